@@ -24,6 +24,8 @@
 #include "python/tensorstore/array_type_caster.h"
 
 // Other headers
+#include <stdint.h>
+
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
@@ -35,6 +37,7 @@
 #include <utility>
 
 #include "python/tensorstore/data_type.h"
+#include "python/tensorstore/gil_safe.h"
 #include "python/tensorstore/json_type_caster.h"
 #include "tensorstore/array.h"
 #include "tensorstore/contiguous_layout.h"
@@ -302,6 +305,165 @@ void CopyFromNumpyArray(pybind11::handle src, ArrayView<void> out) {
   CopyArray(temp_src, out);
 }
 
+namespace {
+
+// Subset of the DLPack ABI (https://github.com/dmlc/dlpack) needed to import a
+// tensor from a `__dlpack__` capsule.
+enum DLDeviceType : int32_t {
+  kDLCPU = 1,
+  kDLCUDA = 2,
+  kDLCUDAHost = 3,
+};
+
+enum DLDataTypeCode : uint8_t {
+  kDLInt = 0,
+  kDLUInt = 1,
+  kDLFloat = 2,
+  kDLBfloat = 4,
+  kDLComplex = 5,
+  kDLBool = 6,
+};
+
+struct DLDevice {
+  int32_t device_type;
+  int32_t device_id;
+};
+
+struct DLDataType {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+};
+
+struct DLTensor {
+  void* data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void* manager_ctx;
+  void (*deleter)(DLManagedTensor* self);
+};
+
+/// Returns the DLPack type code of `data_type`, or `std::nullopt` if it has no
+/// DLPack equivalent.
+std::optional<uint8_t> GetDLDataTypeCode(DataType data_type) {
+  switch (data_type.id()) {
+    case DataTypeId::bool_t:
+      return kDLBool;
+    case DataTypeId::int8_t:
+    case DataTypeId::int16_t:
+    case DataTypeId::int32_t:
+    case DataTypeId::int64_t:
+      return kDLInt;
+    case DataTypeId::uint8_t:
+    case DataTypeId::uint16_t:
+    case DataTypeId::uint32_t:
+    case DataTypeId::uint64_t:
+      return kDLUInt;
+    case DataTypeId::float16_t:
+    case DataTypeId::float32_t:
+    case DataTypeId::float64_t:
+      return kDLFloat;
+    case DataTypeId::bfloat16_t:
+      return kDLBfloat;
+    case DataTypeId::complex64_t:
+    case DataTypeId::complex128_t:
+      return kDLComplex;
+    default:
+      return std::nullopt;
+  }
+}
+
+/// Returns an array that refers to the host memory of a DLPack tensor exported
+/// by `obj.__dlpack__()`.
+///
+/// Host memory that is pinned for transfer to a CUDA device is supported, since
+/// a framework can then copy the result to the device asynchronously.
+SharedArray<void> GetArrayFromDLPack(py::handle obj, DataType data_type,
+                                     DimensionIndex rank) {
+  py::tuple device = obj.attr("__dlpack_device__")();
+  const int device_type = py::cast<int>(device[0]);
+  if (device_type != kDLCPU && device_type != kDLCUDAHost) {
+    throw py::value_error(tensorstore::StrCat(
+        "Reading into DLPack device type ", device_type,
+        " is not supported; only host memory is supported"));
+  }
+  py::object capsule = obj.attr("__dlpack__")();
+  auto* managed = static_cast<DLManagedTensor*>(
+      PyCapsule_GetPointer(capsule.ptr(), "dltensor"));
+  if (!managed) throw py::error_already_set();
+  // Take ownership of the tensor, as specified by the DLPack protocol.
+  if (PyCapsule_SetName(capsule.ptr(), "used_dltensor") != 0) {
+    throw py::error_already_set();
+  }
+  std::shared_ptr<DLManagedTensor> owner(
+      managed, [](DLManagedTensor* managed) {
+        if (!managed->deleter) return;
+        // The deleter may release Python objects.
+        ExitSafeGilScopedAcquire gil;
+        if (gil.acquired()) managed->deleter(managed);
+      });
+  const DLTensor& tensor = managed->dl_tensor;
+  if (tensor.dtype.code != GetDLDataTypeCode(data_type) ||
+      tensor.dtype.bits != data_type.size() * 8 || tensor.dtype.lanes != 1) {
+    throw py::value_error(tensorstore::StrCat(
+        "DLPack tensor does not have data type ", data_type));
+  }
+  if (tensor.ndim != rank) {
+    throw py::value_error(tensorstore::StrCat("Expected DLPack tensor of rank ",
+                                              rank, ", but received rank ",
+                                              tensor.ndim));
+  }
+  char* data = static_cast<char*>(tensor.data) + tensor.byte_offset;
+  if (reinterpret_cast<uintptr_t>(data) % data_type.alignment() != 0) {
+    throw py::value_error("DLPack tensor is not aligned");
+  }
+  SharedArray<void> array;
+  array.layout().set_rank(rank);
+  Index stride = data_type.size();
+  for (DimensionIndex i = rank - 1; i >= 0; --i) {
+    array.shape()[i] = tensor.shape[i];
+    // Null strides indicate C order.
+    array.byte_strides()[i] =
+        tensor.strides ? tensor.strides[i] * data_type.size() : stride;
+    stride *= tensor.shape[i];
+  }
+  array.element_pointer() = SharedElementPointer<void>(
+      std::shared_ptr<void>(std::move(owner), data), data_type);
+  return array;
+}
+
+}  // namespace
+
+SharedArray<void> GetOutputArrayFromPython(pybind11::handle out,
+                                           DataType data_type,
+                                           DimensionIndex rank) {
+  if (GetNumpyDtypeOrThrow(data_type).kind() == 'O') {
+    // Object arrays can only be converted by copying.
+    throw py::value_error(tensorstore::StrCat(
+        "Reading into an existing array is not supported for data type ",
+        data_type));
+  }
+  // Objects that only support DLPack, such as framework tensors in pinned
+  // host memory, are imported directly.
+  if (!PyArray_Check(out.ptr()) && !PyObject_CheckBuffer(out.ptr()) &&
+      py::hasattr(out, "__dlpack__")) {
+    return GetArrayFromDLPack(out, data_type, rank);
+  }
+  SharedArray<void> array;
+  bool is_writable;
+  ConvertToArrayImpl(out, array, is_writable, data_type, rank, rank,
+                     /*writable=*/true, /*no_throw=*/false, /*copy=*/false);
+  return array;
+}
+
 ContiguousLayoutOrder GetContiguousLayoutOrderOrThrow(pybind11::handle obj) {
   Py_UCS4 c;
   if (PyUnicode_Check(obj.ptr())) {
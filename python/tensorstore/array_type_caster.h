@@ -176,6 +176,20 @@ std::conditional_t<NoThrow, bool, void> ConvertToArray(
 /// \param out Target array.
 void CopyFromNumpyArray(pybind11::handle src, ArrayView<void> out);
 
+/// Returns a `SharedArray` that refers directly to the memory of `out`, for use
+/// as the target of a read.
+///
+/// Throws an exception if `out` is not a writable NumPy array or buffer
+/// protocol object that can be viewed, without copying, as an aligned array of
+/// the specified `data_type` and `rank`.
+///
+/// \param out Handle to the target NumPy array or buffer protocol object.
+/// \param data_type Required data type, must be a numeric data type.
+/// \param rank Required rank.
+SharedArray<void> GetOutputArrayFromPython(pybind11::handle out,
+                                           DataType data_type,
+                                           DimensionIndex rank);
+
 /// Wraps an unvalidated `py::object` but displays as "numpy.typing.ArrayLike"
 /// in pybind11 function signatures.
 ///
@@ -0,0 +1,151 @@
+# Copyright 2024 The TensorStore Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Benchmarks the per-call overhead of the Python bindings.
+
+Measures the hot paths crossed by small reads from Python, independent of any
+storage driver:
+
+- index expression parsing and application (`numpy_indexing_spec.cc`),
+- future creation and resolution (`future.cc`),
+- conversion between NumPy arrays and TensorStore arrays, with and without
+  copying (`array_type_caster.cc`).
+
+Each benchmark is run for `--min_time` seconds, and the results are printed
+as one JSON object per line, including the GIL wait counters
+(`/tensorstore/python/gil_*`) accumulated while it ran.
+
+Example:
+
+  bazel run -c opt //python/tensorstore:binding_benchmark -- \
+      --benchmarks=read_small,write_small --threads=4
+"""
+
+import json
+import threading
+import time
+from typing import Any, Callable, Dict, List
+
+from absl import app
+from absl import flags
+import numpy as np
+import tensorstore as ts
+
+FLAGS = flags.FLAGS
+
+flags.DEFINE_list(
+    'benchmarks', [], 'Benchmarks to run.  All benchmarks if empty.'
+)
+flags.DEFINE_float('min_time', 1.0, 'Minimum time per benchmark, in seconds.')
+flags.DEFINE_integer(
+    'threads',
+    1,
+    'Number of Python threads that run each benchmark concurrently, to '
+    'measure GIL contention.',
+)
+flags.DEFINE_integer('size', 16, 'Extent of each dimension of the arrays.')
+
+BenchmarkFn = Callable[[], Any]
+
+
+def _make_benchmarks(size: int) -> Dict[str, BenchmarkFn]:
+  """Returns the benchmarks, keyed by name."""
+  np_array = np.arange(size * size, dtype=np.float32).reshape(size, size)
+  store = ts.array(np_array, write=True)
+  transform = ts.IndexTransform(input_shape=[size, size])
+  expr = ts.d[0].translate_by[1][1:3]
+  promise, ready = ts.Promise.new()
+  promise.set_result(1)
+
+  return {
+      # Indexing expression parsing.
+      'index_numpy_slice': lambda: transform[1:3, 2],
+      'index_numpy_array': lambda: transform[[0, 1, 2], :],
+      'index_dim_expression': lambda: transform[expr],
+      'index_tensorstore': lambda: store[1:3, 2],
+      # Future resolution.
+      'future_ready_result': ready.result,
+      'future_read_result': lambda: store[0, 0].read().result(),
+      # Array conversion.
+      'array_from_numpy_copy': lambda: ts.array(np_array, copy=True),
+      'array_from_numpy_nocopy': lambda: ts.array(np_array, copy=False),
+      'array_to_numpy': lambda: np.asarray(store),
+      'read_small': lambda: store[0:2, 0:2].read().result(),
+      'write_small': lambda: store[0:2, 0:2].write(np_array[0:2, 0:2]).result(),
+  }
+
+
+def _gil_metrics() -> Dict[str, int]:
+  result = {}
+  for metric in ts.experimental_collect_matching_metrics(
+      '/tensorstore/python/gil_', include_zero_metrics=True
+  ):
+    result[metric['name']] = metric['values'][0]['value']
+  return result
+
+
+def _run_thread(fn: BenchmarkFn, deadline: float, counts: List[int]) -> None:
+  count = 0
+  while True:
+    for _ in range(100):
+      fn()
+    count += 100
+    if time.perf_counter() >= deadline:
+      break
+  counts.append(count)
+
+
+def run_benchmark(name: str, fn: BenchmarkFn) -> Dict[str, Any]:
+  """Runs `fn` repeatedly on `--threads` threads and returns the results."""
+  fn()
+  before = _gil_metrics()
+  start = time.perf_counter()
+  deadline = start + FLAGS.min_time
+  counts: List[int] = []
+  threads = [
+      threading.Thread(target=_run_thread, args=(fn, deadline, counts))
+      for _ in range(FLAGS.threads)
+  ]
+  for t in threads:
+    t.start()
+  for t in threads:
+    t.join()
+  elapsed = time.perf_counter() - start
+  after = _gil_metrics()
+  iterations = sum(counts)
+  result = {
+      'name': name,
+      'threads': FLAGS.threads,
+      'iterations': iterations,
+      'ns_per_op': elapsed * 1e9 * FLAGS.threads / iterations,
+      'ops_per_s': iterations / elapsed,
+  }
+  for key, value in after.items():
+    result[key.rsplit('/', 1)[-1]] = value - before.get(key, 0)
+  return result
+
+
+def main(argv):
+  if len(argv) > 1:
+    raise app.UsageError('Too many command-line arguments.')
+  benchmarks = _make_benchmarks(FLAGS.size)
+  names = FLAGS.benchmarks or list(benchmarks)
+  for name in names:
+    if name not in benchmarks:
+      raise app.UsageError(f'Unknown benchmark: {name}')
+  for name in names:
+    print(json.dumps(run_benchmark(name, benchmarks[name])), flush=True)
+
+
+if __name__ == '__main__':
+  app.run(main)
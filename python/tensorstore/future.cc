@@ -26,9 +26,12 @@
 #include <cassert>
 #include <cerrno>
 #include <cstddef>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
+#include "absl/base/no_destructor.h"
 #include "absl/status/status.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -220,10 +223,128 @@ class ScopedFutureCallbackRegistration {
  private:
   FutureCallbackRegistration registration_;
 };
+
+/// Completions of asyncio futures awaiting a `PythonFutureObject`, pending for
+/// a single event loop.
+///
+/// Rather than scheduling a separate `call_soon_threadsafe` callback for each
+/// completion, which wakes the event loop and allocates a handle each time,
+/// completions are queued and a single callback completes all completions
+/// queued before it runs.
+struct PendingAsyncioCompletions {
+  /// Strong reference, which ensures the address of the loop is not reused
+  /// while completions are pending.
+  py::object loop;
+  /// Pairs of `(awaitable_future, source_future)`.
+  std::vector<std::pair<py::object, py::object>> completions;
+};
+
+/// Pending completions for each event loop with a scheduled drain callback.
+///
+/// Guarded by `pending_asyncio_completions_mutex`.  There is typically at most
+/// one event loop.
+std::vector<PendingAsyncioCompletions>& GetPendingAsyncioCompletions() {
+  static absl::NoDestructor<std::vector<PendingAsyncioCompletions>> pending;
+  return *pending;
+}
+
+PythonMutex pending_asyncio_completions_mutex;
+
+/// Appends a completion to the pending completions for `loop`.
+///
+/// Returns `false` if there are no pending completions for `loop`, in which
+/// case `create` must be `true` to add an entry for it.
+bool AppendPendingAsyncioCompletion(py::handle loop,
+                                    py::handle awaitable_future,
+                                    py::handle source_future, bool create) {
+  std::lock_guard<PythonMutex> lock(pending_asyncio_completions_mutex);
+  auto& pending = GetPendingAsyncioCompletions();
+  auto it = std::find_if(pending.begin(), pending.end(), [&](const auto& p) {
+    return p.loop.ptr() == loop.ptr();
+  });
+  if (it == pending.end()) {
+    if (!create) return false;
+    it = pending.insert(pending.end(), PendingAsyncioCompletions{});
+    it->loop = py::reinterpret_borrow<py::object>(loop);
+  }
+  it->completions.emplace_back(
+      py::reinterpret_borrow<py::object>(awaitable_future),
+      py::reinterpret_borrow<py::object>(source_future));
+  return true;
+}
+
+/// Marks `awaitable_future` ready with the outcome of `source_future`.
+///
+/// Must be called from the thread running the event loop of
+/// `awaitable_future`.
+void CompleteAwaitable(py::handle awaitable_future, py::handle source_future) {
+  if (awaitable_future.attr("done")().ptr() == Py_True) {
+    return;
+  }
+  if (source_future.attr("cancelled")().ptr() == Py_True) {
+    awaitable_future.attr("cancel")();
+    return;
+  }
+  auto exc = source_future.attr("exception")();
+  if (!exc.is_none()) {
+    awaitable_future.attr("set_exception")(std::move(exc));
+  } else {
+    awaitable_future.attr("set_result")(source_future.attr("result")());
+  }
+}
+
+/// Completes all pending completions for `loop`.  Called from the event loop.
+void DrainAsyncioCompletions(py::handle loop) {
+  PendingAsyncioCompletions entry;
+  {
+    // Only move the references while holding the lock; they are released
+    // after it is unlocked.
+    std::lock_guard<PythonMutex> lock(pending_asyncio_completions_mutex);
+    auto& pending = GetPendingAsyncioCompletions();
+    auto it = std::find_if(pending.begin(), pending.end(), [&](const auto& p) {
+      return p.loop.ptr() == loop.ptr();
+    });
+    if (it == pending.end()) return;
+    entry = std::move(*it);
+    pending.erase(it);
+  }
+  auto& completions = entry.completions;
+  for (auto& [awaitable_future, source_future] : completions) {
+    // Report errors individually, as the callback scheduled by
+    // `call_soon_threadsafe` would have.
+    try {
+      CompleteAwaitable(awaitable_future, source_future);
+    } catch (py::error_already_set& e) {
+      e.discard_as_unraisable(__func__);
+    }
+  }
+}
+
+/// Queues the completion of `awaitable_future`, scheduling a drain callback on
+/// its event loop if one is not already scheduled.
+///
+/// May be called from any thread with the GIL held.
+void EnqueueAsyncioCompletion(py::handle awaitable_future,
+                              py::handle source_future) {
+  static absl::NoDestructor<py::object> drain_callback(
+      py::cpp_function(&DrainAsyncioCompletions));
+  py::object loop = awaitable_future.attr("get_loop")();
+  if (AppendPendingAsyncioCompletion(loop, awaitable_future, source_future,
+                                     /*create=*/false)) {
+    return;
+  }
+  // Schedule first, since this fails if the loop is closed.  In free-threaded
+  // builds, another thread may concurrently schedule a drain callback as well,
+  // in which case the second one to run finds nothing to drain.
+  loop.attr("call_soon_threadsafe")(*drain_callback, loop);
+  AppendPendingAsyncioCompletion(loop, awaitable_future, source_future,
+                                 /*create=*/true);
+}
+
 }  // namespace
 
 [[noreturn]] void ThrowCancelledError() {
-  PyErr_SetNone(python_imports.asyncio_cancelled_error_class.ptr());
+  PyErr_SetNone(GetAsyncioImports().asyncio_cancelled_error_class.ptr());
   throw py::error_already_set();
 }
 
@@ -233,7 +354,7 @@ class ScopedFutureCallbackRegistration {
 }
 
 pybind11::object GetCancelledError() {
-  return python_imports.asyncio_cancelled_error_class(py::none());
+  return GetAsyncioImports().asyncio_cancelled_error_class(py::none());
 }
 
 // FIXME: Change to AnyFuture.
@@ -281,10 +402,13 @@ void InterruptibleWaitImpl(internal_future::FutureStateBase& future,
 }
 
 bool PythonFutureObject::Cancel() {
-  if (done()) return false;
-  cpp_data.state = {};
-  cpp_data.registration.Unregister();
-  RunCancelCallbacks();
+  {
+    PythonCriticalSection lock(reinterpret_cast<PyObject*>(this));
+    if (done()) return false;
+    cpp_data.state = {};
+    cpp_data.registration.Unregister();
+    RunCancelCallbacks();
+  }
   RunCallbacks();
   return true;
 }
@@ -303,39 +427,23 @@ pybind11::object PythonFutureObject::GetAwaitable() {
   // lambda captures don't interoperate with Python garbage collection.
   // Instead, we create it as a capture-less function and then use a
   // `PyMethod` object to capture `awaitable_future` as the `self` argument.
-  auto done_callback = py::cpp_function([](py::handle awaitable_future,
-                                           py::handle source_future) {
-    awaitable_future.attr("get_loop")().attr("call_soon_threadsafe")(
-        py::cpp_function([](py::handle source_future,
-                            py::object awaitable_future) {
-          if (awaitable_future.attr("done")().ptr() == Py_True) {
-            return;
-          }
-          if (source_future.attr("cancelled")().ptr() == Py_True) {
-            awaitable_future.attr("cancel")();
-            return;
-          }
-          auto exc = source_future.attr("exception")();
-          if (!exc.is_none()) {
-            awaitable_future.attr("set_exception")(std::move(exc));
-          } else {
-            awaitable_future.attr("set_result")(source_future.attr("result")());
-          }
-        }),
-        source_future, awaitable_future);
-  });
+  //
+  // The function objects are shared by all awaitables.
+  static absl::NoDestructor<py::object> done_callback(
+      py::cpp_function(&EnqueueAsyncioCompletion));
 
-  py::object awaitable_future =
-      python_imports.asyncio_get_event_loop_function().attr("create_future")();
+  py::object awaitable_future = GetAsyncioImports()
+                                    .asyncio_get_event_loop_function()
+                                    .attr("create_future")();
 
   // Ensure the PythonFutureObject is cancelled if the awaitable future is
   // cancelled.
-  auto cancel_callback = py::cpp_function(
+  static absl::NoDestructor<py::object> cancel_callback(py::cpp_function(
       [](py::handle source_future, py::handle awaitable_future) {
         reinterpret_cast<PythonFutureObject*>(source_future.ptr())->Cancel();
-      });
-  auto bound_cancel_callback = py::reinterpret_steal<py::object>(
-      PyMethod_New(cancel_callback.ptr(), reinterpret_cast<PyObject*>(this)));
+      }));
+  auto bound_cancel_callback = py::reinterpret_steal<py::object>(PyMethod_New(
+      cancel_callback->ptr(), reinterpret_cast<PyObject*>(this)));
   if (!bound_cancel_callback) throw py::error_already_set();
 
   awaitable_future.attr("add_done_callback")(bound_cancel_callback);
@@ -343,7 +451,7 @@ pybind11::object PythonFutureObject::GetAwaitable() {
   // Ensure the awaitable future is marked ready once the PythonFutureObject
   // becomes ready.
   auto bound_done_callback = py::reinterpret_steal<py::object>(
-      PyMethod_New(done_callback.ptr(), awaitable_future.ptr()));
+      PyMethod_New(done_callback->ptr(), awaitable_future.ptr()));
   if (!bound_done_callback) throw py::error_already_set();
 
   AddDoneCallback(bound_done_callback);
@@ -371,18 +479,23 @@ pybind11::object PythonFutureObject::GetException(absl::Time deadline) {
 }
 
 void PythonFutureObject::AddDoneCallback(pybind11::handle callback) {
-  if (done()) {
-    callback(py::handle(reinterpret_cast<PyObject*>(this)));
-    return;
-  }
-  cpp_data.callbacks.push_back(py::reinterpret_borrow<py::object>(callback));
-  if (cpp_data.callbacks.size() == 1) {
-    Py_INCREF(reinterpret_cast<PyObject*>(this));
-    Force();
+  {
+    PythonCriticalSection lock(reinterpret_cast<PyObject*>(this));
+    if (!done()) {
+      cpp_data.callbacks.push_back(
+          py::reinterpret_borrow<py::object>(callback));
+      if (cpp_data.callbacks.size() == 1) {
+        Py_INCREF(reinterpret_cast<PyObject*>(this));
+        Force();
+      }
+      return;
+    }
   }
+  callback(py::handle(reinterpret_cast<PyObject*>(this)));
 }
 
 size_t PythonFutureObject::RemoveDoneCallback(pybind11::handle callback) {
+  PythonCriticalSection lock(reinterpret_cast<PyObject*>(this));
   auto& callbacks = cpp_data.callbacks;
   // Since caller owns a reference to `callback`, we can be sure that removing
   // `callback` from `callbacks` does not result in any reference counts
@@ -435,7 +548,13 @@ void PythonFutureObject::RunCancelCallbacks() {
 }
 
 void PythonFutureObject::RunCallbacks() {
-  auto callbacks = std::move(cpp_data.callbacks);
+  std::vector<py::object> callbacks;
+  {
+    // Callbacks are invoked without the critical section held, since they may
+    // access this object.
+    PythonCriticalSection lock(reinterpret_cast<PyObject*>(this));
+    callbacks = std::move(cpp_data.callbacks);
+  }
   if (callbacks.empty()) return;
   // If this object has already been finalized, then it is not safe to call
   // callbacks, because they may now be in an invalid state due to garbage
@@ -473,7 +592,7 @@ pybind11::object TryConvertToFuture(pybind11::handle src,
     return py::reinterpret_borrow<py::object>(src);
   }
 
-  if (python_imports.asyncio_iscoroutine_function(src).ptr() != Py_True) {
+  if (GetAsyncioImports().asyncio_iscoroutine_function(src).ptr() != Py_True) {
     return {};
   }
 
@@ -484,7 +603,7 @@ pybind11::object TryConvertToFuture(pybind11::handle src,
   }
 
   auto asyncio_future =
-      python_imports.asyncio_run_coroutine_threadsafe_function(src, loop);
+      GetAsyncioImports().asyncio_run_coroutine_threadsafe_function(src, loop);
   auto pair = PromiseFuturePair<GilSafePythonValueOrExceptionWeakRef>::Make();
 
   // Create Python future wrapper before adding `done_callback`, to ensure that
@@ -1144,9 +1263,12 @@ PyTypeObject* PythonFutureObject::python_type = nullptr;
 PyTypeObject* PythonPromiseObject::python_type = nullptr;
 
 py::object GetCurrentThreadAsyncioEventLoop() {
+  // No event loop can be running if `asyncio` has not been imported, in which
+  // case the import is avoided.
+  if (!IsAsyncioImported()) return py::none();
   if (auto loop =
           py::reinterpret_steal<py::object>(PyObject_CallFunctionObjArgs(
-              python_imports.asyncio__get_running_loop_function.ptr(),
+              GetAsyncioImports().asyncio__get_running_loop_function.ptr(),
               nullptr))) {
     return loop;
   }
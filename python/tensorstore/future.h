@@ -209,13 +209,16 @@ struct PythonFutureObject {
         internal::intrusive_linked_list::MemberAccessor<CancelCallbackBase>;
     explicit CancelCallback(PythonFutureObject* base,
                             absl::FunctionRef<void()> callback)
-        : callback(callback) {
+        : base(base), callback(callback) {
+      PythonCriticalSection lock(reinterpret_cast<PyObject*>(base));
       internal::intrusive_linked_list::InsertBefore(
           Accessor{}, &base->cpp_data.cancel_callbacks, this);
     }
     ~CancelCallback() {
+      PythonCriticalSection lock(reinterpret_cast<PyObject*>(base));
       internal::intrusive_linked_list::Remove(Accessor{}, this);
     }
+    PythonFutureObject* base;
     absl::FunctionRef<void()> callback;
   };
 
@@ -225,7 +228,8 @@ struct PythonFutureObject {
 
     internal_future::FutureStatePointer state;
     /// Callbacks to be invoked when the future becomes ready.  Guarded by the
-    /// GIL.  When non-empty, the Python reference count of the
+    /// GIL, or by a `PythonCriticalSection` on this object in free-threaded
+    /// builds.  When non-empty, the Python reference count of the
     /// `PythonFutureObject` is incremented.  If there is an associated
     /// `PythonPromiseObject`, the additional reference count is considered to
     /// be logically owned by it, and will participate in cyclic garbage
@@ -234,10 +238,10 @@ struct PythonFutureObject {
     /// collection.
     std::vector<pybind11::object> callbacks;
     /// Registration of `ExecuteWhenReady` callback used when `callbacks_` is
-    /// non-empty.  Guarded by the GIL.
+    /// non-empty.  Guarded in the same way as `callbacks`.
     FutureCallbackRegistration registration;
-    /// Linked list of callbacks to be invoked when cancelled.  Guarded by the
-    /// GIL.
+    /// Linked list of callbacks to be invoked when cancelled.  Guarded in the
+    /// same way as `callbacks`.
     CancelCallbackBase cancel_callbacks;
     /// Holds strong references to objects weakly referenced by either the value
     /// that has been set (if done), or by the asynchronous operation
@@ -403,14 +407,18 @@ struct PythonFutureObject {
         [&obj](ReadyFuture<const T> future) mutable {
           ExitSafeGilScopedAcquire gil;
           if (!gil.acquired()) return;
-          if (!obj.cpp_data.state) return;
-          assert(Py_REFCNT(reinterpret_cast<PyObject*>(&obj)) > 0);
-          auto keep_alive = pybind11::reinterpret_borrow<pybind11::object>(
-              reinterpret_cast<PyObject*>(&obj));
-          auto& r = future.result();
-          if constexpr (!std::is_void_v<T>) {
-            if (r.ok()) {
-              obj.cpp_data.reference_manager.Update(*r);
+          pybind11::object keep_alive;
+          {
+            PythonCriticalSection lock(reinterpret_cast<PyObject*>(&obj));
+            if (!obj.cpp_data.state) return;
+            assert(Py_REFCNT(reinterpret_cast<PyObject*>(&obj)) > 0);
+            keep_alive = pybind11::reinterpret_borrow<pybind11::object>(
+                reinterpret_cast<PyObject*>(&obj));
+            auto& r = future.result();
+            if constexpr (!std::is_void_v<T>) {
+              if (r.ok()) {
+                obj.cpp_data.reference_manager.Update(*r);
+              }
             }
           }
           obj.RunCallbacks();
@@ -34,6 +34,26 @@ namespace py = ::pybind11;
 namespace tensorstore {
 namespace internal_python {
 
+namespace {
+
+/// Returns a new reference to the referent of `weak_ref`, or `None` if it has
+/// been destroyed.
+///
+/// Unlike `PyWeakref_GET_OBJECT`, which returns a borrowed reference, this is
+/// safe in free-threaded builds of Python.
+py::object GetWeakRefReferent(PyObject* weak_ref) {
+#if PY_VERSION_HEX >= 0x030D0000
+  PyObject* obj;
+  if (PyWeakref_GetRef(weak_ref, &obj) < 0) throw py::error_already_set();
+  if (!obj) return py::none();
+  return py::reinterpret_steal<py::object>(obj);
+#else
+  return py::reinterpret_borrow<py::object>(PyWeakref_GET_OBJECT(weak_ref));
+#endif
+}
+
+}  // namespace
+
 PythonObjectReferenceManager::PythonObjectReferenceManager() = default;
 
 PythonObjectReferenceManager::PythonObjectReferenceManager(
@@ -98,18 +118,27 @@ void PythonObjectReferenceManager::Visitor::DoIndirect(
       // Actually a strong reference.
       if (PyObject_IS_GC(weak_ref.get())) {
         // Strong reference that needs to be converted to a weak reference.
-        PythonWeakRef new_weak_ref(manager_, weak_ref.get());
-        obj.weak_ref_ = std::move(new_weak_ref.weak_ref_);
+        // The same `PythonWeakRef` may be shared by objects being updated
+        // concurrently by other threads in free-threaded builds, so the
+        // conversion is done under a critical section on the referent.
+        PythonCriticalSection lock(weak_ref.get());
+        weak_ref = obj.weak_ref_.get();
+        if (weak_ref.tag()) {
+          PythonWeakRef new_weak_ref(manager_, weak_ref.get());
+          obj.weak_ref_ = std::move(new_weak_ref.weak_ref_);
+          return;
+        }
+      } else {
+        return;
       }
-      return;
     }
 
     // Actual weak reference.
-    PyObject* python_obj = PyWeakref_GET_OBJECT(weak_ref.get());
-    if (python_obj == Py_None) return;
+    py::object python_obj = GetWeakRefReferent(weak_ref.get());
+    if (python_obj.is_none()) return;
 
-    if (manager_.python_refs_.insert(python_obj).second) {
-      Py_INCREF(python_obj);
+    if (manager_.python_refs_.insert(python_obj.ptr()).second) {
+      python_obj.release();
     }
     return;
   }
@@ -198,7 +227,9 @@ pybind11::handle PythonWeakRef::get_value_or_null() const {
     // Actually a strong reference.
     return weak_ref.get();
   }
-  PyObject* obj = PyWeakref_GET_OBJECT(weak_ref.get());
+  // The referent is kept alive by the `PythonObjectReferenceManager` of the
+  // owner, so a borrowed reference may be returned.
+  PyObject* obj = GetWeakRefReferent(weak_ref.get()).ptr();
   if (obj == Py_None) {
     // Since `None` does not support weak references, we know that the actual
     // value was not `None`.
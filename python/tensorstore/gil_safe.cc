@@ -19,11 +19,17 @@
 #include "python/tensorstore/gil_safe.h"
 
 // Other headers
+#include <stdint.h>
+
+#include <atomic>
 #include <thread>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "python/tensorstore/python_imports.h"
+#include "tensorstore/internal/metrics/counter.h"
 
 namespace tensorstore {
 namespace internal_python {
@@ -31,6 +37,20 @@ namespace internal_python {
 namespace py = ::pybind11;
 
 namespace {
+
+auto& gil_acquire = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/python/gil_acquire",
+    "Number of times the GIL was acquired by a thread not holding it");
+
+auto& gil_wait_ns = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/python/gil_wait_ns",
+    "Total time spent waiting to acquire the GIL (ns)");
+
+void RecordGilWait(absl::Time start) {
+  gil_acquire.Increment();
+  gil_wait_ns.IncrementBy(absl::ToInt64Nanoseconds(absl::Now() - start));
+}
+
 /// Serves to block the main Python thread from exiting while there are pending
 /// calls to Python APIs in other threads by Tensorstore code.
 ABSL_CONST_INIT absl::Mutex exit_block_mutex{absl::kConstInit};
@@ -45,6 +65,21 @@ const std::thread::id main_thread_id = std::this_thread::get_id();
 bool IsMainThread() { return main_thread_id == std::this_thread::get_id(); }
 }  // namespace
 
+PyGILState_STATE GilStateEnsure() {
+  // Re-entrant acquisition does not wait.
+  if (PyGILState_Check()) return PyGILState_Ensure();
+  const absl::Time start = absl::Now();
+  PyGILState_STATE state = PyGILState_Ensure();
+  RecordGilWait(start);
+  return state;
+}
+
+void GilRestoreThread(PyThreadState* save) {
+  const absl::Time start = absl::Now();
+  PyEval_RestoreThread(save);
+  RecordGilWait(start);
+}
+
 void GilSafeIncref(PyObject* p) {
   if (!TryAcquireExitBlock()) return;
   GilScopedAcquire gil;
@@ -89,7 +124,7 @@ void ReleaseExitBlock() noexcept ABSL_NO_THREAD_SAFETY_ANALYSIS {
 ExitSafeGilScopedAcquire::ExitSafeGilScopedAcquire() {
   acquired_ = IsMainThread() || TryAcquireExitBlock();
   if (acquired_) {
-    gil_state_ = PyGILState_Ensure();
+    gil_state_ = GilStateEnsure();
   }
 }
 
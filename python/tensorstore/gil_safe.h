@@ -33,6 +33,15 @@
 namespace tensorstore {
 namespace internal_python {
 
+/// Equivalent to `PyGILState_Ensure`, but if the GIL is not already held by
+/// the current thread, records the time spent waiting for it in the
+/// `/tensorstore/python/gil_wait_ns` metric.
+PyGILState_STATE GilStateEnsure();
+
+/// Equivalent to `PyEval_RestoreThread`, but records the time spent waiting for
+/// the GIL in the `/tensorstore/python/gil_wait_ns` metric.
+void GilRestoreThread(PyThreadState* save);
+
 /// RAII type that ensures the GIL is held by the current thread.
 ///
 /// If this is used from a non-main thread without holding an exit block (see
@@ -40,7 +49,7 @@ namespace internal_python {
 /// crash due to https://bugs.python.org/issue42969.
 class GilScopedAcquire {
  public:
-  GilScopedAcquire() : gil_state_(PyGILState_Ensure()) {}
+  GilScopedAcquire() : gil_state_(GilStateEnsure()) {}
   ~GilScopedAcquire() { PyGILState_Release(gil_state_); }
   GilScopedAcquire(const GilScopedAcquire&) = delete;
 
@@ -52,13 +61,68 @@ class GilScopedAcquire {
 class GilScopedRelease {
  public:
   GilScopedRelease() : save_(PyEval_SaveThread()) {}
-  ~GilScopedRelease() { PyEval_RestoreThread(save_); }
+  ~GilScopedRelease() { GilRestoreThread(save_); }
   GilScopedRelease(const GilScopedRelease&) = delete;
 
  private:
   PyThreadState* save_;
 };
 
+/// RAII type that provides mutual exclusion with respect to other threads that
+/// access `obj`, for C++ state that would otherwise be guarded by the GIL.
+///
+/// In free-threaded builds of Python (where `Py_GIL_DISABLED` is defined), this
+/// is a critical section on the per-object lock of `obj`.  Like the GIL, the
+/// critical section is suspended while the thread state is detached (e.g. by
+/// `GilScopedRelease`).  Otherwise, this is a no-op, since the GIL already
+/// provides mutual exclusion.
+///
+/// \pre The GIL is held (the thread state is attached).
+class PythonCriticalSection {
+ public:
+  explicit PythonCriticalSection(PyObject* obj) {
+#ifdef Py_GIL_DISABLED
+    PyCriticalSection_Begin(&section_, obj);
+#endif
+  }
+  ~PythonCriticalSection() {
+#ifdef Py_GIL_DISABLED
+    PyCriticalSection_End(&section_);
+#endif
+  }
+  PythonCriticalSection(const PythonCriticalSection&) = delete;
+
+ private:
+#ifdef Py_GIL_DISABLED
+  PyCriticalSection section_;
+#endif
+};
+
+/// Mutex for global C++ state that would otherwise be guarded by the GIL.
+///
+/// In free-threaded builds of Python, this is a `PyMutex`, which detaches the
+/// thread state while blocked.  Otherwise, this is a no-op.  Python code,
+/// including object destructors run by `Py_DECREF`, must not be invoked while
+/// the lock is held.
+class PythonMutex {
+ public:
+  void lock() {
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&mutex_);
+#endif
+  }
+  void unlock() {
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&mutex_);
+#endif
+  }
+
+ private:
+#ifdef Py_GIL_DISABLED
+  PyMutex mutex_ = {0};
+#endif
+};
+
 /// Attempts to acquire a block on the Python interpreter exiting.
 ///
 /// If successful, Python will not proceed to finalization until
@@ -17,6 +17,7 @@
 // Other headers must be included after pybind11 to ensure header-order
 // inclusion constraints are satisfied.
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <algorithm>
@@ -25,6 +26,7 @@
 #include <vector>
 
 #include "absl/strings/cord.h"
+#include "absl/time/clock.h"
 #include "python/tensorstore/future.h"
 #include "python/tensorstore/json_type_caster.h"
 #include "python/tensorstore/tensorstore_module_components.h"
@@ -35,6 +37,8 @@
 #include "tensorstore/internal/metrics/collect.h"
 #include "tensorstore/internal/metrics/prometheus.h"
 #include "tensorstore/internal/metrics/registry.h"
+#include "tensorstore/internal/tracing/access_trace.h"
+#include "tensorstore/internal/tracing/inflight_operation.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
@@ -71,6 +75,24 @@ std::vector<std::string> CollectPrometheusFormatMetrics(
   return lines;
 }
 
+std::vector<::nlohmann::json> CollectInFlightOperations() {
+  std::vector<::nlohmann::json> operations;
+  const auto now = absl::Now();
+  for (const auto& info : internal_tracing::CollectInFlightOperations()) {
+    operations.push_back(
+        internal_tracing::InFlightOperationInfoToJson(info, now));
+  }
+  return operations;
+}
+
+::nlohmann::json StopAccessTrace() {
+  size_t num_dropped = 0;
+  auto events = internal_tracing::StopAccessTraceRecording(&num_dropped);
+  auto j = internal_tracing::AccessTraceToJson(events);
+  j["num_dropped"] = num_dropped;
+  return j;
+}
+
 Future<uint32_t> PushMetricsToPrometheus(std::string pushgateway,
                                          std::string job, std::string instance,
                                          std::string metric_prefix) {
@@ -132,6 +154,58 @@ Args:
 Returns:
   :py:obj:`list` of a :py:obj:`str` of prometheus exposition format metrics.
 
+Group:
+  Experimental
+)");
+
+  m.def("experimental_collect_inflight_operations",
+        &internal_python::CollectInFlightOperations, R"(
+Collects the operations currently in progress.
+
+This includes key-value store requests, HTTP transfers, cache reads and
+writebacks, and transaction commits, and may be used to determine where a
+stalled operation is blocked.
+
+Returns:
+  :py:obj:`list` of a :py:obj:`dict` for each operation, ordered by start time,
+  with the keys :python:`"type"`, :python:`"description"`, :python:`"state"`,
+  :python:`"start_time"`, :python:`"elapsed_ms"` and
+  :python:`"state_elapsed_ms"`.
+
+Group:
+  Experimental
+)");
+
+  m.def("experimental_start_access_trace",
+        &internal_tracing::StartAccessTraceRecording,
+        pybind11::arg("max_events") = 1 << 20, R"(
+Starts recording the read and write access pattern.
+
+Each subsequent :py:obj:`TensorStore.read` and :py:obj:`TensorStore.write`
+records the accessed index transform and the times at which it was issued and
+completed, until :py:obj:`experimental_stop_access_trace` is called.
+
+Args:
+  max_events: Maximum number of accesses to record.
+
+Group:
+  Experimental
+)");
+
+  m.def("experimental_stop_access_trace", &internal_python::StopAccessTrace,
+        R"(
+Stops recording the access pattern, and returns the recorded trace.
+
+The trace may be saved as JSON and replayed against a different key-value
+store or context configuration with the
+``//tensorstore/internal/benchmark:access_trace_replay`` tool.
+
+Returns:
+  :py:obj:`dict` with an :python:`"events"` list, where each event specifies
+  :python:`"op"`, :python:`"transform"`, :python:`"start_ms"`,
+  :python:`"end_ms"` and :python:`"ok"`, and :python:`"num_dropped"`, the
+  number of accesses not recorded due to the :python:`max_events` limit.
+
 Group:
   Experimental
 )");
@@ -18,6 +18,9 @@
 
 #include "python/tensorstore/python_imports.h"
 
+#include <atomic>
+#include <memory>
+
 namespace tensorstore {
 namespace internal_python {
 
@@ -25,21 +28,13 @@ namespace py = ::pybind11;
 
 PythonImports python_imports;
 
+namespace {
+std::atomic<PythonAsyncioImports*> asyncio_imports{nullptr};
+}  // namespace
+
 void InitializePythonImports() {
   auto& i = python_imports;
 
-  i.asyncio_module = py::module_::import("asyncio").release();
-  i.asyncio_cancelled_error_class =
-      py::object(i.asyncio_module.attr("CancelledError")).release();
-  i.asyncio_get_event_loop_function =
-      py::object(i.asyncio_module.attr("get_event_loop")).release();
-  i.asyncio__get_running_loop_function =
-      py::object(i.asyncio_module.attr("_get_running_loop")).release();
-  i.asyncio_iscoroutine_function =
-      py::object(i.asyncio_module.attr("iscoroutine")).release();
-  i.asyncio_run_coroutine_threadsafe_function =
-      py::object(i.asyncio_module.attr("run_coroutine_threadsafe")).release();
-
   i.atexit_module = py::module_::import("atexit").release();
   i.atexit_register_function =
       py::object(i.atexit_module.attr("register")).release();
@@ -55,5 +50,44 @@ void InitializePythonImports() {
   i.pickle_loads_function = py::object(i.pickle_module.attr("loads")).release();
 }
 
+const PythonAsyncioImports& GetAsyncioImports() {
+  if (auto* existing = asyncio_imports.load(std::memory_order_acquire)) {
+    return *existing;
+  }
+  auto new_imports = std::make_unique<PythonAsyncioImports>();
+  auto& i = *new_imports;
+  i.asyncio_module = py::module_::import("asyncio").release();
+  i.asyncio_cancelled_error_class =
+      py::object(i.asyncio_module.attr("CancelledError")).release();
+  i.asyncio_get_event_loop_function =
+      py::object(i.asyncio_module.attr("get_event_loop")).release();
+  i.asyncio__get_running_loop_function =
+      py::object(i.asyncio_module.attr("_get_running_loop")).release();
+  i.asyncio_iscoroutine_function =
+      py::object(i.asyncio_module.attr("iscoroutine")).release();
+  i.asyncio_run_coroutine_threadsafe_function =
+      py::object(i.asyncio_module.attr("run_coroutine_threadsafe")).release();
+  // The import may release the GIL, such that another thread may have
+  // completed the imports concurrently.  Like `python_imports`, the
+  // references are never released.
+  PythonAsyncioImports* expected = nullptr;
+  if (!asyncio_imports.compare_exchange_strong(expected, new_imports.get(),
+                                               std::memory_order_acq_rel)) {
+    return *expected;
+  }
+  return *new_imports.release();
+}
+
+bool IsAsyncioImported() {
+  if (asyncio_imports.load(std::memory_order_acquire)) return true;
+  auto module = py::reinterpret_steal<py::object>(
+      PyImport_GetModule(py::str("asyncio").ptr()));
+  if (!module) {
+    PyErr_Clear();
+    return false;
+  }
+  return true;
+}
+
 }  // namespace internal_python
 }  // namespace tensorstore
@@ -20,7 +20,9 @@
 /// Imports of Python builtin and standard library modules/functions that are
 /// required.
 ///
-/// These imports are resolved once during module initialization for efficiency.
+/// These imports are resolved once during module initialization for efficiency,
+/// except for `asyncio`, which is imported on first use since importing it
+/// accounts for a significant part of the time to import `tensorstore`.
 
 #include <pybind11/pybind11.h>
 // Other headers must be included after pybind11 to ensure header-order
@@ -30,13 +32,6 @@ namespace tensorstore {
 namespace internal_python {
 
 struct PythonImports {
-  pybind11::handle asyncio_module;
-  pybind11::handle asyncio_cancelled_error_class;
-  pybind11::handle asyncio_get_event_loop_function;
-  pybind11::handle asyncio__get_running_loop_function;
-  pybind11::handle asyncio_iscoroutine_function;
-  pybind11::handle asyncio_run_coroutine_threadsafe_function;
-
   pybind11::handle atexit_module;
   pybind11::handle atexit_register_function;
 
@@ -55,6 +50,27 @@ extern PythonImports python_imports;
 /// initialization, with the GIL held.
 void InitializePythonImports();
 
+struct PythonAsyncioImports {
+  pybind11::handle asyncio_module;
+  pybind11::handle asyncio_cancelled_error_class;
+  pybind11::handle asyncio_get_event_loop_function;
+  pybind11::handle asyncio__get_running_loop_function;
+  pybind11::handle asyncio_iscoroutine_function;
+  pybind11::handle asyncio_run_coroutine_threadsafe_function;
+};
+
+/// Returns the `asyncio` imports, importing `asyncio` if it has not already
+/// been imported by this function.
+///
+/// Must be called with the GIL held.  Throws `pybind11::error_already_set` if
+/// the import fails.
+const PythonAsyncioImports& GetAsyncioImports();
+
+/// Returns `true` if the `asyncio` module has been imported, by any module.
+///
+/// Must be called with the GIL held.
+bool IsAsyncioImported();
+
 }  // namespace internal_python
 }  // namespace tensorstore
 
@@ -21,6 +21,7 @@
 // Other headers
 #include <cstddef>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string_view>
 #include <typeinfo>
 #include <utility>
@@ -73,8 +74,10 @@ using PickleObjectRegistry = absl::flat_hash_map<void*, PyObject*>;
 /// Entries are automatically removed when the Python wrapper object is
 /// destroyed, which typically happens at the end of the pickling operation.
 ///
-/// \threadsafety Must only be accessed while holding the GIL.
+/// \threadsafety Must only be accessed while holding the GIL and
+///     `pickle_object_registry_mutex`.
 absl::NoDestructor<PickleObjectRegistry> pickle_object_registry;
+PythonMutex pickle_object_registry_mutex;
 
 /// Python object representation for `tensorstore._Encodable` wrapper objects.
 ///
@@ -215,7 +218,15 @@ PyTypeObject EncodableObjectType = [] {
   t.tp_flags = Py_TPFLAGS_DEFAULT;
   t.tp_dealloc = [](PyObject* self) {
     auto& data = reinterpret_cast<EncodableObject*>(self)->cpp_data;
-    pickle_object_registry->erase(data.cpp_object.get());
+    {
+      std::lock_guard<PythonMutex> lock(pickle_object_registry_mutex);
+      // In free-threaded builds, another wrapper for the same C++ object may
+      // have been registered by a concurrent `PickleEncodeSink::DoIndirect`.
+      if (auto it = pickle_object_registry->find(data.cpp_object.get());
+          it != pickle_object_registry->end() && it->second == self) {
+        pickle_object_registry->erase(it);
+      }
+    }
     data.~CppData();
     Py_TYPE(self)->tp_free(self);
   };
@@ -284,6 +295,15 @@ PyTypeObject GlobalPicklableFunctionObjectType = [] {
   return t;
 }();
 
+/// Returns the existing `tensorstore._Encodable` wrapper for `ptr`, or a null
+/// object if there is none.
+py::object FindPickleObject(void* ptr) {
+  std::lock_guard<PythonMutex> lock(pickle_object_registry_mutex);
+  auto it = pickle_object_registry->find(ptr);
+  if (it == pickle_object_registry->end()) return {};
+  return py::reinterpret_borrow<py::object>(it->second);
+}
+
 class PickleEncodeSink final : public serialization::EncodeSink {
  public:
   PickleEncodeSink(riegeli::Writer& writer, pybind11::handle rep) noexcept
@@ -299,10 +319,8 @@ class PickleEncodeSink final : public serialization::EncodeSink {
       // object directly.
       python_object = py::reinterpret_borrow<py::object>(
           static_cast<PyObject*>(object.get()));
-    } else if (auto it = pickle_object_registry->find(object.get());
-               it != pickle_object_registry->end()) {
+    } else if ((python_object = FindPickleObject(object.get()))) {
       // Python wrapper object already exists.  Just return it.
-      python_object = py::reinterpret_borrow<py::object>(it->second);
     } else {
       // Create a new Python wrapper object corresponding to `object`.
       auto* python_type = &EncodableObjectType;
@@ -312,7 +330,10 @@ class PickleEncodeSink final : public serialization::EncodeSink {
       auto& data =
           reinterpret_cast<EncodableObject*>(python_object.ptr())->cpp_data;
       new (&data) EncodableObject::CppData;
-      pickle_object_registry->emplace(object.get(), python_object.ptr());
+      {
+        std::lock_guard<PythonMutex> lock(pickle_object_registry_mutex);
+        pickle_object_registry->try_emplace(object.get(), python_object.ptr());
+      }
       data.cpp_object = std::move(object);
       data.encode = std::move(encode);
     }
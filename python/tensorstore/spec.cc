@@ -80,7 +80,8 @@ constexpr auto WithSpecKeywordArguments = [](auto callback,
       callback, other_param..., spec_setters::SetOpenMode{},
       spec_setters::SetOpen{}, spec_setters::SetCreate{},
       spec_setters::SetDeleteExisting{}, spec_setters::SetAssumeMetadata{},
-      spec_setters::SetAssumeCachedMetadata{}, spec_setters::SetUnbindContext{},
+      spec_setters::SetAssumeCachedMetadata{},
+      spec_setters::SetDeferValidation{}, spec_setters::SetUnbindContext{},
       spec_setters::SetStripContext{}, spec_setters::SetContext{},
       spec_setters::SetKvstore{});
 };
@@ -1929,6 +1930,14 @@ Skip reading the metadata when opening.
 )";
 };
 
+struct OpenModeValueDeferValidation {
+  static constexpr OpenMode mode = OpenMode::defer_validation;
+  static constexpr const char* name = "defer_validation";
+  static constexpr const char* doc = R"(
+Check the metadata on the first read or write rather than when opening.
+)";
+};
+
 template <typename ModeDef>
 void DefineOpenModeAccessor(ClsOpenMode& cls) {
   using Self = PythonOpenMode;
@@ -1952,7 +1961,8 @@ constexpr auto WithOpenModes = [](auto callback, auto... other_params) {
   callback(other_params...,  //
            OpenModeValueOpen{}, OpenModeValueCreate{},
            OpenModeValueDeleteExisting{}, OpenModeValueAssumeMetadata{},
-           OpenModeValueAssumeCachedMetadata{});
+           OpenModeValueAssumeCachedMetadata{},
+           OpenModeValueDeferValidation{});
 };
 
 void DefineOpenModeAttributes(ClsOpenMode& cls) {
@@ -342,6 +342,18 @@ option takes precedence if also specified.
 )";
 };
 
+struct SetDeferValidation : public SetModeBase<OpenMode::defer_validation> {
+  static constexpr const char* name = "defer_validation";
+  static constexpr const char* doc = R"(
+
+Open the existing metadata without checking it against the constraints in the
+spec, and instead check it on the first read or write, which fails if the
+constraints are not satisfied.  Intended for specs obtained from a
+previously-opened TensorStore.  Drivers that do not support deferring the
+checks perform them when opening.  Requires that :py:param:`.open` is `True`.
+)";
+};
+
 struct SetOpenMode {
   using type = PythonOpenMode;
 
@@ -0,0 +1,114 @@
+# Copyright 2024 The TensorStore Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Benchmarks the startup time of short-lived processes that use tensorstore.
+
+Each benchmark runs a fresh Python interpreter `--repetitions` times, and
+measures within it the time taken by each of the steps:
+
+- `import`: `import tensorstore`,
+- `context`: creating the first `tensorstore.Context`,
+- `open`: opening and reading from the first TensorStore, backed by the
+  `memory://` kvstore, such that no network or credential initialization is
+  required.
+
+The results are printed as one JSON object per line, with the median time of
+each step and whether `asyncio` had been imported as a side effect.
+
+Example:
+
+  bazel run -c opt //python/tensorstore:startup_benchmark -- --repetitions=20
+"""
+
+import json
+import statistics
+import subprocess
+import sys
+from typing import Any, Dict, List
+
+from absl import app
+from absl import flags
+
+FLAGS = flags.FLAGS
+
+flags.DEFINE_integer(
+    'repetitions', 10, 'Number of interpreter processes to run.'
+)
+
+_CHILD_SCRIPT = r"""
+import json
+import sys
+import time
+
+times = {}
+start = time.perf_counter()
+import tensorstore as ts
+times['import'] = time.perf_counter() - start
+
+start = time.perf_counter()
+context = ts.Context()
+times['context'] = time.perf_counter() - start
+
+start = time.perf_counter()
+store = ts.open(
+    {'driver': 'zarr', 'kvstore': 'memory://'},
+    create=True,
+    dtype=ts.uint8,
+    shape=[16],
+    context=context,
+).result()
+store.read().result()
+times['open'] = time.perf_counter() - start
+
+times['asyncio_imported'] = 'asyncio' in sys.modules
+print(json.dumps(times))
+"""
+
+
+def _run_child() -> Dict[str, Any]:
+  output = subprocess.run(
+      [sys.executable, '-c', _CHILD_SCRIPT],
+      check=True,
+      capture_output=True,
+      text=True,
+  ).stdout
+  return json.loads(output.splitlines()[-1])
+
+
+def main(argv):
+  if len(argv) > 1:
+    raise app.UsageError('Too many command-line arguments.')
+  runs: List[Dict[str, Any]] = [
+      _run_child() for _ in range(FLAGS.repetitions)
+  ]
+  for step in ('import', 'context', 'open'):
+    print(
+        json.dumps({
+            'name': step,
+            'repetitions': FLAGS.repetitions,
+            'median_ms': statistics.median(r[step] for r in runs) * 1e3,
+            'min_ms': min(r[step] for r in runs) * 1e3,
+        }),
+        flush=True,
+    )
+  print(
+      json.dumps({
+          'name': 'asyncio_imported',
+          'value': any(r['asyncio_imported'] for r in runs),
+      }),
+      flush=True,
+  )
+
+
+if __name__ == '__main__':
+  app.run(main)
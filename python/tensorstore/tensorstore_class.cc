@@ -21,42 +21,54 @@
 #include "python/tensorstore/tensorstore_class.h"
 
 // Other headers
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "python/tensorstore/array_type_caster.h"
 #include "python/tensorstore/batch.h"
 #include "python/tensorstore/context.h"
 #include "python/tensorstore/data_type.h"
 #include "python/tensorstore/define_heap_type.h"
+#include "python/tensorstore/dim_expression.h"
 #include "python/tensorstore/future.h"
 #include "python/tensorstore/homogeneous_tuple.h"
 #include "python/tensorstore/index.h"
 #include "python/tensorstore/index_space.h"
 #include "python/tensorstore/keyword_arguments.h"
+#include "python/tensorstore/numpy_indexing_spec.h"
 #include "python/tensorstore/result_type_caster.h"
 #include "python/tensorstore/sequence_parameter.h"
 #include "python/tensorstore/serialization.h"
 #include "python/tensorstore/spec.h"
+#include "python/tensorstore/status.h"
 #include "python/tensorstore/tensorstore_class.h"
 #include "python/tensorstore/tensorstore_module_components.h"
 #include "python/tensorstore/write_futures.h"
 #include "tensorstore/array.h"
 #include "tensorstore/array_storage_statistics.h"
 #include "tensorstore/batch.h"
+#include "tensorstore/box.h"
 #include "tensorstore/cast.h"
+#include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/context.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/array/array.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/index_space/index_domain.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json/pprint_python.h"
@@ -76,8 +88,13 @@
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/tensorstore.h"
 #include "tensorstore/transaction.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 #include "tensorstore/util/unit.h"
 
 // specializations
@@ -121,7 +138,8 @@ constexpr auto ForwardOpenSetters = [](auto callback, auto... other_param) {
       open_setters::SetWrite{}, open_setters::SetOpenMode{},
       open_setters::SetOpen{}, open_setters::SetCreate{},
       open_setters::SetDeleteExisting{}, open_setters::SetAssumeMetadata{},
-      open_setters::SetAssumeCachedMetadata{}, open_setters::SetContext{},
+      open_setters::SetAssumeCachedMetadata{},
+      open_setters::SetDeferValidation{}, open_setters::SetContext{},
       open_setters::SetTransaction{}, open_setters::SetBatch{},
       spec_setters::SetKvstore{});
 };
@@ -145,6 +163,227 @@ constexpr auto ForwardWriteSetters = [](auto callback, auto... other_param) {
            write_setters::SetCanReferenceSourceDataIndefinitely{});
 };
 
+/// Python iterator returned by `TensorStore.iter_chunks`.
+///
+/// Reads are issued in grid cell order, and up to `prefetch` reads beyond the
+/// chunk being waited on are kept in flight.  All members are guarded by the
+/// GIL, or by a `PythonCriticalSection` on the Python iterator object in
+/// free-threaded builds.  Either is released while issuing reads and waiting
+/// for them.
+struct ChunkIterator {
+  /// Keeps alive any Python objects referenced by `store`.
+  py::object store_object;
+  TensorStore<> store;
+  ContiguousLayoutOrder order;
+  size_t prefetch;
+  /// Origin and cell shape of the chunk grid, in the domain of `store`.
+  std::vector<Index> grid_origin;
+  std::vector<Index> cell_shape;
+  /// Inclusive bounds of the grid cells that intersect the domain.
+  std::vector<Index> min_cell;
+  std::vector<Index> max_cell;
+  /// Next grid cell to read, unless `all_issued` is `true`.
+  std::vector<Index> next_cell;
+  bool all_issued = false;
+  std::deque<std::pair<IndexDomain<>, Future<SharedArray<void>>>> pending;
+
+  static Result<std::unique_ptr<ChunkIterator>> Make(
+      py::object store_object, TensorStore<> store,
+      ContiguousLayoutOrder order, size_t prefetch);
+
+  /// Returns the bounds of `next_cell` and advances it.
+  Box<> NextCellBox();
+
+  std::pair<IndexDomain<>, SharedArray<void>> Next();
+};
+
+Result<std::unique_ptr<ChunkIterator>> ChunkIterator::Make(
+    py::object store_object, TensorStore<> store, ContiguousLayoutOrder order,
+    size_t prefetch) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto layout, store.chunk_layout());
+  const auto domain = store.domain();
+  const DimensionIndex rank = domain.rank();
+  auto self = std::make_unique<ChunkIterator>();
+  self->order = order;
+  self->prefetch = prefetch;
+  self->grid_origin.resize(rank);
+  self->cell_shape.resize(rank);
+  self->min_cell.resize(rank);
+  self->max_cell.resize(rank);
+  const auto layout_shape = layout.read_chunk_shape();
+  const auto layout_origin = layout.grid_origin();
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const IndexInterval interval = domain.box()[i];
+    if (!IsFinite(interval)) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Cannot iterate over chunks of unbounded domain ", domain));
+    }
+    Index size = i < layout_shape.size() ? layout_shape[i] : 0;
+    Index origin = i < layout_origin.size() ? layout_origin[i] : kImplicit;
+    if (size <= 0) {
+      // Unchunked dimension.
+      size = std::max(Index(1), interval.size());
+      origin = kImplicit;
+    }
+    if (origin == kImplicit) origin = interval.inclusive_min();
+    self->grid_origin[i] = origin;
+    self->cell_shape[i] = size;
+    self->min_cell[i] = FloorOfRatio(interval.inclusive_min() - origin, size);
+    self->max_cell[i] = FloorOfRatio(interval.inclusive_max() - origin, size);
+    if (interval.empty()) self->all_issued = true;
+  }
+  self->next_cell = self->min_cell;
+  self->store_object = std::move(store_object);
+  self->store = std::move(store);
+  return self;
+}
+
+Box<> ChunkIterator::NextCellBox() {
+  const DimensionIndex rank = next_cell.size();
+  const auto domain = store.domain().box();
+  Box<> box(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    box[i] = Intersect(
+        IndexInterval::UncheckedSized(
+            grid_origin[i] + next_cell[i] * cell_shape[i], cell_shape[i]),
+        domain[i]);
+  }
+  for (DimensionIndex j = 0; j < rank; ++j) {
+    const DimensionIndex i = order == c_order ? rank - 1 - j : j;
+    if (++next_cell[i] <= max_cell[i]) return box;
+    next_cell[i] = min_cell[i];
+  }
+  all_issued = true;
+  return box;
+}
+
+std::pair<IndexDomain<>, SharedArray<void>> ChunkIterator::Next() {
+  std::vector<TensorStore<>> chunks;
+  while (!all_issued && pending.size() + chunks.size() < prefetch + 1) {
+    chunks.push_back(
+        ValueOrThrow(store | AllDims().BoxSlice(NextCellBox())));
+  }
+  if (!chunks.empty()) {
+    std::vector<Future<SharedArray<void>>> futures;
+    {
+      GilScopedRelease gil_release;
+      for (const auto& chunk : chunks) {
+        futures.push_back(tensorstore::Read<zero_origin>(chunk, order));
+      }
+    }
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      pending.emplace_back(chunks[i].domain(), std::move(futures[i]));
+    }
+  }
+  if (pending.empty()) throw py::stop_iteration();
+  auto [domain, future] = std::move(pending.front());
+  pending.pop_front();
+  // If another thread calls `Next` while the GIL is released, it waits on the
+  // following chunk.
+  return {std::move(domain), ValueOrThrow(InterruptibleWait(future))};
+}
+
+/// Writes `values[i]` to the position `coords[i, :]` of `store`.
+///
+/// Points are grouped by write chunk, and each group is written by a single
+/// index array write, so that the points within each chunk are applied in a
+/// single pass.  If `store` is not bound to a transaction, all writes are
+/// committed as a single transaction.
+Future<const void> WritePoints(TensorStore<> store,
+                               SharedArray<const Index, 2> coords,
+                               SharedArray<const void> values) {
+  const DimensionIndex rank = store.rank();
+  const Index num_points = coords.shape()[0];
+  if (coords.shape()[1] != rank) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Coordinates must have shape [N, ", rank, "], but received shape ",
+        coords.shape()));
+  }
+  const Index values_shape[] = {num_points};
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto broadcast_values, BroadcastArray(values, span(values_shape)),
+      MaybeAnnotateStatus(_, "Invalid values"));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto layout, store.chunk_layout());
+  const auto chunk_shape = layout.write_chunk_shape();
+  const auto grid_origin = layout.grid_origin();
+
+  // Write chunk grid cell of each point.  Unchunked dimensions are assigned to
+  // cell 0.
+  std::vector<Index> cells(num_points * rank);
+  for (DimensionIndex j = 0; j < rank; ++j) {
+    const Index size = j < chunk_shape.size() ? chunk_shape[j] : 0;
+    if (size <= 0) continue;
+    Index origin = j < grid_origin.size() ? grid_origin[j] : kImplicit;
+    if (origin == kImplicit) origin = 0;
+    for (Index i = 0; i < num_points; ++i) {
+      cells[i * rank + j] = FloorOfRatio(coords(i, j) - origin, size);
+    }
+  }
+  const auto cell = [&](Index i) {
+    return span<const Index>(cells.data() + i * rank, rank);
+  };
+
+  // Stable, so that later updates to the same point take precedence.
+  auto permutation = AllocateArray<Index>({num_points});
+  std::iota(permutation.data(), permutation.data() + num_points, Index(0));
+  std::stable_sort(permutation.data(), permutation.data() + num_points,
+                   [&](Index a, Index b) {
+                     return std::lexicographical_compare(
+                         cell(a).begin(), cell(a).end(), cell(b).begin(),
+                         cell(b).end());
+                   });
+  auto sorted_coords = AllocateArray<Index>({num_points, rank});
+  for (Index i = 0; i < num_points; ++i) {
+    for (DimensionIndex j = 0; j < rank; ++j) {
+      sorted_coords(i, j) = coords(permutation(i), j);
+    }
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto permuted_values,
+      broadcast_values | Dims(0).IndexArraySlice(permutation));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto sorted_values,
+                               MakeCopy<zero_origin>(permuted_values));
+
+  Transaction transaction = store.transaction();
+  const bool commit = transaction == no_transaction;
+  if (commit) {
+    transaction = Transaction(isolated);
+    TENSORSTORE_ASSIGN_OR_RETURN(store, store | transaction);
+  }
+  std::vector<AnyFuture> futures;
+  for (Index begin = 0; begin < num_points;) {
+    Index end = begin + 1;
+    while (end < num_points && internal::RangesEqual(cell(permutation(begin)),
+                                                     cell(permutation(end)))) {
+      ++end;
+    }
+    SharedArray<const Index, 2> chunk_coords(
+        AddByteOffset(sorted_coords.element_pointer(),
+                      begin * rank * sizeof(Index)),
+        {end - begin, rank});
+    SharedArray<const void, 1> chunk_values(
+        AddByteOffset(sorted_values.element_pointer(),
+                      begin * sorted_values.dtype().size()),
+        {end - begin});
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto target, store | AllDims().IndexVectorArraySlice(chunk_coords));
+    futures.push_back(
+        tensorstore::Write(std::move(chunk_values), std::move(target))
+            .copy_future);
+    begin = end;
+  }
+  if (commit) futures.push_back(transaction.CommitAsync());
+  return MapFuture(
+      InlineExecutor{},
+      [futures](const Result<void>&) -> Result<void> {
+        for (const auto& future : futures) {
+          TENSORSTORE_RETURN_IF_ERROR(future.status());
+        }
+        return absl::OkStatus();
+      },
+      WaitAllFuture(futures));
+}
+
 using TensorStoreCls = py::class_<PythonTensorStoreObject>;
 
 TensorStoreCls MakeTensorStoreClass(py::module m) {
@@ -464,12 +703,32 @@ Group:
 
   cls.def(
       "read",
-      [](Self& self, ContiguousLayoutOrder order,
-         std::optional<Batch> batch) -> PythonFutureWrapper<SharedArray<void>> {
+      [](Self& self, ContiguousLayoutOrder order, std::optional<Batch> batch,
+         std::optional<ArrayArgumentPlaceholder> out)
+          -> PythonFutureWrapper<SharedArray<void>> {
+        if (!out) {
+          return PythonFutureWrapper<SharedArray<void>>(
+              tensorstore::Read<zero_origin>(
+                  self.value, order,
+                  internal_python::ValidateOptionalBatch(std::move(batch))),
+              self.reference_manager());
+        }
+        // Read directly into the memory of `out`, which is kept alive by
+        // `target` until the read completes.
+        auto target = internal_python::GetOutputArrayFromPython(
+            out->value, self.value.dtype(), self.value.rank());
+        auto future = tensorstore::Read(
+            self.value, target,
+            internal_python::ValidateOptionalBatch(std::move(batch)));
         return PythonFutureWrapper<SharedArray<void>>(
-            tensorstore::Read<zero_origin>(
-                self.value, order,
-                internal_python::ValidateOptionalBatch(std::move(batch))),
+            MapFuture(
+                InlineExecutor{},
+                [target = std::move(target)](
+                    const Result<void>& result) -> Result<SharedArray<void>> {
+                  if (!result.ok()) return result.status();
+                  return target;
+                },
+                std::move(future)),
             self.reference_manager());
       },
       R"(
@@ -523,8 +782,28 @@ Args:
        ready until the batch is submitted.  Therefore, immediately awaiting the
        returned future will lead to deadlock.
 
+  out: Existing writable array into which to read, rather than allocating a
+    new array.  May be a :py:obj:`numpy.ndarray`, any object supporting the
+    buffer protocol, or a `DLPack <https://dmlc.github.io/dlpack/latest/>`__
+    tensor in host memory (including pinned memory for transfer to a GPU),
+    with the same data type and rank as this TensorStore, and
+    a shape compatible with the current domain.  The data is written directly
+    into its memory, which must not be accessed until the returned future
+    becomes ready.  If specified, :py:param:`order` is ignored.
+
+    Only numeric data types are supported.
+
+    >>> out = np.zeros([5, 4], dtype=np.uint32)
+    >>> await dataset[5:10, 8:12].read(out=out)
+    array([[0, 0, 0, 0],
+           [0, 0, 0, 0],
+           [0, 0, 0, 0],
+           [0, 0, 0, 0],
+           [0, 0, 0, 0]], dtype=uint32)
+
 Returns:
-  A future representing the asynchronous read result.
+  A future representing the asynchronous read result.  If :py:param:`out` is
+  specified, the result refers to the memory of :py:param:`out`.
 
 .. tip::
 
@@ -546,7 +825,77 @@ Group:
   I/O
 
 )",
-      py::kw_only(), py::arg("order") = "C", py::arg("batch") = std::nullopt);
+      py::kw_only(), py::arg("order") = "C", py::arg("batch") = std::nullopt,
+      py::arg("out") = std::nullopt);
+
+  cls.def(
+      "iter_chunks",
+      [](Self& self, size_t prefetch, ContiguousLayoutOrder order) {
+        return ValueOrThrow(ChunkIterator::Make(
+            py::reinterpret_borrow<py::object>(
+                reinterpret_cast<PyObject*>(&self)),
+            self.value, order, prefetch));
+      },
+      R"(
+Iterates over the data within the current domain, one chunk at a time.
+
+The domain is partitioned by the read chunk grid of :py:obj:`.chunk_layout`.
+Each iteration yields a :python:`(domain, array)` pair, where :python:`domain`
+is the intersection of a grid cell with the current domain, and
+:python:`array` is its data.  Reads of the following chunks are issued in the
+background and the GIL is released while waiting, so that processing of each
+chunk in Python overlaps with reading the next ones.
+
+Example:
+
+    >>> dataset = await ts.open(
+    ...     {
+    ...         'driver': 'zarr',
+    ...         'kvstore': {
+    ...             'driver': 'memory'
+    ...         }
+    ...     },
+    ...     dtype=ts.uint32,
+    ...     shape=[4, 5],
+    ...     chunk_layout=ts.ChunkLayout(chunk_shape=[2, 3]),
+    ...     create=True)
+    >>> await dataset.write(np.arange(20, dtype=np.uint32).reshape(4, 5))
+    >>> for domain, chunk in dataset.iter_chunks(prefetch=2):
+    ...     print(domain.origin, chunk.shape, chunk.sum())
+    (0, 0) (2, 3) 21
+    (0, 3) (2, 2) 24
+    (2, 0) (2, 3) 81
+    (2, 3) (2, 2) 64
+
+Args:
+  prefetch: Number of chunk reads, in addition to the one being waited on, to
+    keep in flight.
+  order: Order in which the chunks are visited, which is also the contiguous
+    layout order of the returned arrays:
+
+    :python:`'C'`
+      Specifies C order, i.e. the last dimension varies fastest.
+
+    :python:`'F'`
+      Specifies Fortran order, i.e. the first dimension varies fastest.
+
+Returns:
+  An iterator over :python:`(domain, array)` pairs, where :python:`domain` is
+  an :py:obj:`IndexDomain` and :python:`array` is a :py:obj:`numpy.ndarray`
+  with a zero origin.
+
+Raises:
+  ValueError: If the current domain is unbounded.
+
+See also:
+
+  - :py:obj:`.read`
+
+Group:
+  I/O
+
+)",
+      py::kw_only(), py::arg("prefetch") = 2, py::arg("order") = "C");
 
   ForwardWriteSetters([&](auto... param_def) {
     std::string doc = R"(
@@ -753,6 +1102,75 @@ writes to be read:
         MakeKeywordArgumentPyArg(param_def)...);
   });
 
+  cls.def(
+      "write_points",
+      [](Self& self, ArrayArgumentPlaceholder coords,
+         ArrayArgumentPlaceholder values) -> PythonFutureWrapper<void> {
+        SharedArray<const Index, 2> coords_array;
+        ConvertToArray<const Index, 2, /*nothrow=*/false>(coords.value,
+                                                          &coords_array);
+        SharedArray<const void> values_array;
+        ConvertToArray<const void, dynamic_rank, /*nothrow=*/false>(
+            values.value, &values_array, self.value.dtype(), 0, 1);
+        Future<const void> future;
+        {
+          GilScopedRelease gil_release;
+          future = WritePoints(self.value, std::move(coords_array),
+                               std::move(values_array));
+        }
+        return PythonFutureWrapper<void>(std::move(future),
+                                         self.reference_manager());
+      },
+      R"(
+Writes values to a set of scattered points.
+
+This is equivalent to writing :python:`values[i]` to
+:python:`self[tuple(coords[i])]` for each :python:`i`, but the points are sorted
+by :ref:`write chunk<chunk-layout>`, and the points within each chunk are
+written by a single operation.  This is much more efficient than writing each
+point individually.
+
+If this TensorStore is not bound to a :py:obj:`.transaction`, all points are
+committed as a single transaction.  Otherwise, the points are written to the
+existing transaction, which is not committed.
+
+If the same point is specified more than once, the last value takes precedence.
+
+Example:
+
+    >>> dataset = await ts.open(
+    ...     {
+    ...         'driver': 'zarr',
+    ...         'kvstore': {
+    ...             'driver': 'memory'
+    ...         }
+    ...     },
+    ...     dtype=ts.uint32,
+    ...     shape=[4, 5],
+    ...     create=True)
+    >>> await dataset.write_points([[0, 1], [3, 4], [2, 0]], [1, 2, 3])
+    >>> await dataset.read()
+    array([[0, 1, 0, 0, 0],
+           [0, 0, 0, 0, 0],
+           [3, 0, 0, 0, 0],
+           [0, 0, 0, 0, 2]], dtype=uint32)
+
+Args:
+  coords: Integer array of shape :python:`(n, self.rank)` specifying the
+    coordinates of each point, within :py:obj:`.domain`.
+  values: Array of shape :python:`(n,)`, or a scalar, with a data type
+    convertible to :py:obj:`.dtype`.
+
+Returns:
+  Future that becomes ready once the writes are committed, or, if bound to a
+  transaction, once they are reflected in the transaction.
+
+Group:
+  I/O
+
+)",
+      py::arg("coords"), py::arg("values"));
+
   cls.def(
       "resize",
       [](Self& self,
@@ -2251,7 +2669,197 @@ Group:
   // pickling.
 }
 
+/// Region to read by `read_many`, parsed while holding the GIL.
+using ReadManyRegion =
+    std::variant<IndexDomain<>, PythonDimExpression, NumpyIndexingSpec>;
+
+using ReadManyResult =
+    std::variant<SharedArray<void>, std::vector<SharedArray<void>>>;
+
+ReadManyRegion ParseReadManyRegion(py::handle obj) {
+  if (py::isinstance<IndexDomain<>>(obj)) {
+    return py::cast<IndexDomain<>>(obj);
+  }
+  if (py::isinstance<PythonDimExpression>(obj)) {
+    return py::cast<const PythonDimExpression&>(obj);
+  }
+  return ParseIndexingSpec(obj, NumpyIndexingSpec::Mode::kDefault,
+                           NumpyIndexingSpec::Usage::kDirect);
+}
+
+Result<IndexTransform<>> ApplyReadManyRegion(IndexTransform<> transform,
+                                             const ReadManyRegion& region) {
+  if (auto* domain = std::get_if<IndexDomain<>>(&region)) {
+    return (*domain)(std::move(transform));
+  }
+  if (auto* expr = std::get_if<PythonDimExpression>(&region)) {
+    DimensionIndexBuffer dims;
+    return expr->Apply(std::move(transform), &dims, /*domain_only=*/false);
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto spec_transform,
+      ToIndexTransform(std::get<NumpyIndexingSpec>(region),
+                       transform.domain()));
+  return ComposeTransforms(std::move(transform), std::move(spec_transform));
+}
+
+/// Issues a read of each region of `store` as part of `batch`.
+///
+/// If `stack` is `true`, all regions must have the same shape, and are read
+/// directly into consecutive slices of a single array.
+Future<ReadManyResult> ReadMany(const TensorStore<>& store,
+                                span<const ReadManyRegion> regions,
+                                ContiguousLayoutOrder order, Batch batch,
+                                bool stack) {
+  std::vector<IndexTransform<>> transforms;
+  transforms.reserve(regions.size());
+  for (const auto& region : regions) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto transform,
+        ApplyReadManyRegion(IdentityTransform(store.domain()), region),
+        MaybeAnnotateStatus(_, tensorstore::StrCat("Invalid region ",
+                                                   transforms.size())));
+    transforms.push_back(std::move(transform));
+  }
+  std::vector<AnyFuture> futures;
+  futures.reserve(transforms.size());
+  if (stack) {
+    if (transforms.empty()) {
+      return absl::InvalidArgumentError(
+          "At least one region must be specified to stack the results");
+    }
+    const auto shape = transforms[0].input_shape();
+    for (size_t i = 1; i < transforms.size(); ++i) {
+      if (!internal::RangesEqual(transforms[i].input_shape(), shape)) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Cannot stack region ", i, " of shape ",
+            transforms[i].input_shape(), " with region 0 of shape ", shape));
+      }
+    }
+    if (!IsFinite(transforms[0].domain().box())) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Cannot stack regions with unbounded domain ",
+          transforms[0].domain()));
+    }
+    if (shape.size() >= kMaxRank) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Cannot stack regions of rank ", shape.size()));
+    }
+    Index stacked_shape[kMaxRank];
+    stacked_shape[0] = transforms.size();
+    std::copy(shape.begin(), shape.end(), stacked_shape + 1);
+    auto stacked = AllocateArray(
+        span<const Index>(stacked_shape, shape.size() + 1), order,
+        default_init, store.dtype());
+    for (size_t i = 0; i < transforms.size(); ++i) {
+      futures.push_back(tensorstore::Read(
+          store | std::move(transforms[i]),
+          SharedSubArray(stacked, {static_cast<Index>(i)}), batch));
+    }
+    return MapFuture(
+        InlineExecutor{},
+        [futures, stacked = std::move(stacked)](
+            const Result<void>&) -> Result<ReadManyResult> {
+          for (const auto& future : futures) {
+            TENSORSTORE_RETURN_IF_ERROR(future.status());
+          }
+          return stacked;
+        },
+        WaitAllFuture(futures));
+  }
+  std::vector<Future<SharedArray<void>>> array_futures;
+  array_futures.reserve(transforms.size());
+  for (auto& transform : transforms) {
+    auto future = tensorstore::Read<zero_origin>(store | std::move(transform),
+                                                 order, batch);
+    futures.push_back(future);
+    array_futures.push_back(std::move(future));
+  }
+  return MapFuture(
+      InlineExecutor{},
+      [array_futures = std::move(array_futures)](
+          const Result<void>&) -> Result<ReadManyResult> {
+        std::vector<SharedArray<void>> arrays;
+        arrays.reserve(array_futures.size());
+        for (const auto& future : array_futures) {
+          TENSORSTORE_ASSIGN_OR_RETURN(auto array, future.result());
+          arrays.push_back(std::move(array));
+        }
+        return arrays;
+      },
+      WaitAllFuture(futures));
+}
+
 void DefineTensorStoreFunctions(py::module m) {
+  m.def(
+      "read_many",
+      [](PythonTensorStoreObject& store, py::sequence regions,
+         ContiguousLayoutOrder order, std::optional<Batch> batch,
+         bool stack) -> PythonFutureWrapper<ReadManyResult> {
+        std::vector<ReadManyRegion> parsed_regions;
+        parsed_regions.reserve(regions.size());
+        for (py::handle region : regions) {
+          parsed_regions.push_back(ParseReadManyRegion(region));
+        }
+        Future<ReadManyResult> future;
+        {
+          GilScopedRelease gil_release;
+          // Reads are coalesced when the batch is submitted, which for a newly
+          // created batch is when it is destroyed after issuing all reads.
+          future = ReadMany(store.value, parsed_regions, order,
+                            batch ? ValidateOptionalBatch(std::move(batch))
+                                  : Batch::New(),
+                            stack);
+        }
+        return PythonFutureWrapper<ReadManyResult>(std::move(future),
+                                                   store.reference_manager());
+      },
+      R"(
+Reads multiple regions of a TensorStore as a single batch.
+
+This is equivalent to reading each region with
+:python:`store[region].read(batch=batch)`, but issues all reads with a single
+release of the GIL and returns a single future, which avoids the per-read
+overhead of Python futures.  Since all reads are part of the same
+:py:obj:`Batch`, reads of the same chunks or shards may be coalesced.
+
+Example:
+
+    >>> store = ts.array(np.arange(20, dtype=np.int32).reshape(4, 5))
+    >>> await ts.read_many(store, [(0, slice(1, 3)), (2, slice(0, 2))])
+    [array([1, 2], dtype=int32), array([10, 11], dtype=int32)]
+    >>> await ts.read_many(store, [ts.d[0][1], ts.d[0][3]], stack=True)
+    array([[ 5,  6,  7,  8,  9],
+           [15, 16, 17, 18, 19]], dtype=int32)
+
+Args:
+  store: TensorStore from which to read.
+  regions: Regions to read.  Each region may be a NumPy-style indexing
+    expression (as accepted by :py:obj:`TensorStore.__getitem__`), a
+    :py:obj:`DimExpression`, or an :py:obj:`IndexDomain`.
+  order: Contiguous layout order of the returned arrays.
+  batch: Batch to use for the reads.  If not specified, a new batch is used,
+    which is submitted once all reads have been issued.
+
+    .. warning::
+
+       If specified, the returned :py:obj:`Future` will not, in general, become
+       ready until the batch is submitted.
+
+  stack: If :python:`True`, all regions must have the same shape, and are read
+    directly into a single array in which the first dimension indexes the
+    regions.  Otherwise, a list of arrays is returned.
+
+Returns:
+  A future representing the list of arrays, or the stacked array.
+
+Group:
+  I/O
+)",
+      py::arg("store"), py::arg("regions"), py::kw_only(),
+      py::arg("order") = "C", py::arg("batch") = std::nullopt,
+      py::arg("stack") = false);
+
   m.def(
       "array",
       [](ArrayArgumentPlaceholder array, std::optional<DataTypeLike> dtype,
@@ -2746,6 +3354,29 @@ Group:
   });
 }
 
+using ChunkIteratorCls = py::class_<ChunkIterator>;
+
+ChunkIteratorCls DefineChunkIteratorClass(py::handle m) {
+  return ChunkIteratorCls(m, "ChunkIterator", R"(
+Iterator over the chunks of a :py:class:`TensorStore`.
+
+.. seealso::
+
+   :py:obj:`tensorstore.TensorStore.iter_chunks`
+
+Group:
+  I/O
+)");
+}
+
+void DefineChunkIteratorAttributes(ChunkIteratorCls& cls) {
+  cls.def("__iter__", [](py::object self) { return self; });
+  cls.def("__next__", [](py::handle self) {
+    PythonCriticalSection lock(self.ptr());
+    return py::cast<ChunkIterator&>(self).Next();
+  });
+}
+
 using ArrayStorageStatisticsCls = py::class_<ArrayStorageStatistics>;
 
 ArrayStorageStatisticsCls DefineArrayStorageStatisticsClass(py::handle m) {
@@ -2868,6 +3499,9 @@ void RegisterTensorStoreBindings(pybind11::module m, Executor defer) {
     DefineTensorStoreAttributes(cls);
     DefineTensorStoreFunctions(m);
   });
+  defer([cls = DefineChunkIteratorClass(tensorstore_cls)]() mutable {
+    DefineChunkIteratorAttributes(cls);
+  });
   defer([cls = DefineArrayStorageStatisticsClass(tensorstore_cls)]() mutable {
     DefineArrayStorageStatisticsAttributes(cls);
   });
@@ -63,6 +63,7 @@ Allow write access.  Defaults to `True` if neither ``read`` nor ``write`` is spe
 using spec_setters::SetAssumeCachedMetadata;
 using spec_setters::SetAssumeMetadata;
 using spec_setters::SetCreate;
+using spec_setters::SetDeferValidation;
 using spec_setters::SetDeleteExisting;
 using spec_setters::SetOpen;
 using spec_setters::SetOpenMode;
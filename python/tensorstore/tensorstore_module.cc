@@ -63,6 +63,13 @@ PYBIND11_MODULE(_tensorstore, m) {
   internal_python::InitializePythonImports();
   internal_python::SetupExitHandler();
   internal_python::InitializePythonComponents(m);
+
+#if defined(Py_GIL_DISABLED) && PYBIND11_VERSION_HEX >= 0x020D0000
+  // State that would otherwise be guarded by the GIL is guarded by
+  // `PythonCriticalSection` or `PythonMutex`.  pybind11 itself supports
+  // free-threaded builds as of version 2.13.
+  PyUnstable_Module_SetGIL(m.ptr(), Py_MOD_GIL_NOT_USED);
+#endif
 }
 
 }  // namespace
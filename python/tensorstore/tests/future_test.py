@@ -16,6 +16,8 @@ import asyncio
 import os
 import pickle
 import signal
+import subprocess
+import sys
 import threading
 import time
 
@@ -148,6 +150,20 @@ def test_coroutine_no_event_loop_specified():
     ts.Future(do_async())
 
 
+def test_asyncio_imported_on_demand():
+  # Importing `asyncio` is deferred until it is needed, to reduce startup time.
+  subprocess.run(
+      [
+          sys.executable,
+          '-c',
+          'import sys; import tensorstore as ts; '
+          'ts.array([1, 2]).read().result(); '
+          'assert "asyncio" not in sys.modules',
+      ],
+      check=True,
+  )
+
+
 def test_gc_result_cycle(gc_tester):
   obj = []
   f = ts.Future(obj)
@@ -214,3 +230,56 @@ def test_promise_not_fulfilled():
   del p
   assert f.done()
   assert exc is not None
+
+
+async def test_await_many():
+  pairs = [ts.Promise.new() for _ in range(1000)]
+
+  def resolve():
+    for i, (promise, _) in enumerate(pairs):
+      if i % 10 == 0:
+        promise.set_exception(ValueError(str(i)))
+      else:
+        promise.set_result(i)
+
+  t = threading.Thread(target=resolve)
+  t.start()
+  results = await asyncio.gather(
+      *(future for _, future in pairs), return_exceptions=True
+  )
+  t.join()
+  for i, result in enumerate(results):
+    if i % 10 == 0:
+      assert isinstance(result, ValueError)
+    else:
+      assert result == i
+
+
+def test_concurrent_done_callbacks():
+  # Exercises the per-future locking used in free-threaded builds.
+  pairs = [ts.Promise.new() for _ in range(200)]
+  called = [0] * len(pairs)
+  lock = threading.Lock()
+
+  def make_callback(i):
+    def callback(f):
+      with lock:
+        called[i] += 1
+
+    return callback
+
+  def add_callbacks():
+    for i, (_, future) in enumerate(pairs):
+      future.add_done_callback(make_callback(i))
+      removed_callback = lambda f: None
+      future.add_done_callback(removed_callback)
+      future.remove_done_callback(removed_callback)
+
+  threads = [threading.Thread(target=add_callbacks) for _ in range(4)]
+  for t in threads:
+    t.start()
+  for promise, _ in pairs:
+    promise.set_result(None)
+  for t in threads:
+    t.join()
+  assert called == [4] * len(pairs)
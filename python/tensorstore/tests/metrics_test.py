@@ -52,3 +52,55 @@ async def test_collect_prometheus_format_metrics():
   # There are a lot of metrics, including these which should be 0.
   assert 'tensorstore_cache_chunk_cache_reads 0' in metric_list
   assert 'tensorstore_cache_chunk_cache_writes 0' in metric_list
+
+
+def test_gil_metrics():
+  t = ts.array([1, 2, 3])
+  # Blocking on a result releases and reacquires the GIL.
+  assert t[0].read().result() == 1
+  metrics = {
+      m['name']: m['values'][0]['value']
+      for m in ts.experimental_collect_matching_metrics(
+          '/tensorstore/python/gil_', include_zero_metrics=True
+      )
+  }
+  assert metrics['/tensorstore/python/gil_acquire'] >= 0
+  assert metrics['/tensorstore/python/gil_wait_ns'] >= 0
+
+
+async def test_collect_inflight_operations():
+  t = await ts.open({
+      'driver': 'zarr',
+      'kvstore': 'memory://',
+      'dtype': 'int32',
+      'metadata': {'shape': [4], 'chunks': [2]},
+      'create': True,
+  })
+  await t.write([1, 2, 3, 4])
+  assert await t.read() is not None
+  # All operations have completed.
+  operations = ts.experimental_collect_inflight_operations()
+  assert isinstance(operations, list)
+  for op in operations:
+    assert set(op.keys()) >= {'type', 'description', 'state', 'elapsed_ms'}
+
+
+async def test_access_trace():
+  t = await ts.open({
+      'driver': 'zarr',
+      'kvstore': 'memory://',
+      'dtype': 'int32',
+      'metadata': {'shape': [4], 'chunks': [2]},
+      'create': True,
+  })
+  ts.experimental_start_access_trace()
+  await t.write([1, 2, 3, 4])
+  assert await t[1:3].read() is not None
+  trace = ts.experimental_stop_access_trace()
+  assert trace['num_dropped'] == 0
+  assert [e['op'] for e in trace['events']] == ['write', 'read']
+  read = trace['events'][1]
+  assert read['ok']
+  assert read['transform']['input_inclusive_min'] == [1]
+  assert read['transform']['input_exclusive_max'] == [3]
+  assert read['start_ms'] <= read['end_ms']
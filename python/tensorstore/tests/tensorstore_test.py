@@ -540,3 +540,179 @@ async def test_zero_copy(writable: bool):
   # purposes.
   arr[...] = 43
   np.testing.assert_equal(43, await store.read())
+
+
+async def test_read_out():
+  store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+  out = np.zeros([2, 4], dtype=np.int32)
+  result = await store[1:3].read(out=out)
+  np.testing.assert_equal(out, [[4, 5, 6, 7], [8, 9, 10, 11]])
+  np.testing.assert_equal(result, out)
+  # Non-contiguous views are written in place.
+  out = np.zeros([4, 4], dtype=np.int32)
+  await store[0:2, 0:2].read(out=out.T[1:3, 2:4])
+  np.testing.assert_equal(out[2:4, 1:3], [[0, 4], [1, 5]])
+  # Buffer protocol objects.
+  buf = bytearray(16)
+  await store[0].read(out=memoryview(buf).cast('i'))
+  np.testing.assert_equal(np.frombuffer(buf, dtype=np.int32), [0, 1, 2, 3])
+
+
+class _DLPackOnly:
+  """Exposes an array only through the DLPack protocol."""
+
+  def __init__(self, array):
+    self._array = array
+
+  def __dlpack__(self, stream=None):
+    return self._array.__dlpack__()
+
+  def __dlpack_device__(self):
+    return self._array.__dlpack_device__()
+
+
+async def test_read_out_dlpack():
+  store = ts.array(np.arange(6, dtype=np.float32).reshape(2, 3))
+  out = np.zeros([3, 2], dtype=np.float32)
+  await store.read(out=_DLPackOnly(out.T))
+  np.testing.assert_equal(out.T, store.read().result())
+  with pytest.raises(ValueError):
+    await store.read(out=_DLPackOnly(np.zeros([2, 3], dtype=np.float64)))
+
+
+async def test_read_out_invalid():
+  store = ts.array(np.arange(4, dtype=np.int32))
+  with pytest.raises(ValueError):
+    # Would require a copy.
+    await store.read(out=np.zeros([4], dtype=np.int64))
+  readonly = np.zeros([4], dtype=np.int32)
+  readonly.setflags(write=False)
+  with pytest.raises(ValueError):
+    await store.read(out=readonly)
+  with pytest.raises(ValueError):
+    await store.read(out=np.zeros([3], dtype=np.int32))
+  with pytest.raises(ValueError):
+    await ts.array(np.array(["a"], dtype=object), dtype=ts.string).read(
+        out=np.zeros([1], dtype=object)
+    )
+
+
+async def test_read_many():
+  store = ts.array(np.arange(20, dtype=np.int32).reshape(4, 5))
+  arrays = await ts.read_many(
+      store,
+      [
+          (0, slice(1, 3)),
+          ts.d[0][1:3],
+          ts.IndexDomain(shape=[1, 2]),
+      ],
+  )
+  assert len(arrays) == 3
+  np.testing.assert_equal(arrays[0], [1, 2])
+  np.testing.assert_equal(arrays[1], store[1:3].read().result())
+  np.testing.assert_equal(arrays[2], [[0, 1]])
+
+
+async def test_read_many_stack():
+  store = ts.array(np.arange(20, dtype=np.int32).reshape(4, 5))
+  stacked = await ts.read_many(
+      store, [(slice(0, 2), 1), (slice(2, 4), 3)], stack=True
+  )
+  np.testing.assert_equal(stacked, [[1, 6], [13, 18]])
+  with pytest.raises(ValueError, match="Cannot stack region 1"):
+    await ts.read_many(store, [(0,), (slice(0, 2), 0)], stack=True)
+
+
+async def test_read_many_batch():
+  store = await ts.open(
+      {"driver": "zarr3", "kvstore": "memory://"},
+      dtype=ts.int32,
+      shape=[8],
+      create=True,
+  )
+  await store.write(np.arange(8, dtype=np.int32))
+  with ts.Batch() as batch:
+    future = ts.read_many(store, [slice(0, 2), slice(4, 6)], batch=batch)
+  np.testing.assert_equal(await future, [[0, 1], [4, 5]])
+
+
+async def test_iter_chunks():
+  store = await ts.open(
+      {"driver": "zarr3", "kvstore": "memory://"},
+      dtype=ts.int32,
+      shape=[5, 4],
+      chunk_layout=ts.ChunkLayout(chunk_shape=[2, 3]),
+      create=True,
+  )
+  data = np.arange(20, dtype=np.int32).reshape(5, 4)
+  await store.write(data)
+  chunks = list(store[1:, :].iter_chunks(prefetch=1))
+  assert [domain.origin for domain, _ in chunks] == [
+      (1, 0),
+      (1, 3),
+      (2, 0),
+      (2, 3),
+      (4, 0),
+      (4, 3),
+  ]
+  for domain, chunk in chunks:
+    np.testing.assert_equal(chunk, data[domain.index_exp])
+
+
+async def test_iter_chunks_fortran_order():
+  store = await ts.open(
+      {"driver": "zarr3", "kvstore": "memory://"},
+      dtype=ts.int32,
+      shape=[4, 4],
+      chunk_layout=ts.ChunkLayout(chunk_shape=[2, 2]),
+      create=True,
+  )
+  domains = [domain.origin for domain, _ in store.iter_chunks(order="F")]
+  assert domains == [(0, 0), (2, 0), (0, 2), (2, 2)]
+
+
+
+async def test_write_points():
+  store = await ts.open(
+      {"driver": "zarr3", "kvstore": "memory://"},
+      dtype=ts.int32,
+      shape=[6, 6],
+      chunk_layout=ts.ChunkLayout(chunk_shape=[2, 2]),
+      create=True,
+  )
+  coords = np.array([[5, 5], [0, 1], [4, 0], [0, 0], [5, 5]])
+  await store.write_points(coords, [1, 2, 3, 4, 5])
+  expected = np.zeros([6, 6], dtype=np.int32)
+  expected[0, 1] = 2
+  expected[4, 0] = 3
+  expected[0, 0] = 4
+  # The last value for a repeated point takes precedence.
+  expected[5, 5] = 5
+  np.testing.assert_equal(await store.read(), expected)
+
+  await store.write_points([[1, 1], [2, 3]], 7)
+  expected[1, 1] = 7
+  expected[2, 3] = 7
+  np.testing.assert_equal(await store.read(), expected)
+
+
+async def test_write_points_transaction():
+  store = await ts.open(
+      {"driver": "zarr3", "kvstore": "memory://"},
+      dtype=ts.int32,
+      shape=[4],
+      create=True,
+  )
+  txn = ts.Transaction()
+  await store.with_transaction(txn).write_points([[1], [3]], [5, 6])
+  np.testing.assert_equal(await store.read(), [0, 0, 0, 0])
+  await txn.commit_async()
+  np.testing.assert_equal(await store.read(), [0, 5, 0, 6])
+
+
+async def test_write_points_invalid():
+  store = ts.array(np.zeros([4, 4], dtype=np.int32), write=True)
+  with pytest.raises(ValueError, match="Coordinates must have shape"):
+    await store.write_points([[1, 2, 3]], [1])
+  with pytest.raises(ValueError, match="Invalid values"):
+    await store.write_points([[1, 2], [2, 3]], [1, 2, 3])
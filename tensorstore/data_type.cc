@@ -32,6 +32,7 @@
 #include <nlohmann/json.hpp>
 #include "tensorstore/data_type_conversion.h"
 #include "tensorstore/index.h"
+#include "tensorstore/internal/chunk_buffer_pool.h"
 #include "tensorstore/internal/json/same.h"
 #include "tensorstore/internal/json/value_as.h"
 #include "tensorstore/internal/utf8.h"
@@ -97,9 +98,39 @@ void DestroyAndFree(std::ptrdiff_t n, DataType r, void* ptr) {
   }
 }
 
+namespace {
+
+// Allocates from `pool`, if the allocation is large enough to be served by it.
+std::shared_ptr<void> AllocateAndConstructFromPool(
+    internal::ChunkBufferPool& pool, std::ptrdiff_t n,
+    ElementInitialization initialization, DataType r) {
+  const size_t size = static_cast<size_t>(r->size) * n;
+  if (size < internal::ChunkBufferPool::kMinBufferSize) return nullptr;
+  bool zeroed;
+  // Buffers are page-aligned, which satisfies the alignment of any type.
+  void* ptr = pool.Allocate(size, zeroed);
+  if (!ptr) return nullptr;
+  if (initialization == value_init && !zeroed) {
+    std::memset(ptr, 0, size);
+  }
+  r->construct(n, ptr);
+  return std::shared_ptr<void>(
+      ptr, [pool = pool.shared_from_this(), r, n, size](void* x) {
+        r->destroy(n, x);
+        pool->Deallocate(x, size);
+      });
+}
+
+}  // namespace
+
 template <>
 std::shared_ptr<void> AllocateAndConstructShared<void>(
     std::ptrdiff_t n, ElementInitialization initialization, DataType r) {
+  if (auto* pool = internal::GetCurrentChunkBufferPool()) {
+    if (auto ptr = AllocateAndConstructFromPool(*pool, n, initialization, r)) {
+      return ptr;
+    }
+  }
   if (void* ptr = AllocateAndConstruct(n, initialization, r)) {
     return std::shared_ptr<void>(ptr,
                                  [r, n](void* x) { DestroyAndFree(n, r, x); });
@@ -21,7 +21,9 @@
 #include <type_traits>
 
 #include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
 #include "tensorstore/internal/elementwise_function.h"
+#include "tensorstore/internal/vectorized_conversion.h"
 #include "tensorstore/util/result.h"
 
 namespace tensorstore {
@@ -31,6 +33,15 @@ struct ConvertDataType {
   void operator()(const From* from, To* to, void* arg) const {
     *to = static_cast<To>(*from);
   }
+
+  // Common numeric conversions of contiguous arrays are handled by vectorized
+  // kernels.
+  template <typename F = From>
+  static std::enable_if_t<internal::HasVectorizedConversion<F, To>, Index>
+  ApplyContiguous(Index count, const F* from, To* to, void* arg) {
+    internal::ConvertContiguous(from, to, count);
+    return count;
+  }
 };
 
 template <typename From, typename To>
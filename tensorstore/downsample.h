@@ -18,13 +18,19 @@
 /// \file
 /// Downsampling adapter for TensorStore objects.
 
+#include <utility>
+#include <vector>
+
 #include "tensorstore/downsample_method.h"
 #include "tensorstore/driver/downsample/downsample.h"
+#include "tensorstore/driver/downsample/pyramid.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/spec.h"
 #include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 
@@ -99,6 +105,30 @@ Result<Spec> Downsample(const Spec& base_spec,
       base_spec, span<const Index>(downsample_factors), downsample_method);
 }
 
+/// Writes the levels of a multi-resolution pyramid in a single pass over
+/// `base`.
+///
+/// Equivalent to successively writing each of `levels` from a `Downsample` view
+/// of the previous level, but reads each block of `base` only once and writes
+/// the corresponding regions of all levels as soon as the block is available.
+///
+/// \param base Base level, must support reading.
+/// \param levels Downsampled levels, must support writing.
+/// \param downsample_factors Factors by which each level is downsampled
+///     relative to the previous level.  Must have length equal to
+///     `base.rank()`.
+/// \param downsample_method The downsampling method.
+/// \error `absl::StatusCode::kInvalidArgument` if `levels` are not compatible
+///     with `base`, or `downsample_factors` is invalid.
+/// \ingroup downsample
+inline Future<void> WriteDownsamplePyramid(
+    TensorStore<> base, std::vector<TensorStore<>> levels,
+    span<const Index> downsample_factors, DownsampleMethod downsample_method) {
+  return internal_downsample::WritePyramid(std::move(base), std::move(levels),
+                                           downsample_factors,
+                                           downsample_method);
+}
+
 }  // namespace tensorstore
 
 #endif  // TENSORSTORE_DOWNSAMPLE_H_
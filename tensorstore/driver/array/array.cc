@@ -14,13 +14,18 @@
 
 #include "tensorstore/driver/array/array.h"
 
+#include <stddef.h>
+
+#include <algorithm>
 #include <cassert>
+#include <mutex>  // NOLINT
 #include <utility>
 
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/array.h"
 #include "tensorstore/array_storage_statistics.h"
+#include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/container_kind.h"
@@ -32,6 +37,7 @@
 #include "tensorstore/driver/driver_spec.h"
 #include "tensorstore/driver/registry.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/index_space/dimension_permutation.h"
 #include "tensorstore/index_space/dimension_units.h"
@@ -54,6 +60,7 @@
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/constant_vector.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/executor.h"
@@ -242,17 +249,62 @@ class ArrayDriver
       GetStorageStatisticsRequest request) override;
 
  private:
+  /// Number of stripes, along the first dimension of `data_`, that are locked
+  /// independently.
+  constexpr static size_t kNumLockStripes = 16;
+
+  /// Half-open range of lock stripes.
+  struct LockStripes {
+    size_t begin = 0;
+    size_t end = kNumLockStripes;
+  };
+
+  /// Returns the stripes of `data_` that may be accessed through `transform`.
+  LockStripes GetLockStripes(IndexTransformView<> transform);
+
+  /// Registers a lock on each of the specified `stripes`.
+  void RegisterLocks(internal::LockCollection& lock_collection,
+                     LockStripes stripes, bool shared);
+
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency_;
   SharedArray<void> data_;
   DimensionUnitsVector dimension_units_;
 
   /// Controls access to the data referred to by `data_`.
   ///
-  /// A shared lock must be held while reading from `data_`, and an exclusive
-  /// lock must be held while writing to `data_`.
-  absl::Mutex mutex_;
+  /// The first dimension of `data_` is divided into `kNumLockStripes` ranges
+  /// of equal size, each guarded by one mutex; if `data_` has rank 0, only the
+  /// first mutex is used.  A shared lock on a stripe must be held while
+  /// reading from it, and an exclusive lock must be held while writing to it,
+  /// such that writes to non-overlapping regions proceed concurrently.
+  absl::Mutex mutexes_[kNumLockStripes];
 };
 
+ArrayDriver::LockStripes ArrayDriver::GetLockStripes(
+    IndexTransformView<> transform) {
+  if (data_.rank() == 0) return {0, 1};
+  Box<> output_range(data_.rank());
+  if (!GetOutputRange(transform, output_range).ok()) return {};
+  const IndexInterval interval =
+      Intersect(output_range[0], data_.domain()[0]);
+  if (interval.empty()) return {0, 0};
+  const Index stripe_size =
+      CeilOfRatio(data_.shape()[0], static_cast<Index>(kNumLockStripes));
+  return {static_cast<size_t>(interval.inclusive_min() / stripe_size),
+          static_cast<size_t>(interval.inclusive_max() / stripe_size) + 1};
+}
+
+void ArrayDriver::RegisterLocks(internal::LockCollection& lock_collection,
+                                LockStripes stripes, bool shared) {
+  for (size_t i = stripes.begin; i < stripes.end; ++i) {
+    if (shared) {
+      lock_collection.RegisterShared(mutexes_[i]);
+    } else {
+      lock_collection.RegisterExclusive(mutexes_[i]);
+    }
+  }
+}
+
 absl::Status TransactionError() {
   return absl::UnimplementedError(
       "\"array\" driver does not support transactions");
@@ -271,9 +323,10 @@ void ArrayDriver::Read(
   // Implementation of `tensorstore::ReadChunk::Impl` Poly interface.
   struct ChunkImpl {
     IntrusivePtr<ArrayDriver> self;
+    LockStripes stripes;
 
     absl::Status operator()(internal::LockCollection& lock_collection) {
-      lock_collection.RegisterShared(self->mutex_);
+      self->RegisterLocks(lock_collection, stripes, /*shared=*/true);
       return absl::OkStatus();
     }
 
@@ -282,6 +335,11 @@ void ArrayDriver::Read(
                                        Arena* arena) {
       return GetTransformedArrayNDIterable(self->data_, chunk_transform, arena);
     }
+
+    bool operator()(ReadChunk::ReadArray, IndexTransformView<>,
+                    SharedOffsetArray<const void>&) {
+      return false;
+    }
   };
   // Cancellation does not make sense since there is only a single call to
   // `set_value` which occurs immediately after `set_starting`.
@@ -290,10 +348,12 @@ void ArrayDriver::Read(
     execution::set_error(receiver, TransactionError());
   } else {
     auto cell_transform = IdentityTransform(request.transform.input_domain());
-    execution::set_value(receiver,
-                         ReadChunk{ChunkImpl{IntrusivePtr<ArrayDriver>(this)},
-                                   std::move(request.transform)},
-                         std::move(cell_transform));
+    auto stripes = GetLockStripes(request.transform);
+    execution::set_value(
+        receiver,
+        ReadChunk{ChunkImpl{IntrusivePtr<ArrayDriver>(this), stripes},
+                  std::move(request.transform)},
+        std::move(cell_transform));
     execution::set_done(receiver);
   }
   execution::set_stopping(receiver);
@@ -305,9 +365,10 @@ void ArrayDriver::Write(
   // Implementation of `tensorstore::internal::WriteChunk::Impl` Poly interface.
   struct ChunkImpl {
     IntrusivePtr<ArrayDriver> self;
+    LockStripes stripes;
 
     absl::Status operator()(internal::LockCollection& lock_collection) {
-      lock_collection.RegisterExclusive(self->mutex_);
+      self->RegisterLocks(lock_collection, stripes, /*shared=*/false);
       return absl::OkStatus();
     }
 
@@ -340,10 +401,12 @@ void ArrayDriver::Write(
   if (request.transaction) {
     execution::set_error(receiver, TransactionError());
   } else {
-    execution::set_value(receiver,
-                         WriteChunk{ChunkImpl{IntrusivePtr<ArrayDriver>(this)},
-                                    std::move(request.transform)},
-                         std::move(cell_transform));
+    auto stripes = GetLockStripes(request.transform);
+    execution::set_value(
+        receiver,
+        WriteChunk{ChunkImpl{IntrusivePtr<ArrayDriver>(this), stripes},
+                   std::move(request.transform)},
+        std::move(cell_transform));
     execution::set_done(receiver);
   }
   execution::set_stopping(receiver);
@@ -356,7 +419,11 @@ Result<internal::TransformedDriverSpec> ArrayDriver::GetBoundSpec(
   driver_spec->context_binding_state_ = ContextBindingState::bound;
   SharedArray<const void> array;
   {
-    absl::ReaderMutexLock lock(&mutex_);
+    internal::LockCollection lock_collection;
+    RegisterLocks(lock_collection, LockStripes{}, /*shared=*/true);
+    // Locking a mutex never fails.
+    std::unique_lock<internal::LockCollection> lock(lock_collection,
+                                                    std::try_to_lock);
     TENSORSTORE_ASSIGN_OR_RETURN(
         array, tensorstore::TransformArray<zero_origin>(
                    data_, transform, {skip_repeated_elements, must_allocate}));
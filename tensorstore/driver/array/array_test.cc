@@ -161,6 +161,18 @@ TEST(FromArrayTest, ReadIntoNewArray) {
   EXPECT_THAT(read_progress, ::testing::ElementsAre(ReadProgress{6, 6}));
 }
 
+TEST(FromArrayTest, Prefetch) {
+  auto array =
+      tensorstore::MakeOffsetArray<int>({1, 2}, {{1, 2, 3}, {4, 5, 6}});
+  auto store = tensorstore::FromArray(array);
+  std::vector<ReadProgress> read_progress;
+  TENSORSTORE_EXPECT_OK(tensorstore::Prefetch(
+      store, ReadProgressFunction{[&read_progress](ReadProgress progress) {
+        read_progress.push_back(progress);
+      }}));
+  EXPECT_THAT(read_progress, ::testing::ElementsAre(ReadProgress{6, 6}));
+}
+
 /// Tests calling Read with a source domain that does not match the destination
 /// domain.
 TEST(FromArrayTest, ReadDomainMismatch) {
@@ -232,6 +244,43 @@ TEST(FromArrayTest, WriteBroadcast) {
             array);
 }
 
+TEST(FromArrayTest, WriteConcurrentNonOverlapping) {
+  auto array = tensorstore::AllocateArray<int>({64, 8});
+  auto store = tensorstore::FromArray(array);
+  std::vector<tensorstore::WriteFutures> write_futures;
+  for (int i = 0; i < 8; ++i) {
+    write_futures.push_back(tensorstore::Write(
+        tensorstore::MakeScalarArray<int>(i),
+        store | tensorstore::Dims(0).SizedInterval(i * 8, 8)));
+  }
+  for (auto& write_result : write_futures) {
+    TENSORSTORE_EXPECT_OK(write_result.commit_future);
+  }
+  for (int i = 0; i < 64; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      EXPECT_EQ(i / 8, array(i, j)) << i << ", " << j;
+    }
+  }
+}
+
+TEST(FromArrayTest, WriteLarge) {
+  // Large enough to be copied by more than one task.
+  auto array = tensorstore::AllocateArray<int>({4096, 1024});
+  auto store = tensorstore::FromArray(array);
+  auto source = tensorstore::AllocateArray<int>({1024, 4096});
+  for (int i = 0; i < 1024; ++i) {
+    for (int j = 0; j < 4096; ++j) source(i, j) = i * 4096 + j;
+  }
+  TENSORSTORE_EXPECT_OK(
+      tensorstore::Write(source, store | tensorstore::Dims(1, 0).Transpose())
+          .commit_future);
+  for (int i = 0; i < 1024; ++i) {
+    for (int j = 0; j < 4096; ++j) {
+      ASSERT_EQ(i * 4096 + j, array(j, i)) << i << ", " << j;
+    }
+  }
+}
+
 /// Tests calling Write with a source domain that does not match the destination
 /// domain.
 TEST(FromArrayTest, WriteDomainMismatch) {
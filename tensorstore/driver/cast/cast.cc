@@ -316,6 +316,11 @@ struct ReadChunkImpl {
     return GetConvertedInputNDIterable(std::move(iterable), self->target_dtype_,
                                        self->input_conversion_);
   }
+
+  bool operator()(ReadChunk::ReadArray, IndexTransformView<>,
+                  SharedOffsetArray<const void>&) {
+    return false;
+  }
 };
 
 // Implementation of `tensorstore::internal::WriteChunk::Impl` Poly
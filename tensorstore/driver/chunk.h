@@ -28,6 +28,7 @@
 
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
+#include "tensorstore/array.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/index_space/transformed_array.h"
@@ -45,6 +46,7 @@ namespace internal {
 
 struct ReadChunk {
   struct BeginRead {};
+  struct ReadArray {};
   using Impl = poly::Poly<
       sizeof(void*) * 2,
       /*Copyable=*/true,  //
@@ -70,7 +72,23 @@ struct ReadChunk {
       /// \returns An NDIterable with a shape of
       ///     `chunk_transform.input_shape()`.
       Result<NDIterable::Ptr>(BeginRead, IndexTransform<> chunk_transform,
-                              Arena* arena)>;
+                              Arena* arena),
+
+      /// Returns the data directly as a strided array, if supported.
+      ///
+      /// Unlike the `NDIterable` returned by `BeginRead`, the array remains
+      /// valid and unmodified indefinitely, without holding any locks, and may
+      /// therefore be returned to the caller of a read without copying.
+      ///
+      /// \param chunk_transform Transform with a range that is a subset of
+      ///     `transform`.
+      /// \param array[out] Set on success to an array with a domain of
+      ///     `chunk_transform.domain()`.
+      /// 
+eturns `true` if `ReadArray` is supported and `array` has been set,
+      ///     `false` otherwise.
+      bool(ReadArray, IndexTransformView<> chunk_transform,
+           SharedOffsetArray<const void>& array)>;
 
   /// Type-erased chunk implementation.  In the case of the chunks produced by
   /// `ChunkCache::Read`, for example, the contained object holds a
@@ -28,6 +28,7 @@
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/chunk_prefetch.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/staleness_bound.h"
 #include "tensorstore/transaction.h"
@@ -41,9 +42,10 @@ namespace internal {
 /// a `ChunkCache`.
 ///
 /// \tparam Derived Derived `Driver` type, that must define
-///     `size_t component_index()`, `const ChunkCache *cache()`, and
-///     `const StalenessBound &data_staleness_bound()`.  The `Derived` type can
-///     inherit from `ChunkGridSpecificationDriver` to define those methods.
+///     `size_t component_index()`, `const ChunkCache *cache()`,
+///     `const StalenessBound &data_staleness_bound()`, and
+///     `const ChunkPrefetchOptions &prefetch_options()`.  The `Derived` type
+///     can inherit from `ChunkGridSpecificationDriver` to define those methods.
 template <typename Derived, typename Parent>
 class ChunkCacheReadWriteDriverMixin : public Parent {
  public:
@@ -53,7 +55,8 @@ class ChunkCacheReadWriteDriverMixin : public Parent {
       override {
     static_cast<Derived*>(this)->cache()->Read(
         {std::move(request), static_cast<Derived*>(this)->component_index(),
-         static_cast<Derived*>(this)->data_staleness_bound().time},
+         static_cast<Derived*>(this)->data_staleness_bound().time,
+         static_cast<Derived*>(this)->prefetch_options()},
         std::move(receiver));
   }
 
@@ -74,10 +77,12 @@ struct ChunkCacheDriverInitializer {
   CachePtr<CacheType> cache;
   size_t component_index;
   StalenessBound data_staleness_bound;
+  ChunkPrefetchOptions prefetch = {};
 };
 
 /// TensorStore Driver mixin that stores a `CachePtr<ChunkCacheType>`, a
-/// `size_t component_index`, and a `StalenessBound data_staleness_bound`.
+/// `size_t component_index`, a `StalenessBound data_staleness_bound`, and
+/// `ChunkPrefetchOptions prefetch_options`.
 ///
 /// This can be combined with `ChunkCacheReadWriteDriverMixin`, as in
 /// `ChunkCacheDriver`, to implement `Read` and `Write` operations using the
@@ -102,7 +107,8 @@ class ChunkGridSpecificationDriver : public Parent {
       : cache_(
             static_pointer_cast<ChunkCacheType>(std::move(initializer.cache))),
         component_index_(initializer.component_index),
-        data_staleness_bound_(initializer.data_staleness_bound) {
+        data_staleness_bound_(initializer.data_staleness_bound),
+        prefetch_options_(initializer.prefetch) {
     assert(cache_);
     assert(component_index_ < cache()->grid().components.size());
   }
@@ -134,10 +140,16 @@ class ChunkGridSpecificationDriver : public Parent {
     return data_staleness_bound_;
   }
 
+  // NOLINTNEXTLINE(readability/inheritance)
+  virtual const ChunkPrefetchOptions& prefetch_options() const final {
+    return prefetch_options_;
+  }
+
  private:
   CachePtr<ChunkCacheType> cache_;
   size_t component_index_;
   StalenessBound data_staleness_bound_;
+  ChunkPrefetchOptions prefetch_options_;
 };
 
 /// Combines `ChunkGridSpecificationDriver` and
@@ -0,0 +1,217 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/chunk_existence_index.h"
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_kvs_backed_chunk_driver {
+namespace {
+
+class ChunkExistenceIndexKeyValueStore : public kvstore::Driver {
+ public:
+  using Ptr = internal::IntrusivePtr<ChunkExistenceIndexKeyValueStore>;
+
+  explicit ChunkExistenceIndexKeyValueStore(kvstore::DriverPtr base,
+                                            std::string prefix)
+      : base_(std::move(base)), prefix_(std::move(prefix)) {}
+
+  Future<ReadResult> Read(Key key, ReadOptions options) override {
+    if (!absl::StartsWith(key, prefix_)) {
+      return base_->Read(std::move(key), std::move(options));
+    }
+    if (auto listing = GetListing(options.staleness_bound); !listing.null()) {
+      return PromiseFuturePair<ReadResult>::LinkValue(
+                 [self = Ptr(this), key = std::move(key),
+                  options = std::move(options)](
+                     Promise<ReadResult> promise,
+                     ReadyFuture<const void>) mutable {
+                   LinkResult(std::move(promise),
+                              self->ReadUsingIndex(std::move(key),
+                                                   std::move(options)));
+                 },
+                 std::move(listing))
+          .future;
+    }
+    return ReadUsingIndex(std::move(key), std::move(options));
+  }
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override {
+    if (value) AddKey(key);
+    return base_->Write(std::move(key), std::move(value), std::move(options));
+  }
+
+  absl::Status ReadModifyWrite(internal::OpenTransactionPtr& transaction,
+                               size_t& phase, Key key,
+                               ReadModifyWriteSource& source) override {
+    AddKey(key);
+    return base_->ReadModifyWrite(transaction, phase, std::move(key), source);
+  }
+
+  absl::Status TransactionalDeleteRange(
+      const internal::OpenTransactionPtr& transaction,
+      KeyRange range) override {
+    return base_->TransactionalDeleteRange(transaction, std::move(range));
+  }
+
+  Future<const void> DeleteRange(KeyRange range) override {
+    return base_->DeleteRange(std::move(range));
+  }
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override {
+    base_->ListImpl(std::move(options), std::move(receiver));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    return base_->DescribeKey(key);
+  }
+
+  Result<kvstore::DriverSpecPtr> GetBoundSpec() const override {
+    return base_->GetBoundSpec();
+  }
+
+  kvstore::SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const override {
+    // Only whole-value writes are supported through the index.
+    return base_->GetSupportedFeatures(key_range) &
+           ~kvstore::SupportedFeatures::kByteRangeWrite;
+  }
+
+  void GarbageCollectionVisit(
+      garbage_collection::GarbageCollectionVisitor& visitor) const final {
+    // No-op
+  }
+
+ private:
+  /// Returns a future that becomes ready when a listing that satisfies
+  /// `staleness_bound` completes, starting one if necessary.
+  ///
+  /// Returns a null future if the index already satisfies `staleness_bound`,
+  /// or if no listing can satisfy it without waiting for an unrelated one.
+  Future<const void> GetListing(absl::Time staleness_bound) {
+    Promise<void> promise;
+    Future<const void> future;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (staleness_bound <= indexed_time_) return {};
+      if (!pending_.null()) {
+        return pending_time_ >= staleness_bound ? pending_
+                                                : Future<const void>();
+      }
+      const absl::Time now = absl::Now();
+      if (staleness_bound > now) return {};
+      pending_time_ = now;
+      auto pair = PromiseFuturePair<void>::Make();
+      promise = std::move(pair.promise);
+      pending_ = future = std::move(pair.future);
+    }
+    kvstore::ListOptions options;
+    options.range = KeyRange::Prefix(prefix_);
+    kvstore::ListFuture(base_.get(), std::move(options))
+        .ExecuteWhenReady(
+            [self = Ptr(this), promise = std::move(promise)](
+                ReadyFuture<std::vector<kvstore::ListEntry>> f) {
+              self->OnListingReady(f.result());
+              // Reads proceed even if listing failed, since they are then
+              // forwarded to the base kvstore.
+              promise.SetResult(absl::OkStatus());
+            });
+    return future;
+  }
+
+  void OnListingReady(const Result<std::vector<kvstore::ListEntry>>& result) {
+    absl::MutexLock lock(&mutex_);
+    pending_ = Future<const void>();
+    if (!result.ok()) return;
+    // Keys are never removed, since keys written after the listing started
+    // may be absent from it.
+    for (const auto& entry : *result) {
+      keys_.insert(entry.key);
+    }
+    indexed_time_ = pending_time_;
+  }
+
+  Future<ReadResult> ReadUsingIndex(Key key, ReadOptions options) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (options.staleness_bound <= indexed_time_ && !keys_.contains(key)) {
+        TimestampedStorageGeneration stamp(StorageGeneration::NoValue(),
+                                           indexed_time_);
+        return MakeReadyFuture<ReadResult>(
+            options.generation_conditions.Matches(stamp.generation)
+                ? ReadResult::Missing(std::move(stamp))
+                : ReadResult::Unspecified(std::move(stamp)));
+      }
+    }
+    return base_->Read(std::move(key), std::move(options));
+  }
+
+  void AddKey(std::string_view key) {
+    if (!absl::StartsWith(key, prefix_)) return;
+    absl::MutexLock lock(&mutex_);
+    keys_.insert(std::string(key));
+  }
+
+  kvstore::DriverPtr base_;
+  std::string prefix_;
+
+  absl::Mutex mutex_;
+  // Keys known to exist as of `indexed_time_`.
+  absl::flat_hash_set<std::string> keys_ ABSL_GUARDED_BY(mutex_);
+  // Start time of the most recent successful listing.
+  absl::Time indexed_time_ ABSL_GUARDED_BY(mutex_) = absl::InfinitePast();
+  // Listing in progress, or null.
+  Future<const void> pending_ ABSL_GUARDED_BY(mutex_);
+  // Start time of `pending_`.
+  absl::Time pending_time_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+kvstore::DriverPtr GetChunkExistenceIndexKeyValueStore(kvstore::DriverPtr base,
+                                                       std::string prefix) {
+  return kvstore::DriverPtr(
+      new ChunkExistenceIndexKeyValueStore(std::move(base), std::move(prefix)));
+}
+
+}  // namespace internal_kvs_backed_chunk_driver
+}  // namespace tensorstore
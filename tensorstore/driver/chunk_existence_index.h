@@ -0,0 +1,52 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_CHUNK_EXISTENCE_INDEX_H_
+#define TENSORSTORE_DRIVER_CHUNK_EXISTENCE_INDEX_H_
+
+/// \file
+///
+/// Support for resolving reads of missing chunks of sparse arrays without
+/// I/O, based on a listing of the existing chunk keys.
+
+#include <string>
+
+#include "tensorstore/kvstore/driver.h"
+
+namespace tensorstore {
+namespace internal_kvs_backed_chunk_driver {
+
+/// Returns a kvstore adapter that serves reads of keys under `prefix` that are
+/// known not to exist from an index of the existing keys, without reading them
+/// from `base`.
+///
+/// The index is obtained by listing `prefix` when first needed.  A read is
+/// served from the index only if its staleness bound is not newer than the
+/// time at which the listing started; otherwise, a new listing is started
+/// if none is in progress, and the read waits for it.  Reads of keys present
+/// in the index, and all reads if listing fails, are forwarded to `base`.
+///
+/// Writes are forwarded to `base`, and the written keys are added to the
+/// index.  Deleted keys are not removed from the index, which only causes
+/// their subsequent reads to be forwarded to `base`.
+///
+/// \param base Base kvstore.
+/// \param prefix Prefix of the keys to index, e.g. the path of an array.
+kvstore::DriverPtr GetChunkExistenceIndexKeyValueStore(kvstore::DriverPtr base,
+                                                       std::string prefix);
+
+}  // namespace internal_kvs_backed_chunk_driver
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_CHUNK_EXISTENCE_INDEX_H_
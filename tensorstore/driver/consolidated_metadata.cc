@@ -0,0 +1,258 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/consolidated_metadata.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/match.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/kvs_backed_cache.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/estimate_heap_usage/estimate_heap_usage.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/path.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_kvs_backed_chunk_driver {
+namespace {
+
+/// Decoded consolidated metadata document.
+struct ConsolidatedMetadata {
+  /// Encoded JSON value of each entry, keyed by storage key relative to the
+  /// directory containing the document.
+  absl::flat_hash_map<std::string, absl::Cord> entries;
+};
+
+Result<ConsolidatedMetadata> DecodeConsolidatedMetadata(
+    absl::Cord encoded, const ConsolidatedMetadataFormat& format) {
+  auto j = ::nlohmann::json::parse(encoded.Flatten(), nullptr,
+                                   /*allow_exceptions=*/false);
+  if (j.is_discarded()) {
+    return absl::DataLossError("Invalid JSON");
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto map, format.parse(j),
+      MaybeAnnotateStatus(_, "Invalid consolidated metadata"));
+  ConsolidatedMetadata metadata;
+  metadata.entries.reserve(map.size());
+  for (auto& [key, value] : map) {
+    metadata.entries.emplace(key, absl::Cord(value.dump()));
+  }
+  return metadata;
+}
+
+/// Read-only cache of decoded consolidated metadata documents.
+///
+/// Each entry corresponds to a single document, keyed by its storage key.
+class ConsolidatedMetadataCache
+    : public internal::KvsBackedCache<ConsolidatedMetadataCache,
+                                      internal::AsyncCache> {
+  using Base = internal::KvsBackedCache<ConsolidatedMetadataCache,
+                                        internal::AsyncCache>;
+
+ public:
+  using ReadData = ConsolidatedMetadata;
+
+  class Entry : public Base::Entry {
+   public:
+    using OwningCache = ConsolidatedMetadataCache;
+
+    size_t ComputeReadDataSizeInBytes(const void* read_data) override {
+      const auto& entries = static_cast<const ReadData*>(read_data)->entries;
+      size_t size = entries.capacity() *
+                    sizeof(std::pair<const std::string, absl::Cord>);
+      for (const auto& [key, value] : entries) {
+        size += internal::EstimateHeapUsage(key) +
+                internal::EstimateHeapUsage(value);
+      }
+      return size;
+    }
+
+    void DoDecode(std::optional<absl::Cord> value,
+                  DecodeReceiver receiver) override {
+      GetOwningCache(*this).executor()(
+          [this, value = std::move(value),
+           receiver = std::move(receiver)]() mutable {
+            std::shared_ptr<ReadData> read_data;
+            if (value) {
+              TENSORSTORE_ASSIGN_OR_RETURN(
+                  auto metadata,
+                  DecodeConsolidatedMetadata(std::move(*value),
+                                             GetOwningCache(*this).format()),
+                  static_cast<void>(execution::set_error(receiver, _)));
+              read_data = std::make_shared<ReadData>(std::move(metadata));
+            }
+            execution::set_value(receiver, std::move(read_data));
+          });
+    }
+  };
+
+  Entry* DoAllocateEntry() final { return new Entry; }
+  size_t DoGetSizeofEntry() final { return sizeof(Entry); }
+  TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final {
+    ABSL_UNREACHABLE();
+  }
+
+  explicit ConsolidatedMetadataCache(kvstore::DriverPtr base,
+                                     const ConsolidatedMetadataFormat& format,
+                                     Executor executor)
+      : Base(std::move(base)),
+        format_(format),
+        executor_(std::move(executor)) {}
+
+  const ConsolidatedMetadataFormat& format() const { return format_; }
+  const Executor& executor() const { return executor_; }
+
+ private:
+  const ConsolidatedMetadataFormat& format_;
+  Executor executor_;
+};
+
+class ConsolidatedMetadataKeyValueStore : public kvstore::Driver {
+ public:
+  explicit ConsolidatedMetadataKeyValueStore(
+      kvstore::DriverPtr base, std::string prefix,
+      internal::PinnedCacheEntry<ConsolidatedMetadataCache> cache_entry)
+      : base_(std::move(base)),
+        prefix_(std::move(prefix)),
+        cache_entry_(std::move(cache_entry)) {}
+
+  Future<ReadResult> Read(Key key, ReadOptions options) override {
+    if (!absl::StartsWith(key, prefix_)) {
+      return base_->Read(std::move(key), std::move(options));
+    }
+    auto staleness_bound = options.staleness_bound;
+    using Ptr = internal::IntrusivePtr<ConsolidatedMetadataKeyValueStore>;
+    return PromiseFuturePair<ReadResult>::LinkValue(
+               [self = Ptr(this), key = std::move(key),
+                options = std::move(options)](Promise<ReadResult> promise,
+                                              ReadyFuture<const void>) mutable {
+                 if (!promise.result_needed()) return;
+                 self->OnConsolidatedMetadataReady(
+                     std::move(promise), std::move(key), std::move(options));
+               },
+               cache_entry_->Read({staleness_bound}))
+        .future;
+  }
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override {
+    return absl::FailedPreconditionError(tensorstore::StrCat(
+        "Cannot write ", DescribeKey(key), " of hierarchy opened with ",
+        "consolidated metadata"));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    return base_->DescribeKey(key);
+  }
+
+  void GarbageCollectionVisit(
+      garbage_collection::GarbageCollectionVisitor& visitor) const final {
+    // No-op
+  }
+
+ private:
+  void OnConsolidatedMetadataReady(Promise<ReadResult> promise, Key key,
+                                   ReadOptions options) {
+    TimestampedStorageGeneration stamp;
+    std::optional<absl::Cord> value;
+    {
+      internal::AsyncCache::ReadLock<ConsolidatedMetadata> lock(
+          *cache_entry_);
+      if (!lock.data()) {
+        // No consolidated metadata, read individual keys instead.
+        LinkResult(std::move(promise),
+                   base_->Read(std::move(key), std::move(options)));
+        return;
+      }
+      stamp = lock.stamp();
+      const auto& entries = lock.data()->entries;
+      if (auto it = entries.find(
+              std::string_view(key).substr(prefix_.size()));
+          it != entries.end()) {
+        value = it->second;
+      }
+    }
+    if (!options.generation_conditions.Matches(stamp.generation)) {
+      promise.SetResult(ReadResult::Unspecified(std::move(stamp)));
+      return;
+    }
+    if (!value) {
+      promise.SetResult(ReadResult::Missing(std::move(stamp)));
+      return;
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto byte_range, options.byte_range.Validate(value->size()),
+        static_cast<void>(promise.SetResult(_)));
+    promise.SetResult(ReadResult::Value(
+        internal::GetSubCord(*value, byte_range), std::move(stamp)));
+  }
+
+  kvstore::DriverPtr base_;
+  // Directory containing the consolidated metadata document, including the
+  // trailing "/", or empty.
+  std::string prefix_;
+  internal::PinnedCacheEntry<ConsolidatedMetadataCache> cache_entry_;
+};
+
+}  // namespace
+
+kvstore::DriverPtr GetConsolidatedMetadataKeyValueStore(
+    kvstore::DriverPtr base, std::string consolidated_metadata_key,
+    const ConsolidatedMetadataFormat& format, internal::CachePool* cache_pool,
+    Executor executor) {
+  std::string cache_key;
+  internal::EncodeCacheKey(&cache_key, base, format.id);
+  auto cache = internal::GetCache<ConsolidatedMetadataCache>(
+      cache_pool, cache_key, [&] {
+        return std::make_unique<ConsolidatedMetadataCache>(base, format,
+                                                           std::move(executor));
+      });
+  std::string prefix(internal::PathDirnameBasename(consolidated_metadata_key)
+                         .first);
+  if (!prefix.empty()) prefix += '/';
+  auto cache_entry = GetCacheEntry(cache, consolidated_metadata_key);
+  return kvstore::DriverPtr(new ConsolidatedMetadataKeyValueStore(
+      std::move(base), std::move(prefix), std::move(cache_entry)));
+}
+
+}  // namespace internal_kvs_backed_chunk_driver
+}  // namespace tensorstore
@@ -0,0 +1,83 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_CONSOLIDATED_METADATA_H_
+#define TENSORSTORE_DRIVER_CONSOLIDATED_METADATA_H_
+
+/// \file
+///
+/// Support for serving the metadata of the arrays in a hierarchy from a single
+/// consolidated metadata document, as used by the zarr and zarr3 drivers.
+
+#include <string>
+#include <string_view>
+
+#include "absl/container/flat_hash_map.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+class CachePool;
+}  // namespace internal
+
+namespace internal_kvs_backed_chunk_driver {
+
+/// Maps storage keys, relative to the directory containing the consolidated
+/// metadata document, to the JSON value stored under that key.
+using ConsolidatedMetadataMap =
+    absl::flat_hash_map<std::string, ::nlohmann::json>;
+
+/// Specifies a consolidated metadata format.
+struct ConsolidatedMetadataFormat {
+  /// Identifies the format within cache keys.
+  std::string_view id;
+
+  /// Extracts the consolidated entries from the decoded JSON document.
+  Result<ConsolidatedMetadataMap> (*parse)(const ::nlohmann::json& j);
+};
+
+/// Returns a read-only kvstore adapter that serves reads of keys contained in
+/// the consolidated metadata document stored at `consolidated_metadata_key`
+/// of `base` from that document rather than from `base`.
+///
+/// The consolidated document is read once and cached in `cache_pool`, such
+/// that opening many arrays of the same hierarchy requires a single read.
+/// Keys not under the directory containing the document are forwarded to
+/// `base`, as are all keys if the document does not exist.  Keys under the
+/// directory but not present in the document are reported as missing.  The
+/// storage generation of the returned values is that of the document.
+///
+/// Writes are not supported, since they would make the consolidated document
+/// inconsistent.
+///
+/// \param base Base kvstore.
+/// \param consolidated_metadata_key Key in `base` of the consolidated
+///     metadata document.
+/// \param format Consolidated metadata format, must have static storage
+///     duration.
+/// \param cache_pool Cache pool used to cache the decoded document, may be
+///     `nullptr` to disable caching.
+/// \param executor Executor used for decoding.
+kvstore::DriverPtr GetConsolidatedMetadataKeyValueStore(
+    kvstore::DriverPtr base, std::string consolidated_metadata_key,
+    const ConsolidatedMetadataFormat& format, internal::CachePool* cache_pool,
+    Executor executor);
+
+}  // namespace internal_kvs_backed_chunk_driver
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_CONSOLIDATED_METADATA_H_
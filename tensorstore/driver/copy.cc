@@ -184,9 +184,9 @@ struct CopyChunkOp {
           std::move(source_iterable), target_iterable->dtype(),
           state->data_type_conversion);
 
-      copy_status = NDIterableCopier(*source_iterable, *target_iterable,
-                                     write_chunk.transform.input_shape(), arena)
-                        .Copy();
+      copy_status = ParallelNDIterableCopy(
+          *source_iterable, *target_iterable,
+          write_chunk.transform.input_shape(), state->executor, arena);
 
       auto end_write_result =
           write_chunk.impl(WriteChunk::EndWrite{}, write_chunk.transform,
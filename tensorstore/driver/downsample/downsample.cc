@@ -696,6 +696,11 @@ struct BufferedReadChunkImpl {
         propagated.input_downsample_factors, state_->self_->downsample_method_,
         chunk_transform.input_rank(), arena);
   }
+
+  bool operator()(internal::ReadChunk::ReadArray, IndexTransformView<>,
+                  SharedOffsetArray<const void>&) {
+    return false;
+  }
 };
 
 /// Returns an identity transform from `base_domain.rank()` to `request_rank`,
@@ -766,6 +771,42 @@ void ReadState::EmitBufferedChunks() {
   }
 }
 
+/// Returns `true` if downsampling any number of copies of the rank-0 `value`
+/// using `method` is guaranteed to produce exactly `value`.
+bool DownsamplingPreservesValue(DownsampleMethod method,
+                                const SharedArray<const void>& value) {
+  switch (value.dtype().id()) {
+    case DataTypeId::bool_t:
+    case DataTypeId::char_t:
+    case DataTypeId::byte_t:
+    case DataTypeId::int4_t:
+    case DataTypeId::int8_t:
+    case DataTypeId::uint8_t:
+    case DataTypeId::int16_t:
+    case DataTypeId::uint16_t:
+    case DataTypeId::int32_t:
+    case DataTypeId::uint32_t:
+    case DataTypeId::int64_t:
+    case DataTypeId::uint64_t:
+    case DataTypeId::string_t:
+    case DataTypeId::ustring_t:
+    case DataTypeId::json_t:
+      return true;
+    default:
+      break;
+  }
+  if (method == DownsampleMethod::kMedian ||
+      method == DownsampleMethod::kMode) {
+    // The result is always one of the input elements.
+    return true;
+  }
+  // For floating-point types, `kMean` may be inexact and `kMin`/`kMax` do not
+  // propagate NaN, but all methods preserve positive zero.
+  const auto* bytes = static_cast<const unsigned char*>(value.data());
+  return std::all_of(bytes, bytes + value.dtype().size(),
+                     [](unsigned char b) { return b == 0; });
+}
+
 /// Implementation of the `internal::ReadChunk::Impl` Poly interface that
 /// provides a downsampled view of another `ReadChunk`.
 struct IndependentReadChunkImpl {
@@ -786,6 +827,19 @@ struct IndependentReadChunkImpl {
   Result<NDIterable::Ptr> operator()(internal::ReadChunk::BeginRead,
                                      IndexTransform<> chunk_transform,
                                      internal::Arena* arena) {
+    // A base chunk that contains a single repeated value, such as the fill
+    // value of a chunk that is not present in storage, typically downsamples
+    // to that same value.  In that case, the reduction over the base chunk is
+    // skipped.
+    if (auto downsampled_array = GetConstantDownsampledArray();
+        downsampled_array.valid()) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto transformed_array,
+          MakeTransformedArray(std::move(downsampled_array),
+                               std::move(chunk_transform)));
+      return GetTransformedArrayNDIterable(std::move(transformed_array),
+                                           arena);
+    }
     // `chunk_transform` maps from a copy space to the *downsampled* bounds of
     // `state_->base_transform_domain_`.
     TENSORSTORE_ASSIGN_OR_RETURN(
@@ -812,6 +866,38 @@ struct IndependentReadChunkImpl {
         propagated.input_downsample_factors, state_->self_->downsample_method_,
         chunk_transform.input_rank(), arena);
   }
+
+  bool operator()(internal::ReadChunk::ReadArray, IndexTransformView<>,
+                  SharedOffsetArray<const void>&) {
+    return false;
+  }
+
+  /// If `base_chunk_` is known to contain a single repeated value that is
+  /// preserved by downsampling, returns an array with the downsampled domain
+  /// of `base_chunk_` that broadcasts that value.  Otherwise, returns a null
+  /// array.
+  SharedOffsetArray<const void> GetConstantDownsampledArray() {
+    SharedOffsetArray<const void> base_array;
+    if (!base_chunk_.impl(internal::ReadChunk::ReadArray{},
+                          base_chunk_.transform, base_array)) {
+      return {};
+    }
+    // Chunks not present in storage are represented by the broadcast fill
+    // value, which has only zero strides.
+    auto value = UnbroadcastArray(base_array);
+    const DownsampleMethod method = state_->self_->downsample_method_;
+    if (value.rank() != 0 || !DownsamplingPreservesValue(method, value)) {
+      return {};
+    }
+    const BoxView<> base_domain = base_chunk_.transform.domain().box();
+    Box<dynamic_rank(internal::kNumInlinedDims)> downsampled_domain(
+        base_domain.rank());
+    internal_downsample::DownsampleBounds(base_domain, downsampled_domain,
+                                          state_->downsample_factors_, method);
+    auto result = BroadcastArray(std::move(value), downsampled_domain);
+    if (!result.ok()) return {};
+    return *std::move(result);
+  }
 };
 
 /// Attempts to emit a `ReadChunk` from the base driver independently.
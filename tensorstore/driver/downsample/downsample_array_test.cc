@@ -262,6 +262,23 @@ TEST(DownsampleArrayTest, MeanRank3ThreeDownsampleDims) {
                                  }})));
 }
 
+// Tests the 2x2x2 and 2x2x1 blocks, which have specialized implementations.
+TEST(DownsampleArrayTest, Rank3Factor2) {
+  auto source = MakeArray<float>({{{5, 1, 7}, {3, 8, 7}},  //
+                                  {{1, 6, 2}, {9, 1, 9}}});
+  const Index factors[] = {2, 2, 2};
+  EXPECT_THAT(DownsampleArray(source, factors, DownsampleMethod::kMean),
+              Optional(MakeArray<float>({{{4.25, 6.25}}})));
+  EXPECT_THAT(DownsampleArray(source, factors, DownsampleMethod::kMin),
+              Optional(MakeArray<float>({{{1, 2}}})));
+  EXPECT_THAT(DownsampleArray(source, factors, DownsampleMethod::kMax),
+              Optional(MakeArray<float>({{{9, 9}}})));
+  EXPECT_THAT(DownsampleArray(source, factors, DownsampleMethod::kMedian),
+              Optional(MakeArray<float>({{{3, 7}}})));
+  EXPECT_THAT(DownsampleArray(source, factors, DownsampleMethod::kMode),
+              Optional(MakeArray<float>({{{1, 7}}})));
+}
+
 TEST(DownsampleArrayTest, MeanRank1ReversedExactMultiple) {
   EXPECT_THAT(DownsampleTransformedArray(
                   (MakeArray<float>({1, 2, 3, 4}) |
@@ -41,9 +41,9 @@ using ::tensorstore::internal_downsample::DownsampleBounds;
 
 void BenchmarkDownsample(::benchmark::State& state, DataType dtype,
                          DownsampleMethod downsample_method,
-                         DimensionIndex rank, Index downsample_factor,
+                         std::vector<Index> downsample_factors,
                          Index block_size) {
-  std::vector<Index> downsample_factors(rank, downsample_factor);
+  const DimensionIndex rank = downsample_factors.size();
   std::vector<Index> block_shape(rank, block_size);
   absl::BitGen gen;
   BoxView<> base_domain(block_shape);
@@ -87,12 +87,26 @@ TENSORSTORE_GLOBAL_INITIALIZER {
                                     downsample_factor, "_BlockSize", block_size)
                     .c_str(),
                 [=](auto& state) {
-                  BenchmarkDownsample(state, dtype, downsample_method, rank,
-                                      downsample_factor, block_size);
+                  BenchmarkDownsample(
+                      state, dtype, downsample_method,
+                      std::vector<Index>(rank, downsample_factor), block_size);
                 });
           }
         }
       }
+      // Downsampling of 2-d slices of a 3-d volume, as used for anisotropic
+      // multi-resolution pyramids.
+      for (const Index block_size : {16, 64, 256}) {
+        ::benchmark::RegisterBenchmark(
+            tensorstore::StrCat("DownsampleArray_", dtype, "_",
+                                downsample_method, "_Rank3_Factor1x2x2",
+                                "_BlockSize", block_size)
+                .c_str(),
+            [=](auto& state) {
+              BenchmarkDownsample(state, dtype, downsample_method, {1, 2, 2},
+                                  block_size);
+            });
+      }
     }
   }
 }
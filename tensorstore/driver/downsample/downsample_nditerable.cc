@@ -132,6 +132,11 @@ struct ReductionTraits {
 ///
 ///     void Initialize(AccumulateElement& x);
 ///
+///     void Accumulate(AccumulateElement& acc, const Element& input);
+///
+///     void AccumulatePair(AccumulateElement& acc, const Element& a,
+///                         const Element& b);
+///
 ///     void ComputeOutput(Element &output, AccumulateElement &acc);
 template <DownsampleMethod Method, typename Element>
 struct AccumulateReductionTraitsBase {
@@ -144,6 +149,33 @@ struct AccumulateReductionTraitsBase {
     ReductionTraits<Method, Element>::Accumulate(acc[output_index], input);
   }
 
+  /// Accumulates a contiguous row of `n` input elements, downsampled by a
+  /// factor of `Factor` (1 or 2) with no offset, into `acc`.
+  ///
+  /// This is equivalent to calling `ProcessInput` for each element, but is
+  /// written as a simple loop over contiguous memory (combining adjacent pairs
+  /// of elements before accumulating them when `Factor == 2`) so that it can
+  /// be vectorized by the compiler.
+  template <int Factor, typename AccumulateElement>
+  static void ProcessContiguousInputRow(AccumulateElement* acc,
+                                        const Element* input, Index n) {
+    using Traits = ReductionTraits<Method, Element>;
+    if constexpr (Factor == 1) {
+      for (Index i = 0; i < n; ++i) {
+        Traits::Accumulate(acc[i], input[i]);
+      }
+    } else {
+      static_assert(Factor == 2);
+      const Index num_pairs = n / 2;
+      for (Index i = 0; i < num_pairs; ++i) {
+        Traits::AccumulatePair(acc[i], input[2 * i], input[2 * i + 1]);
+      }
+      if (n % 2) {
+        Traits::Accumulate(acc[num_pairs], input[n - 1]);
+      }
+    }
+  }
+
   template <typename AccumulateElement>
   static void Finalize(Element& output, AccumulateElement* acc,
                        Index output_index, Index max_total_elements,
@@ -292,6 +324,14 @@ struct ReductionTraits<DownsampleMethod::kMean, Element,
     acc += input;
   }
 
+  static void AccumulatePair(AccumulateElement& acc, const Element& a,
+                             const Element& b) {
+    AccumulateElement sum{};
+    sum += a;
+    sum += b;
+    acc += sum;
+  }
+
   static void ComputeOutput(Element& output, const AccumulateElement& acc,
                             Index total_elements) {
     AccumulateElement acc_value = acc;
@@ -366,6 +406,9 @@ struct ReductionTraits<DownsampleMethod::kMin, Element,
   static void Accumulate(Element& acc, const Element& input) {
     acc = std::min(acc, input);
   }
+  static void AccumulatePair(Element& acc, const Element& a, const Element& b) {
+    acc = std::min(acc, std::min(a, b));
+  }
   static void ComputeOutput(Element& output, const Element& acc,
                             Index total_elements) {
     output = acc;
@@ -388,6 +431,9 @@ struct ReductionTraits<DownsampleMethod::kMax, Element,
   static void Accumulate(Element& acc, const Element& input) {
     acc = std::max(acc, input);
   }
+  static void AccumulatePair(Element& acc, const Element& a, const Element& b) {
+    acc = std::max(acc, std::max(a, b));
+  }
   static void ComputeOutput(Element& output, const Element& acc,
                             Index total_elements) {
     output = acc;
@@ -423,13 +469,73 @@ struct StoreReductionTraitsBase {
   }
 };
 
+/// Maximum number of elements for which `SortSmallBlock` is used in place of
+/// the general-purpose sorting and selection algorithms.
+constexpr ptrdiff_t kMaxSmallBlockSize = 16;
+
+/// Sorts `input`, which must have at most `kMaxSmallBlockSize` elements.
+///
+/// The block sizes of 4 and 8, which correspond to the common downsample
+/// factors of 2x2x1 and 2x2x2, are sorted using optimal sorting networks;
+/// other sizes are sorted using insertion sort.  Both avoid the overhead of
+/// `std::sort` and `std::nth_element`, which dominates for such small blocks.
+template <typename Element, typename Compare>
+void SortSmallBlock(span<Element> input, Compare compare) {
+  assert(input.size() <= kMaxSmallBlockSize);
+  Element* const data = input.data();
+  const auto compare_exchange = [&](ptrdiff_t i, ptrdiff_t j) {
+    if (compare(data[j], data[i])) std::swap(data[i], data[j]);
+  };
+  switch (input.size()) {
+    case 4:
+      compare_exchange(0, 1);
+      compare_exchange(2, 3);
+      compare_exchange(0, 2);
+      compare_exchange(1, 3);
+      compare_exchange(1, 2);
+      return;
+    case 8:
+      compare_exchange(0, 2);
+      compare_exchange(1, 3);
+      compare_exchange(4, 6);
+      compare_exchange(5, 7);
+      compare_exchange(0, 4);
+      compare_exchange(1, 5);
+      compare_exchange(2, 6);
+      compare_exchange(3, 7);
+      compare_exchange(0, 1);
+      compare_exchange(2, 3);
+      compare_exchange(4, 5);
+      compare_exchange(6, 7);
+      compare_exchange(2, 4);
+      compare_exchange(3, 5);
+      compare_exchange(1, 4);
+      compare_exchange(3, 6);
+      compare_exchange(1, 2);
+      compare_exchange(3, 4);
+      compare_exchange(5, 6);
+      return;
+    default:
+      for (ptrdiff_t i = 1; i < input.size(); ++i) {
+        for (ptrdiff_t j = i; j > 0 && compare(data[j], data[j - 1]); --j) {
+          std::swap(data[j], data[j - 1]);
+        }
+      }
+      return;
+  }
+}
+
 template <typename Element>
 struct ReductionTraits<DownsampleMethod::kMedian, Element,
                        std::enable_if_t<IsOrderingSupported<Element>::value>>
     : public StoreReductionTraitsBase<DownsampleMethod::kMedian, Element> {
   static void ComputeOutput(Element& output, span<Element> input) {
     auto median_it = input.begin() + (input.size() - 1) / 2;
-    std::nth_element(input.begin(), median_it, input.end());
+    if (input.size() <= kMaxSmallBlockSize) {
+      SortSmallBlock(input, std::less<Element>{});
+    } else {
+      std::nth_element(input.begin(), median_it, input.end());
+    }
     output = *median_it;
   }
 };
@@ -455,7 +561,11 @@ struct ReductionTraits<DownsampleMethod::kMode, Element>
   static void ComputeOutput(Element& output, span<Element> input) {
     // Sort in order to determine the number of times each distinct value is
     // repeated.
-    std::sort(input.begin(), input.end(), CompareForMode<Element>{});
+    if (input.size() <= kMaxSmallBlockSize) {
+      SortSmallBlock(input, CompareForMode<Element>{});
+    } else {
+      std::sort(input.begin(), input.end(), CompareForMode<Element>{});
+    }
     Index most_frequent_index = 0;
     size_t most_frequent_count = 1;
     size_t cur_count = 1;
@@ -566,6 +676,26 @@ struct DownsampleImpl {
                                          Index source_outer_i,
                                          Index num_outer_elements,
                                          Index outer_element_offset) {
+        if constexpr (!Traits::kStoreAllElements &&
+                      ArrayAccessor::buffer_kind ==
+                          IterationBufferKind::kContiguous) {
+          // Fast path for the common downsample factors of 1 and 2.
+          if (downsample_factor[1] <= 2 && base_block_offset[1] == 0) {
+            AccumulateElement* acc_row =
+                acc + output_outer_i * output_block_shape[1];
+            const Element* source_row =
+                ArrayAccessor::template GetPointerAtPosition<Element>(
+                    source_pointer, source_outer_i, 0);
+            if (downsample_factor[1] == 1) {
+              Traits::template ProcessContiguousInputRow<1>(
+                  acc_row, source_row, base_block_shape[1]);
+            } else {
+              Traits::template ProcessContiguousInputRow<2>(
+                  acc_row, source_row, base_block_shape[1]);
+            }
+            return;
+          }
+        }
         for_each_source_index(
             std::integral_constant<Index, 1>{},
             [&](Index output_inner_i, Index source_inner_i, Index element_i,
@@ -875,6 +875,62 @@ TEST(DownsampleTest, FillValueSpecified) {
                   tensorstore::MakeArray<uint32_t>({{26, 32}, {59, 64}})));
 }
 
+// Chunks not present in storage are represented by the fill value.
+TEST(DownsampleTest, MissingChunks) {
+  ::nlohmann::json base_spec{{"driver", "zarr"},
+                             {"kvstore", {{"driver", "memory"}}},
+                             {"metadata",
+                              {{"dtype", "<u2"},
+                               {"shape", {12}},
+                               {"chunks", {4}},
+                               {"fill_value", 7},
+                               {"compressor", nullptr}}}};
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store,
+      tensorstore::Open(base_spec, context, tensorstore::OpenMode::create)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      MakeArray<uint16_t>({1, 2, 3, 4}),
+      base_store | tensorstore::Dims(0).SizedInterval(4, 4)));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto downsampled_store,
+      tensorstore::Downsample(base_store, {2}, DownsampleMethod::kMean));
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint16_t>({7, 7, 2, 4, 7, 7})));
+}
+
+// Missing chunks with a NaN fill value are still reduced, since `kMax` does
+// not propagate NaN.
+TEST(DownsampleTest, MissingChunksNaNFillValue) {
+  ::nlohmann::json base_spec{{"driver", "zarr"},
+                             {"kvstore", {{"driver", "memory"}}},
+                             {"metadata",
+                              {{"dtype", "<f4"},
+                               {"shape", {4}},
+                               {"chunks", {2}},
+                               {"fill_value", "NaN"},
+                               {"compressor", nullptr}}}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store,
+      tensorstore::Open(base_spec, tensorstore::OpenMode::create).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto downsampled_store,
+      tensorstore::Downsample(base_store, {2}, DownsampleMethod::kMax));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto base_data,
+                                   tensorstore::Read(base_store).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto array_store,
+                                   tensorstore::FromArray(base_data));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto expected,
+      tensorstore::Read(tensorstore::Downsample(array_store, {2},
+                                                DownsampleMethod::kMax)
+                            .value())
+          .result());
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(expected));
+}
+
 TEST(DownsampleTest, DimensionUnits) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto base_store, tensorstore::FromArray(
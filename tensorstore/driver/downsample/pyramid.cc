@@ -0,0 +1,305 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/downsample/pyramid.h"
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/driver/downsample/downsample_array.h"
+#include "tensorstore/driver/downsample/downsample_nditerable.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+namespace {
+
+/// State of an in-progress `WritePyramid` operation.
+///
+/// The blocks of the base level are processed sequentially, in lexicographical
+/// order of their grid cell indices.
+class PyramidWriter : public internal::AtomicReferenceCount<PyramidWriter> {
+ public:
+  using Ptr = internal::IntrusivePtr<PyramidWriter>;
+
+  PyramidWriter(TensorStore<> base, std::vector<TensorStore<>> levels,
+                span<const Index> downsample_factors, DownsampleMethod method,
+                std::vector<Index> block_shape,
+                std::vector<Index> block_alignment, Promise<void> promise)
+      : base_(std::move(base)),
+        levels_(std::move(levels)),
+        downsample_factors_(downsample_factors.begin(),
+                            downsample_factors.end()),
+        method_(method),
+        block_shape_(std::move(block_shape)),
+        block_alignment_(std::move(block_alignment)),
+        promise_(std::move(promise)) {
+    const DimensionIndex rank = base_.rank();
+    const BoxView<> base_bounds = base_.domain().box();
+    grid_cell_begin_.resize(rank);
+    grid_cell_end_.resize(rank);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      const IndexInterval bounds = base_bounds[i];
+      grid_cell_begin_[i] = FloorOfRatio(
+          bounds.inclusive_min() - block_alignment_[i], block_shape_[i]);
+      grid_cell_end_[i] = FloorOfRatio(bounds.inclusive_max() -
+                                           block_alignment_[i],
+                                       block_shape_[i]) +
+                          1;
+      done_ = done_ || bounds.empty();
+    }
+    grid_cell_ = grid_cell_begin_;
+  }
+
+  /// Processes blocks until an asynchronous operation is pending, all blocks
+  /// have been processed, or an error occurs.
+  static void Run(Ptr self) {
+    while (true) {
+      if (!self->promise_.result_needed()) return;
+      if (self->done_) {
+        self->Finish();
+        return;
+      }
+      auto read_future = tensorstore::Read(
+          self->base_ | AllDims().BoxSlice(self->NextBlock()));
+      if (!read_future.ready()) {
+        read_future.ExecuteWhenReady(
+            [self](ReadyFuture<SharedOffsetArray<void>> future) {
+              if (self->WriteLevels(future.result())) Run(self);
+            });
+        return;
+      }
+      if (!self->WriteLevels(read_future.result())) return;
+    }
+  }
+
+ private:
+  /// Returns the bounds of the current block, and advances to the next block.
+  Box<> NextBlock() {
+    const DimensionIndex rank = base_.rank();
+    const BoxView<> base_bounds = base_.domain().box();
+    Box<> block(rank);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      block[i] = Intersect(
+          IndexInterval::UncheckedSized(
+              block_alignment_[i] + grid_cell_[i] * block_shape_[i],
+              block_shape_[i]),
+          base_bounds[i]);
+    }
+    done_ = true;
+    for (DimensionIndex i = rank - 1; i >= 0; --i) {
+      if (++grid_cell_[i] != grid_cell_end_[i]) {
+        done_ = false;
+        break;
+      }
+      grid_cell_[i] = grid_cell_begin_[i];
+    }
+    return block;
+  }
+
+  /// Computes and writes the regions of all levels corresponding to a block
+  /// of the base level.
+  ///
+  /// Returns `true` if the caller should continue with the next block, or
+  /// `false` if processing will be resumed asynchronously or has failed.
+  bool WriteLevels(const Result<SharedOffsetArray<void>>& base_data) {
+    if (!base_data.ok()) return Fail(base_data.status());
+    SharedOffsetArray<const void> source = *base_data;
+    std::vector<AnyFuture> copy_futures;
+    copy_futures.reserve(levels_.size());
+    for (auto& level : levels_) {
+      auto downsampled =
+          DownsampleArray(source, downsample_factors_, method_);
+      if (!downsampled.ok()) return Fail(downsampled.status());
+      source = *std::move(downsampled);
+      const DimensionIndex rank = source.rank();
+      const BoxView<> level_bounds = level.domain().box();
+      Box<> bounds(rank);
+      for (DimensionIndex i = 0; i < rank; ++i) {
+        bounds[i] = Intersect(source.domain()[i], level_bounds[i]);
+      }
+      if (bounds.is_empty()) continue;
+      auto futures =
+          tensorstore::Write(source | AllDims().BoxSlice(bounds), level);
+      copy_futures.push_back(std::move(futures.copy_future));
+      commit_futures_.push_back(std::move(futures.commit_future));
+    }
+    // Wait until the data has been copied before processing the next block,
+    // to bound the memory usage.
+    auto copied = WaitAllFuture(span<const AnyFuture>(copy_futures));
+    if (!copied.ready()) {
+      copied.ExecuteWhenReady([self = Ptr(this)](ReadyFuture<void> future) {
+        if (self->CheckStatus(future.status())) Run(self);
+      });
+      return false;
+    }
+    return CheckStatus(copied.status());
+  }
+
+  bool CheckStatus(const absl::Status& status) {
+    if (!status.ok()) return Fail(status);
+    return true;
+  }
+
+  bool Fail(const absl::Status& status) {
+    promise_.SetResult(status);
+    return false;
+  }
+
+  void Finish() {
+    LinkResult(std::move(promise_),
+               WaitAllFuture(span<const AnyFuture>(commit_futures_)));
+  }
+
+  TensorStore<> base_;
+  std::vector<TensorStore<>> levels_;
+  std::vector<Index> downsample_factors_;
+  DownsampleMethod method_;
+  std::vector<Index> block_shape_;
+  std::vector<Index> block_alignment_;
+  Promise<void> promise_;
+
+  // Range of grid cell indices of the blocks, and the next block.
+  std::vector<Index> grid_cell_begin_;
+  std::vector<Index> grid_cell_end_;
+  std::vector<Index> grid_cell_;
+  bool done_ = false;
+
+  std::vector<AnyFuture> commit_futures_;
+};
+
+/// Computes the default block shape and the alignment of the blocks.
+absl::Status GetBlockGrid(const TensorStore<>& last_level,
+                          span<const Index> cumulative_factors,
+                          std::vector<Index>& block_shape,
+                          std::vector<Index>& block_alignment) {
+  const DimensionIndex rank = cumulative_factors.size();
+  TENSORSTORE_ASSIGN_OR_RETURN(auto chunk_layout, last_level.chunk_layout());
+  const auto chunk_shape = chunk_layout.write_chunk_shape();
+  const auto grid_origin = chunk_layout.grid_origin();
+  const bool compute_block_shape = block_shape.empty();
+  if (compute_block_shape) block_shape.resize(rank);
+  block_alignment.resize(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const Index origin = (grid_origin.size() == rank &&
+                          grid_origin[i] != kImplicit)
+                             ? grid_origin[i]
+                             : 0;
+    if (internal::MulOverflow(origin, cumulative_factors[i],
+                              &block_alignment[i])) {
+      return absl::InvalidArgumentError(
+          "Integer overflow computing pyramid block alignment");
+    }
+    if (!compute_block_shape) continue;
+    const Index cell_size =
+        (chunk_shape.size() == rank && chunk_shape[i] > 0) ? chunk_shape[i]
+                                                          : 1;
+    if (internal::MulOverflow(cell_size, cumulative_factors[i],
+                              &block_shape[i])) {
+      return absl::InvalidArgumentError(
+          "Integer overflow computing pyramid block shape");
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+Future<void> WritePyramid(TensorStore<> base, std::vector<TensorStore<>> levels,
+                          span<const Index> downsample_factors,
+                          DownsampleMethod method,
+                          WritePyramidOptions options) {
+  if (levels.empty()) return absl::OkStatus();
+  const DimensionIndex rank = base.rank();
+  if (downsample_factors.size() != rank) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Number of downsample factors (", downsample_factors.size(),
+        ") does not match base rank (", rank, ")"));
+  }
+  if (!IsFinite(base.domain().box())) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Base domain ", base.domain(), " is not bounded"));
+  }
+  TENSORSTORE_RETURN_IF_ERROR(ValidateDownsampleMethod(base.dtype(), method));
+  for (size_t level_i = 0; level_i < levels.size(); ++level_i) {
+    const auto& level = levels[level_i];
+    if (level.rank() != rank || level.dtype() != base.dtype()) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Level ", level_i + 1, " with rank ", level.rank(), " and data type ",
+          level.dtype(), " does not match base with rank ", rank,
+          " and data type ", base.dtype()));
+    }
+  }
+  // Cumulative downsample factors of the last level.
+  std::vector<Index> cumulative_factors(rank, 1);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    if (downsample_factors[i] <= 0) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Invalid downsample factors: ", downsample_factors));
+    }
+    for (size_t level_i = 0; level_i < levels.size(); ++level_i) {
+      if (internal::MulOverflow(cumulative_factors[i], downsample_factors[i],
+                                &cumulative_factors[i])) {
+        return absl::InvalidArgumentError(
+            "Integer overflow computing cumulative downsample factors");
+      }
+    }
+  }
+  auto& block_shape = options.block_shape;
+  if (!block_shape.empty()) {
+    if (block_shape.size() != rank) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Block shape ", span(block_shape), " does not match base rank (",
+          rank, ")"));
+    }
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      if (block_shape[i] <= 0 || block_shape[i] % cumulative_factors[i] != 0) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Block shape ", span(block_shape),
+            " is not a multiple of the cumulative downsample factors ",
+            span(cumulative_factors)));
+      }
+    }
+  }
+  std::vector<Index> block_alignment;
+  TENSORSTORE_RETURN_IF_ERROR(GetBlockGrid(levels.back(), cumulative_factors,
+                                           block_shape, block_alignment));
+  auto [promise, future] = PromiseFuturePair<void>::Make();
+  PyramidWriter::Run(internal::MakeIntrusivePtr<PyramidWriter>(
+      std::move(base), std::move(levels), downsample_factors, method,
+      std::move(block_shape), std::move(block_alignment), std::move(promise)));
+  return std::move(future);
+}
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
@@ -0,0 +1,82 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_DOWNSAMPLE_PYRAMID_H_
+#define TENSORSTORE_DRIVER_DOWNSAMPLE_PYRAMID_H_
+
+/// \file
+///
+/// Single-pass generation of multi-resolution pyramids.
+///
+/// Generating each level of a pyramid by reading the previous level through
+/// the `downsample` driver requires a full read pass over each level.  Instead,
+/// `WritePyramid` reads each block of the base level once, and computes and
+/// writes the corresponding region of every level from it.
+
+#include <vector>
+
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/index.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+struct WritePyramidOptions {
+  /// Shape of the blocks of the base level that are processed at once.
+  ///
+  /// Each block is aligned to a multiple of the block shape, and each
+  /// dimension must be a multiple of the cumulative downsample factor of the
+  /// last level.  Memory usage is proportional to the number of elements in a
+  /// block.
+  ///
+  /// If empty, the block shape is chosen such that each block corresponds to
+  /// a single write chunk of the last level, which ensures that every chunk of
+  /// every level is written exactly once.
+  std::vector<Index> block_shape;
+};
+
+/// Writes levels `1, ..., levels.size()` of a multi-resolution pyramid with
+/// base level `base`.
+///
+/// Level `i + 1` is computed by downsampling level `i` by `downsample_factors`,
+/// which gives the same result as writing the data read through the
+/// `downsample` driver applied to the previous level.
+///
+/// Blocks of the base level are processed one at a time: each block is read
+/// once, and the regions of all levels computed from it are written as soon
+/// as the block has been read.
+///
+/// \param base The base level, must support reading.
+/// \param levels The levels to write, must support writing.  The regions of
+///     the downsampled levels outside the domain of the corresponding store
+///     are not written.
+/// \param downsample_factors Downsample factors between successive levels.
+///     Must have length equal to the rank of `base`.
+/// \param method The downsampling method.
+/// \param options Additional options.
+/// \error `absl::StatusCode::kInvalidArgument` if the ranks or data types of
+///     `base` and `levels` do not match, or `downsample_factors`, `method`, or
+///     `options` are invalid.
+Future<void> WritePyramid(TensorStore<> base, std::vector<TensorStore<>> levels,
+                          span<const Index> downsample_factors,
+                          DownsampleMethod method,
+                          WritePyramidOptions options = {});
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_DOWNSAMPLE_PYRAMID_H_
@@ -0,0 +1,144 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/downsample/pyramid.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/downsample.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/index.h"
+#include "tensorstore/open.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::DownsampleMethod;
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::TensorStore;
+using ::tensorstore::internal_downsample::WritePyramid;
+
+TensorStore<> CreateStore(const Context& context, std::string path,
+                          std::vector<Index> shape, std::vector<Index> chunks) {
+  return tensorstore::Open(
+             {
+                 {"driver", "zarr"},
+                 {"kvstore", {{"driver", "memory"}, {"path", path}}},
+                 {"metadata",
+                  {{"shape", shape}, {"chunks", chunks}, {"dtype", "<u2"}}},
+             },
+             context, tensorstore::OpenMode::create,
+             tensorstore::ReadWriteMode::read_write)
+      .value();
+}
+
+class WritePyramidTest : public ::testing::TestWithParam<DownsampleMethod> {};
+
+INSTANTIATE_TEST_SUITE_P(Methods, WritePyramidTest,
+                         ::testing::Values(DownsampleMethod::kStride,
+                                           DownsampleMethod::kMean,
+                                           DownsampleMethod::kMedian,
+                                           DownsampleMethod::kMode,
+                                           DownsampleMethod::kMin,
+                                           DownsampleMethod::kMax));
+
+// Tests that each level matches the result of the `downsample` driver applied
+// to the previous level.
+TEST_P(WritePyramidTest, MatchesDownsampleDriver) {
+  const DownsampleMethod method = GetParam();
+  auto context = Context::Default();
+  auto base = CreateStore(context, "base/", {13, 10}, {4, 4});
+  auto level1 = CreateStore(context, "level1/", {7, 5}, {2, 3});
+  auto level2 = CreateStore(context, "level2/", {4, 3}, {1, 2});
+  auto base_array = tensorstore::AllocateArray<uint16_t>({13, 10});
+  for (Index i = 0; i < 13; ++i) {
+    for (Index j = 0; j < 10; ++j) {
+      base_array(i, j) = static_cast<uint16_t>((i * 7 + j * 13) % 11);
+    }
+  }
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(base_array, base).result());
+
+  TENSORSTORE_ASSERT_OK(
+      WritePyramid(base, {level1, level2}, {{2, 2}}, method).result());
+
+  TensorStore<> previous = base;
+  for (const auto& level : {level1, level2}) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto expected,
+        tensorstore::Read(tensorstore::Downsample(previous, {2, 2}, method))
+            .result());
+    EXPECT_THAT(tensorstore::Read(level).result(),
+                ::testing::Optional(expected));
+    previous = level;
+  }
+}
+
+TEST(WritePyramidTest, BlockShape) {
+  auto context = Context::Default();
+  auto base = CreateStore(context, "base/", {9, 9}, {3, 3});
+  auto level1 = CreateStore(context, "level1/", {5, 5}, {2, 2});
+  auto base_array = tensorstore::AllocateArray<uint16_t>({9, 9});
+  for (Index i = 0; i < 9; ++i) {
+    for (Index j = 0; j < 9; ++j) {
+      base_array(i, j) = static_cast<uint16_t>(i * 9 + j);
+    }
+  }
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(base_array, base).result());
+
+  EXPECT_THAT(WritePyramid(base, {level1}, {{2, 2}}, DownsampleMethod::kMean,
+                           {/*.block_shape=*/{3, 4}})
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Block shape .* is not a multiple of .*"));
+
+  TENSORSTORE_ASSERT_OK(WritePyramid(base, {level1}, {{2, 2}},
+                                     DownsampleMethod::kMean,
+                                     {/*.block_shape=*/{2, 6}})
+                            .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto expected,
+      tensorstore::Read(
+          tensorstore::Downsample(base, {2, 2}, DownsampleMethod::kMean))
+          .result());
+  EXPECT_THAT(tensorstore::Read(level1).result(),
+              ::testing::Optional(expected));
+}
+
+TEST(WritePyramidTest, Invalid) {
+  auto context = Context::Default();
+  auto base = CreateStore(context, "base/", {4, 4}, {2, 2});
+  auto level1 = CreateStore(context, "level1/", {2, 2}, {2, 2});
+  EXPECT_THAT(
+      WritePyramid(base, {level1}, {{2}}, DownsampleMethod::kMean).result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Number of downsample factors .*"));
+  EXPECT_THAT(
+      WritePyramid(base, {level1}, {{2, 0}}, DownsampleMethod::kMean).result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Invalid downsample factors.*"));
+}
+
+}  // namespace
@@ -14,12 +14,22 @@
 
 #include "tensorstore/driver/driver.h"
 
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/array.h"
 #include "tensorstore/array_storage_statistics.h"
 #include "tensorstore/batch.h"
@@ -32,6 +42,8 @@
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/dimension_units.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/digest/sha256.h"
+#include "tensorstore/internal/env.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/tagged_ptr.h"
@@ -41,6 +53,7 @@
 #include "tensorstore/rank.h"
 #include "tensorstore/resize_options.h"
 #include "tensorstore/schema.h"
+#include "tensorstore/serialization/batch.h"
 #include "tensorstore/serialization/fwd.h"
 #include "tensorstore/serialization/serialization.h"
 #include "tensorstore/transaction.h"
@@ -280,6 +293,74 @@ absl::Status SetReadWriteMode(DriverHandle& handle, ReadWriteMode new_mode) {
   return absl::OkStatus();
 }
 
+namespace {
+
+/// Recently decoded driver handles, keyed by the fingerprint of their spec.
+struct DecodedDriverHandleCache {
+  std::atomic<size_t> capacity{
+      internal::GetEnvValue<size_t>("TENSORSTORE_DECODED_DRIVER_CACHE_SIZE")
+          .value_or(0)};
+  absl::Mutex mutex;
+  /// Least recently used first.
+  std::vector<std::pair<std::string, DriverHandle>> entries
+      ABSL_GUARDED_BY(mutex);
+
+  std::optional<DriverHandle> Find(std::string_view fingerprint,
+                                   ReadWriteMode read_write_mode) {
+    absl::MutexLock lock(&mutex);
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (entries[i].first != fingerprint ||
+          entries[i].second.driver.read_write_mode() != read_write_mode) {
+        continue;
+      }
+      std::rotate(entries.begin() + i, entries.begin() + i + 1,
+                  entries.end());
+      return entries.back().second;
+    }
+    return std::nullopt;
+  }
+
+  void Insert(std::string fingerprint, const DriverHandle& handle) {
+    absl::MutexLock lock(&mutex);
+    entries.emplace_back(std::move(fingerprint), handle);
+    Trim(capacity.load(std::memory_order_relaxed));
+  }
+
+  void Trim(size_t max_entries) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    if (entries.size() > max_entries) {
+      entries.erase(entries.begin(),
+                    entries.begin() + (entries.size() - max_entries));
+    }
+  }
+};
+
+DecodedDriverHandleCache& GetDecodedDriverHandleCache() {
+  static absl::NoDestructor<DecodedDriverHandleCache> cache;
+  return *cache;
+}
+
+/// Returns a fingerprint that identifies equivalent specs, which is computed
+/// from their serialized representation.
+Result<std::string> GetSpecFingerprint(const TransformedDriverSpec& spec) {
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto encoded,
+      serialization::EncodeBatch(spec,
+                                 TransformedDriverSpecNonNullSerializer{}));
+  SHA256Digester digester;
+  digester.Write(encoded);
+  auto digest = digester.Digest();
+  return std::string(digest.begin(), digest.end());
+}
+
+}  // namespace
+
+void SetDecodedDriverHandleCacheCapacity(size_t capacity) {
+  auto& cache = GetDecodedDriverHandleCache();
+  absl::MutexLock lock(&cache.mutex);
+  cache.capacity.store(capacity, std::memory_order_relaxed);
+  cache.Trim(capacity);
+}
+
 bool DriverHandleNonNullSerializer::Encode(serialization::EncodeSink& sink,
                                            const DriverHandle& value) {
   assert(value.driver);
@@ -317,9 +398,22 @@ bool DriverHandleNonNullSerializer::Decode(serialization::DecodeSource& source,
   options.read_write_mode = static_cast<ReadWriteMode>(read_write_mode);
   options.open_mode =
       internal::GetOpenMode(spec) | OpenMode::assume_cached_metadata;
+  auto& cache = GetDecodedDriverHandleCache();
+  std::string fingerprint;
+  if (cache.capacity.load(std::memory_order_relaxed) != 0) {
+    // Specs that cannot be re-encoded are simply not cached.
+    if (auto f = GetSpecFingerprint(spec); f.ok()) {
+      fingerprint = *std::move(f);
+      if (auto handle = cache.Find(fingerprint, options.read_write_mode)) {
+        value = *std::move(handle);
+        return true;
+      }
+    }
+  }
   TENSORSTORE_ASSIGN_OR_RETURN(
       value, internal::OpenDriver(std::move(spec), std::move(options)).result(),
       (source.Fail(_), false));
+  if (!fingerprint.empty()) cache.Insert(std::move(fingerprint), value);
   return true;
 }
 
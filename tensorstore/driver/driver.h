@@ -331,6 +331,20 @@ Result<TransformedDriverSpec> GetTransformedDriverSpec(
 // If `new_mode == ReadWriteMode::dynamic`, the existing mode is unchanged.
 absl::Status SetReadWriteMode(DriverHandle& handle, ReadWriteMode new_mode);
 
+/// Sets the maximum number of recently decoded `DriverHandle` objects that are
+/// retained for reuse.
+///
+/// When a handle is decoded whose serialized spec and read-write mode match
+/// those of a retained handle, the retained handle is returned rather than
+/// opening the driver again.  This avoids the cost of opening, and allows the
+/// handles to share caches, when many short-lived tasks each decode the same
+/// handle.  However, a reused handle observes the data staleness bound of the
+/// original open.
+///
+/// Defaults to the value of the `TENSORSTORE_DECODED_DRIVER_CACHE_SIZE`
+/// environment variable, or 0, which disables reuse.
+void SetDecodedDriverHandleCacheCapacity(size_t capacity);
+
 struct DriverHandleNonNullSerializer {
   [[nodiscard]] static bool Encode(serialization::EncodeSink& sink,
                                    const DriverHandle& value);
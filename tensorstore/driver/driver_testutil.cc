@@ -1192,6 +1192,11 @@ ReadChunk MakeArrayBackedReadChunk(TransformedArray<Shared<const void>> data) {
                                        Arena* arena) {
       return GetTransformedArrayNDIterable({data, chunk_transform}, arena);
     }
+
+    bool operator()(ReadChunk::ReadArray, IndexTransformView<>,
+                    SharedOffsetArray<const void>&) {
+      return false;
+    }
   };
   ReadChunk chunk;
   chunk.impl = ReadChunkImpl{data.element_pointer()};
@@ -19,16 +19,20 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include <nlohmann/json.hpp>
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/context.h"
@@ -39,6 +43,7 @@
 #include "tensorstore/driver/driver_spec.h"
 #include "tensorstore/driver/registry.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_domain.h"
 #include "tensorstore/index_space/index_domain_builder.h"
 #include "tensorstore/index_space/index_transform.h"
@@ -51,6 +56,8 @@
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
+#include "tensorstore/internal/decode_offload.h"
+#include "tensorstore/internal/grid_partition.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/staleness_bound.h"  // IWYU pragma: keep
@@ -81,6 +88,80 @@ namespace tensorstore {
 namespace internal_image_driver {
 namespace {
 
+/// Shape of an image whose regions may be decoded independently.
+struct ImageChunking {
+  /// Shape of the image, `{height, width, num_components}`.
+  std::array<Index, 3> shape;
+
+  /// Shape `{height, width}` of the independently decodable regions, such as
+  /// TIFF tiles or strips, which form a regular grid with a zero origin.
+  std::array<Index, 2> chunk_shape;
+};
+
+/// Image data held by the cache.
+///
+/// If the specialization supports decoding regions of the image independently
+/// (see `kSupportsRegionDecoding`), the encoded image is retained and each read
+/// chunk decodes only the region it covers; otherwise, the entire image is
+/// decoded when read.
+struct ImageReadData : public ImageChunking {
+  /// Decoded image, if decoding is not deferred.
+  SharedArray<const uint8_t, 3> array;
+
+  /// Encoded image, if decoding is deferred.
+  absl::Cord encoded;
+
+  BoxView<3> domain() const { return BoxView<3>(shape); }
+};
+
+/// Indicates whether `Specialization` defines the members
+///
+///     Result<ImageChunking> DecodeImageChunking(absl::Cord value);
+///     absl::Status DecodeImageRegion(absl::Cord value,
+///                                    OffsetArrayView<uint8_t, 3> array_yxc);
+///
+/// instead of `DecodeImage`, where `DecodeImageRegion` decodes the region
+/// specified by the domain of `array_yxc` into it.
+template <typename Specialization, typename = void>
+constexpr inline bool kSupportsRegionDecoding = false;
+
+template <typename Specialization>
+constexpr inline bool kSupportsRegionDecoding<
+    Specialization, std::void_t<decltype(&Specialization::DecodeImageRegion)>> =
+    true;
+
+/// Decodes `value`, using `offload`, if not `nullptr`, unless it declines.
+///
+/// The offload is not used if decoding is deferred.
+template <typename Specialization>
+Result<ImageReadData> DecodeImageData(Specialization& specialization,
+                                      absl::Cord value,
+                                      const internal::DecodeOffload* offload) {
+  ImageReadData data;
+  if constexpr (kSupportsRegionDecoding<Specialization>) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto chunking,
+                                 specialization.DecodeImageChunking(value));
+    static_cast<ImageChunking&>(data) = chunking;
+    data.encoded = std::move(value);
+  } else {
+    std::optional<SharedArray<const uint8_t>> offloaded;
+    if (offload) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          offloaded,
+          internal::DecodeWithOffload(*offload, value, /*rank=*/3));
+    }
+    if (offloaded) {
+      data.array = StaticRankCast<3, unchecked>(*std::move(offloaded));
+    } else {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          data.array, specialization.DecodeImage(std::move(value)));
+    }
+    std::copy_n(data.array.shape().begin(), 3, data.shape.begin());
+    data.chunk_shape = {data.shape[0], data.shape[1]};
+  }
+  return data;
+}
+
 template <typename Specialization>
 class ImageDriverSpec
     : public internal::RegisteredDriverSpec<ImageDriverSpec<Specialization>,
@@ -198,7 +279,7 @@ class ImageCache : public internal::KvsBackedCache<ImageCache<Specialization>,
                                                  internal::AsyncCache>;
 
  public:
-  using ReadData = tensorstore::SharedArray<const uint8_t, 3>;
+  using ReadData = ImageReadData;
   using CacheType = ImageCache<Specialization>;
   using LockType = internal::AsyncCache::ReadLock<typename CacheType::ReadData>;
 
@@ -221,8 +302,10 @@ class ImageCache : public internal::KvsBackedCache<ImageCache<Specialization>,
       auto options = GetOwningCache(*this).specialization_;
       GetOwningCache(*this).executor()(
           [value = std::move(value), receiver = std::move(receiver),
-           options = std::move(options)]() mutable {
-            auto decode_result = options.DecodeImage(std::move(*value));
+           options = std::move(options),
+           offload = GetOwningCache(*this).decode_offload_]() mutable {
+            auto decode_result =
+                DecodeImageData(options, std::move(*value), offload.get());
             if (!decode_result.ok()) {
               execution::set_error(receiver, decode_result.status());
             } else {
@@ -234,8 +317,16 @@ class ImageCache : public internal::KvsBackedCache<ImageCache<Specialization>,
 
     void DoEncode(std::shared_ptr<const ReadData> data,
                   EncodeReceiver receiver) override {
+      if (!data->array.data()) {
+        // The image was not decoded, see `kSupportsRegionDecoding`.
+        execution::set_error(
+            receiver, absl::UnimplementedError(tensorstore::StrCat(
+                          "\"", Specialization::id,
+                          "\" driver does not support writing")));
+        return;
+      }
       auto encode_result =
-          GetOwningCache(*this).specialization_.EncodeImage(*data);
+          GetOwningCache(*this).specialization_.EncodeImage(data->array);
       if (!encode_result.ok()) {
         execution::set_error(receiver, encode_result.status());
       } else {
@@ -271,6 +362,9 @@ class ImageCache : public internal::KvsBackedCache<ImageCache<Specialization>,
       data_copy_concurrency_;
   Context::Resource<internal::CachePoolResource> cache_pool_;
   Specialization specialization_;
+
+  /// Offload for decoding images, or `nullptr` to decode on the CPU.
+  internal::DecodeOffload::Ptr decode_offload_;
 };
 
 template <typename Specialization>
@@ -306,6 +400,19 @@ class ImageDriver
   Result<ChunkLayout> GetChunkLayout(IndexTransformView<> transform) override {
     ChunkLayout layout;
     layout.Set(RankConstraint{3}).IgnoreError();
+    if constexpr (kSupportsRegionDecoding<Specialization>) {
+      // Reads are partitioned into the independently decodable regions.
+      LockType lock{*cache_entry_};
+      if (const auto* data = lock.data()) {
+        const Index grid_origin[3] = {0, 0, 0};
+        const Index chunk_shape[3] = {data->chunk_shape[0],
+                                      data->chunk_shape[1], data->shape[2]};
+        TENSORSTORE_RETURN_IF_ERROR(
+            layout.Set(ChunkLayout::GridOrigin(grid_origin)));
+        TENSORSTORE_RETURN_IF_ERROR(
+            layout.Set(ChunkLayout::ReadChunkShape(chunk_shape)));
+      }
+    }
     return layout | transform;
   }
 
@@ -322,6 +429,20 @@ class ImageDriver
             AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>
                 receiver) override;
 
+  /// Emits the read chunks for `transform` to `receiver` once the cache entry
+  /// has been read.
+  absl::Status EmitReadChunks(
+      IndexTransform<> transform,
+      AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>&
+          receiver);
+
+  /// Emits a read chunk for each independently decodable region of the image
+  /// that intersects `transform`, see `kSupportsRegionDecoding`.
+  absl::Status EmitRegionReadChunks(
+      IndexTransform<> transform,
+      AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>&
+          receiver);
+
   internal::PinnedCacheEntry<CacheType> cache_entry_;
   StalenessBound data_staleness_;
 };
@@ -352,6 +473,8 @@ Future<internal::DriverHandle> ImageDriverSpec<Specialization>::Open(
         cache->data_copy_concurrency_ = data_copy_concurrency;
         cache->cache_pool_ = cache_pool;
         cache->specialization_ = specialization;
+        cache->decode_offload_ = internal::GetDecodeOffload(
+            Specialization::id, ::nlohmann::json::object_t());
         return cache;
       },
       [&](Promise<void> initialize_promise,
@@ -516,6 +639,8 @@ struct ReadChunkImpl {
 
   internal::IntrusivePtr<DriverType> self;
   internal::PinnedCacheEntry<CacheType> entry;
+  // Region of the image covered by the chunk, if decoding is deferred.
+  Box<3> region;
 
   absl::Status operator()(internal::LockCollection& lock_collection) const {
     return absl::OkStatus();
@@ -524,10 +649,31 @@ struct ReadChunkImpl {
   Result<internal::NDIterable::Ptr> operator()(internal::ReadChunk::BeginRead,
                                                IndexTransform<> chunk_transform,
                                                internal::Arena* arena) const {
-    LockType lock{*entry};
-    assert(lock.data());
-    return internal::GetTransformedArrayNDIterable(*lock.data(),
-                                                   chunk_transform, arena);
+    if constexpr (!kSupportsRegionDecoding<Specialization>) {
+      LockType lock{*entry};
+      assert(lock.data());
+      return internal::GetTransformedArrayNDIterable(lock.data()->array,
+                                                     chunk_transform, arena);
+    } else {
+      absl::Cord encoded;
+      {
+        LockType lock{*entry};
+        assert(lock.data());
+        encoded = lock.data()->encoded;
+      }
+      // Decode just the region covered by this chunk.
+      auto array = AllocateArray<uint8_t>(region);
+      TENSORSTORE_RETURN_IF_ERROR(
+          GetOwningCache(*entry).specialization_.DecodeImageRegion(
+              std::move(encoded), array));
+      return internal::GetTransformedArrayNDIterable(std::move(array),
+                                                     chunk_transform, arena);
+    }
+  }
+
+  bool operator()(internal::ReadChunk::ReadArray, IndexTransformView<>,
+                  SharedOffsetArray<const void>&) {
+    return false;
   }
 };
 
@@ -544,31 +690,86 @@ void ImageDriver<Specialization>::Read(
     return;
   }
 
-  internal::ReadChunk chunk;
-  chunk.impl = ReadChunkImpl<Specialization>{
-      internal::IntrusivePtr<ImageDriver>(this), cache_entry_};
-  chunk.transform = std::move(request.transform);
-
   // TODO: Wire in execution::set_cancel correctly.
   execution::set_starting(receiver, [] {});
   internal::AsyncCache::AsyncCacheReadRequest read_request;
   read_request.staleness_bound = data_staleness_.time;
   read_request.batch = request.batch;
   auto read_future = cache_entry_->Read(std::move(read_request));
-  read_future.ExecuteWhenReady([chunk = std::move(chunk),
-                                receiver = std::move(receiver)](
-                                   ReadyFuture<const void> future) mutable {
-    auto& r = future.result();
-    if (!r.ok()) {
-      execution::set_error(receiver, r.status());
-    } else {
-      auto cell_transform = IdentityTransform(chunk.transform.input_domain());
-      execution::set_value(receiver, std::move(chunk),
-                           std::move(cell_transform));
-      execution::set_done(receiver);
-    }
-    execution::set_stopping(receiver);
-  });
+  read_future.ExecuteWhenReady(
+      [self = internal::IntrusivePtr<ImageDriver>(this),
+       transform = std::move(request.transform),
+       receiver = std::move(receiver)](ReadyFuture<const void> future) mutable {
+        auto& r = future.result();
+        if (!r.ok()) {
+          execution::set_error(receiver, r.status());
+        } else if (auto status =
+                       self->EmitReadChunks(std::move(transform), receiver);
+                   !status.ok()) {
+          execution::set_error(receiver, std::move(status));
+        } else {
+          execution::set_done(receiver);
+        }
+        execution::set_stopping(receiver);
+      });
+}
+
+template <typename Specialization>
+absl::Status ImageDriver<Specialization>::EmitReadChunks(
+    IndexTransform<> transform,
+    AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>&
+        receiver) {
+  if constexpr (!kSupportsRegionDecoding<Specialization>) {
+    // The decoded image is yielded as a single chunk.
+    internal::ReadChunk chunk;
+    chunk.impl = ReadChunkImpl<Specialization>{
+        internal::IntrusivePtr<ImageDriver>(this), cache_entry_};
+    auto cell_transform = IdentityTransform(transform.input_domain());
+    chunk.transform = std::move(transform);
+    execution::set_value(receiver, std::move(chunk),
+                         std::move(cell_transform));
+    return absl::OkStatus();
+  } else {
+    return EmitRegionReadChunks(std::move(transform), receiver);
+  }
+}
+
+template <typename Specialization>
+absl::Status ImageDriver<Specialization>::EmitRegionReadChunks(
+    IndexTransform<> transform,
+    AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>&
+        receiver) {
+  ImageChunking chunking;
+  {
+    LockType lock{*cache_entry_};
+    assert(lock.data());
+    chunking = *lock.data();
+  }
+  // Yield a chunk for each independently decodable region that intersects
+  // the request, such that only those regions are decoded, in parallel.
+  static constexpr DimensionIndex kGridOutputDimensions[] = {0, 1};
+  return internal::PartitionIndexTransformOverRegularGrid(
+      kGridOutputDimensions, chunking.chunk_shape, transform,
+      [&](span<const Index> grid_cell_indices,
+          IndexTransformView<> cell_transform) -> absl::Status {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto cell_to_source, ComposeTransforms(transform, cell_transform));
+        ReadChunkImpl<Specialization> impl{
+            internal::IntrusivePtr<ImageDriver>(this), cache_entry_};
+        impl.region = BoxView<3>(chunking.shape);
+        for (DimensionIndex i = 0; i < 2; ++i) {
+          const Index origin = grid_cell_indices[i] * chunking.chunk_shape[i];
+          impl.region[i] = IndexInterval::UncheckedHalfOpen(
+              origin,
+              std::min(origin + chunking.chunk_shape[i], chunking.shape[i]));
+        }
+        internal::ReadChunk chunk;
+        chunk.impl = std::move(impl);
+        chunk.transform = std::move(cell_to_source);
+        execution::set_value(receiver, std::move(chunk),
+                             IndexTransform<>(cell_transform));
+        return absl::OkStatus();
+      });
 }
 
 }  // namespace
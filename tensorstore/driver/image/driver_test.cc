@@ -311,6 +311,37 @@ TEST_P(ImageDriverReadTest, MissingPath_Open) {
               MatchesStatus(absl::StatusCode::kNotFound));
 }
 
+// TIFF strips are exposed as read chunks, and are decoded independently.
+TEST(ImageDriverTiffTest, ReadChunks) {
+  auto context = Context::Default();
+  ::nlohmann::json spec{
+      {"driver", "tiff"},
+      {"kvstore", {{"driver", "memory"}, {"path", "d.tiff"}}},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto kvs, tensorstore::kvstore::Open(spec["kvstore"], context).result());
+  TENSORSTORE_ASSERT_OK(tensorstore::kvstore::Write(
+      kvs, {}, ::tensorstore::internal_image_driver::GetTiff()));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store,
+                                   tensorstore::Open(spec, context).result());
+
+  // The test image is written with a single row per strip.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto layout, store.chunk_layout());
+  EXPECT_THAT(layout.read_chunk_shape(), ::testing::ElementsAre(1, 256, 3));
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto array,
+                                   tensorstore::Read(store).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto region,
+      tensorstore::Read(store | tensorstore::Dims(0, 1).SizedInterval(
+                                    {49, 99}, {3, 103}))
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto expected,
+      array | tensorstore::Dims(0, 1).SizedInterval({49, 99}, {3, 103}));
+  EXPECT_EQ(expected, region);
+}
+
 TEST(ImageDriverErrors, NoKvStore) {
   EXPECT_THAT(
       tensorstore::Open({
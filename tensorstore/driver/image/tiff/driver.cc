@@ -14,17 +14,20 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <array>
 
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/reader.h"
 #include "tensorstore/array.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/image/driver_impl.h"
 #include "tensorstore/driver/registry.h"
 #include "tensorstore/index.h"
+#include "tensorstore/internal/image/image_info.h"
 #include "tensorstore/internal/image/tiff_reader.h"
 #include "tensorstore/internal/image/tiff_writer.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
@@ -40,6 +43,7 @@ namespace {
 
 using ::tensorstore::internal_image::ImageInfo;
 using ::tensorstore::internal_image::TiffReader;
+using ::tensorstore::internal_image::TiffReaderOptions;
 using ::tensorstore::internal_image::TiffWriter;
 
 namespace jb = tensorstore::internal_json_binding;
@@ -92,43 +96,78 @@ struct TiffSpecialization : public TiffReadOptions {
     return output;
   }
 
-  Result<SharedArray<uint8_t, 3>> DecodeImage(absl::Cord value) {
-    SharedArray<uint8_t, 3> array_yxc;
+  // TIFF images are stored as independently decodable tiles or strips, so
+  // only those intersecting a read are decoded; see `kSupportsRegionDecoding`.
+  Result<ImageChunking> DecodeImageChunking(absl::Cord value) const {
+    ImageChunking chunking;
     auto status = [&]() -> absl::Status {
       riegeli::CordReader<> buffer_reader(&value);
       TiffReader reader;
+      TENSORSTORE_ASSIGN_OR_RETURN(auto info,
+                                   InitializeReader(reader, &buffer_reader));
+      const auto chunk_shape = reader.GetChunkShape();
+      chunking.shape = {static_cast<Index>(info.height),
+                        static_cast<Index>(info.width),
+                        static_cast<Index>(info.num_components)};
+      chunking.chunk_shape = {
+          std::max(Index{1}, static_cast<Index>(chunk_shape[0])),
+          std::max(Index{1}, static_cast<Index>(chunk_shape[1]))};
+      return absl::OkStatus();
+    }();
+    TENSORSTORE_RETURN_IF_ERROR(ConvertDecodeStatus(std::move(status)));
+    return chunking;
+  }
 
-      TENSORSTORE_RETURN_IF_ERROR(reader.Initialize(&buffer_reader));
-
-      if (page.has_value()) {
-        TENSORSTORE_RETURN_IF_ERROR(reader.SeekFrame(*page));
-      } else if (reader.GetFrameCount() > 1) {
-        // TIFF files often have embedded thumbnails, etc. This driver doesn't
-        // attempt to guess which pages are the correct one.
-        return absl::DataLossError(
-            "Multi-page TIFF image encountered without a \"page\" specifier. ");
-      }
-      ImageInfo info = reader.GetImageInfo();
-      if (info.dtype != dtype_v<uint8_t>) {
-        return absl::UnimplementedError(
-            "\"tiff\" driver only supports uint8 images");
-      }
-      std::array<Index, 3> shape_yxc = {
-          static_cast<Index>(info.height), static_cast<Index>(info.width),
-          static_cast<Index>(info.num_components)};
-      array_yxc = AllocateArray<uint8_t>(shape_yxc);
-      return reader.Decode(tensorstore::span(
-          reinterpret_cast<unsigned char*>(array_yxc.data()),
-          array_yxc.num_elements() * array_yxc.dtype().size()));
+  absl::Status DecodeImageRegion(absl::Cord value,
+                                 OffsetArrayView<uint8_t, 3> array_yxc) const {
+    auto status = [&]() -> absl::Status {
+      riegeli::CordReader<> buffer_reader(&value);
+      TiffReader reader;
+      TENSORSTORE_RETURN_IF_ERROR(
+          InitializeReader(reader, &buffer_reader).status());
+      TiffReaderOptions options;
+      options.region = {
+          /*.y=*/static_cast<size_t>(array_yxc.origin()[0]),
+          /*.x=*/static_cast<size_t>(array_yxc.origin()[1]),
+          /*.height=*/static_cast<size_t>(array_yxc.shape()[0]),
+          /*.width=*/static_cast<size_t>(array_yxc.shape()[1])};
+      return reader.Decode(
+          tensorstore::span(reinterpret_cast<unsigned char*>(
+                                array_yxc.byte_strided_origin_pointer().get()),
+                            array_yxc.num_elements()),
+          options);
     }();
-    if (!status.ok()) {
-      if (status.code() == absl::StatusCode::kInvalidArgument) {
-        return internal::MaybeConvertStatusTo(std::move(status),
-                                              absl::StatusCode::kDataLoss);
-      }
-      return status;
+    return ConvertDecodeStatus(std::move(status));
+  }
+
+ private:
+  // Initializes `reader` and seeks to the page to read, returning its info.
+  Result<ImageInfo> InitializeReader(TiffReader& reader,
+                                     riegeli::Reader* buffer_reader) const {
+    TENSORSTORE_RETURN_IF_ERROR(reader.Initialize(buffer_reader));
+
+    if (page.has_value()) {
+      TENSORSTORE_RETURN_IF_ERROR(reader.SeekFrame(*page));
+    } else if (reader.GetFrameCount() > 1) {
+      // TIFF files often have embedded thumbnails, etc. This driver doesn't
+      // attempt to guess which pages are the correct one.
+      return absl::DataLossError(
+          "Multi-page TIFF image encountered without a \"page\" specifier. ");
+    }
+    ImageInfo info = reader.GetImageInfo();
+    if (info.dtype != dtype_v<uint8_t>) {
+      return absl::UnimplementedError(
+          "\"tiff\" driver only supports uint8 images");
+    }
+    return info;
+  }
+
+  static absl::Status ConvertDecodeStatus(absl::Status status) {
+    if (status.code() == absl::StatusCode::kInvalidArgument) {
+      return internal::MaybeConvertStatusTo(std::move(status),
+                                            absl::StatusCode::kDataLoss);
     }
-    return array_yxc;
+    return status;
   }
 };
 
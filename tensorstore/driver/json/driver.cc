@@ -20,6 +20,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "absl/status/status.h"
@@ -33,6 +34,7 @@
 #include "tensorstore/driver/driver_handle.h"
 #include "tensorstore/driver/driver_spec.h"
 #include "tensorstore/driver/json/json_change_map.h"
+#include "tensorstore/driver/json/json_document.h"
 #include "tensorstore/driver/registry.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/index_domain.h"
@@ -46,7 +48,6 @@
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/intrusive_ptr.h"
-#include "tensorstore/internal/json/same.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/staleness_bound.h"
 #include "tensorstore/internal/json_pointer.h"
@@ -82,26 +83,16 @@ namespace {
 
 namespace jb = tensorstore::internal_json_binding;
 
-Result<::nlohmann::json> DecodeJson(const std::optional<absl::Cord>& data) {
-  if (!data) {
-    return ::nlohmann::json(::nlohmann::json::value_t::discarded);
-  }
-  nlohmann::json raw_data =
-      nlohmann::json::parse(absl::Cord(*data).Flatten(), nullptr,
-                            /*allow_exceptions=*/false);
-  if (raw_data.is_discarded()) {
-    return absl::FailedPreconditionError("Invalid JSON");
-  }
-  return raw_data;
-}
-
 class JsonCache
     : public internal::KvsBackedCache<JsonCache, internal::AsyncCache>,
       public AsyncInitializedCacheMixin {
   using Base = internal::KvsBackedCache<JsonCache, internal::AsyncCache>;
 
  public:
-  using ReadData = ::nlohmann::json;
+  /// The document is only validated when decoded; values are parsed on demand
+  /// when dereferenced, and writeback splices the changed values into the
+  /// existing encoded text.
+  using ReadData = internal_json_driver::JsonDocument;
 
   JsonCache() : Base(kvstore::DriverPtr()) {}
 
@@ -112,23 +103,25 @@ class JsonCache
                   DecodeReceiver receiver) override {
       GetOwningCache(*this).executor()(
           [value = std::move(value), receiver = std::move(receiver)]() mutable {
-            auto decode_result = DecodeJson(value);
+            auto decode_result = ReadData::Parse(value);
             if (!decode_result.ok()) {
               execution::set_error(receiver, decode_result.status());
               return;
             }
-            execution::set_value(receiver, std::make_shared<::nlohmann::json>(
+            execution::set_value(receiver, std::make_shared<ReadData>(
                                                std::move(*decode_result)));
           });
     }
     void DoEncode(std::shared_ptr<const ReadData> data,
                   EncodeReceiver receiver) override {
-      const auto& json_value = *data;
-      if (json_value.is_discarded()) {
+      if (data->missing()) {
         execution::set_value(receiver, std::nullopt);
         return;
       }
-      execution::set_value(receiver, absl::Cord(json_value.dump()));
+      // Reference the encoded text without copying it.
+      std::string_view text = data->text();
+      execution::set_value(receiver, absl::MakeCordFromExternal(
+                                         text, [data = std::move(data)] {}));
     }
   };
 
@@ -163,30 +156,27 @@ class JsonCache
             }
 
             if (!unmodified) {
-              auto* existing_json =
-                  static_cast<const ::nlohmann::json*>(read_state.data.get());
-              ::nlohmann::json new_json;
-              // Apply changes.  If `existing_state` is non-null (equivalent to
-              // `unconditional == false`), provide it to `Apply`.  Otherwise,
-              // pass in a placeholder value (which won't be used).
-              auto result = changes_.Apply(
-                  existing_json
-                      ? *existing_json
-                      : ::nlohmann::json(::nlohmann::json::value_t::discarded));
-              if (result.ok()) {
-                new_json = std::move(*result);
-              } else {
+              auto* existing =
+                  static_cast<const ReadData*>(read_state.data.get());
+              // Apply changes.  If `existing` is non-null (equivalent to
+              // `unconditional == false`), apply them to it.  Otherwise,
+              // apply them to a placeholder missing document (which won't be
+              // used).
+              const ReadData placeholder;
+              bool modified;
+              auto result = (existing ? *existing : placeholder)
+                                .ApplyChanges(changes_, modified);
+              if (!result.ok()) {
                 execution::set_error(receiver, std::move(result).status());
                 return;
               }
               // For conditional states, only mark dirty if it differs from the
               // existing state, since otherwise the writeback can be skipped
               // (and instead the state can just be verified).
-              if (!existing_json ||
-                  !internal_json::JsonSame(new_json, *existing_json)) {
+              if (!existing || modified) {
                 read_state.stamp.generation.MarkDirty();
                 read_state.data =
-                    std::make_shared<::nlohmann::json>(std::move(new_json));
+                    std::make_shared<ReadData>(std::move(*result));
               }
             }
             execution::set_value(receiver, std::move(read_state));
@@ -433,17 +423,22 @@ struct ReadChunkImpl {
     // Note that this acquires a lock on the entry, not the node, and
     // therefore does not conflict with the lock registered with the
     // `LockCollection`.
-    std::shared_ptr<const ::nlohmann::json> read_value =
+    std::shared_ptr<const JsonCache::ReadData> read_value =
         AsyncCache::ReadLock<JsonCache::ReadData>(*entry).shared_data();
+    // Only the value referenced by `json_pointer_` is parsed.
     TENSORSTORE_ASSIGN_OR_RETURN(
-        auto* sub_value,
-        json_pointer::Dereference(*read_value, driver->json_pointer_),
+        auto* sub_value, read_value->Dereference(driver->json_pointer_),
         entry->AnnotateError(_, /*reading=*/true));
     return GetTransformedArrayNDIterable(
         std::shared_ptr<const ::nlohmann::json>(std::move(read_value),
                                                 sub_value),
         std::move(chunk_transform), arena);
   }
+
+  bool operator()(ReadChunk::ReadArray, IndexTransformView<>,
+                  SharedOffsetArray<const void>&) {
+    return false;
+  }
 };
 
 /// TensorStore Driver ReadChunk implementation for the case of a transactional
@@ -464,7 +459,7 @@ struct ReadChunkTransactionImpl {
   Result<NDIterable::Ptr> operator()(ReadChunk::BeginRead,
                                      IndexTransform<> chunk_transform,
                                      Arena* arena) {
-    std::shared_ptr<const ::nlohmann::json> existing_value;
+    std::shared_ptr<const JsonCache::ReadData> existing_value;
     StorageGeneration read_generation;
     {
       AsyncCache::ReadLock<JsonCache::ReadData> lock(*node);
@@ -482,18 +477,26 @@ struct ReadChunkTransactionImpl {
       }
       assert(existing_value ||
              node->changes_.CanApplyUnconditionally(driver->json_pointer_));
+      const JsonCache::ReadData placeholder;
+      const auto& existing = existing_value ? *existing_value : placeholder;
       TENSORSTORE_ASSIGN_OR_RETURN(
           *value,
           node->changes_.Apply(
-              existing_value
-                  ? *existing_value
-                  : ::nlohmann::json(::nlohmann::json::value_t::discarded),
+              [&](std::string_view pointer) {
+                return existing.Dereference(pointer,
+                                            json_pointer::kSimulateCreate);
+              },
               driver->json_pointer_),
           GetOwningEntry(*node).AnnotateError(_, /*reading=*/true));
     }
     return GetTransformedArrayNDIterable(std::move(value), chunk_transform,
                                          arena);
   }
+
+  bool operator()(ReadChunk::ReadArray, IndexTransformView<>,
+                  SharedOffsetArray<const void>&) {
+    return false;
+  }
 };
 
 void JsonDriver::Read(
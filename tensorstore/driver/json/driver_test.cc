@@ -327,6 +327,31 @@ TEST(JsonDriverTest, UnconditionalWriteback) {
   TENSORSTORE_EXPECT_OK(write_future);
 }
 
+TEST(JsonDriverTest, WritePreservesUnchangedText) {
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto kvs, tensorstore::kvstore::Open(GetKvstoreSpec(), context).result());
+  TENSORSTORE_EXPECT_OK(kvstore::Write(
+      kvs, GetPath(),
+      absl::Cord("{ \"a\": [1,  2.50],\n  \"b\": {\"c\": 1} }")));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store_b_c, tensorstore::Open(GetSpec("/b/c"), context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store_b_d, tensorstore::Open(GetSpec("/b/d"), context).result());
+  EXPECT_THAT(tensorstore::Read(store_b_c).result(),
+              Optional(MakeScalarArray<::nlohmann::json>(1)));
+  TENSORSTORE_EXPECT_OK(
+      tensorstore::Write(MakeScalarArray<::nlohmann::json>("x"), store_b_c));
+  TENSORSTORE_EXPECT_OK(
+      tensorstore::Write(MakeScalarArray<::nlohmann::json>(true), store_b_d));
+  // The encoded text of unchanged values, including their formatting, is
+  // preserved.
+  EXPECT_THAT(GetMap(kvs).value(),
+              testing::ElementsAre(Pair(
+                  GetPath(), absl::Cord("{ \"a\": [1,  2.50],\n  \"b\": "
+                                        "{\"c\": \"x\",\"d\":true} }"))));
+}
+
 TEST(JsonDriverTest, ZeroElementWrite) {
   auto json_spec = GetSpec("");
   json_spec["kvstore"] = {{"driver", "mock_key_value_store"},
@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "absl/container/btree_map.h"
+#include "absl/functional/function_ref.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/internal/json_pointer.h"
 #include "tensorstore/util/status.h"
@@ -29,6 +30,18 @@ namespace internal_json_driver {
 Result<::nlohmann::json> JsonChangeMap::Apply(
     const ::nlohmann::json& existing,
     std::string_view sub_value_pointer) const {
+  return Apply(
+      [&](std::string_view pointer) {
+        return json_pointer::Dereference(existing, pointer,
+                                         json_pointer::kSimulateCreate);
+      },
+      sub_value_pointer);
+}
+
+Result<::nlohmann::json> JsonChangeMap::Apply(
+    absl::FunctionRef<Result<const ::nlohmann::json*>(std::string_view)>
+        dereference_existing,
+    std::string_view sub_value_pointer) const {
   Map::const_iterator changes_it = map_.lower_bound(sub_value_pointer),
                       changes_end = map_.end();
   // Check if `sub_value_pointer` is exactly present as a map entry.
@@ -38,8 +51,7 @@ Result<::nlohmann::json> JsonChangeMap::Apply(
 
     // Validate preconditions on `existing`.
     TENSORSTORE_RETURN_IF_ERROR(
-        json_pointer::Dereference(existing, sub_value_pointer,
-                                  json_pointer::kSimulateCreate),
+        dereference_existing(sub_value_pointer),
         internal::ConvertInvalidArgumentToFailedPrecondition(_));
     // avoid basic_json::operator ValueType()
     return {std::in_place, changes_it->second};
@@ -60,8 +72,7 @@ Result<::nlohmann::json> JsonChangeMap::Apply(
               json_pointer::kMustExist));
       // Validate preconditions of entry referred to by `prev_it`.
       TENSORSTORE_RETURN_IF_ERROR(
-          json_pointer::Dereference(existing, prev_it->first,
-                                    json_pointer::kSimulateCreate),
+          dereference_existing(prev_it->first),
           internal::ConvertInvalidArgumentToFailedPrecondition(_));
       return {std::in_place, *modified_value};
     }
@@ -78,8 +89,7 @@ Result<::nlohmann::json> JsonChangeMap::Apply(
     // Find value in `existing` corresponding to `sub_value_pointer`.
     TENSORSTORE_ASSIGN_OR_RETURN(
         const ::nlohmann::json* restricted_existing,
-        json_pointer::Dereference(existing, sub_value_pointer,
-                                  json_pointer::kSimulateCreate));
+        dereference_existing(sub_value_pointer));
     if (restricted_existing) {
       new_value = *restricted_existing;
     } else {
@@ -19,8 +19,10 @@
 #include <string_view>
 
 #include "absl/container/btree_map.h"
+#include "absl/functional/function_ref.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/internal/json_pointer.h"
+#include "tensorstore/util/result.h"
 
 namespace tensorstore {
 namespace internal_json_driver {
@@ -69,6 +71,18 @@ class JsonChangeMap {
   Result<::nlohmann::json> Apply(const ::nlohmann::json& existing,
                                  std::string_view sub_value_pointer = {}) const;
 
+  /// Same as above, but only obtains the portions of the existing value that
+  /// are actually needed.
+  ///
+  /// \param dereference_existing Function that returns the result of
+  ///     `json_pointer::Dereference(existing, pointer, kSimulateCreate)`.
+  /// \param sub_value_pointer JSON Pointer specifying the portion of the
+  ///     result to return.
+  Result<::nlohmann::json> Apply(
+      absl::FunctionRef<Result<const ::nlohmann::json*>(std::string_view)>
+          dereference_existing,
+      std::string_view sub_value_pointer = {}) const;
+
   /// Determines whether `Apply` called with `sub_value_pointer` does not depend
   /// on `existing`.
   ///
@@ -0,0 +1,452 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/json/json_document.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_replace.h"
+#include "absl/synchronization/mutex.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/driver/json/json_change_map.h"
+#include "tensorstore/internal/json/same.h"
+#include "tensorstore/internal/json_pointer.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal_json_driver {
+namespace {
+
+absl::Status InvalidJsonError() {
+  return absl::FailedPreconditionError("Invalid JSON");
+}
+
+Result<::nlohmann::json> ParseJsonText(std::string_view text) {
+  auto value = ::nlohmann::json::parse(text, nullptr,
+                                       /*allow_exceptions=*/false);
+  if (value.is_discarded()) return InvalidJsonError();
+  return value;
+}
+
+std::string DecodeReferenceToken(std::string_view token) {
+  return absl::StrReplaceAll(token, {{"~1", "/"}, {"~0", "~"}});
+}
+
+/// Scans over encoded JSON text without parsing it.
+///
+/// Each `Skip` method advances past the corresponding syntactic element and
+/// returns `true`, or returns `false` if the text at the current position is
+/// not valid.
+class JsonScanner {
+ public:
+  explicit JsonScanner(std::string_view text, size_t pos = 0)
+      : text_(text), pos_(pos) {}
+
+  size_t pos() const { return pos_; }
+  bool done() const { return pos_ == text_.size(); }
+
+  /// Returns the next character, or `'\0'` at the end of the text.
+  char Peek() const { return pos_ < text_.size() ? text_[pos_] : '\0'; }
+
+  bool Consume(char c) {
+    if (done() || text_[pos_] != c) return false;
+    ++pos_;
+    return true;
+  }
+
+  void SkipWhitespace() {
+    while (!done()) {
+      char c = text_[pos_];
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+      ++pos_;
+    }
+  }
+
+  bool SkipString() {
+    if (!Consume('"')) return false;
+    while (!done()) {
+      unsigned char c = text_[pos_++];
+      if (c == '"') return true;
+      if (c < 0x20) return false;
+      if (c != '\\') continue;
+      if (done()) return false;
+      c = text_[pos_++];
+      if (c == 'u') {
+        for (int i = 0; i < 4; ++i) {
+          if (done() || !absl::ascii_isxdigit(text_[pos_])) return false;
+          ++pos_;
+        }
+      } else if (!absl::StrContains("\"\\/bfnrt", c)) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+  /// Reads a string, decoding any escape sequences.
+  bool ReadString(std::string& out) {
+    const size_t begin = pos_;
+    if (!SkipString()) return false;
+    std::string_view encoded = text_.substr(begin, pos_ - begin);
+    if (encoded.find('\\') == std::string_view::npos) {
+      out = encoded.substr(1, encoded.size() - 2);
+      return true;
+    }
+    auto value = ::nlohmann::json::parse(encoded, nullptr,
+                                         /*allow_exceptions=*/false);
+    if (!value.is_string()) return false;
+    out = value.get<std::string>();
+    return true;
+  }
+
+  bool SkipNumber() {
+    Consume('-');
+    if (!Consume('0') && SkipDigits() == 0) return false;
+    if (Consume('.') && SkipDigits() == 0) return false;
+    if (Consume('e') || Consume('E')) {
+      if (!Consume('+')) Consume('-');
+      if (SkipDigits() == 0) return false;
+    }
+    return true;
+  }
+
+  /// Skips `whitespace string whitespace ':'` within an object.
+  bool SkipMemberName() {
+    SkipWhitespace();
+    if (!SkipString()) return false;
+    SkipWhitespace();
+    return Consume(':');
+  }
+
+  bool SkipValue() {
+    // Enclosing containers, as their opening characters.
+    absl::InlinedVector<char, 16> stack;
+    while (true) {
+      SkipWhitespace();
+      const char c = Peek();
+      if (c == '{' || c == '[') {
+        ++pos_;
+        SkipWhitespace();
+        if (!Consume(c == '{' ? '}' : ']')) {
+          stack.push_back(c);
+          if (c == '{' && !SkipMemberName()) return false;
+          continue;
+        }
+      } else if (!SkipScalar()) {
+        return false;
+      }
+      // Advance to the next value, closing any completed containers.
+      while (true) {
+        if (stack.empty()) return true;
+        SkipWhitespace();
+        if (Consume(',')) {
+          if (stack.back() == '{' && !SkipMemberName()) return false;
+          break;
+        }
+        if (!Consume(stack.back() == '{' ? '}' : ']')) return false;
+        stack.pop_back();
+      }
+    }
+  }
+
+ private:
+  size_t SkipDigits() {
+    const size_t begin = pos_;
+    while (!done() && absl::ascii_isdigit(text_[pos_])) ++pos_;
+    return pos_ - begin;
+  }
+
+  bool SkipLiteral(std::string_view literal) {
+    if (!absl::StartsWith(text_.substr(pos_), literal)) return false;
+    pos_ += literal.size();
+    return true;
+  }
+
+  bool SkipScalar() {
+    switch (Peek()) {
+      case '"':
+        return SkipString();
+      case 't':
+        return SkipLiteral("true");
+      case 'f':
+        return SkipLiteral("false");
+      case 'n':
+        return SkipLiteral("null");
+      default:
+        return SkipNumber();
+    }
+  }
+
+  std::string_view text_;
+  size_t pos_;
+};
+
+/// Parses a JSON Pointer reference token as an array index.
+std::optional<size_t> ParseArrayIndex(std::string_view token) {
+  if (token.empty() || (token.size() > 1 && token[0] == '0')) {
+    return std::nullopt;
+  }
+  for (char c : token) {
+    if (!absl::ascii_isdigit(c)) return std::nullopt;
+  }
+  size_t index;
+  if (!absl::SimpleAtoi(token, &index)) return std::nullopt;
+  return index;
+}
+
+/// Advances `scanner`, positioned at the start of an object, to the value of
+/// the member named `name`.
+///
+/// Returns `false` if there is no such member.
+bool FindObjectMember(JsonScanner& scanner, std::string_view name) {
+  scanner.Consume('{');
+  scanner.SkipWhitespace();
+  if (scanner.Consume('}')) return false;
+  std::string member_name;
+  while (true) {
+    scanner.SkipWhitespace();
+    if (!scanner.ReadString(member_name)) return false;
+    scanner.SkipWhitespace();
+    if (!scanner.Consume(':')) return false;
+    scanner.SkipWhitespace();
+    if (member_name == name) return true;
+    if (!scanner.SkipValue()) return false;
+    scanner.SkipWhitespace();
+    if (!scanner.Consume(',')) return false;
+  }
+}
+
+/// Advances `scanner`, positioned at the start of an array, to the element at
+/// `index`.
+///
+/// Returns `false` if there is no such element.
+bool FindArrayElement(JsonScanner& scanner, size_t index) {
+  scanner.Consume('[');
+  scanner.SkipWhitespace();
+  if (scanner.Consume(']')) return false;
+  for (size_t i = 0;; ++i) {
+    scanner.SkipWhitespace();
+    if (i == index) return true;
+    if (!scanner.SkipValue()) return false;
+    scanner.SkipWhitespace();
+    if (!scanner.Consume(',')) return false;
+  }
+}
+
+/// Replacement of the byte range `[begin, end)` of the existing text.
+struct TextEdit {
+  size_t begin, end;
+  std::string text;
+  // Indicates that `text` is a new object member, which must be preceded by a
+  // comma unless it is the first member of the object.
+  bool new_member = false;
+  bool object_empty = false;
+};
+
+}  // namespace
+
+absl::Status ValidateJsonText(std::string_view text) {
+  JsonScanner scanner(text);
+  if (!scanner.SkipValue()) return InvalidJsonError();
+  scanner.SkipWhitespace();
+  if (!scanner.done()) return InvalidJsonError();
+  return absl::OkStatus();
+}
+
+Result<JsonTextLocation> LocateJsonPointer(std::string_view text,
+                                           std::string_view json_pointer) {
+  JsonScanner scanner(text);
+  scanner.SkipWhitespace();
+  size_t pointer_length = 0;
+  while (pointer_length < json_pointer.size()) {
+    size_t token_end = json_pointer.find('/', pointer_length + 1);
+    if (token_end == std::string_view::npos) token_end = json_pointer.size();
+    std::string_view token =
+        json_pointer.substr(pointer_length + 1, token_end - pointer_length - 1);
+    bool found = false;
+    JsonScanner child_scanner = scanner;
+    if (scanner.Peek() == '{') {
+      found = FindObjectMember(child_scanner, DecodeReferenceToken(token));
+    } else if (scanner.Peek() == '[') {
+      if (auto index = ParseArrayIndex(token)) {
+        found = FindArrayElement(child_scanner, *index);
+      }
+    }
+    if (!found) break;
+    scanner = child_scanner;
+    pointer_length = token_end;
+  }
+  const size_t begin = scanner.pos();
+  if (!scanner.SkipValue()) return InvalidJsonError();
+  return JsonTextLocation{begin, scanner.pos(), pointer_length};
+}
+
+JsonDocument JsonDocument::FromJson(const ::nlohmann::json& value) {
+  if (value.is_discarded()) return JsonDocument();
+  return JsonDocument(value.dump());
+}
+
+Result<JsonDocument> JsonDocument::Parse(
+    const std::optional<absl::Cord>& encoded) {
+  if (!encoded) return JsonDocument();
+  std::string text(*encoded);
+  TENSORSTORE_RETURN_IF_ERROR(ValidateJsonText(text));
+  return JsonDocument(std::move(text));
+}
+
+Result<const ::nlohmann::json*> JsonDocument::Dereference(
+    std::string_view json_pointer,
+    json_pointer::DereferenceMode mode) const {
+  assert(mode == json_pointer::kMustExist ||
+         mode == json_pointer::kSimulateCreate);
+  if (missing()) {
+    static const ::nlohmann::json discarded(
+        ::nlohmann::json::value_t::discarded);
+    return json_pointer::Dereference(discarded, json_pointer, mode);
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = parsed_.find(json_pointer); it != parsed_.end()) {
+      return it->second.get();
+    }
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto location,
+                               LocateJsonPointer(*text_, json_pointer));
+  ::nlohmann::json value;
+  if (location.pointer_length == json_pointer.size()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        value, ParseJsonText(std::string_view(*text_).substr(
+                   location.begin, location.end - location.begin)));
+  } else {
+    if (mode == json_pointer::kSimulateCreate &&
+        (*text_)[location.begin] == '{') {
+      // The missing object member would be created.
+      return nullptr;
+    }
+    // Rare case, which is typically an error: defer to
+    // `json_pointer::Dereference` on the entire document so that the result
+    // and any error message are exactly the same.
+    TENSORSTORE_ASSIGN_OR_RETURN(auto full_value, ParseJsonText(*text_));
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        ::nlohmann::json* sub_value,
+        json_pointer::Dereference(full_value, json_pointer, mode));
+    if (!sub_value) return nullptr;
+    value = std::move(*sub_value);
+  }
+  absl::MutexLock lock(&mutex_);
+  auto& parsed = parsed_[std::string(json_pointer)];
+  if (!parsed) parsed = std::make_unique<::nlohmann::json>(std::move(value));
+  return parsed.get();
+}
+
+Result<JsonDocument> JsonDocument::ApplyChanges(const JsonChangeMap& changes,
+                                                bool& modified) const {
+  if (!missing()) {
+    std::vector<TextEdit> edits;
+    bool can_splice = true;
+    for (const auto& [pointer, value] : changes.underlying_map()) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          const ::nlohmann::json* existing_value,
+          Dereference(pointer, json_pointer::kSimulateCreate),
+          internal::ConvertInvalidArgumentToFailedPrecondition(_));
+      if (value.is_discarded()) {
+        // Deleting a missing value has no effect.
+        if (!existing_value) continue;
+        can_splice = false;
+        break;
+      }
+      if (existing_value && internal_json::JsonSame(*existing_value, value)) {
+        continue;
+      }
+      TENSORSTORE_ASSIGN_OR_RETURN(auto location,
+                                   LocateJsonPointer(*text_, pointer));
+      if (existing_value) {
+        TextEdit edit;
+        edit.begin = location.begin;
+        edit.end = location.end;
+        edit.text = value.dump();
+        edits.push_back(std::move(edit));
+        continue;
+      }
+      // Only a new member of an existing object can be inserted.
+      if ((*text_)[location.begin] != '{' ||
+          pointer.find('/', location.pointer_length + 1) !=
+              std::string::npos) {
+        can_splice = false;
+        break;
+      }
+      const std::string member_name = DecodeReferenceToken(
+          std::string_view(pointer).substr(location.pointer_length + 1));
+      TextEdit edit;
+      edit.begin = edit.end = location.end - 1;
+      edit.text = ::nlohmann::json(member_name).dump() + ":" + value.dump();
+      edit.new_member = true;
+      JsonScanner scanner(*text_, location.begin + 1);
+      scanner.SkipWhitespace();
+      edit.object_empty = scanner.pos() == edit.end;
+      edits.push_back(std::move(edit));
+    }
+    if (can_splice) {
+      modified = !edits.empty();
+      if (!modified) return JsonDocument();
+      std::stable_sort(edits.begin(), edits.end(),
+                       [](const TextEdit& a, const TextEdit& b) {
+                         return a.begin < b.begin;
+                       });
+      std::string new_text;
+      size_t pos = 0;
+      bool prev_new_member = false;
+      for (const auto& edit : edits) {
+        const bool after_new_member = prev_new_member && edit.begin == pos;
+        new_text.append(*text_, pos, edit.begin - pos);
+        if (edit.new_member && (!edit.object_empty || after_new_member)) {
+          new_text += ',';
+        }
+        new_text += edit.text;
+        pos = edit.end;
+        prev_new_member = edit.new_member;
+      }
+      new_text.append(*text_, pos);
+      return JsonDocument(std::move(new_text));
+    }
+  }
+  // Fall back to parsing, modifying, and re-encoding the entire document.
+  ::nlohmann::json existing_value(::nlohmann::json::value_t::discarded);
+  if (!missing()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(existing_value, ParseJsonText(*text_));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto new_value, changes.Apply(existing_value));
+  modified = !internal_json::JsonSame(new_value, existing_value);
+  if (!modified) return JsonDocument();
+  return FromJson(new_value);
+}
+
+}  // namespace internal_json_driver
+}  // namespace tensorstore
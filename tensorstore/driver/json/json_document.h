@@ -0,0 +1,152 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_JSON_JSON_DOCUMENT_H_
+#define TENSORSTORE_DRIVER_JSON_JSON_DOCUMENT_H_
+
+/// \file
+///
+/// Lazily-parsed representation of an encoded JSON document.
+///
+/// Rather than parsing an entire (possibly very large) document, only the
+/// byte ranges of the values referenced by JSON Pointers are located, by
+/// scanning over the encoded text, and only those values are parsed.
+/// Changes are applied by splicing the encoded replacement values into the
+/// original text, such that unchanged portions are re-emitted verbatim.
+
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/driver/json/json_change_map.h"
+#include "tensorstore/internal/json_pointer.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_json_driver {
+
+/// Validates that `text` is a single JSON value, optionally surrounded by
+/// whitespace, without parsing it.
+///
+/// The structure of the value is fully checked, but the UTF-8 encoding of
+/// strings is not; invalid encodings are instead reported when the containing
+/// value is parsed.
+///
+/// \error `absl::StatusCode::kFailedPrecondition` if `text` is not valid.
+absl::Status ValidateJsonText(std::string_view text);
+
+/// Location of a JSON Pointer within encoded JSON text.
+struct JsonTextLocation {
+  /// Byte range `[begin, end)` of the deepest existing value along the
+  /// pointer.
+  size_t begin, end;
+
+  /// Length of the prefix of the pointer that refers to the value at `begin`.
+  /// Equal to the length of the pointer if the pointer refers to an existing
+  /// value.
+  size_t pointer_length;
+};
+
+/// Locates `json_pointer` within `text`.
+///
+/// Values that are not along the path of `json_pointer` are skipped without
+/// being parsed.  If an object contains duplicate member names, the first is
+/// used.
+///
+/// \param text Encoded JSON text, previously validated by `ValidateJsonText`.
+/// \param json_pointer Valid JSON Pointer.
+Result<JsonTextLocation> LocateJsonPointer(std::string_view text,
+                                           std::string_view json_pointer);
+
+/// Immutable encoded JSON document, parsed on demand.
+///
+/// This is used as the `ReadData` of the json driver cache.
+class JsonDocument {
+ public:
+  /// Constructs a document representing a missing value.
+  JsonDocument() = default;
+
+  /// Constructs a document from its encoded text, which must be valid.
+  explicit JsonDocument(std::string text) : text_(std::move(text)) {}
+
+  /// Constructs a document by encoding `value`.
+  ///
+  /// A `discarded` value results in a missing document.
+  static JsonDocument FromJson(const ::nlohmann::json& value);
+
+  /// Validates `encoded` and constructs a document from it.
+  ///
+  /// \error `absl::StatusCode::kFailedPrecondition` if `encoded` is not valid
+  ///     JSON.
+  static Result<JsonDocument> Parse(const std::optional<absl::Cord>& encoded);
+
+  JsonDocument(JsonDocument&& other) : text_(std::move(other.text_)) {}
+
+  /// Indicates whether the document is missing.
+  bool missing() const { return !text_.has_value(); }
+
+  /// Returns the encoded text.
+  ///
+  /// \dchecks `!missing()`
+  const std::string& text() const { return *text_; }
+
+  /// Dereferences `json_pointer` within this document.
+  ///
+  /// Equivalent to calling `json_pointer::Dereference` on the parsed
+  /// document, but only parses the referenced value, which is retained for
+  /// the lifetime of the document.
+  ///
+  /// \param mode Must be `json_pointer::kMustExist` or
+  ///     `json_pointer::kSimulateCreate`.
+  Result<const ::nlohmann::json*> Dereference(
+      std::string_view json_pointer,
+      json_pointer::DereferenceMode mode = json_pointer::kMustExist) const;
+
+  /// Returns the result of applying `changes` to this document.
+  ///
+  /// Where possible, the encoded replacement values are spliced into the
+  /// existing encoded text.  Otherwise, the entire document is parsed,
+  /// modified, and re-encoded.
+  ///
+  /// \param modified[out] Set to `false` if applying `changes` leaves the
+  ///     value unchanged, in which case the returned document is empty and
+  ///     must not be used.
+  Result<JsonDocument> ApplyChanges(const JsonChangeMap& changes,
+                                    bool& modified) const;
+
+ private:
+  std::optional<std::string> text_;
+
+  mutable absl::Mutex mutex_;
+  // Values that have been parsed, keyed by JSON Pointer.
+  mutable absl::btree_map<std::string, std::unique_ptr<::nlohmann::json>,
+                          std::less<>>
+      parsed_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_json_driver
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_JSON_JSON_DOCUMENT_H_
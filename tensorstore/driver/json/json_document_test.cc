@@ -0,0 +1,177 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/json/json_document.h"
+
+#include <string>
+#include <string_view>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/driver/json/json_change_map.h"
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/internal/json_pointer.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesJson;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_json_driver::JsonChangeMap;
+using ::tensorstore::internal_json_driver::JsonDocument;
+using ::tensorstore::internal_json_driver::LocateJsonPointer;
+using ::tensorstore::internal_json_driver::ValidateJsonText;
+using ::testing::Pointee;
+
+TEST(ValidateJsonTextTest, Valid) {
+  for (std::string_view text :
+       {"null", " true ", "false", "0", "-1.5e+3", "\"a\\u00e9\\n\"", "[]",
+        "{}", "[1, [2, {}], {\"a\": [true]}]", "{\"a\":{\"b\":{\"c\":[]}}}"}) {
+    TENSORSTORE_EXPECT_OK(ValidateJsonText(text)) << text;
+  }
+}
+
+TEST(ValidateJsonTextTest, Invalid) {
+  for (std::string_view text :
+       {"", "invalid", "01", "1.", "-", "1e", "[1,]", "{\"a\"}", "{\"a\":1,}",
+        "[1 2]", "{1:2}", "\"a", "\"\\x\"", "[", "{}}", "1 2", "[}"}) {
+    EXPECT_THAT(ValidateJsonText(text),
+                MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                              "Invalid JSON"))
+        << text;
+  }
+}
+
+TEST(LocateJsonPointerTest, Basic) {
+  std::string_view text = R"( {"a": [10, {"b~/": 2}], "c\"": "x"} )";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto location, LocateJsonPointer(text, ""));
+  EXPECT_EQ(text.substr(location.begin, location.end - location.begin),
+            R"({"a": [10, {"b~/": 2}], "c\"": "x"})");
+  EXPECT_EQ(0u, location.pointer_length);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(location,
+                                   LocateJsonPointer(text, "/a/1/b~0~1"));
+  EXPECT_EQ("2", text.substr(location.begin, location.end - location.begin));
+  EXPECT_EQ(10u, location.pointer_length);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(location, LocateJsonPointer(text, "/c\""));
+  EXPECT_EQ("\"x\"",
+            text.substr(location.begin, location.end - location.begin));
+
+  // Missing member: the deepest existing value is returned.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(location, LocateJsonPointer(text, "/a/2/b"));
+  EXPECT_EQ("[10, {\"b~/\": 2}]",
+            text.substr(location.begin, location.end - location.begin));
+  EXPECT_EQ(2u, location.pointer_length);
+}
+
+TEST(JsonDocumentTest, Parse) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto missing,
+                                   JsonDocument::Parse(std::nullopt));
+  EXPECT_TRUE(missing.missing());
+  EXPECT_THAT(JsonDocument::Parse(absl::Cord("{\"a\":")),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            "Invalid JSON"));
+}
+
+TEST(JsonDocumentTest, Dereference) {
+  JsonDocument doc(R"({"a": [1, {"b": 2}], "c": 3})");
+  EXPECT_THAT(doc.Dereference("/a/1"),
+              IsOkAndHolds(Pointee(MatchesJson({{"b", 2}}))));
+  EXPECT_THAT(doc.Dereference(""),
+              IsOkAndHolds(Pointee(
+                  MatchesJson({{"a", {1, {{"b", 2}}}}, {"c", 3}}))));
+  EXPECT_THAT(doc.Dereference("/d", tensorstore::json_pointer::kSimulateCreate),
+              IsOkAndHolds(nullptr));
+  EXPECT_THAT(doc.Dereference("/d"),
+              MatchesStatus(absl::StatusCode::kNotFound,
+                            "JSON Pointer \"/d\" refers to non-existent "
+                            "object member"));
+  EXPECT_THAT(doc.Dereference("/c/x"),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            "JSON Pointer reference \"/c/x\" cannot be applied "
+                            "to number value: 3"));
+}
+
+TEST(JsonDocumentTest, ApplyChangesSplicesReplacement) {
+  JsonDocument doc(R"({ "a" : [1, 2],
+  "b": {"c": 3} })");
+  JsonChangeMap changes;
+  TENSORSTORE_ASSERT_OK(changes.AddChange("/b/c", "x"));
+  bool modified;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto new_doc,
+                                   doc.ApplyChanges(changes, modified));
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(R"({ "a" : [1, 2],
+  "b": {"c": "x"} })",
+            new_doc.text());
+}
+
+TEST(JsonDocumentTest, ApplyChangesInsertsMembers) {
+  JsonDocument doc(R"({"a": {}, "b": {"c": 1}})");
+  JsonChangeMap changes;
+  TENSORSTORE_ASSERT_OK(changes.AddChange("/a/x", 1));
+  TENSORSTORE_ASSERT_OK(changes.AddChange("/a/y", 2));
+  TENSORSTORE_ASSERT_OK(changes.AddChange("/b/d", true));
+  bool modified;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto new_doc,
+                                   doc.ApplyChanges(changes, modified));
+  EXPECT_TRUE(modified);
+  EXPECT_EQ(R"({"a": {"x":1,"y":2}, "b": {"c": 1,"d":true}})", new_doc.text());
+}
+
+TEST(JsonDocumentTest, ApplyChangesUnchanged) {
+  JsonDocument doc(R"({"a": 1, "b": 2})");
+  JsonChangeMap changes;
+  TENSORSTORE_ASSERT_OK(changes.AddChange("/a", 1));
+  // Deleting a missing member has no effect.
+  TENSORSTORE_ASSERT_OK(changes.AddChange(
+      "/c", ::nlohmann::json(::nlohmann::json::value_t::discarded)));
+  bool modified;
+  TENSORSTORE_ASSERT_OK(doc.ApplyChanges(changes, modified));
+  EXPECT_FALSE(modified);
+}
+
+TEST(JsonDocumentTest, ApplyChangesFallback) {
+  JsonDocument doc(R"({"a": [1, 2], "b": 3})");
+  JsonChangeMap changes;
+  // Deletions and array appends are applied to the parsed document.
+  TENSORSTORE_ASSERT_OK(changes.AddChange(
+      "/b", ::nlohmann::json(::nlohmann::json::value_t::discarded)));
+  TENSORSTORE_ASSERT_OK(changes.AddChange("/a/-", 3));
+  bool modified;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto new_doc,
+                                   doc.ApplyChanges(changes, modified));
+  EXPECT_TRUE(modified);
+  EXPECT_THAT(::nlohmann::json::parse(new_doc.text()),
+              MatchesJson({{"a", {1, 2, 3}}}));
+}
+
+TEST(JsonDocumentTest, ApplyChangesIncompatible) {
+  JsonDocument doc("42");
+  JsonChangeMap changes;
+  TENSORSTORE_ASSERT_OK(changes.AddChange("/a", true));
+  bool modified;
+  EXPECT_THAT(doc.ApplyChanges(changes, modified),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            "JSON Pointer reference \"/a\" cannot be applied "
+                            "to number value: 42"));
+}
+
+}  // namespace
@@ -15,29 +15,43 @@
 #include "tensorstore/driver/kvs_backed_chunk_driver.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <functional>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "tensorstore/array.h"
 #include "tensorstore/batch.h"
 #include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/driver.h"
+#include "tensorstore/driver/chunk_existence_index.h"
 #include "tensorstore/driver/driver_handle.h"
 #include "tensorstore/driver/kvs_backed_chunk_driver_impl.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/index_transform_builder.h"
+#include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/internal/arena.h"
 #include "tensorstore/internal/box_difference.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/async_initialized_cache_mixin.h"
@@ -45,22 +59,35 @@
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
+#include "tensorstore/internal/cache_key/absl_time.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/cache_key/std_optional.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
+#include "tensorstore/internal/data_type_endian_conversion.h"
+#include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/staleness_bound.h"  // IWYU: pragma keep
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/lock_collection.h"
 #include "tensorstore/internal/mutex.h"
+#include "tensorstore/internal/nditerable.h"
+#include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/internal/open_mode_spec.h"
 #include "tensorstore/internal/path.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/internal/unowned_to_shared.h"
 #include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/open_options.h"
 #include "tensorstore/rank.h"
@@ -84,6 +111,14 @@
 
 namespace tensorstore {
 namespace internal_kvs_backed_chunk_driver {
+namespace {
+
+auto& metadata_read_avoided = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/driver/kvs_backed_chunk_driver/metadata_read_avoided",
+    "Number of opens that used cached metadata, or its cached absence, "
+    "without reading it");
+
+}  // namespace
 
 MetadataOpenState::~MetadataOpenState() = default;
 
@@ -125,17 +160,28 @@ AtomicUpdateConstraint MetadataOpenState::GetCreateConstraint() {
 MetadataCache::MetadataCache(Initializer initializer)
     : Base(kvstore::DriverPtr()),
       data_copy_concurrency_(std::move(initializer.data_copy_concurrency)),
-      cache_pool_(std::move(initializer.cache_pool)) {}
+      cache_pool_(std::move(initializer.cache_pool)),
+      memory_budget_(std::move(initializer.memory_budget)),
+      chunk_buffer_pool_(std::move(initializer.chunk_buffer_pool)) {}
 
 DataCacheBase::DataCacheBase(Initializer&& initializer)
     : metadata_cache_entry_(std::move(initializer.metadata_cache_entry)),
-      initial_metadata_(std::move(initializer.metadata)) {}
+      initial_metadata_(std::move(initializer.metadata)),
+      chunk_existence_index_(initializer.chunk_existence_index),
+      retain_encoded_chunks_(initializer.retain_encoded_chunks),
+      write_behind_buffer_(initializer.write_behind
+                               ? WriteBehindBuffer::Ptr(new WriteBehindBuffer(
+                                     *initializer.write_behind,
+                                     std::move(initializer.cache_pool)))
+                               : WriteBehindBuffer::Ptr()) {}
 
 DataCache::DataCache(Initializer&& initializer,
                      internal::ChunkGridSpecification&& grid)
     : KvsBackedChunkCache(std::move(initializer.store)),
       ChunkedDataCacheBase(std::move(initializer)),
-      grid_(std::move(grid)) {}
+      grid_(std::move(grid)) {
+  set_retain_encoded_chunks(retain_encoded_chunks_);
+}
 
 namespace {
 
@@ -720,12 +766,20 @@ Result<IndexTransform<>> KvsMetadataDriverBase::GetBoundSpecData(
   spec.store.path = cache->GetBaseKvstorePath();
   spec.data_copy_concurrency = metadata_cache->data_copy_concurrency_;
   spec.cache_pool = metadata_cache->cache_pool_;
+  spec.memory_budget = metadata_cache->memory_budget_;
+  spec.chunk_buffer_pool = metadata_cache->chunk_buffer_pool_;
   spec.delete_existing = false;
   spec.open = true;
   spec.create = false;
   spec.assume_metadata = assumed_metadata_time_ == absl::InfiniteFuture();
   spec.staleness.metadata = this->metadata_staleness_bound();
   spec.staleness.data = this->data_staleness_bound();
+  spec.prefetch = this->prefetch_options();
+  spec.chunk_existence_index = cache->chunk_existence_index_;
+  spec.retain_encoded_chunks = cache->retain_encoded_chunks_;
+  if (cache->write_behind_buffer_) {
+    spec.write_behind = cache->write_behind_buffer_->options();
+  }
   spec.schema.Set(RankConstraint{this->rank()}).IgnoreError();
   spec.schema.Set(this->dtype()).IgnoreError();
 
@@ -815,12 +869,24 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
     read_write_mode = base.read_write_mode_;
   }
 
+  if (base.spec_->chunk_existence_index &&
+      !base.spec_->staleness.data.bounded_by_open_time &&
+      base.spec_->staleness.data.time == absl::InfiniteFuture()) {
+    // Every read would require a new listing.
+    return absl::InvalidArgumentError(
+        "\"chunk_existence_index\" requires \"recheck_cached_data\" to be "
+        "false, \"open\", or a timestamp");
+  }
+
   std::string chunk_cache_identifier;
   if (!base.metadata_cache_key_.empty()) {
     auto data_cache_key = state->GetDataCacheKey(metadata.get());
     if (!data_cache_key.empty()) {
       internal::EncodeCacheKey(&chunk_cache_identifier, data_cache_key,
-                               base.metadata_cache_key_);
+                               base.metadata_cache_key_,
+                               base.spec_->chunk_existence_index,
+                               base.spec_->retain_encoded_chunks,
+                               base.spec_->write_behind);
     }
   }
   absl::Status data_key_value_store_status;
@@ -828,9 +894,14 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
   auto data_cache = internal::GetCacheWithExplicitTypeInfo<DataCacheBase>(
       state->cache_pool()->get(), typeid(state_ref), chunk_cache_identifier,
       [&]() -> std::unique_ptr<DataCacheBase> {
-        auto store_result = state->GetDataKeyValueStore(
-            GetOwningCache(*base.metadata_cache_entry_).base_store_,
-            metadata.get());
+        kvstore::DriverPtr base_store =
+            GetOwningCache(*base.metadata_cache_entry_).base_store_;
+        if (base.spec_->chunk_existence_index) {
+          base_store = GetChunkExistenceIndexKeyValueStore(
+              std::move(base_store), state->GetPrefixForDeleteExisting());
+        }
+        auto store_result =
+            state->GetDataKeyValueStore(std::move(base_store), metadata.get());
         if (!store_result) {
           data_key_value_store_status = std::move(store_result).status();
           return nullptr;
@@ -839,6 +910,11 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
         initializer.store = std::move(*store_result);
         initializer.metadata_cache_entry = base.metadata_cache_entry_;
         initializer.metadata = metadata;
+        initializer.chunk_existence_index = base.spec_->chunk_existence_index;
+        initializer.retain_encoded_chunks = base.spec_->retain_encoded_chunks;
+        initializer.write_behind = base.spec_->write_behind;
+        initializer.cache_pool =
+            internal::CachePool::WeakPtr(state->cache_pool()->get());
         return state->GetDataCache(std::move(initializer));
       });
   TENSORSTORE_RETURN_IF_ERROR(data_key_value_store_status);
@@ -876,6 +952,7 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
   initializer.component_index = component_index;
   initializer.data_staleness_bound =
       base.spec_->staleness.data.BoundAtOpen(base.request_time_);
+  initializer.prefetch = base.spec_->prefetch;
   internal::ReadWritePtr<KvsMetadataDriverBase> driver(
       state->AllocateDriver(std::move(initializer)), read_write_mode);
   driver->metadata_staleness_bound_ =
@@ -990,14 +1067,19 @@ struct GetMetadataForOpen {
             state->CreateDriverHandleFromMetadata(std::move(metadata)));
         return;
       }
-      LinkValue(
-          WithExecutor(state_ptr->executor(),
-                       HandleReadMetadata{std::move(state)}),
-          std::move(promise),
-          base.metadata_cache_entry_->Read(
-              {base.spec_->staleness.metadata.BoundAtOpen(base.request_time_)
-                   .time,
-               batch}));
+      const absl::Time staleness_bound =
+          base.spec_->staleness.metadata.BoundAtOpen(base.request_time_).time;
+      {
+        internal::AsyncCache::ReadLock<void> lock(*base.metadata_cache_entry_);
+        if (lock.stamp().time != absl::InfinitePast() &&
+            lock.stamp().time >= staleness_bound) {
+          metadata_read_avoided.Increment();
+        }
+      }
+      LinkValue(WithExecutor(state_ptr->executor(),
+                             HandleReadMetadata{std::move(state)}),
+                std::move(promise),
+                base.metadata_cache_entry_->Read({staleness_bound, batch}));
       return;
     }
     // `tensorstore::Open` ensures that at least one of `OpenMode::create` and
@@ -1206,6 +1288,455 @@ Future<const void> DataCache::DeleteCell(
                                           std::move(transaction));
 }
 
+namespace {
+
+auto& chunk_patch_writes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/driver/kvs_backed_chunk_driver/chunk_patch_writes",
+    "Number of partial chunk writes written in place with byte-range writes");
+
+/// Maximum number of byte-range writes issued for a single chunk patch.
+/// Patches with more discontiguous byte ranges are instead spliced into a copy
+/// of the existing chunk, which requires reading but not decoding it.
+constexpr size_t kMaxByteRangeWritesPerChunk = 16;
+
+/// Contiguous range of encoded bytes modified by a chunk patch.
+struct ChunkPatchRun {
+  int64_t byte_offset;
+  absl::Cord value;
+};
+
+/// Data written by a single `BeginWrite`/`EndWrite` pair of
+/// `ChunkPatchWriteImpl`.
+struct ChunkPatch {
+  DataCache::RawChunkEncoding encoding;
+
+  /// Modified data, with a domain equal to the output range of the chunk
+  /// transform, laid out in the same dimension order as `encoding`.
+  SharedOffsetArray<void> array;
+};
+
+/// Writes a chunk patch to the kvstore.
+///
+/// The runs are written in place if the chunk exists; otherwise, a new chunk
+/// is created from the fill value.  Conditional writes that fail due to
+/// concurrent modifications are retried.
+struct ChunkPatchWriteState
+    : public internal::AtomicReferenceCount<ChunkPatchWriteState> {
+  using Ptr = internal::IntrusivePtr<ChunkPatchWriteState>;
+
+  internal::PinnedCacheEntry<internal::ChunkCache> entry;
+  size_t component_index;
+  SharedOffsetArray<const void> array;
+  IndexTransform<> transform;
+  std::vector<ChunkPatchRun> runs;
+  std::vector<Future<TimestampedStorageGeneration>> run_futures;
+  Promise<void> promise;
+
+  DataCache& cache() {
+    return static_cast<DataCache&>(GetOwningCache(*entry));
+  }
+
+  std::string key() {
+    return static_cast<internal::KvsBackedChunkCache::Entry&>(*entry)
+        .GetKeyValueStoreKey();
+  }
+
+  void Start() {
+    if (runs.size() <= kMaxByteRangeWritesPerChunk) {
+      WriteRuns();
+    } else {
+      SpliceRuns();
+    }
+  }
+
+  /// Writes each run with a byte-range write.
+  void WriteRuns() {
+    auto* driver = cache().kvstore_driver();
+    const std::string chunk_key = key();
+    run_futures.clear();
+    for (const auto& run : runs) {
+      kvstore::WriteOptions options;
+      options.byte_offset = run.byte_offset;
+      run_futures.push_back(
+          driver->Write(chunk_key, run.value, std::move(options)));
+    }
+    WaitAllFuture(span(run_futures))
+        .ExecuteWhenReady([self = Ptr(this)](ReadyFuture<void> future) {
+          for (const auto& run_future : self->run_futures) {
+            const auto& result = run_future.result();
+            if (absl::IsNotFound(result.status())) {
+              self->cache().executor()([self] { self->WriteNewChunk(); });
+              return;
+            }
+            if (!result.ok()) {
+              self->Fail(result.status());
+              return;
+            }
+          }
+          self->Succeed();
+        });
+  }
+
+  /// Reads the existing chunk and writes a copy with the runs spliced in.
+  void SpliceRuns() {
+    cache().kvstore_driver()->Read(key()).ExecuteWhenReady(
+        [self = Ptr(this)](ReadyFuture<kvstore::ReadResult> future) {
+          auto& result = future.result();
+          if (!result.ok()) {
+            self->Fail(result.status());
+          } else if (!result->has_value()) {
+            self->cache().executor()([self] { self->WriteNewChunk(); });
+          } else {
+            self->cache().executor()(
+                [self, read_result = std::move(*result)]() mutable {
+                  self->WriteSplicedChunk(std::move(read_result));
+                });
+          }
+        });
+  }
+
+  void WriteSplicedChunk(kvstore::ReadResult read_result) {
+    std::string data(read_result.value);
+    for (const auto& run : runs) {
+      if (run.byte_offset + static_cast<int64_t>(run.value.size()) >
+          static_cast<int64_t>(data.size())) {
+        Fail(absl::DataLossError(tensorstore::StrCat(
+            "Expected chunk of at least ",
+            run.byte_offset + run.value.size(), " bytes, but received ",
+            data.size(), " bytes")));
+        return;
+      }
+      char* dest = data.data() + run.byte_offset;
+      for (std::string_view chunk : run.value.Chunks()) {
+        std::memcpy(dest, chunk.data(), chunk.size());
+        dest += chunk.size();
+      }
+    }
+    kvstore::WriteOptions options;
+    options.generation_conditions.if_equal =
+        std::move(read_result.stamp.generation);
+    WriteEntireChunk(absl::Cord(std::move(data)), std::move(options),
+                     &ChunkPatchWriteState::SpliceRuns);
+  }
+
+  /// Writes a new chunk consisting of the fill value with the patch applied.
+  void WriteNewChunk() {
+    const auto& grid = cache().grid();
+    absl::InlinedVector<SharedArray<const void>, 1> components;
+    components.reserve(grid.components.size());
+    for (size_t i = 0; i < grid.components.size(); ++i) {
+      const auto& component_spec = grid.components[i];
+      if (i != component_index) {
+        components.push_back(component_spec.fill_value);
+        continue;
+      }
+      auto full = AllocateArray(component_spec.shape(), c_order, default_init,
+                                component_spec.dtype());
+      CopyArray(component_spec.fill_value, full);
+      // View of `full` in the coordinates of the component array.
+      Index origin[kMaxRank];
+      const span<Index> origin_span(origin, component_spec.rank());
+      grid.GetComponentOrigin(i, entry->cell_indices(), origin_span);
+      SharedOffsetArray<void> full_view(
+          AddByteOffset(full.element_pointer(),
+                        -IndexInnerProduct(full.rank(), origin,
+                                           full.byte_strides().data())),
+          StridedLayout<dynamic_rank, offset_origin>(origin_span, full.shape(),
+                                                      full.byte_strides()));
+      if (auto status = CopyTransformedArray(
+              MakeTransformedArray(array, transform),
+              MakeTransformedArray(full_view, transform));
+          !status.ok()) {
+        Fail(std::move(status));
+        return;
+      }
+      components.push_back(std::move(full));
+    }
+    absl::InlinedVector<SharedArrayView<const void>, 1> component_views(
+        components.begin(), components.end());
+    auto encoded = cache().EncodeChunk(entry->cell_indices(), component_views);
+    if (!encoded.ok()) {
+      Fail(std::move(encoded).status());
+      return;
+    }
+    kvstore::WriteOptions options;
+    options.generation_conditions.if_equal = StorageGeneration::NoValue();
+    WriteEntireChunk(*std::move(encoded), std::move(options),
+                     &ChunkPatchWriteState::WriteRuns);
+  }
+
+  /// Writes an entire chunk conditionally, and calls `retry` if the condition
+  /// is not satisfied.
+  void WriteEntireChunk(absl::Cord value, kvstore::WriteOptions options,
+                        void (ChunkPatchWriteState::*retry)()) {
+    cache()
+        .kvstore_driver()
+        ->Write(key(), std::move(value), std::move(options))
+        .ExecuteWhenReady(
+            [self = Ptr(this),
+             retry](ReadyFuture<TimestampedStorageGeneration> future) {
+              auto& result = future.result();
+              if (!result.ok()) {
+                self->Fail(result.status());
+              } else if (StorageGeneration::IsUnknown(result->generation)) {
+                // The chunk was concurrently created, modified, or deleted.
+                ((*self).*retry)();
+              } else {
+                self->Succeed();
+              }
+            });
+  }
+
+  void Succeed() {
+    entry->MarkReadStateStale();
+    promise.SetResult(absl::OkStatus());
+  }
+
+  void Fail(const absl::Status& status) {
+    promise.SetResult(
+        cache().kvstore_driver()->AnnotateError(key(), "writing", status));
+  }
+};
+
+/// `WriteChunk` implementation that writes a partial chunk in place, without
+/// reading the existing chunk.
+///
+/// Unlike `ChunkCache` writes, the write is not recorded in the cache; the
+/// cached read state is instead marked stale once the write completes.  Until
+/// then, writeback of the chunk from the cache is deferred (see
+/// `KvsBackedChunkCache::Entry::AddPendingDirectWrite`).
+struct ChunkPatchWriteImpl {
+  size_t component_index;
+  internal::PinnedCacheEntry<internal::ChunkCache> entry;
+  std::shared_ptr<ChunkPatch> patch;
+
+  absl::Status operator()(internal::LockCollection& lock_collection) const {
+    // The patch is independent of the cache entry state.
+    return absl::OkStatus();
+  }
+
+  Result<internal::NDIterable::Ptr> operator()(
+      internal::WriteChunk::BeginWrite, IndexTransform<> chunk_transform,
+      internal::Arena* arena) const {
+    const auto& component_spec =
+        GetOwningCache(*entry).grid().components[component_index];
+    Box<> output_range(chunk_transform.output_rank());
+    TENSORSTORE_RETURN_IF_ERROR(GetOutputRange(chunk_transform, output_range));
+    // Lay out the array in the encoded dimension order, such that the encoded
+    // position of each element increases with its position in the array.
+    patch->array = AllocateArrayLike<void>(
+        StridedLayoutView<dynamic_rank, offset_origin>(
+            output_range.origin(), output_range.shape(),
+            patch->encoding.byte_strides),
+        skip_repeated_elements, default_init, component_spec.dtype());
+    return internal::GetTransformedArrayNDIterable(
+        patch->array, chunk_transform, arena);
+  }
+
+  internal::WriteChunk::EndWriteResult operator()(
+      internal::WriteChunk::EndWrite, IndexTransformView<> chunk_transform,
+      bool success, internal::Arena* arena) const {
+    auto array = std::exchange(patch->array, {});
+    if (!success) return {};
+    auto runs = GetRuns(array, chunk_transform);
+    if (!runs.ok()) return {std::move(runs).status()};
+    chunk_patch_writes.Increment();
+    auto [promise, future] = PromiseFuturePair<void>::Make();
+    ChunkPatchWriteState::Ptr state(new ChunkPatchWriteState);
+    state->entry = entry;
+    state->component_index = component_index;
+    state->array = std::move(array);
+    state->transform = IndexTransform<>(chunk_transform);
+    state->runs = *std::move(runs);
+    state->promise = std::move(promise);
+    // Writeback of later writes recorded in the cache waits for the patch, so
+    // that it cannot overwrite them.
+    static_cast<internal::KvsBackedChunkCache::Entry&>(*entry)
+        .AddPendingDirectWrite(future);
+    state->Start();
+    return {absl::OkStatus(), std::move(future)};
+  }
+
+  bool operator()(internal::WriteChunk::WriteArray,
+                  IndexTransformView<> chunk_transform,
+                  internal::WriteChunk::GetWriteSourceArrayFunction
+                      get_source_array,
+                  internal::Arena* arena,
+                  internal::WriteChunk::EndWriteResult& end_write_result)
+      const {
+    return false;
+  }
+
+  /// Encodes the elements of `array` written through `chunk_transform` into
+  /// runs of contiguous encoded bytes.
+  Result<std::vector<ChunkPatchRun>> GetRuns(
+      const SharedOffsetArray<void>& array,
+      IndexTransformView<> chunk_transform) const {
+    const auto& grid = GetOwningCache(*entry).grid();
+    const auto& encoding = patch->encoding;
+    const DimensionIndex rank = array.rank();
+    const Index num_elements = array.num_elements();
+    const Index element_size = array.dtype().size();
+
+    // Marks the positions written, if not all positions of `array` were.
+    SharedOffsetArray<bool> mask;
+    Box<> output_range(rank);
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        const bool exact, GetOutputRange(chunk_transform, output_range));
+    if (!exact) {
+      mask = AllocateArrayLike<bool>(array.layout(), skip_repeated_elements,
+                                     value_init);
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto to_scalar,
+          IndexTransformBuilder<>(chunk_transform.input_rank(), 0)
+              .input_domain(chunk_transform.domain())
+              .Finalize());
+      TENSORSTORE_RETURN_IF_ERROR(CopyTransformedArray(
+          MakeTransformedArray(MakeScalarArray(true), std::move(to_scalar)),
+          MakeTransformedArray(mask, chunk_transform)));
+    }
+
+    // Encode `array` into a buffer with the same layout, such that element `i`
+    // in the encoded dimension order is at byte offset `i * element_size`.
+    internal::FlatCordBuilder builder(num_elements * element_size);
+    internal::EncodeArray(
+        ArrayView<const void>(
+            ElementPointer<const void>(
+                array.byte_strided_origin_pointer().get(), array.dtype()),
+            StridedLayoutView<>(array.shape(), array.byte_strides())),
+        ArrayView<void>(ElementPointer<void>(builder.data(), array.dtype()),
+                        StridedLayoutView<>(array.shape(),
+                                            array.byte_strides())),
+        encoding.endian);
+    const absl::Cord encoded = std::move(builder).Build();
+    const bool* mask_data =
+        mask.valid() ? mask.byte_strided_origin_pointer().get() : nullptr;
+
+    // Dimensions in the order of `array`, which is also the encoded order.
+    DimensionIndex dims[kMaxRank];
+    std::iota(dims, dims + rank, DimensionIndex(0));
+    std::sort(dims, dims + rank, [&](DimensionIndex a, DimensionIndex b) {
+      return array.byte_strides()[a] > array.byte_strides()[b];
+    });
+    Index cell_origin[kMaxRank];
+    grid.GetComponentOrigin(component_index, entry->cell_indices(),
+                            span<Index>(cell_origin, rank));
+    int64_t byte_offset = encoding.byte_offset;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      byte_offset +=
+          (array.origin()[i] - cell_origin[i]) * encoding.byte_strides[i];
+    }
+
+    // Iterate over the elements in encoded order, coalescing elements that
+    // are contiguous both in `encoded` and in the chunk.
+    std::vector<ChunkPatchRun> runs;
+    Index run_begin = 0, run_end = 0;
+    int64_t run_byte_offset = 0;
+    const auto flush_run = [&] {
+      if (run_end == run_begin) return;
+      runs.push_back(
+          {run_byte_offset,
+           encoded.Subcord(run_begin * element_size,
+                           (run_end - run_begin) * element_size)});
+    };
+    Index position[kMaxRank] = {};
+    for (Index i = 0; i < num_elements; ++i) {
+      if (!mask_data || mask_data[i]) {
+        if (run_end != i || run_byte_offset + (i - run_begin) * element_size !=
+                                byte_offset) {
+          flush_run();
+          run_begin = i;
+          run_byte_offset = byte_offset;
+        }
+        run_end = i + 1;
+      }
+      for (DimensionIndex j = rank; j-- > 0;) {
+        const DimensionIndex dim = dims[j];
+        byte_offset += encoding.byte_strides[dim];
+        if (++position[j] < array.shape()[dim]) break;
+        byte_offset -= encoding.byte_strides[dim] * array.shape()[dim];
+        position[j] = 0;
+      }
+    }
+    flush_run();
+    return runs;
+  }
+};
+
+}  // namespace
+
+std::optional<DataCache::RawChunkEncoding> DataCache::GetRawChunkEncoding(
+    size_t component_index) {
+  return std::nullopt;
+}
+
+void DataCache::GetPrefetchBounds(size_t component_index,
+                                  MutableBoxView<> bounds) {
+  internal::KvsBackedChunkCache::GetPrefetchBounds(component_index, bounds);
+  // The component bounds of resizable dimensions are unbounded, so constrain
+  // them by the current metadata to avoid prefetching cells that are outside
+  // the array.
+  MetadataPtr metadata = metadata_cache_entry_->GetMetadata();
+  if (!metadata) metadata = initial_metadata_;
+  Box<dynamic_rank(kMaxRank)> metadata_bounds(bounds.rank());
+  DimensionSet implicit_lower_bounds, implicit_upper_bounds;
+  GetChunkGridBounds(metadata.get(), metadata_bounds, implicit_lower_bounds,
+                     implicit_upper_bounds);
+  for (DimensionIndex grid_dim = 0; grid_dim < bounds.rank(); ++grid_dim) {
+    bounds[grid_dim] = Intersect(bounds[grid_dim], metadata_bounds[grid_dim]);
+  }
+}
+
+Result<internal::WriteChunk::Impl> DataCache::GetWriteChunkImpl(
+    const internal::ChunkCache::WriteRequest& request,
+    internal::ChunkCache::Entry& entry, IndexTransformView<> cell_to_dest) {
+  const auto get_default = [&] {
+    return internal::ChunkCache::GetWriteChunkImpl(request, entry,
+                                                   cell_to_dest);
+  };
+  if (request.transaction) return get_default();
+  auto encoding = GetRawChunkEncoding(request.component_index);
+  if (!encoding) return get_default();
+  // Chunks equal to the fill value must be deleted, which requires the entire
+  // chunk.
+  for (const auto& component_spec : grid().components) {
+    if (!component_spec.store_if_equal_to_fill_value) return get_default();
+  }
+  if ((kvstore_driver()->GetSupportedFeatures(KeyRange::Singleton(
+           static_cast<KvsBackedChunkCache::Entry&>(entry)
+               .GetKeyValueStoreKey())) &
+       kvstore::SupportedFeatures::kByteRangeWrite) ==
+      kvstore::SupportedFeatures::kNone) {
+    return get_default();
+  }
+  // Writes of entire chunks are handled by the cache, since they do not
+  // require reading the existing chunk.
+  const auto& component_spec = grid().components[request.component_index];
+  Box<> cell_domain(component_spec.rank());
+  grid().GetComponentOrigin(request.component_index, entry.cell_indices(),
+                            cell_domain.origin());
+  for (DimensionIndex i = 0; i < component_spec.rank(); ++i) {
+    cell_domain[i] = Intersect(
+        IndexInterval::UncheckedSized(cell_domain.origin()[i],
+                                      component_spec.shape()[i]),
+        component_spec.component_bounds[i]);
+  }
+  Box<> output_range(cell_to_dest.output_rank());
+  TENSORSTORE_ASSIGN_OR_RETURN(const bool exact,
+                               GetOutputRange(cell_to_dest, output_range));
+  if (exact && Contains(output_range, cell_domain)) {
+    return get_default();
+  }
+  // Pending writes recorded in the cache must be committed first, to preserve
+  // the order of writes.  Conversely, writeback of writes recorded in the
+  // cache after this patch is deferred until the patch completes.
+  if (entry.HasTransactionNodes()) return get_default();
+  return internal::WriteChunk::Impl(ChunkPatchWriteImpl{
+      request.component_index,
+      internal::PinnedCacheEntry<internal::ChunkCache>(&entry),
+      std::make_shared<ChunkPatch>(ChunkPatch{*std::move(encoding), {}})});
+}
+
 namespace {
 /// Returns the metadata cache for `state`, creating it if it doesn't already
 /// exist.
@@ -1230,7 +1761,8 @@ internal::CachePtr<MetadataCache> GetOrCreateMetadataCache(
         ABSL_LOG_IF(INFO, TENSORSTORE_KVS_DRIVER_DEBUG)
             << "Creating metadata cache: open_state=" << state;
         return state->GetMetadataCache(
-            {base.spec_->data_copy_concurrency, base.spec_->cache_pool});
+            {base.spec_->data_copy_concurrency, base.spec_->cache_pool,
+             base.spec_->memory_budget, base.spec_->chunk_buffer_pool});
       },
       [&](Promise<void> initialized,
           internal::CachePtr<MetadataCache> metadata_cache) {
@@ -1258,10 +1790,49 @@ internal::CachePtr<MetadataCache> GetOrCreateMetadataCache(
 
 Result<internal::Driver::Handle> OpenState::CreateDriverHandleFromMetadata(
     std::shared_ptr<const void> metadata) {
-  TENSORSTORE_ASSIGN_OR_RETURN(size_t component_index,
-                               ValidateOpenRequest(this, metadata.get()));
-  return CreateTensorStoreFromMetadata(OpenState::Ptr(this),
-                                       std::move(metadata), component_index);
+  auto& base = *(PrivateOpenState*)this;  // Cast to private base
+  std::optional<size_t> deferred_component_index;
+  if (base.spec_->defer_validation && metadata) {
+    deferred_component_index =
+        GetComponentIndexWithoutValidation(metadata.get());
+  }
+  if (!deferred_component_index) {
+    TENSORSTORE_ASSIGN_OR_RETURN(size_t component_index,
+                                 ValidateOpenRequest(this, metadata.get()));
+    return CreateTensorStoreFromMetadata(OpenState::Ptr(this),
+                                         std::move(metadata), component_index);
+  }
+  const size_t component_index = *deferred_component_index;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto handle, CreateTensorStoreFromMetadata(OpenState::Ptr(this), metadata,
+                                                 component_index));
+  auto* driver = static_cast<KvsMetadataDriverBase*>(handle.driver.get());
+  driver->deferred_validation_ = [state = OpenState::Ptr(this),
+                                  metadata = std::move(metadata),
+                                  component_index]() -> absl::Status {
+    TENSORSTORE_ASSIGN_OR_RETURN(size_t validated_component_index,
+                                 ValidateOpenRequest(state.get(),
+                                                     metadata.get()));
+    if (validated_component_index != component_index) {
+      return absl::FailedPreconditionError("Metadata is inconsistent");
+    }
+    return absl::OkStatus();
+  };
+  return handle;
+}
+
+std::optional<size_t> OpenState::GetComponentIndexWithoutValidation(
+    const void* metadata) {
+  return std::nullopt;
+}
+
+absl::Status KvsMetadataDriverBase::ValidateDeferred() {
+  absl::call_once(deferred_validation_once_, [&] {
+    if (!deferred_validation_) return;
+    deferred_validation_status_ = deferred_validation_();
+    deferred_validation_ = nullptr;
+  });
+  return deferred_validation_status_;
 }
 
 Future<internal::Driver::Handle> OpenDriver(MetadataOpenState::Ptr state) {
@@ -1444,6 +2015,10 @@ TENSORSTORE_DEFINE_JSON_BINDER(
                    jb::Projection<&KvsDriverSpec::data_copy_concurrency>()),
         jb::Member(internal::CachePoolResource::id,
                    jb::Projection<&KvsDriverSpec::cache_pool>()),
+        jb::Member(internal::MemoryBudgetResource::id,
+                   jb::Projection<&KvsDriverSpec::memory_budget>()),
+        jb::Member(internal::ChunkBufferPoolResource::id,
+                   jb::Projection<&KvsDriverSpec::chunk_buffer_pool>()),
         jb::Projection<&KvsDriverSpec::store>(jb::KvStoreSpecAndPathJsonBinder),
         jb::Initialize([](auto* obj) {
           internal::EnsureDirectoryPath(obj->store.path);
@@ -1458,6 +2033,32 @@ TENSORSTORE_DEFINE_JSON_BINDER(
             jb::Member("recheck_cached_data",
                        jb::Projection(&StalenessBounds::data,
                                       jb::DefaultInitializedValue())))),
+        jb::Member(
+            "prefetch",
+            jb::Projection<&KvsDriverSpec::prefetch>(
+                jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                    [](auto* obj) { *obj = {}; },
+                    jb::Object(
+                        jb::Member("cells",
+                                   jb::Projection<
+                                       &internal::ChunkPrefetchOptions::cells>(
+                                       jb::DefaultInitializedValue())),
+                        jb::Member(
+                            "bytes_limit",
+                            jb::Projection<
+                                &internal::ChunkPrefetchOptions::bytes_limit>(
+                                jb::DefaultInitializedValue())))))),
+        jb::Member("chunk_existence_index",
+                   jb::Projection<&KvsDriverSpec::chunk_existence_index>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { *obj = false; }))),
+        jb::Member("retain_encoded_chunks",
+                   jb::Projection<&KvsDriverSpec::retain_encoded_chunks>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { *obj = false; }))),
+        jb::Member("write_behind",
+                   jb::Projection<&KvsDriverSpec::write_behind>(
+                       jb::Optional())),
         internal::OpenModeSpecJsonBinder));
 
 }  // namespace internal_kvs_backed_chunk_driver
@@ -21,14 +21,21 @@
 /// shared by multiple independent arrays) and one key-value store entry per
 /// chunk.
 
+#include <stddef.h>
+
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string_view>
+#include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/status/status.h"
 #include "tensorstore/box.h"
 #include "tensorstore/driver/chunk_cache_driver.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/registry.h"
+#include "tensorstore/driver/write_behind.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/internal/cache/aggregate_writeback_cache.h"
@@ -36,20 +43,29 @@
 #include "tensorstore/internal/cache/async_initialized_cache_mixin.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/chunk_prefetch.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
+#include "tensorstore/internal/chunk_buffer_pool.h"
+#include "tensorstore/internal/chunk_buffer_pool_resource.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/context_binding.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/estimate_heap_usage/std_vector.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/memory_budget.h"
+#include "tensorstore/internal/memory_budget_resource.h"
 #include "tensorstore/internal/open_mode_spec.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/serialization/absl_time.h"
+#include "tensorstore/serialization/std_optional.h"
 #include "tensorstore/spec.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/sender_util.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 
@@ -66,12 +82,28 @@ struct KvsDriverSpec : public internal::DriverSpec,
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency;
   Context::Resource<internal::CachePoolResource> cache_pool;
+  Context::Resource<internal::MemoryBudgetResource> memory_budget;
+  Context::Resource<internal::ChunkBufferPoolResource> chunk_buffer_pool;
   StalenessBounds staleness;
+  internal::ChunkPrefetchOptions prefetch;
+
+  /// Resolve reads of missing chunks from a listing of the existing chunks.
+  bool chunk_existence_index = false;
+
+  /// Retain evicted chunks in their stored representation in the compressed
+  /// tier of the cache pool.
+  bool retain_encoded_chunks = false;
+
+  /// Buffer non-transactional writes and commit them in groups.
+  std::optional<WriteBehindOptions> write_behind;
 
   static constexpr auto ApplyMembers = [](auto& x, auto f) {
     return f(internal::BaseCast<internal::DriverSpec>(x),
              internal::BaseCast<internal::OpenModeSpec>(x), x.store,
-             x.data_copy_concurrency, x.cache_pool, x.staleness);
+             x.data_copy_concurrency, x.cache_pool, x.memory_budget,
+             x.chunk_buffer_pool, x.staleness, x.prefetch,
+             x.chunk_existence_index, x.retain_encoded_chunks,
+             x.write_behind);
   };
 
   kvstore::Spec GetKvstore() const override;
@@ -139,6 +171,8 @@ class MetadataCache
     Context::Resource<internal::DataCopyConcurrencyResource>
         data_copy_concurrency;
     Context::Resource<internal::CachePoolResource> cache_pool;
+    Context::Resource<internal::MemoryBudgetResource> memory_budget;
+    Context::Resource<internal::ChunkBufferPoolResource> chunk_buffer_pool;
   };
 
   explicit MetadataCache(Initializer initializer);
@@ -261,6 +295,14 @@ class MetadataCache
 
   const Executor& executor() { return data_copy_concurrency_->executor; }
 
+  internal::MemoryBudget* memory_budget() {
+    return memory_budget_->budget.get();
+  }
+
+  internal::ChunkBufferPool* chunk_buffer_pool() {
+    return chunk_buffer_pool_->pool.get();
+  }
+
   /// Key-value store from which `kvstore_driver()` was derived.  Used only by
   /// `GetBoundSpecData`.  A driver implementation may apply some type of
   /// adapter to the `kvstore_driver()` in order to retrieve metadata by
@@ -270,6 +312,8 @@ class MetadataCache
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency_;
   Context::Resource<internal::CachePoolResource> cache_pool_;
+  Context::Resource<internal::MemoryBudgetResource> memory_budget_;
+  Context::Resource<internal::ChunkBufferPoolResource> chunk_buffer_pool_;
 };
 
 /// Abstract base class for `Cache` types that are used with
@@ -292,6 +336,11 @@ class DataCacheBase {
   struct Initializer {
     internal::PinnedCacheEntry<MetadataCache> metadata_cache_entry;
     MetadataPtr metadata;
+    bool chunk_existence_index = false;
+    bool retain_encoded_chunks = false;
+    std::optional<WriteBehindOptions> write_behind;
+    /// Cache pool whose limits on buffered writes apply to `write_behind`.
+    internal::CachePool::WeakPtr cache_pool;
   };
 
   explicit DataCacheBase(Initializer&& initializer);
@@ -378,14 +427,39 @@ class DataCacheBase {
 
   const Executor& executor() const { return metadata_cache()->executor(); }
 
+  internal::MemoryBudget* memory_budget() const {
+    return metadata_cache()->memory_budget();
+  }
+
+  internal::ChunkBufferPool* chunk_buffer_pool() const {
+    return metadata_cache()->chunk_buffer_pool();
+  }
+
   const internal::PinnedCacheEntry<MetadataCache>& metadata_cache_entry()
       const {
     return metadata_cache_entry_;
   }
   const MetadataPtr& initial_metadata() const { return initial_metadata_; }
 
+  /// Sets a null `transaction` to the current write-behind group, if
+  /// write-behind buffering is enabled.
+  void UseWriteBehindTransaction(internal::OpenTransactionPtr& transaction) {
+    if (!transaction && write_behind_buffer_) {
+      transaction = write_behind_buffer_->AcquireTransaction();
+    }
+  }
+
   const internal::PinnedCacheEntry<MetadataCache> metadata_cache_entry_;
   const MetadataPtr initial_metadata_;
+  // Indicates that the data kvstore is wrapped by
+  // `GetChunkExistenceIndexKeyValueStore`.
+  const bool chunk_existence_index_;
+  // Indicates that the stored representation of chunks is retained for the
+  // compressed tier of the cache pool, if supported by the data cache.
+  const bool retain_encoded_chunks_;
+  // Groups non-transactional writes, or `nullptr` if write-behind buffering is
+  // disabled.
+  const WriteBehindBuffer::Ptr write_behind_buffer_;
 };
 
 /// Abstract base class for `Cache` types that are used with
@@ -402,6 +476,8 @@ class ChunkedDataCacheBase : public DataCacheBase {
 
   using DataCacheBase::DataCacheBase;
   using DataCacheBase::executor;
+  using DataCacheBase::memory_budget;
+  using DataCacheBase::chunk_buffer_pool;
 
   /// Returns the grid specification.
   virtual const internal::ChunkGridSpecification& grid() const = 0;
@@ -483,6 +559,14 @@ class DataCache : public internal::KvsBackedChunkCache,
     return ChunkedDataCacheBase::executor();
   }
 
+  internal::MemoryBudget* memory_budget() const final {
+    return ChunkedDataCacheBase::memory_budget();
+  }
+
+  internal::ChunkBufferPool* chunk_buffer_pool() const final {
+    return ChunkedDataCacheBase::chunk_buffer_pool();
+  }
+
   internal::Cache& cache() final { return *this; }
 
   const internal::ChunkGridSpecification& grid() const final { return grid_; }
@@ -490,7 +574,43 @@ class DataCache : public internal::KvsBackedChunkCache,
   Future<const void> DeleteCell(span<const Index> grid_cell_indices,
                                 internal::OpenTransactionPtr transaction) final;
 
+  /// Encoded representation of a component within a chunk that is stored
+  /// without compression, such that each element is encoded at a fixed byte
+  /// offset.
+  struct RawChunkEncoding {
+    /// Byte offset within the chunk of the element at the chunk origin.
+    Index byte_offset;
+
+    /// Positive byte stride within the chunk of each component dimension.
+    std::vector<Index> byte_strides;
+
+    /// Byte order of the encoded elements.
+    tensorstore::endian endian;
+  };
+
+  /// Returns the encoded representation of the specified component if chunks
+  /// are stored without compression, or `std::nullopt` otherwise.
+  ///
+  /// If specified, and the kvstore supports
+  /// `kvstore::SupportedFeatures::kByteRangeWrite`, non-transactional writes
+  /// that modify only part of a chunk are written in place using byte-range
+  /// writes, rather than by reading, modifying, and writing back the entire
+  /// chunk.  The component data type must be trivial.
+  ///
+  /// By default, returns `std::nullopt`.
+  virtual std::optional<RawChunkEncoding> GetRawChunkEncoding(
+      size_t component_index);
+
   internal::ChunkGridSpecification grid_;
+
+ protected:
+  Result<internal::WriteChunk::Impl> GetWriteChunkImpl(
+      const internal::ChunkCache::WriteRequest& request,
+      internal::ChunkCache::Entry& entry,
+      IndexTransformView<> cell_to_dest) override;
+
+  void GetPrefetchBounds(size_t component_index,
+                         MutableBoxView<> bounds) override;
 };
 
 /// Private data members of `OpenState`.
@@ -560,6 +680,16 @@ class KvsMetadataDriverBase : public internal::Driver {
 
   virtual const StalenessBound& data_staleness_bound() const = 0;
 
+  virtual const internal::ChunkPrefetchOptions& prefetch_options() const = 0;
+
+  /// Performs the validation of the metadata deferred by
+  /// `OpenMode::defer_validation`, if any.  The validation is performed at
+  /// most once, and its result is returned by all calls.
+  ///
+  /// Must be called by the `Read` and `Write` implementations of drivers for
+  /// which `OpenState::GetComponentIndexWithoutValidation` is overridden.
+  absl::Status ValidateDeferred();
+
   // Treat as private:
 
   StalenessBound metadata_staleness_bound_;
@@ -572,6 +702,12 @@ class KvsMetadataDriverBase : public internal::Driver {
   /// the open request.  If `OpenMode::assume_metadata` was specified, set to
   /// `absl::InfiniteFuture()`.  Otherwise, set to `absl::InfinitePast()`.
   absl::Time assumed_metadata_time_ = absl::InfinitePast();
+
+  /// If `OpenMode::defer_validation` was specified, set to the deferred
+  /// validation until it is performed by `ValidateDeferred`.
+  std::function<absl::Status()> deferred_validation_;
+  absl::once_flag deferred_validation_once_;
+  absl::Status deferred_validation_status_;
 };
 
 /// Abstract driver base class for use with `ChunkedDataCacheBase`.
@@ -742,6 +878,17 @@ class OpenState : public MetadataOpenState {
   /// If the `metadata` is not compatible, returns an error.
   virtual Result<size_t> GetComponentIndex(const void* metadata,
                                            OpenMode open_mode) = 0;
+
+  /// Returns the component index within the data cache without checking that
+  /// `metadata` is compatible, for use with `OpenMode::defer_validation`, or
+  /// `std::nullopt` if validation cannot be deferred.
+  ///
+  /// If this is overridden, the `Read` and `Write` methods of the driver must
+  /// call `KvsMetadataDriverBase::ValidateDeferred`.
+  ///
+  /// The default implementation returns `std::nullopt`.
+  virtual std::optional<size_t> GetComponentIndexWithoutValidation(
+      const void* metadata);
 };
 
 /// Attempts to open a TensorStore with a kvstore-backed chunk driver.
@@ -884,6 +1031,32 @@ class RegisteredKvsDriver
     return spec;
   }
 
+  /// Performs any deferred validation, and then forwards to `Parent`.
+  void Read(internal::Driver::ReadRequest request,
+            AnyFlowReceiver<absl::Status, internal::ReadChunk,
+                            IndexTransform<>>
+                receiver) override {
+    if (auto status = this->ValidateDeferred(); !status.ok()) {
+      execution::set_error(FlowSingleReceiver{std::move(receiver)}, status);
+      return;
+    }
+    Base::Read(std::move(request), std::move(receiver));
+  }
+
+  /// Adds non-transactional writes to the current write-behind group, if
+  /// write-behind buffering is enabled, and otherwise forwards to `Parent`.
+  void Write(internal::Driver::WriteRequest request,
+             AnyFlowReceiver<absl::Status, internal::WriteChunk,
+                             IndexTransform<>>
+                 receiver) override {
+    if (auto status = this->ValidateDeferred(); !status.ok()) {
+      execution::set_error(FlowSingleReceiver{std::move(receiver)}, status);
+      return;
+    }
+    this->cache()->UseWriteBehindTransaction(request.transaction);
+    Base::Write(std::move(request), std::move(receiver));
+  }
+
   /// Implements the `Open` method required by `internal::RegisteredDriver` in
   /// terms of `internal_kvs_backed_chunk_driver::OpenDriver`.
   static Future<internal::Driver::Handle> Open(
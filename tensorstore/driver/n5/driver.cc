@@ -18,6 +18,7 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -279,6 +280,15 @@ class DataCache : public internal_kvs_backed_chunk_driver::DataCache {
     return internal_n5::EncodeChunk(metadata(), component_arrays[0]);
   }
 
+  std::optional<std::string> GetDecodeSharingKey() override {
+    // The encoded chunk specifies its own shape, such that decoding does not
+    // depend on the chunk position.
+    std::string key;
+    internal::EncodeCacheKey(&key, std::string_view("n5"),
+                             metadata().GetCompatibilityKey());
+    return key;
+  }
+
   std::string GetChunkStorageKey(span<const Index> cell_indices) override {
     // Use "0" for rank 0 as a special case.
     std::string key = tensorstore::StrCat(
@@ -274,12 +274,22 @@ template <typename ImageWriter, typename Options>
 Result<absl::Cord> EncodeImageChunk(Options options, DataType dtype,
                                     span<const Index, 4> shape,
                                     ArrayView<const void> array) {
+  // The image is encoded from a C-order `(z, y, x, channel)` array.  For a
+  // full single-channel chunk in the usual "czyx" layout, `array` already has
+  // that layout (the channel stride is irrelevant) and is encoded in place.
+  const Index channel_byte_stride =
+      shape[0] == 1 ? dtype.size() : array.byte_strides()[0];
   Array<const void, 4> partial_source(
       array.element_pointer(),
       StridedLayout<4>({shape[1], shape[2], shape[3], shape[0]},
                        {array.byte_strides()[1], array.byte_strides()[2],
-                        array.byte_strides()[3], array.byte_strides()[0]}));
-  auto contiguous_array = MakeCopy(partial_source, c_order);
+                        array.byte_strides()[3], channel_byte_stride}));
+  SharedArray<const void> copy;
+  const void* data = partial_source.data();
+  if (!IsContiguousLayout(partial_source, c_order)) {
+    copy = MakeCopy(partial_source, c_order);
+    data = copy.data();
+  }
 
   absl::Cord buffer;
   {
@@ -291,10 +301,8 @@ Result<absl::Cord> EncodeImageChunk(Options options, DataType dtype,
                    /*.num_components =*/static_cast<int32_t>(shape[0]),
                    /*.data_type =*/dtype};
     TENSORSTORE_RETURN_IF_ERROR(writer.Encode(
-        info, tensorstore::span(reinterpret_cast<const unsigned char*>(
-                                    contiguous_array.data()),
-                                contiguous_array.num_elements() *
-                                    contiguous_array.dtype().size())));
+        info, tensorstore::span(reinterpret_cast<const unsigned char*>(data),
+                                ProductOfExtents(shape) * dtype.size())));
     TENSORSTORE_RETURN_IF_ERROR(writer.Done());
   }
   return buffer;
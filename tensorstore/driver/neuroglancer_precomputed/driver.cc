@@ -53,6 +53,7 @@
 #include "tensorstore/driver/kvs_backed_chunk_driver.h"
 #include "tensorstore/driver/neuroglancer_precomputed/chunk_encoding.h"
 #include "tensorstore/driver/neuroglancer_precomputed/metadata.h"
+#include "tensorstore/driver/neuroglancer_precomputed/multiscale.h"
 #include "tensorstore/driver/registry.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
@@ -616,8 +617,28 @@ class ShardedDataCache : public DataCacheBase {
   virtual Future<ArrayStorageStatistics> GetStorageStatistics(
       internal::Driver::GetStorageStatisticsRequest request,
       absl::Time staleness_bound) override {
-    // Not yet implemented for sharded format.
-    return absl::UnimplementedError("");
+    // Chunk keys cannot be listed efficiently, but the presence of each chunk
+    // is resolved by the sharded kvstore from the shard indices alone.
+    const auto& scale = metadata().scales[scale_index_];
+    auto& grid = this->grid();
+    Box<3> grid_bounds;
+    for (DimensionIndex i = 0; i < 3; ++i) {
+      const Index chunk_size = chunk_layout_czyx_.shape()[3 - i];
+      grid_bounds[i] = IndexInterval::UncheckedSized(
+          0, tensorstore::CeilOfRatio(scale.box.shape()[i], chunk_size));
+    }
+    const auto& component = grid.components[0];
+    return internal::GetStorageStatisticsForRegularGridWithChunkKeys(
+        KvStore{kvstore::DriverPtr(this->kvstore_driver()), {},
+                internal::TransactionState::ToTransaction(
+                    std::move(request.transaction))},
+        request.transform, /*grid_output_dimensions=*/
+        component.chunked_to_cell_dimensions,
+        /*chunk_shape=*/grid.chunk_shape, grid_bounds,
+        [this](span<const Index> grid_indices) {
+          return GetChunkStorageKey(grid_indices);
+        },
+        staleness_bound, request.options);
   }
 
   std::array<int, 3> compressed_z_index_bits_;
@@ -931,6 +952,19 @@ Future<internal::Driver::Handle> NeuroglancerPrecomputedDriverSpec::Open(
 }  // namespace
 #endif
 
+Result<std::shared_ptr<const MultiscaleMetadata>> GetMultiscaleMetadata(
+    const internal::DriverHandle& handle) {
+  auto* driver =
+      dynamic_cast<NeuroglancerPrecomputedDriver*>(handle.driver.get());
+  if (!driver) {
+    return absl::InvalidArgumentError(
+        "Expected \"neuroglancer_precomputed\" driver");
+  }
+  const auto& metadata = driver->cache()->initial_metadata();
+  return std::shared_ptr<const MultiscaleMetadata>(
+      metadata, static_cast<const MultiscaleMetadata*>(metadata.get()));
+}
+
 }  // namespace internal_neuroglancer_precomputed
 }  // namespace tensorstore
 
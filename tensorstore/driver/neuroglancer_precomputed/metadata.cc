@@ -1576,6 +1576,58 @@ std::function<uint64_t(uint64_t shard)> GetChunksPerVolumeShardFunction(
   };
 }
 
+std::array<Index, 3> GetWriteCellShape(const ScaleMetadata& scale) {
+  assert(!scale.chunk_sizes.empty());
+  std::array<Index, 3> cell_shape = scale.chunk_sizes[0];
+  const auto* sharding_spec = std::get_if<ShardingSpec>(&scale.sharding);
+  if (!sharding_spec) return cell_shape;
+  ShardChunkHierarchy hierarchy;
+  if (!GetShardChunkHierarchy(*sharding_spec, scale.box.shape(), cell_shape,
+                              hierarchy)) {
+    return cell_shape;
+  }
+  for (int dim_i = 0; dim_i < 3; ++dim_i) {
+    cell_shape[dim_i] *= hierarchy.shard_shape_in_chunks[dim_i];
+  }
+  return cell_shape;
+}
+
+std::vector<Box<3>> GetShardAlignedWriteBoxes(const ScaleMetadata& scale,
+                                              BoxView<3> region) {
+  std::vector<Box<3>> boxes;
+  const auto cell_shape = GetWriteCellShape(scale);
+  // Range of grid cells that intersect `region`, in xyz order.
+  std::array<Index, 3> start_cell, end_cell;
+  Box<3> bounded_region;
+  for (int dim_i = 0; dim_i < 3; ++dim_i) {
+    const IndexInterval interval = Intersect(region[dim_i], scale.box[dim_i]);
+    if (interval.empty()) return boxes;
+    bounded_region[dim_i] = interval;
+    const Index grid_origin = scale.box.origin()[dim_i];
+    start_cell[dim_i] = FloorOfRatio(interval.inclusive_min() - grid_origin,
+                                     cell_shape[dim_i]);
+    end_cell[dim_i] = CeilOfRatio(interval.exclusive_max() - grid_origin,
+                                  cell_shape[dim_i]);
+  }
+  std::array<Index, 3> cell;
+  for (cell[2] = start_cell[2]; cell[2] < end_cell[2]; ++cell[2]) {
+    for (cell[1] = start_cell[1]; cell[1] < end_cell[1]; ++cell[1]) {
+      for (cell[0] = start_cell[0]; cell[0] < end_cell[0]; ++cell[0]) {
+        Box<3> box;
+        for (int dim_i = 0; dim_i < 3; ++dim_i) {
+          box[dim_i] = Intersect(
+              bounded_region[dim_i],
+              IndexInterval::UncheckedSized(
+                  scale.box.origin()[dim_i] + cell[dim_i] * cell_shape[dim_i],
+                  cell_shape[dim_i]));
+        }
+        boxes.push_back(std::move(box));
+      }
+    }
+  }
+  return boxes;
+}
+
 CodecSpec NeuroglancerPrecomputedCodecSpec::Clone() const {
   return internal::CodecDriverSpec::Make<NeuroglancerPrecomputedCodecSpec>(
       *this);
@@ -397,6 +397,26 @@ std::function<uint64_t(uint64_t shard)> GetChunksPerVolumeShardFunction(
     const ShardingSpec& sharding_spec, span<const Index, 3> volume_shape,
     span<const Index, 3> chunk_shape);
 
+/// Returns the shape, in xyz order, of the cells of `scale` that are each
+/// stored as a single unit: the shard shape if `scale` is sharded and shards
+/// correspond to rectangular regions, and otherwise the chunk shape.
+///
+/// \dchecks `!scale.chunk_sizes.empty()`
+std::array<Index, 3> GetWriteCellShape(const ScaleMetadata& scale);
+
+/// Partitions `region`, intersected with `scale.box`, into boxes aligned to
+/// the grid of cells of shape `GetWriteCellShape(scale)`.
+///
+/// Writing each box returned for a sharded volume writes each shard exactly
+/// once, and a box that covers an entire shard is written without reading
+/// the existing shard.  The boxes are independent and may be written
+/// concurrently.
+///
+/// \param scale The scale metadata.
+/// \param region The region, in xyz order.
+std::vector<Box<3>> GetShardAlignedWriteBoxes(const ScaleMetadata& scale,
+                                              BoxView<3> region);
+
 }  // namespace internal_neuroglancer_precomputed
 }  // namespace tensorstore
 
@@ -59,7 +59,10 @@ using ::tensorstore::internal_neuroglancer_precomputed::
 using ::tensorstore::internal_neuroglancer_precomputed::GetCompressedZIndexBits;
 using ::tensorstore::internal_neuroglancer_precomputed::
     GetMetadataCompatibilityKey;
+using ::tensorstore::internal_neuroglancer_precomputed::
+    GetShardAlignedWriteBoxes;
 using ::tensorstore::internal_neuroglancer_precomputed::GetShardChunkHierarchy;
+using ::tensorstore::internal_neuroglancer_precomputed::GetWriteCellShape;
 using ::tensorstore::internal_neuroglancer_precomputed::MultiscaleMetadata;
 using ::tensorstore::internal_neuroglancer_precomputed::
     MultiscaleMetadataConstraints;
@@ -2045,6 +2048,41 @@ TEST(GetChunksPerVolumeShardFunctionTest, NotEnoughBits) {
                                                chunk_shape));
 }
 
+TEST(GetShardAlignedWriteBoxesTest, Sharded) {
+  ScaleMetadata scale;
+  scale.box = Box<3>({0, 0, 0}, {99, 98, 97});
+  scale.chunk_sizes = {{50, 25, 13}};
+  scale.sharding = ShardingSpec{
+      /*.hash_function=*/ShardingSpec::HashFunction::identity,
+      /*.preshift_bits=*/1,
+      /*.minishard_bits=*/2,
+      /*.shard_bits=*/3,
+      /*.data_encoding=*/ShardingSpec::DataEncoding::raw,
+      /*.minishard_index_encoding=*/ShardingSpec::DataEncoding::gzip,
+  };
+  // Shard shape in chunks: {2, 2, 2}
+  EXPECT_THAT(GetWriteCellShape(scale), ElementsAre(100, 50, 26));
+  EXPECT_THAT(
+      GetShardAlignedWriteBoxes(scale, Box<3>({10, -5, 0}, {50, 200, 30})),
+      ElementsAre(Box<3>({10, 0, 0}, {50, 50, 26}),
+                  Box<3>({10, 50, 0}, {50, 48, 26}),
+                  Box<3>({10, 0, 26}, {50, 50, 4}),
+                  Box<3>({10, 50, 26}, {50, 48, 4})));
+  EXPECT_THAT(GetShardAlignedWriteBoxes(scale, Box<3>({100, 0, 0}, {5, 5, 5})),
+              ElementsAre());
+}
+
+TEST(GetShardAlignedWriteBoxesTest, Unsharded) {
+  ScaleMetadata scale;
+  scale.box = Box<3>({1, 2, 3}, {99, 98, 97});
+  scale.chunk_sizes = {{50, 25, 13}};
+  scale.sharding = NoShardingSpec{};
+  EXPECT_THAT(GetWriteCellShape(scale), ElementsAre(50, 25, 13));
+  EXPECT_THAT(GetShardAlignedWriteBoxes(scale, Box<3>({40, 2, 3}, {20, 1, 1})),
+              ElementsAre(Box<3>({40, 2, 3}, {11, 1, 1}),
+                          Box<3>({51, 2, 3}, {9, 1, 1})));
+}
+
 TEST(NeuroglancerPrecomputedCodecSpecTest, Merge) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto codec1,
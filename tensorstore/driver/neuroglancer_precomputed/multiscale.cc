@@ -0,0 +1,175 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/neuroglancer_precomputed/multiscale.h"
+
+#include <stddef.h>
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/box.h"
+#include "tensorstore/context.h"
+#include "tensorstore/driver/neuroglancer_precomputed/metadata.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/open_options.h"
+#include "tensorstore/spec.h"
+#include "tensorstore/staleness_bound.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_neuroglancer_precomputed {
+
+Box<3> GetScaleRegion(BoxView<3> region,
+                      const std::array<double, 3>& base_resolution,
+                      const std::array<double, 3>& resolution,
+                      BoxView<3> scale_box) {
+  Box<3> result;
+  for (int i = 0; i < 3; ++i) {
+    const double factor = base_resolution[i] / resolution[i];
+    const auto interval = region[i];
+    result[i] = Intersect(
+        IndexInterval::UncheckedHalfOpen(
+            static_cast<Index>(std::floor(interval.inclusive_min() * factor)),
+            static_cast<Index>(std::ceil(interval.exclusive_max() * factor))),
+        scale_box[i]);
+  }
+  return result;
+}
+
+}  // namespace internal_neuroglancer_precomputed
+
+namespace neuroglancer_precomputed {
+
+Future<MultiscaleVolume> OpenMultiscaleVolume(
+    Spec spec, TransactionalOpenOptions&& options) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto json_spec, spec.ToJson());
+  if (json_spec.value("driver", "") != "neuroglancer_precomputed") {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Expected \"neuroglancer_precomputed\" driver, but received: ",
+        json_spec.dump()));
+  }
+  json_spec.erase("scale_metadata");
+  json_spec.erase("transform");
+  json_spec["scale_index"] = 0;
+  if (!options.context) options.context = Context::Default();
+
+  // The remaining scales are opened from the metadata cached by the first.
+  TransactionalOpenOptions scale_options = options;
+  scale_options.open_mode = OpenMode::open;
+  scale_options.recheck_cached_metadata = RecheckCachedMetadata(false);
+
+  auto first = tensorstore::Open(json_spec, std::move(options));
+  return PromiseFuturePair<MultiscaleVolume>::LinkValue(
+             [json_spec = std::move(json_spec),
+              scale_options = std::move(scale_options)](
+                 Promise<MultiscaleVolume> promise,
+                 ReadyFuture<TensorStore<>> ready) mutable {
+               auto& store = ready.value();
+               auto metadata_result =
+                   internal_neuroglancer_precomputed::GetMultiscaleMetadata(
+                       internal::TensorStoreAccess::handle(store));
+               if (!metadata_result.ok()) {
+                 promise.SetResult(std::move(metadata_result).status());
+                 return;
+               }
+               const auto& metadata = **metadata_result;
+               auto volume = std::make_shared<MultiscaleVolume>();
+               volume->scales.resize(metadata.scales.size());
+               std::vector<Future<TensorStore<>>> futures;
+               for (size_t i = 0; i < metadata.scales.size(); ++i) {
+                 auto& scale = volume->scales[i];
+                 scale.resolution = metadata.scales[i].resolution;
+                 scale.box = metadata.scales[i].box;
+                 if (i == 0) {
+                   scale.store = store;
+                   continue;
+                 }
+                 json_spec["scale_index"] = i;
+                 futures.push_back(tensorstore::Open(
+                     json_spec, TransactionalOpenOptions(scale_options)));
+               }
+               auto all = WaitAllFuture(tensorstore::span(futures));
+               LinkValue(
+                   [volume, futures = std::move(futures)](
+                       Promise<MultiscaleVolume> promise,
+                       ReadyFuture<void> ready) {
+                     for (size_t i = 0; i < futures.size(); ++i) {
+                       volume->scales[i + 1].store = futures[i].value();
+                     }
+                     promise.SetResult(std::move(*volume));
+                   },
+                   std::move(promise), std::move(all));
+             },
+             std::move(first))
+      .future;
+}
+
+Future<std::vector<SharedOffsetArray<void>>> ReadMultiscaleRegion(
+    const MultiscaleVolume& volume, BoxView<3> region,
+    span<const size_t> scale_indices, Batch batch) {
+  if (volume.scales.empty()) {
+    return absl::InvalidArgumentError("Multiscale volume has no scales");
+  }
+  const auto& base_resolution = volume.scales[0].resolution;
+  if (!batch) batch = Batch::New();
+  std::vector<Future<SharedOffsetArray<void>>> futures;
+  futures.reserve(scale_indices.size());
+  for (size_t scale_index : scale_indices) {
+    if (scale_index >= volume.scales.size()) {
+      return absl::OutOfRangeError(tensorstore::StrCat(
+          "Scale index ", scale_index, " is outside valid range [0, ",
+          volume.scales.size(), ")"));
+    }
+    const auto& scale = volume.scales[scale_index];
+    const auto scale_region = internal_neuroglancer_precomputed::GetScaleRegion(
+        region, base_resolution, scale.resolution, scale.box);
+    futures.push_back(tensorstore::Read(
+        scale.store | Dims("x", "y", "z").BoxSlice(scale_region), batch));
+  }
+  // Submits the batch, unless it was provided by the caller.
+  batch.Release();
+  auto all = WaitAllFuture(tensorstore::span(futures));
+  return PromiseFuturePair<std::vector<SharedOffsetArray<void>>>::LinkValue(
+             [futures = std::move(futures)](
+                 Promise<std::vector<SharedOffsetArray<void>>> promise,
+                 ReadyFuture<void> ready) {
+               std::vector<SharedOffsetArray<void>> arrays;
+               arrays.reserve(futures.size());
+               for (const auto& future : futures) {
+                 arrays.push_back(future.value());
+               }
+               promise.SetResult(std::move(arrays));
+             },
+             std::move(all))
+      .future;
+}
+
+}  // namespace neuroglancer_precomputed
+}  // namespace tensorstore
@@ -0,0 +1,134 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_NEUROGLANCER_PRECOMPUTED_MULTISCALE_H_
+#define TENSORSTORE_DRIVER_NEUROGLANCER_PRECOMPUTED_MULTISCALE_H_
+
+/// \file
+/// Opening and reading all scales of a neuroglancer precomputed volume
+/// together.
+
+#include <stddef.h>
+
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tensorstore/array.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/box.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/driver/neuroglancer_precomputed/metadata.h"
+#include "tensorstore/open_options.h"
+#include "tensorstore/spec.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/option.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace neuroglancer_precomputed {
+
+/// All scales of a multiscale volume, in the order of the ``"scales"`` array
+/// of its ``info`` metadata.
+struct MultiscaleVolume {
+  struct Scale {
+    /// Store with dimensions ``"x"``, ``"y"``, ``"z"``, ``"channel"``.
+    TensorStore<> store;
+
+    /// Voxel size in nanometers, in xyz order.
+    std::array<double, 3> resolution;
+
+    /// Bounds of the scale, in xyz order.
+    Box<3> box;
+  };
+
+  std::vector<Scale> scales;
+};
+
+/// Opens every scale of the multiscale volume specified by `spec`.
+///
+/// \param spec Spec using the ``"neuroglancer_precomputed"`` driver.
+/// \param options Any option compatible with `TransactionalOpenOptions`.
+///
+/// The ``info`` metadata is read once, when the first scale is opened, and
+/// the remaining scales are opened from the cached metadata rather than each
+/// re-reading it.  Scale-specific members of `spec`, i.e. ``"scale_index"``,
+/// ``"scale_metadata"`` and ``"transform"``, are ignored.
+///
+/// If `options` does not specify a `Context`, a default context is shared by
+/// all of the scales.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if `spec` does not use the
+///     ``"neuroglancer_precomputed"`` driver.
+Future<MultiscaleVolume> OpenMultiscaleVolume(
+    Spec spec, TransactionalOpenOptions&& options);
+template <typename... Option>
+std::enable_if_t<
+    IsCompatibleOptionSequence<TransactionalOpenOptions, Option...>,
+    Future<MultiscaleVolume>>
+OpenMultiscaleVolume(Spec spec, Option&&... option) {
+  TENSORSTORE_INTERNAL_ASSIGN_OPTIONS_OR_RETURN(TransactionalOpenOptions,
+                                                options, option)
+  return neuroglancer_precomputed::OpenMultiscaleVolume(std::move(spec),
+                                                        std::move(options));
+}
+
+/// Reads the region of each of `scale_indices` that corresponds to `region`.
+///
+/// `region` is specified in voxel coordinates of scale 0, in xyz order, and
+/// is converted to each scale according to the ratio of the resolutions,
+/// rounding outwards, and clipped to the bounds of the scale.  All channels
+/// are read.
+///
+/// All of the reads are issued as part of `batch`, or, if `batch` is
+/// `no_batch`, as part of a single new batch that is submitted before
+/// returning, such that chunks shared by several scales (e.g. in the same
+/// shard) are fetched together.
+///
+/// \returns A future for the arrays read from each of `scale_indices`, with
+///     dimensions ``"x"``, ``"y"``, ``"z"``, ``"channel"`` and origins in the
+///     voxel coordinates of the respective scales.
+/// \error `absl::StatusCode::kOutOfRange` if any of `scale_indices` is out of
+///     range.
+Future<std::vector<SharedOffsetArray<void>>> ReadMultiscaleRegion(
+    const MultiscaleVolume& volume, BoxView<3> region,
+    span<const size_t> scale_indices, Batch batch = no_batch);
+
+}  // namespace neuroglancer_precomputed
+
+namespace internal_neuroglancer_precomputed {
+
+/// Returns the metadata of the multiscale volume opened by `handle`.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if `handle` does not refer to a
+///     ``"neuroglancer_precomputed"`` driver.
+Result<std::shared_ptr<const MultiscaleMetadata>> GetMultiscaleMetadata(
+    const internal::DriverHandle& handle);
+
+/// Returns the region of a scale with the specified `resolution` and bounds
+/// `scale_box` that corresponds to `region` of a scale with
+/// `base_resolution`.
+Box<3> GetScaleRegion(BoxView<3> region,
+                      const std::array<double, 3>& base_resolution,
+                      const std::array<double, 3>& resolution,
+                      BoxView<3> scale_box);
+
+}  // namespace internal_neuroglancer_precomputed
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_NEUROGLANCER_PRECOMPUTED_MULTISCALE_H_
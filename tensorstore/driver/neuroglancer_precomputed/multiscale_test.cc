@@ -0,0 +1,132 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/neuroglancer_precomputed/multiscale.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/context.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/spec.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_neuroglancer_precomputed::GetScaleRegion;
+using ::tensorstore::neuroglancer_precomputed::OpenMultiscaleVolume;
+using ::tensorstore::neuroglancer_precomputed::ReadMultiscaleRegion;
+
+::nlohmann::json GetScaleSpec(std::array<double, 3> resolution,
+                              std::array<int, 3> size) {
+  return {
+      {"driver", "neuroglancer_precomputed"},
+      {"kvstore", "memory://volume/"},
+      {"multiscale_metadata",
+       {{"data_type", "uint8"}, {"num_channels", 1}, {"type", "image"}}},
+      {"scale_metadata",
+       {{"resolution", resolution},
+        {"encoding", "raw"},
+        {"chunk_size", {2, 2, 1}},
+        {"size", size}}},
+  };
+}
+
+TEST(GetScaleRegionTest, Basic) {
+  const Box<3> scale_box({0, 0, 0}, {50, 50, 10});
+  // Halving the resolution rounds outwards.
+  EXPECT_EQ(Box<3>({0, 1, 2}, {2, 2, 3}),
+            GetScaleRegion(Box<3>({1, 2, 2}, {3, 3, 3}), {4, 4, 40},
+                           {8, 8, 40}, scale_box));
+  // The region is clipped to the bounds of the scale.
+  EXPECT_EQ(Box<3>({40, 0, 0}, {10, 50, 10}),
+            GetScaleRegion(Box<3>({80, -10, 0}, {40, 200, 20}), {4, 4, 40},
+                           {8, 8, 40}, scale_box));
+}
+
+TEST(MultiscaleTest, OpenAndRead) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto scale0, tensorstore::Open(GetScaleSpec({1, 1, 1}, {4, 4, 1}),
+                                     context, tensorstore::OpenMode::create)
+                       .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto scale1, tensorstore::Open(GetScaleSpec({2, 2, 1}, {2, 2, 1}),
+                                     context, tensorstore::OpenMode::create)
+                       .result());
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint8_t>(1), scale0)
+          .commit_future.result());
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint8_t>(2), scale1)
+          .commit_future.result());
+
+  // Scale-specific members of the spec are ignored.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto spec,
+      tensorstore::Spec::FromJson({{"driver", "neuroglancer_precomputed"},
+                                   {"kvstore", "memory://volume/"},
+                                   {"scale_index", 1}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto volume, OpenMultiscaleVolume(spec, context).result());
+  ASSERT_THAT(volume.scales, ::testing::SizeIs(2));
+  EXPECT_THAT(volume.scales[1].resolution, ::testing::ElementsAre(2, 2, 1));
+  EXPECT_EQ(Box<3>({0, 0, 0}, {2, 2, 1}), volume.scales[1].box);
+
+  const size_t scale_indices[] = {0, 1};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto arrays, ReadMultiscaleRegion(volume, Box<3>({1, 1, 0}, {2, 2, 1}),
+                                        scale_indices)
+                       .result());
+  ASSERT_THAT(arrays, ::testing::SizeIs(2));
+  EXPECT_EQ(Box<4>({1, 1, 0, 0}, {2, 2, 1, 1}), arrays[0].domain());
+  EXPECT_EQ(Box<4>({0, 0, 0, 0}, {2, 2, 1, 1}), arrays[1].domain());
+  EXPECT_THAT(tensorstore::Read(scale0 | tensorstore::Dims(0, 1).SizedInterval(
+                                             {1, 1}, {2, 2}))
+                  .result(),
+              ::testing::Optional(arrays[0]));
+  EXPECT_THAT(tensorstore::Read(scale1).result(),
+              ::testing::Optional(arrays[1]));
+
+  const size_t invalid_scale_indices[] = {2};
+  EXPECT_THAT(ReadMultiscaleRegion(volume, Box<3>({0, 0, 0}, {1, 1, 1}),
+                                   invalid_scale_indices)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+}
+
+TEST(MultiscaleTest, InvalidDriver) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto spec, tensorstore::Spec::FromJson(
+                     {{"driver", "zarr"}, {"kvstore", "memory://"}}));
+  EXPECT_THAT(OpenMultiscaleVolume(spec).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"neuroglancer_precomputed\" driver.*"));
+}
+
+}  // namespace
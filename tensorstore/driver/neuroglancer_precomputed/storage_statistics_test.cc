@@ -264,11 +264,69 @@ TEST_F(StorageStatisticsTest, Sharded) {
                       .result());
   mock_kvstore->request_log.pop_all();
 
+  auto transformed = store | tensorstore::AllDims().HalfOpenInterval(
+                                 {8, 8, 8, 0}, {10, 10, 10, 1});
   EXPECT_THAT(tensorstore::GetStorageStatistics(
-                  store | tensorstore::Dims(0).HalfOpenInterval(8, 15),
-                  ArrayStorageStatistics::query_not_stored)
+                  transformed, ArrayStorageStatistics::query_not_stored)
+                  .result(),
+              ::testing::Optional(ArrayStorageStatistics{
+                  /*.mask=*/ArrayStorageStatistics::query_not_stored,
+                  /*.not_stored=*/true}));
+  // The presence of chunks is determined from the shard indices, rather than
+  // by listing.
+  for (const auto& entry : mock_kvstore->request_log.pop_all()) {
+    EXPECT_EQ("read", entry["type"]);
+  }
+
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint8_t>(42),
+                         transformed | tensorstore::Dims(0).SizedInterval(8, 1))
+          .result());
+  EXPECT_THAT(tensorstore::GetStorageStatistics(
+                  transformed, ArrayStorageStatistics::query_not_stored,
+                  ArrayStorageStatistics::query_fully_stored)
+                  .result(),
+              ::testing::Optional(ArrayStorageStatistics{
+                  /*.mask=*/ArrayStorageStatistics::query_not_stored |
+                      ArrayStorageStatistics::query_fully_stored,
+                  /*.not_stored=*/false, /*.fully_stored=*/false}));
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint8_t>(42),
+                         transformed)
+          .result());
+  EXPECT_THAT(tensorstore::GetStorageStatistics(
+                  transformed, ArrayStorageStatistics::query_fully_stored)
+                  .result(),
+              ::testing::Optional(ArrayStorageStatistics{
+                  /*.mask=*/ArrayStorageStatistics::query_fully_stored,
+                  /*.fully_stored=*/true}));
+}
+
+TEST_F(StorageStatisticsTest, ListSplitIntoParallelRequests) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(
+                      {
+                          {"driver", "neuroglancer_precomputed"},
+                          {"kvstore", {{"driver", "mock_key_value_store"}}},
+                      },
+                      Schema::Shape({200, 200, 200, 1}), dtype_v<uint8_t>,
+                      ChunkLayout::ReadChunkShape({4, 4, 4, 1}), context,
+                      tensorstore::OpenMode::create)
+                      .result());
+  mock_kvstore->request_log.pop_all();
+  EXPECT_THAT(tensorstore::GetStorageStatistics(
+                  store, ArrayStorageStatistics::query_not_stored)
                   .result(),
-              MatchesStatus(absl::StatusCode::kUnimplemented));
+              ::testing::Optional(ArrayStorageStatistics{
+                  /*.mask=*/ArrayStorageStatistics::query_not_stored,
+                  /*.not_stored=*/true}));
+  // The 50^3 chunks are listed using one request per range of the outer grid
+  // dimension, rather than a single list of the entire scale.
+  auto log = mock_kvstore->request_log.pop_all();
+  EXPECT_THAT(log, ::testing::SizeIs(::testing::Gt(1)));
+  for (const auto& entry : log) {
+    EXPECT_EQ("list", entry["type"]);
+  }
 }
 
 }  // namespace
@@ -19,7 +19,9 @@
 #include <type_traits>
 #include <utility>
 
+#include "absl/base/call_once.h"
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "tensorstore/array.h"
 #include "tensorstore/batch.h"
 #include "tensorstore/box.h"
@@ -34,6 +36,7 @@
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/internal/deadline.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lock_collection.h"
 #include "tensorstore/internal/nditerable.h"
@@ -42,6 +45,9 @@
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/internal/tagged_ptr.h"
+#include "tensorstore/internal/tracing/access_trace.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
+#include "tensorstore/internal/tracing/trace_span.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/progress.h"
@@ -56,6 +62,7 @@
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/task_priority.h"
 
 namespace tensorstore {
 namespace internal {
@@ -109,7 +116,43 @@ struct ReadState
   std::atomic<Index> copied_elements{0};
   Index total_elements;
 
+  /// Set only by `DriverReadIntoNewArray` with
+  /// `can_reference_cached_data_read_only`.  In that case, the target array is
+  /// not allocated until a chunk is received that cannot be referenced
+  /// directly, and the result is set once all chunks have been processed.
+  struct LazyTarget {
+    Box<> domain;
+    DataType dtype;
+    ContiguousLayoutOrder layout_order;
+    absl::once_flag once;
+    SharedOffsetArray<void> array;
+    std::atomic<bool> failed{false};
+  };
+  std::unique_ptr<LazyTarget> lazy_target;
+
+  ~ReadState() {
+    if constexpr (!std::is_void_v<PromiseValue>) {
+      if (lazy_target && !lazy_target->failed.load() &&
+          promise.result_needed()) {
+        EnsureTargetAllocated();
+        SetDeferredResult(promise, std::move(lazy_target->array));
+      }
+    }
+  }
+
+  /// Allocates `target`, unless it has already been allocated or set to
+  /// reference chunk data.
+  void EnsureTargetAllocated() {
+    absl::call_once(lazy_target->once, [&] {
+      lazy_target->array =
+          AllocateArray(lazy_target->domain, lazy_target->layout_order,
+                        default_init, lazy_target->dtype);
+      target = lazy_target->array;
+    });
+  }
+
   void SetError(absl::Status error) {
+    if (lazy_target) lazy_target->failed = true;
     SetDeferredResult(promise, std::move(error));
   }
 
@@ -128,21 +171,57 @@ struct ReadChunkOp {
   ReadChunk chunk;
   IndexTransform<> cell_transform;
   void operator()() {
+    if (state->lazy_target) {
+      if (TryReferenceChunk()) return;
+      state->EnsureTargetAllocated();
+    }
     // Map the portion of the target array that corresponds to this chunk to
     // the index space expected by the chunk.
     TENSORSTORE_ASSIGN_OR_RETURN(
         auto target,
         ApplyIndexTransform(std::move(cell_transform), state->target),
         state->SetError(_));
-    absl::Status copy_status =
-        internal::CopyReadChunk(chunk.impl, std::move(chunk.transform),
-                                state->data_type_conversion, target);
+    // Large chunks are split across multiple tasks on the data copy
+    // executor, so that copying a single chunk is not limited to one thread.
+    absl::Status copy_status = internal::CopyReadChunk(
+        chunk.impl, std::move(chunk.transform), state->data_type_conversion,
+        target, state->executor);
     if (copy_status.ok()) {
       state->UpdateProgress(ProductOfExtents(target.shape()));
     } else {
       state->SetError(std::move(copy_status));
     }
   }
+
+  /// Attempts to use the data of `chunk` as the result, without copying.
+  ///
+  /// This is only possible if `chunk` covers the entire domain of the read, in
+  /// which case it is the only chunk.
+  bool TryReferenceChunk() {
+    if (cell_transform.domain().num_elements() != state->total_elements ||
+        !(state->data_type_conversion.flags &
+          DataTypeConversionFlags::kIdentity)) {
+      return false;
+    }
+    SharedOffsetArray<const void> chunk_array;
+    if (!chunk.impl(ReadChunk::ReadArray{}, chunk.transform, chunk_array)) {
+      return false;
+    }
+    // `chunk_array` has the domain of `cell_transform`; map it back to the
+    // domain of the read.
+    auto inverse_transform = InverseTransform(cell_transform);
+    if (!inverse_transform.ok()) return false;
+    auto transformed_array =
+        MakeTransformedArray(std::move(chunk_array), *inverse_transform);
+    if (!transformed_array.ok()) return false;
+    auto array = TryConvertToArray(*std::move(transformed_array));
+    if (!array.ok()) return false;
+    absl::call_once(state->lazy_target->once, [&] {
+      state->lazy_target->array = ConstDataTypeCast<void>(*std::move(array));
+    });
+    state->UpdateProgress(state->total_elements);
+    return true;
+  }
 };
 
 /// FlowReceiver used by the two `DriverRead` overloads to copy data from chunks
@@ -166,6 +245,25 @@ struct ReadChunkReceiver {
   }
 };
 
+/// FlowReceiver used by `DriverPrefetch`, which discards chunks as they become
+/// available.
+struct PrefetchChunkReceiver {
+  IntrusivePtr<ReadState<void>> state;
+  FutureCallbackRegistration cancel_registration;
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration =
+        state->promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+  void set_stopping() { cancel_registration(); }
+  void set_done() {}
+  void set_error(absl::Status error) { state->SetError(std::move(error)); }
+  void set_value(ReadChunk chunk, IndexTransform<> cell_transform) {
+    // The data for the chunk has already been read by the driver, and is not
+    // needed.
+    state->UpdateProgress(cell_transform.input_domain().num_elements());
+  }
+};
+
 /// Callback used by `DriverRead` to initiate a read into an existing array once
 /// the source transform bounds have been resolved.
 struct DriverReadIntoExistingInitiateOp {
@@ -183,6 +281,9 @@ struct DriverReadIntoExistingInitiateOp {
         static_cast<void>(promise.SetResult(_)));
     state->promise = std::move(promise);
     state->total_elements = source_transform.domain().num_elements();
+    internal_tracing::AddIoAccounting(
+        &internal_tracing::IoAccounting::bytes_requested,
+        state->total_elements * state->target.dtype()->size);
 
     // Initiate the read on the driver.
     auto source_driver = std::move(state->source_driver);
@@ -202,6 +303,7 @@ struct DriverReadIntoNewInitiateOp {
   IntrusivePtr<State> state;
   DataType target_dtype;
   ContiguousLayoutOrder target_layout_order;
+  ReadResultReferenceRestriction result_reference_restriction;
   void operator()(Promise<SharedOffsetArray<void>> promise,
                   ReadyFuture<IndexTransform<>> source_transform_future) {
     IndexTransform<> source_transform =
@@ -213,12 +315,24 @@ struct DriverReadIntoNewInitiateOp {
       return;
     }
 
-    auto array = AllocateArray(source_transform.domain().box(),
-                               target_layout_order, default_init, target_dtype);
-    auto& r = promise.raw_result() = std::move(array);
-    state->target = *r;
+    if (result_reference_restriction == can_reference_cached_data_read_only) {
+      // Allocation is deferred until a chunk cannot be referenced.
+      state->lazy_target = std::make_unique<State::LazyTarget>();
+      state->lazy_target->domain = source_transform.domain().box();
+      state->lazy_target->dtype = target_dtype;
+      state->lazy_target->layout_order = target_layout_order;
+    } else {
+      auto array =
+          AllocateArray(source_transform.domain().box(), target_layout_order,
+                        default_init, target_dtype);
+      auto& r = promise.raw_result() = std::move(array);
+      state->target = *r;
+    }
     state->promise = std::move(promise);
     state->total_elements = source_transform.input_domain().num_elements();
+    internal_tracing::AddIoAccounting(
+        &internal_tracing::IoAccounting::bytes_requested,
+        state->total_elements * target_dtype->size);
 
     // Initiate the read on the driver.
     auto source_driver = std::move(state->source_driver);
@@ -232,6 +346,36 @@ struct DriverReadIntoNewInitiateOp {
   }
 };
 
+/// Callback used by `DriverPrefetch` to initiate the read once the source
+/// transform bounds have been resolved.
+struct DriverPrefetchInitiateOp {
+  using State = ReadState<void>;
+  IntrusivePtr<State> state;
+  void operator()(Promise<void> promise,
+                  ReadyFuture<IndexTransform<>> source_transform_future) {
+    IndexTransform<> source_transform =
+        std::move(source_transform_future.value());
+
+    if (!IsFinite(source_transform.domain())) {
+      promise.SetResult(absl::InvalidArgumentError(
+          tensorstore::StrCat("Prefetch requires a finite domain, got ",
+                              source_transform.domain())));
+      return;
+    }
+    state->promise = std::move(promise);
+    state->total_elements = source_transform.input_domain().num_elements();
+
+    // Initiate the read on the driver.
+    auto source_driver = std::move(state->source_driver);
+    Driver::ReadRequest request;
+    request.transaction = std::move(state->source_transaction);
+    request.batch = std::move(state->source_batch);
+    request.transform = std::move(source_transform);
+    source_driver->Read(std::move(request),
+                        PrefetchChunkReceiver{std::move(state)});
+  }
+};
+
 }  // namespace
 
 Future<void> DriverRead(Executor executor, DriverHandle source,
@@ -274,9 +418,27 @@ Future<void> DriverRead(Executor executor, DriverHandle source,
 Future<void> DriverRead(DriverHandle source,
                         TransformedSharedArray<void> target,
                         ReadOptions options) {
+  auto io_statistics_function = std::move(options.io_statistics_function);
+  auto io_accounting = MakeIoAccounting(io_statistics_function);
+  internal_tracing::TraceSpan span("tensorstore.driver.read", io_accounting);
+  internal_tracing::AccessTraceRecorder access_recorder("read",
+                                                        source.transform);
   auto executor = source.driver->data_copy_executor();
-  return internal::DriverRead(std::move(executor), std::move(source),
-                              std::move(target), {std::move(options)});
+  internal::ScopedTaskPriority scoped_priority(options.priority);
+  if (options.priority != TaskPriority::kNormal) {
+    executor =
+        internal::WithTaskPriority(std::move(executor), options.priority);
+  }
+  internal::ScopedDeadline scoped_deadline(options.deadline.time);
+  const absl::Time deadline = internal::GetCurrentDeadline();
+  auto future = internal::WithDeadline(
+      internal::DriverRead(std::move(executor), std::move(source),
+                           std::move(target), {std::move(options)}),
+      deadline);
+  access_recorder.RecordWhenReady(future);
+  ReportIoStatisticsWhenReady(std::move(io_accounting),
+                              std::move(io_statistics_function), future);
+  return internal_tracing::EndWhenReady(std::move(span), std::move(future));
 }
 
 Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
@@ -309,25 +471,110 @@ Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
 
   // Initiate the read once the bounds have been resolved.
   LinkValue(WithExecutor(std::move(executor),
-                         DriverReadIntoNewInitiateOp{std::move(state),
-                                                     options.target_dtype,
-                                                     options.layout_order}),
+                         DriverReadIntoNewInitiateOp{
+                             std::move(state), options.target_dtype,
+                             options.layout_order,
+                             options.result_reference_restriction}),
             std::move(pair.promise), std::move(transform_future));
   return std::move(pair.future);
 }
 
 Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
     DriverHandle source, ReadIntoNewArrayOptions options) {
+  auto io_statistics_function = std::move(options.io_statistics_function);
+  auto io_accounting = MakeIoAccounting(io_statistics_function);
+  internal_tracing::TraceSpan span("tensorstore.driver.read", io_accounting);
+  internal_tracing::AccessTraceRecorder access_recorder("read",
+                                                        source.transform);
   auto dtype = source.driver->dtype();
   auto executor = source.driver->data_copy_executor();
-  return internal::DriverReadIntoNewArray(
-      std::move(executor), std::move(source), {std::move(options), dtype});
+  internal::ScopedTaskPriority scoped_priority(options.priority);
+  if (options.priority != TaskPriority::kNormal) {
+    executor =
+        internal::WithTaskPriority(std::move(executor), options.priority);
+  }
+  internal::ScopedDeadline scoped_deadline(options.deadline.time);
+  const absl::Time deadline = internal::GetCurrentDeadline();
+  auto future = internal::WithDeadline(
+      internal::DriverReadIntoNewArray(std::move(executor), std::move(source),
+                                       {std::move(options), dtype}),
+      deadline);
+  access_recorder.RecordWhenReady(future);
+  ReportIoStatisticsWhenReady(std::move(io_accounting),
+                              std::move(io_statistics_function), future);
+  return internal_tracing::EndWhenReady(std::move(span), std::move(future));
 }
 
-absl::Status CopyReadChunk(
+IntrusivePtr<internal_tracing::IoAccounting> MakeIoAccounting(
+    const IoStatisticsFunction& function) {
+  if (!function.value) return {};
+  return MakeIntrusivePtr<internal_tracing::IoAccounting>();
+}
+
+void ReportIoStatisticsWhenReady(
+    IntrusivePtr<internal_tracing::IoAccounting> io_accounting,
+    IoStatisticsFunction function, const AnyFuture& future) {
+  if (!io_accounting) return;
+  future.UntypedExecuteWhenReady(
+      [io_accounting = std::move(io_accounting),
+       function = std::move(function)](AnyFuture) mutable {
+        constexpr auto kOrder = std::memory_order_relaxed;
+        function.value(IoStatistics{
+            io_accounting->bytes_requested.load(kOrder),
+            io_accounting->bytes_fetched.load(kOrder),
+            io_accounting->bytes_decoded.load(kOrder),
+            io_accounting->bytes_written.load(kOrder),
+            io_accounting->chunks_touched.load(kOrder),
+            io_accounting->cache_hits.load(kOrder),
+        });
+      });
+}
+
+Future<void> DriverPrefetch(DriverHandle source, PrefetchOptions options) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsRead(source.driver.read_write_mode()));
+  using State = ReadState<void>;
+  IntrusivePtr<State> state(new State);
+  auto executor = source.driver->data_copy_executor();
+  internal::ScopedTaskPriority scoped_priority(options.priority);
+  if (options.priority != TaskPriority::kNormal) {
+    executor =
+        internal::WithTaskPriority(std::move(executor), options.priority);
+  }
+  state->executor = executor;
+  state->source_driver = std::move(source.driver);
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      state->source_transaction,
+      internal::AcquireOpenTransactionPtrOrError(source.transaction));
+  state->source_batch = std::move(options.batch);
+  state->read_progress_function = std::move(options.progress_function);
+  auto pair = PromiseFuturePair<void>::Make(MakeResult());
+
+  // Resolve the bounds for `source.transform`.
+  Driver::ResolveBoundsRequest request;
+  request.transaction = state->source_transaction;
+  request.transform = std::move(source.transform);
+  request.options = fix_resizable_bounds;
+
+  auto transform_future =
+      state->source_driver->ResolveBounds(std::move(request));
+
+  // Initiate the read once the bounds have been resolved.
+  LinkValue(WithExecutor(std::move(executor),
+                         DriverPrefetchInitiateOp{std::move(state)}),
+            std::move(pair.promise), std::move(transform_future));
+  return std::move(pair.future);
+}
+
+namespace {
+
+// Copies `chunk` to `target`, using `ParallelNDIterableCopy` if `executor` is
+// non-null.
+absl::Status CopyReadChunkImpl(
     ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
     const DataTypeConversionLookupResult& chunk_conversion,
-    TransformedArray<void, dynamic_rank, view> target) {
+    TransformedArray<void, dynamic_rank, view> target,
+    const Executor* executor) {
   DefaultNDIterableArena arena;
 
   TENSORSTORE_ASSIGN_OR_RETURN(
@@ -345,11 +592,34 @@ absl::Status CopyReadChunk(
       std::move(source_iterable), target_iterable->dtype(), chunk_conversion);
 
   // Copy the chunk to the relevant portion of the target array.
+  if (executor) {
+    return ParallelNDIterableCopy(*source_iterable, *target_iterable,
+                                  target.shape(), *executor, arena);
+  }
   NDIterableCopier copier(*source_iterable, *target_iterable, target.shape(),
                           arena);
   return copier.Copy();
 }
 
+}  // namespace
+
+absl::Status CopyReadChunk(
+    ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
+    const DataTypeConversionLookupResult& chunk_conversion,
+    TransformedArray<void, dynamic_rank, view> target) {
+  return CopyReadChunkImpl(chunk, std::move(chunk_transform), chunk_conversion,
+                           std::move(target), /*executor=*/nullptr);
+}
+
+absl::Status CopyReadChunk(
+    ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
+    const DataTypeConversionLookupResult& chunk_conversion,
+    TransformedArray<void, dynamic_rank, view> target,
+    const Executor& executor) {
+  return CopyReadChunkImpl(chunk, std::move(chunk_transform), chunk_conversion,
+                           std::move(target), &executor);
+}
+
 absl::Status CopyReadChunk(ReadChunk::Impl& chunk,
                            IndexTransform<> chunk_transform,
                            TransformedArray<void, dynamic_rank, view> target) {
@@ -25,6 +25,8 @@
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
 #include "tensorstore/progress.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/read_write_options.h"
@@ -85,16 +87,54 @@ Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
 Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
     DriverHandle source, ReadIntoNewArrayOptions options);
 
+/// Reads data from a TensorStore driver without copying it.
+///
+/// This is useful for populating caches maintained by the driver.  Unlike
+/// `DriverReadIntoNewArray`, no destination array is allocated, and each chunk
+/// is released as soon as it becomes available.
+///
+/// \param source Read source.
+/// \param options Specifies options.
+/// \returns A future that becomes ready when all chunks have been read or an
+///     error occurs.
+/// \error `absl::StatusCode::kInvalidArgument` if the resolved domain of
+///     `source.transform` is not finite.
+Future<void> DriverPrefetch(DriverHandle source, PrefetchOptions options);
+
 /// Copies `chunk` transformed by `chunk_transform` to `target`.
 absl::Status CopyReadChunk(
     ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
     const DataTypeConversionLookupResult& chunk_conversion,
     TransformedArray<void, dynamic_rank, view> target);
 
+/// Same as above, but large chunks are copied by multiple concurrent tasks
+/// submitted to `executor`, as well as by the calling thread.
+///
+/// \param executor Executor for copy tasks, normally the data copy executor
+///     of the driver.  Does not deadlock if `executor` is concurrency-limited
+///     and this is called from one of its tasks.
+absl::Status CopyReadChunk(
+    ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
+    const DataTypeConversionLookupResult& chunk_conversion,
+    TransformedArray<void, dynamic_rank, view> target,
+    const Executor& executor);
+
 absl::Status CopyReadChunk(ReadChunk::Impl& chunk,
                            IndexTransform<> chunk_transform,
                            TransformedArray<void, dynamic_rank, view> target);
 
+/// Returns a new accounting object if `function` is specified, or `nullptr`
+/// otherwise.  Used by `DriverRead` and `DriverWrite`, which attach it to the
+/// span of the operation.
+IntrusivePtr<internal_tracing::IoAccounting> MakeIoAccounting(
+    const IoStatisticsFunction& function);
+
+/// Calls `function` with the statistics accumulated by `io_accounting` once
+/// `future` becomes ready.  Does nothing if `io_accounting` is `nullptr`.
+void ReportIoStatisticsWhenReady(
+    IntrusivePtr<internal_tracing::IoAccounting> io_accounting,
+    IoStatisticsFunction function, const AnyFuture& future);
+
 }  // namespace internal
 }  // namespace tensorstore
 
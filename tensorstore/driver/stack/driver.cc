@@ -18,18 +18,22 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <limits>
+#include <list>
 #include <numeric>
 #include <optional>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/hash/hash.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/box.h"
 #include "tensorstore/context.h"
 #include "tensorstore/data_type.h"
@@ -51,6 +55,7 @@
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/grid_partition.h"
+#include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/irregular_grid.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
@@ -188,6 +193,15 @@ struct CellEq {
   }
 };
 
+/// Returns the C-order linear index of `cell` within a grid of `shape`.
+Index GetLinearCellIndex(span<const Index> shape, span<const Index> cell) {
+  Index linear_index = 0;
+  for (DimensionIndex dim = 0; dim < shape.size(); ++dim) {
+    linear_index = linear_index * shape[dim] + cell[dim];
+  }
+  return linear_index;
+}
+
 // Certain operations are applied to either a sequence of
 // `internal::TransformedDriverSpec` used by the `StackDriverSpec` to represent
 // layers, or to a sequence of `StackLayer` used by the open `StackDriver` to
@@ -400,10 +414,11 @@ class StackDriverSpec
 
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency;
   std::vector<internal::TransformedDriverSpec> layers;
+  size_t open_layer_limit = 0;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     return f(internal::BaseCast<internal::DriverSpec>(x),
-             x.data_copy_concurrency, x.layers);
+             x.data_copy_concurrency, x.layers, x.open_layer_limit);
   };
 
   absl::Status InitializeLayerRankAndDtype() {
@@ -426,6 +441,10 @@ class StackDriverSpec
       jb::Member(DataCopyConcurrencyResource::id,
                  jb::Projection<&StackDriverSpec::data_copy_concurrency>()),
       jb::Member("layers", jb::Projection<&StackDriverSpec::layers>()),
+      jb::Member("open_layer_limit",
+                 jb::Projection<&StackDriverSpec::open_layer_limit>(
+                     jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                         [](auto* obj) { *obj = 0; }))),
       jb::Initialize([](auto* obj) {
         TENSORSTORE_RETURN_IF_ERROR(obj->InitializeLayerRankAndDtype());
         SpecOptions base_options;
@@ -494,10 +513,24 @@ class StackDriver
 
   absl::Status InitializeGridIndices(span<const IndexDomain<>> domains);
 
+  /// Returns the layer that covers the specified grid cell, or `kNoLayer`.
+  size_t GetLayerForCell(span<const Index> grid_cell_indices) const;
+
+  constexpr static size_t kNoLayer = std::numeric_limits<size_t>::max();
+
+  /// Opens the layer `layer_i`, which must not already be open, in `mode`.
+  ///
+  /// Non-transactional opens are retained for reuse by subsequent operations,
+  /// up to `open_layer_limit_` layers at a time, closing the least recently
+  /// used layer when the limit is exceeded.
+  Future<internal::Driver::Handle> OpenLayer(
+      size_t layer_i, ReadWriteMode mode,
+      const internal::OpenTransactionPtr& transaction);
+
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     // Exclude `context_binding_state_` because it is handled specially.
     return f(x.dtype_, x.data_copy_concurrency_, x.layers_, x.dimension_units_,
-             x.layer_domain_);
+             x.layer_domain_, x.open_layer_limit_);
   };
 
   DataType dtype_;
@@ -506,8 +539,26 @@ class StackDriver
   DimensionUnitsVector dimension_units_;
   IndexDomain<> layer_domain_;
   IrregularGrid grid_;
+  size_t open_layer_limit_ = 0;
 
+  // Layer covering each grid cell, indexed by the C-order linear cell index,
+  // or empty if `grid_to_layer_` is used instead.  Used if the number of grid
+  // cells is not too large relative to the number of layers, which avoids
+  // hashing the cell indices for each lookup.
+  std::vector<size_t> dense_grid_to_layer_;
   absl::flat_hash_map<Cell, size_t, CellHash, CellEq> grid_to_layer_;
+
+  // Layers opened by `OpenLayer`, keyed by layer index and mode.
+  using OpenLayerKey = std::pair<size_t, ReadWriteMode>;
+  struct OpenLayerEntry {
+    Future<internal::Driver::Handle> future;
+    std::list<OpenLayerKey>::iterator lru_position;
+  };
+  absl::Mutex open_layers_mutex_;
+  absl::flat_hash_map<OpenLayerKey, OpenLayerEntry> open_layers_
+      ABSL_GUARDED_BY(open_layers_mutex_);
+  // Least recently used first.
+  std::list<OpenLayerKey> open_layers_lru_ ABSL_GUARDED_BY(open_layers_mutex_);
 };
 
 Result<internal::Driver::Handle> MakeStackDriverHandle(
@@ -538,6 +589,7 @@ Future<internal::Driver::Handle> StackDriverSpec::Open(
   auto driver =
       internal::MakeReadWritePtr<StackDriver>(request.read_write_mode);
   driver->data_copy_concurrency_ = data_copy_concurrency;
+  driver->open_layer_limit_ = open_layer_limit;
   const size_t num_layers = layers.size();
   driver->layers_.resize(num_layers);
   for (size_t layer_i = 0; layer_i < num_layers; ++layer_i) {
@@ -572,6 +624,21 @@ absl::Status StackDriver::InitializeGridIndices(
   Index start[kMaxRank];
   Index shape[kMaxRank];
   const DimensionIndex rank = grid_.rank();
+
+  // Use a dense table if there are at most 16 cells per layer (or 64k cells
+  // in total).
+  const Index max_dense_cells =
+      std::max<Index>(Index{1} << 16, 16 * static_cast<Index>(domains.size()));
+  Index num_cells = 1;
+  for (DimensionIndex dim = 0; dim < rank; dim++) {
+    if (internal::MulOverflow(num_cells, grid_.shape()[dim], &num_cells) ||
+        num_cells > max_dense_cells) {
+      num_cells = -1;
+      break;
+    }
+  }
+  if (num_cells >= 0) dense_grid_to_layer_.assign(num_cells, kNoLayer);
+
   for (size_t layer_i = 0; layer_i < domains.size(); layer_i++) {
     auto& d = domains[layer_i];
     for (DimensionIndex dim = 0; dim < rank; dim++) {
@@ -580,16 +647,21 @@ absl::Status StackDriver::InitializeGridIndices(
     }
     // Set the mapping for all irregular grid cell covered by this layer
     // to point to this layer.
-    IterateOverIndexRange<>(BoxView<>(rank, start, shape),
-                            [layer_i, this](span<const Index> key) {
-                              grid_to_layer_[key] = layer_i;
-                            });
+    IterateOverIndexRange<>(
+        BoxView<>(rank, start, shape), [layer_i, this](span<const Index> key) {
+          if (!dense_grid_to_layer_.empty()) {
+            dense_grid_to_layer_[GetLinearCellIndex(grid_.shape(), key)] =
+                layer_i;
+          } else {
+            grid_to_layer_[key] = layer_i;
+          }
+        });
   }
 
 #if !defined(NDEBUG)
   // Log the missing cells.
   IterateOverIndexRange<>(grid_.shape(), [this](span<const Index> key) {
-    if (auto it = grid_to_layer_.find(key); it == grid_to_layer_.end()) {
+    if (GetLayerForCell(key) == kNoLayer) {
       ABSL_LOG(INFO) << "\"stack\" driver missing grid cell: " << key;
     }
   });
@@ -598,10 +670,60 @@ absl::Status StackDriver::InitializeGridIndices(
   return absl::OkStatus();
 }
 
+size_t StackDriver::GetLayerForCell(span<const Index> grid_cell_indices) const {
+  if (!dense_grid_to_layer_.empty()) {
+    // Cells outside the grid are not covered by any layer.
+    for (DimensionIndex dim = 0; dim < grid_.rank(); ++dim) {
+      const Index i = grid_cell_indices[dim];
+      if (i < 0 || i >= grid_.shape()[dim]) return kNoLayer;
+    }
+    return dense_grid_to_layer_[GetLinearCellIndex(grid_.shape(),
+                                                   grid_cell_indices)];
+  }
+  auto it = grid_to_layer_.find(grid_cell_indices);
+  return it == grid_to_layer_.end() ? kNoLayer : it->second;
+}
+
+Future<internal::Driver::Handle> StackDriver::OpenLayer(
+    size_t layer_i, ReadWriteMode mode,
+    const internal::OpenTransactionPtr& transaction) {
+  const auto open = [&] {
+    internal::DriverOpenRequest request;
+    request.transaction = transaction;
+    request.read_write_mode = mode;
+    return internal::OpenDriver(layers_[layer_i].GetTransformedDriverSpec(),
+                                std::move(request));
+  };
+  if (transaction || open_layer_limit_ == 0) return open();
+  const OpenLayerKey key{layer_i, mode};
+  absl::MutexLock lock(&open_layers_mutex_);
+  if (auto it = open_layers_.find(key); it != open_layers_.end()) {
+    auto& entry = it->second;
+    if (!entry.future.ready() || entry.future.result().ok()) {
+      open_layers_lru_.splice(open_layers_lru_.end(), open_layers_lru_,
+                              entry.lru_position);
+      return entry.future;
+    }
+    // Retry failed opens.
+    open_layers_lru_.erase(entry.lru_position);
+    open_layers_.erase(it);
+  }
+  auto future = open();
+  open_layers_.emplace(
+      key, OpenLayerEntry{future, open_layers_lru_.insert(
+                                      open_layers_lru_.end(), key)});
+  while (open_layers_.size() > open_layer_limit_) {
+    open_layers_.erase(open_layers_lru_.front());
+    open_layers_lru_.pop_front();
+  }
+  return future;
+}
+
 Result<TransformedDriverSpec> StackDriver::GetBoundSpec(
     internal::OpenTransactionPtr transaction, IndexTransformView<> transform) {
   auto driver_spec = internal::DriverSpec::Make<StackDriverSpec>();
   driver_spec->data_copy_concurrency = data_copy_concurrency_;
+  driver_spec->open_layer_limit = open_layer_limit_;
   driver_spec->schema.Set(dtype_).IgnoreError();
   driver_spec->schema.Set(RankConstraint{rank()}).IgnoreError();
   // When constructing the bound spec, set the dimension_units_ and
@@ -722,9 +844,8 @@ struct OpenLayerOp {
         dimension_order, self->grid_, state->request.transform,
         [&](span<const Index> grid_cell_indices,
             IndexTransformView<> cell_transform) {
-          auto it = self->grid_to_layer_.find(grid_cell_indices);
-          if (it != self->grid_to_layer_.end()) {
-            const size_t layer_i = it->second;
+          const size_t layer_i = self->GetLayerForCell(grid_cell_indices);
+          if (layer_i != StackDriver::kNoLayer) {
             const auto& layer = self->layers_[layer_i];
             if (layer.driver) {
               // Layer is already open, dispatch operation directly.
@@ -735,7 +856,7 @@ struct OpenLayerOp {
                   tensorstore::MaybeAnnotateStatus(
                       _, absl::StrFormat("Layer %d", layer_i)));
             } else {
-              layers_to_load[it->second].emplace_back(cell_transform);
+              layers_to_load[layer_i].emplace_back(cell_transform);
             }
             return absl::OkStatus();
           } else {
@@ -754,16 +875,12 @@ struct OpenLayerOp {
     // transforms.
     for (auto& kv : layers_to_load) {
       const size_t layer_i = kv.first;
-      const auto& layer = self->layers_[layer_i];
-      internal::DriverOpenRequest request;
-      request.transaction = state->request.transaction;
-      request.read_write_mode = StateType::kMode;
       Link(WithExecutor(
                self->data_copy_executor(),
                AfterOpenOp<StateType>{state, layer_i, std::move(kv.second)}),
            state->promise,
-           internal::OpenDriver(layer.GetTransformedDriverSpec(),
-                                std::move(request)));
+           self->OpenLayer(layer_i, StateType::kMode,
+                           state->request.transaction));
     }
   }
 };
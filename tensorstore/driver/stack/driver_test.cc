@@ -326,6 +326,37 @@ TEST(StackDriverTest, WriteCreate) {
           .result());
 }
 
+TEST(StackDriverTest, OpenLayerLimit) {
+  ::nlohmann::json json_spec{
+      {"driver", "stack"},
+      {"layers", ::nlohmann::json::array_t({GetRank1Length4N5Driver(-3),
+                                            GetRank1Length4N5Driver(0),
+                                            GetRank1Length4N5Driver(3, 6)})},
+      {"open_layer_limit", 1},
+  };
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(json_spec, OpenMode::open_or_create).result());
+
+  TENSORSTORE_EXPECT_OK(
+      tensorstore::Write(
+          tensorstore::MakeOffsetArray({-3}, {9, 8, 7, 6, 5, 4, 3, 2, 1}),
+          store)
+          .result());
+
+  // Reads reuse the most recently opened layer, and reopen evicted layers.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(tensorstore::Read(store).result(),
+                ::testing::Optional(MatchesArray<int32_t>(
+                    span<const Index, 1>({-3}), {9, 8, 7, 6, 5, 4, 3, 2, 1})));
+  }
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, store.spec());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec_json, spec.ToJson());
+  EXPECT_EQ(1, spec_json.value("open_layer_limit", 0));
+}
+
 TEST(StackDriverTest, WriteSparse) {
   ::nlohmann::json json_spec{
       {"driver", "stack"},
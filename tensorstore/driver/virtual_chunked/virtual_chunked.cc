@@ -27,8 +27,12 @@
 
 #include "absl/base/optimization.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_join.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
@@ -56,7 +60,14 @@
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/memory.h"
+#include "tensorstore/internal/rate_limiter/admission_queue.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+#include "tensorstore/internal/riegeli/array_endian_codec.h"
+#include "tensorstore/internal/unaligned_data_type_functions.h"
 #include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/open_options.h"
 #include "tensorstore/rank.h"
@@ -67,6 +78,7 @@
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/byte_strided_pointer.h"
 #include "tensorstore/util/element_pointer.h"
+#include "tensorstore/util/endian.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/garbage_collection.h"
 #include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
@@ -91,6 +103,27 @@ class VirtualChunkedCache : public internal::ConcreteChunkCache {
   template <typename EntryOrNode>
   void DoRead(EntryOrNode& node, AsyncCacheReadRequest request);
 
+  /// Fills `output` with the content of the chunk at `cell_indices`, from
+  /// `persistent_cache_` if possible, and otherwise by calling
+  /// `CallReadFunction`.
+  Future<TimestampedStorageGeneration> ReadChunk(
+      span<const Index> cell_indices, SharedOffsetArray<void> output,
+      ReadParameters read_params);
+
+  /// Fills `output` by calling `CallReadFunction`, and then writes it to
+  /// `persistent_cache_` under `key`.
+  Future<TimestampedStorageGeneration> ComputeAndPersistChunk(
+      std::string key, SharedOffsetArray<void> output,
+      ReadParameters read_params);
+
+  /// Calls `read_function_`, subject to `read_queue_`.
+  Future<TimestampedStorageGeneration> CallReadFunction(
+      Array<void, dynamic_rank, offset_origin> output,
+      ReadParameters read_params);
+
+  /// Returns the `persistent_cache_` key of the chunk at `cell_indices`.
+  std::string GetPersistentCacheKey(span<const Index> cell_indices);
+
   class Entry : public internal::ChunkCache::Entry {
    public:
     using OwningCache = VirtualChunkedCache;
@@ -168,11 +201,198 @@ class VirtualChunkedCache : public internal::ConcreteChunkCache {
 
   WriteFunction write_function_;
 
+  // Maximum number of concurrent calls to `read_function_`, or 0 if unlimited.
+  size_t max_concurrent_reads_ = 0;
+
+  // Queue that enforces `max_concurrent_reads_`, or null if unlimited.
+  std::unique_ptr<internal::AdmissionQueue> read_queue_;
+
+  // Priority hint passed to `read_function_`.
+  int read_priority_ = 0;
+
+  // Kvstore in which chunks computed by `read_function_` are persisted, or
+  // invalid.
+  KvStore persistent_cache_;
+
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency_;
   Context::Resource<internal::CachePoolResource> cache_pool_;
 };
 
+/// Returns a view of `array` with a zero origin that shares ownership of the
+/// data.
+SharedArray<void> GetZeroOriginArray(const SharedOffsetArray<void>& array) {
+  return SharedArray<void>(
+      SharedElementPointer<void>(
+          std::shared_ptr<void>(array.pointer(),
+                                array.byte_strided_origin_pointer().get()),
+          array.dtype()),
+      StridedLayout<>(array.shape(), array.byte_strides()));
+}
+
+Result<absl::Cord> EncodePersistedChunk(SharedArray<const void> array) {
+  absl::Cord encoded;
+  riegeli::CordWriter writer{&encoded};
+  if (!internal::EncodeArrayEndian(std::move(array), endian::little, c_order,
+                                   writer) ||
+      !writer.Close()) {
+    return writer.status();
+  }
+  return encoded;
+}
+
+absl::Status DecodePersistedChunk(const absl::Cord& encoded,
+                                  ArrayView<void> array) {
+  riegeli::CordReader reader{&encoded};
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::DecodeArrayEndian(reader, endian::little, c_order, array));
+  if (!reader.VerifyEndAndClose()) return reader.status();
+  return absl::OkStatus();
+}
+
+/// Call to the read function that is queued by
+/// `VirtualChunkedCache::read_queue_`.
+struct QueuedRead : public internal::RateLimiterNode {
+  VirtualChunkedCache* cache;
+  Array<void, dynamic_rank, offset_origin> output;
+  ReadParameters read_params;
+  Promise<TimestampedStorageGeneration> promise;
+
+  static void Start(void* node) {
+    auto* self =
+        static_cast<QueuedRead*>(static_cast<internal::RateLimiterNode*>(node));
+    self->cache->executor()([self] {
+      auto future = self->cache->read_function_(std::move(self->output),
+                                                std::move(self->read_params));
+      future.Force();
+      future.ExecuteWhenReady(
+          [self](ReadyFuture<TimestampedStorageGeneration> future) {
+            std::unique_ptr<QueuedRead> owned(self);
+            owned->cache->read_queue_->Finish(owned.get());
+            owned->promise.SetResult(future.result());
+          });
+    });
+  }
+};
+
+Future<TimestampedStorageGeneration> VirtualChunkedCache::CallReadFunction(
+    Array<void, dynamic_rank, offset_origin> output,
+    ReadParameters read_params) {
+  if (!read_queue_) {
+    return read_function_(std::move(output), std::move(read_params));
+  }
+  auto pair = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+  auto* queued_read = new QueuedRead;
+  queued_read->cache = this;
+  queued_read->output = std::move(output);
+  queued_read->read_params = std::move(read_params);
+  queued_read->promise = std::move(pair.promise);
+  read_queue_->Admit(queued_read, &QueuedRead::Start);
+  return std::move(pair.future);
+}
+
+std::string VirtualChunkedCache::GetPersistentCacheKey(
+    span<const Index> cell_indices) {
+  const DimensionIndex rank = cell_indices.size();
+  if (rank == 0) return "0";
+  std::vector<Index> external_cell_indices(rank);
+  for (DimensionIndex component_dim = 0; component_dim < rank;
+       ++component_dim) {
+    external_cell_indices[inner_order_[component_dim]] =
+        cell_indices[component_dim];
+  }
+  return absl::StrJoin(external_cell_indices, ".");
+}
+
+Future<TimestampedStorageGeneration> VirtualChunkedCache::ReadChunk(
+    span<const Index> cell_indices, SharedOffsetArray<void> output,
+    ReadParameters read_params) {
+  if (!persistent_cache_.valid()) {
+    return CallReadFunction(std::move(output), std::move(read_params));
+  }
+  kvstore::ReadOptions options;
+  options.generation_conditions.if_not_equal = read_params.if_not_equal();
+  options.staleness_bound = read_params.staleness_bound();
+  std::string key = GetPersistentCacheKey(cell_indices);
+  auto read_future = kvstore::Read(persistent_cache_, key, std::move(options));
+  // The cache remains alive until the returned future becomes ready, since
+  // the entry being read holds a reference to it.
+  return PromiseFuturePair<TimestampedStorageGeneration>::LinkValue(
+             [this, key = std::move(key), output = std::move(output),
+              read_params = std::move(read_params)](
+                 Promise<TimestampedStorageGeneration> promise,
+                 ReadyFuture<kvstore::ReadResult> future) mutable {
+               auto& read_result = future.value();
+               if (read_result.aborted()) {
+                 // Persisted chunk is unchanged.
+                 promise.SetResult(TimestampedStorageGeneration{
+                     StorageGeneration::Unknown(), read_result.stamp.time});
+               } else if (read_result.has_value()) {
+                 TENSORSTORE_RETURN_IF_ERROR(
+                     DecodePersistedChunk(read_result.value,
+                                          GetZeroOriginArray(output)),
+                     static_cast<void>(promise.SetResult(MaybeAnnotateStatus(
+                         _, tensorstore::StrCat(
+                                "Error decoding persisted chunk ",
+                                persistent_cache_.driver->DescribeKey(
+                                    persistent_cache_.path + key))))));
+                 promise.SetResult(std::move(read_result.stamp));
+               } else {
+                 LinkResult(std::move(promise),
+                            ComputeAndPersistChunk(std::move(key),
+                                                   std::move(output),
+                                                   std::move(read_params)));
+               }
+             },
+             std::move(read_future))
+      .future;
+}
+
+Future<TimestampedStorageGeneration>
+VirtualChunkedCache::ComputeAndPersistChunk(std::string key,
+                                            SharedOffsetArray<void> output,
+                                            ReadParameters read_params) {
+  auto compute_future = CallReadFunction(output, std::move(read_params));
+  return PromiseFuturePair<TimestampedStorageGeneration>::LinkValue(
+             [this, key = std::move(key), output = std::move(output)](
+                 Promise<TimestampedStorageGeneration> promise,
+                 ReadyFuture<TimestampedStorageGeneration> future) {
+               const auto& computed_stamp = future.value();
+               if (StorageGeneration::IsUnknown(computed_stamp.generation)) {
+                 promise.SetResult(computed_stamp);
+                 return;
+               }
+               TENSORSTORE_ASSIGN_OR_RETURN(
+                   auto encoded,
+                   EncodePersistedChunk(GetZeroOriginArray(output)),
+                   static_cast<void>(promise.SetResult(_)));
+               kvstore::WriteOptions write_options;
+               write_options.generation_conditions.if_equal =
+                   StorageGeneration::NoValue();
+               LinkValue(
+                   [computed_stamp](
+                       Promise<TimestampedStorageGeneration> promise,
+                       ReadyFuture<TimestampedStorageGeneration> future) {
+                     // If the chunk was concurrently persisted by another
+                     // reader, the computed chunk is used as is; it is
+                     // revalidated against the persisted chunk when next
+                     // read.
+                     const auto& persisted_stamp = future.value();
+                     if (StorageGeneration::IsUnknown(
+                             persisted_stamp.generation)) {
+                       promise.SetResult(computed_stamp);
+                     } else {
+                       promise.SetResult(persisted_stamp);
+                     }
+                   },
+                   std::move(promise),
+                   kvstore::Write(persistent_cache_, key, std::move(encoded),
+                                  std::move(write_options)));
+             },
+             std::move(compute_future))
+      .future;
+}
+
 /// Sets `partial_array` to refer to the portion of `full_array` (translated to
 /// the chunk origin) that is within bounds for the chunk corresponding to
 /// `entry`.  Also permutes the dimensions according to
@@ -258,6 +478,13 @@ void VirtualChunkedCache::DoRead(EntryOrNode& node,
            {StorageGeneration::NoValue(), absl::InfiniteFuture()}});
       return;
     }
+    // `partial_array`, sharing ownership of `full_array`.
+    SharedOffsetArray<void> output(
+        SharedElementPointer<void>(
+            std::shared_ptr<void>(full_array.pointer(),
+                                  const_cast<void*>(partial_array.data())),
+            partial_array.dtype()),
+        partial_array.layout());
     read_data.get()[0] = SharedArrayView<void>(
         std::move(full_array.element_pointer()), component_spec.write_layout());
     ReadParameters read_params;
@@ -267,9 +494,9 @@ void VirtualChunkedCache::DoRead(EntryOrNode& node,
       read_params.if_not_equal_ = lock.stamp().generation;
     }
     read_params.staleness_bound_ = staleness_bound;
-    auto read_future =
-        cache.read_function_(ConstDataTypeCast<void>(std::move(partial_array)),
-                             std::move(read_params));
+    read_params.priority_ = cache.read_priority_;
+    auto read_future = cache.ReadChunk(entry.cell_indices(), std::move(output),
+                                       std::move(read_params));
     read_future.Force();
     read_future.ExecuteWhenReady(
         [&node, read_data = std::move(read_data)](
@@ -395,11 +622,15 @@ class VirtualChunkedDriverSpec
       data_copy_concurrency;
   Context::Resource<internal::CachePoolResource> cache_pool;
   StalenessBound data_staleness;
+  size_t max_concurrent_reads = 0;
+  int read_priority = 0;
+  std::optional<KvStore> persistent_cache;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     return f(internal::BaseCast<internal::DriverSpec>(x), x.read_function,
              x.write_function, x.data_copy_concurrency, x.cache_pool,
-             x.data_staleness);
+             x.data_staleness, x.max_concurrent_reads, x.read_priority,
+             x.persistent_cache);
   };
 
   OpenMode open_mode() const override {
@@ -481,6 +712,11 @@ Result<internal::TransformedDriverSpec> VirtualChunkedDriver::GetBoundSpec(
   driver_spec->data_copy_concurrency = cache.data_copy_concurrency_;
   driver_spec->cache_pool = cache.cache_pool_;
   driver_spec->data_staleness = this->data_staleness_bound();
+  driver_spec->max_concurrent_reads = cache.max_concurrent_reads_;
+  driver_spec->read_priority = cache.read_priority_;
+  if (cache.persistent_cache_.valid()) {
+    driver_spec->persistent_cache = cache.persistent_cache_;
+  }
   const DimensionIndex rank = this->rank();
   TENSORSTORE_RETURN_IF_ERROR(driver_spec->schema.Set(RankConstraint{rank}));
   TENSORSTORE_RETURN_IF_ERROR(driver_spec->schema.Set(dtype()));
@@ -569,6 +805,17 @@ Result<internal::Driver::Handle> VirtualChunkedDriver::OpenFromSpecData(
     return absl::InvalidArgumentError("dtype must be specified");
   }
 
+  if (spec.persistent_cache) {
+    if (spec.write_function) {
+      return absl::InvalidArgumentError(
+          "persistent_cache not supported with a write function");
+    }
+    if (!internal::IsTrivialDataType(dtype)) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "persistent_cache not supported with dtype ", dtype));
+    }
+  }
+
   IndexDomain<> domain = spec.schema.domain();
   if (!domain.valid()) {
     domain = IndexDomain<>(rank);
@@ -680,6 +927,15 @@ Result<internal::Driver::Handle> VirtualChunkedDriver::OpenFromSpecData(
             chunk_template.origin().begin(), chunk_template.origin().end());
         cache->cache_pool_ = spec.cache_pool;
         cache->data_copy_concurrency_ = spec.data_copy_concurrency;
+        cache->max_concurrent_reads_ = spec.max_concurrent_reads;
+        if (spec.max_concurrent_reads > 0) {
+          cache->read_queue_ = std::make_unique<internal::AdmissionQueue>(
+              spec.max_concurrent_reads);
+        }
+        cache->read_priority_ = spec.read_priority;
+        if (spec.persistent_cache) {
+          cache->persistent_cache_ = *spec.persistent_cache;
+        }
         return cache;
       });
   handle.driver = internal::MakeReadWritePtr<VirtualChunkedDriver>(
@@ -728,6 +984,10 @@ Result<internal::Driver::Handle> MakeDriver(
     spec.data_staleness = StalenessBound(options.recheck_cached_data);
   }
 
+  spec.max_concurrent_reads = options.max_concurrent_reads.value;
+  spec.read_priority = options.read_priority.value;
+  spec.persistent_cache = std::move(options.persistent_cache);
+
   return VirtualChunkedDriver::OpenFromSpecData(std::move(options.transaction),
                                                 spec);
 }
@@ -743,6 +1003,8 @@ struct GarbageCollection<virtual_chunked::VirtualChunkedDriver> {
                                                value.cache()->read_function_);
     garbage_collection::GarbageCollectionVisit(visitor,
                                                value.cache()->write_function_);
+    garbage_collection::GarbageCollectionVisit(
+        visitor, value.cache()->persistent_cache_);
   }
 };
 }  // namespace garbage_collection
@@ -15,12 +15,14 @@
 #include "tensorstore/virtual_chunked.h"
 
 #include <memory>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -32,6 +34,9 @@
 #include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/internal/queue_testutil.h"
 #include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/rank.h"
@@ -61,6 +66,7 @@ using ::tensorstore::span;
 using ::tensorstore::StorageGeneration;
 using ::tensorstore::TimestampedStorageGeneration;
 using ::tensorstore::internal::ConcurrentQueue;
+using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::UniqueNow;
 using ::tensorstore::serialization::SerializationRoundTrip;
 
@@ -582,4 +588,97 @@ TEST(VirtualChunkedTest, NonAtomicSingleChunk) {
   TENSORSTORE_ASSERT_OK(future);
 }
 
+TEST(VirtualChunkedTest, MaxConcurrentReads) {
+  ConcurrentQueue<ReadRequest<int, 1>> requests;
+  auto mock_view = MockView<int, 1>(
+      requests, tensorstore::Schema::Shape({4}),
+      tensorstore::ChunkLayout::ChunkShape({1}),
+      tensorstore::virtual_chunked::MaxConcurrentReads{2});
+  auto read_future = tensorstore::Read(mock_view);
+  ReadRequest<int, 1> started[2] = {requests.pop(), requests.pop()};
+  EXPECT_FALSE(requests.pop_nonblock());
+  for (int i = 0; i < 4; ++i) {
+    auto& request = started[i % 2];
+    request.array(request.array.origin()[0]) = i;
+    request.promise.SetResult(TimestampedStorageGeneration(
+        StorageGeneration::FromString(""), absl::Now()));
+    if (i < 2) {
+      // Completing a read admits the next queued read.
+      request = requests.pop();
+      EXPECT_FALSE(requests.pop_nonblock());
+    }
+  }
+  TENSORSTORE_EXPECT_OK(read_future);
+}
+
+TEST(VirtualChunkedTest, ReadPriority) {
+  ConcurrentQueue<ReadRequest<int, 0>> requests;
+  auto mock_view = MockView<int, 0>(
+      requests, tensorstore::virtual_chunked::ReadPriority{5});
+  auto read_future = tensorstore::Read(mock_view);
+  {
+    auto request = requests.pop();
+    EXPECT_EQ(5, request.params.priority());
+    request.array() = 42;
+    request.promise.SetResult(TimestampedStorageGeneration(
+        StorageGeneration::FromString(""), absl::Now()));
+  }
+  EXPECT_THAT(read_future.result(),
+              ::testing::Optional(tensorstore::MakeScalarArray<int>(42)));
+}
+
+TEST(VirtualChunkedTest, PersistentCache) {
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::kvstore::Open("memory://computed/", context).result());
+  ConcurrentQueue<ReadRequest<int, 1>> requests;
+  auto open_view = [&] {
+    return MockView<int, 1>(
+        requests, tensorstore::Schema::Shape({3}),
+        tensorstore::ChunkLayout::ChunkShape({2}), context,
+        tensorstore::virtual_chunked::PersistentCache(store));
+  };
+
+  {
+    auto mock_view = open_view();
+    auto read_future = tensorstore::Read(mock_view);
+    for (int i = 0; i < 2; ++i) {
+      auto request = requests.pop();
+      for (Index j = request.array.origin()[0];
+           j < request.array.origin()[0] + request.array.shape()[0]; ++j) {
+        request.array(j) = static_cast<int>(j + 1);
+      }
+      request.promise.SetResult(TimestampedStorageGeneration(
+          StorageGeneration::FromString(""), absl::Now()));
+    }
+    EXPECT_THAT(read_future.result(),
+                ::testing::Optional(tensorstore::MakeArray<int>({1, 2, 3})));
+  }
+
+  // Only the portion of the last chunk within the domain is persisted.
+  EXPECT_THAT(
+      tensorstore::kvstore::Read(store, "1").result(),
+      MatchesKvsReadResult(absl::Cord(std::string_view("\x03\0\0\0", 4))));
+
+  // A new view reads the persisted chunks without calling the read function.
+  auto mock_view = open_view();
+  EXPECT_THAT(tensorstore::Read(mock_view).result(),
+              ::testing::Optional(tensorstore::MakeArray<int>({1, 2, 3})));
+  EXPECT_FALSE(requests.pop_nonblock());
+}
+
+TEST(VirtualChunkedTest, PersistentCacheWriteNotSupported) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::kvstore::Open("memory://").result());
+  ConcurrentQueue<ReadRequest<int, 0>> read_requests;
+  ConcurrentQueue<WriteRequest<int, 0>> write_requests;
+  EXPECT_THAT(MockView<int, 0>(
+                  read_requests, write_requests,
+                  tensorstore::virtual_chunked::PersistentCache(store)),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "persistent_cache not supported with a write "
+                            "function"));
+}
+
 }  // namespace
@@ -19,15 +19,18 @@
 #include <utility>
 
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/data_type_conversion.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/driver/read.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/internal/deadline.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lock_collection.h"
 #include "tensorstore/internal/nditerable.h"
@@ -36,6 +39,9 @@
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/internal/tagged_ptr.h"
+#include "tensorstore/internal/tracing/access_trace.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
+#include "tensorstore/internal/tracing/trace_span.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/progress.h"
@@ -48,6 +54,7 @@
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/task_priority.h"
 
 namespace tensorstore {
 namespace internal {
@@ -187,9 +194,12 @@ struct WriteChunkOp {
             std::move(source_iterable), target_iterable->dtype(),
             state->data_type_conversion);
 
-        copy_status = NDIterableCopier(*source_iterable, *target_iterable,
-                                       chunk.transform.input_shape(), arena)
-                          .Copy();
+        // Large chunks are split across multiple tasks on the data copy
+        // executor, so that copying a single chunk is not limited to one
+        // thread.
+        copy_status = ParallelNDIterableCopy(
+            *source_iterable, *target_iterable, chunk.transform.input_shape(),
+            state->executor, arena);
 
         auto end_write_result = chunk.impl(
             WriteChunk::EndWrite{}, chunk.transform, copy_status.ok(), arena);
@@ -261,6 +271,9 @@ struct DriverWriteInitiateOp {
         static_cast<void>(promise.SetResult(_)));
     state->commit_state->total_elements =
         target_transform.domain().num_elements();
+    internal_tracing::AddIoAccounting(
+        &internal_tracing::IoAccounting::bytes_requested,
+        state->commit_state->total_elements * state->source.dtype()->size);
     state->copy_promise = std::move(promise);
 
     // Initiate the write on the driver.
@@ -323,9 +336,32 @@ WriteFutures DriverWrite(Executor executor,
 
 WriteFutures DriverWrite(TransformedSharedArray<const void> source,
                          DriverHandle target, WriteOptions options) {
+  auto io_statistics_function = std::move(options.io_statistics_function);
+  auto io_accounting = MakeIoAccounting(io_statistics_function);
+  internal_tracing::TraceSpan span("tensorstore.driver.write", io_accounting);
+  internal_tracing::AccessTraceRecorder access_recorder("write",
+                                                        target.transform);
   auto executor = target.driver->data_copy_executor();
-  return internal::DriverWrite(std::move(executor), std::move(source),
-                               std::move(target), {std::move(options)});
+  internal::ScopedTaskPriority scoped_priority(options.priority);
+  if (options.priority != TaskPriority::kNormal) {
+    executor =
+        internal::WithTaskPriority(std::move(executor), options.priority);
+  }
+  internal::ScopedDeadline scoped_deadline(options.deadline.time);
+  const absl::Time deadline = internal::GetCurrentDeadline();
+  auto futures =
+      internal::DriverWrite(std::move(executor), std::move(source),
+                            std::move(target), {std::move(options)});
+  auto commit_future =
+      internal::WithDeadline(std::move(futures.commit_future), deadline);
+  access_recorder.RecordWhenReady(commit_future);
+  ReportIoStatisticsWhenReady(std::move(io_accounting),
+                              std::move(io_statistics_function),
+                              commit_future);
+  // The span covers the operation through commit.
+  return {internal::WithDeadline(std::move(futures.copy_future), deadline),
+          internal_tracing::EndWhenReady(std::move(span),
+                                         std::move(commit_future))};
 }
 
 }  // namespace internal
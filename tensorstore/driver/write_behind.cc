@@ -0,0 +1,154 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/write_behind.h"
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/cache/writeback_scheduler.h"
+#include "tensorstore/internal/json_binding/absl_time.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvs_backed_chunk_driver {
+
+namespace jb = ::tensorstore::internal_json_binding;
+
+TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
+    WriteBehindOptions,
+    jb::Validate(
+        [](const auto& options, auto* obj) {
+          if (obj->max_delay <= absl::ZeroDuration() ||
+              obj->max_delay == absl::InfiniteDuration()) {
+            return absl::InvalidArgumentError(
+                "\"max_delay\" must be positive and finite");
+          }
+          if (obj->idle_delay <= absl::ZeroDuration()) {
+            return absl::InvalidArgumentError(
+                "\"idle_delay\" must be positive");
+          }
+          return absl::OkStatus();
+        },
+        jb::Object(
+            jb::Member("max_dirty_bytes",
+                       jb::Projection<&WriteBehindOptions::max_dirty_bytes>(
+                           jb::DefaultValue([](auto* obj) {
+                             *obj = WriteBehindOptions{}.max_dirty_bytes;
+                           }))),
+            jb::Member("max_delay",
+                       jb::Projection<&WriteBehindOptions::max_delay>(
+                           jb::DefaultValue([](auto* obj) {
+                             *obj = WriteBehindOptions{}.max_delay;
+                           }))),
+            jb::Member("idle_delay",
+                       jb::Projection<&WriteBehindOptions::idle_delay>(
+                           jb::DefaultValue([](auto* obj) {
+                             *obj = WriteBehindOptions{}.idle_delay;
+                           }))))))
+
+WriteBehindBuffer::~WriteBehindBuffer() {
+  if (group_ != no_transaction) group_.CommitAsync().IgnoreFuture();
+}
+
+internal::OpenTransactionPtr WriteBehindBuffer::AcquireTransaction() {
+  Transaction full_group{no_transaction};
+  Transaction new_group{no_transaction};
+  internal::OpenTransactionPtr transaction;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (group_ != no_transaction) {
+      if (group_.total_bytes() >= options_.max_dirty_bytes) {
+        full_group = std::exchange(group_, Transaction(no_transaction));
+      } else {
+        // Fails if the group was aborted, or its commit has started because
+        // a commit future was forced.
+        transaction = internal::TransactionState::get(group_)->AcquireOpenPtr();
+      }
+    }
+    const absl::Time now = absl::Now();
+    if (!transaction) {
+      group_ = Transaction(isolated);
+      transaction = internal::TransactionState::get(group_)->AcquireOpenPtr();
+      internal::ScheduleAt(
+          now + options_.max_delay, [self = Ptr(this), group = group_]() {
+            self->OnDelayElapsed(group);
+          });
+      if (options_.idle_delay < options_.max_delay) {
+        ScheduleIdleCheck(now + options_.idle_delay);
+      }
+      new_group = group_;
+    }
+    last_write_time_ = now;
+  }
+  if (full_group != no_transaction) full_group.CommitAsync().IgnoreFuture();
+  if (auto* scheduler = this->scheduler()) {
+    if (new_group != no_transaction) scheduler->Register(new_group);
+    // The writes added since the previous call are accounted for only now.
+    scheduler->MaybeCommit();
+  }
+  return transaction;
+}
+
+Future<const void> WriteBehindBuffer::Flush() {
+  Transaction group{no_transaction};
+  {
+    absl::MutexLock lock(&mutex_);
+    group = std::exchange(group_, Transaction(no_transaction));
+  }
+  return group.CommitAsync();
+}
+
+void WriteBehindBuffer::OnDelayElapsed(const Transaction& group) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (group_ == group) group_ = Transaction(no_transaction);
+  }
+  // The group may already have been committed, in which case this has no
+  // effect.
+  group.CommitAsync().IgnoreFuture();
+}
+
+void WriteBehindBuffer::ScheduleIdleCheck(absl::Time time) {
+  internal::ScheduleAt(time, [self = Ptr(this), group = group_]() {
+    self->OnIdleDelayElapsed(group);
+  });
+}
+
+void WriteBehindBuffer::OnIdleDelayElapsed(const Transaction& group) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (group_ != group) return;
+    const absl::Time deadline = last_write_time_ + options_.idle_delay;
+    if (absl::Now() < deadline) {
+      // A write arrived since this check was scheduled.
+      ScheduleIdleCheck(deadline);
+      return;
+    }
+    group_ = Transaction(no_transaction);
+  }
+  group.CommitAsync().IgnoreFuture();
+}
+
+}  // namespace internal_kvs_backed_chunk_driver
+}  // namespace tensorstore
@@ -0,0 +1,147 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_WRITE_BEHIND_H_
+#define TENSORSTORE_DRIVER_WRITE_BEHIND_H_
+
+/// \file
+///
+/// Support for buffering non-transactional writes to a chunk cache in memory
+/// and committing them in groups.
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/writeback_scheduler.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvs_backed_chunk_driver {
+
+/// Limits that determine when a group of buffered writes is committed.
+struct WriteBehindOptions {
+  /// A group is committed once the memory used by its buffered writes reaches
+  /// this limit.
+  size_t max_dirty_bytes = 32 * 1024 * 1024;
+
+  /// A group is committed at most this long after its first write.
+  absl::Duration max_delay = absl::Seconds(1);
+
+  /// A group is committed once this long has elapsed without any new write,
+  /// even if `max_delay` has not yet elapsed.  Infinite by default, meaning
+  /// that groups are committed only based on `max_dirty_bytes` and
+  /// `max_delay`.
+  absl::Duration idle_delay = absl::InfiniteDuration();
+
+  TENSORSTORE_DECLARE_JSON_DEFAULT_BINDER(WriteBehindOptions,
+                                          internal_json_binding::NoOptions,
+                                          IncludeDefaults)
+
+  static constexpr auto ApplyMembers = [](auto& x, auto f) {
+    return f(x.max_dirty_bytes, x.max_delay, x.idle_delay);
+  };
+
+  friend bool operator==(const WriteBehindOptions& a,
+                         const WriteBehindOptions& b) {
+    return a.max_dirty_bytes == b.max_dirty_bytes &&
+           a.max_delay == b.max_delay && a.idle_delay == b.idle_delay;
+  }
+  friend bool operator!=(const WriteBehindOptions& a,
+                         const WriteBehindOptions& b) {
+    return !(a == b);
+  }
+};
+
+/// Groups non-transactional writes into shared `isolated` transactions.
+///
+/// Each write issued without a transaction is added to the current group
+/// rather than to a separate implicit transaction, such that successive
+/// writes to the same chunk are merged in memory and the chunk is written
+/// back once per group.  A group is committed when a write is issued after the
+/// group has reached `WriteBehindOptions::max_dirty_bytes`, when
+/// `WriteBehindOptions::max_delay` has elapsed since the group was started,
+/// when `WriteBehindOptions::idle_delay` has elapsed since its last write, or
+/// when the commit future of any of its writes is forced.  A short
+/// `idle_delay` bounds the latency added to a burst of small writes, while
+/// still merging writes that arrive in quick succession.
+///
+/// The commit future of every write in a group is the future of the group
+/// transaction, and therefore becomes ready once the entire group is durable.
+/// If writeback of any chunk in the group fails, the commit future of every
+/// write in the group reports the error.
+///
+/// If the cache pool specifies limits on buffered writes (see
+/// `internal::WritebackScheduler`), groups are additionally committed as
+/// required to satisfy those limits, which apply jointly to the groups of all
+/// buffers that use the pool.
+class WriteBehindBuffer
+    : public internal::AtomicReferenceCount<WriteBehindBuffer> {
+ public:
+  using Ptr = internal::IntrusivePtr<WriteBehindBuffer>;
+
+  explicit WriteBehindBuffer(const WriteBehindOptions& options,
+                             internal::CachePool::WeakPtr pool = {})
+      : options_(options), pool_(std::move(pool)) {}
+
+  ~WriteBehindBuffer();
+
+  const WriteBehindOptions& options() const { return options_; }
+
+  /// Returns an open pointer to the current group, starting a new group if
+  /// there is none or the current group is full.
+  internal::OpenTransactionPtr AcquireTransaction();
+
+  /// Commits the current group, if any.
+  ///
+  /// \returns A future that becomes ready when the group has been committed,
+  ///     or a ready future if there is no current group.
+  Future<const void> Flush();
+
+ private:
+  /// Commits `group` if it is still the current group.
+  void OnDelayElapsed(const Transaction& group);
+
+  /// Commits `group` if it is still the current group and has not received a
+  /// write within `WriteBehindOptions::idle_delay`, and otherwise schedules
+  /// another check.
+  void OnIdleDelayElapsed(const Transaction& group);
+
+  /// Schedules a call to `OnIdleDelayElapsed` at `time`.
+  void ScheduleIdleCheck(absl::Time time) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Returns the scheduler of the cache pool, if any.
+  internal::WritebackScheduler* scheduler() const {
+    return pool_ ? pool_->writeback_scheduler() : nullptr;
+  }
+
+  WriteBehindOptions options_;
+  internal::CachePool::WeakPtr pool_;
+  absl::Mutex mutex_;
+  Transaction group_ ABSL_GUARDED_BY(mutex_){no_transaction};
+  // Time of the most recent write added to `group_`.
+  absl::Time last_write_time_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_kvs_backed_chunk_driver
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_WRITE_BEHIND_H_
@@ -20,11 +20,13 @@
 #include <cassert>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/no_destructor.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
@@ -36,6 +38,7 @@
 #include "tensorstore/context.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/consolidated_metadata.h"
 #include "tensorstore/driver/kvs_backed_chunk_driver.h"
 #include "tensorstore/driver/registry.h"
 #include "tensorstore/driver/zarr/driver_impl.h"
@@ -50,7 +53,9 @@
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/cache_key/std_optional.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/decoded_value_cache.h"
 #include "tensorstore/internal/grid_storage_statistics.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
@@ -82,6 +87,32 @@ using ::tensorstore::internal_kvs_backed_chunk_driver::KvsDriverSpec;
 
 constexpr const char kDefaultMetadataKey[] = ".zarray";
 
+/// Parses a `.zmetadata` consolidated metadata document, as written by
+/// `zarr.consolidate_metadata`.
+Result<internal_kvs_backed_chunk_driver::ConsolidatedMetadataMap>
+ParseConsolidatedMetadata(const ::nlohmann::json& j) {
+  if (!j.is_object()) {
+    return absl::DataLossError("Expected object");
+  }
+  auto format_it = j.find("zarr_consolidated_format");
+  if (format_it == j.end() || *format_it != 1) {
+    return absl::DataLossError(
+        "Expected \"zarr_consolidated_format\" to be 1");
+  }
+  auto metadata_it = j.find("metadata");
+  if (metadata_it == j.end() || !metadata_it->is_object()) {
+    return absl::DataLossError("Expected \"metadata\" to be an object");
+  }
+  internal_kvs_backed_chunk_driver::ConsolidatedMetadataMap map;
+  for (const auto& [key, value] : metadata_it->items()) {
+    map.emplace(key, value);
+  }
+  return map;
+}
+
+constexpr internal_kvs_backed_chunk_driver::ConsolidatedMetadataFormat
+    kConsolidatedMetadataFormat{"zarr", &ParseConsolidatedMetadata};
+
 inline char GetDimensionSeparatorChar(DimensionSeparator dimension_separator) {
   return dimension_separator == DimensionSeparator::kDotSeparated ? '.' : '/';
 }
@@ -96,16 +127,24 @@ DimensionSeparator GetDimensionSeparator(
   return DimensionSeparator::kDotSeparated;
 }
 
-Result<ZarrMetadataPtr> ParseEncodedMetadata(std::string_view encoded_value) {
-  nlohmann::json raw_data = nlohmann::json::parse(encoded_value, nullptr,
-                                                  /*allow_exceptions=*/false);
-  if (raw_data.is_discarded()) {
-    return absl::FailedPreconditionError("Invalid JSON");
-  }
-  auto metadata = std::make_shared<ZarrMetadata>();
-  TENSORSTORE_ASSIGN_OR_RETURN(*metadata,
-                               ZarrMetadata::FromJson(std::move(raw_data)));
-  return metadata;
+Result<std::shared_ptr<const ZarrMetadata>> ParseEncodedMetadata(
+    std::string_view encoded_value) {
+  // Decoded metadata is immutable, and is shared between repeated opens of the
+  // same array rather than parsed again.
+  static absl::NoDestructor<internal::DecodedValueCache<ZarrMetadata>> cache(
+      /*max_entries=*/64);
+  return cache->GetOrDecode(
+      encoded_value, [&]() -> Result<std::shared_ptr<const ZarrMetadata>> {
+        nlohmann::json raw_data = nlohmann::json::parse(
+            encoded_value, nullptr, /*allow_exceptions=*/false);
+        if (raw_data.is_discarded()) {
+          return absl::FailedPreconditionError("Invalid JSON");
+        }
+        auto metadata = std::make_shared<ZarrMetadata>();
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            *metadata, ZarrMetadata::FromJson(std::move(raw_data)));
+        return metadata;
+      });
 }
 
 }  // namespace
@@ -147,6 +186,9 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
                    jb::Projection<&ZarrDriverSpec::metadata_key>(
                        jb::DefaultValue<jb::kNeverIncludeDefaults>(
                            [](auto* obj) { *obj = kDefaultMetadataKey; }))),
+        jb::Member(
+            "consolidated_metadata_key",
+            jb::Projection<&ZarrDriverSpec::consolidated_metadata_key>()),
         // Deprecated `key_encoding` property.
         jb::LoadSave(jb::OptionalMember(
             "key_encoding",
@@ -349,11 +391,31 @@ Result<absl::Cord> DataCache::EncodeChunk(
   return internal_zarr::EncodeChunk(metadata(), component_arrays);
 }
 
+std::optional<std::string> DataCache::GetDecodeSharingKey() {
+  // Decoding depends only on the metadata, not on the chunk position.
+  std::string key;
+  internal::EncodeCacheKey(&key, std::string_view("zarr"), metadata());
+  return key;
+}
+
 std::string DataCache::GetChunkStorageKey(span<const Index> cell_indices) {
   return tensorstore::StrCat(
       key_prefix_, EncodeChunkIndices(cell_indices, dimension_separator_));
 }
 
+std::optional<DataCache::RawChunkEncoding> DataCache::GetRawChunkEncoding(
+    size_t component_index) {
+  const auto& metadata = this->metadata();
+  if (metadata.compressor) return std::nullopt;
+  const auto& field = metadata.dtype.fields[component_index];
+  const auto& byte_strides =
+      metadata.chunk_layout.fields[component_index]
+          .encoded_chunk_layout.byte_strides();
+  return RawChunkEncoding{field.byte_offset,
+                          {byte_strides.begin(), byte_strides.end()},
+                          field.endian};
+}
+
 absl::Status DataCache::GetBoundSpecData(
     internal_kvs_backed_chunk_driver::KvsDriverSpec& spec_base,
     const void* metadata_ptr, size_t component_index) {
@@ -467,6 +529,22 @@ class ZarrDriver::OpenState : public ZarrDriver::OpenStateBase {
     return std::make_unique<MetadataCache>(std::move(initializer));
   }
 
+  std::string GetMetadataCacheKey() override {
+    std::string result;
+    internal::EncodeCacheKey(&result, spec().consolidated_metadata_key);
+    return result;
+  }
+
+  Result<kvstore::DriverPtr> GetMetadataKeyValueStore(
+      kvstore::DriverPtr base_kv_store) override {
+    const auto& consolidated_metadata_key = spec().consolidated_metadata_key;
+    if (!consolidated_metadata_key) return base_kv_store;
+    return internal_kvs_backed_chunk_driver::
+        GetConsolidatedMetadataKeyValueStore(
+            std::move(base_kv_store), *consolidated_metadata_key,
+            kConsolidatedMetadataFormat, cache_pool()->get(), executor());
+  }
+
   Result<std::shared_ptr<const void>> Create(const void* existing_metadata,
                                              CreateOptions options) override {
     if (existing_metadata) {
@@ -17,6 +17,7 @@
 
 #include <stddef.h>
 
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -63,10 +64,11 @@ class ZarrDriverSpec
   ZarrPartialMetadata partial_metadata;
   SelectedField selected_field;
   std::string metadata_key;
+  std::optional<std::string> consolidated_metadata_key;
 
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
     return f(internal::BaseCast<KvsDriverSpec>(x), x.partial_metadata,
-             x.selected_field, x.metadata_key);
+             x.selected_field, x.metadata_key, x.consolidated_metadata_key);
   };
   absl::Status ApplyOptions(SpecOptions&& options) override;
 
@@ -124,8 +126,13 @@ class DataCache : public internal_kvs_backed_chunk_driver::DataCache {
       span<const Index> chunk_indices,
       span<const SharedArrayView<const void>> component_arrays) override;
 
+  std::optional<std::string> GetDecodeSharingKey() override;
+
   std::string GetChunkStorageKey(span<const Index> cell_indices) override;
 
+  std::optional<RawChunkEncoding> GetRawChunkEncoding(
+      size_t component_index) override;
+
   absl::Status GetBoundSpecData(
       internal_kvs_backed_chunk_driver::KvsDriverSpec& spec_base,
       const void* metadata_ptr, size_t component_index) override;
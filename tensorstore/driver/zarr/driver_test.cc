@@ -28,6 +28,7 @@
 #include "absl/base/optimization.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include <nlohmann/json_fwd.hpp>
@@ -58,10 +59,12 @@
 #include "tensorstore/kvstore/mock_kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
 #include "tensorstore/open.h"
 #include "tensorstore/open_mode.h"
+#include "tensorstore/progress.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/resize_options.h"
 #include "tensorstore/schema.h"
@@ -85,6 +88,8 @@ using ::tensorstore::DimensionIndex;
 using ::tensorstore::DimensionSet;
 using ::tensorstore::dtype_v;
 using ::tensorstore::Index;
+using ::tensorstore::IoStatistics;
+using ::tensorstore::IoStatisticsFunction;
 using ::tensorstore::kImplicit;
 using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
@@ -493,6 +498,34 @@ TEST(ZarrDriverTest, MetadataCache) {
   TENSORSTORE_EXPECT_OK(tensorstore::Open(json_spec, context));
 }
 
+TEST(ZarrDriverTest, MetadataCacheMaxAge) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context,
+      Context::FromJson({{"cache_pool", {{"total_bytes_limit", 1000000}}}}));
+  ::nlohmann::json storage_spec{{"driver", "memory"}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto kvs, kvstore::Open(storage_spec, context).result());
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore", storage_spec},
+      {"path", "prefix/"},
+      {"recheck_cached_metadata", {{"max_age", 3600}}},
+  };
+  EXPECT_THAT(tensorstore::Open(json_spec, context).result(),
+              MatchesStatus(absl::StatusCode::kNotFound));
+
+  TENSORSTORE_EXPECT_OK(kvstore::Write(
+      kvs, "prefix/.zarray", absl::Cord(GetBasicResizeMetadata().dump())));
+
+  // The absence of the metadata is cached.
+  EXPECT_THAT(tensorstore::Open(json_spec, context).result(),
+              MatchesStatus(absl::StatusCode::kNotFound));
+
+  // Revalidating the cached metadata finds the new array.
+  json_spec["recheck_cached_metadata"] = "open";
+  TENSORSTORE_EXPECT_OK(tensorstore::Open(json_spec, context).result());
+}
+
 class MockKeyValueStoreTest : public ::testing::Test {
  protected:
   Context context = Context::Default();
@@ -535,6 +568,526 @@ TEST_F(MockKeyValueStoreTest, CreateMetadataError) {
                             "create error"));
 }
 
+// Tests that reads of missing chunks are resolved from a listing when
+// `chunk_existence_index` is specified.
+TEST_F(MockKeyValueStoreTest, ChunkExistenceIndex) {
+  mock_key_value_store->forward_to = memory_store;
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"metadata",
+       {
+           {"compressor", nullptr},
+           {"dtype", "<i2"},
+           {"shape", {4, 4}},
+           {"chunks", {2, 2}},
+       }},
+      {"chunk_existence_index", true},
+      {"recheck_cached_data", "open"},
+      {"create", true},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(json_spec, context).result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}}),
+      store | tensorstore::AllDims().SizedInterval({0, 0}, {2, 2})));
+
+  mock_key_value_store->log_requests = true;
+  EXPECT_THAT(tensorstore::Read<tensorstore::zero_origin>(store).result(),
+              ::testing::Optional(tensorstore::MakeArray<int16_t>({
+                  {1, 2, 0, 0},
+                  {3, 4, 0, 0},
+                  {0, 0, 0, 0},
+                  {0, 0, 0, 0},
+              })));
+
+  // Only the chunk that exists is read.
+  std::vector<::nlohmann::json> lists, reads;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    if (entry["type"] == "list") lists.push_back(entry);
+    if (entry["type"] == "read" && entry["key"] != "prefix/.zarray") {
+      reads.push_back(entry["key"]);
+    }
+  }
+  EXPECT_THAT(lists, ::testing::SizeIs(1));
+  EXPECT_THAT(reads, ::testing::ElementsAre("prefix/0.0"));
+
+  // The index requires a bounded staleness for data reads.
+  json_spec.erase("recheck_cached_data");
+  json_spec["create"] = false;
+  json_spec["open"] = true;
+  json_spec.erase("metadata");
+  EXPECT_THAT(tensorstore::Open(json_spec, context).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"chunk_existence_index\" requires.*"));
+}
+
+// Tests that chunks evicted from the cache are restored from their retained
+// stored representation when `retain_encoded_chunks` is specified.
+TEST_F(MockKeyValueStoreTest, RetainEncodedChunks) {
+  mock_key_value_store->forward_to = memory_store;
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"metadata",
+       {
+           {"compressor", {{"id", "zlib"}}},
+           {"dtype", "<i2"},
+           {"shape", {2, 2}},
+           {"chunks", {2, 2}},
+       }},
+      {"create", true},
+  };
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}}),
+      tensorstore::Open(json_spec, context).value()));
+
+  json_spec.erase("metadata");
+  json_spec.erase("create");
+  json_spec["open"] = true;
+  json_spec["retain_encoded_chunks"] = true;
+  json_spec["recheck_cached_data"] = "open";
+  // The primary limit is small enough that chunks are evicted as soon as they
+  // are no longer referenced.
+  json_spec["context"] = {
+      {"cache_pool",
+       {{"total_bytes_limit", 1}, {"compressed_bytes_limit", 1000000}}}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(json_spec, context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec_json,
+                                   store.spec().value().ToJson());
+  EXPECT_EQ(true, spec_json["retain_encoded_chunks"]);
+
+  mock_key_value_store->log_requests = true;
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(tensorstore::Read<tensorstore::zero_origin>(store).result(),
+                ::testing::Optional(
+                    tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}})));
+  }
+  // The second read is satisfied from the compressed tier.
+  std::vector<::nlohmann::json> reads;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    if (entry["type"] == "read") reads.push_back(entry["key"]);
+  }
+  EXPECT_THAT(reads, ::testing::ElementsAre("prefix/0.0"));
+}
+
+// Tests that non-transactional writes to the same chunk are merged when
+// `write_behind` is specified.
+TEST_F(MockKeyValueStoreTest, WriteBehind) {
+  mock_key_value_store->forward_to = memory_store;
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"metadata",
+       {
+           {"compressor", nullptr},
+           {"dtype", "<i2"},
+           {"shape", {2, 2}},
+           {"chunks", {2, 2}},
+       }},
+      {"write_behind", {{"max_delay", "1h"}}},
+      {"create", true},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(json_spec, context).result());
+  EXPECT_THAT(store.spec().value().ToJson(),
+              ::testing::Optional(tensorstore::JsonSubValueMatches(
+                  "/write_behind",
+                  ::nlohmann::json{{"max_dirty_bytes", 32 * 1024 * 1024},
+                                   {"max_delay", "1h"},
+                                   {"idle_delay", "inf"}})));
+
+  mock_key_value_store->log_requests = true;
+  auto write1 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(1),
+      store | tensorstore::Dims(0, 1).IndexSlice({0, 0}));
+  auto write2 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(2),
+      store | tensorstore::Dims(0, 1).IndexSlice({1, 1}));
+  TENSORSTORE_ASSERT_OK(write1.copy_future.result());
+  TENSORSTORE_ASSERT_OK(write2.copy_future.result());
+  EXPECT_FALSE(write1.commit_future.ready());
+
+  // Forcing either commit future commits the entire group.
+  TENSORSTORE_ASSERT_OK(write2.commit_future.result());
+  TENSORSTORE_ASSERT_OK(write1.commit_future.result());
+
+  std::vector<::nlohmann::json> writes;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    if (entry["type"] == "write") writes.push_back(entry["key"]);
+  }
+  EXPECT_THAT(writes, ::testing::ElementsAre("prefix/0.0"));
+  EXPECT_THAT(tensorstore::Read<tensorstore::zero_origin>(store).result(),
+              ::testing::Optional(
+                  tensorstore::MakeArray<int16_t>({{1, 0}, {0, 2}})));
+
+  json_spec["write_behind"] = {{"max_delay", "0s"}};
+  EXPECT_THAT(tensorstore::Open(json_spec, context).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"max_delay\" must be positive and finite.*"));
+}
+
+// Tests that a group of buffered writes is committed once `idle_delay` has
+// elapsed without further writes, without waiting for `max_delay`.
+TEST_F(MockKeyValueStoreTest, WriteBehindIdleDelay) {
+  mock_key_value_store->forward_to = memory_store;
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"metadata",
+       {
+           {"compressor", nullptr},
+           {"dtype", "<i2"},
+           {"shape", {2, 2}},
+           {"chunks", {2, 2}},
+       }},
+      {"write_behind", {{"max_delay", "1h"}, {"idle_delay", "500ms"}}},
+      {"create", true},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(json_spec, context).result());
+
+  mock_key_value_store->log_requests = true;
+  auto write1 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(1),
+      store | tensorstore::Dims(0, 1).IndexSlice({0, 0}));
+  auto write2 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(2),
+      store | tensorstore::Dims(0, 1).IndexSlice({1, 1}));
+  TENSORSTORE_ASSERT_OK(write1.copy_future.result());
+  TENSORSTORE_ASSERT_OK(write2.copy_future.result());
+
+  // Wait for the group to be committed without forcing the commit futures.
+  const absl::Time deadline = absl::Now() + absl::Seconds(30);
+  while (!write2.commit_future.ready() && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(5));
+  }
+  ASSERT_TRUE(write2.commit_future.ready());
+  TENSORSTORE_ASSERT_OK(write1.commit_future.result());
+  TENSORSTORE_ASSERT_OK(write2.commit_future.result());
+
+  std::vector<::nlohmann::json> writes;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    if (entry["type"] == "write") writes.push_back(entry["key"]);
+  }
+  EXPECT_THAT(writes, ::testing::ElementsAre("prefix/0.0"));
+
+  json_spec["write_behind"] = {{"idle_delay", "0s"}};
+  EXPECT_THAT(tensorstore::Open(json_spec, context).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"idle_delay\" must be positive.*"));
+}
+
+// Tests that the oldest group of buffered writes is committed once the dirty
+// bytes of all write-behind buffers sharing the cache pool exceed the high
+// watermark.
+TEST_F(MockKeyValueStoreTest, WriteBehindDirtyBytesHighWatermark) {
+  mock_key_value_store->forward_to = memory_store;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto pool_context,
+      Context::FromJson({{"cache_pool", {{"dirty_bytes_high_watermark", 1}}}},
+                        context));
+  std::vector<tensorstore::TensorStore<>> stores;
+  for (const char* path : {"a/", "b/"}) {
+    ::nlohmann::json json_spec{
+        {"driver", "zarr"},
+        {"kvstore",
+         {
+             {"driver", "mock_key_value_store"},
+             {"path", path},
+         }},
+        {"metadata",
+         {
+             {"compressor", nullptr},
+             {"dtype", "<i2"},
+             {"shape", {2, 2}},
+             {"chunks", {2, 2}},
+         }},
+        {"write_behind", {{"max_delay", "1h"}}},
+        {"create", true},
+    };
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto store, tensorstore::Open(json_spec, pool_context).result());
+    stores.push_back(std::move(store));
+  }
+
+  mock_key_value_store->log_requests = true;
+  auto write1 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(1),
+      stores[0] | tensorstore::Dims(0, 1).IndexSlice({0, 0}));
+  TENSORSTORE_ASSERT_OK(write1.copy_future.result());
+  // The first group already exceeds the high watermark, and is committed
+  // when the next write is issued.
+  auto write2 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(2),
+      stores[1] | tensorstore::Dims(0, 1).IndexSlice({1, 1}));
+  TENSORSTORE_ASSERT_OK(write2.copy_future.result());
+
+  // Wait for the first group to be committed without forcing its commit
+  // future.
+  const absl::Time deadline = absl::Now() + absl::Seconds(30);
+  while (!write1.commit_future.ready() && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(5));
+  }
+  ASSERT_TRUE(write1.commit_future.ready());
+  TENSORSTORE_ASSERT_OK(write1.commit_future.result());
+  EXPECT_FALSE(write2.commit_future.ready());
+
+  std::vector<::nlohmann::json> writes;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    if (entry["type"] == "write") writes.push_back(entry["key"]);
+  }
+  EXPECT_THAT(writes, ::testing::ElementsAre("a/0.0"));
+  TENSORSTORE_ASSERT_OK(write2.commit_future.result());
+}
+
+// Tests that partial writes to uncompressed chunks use byte-range writes when
+// supported by the kvstore.
+TEST_F(MockKeyValueStoreTest, ByteRangeWrite) {
+  mock_key_value_store->forward_to = memory_store;
+  mock_key_value_store->supported_features =
+      tensorstore::kvstore::SupportedFeatures::kByteRangeWrite;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(
+          {
+              {"driver", "zarr"},
+              {"kvstore",
+               {
+                   {"driver", "mock_key_value_store"},
+                   {"path", "prefix/"},
+               }},
+              {"metadata",
+               {
+                   {"compressor", nullptr},
+                   {"dtype", "<i2"},
+                   {"shape", {4, 4}},
+                   {"chunks", {2, 2}},
+               }},
+              {"create", true},
+          },
+          context)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}}),
+      store | tensorstore::AllDims().SizedInterval({0, 0}, {2, 2})));
+
+  // A partial write to an existing chunk writes only the modified bytes,
+  // without reading the chunk.
+  mock_key_value_store->log_requests = true;
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(5),
+                         store | tensorstore::Dims(0, 1).IndexSlice({1, 1})));
+  // A partial write to a missing chunk writes the entire chunk.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(6),
+                         store | tensorstore::Dims(0, 1).IndexSlice({3, 3})));
+  std::vector<::nlohmann::json> writes;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    EXPECT_NE("read", entry["type"]);
+    if (entry["type"] == "write") {
+      entry.erase("value");
+      entry.erase("if_equal");
+      writes.push_back(entry);
+    }
+  }
+  EXPECT_THAT(writes,
+              ::testing::ElementsAre(
+                  MatchesJson({{"type", "write"},
+                               {"key", "prefix/0.0"},
+                               {"byte_offset", 6}}),
+                  MatchesJson({{"type", "write"},
+                               {"key", "prefix/1.1"},
+                               {"byte_offset", 6}}),
+                  MatchesJson({{"type", "write"}, {"key", "prefix/1.1"}})));
+
+  EXPECT_THAT(tensorstore::Read<tensorstore::zero_origin>(store).result(),
+              ::testing::Optional(tensorstore::MakeArray<int16_t>({
+                  {1, 2, 0, 0},
+                  {3, 5, 0, 0},
+                  {0, 0, 0, 0},
+                  {0, 0, 0, 6},
+              })));
+}
+
+// Tests that a write recorded in the cache is not written back before an
+// earlier byte-range write of the same chunk completes.
+TEST_F(MockKeyValueStoreTest, ByteRangeWriteOrdering) {
+  mock_key_value_store->forward_to = memory_store;
+  mock_key_value_store->supported_features =
+      tensorstore::kvstore::SupportedFeatures::kByteRangeWrite;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(
+          {
+              {"driver", "zarr"},
+              {"kvstore",
+               {
+                   {"driver", "mock_key_value_store"},
+                   {"path", "prefix/"},
+               }},
+              {"metadata",
+               {
+                   {"compressor", nullptr},
+                   {"dtype", "<i2"},
+                   {"shape", {2, 2}},
+                   {"chunks", {2, 2}},
+               }},
+              {"create", true},
+          },
+          context)
+          .result());
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}}),
+                         store));
+
+  mock_key_value_store->forward_to = {};
+  auto patch =
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(5),
+                         store | tensorstore::Dims(0, 1).IndexSlice({1, 1}));
+  patch.commit_future.Force();
+  auto patch_request = mock_key_value_store->write_requests.pop();
+  EXPECT_EQ(6, patch_request.options.byte_offset);
+
+  auto full = tensorstore::Write(
+      tensorstore::MakeArray<int16_t>({{7, 8}, {9, 10}}), store);
+  full.commit_future.Force();
+  absl::SleepFor(absl::Milliseconds(50));
+  EXPECT_FALSE(mock_key_value_store->write_requests.pop_nonblock());
+
+  patch_request(memory_store);
+  TENSORSTORE_ASSERT_OK(patch.commit_future.result());
+  mock_key_value_store->write_requests.pop()(memory_store);
+  TENSORSTORE_ASSERT_OK(full.commit_future.result());
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto chunk,
+      kvstore::Read(kvstore::KvStore(memory_store), "prefix/0.0").result());
+  EXPECT_EQ(std::string("\x07\x00\x08\x00\x09\x00\x0a\x00", 8),
+            chunk.value);
+}
+
+// Tests that partial writes to uncompressed chunks through an adapter kvstore
+// that does not forward byte-range writes rewrite the entire chunk.
+TEST_F(MockKeyValueStoreTest, ByteRangeWriteThroughKvStack) {
+  mock_key_value_store->forward_to = memory_store;
+  mock_key_value_store->supported_features =
+      tensorstore::kvstore::SupportedFeatures::kByteRangeWrite;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(
+          {
+              {"driver", "zarr"},
+              {"kvstore",
+               {
+                   {"driver", "kvstack"},
+                   {"layers",
+                    ::nlohmann::json::array_t{
+                        {
+                            {"base",
+                             {{"driver", "mock_key_value_store"},
+                              {"path", "prefix/"}}},
+                        },
+                    }},
+               }},
+              {"metadata",
+               {
+                   {"compressor", nullptr},
+                   {"dtype", "<i2"},
+                   {"shape", {4, 4}},
+                   {"chunks", {2, 2}},
+               }},
+              {"create", true},
+          },
+          context)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}}),
+      store | tensorstore::AllDims().SizedInterval({0, 0}, {2, 2})));
+
+  mock_key_value_store->log_requests = true;
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(5),
+                         store | tensorstore::Dims(0, 1).IndexSlice({1, 1})));
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    EXPECT_FALSE(entry.contains("byte_offset")) << entry;
+  }
+
+  // The stored chunk is complete, rather than just the modified element.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto chunk,
+      kvstore::Read(kvstore::KvStore(memory_store), "prefix/0.0").result());
+  EXPECT_EQ(std::string("\x01\x00\x02\x00\x03\x00\x05\x00", 8),
+            chunk.value);
+}
+
+// Tests that sequential reads up to the last chunk of the array do not
+// prefetch chunks outside the array.
+TEST_F(MockKeyValueStoreTest, PrefetchLimitedToArrayShape) {
+  mock_key_value_store->forward_to = memory_store;
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"metadata",
+       {
+           {"compressor", nullptr},
+           {"dtype", "<i2"},
+           {"shape", {6}},
+           {"chunks", {2}},
+       }},
+      {"prefetch", {{"cells", 4}}},
+      {"context", {{"cache_pool", {{"total_bytes_limit", 1000000}}}}},
+      {"create", true},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(json_spec, context).result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<int16_t>({1, 2, 3, 4, 5, 6}), store));
+
+  mock_key_value_store->log_requests = true;
+  for (Index cell = 0; cell < 3; ++cell) {
+    EXPECT_THAT(
+        tensorstore::Read<tensorstore::zero_origin>(
+            store | tensorstore::Dims(0).SizedInterval(cell * 2, 2))
+            .result(),
+        ::testing::Optional(tensorstore::MakeArray<int16_t>(
+            {static_cast<int16_t>(cell * 2 + 1),
+             static_cast<int16_t>(cell * 2 + 2)})));
+  }
+
+  // The reads of chunks 0 and 1 trigger a prefetch of chunk 2, but not of the
+  // chunks beyond the array shape.
+  std::vector<::nlohmann::json> reads;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    if (entry["type"] == "read" && entry["key"] != "prefix/.zarray") {
+      reads.push_back(entry["key"]);
+    }
+  }
+  EXPECT_THAT(reads, ::testing::UnorderedElementsAre("prefix/0", "prefix/1",
+                                                     "prefix/2"));
+}
+
 // Tests concurrently creating a zarr array with `create=true` and `open=false`,
 // using independent cache pools.
 TEST_F(MockKeyValueStoreTest,
@@ -1748,6 +2301,26 @@ TEST(ZarrDriverTest, InvalidResizeDeletedMetadata) {
                     "Metadata was deleted"));
 }
 
+TEST(ZarrDriverTest, PrefetchSpec) {
+  auto json_spec = GetJsonSpec();
+  json_spec["prefetch"] = {{"cells", 4}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(json_spec, tensorstore::OpenMode::create).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, store.spec());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec_json, spec.ToJson());
+  EXPECT_EQ(::nlohmann::json({{"cells", 4}}), spec_json["prefetch"]);
+
+  // The default options are not included.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto default_store,
+      tensorstore::Open(GetJsonSpec(), tensorstore::OpenMode::create).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto default_spec, default_store.spec());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto default_spec_json,
+                                   default_spec.ToJson());
+  EXPECT_FALSE(default_spec_json.contains("prefetch"));
+}
+
 TEST(ZarrDriverTest, InvalidSpecExtraMember) {
   auto spec = GetJsonSpec();
   spec["extra_member"] = 5;
@@ -3396,4 +3969,149 @@ TEST(DriverTest, AssumeCachedMetadataMismatch) {
               MatchesStatus(absl::StatusCode::kFailedPrecondition));
 }
 
+TEST(ZarrDriverTest, ReadReferencingCachedData) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context_spec,
+      Context::Spec::FromJson(
+          {{"cache_pool", {{"total_bytes_limit", 10000000}}}}));
+  Context context(context_spec);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(GetJsonSpec(), context,
+                                    tensorstore::OpenMode::create,
+                                    tensorstore::ReadWriteMode::read_write)
+                      .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}, {5, 6}}),
+      store | tensorstore::AllDims().TranslateSizedInterval({3, 4}, {3, 2})));
+  auto expected = tensorstore::MakeArray<int16_t>({{1, 2}, {3, 4}, {5, 6}});
+
+  // A read of exactly one chunk may reference the cached chunk data.
+  auto chunk = store | tensorstore::AllDims().TranslateSizedInterval(
+                           {3, 4}, {3, 2});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto read1,
+      tensorstore::Read<tensorstore::zero_origin>(
+          chunk, tensorstore::can_reference_cached_data_read_only)
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto read2,
+      tensorstore::Read<tensorstore::zero_origin>(
+          chunk, tensorstore::can_reference_cached_data_read_only)
+          .result());
+  EXPECT_EQ(expected, read1);
+  EXPECT_EQ(expected, read2);
+  EXPECT_EQ(read1.data(), read2.data());
+
+  // Without the option, the result is always a new array.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto read3,
+      tensorstore::Read<tensorstore::zero_origin>(chunk).result());
+  EXPECT_EQ(expected, read3);
+  EXPECT_NE(read1.data(), read3.data());
+
+  // A read spanning multiple chunks is copied into a new array.
+  EXPECT_THAT(
+      tensorstore::Read<tensorstore::zero_origin>(
+          store | tensorstore::AllDims().TranslateSizedInterval({3, 3},
+                                                                {3, 3}),
+          tensorstore::can_reference_cached_data_read_only)
+          .result(),
+      ::testing::Optional(tensorstore::MakeArray<int16_t>(
+          {{0, 1, 2}, {0, 3, 4}, {0, 5, 6}})));
+}
+
+TEST(ZarrDriverTest, ConsolidatedMetadata) {
+  auto context = Context::Default();
+  ::nlohmann::json storage_spec{{"driver", "memory"}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto kvs, kvstore::Open(storage_spec, context).result());
+
+  // Only the consolidated document contains the array metadata.
+  TENSORSTORE_EXPECT_OK(kvstore::Write(
+      kvs, "group/.zmetadata",
+      absl::Cord(::nlohmann::json{
+          {"zarr_consolidated_format", 1},
+          {"metadata",
+           {{".zgroup", {{"zarr_format", 2}}},
+            {"arr/.zarray", GetBasicResizeMetadata()}}},
+      }
+                     .dump())));
+  TENSORSTORE_EXPECT_OK(kvstore::Write(
+      kvs, "group/arr/0.0", absl::Cord(std::string({1, 2, 3, 4, 5, 6}))));
+
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore", storage_spec},
+      {"path", "group/arr/"},
+      {"consolidated_metadata_key", "group/.zmetadata"},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(json_spec, context,
+                                    tensorstore::OpenMode::open,
+                                    tensorstore::ReadWriteMode::read)
+                      .result());
+  EXPECT_THAT(tensorstore::Read(store | tensorstore::Dims(0, 1).SizedInterval(
+                                            {0, 0}, {3, 2}))
+                  .result(),
+              ::testing::Optional(tensorstore::MakeArray<int8_t>(
+                  {{1, 2}, {3, 4}, {5, 6}})));
+
+  // Arrays not listed in the consolidated metadata are missing.
+  json_spec["path"] = "group/other/";
+  EXPECT_THAT(tensorstore::Open(json_spec, context,
+                                tensorstore::OpenMode::open,
+                                tensorstore::ReadWriteMode::read)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kNotFound, ".*"));
+
+  // Creating arrays is not supported.
+  json_spec["metadata"] = GetBasicResizeMetadata();
+  EXPECT_THAT(tensorstore::Open(json_spec, context,
+                                tensorstore::OpenMode::create,
+                                tensorstore::ReadWriteMode::read_write)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            ".*consolidated metadata.*"));
+}
+
+TEST(ZarrDriverTest, IoStatistics) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open({{"driver", "zarr"},
+                         {"kvstore", {{"driver", "memory"}}},
+                         {"metadata",
+                          {{"compressor", nullptr},
+                           {"dtype", "|u1"},
+                           {"shape", {4, 4}},
+                           {"chunks", {2, 2}}}}},
+                        context, tensorstore::OpenMode::create)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<uint8_t>(
+          {{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15, 16}}),
+      store));
+
+  IoStatistics stats;
+  absl::Notification done;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto array,
+      tensorstore::Read(store | tensorstore::Dims(0, 1).SizedInterval(
+                                    {1, 0}, {2, 3}),
+                        IoStatisticsFunction{[&](IoStatistics s) {
+                          stats = s;
+                          done.Notify();
+                        }})
+          .result());
+  EXPECT_EQ(tensorstore::MakeArray<uint8_t>({{5, 6, 7}, {9, 10, 11}}), array);
+  done.WaitForNotification();
+  EXPECT_EQ(6, stats.bytes_requested);
+  EXPECT_EQ(4, stats.chunks_touched);
+  // The default cache pool retains nothing, so every chunk is fetched and
+  // decoded even though only part of it was requested.
+  EXPECT_EQ(16, stats.bytes_fetched);
+  EXPECT_EQ(16, stats.bytes_decoded);
+  EXPECT_EQ(0, stats.bytes_written);
+}
+
 }  // namespace
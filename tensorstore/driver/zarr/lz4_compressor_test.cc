@@ -0,0 +1,92 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/zarr/compressor.h"
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_zarr::Compressor;
+
+// Tests that a small input round trips.
+TEST(Lz4CompressorTest, SmallRoundtrip) {
+  auto compressor =
+      Compressor::FromJson({{"id", "lz4"}, {"acceleration", 2}}).value();
+  const absl::Cord input("The quick brown fox jumped over the lazy dog.");
+  absl::Cord encode_result, decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  TENSORSTORE_ASSERT_OK(compressor->Decode(encode_result, &decode_result, 1));
+  EXPECT_EQ(input, decode_result);
+}
+
+// Tests that the encoding is compatible with `numcodecs.LZ4`, which prefixes
+// the LZ4 block with the uncompressed size.
+TEST(Lz4CompressorTest, NumcodecsFormat) {
+  auto compressor = Compressor::FromJson({{"id", "lz4"}}).value();
+  const absl::Cord input(std::string(1000, 'x'));
+  absl::Cord encode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  EXPECT_EQ(std::string("\xe8\x03\x00\x00", 4),
+            std::string(encode_result.Subcord(0, 4)));
+  EXPECT_LT(encode_result.size(), 100);
+
+  absl::Cord decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Decode(absl::Cord(std::string(
+                                               "\x03\x00\x00\x00\x30"
+                                               "abc",
+                                               8)),
+                                           &decode_result, 1));
+  EXPECT_EQ("abc", decode_result);
+}
+
+TEST(Lz4CompressorTest, DecodeCorrupt) {
+  auto compressor = Compressor::FromJson({{"id", "lz4"}}).value();
+  absl::Cord decode_result;
+  EXPECT_THAT(
+      compressor->Decode(absl::Cord(std::string("\x05\x00\x00\x00\x30"
+                                                "xyz",
+                                                8)),
+                         &decode_result, 1),
+      MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+// Tests that an invalid parameter gives an error.
+TEST(Lz4CompressorTest, InvalidParameter) {
+  EXPECT_THAT(Compressor::FromJson({{"id", "lz4"}, {"acceleration", "6"}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error parsing object member \"acceleration\": .*"));
+  EXPECT_THAT(Compressor::FromJson({{"id", "lz4"}, {"acceleration", 0}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error parsing object member \"acceleration\": .*"));
+  EXPECT_THAT(Compressor::FromJson({{"id", "lz4"}, {"foo", 10}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Object includes extra members: \"foo\""));
+}
+
+TEST(Lz4CompressorTest, ToJson) {
+  auto compressor = Compressor::FromJson({{"id", "lz4"}}).value();
+  EXPECT_EQ(nlohmann::json({{"id", "lz4"}, {"acceleration", 1}}),
+            compressor.ToJson());
+}
+
+}  // namespace
@@ -307,23 +307,22 @@ void ZarrShardedChunkCache::Read(
   ShardedReadOrWrite<internal::ReadChunk,
                      &ZarrArrayToArrayCodec::PreparedState::Read>(
       *this, std::move(request.transform), std::move(receiver),
+      // A single batch is shared by all shards intersected by the request, so
+      // that the shard indices of all of the shards are requested up front,
+      // concurrently, once the partitioning is complete, rather than as
+      // separate round trips per shard.
       [transaction = std::move(request.transaction),
-       batch = std::move(request.batch),
+       shard_batch = request.batch ? std::move(request.batch) : Batch::New(),
        staleness_bound = request.staleness_bound](auto entry) {
-        Batch shard_batch = batch;
-        if (!shard_batch) {
-          shard_batch = Batch::New();
-        }
-        return
-            [=, shard_batch = std::move(shard_batch), entry = std::move(entry)](
-                span<const Index> decoded_shape, IndexTransform<> transform,
-                AnyFlowReceiver<absl::Status, internal::ReadChunk,
-                                IndexTransform<>>&& receiver) {
-              entry->sub_chunk_cache.get()->Read(
-                  {{transaction, std::move(transform), shard_batch},
-                   staleness_bound},
-                  std::move(receiver));
-            };
+        return [=, entry = std::move(entry)](
+                   span<const Index> decoded_shape, IndexTransform<> transform,
+                   AnyFlowReceiver<absl::Status, internal::ReadChunk,
+                                   IndexTransform<>>&& receiver) {
+          entry->sub_chunk_cache.get()->Read(
+              {{transaction, std::move(transform), shard_batch},
+               staleness_bound},
+              std::move(receiver));
+        };
       });
 }
 
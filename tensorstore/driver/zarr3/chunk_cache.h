@@ -37,9 +37,11 @@
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
+#include "tensorstore/internal/chunk_buffer_pool.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
+#include "tensorstore/internal/memory_budget.h"
 #include "tensorstore/internal/storage_statistics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/spec.h"
@@ -66,6 +68,14 @@ class ZarrChunkCache {
   virtual const internal::ChunkGridSpecification& grid() const = 0;
   virtual const Executor& executor() const = 0;
 
+  // See `ChunkCache::memory_budget`.  A top-level cache overrides both.
+  virtual internal::MemoryBudget* memory_budget() const { return nullptr; }
+
+  // See `ChunkCache::chunk_buffer_pool`.  A top-level cache overrides both.
+  virtual internal::ChunkBufferPool* chunk_buffer_pool() const {
+    return nullptr;
+  }
+
   struct ReadRequest : internal::DriverReadRequest {
     absl::Time staleness_bound;
   };
@@ -21,16 +21,19 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include <blosc.h>
-#include "riegeli/base/chain.h"
-#include "riegeli/bytes/chain_reader.h"
+#include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
@@ -38,12 +41,14 @@
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/compression_level_tuner.h"
 #include "tensorstore/driver/zarr3/codec/registry.h"
 #include "tensorstore/internal/compression/blosc.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
@@ -55,22 +60,33 @@ namespace {
 
 // Buffers writes to a `std::string`, and then in `Done`, calls `blosc::Encode`
 // and forwards the result to another `Writer`.
+//
+// If `tuner` is not null, the encoding throughput and compression ratio are
+// recorded to it.
 class BloscDeferredWriter : public riegeli::CordWriter<absl::Cord> {
  public:
   explicit BloscDeferredWriter(blosc::Options options,
+                               std::shared_ptr<CompressionLevelTuner> tuner,
                                riegeli::Writer& base_writer)
       : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
             std::numeric_limits<size_t>::max())),
         options_(std::move(options)),
+        tuner_(std::move(tuner)),
         base_writer_(base_writer) {}
 
   void Done() override {
     CordWriter::Done();
-    auto output = blosc::Encode(dest().Flatten(), options_);
+    const absl::Time start_time = absl::Now();
+    std::string_view input = dest().Flatten();
+    auto output = blosc::Encode(input, options_);
     if (!output.ok()) {
       Fail(std::move(output).status());
       return;
     }
+    if (tuner_) {
+      tuner_->Record(options_.clevel, input.size(), output->size(),
+                     absl::Now() - start_time);
+    }
     auto status = riegeli::Write(*std::move(output), base_writer_);
     if (!status.ok()) {
       Fail(std::move(status));
@@ -80,6 +96,7 @@ class BloscDeferredWriter : public riegeli::CordWriter<absl::Cord> {
 
  private:
   blosc::Options options_;
+  std::shared_ptr<CompressionLevelTuner> tuner_;
   riegeli::Writer& base_writer_;
 };
 
@@ -89,23 +106,26 @@ class BloscCodec : public ZarrBytesToBytesCodec {
    public:
     Result<std::unique_ptr<riegeli::Writer>> GetEncodeWriter(
         riegeli::Writer& encoded_writer) const final {
+      const int clevel =
+          codec_->tuner ? codec_->tuner->GetLevel() : codec_->clevel;
       return std::make_unique<BloscDeferredWriter>(
-          blosc::Options{codec_->cname.c_str(), codec_->clevel, codec_->shuffle,
+          blosc::Options{codec_->cname.c_str(), clevel, codec_->shuffle,
                          codec_->blocksize, codec_->typesize},
-          encoded_writer);
+          codec_->tuner, encoded_writer);
     }
 
     Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
         riegeli::Reader& encoded_reader) const final {
-      auto output = riegeli::ReadAll(
-          encoded_reader,
-          [](absl::string_view input) -> absl::StatusOr<std::string> {
-            auto output = blosc::Decode(input);
-            if (!output.ok()) return std::move(output).status();
-            return *std::move(output);
-          });
-      auto reader = std::make_unique<riegeli::ChainReader<riegeli::Chain>>(
-          output.ok() ? riegeli::Chain(std::move(*output)) : riegeli::Chain());
+      absl::Cord encoded;
+      Result<absl::Cord> output;
+      if (auto status = riegeli::ReadAll(encoded_reader, encoded);
+          status.ok()) {
+        output = blosc::DecodeToCord(std::move(encoded));
+      } else {
+        output = std::move(status);
+      }
+      auto reader = std::make_unique<riegeli::CordReader<absl::Cord>>(
+          output.ok() ? *std::move(output) : absl::Cord());
       if (!output.ok()) {
         reader->Fail(std::move(output).status());
       }
@@ -126,8 +146,12 @@ class BloscCodec : public ZarrBytesToBytesCodec {
   int shuffle;
   size_t typesize;
   size_t blocksize;
+  // Non-null if `clevel` is `kAutoCompressionLevel`.
+  std::shared_ptr<CompressionLevelTuner> tuner;
 };
 
+constexpr auto ClevelBinder() { return CompressionLevelBinder(0, 9); }
+
 constexpr auto ShuffleBinder() {
   namespace jb = ::tensorstore::internal_json_binding;
   return jb::Enum<int, std::string_view>({{BLOSC_NOSHUFFLE, "noshuffle"},
@@ -143,14 +167,16 @@ absl::Status BloscCodecSpec::MergeFrom(const ZarrCodecSpec& other,
   const auto& other_options = static_cast<const Self&>(other).options;
   TENSORSTORE_RETURN_IF_ERROR(
       MergeConstraint<&Options::cname>("cname", options, other_options));
-  TENSORSTORE_RETURN_IF_ERROR(
-      MergeConstraint<&Options::clevel>("clevel", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::clevel>(
+      "clevel", options, other_options, ClevelBinder()));
   TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::shuffle>(
       "shuffle", options, other_options, ShuffleBinder()));
   TENSORSTORE_RETURN_IF_ERROR(
       MergeConstraint<&Options::typesize>("typesize", options, other_options));
   TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::blocksize>(
       "blocksize", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::target_throughput>(
+      "target_throughput", options, other_options));
   return absl::OkStatus();
 }
 
@@ -164,6 +190,17 @@ Result<ZarrBytesToBytesCodec::Ptr> BloscCodecSpec::Resolve(
   auto codec = internal::MakeIntrusivePtr<BloscCodec>();
   codec->cname = options.cname.value_or(BLOSC_LZ4_COMPNAME);
   codec->clevel = options.clevel.value_or(5);
+  std::optional<double> target_throughput;
+  if (codec->clevel == kAutoCompressionLevel) {
+    target_throughput =
+        options.target_throughput.value_or(kDefaultTargetThroughput);
+    codec->tuner = std::make_shared<CompressionLevelTuner>(
+        "blosc", std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9},
+        *target_throughput);
+  } else if (options.target_throughput) {
+    return absl::InvalidArgumentError(
+        "\"target_throughput\" requires a \"clevel\" of \"auto\"");
+  }
   std::optional<int> shuffle = options.shuffle;
   std::optional<size_t> typesize = options.typesize;
   if (shuffle != BLOSC_NOSHUFFLE && !typesize.has_value()) {
@@ -197,6 +234,7 @@ Result<ZarrBytesToBytesCodec::Ptr> BloscCodecSpec::Resolve(
       resolved_options.typesize = codec->typesize;
     }
     resolved_options.blocksize = codec->blocksize;
+    resolved_options.target_throughput = target_throughput;
     *resolved_spec = std::move(spec);
   }
   return codec;
@@ -228,7 +266,7 @@ TENSORSTORE_GLOBAL_INITIALIZER {
                                   OptionalIfConstraintsBinder(CodecBinder()))),
           jb::Member("clevel",
                      jb::Projection<&Options::clevel>(
-                         OptionalIfConstraintsBinder(jb::Integer<int>(0, 9)))),
+                         OptionalIfConstraintsBinder(ClevelBinder()))),
           jb::Member("shuffle",
                      jb::Projection<&Options::shuffle>(
                          OptionalIfConstraintsBinder(ShuffleBinder()))),
@@ -251,7 +289,10 @@ TENSORSTORE_GLOBAL_INITIALIZER {
           jb::Member(
               "blocksize",
               jb::Projection<&Options::blocksize>(OptionalIfConstraintsBinder(
-                  jb::Integer<size_t>(0, BLOSC_MAX_BLOCKSIZE))))
+                  jb::Integer<size_t>(0, BLOSC_MAX_BLOCKSIZE)))),
+          jb::Member("target_throughput",
+                     jb::Projection<&Options::target_throughput>(
+                         jb::Optional(TargetThroughputBinder())))
           //
           )));
 }
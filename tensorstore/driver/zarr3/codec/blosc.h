@@ -37,6 +37,9 @@ class BloscCodecSpec : public ZarrBytesToBytesCodecSpec {
     std::optional<int> shuffle;
     std::optional<size_t> typesize;
     std::optional<size_t> blocksize;
+    /// Target encode throughput in bytes per second, only valid if `clevel` is
+    /// `kAutoCompressionLevel`.
+    std::optional<double> target_throughput;
   };
   BloscCodecSpec() = default;
   BloscCodecSpec(Options&& options) : options(std::move(options)) {}
@@ -60,6 +60,37 @@ TEST(BloscTest, Precise) {
   TestCodecSpecRoundTrip(p);
 }
 
+TEST(BloscTest, AutoLevel) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "blosc"},
+       {"configuration",
+        {
+            {"cname", "lz4"},
+            {"clevel", "auto"},
+            {"shuffle", "noshuffle"},
+            {"target_throughput", 2e8},
+        }}},
+  };
+  p.expected_spec = {GetDefaultBytesCodecJson(),
+                     {{"name", "blosc"},
+                      {"configuration",
+                       {
+                           {"cname", "lz4"},
+                           {"clevel", "auto"},
+                           {"shuffle", "noshuffle"},
+                           {"blocksize", 0},
+                           {"target_throughput", 2e8},
+                       }}}};
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(BloscTest, RoundTripAutoLevel) {
+  CodecRoundTripTestParams p;
+  p.spec = {{{"name", "blosc"}, {"configuration", {{"clevel", "auto"}}}}};
+  TestCodecRoundTrip(p);
+}
+
 TEST(BloscTest, DefaultsUint16) {
   CodecSpecRoundTripTestParams p;
   p.orig_spec = {"blosc"};
@@ -0,0 +1,270 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/zarr3/codec/byte_filters.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "riegeli/base/chain.h"
+#include "riegeli/bytes/chain_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/write.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/internal/compression/byte_filters.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace {
+
+// Applies a filter to `input` with the specified element size.
+using Filter = void (*)(size_t element_size, std::string_view input,
+                        char* output);
+
+// Buffers writes to a `absl::Cord`, and then in `Done`, applies the filter and
+// forwards the result to another `Writer`.
+class ByteFilterDeferredWriter : public riegeli::CordWriter<absl::Cord> {
+ public:
+  explicit ByteFilterDeferredWriter(Filter filter, size_t element_size,
+                                    riegeli::Writer& base_writer)
+      : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
+            std::numeric_limits<size_t>::max())),
+        filter_(filter),
+        element_size_(element_size),
+        base_writer_(base_writer) {}
+
+  void Done() override {
+    CordWriter::Done();
+    std::string_view input = dest().Flatten();
+    std::string output(input.size(), '\0');
+    filter_(element_size_, input, output.data());
+    auto status = riegeli::Write(std::move(output), base_writer_);
+    if (!status.ok()) {
+      Fail(std::move(status));
+      return;
+    }
+  }
+
+ private:
+  Filter filter_;
+  size_t element_size_;
+  riegeli::Writer& base_writer_;
+};
+
+class ByteFilterCodec : public ZarrBytesToBytesCodec {
+ public:
+  explicit ByteFilterCodec(Filter encode, Filter decode, size_t element_size)
+      : encode_(encode), decode_(decode), element_size_(element_size) {}
+
+  class State : public ZarrBytesToBytesCodec::PreparedState {
+   public:
+    Result<std::unique_ptr<riegeli::Writer>> GetEncodeWriter(
+        riegeli::Writer& encoded_writer) const final {
+      return std::make_unique<ByteFilterDeferredWriter>(
+          codec_->encode_, codec_->element_size_, encoded_writer);
+    }
+
+    Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
+        riegeli::Reader& encoded_reader) const final {
+      auto output = riegeli::ReadAll(
+          encoded_reader,
+          [&](absl::string_view input) -> absl::StatusOr<std::string> {
+            std::string output(input.size(), '\0');
+            codec_->decode_(codec_->element_size_, input, output.data());
+            return output;
+          });
+      auto reader = std::make_unique<riegeli::ChainReader<riegeli::Chain>>(
+          output.ok() ? riegeli::Chain(std::move(*output)) : riegeli::Chain());
+      if (!output.ok()) {
+        reader->Fail(std::move(output).status());
+      }
+      return reader;
+    }
+
+    // The filters do not change the size.
+    int64_t encoded_size() const final { return decoded_size_; }
+
+    const ByteFilterCodec* codec_;
+    int64_t decoded_size_;
+  };
+
+  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+    auto state = internal::MakeIntrusivePtr<State>();
+    state->codec_ = this;
+    state->decoded_size_ = decoded_size;
+    return state;
+  }
+
+ private:
+  Filter encode_;
+  Filter decode_;
+  size_t element_size_;
+};
+
+bool IsValidDeltaElementSize(size_t element_size) {
+  return element_size == 1 || element_size == 2 || element_size == 4 ||
+         element_size == 8;
+}
+
+// Returns the element size specified by `options`, or otherwise inferred from
+// `decoded`.
+Result<size_t> ResolveElementSize(std::string_view codec_name,
+                                  const ByteFilterCodecSpec::Options& options,
+                                  const BytesCodecResolveParameters& decoded,
+                                  bool (*is_valid)(size_t) = nullptr) {
+  if (options.elementsize) return *options.elementsize;
+  if (decoded.item_bits > 0 && (decoded.item_bits % 8) == 0 &&
+      (!is_valid || is_valid(decoded.item_bits / 8))) {
+    return decoded.item_bits / 8;
+  }
+  return absl::InvalidArgumentError(absl::StrFormat(
+      "elementsize must be specified explicitly because inferred item size "
+      "%d/8 is not supported by %s codec",
+      decoded.item_bits, codec_name));
+}
+
+// Resolves a byte filter codec.
+//
+// If `encoded_elements` is not `nullptr`, the encoded representation is also a
+// sequence of elements, and `encoded_elements->item_bits` is set accordingly.
+template <typename Spec>
+Result<ZarrBytesToBytesCodec::Ptr> ResolveByteFilter(
+    const Spec& spec, std::string_view codec_name, Filter encode,
+    Filter decode, const BytesCodecResolveParameters& decoded,
+    BytesCodecResolveParameters* encoded_elements,
+    ZarrBytesToBytesCodecSpec::Ptr* resolved_spec,
+    bool (*is_valid)(size_t) = nullptr) {
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      size_t element_size,
+      ResolveElementSize(codec_name, spec.options, decoded, is_valid));
+  if (encoded_elements) {
+    encoded_elements->item_bits = static_cast<int64_t>(element_size) * 8;
+  }
+  if (resolved_spec) {
+    resolved_spec->reset(spec.options.elementsize
+                             ? &spec
+                             : new Spec(ByteFilterCodecSpec::Options{
+                                   element_size}));
+  }
+  return internal::MakeIntrusivePtr<ByteFilterCodec>(encode, decode,
+                                                      element_size);
+}
+
+}  // namespace
+
+absl::Status ByteFilterCodecSpec::MergeFrom(const ZarrCodecSpec& other,
+                                            bool strict) {
+  using Self = ByteFilterCodecSpec;
+  const auto& other_options = static_cast<const Self&>(other).options;
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::elementsize>(
+      "elementsize", options, other_options));
+  return absl::OkStatus();
+}
+
+ZarrCodecSpec::Ptr ShuffleCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<ShuffleCodecSpec>(*this);
+}
+
+Result<ZarrBytesToBytesCodec::Ptr> ShuffleCodecSpec::Resolve(
+    BytesCodecResolveParameters&& decoded, BytesCodecResolveParameters& encoded,
+    ZarrBytesToBytesCodecSpec::Ptr* resolved_spec) const {
+  return ResolveByteFilter(*this, "shuffle", &internal::ByteShuffle,
+                           &internal::ByteUnshuffle, decoded,
+                           /*encoded_elements=*/nullptr, resolved_spec);
+}
+
+ZarrCodecSpec::Ptr BitshuffleCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<BitshuffleCodecSpec>(*this);
+}
+
+Result<ZarrBytesToBytesCodec::Ptr> BitshuffleCodecSpec::Resolve(
+    BytesCodecResolveParameters&& decoded, BytesCodecResolveParameters& encoded,
+    ZarrBytesToBytesCodecSpec::Ptr* resolved_spec) const {
+  return ResolveByteFilter(*this, "bitshuffle", &internal::BitShuffle,
+                           &internal::BitUnshuffle, decoded,
+                           /*encoded_elements=*/nullptr, resolved_spec);
+}
+
+ZarrCodecSpec::Ptr DeltaCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<DeltaCodecSpec>(*this);
+}
+
+Result<ZarrBytesToBytesCodec::Ptr> DeltaCodecSpec::Resolve(
+    BytesCodecResolveParameters&& decoded, BytesCodecResolveParameters& encoded,
+    ZarrBytesToBytesCodecSpec::Ptr* resolved_spec) const {
+  // The differences are still a sequence of elements, which allows e.g. a
+  // subsequent "shuffle" codec to infer the element size.
+  return ResolveByteFilter(*this, "delta", &internal::DeltaEncode,
+                           &internal::DeltaDecode, decoded, &encoded,
+                           resolved_spec, &IsValidDeltaElementSize);
+}
+
+namespace {
+template <typename Self, typename ElementSizeBinder>
+void RegisterByteFilterCodec(std::string_view id,
+                             ElementSizeBinder element_size_binder) {
+  using Options = ByteFilterCodecSpec::Options;
+  namespace jb = ::tensorstore::internal_json_binding;
+  RegisterCodec<Self>(
+      id, jb::Projection<&Self::options>(jb::Sequence(  //
+              jb::Member("elementsize",
+                         jb::Projection<&Options::elementsize>(
+                             OptionalIfConstraintsBinder(element_size_binder)))
+              //
+              )));
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  namespace jb = ::tensorstore::internal_json_binding;
+  RegisterByteFilterCodec<ShuffleCodecSpec>("shuffle",
+                                            jb::Integer<size_t>(1));
+  RegisterByteFilterCodec<BitshuffleCodecSpec>("bitshuffle",
+                                               jb::Integer<size_t>(1));
+  RegisterByteFilterCodec<DeltaCodecSpec>(
+      "delta", jb::Validate(
+                   [](const auto& options, size_t* obj) {
+                     if (!IsValidDeltaElementSize(*obj)) {
+                       return absl::InvalidArgumentError(
+                           "Expected 1, 2, 4, or 8");
+                     }
+                     return absl::OkStatus();
+                   },
+                   jb::Integer<size_t>(1, 8)));
+}
+}  // namespace
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
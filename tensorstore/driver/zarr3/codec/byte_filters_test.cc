@@ -0,0 +1,166 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdint.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::dtype_v;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::TestCodecMerge;
+using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
+using ::tensorstore::internal_zarr3::TestCodecSpecResolve;
+using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+
+TEST(ShuffleTest, ElementSizeInferred) {
+  CodecSpecRoundTripTestParams p;
+  p.resolve_params.dtype = dtype_v<float>;
+  p.orig_spec = {"shuffle", {{"name", "zstd"}, {"configuration", {}}}};
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "shuffle"}, {"configuration", {{"elementsize", 4}}}},
+      {{"name", "zstd"}, {"configuration", {{"level", 1}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(ShuffleTest, ElementSizeExplicit) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "shuffle"}, {"configuration", {{"elementsize", 3}}}},
+  };
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "shuffle"}, {"configuration", {{"elementsize", 3}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(ShuffleTest, ElementSizeNotInferred) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<uint16_t>;
+  p.rank = 1;
+  EXPECT_THAT(
+      TestCodecSpecResolve(::nlohmann::json::array_t{"gzip", "shuffle"}, p),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Error resolving codec spec .*"
+                    "elementsize must be specified explicitly.*"));
+}
+
+TEST(ShuffleTest, InvalidElementSize) {
+  EXPECT_THAT(
+      ZarrCodecChainSpec::FromJson(
+          {{{"name", "shuffle"}, {"configuration", {{"elementsize", 0}}}}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument, ".*\"elementsize\".*"));
+}
+
+TEST(ShuffleTest, MergeElementSizeMismatch) {
+  EXPECT_THAT(
+      TestCodecMerge(
+          {{{"name", "shuffle"}, {"configuration", {{"elementsize", 2}}}}},
+          {{{"name", "shuffle"}, {"configuration", {{"elementsize", 4}}}}},
+          /*strict=*/true),
+      MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                    ".*\"elementsize\".*"));
+}
+
+TEST(ShuffleTest, RoundTrip) {
+  CodecRoundTripTestParams p;
+  p.spec = {"shuffle"};
+  TestCodecRoundTrip(p);
+}
+
+TEST(ShuffleTest, RoundTripFloat32Zstd) {
+  CodecRoundTripTestParams p;
+  p.dtype = dtype_v<float>;
+  p.spec = {"shuffle", "zstd"};
+  TestCodecRoundTrip(p);
+}
+
+TEST(BitshuffleTest, ElementSizeInferred) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {"bitshuffle"};
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "bitshuffle"}, {"configuration", {{"elementsize", 2}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(BitshuffleTest, RoundTrip) {
+  CodecRoundTripTestParams p;
+  p.spec = {"bitshuffle"};
+  TestCodecRoundTrip(p);
+}
+
+TEST(BitshuffleTest, RoundTripUint8) {
+  CodecRoundTripTestParams p;
+  p.dtype = dtype_v<uint8_t>;
+  p.shape = {3, 5, 7};
+  p.spec = {"bitshuffle", "gzip"};
+  TestCodecRoundTrip(p);
+}
+
+TEST(DeltaTest, ElementSizeInferred) {
+  CodecSpecRoundTripTestParams p;
+  p.resolve_params.dtype = dtype_v<int32_t>;
+  p.orig_spec = {"delta", "shuffle"};
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "delta"}, {"configuration", {{"elementsize", 4}}}},
+      {{"name", "shuffle"}, {"configuration", {{"elementsize", 4}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(DeltaTest, UnsupportedInferredElementSize) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<::tensorstore::dtypes::complex128_t>;
+  p.rank = 1;
+  EXPECT_THAT(TestCodecSpecResolve(::nlohmann::json::array_t{"delta"}, p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error resolving codec spec .*"
+                            "inferred item size 128/8 is not supported by "
+                            "delta codec"));
+}
+
+TEST(DeltaTest, InvalidElementSize) {
+  EXPECT_THAT(
+      ZarrCodecChainSpec::FromJson(
+          {{{"name", "delta"}, {"configuration", {{"elementsize", 3}}}}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    ".*\"elementsize\".*Expected 1, 2, 4, or 8"));
+}
+
+TEST(DeltaTest, RoundTrip) {
+  CodecRoundTripTestParams p;
+  p.spec = {"delta", "shuffle", "zstd"};
+  TestCodecRoundTrip(p);
+}
+
+}  // namespace
@@ -25,9 +25,13 @@
 #include "absl/strings/cord.h"
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/reader.h"
 #include "tensorstore/array.h"
 #include "tensorstore/index.h"
+#include "tensorstore/internal/decode_offload.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/riegeli/array_endian_codec.h"
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -54,6 +58,27 @@ int64_t ZarrBytesToBytesCodec::PreparedState::encoded_size() const {
 
 bool ZarrShardingCodec::is_sharding_codec() const { return true; }
 
+namespace {
+
+// Reads the remaining data from `reader` and decodes it using `offload`.
+//
+// Returns a reader of the decoded data, or `nullptr` if `offload` declined,
+// in which case `encoded` holds the data that was read.
+Result<std::unique_ptr<riegeli::Reader>> GetOffloadedDecodeReader(
+    const internal::DecodeOffload& offload, riegeli::Reader& reader,
+    absl::Cord& encoded) {
+  TENSORSTORE_RETURN_IF_ERROR(riegeli::ReadAll(reader, encoded));
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto decoded,
+      internal::DecodeWithOffload(offload, encoded, /*rank=*/1));
+  if (!decoded) return std::unique_ptr<riegeli::Reader>();
+  const size_t size = decoded->num_elements();
+  return std::make_unique<riegeli::CordReader<absl::Cord>>(
+      internal::MakeCordFromSharedPtr(std::move(decoded->pointer()), size));
+}
+
+}  // namespace
+
 absl::Status ZarrCodecChain::PreparedState::EncodeArray(
     SharedArrayView<const void> decoded, riegeli::Writer& writer) const {
   StridedLayout<> encoded_layout_storage;
@@ -111,8 +136,24 @@ Result<SharedArray<const void>> ZarrCodecChain::PreparedState::DecodeArray(
   reader.SetReadAllHint(true);
   riegeli::Reader* outer_reader = &reader;
   for (size_t i = bytes_to_bytes.size(); i--;) {
-    TENSORSTORE_ASSIGN_OR_RETURN(
-        auto new_reader, bytes_to_bytes[i]->GetDecodeReader(*outer_reader));
+    std::unique_ptr<riegeli::Reader> new_reader;
+    if (!bytes_to_bytes_offload.empty() && bytes_to_bytes_offload[i]) {
+      absl::Cord encoded;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          new_reader, GetOffloadedDecodeReader(*bytes_to_bytes_offload[i],
+                                               *outer_reader, encoded));
+      if (!new_reader) {
+        // The offload declined, decode the data that was read on the CPU.
+        readers.push_back(
+            std::make_unique<riegeli::CordReader<absl::Cord>>(
+                std::move(encoded)));
+        outer_reader = readers.back().get();
+      }
+    }
+    if (!new_reader) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          new_reader, bytes_to_bytes[i]->GetDecodeReader(*outer_reader));
+    }
     new_reader->SetReadAllHint(true);
     outer_reader = new_reader.get();
     readers.push_back(std::move(new_reader));
@@ -166,6 +207,7 @@ Result<ZarrCodecChain::PreparedState::Ptr> ZarrCodecChain::Prepare(
     encoded_size = codec_state->encoded_size();
     state->bytes_to_bytes.push_back(std::move(codec_state));
   }
+  state->bytes_to_bytes_offload = bytes_to_bytes_offload;
   state->encoded_size_ = encoded_size;
   return state;
 }
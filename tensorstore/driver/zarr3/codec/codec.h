@@ -59,6 +59,7 @@
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/decode_offload.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
 #include "tensorstore/internal/storage_statistics.h"
@@ -299,6 +300,9 @@ class ZarrCodecChain : public internal::AtomicReferenceCount<ZarrCodecChain> {
     ZarrArrayToBytesCodec::PreparedState::Ptr array_to_bytes;
     std::vector<ZarrBytesToBytesCodec::PreparedState::Ptr> bytes_to_bytes;
 
+    // Same as `ZarrCodecChain::bytes_to_bytes_offload`.
+    std::vector<internal::DecodeOffload::Ptr> bytes_to_bytes_offload;
+
    private:
     friend class ZarrCodecChain;
     int64_t encoded_size_;
@@ -309,6 +313,11 @@ class ZarrCodecChain : public internal::AtomicReferenceCount<ZarrCodecChain> {
   std::vector<ZarrArrayToArrayCodec::Ptr> array_to_array;
   ZarrArrayToBytesCodec::Ptr array_to_bytes;
   std::vector<ZarrBytesToBytesCodec::Ptr> bytes_to_bytes;
+
+  // Offload to use for decoding each of `bytes_to_bytes`, or `nullptr` to
+  // decode on the CPU.  Empty if no offload is used.  See
+  // `internal::GetDecodeOffload`.
+  std::vector<internal::DecodeOffload::Ptr> bytes_to_bytes_offload;
 };
 
 // Special subtype of "array -> bytes" codecs that perform sharding.
@@ -38,6 +38,7 @@
 #include "tensorstore/driver/zarr3/name_configuration_json_binder.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/decode_offload.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
@@ -176,6 +177,18 @@ absl::Status CodecResolveError(const ZarrCodecSpec& codec_spec,
                   "Error ", message, " through ",
                   jb::ToJson(&codec_spec, ZarrCodecJsonBinder).value().dump()));
 }
+
+// Returns the offload to use for decoding `codec_spec`, or `nullptr`.
+internal::DecodeOffload::Ptr GetBytesToBytesDecodeOffload(
+    const ZarrCodecSpec& codec_spec) {
+  auto codec_json = jb::ToJson(&codec_spec, ZarrCodecJsonBinder);
+  if (!codec_json.ok() || !codec_json->is_object()) return {};
+  auto name = codec_json->find("name");
+  if (name == codec_json->end() || !name->is_string()) return {};
+  return internal::GetDecodeOffload(
+      tensorstore::StrCat("zarr3/", name->get<std::string>()),
+      codec_json->value("configuration", ::nlohmann::json::object_t()));
+}
 }  // namespace
 
 size_t ZarrCodecChainSpec::sharding_height() const {
@@ -337,6 +350,18 @@ ZarrCodecChainSpec::Resolve(ArrayCodecResolveParameters&& decoded,
     chain->bytes_to_bytes.push_back(std::move(codec));
   }
 
+  if (internal::HasDecodeOffloadProviders()) {
+    bool has_offload = false;
+    std::vector<internal::DecodeOffload::Ptr> offloads;
+    offloads.reserve(bytes_to_bytes.size());
+    for (const auto& codec_spec : bytes_to_bytes) {
+      auto& offload = offloads.emplace_back(
+          GetBytesToBytesDecodeOffload(*codec_spec));
+      has_offload = has_offload || offload;
+    }
+    if (has_offload) chain->bytes_to_bytes_offload = std::move(offloads);
+  }
+
   encoded = std::move(*bytes_decoded_params);
   return chain;
 }
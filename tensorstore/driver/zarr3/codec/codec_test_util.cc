@@ -14,11 +14,15 @@
 
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
 
+#include <stddef.h>
+
+#include <string>
 #include <utility>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/random/random.h"
+#include "absl/strings/cord.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/array.h"
 #include "tensorstore/array_testutil.h"
@@ -115,6 +119,17 @@ void TestCodecRoundTrip(const CodecRoundTripTestParams& params) {
   EXPECT_THAT(prepared_state->DecodeArray(params.shape, encoded),
               ::testing::Optional(MatchesArrayIdentically(data)))
       << "data=" << data;
+
+  // Values read over HTTP are typically split across many chunks, which must
+  // decode the same as a flat value.
+  constexpr size_t kFragmentSize = 4093;
+  absl::Cord fragmented;
+  for (size_t i = 0; i < encoded.size(); i += kFragmentSize) {
+    fragmented.Append(std::string(encoded.Subcord(i, kFragmentSize)));
+  }
+  EXPECT_THAT(prepared_state->DecodeArray(params.shape, fragmented),
+              ::testing::Optional(MatchesArrayIdentically(data)))
+      << "data=" << data;
 }
 
 Result<::nlohmann::json> TestCodecMerge(::nlohmann::json a, ::nlohmann::json b,
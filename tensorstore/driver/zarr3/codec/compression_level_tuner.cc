@@ -0,0 +1,106 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/zarr3/codec/compression_level_tuner.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/metrics/value.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace {
+
+auto& auto_compression_level =
+    internal_metrics::Value<int64_t, std::string>::New(
+        "/tensorstore/zarr3/codec/auto_compression_level", "codec",
+        "Compression level most recently chosen for the \"auto\" level, by "
+        "codec.");
+
+}  // namespace
+
+CompressionLevelTuner::CompressionLevelTuner(std::string codec_name,
+                                             std::vector<int> levels,
+                                             double target_throughput,
+                                             size_t samples_per_level)
+    : codec_name_(std::move(codec_name)),
+      levels_(std::move(levels)),
+      target_throughput_(target_throughput),
+      samples_per_level_(std::max(size_t(1), samples_per_level)) {
+  assert(!levels_.empty());
+}
+
+int CompressionLevelTuner::GetLevel() const {
+  absl::MutexLock lock(&mutex_);
+  if (chosen_) return *chosen_;
+  return levels_[current_];
+}
+
+std::optional<int> CompressionLevelTuner::chosen_level() const {
+  absl::MutexLock lock(&mutex_);
+  return chosen_;
+}
+
+void CompressionLevelTuner::Record(int level, size_t decoded_size,
+                                   size_t encoded_size,
+                                   absl::Duration elapsed) {
+  absl::MutexLock lock(&mutex_);
+  // Ignore results for levels other than the one being sampled, which can
+  // occur when chunks are encoded concurrently.
+  if (chosen_ || level != levels_[current_] || decoded_size == 0) return;
+  ++sample_.count;
+  sample_.decoded_bytes += decoded_size;
+  sample_.encoded_bytes += encoded_size;
+  sample_.seconds += absl::ToDoubleSeconds(elapsed);
+  if (sample_.count < samples_per_level_) return;
+
+  const double throughput =
+      sample_.seconds > 0 ? sample_.decoded_bytes / sample_.seconds
+                          : std::numeric_limits<double>::infinity();
+  if (throughput < target_throughput_) {
+    Choose(best_.value_or(0));
+    return;
+  }
+  const double ratio =
+      sample_.decoded_bytes / std::max(1.0, sample_.encoded_bytes);
+  if (!best_ || ratio > best_ratio_) {
+    best_ = current_;
+    best_ratio_ = ratio;
+  }
+  if (++current_ == levels_.size()) {
+    Choose(*best_);
+    return;
+  }
+  sample_ = Sample{};
+}
+
+void CompressionLevelTuner::Choose(size_t index) {
+  chosen_ = levels_[index];
+  auto_compression_level.Set(*chosen_, codec_name_);
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
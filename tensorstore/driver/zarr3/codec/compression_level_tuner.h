@@ -0,0 +1,150 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_CODEC_COMPRESSION_LEVEL_TUNER_H_
+#define TENSORSTORE_DRIVER_ZARR3_CODEC_COMPRESSION_LEVEL_TUNER_H_
+
+/// \file
+///
+/// Support for the ``"auto"`` compression level of the zarr3 `zstd` and
+/// `blosc` codecs.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/json_binding/json_binding.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+/// Value of a compression level member of a codec `Options` struct that
+/// indicates the ``"auto"`` level.
+constexpr int kAutoCompressionLevel = std::numeric_limits<int>::min();
+
+/// Default target encode throughput, in bytes per second, for the ``"auto"``
+/// level.
+constexpr double kDefaultTargetThroughput = 100 << 20;
+
+/// Binds an `int` compression level in `[min_level, max_level]`, or
+/// `kAutoCompressionLevel`, which is specified by the JSON string ``"auto"``.
+constexpr auto CompressionLevelBinder(int min_level, int max_level) {
+  namespace jb = ::tensorstore::internal_json_binding;
+  return [=](auto is_loading, const auto& options, auto* obj,
+             ::nlohmann::json* j) -> absl::Status {
+    if constexpr (is_loading) {
+      if (const auto* s = j->template get_ptr<const std::string*>();
+          s && *s == "auto") {
+        *obj = kAutoCompressionLevel;
+        return absl::OkStatus();
+      }
+    } else {
+      if (*obj == kAutoCompressionLevel) {
+        *j = "auto";
+        return absl::OkStatus();
+      }
+    }
+    return jb::Integer<int>(min_level, max_level)(is_loading, options, obj, j);
+  };
+}
+
+/// Binds a positive target throughput in bytes per second.
+constexpr auto TargetThroughputBinder() {
+  namespace jb = ::tensorstore::internal_json_binding;
+  return jb::Validate(
+      [](const auto& options, double* obj) {
+        if (!(*obj > 0)) {
+          return absl::InvalidArgumentError(
+              "Expected positive target throughput");
+        }
+        return absl::OkStatus();
+      },
+      jb::FloatBinder);
+}
+
+/// Chooses a compression level by measuring the encode throughput and
+/// compression ratio of the first chunks that are encoded.
+///
+/// Candidate levels are sampled in increasing order, `samples_per_level`
+/// encoded chunks each.  Sampling stops at the first level whose throughput
+/// falls below `target_throughput`, since higher levels are not expected to be
+/// faster.  Of the sampled levels that meet the target, the one with the best
+/// compression ratio is chosen; if none meet the target, the lowest candidate
+/// level is chosen.  The chosen level is recorded in the
+/// ``/tensorstore/zarr3/codec/auto_compression_level`` metric.
+///
+/// This class is thread-safe.
+class CompressionLevelTuner {
+ public:
+  /// Constructs a tuner.
+  ///
+  /// \param codec_name Codec name, used as the metric field.
+  /// \param levels Candidate levels, in increasing order.  Must be non-empty.
+  /// \param target_throughput Minimum acceptable encode throughput, in bytes of
+  ///     decoded data per second of elapsed time spent encoding a chunk.
+  /// \param samples_per_level Number of chunks to encode at each level.
+  CompressionLevelTuner(std::string codec_name, std::vector<int> levels,
+                        double target_throughput, size_t samples_per_level = 2);
+
+  /// Returns the level to use for the next chunk to encode.
+  int GetLevel() const;
+
+  /// Records the result of encoding a chunk at `level`.
+  void Record(int level, size_t decoded_size, size_t encoded_size,
+              absl::Duration elapsed);
+
+  /// Returns the chosen level, or `std::nullopt` if sampling is still in
+  /// progress.
+  std::optional<int> chosen_level() const;
+
+ private:
+  struct Sample {
+    size_t count = 0;
+    double decoded_bytes = 0;
+    double encoded_bytes = 0;
+    double seconds = 0;
+  };
+
+  void Choose(size_t index) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::string codec_name_;
+  const std::vector<int> levels_;
+  const double target_throughput_;
+  const size_t samples_per_level_;
+
+  mutable absl::Mutex mutex_;
+  // Index into `levels_` of the level currently being sampled.
+  size_t current_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Index into `levels_` of the level with the best compression ratio among
+  // the sampled levels that met the target throughput.
+  std::optional<size_t> best_ ABSL_GUARDED_BY(mutex_);
+  Sample sample_ ABSL_GUARDED_BY(mutex_);
+  double best_ratio_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::optional<int> chosen_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_CODEC_COMPRESSION_LEVEL_TUNER_H_
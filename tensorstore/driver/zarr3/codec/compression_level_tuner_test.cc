@@ -0,0 +1,78 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/zarr3/codec/compression_level_tuner.h"
+
+#include <optional>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/time/time.h"
+
+namespace {
+
+using ::tensorstore::internal_zarr3::CompressionLevelTuner;
+
+// Target throughput of 100 bytes per millisecond.
+constexpr double kTarget = 100e3;
+
+TEST(CompressionLevelTunerTest, ChoosesHighestLevelMeetingTarget) {
+  CompressionLevelTuner tuner("test", {1, 2, 3}, kTarget,
+                              /*samples_per_level=*/2);
+  EXPECT_EQ(1, tuner.GetLevel());
+  tuner.Record(1, 1000, 500, absl::Milliseconds(1));
+  EXPECT_EQ(std::nullopt, tuner.chosen_level());
+  tuner.Record(1, 1000, 500, absl::Milliseconds(1));
+  EXPECT_EQ(2, tuner.GetLevel());
+  // Results for levels that are not being sampled are ignored.
+  tuner.Record(1, 1000, 1000, absl::Seconds(1));
+  tuner.Record(2, 1000, 400, absl::Milliseconds(5));
+  tuner.Record(2, 1000, 400, absl::Milliseconds(5));
+  EXPECT_EQ(3, tuner.GetLevel());
+  // Level 3 is too slow.
+  tuner.Record(3, 1000, 300, absl::Milliseconds(20));
+  tuner.Record(3, 1000, 300, absl::Milliseconds(20));
+  EXPECT_EQ(2, tuner.chosen_level());
+  EXPECT_EQ(2, tuner.GetLevel());
+  // Further results do not change the choice.
+  tuner.Record(2, 1000, 1000, absl::Seconds(1));
+  EXPECT_EQ(2, tuner.GetLevel());
+}
+
+TEST(CompressionLevelTunerTest, AllLevelsMeetTarget) {
+  CompressionLevelTuner tuner("test", {1, 5}, kTarget,
+                              /*samples_per_level=*/1);
+  tuner.Record(1, 1000, 500, absl::Milliseconds(1));
+  tuner.Record(5, 1000, 250, absl::Milliseconds(1));
+  EXPECT_EQ(5, tuner.chosen_level());
+}
+
+TEST(CompressionLevelTunerTest, PrefersBetterRatio) {
+  // Level 5 meets the target but compresses worse than level 1.
+  CompressionLevelTuner tuner("test", {1, 5}, kTarget,
+                              /*samples_per_level=*/1);
+  tuner.Record(1, 1000, 250, absl::Milliseconds(1));
+  tuner.Record(5, 1000, 500, absl::Milliseconds(1));
+  EXPECT_EQ(1, tuner.chosen_level());
+}
+
+TEST(CompressionLevelTunerTest, NoLevelMeetsTarget) {
+  CompressionLevelTuner tuner("test", {3, 5}, kTarget,
+                              /*samples_per_level=*/1);
+  tuner.Record(3, 1000, 500, absl::Seconds(1));
+  EXPECT_EQ(3, tuner.chosen_level());
+}
+
+}  // namespace
@@ -17,15 +17,23 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
 #include <memory>
 #include <optional>
+#include <utility>
 
+#include "absl/crc/crc32c.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/notification.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "riegeli/digests/crc32c_digester.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/parallel.h"
 #include "tensorstore/driver/zarr3/codec/registry.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/integer_overflow.h"
@@ -66,7 +74,7 @@ class DigestCodec : public ZarrBytesToBytesCodec {
     }
 
     Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
-        riegeli::Reader& encoded_reader) const final {
+        riegeli::Reader& encoded_reader) const override {
       std::optional<size_t> limit;
       if (encoded_size_ != -1) limit = encoded_size_ - kChecksumSize;
       return std::make_unique<DigestReader>(&encoded_reader, limit);
@@ -77,15 +85,109 @@ class DigestCodec : public ZarrBytesToBytesCodec {
     int64_t encoded_size_;
   };
 
-  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const override {
     return internal::MakeIntrusivePtr<State>(decoded_size);
   }
 };
 
-using Crc32cCodec =
+// Encoded values of at least this size are verified concurrently with the
+// decoding performed by the subsequent codecs, rather than incrementally as the
+// data is read.  Below this size, the hand-off to another thread costs more
+// than it saves.
+constexpr size_t kConcurrentVerifyMinSize = size_t(1) << 20;
+
+// Reader over the payload of a crc32c-suffixed value whose checksum is
+// computed by `GetCodecExecutor()` while the payload is being read.  The
+// computed checksum is compared to the stored checksum in `Done`.
+class ConcurrentCrc32cVerifyingReader
+    : public riegeli::CordReader<absl::Cord> {
+ public:
+  // `encoded` must include the 4-byte checksum suffix.
+  explicit ConcurrentCrc32cVerifyingReader(const absl::Cord& encoded)
+      : CordReader(encoded.Subcord(0, encoded.size() - sizeof(uint32_t))),
+        stored_digest_(encoded.Subcord(encoded.size() - sizeof(uint32_t),
+                                       sizeof(uint32_t))),
+        computation_(std::make_shared<Computation>()) {
+    computation_->payload = src();
+    GetCodecExecutor()(
+        [computation = computation_] { computation->MaybeRun(); });
+  }
+
+ private:
+  struct Computation {
+    absl::Cord payload;
+    std::atomic<bool> started{false};
+    absl::Notification done;
+    uint32_t digest = 0;
+
+    // Computes the checksum unless another thread has already claimed it.
+    bool MaybeRun() {
+      if (started.exchange(true)) return false;
+      absl::crc32c_t crc{0};
+      for (absl::string_view chunk : payload.Chunks()) {
+        crc = absl::ExtendCrc32c(crc, chunk);
+      }
+      digest = static_cast<uint32_t>(crc);
+      payload.Clear();
+      done.Notify();
+      return true;
+    }
+  };
+
+  void Done() override {
+    CordReader::Done();
+    if (!ok()) return;
+    // If the executor has not yet started the computation, perform it on this
+    // thread instead of waiting.
+    if (!computation_->MaybeRun()) computation_->done.WaitForNotification();
+    riegeli::CordReader<const absl::Cord*> digest_reader(&stored_digest_);
+    auto status = internal::LittleEndianDigestVerifier::VerifyDigest(
+        computation_->digest, digest_reader);
+    if (!status.ok()) {
+      FailWithoutAnnotation(std::move(status));
+    }
+  }
+
+  absl::Cord stored_digest_;
+  std::shared_ptr<Computation> computation_;
+};
+
+using Crc32cCodecBase =
     DigestCodec<riegeli::Crc32cDigester, internal::LittleEndianDigestWriter,
                 internal::LittleEndianDigestVerifier>;
 
+class Crc32cCodec : public Crc32cCodecBase {
+ public:
+  class State : public Crc32cCodecBase::State {
+   public:
+    using Crc32cCodecBase::State::State;
+
+    Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
+        riegeli::Reader& encoded_reader) const final {
+      if (std::optional<size_t> size; encoded_reader.SupportsSize() &&
+                                      (size = encoded_reader.Size()) &&
+                                      *size >= encoded_reader.pos()) {
+        const size_t remaining = *size - encoded_reader.pos();
+        if (remaining >= kConcurrentVerifyMinSize &&
+            (encoded_size_ == -1 ||
+             remaining == static_cast<size_t>(encoded_size_))) {
+          absl::Cord encoded;
+          if (auto status = riegeli::ReadAll(encoded_reader, encoded);
+              !status.ok()) {
+            return status;
+          }
+          return std::make_unique<ConcurrentCrc32cVerifyingReader>(encoded);
+        }
+      }
+      return Crc32cCodecBase::State::GetDecodeReader(encoded_reader);
+    }
+  };
+
+  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+    return internal::MakeIntrusivePtr<State>(decoded_size);
+  }
+};
+
 }  // namespace
 
 absl::Status Crc32cCodecSpec::MergeFrom(const ZarrCodecSpec& other,
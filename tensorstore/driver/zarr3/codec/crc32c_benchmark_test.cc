@@ -0,0 +1,104 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Measures the cost of the zarr3 `crc32c` codec.  The reported throughput of
+// `BM_Decode` with `crc32c` relative to `bytes` alone gives the checksum
+// overhead per GiB of decoded data.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include "absl/crc/crc32c.h"
+#include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+
+std::string MakeInput(size_t size) {
+  std::minstd_rand gen(42);
+  std::string input(size, '\0');
+  for (auto& c : input) c = static_cast<char>(gen());
+  return input;
+}
+
+void BM_ComputeCrc32c(benchmark::State& state) {
+  const std::string input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(absl::ComputeCrc32c(input));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+// Decodes a 1-d `uint8` chunk of `state.range(0)` bytes using the codec chain
+// `codecs`.
+void BM_Decode(benchmark::State& state, ::nlohmann::json codecs) {
+  const Index size = state.range(0);
+  ZarrCodecChainSpec::FromJsonOptions from_json_options{/*.constraints=*/true};
+  auto codec_chain_spec =
+      ZarrCodecChainSpec::FromJson(codecs, from_json_options).value();
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.rank = 1;
+  decoded_params.dtype = tensorstore::dtype_v<uint8_t>;
+  decoded_params.fill_value = tensorstore::AllocateArray(
+      tensorstore::span<const Index>{}, tensorstore::c_order,
+      tensorstore::value_init, decoded_params.dtype);
+  BytesCodecResolveParameters encoded_params;
+  auto codec_chain =
+      codec_chain_spec.Resolve(std::move(decoded_params), encoded_params)
+          .value();
+  const Index shape[] = {size};
+  auto prepared_state = codec_chain->Prepare(shape).value();
+  auto decoded = tensorstore::AllocateArray<uint8_t>(shape);
+  const std::string input = MakeInput(size);
+  memcpy(decoded.data(), input.data(), size);
+  const absl::Cord encoded = prepared_state->EncodeArray(decoded).value();
+  for (auto _ : state) {
+    auto result = prepared_state->DecodeArray(shape, encoded);
+    ABSL_CHECK(result.ok());
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_ComputeCrc32c)->Range(4 << 10, 64 << 20);
+BENCHMARK_CAPTURE(BM_Decode, bytes, ::nlohmann::json{"bytes"})
+    ->Range(4 << 10, 64 << 20);
+BENCHMARK_CAPTURE(BM_Decode, crc32c, ::nlohmann::json{"bytes", "crc32c"})
+    ->Range(4 << 10, 64 << 20);
+BENCHMARK_CAPTURE(BM_Decode, zstd, ::nlohmann::json{"bytes", "zstd"})
+    ->Range(4 << 10, 64 << 20);
+BENCHMARK_CAPTURE(BM_Decode, zstd_crc32c,
+                  ::nlohmann::json{"bytes", "zstd", "crc32c"})
+    ->Range(4 << 10, 64 << 20);
+
+}  // namespace
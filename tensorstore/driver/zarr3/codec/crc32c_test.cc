@@ -0,0 +1,139 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/array_testutil.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/data_type_random_generator.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::AllocateArray;
+using ::tensorstore::c_order;
+using ::tensorstore::dtype_v;
+using ::tensorstore::Index;
+using ::tensorstore::MatchesArrayIdentically;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::span;
+using ::tensorstore::value_init;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChain;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+
+Result<ZarrCodecChain::PreparedState::Ptr> PrepareCodecChain(
+    const ::nlohmann::json& spec, span<const Index> shape) {
+  ZarrCodecChainSpec::FromJsonOptions from_json_options{/*.constraints=*/true};
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto codec_chain_spec,
+      ZarrCodecChainSpec::FromJson(spec, from_json_options));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.rank = shape.size();
+  decoded_params.dtype = dtype_v<uint16_t>;
+  decoded_params.fill_value = AllocateArray(span<const Index>{}, c_order,
+                                            value_init, decoded_params.dtype);
+  BytesCodecResolveParameters encoded_params;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto codec_chain,
+      codec_chain_spec.Resolve(std::move(decoded_params), encoded_params));
+  return codec_chain->Prepare(shape);
+}
+
+// Tests that corrupting the byte at `offset` from the end of the encoded
+// representation is detected.
+void TestCorruptionDetected(const ::nlohmann::json& spec,
+                            std::vector<Index> shape, size_t offset) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto prepared_state,
+                                   PrepareCodecChain(spec, shape));
+  absl::BitGen gen;
+  auto data = tensorstore::internal::MakeRandomArray(
+      gen, shape, dtype_v<uint16_t>, c_order);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   prepared_state->EncodeArray(data));
+  EXPECT_THAT(prepared_state->DecodeArray(shape, encoded),
+              ::testing::Optional(MatchesArrayIdentically(data)));
+  std::string corrupted(encoded);
+  ASSERT_LT(offset, corrupted.size());
+  corrupted[corrupted.size() - 1 - offset] ^= 1;
+  EXPECT_THAT(prepared_state->DecodeArray(shape, absl::Cord(corrupted)),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            ".*Digest mismatch.*"));
+}
+
+TEST(Crc32cTest, RoundTrip) {
+  CodecRoundTripTestParams p;
+  p.spec = {"crc32c"};
+  TestCodecRoundTrip(p);
+}
+
+TEST(Crc32cTest, RoundTripLarge) {
+  // Large values are verified concurrently with decoding.
+  CodecRoundTripTestParams p;
+  p.spec = {"crc32c"};
+  p.shape = {1024, 1024};
+  TestCodecRoundTrip(p);
+}
+
+TEST(Crc32cTest, RoundTripLargeCompressed) {
+  CodecRoundTripTestParams p;
+  p.spec = {"zstd", "crc32c"};
+  p.shape = {1024, 1024};
+  TestCodecRoundTrip(p);
+}
+
+TEST(Crc32cTest, CorruptPayload) {
+  TestCorruptionDetected({"crc32c"}, {30, 40, 50}, /*offset=*/100);
+}
+
+TEST(Crc32cTest, CorruptChecksum) {
+  TestCorruptionDetected({"crc32c"}, {30, 40, 50}, /*offset=*/0);
+}
+
+TEST(Crc32cTest, CorruptPayloadLarge) {
+  TestCorruptionDetected({"crc32c"}, {1024, 1024}, /*offset=*/100);
+}
+
+TEST(Crc32cTest, CorruptChecksumLarge) {
+  TestCorruptionDetected({"crc32c"}, {1024, 1024}, /*offset=*/0);
+}
+
+TEST(Crc32cTest, CorruptPayloadLargeCompressed) {
+  TestCorruptionDetected({"zstd", "crc32c"}, {1024, 1024}, /*offset=*/100);
+}
+
+}  // namespace
@@ -12,16 +12,43 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stdint.h>
+
+#include <atomic>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/decode_offload.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
 
 namespace {
 
+using ::tensorstore::Index;
+using ::tensorstore::Result;
+using ::tensorstore::SharedArray;
+using ::tensorstore::internal::DecodeOffload;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
 using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
 using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
 using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
 
 TEST(GzipTest, EndianInferred) {
   CodecSpecRoundTripTestParams p;
@@ -53,4 +80,83 @@ TEST(GzipTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+// Declines every input, counting the calls.
+class DecliningOffload : public DecodeOffload {
+ public:
+  static inline std::atomic<int> num_calls{0};
+
+  Result<std::optional<SharedArray<const void>>> Decode(
+      const absl::Cord& encoded) const override {
+    ++num_calls;
+    return std::optional<SharedArray<const void>>();
+  }
+};
+
+// Decodes every input to 4 zero bytes.
+class ZeroOffload : public DecodeOffload {
+ public:
+  Result<std::optional<SharedArray<const void>>> Decode(
+      const absl::Cord& encoded) const override {
+    return std::make_optional<SharedArray<const void>>(
+        tensorstore::AllocateArray<uint8_t>({4}, tensorstore::c_order,
+                                            tensorstore::value_init));
+  }
+};
+
+// Offloads gzip level 1 to `DecliningOffload` and level 2 to `ZeroOffload`.
+void RegisterTestOffloads() {
+  static bool registered = [] {
+    tensorstore::internal::RegisterDecodeOffloadProvider(
+        [](std::string_view format,
+           const ::nlohmann::json& options) -> DecodeOffload::Ptr {
+          if (format != "zarr3/gzip") return {};
+          const int level = options.value("level", 0);
+          if (level == 1) {
+            return tensorstore::internal::MakeIntrusivePtr<DecliningOffload>();
+          }
+          if (level == 2) {
+            return tensorstore::internal::MakeIntrusivePtr<ZeroOffload>();
+          }
+          return {};
+        });
+    return true;
+  }();
+  (void)registered;
+}
+
+TEST(GzipTest, DecodeOffloadDeclined) {
+  RegisterTestOffloads();
+  CodecRoundTripTestParams p;
+  p.spec = ::nlohmann::json::array_t{
+      {{"name", "gzip"}, {"configuration", {{"level", 1}}}}};
+  TestCodecRoundTrip(p);
+  EXPECT_GT(DecliningOffload::num_calls, 0);
+}
+
+TEST(GzipTest, DecodeOffloaded) {
+  RegisterTestOffloads();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto codec_chain_spec,
+      ZarrCodecChainSpec::FromJson(::nlohmann::json::array_t{
+          {{"name", "gzip"}, {"configuration", {{"level", 2}}}}}));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.rank = 1;
+  decoded_params.dtype = tensorstore::dtype_v<uint8_t>;
+  decoded_params.fill_value = tensorstore::MakeScalarArray<uint8_t>(0);
+  BytesCodecResolveParameters encoded_params;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto codec_chain,
+      codec_chain_spec.Resolve(std::move(decoded_params), encoded_params));
+  const Index shape[] = {4};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto prepared_state,
+                                   codec_chain->Prepare(shape));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, prepared_state->EncodeArray(
+                        tensorstore::MakeArray<uint8_t>({1, 2, 3, 4})));
+  // The result of the offload is used instead of decoding on the CPU.
+  EXPECT_THAT(prepared_state->DecodeArray(shape, encoded),
+              ::testing::Optional(
+                  tensorstore::MakeArray<uint8_t>({0, 0, 0, 0})));
+}
+
 }  // namespace
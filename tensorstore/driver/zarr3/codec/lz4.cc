@@ -0,0 +1,167 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/zarr3/codec/lz4.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "riegeli/base/chain.h"
+#include "riegeli/bytes/chain_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/write.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/internal/compression/lz4.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace {
+
+constexpr int kDefaultLevel = 0;
+
+// Buffers writes to a `std::string`, and then in `Done`, calls `lz4::Encode`
+// and forwards the result to another `Writer`.
+class Lz4DeferredWriter : public riegeli::CordWriter<absl::Cord> {
+ public:
+  explicit Lz4DeferredWriter(lz4::Options options,
+                             riegeli::Writer& base_writer)
+      : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
+            std::numeric_limits<size_t>::max())),
+        options_(options),
+        base_writer_(base_writer) {}
+
+  void Done() override {
+    CordWriter::Done();
+    auto output = lz4::Encode(dest().Flatten(), options_);
+    if (!output.ok()) {
+      Fail(std::move(output).status());
+      return;
+    }
+    auto status = riegeli::Write(*std::move(output), base_writer_);
+    if (!status.ok()) {
+      Fail(std::move(status));
+      return;
+    }
+  }
+
+ private:
+  lz4::Options options_;
+  riegeli::Writer& base_writer_;
+};
+
+class Lz4Codec : public ZarrBytesToBytesCodec {
+ public:
+  explicit Lz4Codec(int level) : level_(level) {}
+
+  class State : public ZarrBytesToBytesCodec::PreparedState {
+   public:
+    Result<std::unique_ptr<riegeli::Writer>> GetEncodeWriter(
+        riegeli::Writer& encoded_writer) const final {
+      return std::make_unique<Lz4DeferredWriter>(lz4::Options{codec_->level_},
+                                                 encoded_writer);
+    }
+
+    Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
+        riegeli::Reader& encoded_reader) const final {
+      auto output = riegeli::ReadAll(
+          encoded_reader,
+          [](absl::string_view input) -> absl::StatusOr<std::string> {
+            auto output = lz4::Decode(input);
+            if (!output.ok()) return std::move(output).status();
+            return *std::move(output);
+          });
+      auto reader = std::make_unique<riegeli::ChainReader<riegeli::Chain>>(
+          output.ok() ? riegeli::Chain(std::move(*output)) : riegeli::Chain());
+      if (!output.ok()) {
+        reader->Fail(std::move(output).status());
+      }
+      return reader;
+    }
+
+    const Lz4Codec* codec_;
+  };
+
+  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+    auto state = internal::MakeIntrusivePtr<State>();
+    state->codec_ = this;
+    return state;
+  }
+
+ private:
+  int level_;
+};
+
+}  // namespace
+
+absl::Status Lz4CodecSpec::MergeFrom(const ZarrCodecSpec& other, bool strict) {
+  using Self = Lz4CodecSpec;
+  const auto& other_options = static_cast<const Self&>(other).options;
+  TENSORSTORE_RETURN_IF_ERROR(
+      MergeConstraint<&Options::level>("level", options, other_options));
+  return absl::OkStatus();
+}
+
+ZarrCodecSpec::Ptr Lz4CodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<Lz4CodecSpec>(*this);
+}
+
+Result<ZarrBytesToBytesCodec::Ptr> Lz4CodecSpec::Resolve(
+    BytesCodecResolveParameters&& decoded, BytesCodecResolveParameters& encoded,
+    ZarrBytesToBytesCodecSpec::Ptr* resolved_spec) const {
+  auto resolved_level = options.level.value_or(kDefaultLevel);
+  if (resolved_spec) {
+    resolved_spec->reset(
+        options.level ? this : new Lz4CodecSpec(Options{resolved_level}));
+  }
+  return internal::MakeIntrusivePtr<Lz4Codec>(resolved_level);
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  using Self = Lz4CodecSpec;
+  using Options = Self::Options;
+  namespace jb = ::tensorstore::internal_json_binding;
+  RegisterCodec<Self>(
+      "lz4",
+      jb::Projection<&Self::options>(jb::Sequence(  //
+          jb::Member("level",
+                     jb::Projection<&Options::level>(
+                         OptionalIfConstraintsBinder(jb::Integer<int>(
+                             lz4::Options::kMinCompressionLevel,
+                             lz4::Options::kMaxCompressionLevel))))
+          //
+          )));
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
@@ -0,0 +1,372 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/packbits.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string_view>
+
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dimension_permutation.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/enum.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/util/int4.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace internal_packbits {
+
+int GetPackedBits(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::bool_t:
+      return 1;
+    case DataTypeId::int4_t:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+// The bool kernels process 8 elements at a time using 64-bit arithmetic.
+void PackBool(const unsigned char* source, size_t count, unsigned char* dest) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    // Byte `k` of `x` is 0 or 1; the multiplication moves it to bit `56 + k`
+    // without carries.
+    const uint64_t x = absl::little_endian::Load64(source + i);
+    *dest++ = static_cast<unsigned char>((x * 0x0102040810204080) >> 56);
+  }
+  if (i == count) return;
+  unsigned char last = 0;
+  for (int k = 0; i < count; ++i, ++k) {
+    last |= (source[i] & 1) << k;
+  }
+  *dest = last;
+}
+
+void UnpackBool(const unsigned char* source, size_t count,
+                unsigned char* dest) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    // Broadcast the byte, select bit `k` in byte `k`, and then map each
+    // non-zero byte to 1.
+    const uint64_t x =
+        (*source++ * uint64_t{0x0101010101010101}) & 0x8040201008040201;
+    absl::little_endian::Store64(
+        dest + i, ((x + 0x7f7f7f7f7f7f7f7f) >> 7) & 0x0101010101010101);
+  }
+  for (int k = 0; i < count; ++i, ++k) {
+    dest[i] = (*source >> k) & 1;
+  }
+}
+
+void PackInt4(const unsigned char* source, size_t count, unsigned char* dest) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    *dest++ = static_cast<unsigned char>((source[i] & 0x0f) |
+                                         (source[i + 1] << 4));
+  }
+  if (i != count) {
+    *dest = source[i] & 0x0f;
+  }
+}
+
+void UnpackInt4(const unsigned char* source, size_t count,
+                unsigned char* dest) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const unsigned char x = *source++;
+    dest[i] = internal::SignedTrunc4(x);
+    dest[i + 1] = static_cast<int8_t>(x) >> 4;
+  }
+  if (i != count) {
+    dest[i] = internal::SignedTrunc4(*source);
+  }
+}
+
+}  // namespace internal_packbits
+
+namespace {
+
+using PaddingEncoding = PackBitsCodecSpec::PaddingEncoding;
+
+absl::Status InvalidDataTypeError(DataType dtype) {
+  return absl::InvalidArgumentError(tensorstore::StrCat(
+      "Data type ", dtype, " not compatible with \"packbits\" codec"));
+}
+
+class PackBitsCodec : public ZarrArrayToBytesCodec {
+ public:
+  explicit PackBitsCodec(DataType decoded_dtype,
+                         PaddingEncoding padding_encoding)
+      : dtype_(decoded_dtype), padding_encoding_(padding_encoding) {}
+
+  Result<PreparedState::Ptr> Prepare(
+      span<const Index> decoded_shape) const final;
+
+ private:
+  DataType dtype_;
+  PaddingEncoding padding_encoding_;
+};
+}  // namespace
+
+absl::Status PackBitsCodecSpec::GetDecodedChunkLayout(
+    const ArrayDataTypeAndShapeInfo& array_info,
+    ArrayCodecChunkLayoutInfo& decoded) const {
+  if (array_info.dtype.valid() &&
+      internal_packbits::GetPackedBits(array_info.dtype) == 0) {
+    return InvalidDataTypeError(array_info.dtype);
+  }
+  const DimensionIndex rank = array_info.rank;
+  if (rank != dynamic_rank) {
+    auto& inner_order = decoded.inner_order.emplace();
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      inner_order[i] = i;
+    }
+  }
+
+  if (array_info.shape) {
+    auto& shape = *array_info.shape;
+    auto& read_chunk_shape = decoded.read_chunk_shape.emplace();
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      read_chunk_shape[i] = shape[i];
+    }
+  }
+  // `decoded.codec_chunk_shape` is unspecified.
+  return absl::OkStatus();
+}
+
+bool PackBitsCodecSpec::SupportsInnerOrder(
+    const ArrayCodecResolveParameters& decoded,
+    span<DimensionIndex> preferred_inner_order) const {
+  if (!decoded.inner_order) return true;
+  if (PermutationMatchesOrder(span(decoded.inner_order->data(), decoded.rank),
+                              c_order)) {
+    return true;
+  }
+  SetPermutation(c_order, preferred_inner_order);
+  return false;
+}
+
+Result<ZarrArrayToBytesCodec::Ptr> PackBitsCodecSpec::Resolve(
+    ArrayCodecResolveParameters&& decoded, BytesCodecResolveParameters& encoded,
+    ZarrArrayToBytesCodecSpec::Ptr* resolved_spec) const {
+  assert(decoded.dtype.valid());
+  const int bits = internal_packbits::GetPackedBits(decoded.dtype);
+  if (bits == 0) {
+    return InvalidDataTypeError(decoded.dtype);
+  }
+  encoded.item_bits = bits;
+  DimensionIndex rank = decoded.rank;
+  if (decoded.codec_chunk_shape) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "\"packbits\" codec does not support codec_chunk_shape (",
+        span<const Index>(decoded.codec_chunk_shape->data(), rank),
+        " was specified"));
+  }
+  if (decoded.inner_order) {
+    auto& decoded_inner_order = *decoded.inner_order;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      if (decoded_inner_order[i] != i) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "\"packbits\" codec does not support inner_order of ",
+            span<const DimensionIndex>(decoded_inner_order.data(), rank)));
+      }
+    }
+  }
+  const PaddingEncoding padding_encoding =
+      options.padding_encoding.value_or(PaddingEncoding::kNone);
+  if (resolved_spec) {
+    resolved_spec->reset(new PackBitsCodecSpec(Options{padding_encoding}));
+  }
+  return internal::MakeIntrusivePtr<PackBitsCodec>(decoded.dtype,
+                                                   padding_encoding);
+}
+
+namespace {
+namespace jb = ::tensorstore::internal_json_binding;
+constexpr auto PaddingEncodingBinder() {
+  return jb::Enum<PaddingEncoding, std::string_view>({
+      {PaddingEncoding::kNone, "none"},
+      {PaddingEncoding::kFirstByte, "first_byte"},
+      {PaddingEncoding::kLastByte, "last_byte"},
+  });
+}
+}  // namespace
+
+absl::Status PackBitsCodecSpec::MergeFrom(const ZarrCodecSpec& other,
+                                          bool strict) {
+  using Self = PackBitsCodecSpec;
+  const auto& other_options = static_cast<const Self&>(other).options;
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::padding_encoding>(
+      "padding_encoding", options, other_options, PaddingEncodingBinder()));
+  return absl::OkStatus();
+}
+
+ZarrCodecSpec::Ptr PackBitsCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<PackBitsCodecSpec>(*this);
+}
+
+namespace {
+class PackBitsCodecPreparedState
+    : public ZarrArrayToBytesCodec::PreparedState {
+ public:
+  int64_t encoded_size() const final { return encoded_size_; }
+
+  absl::Status EncodeArray(SharedArrayView<const void> decoded,
+                           riegeli::Writer& writer) const final {
+    SharedArray<void> copy;
+    if (!IsContiguousLayout(decoded, c_order)) {
+      copy = MakeCopy(decoded, c_order);
+      decoded = copy;
+    }
+    const auto* source = static_cast<const unsigned char*>(decoded.data());
+    if (padding_encoding_ == PaddingEncoding::kFirstByte &&
+        !writer.WriteByte(padding_bits_)) {
+      return writer.status();
+    }
+    if (!writer.Push(packed_bytes_)) return writer.status();
+    auto* dest = reinterpret_cast<unsigned char*>(writer.cursor());
+    if (bits_ == 1) {
+      internal_packbits::PackBool(source, num_elements_, dest);
+    } else {
+      internal_packbits::PackInt4(source, num_elements_, dest);
+    }
+    writer.move_cursor(packed_bytes_);
+    if (padding_encoding_ == PaddingEncoding::kLastByte &&
+        !writer.WriteByte(padding_bits_)) {
+      return writer.status();
+    }
+    return absl::OkStatus();
+  }
+
+  Result<SharedArray<const void>> DecodeArray(
+      span<const Index> decoded_shape, riegeli::Reader& reader) const final {
+    auto decoded =
+        AllocateArray(decoded_shape, c_order, default_init, dtype_);
+    if (padding_encoding_ == PaddingEncoding::kFirstByte) {
+      TENSORSTORE_RETURN_IF_ERROR(ReadPaddingByte(reader));
+    }
+    if (!reader.Pull(packed_bytes_)) {
+      return reader.ok() ? absl::DataLossError(tensorstore::StrCat(
+                               "Expected ", encoded_size_, " bytes"))
+                         : reader.status();
+    }
+    const auto* source =
+        reinterpret_cast<const unsigned char*>(reader.cursor());
+    auto* dest = static_cast<unsigned char*>(decoded.data());
+    if (bits_ == 1) {
+      internal_packbits::UnpackBool(source, num_elements_, dest);
+    } else {
+      internal_packbits::UnpackInt4(source, num_elements_, dest);
+    }
+    reader.move_cursor(packed_bytes_);
+    if (padding_encoding_ == PaddingEncoding::kLastByte) {
+      TENSORSTORE_RETURN_IF_ERROR(ReadPaddingByte(reader));
+    }
+    if (!reader.VerifyEnd()) return reader.status();
+    return decoded;
+  }
+
+  absl::Status ReadPaddingByte(riegeli::Reader& reader) const {
+    uint8_t padding_bits;
+    if (!reader.ReadByte(padding_bits)) {
+      return reader.ok() ? absl::DataLossError(tensorstore::StrCat(
+                               "Expected ", encoded_size_, " bytes"))
+                         : reader.status();
+    }
+    if (padding_bits != padding_bits_) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Expected padding of ", padding_bits_, " bits, but received ",
+          padding_bits));
+    }
+    return absl::OkStatus();
+  }
+
+  DataType dtype_;
+  PaddingEncoding padding_encoding_;
+  int bits_;
+  size_t num_elements_;
+  size_t packed_bytes_;
+  uint8_t padding_bits_;
+  int64_t encoded_size_;
+};
+}  // namespace
+
+Result<ZarrArrayToBytesCodec::PreparedState::Ptr> PackBitsCodec::Prepare(
+    span<const Index> decoded_shape) const {
+  const int bits = internal_packbits::GetPackedBits(dtype_);
+  Index total_bits = bits;
+  for (auto size : decoded_shape) {
+    if (internal::MulOverflow(size, total_bits, &total_bits)) {
+      return absl::OutOfRangeError(tensorstore::StrCat(
+          "Integer overflow computing encoded size of array of shape ",
+          decoded_shape));
+    }
+  }
+  auto state = internal::MakeIntrusivePtr<PackBitsCodecPreparedState>();
+  state->dtype_ = dtype_;
+  state->padding_encoding_ = padding_encoding_;
+  state->bits_ = bits;
+  state->num_elements_ = total_bits / bits;
+  state->packed_bytes_ = (total_bits + 7) / 8;
+  state->padding_bits_ = state->packed_bytes_ * 8 - total_bits;
+  state->encoded_size_ = state->packed_bytes_ +
+                         (padding_encoding_ == PaddingEncoding::kNone ? 0 : 1);
+  return state;
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  using Self = PackBitsCodecSpec;
+  using Options = Self::Options;
+  RegisterCodec<Self>(
+      "packbits",
+      jb::Projection<&Self::options>(jb::Sequence(  //
+          [](auto is_loading, const auto& options, auto* obj, auto* j) {
+            if constexpr (is_loading) {
+              obj->constraints = options.constraints;
+            }
+            return absl::OkStatus();
+          },
+          jb::Member("padding_encoding",
+                     jb::Projection<&Options::padding_encoding>(
+                         jb::Optional(PaddingEncodingBinder())))  //
+          )));
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
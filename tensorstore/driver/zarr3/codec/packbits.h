@@ -0,0 +1,106 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_CODEC_PACKBITS_H_
+#define TENSORSTORE_DRIVER_ZARR3_CODEC_PACKBITS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+
+#include "absl/status/status.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+/// "packbits" array -> bytes codec, which stores each element of a sub-byte
+/// data type (`bool` or `int4`) using only its significant bits.
+///
+/// Elements are packed in lexicographic (C) order, least significant bit
+/// first: element `i` of an `n`-bit data type occupies bits
+/// `[(i * n) % 8, (i * n) % 8 + n)` of byte `i * n / 8`.  Depending on
+/// `padding_encoding`, the number of padding bits in the final byte is
+/// additionally stored in an extra first or last byte.
+class PackBitsCodecSpec : public ZarrArrayToBytesCodecSpec {
+ public:
+  enum class PaddingEncoding {
+    kNone,
+    kFirstByte,
+    kLastByte,
+  };
+
+  struct Options {
+    std::optional<PaddingEncoding> padding_encoding;
+    // Indicates whether this spec should be validated by `Resolve` according to
+    // the (looser) requirements for codecs specified as part of metadata
+    // constraints, rather than the stricter rules for codecs specified in the
+    // actual stored metadata.
+    bool constraints = false;
+  };
+  PackBitsCodecSpec() = default;
+  explicit PackBitsCodecSpec(const Options& options) : options(options) {}
+
+  absl::Status MergeFrom(const ZarrCodecSpec& other, bool strict) override;
+  ZarrCodecSpec::Ptr Clone() const override;
+
+  absl::Status GetDecodedChunkLayout(
+      const ArrayDataTypeAndShapeInfo& array_info,
+      ArrayCodecChunkLayoutInfo& decoded) const override;
+
+  bool SupportsInnerOrder(
+      const ArrayCodecResolveParameters& decoded,
+      span<DimensionIndex> preferred_inner_order) const override;
+
+  Result<ZarrArrayToBytesCodec::Ptr> Resolve(
+      ArrayCodecResolveParameters&& decoded,
+      BytesCodecResolveParameters& encoded,
+      ZarrArrayToBytesCodecSpec::Ptr* resolved_spec) const override;
+
+  Options options;
+};
+
+namespace internal_packbits {
+
+/// Returns the number of significant bits of `dtype`, or 0 if `dtype` is not
+/// supported by the "packbits" codec.
+int GetPackedBits(DataType dtype);
+
+/// Packs `count` `bool` values, each stored as a byte equal to 0 or 1, into
+/// `(count + 7) / 8` bytes.
+void PackBool(const unsigned char* source, size_t count, unsigned char* dest);
+
+/// Inverse of `PackBool`.
+void UnpackBool(const unsigned char* source, size_t count,
+                unsigned char* dest);
+
+/// Packs `count` `int4` values, each stored as a sign-extended byte, into
+/// `(count + 1) / 2` bytes.
+void PackInt4(const unsigned char* source, size_t count, unsigned char* dest);
+
+/// Inverse of `PackInt4`.
+void UnpackInt4(const unsigned char* source, size_t count,
+                unsigned char* dest);
+
+}  // namespace internal_packbits
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_CODEC_PACKBITS_H_
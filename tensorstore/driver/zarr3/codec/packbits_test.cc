@@ -0,0 +1,109 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/packbits.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::dtype_v;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
+using ::tensorstore::internal_zarr3::TestCodecSpecResolve;
+using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::internal_packbits::PackBool;
+using ::tensorstore::internal_zarr3::internal_packbits::PackInt4;
+using ::tensorstore::internal_zarr3::internal_packbits::UnpackBool;
+using ::tensorstore::internal_zarr3::internal_packbits::UnpackInt4;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+TEST(PackBitsTest, PackBool) {
+  const unsigned char source[] = {1, 0, 0, 1, 1, 0, 1, 0,  //
+                                  0, 1, 1, 1, 0, 0, 0, 0,  //
+                                  1, 1, 0};
+  std::vector<unsigned char> packed(3);
+  PackBool(source, 19, packed.data());
+  EXPECT_THAT(packed, ElementsAre(0x59, 0x0e, 0x03));
+
+  std::vector<unsigned char> unpacked(19);
+  UnpackBool(packed.data(), 19, unpacked.data());
+  EXPECT_THAT(unpacked, ElementsAreArray(source));
+}
+
+TEST(PackBitsTest, PackInt4) {
+  const int8_t source[] = {1, -1, -8, 7, 3};
+  std::vector<unsigned char> packed(3);
+  PackInt4(reinterpret_cast<const unsigned char*>(source), 5, packed.data());
+  EXPECT_THAT(packed, ElementsAre(0xf1, 0x78, 0x03));
+
+  std::vector<int8_t> unpacked(5);
+  UnpackInt4(packed.data(), 5,
+             reinterpret_cast<unsigned char*>(unpacked.data()));
+  EXPECT_THAT(unpacked, ElementsAreArray(source));
+}
+
+TEST(PackBitsTest, SpecRoundTrip) {
+  CodecSpecRoundTripTestParams p;
+  p.resolve_params.dtype = dtype_v<bool>;
+  p.orig_spec = {"packbits"};
+  p.expected_spec = {{{"name", "packbits"},
+                      {"configuration", {{"padding_encoding", "none"}}}}};
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(PackBitsTest, RoundTrip) {
+  for (auto padding_encoding : {"none", "first_byte", "last_byte"}) {
+    for (auto dtype : {tensorstore::DataType(dtype_v<bool>),
+                       tensorstore::DataType(
+                           dtype_v<::tensorstore::dtypes::int4_t>)}) {
+      SCOPED_TRACE(padding_encoding);
+      SCOPED_TRACE(dtype);
+      CodecRoundTripTestParams p;
+      p.spec = {{{"name", "packbits"},
+                 {"configuration", {{"padding_encoding", padding_encoding}}}}};
+      p.shape = {3, 5, 7};
+      p.dtype = dtype;
+      TestCodecRoundTrip(p);
+    }
+  }
+}
+
+TEST(PackBitsTest, InvalidDataType) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<uint8_t>;
+  p.rank = 2;
+  EXPECT_THAT(
+      TestCodecSpecResolve(::nlohmann::json::array_t{{{"name", "packbits"}}},
+                           p),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    ".*Data type uint8 not compatible with \"packbits\" "
+                    "codec"));
+}
+
+}  // namespace
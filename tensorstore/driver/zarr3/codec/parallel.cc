@@ -0,0 +1,82 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/zarr3/codec/parallel.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/thread/thread_pool.h"
+#include "tensorstore/util/executor.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+const Executor& GetCodecExecutor() {
+  static absl::NoDestructor<Executor> executor(internal::DetachedThreadPool(
+      std::max(size_t(1), size_t(std::thread::hardware_concurrency()))));
+  return *executor;
+}
+
+absl::Status ParallelFor(size_t n,
+                         absl::FunctionRef<absl::Status(size_t)> func) {
+  struct State {
+    explicit State(size_t n, absl::FunctionRef<absl::Status(size_t)> func)
+        : n(n), func(func) {}
+    const size_t n;
+    // Only valid while `completed < n`, which is guaranteed for any index
+    // claimed from `next`.
+    absl::FunctionRef<absl::Status(size_t)> func;
+    std::atomic<size_t> next{0};
+    absl::Mutex mutex;
+    size_t completed ABSL_GUARDED_BY(mutex) = 0;
+    absl::Status status ABSL_GUARDED_BY(mutex);
+
+    bool Done() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+      return completed == n;
+    }
+
+    void Run() {
+      for (size_t i; (i = next.fetch_add(1)) < n;) {
+        auto func_status = func(i);
+        absl::MutexLock lock(&mutex);
+        if (status.ok()) status = std::move(func_status);
+        ++completed;
+      }
+    }
+  };
+  auto state = std::make_shared<State>(n, func);
+  const auto& executor = GetCodecExecutor();
+  for (size_t i = 1; i < n; ++i) {
+    executor([state] { state->Run(); });
+  }
+  state->Run();
+  absl::MutexLock lock(&state->mutex);
+  state->mutex.Await(absl::Condition(state.get(), &State::Done));
+  return state->status;
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
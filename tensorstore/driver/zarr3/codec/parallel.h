@@ -0,0 +1,47 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_CODEC_PARALLEL_H_
+#define TENSORSTORE_DRIVER_ZARR3_CODEC_PARALLEL_H_
+
+#include <stddef.h>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "tensorstore/util/executor.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+/// Returns the executor used by codecs for parallel work on a single chunk.
+///
+/// Codecs do not have access to the `data_copy_concurrency` resource of the
+/// driver, so this uses a separate pool with the same default concurrency.
+const Executor& GetCodecExecutor();
+
+/// Invokes `func(i)` for each `i` in `[0, n)`, potentially in parallel using
+/// `GetCodecExecutor()`.
+///
+/// The calling thread participates in the work rather than just waiting, so
+/// this never blocks on tasks that have not yet started.
+///
+/// \returns The first error returned by `func`, or `absl::OkStatus()`.
+absl::Status ParallelFor(size_t n,
+                         absl::FunctionRef<absl::Status(size_t)> func);
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_CODEC_PARALLEL_H_
@@ -14,23 +14,51 @@
 
 #include "tensorstore/driver/zarr3/codec/zstd_codec.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "absl/base/no_destructor.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/write.h"
 #include "riegeli/bytes/writer.h"
-#include "riegeli/zstd/zstd_reader.h"
 #include "riegeli/zstd/zstd_writer.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/compression_level_tuner.h"
+#include "tensorstore/driver/zarr3/codec/parallel.h"
 #include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/internal/compression/context_pool.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json/value_as.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/internal/memory.h"
+#include "tensorstore/internal/riegeli/array_endian_codec.h"
+#include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+#include <zstd.h>
 
 namespace tensorstore {
 namespace internal_zarr3 {
@@ -38,15 +66,398 @@ namespace {
 
 using ::riegeli::ZstdWriterBase;
 
+// Chunks with a decoded size of at least `2 * kParallelFrameSize` are encoded
+// as a sequence of independent zstd frames of `kParallelFrameSize` decoded
+// bytes each, which are compressed in parallel.  The zstd format permits
+// concatenated frames, and the decoded value is the concatenation of the
+// decoded frames.
+constexpr size_t kParallelFrameSize = size_t(4) << 20;
+
+struct ZstdCCtxDeleter {
+  void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+
+struct ZstdDCtxDeleter {
+  void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+// Compression contexts are keyed by compression level, which determines the
+// size of their workspace.
+using ZstdCCtxPool =
+    internal::CompressionContextPool<ZSTD_CCtx, ZstdCCtxDeleter, int>;
+using ZstdDCtxPool =
+    internal::CompressionContextPool<ZSTD_DCtx, ZstdDCtxDeleter, int>;
+
+ZstdCCtxPool::Lease AcquireCCtx(int level) {
+  static absl::NoDestructor<ZstdCCtxPool> pool;
+  return pool->Acquire(
+      level, [] { return ZstdCCtxPool::Ptr(ZSTD_createCCtx()); },
+      [](ZSTD_CCtx* ctx) {
+        ZSTD_CCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+      });
+}
+
+ZstdDCtxPool::Lease AcquireDCtx() {
+  static absl::NoDestructor<ZstdDCtxPool> pool;
+  return pool->Acquire(
+      0, [] { return ZstdDCtxPool::Ptr(ZSTD_createDCtx()); },
+      [](ZSTD_DCtx* ctx) {
+        ZSTD_DCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+      });
+}
+
+struct ZstdCDictDeleter {
+  void operator()(ZSTD_CDict* dict) const { ZSTD_freeCDict(dict); }
+};
+
+struct ZstdDDictDeleter {
+  void operator()(ZSTD_DDict* dict) const { ZSTD_freeDDict(dict); }
+};
+
+// Digested form of a dictionary, shared by all uses of a resolved codec.
+struct ZstdDictionary {
+  std::unique_ptr<ZSTD_CDict, ZstdCDictDeleter> cdict;
+  std::unique_ptr<ZSTD_DDict, ZstdDDictDeleter> ddict;
+};
+
+absl::Status ZstdError(std::string_view operation, size_t code) {
+  return absl::InvalidArgumentError(
+      tensorstore::StrCat("Zstd ", operation, " failed: ",
+                          ZSTD_getErrorName(code)));
+}
+
+// Compresses `input` as a single zstd frame and stores the result in `output`.
+absl::Status CompressFrame(std::string_view input, int level, bool checksum,
+                           const ZstdDictionary* dictionary,
+                           std::string& output) {
+  auto ctx = AcquireCCtx(level);
+  if (!ctx) {
+    return absl::ResourceExhaustedError("Failed to create Zstd context");
+  }
+  ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_compressionLevel, level);
+  ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_checksumFlag, checksum ? 1 : 0);
+  if (dictionary) ZSTD_CCtx_refCDict(ctx.get(), dictionary->cdict.get());
+  output.resize(ZSTD_compressBound(input.size()));
+  const size_t result = ZSTD_compress2(ctx.get(), output.data(), output.size(),
+                                       input.data(), input.size());
+  if (ZSTD_isError(result)) return ZstdError("compression", result);
+  output.resize(result);
+  return absl::OkStatus();
+}
+
+// Reads bytes at increasing positions of an `absl::Cord` without flattening
+// it.
+class CordScanner {
+ public:
+  explicit CordScanner(const absl::Cord& cord)
+      : it_(cord.char_begin()), remaining_(cord.size()) {}
+
+  size_t remaining() const { return remaining_; }
+
+  // Copies the next `n` bytes to `output` without consuming them.  Returns
+  // `false` if fewer than `n` bytes remain.
+  bool Peek(size_t n, char* output) const {
+    if (n > remaining_) return false;
+    auto it = it_;
+    for (size_t i = 0; i < n; ++i, ++it) output[i] = *it;
+    return true;
+  }
+
+  // Consumes the next `n` bytes.  Returns `false` if fewer than `n` bytes
+  // remain.
+  bool Skip(size_t n) {
+    if (n > remaining_) return false;
+    absl::Cord::Advance(&it_, n);
+    remaining_ -= n;
+    return true;
+  }
+
+ private:
+  absl::Cord::CharIterator it_;
+  size_t remaining_;
+};
+
+uint32_t LoadLittleEndian32(const char* p) {
+  const auto* b = reinterpret_cast<const unsigned char*>(p);
+  return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) |
+         (uint32_t(b[3]) << 24);
+}
+
+// Sizes of the frame format defined by RFC 8878.
+constexpr size_t kMaxFrameHeaderSize = 18;
+constexpr size_t kSkippableFrameHeaderSize = 8;
+constexpr size_t kBlockHeaderSize = 3;
+constexpr size_t kChecksumSize = 4;
+constexpr uint32_t kSkippableMagicMask = 0xFFFFFFF0;
+
+struct Frame {
+  absl::Cord encoded;
+  size_t decoded_offset;
+  size_t decoded_size;
+};
+
+// Splits `input` into its frames by parsing the frame and block headers, which
+// does not require `input` to be flat.
+//
+// Returns `false` if any frame does not declare its decoded size, or is not
+// well-formed, in which case `input` must be decoded as a stream.
+bool FindFrames(const absl::Cord& input, std::vector<Frame>& frames,
+                size_t& decoded_size) {
+  CordScanner scanner(input);
+  char header[kMaxFrameHeaderSize];
+  while (scanner.remaining() != 0) {
+    const size_t frame_offset = input.size() - scanner.remaining();
+    if (!scanner.Peek(5, header)) return false;
+    const uint32_t magic = LoadLittleEndian32(header);
+    size_t frame_decoded_size = 0;
+    if ((magic & kSkippableMagicMask) == ZSTD_MAGIC_SKIPPABLE_START) {
+      if (!scanner.Peek(kSkippableFrameHeaderSize, header) ||
+          !scanner.Skip(kSkippableFrameHeaderSize) ||
+          !scanner.Skip(LoadLittleEndian32(header + 4))) {
+        return false;
+      }
+    } else {
+      if (magic != ZSTD_MAGICNUMBER) return false;
+      const unsigned char descriptor = header[4];
+      const bool single_segment = descriptor & 0x20;
+      const bool has_checksum = descriptor & 0x04;
+      constexpr size_t kDictionaryIdSizes[] = {0, 1, 2, 4};
+      constexpr size_t kContentSizeSizes[] = {0, 2, 4, 8};
+      const size_t content_size_size =
+          kContentSizeSizes[descriptor >> 6] +
+          (single_segment && (descriptor >> 6) == 0);
+      const size_t header_size = 5 + !single_segment +
+                                 kDictionaryIdSizes[descriptor & 3] +
+                                 content_size_size;
+      if (!scanner.Peek(header_size, header)) return false;
+      const unsigned long long content_size =  // NOLINT
+          ZSTD_getFrameContentSize(header, header_size);
+      if (content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+          content_size == ZSTD_CONTENTSIZE_ERROR ||
+          content_size > std::numeric_limits<size_t>::max() - decoded_size) {
+        return false;
+      }
+      frame_decoded_size = static_cast<size_t>(content_size);
+      scanner.Skip(header_size);
+      while (true) {
+        char block_header[kBlockHeaderSize];
+        if (!scanner.Peek(kBlockHeaderSize, block_header)) return false;
+        const auto* b = reinterpret_cast<const unsigned char*>(block_header);
+        const uint32_t value =
+            uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16);
+        const bool last_block = value & 1;
+        const uint32_t block_type = (value >> 1) & 3;
+        if (block_type == 3) return false;  // Reserved.
+        // The content of an RLE block is a single byte, regardless of the
+        // decoded block size.
+        const size_t block_size = block_type == 1 ? 1 : (value >> 3);
+        if (!scanner.Skip(kBlockHeaderSize + block_size)) return false;
+        if (last_block) break;
+      }
+      if (has_checksum && !scanner.Skip(kChecksumSize)) return false;
+    }
+    const size_t frame_size =
+        input.size() - scanner.remaining() - frame_offset;
+    frames.push_back(Frame{input.Subcord(frame_offset, frame_size),
+                           decoded_size, frame_decoded_size});
+    decoded_size += frame_decoded_size;
+  }
+  return true;
+}
+
+// Decompresses the single zstd frame `frame`, whose decoded size of
+// `decoded_size` bytes is known in advance, into `output`.
+//
+// If `frame` is not flat, its chunks are supplied to the decompressor in turn
+// rather than being copied into a contiguous buffer.
+absl::Status DecompressFrame(const absl::Cord& frame, char* output,
+                             size_t decoded_size,
+                             const ZstdDictionary* dictionary) {
+  auto ctx = AcquireDCtx();
+  if (!ctx) {
+    return absl::ResourceExhaustedError("Failed to create Zstd context");
+  }
+  const auto size_mismatch = [] {
+    return absl::InvalidArgumentError(
+        "Zstd frame does not match its declared content size");
+  };
+  if (auto flat = frame.TryFlat()) {
+    const size_t result =
+        dictionary
+            ? ZSTD_decompress_usingDDict(ctx.get(), output, decoded_size,
+                                         flat->data(), flat->size(),
+                                         dictionary->ddict.get())
+            : ZSTD_decompressDCtx(ctx.get(), output, decoded_size,
+                                  flat->data(), flat->size());
+    if (ZSTD_isError(result)) return ZstdError("decompression", result);
+    if (result != decoded_size) return size_mismatch();
+    return absl::OkStatus();
+  }
+  if (dictionary) ZSTD_DCtx_refDDict(ctx.get(), dictionary->ddict.get());
+  ZSTD_outBuffer out{output, decoded_size, 0};
+  size_t result = 1;
+  for (std::string_view chunk : frame.Chunks()) {
+    ZSTD_inBuffer in{chunk.data(), chunk.size(), 0};
+    while (in.pos < in.size) {
+      const size_t prev_in_pos = in.pos;
+      const size_t prev_out_pos = out.pos;
+      result = ZSTD_decompressStream(ctx.get(), &out, &in);
+      if (ZSTD_isError(result)) return ZstdError("decompression", result);
+      if (in.pos == prev_in_pos && out.pos == prev_out_pos) {
+        return size_mismatch();
+      }
+    }
+  }
+  if (result != 0 || out.pos != decoded_size) return size_mismatch();
+  return absl::OkStatus();
+}
+
+// Decompresses `input`, which may consist of any number of frames whose
+// decoded sizes are not required to be known, into `output`.
+absl::Status DecompressStream(const absl::Cord& input,
+                              const ZstdDictionary* dictionary,
+                              std::string& output) {
+  auto ctx = AcquireDCtx();
+  if (!ctx) {
+    return absl::ResourceExhaustedError("Failed to create Zstd context");
+  }
+  if (dictionary) ZSTD_DCtx_refDDict(ctx.get(), dictionary->ddict.get());
+  auto chunk_it = input.chunk_begin();
+  ZSTD_inBuffer in{nullptr, 0, 0};
+  while (true) {
+    // Supply the chunks of `input` to the decompressor in turn.
+    while (in.pos == in.size && chunk_it != input.chunk_end()) {
+      in = ZSTD_inBuffer{chunk_it->data(), chunk_it->size(), 0};
+      ++chunk_it;
+    }
+    const size_t old_size = output.size();
+    output.resize(old_size + ZSTD_DStreamOutSize());
+    ZSTD_outBuffer out{output.data() + old_size, output.size() - old_size, 0};
+    const size_t result = ZSTD_decompressStream(ctx.get(), &out, &in);
+    output.resize(old_size + out.pos);
+    if (ZSTD_isError(result)) return ZstdError("decompression", result);
+    if (in.pos == in.size && chunk_it == input.chunk_end()) {
+      if (result == 0) break;
+      if (out.pos == 0) {
+        return absl::InvalidArgumentError("Truncated Zstd stream");
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Decodes a sequence of one or more concatenated zstd frames.  When there are
+// multiple frames with known decoded sizes, they are decoded in parallel.
+//
+// When the decoded size is known in advance, the frames are decompressed
+// directly into an uninitialized heap buffer that is returned as a single flat
+// `absl::Cord` chunk.  The buffer is suitably aligned for any data type, which
+// allows `DecodeArrayEndian` to use it as the storage of the decoded array
+// without an additional copy.  Since `input` is never flattened, this buffer
+// is the only copy made of the data.
+absl::StatusOr<absl::Cord> DecodeFrames(const absl::Cord& input,
+                                         const ZstdDictionary* dictionary) {
+  std::vector<Frame> frames;
+  size_t decoded_size = 0;
+  if (!FindFrames(input, frames, decoded_size) || frames.empty()) {
+    // Fall back to streaming decompression of the entire input.
+    std::string output;
+    TENSORSTORE_RETURN_IF_ERROR(DecompressStream(input, dictionary, output));
+    return absl::Cord(std::move(output));
+  }
+  if (decoded_size == 0) return absl::Cord();
+  auto output = internal::make_shared_for_overwrite<char[]>(decoded_size);
+  TENSORSTORE_RETURN_IF_ERROR(ParallelFor(frames.size(), [&](size_t i) {
+    const auto& frame = frames[i];
+    return DecompressFrame(frame.encoded, output.get() + frame.decoded_offset,
+                           frame.decoded_size, dictionary);
+  }));
+  return internal::MakeCordFromSharedPtr(std::move(output), decoded_size);
+}
+
+// Buffers writes to an `absl::Cord`, and then in `Done`, compresses the
+// buffered data as independent frames of `kParallelFrameSize` bytes in
+// parallel and forwards the concatenated frames to another `Writer`.
+class ZstdParallelDeferredWriter : public riegeli::CordWriter<absl::Cord> {
+ public:
+  // If `tuner` is not null, the encoding throughput and compression ratio are
+  // recorded to it.
+  explicit ZstdParallelDeferredWriter(
+      int level, bool checksum,
+      std::shared_ptr<const ZstdDictionary> dictionary,
+      std::shared_ptr<CompressionLevelTuner> tuner,
+      riegeli::Writer& base_writer)
+      : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
+            std::numeric_limits<size_t>::max())),
+        level_(level),
+        checksum_(checksum),
+        dictionary_(std::move(dictionary)),
+        tuner_(std::move(tuner)),
+        base_writer_(base_writer) {}
+
+  void Done() override {
+    CordWriter::Done();
+    const absl::Time start_time = absl::Now();
+    std::string_view input = dest().Flatten();
+    const size_t num_frames =
+        std::max(size_t(1),
+                 (input.size() + kParallelFrameSize - 1) / kParallelFrameSize);
+    std::vector<std::string> frames(num_frames);
+    auto status = ParallelFor(num_frames, [&](size_t i) {
+      return CompressFrame(input.substr(i * kParallelFrameSize,
+                                        kParallelFrameSize),
+                           level_, checksum_, dictionary_.get(), frames[i]);
+    });
+    if (!status.ok()) {
+      Fail(std::move(status));
+      return;
+    }
+    if (tuner_) {
+      size_t encoded_size = 0;
+      for (const auto& frame : frames) encoded_size += frame.size();
+      tuner_->Record(level_, input.size(), encoded_size,
+                     absl::Now() - start_time);
+    }
+    for (auto& frame : frames) {
+      status = riegeli::Write(std::move(frame), base_writer_);
+      if (!status.ok()) {
+        Fail(std::move(status));
+        return;
+      }
+    }
+  }
+
+ private:
+  int level_;
+  bool checksum_;
+  std::shared_ptr<const ZstdDictionary> dictionary_;
+  std::shared_ptr<CompressionLevelTuner> tuner_;
+  riegeli::Writer& base_writer_;
+};
+
 class ZstdCodec : public ZarrBytesToBytesCodec {
  public:
-  explicit ZstdCodec(int level, bool checksum)
-      : level_(level), checksum_(checksum) {}
+  explicit ZstdCodec(int level, bool checksum,
+                     std::shared_ptr<const ZstdDictionary> dictionary,
+                     std::shared_ptr<CompressionLevelTuner> tuner)
+      : level_(level),
+        checksum_(checksum),
+        dictionary_(std::move(dictionary)),
+        tuner_(std::move(tuner)) {}
 
   class State : public ZarrBytesToBytesCodec::PreparedState {
    public:
     Result<std::unique_ptr<riegeli::Writer>> GetEncodeWriter(
         riegeli::Writer& encoded_writer) const final {
+      if (tuner_) {
+        return std::make_unique<ZstdParallelDeferredWriter>(
+            tuner_->GetLevel(), checksum_, nullptr, tuner_, encoded_writer);
+      }
+      if (dictionary_ ||
+          decoded_size_ >= static_cast<int64_t>(2 * kParallelFrameSize)) {
+        return std::make_unique<ZstdParallelDeferredWriter>(
+            level_, checksum_, dictionary_, nullptr, encoded_writer);
+      }
       using Writer = riegeli::ZstdWriter<riegeli::Writer*>;
       Writer::Options options;
       options.set_compression_level(level_);
@@ -59,13 +470,26 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
 
     Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
         riegeli::Reader& encoded_reader) const final {
-      using Reader = riegeli::ZstdReader<riegeli::Reader*>;
-      Reader::Options options;
-      return std::make_unique<Reader>(&encoded_reader, options);
+      absl::Cord encoded;
+      absl::StatusOr<absl::Cord> output;
+      if (auto status = riegeli::ReadAll(encoded_reader, encoded);
+          status.ok()) {
+        output = DecodeFrames(encoded, dictionary_.get());
+      } else {
+        output = std::move(status);
+      }
+      auto reader = std::make_unique<riegeli::CordReader<absl::Cord>>(
+          output.ok() ? std::move(*output) : absl::Cord());
+      if (!output.ok()) {
+        reader->Fail(std::move(output).status());
+      }
+      return reader;
     }
 
     int level_;
     bool checksum_;
+    std::shared_ptr<const ZstdDictionary> dictionary_;
+    std::shared_ptr<CompressionLevelTuner> tuner_;
     int64_t decoded_size_;
   };
 
@@ -73,6 +497,8 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
     auto state = internal::MakeIntrusivePtr<State>();
     state->level_ = level_;
     state->checksum_ = checksum_;
+    state->dictionary_ = dictionary_;
+    state->tuner_ = tuner_;
     state->decoded_size_ = decoded_size;
     return state;
   }
@@ -80,17 +506,63 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
  private:
   int level_;
   bool checksum_;
+  std::shared_ptr<const ZstdDictionary> dictionary_;
+  std::shared_ptr<CompressionLevelTuner> tuner_;
 };
 
+// Candidate levels for the "auto" level.  Negative levels are omitted, since
+// they sacrifice substantial compression ratio.
+constexpr int kAutoLevels[] = {1, 2, 3, 5, 7, 9, 12, 15, 19};
+
+constexpr auto LevelBinder() {
+  return CompressionLevelBinder(ZstdWriterBase::Options::kMinCompressionLevel,
+                                ZstdWriterBase::Options::kMaxCompressionLevel);
+}
+
+// Binds a dictionary to a base64-encoded JSON string.
+constexpr auto DictionaryBinder = [](auto is_loading, const auto& options,
+                                     auto* obj,
+                                     ::nlohmann::json* j) -> absl::Status {
+  if constexpr (is_loading) {
+    const auto* encoded = j->template get_ptr<const std::string*>();
+    if (!encoded) {
+      return internal_json::ExpectedError(*j, "base64-encoded string");
+    }
+    if (!absl::Base64Unescape(*encoded, obj)) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Invalid base64-encoded dictionary: ",
+                              tensorstore::QuoteString(*encoded)));
+    }
+  } else {
+    *j = absl::Base64Escape(*obj);
+  }
+  return absl::OkStatus();
+};
+
+Result<std::shared_ptr<const ZstdDictionary>> MakeDictionary(
+    std::string_view data, int level) {
+  auto dictionary = std::make_shared<ZstdDictionary>();
+  dictionary->cdict.reset(ZSTD_createCDict(data.data(), data.size(), level));
+  dictionary->ddict.reset(ZSTD_createDDict(data.data(), data.size()));
+  if (!dictionary->cdict || !dictionary->ddict) {
+    return absl::InvalidArgumentError("Invalid zstd dictionary");
+  }
+  return dictionary;
+}
+
 }  // namespace
 
 absl::Status ZstdCodecSpec::MergeFrom(const ZarrCodecSpec& other, bool strict) {
   using Self = ZstdCodecSpec;
   const auto& other_options = static_cast<const Self&>(other).options;
-  TENSORSTORE_RETURN_IF_ERROR(
-      MergeConstraint<&Options::level>("level", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::level>(
+      "level", options, other_options, LevelBinder()));
   TENSORSTORE_RETURN_IF_ERROR(
       MergeConstraint<&Options::checksum>("checksum", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::target_throughput>(
+      "target_throughput", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::dictionary>(
+      "dictionary", options, other_options, DictionaryBinder));
   return absl::OkStatus();
 }
 
@@ -104,16 +576,40 @@ Result<ZarrBytesToBytesCodec::Ptr> ZstdCodecSpec::Resolve(
   auto resolved_level =
       options.level.value_or(ZstdWriterBase::Options::kDefaultCompressionLevel);
   auto resolved_checksum = options.checksum.value_or(false);
+  std::optional<double> resolved_target_throughput;
+  std::shared_ptr<CompressionLevelTuner> tuner;
+  if (resolved_level == kAutoCompressionLevel) {
+    if (options.dictionary) {
+      return absl::InvalidArgumentError(
+          "\"level\" of \"auto\" is not supported with a \"dictionary\"");
+    }
+    resolved_target_throughput =
+        options.target_throughput.value_or(kDefaultTargetThroughput);
+    tuner = std::make_shared<CompressionLevelTuner>(
+        "zstd", std::vector<int>(std::begin(kAutoLevels), std::end(kAutoLevels)),
+        *resolved_target_throughput);
+  } else if (options.target_throughput) {
+    return absl::InvalidArgumentError(
+        "\"target_throughput\" requires a \"level\" of \"auto\"");
+  }
+  std::shared_ptr<const ZstdDictionary> dictionary;
+  if (options.dictionary) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        dictionary, MakeDictionary(*options.dictionary, resolved_level));
+  }
   if (resolved_spec) {
-    if (options.level && options.checksum) {
+    if (options.level && options.checksum &&
+        options.target_throughput == resolved_target_throughput) {
       resolved_spec->reset(this);
     } else {
-      resolved_spec->reset(
-          new ZstdCodecSpec(Options{resolved_level, resolved_checksum}));
+      resolved_spec->reset(new ZstdCodecSpec(
+          Options{resolved_level, resolved_checksum, options.dictionary,
+                  resolved_target_throughput}));
     }
   }
-  return internal::MakeIntrusivePtr<ZstdCodec>(resolved_level,
-                                               resolved_checksum);
+  return internal::MakeIntrusivePtr<ZstdCodec>(
+      resolved_level, resolved_checksum, std::move(dictionary),
+      std::move(tuner));
 }
 
 TENSORSTORE_GLOBAL_INITIALIZER {
@@ -125,12 +621,16 @@ TENSORSTORE_GLOBAL_INITIALIZER {
       jb::Projection<&Self::options>(jb::Sequence(
           jb::Member("level",
                      jb::Projection<&Options::level>(
-                         OptionalIfConstraintsBinder(jb::Integer<int>(
-                             ZstdWriterBase::Options::kMinCompressionLevel,
-                             ZstdWriterBase::Options::kMaxCompressionLevel)))),
+                         OptionalIfConstraintsBinder(LevelBinder()))),
           jb::Member("checksum",
                      jb::Projection<&Options::checksum>(
-                         OptionalIfConstraintsBinder())))  //
+                         OptionalIfConstraintsBinder())),
+          jb::Member("dictionary",
+                     jb::Projection<&Options::dictionary>(
+                         jb::Optional(DictionaryBinder))),
+          jb::Member("target_throughput",
+                     jb::Projection<&Options::target_throughput>(
+                         jb::Optional(TargetThroughputBinder()))))  //
                                      ));
 }
 
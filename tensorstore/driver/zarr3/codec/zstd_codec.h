@@ -16,6 +16,7 @@
 #define TENSORSTORE_DRIVER_ZARR3_CODEC_ZSTD_CODEC_H_
 
 #include <optional>
+#include <string>
 
 #include "absl/status/status.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
@@ -30,6 +31,12 @@ class ZstdCodecSpec : public ZarrBytesToBytesCodecSpec {
   struct Options {
     std::optional<int> level;
     std::optional<bool> checksum;
+    /// Raw zstd dictionary, e.g. as returned by
+    /// `internal::TrainZstdDictionary`.
+    std::optional<std::string> dictionary;
+    /// Target encode throughput in bytes per second, only valid if `level` is
+    /// `kAutoCompressionLevel`.
+    std::optional<double> target_throughput;
   };
   ZstdCodecSpec() = default;
   explicit ZstdCodecSpec(const Options& options) : options(options) {}
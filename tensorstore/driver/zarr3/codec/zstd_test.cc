@@ -12,14 +12,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/util/status_testutil.h"
 
 namespace {
 
+using ::tensorstore::MatchesStatus;
 using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::TestCodecMerge;
 using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
 using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
 
@@ -67,4 +73,114 @@ TEST(ZstdTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+TEST(ZstdTest, RoundTripParallel) {
+  // 12 MiB chunks are encoded as multiple independent frames.
+  CodecRoundTripTestParams p;
+  p.spec = {{{"name", "zstd"}, {"configuration", {{"checksum", true}}}}};
+  p.shape = {96, 256, 256};
+  TestCodecRoundTrip(p);
+}
+
+TEST(ZstdTest, AutoLevel) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "zstd"}, {"configuration", {{"level", "auto"}}}},
+  };
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "zstd"},
+       {"configuration",
+        {{"level", "auto"},
+         {"checksum", false},
+         {"target_throughput", 100 << 20}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(ZstdTest, AutoLevelTargetThroughput) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "zstd"},
+       {"configuration", {{"level", "auto"}, {"target_throughput", 5e8}}}},
+  };
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "zstd"},
+       {"configuration",
+        {{"level", "auto"}, {"checksum", false}, {"target_throughput", 5e8}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(ZstdTest, RoundTripAutoLevel) {
+  CodecRoundTripTestParams p;
+  p.spec = {{{"name", "zstd"}, {"configuration", {{"level", "auto"}}}}};
+  TestCodecRoundTrip(p);
+}
+
+TEST(ZstdTest, MergeAutoLevelMismatch) {
+  EXPECT_THAT(
+      TestCodecMerge(
+          {{{"name", "zstd"}, {"configuration", {{"level", "auto"}}}}},
+          {{{"name", "zstd"}, {"configuration", {{"level", 3}}}}},
+          /*strict=*/true),
+      MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                    ".*\"level\": \"auto\" vs 3"));
+}
+
+TEST(ZstdTest, InvalidTargetThroughput) {
+  const ::nlohmann::json spec = {
+      {{"name", "zstd"},
+       {"configuration", {{"level", "auto"}, {"target_throughput", 0}}}}};
+  EXPECT_THAT(TestCodecMerge(spec, spec, /*strict=*/true),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*Expected positive target throughput.*"));
+}
+
+// Base64 encoding of a raw content dictionary.
+constexpr char kDictionary[] =
+    "VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gMDEyMzQ1Njc4OQ"
+    "==";
+
+TEST(ZstdTest, Dictionary) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "zstd"}, {"configuration", {{"dictionary", kDictionary}}}},
+  };
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "zstd"},
+       {"configuration",
+        {{"level", 3}, {"checksum", false}, {"dictionary", kDictionary}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(ZstdTest, RoundTripDictionary) {
+  CodecRoundTripTestParams p;
+  p.spec = {
+      {{"name", "zstd"}, {"configuration", {{"dictionary", kDictionary}}}}};
+  TestCodecRoundTrip(p);
+}
+
+TEST(ZstdTest, InvalidDictionary) {
+  const ::nlohmann::json spec = {
+      {{"name", "zstd"}, {"configuration", {{"dictionary", "#"}}}}};
+  EXPECT_THAT(
+      TestCodecMerge(spec, spec, /*strict=*/true),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    ".*Invalid base64-encoded dictionary: \"#\".*"));
+}
+
+TEST(ZstdTest, MergeDictionaryMismatch) {
+  EXPECT_THAT(
+      TestCodecMerge(
+          {{{"name", "zstd"},
+            {"configuration", {{"dictionary", kDictionary}}}}},
+          {{{"name", "zstd"}, {"configuration", {{"dictionary", "YWJj"}}}}},
+          /*strict=*/true),
+      MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                    ".*\"dictionary\".*"));
+}
+
 }  // namespace
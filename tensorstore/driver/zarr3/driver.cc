@@ -19,10 +19,12 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 
+#include "absl/base/no_destructor.h"
 #include "absl/status/status.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
@@ -38,6 +40,7 @@
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/chunk.h"
+#include "tensorstore/driver/consolidated_metadata.h"
 #include "tensorstore/driver/driver_spec.h"
 #include "tensorstore/driver/kvs_backed_chunk_driver.h"
 #include "tensorstore/driver/registry.h"
@@ -51,7 +54,9 @@
 #include "tensorstore/index_space/index_transform_builder.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/cache_key/std_optional.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/decoded_value_cache.h"
 #include "tensorstore/internal/grid_chunk_key_ranges_base10.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
@@ -63,6 +68,8 @@
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/dimension_set.h"
 #include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/sender_util.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
@@ -87,6 +94,38 @@ using ::tensorstore::internal_kvs_backed_chunk_driver::KvsDriverSpec;
 
 constexpr const char kMetadataKey[] = "zarr.json";
 
+/// Parses the inline consolidated metadata of a group `zarr.json` document.
+///
+/// The `consolidated_metadata.metadata` member maps the path of each node,
+/// relative to the group, to the content of its `zarr.json` document.
+Result<internal_kvs_backed_chunk_driver::ConsolidatedMetadataMap>
+ParseConsolidatedMetadata(const ::nlohmann::json& j) {
+  if (!j.is_object()) {
+    return absl::DataLossError("Expected object");
+  }
+  auto consolidated_it = j.find("consolidated_metadata");
+  if (consolidated_it == j.end() || !consolidated_it->is_object()) {
+    return absl::DataLossError(
+        "Expected \"consolidated_metadata\" to be an object");
+  }
+  auto kind_it = consolidated_it->find("kind");
+  if (kind_it == consolidated_it->end() || *kind_it != "inline") {
+    return absl::DataLossError("Expected \"kind\" to be \"inline\"");
+  }
+  auto metadata_it = consolidated_it->find("metadata");
+  if (metadata_it == consolidated_it->end() || !metadata_it->is_object()) {
+    return absl::DataLossError("Expected \"metadata\" to be an object");
+  }
+  internal_kvs_backed_chunk_driver::ConsolidatedMetadataMap map;
+  for (const auto& [path, value] : metadata_it->items()) {
+    map.emplace(tensorstore::StrCat(path, "/", kMetadataKey), value);
+  }
+  return map;
+}
+
+constexpr internal_kvs_backed_chunk_driver::ConsolidatedMetadataFormat
+    kConsolidatedMetadataFormat{"zarr3", &ParseConsolidatedMetadata};
+
 class ZarrDriverSpec
     : public internal::RegisteredDriverSpec<ZarrDriverSpec,
                                             /*Parent=*/KvsDriverSpec> {
@@ -97,9 +136,11 @@ class ZarrDriverSpec
                                               /*Parent=*/KvsDriverSpec>;
 
   ZarrMetadataConstraints metadata_constraints;
+  std::optional<std::string> consolidated_metadata_key;
 
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    return f(internal::BaseCast<KvsDriverSpec>(x), x.metadata_constraints);
+    return f(internal::BaseCast<KvsDriverSpec>(x), x.metadata_constraints,
+             x.consolidated_metadata_key);
   };
 
   static inline const auto default_json_binder = jb::Sequence(
@@ -122,7 +163,10 @@ class ZarrDriverSpec
                 return absl::OkStatus();
               },
               jb::Projection<&ZarrDriverSpec::metadata_constraints>(
-                  jb::DefaultInitializedValue()))));
+                  jb::DefaultInitializedValue()))),
+      jb::Member(
+          "consolidated_metadata_key",
+          jb::Projection<&ZarrDriverSpec::consolidated_metadata_key>()));
 
   absl::Status ApplyOptions(SpecOptions&& options) override {
     if (options.minimal_spec) {
@@ -169,14 +213,22 @@ class ZarrDriverSpec
 
 Result<std::shared_ptr<const ZarrMetadata>> ParseEncodedMetadata(
     std::string_view encoded_value) {
-  nlohmann::json raw_data = nlohmann::json::parse(encoded_value, nullptr,
-                                                  /*allow_exceptions=*/false);
-  if (raw_data.is_discarded()) {
-    return absl::DataLossError("Invalid JSON");
-  }
-  TENSORSTORE_ASSIGN_OR_RETURN(auto metadata,
-                               ZarrMetadata::FromJson(std::move(raw_data)));
-  return std::make_shared<ZarrMetadata>(std::move(metadata));
+  // Opening the same array repeatedly, e.g. with a new `Context` for each
+  // request, re-reads the same encoded metadata.  Since decoded metadata is
+  // immutable, it is shared rather than parsed again.
+  static absl::NoDestructor<internal::DecodedValueCache<ZarrMetadata>> cache(
+      /*max_entries=*/64);
+  return cache->GetOrDecode(
+      encoded_value, [&]() -> Result<std::shared_ptr<const ZarrMetadata>> {
+        nlohmann::json raw_data = nlohmann::json::parse(
+            encoded_value, nullptr, /*allow_exceptions=*/false);
+        if (raw_data.is_discarded()) {
+          return absl::DataLossError("Invalid JSON");
+        }
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto metadata, ZarrMetadata::FromJson(std::move(raw_data)));
+        return std::make_shared<ZarrMetadata>(std::move(metadata));
+      });
 }
 
 class MetadataCache : public internal_kvs_backed_chunk_driver::MetadataCache {
@@ -434,6 +486,14 @@ class ZarrDataCache : public ChunkCacheImpl, public DataCacheBase {
     return DataCacheBase::executor();
   }
 
+  internal::MemoryBudget* memory_budget() const override {
+    return DataCacheBase::memory_budget();
+  }
+
+  internal::ChunkBufferPool* chunk_buffer_pool() const override {
+    return DataCacheBase::chunk_buffer_pool();
+  }
+
   internal::ChunkGridSpecification grid_;
 };
 
@@ -473,6 +533,10 @@ class ZarrDriver : public ZarrDriverBase {
   void Read(ReadRequest request,
             AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>
                 receiver) override {
+    if (auto status = ValidateDeferred(); !status.ok()) {
+      execution::set_error(FlowSingleReceiver{std::move(receiver)}, status);
+      return;
+    }
     return cache()->zarr_chunk_cache().Read(
         {std::move(request), GetCurrentDataStalenessBound()},
         std::move(receiver));
@@ -482,6 +546,11 @@ class ZarrDriver : public ZarrDriverBase {
       WriteRequest request,
       AnyFlowReceiver<absl::Status, internal::WriteChunk, IndexTransform<>>
           receiver) override {
+    if (auto status = ValidateDeferred(); !status.ok()) {
+      execution::set_error(FlowSingleReceiver{std::move(receiver)}, status);
+      return;
+    }
+    cache()->UseWriteBehindTransaction(request.transaction);
     return cache()->zarr_chunk_cache().Write(std::move(request),
                                              std::move(receiver));
   }
@@ -538,9 +607,24 @@ class ZarrDriver::OpenState : public ZarrDriver::OpenStateBase {
 
   std::string GetMetadataCacheEntryKey() override { return spec().store.path; }
 
-  // The metadata cache isn't parameterized by anything other than the
-  // KeyValueStore; therefore, we don't need to override `GetMetadataCacheKey`
-  // to encode the state.
+  // The metadata cache is parameterized by the consolidated metadata key, since
+  // that determines the KeyValueStore from which metadata is read.
+  std::string GetMetadataCacheKey() override {
+    std::string result;
+    internal::EncodeCacheKey(&result, spec().consolidated_metadata_key);
+    return result;
+  }
+
+  Result<kvstore::DriverPtr> GetMetadataKeyValueStore(
+      kvstore::DriverPtr base_kv_store) override {
+    const auto& consolidated_metadata_key = spec().consolidated_metadata_key;
+    if (!consolidated_metadata_key) return base_kv_store;
+    return internal_kvs_backed_chunk_driver::
+        GetConsolidatedMetadataKeyValueStore(
+            std::move(base_kv_store), *consolidated_metadata_key,
+            kConsolidatedMetadataFormat, cache_pool()->get(), executor());
+  }
+
   std::unique_ptr<internal_kvs_backed_chunk_driver::MetadataCache>
   GetMetadataCache(MetadataCache::Initializer initializer) override {
     return std::make_unique<MetadataCache>(std::move(initializer));
@@ -586,6 +670,11 @@ class ZarrDriver::OpenState : public ZarrDriver::OpenStateBase {
         ValidateMetadataSchema(metadata, spec().schema));
     return 0;
   }
+
+  std::optional<size_t> GetComponentIndexWithoutValidation(
+      const void* metadata_ptr) override {
+    return 0;
+  }
 };
 
 Future<internal::Driver::Handle> ZarrDriverSpec::Open(
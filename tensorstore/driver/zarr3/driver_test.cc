@@ -38,6 +38,7 @@
 #include "tensorstore/driver/driver_testutil.h"
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/index_space/index_domain_builder.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/json_gtest.h"
@@ -1159,6 +1160,42 @@ TEST(ZarrDriverTest, IncompatibleMetadata) {
                             "Updated zarr metadata .*"));
 }
 
+TEST(ZarrDriverTest, DeferValidation) {
+  auto context = Context::Default();
+  ::nlohmann::json json_spec{{"driver", "zarr3"}, {"kvstore", "memory://"}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(json_spec, dtype_v<uint8_t>, Schema::Shape({100}),
+                        tensorstore::OpenMode::create, context)
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, store.spec());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto reopened,
+      tensorstore::Open(spec,
+                        tensorstore::OpenMode::open |
+                            tensorstore::OpenMode::defer_validation,
+                        context)
+          .result());
+  TENSORSTORE_EXPECT_OK(tensorstore::Read(reopened).result());
+
+  // Incompatible constraints are only detected by the first read or write.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto incompatible,
+      tensorstore::Open(json_spec, dtype_v<uint16_t>,
+                        tensorstore::OpenMode::open |
+                            tensorstore::OpenMode::defer_validation,
+                        context)
+          .result());
+  EXPECT_THAT(tensorstore::Read(incompatible).result(),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            ".*data_type.*"));
+  EXPECT_THAT(tensorstore::Write(tensorstore::MakeScalarArray<uint8_t>(1),
+                                 incompatible)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            ".*data_type.*"));
+}
+
 TEST(ZarrDriverTest, DeleteExisting) {
   auto context = Context::Default();
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
@@ -1199,6 +1236,60 @@ TEST(ZarrDriverTest, ShardingBatchRead) {
   EXPECT_THAT(mock_kvstore->request_log.pop_all(), ::testing::SizeIs(4));
 }
 
+TEST(ZarrDriverTest, ShardIndexPrefetch) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_kvstore_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto mock_kvstore = *mock_kvstore_resource;
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  mock_kvstore->forward_to = memory_store;
+  mock_kvstore->handle_batch_requests = true;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open({{"driver", "zarr3"},
+                         {"kvstore", {{"driver", "mock_key_value_store"}}}},
+                        tensorstore::OpenMode::create, context,
+                        dtype_v<uint16_t>, Schema::Shape({8, 8}),
+                        ChunkLayout::ReadChunkShape({2, 2}),
+                        ChunkLayout::WriteChunkShape({4, 4}))
+          .result());
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint16_t>(42), store));
+  mock_kvstore->forward_to = {};
+
+  // Reads one sub-chunk from each of the 4 shards, which requires reading the
+  // shard index of each shard first.
+  auto read_future = tensorstore::Read(
+      store | tensorstore::Dims(0, 1).SizedInterval({1, 1}, {4, 4}));
+
+  // The shard indices of all shards are requested before any of them is
+  // returned.
+  using BatchReadRequest =
+      tensorstore::internal::MockKeyValueStore::BatchReadRequest;
+  std::vector<BatchReadRequest> requests;
+  for (int i = 0; i < 4; ++i) {
+    requests.push_back(mock_kvstore->batch_read_requests.pop());
+    ASSERT_THAT(requests.back().request_batch.requests, ::testing::SizeIs(1));
+  }
+  EXPECT_THAT(requests, ::testing::UnorderedElementsAre(
+                            ::testing::Field(&BatchReadRequest::key, "c/0/0"),
+                            ::testing::Field(&BatchReadRequest::key, "c/0/1"),
+                            ::testing::Field(&BatchReadRequest::key, "c/1/0"),
+                            ::testing::Field(&BatchReadRequest::key, "c/1/1")));
+
+  // Forward the sub-chunk reads issued once the shard indices are available.
+  mock_kvstore->forward_to = memory_store;
+  for (auto& request : requests) request(memory_store);
+
+  EXPECT_THAT(read_future.result(),
+              ::testing::Optional(tensorstore::MakeOffsetArray<uint16_t>(
+                  {1, 1}, {{42, 42, 42, 42},
+                           {42, 42, 42, 42},
+                           {42, 42, 42, 42},
+                           {42, 42, 42, 42}})));
+}
+
 TEST(ZarrDriverTest, CodecLifetime) {
   tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
   tensorstore::Future<const void> future;
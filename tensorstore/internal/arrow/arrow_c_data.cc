@@ -0,0 +1,507 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/arrow/arrow_c_data.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/element_pointer.h"
+#include "tensorstore/util/extents.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_arrow {
+namespace {
+
+constexpr std::string_view kExtensionNameKey = "ARROW:extension:name";
+constexpr std::string_view kExtensionMetadataKey = "ARROW:extension:metadata";
+constexpr std::string_view kFixedShapeTensor = "arrow.fixed_shape_tensor";
+constexpr std::string_view kExtensionPrefix = "tensorstore.";
+
+/// Arrow type corresponding to a data type.
+struct ArrowType {
+  std::string format;
+  /// Extension name, or empty for none.
+  std::string extension_name;
+};
+
+Result<ArrowType> GetArrowType(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::bool_t:
+      return ArrowType{"b"};
+    case DataTypeId::int8_t:
+      return ArrowType{"c"};
+    case DataTypeId::uint8_t:
+      return ArrowType{"C"};
+    case DataTypeId::int16_t:
+      return ArrowType{"s"};
+    case DataTypeId::uint16_t:
+      return ArrowType{"S"};
+    case DataTypeId::int32_t:
+      return ArrowType{"i"};
+    case DataTypeId::uint32_t:
+      return ArrowType{"I"};
+    case DataTypeId::int64_t:
+      return ArrowType{"l"};
+    case DataTypeId::uint64_t:
+      return ArrowType{"L"};
+    case DataTypeId::float16_t:
+      return ArrowType{"e"};
+    case DataTypeId::float32_t:
+      return ArrowType{"f"};
+    case DataTypeId::float64_t:
+      return ArrowType{"g"};
+    case DataTypeId::string_t:
+      return ArrowType{"Z"};
+    case DataTypeId::ustring_t:
+      return ArrowType{"U"};
+    case DataTypeId::json_t:
+    case DataTypeId::custom:
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Data type ", dtype,
+          " is not supported by the Arrow C data interface"));
+    default:
+      return ArrowType{tensorstore::StrCat("w:", dtype.size()),
+                       tensorstore::StrCat(kExtensionPrefix, dtype.name())};
+  }
+}
+
+Result<DataType> GetDataTypeFromArrow(std::string_view format,
+                                      std::string_view extension_name) {
+  if (absl::StartsWith(extension_name, kExtensionPrefix)) {
+    DataType dtype = tensorstore::GetDataType(
+        extension_name.substr(kExtensionPrefix.size()));
+    if (dtype.valid() &&
+        format == tensorstore::StrCat("w:", dtype.size())) {
+      return dtype;
+    }
+  } else if (format.size() == 1) {
+    switch (format[0]) {
+      case 'b':
+        return dtype_v<bool>;
+      case 'c':
+        return dtype_v<int8_t>;
+      case 'C':
+        return dtype_v<uint8_t>;
+      case 's':
+        return dtype_v<int16_t>;
+      case 'S':
+        return dtype_v<uint16_t>;
+      case 'i':
+        return dtype_v<int32_t>;
+      case 'I':
+        return dtype_v<uint32_t>;
+      case 'l':
+        return dtype_v<int64_t>;
+      case 'L':
+        return dtype_v<uint64_t>;
+      case 'e':
+        return dtype_v<dtypes::float16_t>;
+      case 'f':
+        return dtype_v<dtypes::float32_t>;
+      case 'g':
+        return dtype_v<dtypes::float64_t>;
+      case 'z':
+      case 'Z':
+        return dtype_v<dtypes::string_t>;
+      case 'u':
+      case 'U':
+        return dtype_v<dtypes::ustring_t>;
+    }
+  }
+  return absl::InvalidArgumentError(tensorstore::StrCat(
+      "Arrow format ", QuoteString(format),
+      extension_name.empty() ? std::string()
+                             : tensorstore::StrCat(" with extension ",
+                                                   QuoteString(extension_name)),
+      " is not supported"));
+}
+
+// Schema metadata is encoded as an int32 number of pairs, followed by each key
+// and value as an int32 length and the bytes.
+
+void AppendInt32(std::string& out, int32_t x) {
+  out.append(reinterpret_cast<const char*>(&x), sizeof(x));
+}
+
+std::string EncodeMetadata(
+    std::initializer_list<std::pair<std::string_view, std::string_view>>
+        pairs) {
+  std::string out;
+  AppendInt32(out, pairs.size());
+  for (const auto& [key, value] : pairs) {
+    AppendInt32(out, key.size());
+    out.append(key);
+    AppendInt32(out, value.size());
+    out.append(value);
+  }
+  return out;
+}
+
+std::optional<std::string_view> FindMetadata(const char* metadata,
+                                             std::string_view key) {
+  if (!metadata) return std::nullopt;
+  const auto read_int32 = [&] {
+    int32_t x;
+    memcpy(&x, metadata, sizeof(x));
+    metadata += sizeof(x);
+    return x;
+  };
+  for (int32_t n = read_int32(); n > 0; --n) {
+    std::string_view k(metadata + sizeof(int32_t), read_int32());
+    metadata += k.size();
+    std::string_view v(metadata + sizeof(int32_t), read_int32());
+    metadata += v.size();
+    if (k == key) return v;
+  }
+  return std::nullopt;
+}
+
+// -----------------------------------------------------------------------------
+// Export
+
+/// Private data of an exported `ArrowSchema`.
+struct ExportedSchema {
+  std::string format;
+  std::string name;
+  std::string metadata;
+  ArrowSchema child;
+  ArrowSchema* children[1];
+};
+
+void ReleaseSchema(ArrowSchema* schema) {
+  for (int64_t i = 0; i < schema->n_children; ++i) {
+    ArrowSchema* child = schema->children[i];
+    if (child->release) child->release(child);
+  }
+  delete static_cast<ExportedSchema*>(schema->private_data);
+  schema->release = nullptr;
+}
+
+ExportedSchema* ExportSchema(std::string format, std::string name,
+                             std::string metadata, ArrowSchema* schema) {
+  auto* exported = new ExportedSchema;
+  exported->format = std::move(format);
+  exported->name = std::move(name);
+  exported->metadata = std::move(metadata);
+  *schema = ArrowSchema{};
+  schema->format = exported->format.c_str();
+  schema->name = exported->name.c_str();
+  schema->metadata =
+      exported->metadata.empty() ? nullptr : exported->metadata.data();
+  schema->release = &ReleaseSchema;
+  schema->private_data = exported;
+  return exported;
+}
+
+void ExportValueSchema(const ArrowType& type, std::string name,
+                       ArrowSchema* schema) {
+  ExportSchema(type.format, std::move(name),
+               type.extension_name.empty()
+                   ? std::string()
+                   : EncodeMetadata({{kExtensionNameKey, type.extension_name},
+                                     {kExtensionMetadataKey, ""}}),
+               schema);
+}
+
+/// Private data of an exported `ArrowArray`.
+struct ExportedArray {
+  /// Keeps the data buffer alive.
+  SharedArray<const void> data;
+  std::vector<uint8_t> bitmap;
+  std::vector<int64_t> offsets;
+  std::string string_data;
+  const void* buffers[3] = {};
+  ArrowArray child;
+  ArrowArray* children[1];
+};
+
+void ReleaseArray(ArrowArray* array) {
+  for (int64_t i = 0; i < array->n_children; ++i) {
+    ArrowArray* child = array->children[i];
+    if (child->release) child->release(child);
+  }
+  delete static_cast<ExportedArray*>(array->private_data);
+  array->release = nullptr;
+}
+
+ExportedArray* ExportArrayStruct(int64_t length, int64_t n_buffers,
+                                 ArrowArray* out) {
+  auto* exported = new ExportedArray;
+  *out = ArrowArray{};
+  out->length = length;
+  out->n_buffers = n_buffers;
+  out->buffers = exported->buffers;
+  out->release = &ReleaseArray;
+  out->private_data = exported;
+  return exported;
+}
+
+template <typename String>
+void ExportStrings(const String* values, Index n, ExportedArray& exported) {
+  exported.offsets.resize(n + 1);
+  exported.offsets[0] = 0;
+  for (Index i = 0; i < n; ++i) {
+    if constexpr (std::is_same_v<String, dtypes::ustring_t>) {
+      exported.string_data.append(values[i].utf8);
+    } else {
+      exported.string_data.append(values[i]);
+    }
+    exported.offsets[i + 1] = exported.string_data.size();
+  }
+  exported.buffers[1] = exported.offsets.data();
+  exported.buffers[2] = exported.string_data.data();
+}
+
+/// Exports the elements of the C-contiguous `array` as a primitive array.
+void ExportValues(SharedArray<const void> array, ArrowArray* out) {
+  const Index n = array.num_elements();
+  const DataTypeId id = array.dtype().id();
+  const bool is_string =
+      id == DataTypeId::string_t || id == DataTypeId::ustring_t;
+  auto* exported = ExportArrayStruct(n, is_string ? 3 : 2, out);
+  switch (id) {
+    case DataTypeId::bool_t: {
+      const auto* values = static_cast<const bool*>(array.data());
+      exported->bitmap.assign((n + 7) / 8, 0);
+      for (Index i = 0; i < n; ++i) {
+        exported->bitmap[i / 8] |= static_cast<uint8_t>(values[i]) << (i % 8);
+      }
+      exported->buffers[1] = exported->bitmap.data();
+      break;
+    }
+    case DataTypeId::string_t:
+      ExportStrings(static_cast<const dtypes::string_t*>(array.data()), n,
+                    *exported);
+      break;
+    case DataTypeId::ustring_t:
+      ExportStrings(static_cast<const dtypes::ustring_t*>(array.data()), n,
+                    *exported);
+      break;
+    default:
+      exported->buffers[1] = array.data();
+      exported->data = std::move(array);
+      break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Import
+
+absl::Status CheckNoNulls(const ArrowArray& array) {
+  if (array.null_count != 0 && array.n_buffers > 0 && array.buffers[0]) {
+    return absl::InvalidArgumentError(
+        "Arrow arrays with null values are not supported");
+  }
+  return absl::OkStatus();
+}
+
+template <typename Offset, typename String>
+void ImportStrings(const ArrowArray& values, Index offset, Index n,
+                   String* out) {
+  const auto* offsets = static_cast<const Offset*>(values.buffers[1]) + offset;
+  const auto* data = static_cast<const char*>(values.buffers[2]);
+  for (Index i = 0; i < n; ++i) {
+    std::string_view s(data + offsets[i], offsets[i + 1] - offsets[i]);
+    if constexpr (std::is_same_v<String, dtypes::ustring_t>) {
+      out[i].utf8 = std::string(s);
+    } else {
+      out[i] = std::string(s);
+    }
+  }
+}
+
+}  // namespace
+
+absl::Status ExportArray(SharedArray<const void> array, ArrowSchema* schema,
+                         ArrowArray* out) {
+  const DimensionIndex rank = array.rank();
+  if (rank == 0) {
+    return absl::InvalidArgumentError(
+        "Arrays of rank 0 cannot be exported as Arrow arrays");
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto type, GetArrowType(array.dtype()));
+  if (!IsContiguousLayout(array, c_order)) {
+    array = MakeCopy(array);
+  }
+  if (rank == 1) {
+    ExportValueSchema(type, "", schema);
+    ExportValues(std::move(array), out);
+    return absl::OkStatus();
+  }
+  const auto inner_shape = span(array.shape()).subspan(1);
+  const Index list_size = ProductOfExtents(inner_shape);
+  ::nlohmann::json::array_t json_shape(inner_shape.begin(), inner_shape.end());
+  auto* exported_schema = ExportSchema(
+      tensorstore::StrCat("+w:", list_size), "",
+      EncodeMetadata({{kExtensionNameKey, kFixedShapeTensor},
+                      {kExtensionMetadataKey,
+                       ::nlohmann::json{{"shape", json_shape}}.dump()}}),
+      schema);
+  ExportValueSchema(type, "item", &exported_schema->child);
+  exported_schema->children[0] = &exported_schema->child;
+  schema->n_children = 1;
+  schema->children = exported_schema->children;
+
+  auto* exported = ExportArrayStruct(array.shape()[0], 1, out);
+  ExportValues(std::move(array), &exported->child);
+  exported->children[0] = &exported->child;
+  out->n_children = 1;
+  out->children = exported->children;
+  return absl::OkStatus();
+}
+
+Result<SharedArray<const void>> ImportArray(ArrowArray* array,
+                                            const ArrowSchema& schema) {
+  if (!array->release) {
+    return absl::InvalidArgumentError("Arrow array has been released");
+  }
+  std::shared_ptr<ArrowArray> owner(new ArrowArray(*array),
+                                    [](ArrowArray* array) {
+                                      if (array->release) {
+                                        array->release(array);
+                                      }
+                                      delete array;
+                                    });
+  array->release = nullptr;
+
+  std::vector<Index> shape{owner->length};
+  Index offset = owner->offset;
+  const ArrowSchema* value_schema = &schema;
+  const ArrowArray* values = owner.get();
+  std::string_view format = schema.format;
+  const auto extension_name = FindMetadata(schema.metadata, kExtensionNameKey);
+  if (absl::StartsWith(format, "+w:")) {
+    Index list_size;
+    if (!absl::SimpleAtoi(format.substr(3), &list_size) || list_size < 0 ||
+        schema.n_children != 1 || owner->n_children != 1) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Invalid Arrow fixed-size list format ", QuoteString(format)));
+    }
+    TENSORSTORE_RETURN_IF_ERROR(CheckNoNulls(*owner));
+    if (extension_name == kFixedShapeTensor) {
+      auto metadata = ::nlohmann::json::parse(
+          FindMetadata(schema.metadata, kExtensionMetadataKey).value_or(""),
+          nullptr, /*allow_exceptions=*/false);
+      const auto invalid = [&] {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Unsupported ", kFixedShapeTensor, " metadata: ", metadata.dump()));
+      };
+      if (!metadata.is_object() || !metadata.contains("shape") ||
+          !metadata["shape"].is_array()) {
+        return invalid();
+      }
+      for (const auto& x : metadata["shape"]) {
+        if (!x.is_number_integer() || x.get<Index>() < 0) return invalid();
+        shape.push_back(x.get<Index>());
+      }
+      if (auto it = metadata.find("permutation"); it != metadata.end()) {
+        // Only the identity permutation is supported.
+        if (!it->is_array()) return invalid();
+        for (size_t i = 0; i < it->size(); ++i) {
+          if ((*it)[i] != i) return invalid();
+        }
+      }
+      if (ProductOfExtents(span(shape).subspan(1)) != list_size) {
+        return invalid();
+      }
+    } else {
+      shape.push_back(list_size);
+    }
+    value_schema = schema.children[0];
+    values = owner->children[0];
+    offset = offset * list_size + values->offset;
+  } else if (extension_name == kFixedShapeTensor) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        kFixedShapeTensor, " must have a fixed-size list storage type"));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      DataType dtype,
+      GetDataTypeFromArrow(
+          value_schema->format,
+          FindMetadata(value_schema->metadata, kExtensionNameKey)
+              .value_or("")));
+  TENSORSTORE_RETURN_IF_ERROR(CheckNoNulls(*values));
+  const Index n = ProductOfExtents(span(shape));
+  if (offset + n > values->offset + values->length) {
+    return absl::InvalidArgumentError(
+        "Arrow array is shorter than indicated by its type");
+  }
+
+  const auto* data = static_cast<const char*>(values->buffers[1]);
+  switch (dtype.id()) {
+    case DataTypeId::bool_t: {
+      auto result = AllocateArray<bool>(shape);
+      for (Index i = 0; i < n; ++i) {
+        const Index j = offset + i;
+        result.data()[i] = (data[j / 8] >> (j % 8)) & 1;
+      }
+      return result;
+    }
+    case DataTypeId::string_t:
+    case DataTypeId::ustring_t: {
+      auto result = AllocateArray(shape, c_order, default_init, dtype);
+      const bool large = value_schema->format[0] == 'Z' ||
+                         value_schema->format[0] == 'U';
+      if (dtype.id() == DataTypeId::string_t) {
+        auto* out = static_cast<dtypes::string_t*>(result.data());
+        large ? ImportStrings<int64_t>(*values, offset, n, out)
+              : ImportStrings<int32_t>(*values, offset, n, out);
+      } else {
+        auto* out = static_cast<dtypes::ustring_t*>(result.data());
+        large ? ImportStrings<int64_t>(*values, offset, n, out)
+              : ImportStrings<int32_t>(*values, offset, n, out);
+      }
+      return result;
+    }
+    default:
+      break;
+  }
+  data += offset * dtype.size();
+  SharedArray<const void> result(
+      SharedElementPointer<const void>(
+          std::shared_ptr<const void>(std::move(owner), data), dtype),
+      shape);
+  if (reinterpret_cast<uintptr_t>(data) % dtype.alignment() != 0) {
+    // Arrow only recommends, but does not require, aligned buffers.
+    return SharedArray<const void>(MakeCopy(result));
+  }
+  return result;
+}
+
+}  // namespace internal_arrow
+}  // namespace tensorstore
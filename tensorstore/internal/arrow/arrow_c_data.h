@@ -0,0 +1,115 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_ARROW_ARROW_C_DATA_H_
+#define TENSORSTORE_INTERNAL_ARROW_ARROW_C_DATA_H_
+
+/// \file
+///
+/// Conversion between arrays and the Arrow C data interface
+/// (https://arrow.apache.org/docs/format/CDataInterface.html), which allows
+/// arrays to be exchanged with Arrow-based libraries without depending on
+/// Arrow, and without copying where the representations agree.
+///
+/// An array of rank 1 corresponds to a primitive Arrow array.  An array of
+/// rank `n > 1` corresponds to an Arrow array of length `shape[0]` of the
+/// canonical `arrow.fixed_shape_tensor` extension type, with shape
+/// `shape[1:]`.
+///
+/// Data types with an Arrow equivalent use it; `bool` values are bit-packed
+/// in Arrow, and `string` and `ustring` values correspond to Arrow
+/// `large_binary` and `large_utf8` values, so these are always copied.  Other
+/// data types, such as `bfloat16`, `float8_e4m3fn` and `complex64`, correspond
+/// to fixed-size binary values with the extension name
+/// `"tensorstore.<dtype>"`.  The `json` data type is not supported.
+
+#include <stdint.h>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/util/result.h"
+
+// ABI defined by the Arrow C data interface specification.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace tensorstore {
+namespace internal_arrow {
+
+/// Exports `array` as an Arrow array.
+///
+/// On success, initializes `*schema` and `*out`, which the caller must
+/// release by invoking their `release` callbacks.  The data is shared with
+/// `array` rather than copied if `array` is C-contiguous.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if `array` has rank 0 or its
+///     data type is not supported.
+absl::Status ExportArray(SharedArray<const void> array, ArrowSchema* schema,
+                         ArrowArray* out);
+
+/// Imports the Arrow array `array` of type `schema`.
+///
+/// Takes ownership of `array`, as if by moving it, even if an error is
+/// returned: `array->release` is set to `nullptr`.  `schema` is not released.
+/// The data is shared rather than copied if the data type permits and the
+/// data buffer is suitably aligned.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if the array contains nulls or
+///     its type is not supported.
+Result<SharedArray<const void>> ImportArray(ArrowArray* array,
+                                            const ArrowSchema& schema);
+
+}  // namespace internal_arrow
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_ARROW_ARROW_C_DATA_H_
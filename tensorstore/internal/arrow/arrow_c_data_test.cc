@@ -0,0 +1,169 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/arrow/arrow_c_data.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/strided_layout.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MakeArray;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::SharedArray;
+using ::tensorstore::internal_arrow::ExportArray;
+using ::tensorstore::internal_arrow::ImportArray;
+
+/// Exports `array` and imports it again.
+tensorstore::Result<SharedArray<const void>> RoundTrip(
+    SharedArray<const void> array) {
+  ArrowSchema schema;
+  ArrowArray arrow_array;
+  TENSORSTORE_RETURN_IF_ERROR(
+      ExportArray(std::move(array), &schema, &arrow_array));
+  auto result = ImportArray(&arrow_array, schema);
+  EXPECT_EQ(nullptr, arrow_array.release);
+  schema.release(&schema);
+  return result;
+}
+
+TEST(ArrowCDataTest, ExportRank1) {
+  auto array = MakeArray<int32_t>({1, 2, 3});
+  ArrowSchema schema;
+  ArrowArray arrow_array;
+  TENSORSTORE_ASSERT_OK(ExportArray(array, &schema, &arrow_array));
+  EXPECT_EQ("i", std::string(schema.format));
+  EXPECT_EQ(0, schema.n_children);
+  EXPECT_EQ(3, arrow_array.length);
+  EXPECT_EQ(2, arrow_array.n_buffers);
+  EXPECT_EQ(nullptr, arrow_array.buffers[0]);
+  // The data buffer is shared, not copied.
+  EXPECT_EQ(array.data(), arrow_array.buffers[1]);
+  arrow_array.release(&arrow_array);
+  schema.release(&schema);
+}
+
+TEST(ArrowCDataTest, ExportRank2) {
+  auto array = MakeArray<float>({{1, 2, 3}, {4, 5, 6}});
+  ArrowSchema schema;
+  ArrowArray arrow_array;
+  TENSORSTORE_ASSERT_OK(ExportArray(array, &schema, &arrow_array));
+  EXPECT_EQ("+w:3", std::string(schema.format));
+  ASSERT_EQ(1, schema.n_children);
+  EXPECT_EQ("f", std::string(schema.children[0]->format));
+  EXPECT_EQ(2, arrow_array.length);
+  ASSERT_EQ(1, arrow_array.n_children);
+  EXPECT_EQ(6, arrow_array.children[0]->length);
+  arrow_array.release(&arrow_array);
+  schema.release(&schema);
+}
+
+TEST(ArrowCDataTest, ExportRank0) {
+  ArrowSchema schema;
+  ArrowArray arrow_array;
+  EXPECT_THAT(
+      ExportArray(tensorstore::MakeScalarArray<int32_t>(1), &schema,
+                  &arrow_array),
+      MatchesStatus(absl::StatusCode::kInvalidArgument, ".*rank 0.*"));
+}
+
+TEST(ArrowCDataTest, ExportJsonUnsupported) {
+  ArrowSchema schema;
+  ArrowArray arrow_array;
+  EXPECT_THAT(
+      ExportArray(MakeArray<::tensorstore::dtypes::json_t>({1, 2}), &schema,
+                  &arrow_array),
+      MatchesStatus(absl::StatusCode::kInvalidArgument, ".*json.*"));
+}
+
+TEST(ArrowCDataTest, RoundTripZeroCopy) {
+  auto array = MakeArray<int64_t>({{1, 2}, {3, 4}, {5, 6}});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, RoundTrip(array));
+  EXPECT_EQ(array, result);
+  EXPECT_EQ(array.data(), result.data());
+}
+
+TEST(ArrowCDataTest, RoundTripRank3) {
+  auto array = MakeArray<uint16_t>({{{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, RoundTrip(array));
+  EXPECT_EQ(array, result);
+}
+
+TEST(ArrowCDataTest, RoundTripNonContiguous) {
+  auto array = MakeArray<int32_t>({{1, 2, 3}, {4, 5, 6}});
+  // Transposed view of `array`.
+  SharedArray<const void> transposed(
+      array.element_pointer(),
+      tensorstore::StridedLayout<>({3, 2}, {4, 12}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, RoundTrip(transposed));
+  EXPECT_EQ(MakeArray<int32_t>({{1, 4}, {2, 5}, {3, 6}}), result);
+}
+
+TEST(ArrowCDataTest, RoundTripBool) {
+  auto array = MakeArray<bool>(
+      {{true, false, true}, {false, false, true}, {true, true, true}});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, RoundTrip(array));
+  EXPECT_EQ(array, result);
+}
+
+TEST(ArrowCDataTest, RoundTripStrings) {
+  using ::tensorstore::dtypes::string_t;
+  using ::tensorstore::dtypes::ustring_t;
+  auto strings = MakeArray<string_t>({"a", "", "xyz"});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, RoundTrip(strings));
+  EXPECT_EQ(strings, result);
+  auto ustrings = MakeArray<ustring_t>({{{"a"}, {"bc"}}, {{""}, {"def"}}});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(result, RoundTrip(ustrings));
+  EXPECT_EQ(ustrings, result);
+}
+
+TEST(ArrowCDataTest, RoundTripExtensionType) {
+  using ::tensorstore::dtypes::bfloat16_t;
+  auto array = MakeArray<bfloat16_t>(
+      {{bfloat16_t(1), bfloat16_t(2)}, {bfloat16_t(3), bfloat16_t(4)}});
+  ArrowSchema schema;
+  ArrowArray arrow_array;
+  TENSORSTORE_ASSERT_OK(ExportArray(array, &schema, &arrow_array));
+  EXPECT_EQ("w:2", std::string(schema.children[0]->format));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result,
+                                   ImportArray(&arrow_array, schema));
+  schema.release(&schema);
+  EXPECT_EQ(array, result);
+}
+
+TEST(ArrowCDataTest, ImportRejectsNulls) {
+  auto array = MakeArray<int32_t>({1, 2, 3});
+  ArrowSchema schema;
+  ArrowArray arrow_array;
+  TENSORSTORE_ASSERT_OK(ExportArray(array, &schema, &arrow_array));
+  const uint8_t validity = 0b101;
+  arrow_array.buffers[0] = &validity;
+  arrow_array.null_count = 1;
+  EXPECT_THAT(ImportArray(&arrow_array, schema),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*null values.*"));
+  EXPECT_EQ(nullptr, arrow_array.release);
+  schema.release(&schema);
+}
+
+}  // namespace
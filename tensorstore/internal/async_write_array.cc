@@ -92,6 +92,22 @@ Result<NDIterable::Ptr> AsyncWriteArray::Spec::GetReadNDIterable(
       arena);
 }
 
+Result<SharedOffsetArray<const void>> AsyncWriteArray::Spec::GetReadArray(
+    SharedArrayView<const void> array, span<const Index> origin,
+    IndexTransformView<> chunk_transform) const {
+  if (!array.valid()) array = fill_value;
+  assert(internal::RangesEqual(array.shape(), this->shape()));
+  StridedLayoutView<dynamic_rank, offset_origin> data_layout(
+      origin, shape(), array.byte_strides());
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto transform, ComposeLayoutAndTransform(
+                          data_layout, IndexTransform<>(chunk_transform)));
+  return TryConvertToArray(TransformedArray<Shared<const void>>(
+      AddByteOffset(std::move(array.element_pointer()),
+                    -data_layout.origin_byte_offset()),
+      std::move(transform)));
+}
+
 AsyncWriteArray::MaskedArray::MaskedArray(DimensionIndex rank) : mask(rank) {}
 
 void AsyncWriteArray::MaskedArray::WriteFillValue(const Spec& spec,
@@ -136,6 +136,15 @@ struct AsyncWriteArray {
                                               IndexTransform<> chunk_transform,
                                               Arena* arena) const;
 
+    /// Same as `GetReadNDIterable`, but returns a view of `array` (or of the
+    /// fill value, if `array` is not valid) that shares its data.
+    ///
+    /// \error `absl::StatusCode::kInvalidArgument` if `chunk_transform` uses
+    ///     index arrays.
+    Result<SharedOffsetArray<const void>> GetReadArray(
+        SharedArrayView<const void> array, span<const Index> origin,
+        IndexTransformView<> chunk_transform) const;
+
     size_t EstimateReadStateSizeInBytes(bool valid) const {
       if (!valid) return 0;
       return num_elements() * dtype()->size;
@@ -0,0 +1,328 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file access_trace_replay replays an access trace, recorded by
+/// `tensorstore.experimental_start_access_trace` and
+/// `tensorstore.experimental_stop_access_trace`, against a TensorStore spec
+/// with a possibly different kvstore and context configuration.
+///
+/// Each recorded read and write is issued against the same index transform.
+/// With `--time_scale=1`, each operation is issued at its recorded start
+/// time, which reproduces both the timing and the concurrency of the trace.
+/// With `--time_scale=0`, operations are issued as fast as possible, subject
+/// to the number of operations that were in flight when each was recorded.
+///
+/// The recorded transforms are relative to the base index space of the
+/// TensorStore that was accessed, so `--tensorstore_spec` must not specify
+/// an index transform.
+///
+/// Reports the latency distribution of each operation, the number of bytes
+/// fetched from the kvstore and the cache hit rate as JSON.
+///
+/* Examples
+
+bazel run -c opt \
+  //tensorstore/internal/benchmark:access_trace_replay -- \
+  --trace_kvstore_spec='"file:///tmp/viewer_trace.json"' \
+  --tensorstore_spec='{
+    "driver": "zarr3",
+    "kvstore": "gs://bucket/dataset/"
+  }' \
+  --context_spec='{"cache_pool": {"total_bytes_limit": 1000000000}}'
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/internal/benchmark/metric_utils.h"
+#include "tensorstore/internal/metrics/collect.h"
+#include "tensorstore/internal/metrics/registry.h"
+#include "tensorstore/internal/tracing/access_trace.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/spec.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/json_absl_flag.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::kvstore::Spec>,
+          trace_kvstore_spec, {},
+          "KvStore spec of the JSON access trace to replay.");
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::Spec>, tensorstore_spec, {},
+          "TensorStore spec against which the trace is replayed.");
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::Context::Spec>, context_spec,
+          {}, "Context spec used to open the TensorStore.");
+
+ABSL_FLAG(double, time_scale, 1.0,
+          "Multiplier applied to the recorded start times.  0 issues "
+          "operations as fast as the recorded concurrency allows.");
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::kvstore::Spec>,
+          results_kvstore_spec, {},
+          "KvStore spec to which the results are written as JSON, in "
+          "addition to stdout.");
+
+namespace tensorstore {
+namespace {
+
+using ::tensorstore::internal_tracing::AccessTraceEvent;
+
+// Totals of the metrics used to compute the cache hit rate and the number of
+// bytes fetched.
+struct MetricTotals {
+  int64_t cache_hits = 0;
+  int64_t cache_misses = 0;
+  double bytes_read = 0;
+  int64_t reads_issued = 0;
+
+  static MetricTotals Collect() {
+    MetricTotals totals;
+    auto& registry = internal_metrics::GetMetricRegistry();
+    auto sum_counter = [&](std::string_view name) {
+      int64_t total = 0;
+      if (auto metric = registry.Collect(name)) {
+        for (const auto& v : metric->values) {
+          if (auto* value = std::get_if<int64_t>(&v.value)) total += *value;
+        }
+      }
+      return total;
+    };
+    totals.cache_hits = sum_counter("/tensorstore/cache/hit_count");
+    totals.cache_misses = sum_counter("/tensorstore/cache/miss_count");
+    if (auto metric = registry.Collect("/tensorstore/kvstore/bytes")) {
+      // Fields are the driver and the operation.
+      for (const auto& h : metric->histograms) {
+        if (h.fields.size() == 2 && h.fields[1] == "read") {
+          totals.bytes_read += h.count * h.mean;
+          totals.reads_issued += h.count;
+        }
+      }
+    }
+    return totals;
+  }
+};
+
+// Returns, for each event, the number of recorded events in flight when it
+// started, including itself.  `events` must be ordered by start time.
+std::vector<size_t> GetRecordedConcurrency(
+    const std::vector<AccessTraceEvent>& events) {
+  std::vector<size_t> concurrency;
+  concurrency.reserve(events.size());
+  std::priority_queue<absl::Time, std::vector<absl::Time>,
+                      std::greater<absl::Time>>
+      end_times;
+  for (const auto& event : events) {
+    while (!end_times.empty() && end_times.top() <= event.start_time) {
+      end_times.pop();
+    }
+    end_times.push(event.end_time);
+    concurrency.push_back(end_times.size());
+  }
+  return concurrency;
+}
+
+::nlohmann::json SummarizeLatencies(std::vector<absl::Duration> latencies) {
+  if (latencies.empty()) return {{"count", 0}};
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile_ms = [&](double p) {
+    size_t index = std::min(latencies.size() - 1,
+                            static_cast<size_t>(p * latencies.size()));
+    return absl::ToDoubleMilliseconds(latencies[index]);
+  };
+  return {
+      {"count", latencies.size()},
+      {"mean", absl::ToDoubleMilliseconds(
+                   std::accumulate(latencies.begin(), latencies.end(),
+                                   absl::ZeroDuration()) /
+                   latencies.size())},
+      {"p50", percentile_ms(0.5)},
+      {"p90", percentile_ms(0.9)},
+      {"p99", percentile_ms(0.99)},
+      {"max", percentile_ms(1.0)},
+  };
+}
+
+// State shared by the replayed operations.
+struct ReplayState {
+  absl::Mutex mutex;
+  size_t in_flight ABSL_GUARDED_BY(mutex) = 0;
+  size_t max_in_flight ABSL_GUARDED_BY(mutex) = 0;
+  size_t num_errors ABSL_GUARDED_BY(mutex) = 0;
+  std::vector<absl::Duration> read_latencies ABSL_GUARDED_BY(mutex);
+  std::vector<absl::Duration> write_latencies ABSL_GUARDED_BY(mutex);
+};
+
+AnyFuture IssueOperation(const TensorStore<>& store,
+                         const AccessTraceEvent& event) {
+  auto sliced = store | event.transform;
+  if (!sliced.ok()) return MakeReadyFuture<void>(sliced.status());
+  if (event.op == "read") {
+    return tensorstore::Read(*sliced);
+  }
+  auto source = AllocateArray(sliced->domain().box(), c_order, value_init,
+                              sliced->dtype());
+  return tensorstore::Write(std::move(source), *sliced).commit_future;
+}
+
+void DoAccessTraceReplay() {
+  auto trace_json = internal::ReadMetricCollectionFromKvstore(
+      absl::GetFlag(FLAGS_trace_kvstore_spec).value);
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(
+      auto events, internal_tracing::ParseAccessTrace(trace_json));
+  ABSL_CHECK(!events.empty()) << "Access trace is empty";
+  std::stable_sort(events.begin(), events.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.start_time < b.start_time;
+                   });
+  const auto recorded_concurrency = GetRecordedConcurrency(events);
+  const bool has_writes =
+      std::any_of(events.begin(), events.end(),
+                  [](const auto& event) { return event.op == "write"; });
+
+  Context context(absl::GetFlag(FLAGS_context_spec).value);
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(absl::GetFlag(FLAGS_tensorstore_spec).value, context,
+                        has_writes ? ReadWriteMode::read_write
+                                   : ReadWriteMode::read)
+          .result());
+
+  const double time_scale = absl::GetFlag(FLAGS_time_scale);
+  ABSL_CHECK_GE(time_scale, 0);
+  ABSL_LOG(INFO) << "Replaying " << events.size() << " operations";
+
+  ReplayState state;
+  std::vector<AnyFuture> futures;
+  futures.reserve(events.size());
+  const auto metrics_before = MetricTotals::Collect();
+  const absl::Time trace_origin = events.front().start_time;
+  const absl::Time start_time = absl::Now();
+
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    if (time_scale > 0) {
+      absl::SleepFor(start_time +
+                     (event.start_time - trace_origin) * time_scale -
+                     absl::Now());
+    }
+    {
+      absl::MutexLock lock(&state.mutex);
+      if (time_scale == 0) {
+        auto below_recorded_concurrency = [&] {
+          return state.in_flight < recorded_concurrency[i];
+        };
+        state.mutex.Await(absl::Condition(&below_recorded_concurrency));
+      }
+      ++state.in_flight;
+      state.max_in_flight = std::max(state.max_in_flight, state.in_flight);
+    }
+    const absl::Time op_start_time = absl::Now();
+    auto future = IssueOperation(store, event);
+    future.UntypedExecuteWhenReady([&state, is_read = event.op == "read",
+                                    op_start_time](AnyFuture f) {
+      const absl::Duration latency = absl::Now() - op_start_time;
+      absl::MutexLock lock(&state.mutex);
+      --state.in_flight;
+      if (!f.status().ok()) ++state.num_errors;
+      (is_read ? state.read_latencies : state.write_latencies)
+          .push_back(latency);
+    });
+    futures.push_back(std::move(future));
+  }
+  for (auto& future : futures) future.Wait();
+  absl::MutexLock lock(&state.mutex);
+  // Wait for the callbacks to record the latency of the final operations.
+  auto done = [&] { return state.in_flight == 0; };
+  state.mutex.Await(absl::Condition(&done));
+  const double seconds = absl::ToDoubleSeconds(absl::Now() - start_time);
+  const auto metrics_after = MetricTotals::Collect();
+
+  const int64_t hits = metrics_after.cache_hits - metrics_before.cache_hits;
+  const int64_t misses =
+      metrics_after.cache_misses - metrics_before.cache_misses;
+  const size_t max_recorded_concurrency = *std::max_element(
+      recorded_concurrency.begin(), recorded_concurrency.end());
+  absl::Time trace_end = trace_origin;
+  for (const auto& event : events) {
+    trace_end = std::max(trace_end, event.end_time);
+  }
+
+  ::nlohmann::json report{
+      {"benchmark", "access_trace_replay"},
+      {"timestamp", absl::FormatTime(absl::Now())},
+      {"ops", events.size()},
+      {"errors", state.num_errors},
+      {"seconds", seconds},
+      {"recorded_seconds", absl::ToDoubleSeconds(trace_end - trace_origin)},
+      {"max_concurrency", state.max_in_flight},
+      {"recorded_max_concurrency", max_recorded_concurrency},
+      {"cache_hits", hits},
+      {"cache_misses", misses},
+      {"cache_hit_rate",
+       hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0},
+      {"kvstore_reads", metrics_after.reads_issued -
+                            metrics_before.reads_issued},
+      {"kvstore_bytes_read",
+       metrics_after.bytes_read - metrics_before.bytes_read},
+      {"read_latency_ms", SummarizeLatencies(state.read_latencies)},
+      {"write_latency_ms", SummarizeLatencies(state.write_latencies)},
+  };
+  std::cout << report.dump(2) << std::endl;
+
+  if (absl::GetFlag(FLAGS_results_kvstore_spec).value.valid()) {
+    auto status = internal::WriteMetricCollectionToKvstore(
+        std::move(report), absl::GetFlag(FLAGS_results_kvstore_spec).value,
+        /*final_collect=*/false);
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Failed to write results: " << status;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);  // InitTensorstore
+  tensorstore::DoAccessTraceReplay();
+  return 0;
+}
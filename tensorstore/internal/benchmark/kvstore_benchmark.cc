@@ -26,6 +26,16 @@ bazel run -c opt \
   --repeat_writes=10 \
   --repeat_reads=10
 
+# 1 GB file, bypassing the page cache when writing
+
+bazel run -c opt \
+  //tensorstore/internal/benchmark:kvstore_benchmark -- \
+  --kvstore_spec='"file:///tmp/tensorstore_kvstore_benchmark"' \
+  --clean_before_write \
+  --direct_io \
+  --repeat_writes=10 \
+  --repeat_reads=10
+
 # 4 GB memory, 4MB chunks
 
 bazel run -c opt \
@@ -119,6 +129,9 @@ ABSL_FLAG(bool, clean_before_write, false,
 
 ABSL_FLAG(size_t, read_blowup, 1, "Number of chunk reads for each read loop.");
 
+ABSL_FLAG(bool, direct_io, false,
+          "Enable \"direct_io\" writes; requires a \"file\" kvstore_spec.");
+
 ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::kvstore::Spec>,
           metric_kvstore_spec, {},
           "KvStore spec for writing the metric data in json.  See examples at "
@@ -160,6 +173,9 @@ auto& read_throughput = internal_metrics::Value<double>::New(
   json_metrics.emplace_back(::nlohmann::json{
       {"name", "/per_operation_metrics"},
       {"values", {absl::GetFlag(FLAGS_per_operation_metrics)}}});
+  json_metrics.emplace_back(
+      ::nlohmann::json{{"name", "/direct_io"},
+                       {"values", {absl::GetFlag(FLAGS_direct_io)}}});
 
   return json_metrics;
 }
@@ -178,6 +194,20 @@ void PerOperationMetricCollection(::nlohmann::json* all_metrics,
   }
 }
 
+// When --direct_io is true, returns `kvstore_spec` with "direct_io" enabled.
+kvstore::Spec MaybeEnableDirectIo(kvstore::Spec kvstore_spec) {
+  if (!absl::GetFlag(FLAGS_direct_io)) {
+    return kvstore_spec;
+  }
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(auto json, kvstore_spec.ToJson());
+  ABSL_CHECK(json.is_object() && json.value("driver", "") == "file")
+      << "--direct_io requires a \"file\" kvstore_spec: " << json.dump();
+  json["direct_io"] = true;
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(kvstore_spec,
+                                  kvstore::Spec::FromJson(std::move(json)));
+  return kvstore_spec;
+}
+
 void MaybeCleanExisting(Context context, kvstore::Spec kvstore_spec) {
   // When set, delete the kvstore. For ocdbt, delete everything at "base".
   if (!absl::GetFlag(FLAGS_clean_before_write)) {
@@ -380,7 +410,8 @@ void DoReadBenchmark(Context context, kvstore::Spec kvstore_spec,
 }
 
 void DoKvstoreBenchmark() {
-  auto kvstore_spec = absl::GetFlag(FLAGS_kvstore_spec).value;
+  auto kvstore_spec =
+      MaybeEnableDirectIo(absl::GetFlag(FLAGS_kvstore_spec).value);
   internal::EnsureDirectoryPath(kvstore_spec.path);
 
   Context context(absl::GetFlag(FLAGS_context_spec).value);
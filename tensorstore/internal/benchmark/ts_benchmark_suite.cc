@@ -0,0 +1,483 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file ts_benchmark_suite runs a matrix of end-to-end TensorStore read and
+/// write benchmarks, and reports the results as JSON.
+///
+/// Each profile is a combination of a driver, a codec and a chunk shape.  For
+/// each profile, a new array is created and each access pattern is run,
+/// first writing and then reading.  For each (profile, pattern, operation),
+/// the throughput (MB/s and ops/s) and the latency percentiles of individual
+/// operations are reported.
+///
+/// Access patterns:
+///
+/// - sequential: each chunk-aligned region in C order.
+/// - random: each chunk-aligned region in random order.
+/// - strided: every `--stride`th chunk-aligned region in C order.
+/// - sparse: `--sparse_ops` small, unaligned regions at random positions,
+///   each a quarter of the chunk shape.
+///
+/* Examples
+
+# Default matrix, in memory, results printed to stdout.
+
+bazel run -c opt \
+  //tensorstore/internal/benchmark:ts_benchmark_suite -- \
+  --alsologtostderr
+
+# zarr3 only, on local disk, results written to a file for comparison with
+# other releases.
+
+bazel run -c opt \
+  //tensorstore/internal/benchmark:ts_benchmark_suite -- \
+  --drivers=zarr3 \
+  --codecs=raw,zstd \
+  --chunk_shapes=64x64x64,256x256x16 \
+  --patterns=sequential,random \
+  --shape=1024x1024x256 \
+  --kvstore_spec='"file:///tmp/ts_benchmark_suite/"' \
+  --results_kvstore_spec='"file:///tmp/ts_benchmark_suite.json"'
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/context.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/benchmark/metric_utils.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/json_absl_flag.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+ABSL_FLAG(std::vector<std::string>, drivers,
+          std::vector<std::string>({"zarr", "zarr3", "n5",
+                                    "neuroglancer_precomputed"}),
+          "Drivers to benchmark: zarr, zarr3, n5 and/or "
+          "neuroglancer_precomputed.");
+
+ABSL_FLAG(std::vector<std::string>, codecs,
+          std::vector<std::string>({"raw", "gzip", "zstd", "blosc"}),
+          "Codecs to benchmark: raw, gzip, zstd and/or blosc.  Combinations "
+          "not supported by a driver are skipped.");
+
+ABSL_FLAG(std::vector<std::string>, chunk_shapes,
+          std::vector<std::string>({"64x64x64", "256x256x16"}),
+          "Chunk shapes to benchmark, e.g. 64x64x64.");
+
+ABSL_FLAG(std::vector<std::string>, patterns,
+          std::vector<std::string>({"sequential", "random", "strided",
+                                    "sparse"}),
+          "Access patterns: sequential, random, strided and/or sparse.");
+
+ABSL_FLAG(std::string, shape, "512x512x256", "Shape of the uint8 array.");
+
+ABSL_FLAG(int64_t, stride, 4,
+          "Chunk stride of the 'strided' access pattern.");
+
+ABSL_FLAG(int64_t, sparse_ops, 1024,
+          "Number of operations of the 'sparse' access pattern.");
+
+ABSL_FLAG(int64_t, concurrency, 16,
+          "Maximum number of concurrent read or write operations.");
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::kvstore::Spec>, kvstore_spec,
+          tensorstore::kvstore::Spec::FromJson("memory://").value(),
+          "Base KvStore spec under which each profile is created.");
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::Context::Spec>, context_spec,
+          tensorstore::Context::Spec::FromJson(
+              {{"cache_pool", {{"total_bytes_limit", 0}}}})
+              .value(),
+          "Context spec.  By default, the cache is disabled such that reads "
+          "are served by the kvstore.");
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::kvstore::Spec>,
+          results_kvstore_spec, {},
+          "KvStore spec to which the results are written as JSON, in "
+          "addition to stdout.");
+
+namespace tensorstore {
+namespace {
+
+std::vector<Index> ParseShape(std::string_view text) {
+  std::vector<Index> shape;
+  for (std::string_view part : absl::StrSplit(text, 'x')) {
+    Index size;
+    ABSL_CHECK(absl::SimpleAtoi(part, &size) && size > 0)
+        << "Invalid shape: " << text;
+    shape.push_back(size);
+  }
+  return shape;
+}
+
+struct Profile {
+  std::string driver;
+  std::string codec;
+  std::vector<Index> chunk_shape;
+
+  std::string name() const {
+    return absl::StrCat(driver, "/", codec, "/",
+                        absl::StrJoin(chunk_shape, "x"));
+  }
+};
+
+// Returns the spec of `profile`, or `std::nullopt` if the codec is not
+// supported by the driver.
+std::optional<::nlohmann::json> GetProfileSpec(
+    const Profile& profile, const std::vector<Index>& shape,
+    ::nlohmann::json kvstore) {
+  const auto& codec = profile.codec;
+  const auto& chunks = profile.chunk_shape;
+  ::nlohmann::json spec{{"driver", profile.driver}, {"kvstore", kvstore}};
+  if (profile.driver == "zarr") {
+    ::nlohmann::json compressor;
+    if (codec == "gzip") {
+      compressor = {{"id", "zlib"}, {"level", 6}};
+    } else if (codec == "zstd") {
+      compressor = {{"id", "zstd"}, {"level", 1}};
+    } else if (codec == "blosc") {
+      compressor = {{"id", "blosc"}, {"cname", "lz4"}, {"clevel", 5},
+                    {"shuffle", 1}};
+    } else if (codec != "raw") {
+      return std::nullopt;
+    }
+    spec["metadata"] = {{"dtype", "|u1"},
+                        {"shape", shape},
+                        {"chunks", chunks},
+                        {"compressor", compressor}};
+  } else if (profile.driver == "zarr3") {
+    ::nlohmann::json codecs{{{"name", "bytes"}}};
+    if (codec == "gzip") {
+      codecs.push_back({{"name", "gzip"}, {"configuration", {{"level", 6}}}});
+    } else if (codec == "zstd") {
+      codecs.push_back({{"name", "zstd"}, {"configuration", {{"level", 1}}}});
+    } else if (codec == "blosc") {
+      codecs.push_back({{"name", "blosc"},
+                        {"configuration", {{"cname", "lz4"}, {"clevel", 5}}}});
+    } else if (codec != "raw") {
+      return std::nullopt;
+    }
+    spec["metadata"] = {
+        {"data_type", "uint8"},
+        {"shape", shape},
+        {"chunk_grid",
+         {{"name", "regular"}, {"configuration", {{"chunk_shape", chunks}}}}},
+        {"codecs", codecs}};
+  } else if (profile.driver == "n5") {
+    ::nlohmann::json compression;
+    if (codec == "raw") {
+      compression = {{"type", "raw"}};
+    } else if (codec == "gzip") {
+      compression = {{"type", "gzip"}, {"level", 6}};
+    } else if (codec == "zstd") {
+      compression = {{"type", "zstd"}, {"level", 1}};
+    } else if (codec == "blosc") {
+      compression = {{"type", "blosc"}, {"cname", "lz4"}, {"clevel", 5},
+                     {"shuffle", 1}};
+    } else {
+      return std::nullopt;
+    }
+    spec["metadata"] = {{"dataType", "uint8"},
+                        {"dimensions", shape},
+                        {"blockSize", chunks},
+                        {"compression", compression}};
+  } else if (profile.driver == "neuroglancer_precomputed") {
+    // Only the lossless "raw" encoding supports arbitrary uint8 data.
+    if (codec != "raw" || shape.size() != 3) return std::nullopt;
+    spec["multiscale_metadata"] = {
+        {"data_type", "uint8"}, {"num_channels", 1}, {"type", "image"}};
+    spec["scale_metadata"] = {
+        {"size", shape}, {"chunk_size", chunks}, {"encoding", "raw"}};
+  } else {
+    ABSL_LOG(FATAL) << "Unsupported driver: " << profile.driver;
+  }
+  return spec;
+}
+
+// Returns the regions accessed by `pattern`.  Each region is specified by
+// its origin and shape over the first `shape.size()` dimensions.
+std::vector<Box<>> GetPatternRegions(std::string_view pattern,
+                                     const std::vector<Index>& shape,
+                                     const std::vector<Index>& chunk_shape,
+                                     absl::BitGen& gen) {
+  const DimensionIndex rank = shape.size();
+  std::vector<Box<>> regions;
+  if (pattern == "sparse") {
+    for (int64_t i = 0; i < absl::GetFlag(FLAGS_sparse_ops); ++i) {
+      Box<> region(rank);
+      for (DimensionIndex dim = 0; dim < rank; ++dim) {
+        const Index size = std::min(shape[dim], std::max<Index>(
+                                                    1, chunk_shape[dim] / 4));
+        region.origin()[dim] =
+            absl::Uniform<Index>(gen, 0, shape[dim] - size + 1);
+        region.shape()[dim] = size;
+      }
+      regions.push_back(std::move(region));
+    }
+    return regions;
+  }
+
+  // Enumerate the chunk-aligned regions in C order.
+  std::vector<Index> grid_shape(rank);
+  Index num_cells = 1;
+  for (DimensionIndex dim = 0; dim < rank; ++dim) {
+    grid_shape[dim] = (shape[dim] + chunk_shape[dim] - 1) / chunk_shape[dim];
+    num_cells *= grid_shape[dim];
+  }
+  const Index stride =
+      pattern == "strided" ? std::max<int64_t>(1, absl::GetFlag(FLAGS_stride))
+                           : 1;
+  for (Index cell = 0; cell < num_cells; cell += stride) {
+    Box<> region(rank);
+    Index remainder = cell;
+    for (DimensionIndex dim = rank - 1; dim >= 0; --dim) {
+      const Index origin = (remainder % grid_shape[dim]) * chunk_shape[dim];
+      remainder /= grid_shape[dim];
+      region.origin()[dim] = origin;
+      region.shape()[dim] = std::min(chunk_shape[dim], shape[dim] - origin);
+    }
+    regions.push_back(std::move(region));
+  }
+  if (pattern == "random") {
+    std::shuffle(regions.begin(), regions.end(), gen);
+  } else if (pattern != "sequential" && pattern != "strided") {
+    ABSL_LOG(FATAL) << "Unsupported access pattern: " << pattern;
+  }
+  return regions;
+}
+
+// Returns `store` restricted to `region`, which spans the leading dimensions;
+// any remaining dimensions, such as the channel dimension of
+// neuroglancer_precomputed, are not restricted.
+Result<TensorStore<>> SliceStore(const TensorStore<>& store,
+                                 const Box<>& region) {
+  Box<> box(store.domain().box());
+  for (DimensionIndex dim = 0; dim < region.rank(); ++dim) {
+    box[dim] = region[dim];
+  }
+  return store | AllDims().BoxSlice(box);
+}
+
+// Runs `op` for each region with up to `--concurrency` operations in flight,
+// and returns the throughput and latency summary.
+template <typename Op>
+::nlohmann::json RunOperations(const std::vector<Box<>>& regions, Op op) {
+  const size_t concurrency =
+      std::max<int64_t>(1, absl::GetFlag(FLAGS_concurrency));
+  std::vector<absl::Duration> latencies(regions.size());
+  std::deque<AnyFuture> pending;
+  absl::Status status;
+  int64_t bytes = 0;
+
+  const absl::Time start_time = absl::Now();
+  for (size_t i = 0; i < regions.size(); ++i) {
+    bytes += regions[i].num_elements();
+    const absl::Time op_start_time = absl::Now();
+    AnyFuture future = op(regions[i]);
+    future.UntypedExecuteWhenReady([&latencies, i, op_start_time](AnyFuture) {
+      latencies[i] = absl::Now() - op_start_time;
+    });
+    pending.push_back(std::move(future));
+    while (pending.size() >= concurrency) {
+      status.Update(pending.front().status());
+      pending.pop_front();
+    }
+  }
+  for (auto& future : pending) status.Update(future.status());
+  const double seconds = absl::ToDoubleSeconds(absl::Now() - start_time);
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile_ms = [&](double p) {
+    if (latencies.empty()) return 0.0;
+    size_t index = std::min(latencies.size() - 1,
+                            static_cast<size_t>(p * latencies.size()));
+    return absl::ToDoubleMilliseconds(latencies[index]);
+  };
+  const double mean_ms =
+      latencies.empty()
+          ? 0.0
+          : absl::ToDoubleMilliseconds(
+                std::accumulate(latencies.begin(), latencies.end(),
+                                absl::ZeroDuration()) /
+                latencies.size());
+
+  ::nlohmann::json result{
+      {"ops", regions.size()},
+      {"bytes", bytes},
+      {"seconds", seconds},
+      {"mb_per_second", seconds > 0 ? bytes / seconds / 1e6 : 0.0},
+      {"ops_per_second", seconds > 0 ? regions.size() / seconds : 0.0},
+      {"latency_ms",
+       {{"mean", mean_ms},
+        {"p50", percentile_ms(0.5)},
+        {"p90", percentile_ms(0.9)},
+        {"p99", percentile_ms(0.99)},
+        {"max", percentile_ms(1.0)}}},
+  };
+  if (!status.ok()) result["error"] = status.ToString();
+  return result;
+}
+
+// Returns a compressible uint8 array of the specified shape.
+SharedArray<uint8_t> MakeSourceArray(span<const Index> shape) {
+  auto array = AllocateArray<uint8_t>(shape);
+  uint8_t* data = array.data();
+  for (Index i = 0; i < array.num_elements(); ++i) {
+    data[i] = static_cast<uint8_t>((i * 7) >> 4);
+  }
+  return array;
+}
+
+::nlohmann::json RunProfile(const Profile& profile,
+                            const std::vector<Index>& shape,
+                            const Context& context, absl::BitGen& gen) {
+  ::nlohmann::json results = ::nlohmann::json::array_t();
+  auto kvstore_spec = absl::GetFlag(FLAGS_kvstore_spec).value;
+  kvstore_spec.AppendPathComponent(absl::StrCat(
+      profile.driver, "_", profile.codec, "_",
+      absl::StrJoin(profile.chunk_shape, "x"), "/"));
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(auto kvstore_json, kvstore_spec.ToJson());
+  auto spec = GetProfileSpec(profile, shape, kvstore_json);
+  if (!spec) {
+    ABSL_LOG(INFO) << "Skipping unsupported profile " << profile.name();
+    return results;
+  }
+
+  auto store_result = tensorstore::Open(*spec, context,
+                                        OpenMode::create |
+                                            OpenMode::delete_existing,
+                                        ReadWriteMode::read_write)
+                          .result();
+  if (!store_result.ok()) {
+    ABSL_LOG(ERROR) << "Failed to open " << profile.name() << ": "
+                    << store_result.status();
+    results.push_back({{"profile", profile.name()},
+                       {"error", store_result.status().ToString()}});
+    return results;
+  }
+  const TensorStore<> store = *std::move(store_result);
+
+  for (const auto& pattern : absl::GetFlag(FLAGS_patterns)) {
+    auto regions = GetPatternRegions(pattern, shape, profile.chunk_shape, gen);
+    auto make_result = [&](std::string_view operation,
+                           ::nlohmann::json summary) {
+      summary["profile"] = profile.name();
+      summary["driver"] = profile.driver;
+      summary["codec"] = profile.codec;
+      summary["chunk_shape"] = profile.chunk_shape;
+      summary["shape"] = shape;
+      summary["pattern"] = pattern;
+      summary["operation"] = operation;
+      ABSL_LOG(INFO) << summary.dump();
+      return summary;
+    };
+
+    results.push_back(make_result(
+        "write",
+        RunOperations(regions, [&](const Box<>& region) -> AnyFuture {
+          auto sliced = SliceStore(store, region);
+          if (!sliced.ok()) return MakeReadyFuture<void>(sliced.status());
+          auto source = MakeSourceArray(sliced->domain().shape());
+          return tensorstore::Write(source, *sliced).commit_future;
+        })));
+
+    results.push_back(make_result(
+        "read",
+        RunOperations(regions, [&](const Box<>& region) -> AnyFuture {
+          auto sliced = SliceStore(store, region);
+          if (!sliced.ok()) return MakeReadyFuture<void>(sliced.status());
+          return tensorstore::Read(*sliced);
+        })));
+  }
+  return results;
+}
+
+void DoTsBenchmarkSuite() {
+  const auto shape = ParseShape(absl::GetFlag(FLAGS_shape));
+  Context context(absl::GetFlag(FLAGS_context_spec).value);
+  absl::BitGen gen;
+
+  ::nlohmann::json results = ::nlohmann::json::array_t();
+  for (const auto& driver : absl::GetFlag(FLAGS_drivers)) {
+    for (const auto& codec : absl::GetFlag(FLAGS_codecs)) {
+      for (const auto& chunk_shape_text : absl::GetFlag(FLAGS_chunk_shapes)) {
+        Profile profile{driver, codec, ParseShape(chunk_shape_text)};
+        ABSL_CHECK_EQ(profile.chunk_shape.size(), shape.size())
+            << "Chunk shape " << chunk_shape_text
+            << " does not match the rank of --shape";
+        for (auto& result : RunProfile(profile, shape, context, gen)) {
+          results.push_back(std::move(result));
+        }
+      }
+    }
+  }
+
+  ::nlohmann::json report{
+      {"benchmark", "ts_benchmark_suite"},
+      {"timestamp", absl::FormatTime(absl::Now())},
+      {"results", results},
+  };
+  std::cout << report.dump(2) << std::endl;
+
+  if (absl::GetFlag(FLAGS_results_kvstore_spec).value.valid()) {
+    auto status = internal::WriteMetricCollectionToKvstore(
+        std::move(report), absl::GetFlag(FLAGS_results_kvstore_spec).value,
+        /*final_collect=*/false);
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Failed to write results: " << status;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);  // InitTensorstore
+  tensorstore::DoTsBenchmarkSuite();
+  return 0;
+}
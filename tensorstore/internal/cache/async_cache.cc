@@ -38,10 +38,14 @@
 #include "tensorstore/internal/container/intrusive_linked_list.h"
 #include "tensorstore/internal/container/intrusive_red_black_tree.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/mutex.h"
+#include "tensorstore/internal/tracing/inflight_operation.h"
+#include "tensorstore/internal/tracing/trace_span.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 
@@ -57,6 +61,12 @@ using PendingWritebackQueueAccessor =
     TransactionNode::PendingWritebackQueueAccessor;
 using PrepareForCommitState = TransactionNode::PrepareForCommitState;
 
+auto& writeback_latency_ms =
+    internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
+        "/tensorstore/cache/writeback_latency_ms",
+        "Latency (ms) from the start of writeback of a cache entry until it "
+        "completes.");
+
 // While the real epsilon is `absl::Nanoseconds(1) / 4`, `operator/` is not
 // constexpr, and this value is sufficient for use here.
 constexpr absl::Duration kEpsilonDuration = absl::Nanoseconds(1);
@@ -134,6 +144,8 @@ void EntryOrNodeStartRead(EntryOrNode& entry_or_node,
       std::exchange(request_state.queued_time, absl::InfinitePast());
   request_state.issued = std::move(request_state.queued);
   request_state.queued_request_is_deferred = true;
+  request_state.issued_inflight = internal_tracing::InFlightOperation(
+      "cache.read", QuoteString(GetOwningEntry(entry_or_node).key()));
   lock.unlock();
   AcquireReadRequestReference(entry_or_node);
   ABSL_LOG_IF(INFO, TENSORSTORE_ASYNC_CACHE_DEBUG)
@@ -184,6 +196,15 @@ void MaybeStartReadOrWriteback(Entry& entry, UniqueWriterLock<Entry> lock,
           new_prepare_for_commit_state =
               PrepareForCommitState::kReadyForCommitCalled;
       }
+      if (new_prepare_for_commit_state ==
+              PrepareForCommitState::kReadyForCommitCalled &&
+          existing_prepare_for_commit_state !=
+              PrepareForCommitState::kReadyForCommitCalled) {
+        committing_transaction_node->writeback_start_time_ = absl::Now();
+        committing_transaction_node->writeback_inflight_ =
+            internal_tracing::InFlightOperation(
+                "cache.writeback", QuoteString(entry.key()));
+      }
       committing_transaction_node->prepare_for_commit_state_ =
           new_prepare_for_commit_state;
       next =
@@ -250,6 +271,9 @@ void SetReadState(EntryOrNode& entry_or_node, ReadState&& read_state,
   }
   entry_or_node.read_request_state_.known_to_be_stale = false;
   entry_or_node.read_request_state_.read_state = std::move(read_state);
+  if constexpr (std::is_same_v<EntryOrNode, Entry>) {
+    entry_or_node.PublishReadStateTime();
+  }
   size_t change =
       read_state_size -
       std::exchange(entry_or_node.read_request_state_.read_state_size,
@@ -307,6 +331,16 @@ Future<const void> RequestRead(EntryOrNode& entry_or_node,
   static_assert(std::is_same_v<EntryOrNode, Entry> ||
                 std::is_same_v<EntryOrNode, TransactionNode>);
   auto& entry = GetOwningEntry(entry_or_node);
+  if constexpr (std::is_same_v<EntryOrNode, Entry>) {
+    // Fast path for reads satisfied by the cached read state, which avoids
+    // contention on the entry mutex for frequently-read entries.  Since
+    // `ToUnixNanos` rounds down, the strict comparison implies that the
+    // read state time is after `staleness_bound`.
+    if (entry.published_read_time_.load(std::memory_order_acquire) >
+        absl::ToUnixNanos(options.staleness_bound)) {
+      return MakeReadyFuture();
+    }
+  }
   UniqueWriterLock lock(entry);
 
   auto& effective_request_state = GetEffectiveReadRequestState(entry_or_node);
@@ -388,6 +422,7 @@ void ResolveIssuedRead(EntryOrNode& entry_or_node, absl::Status status,
                 std::is_same_v<EntryOrNode, TransactionNode>);
   auto& request_state = entry_or_node.read_request_state_;
   auto issued = std::move(request_state.issued);
+  request_state.issued_inflight.reset();
   auto time = GetEffectiveReadRequestState(entry_or_node).read_state.stamp.time;
   assert(!issued.null());
   assert(!status.ok() || time >= request_state.issued_time);
@@ -454,6 +489,10 @@ void ResolveIssuedWriteback(AsyncCache::TransactionNode& node,
   // Read must not be in progress.
   assert(entry.read_request_state_.issued.null());
 
+  writeback_latency_ms.Observe(
+      absl::ToDoubleMilliseconds(absl::Now() - node.writeback_start_time_));
+  node.writeback_inflight_.reset();
+
   if (entry.committing_transaction_node_ != &node) {
     intrusive_linked_list::Remove(PendingWritebackQueueAccessor{}, &node);
   } else {
@@ -501,7 +540,11 @@ Future<const void> AsyncCache::Entry::Read(AsyncCacheReadRequest request,
   ABSL_LOG_IF(INFO, TENSORSTORE_ASYNC_CACHE_DEBUG)
       << *this << "Read: staleness_bound=" << request.staleness_bound
       << ", must_not_be_known_to_be_stale=" << must_not_be_known_to_be_stale;
-  return RequestRead(*this, request, must_not_be_known_to_be_stale);
+  internal_tracing::TraceSpan span("tensorstore.cache.read");
+  auto future = RequestRead(*this, request, must_not_be_known_to_be_stale);
+  // A read satisfied by the cached read state completes immediately.
+  span.SetAttribute("cache_hit", future.ready() && future.status().ok());
+  return internal_tracing::EndWhenReady(std::move(span), std::move(future));
 }
 
 void AsyncCache::Entry::ReadSuccess(ReadState&& read_state) {
@@ -517,6 +560,19 @@ void AsyncCache::Entry::ReadError(absl::Status error) {
   internal::EntryOrNodeReadError(*this, std::move(error));
 }
 
+void AsyncCache::Entry::MarkReadStateStale() {
+  ABSL_LOG_IF(INFO, TENSORSTORE_ASYNC_CACHE_DEBUG)
+      << *this << "MarkReadStateStale";
+  UniqueWriterLock lock(*this);
+  read_request_state_.known_to_be_stale = true;
+  PublishReadStateTime();
+}
+
+bool AsyncCache::Entry::HasTransactionNodes() {
+  UniqueWriterLock lock(*this);
+  return !transactions_.empty() || committing_transaction_node_ != nullptr;
+}
+
 AsyncCache::TransactionNode::TransactionNode(Entry& entry)
     : internal::TransactionState::Node(Cache::PinnedEntry(&entry).release()),
       reads_committed_(false),
@@ -609,6 +665,7 @@ void AsyncCache::TransactionNode::WritebackSuccess(ReadState&& read_state) {
     SetReadState(entry, std::move(read_state), read_state_size);
   } else if (read_state_time > request_state.read_state.stamp.time) {
     request_state.known_to_be_stale = true;
+    entry.PublishReadStateTime();
   }
 
   QueuedReadHandler queued_read_handler(request_state, read_state_time);
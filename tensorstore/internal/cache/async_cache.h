@@ -19,8 +19,10 @@
 /// `Cache` class with asynchronous read and read-modify-write functionality.
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <type_traits>
@@ -38,6 +40,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/tagged_ptr.h"
+#include "tensorstore/internal/tracing/inflight_operation.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/any_receiver.h"
@@ -188,6 +191,10 @@ class AsyncCache : public Cache {
     /// Only meaningful if `issued.valid()`.
     absl::Time issued_time;
 
+    /// Registers the read request corresponding to `issued` as an in-flight
+    /// operation.
+    internal_tracing::InFlightOperation issued_inflight;
+
     /// Only meaningful if `queued.valid()`.
     absl::Time queued_time = absl::InfinitePast();
 
@@ -452,6 +459,27 @@ class AsyncCache : public Cache {
     /// state".
     virtual size_t ComputeReadDataSizeInBytes(const void* data);
 
+    /// Marks the cached read state as out-of-date, due to a modification of
+    /// the underlying storage that bypassed this cache.
+    ///
+    /// Subsequent calls to `Read` with `must_not_be_known_to_be_stale=true`
+    /// request newer data even if the existing data satisfies the staleness
+    /// bound.
+    void MarkReadStateStale();
+
+    /// Returns `true` if there are any uncommitted or committing transaction
+    /// nodes associated with this entry.
+    bool HasTransactionNodes();
+
+    /// Returns the data of the current read state.
+    ///
+    /// Unlike `ReadLock`, this acquires `mutex()` in shared mode, such that
+    /// concurrent readers of the same entry do not exclude one another.
+    std::shared_ptr<const void> GetReadStateData() {
+      absl::ReaderMutexLock lock(&mutex());
+      return read_request_state_.read_state.data;
+    }
+
     // Below members should be treated as private:
 
     ReadState& LockReadState() ABSL_NO_THREAD_SAFETY_ANALYSIS {
@@ -459,6 +487,18 @@ class AsyncCache : public Cache {
       return read_request_state_.read_state;
     }
 
+    /// Updates `published_read_time_` to reflect `read_request_state_`.
+    ///
+    /// Must be called with `mutex()` held whenever the read state time or
+    /// `known_to_be_stale` changes.
+    void PublishReadStateTime() {
+      published_read_time_.store(
+          read_request_state_.known_to_be_stale
+              ? std::numeric_limits<int64_t>::min()
+              : absl::ToUnixNanos(read_request_state_.read_state.stamp.time),
+          std::memory_order_release);
+    }
+
     Result<OpenTransactionNodePtr<TransactionNode>> GetTransactionNodeImpl(
         OpenTransactionPtr& transaction);
 
@@ -468,6 +508,13 @@ class AsyncCache : public Cache {
 
     ReadRequestState read_request_state_;
 
+    /// Time of the read state, in nanoseconds since the Unix epoch, or the
+    /// minimum value if the read state is known to be stale.  Allows reads
+    /// satisfied by the cached read state to be detected without acquiring
+    /// `mutex()`.
+    std::atomic<int64_t> published_read_time_{
+        std::numeric_limits<int64_t>::min()};
+
     using TransactionTree =
         internal::intrusive_red_black_tree::Tree<TransactionNode,
                                                  TransactionNode>;
@@ -857,6 +904,14 @@ class AsyncCache : public Cache {
     /// locked.
     bool size_updated_;
 
+    /// Time at which `ReadyForCommit` was called, used to measure the
+    /// writeback latency.  Protected by the owning entry's mutex.
+    absl::Time writeback_start_time_;
+
+    /// Registers the writeback as an in-flight operation from the time
+    /// `ReadyForCommit` is called.  Protected by the owning entry's mutex.
+    internal_tracing::InFlightOperation writeback_inflight_;
+
     /// Indicates whether this transaction node has been revoked.  This may be
     /// set to `true` without holding any locks, but a thread that already owns
     /// a lock on `mutex_` may continue writing.  No writes may be performed if
@@ -345,6 +345,43 @@ TEST(AsyncCacheTest, ReadBasic) {
   }
 }
 
+TEST(AsyncCacheTest, ReadAfterMarkReadStateStale) {
+  auto pool = CachePool::Make(CachePool::Limits{});
+  RequestLog log;
+  auto cache = GetCache<TestCache>(
+      pool.get(), "", [&] { return std::make_unique<TestCache>(&log); });
+  auto entry = GetCacheEntry(cache, "a");
+
+  auto read_time = absl::Now();
+  {
+    auto read_future = entry->Read({absl::InfinitePast()});
+    ASSERT_EQ(1u, log.reads.size());
+    log.reads.pop().Success(read_time);
+    TENSORSTORE_EXPECT_OK(read_future.result());
+  }
+
+  // Satisfied by the cached read state.
+  EXPECT_TRUE(entry->Read({read_time - absl::Seconds(1)}).ready());
+  ASSERT_TRUE(log.reads.empty());
+
+  // Once marked stale, the same staleness bound requires a new read unless
+  // `must_not_be_known_to_be_stale` is `false`.
+  entry->MarkReadStateStale();
+  EXPECT_TRUE(entry->Read({read_time - absl::Seconds(1)},
+                          /*must_not_be_known_to_be_stale=*/false)
+                  .ready());
+  ASSERT_TRUE(log.reads.empty());
+  auto read_future = entry->Read({read_time - absl::Seconds(1)});
+  EXPECT_FALSE(read_future.ready());
+  ASSERT_EQ(1u, log.reads.size());
+  log.reads.pop().Success(UniqueNow());
+  TENSORSTORE_EXPECT_OK(read_future.result());
+
+  // The new read state is again used without issuing a read.
+  EXPECT_TRUE(entry->Read({read_time}).ready());
+  ASSERT_TRUE(log.reads.empty());
+}
+
 TEST(AsyncCacheTest, ReadFailed) {
   auto pool = CachePool::Make(kSmallCacheLimits);
   RequestLog log;
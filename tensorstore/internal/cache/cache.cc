@@ -21,8 +21,10 @@
 #include <atomic>
 #include <bitset>
 #include <cassert>
+#include <limits>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -35,11 +37,16 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/function_ref.h"
+#include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/cache/cache_pool_limits.h"
+#include "tensorstore/internal/cache/compressed_cache_tier.h"
+#include "tensorstore/internal/cache/decoded_chunk_registry.h"
+#include "tensorstore/internal/cache/writeback_scheduler.h"
 #include "tensorstore/internal/container/intrusive_linked_list.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/gauge.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/type_traits.h"
 
@@ -52,12 +59,34 @@
 namespace tensorstore {
 namespace internal_cache {
 
-auto& hit_count = internal_metrics::Counter<int64_t>::New(
+auto& hit_count = internal_metrics::ShardedCounter<int64_t>::New(
     "/tensorstore/cache/hit_count", "Number of cache hits.");
-auto& miss_count = internal_metrics::Counter<int64_t>::New(
+auto& miss_count = internal_metrics::ShardedCounter<int64_t>::New(
     "/tensorstore/cache/miss_count", "Number of cache misses.");
 auto& evict_count = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/cache/evict_count", "Number of evictions from the cache.");
+auto& evict_bytes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/evict_bytes",
+    "Number of bytes evicted from the cache.");
+auto& bytes_resident = internal_metrics::Gauge<int64_t>::New(
+    "/tensorstore/cache/bytes_resident",
+    "Number of bytes held by entries of all cache pools.");
+auto& segmented_lru_hit_count =
+    internal_metrics::ShardedCounter<int64_t, std::string>::New(
+        "/tensorstore/cache/segmented_lru/hit_count", "segment",
+        "Number of cache hits on entries not in use with the segmented LRU "
+        "eviction policy, by segment.");
+auto& segmented_lru_evict_count =
+    internal_metrics::Counter<int64_t, std::string>::New(
+        "/tensorstore/cache/segmented_lru/evict_count", "segment",
+        "Number of evictions with the segmented LRU eviction policy, by "
+        "segment.");
+auto& segmented_lru_promote_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/segmented_lru/promote_count",
+    "Number of entries promoted to the protected segment.");
+auto& segmented_lru_demote_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/segmented_lru/demote_count",
+    "Number of entries demoted from the protected segment.");
 
 using ::tensorstore::internal::PinnedCacheEntry;
 
@@ -75,7 +104,26 @@ CachePoolImpl::CachePoolImpl(const CachePool::Limits& limits)
       total_bytes_(0),
       strong_references_(1),
       weak_references_(1) {
-  Initialize(LruListAccessor{}, &eviction_queue_);
+  for (auto& shard : lru_shards_) {
+    Initialize(LruListAccessor{}, &shard.eviction_queue);
+    Initialize(LruListAccessor{}, &shard.protected_queue);
+    for (auto& sequence : shard.front_sequence) {
+      sequence.store(std::numeric_limits<uint64_t>::max(),
+                     std::memory_order_relaxed);
+    }
+  }
+  if (limits_.total_bytes_limit != 0 && limits_.compressed_bytes_limit != 0) {
+    compressed_tier_ =
+        std::make_unique<CompressedCacheTier>(limits_.compressed_bytes_limit);
+  }
+  if (internal::WritebackScheduler::Enabled(limits_)) {
+    writeback_scheduler_ =
+        std::make_unique<internal::WritebackScheduler>(limits_);
+  }
+  if (limits_.share_decoded_chunks) {
+    decoded_chunk_registry_ =
+        std::make_unique<internal::DecodedChunkRegistry>();
+  }
 }
 
 namespace {
@@ -121,38 +169,174 @@ void UnlinkListNode(LruListNode* node) noexcept {
   Initialize(LruListAccessor{}, node);
 }
 
+using EvictionSegment = CacheEntryImpl::EvictionSegment;
+using LruShard = CachePoolImpl::LruShard;
+
+constexpr uint64_t kEmptyQueueSequence = std::numeric_limits<uint64_t>::max();
+
+const char* GetEvictionSegmentName(EvictionSegment segment) {
+  return segment == EvictionSegment::kProtected ? "protected" : "probationary";
+}
+
+LruListNode* GetEvictionQueue(LruShard& shard, EvictionSegment segment) {
+  return segment == EvictionSegment::kProtected ? &shard.protected_queue
+                                                : &shard.eviction_queue;
+}
+
+// Updates `shard.front_sequence` to reflect the current front of the queue for
+// `segment`.
+void UpdateFrontSequence(LruShard& shard, EvictionSegment segment) noexcept {
+  DebugAssertMutexHeld(&shard.mutex);
+  auto* queue = GetEvictionQueue(shard, segment);
+  shard.front_sequence[static_cast<size_t>(segment)].store(
+      queue->next == queue
+          ? kEmptyQueueSequence
+          : static_cast<CacheEntryImpl*>(queue->next)->queue_sequence_,
+      std::memory_order_relaxed);
+}
+
+// Removes `entry` from the eviction queue, if it is present.
+void UnlinkFromEvictionQueue(CachePoolImpl* pool, LruShard& shard,
+                             CacheEntryImpl* entry) noexcept {
+  DebugAssertMutexHeld(&shard.mutex);
+  if (OnlyContainsNode(LruListAccessor{}, entry)) return;
+  const EvictionSegment segment =
+      entry->eviction_segment_.load(std::memory_order_relaxed);
+  if (segment == EvictionSegment::kProtected) {
+    pool->protected_bytes_.fetch_sub(entry->protected_bytes_,
+                                     std::memory_order_relaxed);
+  }
+  const bool was_front = GetEvictionQueue(shard, segment)->next == entry;
+  UnlinkListNode(entry);
+  if (was_front) UpdateFrontSequence(shard, segment);
+}
+
+// Adds `entry`, which must not already be in the eviction queue, to the most
+// recently used end of the queue for `segment`.
+void AppendToEvictionQueue(CachePoolImpl* pool, LruShard& shard,
+                           CacheEntryImpl* entry,
+                           EvictionSegment segment) noexcept {
+  DebugAssertMutexHeld(&shard.mutex);
+  auto* queue = GetEvictionQueue(shard, segment);
+  const bool was_empty = queue->next == queue;
+  entry->eviction_segment_.store(segment, std::memory_order_relaxed);
+  entry->queue_sequence_ =
+      pool->next_queue_sequence_.fetch_add(1, std::memory_order_relaxed);
+  if (segment == EvictionSegment::kProtected) {
+    // `num_bytes_` cannot change concurrently since the entry is not in use.
+    entry->protected_bytes_ = entry->num_bytes_;
+    pool->protected_bytes_.fetch_add(entry->protected_bytes_,
+                                     std::memory_order_relaxed);
+  }
+  InsertBefore(LruListAccessor{}, queue, entry);
+  if (was_empty) UpdateFrontSequence(shard, segment);
+}
+
 void UnregisterEntryFromPool(CacheEntryImpl* entry,
                              CachePoolImpl* pool) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
-  UnlinkListNode(entry);
+  UnlinkFromEvictionQueue(pool, pool->LruShardForEntry(entry), entry);
   pool->total_bytes_.fetch_sub(entry->num_bytes_, std::memory_order_relaxed);
+  bytes_resident.DecrementBy(entry->num_bytes_);
 }
 
+// Adds `entry`, which is no longer in use, to the most recently used end of the
+// eviction queue.
+//
+// The caller must hold the mutex of the shard of `entry`, and should call
+// `MaybeEvictEntries` after releasing it.
 void AddToEvictionQueue(CachePoolImpl* pool, CacheEntryImpl* entry) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
-  auto* eviction_queue = &pool->eviction_queue_;
-  if (!OnlyContainsNode(LruListAccessor{}, entry)) {
-    Remove(LruListAccessor{}, entry);
+  auto& shard = pool->LruShardForEntry(entry);
+  const EvictionSegment old_segment =
+      entry->eviction_segment_.load(std::memory_order_relaxed);
+  UnlinkFromEvictionQueue(pool, shard, entry);
+  if (pool->limits_.eviction_policy != CacheEvictionPolicy::kSegmentedLru ||
+      !entry->reused_.exchange(false, std::memory_order_relaxed)) {
+    AppendToEvictionQueue(pool, shard, entry, EvictionSegment::kProbationary);
+    return;
+  }
+
+  // Entry was used again after becoming idle; move it to the most recently
+  // used end of the protected segment.
+  if (old_segment != EvictionSegment::kProtected) {
+    segmented_lru_promote_count.Increment();
   }
-  InsertBefore(LruListAccessor{}, eviction_queue, entry);
+  AppendToEvictionQueue(pool, shard, entry, EvictionSegment::kProtected);
+}
+
+// Returns the shard whose queue for `segment` has the least recently used front
+// entry, or `nullptr` if the queues of all shards are empty.
+//
+// Since no mutex is held, the result may be outdated by the time the shard is
+// locked.
+LruShard* FindShardWithOldestEntry(CachePoolImpl* pool,
+                                   EvictionSegment segment) noexcept {
+  LruShard* oldest_shard = nullptr;
+  uint64_t oldest_sequence = kEmptyQueueSequence;
+  for (auto& shard : pool->lru_shards_) {
+    const uint64_t sequence =
+        shard.front_sequence[static_cast<size_t>(segment)].load(
+            std::memory_order_relaxed);
+    if (sequence < oldest_sequence) {
+      oldest_sequence = sequence;
+      oldest_shard = &shard;
+    }
+  }
+  return oldest_shard;
 }
 
 void DestroyCache(CachePoolImpl* pool, CacheImpl* cache);
 
+// Demotes and evicts entries as needed to satisfy the limits of `pool`.
+//
+// Must be called without holding the mutex of any shard.
 void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
+  if (pool->limits_.eviction_policy == CacheEvictionPolicy::kSegmentedLru) {
+    // Demote the least recently used protected entries to the most recently
+    // used end of the probationary segment, where they get another chance to
+    // be reused before being evicted.
+    const size_t protected_bytes_limit =
+        pool->limits_.total_bytes_limit / 100 *
+        CachePoolLimits::kProtectedSegmentPercent;
+    while (pool->protected_bytes_.load(std::memory_order_relaxed) >
+           protected_bytes_limit) {
+      auto* shard = FindShardWithOldestEntry(pool, EvictionSegment::kProtected);
+      if (!shard) break;
+      absl::MutexLock lock(&shard->mutex);
+      auto* queue = &shard->protected_queue;
+      if (queue->next == queue) continue;
+      auto* demoted = static_cast<CacheEntryImpl*>(queue->next);
+      UnlinkFromEvictionQueue(pool, *shard, demoted);
+      AppendToEvictionQueue(pool, *shard, demoted,
+                            EvictionSegment::kProbationary);
+      segmented_lru_demote_count.Increment();
+    }
+  }
 
   constexpr size_t kBufferSize = 64;
   std::array<CacheEntryImpl*, kBufferSize> entries_to_delete;
   // Indicates for each entry in `entries_to_delete` whether its cache should
   // also be deleted.
   std::bitset<kBufferSize> should_delete_cache_for_entry;
+  // Encoders, and the corresponding cache ids, for entries to be retained in
+  // the compressed tier.  These are invoked without holding any shard mutex.
+  std::array<Cache::EvictedEntryEncoder, kBufferSize> encoders;
+  std::array<uint64_t, kBufferSize> encoder_cache_ids;
   size_t num_entries_to_delete = 0;
 
   const auto destroy_entries = [&] {
-    internal::ScopedWriterUnlock unlock(pool->lru_mutex_);
     for (size_t i = 0; i < num_entries_to_delete; ++i) {
       auto* entry = entries_to_delete[i];
+      if (auto& encoder = encoders[i]) {
+        // If the cache was concurrently destroyed, the inserted value is never
+        // retrieved (since cache ids are not reused) and is eventually
+        // discarded by the compressed tier.
+        if (auto value = std::move(encoder)()) {
+          pool->compressed_tier_->Insert(encoder_cache_ids[i],
+                                         std::move(entry->key_),
+                                         *std::move(value));
+        }
+        encoder = nullptr;
+      }
       if (should_delete_cache_for_entry[i]) {
         DestroyCache(entry->cache_->pool_, entry->cache_);
       }
@@ -160,54 +344,84 @@ void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
       entry->cache_ = nullptr;
       delete Access::StaticCast<CacheEntry>(entry);
     }
+    num_entries_to_delete = 0;
   };
 
   while (pool->total_bytes_.load(std::memory_order_acquire) >
          pool->limits_.total_bytes_limit) {
-    auto* queue = &pool->eviction_queue_;
-    if (queue->next == queue) {
+    // With `CacheEvictionPolicy::kSegmentedLru`, entries in the protected
+    // segment are evicted only once the probationary segment is empty.
+    auto* shard = FindShardWithOldestEntry(pool, EvictionSegment::kProbationary);
+    if (!shard) {
+      shard = FindShardWithOldestEntry(pool, EvictionSegment::kProtected);
+    }
+    if (!shard) {
       // Queue empty.
       break;
     }
-    auto* entry = static_cast<CacheEntryImpl*>(queue->next);
-    auto* cache = entry->cache_;
-    bool evict = false;
-    bool should_delete_cache = false;
-    auto& shard = cache->ShardForKey(entry->key_);
-    if (absl::MutexLock lock(&shard.mutex);
-        entry->reference_count_.load(std::memory_order_acquire) == 0) {
-      [[maybe_unused]] size_t erase_count = shard.entries.erase(entry);
-      assert(erase_count == 1);
-      if (shard.entries.empty()) {
-        if (DecrementCacheReferenceCount(cache,
-                                         CacheImpl::kNonEmptyShardIncrement)
-                .should_delete()) {
-          should_delete_cache = true;
+    {
+      absl::MutexLock lru_lock(&shard->mutex);
+      auto* queue = &shard->eviction_queue;
+      if (queue->next == queue) {
+        queue = &shard->protected_queue;
+      }
+      if (queue->next == queue) {
+        // Shard was emptied concurrently.
+        continue;
+      }
+      auto* entry = static_cast<CacheEntryImpl*>(queue->next);
+      auto* cache = entry->cache_;
+      bool evict = false;
+      bool should_delete_cache = false;
+      auto& cache_shard = cache->ShardForKey(entry->key_);
+      if (absl::MutexLock lock(&cache_shard.mutex);
+          entry->reference_count_.load(std::memory_order_acquire) == 0) {
+        [[maybe_unused]] size_t erase_count = cache_shard.entries.erase(entry);
+        assert(erase_count == 1);
+        if (cache_shard.entries.empty()) {
+          if (DecrementCacheReferenceCount(cache,
+                                           CacheImpl::kNonEmptyShardIncrement)
+                  .should_delete()) {
+            should_delete_cache = true;
+          }
         }
+        evict = true;
       }
-      evict = true;
-    }
-    if (!evict) {
-      // Entry is still in use, remove it from LRU eviction list.  For
-      // efficiency, entries aren't removed from the eviction list when the
-      // reference count increases.  It will be put back on the eviction list
-      // the next time the reference count becomes 0.  There is no race
-      // condition here because both `cache->entries_mutex_` and
-      // `pool->lru_mutex_` are held, and the reference count cannot increase
-      // from zero except while holding `cache->entries_mutex_`, and the
-      // reference count cannot decrease to zero except while holding
-      // `pool->lru_mutex_`.
-      UnlinkListNode(entry);
-      continue;
+      if (!evict) {
+        // Entry is still in use, remove it from LRU eviction list.  For
+        // efficiency, entries aren't removed from the eviction list when the
+        // reference count increases.  It will be put back on the eviction list
+        // the next time the reference count becomes 0.  There is no race
+        // condition here because both `cache_shard.mutex` and `shard->mutex`
+        // are held, and the reference count cannot increase from zero except
+        // while holding `cache_shard.mutex`, and the reference count cannot
+        // decrease to zero except while holding `shard->mutex`.
+        UnlinkFromEvictionQueue(pool, *shard, entry);
+        continue;
+      }
+      if (pool->limits_.eviction_policy ==
+          CacheEvictionPolicy::kSegmentedLru) {
+        segmented_lru_evict_count.Increment(GetEvictionSegmentName(
+            entry->eviction_segment_.load(std::memory_order_relaxed)));
+      }
+      evict_bytes.IncrementBy(entry->num_bytes_);
+      UnregisterEntryFromPool(entry, pool);
+      evict_count.Increment();
+      if (pool->compressed_tier_ && !should_delete_cache) {
+        // The cache remains valid while `shard->mutex` is held, since
+        // `DestroyCache` must acquire it.
+        encoders[num_entries_to_delete] =
+            Access::StaticCast<Cache>(cache)->DoGetEvictedEntryEncoder(
+                Access::StaticCast<CacheEntry>(entry));
+        encoder_cache_ids[num_entries_to_delete] = cache->id_;
+      }
+      // Enqueue entry to be destroyed with `shard->mutex` released.
+      should_delete_cache_for_entry[num_entries_to_delete] =
+          should_delete_cache;
+      entries_to_delete[num_entries_to_delete++] = entry;
     }
-    UnregisterEntryFromPool(entry, pool);
-    evict_count.Increment();
-    // Enqueue entry to be destroyed with `pool->lru_mutex_` released.
-    should_delete_cache_for_entry[num_entries_to_delete] = should_delete_cache;
-    entries_to_delete[num_entries_to_delete++] = entry;
     if (num_entries_to_delete == entries_to_delete.size()) {
       destroy_entries();
-      num_entries_to_delete = 0;
     }
   }
   destroy_entries();
@@ -223,6 +437,9 @@ void InitializeNewEntry(CacheEntryImpl* entry, CacheImpl* cache) noexcept {
 void DestroyCache(CachePoolImpl* pool,
                   CacheImpl* cache) ABSL_NO_THREAD_SAFETY_ANALYSIS {
   if (pool) {
+    if (pool->compressed_tier_) {
+      pool->compressed_tier_->EraseCache(cache->id_);
+    }
     if (!cache->cache_identifier_.empty()) {
       // Remove from caches array. It is possible, given that this cache has
       // been marked `ShouldDelete == true`, that the pool already contains a
@@ -235,7 +452,10 @@ void DestroyCache(CachePoolImpl* pool,
       }
     }
     if (HasLruCache(pool)) {
-      absl::MutexLock lru_lock(&pool->lru_mutex_);
+      // The entries of `cache` may be in any shard of the eviction queue.
+      for (auto& lru_shard : pool->lru_shards_) {
+        lru_shard.mutex.Lock();
+      }
       for (auto& shard : cache->shards_) {
         absl::MutexLock lock(&shard.mutex);
         for (CacheEntryImpl* entry : shard.entries) {
@@ -247,6 +467,9 @@ void DestroyCache(CachePoolImpl* pool,
           UnregisterEntryFromPool(entry, pool);
         }
       }
+      for (auto& lru_shard : pool->lru_shards_) {
+        lru_shard.mutex.Unlock();
+      }
       // At this point, no external references to any entry are possible, and
       // the entries can safely be destroyed without holding any locks.
     } else {
@@ -364,7 +587,9 @@ void StrongPtrTraitsCacheEntry::decrement(CacheEntry* p) noexcept
     } else {
       auto lock = DecrementReferenceCountWithLock(
           entry->reference_count_,
-          [pool_impl]() -> absl::Mutex& { return pool_impl->lru_mutex_; },
+          [&]() -> absl::Mutex& {
+            return pool_impl->LruShardForEntry(entry).mutex;
+          },
           new_count,
           /*decrease_amount=*/2, /*lock_threshold=*/1);
       TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:decrement", p,
@@ -372,6 +597,7 @@ void StrongPtrTraitsCacheEntry::decrement(CacheEntry* p) noexcept
       if (!lock) return;
       if (new_count == 0) {
         AddToEvictionQueue(pool_impl, entry);
+        lock.unlock();
         MaybeEvictEntries(pool_impl);
       }
     }
@@ -506,6 +732,15 @@ PinnedCacheEntry<Cache> GetCacheEntryInternal(internal::Cache* cache,
         // This ensures the Cache object is not destroyed while any of its
         // entries are referenced.
         StrongPtrTraitsCache::increment(cache);
+        if (HasLruCache(cache_impl->pool_) &&
+            cache_impl->pool_->limits_.eviction_policy ==
+                CacheEvictionPolicy::kSegmentedLru) {
+          // The idle entry is being reused, and should be promoted to the
+          // protected segment once it becomes idle again.
+          entry_impl->reused_.store(true, std::memory_order_relaxed);
+          segmented_lru_hit_count.Increment(GetEvictionSegmentName(
+              entry_impl->eviction_segment_.load(std::memory_order_relaxed)));
+        }
       }
       // Adopt reference added via `fetch_add` above.
       returned_entry =
@@ -565,7 +800,15 @@ void StrongPtrTraitsCache::decrement(Cache* p) noexcept {
   }
 }
 
-CacheImpl::CacheImpl() : pool_(nullptr), reference_count_(0) {}
+namespace {
+uint64_t GetNextCacheId() {
+  static std::atomic<uint64_t> next_id{0};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace
+
+CacheImpl::CacheImpl()
+    : pool_(nullptr), id_(GetNextCacheId()), reference_count_(0) {}
 CacheImpl::~CacheImpl() = default;
 
 void StrongPtrTraitsCachePool::increment(CachePool* p) noexcept {
@@ -668,7 +911,8 @@ void intrusive_ptr_decrement(CacheEntryWeakState* p)
   }
   auto pool_lock = DecrementReferenceCountWithLock(
       entry->reference_count_,
-      [pool]() -> absl::Mutex& { return pool->lru_mutex_; }, new_count,
+      [&]() -> absl::Mutex& { return pool->LruShardForEntry(entry).mutex; },
+      new_count,
       /*decrease_amount=*/1,
       /*lock_threshold=*/0);
   TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:decrement", entry,
@@ -679,6 +923,7 @@ void intrusive_ptr_decrement(CacheEntryWeakState* p)
   // state if applicable.
   weak_lock = {};
   AddToEvictionQueue(pool, entry);
+  pool_lock = {};
   MaybeEvictEntries(pool);
 }
 
@@ -721,12 +966,12 @@ internal::IntrusivePtr<CacheEntryWeakState> AcquireWeakCacheEntryReference(
 
 void UpdateTotalBytes(CachePoolImpl& pool, ptrdiff_t change) {
   assert(HasLruCache(&pool));
+  bytes_resident.IncrementBy(change);
   if (pool.total_bytes_.fetch_add(change, std::memory_order_acq_rel) + change <=
           pool.limits_.total_bytes_limit ||
       change <= 0) {
     return;
   }
-  absl::MutexLock lock(&pool.lru_mutex_);
   MaybeEvictEntries(&pool);
 }
 
@@ -760,6 +1005,16 @@ CacheEntry::~CacheEntry() {
 
 void CacheEntry::DoInitialize() {}
 
+std::optional<absl::Cord> CacheEntry::TakeCompressedTierValue() {
+  auto* pool = cache_->pool_;
+  if (!pool || !pool->compressed_tier_) return std::nullopt;
+  return pool->compressed_tier_->Take(cache_->id_, key_);
+}
+
+Cache::EvictedEntryEncoder Cache::DoGetEvictedEntryEncoder(Entry* entry) {
+  return {};
+}
+
 void CacheEntry::WriterLock() { mutex_.WriterLock(); }
 
 void CacheEntry::WriterUnlock() {
@@ -72,9 +72,13 @@
 #include <utility>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/functional/function_ref.h"
+#include "absl/strings/cord.h"
 #include "tensorstore/internal/cache/cache_impl.h"
 #include "tensorstore/internal/cache/cache_pool_limits.h"
+#include "tensorstore/internal/cache/decoded_chunk_registry.h"
+#include "tensorstore/internal/cache/writeback_scheduler.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/poly/poly.h"
@@ -109,6 +113,18 @@ class CachePool : private internal_cache::CachePoolImpl {
   /// Returns the limits of this cache pool.
   const Limits& limits() const { return limits_; }
 
+  /// Returns the scheduler that limits buffered writes across this pool, or
+  /// `nullptr` if `limits()` do not specify such limits.
+  WritebackScheduler* writeback_scheduler() const {
+    return writeback_scheduler_.get();
+  }
+
+  /// Returns the registry of decoded chunks shared across this pool, or
+  /// `nullptr` if `limits().share_decoded_chunks` is `false`.
+  DecodedChunkRegistry* decoded_chunk_registry() const {
+    return decoded_chunk_registry_.get();
+  }
+
   class WeakPtr;
 
   /// Reference-counted pointer to a cache pool that keeps in-use and recently
@@ -283,6 +299,13 @@ class ABSL_LOCKABLE CacheEntry : private internal_cache::CacheEntryImpl {
     return internal_cache::AcquireWeakCacheEntryReference(this);
   }
 
+  /// Removes and returns the value retained in the compressed tier of the
+  /// cache pool when a previous entry with the same key in the same cache was
+  /// evicted (see `Cache::DoGetEvictedEntryEncoder`), if any.
+  ///
+  /// Intended to be called from `DoInitialize`.
+  std::optional<absl::Cord> TakeCompressedTierValue();
+
   /// Destroys the cache entry.
   ///
   /// Warning: The destructor must not call `GetOwningCache(*this)` to obtain a
@@ -372,6 +395,28 @@ class Cache : private internal_cache::CacheImpl {
   /// size_t DoGetSizeofEntry() final { return sizeof(Entry); }
   virtual size_t DoGetSizeofEntry() = 0;
 
+  /// Produces the value to retain in the compressed tier of the cache pool
+  /// for an evicted entry, or `std::nullopt` if the entry should not be
+  /// retained.
+  using EvictedEntryEncoder =
+      absl::AnyInvocable<std::optional<absl::Cord>() &&>;
+
+  /// Returns an encoder for `entry`, which is about to be evicted, or a null
+  /// encoder if `entry` is not to be retained in the compressed tier.
+  ///
+  /// This is only called if the cache pool has a compressed tier (see
+  /// `CachePoolLimits::compressed_bytes_limit`), while holding the cache
+  /// pool's eviction lock; therefore, it must only capture the necessary
+  /// state (e.g. references to immutable data) and defer the actual encoding
+  /// to the returned encoder, which is invoked without any locks held.  The
+  /// encoder may outlive both `entry` and this cache.
+  ///
+  /// The retained value may subsequently be obtained by a new entry with the
+  /// same key by calling `CacheEntry::TakeCompressedTierValue`.
+  ///
+  /// By default, returns a null encoder.
+  virtual EvictedEntryEncoder DoGetEvictedEntryEncoder(Entry* entry);
+
  private:
   friend class internal_cache::Access;
 };
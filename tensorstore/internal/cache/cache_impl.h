@@ -40,6 +40,9 @@
 #include "absl/log/absl_log.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/cache/cache_pool_limits.h"
+#include "tensorstore/internal/cache/compressed_cache_tier.h"
+#include "tensorstore/internal/cache/decoded_chunk_registry.h"
+#include "tensorstore/internal/cache/writeback_scheduler.h"
 #include "tensorstore/internal/container/heterogeneous_container.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 
@@ -53,6 +56,7 @@ namespace internal_cache {
 using internal::Cache;
 using internal::CacheEntry;
 using internal::CachePool;
+using internal::CacheEvictionPolicy;
 using internal::CachePoolLimits;
 
 #define TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT(method, p, new_count) \
@@ -143,6 +147,37 @@ class CacheEntryImpl : public internal_cache::LruListNode {
   // Set if the return value of `DoGetSizeInBytes` may have changed.
   constexpr static Flags kSizeChanged = 1;
 
+  // Segment of the pool eviction queue, used with
+  // `CacheEvictionPolicy::kSegmentedLru`.
+  enum class EvictionSegment : uint8_t {
+    kProbationary,
+    kProtected,
+  };
+
+  // Segment of the eviction queue to which this entry was most recently added.
+  // Changed only while holding the mutex of the `CachePoolImpl::LruShard` of
+  // this entry, but also read (for metrics) while holding only the shard mutex
+  // of `cache_`.
+  std::atomic<EvictionSegment> eviction_segment_{
+      EvictionSegment::kProbationary};
+
+  // Position of this entry in the eviction order across all shards of the
+  // eviction queue, assigned from `CachePoolImpl::next_queue_sequence_` when
+  // the entry is added to the queue.  Guarded by the mutex of the
+  // `CachePoolImpl::LruShard` of this entry.
+  uint64_t queue_sequence_ = 0;
+
+  // Set when a reference to this entry is acquired while it is not in use,
+  // indicating that the entry should be promoted to the protected segment the
+  // next time it is added to the eviction queue.  Only used with
+  // `CacheEvictionPolicy::kSegmentedLru`.
+  std::atomic<bool> reused_{false};
+
+  // Value of `num_bytes_` reflected in `CachePoolImpl::protected_bytes_`, valid
+  // while the entry is in the protected segment.  Guarded by the mutex of the
+  // `CachePoolImpl::LruShard` of this entry.
+  size_t protected_bytes_ = 0;
+
   // Initially set to `nullptr`.  Allocated when the first weak reference is
   // obtained, and remains until the entry is destroyed even if all weak
   // references are released.
@@ -159,6 +194,11 @@ class CacheImpl {
 
   CachePoolImpl* pool_;
 
+  /// Unique identifier of this cache, used to key the values of its evicted
+  /// entries in the compressed tier of the pool.  Unlike the address of the
+  /// cache, identifiers are never reused.
+  const uint64_t id_;
+
   /// Stores the pointer to `this`, cast to the `CacheType` specified in
   /// `GetCache` when this cache was created.  This pointer needs to be stored
   /// because the address may not equal `this` in the case that `CacheType` is a
@@ -273,20 +313,72 @@ class CachePoolImpl {
   CachePoolLimits limits_;
   std::atomic<size_t> total_bytes_;
 
-  // Protects access to `eviction_queue_`.  If `lru_mutex_` is held at the same
-  // time as `caches_mutex_`, `caches_mutex_` must be acquired first.  If
-  // `lru_mutex_` is held at the same time as `entries_mutex_`, `lru_mutex_`
-  // must be acquired first.
-  absl::Mutex lru_mutex_;
+  constexpr static size_t kNumLruShards = 16;
+
+  // Shard of the eviction queue.  Each entry is assigned to a single shard
+  // based on its address, such that releasing the last reference to an entry
+  // only locks the mutex of its shard rather than a pool-wide mutex.
+  struct ABSL_CACHELINE_ALIGNED LruShard {
+    // Protects access to the queues of this shard.  If held at the same time as
+    // `caches_mutex_`, `caches_mutex_` must be acquired first.  If held at the
+    // same time as the shard mutex of a cache, this mutex must be acquired
+    // first.  If the mutexes of multiple shards are held, they must be acquired
+    // in order of increasing shard index.
+    absl::Mutex mutex;
+
+    // next points to the front of the queue, which is the first to be evicted.
+    //
+    // With `CacheEvictionPolicy::kSegmentedLru`, this is the probationary
+    // segment.
+    LruListNode eviction_queue;
+
+    // Protected segment used with `CacheEvictionPolicy::kSegmentedLru`, from
+    // which entries are evicted only once the probationary segments of all
+    // shards are empty.  Always empty otherwise.
+    LruListNode protected_queue;
+
+    // `CacheEntryImpl::queue_sequence_` of the front entry of `eviction_queue`
+    // and `protected_queue`, respectively, or the maximum value if the queue is
+    // empty.  Modified only while holding `mutex`, but read without it to
+    // choose the shard from which to evict.
+    std::atomic<uint64_t> front_sequence[2];
+  };
+
+  LruShard lru_shards_[kNumLruShards];
+
+  LruShard& LruShardForEntry(const CacheEntryImpl* entry) {
+    absl::Hash<const CacheEntryImpl*> h;
+    return lru_shards_[h(entry) % kNumLruShards];
+  }
+
+  // Sequence number assigned to the next entry added to the eviction queue.
+  // Since entries are appended to the back of their shard queue while holding
+  // the shard mutex, each shard queue is ordered by sequence number, and the
+  // least recently used entry of the pool is the shard front with the smallest
+  // sequence number.
+  std::atomic<uint64_t> next_queue_sequence_{0};
 
-  // next points to the front of the queue, which is the first to be evicted.
-  LruListNode eviction_queue_;
+  // Sum of `CacheEntryImpl::protected_bytes_` over the entries in the
+  // `protected_queue` of all shards.
+  std::atomic<size_t> protected_bytes_{0};
 
   // Protects access to `caches_`.
   absl::Mutex caches_mutex_;
   internal::HeterogeneousHashSet<CacheImpl*, CacheKey, &CacheImpl::cache_key>
       caches_;
 
+  /// Second tier for evicted entries, or `nullptr` if disabled.  See
+  /// `CachePoolLimits::compressed_bytes_limit`.
+  std::unique_ptr<CompressedCacheTier> compressed_tier_;
+
+  /// Limits buffered writes across the pool, or `nullptr` if disabled.  See
+  /// `CachePoolLimits::dirty_bytes_high_watermark`.
+  std::unique_ptr<internal::WritebackScheduler> writeback_scheduler_;
+
+  /// Shares decoded chunks across the pool, or `nullptr` if disabled.  See
+  /// `CachePoolLimits::share_decoded_chunks`.
+  std::unique_ptr<internal::DecodedChunkRegistry> decoded_chunk_registry_;
+
   /// Initial strong reference returned when the cache pool is created.
   std::atomic<size_t> strong_references_;
   /// One weak reference is kept until strong_references_ becomes 0.
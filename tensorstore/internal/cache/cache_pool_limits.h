@@ -16,16 +16,72 @@
 #define TENSORSTORE_INTERNAL_CACHE_CACHE_POOL_LIMITS_H_
 
 #include <cstddef>
+#include <cstdint>
+
+#include "absl/time/time.h"
 
 namespace tensorstore {
 namespace internal {
 
+/// Policy used to choose the cache entries to evict when the total size exceeds
+/// `CachePoolLimits::total_bytes_limit`.
+enum class CacheEvictionPolicy : uint8_t {
+  /// Evicts the least recently used entry.
+  kLru,
+
+  /// Segmented LRU: newly-added entries are placed in a probationary segment,
+  /// and are only promoted to the protected segment if they are used again
+  /// after becoming idle.  Entries are evicted from the probationary segment
+  /// first, which prevents a single pass over a large amount of data from
+  /// evicting frequently re-used entries.  The protected segment is limited to
+  /// `kProtectedSegmentPercent` of `total_bytes_limit`; entries beyond that
+  /// are demoted back to the probationary segment.
+  kSegmentedLru,
+};
+
 /// Memory limit parameters for a cache pool.
 struct CachePoolLimits {
   size_t total_bytes_limit = 0;
 
+  /// Limit on the total number of bytes of the compressed second tier, which
+  /// retains compact encodings of entries evicted due to `total_bytes_limit`
+  /// for caches that support it.  The compressed tier is disabled if `0`, or
+  /// if `total_bytes_limit` is `0`.
+  size_t compressed_bytes_limit = 0;
+
+  /// Policy for choosing entries to evict.
+  CacheEvictionPolicy eviction_policy = CacheEvictionPolicy::kLru;
+
+  /// Limit on the total number of bytes of buffered writes that have not yet
+  /// been committed, across all write-behind buffers that use the pool.  Once
+  /// exceeded, the oldest groups of buffered writes are committed until the
+  /// total is at most `dirty_bytes_low_watermark`.  No limit if `0`.
+  size_t dirty_bytes_high_watermark = 0;
+
+  /// Target total number of bytes of buffered writes after committing due to
+  /// `dirty_bytes_high_watermark`.  If `0`, or greater than
+  /// `dirty_bytes_high_watermark`, half of `dirty_bytes_high_watermark` is
+  /// used.
+  size_t dirty_bytes_low_watermark = 0;
+
+  /// Maximum time for which any group of buffered writes that uses the pool
+  /// remains uncommitted.
+  absl::Duration max_dirty_age = absl::InfiniteDuration();
+
+  /// Specifies whether caches that use the pool share the decoded
+  /// representation of chunks with identical encoded bytes, for caches that
+  /// support it.  See `DecodedChunkRegistry`.
+  bool share_decoded_chunks = false;
+
+  /// Maximum size of the protected segment, as a percentage of
+  /// `total_bytes_limit`, when using `CacheEvictionPolicy::kSegmentedLru`.
+  constexpr static size_t kProtectedSegmentPercent = 80;
+
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.total_bytes_limit);
+    return f(x.total_bytes_limit, x.compressed_bytes_limit,
+             x.eviction_policy, x.dirty_bytes_high_watermark,
+             x.dirty_bytes_low_watermark, x.max_dirty_age,
+             x.share_decoded_chunks);
   };
 };
 
@@ -14,12 +14,17 @@
 
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 
+#include "absl/status/status.h"
+#include "absl/time/time.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/cache_pool_limits.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/absl_time.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/util/result.h"
 
@@ -27,17 +32,72 @@ namespace tensorstore {
 namespace internal {
 namespace {
 
+namespace jb = tensorstore::internal_json_binding;
+
+constexpr auto CacheEvictionPolicyJsonBinder = [](auto is_loading,
+                                                  const auto& options,
+                                                  auto* obj, auto* j) {
+  return jb::Enum<CacheEvictionPolicy, const char*>({
+      {CacheEvictionPolicy::kLru, "lru"},
+      {CacheEvictionPolicy::kSegmentedLru, "segmented_lru"},
+  })(is_loading, options, obj, j);
+};
+
 struct CachePoolResourceTraits
     : public ContextResourceTraits<CachePoolResource> {
   using Spec = CachePool::Limits;
   using Resource = typename CachePoolResource::Resource;
   static constexpr Spec Default() { return {}; }
   static constexpr auto JsonBinder() {
-    namespace jb = tensorstore::internal_json_binding;
-    return jb::Object(
-        jb::Member("total_bytes_limit",
-                   jb::Projection(&Spec::total_bytes_limit,
-                                  jb::DefaultValue([](auto* v) { *v = 0; }))));
+    return jb::Validate(
+        [](const auto& options, auto* obj) {
+          if (obj->max_dirty_age <= absl::ZeroDuration()) {
+            return absl::InvalidArgumentError(
+                "\"max_dirty_age\" must be positive");
+          }
+          return absl::OkStatus();
+        },
+        jb::Object(
+            jb::Member("total_bytes_limit",
+                       jb::Projection(&Spec::total_bytes_limit,
+                                      jb::DefaultValue([](auto* v) {
+                                        *v = 0;
+                                      }))),
+            jb::Member(
+                "compressed_bytes_limit",
+                jb::Projection(&Spec::compressed_bytes_limit,
+                               jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                   [](auto* v) { *v = 0; }))),
+            jb::Member(
+                "eviction_policy",
+                jb::Projection(&Spec::eviction_policy,
+                               jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                   [](auto* v) {
+                                     *v = CacheEvictionPolicy::kLru;
+                                   },
+                                   CacheEvictionPolicyJsonBinder))),
+            jb::Member(
+                "dirty_bytes_high_watermark",
+                jb::Projection(&Spec::dirty_bytes_high_watermark,
+                               jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                   [](auto* v) { *v = 0; }))),
+            jb::Member(
+                "dirty_bytes_low_watermark",
+                jb::Projection(&Spec::dirty_bytes_low_watermark,
+                               jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                   [](auto* v) { *v = 0; }))),
+            jb::Member(
+                "max_dirty_age",
+                jb::Projection(&Spec::max_dirty_age,
+                               jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                   [](auto* v) {
+                                     *v = absl::InfiniteDuration();
+                                   }))),
+            jb::Member(
+                "share_decoded_chunks",
+                jb::Projection(&Spec::share_decoded_chunks,
+                               jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                   [](auto* v) { *v = false; })))));
   }
   static Result<Resource> Create(const Spec& limits,
                                  ContextResourceCreationContext context) {
@@ -16,6 +16,8 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/time.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/cache.h"
@@ -28,6 +30,7 @@ namespace {
 
 using ::tensorstore::Context;
 using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::CacheEvictionPolicy;
 using ::tensorstore::internal::CachePoolResource;
 
 TEST(CachePoolResourceTest, Default) {
@@ -52,4 +55,88 @@ TEST(CachePoolResourceTest, TotalBytesLimitOnly) {
   EXPECT_EQ(100u, (*cache)->limits().total_bytes_limit);
 }
 
+TEST(CachePoolResourceTest, CompressedBytesLimit) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CachePoolResource>::FromJson(
+          {{"total_bytes_limit", 100}, {"compressed_bytes_limit", 50}}));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(100u, (*cache)->limits().total_bytes_limit);
+  EXPECT_EQ(50u, (*cache)->limits().compressed_bytes_limit);
+  EXPECT_EQ(::nlohmann::json(
+                {{"total_bytes_limit", 100}, {"compressed_bytes_limit", 50}}),
+            resource_spec.ToJson());
+}
+
+TEST(CachePoolResourceTest, EvictionPolicy) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CachePoolResource>::FromJson(
+          {{"total_bytes_limit", 100}, {"eviction_policy", "segmented_lru"}}));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(CacheEvictionPolicy::kSegmentedLru,
+            (*cache)->limits().eviction_policy);
+  EXPECT_EQ(::nlohmann::json({{"total_bytes_limit", 100},
+                              {"eviction_policy", "segmented_lru"}}),
+            resource_spec.ToJson());
+}
+
+TEST(CachePoolResourceTest, DefaultEvictionPolicy) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CachePoolResource>::FromJson(
+          {{"total_bytes_limit", 100}, {"eviction_policy", "lru"}}));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(CacheEvictionPolicy::kLru, (*cache)->limits().eviction_policy);
+  EXPECT_EQ(::nlohmann::json({{"total_bytes_limit", 100}}),
+            resource_spec.ToJson());
+}
+
+TEST(CachePoolResourceTest, InvalidEvictionPolicy) {
+  EXPECT_THAT(Context::Resource<CachePoolResource>::FromJson(
+                  {{"total_bytes_limit", 100}, {"eviction_policy", "arc"}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CachePoolResourceTest, DirtyBytesLimits) {
+  ::nlohmann::json json{{"total_bytes_limit", 100},
+                        {"dirty_bytes_high_watermark", 1000},
+                        {"dirty_bytes_low_watermark", 500},
+                        {"max_dirty_age", "10s"}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec, Context::Resource<CachePoolResource>::FromJson(json));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(1000u, (*cache)->limits().dirty_bytes_high_watermark);
+  EXPECT_EQ(500u, (*cache)->limits().dirty_bytes_low_watermark);
+  EXPECT_EQ(absl::Seconds(10), (*cache)->limits().max_dirty_age);
+  EXPECT_NE(nullptr, (*cache)->writeback_scheduler());
+  EXPECT_EQ(json, resource_spec.ToJson());
+}
+
+TEST(CachePoolResourceTest, NoDirtyBytesLimits) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec, Context::Resource<CachePoolResource>::FromJson(
+                              {{"total_bytes_limit", 100}}));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(nullptr, (*cache)->writeback_scheduler());
+}
+
+TEST(CachePoolResourceTest, ShareDecodedChunks) {
+  ::nlohmann::json json{{"total_bytes_limit", 100},
+                        {"share_decoded_chunks", true}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec, Context::Resource<CachePoolResource>::FromJson(json));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_TRUE((*cache)->limits().share_decoded_chunks);
+  EXPECT_NE(nullptr, (*cache)->decoded_chunk_registry());
+  EXPECT_EQ(json, resource_spec.ToJson());
+}
+
+TEST(CachePoolResourceTest, InvalidMaxDirtyAge) {
+  EXPECT_THAT(Context::Resource<CachePoolResource>::FromJson(
+                  {{"max_dirty_age", "0s"}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"max_dirty_age\" must be positive.*"));
+}
+
 }  // namespace
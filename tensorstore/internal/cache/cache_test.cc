@@ -18,15 +18,18 @@
 
 #include <atomic>
 #include <deque>
+#include <limits>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
@@ -36,6 +39,7 @@ namespace {
 
 using ::tensorstore::UniqueWriterLock;
 using ::tensorstore::internal::Cache;
+using ::tensorstore::internal::CacheEvictionPolicy;
 using ::tensorstore::internal::CachePool;
 using ::tensorstore::internal::CachePtr;
 using ::tensorstore::internal::GetCache;
@@ -163,7 +167,42 @@ void AssertInvariants(const CachePool::StrongPtr& pool,
                       absl::flat_hash_set<Cache*> expected_caches)
     ABSL_NO_THREAD_SAFETY_ANALYSIS {
   auto* pool_impl = GetPoolImpl(pool);
-  auto eviction_queue_entries = GetEntrySet(&pool_impl->eviction_queue_);
+  absl::flat_hash_set<EntryIdentifier> eviction_queue_entries;
+  size_t expected_protected_bytes = 0;
+  for (auto& shard : pool_impl->lru_shards_) {
+    for (auto segment : {CacheEntryImpl::EvictionSegment::kProbationary,
+                         CacheEntryImpl::EvictionSegment::kProtected}) {
+      LruListNode* head =
+          segment == CacheEntryImpl::EvictionSegment::kProtected
+              ? &shard.protected_queue
+              : &shard.eviction_queue;
+      if (head->next == head) {
+        EXPECT_EQ(std::numeric_limits<uint64_t>::max(),
+                  shard.front_sequence[static_cast<size_t>(segment)].load());
+      }
+      eviction_queue_entries.merge(GetEntrySet(head));
+      uint64_t prev_sequence = 0;
+      for (LruListNode* node = head->next; node != head; node = node->next) {
+        auto* entry = Access::StaticCast<CacheEntryImpl>(node);
+        EXPECT_EQ(&shard, &pool_impl->LruShardForEntry(entry));
+        EXPECT_EQ(segment, entry->eviction_segment_.load());
+        if (node == head->next) {
+          EXPECT_EQ(entry->queue_sequence_,
+                    shard.front_sequence[static_cast<size_t>(segment)].load());
+        } else {
+          EXPECT_LT(prev_sequence, entry->queue_sequence_);
+        }
+        prev_sequence = entry->queue_sequence_;
+        if (segment == CacheEntryImpl::EvictionSegment::kProtected) {
+          expected_protected_bytes += entry->protected_bytes_;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(expected_protected_bytes, pool_impl->protected_bytes_.load());
+  EXPECT_LE(pool_impl->protected_bytes_.load(),
+            pool_impl->limits_.total_bytes_limit / 100 *
+                CachePool::Limits::kProtectedSegmentPercent);
 
   absl::flat_hash_set<EntryIdentifier> expected_eviction_queue_entries;
 
@@ -836,6 +875,35 @@ TEST(CacheTest, ConcurrentDestroyCacheEvictEntries) {
       concurrent_op, concurrent_op, concurrent_op);
 }
 
+// Tests concurrently reusing and evicting entries, which may be in different
+// shards of the eviction queue.
+TEST(CacheTest, ConcurrentGetReleaseCacheEntryWithEviction) {
+  for (auto policy :
+       {CacheEvictionPolicy::kLru, CacheEvictionPolicy::kSegmentedLru}) {
+    CachePool::Limits limits;
+    limits.total_bytes_limit = 10;
+    limits.eviction_policy = policy;
+    auto pool = CachePool::Make(limits);
+    auto cache = GetTestCache(pool.get(), "cache");
+    const auto concurrent_op = [&] {
+      for (int i = 0; i < 20; ++i) {
+        auto entry = GetCacheEntry(cache, absl::StrCat(i % 12));
+      }
+    };
+    TestConcurrent(
+        kDefaultIterations,
+        /*initialize=*/
+        [&] {},
+        /*finalize=*/
+        [&] {
+          TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+          EXPECT_LE(GetPoolImpl(pool)->total_bytes_.load(), 10u);
+        },
+        // Concurrent operations:
+        concurrent_op, concurrent_op, concurrent_op);
+  }
+}
+
 TEST(CacheTest, EvictEntryDestroyCache) {
   auto log = std::make_shared<TestCache::RequestLog>();
   CachePool::Limits limits;
@@ -877,6 +945,77 @@ TEST(CacheTest, EvictEntryDestroyCache) {
   }
 }
 
+// Accesses entries "hot0" and "hot1" twice, then performs a single pass over
+// `num_scan_entries` other entries, where all entries have a size of 100 bytes.
+// Returns the keys of the destroyed entries.
+std::vector<std::string> GetEntriesEvictedByScan(CacheEvictionPolicy policy,
+                                                 size_t num_scan_entries) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 1000;
+  limits.eviction_policy = policy;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get(), "cache", log);
+  const auto access = [&](const std::string& key) {
+    auto entry = GetCacheEntry(cache, key);
+    if (entry->size != 100) entry->ChangeSize(100);
+  };
+  for (int i = 0; i < 2; ++i) {
+    access("hot0");
+    access("hot1");
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+  for (size_t i = 0; i < num_scan_entries; ++i) {
+    access(absl::StrCat("scan", i));
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+  std::vector<std::string> evicted;
+  for (const auto& [cache_key, entry_key] : log->entry_destroy_log) {
+    evicted.push_back(entry_key);
+  }
+  return evicted;
+}
+
+TEST(CacheTest, LruEvictionPolicyScan) {
+  EXPECT_THAT(GetEntriesEvictedByScan(CacheEvictionPolicy::kLru, 10),
+              ::testing::IsSupersetOf({"hot0", "hot1"}));
+}
+
+TEST(CacheTest, SegmentedLruEvictionPolicyIsScanResistant) {
+  EXPECT_THAT(GetEntriesEvictedByScan(CacheEvictionPolicy::kSegmentedLru, 20),
+              ::testing::AllOf(::testing::SizeIs(12),
+                               ::testing::Not(::testing::Contains("hot0")),
+                               ::testing::Not(::testing::Contains("hot1"))));
+}
+
+TEST(CacheTest, SegmentedLruEvictionPolicyDemotes) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 1000;
+  limits.eviction_policy = CacheEvictionPolicy::kSegmentedLru;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get(), "cache", log);
+  // Promote 9 entries of 100 bytes, which exceeds the 800 byte limit on the
+  // protected segment.
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 9; ++j) {
+      auto entry = GetCacheEntry(cache, absl::StrCat("e", j));
+      if (entry->size != 100) entry->ChangeSize(100);
+    }
+  }
+  EXPECT_THAT(log->entry_destroy_log, ElementsAre());
+  EXPECT_EQ(800u, GetPoolImpl(pool)->protected_bytes_.load());
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+
+  // The least recently used entry was demoted, and is therefore evicted first.
+  {
+    auto entry = GetCacheEntry(cache, "new");
+    entry->ChangeSize(200);
+  }
+  EXPECT_THAT(log->entry_destroy_log, ElementsAre(Pair("cache", "e0")));
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+}
+
 // Tests behavior of `CachePool::WeakPtr` and conversion to/from
 // `CachePool::StrongPtr`.
 TEST(CacheTest, CachePoolWeakPtr) {
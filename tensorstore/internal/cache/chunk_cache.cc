@@ -19,15 +19,20 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstring>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <numeric>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
 #include "tensorstore/contiguous_layout.h"
@@ -41,6 +46,10 @@
 #include "tensorstore/internal/async_write_array.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/chunk_prefetch.h"
+#include "tensorstore/internal/chunk_buffer_pool.h"
+#include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/compression/blosc.h"
 #include "tensorstore/internal/elementwise_function.h"
 #include "tensorstore/internal/grid_partition.h"
 #include "tensorstore/internal/intrusive_ptr.h"
@@ -48,11 +57,14 @@
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/nditerable.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
+#include "tensorstore/kvstore/generation.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/read_write_options.h"
 #include "tensorstore/staleness_bound.h"
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/transaction.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/element_pointer.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
@@ -71,6 +83,9 @@ auto& num_writes = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/cache/chunk_cache/writes", "Number of writes to ChunkCache.");
 auto& num_reads = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/cache/chunk_cache/reads", "Number of reads from ChunkCache.");
+auto& num_prefetches = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/chunk_cache/prefetches",
+    "Number of speculative prefetch reads issued by ChunkCache.");
 
 namespace {
 
@@ -96,6 +111,17 @@ bool IsFullyOverwritten(ChunkCache::TransactionNode& node) {
   return true;
 }
 
+/// Returns the specified component of the current read state of `entry`.
+///
+/// Concurrent calls for the same entry do not exclude one another.
+SharedArray<const void> GetReadComponentSnapshot(ChunkCache::Entry& entry,
+                                                 size_t component_index) {
+  auto read_data = entry.GetReadStateData();
+  return ChunkCache::GetReadComponent(
+      static_cast<const ChunkCache::ReadData*>(read_data.get()),
+      component_index);
+}
+
 /// TensorStore Driver ReadChunk implementation for the chunk cache, for the
 /// case of a non-transactional read.
 ///
@@ -143,9 +169,9 @@ struct ReadChunkImpl {
   PinnedCacheEntry<ChunkCache> entry;
 
   absl::Status operator()(internal::LockCollection& lock_collection) const {
-    // No locks need to be held throughout read operation.  A temporary lock is
-    // held in the `BeginRead` method below only while copying the shared_ptr to
-    // the immutable cached chunk data.
+    // No locks need to be held throughout read operation.  A temporary shared
+    // lock is held in the `BeginRead` method below only while copying the
+    // shared_ptr to the immutable cached chunk data.
     return absl::OkStatus();
   }
 
@@ -159,12 +185,29 @@ struct ReadChunkImpl {
     GetOwningCache(*entry).grid().GetComponentOrigin(
         component_index, entry->cell_indices(), origin_span);
     SharedArray<const void, dynamic_rank(kMaxRank)> read_array{
-        ChunkCache::GetReadComponent(
-            AsyncCache::ReadLock<ChunkCache::ReadData>(*entry).data(),
-            component_index)};
+        GetReadComponentSnapshot(*entry, component_index)};
     return component_spec.GetReadNDIterable(std::move(read_array), origin_span,
                                             std::move(chunk_transform), arena);
   }
+
+  bool operator()(ReadChunk::ReadArray, IndexTransformView<> chunk_transform,
+                  SharedOffsetArray<const void>& array) const {
+    // The cached chunk data is immutable, and may therefore be referenced
+    // indefinitely.
+    const auto& component_spec =
+        GetOwningCache(*entry).grid().components[component_index];
+    Index origin[kMaxRank];
+    const span<Index> origin_span(origin, component_spec.rank());
+    GetOwningCache(*entry).grid().GetComponentOrigin(
+        component_index, entry->cell_indices(), origin_span);
+    SharedArray<const void, dynamic_rank(kMaxRank)> read_array{
+        GetReadComponentSnapshot(*entry, component_index)};
+    auto result = component_spec.GetReadArray(std::move(read_array),
+                                              origin_span, chunk_transform);
+    if (!result.ok()) return false;
+    array = *std::move(result);
+    return true;
+  }
 };
 
 /// TensorStore Driver ReadChunk implementation for the chunk cache, for the
@@ -239,6 +282,11 @@ struct ReadChunkTransactionImpl {
                                        std::move(read_array), read_generation,
                                        std::move(chunk_transform), arena);
   }
+
+  bool operator()(ReadChunk::ReadArray, IndexTransformView<>,
+                  SharedOffsetArray<const void>&) {
+    return false;
+  }
 };
 
 /// TensorStore Driver WriteChunk implementation for the chunk cache.
@@ -336,9 +384,11 @@ struct WriteChunkImpl {
     const auto component_spec = entry.component_specs()[component_index];
     Index origin[kMaxRank];
     const span<Index> origin_span(origin, component_spec.rank());
-    GetOwningCache(entry).grid().GetComponentOrigin(
-        component_index, entry.cell_indices(), origin_span);
+    auto& cache = GetOwningCache(entry);
+    cache.grid().GetComponentOrigin(component_index, entry.cell_indices(),
+                                    origin_span);
     node->MarkSizeUpdated();
+    ScopedChunkBufferPool buffer_pool_scope(cache.chunk_buffer_pool());
     return node->components()[component_index].BeginWrite(
         component_spec, origin_span, std::move(chunk_transform), arena);
   }
@@ -369,10 +419,12 @@ struct WriteChunkImpl {
     const auto& component_spec = entry.component_specs()[component_index];
     Index origin[kMaxRank];
     const span<Index> origin_span(origin, component_spec.rank());
-    GetOwningCache(entry).grid().GetComponentOrigin(
-        component_index, entry.cell_indices(), origin_span);
+    auto& cache = GetOwningCache(entry);
+    cache.grid().GetComponentOrigin(component_index, entry.cell_indices(),
+                                    origin_span);
     using WriteArraySourceCapabilities =
         AsyncWriteArray::WriteArraySourceCapabilities;
+    ScopedChunkBufferPool buffer_pool_scope(cache.chunk_buffer_pool());
     auto status = node->components()[component_index].WriteArray(
         component_spec, origin_span, chunk_transform,
         [&]() -> Result<std::pair<TransformedSharedArray<const void>,
@@ -417,56 +469,175 @@ void ChunkCache::Read(
   // Shared state used while `Read` is in progress.
   using ReadOperationState = ChunkOperationState<ReadChunk>;
 
-  auto state = MakeIntrusivePtr<ReadOperationState>(std::move(receiver));
-  auto status = PartitionIndexTransformOverRegularGrid(
+  // Bounding box of the grid cells touched by the read, used to detect
+  // sequential access for prefetching.
+  const bool prefetch = request.prefetch.cells != 0 && !request.transaction &&
+                        !request.batch;
+  const DimensionIndex grid_rank = grid().grid_rank();
+  Index cells_min[kMaxRank];
+  Index cells_max[kMaxRank];
+  bool any_cells = false;
+
+  // Reads contained in a single chunk, such as point lookups, bypass the
+  // partitioning of `request.transform`, which dominates their cost when the
+  // chunk is cached.
+  Index single_cell_indices[kMaxRank];
+  const bool single_cell = GetSingleRegularGridCell(
       component_spec.chunked_to_cell_dimensions, grid().chunk_shape,
-      request.transform,
-      [&](span<const Index> grid_cell_indices,
-          IndexTransformView<> cell_transform) {
-        if (state->cancelled()) {
-          return absl::CancelledError("");
-        }
-        num_reads.Increment();
-        TENSORSTORE_ASSIGN_OR_RETURN(
-            auto cell_to_source,
-            ComposeTransforms(request.transform, cell_transform));
-        auto entry = GetEntryForGridCell(*this, grid_cell_indices);
-        // Arrange to call `set_value` on the receiver with a `ReadChunk`
-        // corresponding to this grid cell once the read request completes
-        // successfully.
-        ReadChunk chunk;
-        chunk.transform = std::move(cell_to_source);
-        Future<const void> read_future;
-        const auto get_cache_read_request = [&] {
-          AsyncCache::AsyncCacheReadRequest cache_request;
-          cache_request.staleness_bound = request.staleness_bound;
-          cache_request.batch = request.batch;
-          return cache_request;
-        };
-        if (request.transaction) {
-          TENSORSTORE_ASSIGN_OR_RETURN(
-              auto node, GetTransactionNode(*entry, request.transaction));
-          read_future = node->IsUnconditional()
-                            ? MakeReadyFuture()
-                            : node->Read(get_cache_read_request());
-          chunk.impl = ReadChunkTransactionImpl{request.component_index,
-                                                std::move(node)};
-        } else {
-          read_future = entry->Read(get_cache_read_request());
-          chunk.impl = ReadChunkImpl{request.component_index, std::move(entry)};
-        }
-        LinkValue(
-            [state, chunk = std::move(chunk),
-             cell_transform = IndexTransform<>(cell_transform)](
-                Promise<void> promise, ReadyFuture<const void> future) mutable {
-              execution::set_value(state->shared_receiver->receiver,
-                                   std::move(chunk), std::move(cell_transform));
-            },
-            state->promise, std::move(read_future));
-        return absl::OkStatus();
-      });
+      request.transform, span<Index>(single_cell_indices, grid_rank));
+
+  auto state = MakeIntrusivePtr<ReadOperationState>(std::move(receiver));
+  const auto read_cell = [&](span<const Index> grid_cell_indices,
+                             IndexTransformView<> cell_transform)
+      -> absl::Status {
+    if (state->cancelled()) {
+      return absl::CancelledError("");
+    }
+    num_reads.Increment();
+    internal_tracing::AddIoAccounting(
+        &internal_tracing::IoAccounting::chunks_touched, 1);
+    if (prefetch) {
+      for (DimensionIndex i = 0; i < grid_rank; ++i) {
+        const Index cell = grid_cell_indices[i];
+        cells_min[i] = any_cells ? std::min(cells_min[i], cell) : cell;
+        cells_max[i] = any_cells ? std::max(cells_max[i], cell) : cell;
+      }
+      any_cells = true;
+    }
+    IndexTransform<> cell_to_source;
+    if (single_cell) {
+      // `cell_transform` is an identity transform.
+      cell_to_source = request.transform;
+    } else {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          cell_to_source, ComposeTransforms(request.transform, cell_transform));
+    }
+    auto entry = GetEntryForGridCell(*this, grid_cell_indices);
+    // Arrange to call `set_value` on the receiver with a `ReadChunk`
+    // corresponding to this grid cell once the read request completes
+    // successfully.
+    ReadChunk chunk;
+    chunk.transform = std::move(cell_to_source);
+    Future<const void> read_future;
+    const auto get_cache_read_request = [&] {
+      AsyncCache::AsyncCacheReadRequest cache_request;
+      cache_request.staleness_bound = request.staleness_bound;
+      cache_request.batch = request.batch;
+      return cache_request;
+    };
+    if (request.transaction) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto node, GetTransactionNode(*entry, request.transaction));
+      read_future = node->IsUnconditional()
+                        ? MakeReadyFuture()
+                        : node->Read(get_cache_read_request());
+      chunk.impl = ReadChunkTransactionImpl{request.component_index,
+                                            std::move(node)};
+    } else {
+      read_future = entry->Read(get_cache_read_request());
+      chunk.impl = ReadChunkImpl{request.component_index, std::move(entry)};
+    }
+    if (read_future.ready()) {
+      internal_tracing::AddIoAccounting(
+          &internal_tracing::IoAccounting::cache_hits, 1);
+    }
+    LinkValue(
+        [state, chunk = std::move(chunk),
+         cell_transform = IndexTransform<>(cell_transform)](
+            Promise<void> promise, ReadyFuture<const void> future) mutable {
+          execution::set_value(state->shared_receiver->receiver,
+                               std::move(chunk), std::move(cell_transform));
+        },
+        state->promise, std::move(read_future));
+    return absl::OkStatus();
+  };
+  auto status =
+      single_cell
+          ? read_cell(span<const Index>(single_cell_indices, grid_rank),
+                      IdentityTransform(request.transform.domain().box()))
+          : PartitionIndexTransformOverRegularGrid(
+                component_spec.chunked_to_cell_dimensions, grid().chunk_shape,
+                request.transform, read_cell);
   if (!status.ok()) {
     state->SetError(std::move(status));
+    return;
+  }
+  if (any_cells) {
+    // Prefetch reads are issued after all of the reads required by this
+    // request, since the kvstore layer does not support read priorities.
+    Box<> cells(grid_rank);
+    for (DimensionIndex i = 0; i < grid_rank; ++i) {
+      cells[i] = IndexInterval::UncheckedClosed(cells_min[i], cells_max[i]);
+    }
+    Prefetch(request, cells);
+  }
+}
+
+void ChunkCache::GetPrefetchBounds(size_t component_index,
+                                   MutableBoxView<> bounds) {
+  const auto& component_spec = grid().components[component_index];
+  for (DimensionIndex grid_dim = 0; grid_dim < bounds.rank(); ++grid_dim) {
+    bounds[grid_dim] =
+        component_spec.component_bounds[component_spec
+                                            .chunked_to_cell_dimensions
+                                                [grid_dim]];
+  }
+}
+
+void ChunkCache::Prefetch(const ReadRequest& request, BoxView<> cells) {
+  auto* pool = this->pool();
+  if (!pool || pool->limits().total_bytes_limit == 0) return;
+  // Prefetched chunks must not displace more than half of the cache pool.
+  size_t bytes_limit = pool->limits().total_bytes_limit / 2;
+  if (request.prefetch.bytes_limit != 0) {
+    bytes_limit = std::min(bytes_limit, request.prefetch.bytes_limit);
+  }
+
+  const auto& grid = this->grid();
+  const DimensionIndex grid_rank = grid.grid_rank();
+  Box<> grid_bounds(grid_rank);
+  GetPrefetchBounds(request.component_index, grid_bounds);
+  for (DimensionIndex grid_dim = 0; grid_dim < grid_rank; ++grid_dim) {
+    const IndexInterval bounds = grid_bounds[grid_dim];
+    if (bounds.empty()) return;
+    const Index chunk_size = grid.chunk_shape[grid_dim];
+    grid_bounds[grid_dim] = IndexInterval::UncheckedClosed(
+        bounds.inclusive_min() == -kInfIndex
+            ? -kInfIndex
+            : FloorOfRatio(bounds.inclusive_min(), chunk_size),
+        bounds.inclusive_max() == kInfIndex
+            ? kInfIndex
+            : FloorOfRatio(bounds.inclusive_max(), chunk_size));
+  }
+
+  const std::vector<Index> cell_indices =
+      prefetch_detector_.Update(cells, grid_bounds, request.prefetch.cells);
+  if (cell_indices.empty()) return;
+
+  size_t cell_bytes = 0;
+  for (const auto& component : grid.components) {
+    cell_bytes += component.EstimateReadStateSizeInBytes(/*valid=*/true);
+  }
+  AsyncCache::AsyncCacheReadRequest cache_request;
+  cache_request.staleness_bound = request.staleness_bound;
+  for (size_t i = 0; i < cell_indices.size(); i += grid_rank) {
+    size_t in_flight =
+        prefetch_bytes_in_flight_.load(std::memory_order_relaxed);
+    do {
+      if (in_flight + cell_bytes > bytes_limit) return;
+    } while (!prefetch_bytes_in_flight_.compare_exchange_weak(
+        in_flight, in_flight + cell_bytes, std::memory_order_relaxed));
+    num_prefetches.Increment();
+    auto entry = GetEntryForGridCell(
+        *this, span<const Index>(&cell_indices[i], grid_rank));
+    auto read_future = entry->Read(cache_request);
+    // The entry remains pinned until the read completes, at which point it
+    // becomes eligible for eviction like any other entry.
+    read_future.ExecuteWhenReady(
+        [entry = std::move(entry), cell_bytes](ReadyFuture<const void>) {
+          GetOwningCache(*entry).prefetch_bytes_in_flight_.fetch_sub(
+              cell_bytes, std::memory_order_relaxed);
+        });
   }
 }
 
@@ -488,17 +659,16 @@ void ChunkCache::Write(
           IndexTransformView<> cell_transform) {
         if (cancelled) return absl::CancelledError("");
         num_writes.Increment();
+        internal_tracing::AddIoAccounting(
+            &internal_tracing::IoAccounting::chunks_touched, 1);
         TENSORSTORE_ASSIGN_OR_RETURN(
             auto cell_to_dest,
             ComposeTransforms(request.transform, cell_transform));
         auto entry = GetEntryForGridCell(*this, grid_cell_indices);
-        auto transaction_copy = request.transaction;
         TENSORSTORE_ASSIGN_OR_RETURN(
-            auto node, GetTransactionNode(*entry, transaction_copy));
+            auto impl, GetWriteChunkImpl(request, *entry, cell_to_dest));
         execution::set_value(
-            receiver,
-            WriteChunk{WriteChunkImpl{request.component_index, std::move(node)},
-                       std::move(cell_to_dest)},
+            receiver, WriteChunk{std::move(impl), std::move(cell_to_dest)},
             IndexTransform<>(cell_transform));
         return absl::OkStatus();
       });
@@ -510,6 +680,16 @@ void ChunkCache::Write(
   execution::set_stopping(receiver);
 }
 
+Result<WriteChunk::Impl> ChunkCache::GetWriteChunkImpl(
+    const WriteRequest& request, Entry& entry,
+    IndexTransformView<> cell_to_dest) {
+  auto transaction_copy = request.transaction;
+  TENSORSTORE_ASSIGN_OR_RETURN(auto node,
+                               GetTransactionNode(entry, transaction_copy));
+  return WriteChunk::Impl(
+      WriteChunkImpl{request.component_index, std::move(node)});
+}
+
 Future<const void> ChunkCache::DeleteCell(
     span<const Index> grid_cell_indices,
     internal::OpenTransactionPtr transaction) {
@@ -556,9 +736,223 @@ size_t ChunkCache::TransactionNode::ComputeWriteStateSizeInBytes() {
         this->components()[component_index].write_state.EstimateSizeInBytes(
             component_specs[component_index]);
   }
+  // This is called whenever the write state changes size.
+  write_reservation_.Resize(total);
   return total;
 }
 
+namespace {
+
+// Values retained in the compressed tier of the cache pool have the following
+// format.  Since they are only interpreted within the same process, native
+// byte order is used.
+//
+//   format: char, a `CompressedTierFormat` value
+//   generation_size: uint64
+//   generation: char[generation_size]
+//   time: int64, nanoseconds since the Unix epoch (saturating)
+//
+// followed, for `kDecodedArrays`, by:
+//
+//   for each component:
+//     compressed_size: uint64, or `kMissingComponent` if the component is
+//         equal to the fill value
+//     compressed: char[compressed_size], blosc-compressed elements in C order
+//
+// or, for `kEncodedChunk`, by the representation returned by
+// `ChunkCache::GetEncodedChunkForCompressedTier`.
+enum CompressedTierFormat : char {
+  kDecodedArrays = 0,
+  kEncodedChunk = 1,
+};
+
+constexpr uint64_t kMissingComponent = ~uint64_t(0);
+
+bool IsTriviallyEncodable(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::custom:
+    case DataTypeId::string_t:
+    case DataTypeId::ustring_t:
+    case DataTypeId::json_t:
+      return false;
+    default:
+      return true;
+  }
+}
+
+void AppendUint64(std::string& out, uint64_t value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool ConsumeUint64(std::string_view& in, uint64_t& value) {
+  if (in.size() < sizeof(value)) return false;
+  std::memcpy(&value, in.data(), sizeof(value));
+  in.remove_prefix(sizeof(value));
+  return true;
+}
+
+void AppendHeader(std::string& out, CompressedTierFormat format,
+                  const TimestampedStorageGeneration& stamp) {
+  out += static_cast<char>(format);
+  const std::string& generation = stamp.generation.value;
+  AppendUint64(out, generation.size());
+  out += generation;
+  AppendUint64(out, absl::ToUnixNanos(stamp.time));
+}
+
+bool ConsumeHeader(std::string_view& in, CompressedTierFormat& format,
+                   TimestampedStorageGeneration& stamp) {
+  if (in.empty()) return false;
+  format = static_cast<CompressedTierFormat>(in[0]);
+  in.remove_prefix(1);
+  uint64_t size;
+  if (!ConsumeUint64(in, size) || in.size() < size) return false;
+  stamp.generation.value = std::string(in.substr(0, size));
+  in.remove_prefix(size);
+  uint64_t time;
+  if (!ConsumeUint64(in, time)) return false;
+  stamp.time = absl::FromUnixNanos(static_cast<int64_t>(time));
+  return true;
+}
+
+std::optional<absl::Cord> EncodeForCompressedTier(
+    const AsyncCache::ReadState& read_state, size_t num_components) {
+  std::string out;
+  AppendHeader(out, kDecodedArrays, read_state.stamp);
+  const auto* components =
+      static_cast<const ChunkCache::ReadData*>(read_state.data.get());
+  for (size_t i = 0; i < num_components; ++i) {
+    if (!components || !components[i].valid()) {
+      AppendUint64(out, kMissingComponent);
+      continue;
+    }
+    const auto& array = components[i];
+    SharedArray<const void> c_order_array = array;
+    if (!IsContiguousLayout(array, c_order)) {
+      c_order_array = MakeCopy(array, {c_order, include_repeated_elements});
+    }
+    const size_t element_size = array.dtype()->size;
+    auto compressed = blosc::Encode(
+        std::string_view(static_cast<const char*>(c_order_array.data()),
+                         c_order_array.num_elements() * element_size),
+        blosc::Options{/*.compressor=*/"lz4", /*.clevel=*/5, /*.shuffle=*/-1,
+                       /*.blocksize=*/0, /*.element_size=*/element_size});
+    if (!compressed.ok()) return std::nullopt;
+    AppendUint64(out, compressed->size());
+    out += *compressed;
+  }
+  return absl::Cord(std::move(out));
+}
+
+// Decodes the components following a `kDecodedArrays` header.  Returns a null
+// pointer if all components are missing.
+std::optional<std::shared_ptr<ChunkCache::ReadData>>
+DecodeArraysFromCompressedTier(
+    span<const ChunkGridSpecification::Component> component_specs,
+    std::string_view in) {
+  uint64_t size;
+  std::shared_ptr<ChunkCache::ReadData> components;
+  for (size_t i = 0; i < static_cast<size_t>(component_specs.size()); ++i) {
+    if (!ConsumeUint64(in, size)) return std::nullopt;
+    if (size == kMissingComponent) continue;
+    if (in.size() < size) return std::nullopt;
+    auto decoded = blosc::Decode(in.substr(0, size));
+    in.remove_prefix(size);
+    const auto& spec = component_specs[i];
+    if (!decoded.ok() ||
+        decoded->size() != spec.num_elements() * spec.dtype()->size) {
+      return std::nullopt;
+    }
+    auto array =
+        AllocateArray(spec.shape(), c_order, default_init, spec.dtype());
+    std::memcpy(array.data(), decoded->data(), decoded->size());
+    if (!components) {
+      components = internal::make_shared_for_overwrite<ChunkCache::ReadData[]>(
+          component_specs.size());
+    }
+    components.get()[i] = std::move(array);
+  }
+  if (!in.empty()) return std::nullopt;
+  return components;
+}
+
+}  // namespace
+
+void ChunkCache::Entry::DoInitialize() {
+  AsyncCache::Entry::DoInitialize();
+  auto value = TakeCompressedTierValue();
+  if (!value) return;
+  std::string_view in = value->Flatten();
+  ScopedChunkBufferPool buffer_pool_scope(
+      GetOwningCache(*this).chunk_buffer_pool());
+  ReadState read_state;
+  CompressedTierFormat format;
+  if (!ConsumeHeader(in, format, read_state.stamp)) return;
+  switch (format) {
+    case kDecodedArrays: {
+      auto components = DecodeArraysFromCompressedTier(component_specs(), in);
+      if (!components) return;
+      read_state.data = *std::move(components);
+      break;
+    }
+    case kEncodedChunk: {
+      value->RemovePrefix(value->size() - in.size());
+      auto components = GetOwningCache(*this).DecodeChunkFromCompressedTier(
+          *this, *std::move(value));
+      if (!components) return;
+      read_state.data = std::move(components);
+      break;
+    }
+    default:
+      return;
+  }
+  const size_t read_state_size =
+      read_state.data ? ComputeReadDataSizeInBytes(read_state.data.get()) : 0;
+  // The size is accounted for by the cache pool after `DoInitialize` returns.
+  absl::MutexLock lock(&mutex());
+  read_request_state_.read_state = std::move(read_state);
+  read_request_state_.read_state_size = read_state_size;
+  PublishReadStateTime();
+}
+
+std::optional<absl::Cord> ChunkCache::GetEncodedChunkForCompressedTier(
+    Entry& entry, const void* read_data) {
+  return std::nullopt;
+}
+
+std::shared_ptr<ChunkCache::ReadData>
+ChunkCache::DecodeChunkFromCompressedTier(Entry& entry, absl::Cord encoded) {
+  return nullptr;
+}
+
+Cache::EvictedEntryEncoder ChunkCache::DoGetEvictedEntryEncoder(
+    internal::CacheEntry* base_entry) {
+  auto& entry = static_cast<Entry&>(*base_entry);
+  ReadState read_state = AsyncCache::ReadLock<void>(entry).read_state();
+  if (!StorageGeneration::IsClean(read_state.stamp.generation)) return {};
+  if (read_state.data) {
+    if (auto encoded =
+            GetEncodedChunkForCompressedTier(entry, read_state.data.get())) {
+      return [stamp = std::move(read_state.stamp),
+              encoded = *std::move(encoded)]() mutable {
+        std::string header;
+        AppendHeader(header, kEncodedChunk, stamp);
+        absl::Cord value(std::move(header));
+        value.Append(std::move(encoded));
+        return std::optional<absl::Cord>(std::move(value));
+      };
+    }
+  }
+  const auto& component_specs = grid().components;
+  for (const auto& component_spec : component_specs) {
+    if (!IsTriviallyEncodable(component_spec.dtype())) return {};
+  }
+  return [read_state = std::move(read_state),
+          num_components = component_specs.size()]() mutable {
+    return EncodeForCompressedTier(read_state, num_components);
+  };
+}
+
 size_t ChunkCache::Entry::ComputeReadDataSizeInBytes(const void* read_data) {
   const ReadData* components = static_cast<const ReadData*>(read_data);
   size_t total = 0;
@@ -607,6 +1001,9 @@ ChunkCache::TransactionNode::TransactionNode(Entry& entry)
   for (size_t i = 0; i < component_specs.size(); ++i) {
     components_.emplace_back(component_specs[i].rank());
   }
+  if (auto* memory_budget = GetOwningCache(entry).memory_budget()) {
+    write_reservation_ = memory_budget->Retain();
+  }
 }
 
 absl::Status ChunkCache::TransactionNode::OnModified() {
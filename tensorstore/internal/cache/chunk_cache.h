@@ -49,12 +49,15 @@
 
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/read_request.h"
@@ -64,8 +67,11 @@
 #include "tensorstore/internal/async_write_array.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/chunk_prefetch.h"
+#include "tensorstore/internal/chunk_buffer_pool.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/memory_budget.h"
 #include "tensorstore/staleness_bound.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/any_receiver.h"
@@ -107,6 +113,10 @@ class ChunkCache : public AsyncCache {
     Future<const void> Delete(internal::OpenTransactionPtr transaction);
 
     size_t ComputeReadDataSizeInBytes(const void* read_data) override;
+
+    /// Restores the read state from the compressed tier of the cache pool, if
+    /// this entry was previously evicted.
+    void DoInitialize() override;
   };
 
   class TransactionNode : public AsyncCache::TransactionNode {
@@ -160,6 +170,9 @@ class ChunkCache : public AsyncCache {
     friend class ChunkCache;
     absl::InlinedVector<Component, 1> components_;
     std::atomic<bool> unconditional_{false};
+    // Charges the write state to the `memory_budget()` of the cache until the
+    // node is destroyed.
+    MemoryReservation write_reservation_;
 
    public:
     bool is_modified{false};
@@ -205,6 +218,14 @@ class ChunkCache : public AsyncCache {
   /// Returns the data copy executor.
   virtual const Executor& executor() const = 0;
 
+  /// Returns the budget to which chunks being decoded and write state pending
+  /// writeback are charged, or `nullptr` if not limited.
+  virtual MemoryBudget* memory_budget() const { return nullptr; }
+
+  /// Returns the pool from which chunk buffers are allocated, or `nullptr` to
+  /// use the general allocator.
+  virtual ChunkBufferPool* chunk_buffer_pool() const { return nullptr; }
+
   struct ReadRequest : public internal::DriverReadRequest {
     /// Component array index in the range `[0, grid().components.size())`.
     size_t component_index;
@@ -212,6 +233,12 @@ class ChunkCache : public AsyncCache {
     /// Cached data older than `staleness_bound` will not be returned without
     /// being rechecked.
     absl::Time staleness_bound;
+
+    /// Speculative readahead to perform if this read continues a sequential
+    /// access pattern.  Prefetching only applies to non-transactional,
+    /// non-batched reads and requires a cache pool with a non-zero
+    /// `total_bytes_limit`.
+    ChunkPrefetchOptions prefetch;
   };
 
   /// Implements the behavior of `Driver::Read` for a given component array.
@@ -239,6 +266,72 @@ class ChunkCache : public AsyncCache {
 
   Future<const void> DeleteCell(span<const Index> grid_cell_indices,
                                 internal::OpenTransactionPtr transaction);
+
+  /// Retains the clean read state of evicted entries in the compressed tier
+  /// of the cache pool, either in the form returned by
+  /// `GetEncodedChunkForCompressedTier` or as blosc-compressed arrays.
+  /// Entries with data types that are not trivially copyable are only
+  /// retained in the former case.
+  EvictedEntryEncoder DoGetEvictedEntryEncoder(
+      internal::CacheEntry* entry) override;
+
+ protected:
+  /// Returns an encoded representation of `read_data`, the current read state
+  /// data of `entry`, to retain in the compressed tier of the cache pool in
+  /// place of blosc-compressed arrays, or `std::nullopt` to use the latter.
+  ///
+  /// Called while holding the cache pool's eviction lock, so this must not
+  /// perform any encoding itself; it is intended for returning a previously
+  /// retained representation, such as the stored chunk.
+  ///
+  /// By default, returns `std::nullopt`.
+  virtual std::optional<absl::Cord> GetEncodedChunkForCompressedTier(
+      Entry& entry, const void* read_data);
+
+  /// Decodes a representation previously returned by
+  /// `GetEncodedChunkForCompressedTier`, or returns `nullptr` on failure.
+  ///
+  /// By default, returns `nullptr`.
+  virtual std::shared_ptr<ReadData> DecodeChunkFromCompressedTier(
+      Entry& entry, absl::Cord encoded);
+
+  /// Returns the implementation of the chunk sent by `Write` for a single grid
+  /// cell.
+  ///
+  /// By default, returns an implementation that records the write in the
+  /// transaction node of `entry` associated with `request.transaction`.
+  /// Derived classes may override this to write some chunks by other means.
+  ///
+  /// \param request The write request.
+  /// \param entry Cache entry for the grid cell.
+  /// \param cell_to_dest Transform from the chunk domain to the component
+  ///     array, equal to the `WriteChunk::transform` of the chunk.
+  virtual Result<WriteChunk::Impl> GetWriteChunkImpl(
+      const WriteRequest& request, Entry& entry,
+      IndexTransformView<> cell_to_dest);
+
+  /// Sets `bounds` to the bounds, for each chunked dimension, of the elements
+  /// of the specified component that may be prefetched.  Only grid cells that
+  /// intersect `bounds` are prefetched.
+  ///
+  /// By default, uses the `component_bounds` of the grid specification.
+  /// Derived classes for which those are unbounded in resizable dimensions
+  /// should override this to exclude cells outside the current domain.
+  ///
+  /// \param component_index The component index.
+  /// \param bounds[out] Box of rank equal to `grid().grid_rank()`.
+  virtual void GetPrefetchBounds(size_t component_index,
+                                 MutableBoxView<> bounds);
+
+ private:
+  /// Issues prefetch reads for the grid cells predicted to follow a read of
+  /// the grid cells in `cells`.
+  void Prefetch(const ReadRequest& request, BoxView<> cells);
+
+  ChunkPrefetchDetector prefetch_detector_;
+
+  /// Estimated size in bytes of the prefetch reads that are in progress.
+  std::atomic<size_t> prefetch_bytes_in_flight_{0};
 };
 
 class ConcreteChunkCache : public ChunkCache {
@@ -115,6 +115,10 @@ struct BenchmarkConfig {
   /// Specifies whether the benchmark is a read benchmark (`read == true`) or
   /// write benchmark (`read == false`).
   bool read;
+
+  /// Specifies the `total_bytes_limit` of the cache pool.  If `0`, entries are
+  /// destroyed as soon as they are no longer referenced.
+  size_t total_bytes_limit = 0;
 };
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkConfig& config) {
@@ -125,7 +129,8 @@ std::ostream& operator<<(std::ostream& os, const BenchmarkConfig& config) {
          << span(std::vector<int>(config.indexed.begin(), config.indexed.end()))
          << ", cell_shape=" << span(config.cell_shape) << ", chunked="
          << span(std::vector<int>(config.chunked.begin(), config.chunked.end()))
-         << ", cached=" << config.cached << ", threads=" << config.threads;
+         << ", cached=" << config.cached << ", threads=" << config.threads
+         << ", total_bytes_limit=" << config.total_bytes_limit;
 }
 
 class BenchmarkCache : public ConcreteChunkCache {
@@ -224,7 +229,7 @@ class CopyBenchmarkRunner {
       executor = tensorstore::internal::DetachedThreadPool(config.threads);
     }
 
-    pool = CachePool::Make(CachePool::Limits{});
+    pool = CachePool::Make(CachePool::Limits{config.total_bytes_limit});
     const DimensionIndex rank = config.copy_shape.size();
     assert(rank == static_cast<DimensionIndex>(config.stride.size()));
     assert(rank == static_cast<DimensionIndex>(config.indexed.size()));
@@ -311,6 +316,48 @@ void BenchmarkCopy(const BenchmarkConfig& config, ::benchmark::State& state) {
   state.SetBytesProcessed(total_bytes);
 }
 
+// Measures the throughput of concurrently reading chunks that are already
+// cached, from an increasing number of threads.  Since the chunks are small,
+// this is dominated by acquiring and releasing references to the cache entries,
+// which for a cache pool with a non-zero `total_bytes_limit` requires updating
+// the eviction queue.
+void BM_ConcurrentCachedRead(::benchmark::State& state) {
+  static CopyBenchmarkRunner* runner = nullptr;
+  const BenchmarkConfig config{
+      /*dtype=*/tensorstore::dtype_v<int>,
+      /*copy_shape=*/{32, 32, 4},
+      /*stride=*/{1, 1, 1},
+      /*indexed=*/{false, false, false},
+      /*cell_shape=*/{8, 8, 8},
+      /*chunked=*/{true, true, true},
+      /*cached=*/true,
+      /*threads=*/0,
+      /*read=*/true,
+      /*total_bytes_limit=*/64 * 1024 * 1024,
+  };
+  if (state.thread_index() == 0) {
+    runner = new CopyBenchmarkRunner(config);
+    // Populate the cache.
+    runner->RunOnce();
+  }
+  auto array = AllocateArray(config.copy_shape, tensorstore::c_order,
+                             tensorstore::value_init, config.dtype);
+  const Index num_bytes = array.num_elements() * config.dtype->size;
+  for (auto s : state) {
+    tensorstore::internal::DriverRead(runner->cache->executor(),
+                                      {runner->driver, runner->transform},
+                                      array, {/*.progress_function=*/{}})
+        .result();
+  }
+  state.SetBytesProcessed(state.iterations() * num_bytes);
+  if (state.thread_index() == 0) {
+    delete runner;
+    runner = nullptr;
+  }
+}
+
+BENCHMARK(BM_ConcurrentCachedRead)->ThreadRange(1, 64)->UseRealTime();
+
 struct RegisterBenchmarks {
   static void Register(const BenchmarkConfig& config) {
     ::benchmark::RegisterBenchmark(
@@ -57,6 +57,7 @@
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/chunk_prefetch.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/element_copy_function.h"
@@ -118,6 +119,7 @@ using ::tensorstore::internal::CachePool;
 using ::tensorstore::internal::CachePtr;
 using ::tensorstore::internal::ChunkCache;
 using ::tensorstore::internal::ChunkGridSpecification;
+using ::tensorstore::internal::ChunkPrefetchOptions;
 using ::tensorstore::internal::ConcreteChunkCache;
 using ::tensorstore::internal::ElementCopyFunction;
 using ::tensorstore::internal::GetCache;
@@ -305,11 +307,12 @@ std::vector<Index> ParseKey(std::string_view key) {
 
 ReadWritePtr<TestDriver> MakeDriver(CachePtr<ChunkCache> cache,
                                     size_t component_index = 0,
-                                    StalenessBound data_staleness = {}) {
+                                    StalenessBound data_staleness = {},
+                                    ChunkPrefetchOptions prefetch = {}) {
   return MakeReadWritePtr<TestDriver>(
       tensorstore::ReadWriteMode::read_write,
       TestDriver::Initializer{std::move(cache), component_index,
-                              data_staleness});
+                              data_staleness, prefetch});
 }
 
 class ChunkCacheTest : public ::testing::Test {
@@ -618,6 +621,143 @@ TEST_F(ChunkCacheTest, ReadSingleComponentOneDimensionalExisting) {
   }
 }
 
+// Tests that chunks evicted from the cache are restored from the compressed
+// tier without issuing new read requests.
+TEST_F(ChunkCacheTest, ReadFromCompressedTier) {
+  // Dimension 0 is chunked with a size of 2.
+  grid = ChunkGridSpecification({ChunkGridSpecification::Component{
+      SharedArray<const void>(MakeArray<int>({1, 2})), Box<>(1)}});
+
+  SetChunk({1}, {MakeArray<int>({5, 6})});
+
+  // The primary limit is small enough that entries are evicted as soon as
+  // they are no longer referenced.
+  auto cache = MakeChunkCache(
+      "", CachePool::Make(CachePool::Limits{/*total_bytes_limit=*/1,
+                                            /*compressed_bytes_limit=*/
+                                            10000000}));
+
+  {
+    auto read_future =
+        tensorstore::Read(GetTensorStore(cache, absl::InfinitePast()) |
+                          tensorstore::Dims(0).TranslateSizedInterval(2, 2));
+    {
+      auto r = mock_store->read_requests.pop();
+      EXPECT_THAT(ParseKey(r.key), ElementsAre(1));
+      r(memory_store);
+    }
+    EXPECT_THAT(read_future.result(),
+                ::testing::Optional(tensorstore::MakeArray({5, 6})));
+  }
+
+  {
+    auto read_future =
+        tensorstore::Read(GetTensorStore(cache, absl::InfinitePast()) |
+                          tensorstore::Dims(0).TranslateSizedInterval(2, 2));
+    EXPECT_THAT(read_future.result(),
+                ::testing::Optional(tensorstore::MakeArray({5, 6})));
+    EXPECT_TRUE(mock_store->read_requests.empty());
+  }
+
+  // Revalidation of a restored chunk is conditioned on its generation.
+  {
+    auto read_future =
+        tensorstore::Read(GetTensorStore(cache, absl::InfiniteFuture()) |
+                          tensorstore::Dims(0).TranslateSizedInterval(2, 2));
+    {
+      auto r = mock_store->read_requests.pop();
+      EXPECT_THAT(ParseKey(r.key), ElementsAre(1));
+      EXPECT_FALSE(StorageGeneration::IsUnknown(
+          r.options.generation_conditions.if_not_equal));
+      r(memory_store);
+    }
+    EXPECT_THAT(read_future.result(),
+                ::testing::Optional(tensorstore::MakeArray({5, 6})));
+  }
+}
+
+// Tests that `tensorstore::Prefetch` populates the cache.
+TEST_F(ChunkCacheTest, Prefetch) {
+  // Dimension 0 is chunked with a size of 2.
+  grid = ChunkGridSpecification({ChunkGridSpecification::Component{
+      SharedArray<const void>(MakeArray<int>({1, 2})), Box<>(1)}});
+  SetChunk({1}, {MakeArray<int>({5, 6})});
+
+  auto cache = MakeChunkCache();
+  auto store = GetTensorStore(cache, absl::InfinitePast());
+
+  EXPECT_THAT(tensorstore::Prefetch(store).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Prefetch requires a finite domain, .*"));
+
+  std::vector<tensorstore::ReadProgress> read_progress;
+  auto prefetch_future = tensorstore::Prefetch(
+      store | tensorstore::Dims(0).TranslateSizedInterval(1, 3),
+      ReadProgressFunction{
+          [&read_progress](tensorstore::ReadProgress progress) {
+            read_progress.push_back(progress);
+          }});
+  {
+    auto r = mock_store->read_requests.pop();
+    EXPECT_THAT(ParseKey(r.key), ElementsAre(0));
+    r(memory_store);
+  }
+  {
+    auto r = mock_store->read_requests.pop();
+    EXPECT_THAT(ParseKey(r.key), ElementsAre(1));
+    r(memory_store);
+  }
+  TENSORSTORE_EXPECT_OK(prefetch_future.result());
+  EXPECT_THAT(read_progress,
+              ElementsAre(tensorstore::ReadProgress{3, 1},
+                          tensorstore::ReadProgress{3, 3}));
+
+  // Read is satisfied from the cache.
+  EXPECT_THAT(tensorstore::Read(store | tensorstore::Dims(0)
+                                            .TranslateSizedInterval(1, 3))
+                  .result(),
+              ::testing::Optional(tensorstore::MakeArray({2, 5, 6})));
+  EXPECT_TRUE(mock_store->read_requests.empty());
+}
+
+// Tests that sequential reads result in prefetch reads of the following
+// chunks.
+TEST_F(ChunkCacheTest, PrefetchSequentialReads) {
+  // Dimension 0 is chunked with a size of 2.
+  grid = ChunkGridSpecification({ChunkGridSpecification::Component{
+      SharedArray<const void>(MakeArray<int>({1, 2})), Box<>(1)}});
+
+  auto cache = MakeChunkCache();
+  ChunkPrefetchOptions prefetch;
+  prefetch.cells = 2;
+  TensorStore<> store =
+      tensorstore::internal::TensorStoreAccess::Construct<TensorStore<>>(
+          tensorstore::internal::Driver::Handle{
+              MakeDriver(cache, 0, absl::InfinitePast(), prefetch),
+              tensorstore::IdentityTransform(1)});
+
+  const auto read_chunk = [&](Index cell, std::vector<Index> expected_keys) {
+    auto read_future = tensorstore::Read(
+        store | tensorstore::Dims(0).TranslateSizedInterval(cell * 2, 2));
+    for (Index key : expected_keys) {
+      auto r = mock_store->read_requests.pop();
+      EXPECT_THAT(ParseKey(r.key), ElementsAre(key));
+      r(memory_store);
+    }
+    EXPECT_THAT(read_future.result(),
+                ::testing::Optional(tensorstore::MakeArray({1, 2})));
+    EXPECT_TRUE(mock_store->read_requests.empty());
+  };
+
+  read_chunk(0, {0});
+  read_chunk(1, {1});
+  // The stride is confirmed by the third read, and the next 2 chunks are
+  // prefetched after the chunk required by the read.
+  read_chunk(2, {2, 3, 4});
+  // Chunk 3 is already cached, and only chunk 5 remains to be prefetched.
+  read_chunk(3, {5});
+}
+
 // Test reading the fill value from a two-dimensional chunk cache.
 TEST_F(ChunkCacheTest, TwoDimensional) {
   grid = ChunkGridSpecification({ChunkGridSpecification::Component{
@@ -0,0 +1,101 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/chunk_prefetch.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/iterate_over_index_range.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+std::vector<Index> ChunkPrefetchDetector::Update(BoxView<> cells,
+                                                 BoxView<> grid_bounds,
+                                                 size_t max_cells) {
+  const DimensionIndex rank = cells.rank();
+  assert(grid_bounds.rank() == rank);
+  std::vector<Index> result;
+  absl::MutexLock lock(&mutex_);
+  if (last_cells_.rank() != rank ||
+      !std::equal(cells.shape().begin(), cells.shape().end(),
+                  last_cells_.shape().begin())) {
+    // Start of a new access pattern.
+    last_cells_ = Box<>(cells);
+    last_stride_.clear();
+    prefetched_strides_ = 0;
+    return result;
+  }
+
+  std::vector<Index> stride(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    stride[i] = cells.origin()[i] - last_cells_.origin()[i];
+  }
+  if (std::all_of(stride.begin(), stride.end(),
+                  [](Index x) { return x == 0; })) {
+    // Repeated read of the same cells does not advance the pattern.
+    return result;
+  }
+  const bool confirmed = (stride == last_stride_);
+  // Strides that were prefetched relative to the previous read are one stride
+  // closer relative to this read.
+  const size_t skip_strides =
+      (confirmed && prefetched_strides_ > 0) ? prefetched_strides_ - 1 : 0;
+  last_cells_ = Box<>(cells);
+  last_stride_ = std::move(stride);
+  prefetched_strides_ = 0;
+  if (!confirmed) return result;
+
+  Box<> target(cells);
+  Box<> previous(rank);
+  size_t num_cells = 0;
+  for (size_t k = 1; num_cells < max_cells; ++k) {
+    previous = target;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      target.origin()[i] += last_stride_[i];
+    }
+    bool any_in_bounds = false;
+    bool complete = true;
+    IterateOverIndexRange(target, [&](span<const Index> indices) {
+      if (!Contains(grid_bounds, indices) || Contains(previous, indices)) {
+        return true;
+      }
+      any_in_bounds = true;
+      if (num_cells == max_cells) {
+        complete = false;
+        return false;
+      }
+      ++num_cells;
+      if (k > skip_strides) {
+        result.insert(result.end(), indices.begin(), indices.end());
+      }
+      return true;
+    });
+    // Subsequent strides only move further out of bounds.
+    if (!any_in_bounds) break;
+    if (complete) prefetched_strides_ = k;
+  }
+  return result;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,91 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_CHUNK_PREFETCH_H_
+#define TENSORSTORE_INTERNAL_CACHE_CHUNK_PREFETCH_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Options that control speculative readahead of chunks by `ChunkCache`.
+struct ChunkPrefetchOptions {
+  /// Maximum number of grid cells to read ahead of a sequential access
+  /// pattern.  A value of `0` disables prefetching.
+  size_t cells = 0;
+
+  /// Maximum estimated number of bytes of outstanding prefetch reads.  A value
+  /// of `0` indicates a limit of half of the cache pool `total_bytes_limit`.
+  /// The limit is always capped at half of the cache pool `total_bytes_limit`.
+  size_t bytes_limit = 0;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.cells, x.bytes_limit);
+  };
+
+  friend bool operator==(const ChunkPrefetchOptions& a,
+                         const ChunkPrefetchOptions& b) {
+    return a.cells == b.cells && a.bytes_limit == b.bytes_limit;
+  }
+  friend bool operator!=(const ChunkPrefetchOptions& a,
+                         const ChunkPrefetchOptions& b) {
+    return !(a == b);
+  }
+};
+
+/// Detects strided sequential access over a chunk grid.
+///
+/// Each read is summarized by the bounding box of the grid cells that it
+/// touches.  Once two successive reads have the same shape and the same
+/// displacement as the read before them, the stride is considered confirmed
+/// and the cells covered by extrapolating the stride are returned for
+/// prefetching.  Cells that were returned by a previous call for the same
+/// access pattern are not returned again.
+///
+/// This class is thread-safe.
+class ChunkPrefetchDetector {
+ public:
+  /// Records a read of the grid cells in `cells`.
+  ///
+  /// \param cells Bounding box of the grid cells touched by the read.
+  /// \param grid_bounds Bounds on the valid grid cell indices, may be
+  ///     unbounded.
+  /// \param max_cells Maximum number of grid cells to read ahead.
+  /// \returns The grid cell indices to prefetch, in order of increasing
+  ///     distance from `cells`, flattened such that each consecutive sequence
+  ///     of `cells.rank()` values specifies one grid cell.
+  std::vector<Index> Update(BoxView<> cells, BoxView<> grid_bounds,
+                            size_t max_cells);
+
+ private:
+  absl::Mutex mutex_;
+  Box<> last_cells_ ABSL_GUARDED_BY(mutex_);
+  std::vector<Index> last_stride_ ABSL_GUARDED_BY(mutex_);
+  // Number of complete strides beyond `last_cells_` that have already been
+  // returned for prefetching.
+  size_t prefetched_strides_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_CHUNK_PREFETCH_H_
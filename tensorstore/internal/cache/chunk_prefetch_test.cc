@@ -0,0 +1,99 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/chunk_prefetch.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::BoxView;
+using ::tensorstore::Index;
+using ::tensorstore::internal::ChunkPrefetchDetector;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(ChunkPrefetchDetectorTest, SequentialOneDimensional) {
+  ChunkPrefetchDetector detector;
+  const BoxView<> unbounded(1);
+  EXPECT_THAT(detector.Update(Box({0}, {1}), unbounded, 3), IsEmpty());
+  // The first displacement is not yet confirmed.
+  EXPECT_THAT(detector.Update(Box({1}, {1}), unbounded, 3), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({2}, {1}), unbounded, 3),
+              ElementsAre(3, 4, 5));
+  // Cells that were previously prefetched are not returned again.
+  EXPECT_THAT(detector.Update(Box({3}, {1}), unbounded, 3), ElementsAre(6));
+  // Repeated reads of the same cells do not affect the pattern.
+  EXPECT_THAT(detector.Update(Box({3}, {1}), unbounded, 3), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({4}, {1}), unbounded, 3), ElementsAre(7));
+}
+
+TEST(ChunkPrefetchDetectorTest, StrideChange) {
+  ChunkPrefetchDetector detector;
+  const BoxView<> unbounded(1);
+  EXPECT_THAT(detector.Update(Box({0}, {1}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({1}, {1}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({2}, {1}), unbounded, 2), ElementsAre(3, 4));
+  EXPECT_THAT(detector.Update(Box({4}, {1}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({6}, {1}), unbounded, 2), ElementsAre(8, 10));
+  // Reverse direction.
+  EXPECT_THAT(detector.Update(Box({5}, {1}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({4}, {1}), unbounded, 2), ElementsAre(3, 2));
+}
+
+TEST(ChunkPrefetchDetectorTest, ShapeChangeResets) {
+  ChunkPrefetchDetector detector;
+  const BoxView<> unbounded(1);
+  EXPECT_THAT(detector.Update(Box({0}, {1}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({1}, {1}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({2}, {2}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({4}, {2}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({6}, {2}), unbounded, 2), ElementsAre(8, 9));
+}
+
+TEST(ChunkPrefetchDetectorTest, Bounds) {
+  ChunkPrefetchDetector detector;
+  const Box<> bounds({0}, {5});
+  EXPECT_THAT(detector.Update(Box({0}, {1}), bounds, 5), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({1}, {1}), bounds, 5), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({2}, {1}), bounds, 5), ElementsAre(3, 4));
+  EXPECT_THAT(detector.Update(Box({3}, {1}), bounds, 5), IsEmpty());
+}
+
+TEST(ChunkPrefetchDetectorTest, OverlappingReads) {
+  ChunkPrefetchDetector detector;
+  const BoxView<> unbounded(1);
+  EXPECT_THAT(detector.Update(Box({0}, {2}), unbounded, 2), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({1}, {2}), unbounded, 2), IsEmpty());
+  // Cell 3 is part of the current read.
+  EXPECT_THAT(detector.Update(Box({2}, {2}), unbounded, 2), ElementsAre(4, 5));
+}
+
+TEST(ChunkPrefetchDetectorTest, TwoDimensional) {
+  ChunkPrefetchDetector detector;
+  const Box<> bounds({0, 0}, {10, 3});
+  EXPECT_THAT(detector.Update(Box({0, 0}, {1, 3}), bounds, 4), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({1, 0}, {1, 3}), bounds, 4), IsEmpty());
+  EXPECT_THAT(detector.Update(Box({2, 0}, {1, 3}), bounds, 4),
+              ElementsAre(3, 0, 3, 1, 3, 2, 4, 0));
+  // The partially-prefetched row 4 is returned again.
+  EXPECT_THAT(detector.Update(Box({3, 0}, {1, 3}), bounds, 4),
+              ElementsAre(4, 0, 4, 1, 4, 2, 5, 0));
+}
+
+}  // namespace
@@ -0,0 +1,113 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/compressed_cache_tier.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/metrics/counter.h"
+
+namespace tensorstore {
+namespace internal_cache {
+namespace {
+
+auto& compressed_hit_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/compressed_tier/hit_count",
+    "Number of new cache entries restored from the compressed tier.");
+auto& compressed_miss_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/compressed_tier/miss_count",
+    "Number of new cache entries not found in the compressed tier.");
+auto& compressed_evict_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/compressed_tier/evict_count",
+    "Number of evictions from the compressed tier.");
+
+}  // namespace
+
+void CompressedCacheTier::EraseNode(NodeList::iterator it) {
+  total_bytes_ -= GetNodeSize(*it);
+  auto cache_it = caches_.find(it->cache_id);
+  cache_it->second.erase(it->key);
+  if (cache_it->second.empty()) {
+    caches_.erase(cache_it);
+  }
+  nodes_.erase(it);
+}
+
+void CompressedCacheTier::Insert(uint64_t cache_id, std::string key,
+                                 absl::Cord value) {
+  absl::MutexLock lock(&mutex_);
+  KeyMap& key_map = caches_[cache_id];
+  if (auto it = key_map.find(key); it != key_map.end()) {
+    auto node_it = it->second;
+    total_bytes_ -= GetNodeSize(*node_it);
+    key_map.erase(it);
+    nodes_.erase(node_it);
+  }
+  Node node{cache_id, std::move(key), std::move(value)};
+  const size_t node_size = GetNodeSize(node);
+  if (node_size > total_bytes_limit_) {
+    if (key_map.empty()) caches_.erase(cache_id);
+    return;
+  }
+  // Note: `EraseNode` may invalidate `key_map`.
+  while (total_bytes_ + node_size > total_bytes_limit_) {
+    compressed_evict_count.Increment();
+    EraseNode(nodes_.begin());
+  }
+  auto node_it = nodes_.insert(nodes_.end(), std::move(node));
+  total_bytes_ += node_size;
+  caches_[cache_id].emplace(node_it->key, node_it);
+}
+
+std::optional<absl::Cord> CompressedCacheTier::Take(uint64_t cache_id,
+                                                    std::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto cache_it = caches_.find(cache_id);
+  if (cache_it != caches_.end()) {
+    if (auto it = cache_it->second.find(key); it != cache_it->second.end()) {
+      compressed_hit_count.Increment();
+      auto node_it = it->second;
+      total_bytes_ -= GetNodeSize(*node_it);
+      absl::Cord value = std::move(node_it->value);
+      cache_it->second.erase(it);
+      if (cache_it->second.empty()) caches_.erase(cache_it);
+      nodes_.erase(node_it);
+      return value;
+    }
+  }
+  compressed_miss_count.Increment();
+  return std::nullopt;
+}
+
+void CompressedCacheTier::EraseCache(uint64_t cache_id) {
+  absl::MutexLock lock(&mutex_);
+  auto cache_it = caches_.find(cache_id);
+  if (cache_it == caches_.end()) return;
+  for (auto& [key, node_it] : cache_it->second) {
+    total_bytes_ -= GetNodeSize(*node_it);
+    nodes_.erase(node_it);
+  }
+  caches_.erase(cache_it);
+}
+
+}  // namespace internal_cache
+}  // namespace tensorstore
@@ -0,0 +1,96 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_COMPRESSED_CACHE_TIER_H_
+#define TENSORSTORE_INTERNAL_CACHE_COMPRESSED_CACHE_TIER_H_
+
+// IWYU pragma: private, include "third_party/tensorstore/internal/cache/cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorstore {
+namespace internal_cache {
+
+/// Second cache tier of a `CachePool` that holds compact encoded
+/// representations of evicted cache entries.
+///
+/// Values are keyed by the unique id of the owning cache and the entry key.
+/// The tier is exclusive: a value is removed when it is retrieved by `Take`,
+/// since the newly-created entry is then responsible for the data.  Once the
+/// total size exceeds the limit, the least recently inserted values are
+/// discarded.
+class CompressedCacheTier {
+ public:
+  explicit CompressedCacheTier(size_t total_bytes_limit)
+      : total_bytes_limit_(total_bytes_limit) {}
+
+  CompressedCacheTier(const CompressedCacheTier&) = delete;
+  CompressedCacheTier& operator=(const CompressedCacheTier&) = delete;
+
+  /// Stores `value` for the specified entry, replacing any existing value.
+  void Insert(uint64_t cache_id, std::string key, absl::Cord value);
+
+  /// Removes and returns the value for the specified entry, if present.
+  std::optional<absl::Cord> Take(uint64_t cache_id, std::string_view key);
+
+  /// Removes all values for the specified cache.
+  void EraseCache(uint64_t cache_id);
+
+  /// Returns the total number of bytes currently held, including per-value
+  /// overhead.
+  size_t total_bytes() const {
+    absl::MutexLock lock(&mutex_);
+    return total_bytes_;
+  }
+
+  size_t total_bytes_limit() const { return total_bytes_limit_; }
+
+ private:
+  struct Node {
+    uint64_t cache_id;
+    std::string key;
+    absl::Cord value;
+  };
+  using NodeList = std::list<Node>;
+  using KeyMap = absl::flat_hash_map<std::string, NodeList::iterator>;
+
+  static size_t GetNodeSize(const Node& node) {
+    return sizeof(Node) + node.key.size() + node.value.size();
+  }
+
+  void EraseNode(NodeList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t total_bytes_limit_;
+  mutable absl::Mutex mutex_;
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Front is the least recently inserted value, which is discarded first.
+  NodeList nodes_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<uint64_t, KeyMap> caches_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_cache
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_COMPRESSED_CACHE_TIER_H_
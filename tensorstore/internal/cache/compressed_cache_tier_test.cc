@@ -0,0 +1,89 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/compressed_cache_tier.h"
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+
+namespace {
+
+using ::tensorstore::internal_cache::CompressedCacheTier;
+using ::testing::Optional;
+
+TEST(CompressedCacheTierTest, InsertTake) {
+  CompressedCacheTier tier(10000);
+  EXPECT_EQ(0, tier.total_bytes());
+  tier.Insert(1, "a", absl::Cord("value_a"));
+  tier.Insert(2, "a", absl::Cord("other_a"));
+  EXPECT_LT(0, tier.total_bytes());
+  EXPECT_EQ(std::nullopt, tier.Take(1, "b"));
+  EXPECT_EQ(std::nullopt, tier.Take(3, "a"));
+  EXPECT_THAT(tier.Take(1, "a"), Optional(absl::Cord("value_a")));
+  // Values are removed once taken.
+  EXPECT_EQ(std::nullopt, tier.Take(1, "a"));
+  EXPECT_THAT(tier.Take(2, "a"), Optional(absl::Cord("other_a")));
+  EXPECT_EQ(0, tier.total_bytes());
+}
+
+TEST(CompressedCacheTierTest, Replace) {
+  CompressedCacheTier tier(10000);
+  tier.Insert(1, "a", absl::Cord("old"));
+  const size_t size = tier.total_bytes();
+  tier.Insert(1, "a", absl::Cord("new"));
+  EXPECT_EQ(size, tier.total_bytes());
+  EXPECT_THAT(tier.Take(1, "a"), Optional(absl::Cord("new")));
+  EXPECT_EQ(0, tier.total_bytes());
+}
+
+TEST(CompressedCacheTierTest, EvictsOldestFirst) {
+  const std::string value(1000, 'x');
+  CompressedCacheTier tier(2500);
+  tier.Insert(1, "a", absl::Cord(value));
+  tier.Insert(1, "b", absl::Cord(value));
+  tier.Insert(2, "c", absl::Cord(value));
+  EXPECT_LE(tier.total_bytes(), tier.total_bytes_limit());
+  EXPECT_EQ(std::nullopt, tier.Take(1, "a"));
+  EXPECT_THAT(tier.Take(1, "b"), Optional(absl::Cord(value)));
+  EXPECT_THAT(tier.Take(2, "c"), Optional(absl::Cord(value)));
+}
+
+TEST(CompressedCacheTierTest, ValueLargerThanLimit) {
+  CompressedCacheTier tier(100);
+  tier.Insert(1, "a", absl::Cord("small"));
+  tier.Insert(1, "b", absl::Cord(std::string(1000, 'x')));
+  EXPECT_EQ(std::nullopt, tier.Take(1, "b"));
+  EXPECT_THAT(tier.Take(1, "a"), Optional(absl::Cord("small")));
+}
+
+TEST(CompressedCacheTierTest, EraseCache) {
+  CompressedCacheTier tier(10000);
+  tier.Insert(1, "a", absl::Cord("value_a"));
+  tier.Insert(1, "b", absl::Cord("value_b"));
+  tier.Insert(2, "a", absl::Cord("other_a"));
+  tier.EraseCache(1);
+  tier.EraseCache(3);
+  EXPECT_EQ(std::nullopt, tier.Take(1, "a"));
+  EXPECT_EQ(std::nullopt, tier.Take(1, "b"));
+  EXPECT_THAT(tier.Take(2, "a"), Optional(absl::Cord("other_a")));
+  EXPECT_EQ(0, tier.total_bytes());
+}
+
+}  // namespace
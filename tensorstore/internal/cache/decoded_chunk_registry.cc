@@ -0,0 +1,116 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/decoded_chunk_registry.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/crc/crc32c.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/metrics/counter.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+auto& shared_decodes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/decoded_chunk_registry/hits",
+    "Number of chunk decodes avoided by sharing the decoded representation "
+    "of identical encoded chunks.");
+
+std::string GetNodesKey(std::string_view decoder_key, uint32_t digest) {
+  return absl::StrCat(
+      decoder_key,
+      std::string_view(reinterpret_cast<const char*>(&digest), sizeof(digest)));
+}
+
+}  // namespace
+
+uint32_t DecodedChunkRegistry::ComputeDigest(const absl::Cord& encoded) {
+  absl::crc32c_t crc{0};
+  for (std::string_view chunk : encoded.Chunks()) {
+    crc = absl::ExtendCrc32c(crc, chunk);
+  }
+  return static_cast<uint32_t>(crc);
+}
+
+std::shared_ptr<const void> DecodedChunkRegistry::Find(
+    std::string_view decoder_key, const absl::Cord& encoded, uint32_t digest) {
+  absl::MutexLock lock(&mutex_);
+  auto it = nodes_.find(GetNodesKey(decoder_key, digest));
+  if (it == nodes_.end()) return nullptr;
+  for (const auto& node : it->second) {
+    if (node.encoded != encoded) continue;
+    if (auto decoded = node.decoded.lock()) {
+      shared_decodes.Increment();
+      return decoded;
+    }
+  }
+  return nullptr;
+}
+
+void DecodedChunkRegistry::Register(
+    std::string_view decoder_key, absl::Cord encoded, uint32_t digest,
+    const std::shared_ptr<const void>& decoded) {
+  absl::MutexLock lock(&mutex_);
+  auto& nodes = nodes_[GetNodesKey(decoder_key, digest)];
+  // Replace any node for the same encoded bytes, which is expired if the
+  // chunk was decoded again.
+  for (auto& node : nodes) {
+    if (node.encoded != encoded) continue;
+    node.decoded = decoded;
+    return;
+  }
+  nodes.push_back(Node{std::move(encoded), decoded});
+  // Pruning once the number of nodes has doubled bounds the number of expired
+  // nodes at a constant amortized cost.
+  if (++num_nodes_ > 2 * num_nodes_after_prune_ + 64) Prune();
+}
+
+void DecodedChunkRegistry::Prune() {
+  for (auto it = nodes_.begin(); it != nodes_.end();) {
+    auto& nodes = it->second;
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(),
+                               [](const Node& node) {
+                                 return node.decoded.expired();
+                               }),
+                nodes.end());
+    if (nodes.empty()) {
+      nodes_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  num_nodes_ = 0;
+  for (const auto& [key, nodes] : nodes_) num_nodes_ += nodes.size();
+  num_nodes_after_prune_ = num_nodes_;
+}
+
+size_t DecodedChunkRegistry::size() {
+  absl::MutexLock lock(&mutex_);
+  Prune();
+  return num_nodes_;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
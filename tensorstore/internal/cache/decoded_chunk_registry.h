@@ -0,0 +1,96 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_DECODED_CHUNK_REGISTRY_H_
+#define TENSORSTORE_INTERNAL_CACHE_DECODED_CHUNK_REGISTRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Allows caches that share a `CachePool` to share the decoded representation
+/// of identical encoded chunks.
+///
+/// Decoded chunks are registered under a key that identifies the decoder,
+/// along with their encoded representation.  A chunk with the same decoder key
+/// and identical encoded bytes, possibly stored under a different key or in a
+/// different array, is then not decoded again as long as the registered
+/// decoded representation remains in use.  Candidates are found by a crc32c
+/// digest of the encoded bytes, and verified by comparing the bytes.
+///
+/// Only weak references to the decoded chunks are held, such that the registry
+/// does not extend their lifetime.  The encoded representation of a chunk is
+/// released once its decoded representation has been destroyed, when expired
+/// registrations are next pruned.
+class DecodedChunkRegistry {
+ public:
+  DecodedChunkRegistry() = default;
+
+  DecodedChunkRegistry(const DecodedChunkRegistry&) = delete;
+  DecodedChunkRegistry& operator=(const DecodedChunkRegistry&) = delete;
+
+  /// Returns the crc32c digest of `encoded`.
+  static uint32_t ComputeDigest(const absl::Cord& encoded);
+
+  /// Returns the decoded representation registered for `encoded` with
+  /// `decoder_key`, or `nullptr` if there is none.
+  ///
+  /// \param digest Must equal `ComputeDigest(encoded)`.
+  std::shared_ptr<const void> Find(std::string_view decoder_key,
+                                   const absl::Cord& encoded, uint32_t digest);
+
+  /// Registers `decoded` as the decoded representation of `encoded` with
+  /// `decoder_key`.
+  ///
+  /// \param digest Must equal `ComputeDigest(encoded)`.
+  void Register(std::string_view decoder_key, absl::Cord encoded,
+                uint32_t digest, const std::shared_ptr<const void>& decoded);
+
+  /// Returns the number of registered chunks that are still alive.
+  size_t size();
+
+ private:
+  struct Node {
+    absl::Cord encoded;
+    std::weak_ptr<const void> decoded;
+  };
+
+  // Removes the nodes whose decoded representation has been destroyed.
+  void Prune() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  // Keyed by the decoder key followed by the digest.
+  absl::flat_hash_map<std::string, std::vector<Node>> nodes_
+      ABSL_GUARDED_BY(mutex_);
+  size_t num_nodes_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of nodes after the last call to `Prune`.
+  size_t num_nodes_after_prune_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_DECODED_CHUNK_REGISTRY_H_
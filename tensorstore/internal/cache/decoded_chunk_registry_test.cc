@@ -0,0 +1,71 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/decoded_chunk_registry.h"
+
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+
+namespace {
+
+using ::tensorstore::internal::DecodedChunkRegistry;
+
+TEST(DecodedChunkRegistryTest, ComputeDigest) {
+  absl::Cord fragmented;
+  fragmented.Append(absl::Cord("ab"));
+  fragmented.Append(absl::Cord("c"));
+  EXPECT_EQ(DecodedChunkRegistry::ComputeDigest(absl::Cord("abc")),
+            DecodedChunkRegistry::ComputeDigest(fragmented));
+  EXPECT_NE(DecodedChunkRegistry::ComputeDigest(absl::Cord("abc")),
+            DecodedChunkRegistry::ComputeDigest(absl::Cord("abd")));
+}
+
+TEST(DecodedChunkRegistryTest, FindRegistered) {
+  DecodedChunkRegistry registry;
+  const absl::Cord encoded("encoded");
+  const auto digest = DecodedChunkRegistry::ComputeDigest(encoded);
+  auto decoded = std::make_shared<int>(42);
+  registry.Register("decoder", encoded, digest, decoded);
+  EXPECT_EQ(decoded, registry.Find("decoder", absl::Cord("encoded"), digest));
+  // The decoder key must match.
+  EXPECT_EQ(nullptr, registry.Find("other", encoded, digest));
+  // The bytes are compared, rather than only the digest.
+  EXPECT_EQ(nullptr, registry.Find("decoder", absl::Cord("other"), digest));
+  EXPECT_EQ(1u, registry.size());
+}
+
+TEST(DecodedChunkRegistryTest, DoesNotExtendLifetime) {
+  DecodedChunkRegistry registry;
+  const absl::Cord encoded("encoded");
+  const auto digest = DecodedChunkRegistry::ComputeDigest(encoded);
+  auto decoded = std::make_shared<int>(42);
+  std::weak_ptr<int> weak = decoded;
+  registry.Register("decoder", encoded, digest, decoded);
+  decoded.reset();
+  EXPECT_TRUE(weak.expired());
+  EXPECT_EQ(nullptr, registry.Find("decoder", encoded, digest));
+  EXPECT_EQ(0u, registry.size());
+
+  // Registering again replaces the expired registration.
+  auto decoded2 = std::make_shared<int>(43);
+  registry.Register("decoder", encoded, digest, decoded2);
+  EXPECT_EQ(decoded2, registry.Find("decoder", encoded, digest));
+  EXPECT_EQ(1u, registry.size());
+}
+
+}  // namespace
@@ -20,10 +20,12 @@ namespace tensorstore {
 namespace internal {
 namespace {
 
-auto& kvs_cache_read = internal_metrics::Counter<int64_t, std::string>::New(
-    "/tensorstore/cache/kvs_cache_read", "category",
-    "Count of kvs_backed_cache reads by category. A large number of "
-    "'unchanged' reads indicates that the dataset is relatively quiescent.");
+auto& kvs_cache_read =
+    internal_metrics::ShardedCounter<int64_t, std::string>::New(
+        "/tensorstore/cache/kvs_cache_read", "category",
+        "Count of kvs_backed_cache reads by category. A large number of "
+        "'unchanged' reads indicates that the dataset is relatively "
+        "quiescent.");
 }
 
 void KvsBackedCache_IncrementReadUnchangedMetric() {
@@ -33,6 +33,7 @@
 #include "absl/strings/cord.h"
 #include "absl/time/time.h"
 #include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/operations.h"
@@ -42,6 +43,7 @@
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/deadline.h"
 #include "tensorstore/util/execution/future_sender.h"  // IWYU pragma: keep
 #include "tensorstore/util/status.h"
 
@@ -145,6 +147,11 @@ class KvsBackedCache : public Parent {
         ABSL_LOG_IF(INFO, TENSORSTORE_ASYNC_CACHE_DEBUG)
             << *entry_or_node_ << "DoDecode: " << read_result.stamp;
         KvsBackedCache_IncrementReadChangedMetric();
+        if (read_result.has_value()) {
+          internal_tracing::AddIoAccounting(
+              &internal_tracing::IoAccounting::bytes_fetched,
+              read_result.value.size());
+        }
         GetOwningEntry(*entry_or_node_)
             .DoDecode(std::move(read_result).optional_value(),
                       DecodeReceiverImpl<EntryOrNode>{
@@ -171,6 +178,9 @@ class KvsBackedCache : public Parent {
       kvstore_options.generation_conditions.if_not_equal =
           std::move(read_state.stamp.generation);
       kvstore_options.batch = request.batch;
+      // The read is shared by all concurrent requests for this entry; it is
+      // bounded by the deadline of the request that issued it.
+      kvstore_options.deadline = internal::GetCurrentDeadline();
       auto& cache = GetOwningCache(*this);
       auto future = cache.kvstore_driver_->Read(this->GetKeyValueStoreKey(),
                                                 std::move(kvstore_options));
@@ -304,6 +314,11 @@ class KvsBackedCache : public Parent {
         }
         void set_cancel() { ABSL_UNREACHABLE(); }  // COV_NF_LINE
         void set_value(std::optional<absl::Cord> value) {
+          if (value) {
+            internal_tracing::AddIoAccounting(
+                &internal_tracing::IoAccounting::bytes_written,
+                value->size());
+          }
           kvstore::ReadResult read_result =
               value ? kvstore::ReadResult::Value(std::move(*value),
                                                  std::move(update_stamp_))
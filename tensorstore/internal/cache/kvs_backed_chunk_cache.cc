@@ -14,16 +14,31 @@
 
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/array.h"
 #include "tensorstore/index.h"
+#include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/decoded_chunk_registry.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
+#include "tensorstore/internal/chunk_buffer_pool.h"
+#include "tensorstore/internal/memory_budget.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
+#include "tensorstore/internal/tracing/trace_span.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 
@@ -37,33 +52,181 @@ std::string KvsBackedChunkCache::Entry::GetKeyValueStoreKey() {
 
 void KvsBackedChunkCache::Entry::DoDecode(std::optional<absl::Cord> value,
                                           DecodeReceiver receiver) {
-  GetOwningCache(*this).executor()([this, value = std::move(value),
-                                    receiver = std::move(receiver)]() mutable {
-    if (!value) {
-      execution::set_value(receiver, nullptr);
+  auto* memory_budget = value ? GetOwningCache(*this).memory_budget() : nullptr;
+  auto decode = [this, value = std::move(value),
+                 receiver = std::move(receiver)](
+                    MemoryReservation reservation) mutable {
+    // The reservation is released once the decoded chunk has been handed to
+    // the cache, which accounts for it from then on.
+    GetOwningCache(*this).executor()([this, value = std::move(value),
+                                      receiver = std::move(receiver),
+                                      reservation =
+                                          std::move(reservation)]() mutable {
+      DecodeAdmitted(std::move(value), std::move(receiver));
+    });
+  };
+  if (!memory_budget) {
+    decode(MemoryReservation());
+    return;
+  }
+  size_t decoded_size = 0;
+  for (const auto& component_spec : this->component_specs()) {
+    decoded_size += component_spec.EstimateReadStateSizeInBytes(true);
+  }
+  memory_budget->Reserve(decoded_size, std::move(decode));
+}
+
+void KvsBackedChunkCache::Entry::DecodeAdmitted(
+    std::optional<absl::Cord> value, DecodeReceiver receiver) {
+  if (!value) {
+    execution::set_value(receiver, nullptr);
+    return;
+  }
+  auto& cache = GetOwningCache(*this);
+  std::optional<absl::Cord> encoded;
+  if (cache.retain_encoded_chunks() && cache.pool() &&
+      cache.pool()->limits().total_bytes_limit != 0 &&
+      cache.pool()->limits().compressed_bytes_limit != 0) {
+    encoded = *value;
+  }
+  // Encoded data retained to register the decoded chunk for sharing.
+  std::optional<std::string> sharing_key;
+  std::optional<absl::Cord> sharing_encoded;
+  uint32_t digest = 0;
+  DecodedChunkRegistry* registry =
+      cache.pool() ? cache.pool()->decoded_chunk_registry() : nullptr;
+  if (registry && (sharing_key = cache.GetDecodeSharingKey())) {
+    digest = DecodedChunkRegistry::ComputeDigest(*value);
+    if (auto shared = registry->Find(*sharing_key, *value, digest)) {
+      if (encoded) {
+        RetainEncodedChunk(shared, *std::move(encoded));
+      }
+      execution::set_value(receiver,
+                           std::static_pointer_cast<const ReadData>(shared));
       return;
     }
-    auto& cache = GetOwningCache(*this);
-    auto decoded_result =
-        cache.DecodeChunk(this->cell_indices(), std::move(*value));
-    if (!decoded_result.ok()) {
-      execution::set_error(receiver,
-                           internal::ConvertInvalidArgumentToFailedPrecondition(
-                               std::move(decoded_result).status()));
-      return;
+    sharing_encoded = *value;
+  }
+  internal_tracing::TraceSpan span("tensorstore.codec.decode");
+  span.SetAttribute("size", value->size());
+  auto decoded_result = [&] {
+    ScopedChunkBufferPool buffer_pool_scope(cache.chunk_buffer_pool());
+    return cache.DecodeChunk(this->cell_indices(), std::move(*value));
+  }();
+  span.SetStatus(decoded_result.status());
+  span.End();
+  if (!decoded_result.ok()) {
+    execution::set_error(receiver,
+                         internal::ConvertInvalidArgumentToFailedPrecondition(
+                             std::move(decoded_result).status()));
+    return;
+  }
+  if (internal_tracing::GetCurrentIoAccounting()) {
+    Index decoded_bytes = 0;
+    for (const auto& array : *decoded_result) {
+      if (!array.valid()) continue;
+      decoded_bytes += array.num_elements() * array.dtype()->size;
     }
-    const size_t num_components = this->component_specs().size();
-    auto new_read_data =
-        internal::make_shared_for_overwrite<ReadData[]>(num_components);
-    assert(decoded_result->size() == num_components);
-    std::copy_n(decoded_result->begin(), num_components, new_read_data.get());
-    execution::set_value(
-        receiver, std::static_pointer_cast<ReadData>(std::move(new_read_data)));
-  });
+    internal_tracing::AddIoAccounting(
+        &internal_tracing::IoAccounting::bytes_decoded, decoded_bytes);
+  }
+  const size_t num_components = this->component_specs().size();
+  auto new_read_data =
+      internal::make_shared_for_overwrite<ReadData[]>(num_components);
+  assert(decoded_result->size() == num_components);
+  std::copy_n(decoded_result->begin(), num_components, new_read_data.get());
+  if (encoded) {
+    RetainEncodedChunk(new_read_data, *std::move(encoded));
+  }
+  if (sharing_encoded) {
+    registry->Register(*sharing_key, *std::move(sharing_encoded), digest,
+                       new_read_data);
+  }
+  execution::set_value(
+      receiver, std::static_pointer_cast<ReadData>(std::move(new_read_data)));
+}
+
+void KvsBackedChunkCache::Entry::RetainEncodedChunk(
+    const std::shared_ptr<const void>& read_data, absl::Cord encoded) {
+  absl::MutexLock lock(&encoded_chunk_mutex_);
+  encoded_chunk_read_data_ = read_data;
+  encoded_chunk_ = std::move(encoded);
+}
+
+std::optional<absl::Cord> KvsBackedChunkCache::Entry::GetRetainedEncodedChunk(
+    const void* read_data) {
+  absl::MutexLock lock(&encoded_chunk_mutex_);
+  auto retained = encoded_chunk_read_data_.lock();
+  if (!retained || retained.get() != read_data) return std::nullopt;
+  return encoded_chunk_;
+}
+
+size_t KvsBackedChunkCache::Entry::ComputeReadDataSizeInBytes(
+    const void* read_data) {
+  size_t total = ChunkCache::Entry::ComputeReadDataSizeInBytes(read_data);
+  if (auto encoded = GetRetainedEncodedChunk(read_data)) {
+    total += encoded->size();
+  }
+  return total;
+}
+
+std::optional<absl::Cord>
+KvsBackedChunkCache::GetEncodedChunkForCompressedTier(
+    ChunkCache::Entry& entry, const void* read_data) {
+  return static_cast<Entry&>(entry).GetRetainedEncodedChunk(read_data);
+}
+
+std::shared_ptr<KvsBackedChunkCache::ReadData>
+KvsBackedChunkCache::DecodeChunkFromCompressedTier(
+    ChunkCache::Entry& base_entry, absl::Cord encoded) {
+  auto& entry = static_cast<Entry&>(base_entry);
+  auto decoded_result = DecodeChunk(entry.cell_indices(), encoded);
+  if (!decoded_result.ok()) return nullptr;
+  const size_t num_components = grid().components.size();
+  auto new_read_data =
+      internal::make_shared_for_overwrite<ReadData[]>(num_components);
+  assert(decoded_result->size() == num_components);
+  std::copy_n(decoded_result->begin(), num_components, new_read_data.get());
+  // Retain the encoded representation again, in case this entry is evicted
+  // once more.
+  entry.RetainEncodedChunk(new_read_data, std::move(encoded));
+  return new_read_data;
+}
+
+void KvsBackedChunkCache::Entry::AddPendingDirectWrite(
+    Future<const void> future) {
+  absl::MutexLock lock(&direct_writes_mutex_);
+  direct_writes_.push_back(std::move(future));
+}
+
+Future<const void> KvsBackedChunkCache::Entry::GetPendingDirectWrites() {
+  absl::MutexLock lock(&direct_writes_mutex_);
+  direct_writes_.erase(
+      std::remove_if(direct_writes_.begin(), direct_writes_.end(),
+                     [](const Future<const void>& f) { return f.ready(); }),
+      direct_writes_.end());
+  if (direct_writes_.empty()) return {};
+  return WaitAllFuture(span(direct_writes_));
 }
 
 void KvsBackedChunkCache::Entry::DoEncode(std::shared_ptr<const ReadData> data,
                                           EncodeReceiver receiver) {
+  // Encoding immediately precedes the write to the kvstore, which must not
+  // be issued before earlier direct writes of the chunk complete.
+  if (auto pending = GetPendingDirectWrites(); !pending.null()) {
+    std::move(pending).ExecuteWhenReady(
+        [self = PinnedCacheEntry<KvsBackedChunkCache>(this),
+         data = std::move(data),
+         receiver = std::move(receiver)](ReadyFuture<const void>) mutable {
+          self->EncodeNow(std::move(data), std::move(receiver));
+        });
+    return;
+  }
+  EncodeNow(std::move(data), std::move(receiver));
+}
+
+void KvsBackedChunkCache::Entry::EncodeNow(std::shared_ptr<const ReadData> data,
+                                           EncodeReceiver receiver) {
   if (!data) {
     execution::set_value(receiver, std::nullopt);
     return;
@@ -83,8 +246,11 @@ void KvsBackedChunkCache::Entry::DoEncode(std::shared_ptr<const ReadData> data,
       component_arrays[i] = component_specs[i].fill_value;
     }
   }
+  internal_tracing::TraceSpan span("tensorstore.codec.encode");
   auto encoded_result =
       cache.EncodeChunk(entry.cell_indices(), component_arrays);
+  span.SetStatus(encoded_result.status());
+  span.End();
   if (!encoded_result.ok()) {
     execution::set_error(receiver, std::move(encoded_result).status());
     return;
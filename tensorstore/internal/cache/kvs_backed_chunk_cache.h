@@ -18,13 +18,17 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/array.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 
@@ -43,6 +47,19 @@ class KvsBackedChunkCache
 
   using Base::Base;
 
+  /// Specifies whether the stored representation of chunks read from the
+  /// kvstore is retained while they are cached, so that evicted chunks are
+  /// kept in that form, rather than as blosc-compressed arrays, in the
+  /// compressed tier of the cache pool (see
+  /// `CachePoolLimits::compressed_bytes_limit`).
+  ///
+  /// This is beneficial for formats, such as segmentation encodings, with a
+  /// much higher compression ratio than blosc, at the cost of also holding
+  /// the stored representation in memory while the decoded chunk is cached.
+  /// Has no effect if the cache pool does not have a compressed tier.
+  bool retain_encoded_chunks() const { return retain_encoded_chunks_; }
+  void set_retain_encoded_chunks(bool value) { retain_encoded_chunks_ = value; }
+
   virtual std::string GetChunkStorageKey(span<const Index> cell_indices) = 0;
 
   /// Decodes a data chunk.
@@ -55,6 +72,18 @@ class KvsBackedChunkCache
   virtual Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunk(
       span<const Index> chunk_indices, absl::Cord data) = 0;
 
+  /// Returns a key that identifies the decoding performed by `DecodeChunk`,
+  /// or `std::nullopt` (the default) if decoded chunks must not be shared.
+  ///
+  /// If the cache pool has `CachePoolLimits::share_decoded_chunks` enabled,
+  /// chunks with the same key and identical encoded data share a single
+  /// decoded representation, across all caches in the pool.  This is only
+  /// valid if the result of `DecodeChunk` depends only on the encoded data
+  /// and on the properties encoded in the key, and not on the chunk indices.
+  virtual std::optional<std::string> GetDecodeSharingKey() {
+    return std::nullopt;
+  }
+
   /// Encodes a data chunk.
   ///
   /// \param component_arrays Chunk data for each component.
@@ -75,14 +104,66 @@ class KvsBackedChunkCache
     void DoEncode(std::shared_ptr<const ReadData> data,
                   EncodeReceiver receiver) override;
     std::string GetKeyValueStoreKey() override;
+    size_t ComputeReadDataSizeInBytes(const void* read_data) override;
+
+    /// Registers a write of the stored chunk that bypasses this cache, and
+    /// that becomes ready when `future` does.
+    ///
+    /// Writeback of modifications recorded in the cache is deferred until all
+    /// such writes registered before it complete, so that the stored chunk is
+    /// not overwritten by an earlier direct write.
+    void AddPendingDirectWrite(Future<const void> future);
+
+   private:
+    friend class KvsBackedChunkCache;
+
+    // Returns a future that becomes ready once all direct writes registered
+    // so far complete, or a null future if there are none.
+    Future<const void> GetPendingDirectWrites();
+
+    // Encodes `data` once pending direct writes have completed.
+    void EncodeNow(std::shared_ptr<const ReadData> data,
+                   EncodeReceiver receiver);
+
+    // Decodes `value` once memory for the decoded chunk has been reserved
+    // from the `memory_budget()` of the cache.
+    void DecodeAdmitted(std::optional<absl::Cord> value,
+                        DecodeReceiver receiver);
+
+    // Records `encoded` as the stored representation of `read_data`.
+    void RetainEncodedChunk(const std::shared_ptr<const void>& read_data,
+                            absl::Cord encoded);
+
+    // Returns the stored representation of `read_data`, if retained.
+    std::optional<absl::Cord> GetRetainedEncodedChunk(const void* read_data);
+
+    absl::Mutex encoded_chunk_mutex_;
+    // Read data decoded from `encoded_chunk_`.  A weak reference ensures that
+    // a different object allocated at the same address is not mistaken for
+    // it.
+    std::weak_ptr<const void> encoded_chunk_read_data_
+        ABSL_GUARDED_BY(encoded_chunk_mutex_);
+    absl::Cord encoded_chunk_ ABSL_GUARDED_BY(encoded_chunk_mutex_);
+
+    absl::Mutex direct_writes_mutex_;
+    std::vector<Future<const void>> direct_writes_
+        ABSL_GUARDED_BY(direct_writes_mutex_);
   };
 
+  std::optional<absl::Cord> GetEncodedChunkForCompressedTier(
+      ChunkCache::Entry& entry, const void* read_data) override;
+  std::shared_ptr<ReadData> DecodeChunkFromCompressedTier(
+      ChunkCache::Entry& entry, absl::Cord encoded) override;
+
   Entry* DoAllocateEntry() override { return new Entry; }
   size_t DoGetSizeofEntry() override { return sizeof(Entry); }
   TransactionNode* DoAllocateTransactionNode(
       AsyncCache::Entry& entry) override {
     return new TransactionNode(static_cast<Entry&>(entry));
   }
+
+ private:
+  bool retain_encoded_chunks_ = false;
 };
 
 }  // namespace internal
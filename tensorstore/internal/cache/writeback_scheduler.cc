@@ -0,0 +1,110 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/writeback_scheduler.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/cache/cache_pool_limits.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/transaction.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+auto& watermark_commits = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/writeback_scheduler/watermark_commits",
+    "Number of groups of buffered writes committed because the cache pool "
+    "exceeded its dirty bytes high watermark.");
+
+size_t GetLowWatermark(const CachePoolLimits& limits) {
+  if (limits.dirty_bytes_low_watermark == 0 ||
+      limits.dirty_bytes_low_watermark > limits.dirty_bytes_high_watermark) {
+    return limits.dirty_bytes_high_watermark / 2;
+  }
+  return limits.dirty_bytes_low_watermark;
+}
+
+}  // namespace
+
+WritebackScheduler::WritebackScheduler(const CachePoolLimits& limits)
+    : high_watermark_(limits.dirty_bytes_high_watermark),
+      low_watermark_(GetLowWatermark(limits)),
+      max_dirty_age_(limits.max_dirty_age) {}
+
+void WritebackScheduler::Register(const Transaction& group) {
+  if (max_dirty_age_ != absl::InfiniteDuration()) {
+    internal::ScheduleAt(absl::Now() + max_dirty_age_, [group] {
+      // The group may already have been committed, in which case this has no
+      // effect.
+      group.CommitAsync().IgnoreFuture();
+    });
+  }
+  if (high_watermark_ == 0) return;
+  absl::MutexLock lock(&mutex_);
+  groups_.push_back(group);
+}
+
+size_t WritebackScheduler::PruneGroups() {
+  size_t total_bytes = 0;
+  std::deque<Transaction> open_groups;
+  for (auto& group : groups_) {
+    if (group.commit_started() || group.aborted()) continue;
+    total_bytes += group.total_bytes();
+    open_groups.push_back(std::move(group));
+  }
+  groups_ = std::move(open_groups);
+  return total_bytes;
+}
+
+void WritebackScheduler::MaybeCommit() {
+  if (high_watermark_ == 0) return;
+  std::vector<Transaction> to_commit;
+  {
+    absl::MutexLock lock(&mutex_);
+    size_t total_bytes = PruneGroups();
+    if (total_bytes <= high_watermark_) return;
+    while (total_bytes > low_watermark_ && !groups_.empty()) {
+      auto& group = groups_.front();
+      total_bytes -= std::min(total_bytes, group.total_bytes());
+      to_commit.push_back(std::move(group));
+      groups_.pop_front();
+    }
+  }
+  // Commit with the lock released, since committing may call back into the
+  // write-behind buffers.
+  watermark_commits.IncrementBy(to_commit.size());
+  for (auto& group : to_commit) {
+    group.CommitAsync().IgnoreFuture();
+  }
+}
+
+size_t WritebackScheduler::dirty_bytes() {
+  absl::MutexLock lock(&mutex_);
+  return PruneGroups();
+}
+
+}  // namespace internal
+}  // namespace tensorstore
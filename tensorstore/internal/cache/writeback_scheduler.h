@@ -0,0 +1,82 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_WRITEBACK_SCHEDULER_H_
+#define TENSORSTORE_INTERNAL_CACHE_WRITEBACK_SCHEDULER_H_
+
+#include <stddef.h>
+
+#include <deque>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/cache/cache_pool_limits.h"
+#include "tensorstore/transaction.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Limits the total amount and age of buffered writes across all of the
+/// write-behind buffers that share a `CachePool`.
+///
+/// Each group of buffered writes is an open transaction that is committed by
+/// its buffer according to the buffer's own limits.  The scheduler
+/// additionally commits groups, oldest first, once the total size of the
+/// uncommitted groups exceeds `CachePoolLimits::dirty_bytes_high_watermark`,
+/// and commits each group once it reaches `CachePoolLimits::max_dirty_age`.
+/// Commits proceed asynchronously, such that a producer is not stalled by one
+/// large commit of everything it has written.
+class WritebackScheduler {
+ public:
+  explicit WritebackScheduler(const CachePoolLimits& limits);
+
+  WritebackScheduler(const WritebackScheduler&) = delete;
+  WritebackScheduler& operator=(const WritebackScheduler&) = delete;
+
+  /// Returns `true` if `limits` specify any limit enforced by the scheduler.
+  static bool Enabled(const CachePoolLimits& limits) {
+    return limits.dirty_bytes_high_watermark != 0 ||
+           limits.max_dirty_age != absl::InfiniteDuration();
+  }
+
+  /// Adds a newly-started group.
+  void Register(const Transaction& group);
+
+  /// Commits the oldest groups if the total size of the uncommitted groups
+  /// exceeds the high watermark.
+  ///
+  /// Should be called whenever writes may have been added to a group.
+  void MaybeCommit();
+
+  /// Returns the total size of the uncommitted groups.
+  size_t dirty_bytes();
+
+ private:
+  /// Removes groups that are no longer open and returns the total size of the
+  /// remaining groups.
+  size_t PruneGroups() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t high_watermark_;
+  const size_t low_watermark_;
+  const absl::Duration max_dirty_age_;
+  absl::Mutex mutex_;
+  // Ordered from oldest to newest.
+  std::deque<Transaction> groups_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_WRITEBACK_SCHEDULER_H_
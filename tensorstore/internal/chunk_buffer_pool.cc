@@ -0,0 +1,184 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_buffer_pool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/numeric/bits.h"
+#include "absl/synchronization/mutex.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_MMAP 1
+#endif
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+constexpr size_t kPageSize = 4096;
+
+ABSL_CONST_INIT thread_local ChunkBufferPool* current_chunk_buffer_pool =
+    nullptr;
+
+size_t RoundUpTo(size_t size, size_t multiple) {
+  return (size + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+std::shared_ptr<ChunkBufferPool> ChunkBufferPool::Make(
+    const Options& options) {
+  return std::shared_ptr<ChunkBufferPool>(new ChunkBufferPool(options));
+}
+
+ChunkBufferPool::~ChunkBufferPool() {
+  for (auto& [size_class, buffers] : free_buffers_) {
+    for (void* ptr : buffers) Unmap(ptr, size_class);
+  }
+}
+
+size_t ChunkBufferPool::GetSizeClass(size_t size) {
+  if (size <= kMinBufferSize) return kMinBufferSize;
+  // Four size classes per power of two bound the unused part of a buffer to
+  // a quarter of its size.  Unused pages are never touched, and therefore do
+  // not consume memory.
+  const size_t step = std::max(absl::bit_floor(size - 1) / 4, kPageSize);
+  return RoundUpTo(size, step);
+}
+
+void* ChunkBufferPool::Allocate(size_t size, bool& zeroed) {
+  const size_t size_class = GetSizeClass(size);
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = free_buffers_.find(size_class);
+    if (it != free_buffers_.end() && !it->second.empty()) {
+      void* ptr = it->second.back();
+      it->second.pop_back();
+      cached_bytes_ -= size_class;
+      zeroed = false;
+      return ptr;
+    }
+  }
+#ifdef TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_MMAP
+  zeroed = true;
+#else
+  zeroed = false;
+#endif
+  return Map(size_class);
+}
+
+void ChunkBufferPool::Deallocate(void* ptr, size_t size) {
+  const size_t size_class = GetSizeClass(size);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (cached_bytes_ + size_class <= options_.max_cached_bytes) {
+      free_buffers_[size_class].push_back(ptr);
+      cached_bytes_ += size_class;
+      return;
+    }
+  }
+  Unmap(ptr, size_class);
+}
+
+size_t ChunkBufferPool::cached_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return cached_bytes_;
+}
+
+#ifdef TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_MMAP
+
+namespace {
+
+// Returns the length of the mapping of a buffer of `size_class` bytes, which
+// is a whole number of huge pages if huge pages may back it.
+size_t GetMappedSize(HugePageMode huge_pages, size_t size_class) {
+  if (huge_pages == HugePageMode::kNone ||
+      size_class < ChunkBufferPool::kHugePageSize) {
+    return size_class;
+  }
+  return RoundUpTo(size_class, ChunkBufferPool::kHugePageSize);
+}
+
+void* MapPages(size_t size, int extra_flags = 0) {
+  void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+}  // namespace
+
+void* ChunkBufferPool::Map(size_t size_class) {
+  const size_t size = GetMappedSize(options_.huge_pages, size_class);
+  if (size == size_class) return MapPages(size);
+#ifdef MAP_HUGETLB
+  if (options_.huge_pages == HugePageMode::kHugetlb) {
+    if (void* ptr = MapPages(size, MAP_HUGETLB)) return ptr;
+  }
+#endif
+  // Transparent huge pages are only used for huge-page-aligned ranges, so the
+  // mapping is over-allocated and trimmed to an aligned range.
+  char* ptr = static_cast<char*>(MapPages(size + kHugePageSize));
+  if (!ptr) return nullptr;
+  const size_t head =
+      RoundUpTo(reinterpret_cast<uintptr_t>(ptr), kHugePageSize) -
+      reinterpret_cast<uintptr_t>(ptr);
+  if (head != 0) ::munmap(ptr, head);
+  ::munmap(ptr + head + size, kHugePageSize - head);
+  ptr += head;
+#ifdef MADV_HUGEPAGE
+  ::madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+  return ptr;
+}
+
+void ChunkBufferPool::Unmap(void* ptr, size_t size_class) {
+  ::munmap(ptr, GetMappedSize(options_.huge_pages, size_class));
+}
+
+#else  // TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_MMAP
+
+void* ChunkBufferPool::Map(size_t size_class) {
+  return ::operator new(size_class, std::align_val_t(kPageSize),
+                        std::nothrow);
+}
+
+void ChunkBufferPool::Unmap(void* ptr, size_t size_class) {
+  ::operator delete(ptr, std::align_val_t(kPageSize));
+}
+
+#endif  // TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_MMAP
+
+ChunkBufferPool* GetCurrentChunkBufferPool() {
+  return current_chunk_buffer_pool;
+}
+
+ScopedChunkBufferPool::ScopedChunkBufferPool(ChunkBufferPool* pool)
+    : prev_(std::exchange(current_chunk_buffer_pool, pool)) {}
+
+ScopedChunkBufferPool::~ScopedChunkBufferPool() {
+  current_chunk_buffer_pool = prev_;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,143 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_H_
+#define TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Specifies how the memory of chunk buffers is backed by huge pages.
+enum class HugePageMode : uint8_t {
+  /// Regular pages.
+  kNone,
+
+  /// Transparent huge pages, requested by `madvise(MADV_HUGEPAGE)` for
+  /// buffers of at least `ChunkBufferPool::kHugePageSize`.
+  kTransparent,
+
+  /// Explicitly reserved huge pages, allocated by `mmap(MAP_HUGETLB)` for
+  /// buffers of at least `ChunkBufferPool::kHugePageSize`.  Falls back to
+  /// transparent huge pages if no reserved huge pages are available.
+  kHugetlb,
+};
+
+/// Allocator for large chunk buffers, which retains freed buffers for reuse.
+///
+/// Buffers are mapped directly from the operating system, rounded up to one
+/// of a set of size classes, such that a freed buffer can be reused for any
+/// later request of the same class without touching new pages.  Freed buffers
+/// are retained, up to a total of `Options::max_cached_bytes`, rather than
+/// returned to the operating system, which avoids the page faults incurred by
+/// the first access to newly-mapped memory.
+///
+/// Buffers are used by `AllocateAndConstructShared` while a
+/// `ScopedChunkBufferPool` is active on the current thread.
+///
+/// On platforms without `mmap`, buffers are allocated by `operator new`, and
+/// huge pages are not supported.
+class ChunkBufferPool : public std::enable_shared_from_this<ChunkBufferPool> {
+ public:
+  struct Options {
+    /// Limit on the total size of freed buffers retained for reuse.
+    size_t max_cached_bytes = 0;
+
+    HugePageMode huge_pages = HugePageMode::kNone;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.max_cached_bytes, x.huge_pages);
+    };
+  };
+
+  /// Smaller allocations are not served by the pool.
+  constexpr static size_t kMinBufferSize = 64 * 1024;
+
+  /// Size of huge pages assumed for `HugePageMode`.
+  constexpr static size_t kHugePageSize = 2 * 1024 * 1024;
+
+  static std::shared_ptr<ChunkBufferPool> Make(const Options& options);
+
+  ~ChunkBufferPool();
+
+  /// Returns the size class of allocations of `size` bytes.
+  static size_t GetSizeClass(size_t size);
+
+  /// Allocates a buffer of at least `size` bytes, aligned to at least the page
+  /// size.
+  ///
+  /// \param size Must be at least `kMinBufferSize`.
+  /// \param zeroed[out] Set to `true` if the buffer is known to be filled with
+  ///     zeros.
+  /// \returns The buffer, or `nullptr` if the allocation failed.
+  void* Allocate(size_t size, bool& zeroed);
+
+  /// Returns a buffer obtained from `Allocate(size, ...)`.
+  void Deallocate(void* ptr, size_t size);
+
+  /// Returns the total size of freed buffers retained for reuse.
+  size_t cached_bytes() const;
+
+  const Options& options() const { return options_; }
+
+ private:
+  explicit ChunkBufferPool(const Options& options) : options_(options) {}
+
+  void* Map(size_t size_class);
+  void Unmap(void* ptr, size_t size_class);
+
+  const Options options_;
+  mutable absl::Mutex mutex_;
+  // Freed buffers, keyed by size class.
+  absl::flat_hash_map<size_t, std::vector<void*>> free_buffers_
+      ABSL_GUARDED_BY(mutex_);
+  size_t cached_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+/// Returns the pool set by the innermost `ScopedChunkBufferPool` on the current
+/// thread, or `nullptr` if there is none.
+ChunkBufferPool* GetCurrentChunkBufferPool();
+
+/// Sets the pool used by `AllocateAndConstructShared` on the current thread for
+/// the lifetime of this object.
+///
+/// Used by the chunk caches around decoding and writing chunks, such that
+/// the arrays allocated for chunks, including those allocated by the chunk
+/// decoders of individual drivers, are served by the pool.
+class ScopedChunkBufferPool {
+ public:
+  /// \param pool The pool to use, or `nullptr` to use the general allocator.
+  explicit ScopedChunkBufferPool(ChunkBufferPool* pool);
+  ~ScopedChunkBufferPool();
+
+  ScopedChunkBufferPool(const ScopedChunkBufferPool&) = delete;
+  ScopedChunkBufferPool& operator=(const ScopedChunkBufferPool&) = delete;
+
+ private:
+  ChunkBufferPool* prev_;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CHUNK_BUFFER_POOL_H_
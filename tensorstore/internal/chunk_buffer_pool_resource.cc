@@ -0,0 +1,78 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_buffer_pool_resource.h"
+
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/chunk_buffer_pool.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+constexpr auto HugePageModeJsonBinder = [](auto is_loading,
+                                           const auto& options, auto* obj,
+                                           auto* j) {
+  return jb::Enum<HugePageMode, const char*>({
+      {HugePageMode::kNone, "none"},
+      {HugePageMode::kTransparent, "transparent"},
+      {HugePageMode::kHugetlb, "hugetlb"},
+  })(is_loading, options, obj, j);
+};
+
+struct ChunkBufferPoolResourceTraits
+    : public ContextResourceTraits<ChunkBufferPoolResource> {
+  using Spec = ChunkBufferPoolResource::Spec;
+  using Resource = ChunkBufferPoolResource::Resource;
+  static constexpr Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    return jb::Object(
+        jb::Member("max_cached_bytes",
+                   jb::Projection(&Spec::max_cached_bytes,
+                                  jb::DefaultValue([](auto* v) { *v = 0; }))),
+        jb::Member("huge_pages",
+                   jb::Projection(&Spec::huge_pages,
+                                  jb::DefaultValue(
+                                      [](auto* v) {
+                                        *v = HugePageMode::kNone;
+                                      },
+                                      HugePageModeJsonBinder))));
+  }
+  static Result<Resource> Create(const Spec& spec,
+                                 ContextResourceCreationContext context) {
+    Resource resource;
+    resource.spec = spec;
+    if (spec.max_cached_bytes != 0 || spec.huge_pages != HugePageMode::kNone) {
+      resource.pool = ChunkBufferPool::Make(spec);
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+const ContextResourceRegistration<ChunkBufferPoolResourceTraits> registration;
+
+}  // namespace
+}  // namespace internal
+}  // namespace tensorstore
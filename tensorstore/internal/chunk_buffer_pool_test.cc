@@ -0,0 +1,142 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_buffer_pool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/internal/chunk_buffer_pool_resource.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::internal::ChunkBufferPool;
+using ::tensorstore::internal::ChunkBufferPoolResource;
+using ::tensorstore::internal::HugePageMode;
+using ::tensorstore::internal::ScopedChunkBufferPool;
+
+TEST(ChunkBufferPoolTest, GetSizeClass) {
+  constexpr size_t kMin = ChunkBufferPool::kMinBufferSize;
+  EXPECT_EQ(kMin, ChunkBufferPool::GetSizeClass(1));
+  EXPECT_EQ(kMin, ChunkBufferPool::GetSizeClass(kMin));
+  EXPECT_EQ(kMin * 5 / 4, ChunkBufferPool::GetSizeClass(kMin + 1));
+  EXPECT_EQ(kMin * 2, ChunkBufferPool::GetSizeClass(kMin * 2));
+  EXPECT_EQ(kMin * 5 / 2, ChunkBufferPool::GetSizeClass(kMin * 2 + 1));
+}
+
+TEST(ChunkBufferPoolTest, ReusesFreedBuffers) {
+  auto pool = ChunkBufferPool::Make({/*max_cached_bytes=*/1 << 20});
+  constexpr size_t kSize = 100000;
+  bool zeroed;
+  void* a = pool->Allocate(kSize, zeroed);
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a) % 4096);
+  std::memset(a, 1, kSize);
+  pool->Deallocate(a, kSize);
+  EXPECT_EQ(ChunkBufferPool::GetSizeClass(kSize), pool->cached_bytes());
+
+  // A request of the same size class reuses the buffer.
+  void* b = pool->Allocate(kSize + 1, zeroed);
+  EXPECT_EQ(a, b);
+  EXPECT_FALSE(zeroed);
+  EXPECT_EQ(0u, pool->cached_bytes());
+  pool->Deallocate(b, kSize + 1);
+}
+
+TEST(ChunkBufferPoolTest, MaxCachedBytes) {
+  auto pool = ChunkBufferPool::Make({/*max_cached_bytes=*/0});
+  bool zeroed;
+  void* a = pool->Allocate(ChunkBufferPool::kMinBufferSize, zeroed);
+  ASSERT_NE(nullptr, a);
+  pool->Deallocate(a, ChunkBufferPool::kMinBufferSize);
+  EXPECT_EQ(0u, pool->cached_bytes());
+}
+
+TEST(ChunkBufferPoolTest, HugePages) {
+  for (auto mode : {HugePageMode::kTransparent, HugePageMode::kHugetlb}) {
+    auto pool = ChunkBufferPool::Make({/*max_cached_bytes=*/0, mode});
+    constexpr size_t kSize = ChunkBufferPool::kHugePageSize + 1;
+    bool zeroed;
+    char* a = static_cast<char*>(pool->Allocate(kSize, zeroed));
+    ASSERT_NE(nullptr, a);
+    a[0] = 1;
+    a[kSize - 1] = 1;
+    pool->Deallocate(a, kSize);
+  }
+}
+
+TEST(ChunkBufferPoolTest, AllocateArray) {
+  auto pool = ChunkBufferPool::Make({/*max_cached_bytes=*/1 << 20});
+  void* data;
+  {
+    ScopedChunkBufferPool scope(pool.get());
+    auto array = tensorstore::AllocateArray<int32_t>(
+        {256, 256}, tensorstore::c_order, tensorstore::value_init);
+    data = array.data();
+    EXPECT_EQ(0, array(255, 255));
+    array(255, 255) = 1;
+    // Small arrays use the general allocator.
+    auto small_array = tensorstore::AllocateArray<int32_t>({4});
+  }
+  EXPECT_EQ(256u * 256 * 4, pool->cached_bytes());
+
+  {
+    ScopedChunkBufferPool scope(pool.get());
+    auto array = tensorstore::AllocateArray<int32_t>(
+        {256, 256}, tensorstore::c_order, tensorstore::value_init);
+    EXPECT_EQ(data, array.data());
+    EXPECT_EQ(0, array(255, 255));
+  }
+
+  // Without a scope, the general allocator is used.
+  auto array = tensorstore::AllocateArray<int32_t>({256, 256});
+  EXPECT_EQ(256u * 256 * 4, pool->cached_bytes());
+}
+
+TEST(ChunkBufferPoolResourceTest, Default) {
+  auto resource =
+      Context::Default().GetResource<ChunkBufferPoolResource>().value();
+  EXPECT_EQ(nullptr, resource->pool);
+}
+
+TEST(ChunkBufferPoolResourceTest, FromJson) {
+  ::nlohmann::json json{{"max_cached_bytes", 1000},
+                        {"huge_pages", "transparent"}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<ChunkBufferPoolResource>::FromJson(json));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  ASSERT_NE(nullptr, resource->pool);
+  EXPECT_EQ(1000u, resource->pool->options().max_cached_bytes);
+  EXPECT_EQ(HugePageMode::kTransparent, resource->pool->options().huge_pages);
+  EXPECT_EQ(json, resource_spec.ToJson());
+}
+
+TEST(ChunkBufferPoolResourceTest, InvalidHugePages) {
+  EXPECT_FALSE(Context::Resource<ChunkBufferPoolResource>::FromJson(
+                   {{"huge_pages", "always"}})
+                   .ok());
+}
+
+}  // namespace
@@ -0,0 +1,238 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_layout_advisor.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/tracing/access_trace.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+/// Maximum number of coordinate descent steps, as a safeguard; each step
+/// strictly decreases the cost, so the search terminates regardless.
+constexpr size_t kMaxSearchSteps = 4096;
+
+double WeightedCost(span<const AccessRegionStatistics> statistics,
+                    span<const Index> chunk_shape,
+                    const ChunkLayoutCostModel& cost_model) {
+  double total = 0;
+  for (const auto& s : statistics) {
+    total += s.weight * absl::ToDoubleSeconds(EstimateAccessCost(
+                            s.shape, chunk_shape, s.write, cost_model));
+  }
+  return total;
+}
+
+/// Minimizes the weighted cost of `statistics` over chunk shapes that are
+/// multiples of `unit`, by coordinate descent starting from the initial value
+/// of `chunk_shape`.
+///
+/// Each step performs a line search over all power-of-two multiples and
+/// fractions of the current size in each dimension, since the cost is not
+/// unimodal in a single dimension: for example, a chunk that exactly covers a
+/// region avoids the read-modify-write that slightly smaller chunks incur.
+///
+/// \param limit Upper bound on each dimension of the chunk shape, rounded up
+///     to a multiple of `unit`.
+void MinimizeCost(span<const AccessRegionStatistics> statistics,
+                  span<const Index> unit, span<const Index> limit,
+                  const ChunkLayoutCostModel& cost_model,
+                  span<Index> chunk_shape) {
+  const DimensionIndex rank = chunk_shape.size();
+  double best = WeightedCost(statistics, chunk_shape, cost_model);
+  for (size_t step = 0; step < kMaxSearchSteps; ++step) {
+    double step_best = best;
+    DimensionIndex step_dim = -1;
+    Index step_size = 0;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      const Index size = chunk_shape[i];
+      const Index max_size = limit[i] == kInfSize
+                                 ? kInfSize
+                                 : CeilOfRatio(limit[i], unit[i]) * unit[i];
+      std::vector<Index> candidates;
+      for (Index c = size; c < max_size;) {
+        if (c <= max_size / 2) {
+          c *= 2;
+        } else if (max_size != kInfSize) {
+          c = max_size;
+        } else {
+          break;
+        }
+        candidates.push_back(c);
+      }
+      for (Index c = size / 2; c >= unit[i] && c % unit[i] == 0; c /= 2) {
+        candidates.push_back(c);
+      }
+      for (Index candidate : candidates) {
+        chunk_shape[i] = candidate;
+        double cost = WeightedCost(statistics, chunk_shape, cost_model);
+        if (cost < step_best) {
+          step_best = cost;
+          step_dim = i;
+          step_size = candidate;
+        }
+      }
+      chunk_shape[i] = size;
+    }
+    if (step_dim == -1) break;
+    chunk_shape[step_dim] = step_size;
+    best = step_best;
+  }
+}
+
+}  // namespace
+
+Result<std::vector<AccessRegionStatistics>> GetAccessRegionStatistics(
+    span<const internal_tracing::AccessTraceEvent> events) {
+  std::map<std::pair<bool, std::vector<Index>>, double> counts;
+  DimensionIndex rank = dynamic_rank;
+  for (const auto& event : events) {
+    if (!event.ok || !event.transform.valid()) continue;
+    const bool write = event.op == "write";
+    if (!write && event.op != "read") continue;
+    const DimensionIndex output_rank = event.transform.output_rank();
+    if (rank == dynamic_rank) {
+      rank = output_rank;
+    } else if (rank != output_rank) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Access trace contains events of rank ", rank, " and ",
+          output_rank));
+    }
+    Box<> range(output_rank);
+    TENSORSTORE_RETURN_IF_ERROR(GetOutputRange(event.transform, range));
+    if (!IsFinite(range)) continue;
+    std::vector<Index> shape(range.shape().begin(), range.shape().end());
+    counts[{write, std::move(shape)}] += 1;
+  }
+  std::vector<AccessRegionStatistics> statistics;
+  statistics.reserve(counts.size());
+  for (auto& [key, count] : counts) {
+    auto& s = statistics.emplace_back();
+    s.write = key.first;
+    s.shape = key.second;
+    s.weight = count;
+  }
+  return statistics;
+}
+
+absl::Duration EstimateAccessCost(span<const Index> region_shape,
+                                  span<const Index> chunk_shape, bool write,
+                                  const ChunkLayoutCostModel& cost_model) {
+  assert(region_shape.size() == chunk_shape.size());
+  // Expected number of chunks intersected by a region at a uniformly random
+  // offset, in each dimension, is `(r - 1) / c + 1`.
+  double num_chunks = 1;
+  double chunk_elements = 1;
+  double region_elements = 1;
+  for (size_t i = 0; i < region_shape.size(); ++i) {
+    const double r = std::max(Index(1), region_shape[i]);
+    const double c = std::max(Index(1), chunk_shape[i]);
+    num_chunks *= (r - 1) / c + 1;
+    chunk_elements *= c;
+    region_elements *= r;
+  }
+  const double element_size = cost_model.element_size;
+  const double transferred = num_chunks * chunk_elements * element_size;
+  double requests = num_chunks;
+  double bytes = transferred;
+  if (write) {
+    // Partially-written chunks must first be read to preserve the remainder.
+    const double remainder =
+        std::max(0.0, transferred - region_elements * element_size);
+    if (remainder > 0) {
+      requests *= 2;
+      bytes += remainder;
+    }
+  }
+  const double rounds = std::ceil(
+      requests / std::max(size_t(1), cost_model.concurrency));
+  return cost_model.request_latency * rounds +
+         absl::Seconds(bytes / cost_model.bandwidth +
+                       bytes / cost_model.decode_throughput);
+}
+
+Result<ChunkLayout> RecommendChunkLayout(
+    span<const AccessRegionStatistics> statistics, BoxView<> domain,
+    const ChunkLayoutCostModel& cost_model) {
+  const DimensionIndex rank = domain.rank();
+  if (statistics.empty()) {
+    return absl::InvalidArgumentError("No access statistics specified");
+  }
+  std::vector<AccessRegionStatistics> reads, writes;
+  for (const auto& s : statistics) {
+    if (static_cast<DimensionIndex>(s.shape.size()) != rank) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Access statistics of rank ", s.shape.size(),
+          " do not match domain of rank ", rank));
+    }
+    if (s.weight <= 0) continue;
+    (s.write ? writes : reads).push_back(s);
+  }
+
+  std::vector<Index> limit(rank), unit(rank, 1);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    limit[i] = IsFinite(domain[i]) ? std::max(Index(1), domain.shape()[i])
+                                   : kInfSize;
+  }
+
+  // Start from the default chunk shape for the domain.
+  std::vector<Index> read_shape(rank);
+  TENSORSTORE_RETURN_IF_ERROR(
+      ChooseChunkShape(ChunkLayout::GridView(), domain, read_shape));
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    read_shape[i] = std::clamp(read_shape[i], Index(1), limit[i]);
+  }
+  MinimizeCost(reads.empty() ? writes : reads, unit, limit, cost_model,
+               read_shape);
+
+  // Write chunks (shards) are multiples of the read chunk.
+  std::vector<Index> write_shape = read_shape;
+  if (!writes.empty()) {
+    MinimizeCost(writes, read_shape, limit, cost_model, write_shape);
+  }
+
+  ChunkLayout layout;
+  TENSORSTORE_RETURN_IF_ERROR(layout.Set(RankConstraint{rank}));
+  TENSORSTORE_RETURN_IF_ERROR(
+      layout.Set(ChunkLayout::ReadChunkShape(read_shape)));
+  TENSORSTORE_RETURN_IF_ERROR(
+      layout.Set(ChunkLayout::WriteChunkShape(write_shape)));
+  return layout;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,120 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CHUNK_LAYOUT_ADVISOR_H_
+#define TENSORSTORE_INTERNAL_CHUNK_LAYOUT_ADVISOR_H_
+
+/// \file
+///
+/// Recommends read and write chunk shapes from an observed access pattern.
+///
+/// The access pattern is summarized as a weighted set of region shapes, which
+/// may be derived from a recorded access trace (see
+/// `tensorstore/internal/tracing/access_trace.h`).  Candidate chunk shapes are
+/// scored with a simple cost model of the storage backend, and the resultant
+/// `ChunkLayout` may be passed directly to `Schema::Set` when creating a new
+/// array.
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "absl/time/time.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/tracing/access_trace.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Accesses of a given shape, aggregated over an access pattern.
+struct AccessRegionStatistics {
+  /// Shape of the bounding box of the accessed region.
+  std::vector<Index> shape;
+
+  /// Relative frequency of the access.  Need not be normalized.
+  double weight = 1;
+
+  /// Indicates a write rather than a read.
+  bool write = false;
+};
+
+/// Cost model of the underlying storage used to score chunk shapes.
+struct ChunkLayoutCostModel {
+  /// Fixed latency of each storage request.
+  absl::Duration request_latency = absl::Milliseconds(20);
+
+  /// Transfer bandwidth, in bytes per second.
+  double bandwidth = 100e6;
+
+  /// Decode (and encode) throughput, in bytes per second of decoded data.
+  double decode_throughput = 500e6;
+
+  /// Size in bytes of a single element.
+  size_t element_size = 1;
+
+  /// Number of requests issued concurrently.  Latency is amortized over
+  /// concurrent requests, but transfer and decode costs are not.
+  size_t concurrency = 32;
+};
+
+/// Aggregates `events` into per-shape access statistics.
+///
+/// The shape of each event is the bounding box of the output range of its
+/// transform.  Events that are not reads or writes, that failed, or whose
+/// output range is unbounded are skipped.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if the events do not all have
+///     the same output rank.
+Result<std::vector<AccessRegionStatistics>> GetAccessRegionStatistics(
+    span<const internal_tracing::AccessTraceEvent> events);
+
+/// Returns the estimated cost of performing a single access of `region_shape`
+/// against a grid with the specified `chunk_shape`.
+///
+/// For writes, regions that only partially cover a chunk additionally pay for
+/// reading the remainder of the chunk.
+///
+/// \dchecks `region_shape.size() == chunk_shape.size()`
+absl::Duration EstimateAccessCost(span<const Index> region_shape,
+                                  span<const Index> chunk_shape, bool write,
+                                  const ChunkLayoutCostModel& cost_model);
+
+/// Recommends read and write chunk shapes for `domain`.
+///
+/// The read chunk shape minimizes the weighted cost of the read accesses
+/// (or of the write accesses, if there are no reads).  The write chunk shape
+/// is a multiple of the read chunk shape that minimizes the weighted cost of
+/// the write accesses; it is equal to the read chunk shape if there are no
+/// writes.  When the two differ, the write chunk corresponds to a shard.
+///
+/// Both shapes are returned as hard constraints.
+///
+/// \param statistics Access statistics, each with rank equal to
+///     `domain.rank()`.
+/// \param domain Domain of the array.  Unbounded dimensions are permitted.
+/// \param cost_model Cost model of the storage.
+/// \error `absl::StatusCode::kInvalidArgument` if `statistics` is empty or
+///     has a rank other than `domain.rank()`.
+Result<ChunkLayout> RecommendChunkLayout(
+    span<const AccessRegionStatistics> statistics, BoxView<> domain,
+    const ChunkLayoutCostModel& cost_model = {});
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CHUNK_LAYOUT_ADVISOR_H_
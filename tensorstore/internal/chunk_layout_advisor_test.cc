@@ -0,0 +1,128 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_layout_advisor.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/tracing/access_trace.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::IdentityTransform;
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::AccessRegionStatistics;
+using ::tensorstore::internal::ChunkLayoutCostModel;
+using ::tensorstore::internal::EstimateAccessCost;
+using ::tensorstore::internal::GetAccessRegionStatistics;
+using ::tensorstore::internal::RecommendChunkLayout;
+using ::tensorstore::internal_tracing::AccessTraceEvent;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+
+AccessTraceEvent MakeEvent(const char* op, std::vector<Index> shape,
+                           bool ok = true) {
+  AccessTraceEvent event;
+  event.op = op;
+  event.transform = IdentityTransform(Box<>(shape));
+  event.ok = ok;
+  return event;
+}
+
+TEST(ChunkLayoutAdvisorTest, EstimateAccessCost) {
+  ChunkLayoutCostModel cost_model;
+  cost_model.request_latency = absl::Milliseconds(10);
+  cost_model.bandwidth = 1000;
+  cost_model.decode_throughput = 1000;
+  cost_model.concurrency = 1;
+  const Index region[] = {1};
+  const Index chunk[] = {100};
+  // One request of 100 bytes.
+  EXPECT_THAT(absl::ToDoubleSeconds(
+                  EstimateAccessCost(region, chunk, false, cost_model)),
+              DoubleNear(0.21, 1e-9));
+  // Writes additionally read the 99 bytes that are not overwritten.
+  EXPECT_THAT(absl::ToDoubleSeconds(
+                  EstimateAccessCost(region, chunk, true, cost_model)),
+              DoubleNear(0.418, 1e-9));
+}
+
+TEST(ChunkLayoutAdvisorTest, GetAccessRegionStatistics) {
+  std::vector<AccessTraceEvent> events{
+      MakeEvent("read", {2, 3}),
+      MakeEvent("write", {4, 5}),
+      MakeEvent("read", {2, 3}),
+      MakeEvent("read", {6, 7}, /*ok=*/false),
+      MakeEvent("other", {8, 9}),
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto statistics,
+                                   GetAccessRegionStatistics(events));
+  ASSERT_EQ(2, statistics.size());
+  EXPECT_THAT(statistics[0].shape, ElementsAre(2, 3));
+  EXPECT_FALSE(statistics[0].write);
+  EXPECT_EQ(2, statistics[0].weight);
+  EXPECT_THAT(statistics[1].shape, ElementsAre(4, 5));
+  EXPECT_TRUE(statistics[1].write);
+  EXPECT_EQ(1, statistics[1].weight);
+
+  events.push_back(MakeEvent("read", {1}));
+  EXPECT_THAT(GetAccessRegionStatistics(events),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Access trace contains events of rank 2 and 1"));
+}
+
+TEST(ChunkLayoutAdvisorTest, RowReads) {
+  std::vector<AccessRegionStatistics> statistics(1);
+  statistics[0].shape = {1, 1000};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto layout, RecommendChunkLayout(statistics, Box<>({1000, 1000})));
+  EXPECT_THAT(layout.read_chunk_shape(), ElementsAre(1, 1000));
+  EXPECT_THAT(layout.write_chunk_shape(), ElementsAre(1, 1000));
+}
+
+TEST(ChunkLayoutAdvisorTest, RowReadsBulkWrite) {
+  std::vector<AccessRegionStatistics> statistics(2);
+  statistics[0].shape = {1, 1000};
+  statistics[0].weight = 100;
+  statistics[1].shape = {1000, 1000};
+  statistics[1].write = true;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto layout, RecommendChunkLayout(statistics, Box<>({1000, 1000})));
+  EXPECT_THAT(layout.read_chunk_shape(), ElementsAre(1, 1000));
+  EXPECT_THAT(layout.write_chunk_shape(), ElementsAre(1000, 1000));
+}
+
+TEST(ChunkLayoutAdvisorTest, Errors) {
+  EXPECT_THAT(RecommendChunkLayout({}, Box<>({0}, {10})),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "No access statistics specified"));
+  std::vector<AccessRegionStatistics> statistics(1);
+  statistics[0].shape = {1, 2};
+  EXPECT_THAT(RecommendChunkLayout(statistics, Box<>({0}, {10})),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Access statistics of rank 2 do not match "
+                            "domain of rank 1"));
+}
+
+}  // namespace
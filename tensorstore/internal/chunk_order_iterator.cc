@@ -0,0 +1,136 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_order_iterator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+/// Advances `cell` to the next position in lexicographical order within
+/// `[begin, end)`.
+///
+/// Returns `false` if `cell` was the last position, in which case it is reset
+/// to `begin`.
+bool AdvanceCell(span<Index> cell, span<const Index> begin,
+                 span<const Index> end) {
+  for (DimensionIndex i = cell.size() - 1; i >= 0; --i) {
+    if (++cell[i] != end[i]) return true;
+    cell[i] = begin[i];
+  }
+  return false;
+}
+
+}  // namespace
+
+ChunkOrderIterator::ChunkOrderIterator(BoxView<> domain,
+                                       const ChunkLayout& chunk_layout)
+    : domain_(domain) {
+  const DimensionIndex rank = domain.rank();
+  const auto grid_origin = chunk_layout.grid_origin();
+  const auto read_chunk_shape = chunk_layout.read_chunk_shape();
+  const auto write_chunk_shape = chunk_layout.write_chunk_shape();
+  const auto get_size = [&](span<const Index> shape, DimensionIndex i) {
+    return (shape.size() == rank && shape[i] > 0) ? shape[i] : Index(0);
+  };
+  grid_origin_.resize(rank);
+  read_shape_.resize(rank);
+  write_shape_.resize(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    Index read_size = get_size(read_chunk_shape, i);
+    Index write_size = get_size(write_chunk_shape, i);
+    if (read_size == 0) read_size = write_size;
+    if (write_size == 0) write_size = read_size;
+    if (read_size == 0 || grid_origin.size() != rank ||
+        grid_origin[i] == kImplicit) {
+      // Not partitioned along this dimension.
+      grid_origin_[i] = domain[i].inclusive_min();
+    } else {
+      grid_origin_[i] = grid_origin[i];
+    }
+    if (read_size == 0) {
+      read_size = write_size = std::max(Index(1), domain[i].size());
+    }
+    read_shape_[i] = read_size;
+    write_shape_[i] = write_size;
+  }
+  at_end_ = domain.is_empty();
+  if (at_end_) return;
+  GetCellRange(domain, write_shape_, write_begin_, write_end_);
+  write_cell_ = write_begin_;
+  StartWriteCell();
+}
+
+Box<> ChunkOrderIterator::Next() {
+  assert(!at_end_);
+  Box<> box = GetCellBounds(read_cell_, read_shape_);
+  if (!AdvanceCell(read_cell_, read_begin_, read_end_)) {
+    if (AdvanceCell(write_cell_, write_begin_, write_end_)) {
+      StartWriteCell();
+    } else {
+      at_end_ = true;
+    }
+  }
+  return box;
+}
+
+void ChunkOrderIterator::GetCellRange(BoxView<> bounds,
+                                      span<const Index> cell_shape,
+                                      std::vector<Index>& begin,
+                                      std::vector<Index>& end) {
+  const DimensionIndex rank = bounds.rank();
+  begin.resize(rank);
+  end.resize(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    begin[i] = FloorOfRatio(bounds[i].inclusive_min() - grid_origin_[i],
+                            cell_shape[i]);
+    end[i] = FloorOfRatio(bounds[i].inclusive_max() - grid_origin_[i],
+                          cell_shape[i]) +
+             1;
+  }
+}
+
+Box<> ChunkOrderIterator::GetCellBounds(span<const Index> cell,
+                                        span<const Index> cell_shape) {
+  const DimensionIndex rank = domain_.rank();
+  Box<> box(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    box[i] = Intersect(
+        IndexInterval::UncheckedSized(
+            grid_origin_[i] + cell[i] * cell_shape[i], cell_shape[i]),
+        domain_[i]);
+  }
+  return box;
+}
+
+void ChunkOrderIterator::StartWriteCell() {
+  GetCellRange(GetCellBounds(write_cell_, write_shape_), read_shape_,
+               read_begin_, read_end_);
+  read_cell_ = read_begin_;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,67 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CHUNK_ORDER_ITERATOR_H_
+#define TENSORSTORE_INTERNAL_CHUNK_ORDER_ITERATOR_H_
+
+#include <vector>
+
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Enumerates the read chunks that intersect a bounded domain, in storage
+/// order: the write chunks (e.g. shards) in lexicographical order, and within
+/// each write chunk, the read chunks in lexicographical order.
+///
+/// Dimensions for which `chunk_layout` does not specify a chunk size are not
+/// partitioned.
+class ChunkOrderIterator {
+ public:
+  ChunkOrderIterator(BoxView<> domain, const ChunkLayout& chunk_layout);
+
+  bool AtEnd() const { return at_end_; }
+
+  /// Returns the bounds of the next read chunk, intersected with the domain.
+  Box<> Next();
+
+ private:
+  /// Computes the range of grid cells with shape `cell_shape` that intersect
+  /// `bounds`.
+  void GetCellRange(BoxView<> bounds, span<const Index> cell_shape,
+                    std::vector<Index>& begin, std::vector<Index>& end);
+
+  /// Returns the bounds of the grid cell `cell`, intersected with the domain.
+  Box<> GetCellBounds(span<const Index> cell, span<const Index> cell_shape);
+
+  /// Initializes the range of read chunks for the current write chunk.
+  void StartWriteCell();
+
+  Box<> domain_;
+  std::vector<Index> grid_origin_;
+  std::vector<Index> read_shape_;
+  std::vector<Index> write_shape_;
+  std::vector<Index> write_begin_, write_end_, write_cell_;
+  std::vector<Index> read_begin_, read_end_, read_cell_;
+  bool at_end_;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CHUNK_ORDER_ITERATOR_H_
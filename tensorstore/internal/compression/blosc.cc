@@ -15,12 +15,16 @@
 #include "tensorstore/internal/compression/blosc.h"
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <string_view>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include <blosc.h>
+#include "tensorstore/internal/memory.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
@@ -49,23 +53,48 @@ Result<std::string> Encode(std::string_view input, const Options& options) {
   return output;
 }
 
-Result<std::string> Decode(std::string_view input) {
+namespace {
+
+Result<size_t> GetDecodedSize(std::string_view input) {
   size_t nbytes;
   if (blosc_cbuffer_validate(input.data(), input.size(), &nbytes) != 0) {
     return absl::InvalidArgumentError("Invalid blosc-compressed data");
   }
-  std::string output(nbytes, '\0');
-  if (nbytes > 0) {
-    const int n =
-        blosc_decompress_ctx(input.data(), output.data(), output.size(),
-                             /*numinternalthreads=*/1);
-    if (n <= 0) {
-      return absl::InvalidArgumentError(
-          tensorstore::StrCat("Blosc error: ", n));
-    }
+  return nbytes;
+}
+
+absl::Status DecodeTo(std::string_view input, char* output, size_t nbytes) {
+  if (nbytes == 0) return absl::OkStatus();
+  const int n = blosc_decompress_ctx(input.data(), output, nbytes,
+                                     /*numinternalthreads=*/1);
+  if (n <= 0) {
+    return absl::InvalidArgumentError(tensorstore::StrCat("Blosc error: ", n));
   }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+Result<std::string> Decode(std::string_view input) {
+  TENSORSTORE_ASSIGN_OR_RETURN(const size_t nbytes, GetDecodedSize(input));
+  std::string output(nbytes, '\0');
+  TENSORSTORE_RETURN_IF_ERROR(DecodeTo(input, output.data(), nbytes));
   return output;
 }
 
+Result<absl::Cord> DecodeToCord(absl::Cord input) {
+  const std::string_view flat = input.Flatten();
+  TENSORSTORE_ASSIGN_OR_RETURN(const size_t nbytes, GetDecodedSize(flat));
+  if (nbytes == 0) return absl::Cord();
+  std::shared_ptr<char> output =
+      internal::make_shared_for_overwrite<char[]>(nbytes);
+  TENSORSTORE_RETURN_IF_ERROR(DecodeTo(flat, output.get(), nbytes));
+  const std::string_view data(output.get(), nbytes);
+  return absl::MakeCordFromExternal(
+      data, [output = std::move(output)](std::string_view) mutable {
+        output.reset();
+      });
+}
+
 }  // namespace blosc
 }  // namespace tensorstore
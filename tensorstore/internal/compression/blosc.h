@@ -19,6 +19,7 @@
 #include <string>
 #include <string_view>
 
+#include "absl/strings/cord.h"
 #include "tensorstore/util/result.h"
 
 /// Convenience interface to the blosc library.
@@ -71,6 +72,18 @@ Result<std::string> Encode(std::string_view input, const Options& options);
 /// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
 Result<std::string> Decode(std::string_view input);
 
+/// Decompresses `input` into a newly-allocated buffer that is returned as a
+/// single flat `absl::Cord` chunk.
+///
+/// The blosc format requires contiguous input, so `input` is flattened if it
+/// is not already flat.  The output buffer is suitably aligned for any data
+/// type, such that it may be used as the storage of a decoded array without an
+/// additional copy.
+///
+/// \param input The input data to decompress.
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
+Result<absl::Cord> DecodeToCord(absl::Cord input);
+
 }  // namespace blosc
 }  // namespace tensorstore
 
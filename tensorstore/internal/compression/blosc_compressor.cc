@@ -24,14 +24,14 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
-#include "riegeli/base/chain.h"
-#include "riegeli/bytes/chain_reader.h"
+#include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/write.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/internal/compression/blosc.h"
+#include "tensorstore/util/result.h"
 
 namespace tensorstore {
 namespace internal {
@@ -78,15 +78,16 @@ std::unique_ptr<riegeli::Writer> BloscCompressor::GetWriter(
 
 std::unique_ptr<riegeli::Reader> BloscCompressor::GetReader(
     std::unique_ptr<riegeli::Reader> base_reader, size_t element_bytes) const {
-  auto output = riegeli::ReadAll(
-      std::move(base_reader),
-      [](absl::string_view input) -> absl::StatusOr<std::string> {
-        auto output = blosc::Decode(input);
-        if (!output.ok()) return std::move(output).status();
-        return *std::move(output);
-      });
-  auto reader = std::make_unique<riegeli::ChainReader<riegeli::Chain>>(
-      output.ok() ? riegeli::Chain(std::move(*output)) : riegeli::Chain());
+  absl::Cord encoded;
+  Result<absl::Cord> output;
+  if (auto status = riegeli::ReadAll(std::move(base_reader), encoded);
+      status.ok()) {
+    output = blosc::DecodeToCord(std::move(encoded));
+  } else {
+    output = std::move(status);
+  }
+  auto reader = std::make_unique<riegeli::CordReader<absl::Cord>>(
+      output.ok() ? *std::move(output) : absl::Cord());
   if (!output.ok()) {
     reader->Fail(std::move(output).status());
   }
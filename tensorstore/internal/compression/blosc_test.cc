@@ -23,6 +23,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include <blosc.h>
 #include "tensorstore/util/status_testutil.h"
 
@@ -87,6 +88,31 @@ TEST(BloscTest, EncodeDecode) {
   }
 }
 
+// Tests decoding to a cord from encoded data split across multiple chunks.
+TEST(BloscTest, DecodeToCordFragmented) {
+  for (blosc::Options options : GetTestOptions()) {
+    for (const auto& array : GetTestArrays()) {
+      options.element_size = 2;
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                       blosc::Encode(array, options));
+      absl::Cord fragmented;
+      for (size_t i = 0; i < encoded.size(); i += 7) {
+        fragmented.Append(absl::Cord(std::string_view(encoded).substr(i, 7)));
+      }
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded,
+                                       blosc::DecodeToCord(fragmented));
+      EXPECT_EQ(array, decoded);
+      EXPECT_TRUE(decoded.TryFlat());
+    }
+  }
+}
+
+// Tests that decoding a corrupted cord returns an error.
+TEST(BloscTest, DecodeToCordCorrupted) {
+  EXPECT_THAT(blosc::DecodeToCord(absl::Cord("abc")),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 // Tests that the compressed data has the expected blosc complib.
 TEST(BloscTest, CheckComplib) {
   const std::string_view array =
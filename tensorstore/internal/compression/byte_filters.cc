@@ -0,0 +1,267 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/byte_filters.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cassert>
+#include <cstring>
+#include <string_view>
+
+#include "absl/base/internal/endian.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+// Copies the bytes that follow the last complete element (or group of
+// elements), which are not affected by the filters.
+void CopyTrailingBytes(size_t offset, std::string_view input, char* output) {
+  std::memcpy(output + offset, input.data() + offset, input.size() - offset);
+}
+
+// Each `*Op` performs a filter on the complete elements, and specifies the
+// number of bytes that it processes.  `Apply<ElementSize>` is specialized for
+// common element sizes, which allows the compiler to unroll the inner loops;
+// `ElementSize == 0` indicates a run-time element size.
+template <typename Op>
+void Dispatch(size_t element_size, std::string_view input, char* output) {
+  assert(element_size > 0);
+  const size_t n = Op::NumElements(element_size, input.size());
+  switch (element_size) {
+    case 2:
+      Op::template Apply<2>(element_size, n, input.data(), output);
+      break;
+    case 4:
+      Op::template Apply<4>(element_size, n, input.data(), output);
+      break;
+    case 8:
+      Op::template Apply<8>(element_size, n, input.data(), output);
+      break;
+    default:
+      Op::template Apply<0>(element_size, n, input.data(), output);
+      break;
+  }
+  CopyTrailingBytes(n * element_size, input, output);
+}
+
+struct ByteShuffleOp {
+  static size_t NumElements(size_t element_size, size_t size) {
+    return size / element_size;
+  }
+
+  template <size_t ElementSize>
+  static void Apply(size_t element_size, size_t n, const char* input,
+                    char* output) {
+    const size_t size = ElementSize ? ElementSize : element_size;
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < size; ++j) {
+        output[j * n + i] = input[i * size + j];
+      }
+    }
+  }
+};
+
+struct ByteUnshuffleOp : public ByteShuffleOp {
+  template <size_t ElementSize>
+  static void Apply(size_t element_size, size_t n, const char* input,
+                    char* output) {
+    const size_t size = ElementSize ? ElementSize : element_size;
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < size; ++j) {
+        output[i * size + j] = input[j * n + i];
+      }
+    }
+  }
+};
+
+// Transposes an 8x8 bit matrix, where bit `c` of byte `r` is element `(r, c)`.
+//
+// See Hacker's Delight, Section 7-3.
+uint64_t TransposeBits8x8(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0;
+  x = x ^ t ^ (t << 28);
+  return x;
+}
+
+struct BitShuffleOp {
+  // Only complete groups of 8 elements are shuffled.
+  static size_t NumElements(size_t element_size, size_t size) {
+    return size / element_size / 8 * 8;
+  }
+
+  template <size_t ElementSize>
+  static void Apply(size_t element_size, size_t n, const char* input,
+                    char* output) {
+    const size_t size = ElementSize ? ElementSize : element_size;
+    const size_t num_groups = n / 8;
+    for (size_t g = 0; g < num_groups; ++g) {
+      const auto* group =
+          reinterpret_cast<const unsigned char*>(input) + g * 8 * size;
+      for (size_t j = 0; j < size; ++j) {
+        uint64_t x = 0;
+        for (size_t r = 0; r < 8; ++r) {
+          x |= static_cast<uint64_t>(group[r * size + j]) << (8 * r);
+        }
+        x = TransposeBits8x8(x);
+        for (size_t b = 0; b < 8; ++b) {
+          output[(8 * j + b) * num_groups + g] =
+              static_cast<char>(x >> (8 * b));
+        }
+      }
+    }
+  }
+};
+
+struct BitUnshuffleOp : public BitShuffleOp {
+  template <size_t ElementSize>
+  static void Apply(size_t element_size, size_t n, const char* input,
+                    char* output) {
+    const size_t size = ElementSize ? ElementSize : element_size;
+    const size_t num_groups = n / 8;
+    for (size_t g = 0; g < num_groups; ++g) {
+      auto* group = output + g * 8 * size;
+      for (size_t j = 0; j < size; ++j) {
+        uint64_t x = 0;
+        for (size_t b = 0; b < 8; ++b) {
+          x |= static_cast<uint64_t>(static_cast<unsigned char>(
+                   input[(8 * j + b) * num_groups + g]))
+               << (8 * b);
+        }
+        x = TransposeBits8x8(x);
+        for (size_t r = 0; r < 8; ++r) {
+          group[r * size + j] = static_cast<char>(x >> (8 * r));
+        }
+      }
+    }
+  }
+};
+
+template <typename T>
+T LoadLittleEndian(const char* p) {
+  if constexpr (sizeof(T) == 1) {
+    return static_cast<T>(*p);
+  } else if constexpr (sizeof(T) == 2) {
+    return absl::little_endian::Load16(p);
+  } else if constexpr (sizeof(T) == 4) {
+    return absl::little_endian::Load32(p);
+  } else {
+    return absl::little_endian::Load64(p);
+  }
+}
+
+template <typename T>
+void StoreLittleEndian(T value, char* p) {
+  if constexpr (sizeof(T) == 1) {
+    *p = static_cast<char>(value);
+  } else if constexpr (sizeof(T) == 2) {
+    absl::little_endian::Store16(p, value);
+  } else if constexpr (sizeof(T) == 4) {
+    absl::little_endian::Store32(p, value);
+  } else {
+    absl::little_endian::Store64(p, value);
+  }
+}
+
+struct DeltaEncodeOp {
+  static size_t NumElements(size_t element_size, size_t size) {
+    return size / element_size;
+  }
+
+  template <typename T>
+  static void Apply(size_t n, const char* input, char* output) {
+    T previous = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const T value = LoadLittleEndian<T>(input + i * sizeof(T));
+      StoreLittleEndian<T>(static_cast<T>(value - previous),
+                           output + i * sizeof(T));
+      previous = value;
+    }
+  }
+};
+
+struct DeltaDecodeOp : public DeltaEncodeOp {
+  template <typename T>
+  static void Apply(size_t n, const char* input, char* output) {
+    T value = 0;
+    for (size_t i = 0; i < n; ++i) {
+      value =
+          static_cast<T>(value + LoadLittleEndian<T>(input + i * sizeof(T)));
+      StoreLittleEndian<T>(value, output + i * sizeof(T));
+    }
+  }
+};
+
+// Like `Dispatch`, but `Op::Apply` is specialized on the unsigned integer type
+// corresponding to the element size.
+template <typename Op>
+void DispatchInteger(size_t element_size, std::string_view input,
+                     char* output) {
+  const size_t n = Op::NumElements(element_size, input.size());
+  switch (element_size) {
+    case 1:
+      Op::template Apply<uint8_t>(n, input.data(), output);
+      break;
+    case 2:
+      Op::template Apply<uint16_t>(n, input.data(), output);
+      break;
+    case 4:
+      Op::template Apply<uint32_t>(n, input.data(), output);
+      break;
+    case 8:
+      Op::template Apply<uint64_t>(n, input.data(), output);
+      break;
+    default:
+      assert(false);
+      return;
+  }
+  CopyTrailingBytes(n * element_size, input, output);
+}
+
+}  // namespace
+
+void ByteShuffle(size_t element_size, std::string_view input, char* output) {
+  Dispatch<ByteShuffleOp>(element_size, input, output);
+}
+
+void ByteUnshuffle(size_t element_size, std::string_view input, char* output) {
+  Dispatch<ByteUnshuffleOp>(element_size, input, output);
+}
+
+void BitShuffle(size_t element_size, std::string_view input, char* output) {
+  Dispatch<BitShuffleOp>(element_size, input, output);
+}
+
+void BitUnshuffle(size_t element_size, std::string_view input, char* output) {
+  Dispatch<BitUnshuffleOp>(element_size, input, output);
+}
+
+void DeltaEncode(size_t element_size, std::string_view input, char* output) {
+  DispatchInteger<DeltaEncodeOp>(element_size, input, output);
+}
+
+void DeltaDecode(size_t element_size, std::string_view input, char* output) {
+  DispatchInteger<DeltaDecodeOp>(element_size, input, output);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
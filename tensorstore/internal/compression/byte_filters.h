@@ -0,0 +1,71 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_BYTE_FILTERS_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_BYTE_FILTERS_H_
+
+/// \file
+/// Reversible filters that rearrange a sequence of fixed-size elements to
+/// improve its compressibility.
+///
+/// Each filter treats the input as a sequence of `element_size`-byte elements,
+/// followed by `input.size() % element_size` trailing bytes that are copied
+/// unchanged.  The output has the same size as the input, and must not overlap
+/// with it.
+
+#include <stddef.h>
+
+#include <string_view>
+
+namespace tensorstore {
+namespace internal {
+
+/// Groups the bytes of each element by their position within the element.
+///
+/// With `n` complete elements, byte `j` of element `i` is written to
+/// `output[j * n + i]`.  This matches the `numcodecs.Shuffle` codec.
+void ByteShuffle(size_t element_size, std::string_view input, char* output);
+
+/// Inverse of `ByteShuffle`.
+void ByteUnshuffle(size_t element_size, std::string_view input, char* output);
+
+/// Groups the bits of each element by their position within the element.
+///
+/// The elements are processed in groups of 8; any remaining elements are
+/// copied unchanged after the shuffled elements.  With `n` elements in complete
+/// groups, the output starts with `8 * element_size` bit planes of `n / 8`
+/// bytes each.  Bit `b` of byte `j` of element `i` is stored in bit `i % 8` of
+/// byte `i / 8` of plane `8 * j + b`.
+void BitShuffle(size_t element_size, std::string_view input, char* output);
+
+/// Inverse of `BitShuffle`.
+void BitUnshuffle(size_t element_size, std::string_view input, char* output);
+
+/// Replaces each element by its difference from the previous element.
+///
+/// The elements are interpreted as little-endian unsigned integers, and the
+/// differences are computed modulo `2**(8 * element_size)`, which makes the
+/// encoding lossless for any data type.
+///
+/// \dchecks `element_size` is 1, 2, 4, or 8.
+void DeltaEncode(size_t element_size, std::string_view input, char* output);
+
+/// Inverse of `DeltaEncode`.
+void DeltaDecode(size_t element_size, std::string_view input, char* output);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_BYTE_FILTERS_H_
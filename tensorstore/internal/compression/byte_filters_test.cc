@@ -0,0 +1,123 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/byte_filters.h"
+
+#include <stddef.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using ::tensorstore::internal::BitShuffle;
+using ::tensorstore::internal::BitUnshuffle;
+using ::tensorstore::internal::ByteShuffle;
+using ::tensorstore::internal::ByteUnshuffle;
+using ::tensorstore::internal::DeltaDecode;
+using ::tensorstore::internal::DeltaEncode;
+
+using Filter = void (*)(size_t, std::string_view, char*);
+
+std::string Apply(Filter filter, size_t element_size, std::string_view input) {
+  std::string output(input.size(), '\0');
+  filter(element_size, input, output.data());
+  return output;
+}
+
+std::string RandomBytes(size_t size) {
+  std::minstd_rand gen(size);
+  std::string s(size, '\0');
+  for (auto& c : s) c = static_cast<char>(gen());
+  return s;
+}
+
+// Straightforward bit-by-bit implementation of `BitShuffle`.
+std::string ReferenceBitShuffle(size_t element_size, std::string_view input) {
+  const size_t n = input.size() / element_size / 8 * 8;
+  std::string output(input);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t k = 0; k < 8 * element_size; ++k) {
+      const bool bit = (input[i * element_size + k / 8] >> (k % 8)) & 1;
+      const size_t out_bit = k * n + i;
+      if (out_bit % 8 == 0) output[out_bit / 8] = 0;
+      output[out_bit / 8] |= static_cast<char>(bit << (out_bit % 8));
+    }
+  }
+  return output;
+}
+
+TEST(ByteShuffleTest, Basic) {
+  EXPECT_EQ("acebdf", Apply(ByteShuffle, 2, "abcdef"));
+  EXPECT_EQ("abcdef", Apply(ByteUnshuffle, 2, "acebdf"));
+  // Trailing bytes are copied unchanged.
+  EXPECT_EQ("adbecfg", Apply(ByteShuffle, 3, "abcdefg"));
+  EXPECT_EQ("abcdefg", Apply(ByteUnshuffle, 3, "adbecfg"));
+  EXPECT_EQ("abc", Apply(ByteShuffle, 1, "abc"));
+}
+
+TEST(BitShuffleTest, Basic) {
+  // Bit 0 of each of 8 single-byte elements forms the first byte.
+  EXPECT_EQ(std::string("\x81\0\0\0\0\0\0\x01", 8),
+            Apply(BitShuffle, 1, std::string("\x81\0\0\0\0\0\0\x01", 8)));
+  EXPECT_EQ(std::string("\x01\0\0\0\0\0\0\x01", 8),
+            Apply(BitShuffle, 1, std::string("\x81\0\0\0\0\0\0\0", 8)));
+}
+
+TEST(BitShuffleTest, MatchesReference) {
+  for (size_t element_size : {1, 2, 3, 4, 8, 16}) {
+    for (size_t size : {0, 7, 64, 100, 1000}) {
+      SCOPED_TRACE(element_size);
+      SCOPED_TRACE(size);
+      const std::string input = RandomBytes(size);
+      EXPECT_EQ(ReferenceBitShuffle(element_size, input),
+                Apply(BitShuffle, element_size, input));
+    }
+  }
+}
+
+TEST(FilterTest, RoundTrip) {
+  for (size_t element_size : {1, 2, 3, 4, 8, 16}) {
+    for (size_t size : {0, 1, 7, 64, 100, 1000}) {
+      SCOPED_TRACE(element_size);
+      SCOPED_TRACE(size);
+      const std::string input = RandomBytes(size);
+      EXPECT_EQ(input,
+                Apply(ByteUnshuffle, element_size,
+                      Apply(ByteShuffle, element_size, input)));
+      EXPECT_EQ(input, Apply(BitUnshuffle, element_size,
+                             Apply(BitShuffle, element_size, input)));
+      if (element_size <= 8 && (element_size & (element_size - 1)) == 0) {
+        EXPECT_EQ(input, Apply(DeltaDecode, element_size,
+                               Apply(DeltaEncode, element_size, input)));
+      }
+    }
+  }
+}
+
+TEST(DeltaTest, Basic) {
+  EXPECT_EQ(std::string("\x01\x01\x01\xfe", 4),
+            Apply(DeltaEncode, 1, std::string("\x01\x02\x03\x01", 4)));
+  // Little endian 16-bit values 0x0100, 0x0003, followed by a trailing byte.
+  EXPECT_EQ(std::string("\x00\x01\x03\xff\x07", 5),
+            Apply(DeltaEncode, 2, std::string("\x00\x01\x03\x00\x07", 5)));
+  EXPECT_EQ(std::string("\x00\x01\x03\x00\x07", 5),
+            Apply(DeltaDecode, 2, std::string("\x00\x01\x03\xff\x07", 5)));
+}
+
+}  // namespace
@@ -0,0 +1,120 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stddef.h>
+
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/compression/zlib.h"
+#include <zstd.h>
+
+// Include zlib header last because it defines a bunch of poorly-named macros.
+#include <zlib.h>
+
+namespace {
+
+namespace zlib = ::tensorstore::zlib;
+
+// Returns moderately compressible input of `size` bytes.
+absl::Cord MakeInput(size_t size) {
+  std::minstd_rand gen(42);
+  std::string input(size, '\0');
+  for (auto& c : input) c = static_cast<char>('a' + gen() % 8);
+  return absl::Cord(std::move(input));
+}
+
+// Cost of encoding a small chunk, which reuses pooled streams.
+void BM_ZlibEncode(benchmark::State& state) {
+  const absl::Cord input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    absl::Cord output;
+    zlib::Encode(input, &output, zlib::Options{});
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+void BM_ZlibDecode(benchmark::State& state) {
+  absl::Cord encoded;
+  zlib::Encode(MakeInput(state.range(0)), &encoded, zlib::Options{});
+  for (auto _ : state) {
+    absl::Cord output;
+    ABSL_CHECK(zlib::Decode(encoded, &output, false).ok());
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Per-chunk overhead of initializing a new deflate stream, which is avoided by
+// reusing pooled streams.
+void BM_DeflateInit(benchmark::State& state) {
+  for (auto _ : state) {
+    z_stream s = {};
+    ABSL_CHECK_EQ(deflateInit(&s, Z_DEFAULT_COMPRESSION), Z_OK);
+    deflateEnd(&s);
+  }
+}
+
+// Per-chunk overhead of resetting a pooled deflate stream.
+void BM_DeflateReset(benchmark::State& state) {
+  z_stream s = {};
+  ABSL_CHECK_EQ(deflateInit(&s, Z_DEFAULT_COMPRESSION), Z_OK);
+  for (auto _ : state) {
+    ABSL_CHECK_EQ(deflateReset(&s), Z_OK);
+  }
+  deflateEnd(&s);
+}
+
+// Compresses a chunk with a newly-created zstd context.
+void BM_ZstdCompressNewContext(benchmark::State& state) {
+  const std::string input(MakeInput(state.range(0)));
+  std::string output(ZSTD_compressBound(input.size()), '\0');
+  for (auto _ : state) {
+    ZSTD_CCtx* ctx = ZSTD_createCCtx();
+    const size_t result = ZSTD_compressCCtx(ctx, output.data(), output.size(),
+                                            input.data(), input.size(), 3);
+    ABSL_CHECK(!ZSTD_isError(result));
+    ZSTD_freeCCtx(ctx);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+// Compresses a chunk with a reused zstd context, as done by the pooled
+// contexts of the zarr3 `zstd` codec.
+void BM_ZstdCompressReusedContext(benchmark::State& state) {
+  const std::string input(MakeInput(state.range(0)));
+  std::string output(ZSTD_compressBound(input.size()), '\0');
+  ZSTD_CCtx* ctx = ZSTD_createCCtx();
+  for (auto _ : state) {
+    ZSTD_CCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+    const size_t result = ZSTD_compressCCtx(ctx, output.data(), output.size(),
+                                            input.data(), input.size(), 3);
+    ABSL_CHECK(!ZSTD_isError(result));
+  }
+  ZSTD_freeCCtx(ctx);
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(BM_ZlibEncode)->Range(4 << 10, 1 << 20);
+BENCHMARK(BM_ZlibDecode)->Range(4 << 10, 1 << 20);
+BENCHMARK(BM_DeflateInit);
+BENCHMARK(BM_DeflateReset);
+BENCHMARK(BM_ZstdCompressNewContext)->Range(4 << 10, 1 << 20);
+BENCHMARK(BM_ZstdCompressReusedContext)->Range(4 << 10, 1 << 20);
+
+}  // namespace
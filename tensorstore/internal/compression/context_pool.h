@@ -0,0 +1,146 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_CONTEXT_POOL_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_CONTEXT_POOL_H_
+
+/// \file
+/// Pool of reusable compression library contexts.
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Bounded pool of idle compression library contexts, such as `ZSTD_CCtx` or
+/// `z_stream`, which are costly to create relative to the work done on small
+/// inputs.
+///
+/// Each context is associated with a `Key` that identifies the parameters that
+/// determine its memory footprint, such as the compression level, and is only
+/// reused for an equal key.
+///
+/// This class is thread-safe.
+///
+/// \tparam T The context type.
+/// \tparam Deleter Deleter that destroys a `T*`.
+/// \tparam Key Equality-comparable key type.
+template <typename T, typename Deleter, typename Key>
+class CompressionContextPool {
+ public:
+  using Ptr = std::unique_ptr<T, Deleter>;
+
+  /// Deleter of a `Lease` that returns the context to the pool.
+  class ReturnToPool {
+   public:
+    ReturnToPool() = default;
+    ReturnToPool(CompressionContextPool* pool, Key key)
+        : pool_(pool), key_(std::move(key)) {}
+
+    void operator()(T* context) const {
+      pool_->Put(key_, Ptr(context));
+    }
+
+   private:
+    CompressionContextPool* pool_ = nullptr;
+    Key key_;
+  };
+
+  /// Context that is returned to the pool when destroyed.
+  using Lease = std::unique_ptr<T, ReturnToPool>;
+
+  /// Returns the default value of `max_size`, equal to the number of hardware
+  /// threads.
+  static size_t DefaultMaxSize() {
+    return std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+  }
+
+  /// Constructs a pool that retains at most `max_size` idle contexts.
+  explicit CompressionContextPool(size_t max_size = DefaultMaxSize())
+      : max_size_(max_size) {}
+
+  /// Returns an idle context with the specified `key`, after calling
+  /// `reset(context)` on it, or a new context obtained from `create()` if
+  /// there is no such idle context.
+  ///
+  /// \param key Parameters of the context.
+  /// \param create Function with signature `Ptr ()`.
+  /// \param reset Function with signature `void (T*)` that restores a
+  ///     previously-used context to its initial state.
+  template <typename Create, typename Reset>
+  Lease Acquire(const Key& key, Create create, Reset reset) {
+    Ptr context = Get(key);
+    if (context) {
+      reset(context.get());
+    } else {
+      context = create();
+    }
+    return Lease(context.release(), ReturnToPool(this, key));
+  }
+
+  /// Returns an idle context with the specified `key`, or `nullptr` if there
+  /// is none.
+  Ptr Get(const Key& key) {
+    absl::MutexLock lock(&mutex_);
+    // Search from the most recently returned context.
+    for (auto it = contexts_.rbegin(); it != contexts_.rend(); ++it) {
+      if (it->first == key) {
+        Ptr context = std::move(it->second);
+        contexts_.erase(std::next(it).base());
+        return context;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Adds `context` to the pool.  If the pool is full, the least recently
+  /// added context is destroyed.
+  void Put(const Key& key, Ptr context) {
+    if (!context || max_size_ == 0) return;
+    Ptr evicted;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (contexts_.size() == max_size_) {
+        evicted = std::move(contexts_.front().second);
+        contexts_.pop_front();
+      }
+      contexts_.emplace_back(key, std::move(context));
+    }
+  }
+
+  /// Returns the number of idle contexts.
+  size_t size() {
+    absl::MutexLock lock(&mutex_);
+    return contexts_.size();
+  }
+
+ private:
+  const size_t max_size_;
+  absl::Mutex mutex_;
+  std::deque<std::pair<Key, Ptr>> contexts_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_CONTEXT_POOL_H_
@@ -0,0 +1,111 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/compression/context_pool.h"
+
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+using ::tensorstore::internal::CompressionContextPool;
+
+struct Context {
+  explicit Context(int id) : id(id) {}
+  int id;
+  bool reset = false;
+};
+
+struct ContextDeleter {
+  void operator()(Context* context) const {
+    ++num_deleted;
+    delete context;
+  }
+  static inline int num_deleted = 0;
+};
+
+using Pool = CompressionContextPool<Context, ContextDeleter, std::string>;
+
+Pool::Lease Acquire(Pool& pool, const std::string& key, int id) {
+  return pool.Acquire(
+      key, [&] { return Pool::Ptr(new Context(id)); },
+      [](Context* context) { context->reset = true; });
+}
+
+TEST(CompressionContextPoolTest, ReusesContextWithSameKey) {
+  Pool pool(4);
+  {
+    auto context = Acquire(pool, "a", 1);
+    EXPECT_EQ(1, context->id);
+    EXPECT_FALSE(context->reset);
+    EXPECT_EQ(0, pool.size());
+  }
+  EXPECT_EQ(1, pool.size());
+  {
+    auto context = Acquire(pool, "a", 2);
+    EXPECT_EQ(1, context->id);
+    EXPECT_TRUE(context->reset);
+    EXPECT_EQ(0, pool.size());
+  }
+  {
+    auto context = Acquire(pool, "b", 3);
+    EXPECT_EQ(3, context->id);
+    EXPECT_FALSE(context->reset);
+    EXPECT_EQ(1, pool.size());
+  }
+  EXPECT_EQ(2, pool.size());
+}
+
+TEST(CompressionContextPoolTest, ConcurrentLeases) {
+  Pool pool(4);
+  {
+    auto a = Acquire(pool, "a", 1);
+    auto b = Acquire(pool, "a", 2);
+    EXPECT_EQ(1, a->id);
+    EXPECT_EQ(2, b->id);
+  }
+  EXPECT_EQ(2, pool.size());
+  auto c = Acquire(pool, "a", 3);
+  // The most recently returned context is reused first.
+  EXPECT_EQ(1, c->id);
+}
+
+TEST(CompressionContextPoolTest, EvictsLeastRecentlyReturned) {
+  Pool pool(2);
+  ContextDeleter::num_deleted = 0;
+  {
+    auto a = Acquire(pool, "a", 1);
+    auto b = Acquire(pool, "b", 2);
+    auto c = Acquire(pool, "c", 3);
+  }
+  // `c` is returned first, and then evicted by `a`.
+  EXPECT_EQ(1, ContextDeleter::num_deleted);
+  EXPECT_EQ(2, pool.size());
+  EXPECT_EQ(1, Acquire(pool, "a", 4)->id);
+  EXPECT_EQ(2, Acquire(pool, "b", 5)->id);
+  EXPECT_EQ(6, Acquire(pool, "c", 6)->id);
+}
+
+TEST(CompressionContextPoolTest, ZeroSize) {
+  Pool pool(0);
+  ContextDeleter::num_deleted = 0;
+  Acquire(pool, "a", 1);
+  EXPECT_EQ(1, ContextDeleter::num_deleted);
+  EXPECT_EQ(0, pool.size());
+}
+
+}  // namespace
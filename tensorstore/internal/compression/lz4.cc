@@ -0,0 +1,160 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/lz4.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
+#include <lz4.h>
+#include <lz4frame.h>
+#include <lz4hc.h>
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace lz4 {
+namespace {
+
+static_assert(Options::kMaxCompressionLevel == LZ4HC_CLEVEL_MAX);
+static_assert(-Options::kMinCompressionLevel + 1 == LZ4_ACCELERATION_MAX);
+
+struct DecompressionContextDeleter {
+  void operator()(LZ4F_dctx* dctx) const {
+    LZ4F_freeDecompressionContext(dctx);
+  }
+};
+
+absl::Status FrameError(size_t code) {
+  return absl::InvalidArgumentError(
+      tensorstore::StrCat("Error decoding LZ4 frame: ", LZ4F_getErrorName(code)));
+}
+
+}  // namespace
+
+Result<std::string> Encode(std::string_view input, const Options& options) {
+  LZ4F_preferences_t preferences = {};
+  preferences.frameInfo.contentSize = input.size();
+  preferences.compressionLevel = options.level;
+  std::string output(LZ4F_compressFrameBound(input.size(), &preferences), '\0');
+  const size_t n = LZ4F_compressFrame(output.data(), output.size(),
+                                      input.data(), input.size(), &preferences);
+  if (LZ4F_isError(n)) {
+    return absl::InternalError(
+        tensorstore::StrCat("Internal lz4 error: ", LZ4F_getErrorName(n)));
+  }
+  output.erase(n);
+  return output;
+}
+
+Result<std::string> Decode(std::string_view input) {
+  if (input.empty()) {
+    return absl::InvalidArgumentError("Empty LZ4 input");
+  }
+  LZ4F_dctx* dctx_ptr;
+  if (auto code = LZ4F_createDecompressionContext(&dctx_ptr, LZ4F_VERSION);
+      LZ4F_isError(code)) {
+    return absl::InternalError(
+        tensorstore::StrCat("Internal lz4 error: ", LZ4F_getErrorName(code)));
+  }
+  std::unique_ptr<LZ4F_dctx, DecompressionContextDeleter> dctx(dctx_ptr);
+  std::string output;
+  size_t output_size = 0;
+  const char* src = input.data();
+  size_t src_remaining = input.size();
+  while (src_remaining != 0) {
+    // Each frame normally records its content size, which permits the output
+    // to be allocated once.  The size is untrusted, though, and the
+    // allocation is bounded by the maximum LZ4 compression ratio.
+    LZ4F_frameInfo_t frame_info;
+    size_t consumed = src_remaining;
+    size_t hint = LZ4F_getFrameInfo(dctx.get(), &frame_info, src, &consumed);
+    if (LZ4F_isError(hint)) return FrameError(hint);
+    src += consumed;
+    src_remaining -= consumed;
+    const size_t max_content_size = src_remaining * 256 + 64;
+    output.resize(
+        output_size +
+        (frame_info.contentSize != 0 && frame_info.contentSize <= max_content_size
+             ? static_cast<size_t>(frame_info.contentSize)
+             : std::min(max_content_size, size_t{1} << 20)));
+    while (hint != 0) {
+      if (output_size == output.size()) {
+        output.resize(std::max(output.size() * 2, size_t{4096}));
+      }
+      size_t dst_size = output.size() - output_size;
+      size_t src_size = src_remaining;
+      hint = LZ4F_decompress(dctx.get(), output.data() + output_size, &dst_size,
+                             src, &src_size, /*dOptPtr=*/nullptr);
+      if (LZ4F_isError(hint)) return FrameError(hint);
+      if (hint != 0 && src_size == 0 && dst_size == 0) {
+        return absl::InvalidArgumentError("Truncated LZ4 frame");
+      }
+      src += src_size;
+      src_remaining -= src_size;
+      output_size += dst_size;
+    }
+  }
+  output.resize(output_size);
+  return output;
+}
+
+Result<std::string> EncodeBlock(std::string_view input, int acceleration) {
+  if (input.size() > LZ4_MAX_INPUT_SIZE) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "LZ4 compression input of ", input.size(),
+        " bytes exceeds maximum size of ", LZ4_MAX_INPUT_SIZE));
+  }
+  const int input_size = static_cast<int>(input.size());
+  const int bound = LZ4_compressBound(input_size);
+  std::string output(4 + bound, '\0');
+  absl::little_endian::Store32(output.data(), input_size);
+  const int n = LZ4_compress_fast(input.data(), output.data() + 4, input_size,
+                                  bound, acceleration);
+  if (n <= 0 && input_size != 0) {
+    return absl::InternalError(tensorstore::StrCat("Internal lz4 error: ", n));
+  }
+  output.erase(4 + n);
+  return output;
+}
+
+Result<std::string> DecodeBlock(std::string_view input) {
+  if (input.size() < 4) {
+    return absl::InvalidArgumentError("Invalid LZ4-compressed data");
+  }
+  const uint32_t size = absl::little_endian::Load32(input.data());
+  if (size > LZ4_MAX_INPUT_SIZE) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Invalid LZ4 uncompressed size: ", size));
+  }
+  std::string output(size, '\0');
+  const int n = LZ4_decompress_safe(input.data() + 4, output.data(),
+                                    static_cast<int>(input.size() - 4),
+                                    static_cast<int>(size));
+  if (n < 0 || static_cast<uint32_t>(n) != size) {
+    return absl::InvalidArgumentError("Invalid LZ4-compressed data");
+  }
+  return output;
+}
+
+}  // namespace lz4
+}  // namespace tensorstore
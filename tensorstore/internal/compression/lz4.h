@@ -0,0 +1,81 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_LZ4_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_LZ4_H_
+
+/// \file
+/// Convenience interface to the lz4 library.
+
+#include <string>
+#include <string_view>
+
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace lz4 {
+
+/// Specifies the LZ4 frame encode options.
+struct Options {
+  /// Minimum compression level.  Negative levels trade compression ratio for
+  /// speed.
+  static constexpr int kMinCompressionLevel = -65536;
+
+  /// Maximum compression level.  Levels of at least `3` use the slower high
+  /// compression (LZ4HC) mode, which does not affect decompression speed.
+  static constexpr int kMaxCompressionLevel = 12;
+
+  /// Specifies the compression level, must be in the range
+  /// `[kMinCompressionLevel, kMaxCompressionLevel]`.  Levels `0` to `2` are
+  /// equivalent and select the default fast mode.
+  int level = 0;
+};
+
+/// Compresses `input` as a single LZ4 frame that records the content size.
+///
+/// The result is compatible with the `lz4` command-line tool.
+///
+/// \param input The input data to compress.
+/// \param options Specifies compression options.
+Result<std::string> Encode(std::string_view input, const Options& options);
+
+/// Decompresses `input`, which must consist of one or more concatenated LZ4
+/// frames.
+///
+/// \param input The input data to decompress.
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
+Result<std::string> Decode(std::string_view input);
+
+/// Compresses `input` in the format of the `numcodecs.LZ4` codec: the
+/// uncompressed size as a 32-bit little-endian integer, followed by a single
+/// LZ4 block.
+///
+/// \param input The input data to compress.
+/// \param acceleration Acceleration factor, must be positive.  Higher values
+///     trade compression ratio for speed.
+/// \error `absl::StatusCode::kInvalidArgument` if `input.size()` exceeds
+///     `LZ4_MAX_INPUT_SIZE`.
+Result<std::string> EncodeBlock(std::string_view input, int acceleration);
+
+/// Decompresses `input` encoded by `EncodeBlock`.
+///
+/// \param input The input data to decompress.
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
+Result<std::string> DecodeBlock(std::string_view input);
+
+}  // namespace lz4
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_LZ4_H_
@@ -0,0 +1,145 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/lz4.h"
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+
+namespace lz4 = tensorstore::lz4;
+
+std::vector<std::string> GetTestArrays() {
+  std::vector<std::string> arrays;
+
+  // Add empty array.
+  arrays.emplace_back();
+
+  {
+    std::string arr(100, '\0');
+    unsigned char v = 0;
+    for (auto& x : arr) {
+      x = (v += 7);
+    }
+    arrays.push_back(std::move(arr));
+  }
+
+  {
+    // Exceeds the default 64KiB LZ4 frame block size.
+    std::string arr(300000, '\0');
+    unsigned int v = 1;
+    for (auto& x : arr) {
+      v = v * 1103515245 + 12345;
+      x = static_cast<char>((v >> 16) % 16);
+    }
+    arrays.push_back(std::move(arr));
+  }
+
+  arrays.push_back("The quick brown fox jumped over the lazy dog.");
+  return arrays;
+}
+
+TEST(Lz4Test, EncodeDecode) {
+  for (const int level : {lz4::Options::kMinCompressionLevel, -1, 0, 3, 9,
+                          lz4::Options::kMaxCompressionLevel}) {
+    for (const auto& array : GetTestArrays()) {
+      SCOPED_TRACE(tensorstore::StrCat("level=", level,
+                                       ", size=", array.size()));
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                       lz4::Encode(array, {level}));
+      EXPECT_THAT(lz4::Decode(encoded), ::testing::Optional(array));
+    }
+  }
+}
+
+TEST(Lz4Test, Compresses) {
+  const std::string input(100000, 'x');
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, lz4::Encode(input, {}));
+  EXPECT_LT(encoded.size(), 1000);
+}
+
+TEST(Lz4Test, DecodeConcatenatedFrames) {
+  auto arrays = GetTestArrays();
+  std::string encoded;
+  std::string expected;
+  for (const auto& array : arrays) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto part, lz4::Encode(array, {}));
+    encoded += part;
+    expected += array;
+  }
+  EXPECT_THAT(lz4::Decode(encoded), ::testing::Optional(expected));
+}
+
+TEST(Lz4Test, DecodeCorrupt) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, lz4::Encode(GetTestArrays()[2], {}));
+  EXPECT_THAT(lz4::Decode(""),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(lz4::Decode("abcdefghijklmnop"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(lz4::Decode(std::string_view(encoded).substr(0, 100)),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  std::string corrupt = encoded;
+  corrupt[5] ^= 0xff;
+  EXPECT_THAT(lz4::Decode(corrupt),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(Lz4Test, EncodeDecodeBlock) {
+  for (const int acceleration : {1, 10}) {
+    for (const auto& array : GetTestArrays()) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                       lz4::EncodeBlock(array, acceleration));
+      EXPECT_THAT(lz4::DecodeBlock(encoded), ::testing::Optional(array));
+    }
+  }
+}
+
+TEST(Lz4Test, BlockFormat) {
+  // The uncompressed size is stored as a 32-bit little-endian prefix, as by
+  // `numcodecs.LZ4`.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   lz4::EncodeBlock("abcabcabcabcabc", 1));
+  EXPECT_EQ(std::string("\x0f\x00\x00\x00", 4), encoded.substr(0, 4));
+
+  // Block consisting of a single sequence of 3 literals.
+  EXPECT_THAT(
+      lz4::DecodeBlock(std::string("\x03\x00\x00\x00\x30"
+                                   "abc",
+                                   8)),
+      ::testing::Optional(std::string("abc")));
+}
+
+TEST(Lz4Test, DecodeBlockCorrupt) {
+  EXPECT_THAT(lz4::DecodeBlock("abc"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(lz4::DecodeBlock(std::string("\x05\x00\x00\x00", 4)),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(lz4::DecodeBlock(std::string("\xff\xff\xff\xff\x00", 5)),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
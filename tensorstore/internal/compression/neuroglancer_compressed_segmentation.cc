@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "absl/base/internal/endian.h"
+#include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 
 namespace tensorstore {
@@ -40,6 +41,42 @@ void WriteBlockHeader(size_t encoded_value_base_offset,
                                encoded_value_base_offset);
 }
 
+// Packs `indices`, which must be padded with zeros to a multiple of
+// `32 / Bits` elements, into `Bits`-bit fields of little-endian 32-bit words.
+//
+// Specializing on `Bits` allows the compiler to unroll and vectorize the inner
+// loop.
+template <size_t Bits>
+void PackIndices(const uint32_t* indices, size_t num_words, char* output) {
+  constexpr size_t kIndicesPerWord = 32 / Bits;
+  for (size_t word_i = 0; word_i < num_words; ++word_i) {
+    uint32_t word = 0;
+    for (size_t i = 0; i < kIndicesPerWord; ++i) {
+      word |= indices[word_i * kIndicesPerWord + i] << (i * Bits);
+    }
+    absl::little_endian::Store32(output + word_i * 4, word);
+  }
+}
+
+void PackIndices(size_t encoded_bits, const uint32_t* indices,
+                 size_t num_words, char* output) {
+  switch (encoded_bits) {
+    case 1:
+      return PackIndices<1>(indices, num_words, output);
+    case 2:
+      return PackIndices<2>(indices, num_words, output);
+    case 4:
+      return PackIndices<4>(indices, num_words, output);
+    case 8:
+      return PackIndices<8>(indices, num_words, output);
+    case 16:
+      return PackIndices<16>(indices, num_words, output);
+    case 32:
+      return PackIndices<32>(indices, num_words, output);
+  }
+  ABSL_UNREACHABLE();  // COV_NF_LINE
+}
+
 template <typename Label>
 void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
                  const ptrdiff_t input_byte_strides[3],
@@ -59,57 +96,81 @@ void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
   absl::flat_hash_map<Label, uint32_t> seen_values;
   std::vector<Label> seen_values_inv;
 
-  // Calls `func(z, y, x, label)` for each `label` value within the block, in C
-  // order.
-  const auto ForEachElement = [&](auto func) {
+  const size_t num_block_elements =
+      block_shape[0] * block_shape[1] * block_shape[2];
+  const bool full_block = input_shape[0] == block_shape[0] &&
+                          input_shape[1] == block_shape[1] &&
+                          input_shape[2] == block_shape[2];
+
+  // Index into `seen_values_inv` of each element, in C order with respect to
+  // the block shape, padded to a multiple of 32 elements for `PackIndices`.
+  // Positions outside `input_shape` are left as 0.
+  std::vector<uint32_t> indices((num_block_elements + 31) / 32 * 32);
+
+  // First determine the distinct values, and the (unsorted) index of each
+  // element.
+  {
+    // Initialize previous_value such that it is guaranteed not to equal to the
+    // first value.
+    Label previous_value = input[0] + 1;
+    uint32_t previous_index = 0;
     auto* input_z = reinterpret_cast<const char*>(input);
     for (ptrdiff_t z = 0; z < input_shape[0]; ++z) {
       auto* input_y = input_z;
       for (ptrdiff_t y = 0; y < input_shape[1]; ++y) {
         auto* input_x = input_y;
+        uint32_t* row_indices =
+            indices.data() + block_shape[2] * (y + block_shape[1] * z);
         for (ptrdiff_t x = 0; x < input_shape[2]; ++x) {
-          func(z, y, x, *reinterpret_cast<const Label*>(input_x));
+          const Label value = *reinterpret_cast<const Label*>(input_x);
+          // If this value matches the previous value, we can skip the more
+          // expensive hash table lookup.
+          if (value != previous_value) {
+            previous_value = value;
+            auto [it, inserted] = seen_values.emplace(
+                value, static_cast<uint32_t>(seen_values_inv.size()));
+            if (inserted) seen_values_inv.push_back(value);
+            previous_index = it->second;
+          }
+          row_indices[x] = previous_index;
           input_x += input_byte_strides[2];
         }
         input_y += input_byte_strides[1];
       }
       input_z += input_byte_strides[0];
     }
-  };
+  }
 
-  // First determine the distinct values.
-
-  // Initialize previous_value such that it is guaranteed not to equal to the
-  // first value.
-  Label previous_value = input[0] + 1;
-  ForEachElement([&](size_t z, size_t y, size_t x, Label value) {
-    // If this value matches the previous value, we can skip the more
-    // expensive hash table lookup.
-    if (value != previous_value) {
-      previous_value = value;
-      if (seen_values.emplace(value, 0).second) {
-        seen_values_inv.push_back(value);
-      }
+  // Sort the distinct values, and compute the mapping from the unsorted index
+  // to the sorted index.
+  const size_t num_values = seen_values_inv.size();
+  std::vector<uint32_t> sorted_index(num_values);
+  {
+    std::vector<uint32_t> permutation(num_values);
+    for (uint32_t i = 0; i < num_values; ++i) permutation[i] = i;
+    std::sort(permutation.begin(), permutation.end(),
+              [&](uint32_t a, uint32_t b) {
+                return seen_values_inv[a] < seen_values_inv[b];
+              });
+    std::vector<Label> sorted_values(num_values);
+    for (uint32_t i = 0; i < num_values; ++i) {
+      sorted_values[i] = seen_values_inv[permutation[i]];
+      sorted_index[permutation[i]] = i;
     }
-  });
-
-  std::sort(seen_values_inv.begin(), seen_values_inv.end());
-  for (size_t i = 0; i < seen_values_inv.size(); ++i) {
-    seen_values[seen_values_inv[i]] = static_cast<uint32_t>(i);
+    seen_values_inv = std::move(sorted_values);
   }
 
   // Determine number of bits with which to encode each index.
   size_t encoded_bits = 0;
-  if (seen_values.size() != 1) {
+  if (num_values != 1) {
     encoded_bits = 1;
-    while ((size_t(1) << encoded_bits) < seen_values.size()) {
+    while ((size_t(1) << encoded_bits) < num_values) {
       encoded_bits *= 2;
     }
   }
   *encoded_bits_output = encoded_bits;
   const size_t encoded_size_32bits =
-      (encoded_bits * block_shape[0] * block_shape[1] * block_shape[2] + 31) /
-      32;
+      (encoded_bits * num_block_elements + 31) / 32;
 
   const size_t encoded_value_base_offset = output->size();
   assert((encoded_value_base_offset - base_offset) % 4 == 0);
@@ -120,7 +181,7 @@ void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
     auto it = cache->find(seen_values_inv);
     if (it == cache->end()) {
       write_table = true;
-      elements_to_write += seen_values.size() * num_32bit_words_per_label;
+      elements_to_write += num_values * num_32bit_words_per_label;
       *table_offset_output =
           (encoded_value_base_offset - base_offset) / 4 + encoded_size_32bits;
     } else {
@@ -132,14 +193,25 @@ void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
   output->resize(encoded_value_base_offset + elements_to_write * 4);
   char* output_ptr = output->data() + encoded_value_base_offset;
   // Write encoded representation.
-  ForEachElement([&](size_t z, size_t y, size_t x, Label value) {
-    uint32_t index = seen_values.at(value);
-    size_t output_offset = x + block_shape[2] * (y + block_shape[1] * z);
-    void* cur_ptr = output_ptr + output_offset * encoded_bits / 32 * 4;
-    absl::little_endian::Store32(
-        cur_ptr, absl::little_endian::Load32(cur_ptr) |
-                     (index << (output_offset * encoded_bits % 32)));
-  });
+  if (encoded_bits != 0) {
+    if (full_block) {
+      for (size_t i = 0; i < num_block_elements; ++i) {
+        indices[i] = sorted_index[indices[i]];
+      }
+    } else {
+      // Positions outside `input_shape` must remain 0.
+      for (ptrdiff_t z = 0; z < input_shape[0]; ++z) {
+        for (ptrdiff_t y = 0; y < input_shape[1]; ++y) {
+          uint32_t* row_indices =
+              indices.data() + block_shape[2] * (y + block_shape[1] * z);
+          for (ptrdiff_t x = 0; x < input_shape[2]; ++x) {
+            row_indices[x] = sorted_index[row_indices[x]];
+          }
+        }
+      }
+    }
+    PackIndices(encoded_bits, indices.data(), encoded_size_32bits, output_ptr);
+  }
 
   // Write table
   if (write_table) {
@@ -223,73 +295,123 @@ void ReadBlockHeader(const void* header, size_t* encoded_value_base_offset,
   *encoded_value_base_offset = (h >> 32) & 0xffffff;
 }
 
+// Returns the label at the specified table index.
 template <typename Label>
-bool DecodeBlock(size_t encoded_bits, const char* encoded_input,
-                 const char* table_input, size_t table_size,
-                 const ptrdiff_t block_shape[3],
+Label ReadTableLabel(const char* table_input, size_t index) {
+  if constexpr (sizeof(Label) == 4) {
+    return absl::little_endian::Load32(table_input + index * sizeof(Label));
+  } else {
+    return absl::little_endian::Load64(table_input + index * sizeof(Label));
+  }
+}
+
+// Decodes a block with `Bits`-bit encoded indices.
+//
+// Specializing on `Bits` turns the per-element bit extraction into constant
+// shifts and masks, which allows the compiler to vectorize the inner loop.
+template <size_t Bits, typename Label>
+bool DecodeBlock(const char* encoded_input, const char* table_input,
+                 size_t table_size, const ptrdiff_t block_shape[3],
                  const ptrdiff_t output_shape[3],
                  const ptrdiff_t output_byte_strides[3], Label* output) {
-  // TODO(jbms): Consider specializing this function for the value of
-  // `encoded_bits` and whether `table_size` is `< 2**encoded_bits`.  If
-  // `table_size >= 2**encoded_bits`, there is no need to check below that
-  // `index <= table_size`.
-
-  // Invokes `callback(label, z, y, x)` for each block position in C order.  If
-  // `callback` returns `false`, stops iterating and returns `false`.  Otherwise
-  // returns `true` when done.
-  const auto for_each_position = [&](auto callback) {
-    auto* output_z = reinterpret_cast<char*>(output);
-    for (ptrdiff_t z = 0; z < output_shape[0]; ++z) {
-      auto* output_y = output_z;
-      for (ptrdiff_t y = 0; y < output_shape[1]; ++y) {
-        auto* output_x = output_y;
-        for (ptrdiff_t x = 0; x < output_shape[2]; ++x) {
-          auto& label = *reinterpret_cast<Label*>(output_x);
-          if (!callback(label, z, y, x)) return false;
-          output_x += output_byte_strides[2];
-        }
-        output_y += output_byte_strides[1];
-      }
-      output_z += output_byte_strides[0];
+  constexpr uint32_t kMask =
+      Bits == 32 ? ~uint32_t(0) : ((uint32_t(1) << (Bits % 32)) - 1);
+  // Every encoded index is valid if the table is at least as large as the
+  // range of encoded indices, in which case the check can be skipped.
+  const bool check_index = Bits == 32 || table_size <= kMask;
+
+  // For small tables, decode the labels once rather than for each element.
+  constexpr size_t kLocalTableSize = Bits <= 8 ? (size_t(1) << Bits) : 1;
+  Label local_table[kLocalTableSize];
+  if constexpr (Bits <= 8) {
+    const size_t n = std::min(table_size, kLocalTableSize);
+    for (size_t i = 0; i < n; ++i) {
+      local_table[i] = ReadTableLabel<Label>(table_input, i);
     }
-    return true;
-  };
-
-  // Returns the label at the specified table index.
-  const auto read_label = [&](size_t index) -> Label {
-    if constexpr (sizeof(Label) == 4) {
-      return absl::little_endian::Load32(table_input + index * sizeof(Label));
+  }
+  const auto get_label = [&](uint32_t index) -> Label {
+    if constexpr (Bits <= 8) {
+      return local_table[index];
     } else {
-      return absl::little_endian::Load64(table_input + index * sizeof(Label));
+      return ReadTableLabel<Label>(table_input, index);
     }
   };
 
-  if (encoded_bits == 0) {
-    // There are no encoded indices to read.
-    if (table_size == 0) return false;
-    const Label label = read_label(0);
-    return for_each_position(
-        [&](Label& output_label, ptrdiff_t z, ptrdiff_t y, ptrdiff_t x) {
-          output_label = label;
-          return true;
-        });
+  auto* output_z = reinterpret_cast<char*>(output);
+  for (ptrdiff_t z = 0; z < output_shape[0]; ++z) {
+    auto* output_y = output_z;
+    for (ptrdiff_t y = 0; y < output_shape[1]; ++y) {
+      auto* output_x = output_y;
+      const size_t row_offset = block_shape[2] * (y + block_shape[1] * z);
+      for (ptrdiff_t x = 0; x < output_shape[2]; ++x) {
+        const size_t encoded_offset = row_offset + x;
+        const uint32_t index =
+            (absl::little_endian::Load32(encoded_input +
+                                         encoded_offset * Bits / 32 * 4) >>
+             (encoded_offset * Bits % 32)) &
+            kMask;
+        if (check_index && index >= table_size) return false;
+        *reinterpret_cast<Label*>(output_x) = get_label(index);
+        output_x += output_byte_strides[2];
+      }
+      output_y += output_byte_strides[1];
+    }
+    output_z += output_byte_strides[0];
   }
-
-  const uint32_t encoded_value_mask = (1U << encoded_bits) - 1;
-  return for_each_position([&](Label& output_label, ptrdiff_t z, ptrdiff_t y,
-                               ptrdiff_t x) {
-    size_t encoded_offset = x + block_shape[2] * (y + block_shape[1] * z);
-    auto index = absl::little_endian::Load32(
-                     encoded_input + encoded_offset * encoded_bits / 32 * 4) >>
-                     (encoded_offset * encoded_bits % 32) &
-                 encoded_value_mask;
-    if (index >= table_size) return false;
-    output_label = read_label(index);
-    return true;
-  });
   return true;
 }
 
+template <typename Label>
+bool DecodeBlock(size_t encoded_bits, const char* encoded_input,
+                 const char* table_input, size_t table_size,
+                 const ptrdiff_t block_shape[3],
+                 const ptrdiff_t output_shape[3],
+                 const ptrdiff_t output_byte_strides[3], Label* output) {
+  switch (encoded_bits) {
+    case 0: {
+      // There are no encoded indices to read.
+      if (table_size == 0) return false;
+      const Label label = ReadTableLabel<Label>(table_input, 0);
+      auto* output_z = reinterpret_cast<char*>(output);
+      for (ptrdiff_t z = 0; z < output_shape[0]; ++z) {
+        auto* output_y = output_z;
+        for (ptrdiff_t y = 0; y < output_shape[1]; ++y) {
+          auto* output_x = output_y;
+          for (ptrdiff_t x = 0; x < output_shape[2]; ++x) {
+            *reinterpret_cast<Label*>(output_x) = label;
+            output_x += output_byte_strides[2];
+          }
+          output_y += output_byte_strides[1];
+        }
+        output_z += output_byte_strides[0];
+      }
+      return true;
+    }
+    case 1:
+      return DecodeBlock<1>(encoded_input, table_input, table_size, block_shape,
+                            output_shape, output_byte_strides, output);
+    case 2:
+      return DecodeBlock<2>(encoded_input, table_input, table_size, block_shape,
+                            output_shape, output_byte_strides, output);
+    case 4:
+      return DecodeBlock<4>(encoded_input, table_input, table_size, block_shape,
+                            output_shape, output_byte_strides, output);
+    case 8:
+      return DecodeBlock<8>(encoded_input, table_input, table_size, block_shape,
+                            output_shape, output_byte_strides, output);
+    case 16:
+      return DecodeBlock<16>(encoded_input, table_input, table_size,
+                             block_shape, output_shape, output_byte_strides,
+                             output);
+    case 32:
+      return DecodeBlock<32>(encoded_input, table_input, table_size,
+                             block_shape, output_shape, output_byte_strides,
+                             output);
+    default:
+      return false;
+  }
+}
+
 template <typename Label>
 bool DecodeChannel(std::string_view input, const ptrdiff_t block_shape[3],
                    const ptrdiff_t output_shape[3],
@@ -0,0 +1,80 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "absl/log/absl_check.h"
+#include "tensorstore/internal/compression/neuroglancer_compressed_segmentation.h"
+
+namespace {
+
+using ::tensorstore::neuroglancer_compressed_segmentation::DecodeChannels;
+using ::tensorstore::neuroglancer_compressed_segmentation::EncodeChannels;
+
+constexpr ptrdiff_t kSize = 64;
+const ptrdiff_t kShape[4] = {1, kSize, kSize, kSize};
+const ptrdiff_t kByteStrides[4] = {
+    kSize * kSize * kSize * sizeof(uint64_t),
+    kSize * kSize * sizeof(uint64_t), kSize * sizeof(uint64_t),
+    sizeof(uint64_t)};
+const ptrdiff_t kBlockShape[3] = {8, 8, 8};
+
+// Returns a `kSize`^3 volume in which each element is one of `num_labels`
+// distinct random labels.
+std::vector<uint64_t> MakeInput(size_t num_labels) {
+  std::minstd_rand gen(42);
+  std::vector<uint64_t> labels(num_labels);
+  for (auto& label : labels) label = (uint64_t{gen()} << 32) | gen();
+  std::vector<uint64_t> input(kSize * kSize * kSize);
+  for (auto& x : input) x = labels[gen() % num_labels];
+  return input;
+}
+
+void BM_Encode(benchmark::State& state) {
+  const auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    std::string output;
+    EncodeChannels(input.data(), kShape, kByteStrides, kBlockShape, &output);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size() *
+                          sizeof(uint64_t));
+}
+
+void BM_Decode(benchmark::State& state) {
+  const auto input = MakeInput(state.range(0));
+  std::string encoded;
+  EncodeChannels(input.data(), kShape, kByteStrides, kBlockShape, &encoded);
+  std::vector<uint64_t> output(input.size());
+  for (auto _ : state) {
+    ABSL_CHECK(DecodeChannels(encoded, kBlockShape, kShape, kByteStrides,
+                              output.data()));
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size() *
+                          sizeof(uint64_t));
+}
+
+// The number of distinct labels determines the encoded bit width.
+BENCHMARK(BM_Encode)->Arg(1)->Arg(2)->Arg(4)->Arg(16)->Arg(256)->Arg(512);
+BENCHMARK(BM_Decode)->Arg(1)->Arg(2)->Arg(4)->Arg(16)->Arg(256)->Arg(512);
+
+}  // namespace
@@ -30,16 +30,22 @@
 #include "absl/log/absl_log.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/civil_time.h"
 #include "absl/time/time.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/limiting_reader.h"
 #include "riegeli/bytes/prefix_limiting_reader.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
 #include "riegeli/bzip2/bzip2_reader.h"
 #include "riegeli/endian/endian_reading.h"
+#include "riegeli/endian/endian_writing.h"
 #include "riegeli/xz/xz_reader.h"
 #include "riegeli/zlib/zlib_reader.h"
+#include "riegeli/zlib/zlib_writer.h"
 #include "riegeli/zstd/zstd_reader.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/riegeli/find.h"
@@ -47,6 +53,9 @@
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
+// Include these last to reduce impact of macros.
+#include <zlib.h>
+
 namespace tensorstore {
 namespace internal_zip {
 namespace {
@@ -55,6 +64,15 @@ using ::riegeli::ReadLittleEndian16;
 using ::riegeli::ReadLittleEndian32;
 using ::riegeli::ReadLittleEndian64;
 using ::riegeli::ReadLittleEndianSigned64;
+using ::riegeli::WriteLittleEndian16;
+using ::riegeli::WriteLittleEndian32;
+using ::riegeli::WriteLittleEndian64;
+
+constexpr uint16_t kMax16 = std::numeric_limits<uint16_t>::max();
+constexpr uint32_t kMax32 = std::numeric_limits<uint32_t>::max();
+
+// 4.4.2: Upper byte 3 (UNIX), lower byte 45 (version 4.5, ZIP64).
+constexpr uint16_t kVersionMadeBy = (3 << 8) | 45;
 
 ABSL_CONST_INIT internal_log::VerboseFlag zip_logging("zip_details");
 
@@ -78,6 +96,23 @@ absl::Time MakeMSDOSTime(uint16_t date, uint16_t time) {
   return absl::FromTM(dos_tm, absl::UTCTimeZone());
 }
 
+// Inverse of MakeMSDOSTime. MSDOS dates are limited to 1980 through 2107.
+void ToMSDOSTime(absl::Time t, uint16_t &date, uint16_t &time) {
+  auto cs = absl::ToCivilSecond(t, absl::UTCTimeZone());
+  if (cs.year() < 1980) cs = absl::CivilSecond(1980, 1, 1);
+  if (cs.year() > 2107) cs = absl::CivilSecond(2107, 12, 31, 23, 59, 58);
+  date = static_cast<uint16_t>(((cs.year() - 1980) << 9) | (cs.month() << 5) |
+                               cs.day());
+  time = static_cast<uint16_t>((cs.hour() << 11) | (cs.minute() << 5) |
+                               (cs.second() / 2));
+}
+
+uint16_t VersionNeededToExtract(const ZipEntry &entry, bool zip64) {
+  if (zip64) return 45;
+  if (entry.compression_method == ZipCompression::kDeflate) return 20;
+  return 10;
+}
+
 // These could have different implementations for central headers vs.
 // local headers.
 absl::Status ReadExtraField_Zip64_0001(riegeli::Reader &reader,
@@ -300,8 +335,6 @@ absl::Status ReadEOCD64(riegeli::Reader &reader, ZipEOCD &eocd) {
 
   if (disk_number != disk_number_with_cd ||
       eocd.num_entries != total_num_entries ||
-      eocd.num_entries == std::numeric_limits<uint16_t>::max() ||
-      eocd.cd_size == std::numeric_limits<uint16_t>::max() ||
       eocd.cd_offset == std::numeric_limits<uint32_t>::max() ||
       eocd.cd_size < 0 || eocd.cd_offset < 0) {
     return absl::InvalidArgumentError(
@@ -739,5 +772,179 @@ tensorstore::Result<std::unique_ptr<riegeli::Reader>> GetReader(
       "Unsupported ZIP compression method ", entry.compression_method));
 }
 
+// --------------------------------------------------------------------------
+
+Result<absl::Cord> EncodeEntryData(const absl::Cord &data, ZipEntry &entry) {
+  uLong crc = crc32(0L, Z_NULL, 0);
+  for (std::string_view chunk : data.Chunks()) {
+    crc = crc32(crc, reinterpret_cast<const Bytef *>(chunk.data()),
+                static_cast<uInt>(chunk.size()));
+  }
+  entry.crc = static_cast<uint32_t>(crc);
+  entry.uncompressed_size = data.size();
+
+  absl::Cord encoded;
+  switch (entry.compression_method) {
+    case ZipCompression::kStore:
+      encoded = data;
+      break;
+    case ZipCompression::kDeflate: {
+      using DeflateWriter = riegeli::ZlibWriter<riegeli::CordWriter<>>;
+      DeflateWriter writer(
+          riegeli::CordWriter<>(&encoded),
+          DeflateWriter::Options().set_header(DeflateWriter::Header::kRaw));
+      if (!writer.Write(data) || !writer.Close()) {
+        return writer.status();
+      }
+      break;
+    }
+    default:
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Unsupported ZIP compression method for writing ",
+          entry.compression_method));
+  }
+  entry.compressed_size = encoded.size();
+  return encoded;
+}
+
+// 4.3.7
+absl::Status WriteLocalEntry(riegeli::Writer &writer, const ZipEntry &entry) {
+  if (entry.filename.size() > kMax16) {
+    return absl::InvalidArgumentError("ZIP entry filename too long");
+  }
+  const bool zip64 =
+      entry.uncompressed_size >= kMax32 || entry.compressed_size >= kMax32;
+  uint16_t last_mod_date;
+  uint16_t last_mod_time;
+  ToMSDOSTime(entry.mtime, last_mod_date, last_mod_time);
+
+  WriteLittleEndian32(0x04034b50, writer);
+  WriteLittleEndian16(VersionNeededToExtract(entry, zip64), writer);
+  WriteLittleEndian16(entry.flags, writer);
+  WriteLittleEndian16(static_cast<uint16_t>(entry.compression_method),
+                      writer);
+  WriteLittleEndian16(last_mod_time, writer);
+  WriteLittleEndian16(last_mod_date, writer);
+  WriteLittleEndian32(entry.crc, writer);
+  WriteLittleEndian32(zip64 ? kMax32 : entry.compressed_size, writer);
+  WriteLittleEndian32(zip64 ? kMax32 : entry.uncompressed_size, writer);
+  WriteLittleEndian16(entry.filename.size(), writer);
+  WriteLittleEndian16(zip64 ? 20 : 0, writer);
+  writer.Write(entry.filename);
+  if (zip64) {
+    // 4.5.3: The local header ZIP64 extra field includes both sizes.
+    WriteLittleEndian16(0x0001, writer);
+    WriteLittleEndian16(16, writer);
+    WriteLittleEndian64(entry.uncompressed_size, writer);
+    WriteLittleEndian64(entry.compressed_size, writer);
+  }
+  if (!writer.ok()) {
+    return MaybeAnnotateStatus(writer.status(),
+                               "Failed to write ZIP Local Entry");
+  }
+  return absl::OkStatus();
+}
+
+// 4.3.12
+absl::Status WriteCentralDirectoryEntry(riegeli::Writer &writer,
+                                        const ZipEntry &entry) {
+  if (entry.filename.size() > kMax16 || entry.comment.size() > kMax16) {
+    return absl::InvalidArgumentError(
+        "ZIP entry filename or comment too long");
+  }
+  const bool zip64_uncompressed = entry.uncompressed_size >= kMax32;
+  const bool zip64_compressed = entry.compressed_size >= kMax32;
+  const bool zip64_offset = entry.local_header_offset >= kMax32;
+  const uint16_t zip64_size =
+      8 * (zip64_uncompressed + zip64_compressed + zip64_offset);
+  uint16_t last_mod_date;
+  uint16_t last_mod_time;
+  ToMSDOSTime(entry.mtime, last_mod_date, last_mod_time);
+
+  WriteLittleEndian32(0x02014b50, writer);
+  WriteLittleEndian16(
+      entry.version_madeby ? entry.version_madeby : kVersionMadeBy, writer);
+  WriteLittleEndian16(VersionNeededToExtract(entry, zip64_size > 0), writer);
+  WriteLittleEndian16(entry.flags, writer);
+  WriteLittleEndian16(static_cast<uint16_t>(entry.compression_method),
+                      writer);
+  WriteLittleEndian16(last_mod_time, writer);
+  WriteLittleEndian16(last_mod_date, writer);
+  WriteLittleEndian32(entry.crc, writer);
+  WriteLittleEndian32(zip64_compressed ? kMax32 : entry.compressed_size,
+                      writer);
+  WriteLittleEndian32(zip64_uncompressed ? kMax32 : entry.uncompressed_size,
+                      writer);
+  WriteLittleEndian16(entry.filename.size(), writer);
+  WriteLittleEndian16(zip64_size ? zip64_size + 4 : 0, writer);
+  WriteLittleEndian16(entry.comment.size(), writer);
+  WriteLittleEndian16(0, writer);  // start disk_number
+  WriteLittleEndian16(entry.internal_fa, writer);
+  WriteLittleEndian32(entry.external_fa, writer);
+  WriteLittleEndian32(zip64_offset ? kMax32 : entry.local_header_offset,
+                      writer);
+  writer.Write(entry.filename);
+  if (zip64_size) {
+    // 4.5.3: Only the fields which overflow are included, in this order.
+    WriteLittleEndian16(0x0001, writer);
+    WriteLittleEndian16(zip64_size, writer);
+    if (zip64_uncompressed) {
+      WriteLittleEndian64(entry.uncompressed_size, writer);
+    }
+    if (zip64_compressed) WriteLittleEndian64(entry.compressed_size, writer);
+    if (zip64_offset) WriteLittleEndian64(entry.local_header_offset, writer);
+  }
+  writer.Write(entry.comment);
+  if (!writer.ok()) {
+    return MaybeAnnotateStatus(writer.status(),
+                               "Failed to write ZIP Central Directory Entry");
+  }
+  return absl::OkStatus();
+}
+
+// 4.3.14, 4.3.15, 4.3.16
+absl::Status WriteEOCD(riegeli::Writer &writer, const ZipEOCD &eocd) {
+  if (eocd.comment.size() > kMax16) {
+    return absl::InvalidArgumentError("ZIP comment too long");
+  }
+  const bool zip64 = eocd.num_entries >= kMax16 ||
+                     static_cast<uint64_t>(eocd.cd_size) >= kMax32 ||
+                     static_cast<uint64_t>(eocd.cd_offset) >= kMax32;
+  if (zip64) {
+    const uint64_t eocd64_offset = writer.pos();
+    WriteLittleEndian32(0x06064b50, writer);
+    WriteLittleEndian64(44, writer);  // size of remaining fixed fields.
+    WriteLittleEndian16(kVersionMadeBy, writer);
+    WriteLittleEndian16(45, writer);  // version needed
+    WriteLittleEndian32(0, writer);   // disk_number
+    WriteLittleEndian32(0, writer);   // disk_number_with_cd
+    WriteLittleEndian64(eocd.num_entries, writer);
+    WriteLittleEndian64(eocd.num_entries, writer);
+    WriteLittleEndian64(eocd.cd_size, writer);
+    WriteLittleEndian64(eocd.cd_offset, writer);
+
+    WriteLittleEndian32(0x07064b50, writer);
+    WriteLittleEndian32(0, writer);  // disk_number_with_cd
+    WriteLittleEndian64(eocd64_offset, writer);
+    WriteLittleEndian32(1, writer);  // total number of disks
+  }
+  const uint16_t num_entries =
+      zip64 ? kMax16 : static_cast<uint16_t>(eocd.num_entries);
+  WriteLittleEndian32(0x06054b50, writer);
+  WriteLittleEndian16(0, writer);  // disk_number
+  WriteLittleEndian16(0, writer);  // disk_number_with_cd
+  WriteLittleEndian16(num_entries, writer);
+  WriteLittleEndian16(num_entries, writer);
+  WriteLittleEndian32(zip64 ? kMax32 : eocd.cd_size, writer);
+  WriteLittleEndian32(zip64 ? kMax32 : eocd.cd_offset, writer);
+  WriteLittleEndian16(eocd.comment.size(), writer);
+  writer.Write(eocd.comment);
+  if (!writer.ok()) {
+    return MaybeAnnotateStatus(writer.status(),
+                               "Failed to write ZIP End of Central Directory");
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace internal_zip
 }  // namespace tensorstore
@@ -23,9 +23,11 @@
 #include <variant>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
 #include "tensorstore/util/result.h"
 
 // NOTE: Currently tensorstore does not use a third-party zip library such
@@ -224,6 +226,36 @@ tensorstore::Result<std::unique_ptr<riegeli::Reader>> GetRawReader(
 tensorstore::Result<std::unique_ptr<riegeli::Reader>> GetReader(
     riegeli::Reader *reader, ZipEntry &entry);
 
+// --------------------------------------------------------------------------
+// Writing.
+//
+// Entries are written without data descriptors, so the sizes and crc of a
+// new entry must be known before its local header is written.  ZIP64 extra
+// fields and records are written only when the values do not fit in the
+// 32-bit and 16-bit fields.
+
+/// Compresses `data` using `entry.compression_method`, which must be
+/// `kStore` or `kDeflate`, and sets the crc and sizes of `entry`.
+///
+/// 
+eturns The compressed entry data.
+Result<absl::Cord> EncodeEntryData(const absl::Cord &data, ZipEntry &entry);
+
+/// Writes a ZIP Local Entry header for `entry` at the current writer position.
+absl::Status WriteLocalEntry(riegeli::Writer &writer, const ZipEntry &entry);
+
+/// Writes a ZIP Central Directory Entry for `entry` at the current writer
+/// position, which references the local header at
+/// `entry.local_header_offset`.
+absl::Status WriteCentralDirectoryEntry(riegeli::Writer &writer,
+                                        const ZipEntry &entry);
+
+/// Writes the end of central directory records for `eocd`, including the
+/// EOCD64 record and locator if required.
+///
+/// \pre `writer.pos()` is the offset from the start of the file.
+absl::Status WriteEOCD(riegeli::Writer &writer, const ZipEOCD &eocd);
+
 }  // namespace internal_zip
 }  // namespace tensorstore
 
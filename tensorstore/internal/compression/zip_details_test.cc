@@ -29,8 +29,10 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/fd_reader.h"
 #include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
@@ -44,11 +46,15 @@ using ::tensorstore::internal::StartsWith;
 using ::tensorstore::internal_zip::kCentralHeaderLiteral;
 using ::tensorstore::internal_zip::kEOCDLiteral;
 using ::tensorstore::internal_zip::kLocalHeaderLiteral;
+using ::tensorstore::internal_zip::EncodeEntryData;
 using ::tensorstore::internal_zip::ReadCentralDirectoryEntry;
 using ::tensorstore::internal_zip::ReadEOCD;
 using ::tensorstore::internal_zip::ReadEOCD64Locator;
 using ::tensorstore::internal_zip::ReadLocalEntry;
 using ::tensorstore::internal_zip::TryReadFullEOCD;
+using ::tensorstore::internal_zip::WriteCentralDirectoryEntry;
+using ::tensorstore::internal_zip::WriteEOCD;
+using ::tensorstore::internal_zip::WriteLocalEntry;
 using ::tensorstore::internal_zip::ZipCompression;
 using ::tensorstore::internal_zip::ZipEntry;
 using ::tensorstore::internal_zip::ZipEOCD;
@@ -562,6 +568,104 @@ TEST(ZipDetailsTest, Deflate) {
   EXPECT_EQ(data.size(), local_header.uncompressed_size);
 }
 
+TEST(ZipDetailsTest, WriteRoundTrip) {
+  const absl::Time mtime = absl::FromCivil(
+      absl::CivilSecond(2023, 8, 3, 6, 2, 22), absl::UTCTimeZone());
+  const absl::Cord data("aaaaaaaaaaaaaa\nbbbbbbbbbbbbbb\naaaaaaaaaaaaaa\n");
+
+  absl::Cord zip;
+  std::vector<ZipEntry> entries;
+  {
+    riegeli::CordWriter<> writer(&zip);
+    for (auto method : {ZipCompression::kStore, ZipCompression::kDeflate}) {
+      ZipEntry entry{};
+      entry.compression_method = method;
+      entry.mtime = mtime;
+      entry.filename = absl::StrFormat("file%d", entries.size());
+      entry.local_header_offset = writer.pos();
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                       EncodeEntryData(data, entry));
+      TENSORSTORE_ASSERT_OK(WriteLocalEntry(writer, entry));
+      ASSERT_TRUE(writer.Write(encoded));
+      entries.push_back(std::move(entry));
+    }
+    ZipEOCD eocd{};
+    eocd.num_entries = entries.size();
+    eocd.cd_offset = writer.pos();
+    for (const auto& entry : entries) {
+      TENSORSTORE_ASSERT_OK(WriteCentralDirectoryEntry(writer, entry));
+    }
+    eocd.cd_size = writer.pos() - eocd.cd_offset;
+    TENSORSTORE_ASSERT_OK(WriteEOCD(writer, eocd));
+    ASSERT_TRUE(writer.Close());
+  }
+
+  riegeli::CordReader reader(&zip);
+  ZipEOCD eocd{};
+  ASSERT_TRUE(std::holds_alternative<absl::Status>(
+      TryReadFullEOCD(reader, eocd, 0)));
+  EXPECT_EQ(eocd.num_entries, 2);
+  ASSERT_TRUE(reader.Seek(eocd.cd_offset));
+  for (const auto& expected : entries) {
+    ZipEntry entry{};
+    TENSORSTORE_ASSERT_OK(ReadCentralDirectoryEntry(reader, entry));
+    EXPECT_EQ(entry.filename, expected.filename);
+    EXPECT_EQ(entry.compression_method, expected.compression_method);
+    EXPECT_EQ(entry.crc, expected.crc);
+    EXPECT_EQ(entry.local_header_offset, expected.local_header_offset);
+    EXPECT_EQ(entry.mtime, mtime);
+  }
+
+  for (const auto& expected : entries) {
+    riegeli::CordReader entry_reader(&zip);
+    ASSERT_TRUE(entry_reader.Seek(expected.local_header_offset));
+    ZipEntry local_header{};
+    TENSORSTORE_ASSERT_OK(ReadLocalEntry(entry_reader, local_header));
+    EXPECT_EQ(local_header.filename, expected.filename);
+    EXPECT_EQ(local_header.crc, expected.crc);
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto reader,
+                                     GetReader(&entry_reader, local_header));
+    std::string decoded;
+    TENSORSTORE_ASSERT_OK(riegeli::ReadAll(*reader, decoded));
+    EXPECT_EQ(decoded, data);
+  }
+}
+
+TEST(ZipDetailsTest, WriteZip64) {
+  ZipEntry entry{};
+  entry.filename = "large";
+  entry.compressed_size = 5000000000;
+  entry.uncompressed_size = 5000000000;
+  entry.local_header_offset = 6000000000;
+
+  absl::Cord zip;
+  ZipEOCD eocd{};
+  eocd.num_entries = 70000;
+  eocd.cd_offset = 7000000000;
+  {
+    riegeli::CordWriter<> writer(&zip);
+    TENSORSTORE_ASSERT_OK(WriteCentralDirectoryEntry(writer, entry));
+    eocd.cd_size = writer.pos();
+    TENSORSTORE_ASSERT_OK(WriteEOCD(writer, eocd));
+    ASSERT_TRUE(writer.Close());
+  }
+
+  riegeli::CordReader reader(&zip);
+  ZipEntry read_entry{};
+  TENSORSTORE_ASSERT_OK(ReadCentralDirectoryEntry(reader, read_entry));
+  EXPECT_TRUE(read_entry.is_zip64);
+  EXPECT_EQ(read_entry.compressed_size, entry.compressed_size);
+  EXPECT_EQ(read_entry.uncompressed_size, entry.uncompressed_size);
+  EXPECT_EQ(read_entry.local_header_offset, entry.local_header_offset);
+
+  ZipEOCD read_eocd{};
+  ASSERT_TRUE(std::holds_alternative<absl::Status>(
+      TryReadFullEOCD(reader, read_eocd, 0)));
+  EXPECT_EQ(read_eocd.num_entries, eocd.num_entries);
+  EXPECT_EQ(read_eocd.cd_offset, eocd.cd_offset);
+  EXPECT_EQ(read_eocd.cd_size, eocd.cd_size);
+}
+
 /* zipdetails data.zip
 =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 00000 LOCAL HEADER #1       04034B50
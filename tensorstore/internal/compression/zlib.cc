@@ -14,9 +14,14 @@
 
 #include "tensorstore/internal/compression/zlib.h"
 
+#include <memory>
+#include <utility>
+
+#include "absl/base/no_destructor.h"
 #include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
+#include "tensorstore/internal/compression/context_pool.h"
 #include "tensorstore/internal/compression/cord_stream_manager.h"
 
 // Include zlib header last because it defines a bunch of poorly-named macros.
@@ -31,6 +36,7 @@ struct InflateOp {
     return inflateInit2(s, /*windowBits=*/15 /* (default) */
                                + header_option);
   }
+  static int Reset(z_stream* s) { return inflateReset(s); }
   static int Process(z_stream* s, int flags) { return inflate(s, flags); }
   static int Destroy(z_stream* s) { return inflateEnd(s); }
   static constexpr bool kDataErrorPossible = true;
@@ -44,11 +50,34 @@ struct DeflateOp {
                         /*memlevel=*/8 /* (default) */,
                         /*strategy=*/Z_DEFAULT_STRATEGY);
   }
+  static int Reset(z_stream* s) { return deflateReset(s); }
   static int Process(z_stream* s, int flags) { return deflate(s, flags); }
   static int Destroy(z_stream* s) { return deflateEnd(s); }
   static constexpr bool kDataErrorPossible = false;
 };
 
+template <typename Op>
+struct ZStreamDeleter {
+  void operator()(z_stream* s) const {
+    Op::Destroy(s);
+    delete s;
+  }
+};
+
+// Streams are keyed by `(level, header_option)`.  Streams are heap allocated
+// since zlib requires that the address of an initialized `z_stream` remain
+// unchanged.
+template <typename Op>
+using ZStreamPool =
+    internal::CompressionContextPool<z_stream, ZStreamDeleter<Op>,
+                                     std::pair<int, int>>;
+
+template <typename Op>
+ZStreamPool<Op>& GetZStreamPool() {
+  static absl::NoDestructor<ZStreamPool<Op>> pool;
+  return *pool;
+}
+
 /// Inflates or deflates using zlib.
 ///
 /// \tparam Op Either `InflateOp` or `DeflateOp`.
@@ -63,21 +92,26 @@ struct DeflateOp {
 template <typename Op>
 absl::Status ProcessZlib(const absl::Cord& input, absl::Cord* output, int level,
                          bool use_gzip_header) {
-  z_stream s = {};
-  internal::CordStreamManager<z_stream, /*BufferSize=*/16 * 1024>
-      stream_manager(s, input, output);
   const int header_option = use_gzip_header ? 16 /* require gzip header */
                                             : 0;
-  int err = Op::Init(&s, level, header_option);
-  if (err != Z_OK) {
-    // Terminate if allocating even the small amount of memory required fails.
-    ABSL_CHECK(false);
-  }
-  struct StreamDestroyer {
-    z_stream* s;
-    ~StreamDestroyer() { Op::Destroy(s); }
-  } stream_destroyer{&s};
-
+  // Reuse a previously-initialized stream, if available, to avoid the cost of
+  // allocating and initializing the stream state for each call.
+  auto stream = GetZStreamPool<Op>().Acquire(
+      {level, header_option},
+      [&] {
+        typename ZStreamPool<Op>::Ptr s(new z_stream{});
+        if (Op::Init(s.get(), level, header_option) != Z_OK) {
+          // Terminate if allocating even the small amount of memory required
+          // fails.
+          ABSL_CHECK(false);
+        }
+        return s;
+      },
+      [](z_stream* s) { ABSL_CHECK_EQ(Op::Reset(s), Z_OK); });
+  z_stream& s = *stream;
+  internal::CordStreamManager<z_stream, /*BufferSize=*/16 * 1024>
+      stream_manager(s, input, output);
+  int err;
   while (true) {
     const bool input_complete = stream_manager.FeedInputAndOutputBuffers();
     err = Op::Process(&s, input_complete ? Z_FINISH : Z_NO_FLUSH);
@@ -0,0 +1,60 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/compression/zstd_dictionary.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+#include <zdict.h>
+
+namespace tensorstore {
+namespace internal {
+
+Result<std::string> TrainZstdDictionary(span<const absl::Cord> samples,
+                                        size_t max_size) {
+  // ZDICT requires the samples to be concatenated into a single buffer.
+  std::string buffer;
+  std::vector<size_t> sample_sizes;
+  sample_sizes.reserve(samples.size());
+  for (const auto& sample : samples) {
+    for (absl::string_view chunk : sample.Chunks()) {
+      buffer.append(chunk.data(), chunk.size());
+    }
+    sample_sizes.push_back(sample.size());
+  }
+  std::string dictionary(max_size, '\0');
+  const size_t result = ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), buffer.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(result)) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Failed to train zstd dictionary from ",
+                            samples.size(), " samples: ",
+                            ZDICT_getErrorName(result)));
+  }
+  dictionary.resize(result);
+  return dictionary;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,57 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_ZSTD_DICTIONARY_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_ZSTD_DICTIONARY_H_
+
+/// \file
+/// Training of zstd dictionaries.
+
+#include <stddef.h>
+
+#include <string>
+
+#include "absl/strings/cord.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Default maximum size of a trained dictionary.
+constexpr size_t kDefaultZstdDictionarySize = 112640;
+
+/// Trains a zstd dictionary from a sample of representative inputs.
+///
+/// Dictionaries improve the compression ratio and speed for small inputs,
+/// which otherwise are compressed without any prior context.  Training works
+/// best with a few hundred samples whose combined size is roughly 100 times
+/// the dictionary size.
+///
+/// \param samples The sample inputs, e.g. existing chunks prior to
+///     compression.
+/// \param max_size Maximum size of the dictionary in bytes.
+/// \returns The raw dictionary, suitable for use with `ZSTD_createCDict` and
+///     `ZSTD_createDDict`, or as the ``dictionary`` of the zarr3 ``zstd``
+///     codec.
+/// \error `absl::StatusCode::kInvalidArgument` if training fails, e.g. due to
+///     insufficient samples.
+Result<std::string> TrainZstdDictionary(
+    span<const absl::Cord> samples,
+    size_t max_size = kDefaultZstdDictionarySize);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_ZSTD_DICTIONARY_H_
@@ -0,0 +1,81 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/compression/zstd_dictionary.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+#include <zstd.h>
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::TrainZstdDictionary;
+
+// Returns the compressed size of `input`, optionally using `dictionary`.
+size_t CompressedSize(const std::string& input, const std::string* dictionary) {
+  std::string output(ZSTD_compressBound(input.size()), '\0');
+  ZSTD_CCtx* ctx = ZSTD_createCCtx();
+  const size_t result =
+      dictionary ? ZSTD_compress_usingDict(ctx, output.data(), output.size(),
+                                           input.data(), input.size(),
+                                           dictionary->data(),
+                                           dictionary->size(), 3)
+                 : ZSTD_compressCCtx(ctx, output.data(), output.size(),
+                                     input.data(), input.size(), 3);
+  ZSTD_freeCCtx(ctx);
+  EXPECT_FALSE(ZSTD_isError(result));
+  return result;
+}
+
+std::string MakeSample(int i) {
+  return tensorstore::StrCat(R"({"segment_id": )", i * 7919 % 1000,
+                             R"(, "label": "neuron", "parent": )", i % 13,
+                             R"(, "bounds": [)", i % 100, ", ", i % 37, ", ",
+                             i % 11, "]}");
+}
+
+TEST(TrainZstdDictionaryTest, ImprovesCompressionOfSmallInputs) {
+  std::vector<absl::Cord> samples;
+  for (int i = 0; i < 1000; ++i) {
+    samples.push_back(absl::Cord(MakeSample(i)));
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto dictionary,
+                                   TrainZstdDictionary(samples, 4096));
+  EXPECT_LE(dictionary.size(), 4096);
+  EXPECT_FALSE(dictionary.empty());
+
+  const std::string input = MakeSample(12345);
+  EXPECT_LT(CompressedSize(input, &dictionary),
+            CompressedSize(input, nullptr));
+}
+
+TEST(TrainZstdDictionaryTest, InsufficientSamples) {
+  std::vector<absl::Cord> samples{absl::Cord("abc")};
+  EXPECT_THAT(TrainZstdDictionary(samples),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Failed to train zstd dictionary from 1 samples: "
+                            ".*"));
+}
+
+}  // namespace
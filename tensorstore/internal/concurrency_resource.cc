@@ -38,10 +38,16 @@ AnyContextResourceJsonBinder<ConcurrencyResource::Spec>
 ConcurrencyResourceTraits::JsonBinder() {
   namespace jb = tensorstore::internal_json_binding;
   return [](auto is_loading, const auto& options, auto* obj, auto* j) {
-    return jb::Object(jb::Member(
-        "limit", jb::DefaultInitializedValue(jb::Optional(
-                     jb::Integer<size_t>(1), [] { return "shared"; }))))(
-        is_loading, options, obj, j);
+    return jb::Object(
+        jb::Member("limit", jb::Projection<&Spec::limit>(
+                                jb::DefaultInitializedValue(jb::Optional(
+                                    jb::Integer<size_t>(1),
+                                    [] { return "shared"; })))),
+        jb::Member("numa_aware",
+                   jb::Projection<&Spec::numa_aware>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* v) { *v = false; }))))(is_loading, options,
+                                                           obj, j);
   };
 }
 
@@ -49,14 +55,19 @@ Result<ConcurrencyResource::Resource> ConcurrencyResourceTraits::Create(
     const Spec& spec, ContextResourceCreationContext context) const {
   Resource value;
   value.spec = spec;
-  if (spec) {
-    value.executor = DetachedThreadPool(*spec);
+  auto make_thread_pool = [&](size_t limit) {
+    return spec.numa_aware ? NumaAwareDetachedThreadPool(limit)
+                           : DetachedThreadPool(limit);
+  };
+  if (spec.limit) {
+    value.executor = make_thread_pool(*spec.limit);
   } else {
-    absl::call_once(shared_executor_once_, [&] {
-      shared_executor_ = DetachedThreadPool(shared_limit_);
+    absl::call_once(shared_executor_once_[spec.numa_aware], [&] {
+      shared_executor_[spec.numa_aware] = make_thread_pool(shared_limit_);
     });
-    value.executor = shared_executor_;
+    value.executor = shared_executor_[spec.numa_aware];
   }
+  value.maybe_inline_executor = MaybeInlineExecutor(value.executor);
   return value;
 }
 
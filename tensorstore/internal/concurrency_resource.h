@@ -49,11 +49,19 @@ namespace internal {
 ///
 /// 3. Register the `Traits` type using a `ContextResourceRegistration` object.
 struct ConcurrencyResource {
-  using Spec = std::optional<size_t>;
-  struct Resource {
+  struct Spec {
     // If equal to `nullopt`, indicates that the shared executor is used.
+    std::optional<size_t> limit;
+    // Partition worker threads by NUMA node; see
+    // `NumaAwareDetachedThreadPool`.
+    bool numa_aware = false;
+  };
+  struct Resource {
     Spec spec;
     Executor executor;
+    // Runs cheap continuations inline when already on a thread of `executor`;
+    // see `MaybeInlineExecutor`.
+    Executor maybe_inline_executor;
   };
 };
 
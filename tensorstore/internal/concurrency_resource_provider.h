@@ -40,7 +40,7 @@ class ConcurrencyResourceTraits {
   ConcurrencyResourceTraits(size_t shared_limit)
       : shared_limit_(shared_limit) {}
 
-  static Spec Default() { return std::nullopt; }
+  static Spec Default() { return {}; }
 
   static AnyContextResourceJsonBinder<Spec> JsonBinder();
 
@@ -49,13 +49,14 @@ class ConcurrencyResourceTraits {
   Spec GetSpec(const Resource& value, const ContextSpecBuilder& builder) const;
 
  private:
-  /// Size of thread pool referenced by `shared_executor_`.
+  /// Size of thread pools referenced by `shared_executor_`.
   size_t shared_limit_;
-  /// Protects initialization of `shared_executor_`.
-  mutable absl::once_flag shared_executor_once_;
-  /// Lazily-initialization shared thread pool used in the case of a default
-  /// resource specification.
-  mutable Executor shared_executor_;
+  /// Protects initialization of `shared_executor_`, indexed by
+  /// `Spec::numa_aware`.
+  mutable absl::once_flag shared_executor_once_[2];
+  /// Lazily-initialization shared thread pools used in the case of a default
+  /// resource specification, indexed by `Spec::numa_aware`.
+  mutable Executor shared_executor_[2];
 };
 
 }  // namespace internal
@@ -0,0 +1,97 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CONTAINER_MPSC_INBOX_H_
+#define TENSORSTORE_INTERNAL_CONTAINER_MPSC_INBOX_H_
+
+#include <atomic>
+#include <cassert>
+
+namespace tensorstore {
+namespace internal_container {
+
+/// MpscInbox is a lock-free multi-producer inbox of intrusively-linked nodes.
+///
+/// Producers push a single node, or a pre-linked chain of nodes, with a single
+/// compare-and-swap.  The consumer removes all nodes at once, in the order in
+/// which they were pushed.  Since nodes are never removed individually, the
+/// inbox is not subject to the ABA problem.
+///
+/// Nodes are linked through the `T* T::*Next` member, which must not be
+/// accessed by other code while the node is in the inbox.  The inbox does not
+/// own the nodes.
+template <typename T, T* T::*Next>
+class MpscInbox {
+ public:
+  MpscInbox() = default;
+  MpscInbox(const MpscInbox&) = delete;
+  MpscInbox& operator=(const MpscInbox&) = delete;
+
+  ~MpscInbox() { assert(empty()); }
+
+  /// Pushes `node`.
+  ///
+  /// Returns `true` if the inbox was empty.
+  ///
+  /// Thread safety: safe to call concurrently from multiple threads.
+  bool Push(T* node) { return PushChain(node, node); }
+
+  /// Pushes a chain of nodes linked through `Next` from `newest` to `oldest`;
+  /// the `Next` member of `oldest` is overwritten.
+  ///
+  /// Returns `true` if the inbox was empty.
+  ///
+  /// Thread safety: safe to call concurrently from multiple threads.
+  bool PushChain(T* newest, T* oldest) {
+    T* top = top_.load(std::memory_order_relaxed);
+    do {
+      oldest->*Next = top;
+    } while (!top_.compare_exchange_weak(top, newest, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed));
+    return top == nullptr;
+  }
+
+  /// Removes all nodes, and returns the oldest node, or `nullptr` if the inbox
+  /// was empty.  The returned nodes are linked through `Next` in the order in
+  /// which they were pushed, and the last has a null `Next`.
+  ///
+  /// Thread safety: safe to call concurrently from multiple threads.
+  T* TakeAll() {
+    T* node = top_.exchange(nullptr, std::memory_order_acquire);
+    T* prev = nullptr;
+    while (node != nullptr) {
+      T* next = node->*Next;
+      node->*Next = prev;
+      prev = node;
+      node = next;
+    }
+    return prev;
+  }
+
+  /// Returns `true` if the inbox is empty.
+  ///
+  /// Uses a sequentially-consistent load, so that a producer and a consumer
+  /// that each publish a flag and then check the other's cannot both miss.
+  bool empty() const {
+    return top_.load(std::memory_order_seq_cst) == nullptr;
+  }
+
+ private:
+  std::atomic<T*> top_{nullptr};
+};
+
+}  // namespace internal_container
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CONTAINER_MPSC_INBOX_H_
@@ -0,0 +1,104 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/container/mpsc_inbox.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/internal/thread/thread.h"
+
+namespace {
+
+using ::tensorstore::internal_container::MpscInbox;
+
+struct Node {
+  int value = 0;
+  Node* next = nullptr;
+};
+
+using Inbox = MpscInbox<Node, &Node::next>;
+
+std::vector<int> TakeAllValues(Inbox& inbox) {
+  std::vector<int> values;
+  for (Node* node = inbox.TakeAll(); node != nullptr; node = node->next) {
+    values.push_back(node->value);
+  }
+  return values;
+}
+
+TEST(MpscInboxTest, Basic) {
+  Inbox inbox;
+  EXPECT_TRUE(inbox.empty());
+  EXPECT_EQ(nullptr, inbox.TakeAll());
+
+  Node a{1}, b{2}, c{3};
+  EXPECT_TRUE(inbox.Push(&a));
+  EXPECT_FALSE(inbox.Push(&b));
+  EXPECT_FALSE(inbox.empty());
+  EXPECT_THAT(TakeAllValues(inbox), ::testing::ElementsAre(1, 2));
+  EXPECT_TRUE(inbox.empty());
+
+  EXPECT_TRUE(inbox.Push(&c));
+  EXPECT_THAT(TakeAllValues(inbox), ::testing::ElementsAre(3));
+}
+
+TEST(MpscInboxTest, PushChain) {
+  Inbox inbox;
+  Node a{1}, b{2}, c{3}, d{4};
+  inbox.Push(&a);
+  // Chain linked from newest to oldest.
+  d.next = &c;
+  c.next = &b;
+  EXPECT_FALSE(inbox.PushChain(&d, &b));
+  EXPECT_THAT(TakeAllValues(inbox), ::testing::ElementsAre(1, 2, 3, 4));
+}
+
+TEST(MpscInboxTest, ConcurrentProducers) {
+  constexpr size_t kThreads = 4;
+  constexpr int kPerThread = 1000;
+  Inbox inbox;
+  std::vector<std::vector<Node>> nodes(kThreads,
+                                       std::vector<Node>(kPerThread));
+  std::vector<tensorstore::internal::Thread> threads;
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back(tensorstore::internal::Thread(
+        {"producer"}, [&nodes, &inbox, i] {
+          for (int j = 0; j < kPerThread; ++j) {
+            nodes[i][j].value = static_cast<int>(i) * kPerThread + j;
+            inbox.Push(&nodes[i][j]);
+          }
+        }));
+  }
+
+  std::vector<int> last(kThreads, -1);
+  size_t count = 0;
+  auto consume = [&] {
+    for (Node* node = inbox.TakeAll(); node != nullptr; node = node->next) {
+      // Nodes from each producer are received in order.
+      size_t producer = node->value / kPerThread;
+      EXPECT_LT(last[producer], node->value);
+      last[producer] = node->value;
+      ++count;
+    }
+  };
+  while (count < kThreads * kPerThread) consume();
+  for (auto& thread : threads) thread.Join();
+  EXPECT_TRUE(inbox.empty());
+}
+
+}  // namespace
@@ -0,0 +1,49 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/deadline.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/metrics/counter.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+auto& deadline_exceeded = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/deadline_exceeded",
+    "Number of operations that failed because their deadline passed.");
+
+}  // namespace
+
+absl::Status DeadlineExceededError(absl::Time deadline) {
+  deadline_exceeded.Increment();
+  return absl::DeadlineExceededError(
+      absl::StrCat("Operation did not complete by deadline ",
+                   absl::FormatTime(deadline)));
+}
+
+absl::Duration TimeUntilDeadline(absl::Time deadline) {
+  return std::max(absl::ZeroDuration(), deadline - absl::Now());
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,81 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_DEADLINE_H_
+#define TENSORSTORE_INTERNAL_DEADLINE_H_
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/util/deadline.h"  // IWYU pragma: export
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/stop_token.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Returns the error for an operation which did not complete by `deadline`.
+absl::Status DeadlineExceededError(absl::Time deadline);
+
+/// Returns the time remaining until `deadline`, which is never negative.
+absl::Duration TimeUntilDeadline(absl::Time deadline);
+
+/// Arranges for `promise` to fail with `DeadlineExceededError(deadline)` if
+/// its result has not been set by `deadline`.
+///
+/// Setting the error marks the result as not needed, which triggers any
+/// cancellation registered with `Promise::ExecuteWhenNotNeeded`.  The timer is
+/// removed once the result is set or is no longer needed.
+template <typename T>
+void SetPromiseDeadline(const Promise<T>& promise, absl::Time deadline) {
+  if (deadline == absl::InfiniteFuture() || !promise.result_needed()) return;
+  if (deadline <= absl::Now()) {
+    promise.SetResult(DeadlineExceededError(deadline));
+    return;
+  }
+  StopSource stop_source;
+  ScheduleAt(
+      deadline,
+      [promise, deadline] {
+        promise.SetResult(DeadlineExceededError(deadline));
+      },
+      stop_source.get_token());
+  promise.ExecuteWhenNotNeeded(
+      [stop_source = std::move(stop_source)] { stop_source.request_stop(); });
+}
+
+/// Returns a future which becomes ready with the result of `future`, or with
+/// `DeadlineExceededError(deadline)` if `future` does not become ready by
+/// `deadline`.
+///
+/// In the latter case, the reference to `future` is released, so that its
+/// producer may cancel the outstanding work.
+template <typename T>
+Future<T> WithDeadline(Future<T> future, absl::Time deadline) {
+  if (deadline == absl::InfiniteFuture() || future.null() || future.ready()) {
+    return future;
+  }
+  auto pair = PromiseFuturePair<T>::Make();
+  LinkResult(pair.promise, std::move(future));
+  SetPromiseDeadline(pair.promise, deadline);
+  return std::move(pair.future);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_DEADLINE_H_
@@ -0,0 +1,85 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/deadline.h"
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::internal::GetCurrentDeadline;
+using ::tensorstore::internal::ScopedDeadline;
+using ::tensorstore::internal::WithDeadline;
+
+TEST(DeadlineTest, ScopedDeadlineOnlyShortens) {
+  EXPECT_EQ(absl::InfiniteFuture(), GetCurrentDeadline());
+  const absl::Time t = absl::Now() + absl::Seconds(10);
+  {
+    ScopedDeadline outer(t);
+    EXPECT_EQ(t, GetCurrentDeadline());
+    {
+      ScopedDeadline inner(t + absl::Seconds(5));
+      EXPECT_EQ(t, GetCurrentDeadline());
+    }
+    {
+      ScopedDeadline inner(t - absl::Seconds(5));
+      EXPECT_EQ(t - absl::Seconds(5), GetCurrentDeadline());
+    }
+    EXPECT_EQ(t, GetCurrentDeadline());
+  }
+  EXPECT_EQ(absl::InfiniteFuture(), GetCurrentDeadline());
+}
+
+TEST(DeadlineTest, NoDeadline) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future = WithDeadline(pair.future, absl::InfiniteFuture());
+  pair.promise.SetResult(5);
+  ASSERT_TRUE(future.ready());
+  EXPECT_EQ(5, future.value());
+}
+
+TEST(DeadlineTest, CompletesBeforeDeadline) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future =
+      WithDeadline(std::move(pair.future), absl::Now() + absl::Seconds(100));
+  EXPECT_FALSE(future.ready());
+  pair.promise.SetResult(5);
+  ASSERT_TRUE(future.ready());
+  EXPECT_EQ(5, future.value());
+}
+
+TEST(DeadlineTest, AlreadyExpired) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future =
+      WithDeadline(std::move(pair.future), absl::Now() - absl::Seconds(1));
+  ASSERT_TRUE(future.ready());
+  EXPECT_EQ(absl::StatusCode::kDeadlineExceeded, future.status().code());
+  // The reference to the original future is released.
+  EXPECT_FALSE(pair.promise.result_needed());
+}
+
+TEST(DeadlineTest, Expires) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future = WithDeadline(std::move(pair.future),
+                             absl::Now() + absl::Milliseconds(10));
+  EXPECT_EQ(absl::StatusCode::kDeadlineExceeded, future.status().code());
+  EXPECT_FALSE(pair.promise.result_needed());
+}
+
+}  // namespace
@@ -0,0 +1,100 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/decode_offload.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+struct DecodeOffloadRegistry {
+  absl::Mutex mutex;
+  std::vector<DecodeOffloadProvider> providers ABSL_GUARDED_BY(mutex);
+  // Set once `providers` is non-empty, to avoid locking `mutex` in the common
+  // case that no provider is registered.
+  std::atomic<bool> has_providers{false};
+};
+
+DecodeOffloadRegistry& GetDecodeOffloadRegistry() {
+  static absl::NoDestructor<DecodeOffloadRegistry> registry;
+  return *registry;
+}
+
+}  // namespace
+
+DecodeOffload::~DecodeOffload() = default;
+
+void RegisterDecodeOffloadProvider(DecodeOffloadProvider provider) {
+  auto& registry = GetDecodeOffloadRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.providers.push_back(std::move(provider));
+  registry.has_providers.store(true, std::memory_order_release);
+}
+
+bool HasDecodeOffloadProviders() {
+  return GetDecodeOffloadRegistry().has_providers.load(
+      std::memory_order_acquire);
+}
+
+DecodeOffload::Ptr GetDecodeOffload(std::string_view format,
+                                    const ::nlohmann::json& options) {
+  if (!HasDecodeOffloadProviders()) return {};
+  auto& registry = GetDecodeOffloadRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  for (const auto& provider : registry.providers) {
+    if (auto offload = provider(format, options)) return offload;
+  }
+  return {};
+}
+
+Result<std::optional<SharedArray<const uint8_t>>> DecodeWithOffload(
+    const DecodeOffload& offload, const absl::Cord& encoded,
+    DimensionIndex rank) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto decoded, offload.Decode(encoded));
+  if (!decoded) return std::optional<SharedArray<const uint8_t>>();
+  if (decoded->dtype() != dtype_v<uint8_t> || decoded->rank() != rank ||
+      !IsContiguousLayout(*decoded, c_order)) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Offloaded decode returned an array of data type ", decoded->dtype(),
+        " and rank ", decoded->rank(),
+        ", but expected a C-order contiguous uint8 array of rank ", rank));
+  }
+  return std::make_optional(
+      StaticDataTypeCast<const uint8_t, unchecked>(*std::move(decoded)));
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,98 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_DECODE_OFFLOAD_H_
+#define TENSORSTORE_INTERNAL_DECODE_OFFLOAD_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <optional>
+#include <string_view>
+
+#include "absl/strings/cord.h"
+#include <nlohmann/json_fwd.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Decoder to which decoding of a particular encoded format may be offloaded,
+/// e.g. to an accelerator such as a GPU.
+///
+/// Offloading is cooperative: `Decode` may decline any input, in which case
+/// the caller decodes it on the CPU as usual.  Chunks are decoded concurrently
+/// by the threads of the data copy executor, such that an implementation may
+/// combine concurrent calls into batches.
+///
+/// The supported formats are:
+///
+/// - `"zarr3/<name>"`, for the zarr v3 "bytes -> bytes" codec `<name>`, e.g.
+///   `"zarr3/zstd"` or `"zarr3/blosc"`.  The options are the codec
+///   configuration.  The decoded result is a one-dimensional `uint8_t` array.
+///
+/// - The id of an image driver, e.g. `"jpeg"` or `"png"`.  The options are an
+///   empty object.  The decoded result is a `uint8_t` array of shape
+///   `{height, width, num_components}`.
+class DecodeOffload : public AtomicReferenceCount<DecodeOffload> {
+ public:
+  using Ptr = IntrusivePtr<const DecodeOffload>;
+
+  virtual ~DecodeOffload();
+
+  /// Decodes `encoded`.
+  ///
+  /// \returns The decoded array, in host memory and with a C-order contiguous
+  ///     layout, or `std::nullopt` to decline.
+  virtual Result<std::optional<SharedArray<const void>>> Decode(
+      const absl::Cord& encoded) const = 0;
+};
+
+/// Returns an offload for `format` with the specified `options`, or `nullptr`
+/// if the combination is not supported.
+using DecodeOffloadProvider = std::function<DecodeOffload::Ptr(
+    std::string_view format, const ::nlohmann::json& options)>;
+
+/// Registers a provider of offloads.
+///
+/// Providers are consulted, in registration order, when a codec or driver is
+/// opened; already-open drivers are not affected.  Typically called from a
+/// static initializer.
+void RegisterDecodeOffloadProvider(DecodeOffloadProvider provider);
+
+/// Returns `true` if any provider has been registered.
+bool HasDecodeOffloadProviders();
+
+/// Returns the offload from the first registered provider that supports
+/// `format` with `options`, or `nullptr` if there is none.
+DecodeOffload::Ptr GetDecodeOffload(std::string_view format,
+                                    const ::nlohmann::json& options);
+
+/// Decodes `encoded` using `offload`, and validates that the result is a
+/// C-order contiguous `uint8_t` array of rank `rank`.
+///
+/// \returns The decoded array, or `std::nullopt` if `offload` declined.
+/// \error `absl::StatusCode::kDataLoss` if the result is not valid.
+Result<std::optional<SharedArray<const uint8_t>>> DecodeWithOffload(
+    const DecodeOffload& offload, const absl::Cord& encoded,
+    DimensionIndex rank);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_DECODE_OFFLOAD_H_
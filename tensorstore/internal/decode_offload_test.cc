@@ -0,0 +1,115 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/decode_offload.h"
+
+#include <stdint.h>
+
+#include <optional>
+#include <string_view>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::SharedArray;
+using ::tensorstore::internal::DecodeOffload;
+using ::tensorstore::internal::DecodeWithOffload;
+using ::tensorstore::internal::GetDecodeOffload;
+using ::tensorstore::internal::HasDecodeOffloadProviders;
+using ::tensorstore::internal::RegisterDecodeOffloadProvider;
+
+// Decodes each byte to its value plus `offset`, and declines empty inputs.
+class AddOffload : public DecodeOffload {
+ public:
+  explicit AddOffload(int offset) : offset_(offset) {}
+
+  Result<std::optional<SharedArray<const void>>> Decode(
+      const absl::Cord& encoded) const override {
+    if (encoded.empty()) return std::optional<SharedArray<const void>>();
+    auto decoded = tensorstore::AllocateArray<uint8_t>(
+        {static_cast<tensorstore::Index>(encoded.size())});
+    uint8_t* out = decoded.data();
+    for (char c : encoded.Chars()) {
+      *out++ = static_cast<uint8_t>(c + offset_);
+    }
+    return std::make_optional<SharedArray<const void>>(decoded);
+  }
+
+ private:
+  int offset_;
+};
+
+void RegisterTestProvider() {
+  static bool registered = [] {
+    RegisterDecodeOffloadProvider(
+        [](std::string_view format,
+           const ::nlohmann::json& options) -> DecodeOffload::Ptr {
+          if (format != "test_offload") return {};
+          return tensorstore::internal::MakeIntrusivePtr<AddOffload>(
+              options.value("offset", 0));
+        });
+    return true;
+  }();
+  (void)registered;
+}
+
+TEST(DecodeOffloadTest, GetDecodeOffload) {
+  RegisterTestProvider();
+  EXPECT_TRUE(HasDecodeOffloadProviders());
+  EXPECT_FALSE(GetDecodeOffload("other", ::nlohmann::json::object_t()));
+  EXPECT_TRUE(GetDecodeOffload("test_offload", {{"offset", 1}}));
+}
+
+TEST(DecodeOffloadTest, DecodeWithOffload) {
+  RegisterTestProvider();
+  auto offload = GetDecodeOffload("test_offload", {{"offset", 1}});
+  ASSERT_TRUE(offload);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto decoded, DecodeWithOffload(*offload, absl::Cord("abc"), 1));
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(tensorstore::MakeArray<uint8_t>({'b', 'c', 'd'}), *decoded);
+}
+
+TEST(DecodeOffloadTest, Declined) {
+  RegisterTestProvider();
+  auto offload = GetDecodeOffload("test_offload", ::nlohmann::json::object_t());
+  ASSERT_TRUE(offload);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto decoded, DecodeWithOffload(*offload, absl::Cord(), 1));
+  EXPECT_FALSE(decoded);
+}
+
+TEST(DecodeOffloadTest, InvalidResult) {
+  RegisterTestProvider();
+  auto offload = GetDecodeOffload("test_offload", ::nlohmann::json::object_t());
+  ASSERT_TRUE(offload);
+  EXPECT_THAT(DecodeWithOffload(*offload, absl::Cord("abc"), 3),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Offloaded decode returned .*"));
+}
+
+}  // namespace
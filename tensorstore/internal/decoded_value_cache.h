@@ -0,0 +1,107 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_DECODED_VALUE_CACHE_H_
+#define TENSORSTORE_INTERNAL_DECODED_VALUE_CACHE_H_
+
+/// \file
+///
+/// Memoization of values decoded from an encoded string representation, such
+/// as driver metadata parsed from JSON.
+
+#include <stddef.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Bounded, thread-safe cache of immutable values of type `T` keyed by their
+/// encoded representation, with least-recently-used eviction.
+///
+/// Since the decoded values are shared, `T` must not be modified after it is
+/// inserted.  Decoding errors are not cached.
+template <typename T>
+class DecodedValueCache {
+ public:
+  using Pointer = std::shared_ptr<const T>;
+
+  /// Constructs a cache that holds at most `max_entries` values, each with an
+  /// encoded representation of at most `max_encoded_size` bytes.
+  explicit DecodedValueCache(size_t max_entries,
+                             size_t max_encoded_size = 64 * 1024)
+      : max_entries_(max_entries), max_encoded_size_(max_encoded_size) {}
+
+  /// Returns the value cached for `encoded`, or `nullptr` if there is none.
+  Pointer Find(std::string_view encoded) {
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(encoded);
+    if (it == index_.end()) return nullptr;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+
+  /// Inserts `value` as the value for `encoded`, evicting the least-recently
+  /// used entry if the cache is full.
+  void Insert(std::string_view encoded, Pointer value) {
+    if (max_entries_ == 0 || encoded.size() > max_encoded_size_) return;
+    absl::MutexLock lock(&mutex_);
+    if (index_.find(encoded) != index_.end()) return;
+    if (entries_.size() == max_entries_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    entries_.emplace_front(std::string(encoded), std::move(value));
+    index_.emplace(entries_.front().first, entries_.begin());
+  }
+
+  /// Returns the cached value for `encoded`, or otherwise the result of
+  /// `decode()`, which is inserted into the cache if successful.
+  ///
+  /// \param decode Function with signature `Result<Pointer> ()`, called
+  ///     without holding the lock.
+  template <typename Decode>
+  Result<Pointer> GetOrDecode(std::string_view encoded, Decode decode) {
+    if (auto value = Find(encoded)) return value;
+    Result<Pointer> value = decode();
+    if (value.ok()) Insert(encoded, *value);
+    return value;
+  }
+
+ private:
+  using Entry = std::pair<std::string, Pointer>;
+
+  size_t max_entries_;
+  size_t max_encoded_size_;
+  absl::Mutex mutex_;
+  // Ordered from most to least recently used.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // Keys refer to the strings owned by `entries_`.
+  absl::flat_hash_map<std::string_view, typename std::list<Entry>::iterator>
+      index_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_DECODED_VALUE_CACHE_H_
@@ -0,0 +1,82 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/decoded_value_cache.h"
+
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::internal::DecodedValueCache;
+
+using Cache = DecodedValueCache<std::string>;
+
+TEST(DecodedValueCacheTest, GetOrDecode) {
+  Cache cache(2);
+  int num_decodes = 0;
+  auto decode = [&](std::string value) {
+    return [&num_decodes, value]() -> Result<Cache::Pointer> {
+      ++num_decodes;
+      return std::make_shared<const std::string>(value);
+    };
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto a, cache.GetOrDecode("a", decode("A")));
+  EXPECT_EQ("A", *a);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto a2,
+                                   cache.GetOrDecode("a", decode("X")));
+  EXPECT_EQ(a, a2);
+  EXPECT_EQ(1, num_decodes);
+
+  // Inserting "c" evicts "b", the least recently used entry.
+  TENSORSTORE_ASSERT_OK(cache.GetOrDecode("b", decode("B")));
+  EXPECT_TRUE(cache.Find("a"));
+  TENSORSTORE_ASSERT_OK(cache.GetOrDecode("c", decode("C")));
+  EXPECT_EQ(3, num_decodes);
+  EXPECT_TRUE(cache.Find("a"));
+  EXPECT_FALSE(cache.Find("b"));
+  EXPECT_TRUE(cache.Find("c"));
+}
+
+TEST(DecodedValueCacheTest, ErrorNotCached) {
+  Cache cache(2);
+  EXPECT_THAT(cache.GetOrDecode("a",
+                                []() -> Result<Cache::Pointer> {
+                                  return absl::DataLossError("Invalid");
+                                }),
+              MatchesStatus(absl::StatusCode::kDataLoss, "Invalid"));
+  EXPECT_FALSE(cache.Find("a"));
+}
+
+TEST(DecodedValueCacheTest, Limits) {
+  Cache cache(/*max_entries=*/2, /*max_encoded_size=*/3);
+  cache.Insert("abcd", std::make_shared<const std::string>("x"));
+  EXPECT_FALSE(cache.Find("abcd"));
+  cache.Insert("abc", std::make_shared<const std::string>("x"));
+  EXPECT_TRUE(cache.Find("abc"));
+
+  Cache disabled(0);
+  disabled.Insert("a", std::make_shared<const std::string>("x"));
+  EXPECT_FALSE(disabled.Find("a"));
+}
+
+}  // namespace
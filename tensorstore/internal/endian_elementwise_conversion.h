@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <array>
 #include <string_view>
+#include <type_traits>
 
 #include "absl/status/status.h"
 #include "tensorstore/index.h"
@@ -27,6 +28,7 @@
 #include "tensorstore/internal/riegeli/delimited.h"
 #include "tensorstore/internal/riegeli/json_input.h"
 #include "tensorstore/internal/riegeli/json_output.h"
+#include "tensorstore/internal/vectorized_conversion.h"
 #include "tensorstore/util/endian.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
@@ -55,6 +57,24 @@ struct SwapEndianUnalignedLoopImpl {
     SwapEndianUnaligned<SubElementSize, NumSubElements>(source, target);
   }
 
+  // Contiguous arrays that require byte swapping are handled by vectorized
+  // kernels.
+  template <size_t S = SubElementSize>
+  static std::enable_if_t<(S > 1), Index> ApplyContiguous(Index count,
+                                                          UnalignedValue* value,
+                                                          void* arg) {
+    SwapEndianContiguous<S>(value, value, count * NumSubElements);
+    return count;
+  }
+
+  template <size_t S = SubElementSize>
+  static std::enable_if_t<(S > 1), Index> ApplyContiguous(
+      Index count, const UnalignedValue* source, UnalignedValue* target,
+      void* arg) {
+    SwapEndianContiguous<S>(source, target, count * NumSubElements);
+    return count;
+  }
+
   using InplaceLoopImpl = internal_elementwise_function::SimpleLoopTemplate<
       SwapEndianUnalignedLoopImpl<SubElementSize, NumSubElements>(
           UnalignedValue),
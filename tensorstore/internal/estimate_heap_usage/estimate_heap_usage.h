@@ -96,15 +96,26 @@ struct HeapUsageEstimator<T, std::enable_if_t<SupportsApplyMembers<T>>> {
 template <>
 struct HeapUsageEstimator<std::string> {
   static size_t EstimateHeapUsage(const std::string& x, size_t max_depth) {
-    // FIXME: include heap allocation overhead
-    return x.capacity();
+    // Short strings are stored inline and use no heap memory.
+    const char* data = x.data();
+    if (data >= reinterpret_cast<const char*>(&x) &&
+        data < reinterpret_cast<const char*>(&x + 1)) {
+      return 0;
+    }
+    // Include the terminating null character.
+    return x.capacity() + 1;
   }
 };
 
 template <>
 struct HeapUsageEstimator<absl::Cord> {
   static size_t EstimateHeapUsage(const absl::Cord& x, size_t max_depth) {
-    return x.size();
+    // Includes the tree nodes and the unused capacity of flat chunks.  Chunks
+    // shared with other cords, such as sub-cords of a single kvstore read, are
+    // divided among the cords that reference them, so that they are not
+    // counted once per reference.
+    return x.EstimatedMemoryUsage(absl::CordMemoryAccounting::kFairShare) -
+           sizeof(absl::Cord);
   }
 };
 
@@ -114,7 +125,7 @@ struct PointerHeapUsageEstimator {
     if (!x) return 0;
     size_t total = sizeof(*x);
     if (max_depth > 0) {
-      total += internal::EstimateHeapUsage(*x);
+      total += internal::EstimateHeapUsage(*x, max_depth - 1);
     }
     return total;
   }
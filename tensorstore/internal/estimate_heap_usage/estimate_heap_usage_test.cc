@@ -43,12 +43,25 @@ TEST(EstimateHeapUsageTest, Trivial) {
 
 TEST(EstimateHeapUsageTest, String) {
   std::string s(1000, 'x');
-  EXPECT_EQ(s.capacity(), EstimateHeapUsage(s));
+  EXPECT_EQ(s.capacity() + 1, EstimateHeapUsage(s));
+  EXPECT_EQ(0, EstimateHeapUsage(std::string("a")));
 }
 
 TEST(EstimateHeapUsageTest, Cord) {
   auto cord = absl::Cord(std::string(1000, 'x'));
-  EXPECT_EQ(cord.size(), EstimateHeapUsage(cord));
+  EXPECT_EQ(cord.EstimatedMemoryUsage() - sizeof(absl::Cord),
+            EstimateHeapUsage(cord));
+  EXPECT_LE(cord.size(), EstimateHeapUsage(cord));
+  EXPECT_EQ(0, EstimateHeapUsage(absl::Cord("a")));
+}
+
+TEST(EstimateHeapUsageTest, SharedCord) {
+  auto cord = absl::Cord(std::string(1000, 'x'));
+  const size_t unshared = EstimateHeapUsage(cord);
+  auto copy = cord;
+  // Shared chunks are divided between the cords that reference them.
+  EXPECT_LT(EstimateHeapUsage(cord), unshared);
+  EXPECT_LT(EstimateHeapUsage(copy), unshared);
 }
 
 TEST(EstimateHeapUsageTest, Optional) {
@@ -56,7 +69,7 @@ TEST(EstimateHeapUsageTest, Optional) {
   EXPECT_EQ(0, EstimateHeapUsage(std::optional<int>(42)));
   EXPECT_EQ(0, EstimateHeapUsage(std::optional<std::string>()));
   auto o = std::optional<std::string>(std::in_place, 1000, 'x');
-  EXPECT_EQ(o->capacity(), EstimateHeapUsage(o));
+  EXPECT_EQ(o->capacity() + 1, EstimateHeapUsage(o));
 }
 
 TEST(EstimateHeapUsageTest, UniquePtr) {
@@ -89,8 +102,8 @@ TEST(EstimateHeapUsageTest, Vector) {
   std::vector<std::string> v;
   v.push_back(std::string(1000, 'x'));
   v.push_back(std::string(5000, 'x'));
-  size_t expected =
-      v[0].capacity() + v[1].capacity() + v.capacity() * sizeof(std::string);
+  size_t expected = v[0].capacity() + v[1].capacity() + 2 +
+                    v.capacity() * sizeof(std::string);
   EXPECT_EQ(expected, EstimateHeapUsage(v));
   EXPECT_EQ(v.capacity() * sizeof(std::string), EstimateHeapUsage(v, 0));
 }
@@ -100,8 +113,8 @@ TEST(EstimateHeapUsageTest, Composite) {
   v = std::vector<std::string>({"a", "b"});
   {
     auto& string_vec = std::get<std::vector<std::string>>(v);
-    EXPECT_EQ(string_vec.capacity() * sizeof(std::string) +
-                  string_vec[0].capacity() + string_vec[1].capacity(),
+    // Short strings are stored inline.
+    EXPECT_EQ(string_vec.capacity() * sizeof(std::string),
               EstimateHeapUsage(v));
     EXPECT_EQ(string_vec.capacity() * sizeof(std::string),
               EstimateHeapUsage(v, /*max_depth=*/0));
@@ -117,7 +130,7 @@ TEST(EstimateHeapUsageTest, Composite) {
 TEST(EstimateHeapUsageTest, Tuple) {
   auto t = std::tuple{std::string(1000, 'x'), std::string(5000, 'x')};
   auto& [s0, s1] = t;
-  EXPECT_EQ(s0.capacity() + s1.capacity(), EstimateHeapUsage(t));
+  EXPECT_EQ(s0.capacity() + s1.capacity() + 2, EstimateHeapUsage(t));
 }
 
 TEST(EstimateHeapUsageTest, Variant) {
@@ -126,7 +139,7 @@ TEST(EstimateHeapUsageTest, Variant) {
   EXPECT_EQ(0, EstimateHeapUsage(Variant(5)));
   std::string s(1000, 'x');
   size_t capacity = s.capacity();
-  EXPECT_EQ(capacity, EstimateHeapUsage(Variant(std::move(s))));
+  EXPECT_EQ(capacity + 1, EstimateHeapUsage(Variant(std::move(s))));
 }
 
 }  // namespace
@@ -35,38 +35,18 @@
 namespace tensorstore {
 namespace internal {
 
-absl::Status GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys(
-    const internal_grid_partition::IndexTransformGridPartition& grid_partition,
-    IndexTransformView<> transform,
-    span<const DimensionIndex> grid_output_dimensions,
-    internal_grid_partition::OutputToGridCellFn output_to_grid_cell,
-    BoxView<> grid_bounds,
+namespace {
+
+absl::Status GetChunkKeyRangesForGridCellRange(
+    BoxView<> range, BoxView<> grid_bounds,
     const LexicographicalGridIndexKeyFormatter& key_formatter,
+    absl::FunctionRef<Index(DimensionIndex dim)>
+        get_min_grid_index_for_lexicographical_order,
     absl::FunctionRef<absl::Status(std::string key,
                                    span<const Index> grid_indices)>
         handle_key,
     absl::FunctionRef<absl::Status(KeyRange key_range, BoxView<> grid_bounds)>
         handle_key_range) {
-  Box<dynamic_rank(kMaxRank)> grid_bounds_copy(grid_bounds);
-  assert(grid_output_dimensions.size() == grid_bounds.rank());
-
-  // Cache of last computed value for
-  // `min_grid_index_for_lexicographical_order`.  In practice will only be
-  // computed for a single dimension.
-  DimensionIndex cached_min_grid_index_for_lexicographical_order_dim = -1;
-  Index cached_min_grid_index_for_lexicographical_order;
-
-  const auto get_min_grid_index_for_lexicographical_order =
-      [&](DimensionIndex dim) {
-        if (dim == cached_min_grid_index_for_lexicographical_order_dim) {
-          return cached_min_grid_index_for_lexicographical_order;
-        }
-        cached_min_grid_index_for_lexicographical_order_dim = dim;
-        return cached_min_grid_index_for_lexicographical_order =
-                   key_formatter.MinGridIndexForLexicographicalOrder(
-                       dim, grid_bounds[dim]);
-      };
-
   const auto forward_bounds =
       [&](BoxView<> bounds, DimensionIndex outer_prefix_rank) -> absl::Status {
     if (bounds.num_elements() == 1) {
@@ -92,55 +72,95 @@ absl::Status GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys(
         bounds);
   };
 
-  const auto handle_interval = [&](BoxView<> bounds) -> absl::Status {
-    // Find first dimension of `bounds` where size is not 1.
-    DimensionIndex outer_prefix_rank = 0;
-    while (outer_prefix_rank < bounds.rank() &&
-           bounds.shape()[outer_prefix_rank] == 1) {
-      ++outer_prefix_rank;
-    }
+  // Find first dimension of `range` where size is not 1.
+  DimensionIndex outer_prefix_rank = 0;
+  while (outer_prefix_rank < range.rank() &&
+         range.shape()[outer_prefix_rank] == 1) {
+    ++outer_prefix_rank;
+  }
+
+  // Check if `outer_prefix_rank` dimension is unconstrained.
+  if (outer_prefix_rank == range.rank() ||
+      range[outer_prefix_rank] == grid_bounds[outer_prefix_rank]) {
+    return forward_bounds(range, outer_prefix_rank);
+  }
+
+  // Keys must be restricted by `inner_interval`.
+
+  // Check if a portion of the indices in `inner_interval` need to be split
+  // off individually due to lexicographical order / numerical order mismatch.
+  const Index min_index_for_lexicographical_order =
+      get_min_grid_index_for_lexicographical_order(outer_prefix_rank);
+
+  if (min_index_for_lexicographical_order <=
+      range.origin()[outer_prefix_rank]) {
+    // Entire box is a single lexicographical range.
+    return forward_bounds(range, outer_prefix_rank);
+  }
+
+  Box<dynamic_rank(kMaxRank)> new_bounds(range);
+  IndexInterval inner_interval = range[outer_prefix_rank];
+  while (!inner_interval.empty() && inner_interval.inclusive_min() <
+                                        min_index_for_lexicographical_order) {
+    // Split off each `inner_interval.inclusive_min()` value into a separate
+    // key range.
+    new_bounds[outer_prefix_rank] =
+        IndexInterval::UncheckedSized(inner_interval.inclusive_min(), 1);
+    TENSORSTORE_RETURN_IF_ERROR(
+        forward_bounds(new_bounds, outer_prefix_rank + 1));
+    inner_interval = IndexInterval::UncheckedClosed(
+        inner_interval.inclusive_min() + 1, inner_interval.inclusive_max());
+  }
+  if (inner_interval.empty()) return absl::OkStatus();
+
+  // The remaining interval has both bounds greater or equal to
+  // `min_index_for_lexicographical_order`, and therefore it can be handled
+  // with a single key range.
+  new_bounds[outer_prefix_rank] = inner_interval;
+  return forward_bounds(new_bounds, inner_interval.size() == 1
+                                        ? outer_prefix_rank + 1
+                                        : outer_prefix_rank);
+}
 
-    // Check if `outer_prefix_rank` dimension is unconstrained.
-    if (outer_prefix_rank == bounds.rank() ||
-        bounds[outer_prefix_rank] == grid_bounds[outer_prefix_rank]) {
-      return forward_bounds(bounds, outer_prefix_rank);
-    }
+}  // namespace
 
-    // Keys must be restricted by `inner_interval`.
+absl::Status GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys(
+    const internal_grid_partition::IndexTransformGridPartition& grid_partition,
+    IndexTransformView<> transform,
+    span<const DimensionIndex> grid_output_dimensions,
+    internal_grid_partition::OutputToGridCellFn output_to_grid_cell,
+    BoxView<> grid_bounds,
+    const LexicographicalGridIndexKeyFormatter& key_formatter,
+    absl::FunctionRef<absl::Status(std::string key,
+                                   span<const Index> grid_indices)>
+        handle_key,
+    absl::FunctionRef<absl::Status(KeyRange key_range, BoxView<> grid_bounds)>
+        handle_key_range) {
+  Box<dynamic_rank(kMaxRank)> grid_bounds_copy(grid_bounds);
+  assert(grid_output_dimensions.size() == grid_bounds.rank());
 
-    // Check if a portion of the indices in `inner_interval` need to be split
-    // off individually due to lexicographical order / numerical order mismatch.
-    const Index min_index_for_lexicographical_order =
-        get_min_grid_index_for_lexicographical_order(outer_prefix_rank);
+  // Cache of last computed value for
+  // `min_grid_index_for_lexicographical_order`.  In practice will only be
+  // computed for a single dimension.
+  DimensionIndex cached_min_grid_index_for_lexicographical_order_dim = -1;
+  Index cached_min_grid_index_for_lexicographical_order;
 
-    if (min_index_for_lexicographical_order <=
-        bounds.origin()[outer_prefix_rank]) {
-      // Entire box is a single lexicographical range.
-      return forward_bounds(bounds, outer_prefix_rank);
-    }
+  const auto get_min_grid_index_for_lexicographical_order =
+      [&](DimensionIndex dim) {
+        if (dim == cached_min_grid_index_for_lexicographical_order_dim) {
+          return cached_min_grid_index_for_lexicographical_order;
+        }
+        cached_min_grid_index_for_lexicographical_order_dim = dim;
+        return cached_min_grid_index_for_lexicographical_order =
+                   key_formatter.MinGridIndexForLexicographicalOrder(
+                       dim, grid_bounds[dim]);
+      };
 
-    Box<dynamic_rank(kMaxRank)> new_bounds(bounds);
-    IndexInterval inner_interval = bounds[outer_prefix_rank];
-    while (!inner_interval.empty() && inner_interval.inclusive_min() <
-                                          min_index_for_lexicographical_order) {
-      // Split off each `inner_interval.inclusive_min()` value into a separate
-      // key range.
-      new_bounds[outer_prefix_rank] =
-          IndexInterval::UncheckedSized(inner_interval.inclusive_min(), 1);
-      TENSORSTORE_RETURN_IF_ERROR(
-          forward_bounds(new_bounds, outer_prefix_rank + 1));
-      inner_interval = IndexInterval::UncheckedClosed(
-          inner_interval.inclusive_min() + 1, inner_interval.inclusive_max());
-    }
-    if (inner_interval.empty()) return absl::OkStatus();
-
-    // The remaining interval has both bounds greater or equal to
-    // `min_index_for_lexicographical_order`, and therefore it can be handled
-    // with a single key range.
-    new_bounds[outer_prefix_rank] = inner_interval;
-    return forward_bounds(new_bounds, inner_interval.size() == 1
-                                          ? outer_prefix_rank + 1
-                                          : outer_prefix_rank);
+  const auto handle_interval = [&](BoxView<> bounds) -> absl::Status {
+    return GetChunkKeyRangesForGridCellRange(
+        bounds, grid_bounds, key_formatter,
+        get_min_grid_index_for_lexicographical_order, handle_key,
+        handle_key_range);
   };
 
   return internal_grid_partition::GetGridCellRanges(
@@ -148,5 +168,23 @@ absl::Status GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys(
       transform, handle_interval);
 }
 
+absl::Status GetChunkKeyRangesForGridCellRangeWithSemiLexicographicalKeys(
+    BoxView<> bounds, BoxView<> grid_bounds,
+    const LexicographicalGridIndexKeyFormatter& key_formatter,
+    absl::FunctionRef<absl::Status(std::string key,
+                                   span<const Index> grid_indices)>
+        handle_key,
+    absl::FunctionRef<absl::Status(KeyRange key_range, BoxView<> grid_bounds)>
+        handle_key_range) {
+  assert(bounds.rank() == grid_bounds.rank());
+  return GetChunkKeyRangesForGridCellRange(
+      bounds, grid_bounds, key_formatter,
+      [&](DimensionIndex dim) {
+        return key_formatter.MinGridIndexForLexicographicalOrder(
+            dim, grid_bounds[dim]);
+      },
+      handle_key, handle_key_range);
+}
+
 }  // namespace internal
 }  // namespace tensorstore
@@ -80,6 +80,31 @@ absl::Status GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys(
     absl::FunctionRef<absl::Status(KeyRange key_range, BoxView<> grid_bounds)>
         handle_key_range);
 
+// Computes the set of keys and key ranges specifying the grid cells within
+// `bounds`.
+//
+// This is the same computation performed by
+// `GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys` for each range
+// of grid cells, and is useful for subdividing a range passed to
+// `handle_key_range`.
+//
+// Args:
+//   bounds: Range of grid cells.  At most one dimension `i` may satisfy both
+//     `bounds[i].size() != 1` and `bounds[i] != grid_bounds[i]`, and all
+//     dimensions after it must satisfy `bounds[i] == grid_bounds[i]`.
+//   grid_bounds: Range of grid indices along each grid dimension.
+//   key_formatter: Specifies the key format.
+//   handle_key: Callback invoked for individual chunk keys.
+//   handle_key_range: Callback invoked for chunk key ranges.
+absl::Status GetChunkKeyRangesForGridCellRangeWithSemiLexicographicalKeys(
+    BoxView<> bounds, BoxView<> grid_bounds,
+    const LexicographicalGridIndexKeyFormatter& key_formatter,
+    absl::FunctionRef<absl::Status(std::string key,
+                                   span<const Index> grid_indices)>
+        handle_key,
+    absl::FunctionRef<absl::Status(KeyRange key_range, BoxView<> grid_bounds)>
+        handle_key_range);
+
 }  // namespace internal
 }  // namespace tensorstore
 
@@ -38,6 +38,7 @@
 #include "tensorstore/util/division.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
 
 namespace {
 
@@ -264,4 +265,33 @@ TEST(ChunkKeyRangesTest, Rank2ConstrainedSecondDimOnly) {
                         Box<>{{4, 1}, {1, 7}}})));
 }
 
+
+TEST(ChunkKeyRangesTest, GridCellRange) {
+  // Grid dimension 0 has range [0, 20), such that indices in [0, 10) are not
+  // ordered lexicographically.
+  std::vector<R> ranges;
+  TENSORSTORE_EXPECT_OK(
+      tensorstore::internal::
+          GetChunkKeyRangesForGridCellRangeWithSemiLexicographicalKeys(
+              /*bounds=*/Box<>({8, 0}, {4, 5}),
+              /*grid_bounds=*/Box<>({0, 0}, {20, 5}),
+              Base10LexicographicalGridIndexKeyParser{2, '/'},
+              [&](std::string key,
+                  span<const Index> grid_indices) -> absl::Status {
+                ranges.emplace_back(
+                    KeyRange::Singleton(key),
+                    Box<>(grid_indices,
+                          std::vector<Index>(grid_indices.size(), 1)));
+                return absl::OkStatus();
+              },
+              [&](KeyRange key_range, BoxView<> grid_bounds) -> absl::Status {
+                ranges.emplace_back(std::move(key_range), grid_bounds);
+                return absl::OkStatus();
+              }));
+  EXPECT_THAT(ranges,
+              ElementsAre(R{KeyRange::Prefix("8/"), Box<>({8, 0}, {1, 5})},
+                          R{KeyRange::Prefix("9/"), Box<>({9, 0}, {1, 5})},
+                          R{KeyRange("10/", "110"), Box<>({10, 0}, {2, 5})}));
+}
+
 }  // namespace
@@ -32,11 +32,13 @@
 #include "tensorstore/index_space/internal/transform_rep.h"
 #include "tensorstore/index_space/output_index_map.h"
 #include "tensorstore/index_space/output_index_method.h"
+#include "tensorstore/internal/arena.h"
 #include "tensorstore/internal/grid_partition_impl.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/util/dimension_set.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -54,6 +56,10 @@ using ::tensorstore::internal_index_space::TransformRep;
 using IndexArraySet = IndexTransformGridPartition::IndexArraySet;
 using StridedSet = IndexTransformGridPartition::StridedSet;
 
+/// Size of the stack buffer used for temporary allocations by
+/// `PrePartitionIndexTransformOverGrid`.
+constexpr size_t kArenaBufferSize = 8 * 1024;
+
 struct ConnectedSetIterateParameters {
   const IndexTransformGridPartition& info;
   span<const DimensionIndex> grid_output_dimensions;
@@ -487,9 +493,14 @@ absl::Status PartitionIndexTransformOverGrid(
     absl::FunctionRef<absl::Status(span<const Index> grid_cell_indices,
                                    IndexTransformView<> cell_transform)>
         func) {
+  // Temporary data for the duration of the partitioning is allocated from the
+  // stack when possible, since this is called once per read or write.
+  unsigned char arena_buffer[internal_grid_partition::kArenaBufferSize];
+  internal::Arena arena(arena_buffer);
   internal_grid_partition::IndexTransformGridPartition partition_info;
   auto status = internal_grid_partition::PrePartitionIndexTransformOverGrid(
-      transform, grid_output_dimensions, output_to_grid_cell, partition_info);
+      transform, grid_output_dimensions, output_to_grid_cell, partition_info,
+      &arena);
 
   if (!status.ok()) return status;
   return internal_grid_partition::ConnectedSetIterateHelper(
@@ -501,6 +512,45 @@ absl::Status PartitionIndexTransformOverGrid(
       .Iterate();
 }
 
+bool GetSingleRegularGridCell(span<const DimensionIndex> grid_output_dimensions,
+                              span<const Index> grid_cell_shape,
+                              IndexTransformView<> transform,
+                              span<Index> grid_cell_indices) {
+  assert(grid_cell_shape.size() == grid_output_dimensions.size());
+  assert(grid_cell_indices.size() == grid_output_dimensions.size());
+  const BoxView<> input_domain = transform.domain().box();
+  for (DimensionIndex input_dim = 0; input_dim < input_domain.rank();
+       ++input_dim) {
+    const IndexInterval interval = input_domain[input_dim];
+    if (interval.empty() || !IsFinite(interval)) return false;
+  }
+  const auto output_index_maps = transform.output_index_maps();
+  for (DimensionIndex grid_dim = 0; grid_dim < grid_output_dimensions.size();
+       ++grid_dim) {
+    const auto map = output_index_maps[grid_output_dimensions[grid_dim]];
+    IndexInterval range;
+    switch (map.method()) {
+      case OutputIndexMethod::constant:
+        range = IndexInterval::UncheckedSized(map.offset(), 1);
+        break;
+      case OutputIndexMethod::single_input_dimension: {
+        auto result = GetAffineTransformRange(
+            input_domain[map.input_dimension()], map.offset(), map.stride());
+        if (!result.ok()) return false;
+        range = *result;
+        break;
+      }
+      case OutputIndexMethod::array:
+        return false;
+    }
+    const Index cell_size = grid_cell_shape[grid_dim];
+    const Index cell = FloorOfRatio(range.inclusive_min(), cell_size);
+    if (FloorOfRatio(range.inclusive_max(), cell_size) != cell) return false;
+    grid_cell_indices[grid_dim] = cell;
+  }
+  return true;
+}
+
 absl::Status PartitionIndexTransformOverRegularGrid(
     span<const DimensionIndex> grid_output_dimensions,
     span<const Index> grid_cell_shape, IndexTransformView<> transform,
@@ -509,8 +559,22 @@ absl::Status PartitionIndexTransformOverRegularGrid(
         func) {
   assert(grid_cell_shape.size() == grid_output_dimensions.size());
   internal_grid_partition::RegularGridRef grid{grid_cell_shape};
-  return PartitionIndexTransformOverGrid(grid_output_dimensions, grid,
-                                         transform, std::move(func));
+  unsigned char arena_buffer[internal_grid_partition::kArenaBufferSize];
+  internal::Arena arena(arena_buffer);
+  internal_grid_partition::IndexTransformGridPartition partition_info;
+  // Reads and writes with the same index arrays are common (e.g. repeatedly
+  // reading the same points), so the index array partitioning is cached.
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal_grid_partition::PrePartitionIndexTransformOverRegularGrid(
+          transform, grid_output_dimensions, grid_cell_shape, partition_info,
+          &arena, &internal_grid_partition::IndexArraySetCache::Global()));
+  return internal_grid_partition::ConnectedSetIterateHelper(
+             {/*.info=*/partition_info,
+              /*.grid_output_dimensions=*/grid_output_dimensions,
+              /*.output_to_grid_cell=*/grid,
+              /*.transform=*/transform,
+              /*.func=*/std::move(func)})
+      .Iterate();
 }
 
 }  // namespace internal
@@ -684,11 +748,13 @@ absl::Status GetGridCellRanges(
     return callback({});
   }
 
+  unsigned char arena_buffer[internal_grid_partition::kArenaBufferSize];
+  internal::Arena arena(arena_buffer);
   internal_grid_partition::IndexTransformGridPartition grid_partition;
   TENSORSTORE_RETURN_IF_ERROR(
       internal_grid_partition::PrePartitionIndexTransformOverGrid(
           transform, grid_output_dimensions, output_to_grid_cell,
-          grid_partition));
+          grid_partition, &arena));
   return internal_grid_partition::GetGridCellRanges(
       grid_partition, grid_output_dimensions, grid_bounds, output_to_grid_cell,
       transform, callback);
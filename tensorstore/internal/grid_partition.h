@@ -135,6 +135,31 @@ absl::Status PartitionIndexTransformOverRegularGrid(
                                    IndexTransformView<> cell_transform)>
         func);
 
+/// Checks if the range of `transform` lies within a single cell of the
+/// specified regular grid, as is typical of point and other small reads.
+///
+/// If this returns `true`, `PartitionIndexTransformOverRegularGrid` would
+/// invoke its callback exactly once, with the `grid_cell_indices` computed by
+/// this function and a `cell_transform` equal to
+/// `IdentityTransform(transform.domain().box())`.  Callers may therefore skip
+/// the partitioning, which is comparatively expensive for such small requests.
+///
+/// Returns `false` if a grid dimension depends on an index array, if the
+/// domain of `transform` is empty or unbounded, or if the range spans
+/// multiple grid cells.
+///
+/// \param grid_output_dimensions The sequence of dimensions of the index space
+///     "output" corresponding to the grid.
+/// \param grid_cell_shape The shape of a grid cell.
+/// \param transform The index transform from "full" to "output".  Must be
+///     valid.
+/// \param grid_cell_indices[out] Set to the grid cell indices on success.
+/// \dchecks `grid_cell_indices.size() == grid_output_dimensions.size()`
+bool GetSingleRegularGridCell(span<const DimensionIndex> grid_output_dimensions,
+                              span<const Index> grid_cell_shape,
+                              IndexTransformView<> transform,
+                              span<Index> grid_cell_indices);
+
 /// Partitions the input domain of a given `transform` from an input space
 /// "full" to an output space "output" based on potentially irregular grid
 /// specified by `output_to_grid_cell`, which maps from a given dimension and
@@ -18,14 +18,17 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/base/no_destructor.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/functional/function_ref.h"
 #include "absl/hash/hash.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
 #include "tensorstore/index.h"
@@ -34,14 +37,15 @@
 #include "tensorstore/index_space/internal/transform_rep.h"
 #include "tensorstore/index_space/output_index_map.h"
 #include "tensorstore/index_space/output_index_method.h"
+#include "tensorstore/internal/arena.h"
 #include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/util/byte_strided_pointer.h"
 #include "tensorstore/util/dimension_set.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/iterate.h"
-#include "tensorstore/util/iterate_over_index_range.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
@@ -194,6 +198,10 @@ IndexTransform<> IndexTransformGridPartition::GetCellTransform(
 
 namespace {
 
+/// Vector of temporary indices allocated from the arena supplied to
+/// `PrePartitionIndexTransformOverGrid`.
+using TempIndexVector = std::vector<Index, internal::ArenaAllocator<Index>>;
+
 /// Invokes the specified callback for each connected sets of input and grid
 /// dimensions of an index transform.
 ///
@@ -477,19 +485,21 @@ Result<Index> ProductOfIndirectExtents(span<const Index> input_shape,
 /// \param index_transform The index transform.
 /// \param num_positions The product of `index_transform.input_size(d)` for `d`
 ///     in `input_dims`.
-/// \returns A vector representing a row-major array of shape
+/// \param temp_output_indices[out] Set to a row-major array of shape
+///     `{num_positions, grid_dims.count()}` containing the partial output index
+///     vectors for each input position.
+/// \param temp_cell_indices[out] Set to a row-major array of shape
 ///     `{num_positions, grid_dims.count()}` containing the partial grid cell
 ///     index vectors for each input position.
-Result<std::vector<Index>> GenerateIndexArraySetGridCellIndices(
+absl::Status GenerateIndexArraySetGridCellIndices(
     DimensionSet grid_dims, DimensionSet input_dims,
     span<const DimensionIndex> grid_output_dimensions,
     OutputToGridCellFn output_to_grid_cell,
-    IndexTransformView<> index_transform, Index num_positions) {
+    IndexTransformView<> index_transform, Index num_positions,
+    TempIndexVector& temp_output_indices, TempIndexVector& temp_cell_indices) {
   const DimensionIndex num_grid_dims = grid_dims.count();
-  // Logically represents a row-major array of shape
-  // `{num_positions, num_grid_dims}` containing the partial grid cell index
-  // vectors for each position.
-  std::vector<Index> temp_cell_indices(num_grid_dims * num_positions);
+  temp_output_indices.resize(num_grid_dims * num_positions);
+  temp_cell_indices.resize(num_grid_dims * num_positions);
   // Loop over the grid dimensions and fill in `temp_celll_indices` with the
   // grid cell index vectors for each position.
   DimensionIndex grid_i = 0;
@@ -497,27 +507,27 @@ Result<std::vector<Index>> GenerateIndexArraySetGridCellIndices(
     const DimensionIndex output_dim = grid_output_dimensions[grid_dim];
     const OutputIndexMapRef<> map =
         index_transform.output_index_map(output_dim);
+    Index* cur_output_indices = temp_output_indices.data() + grid_i;
     Index* cur_cell_indices = temp_cell_indices.data() + grid_i;
     // First, compute the output indices for this grid dimension.  These output
     // indices will then be transformed to grid indices.
     if (map.method() == OutputIndexMethod::single_input_dimension) {
       TENSORSTORE_RETURN_IF_ERROR(GenerateSingleInputDimensionOutputIndices(
-          map, input_dims, index_transform, cur_cell_indices, num_grid_dims));
+          map, input_dims, index_transform, cur_output_indices, num_grid_dims));
     } else {
       assert(map.method() == OutputIndexMethod::array);
       TENSORSTORE_RETURN_IF_ERROR(GenerateIndexArrayOutputIndices(
-          map, input_dims, index_transform, cur_cell_indices, num_grid_dims));
+          map, input_dims, index_transform, cur_output_indices, num_grid_dims));
     }
 
     // Convert the output indices to grid cell indices
-    for (Index* end = cur_cell_indices + num_positions * num_grid_dims;
-         cur_cell_indices != end; cur_cell_indices += num_grid_dims) {
-      *cur_cell_indices =
-          output_to_grid_cell(grid_dim, *cur_cell_indices, nullptr);
+    for (Index i = 0; i < num_positions * num_grid_dims; i += num_grid_dims) {
+      cur_cell_indices[i] =
+          output_to_grid_cell(grid_dim, cur_output_indices[i], nullptr);
     }
     ++grid_i;
   }
-  return temp_cell_indices;
+  return absl::OkStatus();
 }
 
 /// Checks if two offsets into a cell indices array refer to the same cell
@@ -586,8 +596,9 @@ struct IndirectHashIndices {
   };
 };
 
-using IndirectVectorMap = absl::flat_hash_map<Index, Index, IndirectHashIndices,
-                                              IndirectIndicesEqual>;
+using IndirectVectorMap = absl::flat_hash_map<
+    Index, Index, IndirectHashIndices, IndirectIndicesEqual,
+    internal::ArenaAllocator<std::pair<const Index, Index>>>;
 
 /// Given an array `temp_cell_indices` of non-unique partial grid cell index
 /// vectors, implicitly computes a sorted version of this array (possibly
@@ -614,6 +625,7 @@ using IndirectVectorMap = absl::flat_hash_map<Index, Index, IndirectHashIndices,
 ///     of the first occurrence in the sorted array of the partial grid cell
 ///     index vector
 ///     `span(grid_cell_indices->data() + i * num_grid_dims, num_grid_dims)`.
+/// \param arena Arena used to allocate the returned hash map.
 /// \returns An IndirectVectorMap that maps each position `position_i` in the
 ///     range `[0,num_positions)`, representing the grid cell index vector
 ///     `span(temp_celll_indices + position_i * num_grid_dims, num_grid_dims)`,
@@ -632,7 +644,7 @@ using IndirectVectorMap = absl::flat_hash_map<Index, Index, IndirectHashIndices,
 IndirectVectorMap PartitionIndexArraySetGridCellIndexVectors(
     const Index* temp_cell_indices, Index num_positions, Index num_grid_dims,
     std::vector<Index>* grid_cell_indices,
-    std::vector<Index>* grid_cell_partition_offsets) {
+    std::vector<Index>* grid_cell_partition_offsets, internal::Arena* arena) {
   /// Initialize an empty hash map keyed by positions `position_i` in the range
   /// `[0,num_positions)`, corresponding to a vector:
   /// `span(temp_cell_indices + grid_dims * position_i, num_dims)`.  Two
@@ -640,7 +652,8 @@ IndirectVectorMap PartitionIndexArraySetGridCellIndexVectors(
   /// slot in the hash map.
   IndirectVectorMap cells(
       1, IndirectHashIndices{temp_cell_indices, num_grid_dims},
-      IndirectIndicesEqual{temp_cell_indices, num_grid_dims});
+      IndirectIndicesEqual{temp_cell_indices, num_grid_dims},
+      internal::ArenaAllocator<std::pair<const Index, Index>>(arena));
   // Compute the number of occurrences of each partial grid cell index vector.
   for (DimensionIndex i = 0; i < num_positions; ++i) {
     ++cells[i];
@@ -692,6 +705,11 @@ IndirectVectorMap PartitionIndexArraySetGridCellIndexVectors(
 /// `full_input_domain` specified by `input_dims`, and writes them to an array
 /// in a partitioned way according to the `cells` map.
 ///
+/// Within each partition, the input index vectors are ordered by their
+/// corresponding partial output index vectors, so that each grid cell is
+/// accessed in order of increasing position (e.g. increasing offset for a
+/// C-order chunk) rather than in the arbitrary order of the index arrays.
+///
 /// \param input_dims The list of distinct input dimensions in the subset, each
 ///     in the range `[0, full_input_domain.rank())`.
 /// \param full_input_domain The full input domain.  Only values at indices in
@@ -701,11 +719,20 @@ IndirectVectorMap PartitionIndexArraySetGridCellIndexVectors(
 ///     output array at which to write the partial input index vectors.
 /// \param num_positions The product of `input_shape[d]` for `d` in
 ///     `input_dims`.
+/// \param grid_cell_partition_offsets The starting offset of each partition.
+/// \param temp_output_indices Row-major array of shape
+///     `{num_positions, num_grid_dims}` specifying the partial output index
+///     vector for each flat input position index.
+/// \param num_grid_dims Number of grid dimensions in the connected set.
+/// \param arena Arena used for temporary allocations.
 /// \returns A newly allocated array of shape
 ///     `{num_positions, input_dims.count()}` containing the
 SharedArray<Index, 2> GenerateIndexArraySetPartitionedInputIndices(
     DimensionSet input_dims, BoxView<> full_input_domain,
-    IndirectVectorMap cells, Index num_positions) {
+    IndirectVectorMap cells, Index num_positions,
+    span<const Index> grid_cell_partition_offsets,
+    const Index* temp_output_indices, DimensionIndex num_grid_dims,
+    internal::Arena* arena) {
   const DimensionIndex num_input_dims = input_dims.count();
   Box<dynamic_rank(internal::kNumInlinedDims)> partial_input_domain(
       num_input_dims);
@@ -716,19 +743,38 @@ SharedArray<Index, 2> GenerateIndexArraySetPartitionedInputIndices(
       ++i;
     }
   }
-  SharedArray<Index, 2> partitioned_input_indices =
-      AllocateArray<Index>({num_positions, num_input_dims});
-  // Flat position index.
-  Index position_i = 0;
-  IterateOverIndexRange(partial_input_domain, [&](span<const Index> indices) {
+  // Group the flat position indices by partition.
+  TempIndexVector partitioned_positions(num_positions, arena);
+  for (Index position_i = 0; position_i < num_positions; ++position_i) {
     auto it = cells.find(position_i);
     assert(it != cells.end());
-    auto& offset = it->second;
-    std::copy(indices.begin(), indices.end(),
-              partitioned_input_indices.data() + offset * num_input_dims);
-    ++offset;
-    ++position_i;
-  });
+    partitioned_positions[it->second++] = position_i;
+  }
+  // Order the positions within each partition by output index vector.  A
+  // stable sort preserves the input order of duplicate positions.
+  const Index num_partitions = grid_cell_partition_offsets.size();
+  for (Index partition_i = 0; partition_i < num_partitions; ++partition_i) {
+    const Index begin = grid_cell_partition_offsets[partition_i];
+    const Index end = partition_i + 1 == num_partitions
+                          ? num_positions
+                          : grid_cell_partition_offsets[partition_i + 1];
+    std::stable_sort(partitioned_positions.begin() + begin,
+                     partitioned_positions.begin() + end,
+                     IndirectIndicesLess{temp_output_indices, num_grid_dims});
+  }
+  // Convert each flat position index, which corresponds to C order iteration
+  // over `partial_input_domain`, to an input index vector.
+  SharedArray<Index, 2> partitioned_input_indices =
+      AllocateArray<Index>({num_positions, num_input_dims});
+  Index* indices = partitioned_input_indices.data();
+  for (Index position_i : partitioned_positions) {
+    for (DimensionIndex i = num_input_dims - 1; i >= 0; --i) {
+      const IndexInterval interval = partial_input_domain[i];
+      indices[i] = interval.inclusive_min() + position_i % interval.size();
+      position_i /= interval.size();
+    }
+    indices += num_input_dims;
+  }
   return partitioned_input_indices;
 }
 
@@ -758,6 +804,7 @@ SharedArray<Index, 2> GenerateIndexArraySetPartitionedInputIndices(
 /// \param grid_cell_shape Array of size `grid_output_dimensions.size()`
 ///     specifying the extent of the grid cells.
 /// \param index_transform The index transform.
+/// \param arena Arena used for temporary allocations.
 /// \error `absl::StatusCode::kInvalidArgument` if integer overflow occurs.
 /// \error `absl::StatusCode::kOutOfRange` if an index array contains an
 ///     out-of-bounds index.
@@ -765,7 +812,7 @@ absl::Status FillIndexArraySetData(
     IndexTransformGridPartition::IndexArraySet& index_array_set,
     span<const DimensionIndex> grid_output_dimensions,
     OutputToGridCellFn output_to_grid_cell,
-    IndexTransformView<> index_transform) {
+    IndexTransformView<> index_transform, internal::Arena* arena) {
   // Compute the total number of distinct partial input index vectors in the
   // input domain subset.  This allows us to terminate early if it equals 0, and
   // avoids the need for computing it and checking for overflow in each of the
@@ -778,15 +825,16 @@ absl::Status FillIndexArraySetData(
     return absl::OkStatus();
   }
 
-  // Logically represents a row-major array of shape
-  // `{num_positions, grid_dims.count()}` containing the partial grid cell index
-  // vectors for each position in the input domain subset.
-  TENSORSTORE_ASSIGN_OR_RETURN(
-      std::vector<Index> temp_cell_indices,
-      GenerateIndexArraySetGridCellIndices(
-          index_array_set.grid_dimensions, index_array_set.input_dimensions,
-          grid_output_dimensions, output_to_grid_cell, index_transform,
-          num_positions));
+  // Logically represent row-major arrays of shape
+  // `{num_positions, grid_dims.count()}` containing the partial output index
+  // vectors and partial grid cell index vectors, respectively, for each
+  // position in the input domain subset.
+  TempIndexVector temp_output_indices(arena);
+  TempIndexVector temp_cell_indices(arena);
+  TENSORSTORE_RETURN_IF_ERROR(GenerateIndexArraySetGridCellIndices(
+      index_array_set.grid_dimensions, index_array_set.input_dimensions,
+      grid_output_dimensions, output_to_grid_cell, index_transform,
+      num_positions, temp_output_indices, temp_cell_indices));
 
   // Compute `index_array_set.grid_cell_indices`, the sorted array of the
   // distinct index vectors in `temp_cell_indices`, and
@@ -800,15 +848,19 @@ absl::Status FillIndexArraySetData(
       temp_cell_indices.data(), num_positions,
       index_array_set.grid_dimensions.count(),
       &index_array_set.grid_cell_indices,
-      &index_array_set.grid_cell_partition_offsets);
+      &index_array_set.grid_cell_partition_offsets, arena);
 
   // Compute the partial input index vectors corresponding to each partial grid
   // cell index vector in `temp_cell_indices`, and directly write them
-  // partitioned by grid cell using the `cells` map.
+  // partitioned by grid cell using the `cells` map, ordered within each grid
+  // cell by output index.
   index_array_set.partitioned_input_indices =
       GenerateIndexArraySetPartitionedInputIndices(
           index_array_set.input_dimensions, index_transform.domain().box(),
-          std::move(cells), num_positions);
+          std::move(cells), num_positions,
+          index_array_set.grid_cell_partition_offsets,
+          temp_output_indices.data(), index_array_set.grid_dimensions.count(),
+          arena);
   return absl::OkStatus();
 }
 
@@ -823,6 +875,10 @@ absl::Status FillIndexArraySetData(
 ///     be valid.
 /// \param grid_partition[out] `IndexTransformGridPartition` object to be
 ///     initialized.
+/// \param arena Arena used for temporary allocations.
+/// \param grid_cell_shape The cell shape if the grid is a regular grid, or
+///     empty otherwise.
+/// \param cache Optional.  If non-null, `grid_cell_shape` must be non-empty.
 /// \error `absl::StatusCode::kInvalidArgument` if integer overflow occurs.
 /// \error `absl::StatusCode::kOutOfRange` if an index array contains an
 ///     out-of-bounds index.
@@ -830,7 +886,8 @@ absl::Status GenerateIndexTransformGridPartitionData(
     span<const DimensionIndex> grid_output_dimensions,
     OutputToGridCellFn output_to_grid_cell,
     IndexTransformView<> index_transform,
-    IndexTransformGridPartition& grid_partition) {
+    IndexTransformGridPartition& grid_partition, internal::Arena* arena,
+    span<const Index> grid_cell_shape, IndexArraySetCache* cache) {
   IndexTransformGridPartition::StridedSet strided_sets[kMaxRank];
   DimensionIndex num_strided_sets = 0;
 
@@ -861,14 +918,236 @@ absl::Status GenerateIndexTransformGridPartitionData(
     auto [grid_dims, input_dims] = index_array_sets[i];
     set.input_dimensions = input_dims;
     set.grid_dimensions = grid_dims;
+    if (cache && cache->Lookup(set, grid_output_dimensions, grid_cell_shape,
+                               index_transform)) {
+      continue;
+    }
     TENSORSTORE_RETURN_IF_ERROR(FillIndexArraySetData(
-        set, grid_output_dimensions, output_to_grid_cell, index_transform));
+        set, grid_output_dimensions, output_to_grid_cell, index_transform,
+        arena));
+    if (cache) {
+      cache->Insert(set, grid_output_dimensions, grid_cell_shape,
+                    index_transform);
+    }
   }
 
   return absl::OkStatus();
 }
+
+absl::Status PrePartitionIndexTransformOverGridImpl(
+    IndexTransformView<> index_transform,
+    span<const DimensionIndex> grid_output_dimensions,
+    OutputToGridCellFn output_to_grid_cell,
+    IndexTransformGridPartition& grid_partition, internal::Arena* arena,
+    span<const Index> grid_cell_shape, IndexArraySetCache* cache) {
+  const DimensionIndex input_rank = index_transform.input_rank();
+
+  // Check that the input domains are all bounded.
+  for (DimensionIndex input_dim = 0; input_dim < input_rank; ++input_dim) {
+    const IndexInterval domain = index_transform.input_domain()[input_dim];
+    if (!IsFinite(domain)) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Input dimension ", input_dim,
+                              " has unbounded domain ", domain, "."));
+    }
+  }
+
+  // Check that the output ranges due to `single_input_dimension` maps are
+  // valid.  This check ensures that integer overflow cannot occur later when
+  // computing the output indices from `single_input_dimension` maps.
+  for (const DimensionIndex output_dim : grid_output_dimensions) {
+    const OutputIndexMapRef<> map =
+        index_transform.output_index_map(output_dim);
+    if (map.method() != OutputIndexMethod::single_input_dimension) continue;
+    auto status = GetAffineTransformRange(
+                      index_transform.input_domain()[map.input_dimension()],
+                      map.offset(), map.stride())
+                      .status();
+    if (!status.ok()) {
+      return MaybeAnnotateStatus(
+          status, tensorstore::StrCat("Computing range of output dimension ",
+                                      output_dim));
+    }
+  }
+
+  // Compute the IndexTransformGridPartition structure.
+  internal::Arena heap_arena;
+  return internal_grid_partition::GenerateIndexTransformGridPartitionData(
+      grid_output_dimensions, output_to_grid_cell, index_transform,
+      grid_partition, arena ? arena : &heap_arena, grid_cell_shape, cache);
+}
+
+/// Returns the grid cell index offset, and the remaining output offset, of the
+/// output index map for `grid_dim`.
+std::pair<Index, Index> SplitOutputOffset(Index offset, Index cell_size) {
+  const Index cell_offset = FloorOfRatio(offset, cell_size);
+  return {cell_offset, offset - cell_offset * cell_size};
+}
+
 }  // namespace
 
+/// Parameters of the output index map for one grid dimension of a cached
+/// `IndexArraySet`.
+struct IndexArraySetCacheMap {
+  OutputIndexMethod method;
+  Index cell_size;
+  // Output offset modulo `cell_size`.
+  Index offset_remainder;
+  Index stride;
+  DimensionIndex input_dimension;
+  IndexInterval index_range;
+  SharedArray<const Index, dynamic_rank, offset_origin> index_array;
+  // Grid cell index offset corresponding to `data`.
+  Index cell_offset;
+};
+
+struct IndexArraySetCache::Entry {
+  DimensionSet grid_dimensions;
+  DimensionSet input_dimensions;
+  // Domain of each input dimension in `input_dimensions`.
+  std::vector<IndexInterval> input_domain;
+  // Output index map of each grid dimension in `grid_dimensions`.
+  std::vector<IndexArraySetCacheMap> maps;
+  IndexTransformGridPartition::IndexArraySet data;
+};
+
+namespace {
+
+/// Returns `true` if `entry` was computed from an equivalent connected set.
+///
+/// \param cell_offset_delta[out] Set to the grid cell index offset to be added
+///     to each grid dimension of `entry.data`.
+bool MatchesIndexArraySetCacheEntry(
+    const IndexArraySetCache::Entry& entry,
+    const IndexTransformGridPartition::IndexArraySet& index_array_set,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> grid_cell_shape, IndexTransformView<> index_transform,
+    Index* cell_offset_delta) {
+  if (entry.grid_dimensions != index_array_set.grid_dimensions ||
+      entry.input_dimensions != index_array_set.input_dimensions) {
+    return false;
+  }
+  {
+    DimensionIndex i = 0;
+    for (DimensionIndex input_dim :
+         index_array_set.input_dimensions.index_view()) {
+      if (entry.input_domain[i++] !=
+          index_transform.input_domain()[input_dim]) {
+        return false;
+      }
+    }
+  }
+  DimensionIndex i = 0;
+  for (DimensionIndex grid_dim : index_array_set.grid_dimensions.index_view()) {
+    const auto& cached = entry.maps[i];
+    const OutputIndexMapRef<> map =
+        index_transform.output_index_map(grid_output_dimensions[grid_dim]);
+    if (cached.method != map.method() ||
+        cached.cell_size != grid_cell_shape[grid_dim] ||
+        cached.stride != map.stride()) {
+      return false;
+    }
+    auto [cell_offset, offset_remainder] =
+        SplitOutputOffset(map.offset(), cached.cell_size);
+    if (cached.offset_remainder != offset_remainder) return false;
+    if (map.method() == OutputIndexMethod::single_input_dimension) {
+      if (cached.input_dimension != map.input_dimension()) return false;
+    } else {
+      const auto index_array = map.index_array();
+      if (cached.index_range != index_array.index_range() ||
+          !AreArraysEqual(cached.index_array, index_array.array_ref())) {
+        return false;
+      }
+    }
+    if (internal::SubOverflow(cell_offset, cached.cell_offset,
+                              &cell_offset_delta[i])) {
+      return false;
+    }
+    ++i;
+  }
+  return true;
+}
+
+}  // namespace
+
+IndexArraySetCache& IndexArraySetCache::Global() {
+  static absl::NoDestructor<IndexArraySetCache> cache(/*max_entries=*/8);
+  return *cache;
+}
+
+bool IndexArraySetCache::Lookup(
+    IndexTransformGridPartition::IndexArraySet& index_array_set,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> grid_cell_shape, IndexTransformView<> index_transform) {
+  std::shared_ptr<const Entry> entry;
+  Index cell_offset_delta[kMaxRank];
+  {
+    absl::MutexLock lock(&mutex_);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      if (!MatchesIndexArraySetCacheEntry(
+              *entries_[i], index_array_set, grid_output_dimensions,
+              grid_cell_shape, index_transform, cell_offset_delta)) {
+        continue;
+      }
+      entry = entries_[i];
+      // Move to the front.
+      std::rotate(entries_.begin(), entries_.begin() + i,
+                  entries_.begin() + i + 1);
+      break;
+    }
+  }
+  if (!entry) return false;
+  const DimensionIndex num_grid_dims = index_array_set.grid_dimensions.count();
+  index_array_set = entry->data;
+  // Shift the grid cell indices, which does not change their relative order.
+  for (size_t i = 0; i < index_array_set.grid_cell_indices.size(); ++i) {
+    index_array_set.grid_cell_indices[i] +=
+        cell_offset_delta[i % num_grid_dims];
+  }
+  return true;
+}
+
+void IndexArraySetCache::Insert(
+    const IndexTransformGridPartition::IndexArraySet& index_array_set,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> grid_cell_shape, IndexTransformView<> index_transform) {
+  if (max_entries_ == 0 ||
+      index_array_set.partitioned_input_indices.shape()[0] > kMaxPositions) {
+    return;
+  }
+  auto entry = std::make_shared<Entry>();
+  entry->grid_dimensions = index_array_set.grid_dimensions;
+  entry->input_dimensions = index_array_set.input_dimensions;
+  for (DimensionIndex input_dim :
+       index_array_set.input_dimensions.index_view()) {
+    entry->input_domain.push_back(index_transform.input_domain()[input_dim]);
+  }
+  for (DimensionIndex grid_dim : index_array_set.grid_dimensions.index_view()) {
+    const OutputIndexMapRef<> map =
+        index_transform.output_index_map(grid_output_dimensions[grid_dim]);
+    auto& cached = entry->maps.emplace_back();
+    cached.method = map.method();
+    cached.cell_size = grid_cell_shape[grid_dim];
+    std::tie(cached.cell_offset, cached.offset_remainder) =
+        SplitOutputOffset(map.offset(), cached.cell_size);
+    cached.stride = map.stride();
+    if (map.method() == OutputIndexMethod::single_input_dimension) {
+      cached.input_dimension = map.input_dimension();
+    } else {
+      const auto index_array = map.index_array();
+      cached.index_range = index_array.index_range();
+      // Copy the index array, since its contents may be modified after the
+      // transform is no longer used.
+      cached.index_array =
+          MakeCopy(index_array.array_ref(), skip_repeated_elements);
+    }
+  }
+  entry->data = index_array_set;
+  absl::MutexLock lock(&mutex_);
+  if (entries_.size() == max_entries_) entries_.pop_back();
+  entries_.insert(entries_.begin(), std::move(entry));
+}
+
 internal_index_space::TransformRep::Ptr<> InitializeCellTransform(
     const IndexTransformGridPartition& info,
     IndexTransformView<> full_transform) {
@@ -967,41 +1246,22 @@ absl::Status PrePartitionIndexTransformOverGrid(
     IndexTransformView<> index_transform,
     span<const DimensionIndex> grid_output_dimensions,
     OutputToGridCellFn output_to_grid_cell,
-    IndexTransformGridPartition& grid_partition) {
-  const DimensionIndex input_rank = index_transform.input_rank();
-
-  // Check that the input domains are all bounded.
-  for (DimensionIndex input_dim = 0; input_dim < input_rank; ++input_dim) {
-    const IndexInterval domain = index_transform.input_domain()[input_dim];
-    if (!IsFinite(domain)) {
-      return absl::InvalidArgumentError(
-          tensorstore::StrCat("Input dimension ", input_dim,
-                              " has unbounded domain ", domain, "."));
-    }
-  }
-
-  // Check that the output ranges due to `single_input_dimension` maps are
-  // valid.  This check ensures that integer overflow cannot occur later when
-  // computing the output indices from `single_input_dimension` maps.
-  for (const DimensionIndex output_dim : grid_output_dimensions) {
-    const OutputIndexMapRef<> map =
-        index_transform.output_index_map(output_dim);
-    if (map.method() != OutputIndexMethod::single_input_dimension) continue;
-    auto status = GetAffineTransformRange(
-                      index_transform.input_domain()[map.input_dimension()],
-                      map.offset(), map.stride())
-                      .status();
-    if (!status.ok()) {
-      return MaybeAnnotateStatus(
-          status, tensorstore::StrCat("Computing range of output dimension ",
-                                      output_dim));
-    }
-  }
+    IndexTransformGridPartition& grid_partition, internal::Arena* arena) {
+  return PrePartitionIndexTransformOverGridImpl(
+      index_transform, grid_output_dimensions, output_to_grid_cell,
+      grid_partition, arena, /*grid_cell_shape=*/{}, /*cache=*/nullptr);
+}
 
-  // Compute the IndexTransformGridPartition structure.
-  return internal_grid_partition::GenerateIndexTransformGridPartitionData(
-      grid_output_dimensions, output_to_grid_cell, index_transform,
-      grid_partition);
+absl::Status PrePartitionIndexTransformOverRegularGrid(
+    IndexTransformView<> index_transform,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> grid_cell_shape,
+    IndexTransformGridPartition& grid_partition, internal::Arena* arena,
+    IndexArraySetCache* cache) {
+  assert(grid_cell_shape.size() == grid_output_dimensions.size());
+  return PrePartitionIndexTransformOverGridImpl(
+      index_transform, grid_output_dimensions, RegularGridRef{grid_cell_shape},
+      grid_partition, arena, grid_cell_shape, cache);
 }
 
 }  // namespace internal_grid_partition
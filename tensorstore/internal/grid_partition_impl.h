@@ -20,15 +20,21 @@
 
 // IWYU pragma: private, include "third_party/tensorstore/internal/grid_partition.h"
 
+#include <stddef.h>
+
+#include <memory>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/array.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/index_space/internal/transform_rep.h"
+#include "tensorstore/internal/arena.h"
 #include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/util/dimension_set.h"
 #include "tensorstore/util/iterate.h"
@@ -214,6 +220,9 @@ void UpdateCellTransformForIndexArraySetPartition(
 ///     a grid cell.
 /// \param grid_partition[out] Will be initialized with the partitioning
 ///     information.
+/// \param arena Optional.  Arena used for temporary allocations, such as the
+///     per-position grid cell indices computed for index array dimensions.  If
+///     `nullptr`, the heap is used.
 /// \error `absl::StatusCode::kInvalidArgument` if any input dimension of
 ///     `index_transform` has an unbounded domain.
 /// \error `absl::StatusCode::kInvalidArgument` if integer overflow occurs.
@@ -223,7 +232,65 @@ absl::Status PrePartitionIndexTransformOverGrid(
     IndexTransformView<> index_transform,
     span<const DimensionIndex> grid_output_dimensions,
     OutputToGridCellFn output_to_grid_cell,
-    IndexTransformGridPartition& grid_partition);
+    IndexTransformGridPartition& grid_partition,
+    internal::Arena* arena = nullptr);
+
+/// Cache of `IndexTransformGridPartition::IndexArraySet` data computed for
+/// regular grids.
+///
+/// Computing an `IndexArraySet` requires grouping every position of the index
+/// arrays by grid cell, which dominates the cost of partitioning a transform
+/// with large index arrays.  When the same index arrays are repeatedly
+/// partitioned over the same regular grid, with the output possibly translated
+/// by a multiple of the grid cell shape, the data is instead reused from a
+/// previous computation, with the grid cell indices shifted accordingly.
+///
+/// Entries hold a copy of the index arrays, and are only added for connected
+/// sets with at most `kMaxPositions` positions.
+class IndexArraySetCache {
+ public:
+  /// Maximum number of positions of a cached connected set.
+  constexpr static Index kMaxPositions = 1 << 18;
+
+  explicit IndexArraySetCache(size_t max_entries)
+      : max_entries_(max_entries) {}
+
+  /// Returns the cache used by `PartitionIndexTransformOverRegularGrid`.
+  static IndexArraySetCache& Global();
+
+  /// Sets all fields of `index_array_set`, which must have its
+  /// `grid_dimensions` and `input_dimensions` already set, from a matching
+  /// entry.
+  ///
+  /// Returns `true` if a matching entry was found.
+  bool Lookup(IndexTransformGridPartition::IndexArraySet& index_array_set,
+              span<const DimensionIndex> grid_output_dimensions,
+              span<const Index> grid_cell_shape,
+              IndexTransformView<> index_transform);
+
+  /// Adds an entry for `index_array_set`, computed from `index_transform`.
+  void Insert(const IndexTransformGridPartition::IndexArraySet& index_array_set,
+              span<const DimensionIndex> grid_output_dimensions,
+              span<const Index> grid_cell_shape,
+              IndexTransformView<> index_transform);
+
+  struct Entry;
+
+ private:
+  const size_t max_entries_;
+  absl::Mutex mutex_;
+  // Ordered from most to least recently used.
+  std::vector<std::shared_ptr<const Entry>> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+/// Same as `PrePartitionIndexTransformOverGrid`, but for a regular grid, and
+/// uses `cache` (if non-null) to reuse the `IndexArraySet` data.
+absl::Status PrePartitionIndexTransformOverRegularGrid(
+    IndexTransformView<> index_transform,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> grid_cell_shape,
+    IndexTransformGridPartition& grid_partition, internal::Arena* arena,
+    IndexArraySetCache* cache);
 
 }  // namespace internal_grid_partition
 }  // namespace tensorstore
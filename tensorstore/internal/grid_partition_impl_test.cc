@@ -25,6 +25,7 @@
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/index_space/index_transform_builder.h"
+#include "tensorstore/internal/arena.h"
 #include "tensorstore/internal/irregular_grid.h"
 #include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/util/dimension_set.h"
@@ -96,10 +97,14 @@ using ::tensorstore::kInfIndex;
 using ::tensorstore::MakeArray;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::span;
+using ::tensorstore::internal::Arena;
 using ::tensorstore::internal::IrregularGrid;
+using ::tensorstore::internal_grid_partition::IndexArraySetCache;
 using ::tensorstore::internal_grid_partition::IndexTransformGridPartition;
 using ::tensorstore::internal_grid_partition::
     PrePartitionIndexTransformOverGrid;
+using ::tensorstore::internal_grid_partition::
+    PrePartitionIndexTransformOverRegularGrid;
 using ::tensorstore::internal_grid_partition::RegularGridRef;
 using ::testing::ElementsAre;
 
@@ -293,7 +298,8 @@ TEST(PrePartitionIndexTransformOverRegularGridTest, SingleIndexArrayDimension) {
           /*.grid_dimensions=*/DimensionSet::FromIndices({0}),
           /*.input_dimensions=*/DimensionSet::FromIndices({0}),
           /*.grid_cell_indices=*/{1, 3, 5},
-          /*.partitioned_input_indices=*/MakeArray<Index>({{0}, {3}, {1}, {2}}),
+          // Within grid cell 5, ordered by output index (21, 23).
+          /*.partitioned_input_indices=*/MakeArray<Index>({{0}, {3}, {2}, {1}}),
           /*.grid_cell_partition_offsets=*/{0, 1, 2}}));
   EXPECT_THAT(partitioned.strided_sets(), ElementsAre());
 }
@@ -417,6 +423,98 @@ TEST(PrePartitionIndexTransformOverRegularGridTest,
   EXPECT_THAT(partitioned.strided_sets(), ElementsAre());
 }
 
+// Tests that temporary allocations may be served from an arena, including when
+// the arena buffer is too small for all of them.
+TEST(PrePartitionIndexTransformOverRegularGridTest, Arena) {
+  auto transform =
+      tensorstore::IndexTransformBuilder<>(2, 2)
+          .input_origin({-1, 2})
+          .input_shape({2, 3})
+          .output_index_array(0, 5, 2, MakeArray<Index>({{1, 2, 3}, {3, 4, 5}}))
+          .output_index_array(1, 2, 1, MakeArray<Index>({{5, 9, 1}, {8, 2, 3}}))
+          .Finalize()
+          .value();
+  const DimensionIndex grid_output_dimensions[] = {1, 0};
+  const Index grid_cell_shape[] = {3, 5};
+  for (size_t buffer_size : {0, 64, 4096}) {
+    SCOPED_TRACE(tensorstore::StrCat("buffer_size=", buffer_size));
+    std::vector<unsigned char> buffer(buffer_size);
+    Arena arena(buffer);
+    IndexTransformGridPartition partitioned;
+    TENSORSTORE_CHECK_OK(PrePartitionIndexTransformOverGrid(
+        transform, grid_output_dimensions, RegularGridRef{grid_cell_shape},
+        partitioned, &arena));
+    EXPECT_THAT(partitioned.index_array_sets(),
+                ElementsAre(IndexTransformGridPartition::IndexArraySet{
+                    /*.grid_dimensions=*/DimensionSet::FromIndices({0, 1}),
+                    /*.input_dimensions=*/DimensionSet::FromIndices({0, 1}),
+                    /*.grid_cell_indices=*/{1, 2, 1, 3, 2, 1, 3, 1, 3, 2},
+                    /*.partitioned_input_indices=*/
+                    MakeArray<Index>(
+                        {{-1, 4}, {0, 3}, {0, 4}, {-1, 2}, {-1, 3}, {0, 2}}),
+                    /*.grid_cell_partition_offsets=*/{0, 2, 3, 4, 5}}));
+  }
+}
+
+TEST(PrePartitionIndexTransformOverRegularGridTest, IndexArraySetCache) {
+  auto make_transform = [](Index offset, Index last_index) {
+    return tensorstore::IndexTransformBuilder<>(1, 1)
+        .input_origin({0})
+        .input_shape({4})
+        .output_index_array(0, offset, 2,
+                            MakeArray<Index>({1, 9, 8, last_index}))
+        .Finalize()
+        .value();
+  };
+  const DimensionIndex grid_output_dimensions[] = {0};
+  const Index grid_cell_shape[] = {4};
+  IndexArraySetCache cache(/*max_entries=*/2);
+  auto partition = [&](auto transform, IndexArraySetCache* cache) {
+    IndexTransformGridPartition partitioned;
+    TENSORSTORE_CHECK_OK(PrePartitionIndexTransformOverRegularGrid(
+        transform, grid_output_dimensions, grid_cell_shape, partitioned,
+        /*arena=*/nullptr, cache));
+    return partitioned;
+  };
+  auto get_data = [](const IndexTransformGridPartition& partitioned) {
+    return partitioned.index_array_sets()[0].partitioned_input_indices.data();
+  };
+
+  auto original = partition(make_transform(5, 4), &cache);
+  EXPECT_THAT(original.index_array_sets(),
+              ElementsAre(partition(make_transform(5, 4), nullptr)
+                              .index_array_sets()[0]));
+
+  // Identical transform reuses the cached data.
+  {
+    auto partitioned = partition(make_transform(5, 4), &cache);
+    EXPECT_EQ(get_data(original), get_data(partitioned));
+    EXPECT_THAT(partitioned.index_array_sets(),
+                ElementsAre(original.index_array_sets()[0]));
+  }
+
+  // Translating the output by a multiple of the grid cell shape reuses the
+  // cached data, with shifted grid cell indices.
+  {
+    auto partitioned = partition(make_transform(13, 4), &cache);
+    EXPECT_EQ(get_data(original), get_data(partitioned));
+    EXPECT_THAT(partitioned.index_array_sets(),
+                ElementsAre(partition(make_transform(13, 4), nullptr)
+                                .index_array_sets()[0]));
+    EXPECT_THAT(partitioned.index_array_sets()[0].grid_cell_indices,
+                ElementsAre(3, 5, 7));
+  }
+
+  // Other translations, and different index arrays, are not cached.
+  for (auto transform : {make_transform(6, 4), make_transform(5, 3)}) {
+    auto partitioned = partition(transform, &cache);
+    EXPECT_NE(get_data(original), get_data(partitioned));
+    EXPECT_THAT(
+        partitioned.index_array_sets(),
+        ElementsAre(partition(transform, nullptr).index_array_sets()[0]));
+  }
+}
+
 // Tests that an unbounded input domain leads to an error.
 TEST(PrePartitionIndexTransformOverRegularGridTest, UnboundedDomain) {
   auto transform = tensorstore::IndexTransformBuilder<>(1, 1)
@@ -46,6 +46,7 @@ using ::tensorstore::MakeArray;
 using ::tensorstore::Result;
 using ::tensorstore::span;
 using ::tensorstore::internal::GetGridCellRanges;
+using ::tensorstore::internal::GetSingleRegularGridCell;
 using ::tensorstore::internal::IrregularGrid;
 using ::tensorstore::internal_grid_partition::IndexTransformGridPartition;
 using ::tensorstore::internal_grid_partition::OutputToGridCellFn;
@@ -393,6 +394,38 @@ TEST(PartitionIndexTransformOverRegularGrid, SingleIndexArrayDimension) {
                 .value()}));
 }
 
+// Tests that the positions within each grid cell are ordered by output index.
+TEST(PartitionIndexTransformOverRegularGrid, IndexArrayOrderWithinCell) {
+  const auto results =
+      GetPartitions({0}, {10},
+                    IndexTransformBuilder<>(1, 1)
+                        .input_origin({100})
+                        .input_shape({5})
+                        .output_index_array(
+                            0, 0, 1, MakeArray<Index>({5, 1, 4, 12, 2}))
+                        .Finalize()
+                        .value());
+  // Input index:  100 101 102 103 104
+  // Output index:   5   1   4  12   2
+  // Grid index:     0   0   0   1   0
+  EXPECT_THAT(
+      results,
+      ElementsAre(
+          R{{0}, IndexTransformBuilder<>(1, 1)
+                     .input_origin({0})
+                     .input_shape({4})
+                     .output_index_array(
+                         0, 0, 1, MakeArray<Index>({101, 104, 102, 100}))
+                     .Finalize()
+                     .value()},
+          R{{1}, IndexTransformBuilder<>(1, 1)
+                     .input_origin({0})
+                     .input_shape({1})
+                     .output_index_array(0, 0, 1, MakeArray<Index>({103}))
+                     .Finalize()
+                     .value()}));
+}
+
 // Tests that a transform with a single gridded output dimension with an `array`
 // map from a single input dimension with non-unit stride is correctly
 // partitioned.
@@ -757,6 +790,77 @@ TEST(PartitionIndexTransformOverIrregularGrid, IndexArrayAndStridedDimensions) {
                   ));
 }
 
+// Tests that `GetSingleRegularGridCell` identifies transforms that map to a
+// single grid cell, consistent with `PartitionIndexTransformOverRegularGrid`.
+TEST(GetSingleRegularGridCellTest, Basic) {
+  const std::vector<DimensionIndex> grid_output_dimensions{0, 1};
+  const std::vector<Index> grid_cell_shape{5, 10};
+  Index cell[2];
+  {
+    auto transform = IndexTransformBuilder<>(2, 2)
+                         .input_origin({6, 20})
+                         .input_shape({3, 10})
+                         .output_identity_transform()
+                         .Finalize()
+                         .value();
+    EXPECT_TRUE(GetSingleRegularGridCell(
+        grid_output_dimensions, grid_cell_shape, transform, cell));
+    EXPECT_THAT(cell, ElementsAre(1, 2));
+    EXPECT_THAT(
+        GetPartitions(grid_output_dimensions, grid_cell_shape, transform),
+        ElementsAre(R{{1, 2},
+                      tensorstore::IdentityTransform(
+                          transform.domain().box())}));
+  }
+  {
+    // Extends into the next cell along dimension 1.
+    auto transform = IndexTransformBuilder<>(2, 2)
+                         .input_origin({6, 20})
+                         .input_shape({3, 11})
+                         .output_identity_transform()
+                         .Finalize()
+                         .value();
+    EXPECT_FALSE(GetSingleRegularGridCell(
+        grid_output_dimensions, grid_cell_shape, transform, cell));
+  }
+  {
+    // Constant and strided output maps.
+    auto transform = IndexTransformBuilder<>(1, 2)
+                         .input_origin({3})
+                         .input_shape({2})
+                         .output_constant(0, -1)
+                         .output_single_input_dimension(1, 1, 3, 0)
+                         .Finalize()
+                         .value();
+    EXPECT_TRUE(GetSingleRegularGridCell(
+        grid_output_dimensions, grid_cell_shape, transform, cell));
+    EXPECT_THAT(cell, ElementsAre(-1, 1));
+  }
+  {
+    // Index array output maps are not handled.
+    auto transform = IndexTransformBuilder<>(1, 2)
+                         .input_origin({0})
+                         .input_shape({2})
+                         .output_constant(0, 0)
+                         .output_index_array(1, 0, 1, MakeArray<Index>({1, 2}))
+                         .Finalize()
+                         .value();
+    EXPECT_FALSE(GetSingleRegularGridCell(
+        grid_output_dimensions, grid_cell_shape, transform, cell));
+  }
+  {
+    // Empty domains do not correspond to any grid cell.
+    auto transform = IndexTransformBuilder<>(2, 2)
+                         .input_origin({0, 0})
+                         .input_shape({0, 1})
+                         .output_identity_transform()
+                         .Finalize()
+                         .value();
+    EXPECT_FALSE(GetSingleRegularGridCell(
+        grid_output_dimensions, grid_cell_shape, transform, cell));
+  }
+}
+
 }  // namespace partition_tests
 
 namespace get_grid_cell_ranges_tests {
@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <limits>
@@ -24,23 +25,25 @@
 #include <utility>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/time/time.h"
 #include "tensorstore/array_storage_statistics.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/box.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/internal/grid_chunk_key_ranges.h"
 #include "tensorstore/internal/grid_chunk_key_ranges_base10.h"
+#include "tensorstore/internal/grid_partition.h"
 #include "tensorstore/internal/grid_partition_impl.h"
 #include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
 #include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/internal/storage_statistics.h"
-#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
@@ -48,6 +51,7 @@
 #include "tensorstore/rank.h"
 #include "tensorstore/util/division.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/iterate_over_index_range.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
@@ -111,6 +115,38 @@ struct ListReceiver {
   }
 };
 
+// Key ranges that may contain more than this number of chunks are split into
+// multiple list operations that are issued in parallel, since listing a single
+// large key range requires a long sequence of paginated requests.
+constexpr Index kMaxChunksPerList = 65536;
+
+// Maximum number of list operations into which a single key range is split.
+constexpr Index kMaxParallelListsPerKeyRange = 64;
+
+// Determines the presence of the chunk at `key` using a metadata-only stat.
+void ReadChunkPresence(
+    const internal::IntrusivePtr<GridStorageStatisticsChunkHandler>& handler,
+    const KvStore& kvs, std::string key, span<const Index> grid_indices,
+    absl::Time staleness_bound, Batch::View batch = no_batch) {
+  kvstore::StatOptions stat_options;
+  stat_options.staleness_bound = staleness_bound;
+  stat_options.batch = batch;
+  LinkValue(
+      [handler, grid_indices = std::vector<Index>(grid_indices.begin(),
+                                                  grid_indices.end())](
+          Promise<ArrayStorageStatistics> promise,
+          ReadyFuture<kvstore::StatResult> future) {
+        auto& stat_result = future.value();
+        if (!stat_result.has_value()) {
+          handler->state->ChunkMissing();
+        } else {
+          handler->ChunkPresent(grid_indices);
+        }
+      },
+      handler->state->promise,
+      kvstore::Stat(kvs, std::move(key), std::move(stat_options)));
+}
+
 }  // namespace
 
 GridStorageStatisticsChunkHandler::~GridStorageStatisticsChunkHandler() =
@@ -175,51 +211,70 @@ void GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
 
   int64_t total_chunks = 0;
 
-  const auto handle_key = [&](std::string key, span<const Index> grid_indices) {
+  const auto read_key = [&](std::string key, span<const Index> grid_indices) {
     ABSL_LOG_IF(INFO, TENSORSTORE_INTERNAL_GRID_STORAGE_STATISTICS_DEBUG)
         << "key: " << tensorstore::QuoteString(key);
+    ReadChunkPresence(handler, kvs, std::move(key), grid_indices,
+                      staleness_bound);
+    return absl::OkStatus();
+  };
+
+  const auto list_key_range = [&](KeyRange key_range,
+                                  BoxView<> bounds) -> absl::Status {
+    ABSL_LOG_IF(INFO, TENSORSTORE_INTERNAL_GRID_STORAGE_STATISTICS_DEBUG)
+        << "key_range: " << key_range << ", grid_bounds=" << bounds;
+    kvstore::ListOptions list_options;
+    list_options.staleness_bound = staleness_bound;
+    list_options.range = std::move(key_range);
+    kvstore::List(kvs, std::move(list_options),
+                  ListReceiver{handler, Box<>(bounds)});
+    return absl::OkStatus();
+  };
+
+  const auto handle_key = [&](std::string key, span<const Index> grid_indices) {
     if (internal::AddOverflow<Index>(total_chunks, 1, &total_chunks)) {
       return absl::OutOfRangeError(
           "Integer overflow computing number of chunks");
     }
-    kvstore::ReadOptions read_options;
-    read_options.byte_range = OptionalByteRangeRequest(0, 0);
-    read_options.staleness_bound = staleness_bound;
-    LinkValue(
-        [handler, grid_indices = std::vector<Index>(grid_indices.begin(),
-                                                    grid_indices.end())](
-            Promise<ArrayStorageStatistics> promise,
-            ReadyFuture<kvstore::ReadResult> future) {
-          auto& read_result = future.value();
-          if (!read_result.has_value()) {
-            handler->state->ChunkMissing();
-          } else {
-            handler->ChunkPresent(grid_indices);
-          }
-        },
-        handler->state->promise,
-        kvstore::Read(kvs, std::move(key), std::move(read_options)));
-    return absl::OkStatus();
+    return read_key(std::move(key), grid_indices);
   };
 
   const auto handle_key_range = [&](KeyRange key_range,
-                                    BoxView<> grid_bounds) -> absl::Status {
-    ABSL_LOG_IF(INFO, TENSORSTORE_INTERNAL_GRID_STORAGE_STATISTICS_DEBUG)
-        << "key_range: " << key_range << ", grid_bounds=" << grid_bounds;
-    Index cur_total_chunks = grid_bounds.num_elements();
+                                    BoxView<> bounds) -> absl::Status {
+    Index cur_total_chunks = bounds.num_elements();
     if (cur_total_chunks == std::numeric_limits<Index>::max()) {
       return absl::OutOfRangeError(tensorstore::StrCat(
-          "Integer overflow computing number of chunks in ", grid_bounds));
+          "Integer overflow computing number of chunks in ", bounds));
     }
     if (internal::AddOverflow(total_chunks, cur_total_chunks, &total_chunks)) {
       return absl::OutOfRangeError(
           "Integer overflow computing number of chunks");
     }
-    kvstore::ListOptions list_options;
-    list_options.staleness_bound = staleness_bound;
-    list_options.range = std::move(key_range);
-    kvstore::List(kvs, std::move(list_options),
-                  ListReceiver{handler, Box<>(grid_bounds)});
+    // Split the range along its outermost non-singleton dimension into
+    // sub-ranges that are listed in parallel.
+    DimensionIndex split_dim = 0;
+    while (split_dim + 1 < bounds.rank() && bounds.shape()[split_dim] == 1) {
+      ++split_dim;
+    }
+    const Index split_size = bounds.shape()[split_dim];
+    const Index num_lists =
+        std::min({split_size, kMaxParallelListsPerKeyRange,
+                  CeilOfRatio(cur_total_chunks, kMaxChunksPerList)});
+    if (num_lists <= 1) {
+      return list_key_range(std::move(key_range), bounds);
+    }
+    const Index sub_size = CeilOfRatio(split_size, num_lists);
+    Box<dynamic_rank(kMaxRank)> sub_bounds(bounds);
+    for (Index start = bounds.origin()[split_dim];
+         start <= bounds[split_dim].inclusive_max(); start += sub_size) {
+      sub_bounds[split_dim] = IndexInterval::UncheckedHalfOpen(
+          start,
+          std::min(start + sub_size, bounds[split_dim].exclusive_max()));
+      TENSORSTORE_RETURN_IF_ERROR(
+          GetChunkKeyRangesForGridCellRangeWithSemiLexicographicalKeys(
+              sub_bounds, grid_bounds, *handler->key_formatter, read_key,
+              list_key_range));
+    }
     return absl::OkStatus();
   };
 
@@ -242,6 +297,61 @@ void GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
   handler->state->total_chunks += total_chunks;
 }
 
+Future<ArrayStorageStatistics> GetStorageStatisticsForRegularGridWithChunkKeys(
+    const KvStore& kvs, IndexTransformView<> transform,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> chunk_shape, BoxView<> grid_bounds,
+    absl::FunctionRef<std::string(span<const Index> grid_indices)>
+        get_chunk_key,
+    absl::Time staleness_bound, GetArrayStorageStatisticsOptions options) {
+  Future<ArrayStorageStatistics> future;
+  auto handler =
+      internal::MakeIntrusivePtr<GridStorageStatisticsChunkHandler>();
+  // Note: `future` is a output parameter.
+  handler->state =
+      internal::MakeIntrusivePtr<GetStorageStatisticsAsyncOperationState>(
+          future, options);
+  handler->full_transform = transform;
+  handler->grid_output_dimensions = grid_output_dimensions;
+  handler->chunk_shape = chunk_shape;
+
+  internal_grid_partition::RegularGridRef output_to_grid_cell{chunk_shape};
+
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal_grid_partition::PrePartitionIndexTransformOverGrid(
+          handler->full_transform, grid_output_dimensions,
+          output_to_grid_cell, handler->grid_partition),
+      (handler->state->SetError(_), future));
+
+  // Reads of chunks in the same shard are batched, such that each shard index
+  // is read only once.
+  Batch batch = Batch::New();
+  int64_t total_chunks = 0;
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal_grid_partition::GetGridCellRanges(
+          handler->grid_partition, grid_output_dimensions, grid_bounds,
+          output_to_grid_cell, handler->full_transform,
+          [&](BoxView<> bounds) -> absl::Status {
+            if (internal::AddOverflow(total_chunks, bounds.num_elements(),
+                                      &total_chunks)) {
+              return absl::OutOfRangeError(
+                  "Integer overflow computing number of chunks");
+            }
+            IterateOverIndexRange(bounds, [&](span<const Index> grid_indices) {
+              // Stop issuing reads once the result is known.
+              if (!handler->state->promise.result_needed()) return false;
+              ReadChunkPresence(handler, kvs, get_chunk_key(grid_indices),
+                                grid_indices, staleness_bound, batch);
+              return true;
+            });
+            return absl::OkStatus();
+          }),
+      (handler->state->SetError(_), future));
+
+  handler->state->total_chunks += total_chunks;
+  return future;
+}
+
 Future<ArrayStorageStatistics> GetStorageStatisticsForRegularGridWithBase10Keys(
     const KvStore& kvs, IndexTransformView<> transform,
     span<const DimensionIndex> grid_output_dimensions,
@@ -16,7 +16,9 @@
 #define TENSORSTORE_INTERNAL_GRID_STORAGE_STATISTICS_H_
 
 #include <memory>
+#include <string>
 
+#include "absl/functional/function_ref.h"
 #include "absl/time/time.h"
 #include "tensorstore/array_storage_statistics.h"
 #include "tensorstore/box.h"
@@ -70,6 +72,34 @@ Future<ArrayStorageStatistics> GetStorageStatisticsForRegularGridWithBase10Keys(
     char dimension_separator, absl::Time staleness_bound,
     GetArrayStorageStatisticsOptions options);
 
+// Computes array storage statistics for drivers that map each chunk to a
+// separate key of a kvstore that does not support efficient listing of the
+// chunk keys, such as a sharded kvstore that resolves keys using shard indices.
+//
+// The presence of each chunk is determined by a zero-length read.  The reads
+// are issued as a single batch.
+//
+// Args:
+//   kvs: Key-value store.
+//   transform: Index transform.
+//   grid_output_dimensions: Output dimensions of `transform` corresponding to
+//     each grid dimension.
+//   chunk_shape: Chunk size along each grid dimension.  Must be the same length
+//     as `grid_output_dimensions`.
+//   grid_bounds: Range of grid indices along each grid dimension.  Must be the
+//     same rank as `grid_output_dimensions`.
+//   get_chunk_key: Returns the key of the chunk with the specified grid
+//     indices.
+//   staleness_bound: Staleness bound to use for kvstore operations.
+//   options: Specifies which statistics to compute.
+Future<ArrayStorageStatistics> GetStorageStatisticsForRegularGridWithChunkKeys(
+    const KvStore& kvs, IndexTransformView<> transform,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> chunk_shape, BoxView<> grid_bounds,
+    absl::FunctionRef<std::string(span<const Index> grid_indices)>
+        get_chunk_key,
+    absl::Time staleness_bound, GetArrayStorageStatisticsOptions options);
+
 struct GridStorageStatisticsChunkHandler
     : public internal::AtomicReferenceCount<GridStorageStatisticsChunkHandler> {
   internal::IntrusivePtr<GetStorageStatisticsAsyncOperationState> state;
@@ -25,9 +25,11 @@
 #include "absl/base/attributes.h"
 #include "absl/base/call_once.h"
 #include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/flags/flag.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
 #include <curl/curl.h>  // IWYU pragma: keep
 #include "tensorstore/internal/env.h"
 #include "tensorstore/internal/http/curl_wrappers.h"
@@ -55,6 +57,10 @@ ABSL_FLAG(std::optional<std::string>, tensorstore_ca_bundle, std::nullopt,
           "CA Bundle used with http connections. "
           "Overrides TENSORSTORE_CA_BUNDLE.");
 
+ABSL_FLAG(std::optional<bool>, tensorstore_curl_share, std::nullopt,
+          "Share DNS and TLS session caches between curl handles. "
+          "Overrides TENSORSTORE_CURL_SHARE.");
+
 ABSL_FLAG(std::optional<uint32_t>, tensorstore_http2_max_concurrent_streams,
           std::nullopt,
           "Maximum concurrent streams for http2 connections. "
@@ -127,6 +133,9 @@ struct CurlConfig {
   std::optional<std::string> ca_bundle =
       GetFlagOrEnvValue(FLAGS_tensorstore_ca_bundle, "TENSORSTORE_CA_BUNDLE");
   int32_t max_http2_concurrent_streams = GetMaxHttp2ConcurrentStreams();
+  bool share =
+      GetFlagOrEnvValue(FLAGS_tensorstore_curl_share, "TENSORSTORE_CURL_SHARE")
+          .value_or(true);
 };
 
 const CurlConfig& CurlEnvConfig() {
@@ -134,6 +143,48 @@ const CurlConfig& CurlEnvConfig() {
   return *curl_config;
 }
 
+/// CurlShareState shares the DNS cache and the TLS session cache between all
+/// curl handles.  Each multi handle otherwise keeps its own DNS cache, and TLS
+/// sessions are not resumed across handles, so every new connection would do
+/// a name lookup and a full TLS handshake.
+class CurlShareState {
+ public:
+  CurlShareState() : share_(curl_share_init()) {
+    ABSL_CHECK(share_ != nullptr);
+    ABSL_CHECK_EQ(CURLSHE_OK, curl_share_setopt(share_.get(),
+                                                CURLSHOPT_LOCKFUNC, &Lock));
+    ABSL_CHECK_EQ(CURLSHE_OK, curl_share_setopt(share_.get(),
+                                                CURLSHOPT_UNLOCKFUNC, &Unlock));
+    ABSL_CHECK_EQ(CURLSHE_OK,
+                  curl_share_setopt(share_.get(), CURLSHOPT_USERDATA, this));
+    ABSL_CHECK_EQ(CURLSHE_OK, curl_share_setopt(share_.get(), CURLSHOPT_SHARE,
+                                                CURL_LOCK_DATA_DNS));
+    ABSL_CHECK_EQ(CURLSHE_OK, curl_share_setopt(share_.get(), CURLSHOPT_SHARE,
+                                                CURL_LOCK_DATA_SSL_SESSION));
+  }
+
+  CURLSH* get() { return share_.get(); }
+
+ private:
+  static void Lock(CURL* handle, curl_lock_data data, curl_lock_access access,
+                   void* userptr) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    static_cast<CurlShareState*>(userptr)->mutex_[data].Lock();
+  }
+
+  static void Unlock(CURL* handle, curl_lock_data data,
+                     void* userptr) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    static_cast<CurlShareState*>(userptr)->mutex_[data].Unlock();
+  }
+
+  absl::Mutex mutex_[CURL_LOCK_DATA_LAST];
+  CurlShare share_;
+};
+
+CURLSH* GetCurlShare() {
+  static absl::NoDestructor<CurlShareState> share_state;
+  return share_state->get();
+}
+
 /// DefaultCurlHandleFactory generates a new handle on each request.
 class DefaultCurlHandleFactory : public CurlHandleFactory {
  public:
@@ -176,6 +227,11 @@ class DefaultCurlHandleFactory : public CurlHandleFactory {
                                                CURLOPT_LOW_SPEED_LIMIT, bytes));
     }
 
+    if (config.share) {
+      ABSL_CHECK_EQ(CURLE_OK, curl_easy_setopt(handle.get(), CURLOPT_SHARE,
+                                               GetCurlShare()));
+    }
+
     // Set ca_path or ca_bundle, if provided.
     if (config.ca_path || config.ca_bundle) {
       ABSL_CHECK_EQ(
@@ -214,6 +270,10 @@ class DefaultCurlHandleFactory : public CurlHandleFactory {
   }
 
   void CleanupMultiHandle(CurlMulti&& m) override { m.reset(); }
+
+  int32_t max_concurrent_streams() const override {
+    return CurlEnvConfig().max_http2_concurrent_streams;
+  }
 };
 
 /// TODO: Implement a CurlHandleFactory which caches values.
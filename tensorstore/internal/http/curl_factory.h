@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_INTERNAL_HTTP_CURL_FACTORY_H_
 #define TENSORSTORE_INTERNAL_HTTP_CURL_FACTORY_H_
 
+#include <stdint.h>
+
 #include <memory>
 
 #include "tensorstore/internal/http/curl_wrappers.h"
@@ -36,6 +38,10 @@ class CurlHandleFactory {
 
   virtual CurlMulti CreateMultiHandle() = 0;
   virtual void CleanupMultiHandle(CurlMulti&&) = 0;
+
+  /// Returns the maximum number of HTTP/2 streams which multi handles created
+  /// by this factory multiplex over a single connection.
+  virtual int32_t max_concurrent_streams() const { return 1; }
 };
 
 /// Returns the default CurlHandleFactory.
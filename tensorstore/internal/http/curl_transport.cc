@@ -34,6 +34,7 @@
 #include "absl/base/attributes.h"
 #include "absl/base/const_init.h"
 #include "absl/flags/flag.h"
+#include "absl/hash/hash.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
@@ -49,15 +50,32 @@
 #include "tensorstore/internal/http/curl_wrappers.h"
 #include "tensorstore/internal/http/http_request.h"
 #include "tensorstore/internal/http/http_transport.h"
+#include "tensorstore/internal/memory_budget.h"
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/gauge.h"
 #include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/thread/thread.h"
+#include "tensorstore/internal/tracing/inflight_operation.h"
+#include "tensorstore/internal/uri_utils.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 
 ABSL_FLAG(std::optional<uint32_t>, tensorstore_http_threads, std::nullopt,
           "Threads to use for http requests. "
           "Overrides TENSORSTORE_HTTP_THREADS.");
 
+ABSL_FLAG(std::optional<std::vector<std::string>>,
+          tensorstore_http_warmup_urls, std::nullopt,
+          "Comma-separated urls to which connections are opened when the "
+          "default http transport is created. "
+          "Overrides TENSORSTORE_HTTP_WARMUP_URLS.");
+
+ABSL_FLAG(std::optional<uint32_t>, tensorstore_http_warmup_connections,
+          std::nullopt,
+          "Connections to open to each of --tensorstore_http_warmup_urls. "
+          "Overrides TENSORSTORE_HTTP_WARMUP_CONNECTIONS.");
+
 namespace tensorstore {
 namespace internal_http {
 namespace {
@@ -71,6 +89,14 @@ auto& http_request_started = internal_metrics::Counter<int64_t>::New(
 auto& http_request_completed = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/http/request_completed", "HTTP requests completed");
 
+auto& http_request_cancelled = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/http/request_cancelled",
+    "HTTP requests abandoned because the response was no longer needed");
+
+auto& http_cancelled_bytes_saved = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/http/cancelled_bytes_saved",
+    "HTTP response bytes not received due to cancelled requests");
+
 auto& http_request_bytes =
     internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
         "/tensorstore/http/request_bytes", "HTTP request bytes transmitted");
@@ -100,6 +126,16 @@ auto& http_first_byte_latency_us =
         "/tensorstore/http/first_byte_latency_us",
         "HTTP first byte received latency (us)");
 
+auto& http_connections_created = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/http/connections_created", "HTTP connections created");
+
+auto& http_tls_handshakes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/http/tls_handshakes", "HTTP TLS handshakes performed");
+
+auto& http_thread_queue_depth = internal_metrics::Gauge<int64_t, int>::New(
+    "/tensorstore/http/thread_queue_depth", "thread",
+    "HTTP requests assigned to each transport thread");
+
 auto& http_poll_time_ns =
     internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
         "/tensorstore/http/http_poll_time_ns",
@@ -111,6 +147,26 @@ uint32_t GetHttpThreads() {
                           .value_or(4u));
 }
 
+// Handles the response to a warm-up request, which is issued only to open a
+// connection.
+class WarmUpResponseHandler : public HttpResponseHandler {
+ public:
+  explicit WarmUpResponseHandler(Promise<void> promise)
+      : promise_(std::move(promise)) {}
+
+  void OnFailure(absl::Status status) override {
+    promise_.SetResult(std::move(status));
+    delete this;
+  }
+  void OnStatus(int32_t status_code) override {}
+  void OnResponseHeader(std::string_view data) override {}
+  void OnResponseBody(std::string_view data) override {}
+  void OnComplete() override { delete this; }
+
+ private:
+  Promise<void> promise_;
+};
+
 struct CurlRequestState {
   std::shared_ptr<CurlHandleFactory> factory_;
   CurlHandle handle_;
@@ -121,7 +177,11 @@ struct CurlRequestState {
   HttpResponseHandler* response_handler_ = nullptr;
   size_t response_payload_size_ = 0;
   bool status_set = false;
+  bool cancelled_ = false;
   char error_buffer_[CURL_ERROR_SIZE];
+  internal_tracing::InFlightOperation inflight_;
+  // Charged with the response body received so far.
+  internal::MemoryReservation memory_reservation_;
 
   CurlRequestState(std::shared_ptr<CurlHandleFactory> factory)
       : factory_(std::move(factory)), handle_(CurlHandle::Create(*factory_)) {
@@ -143,7 +203,12 @@ struct CurlRequestState {
     handle_.SetOption(CURLOPT_HEADERFUNCTION,
                       &CurlRequestState::CurlHeaderCallback);
 
-    // Consider: CURLOPT_XFERINFOFUNCTION for increased logging.
+    // The progress callback aborts requests which are no longer needed, even
+    // while no data is being received.
+    handle_.SetOption(CURLOPT_XFERINFODATA, this);
+    handle_.SetOption(CURLOPT_XFERINFOFUNCTION,
+                      &CurlRequestState::CurlXferInfoCallback);
+    handle_.SetOption(CURLOPT_NOPROGRESS, 0L);
   }
 
   ~CurlRequestState() {
@@ -155,11 +220,16 @@ struct CurlRequestState {
     handle_.SetOption(CURLOPT_SEEKFUNCTION, nullptr);
     handle_.SetOption(CURLOPT_HEADERDATA, nullptr);
     handle_.SetOption(CURLOPT_HEADERFUNCTION, nullptr);
+    handle_.SetOption(CURLOPT_NOPROGRESS, 1L);
+    handle_.SetOption(CURLOPT_XFERINFODATA, nullptr);
+    handle_.SetOption(CURLOPT_XFERINFOFUNCTION, nullptr);
     handle_.SetOption(CURLOPT_ERRORBUFFER, nullptr);
     CurlHandle::Cleanup(*factory_, std::move(handle_));
   }
 
   void Prepare(const HttpRequest& request, IssueRequestOptions options) {
+    inflight_ = internal_tracing::InFlightOperation(
+        "http", request.method + " " + request.url, "queued");
     handle_.SetOption(CURLOPT_URL, request.url.c_str());
 
     std::string user_agent = request.user_agent + GetCurlUserAgentSuffix();
@@ -260,6 +330,13 @@ struct CurlRequestState {
     handle_.SetOption(CURLOPT_FORBID_REUSE, 1);
   }
 
+  // Returns true if the response is no longer needed, in which case the
+  // transfer should be aborted.
+  bool CheckCancelled() {
+    if (!cancelled_ && response_handler_->IsCancelled()) cancelled_ = true;
+    return cancelled_;
+  }
+
   bool MaybeSetStatusAndProcess() {
     if (status_set) return true;
     auto status_code = handle_.GetResponseCode();
@@ -275,6 +352,8 @@ struct CurlRequestState {
     auto* self = static_cast<CurlRequestState*>(userdata);
     auto data =
         std::string_view(static_cast<char const*>(contents), size * nmemb);
+    // Returning a different size aborts the transfer.
+    if (self->CheckCancelled()) return 0;
     if (self->MaybeSetStatusAndProcess()) {
       self->response_handler_->OnResponseHeader(data);
     }
@@ -286,13 +365,24 @@ struct CurlRequestState {
     auto* self = static_cast<CurlRequestState*>(userdata);
     auto data =
         std::string_view(static_cast<char const*>(contents), size * nmemb);
+    // Returning a different size aborts the transfer.
+    if (self->CheckCancelled()) return 0;
     if (self->MaybeSetStatusAndProcess()) {
       self->response_payload_size_ += data.size();
+      self->memory_reservation_.Resize(self->response_payload_size_);
       self->response_handler_->OnResponseBody(data);
     }
     return data.size();
   }
 
+  static int CurlXferInfoCallback(void* userdata, curl_off_t dltotal,
+                                  curl_off_t dlnow, curl_off_t ultotal,
+                                  curl_off_t ulnow) {
+    auto* self = static_cast<CurlRequestState*>(userdata);
+    // Returning a non-zero value aborts the transfer.
+    return self->CheckCancelled() ? 1 : 0;
+  }
+
   static size_t CurlReadCallback(void* contents, size_t size, size_t nmemb,
                                  void* userdata) {
     auto* self = static_cast<CurlRequestState*>(userdata);
@@ -333,10 +423,15 @@ class MultiTransportImpl {
   void EnqueueRequest(const HttpRequest& request, IssueRequestOptions options,
                       HttpResponseHandler* response_handler);
 
+  Future<void> WarmUp(span<const std::string> urls, size_t connections);
+
+  const CurlHandleFactory& factory() const { return *factory_; }
+
   void FinishRequest(std::unique_ptr<CurlRequestState> state, CURLcode code);
 
  private:
   struct ThreadData {
+    int index = 0;
     std::atomic<int64_t> count = 0;
     CurlMulti multi;
     absl::Mutex mutex;
@@ -347,6 +442,13 @@ class MultiTransportImpl {
   // Runs the thread loop.
   void Run(ThreadData& thread_data);
 
+  // Returns the indices of the two threads to which requests for `url` may be
+  // assigned.
+  std::pair<size_t, size_t> GetCandidateThreads(std::string_view url);
+
+  // Enqueues the request on the thread with index `thread_index`.
+  void Enqueue(std::unique_ptr<CurlRequestState> state, size_t thread_index);
+
   void MaybeAddPendingTransfers(ThreadData& thread_data);
   void RemoveCompletedTransfers(ThreadData& thread_data);
 
@@ -364,6 +466,7 @@ MultiTransportImpl::MultiTransportImpl(
   threads_.reserve(nthreads);
   thread_data_ = std::make_unique<ThreadData[]>(nthreads);
   for (size_t i = 0; i < nthreads; ++i) {
+    thread_data_[i].index = static_cast<int>(i);
     thread_data_[i].multi = factory_->CreateMultiHandle();
     threads_.push_back(
         internal::Thread({"curl_multi_thread"},
@@ -398,23 +501,84 @@ void MultiTransportImpl::EnqueueRequest(const HttpRequest& request,
     return;
   }
 
+  auto memory_budget = std::move(options.memory_budget);
+  const bool has_payload = !options.payload.empty();
   auto state = std::make_unique<CurlRequestState>(factory_);
   state->response_handler_ = response_handler;
   state->Prepare(request, std::move(options));
 
-  // Select the thread with the fewest active connections, and then enqueue
-  // the request on that thread.
-  size_t selected_index = 0;
-  for (size_t i = 1; i < threads_.size(); ++i) {
-    if (thread_data_[i].count < thread_data_[selected_index].count) {
-      selected_index = i;
+  // Of the two candidate threads for the host, select the one with the fewest
+  // active requests, and then enqueue the request on that thread.
+  auto [first, second] = GetCandidateThreads(request.url);
+  const auto enqueue = [this, first = first, second = second](
+                           std::unique_ptr<CurlRequestState> state) {
+    Enqueue(std::move(state),
+            thread_data_[second].count < thread_data_[first].count ? second
+                                                                   : first);
+  };
+  if (!memory_budget) {
+    enqueue(std::move(state));
+    return;
+  }
+  if (has_payload) {
+    // Uploads are not held back, since they are typically writebacks that
+    // release memory charged to the budget.
+    state->memory_reservation_ = memory_budget->Retain();
+    enqueue(std::move(state));
+    return;
+  }
+  memory_budget->Reserve(
+      0, [enqueue, state = std::move(state)](
+             internal::MemoryReservation reservation) mutable {
+        state->memory_reservation_ = std::move(reservation);
+        enqueue(std::move(state));
+      });
+}
+
+std::pair<size_t, size_t> MultiTransportImpl::GetCandidateThreads(
+    std::string_view url) {
+  // Each thread has its own multi handle, and thereby its own connection
+  // cache.  Assigning requests for a host to one of two threads determined by
+  // the host keeps connections to the host reusable, while still spreading
+  // the load over all threads when there are many hosts, or when a thread is
+  // busy ("power of two choices").
+  const size_t n = threads_.size();
+  if (n == 1) return {0, 0};
+  const size_t hash = absl::HashOf(internal::ParseGenericUri(url).authority);
+  const size_t first = hash % n;
+  const size_t second = (first + 1 + (hash / n) % (n - 1)) % n;
+  return {first, second};
+}
+
+Future<void> MultiTransportImpl::WarmUp(span<const std::string> urls,
+                                        size_t connections) {
+  auto pair = PromiseFuturePair<void>::Make(MakeResult());
+  if (done_.load()) {
+    pair.promise.SetResult(
+        absl::InternalError("MultiTransportImpl is shutting down"));
+    return std::move(pair.future);
+  }
+  // The connections are spread over the threads to which later requests for
+  // the host are assigned, since each has its own connection cache.
+  for (const std::string& url : urls) {
+    HttpRequest request{"HEAD", url};
+    auto [first, second] = GetCandidateThreads(url);
+    for (size_t i = 0; i < connections; ++i) {
+      auto state = std::make_unique<CurlRequestState>(factory_);
+      state->response_handler_ = new WarmUpResponseHandler(pair.promise);
+      state->Prepare(request, IssueRequestOptions{});
+      Enqueue(std::move(state), i % 2 == 0 ? first : second);
     }
   }
+  return std::move(pair.future);
+}
 
-  auto& selected = thread_data_[selected_index];
+void MultiTransportImpl::Enqueue(std::unique_ptr<CurlRequestState> state,
+                                 size_t thread_index) {
+  auto& selected = thread_data_[thread_index];
   absl::MutexLock l(&selected.mutex);
   selected.pending.push_back(std::move(state));
-  selected.count++;
+  http_thread_queue_depth.Set(++selected.count, selected.index);
   curl_multi_wakeup(selected.multi.get());
 }
 
@@ -440,6 +604,20 @@ void MultiTransportImpl::FinishRequest(std::unique_ptr<CurlRequestState> state,
     http_first_byte_latency_us.Observe(first_byte_us);
   }
 
+  // Record new connections, and the TLS handshakes done for them.  With the
+  // TLS session cache shared between handles, handshakes may resume an
+  // earlier session.
+  {
+    long num_connects = 0;  // NOLINT
+    state->handle_.GetInfo(CURLINFO_NUM_CONNECTS, &num_connects);
+    if (num_connects > 0) {
+      http_connections_created.IncrementBy(num_connects);
+      curl_off_t appconnect_us = 0;
+      state->handle_.GetInfo(CURLINFO_APPCONNECT_TIME_T, &appconnect_us);
+      if (appconnect_us > 0) http_tls_handshakes.Increment();
+    }
+  }
+
   // Record the total time.
   {
     curl_off_t total_time_us = 0;
@@ -447,6 +625,21 @@ void MultiTransportImpl::FinishRequest(std::unique_ptr<CurlRequestState> state,
     http_total_time_ms.Observe(total_time_us / 1000);
   }
 
+  if (state->cancelled_) {
+    // Transfer aborted by a callback since the response is no longer needed.
+    http_request_cancelled.Increment();
+    curl_off_t content_length = -1;
+    state->handle_.GetInfo(CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+    if (content_length >
+        static_cast<curl_off_t>(state->response_payload_size_)) {
+      http_cancelled_bytes_saved.IncrementBy(content_length -
+                                             state->response_payload_size_);
+    }
+    state->response_handler_->OnFailure(
+        absl::CancelledError("HTTP request cancelled"));
+    return;
+  }
+
   if (code != CURLE_OK) {
     /// Transfer failed; set the status
     ABSL_LOG(WARNING) << "Error [" << code << "]=" << curl_easy_strerror(code)
@@ -523,6 +716,15 @@ void MultiTransportImpl::MaybeAddPendingTransfers(ThreadData& thread_data) {
     thread_data.pending.pop_front();
 
     assert(state != nullptr);
+    if (state->response_handler_->IsCancelled()) {
+      // The response is no longer needed; fail without starting the transfer.
+      http_thread_queue_depth.Set(--thread_data.count, thread_data.index);
+      http_request_cancelled.Increment();
+      state->response_handler_->OnFailure(
+          absl::CancelledError("HTTP request cancelled"));
+      continue;
+    }
+
     // Add state to multi handle.
     // Set the CURLINFO_PRIVATE data to take pointer ownership.
     state->handle_.SetOption(CURLOPT_PRIVATE, state.get());
@@ -531,10 +733,11 @@ void MultiTransportImpl::MaybeAddPendingTransfers(ThreadData& thread_data) {
     CURLMcode mcode = curl_multi_add_handle(thread_data.multi.get(), e);
     if (mcode == CURLM_OK) {
       // ownership successfully transferred.
+      state->inflight_.SetState("transfer");
       state.release();
     } else {
       // This shouldn't happen unless things have really gone pear-shaped.
-      thread_data.count--;
+      http_thread_queue_depth.Set(--thread_data.count, thread_data.index);
       state->handle_.SetOption(CURLOPT_PRIVATE, nullptr);
       state->response_handler_->OnFailure(
           CurlMCodeToStatus(mcode, "in curl_multi_add_handle"));
@@ -554,7 +757,7 @@ void MultiTransportImpl::RemoveCompletedTransfers(ThreadData& thread_data) {
       CURLcode result = m->data.result;
       CURL* e = m->easy_handle;
       curl_multi_remove_handle(thread_data.multi.get(), e);
-      thread_data.count--;
+      http_thread_queue_depth.Set(--thread_data.count, thread_data.index);
       CurlRequestState* pvt = nullptr;
       curl_easy_getinfo(e, CURLINFO_PRIVATE, &pvt);
       assert(pvt);
@@ -586,14 +789,37 @@ void CurlTransport::IssueRequestWithHandler(
   impl_->EnqueueRequest(request, std::move(options), response_handler);
 }
 
+int32_t CurlTransport::max_concurrent_streams() const {
+  assert(impl_);
+  return impl_->factory().max_concurrent_streams();
+}
+
+Future<void> CurlTransport::WarmUp(span<const std::string> urls,
+                                   size_t connections) {
+  assert(impl_);
+  return impl_->WarmUp(urls, connections);
+}
+
 namespace {
 struct GlobalTransport {
   std::shared_ptr<HttpTransport> transport_;
 
   std::shared_ptr<HttpTransport> Get() {
     if (!transport_) {
-      transport_ =
+      auto transport =
           std::make_shared<CurlTransport>(GetDefaultCurlHandleFactory());
+      if (auto urls = GetFlagOrEnvValue(FLAGS_tensorstore_http_warmup_urls,
+                                        "TENSORSTORE_HTTP_WARMUP_URLS");
+          urls && !urls->empty()) {
+        // Connections are opened in the background; failures are ignored,
+        // as the connections are otherwise opened on demand.
+        transport->WarmUp(
+            *urls, GetFlagOrEnvValue(FLAGS_tensorstore_http_warmup_connections,
+                                     "TENSORSTORE_HTTP_WARMUP_CONNECTIONS")
+                       .value_or(GetHttpThreads()))
+            .IgnoreFuture();
+      }
+      transport_ = std::move(transport);
     }
     return transport_;
   }
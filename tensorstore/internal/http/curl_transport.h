@@ -15,12 +15,18 @@
 #ifndef TENSORSTORE_INTERNAL_HTTP_CURL_TRANSPORT_H_
 #define TENSORSTORE_INTERNAL_HTTP_CURL_TRANSPORT_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
+#include <string>
 
 #include "tensorstore/internal/http/curl_factory.h"
 #include "tensorstore/internal/http/curl_handle.h"
 #include "tensorstore/internal/http/http_request.h"
 #include "tensorstore/internal/http/http_transport.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal_http {
@@ -43,6 +49,17 @@ class CurlTransport : public HttpTransport {
                                IssueRequestOptions options,
                                HttpResponseHandler* response_handler) override;
 
+  int32_t max_concurrent_streams() const override;
+
+  /// Opens `connections` connections to the host of each of `urls`, so that
+  /// later requests to those hosts reuse them rather than waiting for a DNS
+  /// lookup and a TLS handshake.  Each connection is opened by a `HEAD`
+  /// request for the url, the response to which is discarded.
+  ///
+  /// The returned future becomes ready once all requests have completed, with
+  /// the first error encountered, if any.
+  Future<void> WarmUp(span<const std::string> urls, size_t connections);
+
  private:
   class Impl;
   std::shared_ptr<Impl> impl_;
@@ -19,20 +19,25 @@
 #pragma comment(lib, "ws2_32.lib")
 #endif
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/str_cat.h"
+#include "tensorstore/internal/http/curl_factory.h"
 #include "tensorstore/internal/http/curl_transport.h"
 #include "tensorstore/internal/http/http_transport.h"
 #include "tensorstore/internal/http/transport_test_utils.h"
 #include "tensorstore/internal/thread/thread.h"
 
+using ::tensorstore::internal_http::CurlTransport;
+using ::tensorstore::internal_http::GetDefaultCurlHandleFactory;
 using ::tensorstore::internal_http::HttpRequestBuilder;
 using ::tensorstore::internal_http::IssueRequestOptions;
 using ::tensorstore::transport_test_utils::AcceptNonBlocking;
@@ -187,6 +192,8 @@ TEST_F(CurlTransportTest, Http1Resend) {
     EXPECT_EQ(200, future.value().status_code);
     EXPECT_EQ("<html>\n<body>\n<h1>Hello, World!</h1>\n</body>\n</html>\n",
               future.value().payload);
+    // With a known content-length, the payload is a single flat chunk.
+    EXPECT_TRUE(future.value().payload.TryFlat().has_value());
   }
 
   ABSL_LOG(INFO) << "Wait on server";
@@ -210,4 +217,57 @@ TEST_F(CurlTransportTest, Http1Resend) {
   }
 }
 
+// Tests that a connection opened by WarmUp is reused by a later request.
+TEST_F(CurlTransportTest, WarmUp) {
+  auto transport =
+      std::make_shared<CurlTransport>(GetDefaultCurlHandleFactory());
+
+  auto socket = CreateBoundSocket();
+  ABSL_CHECK(socket.has_value());
+
+  auto hostport = FormatSocketAddress(*socket);
+  ABSL_CHECK(!hostport.empty());
+
+  static constexpr char kResponse[] =  //
+      "HTTP/1.1 200 OK\r\n"
+      "Connection: Keep-Alive\r\n"
+      "Content-Length: 2\r\n"
+      "\r\n";
+
+  // The server accepts a single connection, over which it receives both the
+  // warm-up request and the subsequent request.
+  std::string seen_requests[2];
+  tensorstore::internal::Thread serve_thread({"serve_thread"}, [&] {
+    auto client_fd = AcceptNonBlocking(*socket);
+    ABSL_CHECK(client_fd.has_value());
+    for (int i = 0; i < 2; i++) {
+      while (seen_requests[i].empty()) {
+        seen_requests[i] = ReceiveAvailable(*client_fd);
+      }
+      // The HEAD response has no body.
+      AssertSend(*client_fd, i == 0 ? std::string(kResponse)
+                                    : absl::StrCat(kResponse, "ok"));
+    }
+    CloseSocket(*client_fd);
+  });
+
+  std::vector<std::string> urls{absl::StrCat("http://", hostport, "/")};
+  EXPECT_TRUE(transport->WarmUp(urls, 1).result().ok());
+
+  auto response = transport->IssueRequest(
+      HttpRequestBuilder("GET", absl::StrCat("http://", hostport, "/a"))
+          .BuildRequest(),
+      IssueRequestOptions());
+
+  ABSL_LOG(INFO) << "Wait on server";
+  serve_thread.Join();
+  CloseSocket(*socket);
+
+  EXPECT_THAT(seen_requests[0], HasSubstr("HEAD / "));
+  EXPECT_THAT(seen_requests[1], HasSubstr("GET /a "));
+  ASSERT_TRUE(response.result().ok());
+  EXPECT_EQ(200, response.value().status_code);
+  EXPECT_EQ("ok", response.value().payload);
+}
+
 }  // namespace
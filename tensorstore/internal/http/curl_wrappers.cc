@@ -29,6 +29,7 @@ namespace internal_http {
 void CurlPtrCleanup::operator()(CURL* c) { curl_easy_cleanup(c); }
 void CurlMultiCleanup::operator()(CURLM* m) { curl_multi_cleanup(m); }
 void CurlSlistCleanup::operator()(curl_slist* s) { curl_slist_free_all(s); }
+void CurlShareCleanup::operator()(CURLSH* s) { curl_share_cleanup(s); }
 
 /// Returns the default CurlUserAgent.
 std::string GetCurlUserAgentSuffix() {
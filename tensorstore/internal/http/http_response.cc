@@ -21,6 +21,7 @@
 #include <limits>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "absl/status/status.h"
@@ -141,16 +142,20 @@ Result<ParsedContentRange> ParseContentRangeHeader(
     return absl::FailedPreconditionError(
         "Expected Content-Range header with HTTP 206 response");
   }
+  return ParseContentRange(it->second);
+}
+
+Result<ParsedContentRange> ParseContentRange(std::string_view value) {
   // Expected header format:
   // "bytes <inclusive_start>-<inclusive_end>/<total_size>"
   static const RE2 kContentRangeRegex(R"(^bytes (\d+)-(\d+)/(?:(\d+)|\*))");
   int64_t a, b;
   std::optional<int64_t> total_size;
-  if (!RE2::FullMatch(it->second, kContentRangeRegex, &a, &b, &total_size) ||
+  if (!RE2::FullMatch(value, kContentRangeRegex, &a, &b, &total_size) ||
       a > b || (total_size && b >= *total_size) ||
       b == std::numeric_limits<int64_t>::max()) {
     return absl::FailedPreconditionError(tensorstore::StrCat(
-        "Unexpected Content-Range header received: ", QuoteString(it->second)));
+        "Unexpected Content-Range header received: ", QuoteString(value)));
   }
   return ParsedContentRange{a, b + 1, total_size.value_or(-1)};
 }
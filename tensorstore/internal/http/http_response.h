@@ -19,6 +19,7 @@
 #include <stdint.h>
 
 #include <string>
+#include <string_view>
 #include <tuple>
 
 #include "absl/container/btree_map.h"
@@ -85,6 +86,10 @@ struct ParsedContentRange {
 Result<ParsedContentRange> ParseContentRangeHeader(
     const HttpResponse& response);
 
+/// Parses the value of a "content-range" header, of the form
+/// "bytes <inclusive_start>-<inclusive_end>/<total_size>".
+Result<ParsedContentRange> ParseContentRange(std::string_view value);
+
 }  // namespace internal_http
 }  // namespace tensorstore
 
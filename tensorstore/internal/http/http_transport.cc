@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -27,11 +28,14 @@
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
 #include "riegeli/bytes/cord_writer.h"
+#include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/internal/http/http_header.h"
 #include "tensorstore/internal/http/http_request.h"
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/tracing/trace_span.h"
 #include "tensorstore/util/future.h"
 
 namespace tensorstore {
@@ -53,11 +57,18 @@ class LegacyHttpResponseHandler : public HttpResponseHandler {
   void OnResponseHeader(std::string_view data) override;
   void OnResponseBody(std::string_view data) override;
   void OnComplete() override;
+  bool IsCancelled() override;
 
  private:
   Promise<HttpResponse> promise_;
   absl::Cord data_;
   riegeli::CordWriter<absl::Cord*> writer_;
+  // When the size of the body is known in advance, it is assembled in `flat_`
+  // rather than `writer_`, so that the payload is a single flat chunk which
+  // decoders may use without flattening.  Falls back to `writer_` if more data
+  // than expected is received.
+  std::optional<size_t> flat_size_;
+  internal::FlatCordBuilder flat_;
   int32_t status_code_ = 0;
   absl::btree_multimap<std::string, std::string> headers_;
 };
@@ -75,12 +86,42 @@ void LegacyHttpResponseHandler::OnResponseHeader(std::string_view data) {
   if (content_length) {
     writer_.SetWriteSizeHint(*content_length);
   }
+  if (flat_.size() != 0 || writer_.pos() != 0) {
+    // Trailers received after the body.
+    return;
+  }
+  // A `content-range` may be reported for an encoded body, the decoded size
+  // of which is not known.
+  if (content_length && *content_length > 0 &&
+      headers_.find("content-encoding") == headers_.end()) {
+    flat_size_ = content_length;
+  } else {
+    flat_size_ = std::nullopt;
+  }
 }
 
 void LegacyHttpResponseHandler::OnResponseBody(std::string_view data) {
+  if (flat_size_) {
+    // The buffer is allocated on the first body data, since responses such as
+    // those to HEAD requests report a size but have no body.
+    if (flat_.size() == 0) {
+      flat_ = internal::FlatCordBuilder(*flat_size_, 0);
+    }
+    if (data.size() <= flat_.available()) {
+      flat_.Append(data);
+      return;
+    }
+    writer_.Write(std::move(flat_).Build());
+    flat_size_ = std::nullopt;
+  }
   writer_.Write(data);
 }
 
+bool LegacyHttpResponseHandler::IsCancelled() {
+  // The request may be abandoned once all futures have been released.
+  return !promise_.result_needed();
+}
+
 void LegacyHttpResponseHandler::OnFailure(absl::Status status) {
   ABSL_LOG_IF(INFO, verbose.Level(1)) << status;
   promise_.SetResult(std::move(status));
@@ -89,6 +130,9 @@ void LegacyHttpResponseHandler::OnFailure(absl::Status status) {
 
 void LegacyHttpResponseHandler::OnComplete() {
   writer_.Close();
+  if (flat_.size() != 0) {
+    data_ = std::move(flat_).Build();
+  }
   HttpResponse response{status_code_, std::move(data_), std::move(headers_)};
   ABSL_LOG_IF(INFO, verbose.Level(1)) << response;
   promise_.SetResult(std::move(response));
@@ -99,11 +143,32 @@ void LegacyHttpResponseHandler::OnComplete() {
 
 Future<HttpResponse> HttpTransport::IssueRequest(const HttpRequest& request,
                                                  IssueRequestOptions options) {
+  internal_tracing::TraceSpan span("tensorstore.http.request");
+  std::optional<HttpRequest> traced_request;
+  if (span.active()) {
+    span.SetAttribute("http.method", request.method);
+    span.SetAttribute("http.url", request.url);
+    // Propagate the trace context to the server.
+    traced_request = request;
+    traced_request->headers.push_back(absl::StrCat(
+        "traceparent: ", *internal_tracing::GetCurrentTraceparent()));
+  }
   auto pair = PromiseFuturePair<HttpResponse>::Make();
   ABSL_LOG_IF(INFO, verbose.Level(1)) << request;
   IssueRequestWithHandler(
-      request, std::move(options),
+      traced_request ? *traced_request : request, std::move(options),
       new LegacyHttpResponseHandler(std::move(pair.promise)));
+  if (span.active()) {
+    span.Detach();
+    pair.future.ExecuteWhenReady(
+        [span = std::move(span)](ReadyFuture<HttpResponse> future) mutable {
+          if (future.status().ok()) {
+            span.SetAttribute("http.status_code", future.value().status_code);
+          }
+          span.SetStatus(future.status());
+          span.End();
+        });
+  }
   return std::move(pair.future);
 }
 
@@ -17,14 +17,18 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <string_view>
 #include <utility>
 
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorstore/internal/http/http_request.h"
 #include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/memory_budget.h"
 #include "tensorstore/util/future.h"
 
 namespace tensorstore {
@@ -55,15 +59,37 @@ struct IssueRequestOptions {
     this->request_timeout = request_timeout;
     return std::move(*this);
   }
+  // Limits the request timeout to the time remaining until `deadline`, so
+  // that a request outstanding when an operation's deadline passes is
+  // aborted by the transport.
+  IssueRequestOptions&& SetDeadline(absl::Time deadline) && {
+    if (deadline != absl::InfiniteFuture()) {
+      // A zero timeout means no timeout, so always allow at least 1ms.
+      auto remaining = std::max(deadline - absl::Now(), absl::Milliseconds(1));
+      if (request_timeout == absl::ZeroDuration() ||
+          remaining < request_timeout) {
+        request_timeout = remaining;
+      }
+    }
+    return std::move(*this);
+  }
   IssueRequestOptions&& SetConnectTimeout(absl::Duration connect_timeout) && {
     this->connect_timeout = connect_timeout;
     return std::move(*this);
   }
+  // Charges the response to `memory_budget` while it is being received.
+  // Requests without a payload are not issued until the budget admits them.
+  IssueRequestOptions&& SetMemoryBudget(
+      internal::IntrusivePtr<internal::MemoryBudget> memory_budget) && {
+    this->memory_budget = std::move(memory_budget);
+    return std::move(*this);
+  }
 
   absl::Cord payload;
   absl::Duration request_timeout = absl::ZeroDuration();
   absl::Duration connect_timeout = absl::ZeroDuration();
   HttpVersion http_version = HttpVersion::kDefault;
+  internal::IntrusivePtr<internal::MemoryBudget> memory_budget;
 };
 
 /// Interface used by the HTTP transport to signal data to caller.
@@ -83,7 +109,10 @@ class HttpResponseHandler {
   virtual void OnResponseBody(std::string_view data) = 0;
   // Request has completed with the provided http status code.
   virtual void OnComplete() = 0;
-  // TODO: GetStopToken()
+  // Returns true if the response is no longer needed.  Transports poll this
+  // while the request is queued or in progress, and may abort the request, in
+  // which case OnFailure is invoked with `absl::StatusCode::kCancelled`.
+  virtual bool IsCancelled() { return false; }
 };
 
 /// HttpTransport is an interface class for making http requests.
@@ -103,6 +132,11 @@ class HttpTransport {
   virtual void IssueRequestWithHandler(
       const HttpRequest& request, IssueRequestOptions options,
       HttpResponseHandler* response_handler) = 0;
+
+  /// Returns the maximum number of HTTP/2 requests which are multiplexed over
+  /// a single connection, or 1 if each concurrent request uses a separate
+  /// connection.
+  virtual int32_t max_concurrent_streams() const { return 1; }
 };
 
 }  // namespace internal_http
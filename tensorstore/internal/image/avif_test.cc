@@ -157,4 +157,42 @@ TEST(AvifTest, CorruptData) {
               tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(AvifTest, EncodeMultithreaded) {
+  std::vector<uint8_t> pixels(128 * 128);
+  for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = i % 251;
+
+  AvifWriterOptions options;
+  options.quantizer = 45;
+  options.speed = 10;
+  options.max_threads = 4;
+
+  absl::Cord encoded;
+  {
+    AvifWriter encoder;
+    riegeli::CordWriter cord_writer(&encoded);
+    ASSERT_THAT(encoder.Initialize(&cord_writer, options),
+                ::tensorstore::IsOk());
+    ASSERT_THAT(encoder.Encode(ImageInfo{128, 128, 1}, pixels),
+                ::tensorstore::IsOk());
+    ASSERT_THAT(encoder.Done(), ::tensorstore::IsOk());
+  }
+
+  AvifReader decoder;
+  riegeli::CordReader cord_reader(&encoded);
+  ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+  EXPECT_EQ((ImageInfo{128, 128, 1}), decoder.GetImageInfo());
+  std::vector<uint8_t> new_pixels(pixels.size());
+  EXPECT_THAT(decoder.Decode(new_pixels), tensorstore::IsOk());
+}
+
+TEST(AvifTest, InvalidMaxThreads) {
+  AvifWriterOptions options;
+  options.max_threads = 0;
+  absl::Cord encoded;
+  AvifWriter encoder;
+  riegeli::CordWriter cord_writer(&encoded);
+  EXPECT_THAT(encoder.Initialize(&cord_writer, options),
+              tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
@@ -57,6 +57,11 @@ struct AvifWriterOptions {
   /// quality=45, speed=2 works well.
   int speed = 6;
 
+  /// Maximum number of threads used by the codec to encode an image.  Values
+  /// greater than 1 allow the AV1 encoder to process tiles and rows
+  /// concurrently, which substantially reduces the latency of large images.
+  int max_threads = 1;
+
   /// AVIF stores images as YUV(A); it can convert from RGB(A) when necessary.
   bool input_is_rgb = true;
 };
@@ -14,9 +14,13 @@
 
 #include "tensorstore/internal/image/jpeg_reader.h"
 
+#include <stdint.h>
+
 #include <cassert>
 #include <csetjmp>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
@@ -171,6 +175,53 @@ ImageInfo GetJpegImageInfo(::jpeg_decompress_struct* cinfo) {
   return info;
 }
 
+bool HasCrop(const JpegReaderOptions& options) {
+  return options.crop_width != 0 && options.crop_height != 0;
+}
+
+/// Returns the info of the image decoded with `options`.
+///
+/// libjpeg computes the scaled dimensions by rounding up.
+ImageInfo GetJpegOutputInfo(::jpeg_decompress_struct* cinfo,
+                            const JpegReaderOptions& options) {
+  ImageInfo info = GetJpegImageInfo(cinfo);
+  if (HasCrop(options)) {
+    info.width = options.crop_width;
+    info.height = options.crop_height;
+  } else if (options.scale_denom > 1) {
+    info.width = (info.width + options.scale_denom - 1) / options.scale_denom;
+    info.height =
+        (info.height + options.scale_denom - 1) / options.scale_denom;
+  }
+  return info;
+}
+
+absl::Status ValidateJpegReaderOptions(::jpeg_decompress_struct* cinfo,
+                                       const JpegReaderOptions& options) {
+  if (options.scale_denom != 1 && options.scale_denom != 2 &&
+      options.scale_denom != 4 && options.scale_denom != 8) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "JPEG scale_denom must be 1, 2, 4, or 8, but received: %d",
+        options.scale_denom));
+  }
+  if (!HasCrop(options)) return absl::OkStatus();
+  JpegReaderOptions scaled_options;
+  scaled_options.scale_denom = options.scale_denom;
+  auto scaled_info = GetJpegOutputInfo(cinfo, scaled_options);
+  if (options.crop_x < 0 || options.crop_y < 0 || options.crop_width < 0 ||
+      options.crop_height < 0 ||
+      options.crop_width > scaled_info.width - options.crop_x ||
+      options.crop_height > scaled_info.height - options.crop_y) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "JPEG crop region [%d, %d) x [%d, %d) is not contained in the %d x %d "
+        "scaled image",
+        options.crop_x, options.crop_x + options.crop_width, options.crop_y,
+        options.crop_y + options.crop_height, scaled_info.width,
+        scaled_info.height));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 struct JpegReader::Context {
@@ -249,11 +300,29 @@ absl::Status JpegReader::Context::Decode(tensorstore::span<unsigned char> dest,
     return absl::InternalError("");
   }
 
+  TENSORSTORE_RETURN_IF_ERROR(ValidateJpegReaderOptions(&cinfo_, options));
+
   // Validate the image is compatible.
-  auto info = GetJpegImageInfo(&cinfo_);
+  auto info = GetJpegOutputInfo(&cinfo_, options);
   ABSL_CHECK_EQ(dest.size(), ImageRequiredBytes(info));
 
+  cinfo_.scale_num = 1;
+  cinfo_.scale_denom = options.scale_denom;
+
   ImageView dest_view(info, dest);
+  const bool crop = HasCrop(options);
+
+  // When cropping, libjpeg expands the region horizontally to block
+  // boundaries, so rows are decoded into `row_buffer` and then copied.
+  std::vector<JSAMPLE> row_buffer;
+  if (crop) {
+    JpegReaderOptions scaled_options;
+    scaled_options.scale_denom = options.scale_denom;
+    auto scaled_info = GetJpegOutputInfo(&cinfo_, scaled_options);
+    row_buffer.resize(static_cast<size_t>(scaled_info.width) *
+                      scaled_info.num_components);
+  }
+
   bool ok = [&]() {
     // Setjump is problematic with C++; by convention we put it in a
     // lambda which has no variables requiring cleanup.
@@ -265,16 +334,45 @@ absl::Status JpegReader::Context::Decode(tensorstore::span<unsigned char> dest,
     ::jpeg_start_decompress(&cinfo_);
     started_ = true;
 
-    // ... then read each scanline
-    while (cinfo_.output_scanline < cinfo_.output_height) {
-      auto* output_line = reinterpret_cast<JSAMPLE*>(
-          dest_view.data_row(cinfo_.output_scanline).data());
+    if (!crop) {
+      // ... then read each scanline
+      while (cinfo_.output_scanline < cinfo_.output_height) {
+        auto* output_line = reinterpret_cast<JSAMPLE*>(
+            dest_view.data_row(cinfo_.output_scanline).data());
+        if (::jpeg_read_scanlines(&cinfo_, &output_line, 1) != 1) {
+          error_.last_error.Update(absl::DataLossError(absl::StrFormat(
+              "Cannot read JPEG; data ended after %d/%d scan lines",
+              cinfo_.output_scanline, cinfo_.output_height)));
+          return false;
+        }
+      }
+      return true;
+    }
+
+    JDIMENSION xoffset = options.crop_x;
+    JDIMENSION width = options.crop_width;
+    ::jpeg_crop_scanline(&cinfo_, &xoffset, &width);
+    const size_t pixel_bytes = cinfo_.output_components;
+    const size_t column_offset = (options.crop_x - xoffset) * pixel_bytes;
+    if (options.crop_y > 0 &&
+        ::jpeg_skip_scanlines(&cinfo_, options.crop_y) !=
+            static_cast<JDIMENSION>(options.crop_y)) {
+      error_.last_error.Update(absl::DataLossError(absl::StrFormat(
+          "Cannot read JPEG; data ended after %d/%d scan lines",
+          cinfo_.output_scanline, cinfo_.output_height)));
+      return false;
+    }
+    for (int32_t y = 0; y < options.crop_height; ++y) {
+      JSAMPLE* output_line = row_buffer.data();
       if (::jpeg_read_scanlines(&cinfo_, &output_line, 1) != 1) {
         error_.last_error.Update(absl::DataLossError(absl::StrFormat(
             "Cannot read JPEG; data ended after %d/%d scan lines",
             cinfo_.output_scanline, cinfo_.output_height)));
         return false;
       }
+      std::memcpy(dest_view.data_row(y).data(),
+                  row_buffer.data() + column_offset,
+                  options.crop_width * pixel_bytes);
     }
     return true;
   }();
@@ -319,6 +417,11 @@ ImageInfo JpegReader::GetImageInfo() {
   return GetJpegImageInfo(&context_->cinfo_);
 }
 
+ImageInfo JpegReader::GetImageInfo(const JpegReaderOptions& options) {
+  if (!context_) return {};
+  return GetJpegOutputInfo(&context_->cinfo_, options);
+}
+
 absl::Status JpegReader::DecodeImpl(tensorstore::span<unsigned char> dest,
                                     const JpegReaderOptions& options) {
   if (!context_) {
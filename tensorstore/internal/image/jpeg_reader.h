@@ -15,6 +15,11 @@
 #ifndef TENSORSTORE_INTERNAL_IMAGE_JPEG_READER_H_
 #define TENSORSTORE_INTERNAL_IMAGE_JPEG_READER_H_
 
+#include <stdint.h>
+
+#include <memory>
+
+#include "absl/status/status.h"
 #include "riegeli/bytes/reader.h"
 #include "tensorstore/internal/image/image_info.h"
 #include "tensorstore/internal/image/image_reader.h"
@@ -23,7 +28,22 @@
 namespace tensorstore {
 namespace internal_image {
 
-struct JpegReaderOptions {};
+struct JpegReaderOptions {
+  /// Decodes the image reduced in size by this factor, which must be 1, 2, 4,
+  /// or 8.  The reduction is performed in the DCT domain, which skips most of
+  /// the inverse DCT work; the result approximates, but does not exactly
+  /// equal, an area-averaged downsampling of the full-resolution image.
+  int scale_denom = 1;
+
+  /// Region of the scaled image to decode.  If `crop_width` or `crop_height`
+  /// is 0, the entire scaled image is decoded.  Rows before the region are
+  /// skipped without being fully decoded, and only the columns of blocks
+  /// that intersect the region are decoded.
+  int32_t crop_x = 0;
+  int32_t crop_y = 0;
+  int32_t crop_width = 0;
+  int32_t crop_height = 0;
+};
 
 class JpegReader : public ImageReader {
  public:
@@ -41,6 +61,9 @@ class JpegReader : public ImageReader {
   // Returns the current ImageInfo.
   ImageInfo GetImageInfo() override;
 
+  // Returns the ImageInfo of the output of `Decode` with `options`.
+  ImageInfo GetImageInfo(const JpegReaderOptions& options);
+
   // Decodes the next available image into 'dest'.
   absl::Status Decode(tensorstore::span<unsigned char> dest) override {
     return DecodeImpl(dest, {});
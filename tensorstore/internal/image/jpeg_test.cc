@@ -14,7 +14,10 @@
 
 #include <stddef.h>
 
+#include <stdint.h>
+
 #include <cmath>
+#include <cstdlib>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -27,13 +30,16 @@
 #include "tensorstore/internal/image/jpeg_writer.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
 
 namespace {
 
 using ::tensorstore::internal_image::ImageInfo;
 using ::tensorstore::internal_image::JpegReader;
+using ::tensorstore::internal_image::JpegReaderOptions;
 using ::tensorstore::internal_image::JpegWriter;
+using ::tensorstore::internal_image::JpegWriterOptions;
 
 TEST(JpegTest, Decode) {
   // Started the same as the png image, but very much the worse for wear after
@@ -298,4 +304,122 @@ TEST(JpegTest, InvalidNumComponents) {
   }
 }
 
+// Encodes a grayscale gradient image.
+absl::Cord EncodeGradient(int width, int height) {
+  std::vector<uint8_t> pixels(width * height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      pixels[y * width + x] = static_cast<uint8_t>(2 * x + y);
+    }
+  }
+  absl::Cord encoded;
+  JpegWriter encoder;
+  riegeli::CordWriter cord_writer(&encoded);
+  JpegWriterOptions options;
+  options.quality = 95;
+  TENSORSTORE_CHECK_OK(encoder.Initialize(&cord_writer, options));
+  TENSORSTORE_CHECK_OK(encoder.Encode(ImageInfo{height, width, 1}, pixels));
+  TENSORSTORE_CHECK_OK(encoder.Done());
+  return encoded;
+}
+
+std::vector<uint8_t> DecodeWithOptions(const absl::Cord& encoded,
+                                       const JpegReaderOptions& options) {
+  JpegReader decoder;
+  riegeli::CordReader cord_reader(&encoded);
+  TENSORSTORE_CHECK_OK(decoder.Initialize(&cord_reader));
+  std::vector<uint8_t> pixels(
+      ImageRequiredBytes(decoder.GetImageInfo(options)));
+  TENSORSTORE_CHECK_OK(decoder.Decode(pixels, options));
+  return pixels;
+}
+
+TEST(JpegTest, ScaledDecode) {
+  auto encoded = EncodeGradient(64, 48);
+  auto full = DecodeWithOptions(encoded, {});
+  for (int scale_denom : {2, 4, 8}) {
+    SCOPED_TRACE(scale_denom);
+    JpegReaderOptions options;
+    options.scale_denom = scale_denom;
+    JpegReader decoder;
+    riegeli::CordReader cord_reader(&encoded);
+    ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+    auto info = decoder.GetImageInfo(options);
+    EXPECT_EQ(64 / scale_denom, info.width);
+    EXPECT_EQ(48 / scale_denom, info.height);
+    std::vector<uint8_t> scaled(ImageRequiredBytes(info));
+    ASSERT_THAT(decoder.Decode(scaled, options), ::tensorstore::IsOk());
+
+    // Each output pixel approximates the mean of the corresponding block.
+    for (int y = 0; y < info.height; ++y) {
+      for (int x = 0; x < info.width; ++x) {
+        int sum = 0;
+        for (int i = 0; i < scale_denom; ++i) {
+          for (int j = 0; j < scale_denom; ++j) {
+            sum += full[(y * scale_denom + i) * 64 + x * scale_denom + j];
+          }
+        }
+        const int mean = sum / (scale_denom * scale_denom);
+        EXPECT_LE(std::abs(mean - scaled[y * info.width + x]), 8)
+            << "x=" << x << ", y=" << y;
+      }
+    }
+  }
+}
+
+TEST(JpegTest, CroppedDecode) {
+  auto encoded = EncodeGradient(64, 48);
+  for (int scale_denom : {1, 2}) {
+    SCOPED_TRACE(scale_denom);
+    JpegReaderOptions options;
+    options.scale_denom = scale_denom;
+    const int scaled_width = 64 / scale_denom;
+    auto scaled = DecodeWithOptions(encoded, options);
+
+    options.crop_x = 5;
+    options.crop_y = 9;
+    options.crop_width = 17;
+    options.crop_height = 11;
+    auto cropped = DecodeWithOptions(encoded, options);
+    ASSERT_EQ(17 * 11, cropped.size());
+    for (int y = 0; y < 11; ++y) {
+      for (int x = 0; x < 17; ++x) {
+        EXPECT_EQ(scaled[(y + 9) * scaled_width + x + 5], cropped[y * 17 + x])
+            << "x=" << x << ", y=" << y;
+      }
+    }
+  }
+}
+
+TEST(JpegTest, InvalidDecodeOptions) {
+  auto encoded = EncodeGradient(16, 16);
+  {
+    JpegReaderOptions options;
+    options.scale_denom = 3;
+    JpegReader decoder;
+    riegeli::CordReader cord_reader(&encoded);
+    ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+    std::vector<uint8_t> pixels(
+        ImageRequiredBytes(decoder.GetImageInfo(options)));
+    EXPECT_THAT(decoder.Decode(pixels, options),
+                tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument,
+                                           ".*scale_denom.*"));
+  }
+  {
+    JpegReaderOptions options;
+    options.scale_denom = 2;
+    options.crop_x = 4;
+    options.crop_width = 5;
+    options.crop_height = 1;
+    JpegReader decoder;
+    riegeli::CordReader cord_reader(&encoded);
+    ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+    std::vector<uint8_t> pixels(
+        ImageRequiredBytes(decoder.GetImageInfo(options)));
+    EXPECT_THAT(decoder.Decode(pixels, options),
+                tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument,
+                                           ".*crop region.*"));
+  }
+}
+
 }  // namespace
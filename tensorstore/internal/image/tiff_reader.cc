@@ -19,6 +19,7 @@
 #include <stdio.h>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <memory>
@@ -56,7 +57,8 @@ struct TiffReader::Context : public LibTiffErrorBase {
   absl::Status ExtractErrors(absl::Status in);
 
   absl::Status Open();
-  absl::Status DefaultDecode(tensorstore::span<unsigned char> data);
+  absl::Status DefaultDecode(tensorstore::span<unsigned char> data,
+                             const TiffReaderOptions& options);
 };
 
 namespace {
@@ -258,34 +260,70 @@ absl::Status GetTIFFImageInfo(TIFF* tiff, TiffImageInfo& info) {
   return absl::OkStatus();
 }
 
-absl::Status ReadStripImpl(TIFF* tiff, TiffImageInfo& info,
-                           tensorstore::span<unsigned char> data) {
-  ImageView dest_view(info, data);
-
-  // Translate 1,2,4 bits per sample to 8-bpp images.
-  const unsigned char* mapping = nullptr;
-  ptrdiff_t trstride = 1;
-  if (info.bits_per_sample_ == 1) {
-    mapping = TranslateBits<1>(trstride);
-  } else if (info.bits_per_sample_ == 2) {
-    mapping = TranslateBits<2>(trstride);
-  } else if (info.bits_per_sample_ == 4) {
-    mapping = TranslateBits<4>(trstride);
+/// Returns the mapping used to expand samples of 1, 2 or 4 bits to bytes, or
+/// `nullptr` if samples are byte-aligned.
+const unsigned char* GetBitsMapping(const TiffImageInfo& info,
+                                    ptrdiff_t& trstride) {
+  trstride = 1;
+  if (info.bits_per_sample_ == 1) return TranslateBits<1>(trstride);
+  if (info.bits_per_sample_ == 2) return TranslateBits<2>(trstride);
+  if (info.bits_per_sample_ == 4) return TranslateBits<4>(trstride);
+  return nullptr;
+}
+
+/// Copies `width` pixels starting at pixel `x` of the decoded `source_row`
+/// to `target_row`, expanding packed samples using `mapping`.
+void CopyRow(const TiffImageInfo& info, const unsigned char* source_row,
+             size_t x, size_t width, const unsigned char* mapping,
+             ptrdiff_t trstride, unsigned char* target_row) {
+  if (!mapping) {
+    const size_t pixel_bytes =
+        (info.bits_per_sample_ / 8) * info.num_components;
+    memcpy(target_row, source_row + x * pixel_bytes, width * pixel_bytes);
+    return;
+  }
+  const size_t n = width * info.num_components;
+  for (size_t i = 0, j = x * info.num_components; i < n; ++i, ++j) {
+    target_row[i] = mapping[source_row[j / trstride] * trstride + j % trstride];
   }
+}
 
-  const int strip_bytes = TIFFStripSize(tiff);
+absl::Status ReadStripImpl(TIFF* tiff, const TiffImageInfo& info,
+                           const TiffReaderOptions::Region& region,
+                           tensorstore::span<unsigned char> data) {
+  ImageView dest_view(
+      ImageInfo{/*.height=*/static_cast<int32_t>(region.height),
+                /*.width=*/static_cast<int32_t>(region.width),
+                /*.num_components=*/info.num_components,
+                /*.dtype=*/info.dtype},
+      data);
+
+  ptrdiff_t trstride;
+  const unsigned char* mapping = GetBitsMapping(info, trstride);
+
+  const size_t strip_bytes = TIFFStripSize(tiff);
+  const size_t line_bytes = TIFFScanlineSize(tiff);
   uint32_t rows_per_strip = 1;
   TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
+  const size_t strip_height =
+      std::min<size_t>(rows_per_strip, static_cast<size_t>(info.height));
+
+  // Only the strips that intersect the region are read.
+  const size_t y_start = region.y - region.y % strip_height;
+  const size_t y_end = region.y + region.height;
 
-  if (!mapping &&
-      strip_bytes == rows_per_strip * dest_view.row_stride_bytes()) {
+  if (!mapping && y_start == region.y && region.x == 0 &&
+      region.width == static_cast<size_t>(info.width) &&
+      line_bytes == static_cast<size_t>(dest_view.row_stride_bytes()) &&
+      strip_bytes == strip_height * line_bytes) {
     /// No extra data && no mapping means that the TIFF can be read directly
     /// into the output buffer.
-    for (size_t y = 0; y < info.height; y += rows_per_strip) {
-      // Read the strip.
+    for (size_t y = y_start; y < y_end; y += strip_height) {
+      // Read the strip, or the part of it within the region.
+      const size_t rows = std::min(strip_height, y_end - y);
       if (TIFFReadEncodedStrip(tiff, TIFFComputeStrip(tiff, y, 0),
-                               dest_view.data_row(y).data(),
-                               strip_bytes) == -1) {
+                               dest_view.data_row(y - region.y).data(),
+                               rows * line_bytes) == -1) {
         return absl::DataLossError("TIFF read strip failed");
       }
     }
@@ -293,86 +331,64 @@ absl::Status ReadStripImpl(TIFF* tiff, TiffImageInfo& info,
   }
 
   std::unique_ptr<unsigned char[]> buffer(new unsigned char[strip_bytes]);
-  uint32_t line_bytes =
-      info.width * (info.bits_per_sample_ / 8) * info.num_components;
-
-  for (size_t y = 0; y < info.height; y += rows_per_strip) {
+  for (size_t y = y_start; y < y_end; y += strip_height) {
     // Read the strip.
     if (TIFFReadEncodedStrip(tiff, TIFFComputeStrip(tiff, y, 0), buffer.get(),
                              strip_bytes) == -1) {
       return absl::DataLossError("TIFF read strip failed");
     }
-
-    unsigned char* source_row = buffer.get();
-    for (size_t r = 0; r < rows_per_strip; r++) {
-      if (y + r >= info.height) break;
-      auto target_row = dest_view.data_row(y + r);
-
-      if (info.bits_per_sample_ >= 8) {
-        assert(line_bytes == dest_view.row_stride_bytes());
-        memcpy(target_row.data(), source_row, line_bytes);
-        source_row += line_bytes;
-      } else {
-        while (!target_row.empty()) {
-          size_t n = std::min(trstride, target_row.size());
-          memcpy(target_row.data(), mapping + (*source_row * trstride), n);
-          target_row = target_row.subspan(n);
-          source_row++;
-        }
-      }
+    const size_t row_end = std::min(y + strip_height, y_end);
+    for (size_t row = std::max(y, region.y); row < row_end; ++row) {
+      CopyRow(info, buffer.get() + (row - y) * line_bytes, region.x,
+              region.width, mapping, trstride,
+              dest_view.data_row(row - region.y).data());
     }
   }
   return absl::OkStatus();
 }
 
-absl::Status ReadTiledImpl(TIFF* tiff, TiffImageInfo& info,
+absl::Status ReadTiledImpl(TIFF* tiff, const TiffImageInfo& info,
+                           const TiffReaderOptions::Region& region,
                            tensorstore::span<unsigned char> data) {
-  ImageView dest_view(info, data);
-
-  // Translate 1,2,4 bits per sample to 8-bpp images.
-  const unsigned char* mapping = nullptr;
-  ptrdiff_t trstride = 1;
-  if (info.bits_per_sample_ == 1) {
-    mapping = TranslateBits<1>(trstride);
-  } else if (info.bits_per_sample_ == 2) {
-    mapping = TranslateBits<2>(trstride);
-  } else if (info.bits_per_sample_ == 4) {
-    mapping = TranslateBits<4>(trstride);
-  }
+  ImageView dest_view(
+      ImageInfo{/*.height=*/static_cast<int32_t>(region.height),
+                /*.width=*/static_cast<int32_t>(region.width),
+                /*.num_components=*/info.num_components,
+                /*.dtype=*/info.dtype},
+      data);
+  const size_t dest_pixel_bytes = info.num_components * info.dtype.size();
+
+  ptrdiff_t trstride;
+  const unsigned char* mapping = GetBitsMapping(info, trstride);
 
   uint32_t tile_width, tile_height;
   TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &tile_width);
   TIFFGetField(tiff, TIFFTAG_TILELENGTH, &tile_height);
 
-  const int tile_bytes = TIFFTileSize(tiff);
+  const size_t tile_bytes = TIFFTileSize(tiff);
+  const size_t tile_row_bytes = TIFFTileRowSize(tiff);
   std::unique_ptr<unsigned char[]> tile_buffer(new unsigned char[tile_bytes]);
-  ImageView tile_view(ImageInfo{/*.height=*/static_cast<int32_t>(tile_height),
-                                /*.width=*/static_cast<int32_t>(tile_width),
-                                /*.num_components=*/info.num_components},
-                      {tile_buffer.get(), tile_bytes});
 
-  for (size_t y = 0; y < info.height; y += tile_height) {
-    for (size_t x = 0; x < info.width; x += tile_width) {
+  // Only the tiles that intersect the region are read.
+  const size_t y_end = region.y + region.height;
+  const size_t x_end = region.x + region.width;
+  for (size_t y = region.y - region.y % tile_height; y < y_end;
+       y += tile_height) {
+    for (size_t x = region.x - region.x % tile_width; x < x_end;
+         x += tile_width) {
       if (TIFFReadTile(tiff, tile_buffer.get(), x, y, 0, 0) == -1) {
         return absl::DataLossError("TIFF read tile failed");
       }
-      for (size_t y1 = 0; y1 < tile_height; y1++) {
-        if ((y + y1) >= info.height) break;
-        auto target_row = dest_view.data_row(y + y1, x);
-        auto tile_row = tile_view.data_row(y1);
-        if (info.bits_per_sample_ >= 8) {
-          memcpy(target_row.data(), tile_row.data(),
-                 std::min(target_row.size(), tile_row.size()));
-        } else {
-          unsigned char* packed = tile_row.data();
-          while (!target_row.empty()) {
-            size_t n = std::min(trstride, target_row.size());
-            memcpy(target_row.data(), mapping + (*packed * trstride), n);
-            target_row = target_row.subspan(n);
-            packed++;
-          }
-          assert(packed <= tile_row.data() + tile_row.size());
-        }
+      const size_t x0 = std::max(x, region.x);
+      const size_t x1 = std::min<size_t>(x + tile_width, x_end);
+      const size_t row_end = std::min<size_t>(y + tile_height, y_end);
+      for (size_t row = std::max(y, region.y); row < row_end; ++row) {
+        CopyRow(info, tile_buffer.get() + (row - y) * tile_row_bytes, x0 - x,
+                x1 - x0, mapping, trstride,
+                dest_view
+                    .data_row(row - region.y, (x0 - region.x) *
+                                                  dest_pixel_bytes)
+                    .data());
       }
     }
   }
@@ -424,10 +440,30 @@ absl::Status TiffReader::Context::Open() {
 }
 
 absl::Status TiffReader::Context::DefaultDecode(
-    tensorstore::span<unsigned char> data) {
+    tensorstore::span<unsigned char> data, const TiffReaderOptions& options) {
   TiffImageInfo info;
   TENSORSTORE_RETURN_IF_ERROR(GetTIFFImageInfo(tiff_, info));
-  ABSL_CHECK_EQ(data.size(), ImageRequiredBytes(info));
+
+  TiffReaderOptions::Region region;
+  if (options.region) {
+    region = *options.region;
+    if (region.y + region.height > static_cast<size_t>(info.height) ||
+        region.x + region.width > static_cast<size_t>(info.width)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "TIFF read failed: region [%d, %d) x [%d, %d) exceeds image bounds "
+          "%dx%d",
+          region.y, region.y + region.height, region.x,
+          region.x + region.width, info.height, info.width));
+    }
+  } else {
+    region.height = info.height;
+    region.width = info.width;
+  }
+  ImageInfo region_info = info;
+  region_info.height = region.height;
+  region_info.width = region.width;
+  ABSL_CHECK_EQ(data.size(), ImageRequiredBytes(region_info));
+  if (region.height == 0 || region.width == 0) return absl::OkStatus();
 
   // Additional fields checks (beyond the info)
   uint32_t compress_tag = 0;
@@ -476,9 +512,9 @@ absl::Status TiffReader::Context::DefaultDecode(
 
   absl::Status status;
   if (TIFFIsTiled(tiff_)) {
-    status = ReadTiledImpl(tiff_, info, data);
+    status = ReadTiledImpl(tiff_, info, region, data);
   } else {
-    status = ReadStripImpl(tiff_, info, data);
+    status = ReadStripImpl(tiff_, info, region, data);
   }
 
   return ExtractErrors(status);
@@ -534,7 +570,23 @@ absl::Status TiffReader::DecodeImpl(tensorstore::span<unsigned char> dest,
   if (!context_) {
     return absl::InternalError("No TIFF file to decode");
   }
-  return context_->DefaultDecode(dest);
+  return context_->DefaultDecode(dest, options);
+}
+
+std::array<size_t, 2> TiffReader::GetChunkShape() {
+  if (!context_) return {0, 0};
+  TiffImageInfo info;
+  if (!GetTIFFImageInfo(context_->tiff_, info).ok()) return {0, 0};
+  if (TIFFIsTiled(context_->tiff_)) {
+    uint32_t tile_width = 0, tile_height = 0;
+    TIFFGetField(context_->tiff_, TIFFTAG_TILEWIDTH, &tile_width);
+    TIFFGetField(context_->tiff_, TIFFTAG_TILELENGTH, &tile_height);
+    return {tile_height, tile_width};
+  }
+  uint32_t rows_per_strip = 1;
+  TIFFGetFieldDefaulted(context_->tiff_, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
+  return {std::min<size_t>(rows_per_strip, static_cast<size_t>(info.height)),
+          static_cast<size_t>(info.width)};
 }
 
 }  // namespace internal_image
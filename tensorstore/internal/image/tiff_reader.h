@@ -15,7 +15,11 @@
 #ifndef TENSORSTORE_INTERNAL_IMAGE_TIFF_READER_H_
 #define TENSORSTORE_INTERNAL_IMAGE_TIFF_READER_H_
 
+#include <stddef.h>
+
+#include <array>
 #include <memory>
+#include <optional>
 
 #include "absl/status/status.h"
 #include "riegeli/bytes/reader.h"
@@ -26,7 +30,20 @@
 namespace tensorstore {
 namespace internal_image {
 
-struct TiffReaderOptions {};
+struct TiffReaderOptions {
+  /// Rectangular region of an image, in pixels.
+  struct Region {
+    size_t y = 0;
+    size_t x = 0;
+    size_t height = 0;
+    size_t width = 0;
+  };
+
+  /// Region of the image to decode.  The destination buffer holds just the
+  /// region, and only the tiles or strips that intersect it are read and
+  /// decompressed.  If not specified, the entire image is decoded.
+  std::optional<Region> region;
+};
 
 class TiffReader : public ImageReader {
  public:
@@ -55,6 +72,10 @@ class TiffReader : public ImageReader {
   // Returns the current ImageInfo.
   ImageInfo GetImageInfo() override;
 
+  // Returns the shape `{height, width}` of the tiles, or of the strips, in
+  // which the current frame is stored.
+  std::array<size_t, 2> GetChunkShape();
+
   // Decodes the next available image into 'dest'.
   absl::Status Decode(tensorstore::span<unsigned char> dest) override {
     return DecodeImpl(dest, {});
@@ -15,9 +15,11 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -43,6 +45,7 @@ namespace {
 
 using ::tensorstore::internal_image::ImageInfo;
 using ::tensorstore::internal_image::TiffReader;
+using ::tensorstore::internal_image::TiffReaderOptions;
 using ::tensorstore::internal_image::TiffWriter;
 using ::tensorstore::internal_image::TiffWriterOptions;
 
@@ -195,6 +198,59 @@ TEST_F(TiffTest, ReadMultiPage) {
   }
 }
 
+// Decoding a region reads only the intersecting tiles or strips, and yields
+// the same pixels as decoding the entire image.
+TEST_F(TiffTest, ReadRegion) {
+  for (const char* name :
+       {"tiff/D75_08b_tiled.tiff", "tiff/D75_08b_scanline.tiff"}) {
+    SCOPED_TRACE(name);
+    absl::Cord file_data;
+    {
+      std::string filename = tensorstore::internal::JoinPath(
+          absl::GetFlag(FLAGS_tensorstore_test_data_dir), name);
+      TENSORSTORE_ASSERT_OK(
+          riegeli::ReadAll(riegeli::FdReader(filename), file_data));
+    }
+    riegeli::CordReader cord_reader(&file_data);
+    TiffReader decoder;
+    ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+    const auto info = decoder.GetImageInfo();
+    const auto chunk_shape = decoder.GetChunkShape();
+    EXPECT_LT(0, chunk_shape[0]);
+    EXPECT_LT(0, chunk_shape[1]);
+
+    std::vector<unsigned char> image(ImageRequiredBytes(info));
+    ASSERT_THAT(decoder.Decode(image), ::tensorstore::IsOk());
+
+    TiffReaderOptions options;
+    options.region = {/*.y=*/17, /*.x=*/33, /*.height=*/50, /*.width=*/70};
+    ImageInfo region_info = info;
+    region_info.height = options.region->height;
+    region_info.width = options.region->width;
+    std::vector<unsigned char> region(ImageRequiredBytes(region_info));
+    ASSERT_THAT(decoder.Decode(region, options), ::tensorstore::IsOk());
+
+    const size_t pixel_bytes = info.num_components * info.dtype.size();
+    const size_t row_bytes = options.region->width * pixel_bytes;
+    for (size_t y = 0; y < options.region->height; ++y) {
+      const size_t offset =
+          ((options.region->y + y) * info.width + options.region->x) *
+          pixel_bytes;
+      EXPECT_TRUE(std::equal(region.begin() + y * row_bytes,
+                             region.begin() + (y + 1) * row_bytes,
+                             image.begin() + offset))
+          << "row " << y;
+    }
+
+    options.region = {/*.y=*/0, /*.x=*/0, /*.height=*/1,
+                      /*.width=*/static_cast<size_t>(info.width) + 1};
+    std::vector<unsigned char> row(ImageRequiredBytes(
+        ImageInfo{1, info.width + 1, info.num_components, info.dtype}));
+    EXPECT_THAT(decoder.Decode(row, options),
+                tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument));
+  }
+}
+
 TEST_F(TiffTest, CorruptData) {
   static constexpr unsigned char data[] = {
       0x49, 0x49, 0x2a, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x00,
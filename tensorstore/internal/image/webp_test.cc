@@ -114,4 +114,42 @@ TEST(WebPTest, CorruptData) {
               tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(WebPTest, EncodeFastMultithreaded) {
+  std::vector<uint8_t> pixels(64 * 64 * 3);
+  for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = i % 251;
+
+  WebPWriterOptions options;
+  options.lossless = false;
+  options.method = 0;
+  options.multithreaded = true;
+
+  absl::Cord encoded;
+  {
+    WebPWriter encoder;
+    riegeli::CordWriter cord_writer(&encoded);
+    ASSERT_THAT(encoder.Initialize(&cord_writer, options),
+                ::tensorstore::IsOk());
+    ASSERT_THAT(encoder.Encode(ImageInfo{64, 64, 3}, pixels),
+                ::tensorstore::IsOk());
+    ASSERT_THAT(encoder.Done(), ::tensorstore::IsOk());
+  }
+
+  WebPReader decoder;
+  riegeli::CordReader cord_reader(&encoded);
+  ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+  EXPECT_EQ((ImageInfo{64, 64, 3}), decoder.GetImageInfo());
+  std::vector<uint8_t> new_pixels(pixels.size());
+  EXPECT_THAT(decoder.Decode(new_pixels), tensorstore::IsOk());
+}
+
+TEST(WebPTest, InvalidMethod) {
+  WebPWriterOptions options;
+  options.method = 7;
+  absl::Cord encoded;
+  WebPWriter encoder;
+  riegeli::CordWriter cord_writer(&encoded);
+  EXPECT_THAT(encoder.Initialize(&cord_writer, options),
+              tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
@@ -54,7 +54,8 @@ absl::Status EncodeWebP(riegeli::Writer* writer,
   }
   config.lossless = options.lossless ? 1 : 0;
   config.quality = options.quality;
-  config.method = 6;
+  config.method = options.method;
+  config.thread_level = options.multithreaded ? 1 : 0;
   config.exact = (info.num_components == 4) ? 1 : 0;  // Keep alpha channel.
   ABSL_CHECK(WebPValidateConfig(&config));
 
@@ -117,6 +118,10 @@ absl::Status WebPWriter::InitializeImpl(riegeli::Writer* writer,
     return absl::InvalidArgumentError(
         "WEBP quality option must be in the range [0.. 100]");
   }
+  if (options.method < 0 || options.method > 6) {
+    return absl::InvalidArgumentError(
+        "WEBP method option must be in the range [0.. 6]");
+  }
   writer_ = writer;
   options_ = options;
   return absl::OkStatus();
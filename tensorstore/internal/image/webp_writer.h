@@ -34,6 +34,14 @@ struct WebPWriterOptions {
   /// Quality ia a value between [0..100] and reflects cpu cost for compression
   /// (in lossless), or a relative perceptual loss (lossy).
   int quality = 95;
+
+  /// Compression method, between [0..6], trading encoding speed (0 is fastest)
+  /// for output size (6 is smallest).
+  int method = 6;
+
+  /// Whether the encoder may use additional threads for the parts of
+  /// encoding that support it.
+  bool multithreaded = false;
 };
 
 class WebPWriter : public ImageWriter {
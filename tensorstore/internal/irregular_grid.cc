@@ -29,6 +29,12 @@
 
 namespace tensorstore {
 namespace internal {
+namespace {
+
+// Dimensions with fewer grid points are searched directly.
+constexpr size_t kMinPointsForBuckets = 16;
+
+}  // namespace
 
 IrregularGrid::IrregularGrid(std::vector<std::vector<Index>> inclusive_mins)
     : shape_(inclusive_mins.size(), 0),
@@ -42,13 +48,62 @@ IrregularGrid::IrregularGrid(std::vector<std::vector<Index>> inclusive_mins)
         std::distance(inclusive_mins_[i].begin(), new_it));
     shape_[i] = inclusive_mins_[i].size() - 1;
   }
+  InitializeBuckets();
+}
+
+void IrregularGrid::InitializeBuckets() {
+  buckets_.resize(inclusive_mins_.size());
+  for (size_t dim = 0; dim < inclusive_mins_.size(); ++dim) {
+    const auto& points = inclusive_mins_[dim];
+    const size_t n = points.size();
+    if (n < kMinPointsForBuckets) continue;
+    // Offsets relative to the first point are computed using unsigned
+    // arithmetic, since the range of points may exceed the range of `Index`.
+    const uint64_t lo = static_cast<uint64_t>(points[0]);
+    const uint64_t range = static_cast<uint64_t>(points[n - 1]) - lo;
+    // Use one bucket per cell on average.
+    const uint64_t width = std::max<uint64_t>(1, (range + n - 2) / (n - 1));
+    const uint64_t num_buckets = (range + width - 1) / width;
+    auto& buckets = buckets_[dim];
+    buckets.width = width;
+    buckets.first_cell.resize(num_buckets + 1);
+    size_t cell = 0;
+    for (uint64_t b = 0; b <= num_buckets; ++b) {
+      const uint64_t start = b * width;
+      while (cell + 1 < n &&
+             static_cast<uint64_t>(points[cell + 1]) - lo <= start) {
+        ++cell;
+      }
+      buckets.first_cell[b] = cell;
+    }
+  }
+}
+
+Index IrregularGrid::GetCellIndex(DimensionIndex dim,
+                                  Index output_index) const {
+  auto points = inclusive_min(dim);
+  const auto& buckets = buckets_[dim];
+  auto begin = points.begin();
+  auto end = points.end();
+  if (buckets.width != 0) {
+    if (output_index < points[0]) return -1;
+    if (output_index >= points.back()) return points.size() - 1;
+    const uint64_t b = (static_cast<uint64_t>(output_index) -
+                        static_cast<uint64_t>(points[0])) /
+                       buckets.width;
+    // The cell is in the range `[first_cell[b], first_cell[b + 1]]`, and
+    // `points[first_cell[b]] <= output_index`.
+    end = points.begin() + buckets.first_cell[b + 1] + 1;
+    begin = points.begin() + buckets.first_cell[b] + 1;
+  }
+  auto it = std::upper_bound(begin, end, output_index);
+  return std::distance(points.begin(), it) - 1;
 }
 
 Index IrregularGrid::operator()(DimensionIndex dim, Index output_index,
                                 IndexInterval* cell_bounds) const {
   auto points = inclusive_min(dim);
-  auto it = std::upper_bound(points.begin(), points.end(), output_index);
-  Index cell = std::distance(points.begin(), it) - 1;
+  Index cell = GetCellIndex(dim, output_index);
   if (cell_bounds) {
     if (cell < 0) {
       *cell_bounds = IndexInterval::UncheckedHalfOpen(-kInfIndex, points[0]);
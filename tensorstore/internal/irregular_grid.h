@@ -16,6 +16,7 @@
 #define TENSORSTORE_INTERNAL_IRREGULAR_GRID_H_
 
 #include <assert.h>
+#include <stdint.h>
 
 #include <vector>
 
@@ -33,6 +34,12 @@ namespace internal {
 ///
 /// The grid cells have index vectors of length `rank()` in the range
 /// `{0...} .. shape()`
+///
+/// To support grids with many cells, e.g. a "stack" driver with 100k layers,
+/// each dimension with many grid points is additionally divided into
+/// equal-width buckets that record the first cell intersecting each bucket.
+/// Locating a cell then requires a search only within a single bucket, which
+/// takes constant time if the grid points are (nearly) evenly spaced.
 class IrregularGrid {
  public:
   IrregularGrid() = default;
@@ -59,6 +66,10 @@ class IrregularGrid {
     return inclusive_mins_[r];
   }
 
+  /// Returns the cell containing `output_index` along dimension `dim`, in the
+  /// range `[-1, shape()[dim]]`.
+  Index GetCellIndex(DimensionIndex dim, Index output_index) const;
+
   std::vector<Index> cell_origin(span<const Index> indices) const {
     assert(indices.size() == rank());
     std::vector<Index> origin;
@@ -77,8 +88,20 @@ class IrregularGrid {
   }
 
  private:
+  // Bucket index for a single dimension.
+  struct Buckets {
+    // Width of each bucket, or 0 if the dimension is not bucketed.
+    uint64_t width = 0;
+    // Index of the cell containing the start of each bucket, followed by the
+    // cell containing the end of the last bucket.
+    std::vector<Index> first_cell;
+  };
+
+  void InitializeBuckets();
+
   std::vector<Index> shape_;
   std::vector<std::vector<Index>> inclusive_mins_;
+  std::vector<Buckets> buckets_;
 };
 
 }  // namespace internal
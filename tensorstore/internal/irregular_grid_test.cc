@@ -14,6 +14,7 @@
 
 #include "tensorstore/internal/irregular_grid.h"
 
+#include <algorithm>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -128,4 +129,33 @@ TEST(IrregularGridTest, Rank0) {
   EXPECT_TRUE(grid.cell_origin({}).empty());
 }
 
+TEST(IrregularGridTest, ManyPoints) {
+  // Dimensions with many grid points use a bucket index; check that it
+  // agrees with a direct search for evenly and unevenly spaced points,
+  // including unbounded extremes.
+  std::vector<Index> even;
+  std::vector<Index> uneven{-kInfIndex, kInfIndex + 1};
+  for (Index i = 0; i <= 1000; ++i) {
+    even.push_back(i * 10);
+    uneven.push_back(i * i - 5000);
+  }
+  auto grid = IrregularGrid({even, uneven});
+  EXPECT_THAT(grid.shape(), ElementsAre(1000, 1002));
+  for (DimensionIndex dim = 0; dim < 2; ++dim) {
+    auto points = grid.inclusive_min(dim);
+    for (Index x : {-kInfIndex, Index{-5001}, Index{-5000}, Index{-1},
+                    Index{0}, Index{9}, Index{10}, Index{4321}, Index{9999},
+                    Index{10000}, Index{10001}, Index{995000}, kInfIndex}) {
+      SCOPED_TRACE(x);
+      const Index expected =
+          std::upper_bound(points.begin(), points.end(), x) - points.begin() -
+          1;
+      EXPECT_EQ(expected, grid(dim, x, nullptr));
+    }
+  }
+  IndexInterval grid_cell;
+  EXPECT_EQ(432, grid(0, 4321, &grid_cell));
+  EXPECT_EQ(grid_cell, IndexInterval::UncheckedSized(4320, 10));
+}
+
 }  // namespace
@@ -20,6 +20,7 @@
 #include "tensorstore/internal/json/value_as.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/status.h"
 
 namespace tensorstore {
 namespace internal {
@@ -35,15 +36,30 @@ TENSORSTORE_DEFINE_JSON_BINDER(
           const double t = static_cast<double>(*j);
           *obj = absl::UnixEpoch() + absl::Seconds(t);
         } else if (*j == "open") {
-          obj->time = absl::InfiniteFuture();
-          obj->bounded_by_open_time = true;
+          *obj = StalenessBound::BoundedByOpen();
+        } else if (j->is_object()) {
+          namespace jb = internal_json_binding;
+          double max_age;
+          TENSORSTORE_RETURN_IF_ERROR(
+              jb::Object(jb::Member("max_age", jb::LooseFloatBinder))(
+                  is_loading, options, &max_age, j));
+          if (!(max_age >= 0)) {
+            return absl::InvalidArgumentError(
+                "Expected \"max_age\" to be non-negative");
+          }
+          *obj = StalenessBound::MaxAge(absl::Seconds(max_age));
         } else {
-          return internal_json::ExpectedError(*j,
-                                              "boolean, number, or \"open\"");
+          return internal_json::ExpectedError(
+              *j, "boolean, number, \"open\", or object");
         }
       } else {
         if (obj->bounded_by_open_time) {
-          *j = "open";
+          if (obj->max_age == absl::ZeroDuration()) {
+            *j = "open";
+          } else {
+            *j = ::nlohmann::json::object_t{
+                {"max_age", absl::ToDoubleSeconds(obj->max_age)}};
+          }
         } else {
           const absl::Time& t = obj->time;
           if (t == absl::InfiniteFuture()) {
@@ -20,6 +20,7 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
 #include "absl/time/time.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/internal/json_binding/bindable.h"
@@ -27,6 +28,7 @@
 #include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/json_serialization_options_base.h"
 #include "tensorstore/staleness_bound.h"
+#include "tensorstore/util/status_testutil.h"
 
 using ::tensorstore::MatchesJson;
 using ::tensorstore::StalenessBound;
@@ -39,6 +41,8 @@ TEST(StalenessBoundJsonBinderTest, RoundTrip) {
       {StalenessBound{absl::InfinitePast()}, Optional(MatchesJson(false))},
       {StalenessBound{absl::InfiniteFuture()}, Optional(MatchesJson(true))},
       {StalenessBound::BoundedByOpen(), Optional(MatchesJson("open"))},
+      {StalenessBound::MaxAge(absl::Seconds(60)),
+       Optional(MatchesJson({{"max_age", 60}}))},
       {StalenessBound{absl::UnixEpoch()}, Optional(MatchesJson(0))},
       {StalenessBound{absl::UnixEpoch() + absl::Seconds(1)},
        Optional(MatchesJson(1))},
@@ -74,7 +78,33 @@ TEST(StalenessBoundJsonBinderTest, FromJson) {
            ::testing::Field(&StalenessBound::time,
                             absl::UnixEpoch() + absl::Milliseconds(1500)),
            ::testing::Field(&StalenessBound::bounded_by_open_time, false)))},
+      {{{"max_age", 1.5}},
+       ::testing::Optional(::testing::AllOf(
+           ::testing::Field(&StalenessBound::max_age,
+                            absl::Milliseconds(1500)),
+           ::testing::Field(&StalenessBound::bounded_by_open_time, true)))},
   });
 }
 
+TEST(StalenessBoundJsonBinderTest, FromJsonInvalid) {
+  tensorstore::TestJsonBinderFromJson<StalenessBound>({
+      {"x", tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument)},
+      {{{"max_age", -1}},
+       tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument,
+                                  ".*non-negative.*")},
+      {{{"max_age", 1}, {"extra", 1}},
+       tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument)},
+  });
+}
+
+TEST(StalenessBoundTest, BoundAtOpen) {
+  const absl::Time open_time = absl::UnixEpoch() + absl::Seconds(100);
+  EXPECT_EQ(open_time,
+            StalenessBound::BoundedByOpen().BoundAtOpen(open_time).time);
+  EXPECT_EQ(absl::UnixEpoch() + absl::Seconds(40),
+            StalenessBound::MaxAge(absl::Seconds(60))
+                .BoundAtOpen(open_time)
+                .time);
+}
+
 }  // namespace
@@ -32,6 +32,7 @@
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/arena.h"
+#include "tensorstore/internal/box_difference.h"
 #include "tensorstore/internal/elementwise_function.h"
 #include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/memory.h"
@@ -168,14 +169,31 @@ void UnionMasks(BoxView<> box, MaskData* mask_a, MaskData* mask_b) {
   assert(mask_a->region.rank() == rank);
   assert(mask_b->region.rank() == rank);
 
+  Index byte_strides[kMaxRank];  // Only first `rank` elements are used.
+  const span<Index> byte_strides_span(&byte_strides[0], rank);
+  ComputeStrides(ContiguousLayoutOrder::c, sizeof(bool), box.shape(),
+                 byte_strides_span);
+
   if (mask_a->mask_array && mask_b->mask_array) {
-    const Index size = box.num_elements();
-    mask_a->num_masked_elements = 0;
-    for (Index i = 0; i < size; ++i) {
-      if ((mask_a->mask_array[i] |= mask_b->mask_array[i])) {
-        ++mask_a->num_masked_elements;
-      }
-    }
+    // All elements of `mask_b` outside `mask_b->region` are `false`, so only
+    // that region needs to be merged.  For fragmented writes this is
+    // typically much smaller than `box`.
+    const Index offset = GetRelativeOffset(
+        box.origin(), mask_b->region.origin(), byte_strides_span);
+    const StridedLayoutView<> b_layout(mask_b->region.shape(),
+                                       byte_strides_span);
+    IterateOverArrays(
+        [&](bool* a, const bool* b) {
+          if (*b && !*a) {
+            *a = true;
+            ++mask_a->num_masked_elements;
+          }
+        },
+        /*constraints=*/{},
+        ArrayView<bool>(AddByteOffset(mask_a->mask_array.get(), offset),
+                        b_layout),
+        ArrayView<const bool>(
+            AddByteOffset(mask_b->mask_array.get(), offset), b_layout));
     Hull(mask_a->region, mask_b->region, mask_a->region);
     RemoveMaskArrayIfNotNeeded(mask_a);
     return;
@@ -192,10 +210,6 @@ void UnionMasks(BoxView<> box, MaskData* mask_a, MaskData* mask_b) {
     std::swap(*mask_a, *mask_b);
   }
 
-  Index byte_strides[kMaxRank];  // Only first `rank` elements are used.
-  const span<Index> byte_strides_span(&byte_strides[0], rank);
-  ComputeStrides(ContiguousLayoutOrder::c, sizeof(bool), box.shape(),
-                 byte_strides_span);
   if (!mask_a->mask_array) {
     CreateMaskArrayFromRegion(box, mask_a, byte_strides_span);
   }
@@ -232,21 +246,39 @@ void RebaseMaskedArray(BoxView<> box, ArrayView<const void> source,
     assert(success);
     return;
   }
+  if (!mask.mask_array) {
+    // All elements within `mask.region` are masked; copy the remaining
+    // sub-boxes directly rather than materializing a mask array.
+    const DimensionIndex rank = box.rank();
+    BoxDifference difference(box, mask.region);
+    Box<dynamic_rank(kNumInlinedDims)> sub_box(rank);
+    for (Index i = 0, n = difference.num_sub_boxes(); i < n; ++i) {
+      difference.GetSubBox(i, sub_box);
+      ArrayView<const void> source_part(
+          AddByteOffset(source.element_pointer(),
+                        GetRelativeOffset(box.origin(), sub_box.origin(),
+                                          source.byte_strides())),
+          StridedLayoutView<>(sub_box.shape(), source.byte_strides()));
+      ArrayView<void> dest_part(
+          AddByteOffset(dest.element_pointer(),
+                        GetRelativeOffset(box.origin(), sub_box.origin(),
+                                          dest.byte_strides())),
+          StridedLayoutView<>(sub_box.shape(), dest.byte_strides()));
+      [[maybe_unused]] const auto success = internal::IterateOverArrays(
+          {&dtype->copy_assign, /*context=*/nullptr}, /*status=*/nullptr,
+          skip_repeated_elements, source_part, dest_part);
+      assert(success);
+    }
+    return;
+  }
   Index mask_byte_strides_storage[kMaxRank];
   const span<Index> mask_byte_strides(&mask_byte_strides_storage[0],
                                       box.rank());
   ComputeStrides(ContiguousLayoutOrder::c, sizeof(bool), box.shape(),
                  mask_byte_strides);
-  std::unique_ptr<bool[], FreeDeleter> mask_owner;
-  bool* mask_array_ptr;
-  if (!mask.mask_array) {
-    mask_owner = CreateMaskArray(box, mask.region, mask_byte_strides);
-    mask_array_ptr = mask_owner.get();
-  } else {
-    mask_array_ptr = mask.mask_array.get();
-  }
   ArrayView<const bool> mask_array(
-      mask_array_ptr, StridedLayoutView<>(box.shape(), mask_byte_strides));
+      mask.mask_array.get(),
+      StridedLayoutView<>(box.shape(), mask_byte_strides));
   [[maybe_unused]] const auto success = internal::IterateOverArrays(
       {&dtype->copy_assign_unmasked, /*context=*/nullptr}, /*status=*/nullptr,
       skip_repeated_elements, source, dest, mask_array);
@@ -662,6 +662,39 @@ TEST(UnionMasksTest, MaskArrayAndMaskArrayEqualsMaskArray) {
   EXPECT_EQ(MakeArray<bool>({1, 0, 1, 1, 0}), tester.mask_array());
 }
 
+TEST(UnionMasksTest, MaskArrayAndMaskArraySubRegion) {
+  MaskedArrayWriteTester<int> tester{BoxView({1, 2}, {3, 4})};
+  MaskedArrayWriteTester<int> tester_b{BoxView({1, 2}, {3, 4})};
+
+  // Use MaskedArrayWriteTester::Write as a simple way to modify the mask.
+  TENSORSTORE_EXPECT_OK(tester.Write(
+      (tester.transform() | Dims(0, 1).IndexVectorArraySlice(MakeArray<Index>({
+                                {1, 2},
+                                {2, 4},
+                            })))
+          .value(),
+      MakeArray({1, 2})));
+  EXPECT_TRUE(tester.mask_array().valid());
+  TENSORSTORE_EXPECT_OK(
+      tester_b.Write((tester_b.transform() |
+                      Dims(0, 1).TranslateSizedInterval({2, 3}, {2, 2}, {1, 2}))
+                         .value(),
+                     MakeArray({{1, 2}, {3, 4}})));
+  EXPECT_TRUE(tester_b.mask_array().valid());
+  // The mask region of `tester_b` is a strict subset of the domain.
+  EXPECT_EQ(BoxView({2, 3}, {2, 3}), tester_b.mask_region());
+  tester.Combine(std::move(tester_b));
+
+  EXPECT_EQ(6, tester.num_masked_elements());
+  EXPECT_EQ(BoxView({1, 2}, {3, 4}), tester.mask_region());
+  EXPECT_EQ(MakeArray<bool>({
+                {1, 0, 0, 0},
+                {0, 1, 1, 1},
+                {0, 1, 0, 1},
+            }),
+            tester.mask_array());
+}
+
 TEST(UnionMasksTest, MaskArrayAndMaskArrayEqualsNoMaskArray) {
   MaskedArrayWriteTester<int> tester{BoxView({1}, {5})};
   MaskedArrayWriteTester<int> tester_b{BoxView({1}, {5})};
@@ -0,0 +1,95 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/memory_budget.h"
+
+#include <stddef.h>
+
+#include <cassert>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/tracing.h"
+
+namespace tensorstore {
+namespace internal {
+
+MemoryBudget::MemoryBudget(size_t total_bytes_limit)
+    : total_bytes_limit_(total_bytes_limit) {}
+
+bool MemoryBudget::CanAdmit(size_t bytes) const {
+  return num_transient_ == 0 || bytes_in_use_ + bytes <= total_bytes_limit_;
+}
+
+void MemoryBudget::Reserve(size_t bytes, AdmitCallback on_admitted) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!waiting_.empty() || !CanAdmit(bytes)) {
+      waiting_.push_back(Waiter{bytes, std::move(on_admitted)});
+      return;
+    }
+    bytes_in_use_ += bytes;
+    ++num_transient_;
+  }
+  std::move(on_admitted)(MemoryReservation(IntrusivePtr<MemoryBudget>(this),
+                                           bytes, /*transient=*/true));
+}
+
+MemoryReservation MemoryBudget::Retain() {
+  return MemoryReservation(IntrusivePtr<MemoryBudget>(this), 0,
+                           /*transient=*/false);
+}
+
+void MemoryBudget::Update(size_t old_bytes, size_t new_bytes,
+                          bool end_transient) {
+  absl::InlinedVector<Waiter, 1> admitted;
+  {
+    absl::MutexLock lock(&mutex_);
+    assert(bytes_in_use_ >= old_bytes);
+    bytes_in_use_ = bytes_in_use_ - old_bytes + new_bytes;
+    if (end_transient) {
+      assert(num_transient_ > 0);
+      --num_transient_;
+    }
+    while (!waiting_.empty() && CanAdmit(waiting_.front().bytes)) {
+      bytes_in_use_ += waiting_.front().bytes;
+      ++num_transient_;
+      admitted.push_back(std::move(waiting_.front()));
+      waiting_.pop_front();
+    }
+  }
+  for (auto& waiter : admitted) {
+    internal_tracing::SwapCurrentTraceContext(&waiter.trace_context);
+    std::move(waiter.on_admitted)(MemoryReservation(
+        IntrusivePtr<MemoryBudget>(this), waiter.bytes, /*transient=*/true));
+    internal_tracing::SwapCurrentTraceContext(&waiter.trace_context);
+  }
+}
+
+void MemoryReservation::Resize(size_t bytes) {
+  if (!budget_ || bytes == bytes_) return;
+  budget_->Update(std::exchange(bytes_, bytes), bytes,
+                  /*end_transient=*/false);
+}
+
+void MemoryReservation::Reset() {
+  if (!budget_) return;
+  auto budget = std::move(budget_);
+  budget->Update(std::exchange(bytes_, 0), 0, transient_);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,155 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_MEMORY_BUDGET_H_
+#define TENSORSTORE_INTERNAL_MEMORY_BUDGET_H_
+
+#include <stddef.h>
+
+#include <deque>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/tracing.h"
+
+namespace tensorstore {
+namespace internal {
+
+class MemoryReservation;
+
+/// Budget for memory that is not accounted for by the cache pool, such as
+/// partially received HTTP responses, decoded chunks that have not yet been
+/// added to the cache, and pending writeback data.
+///
+/// Memory is charged to the budget in one of two ways:
+///
+/// - *Transient* memory is reserved by `Reserve` before starting new work
+///   whose memory is released once the work completes, such as an HTTP
+///   request or a chunk decode.  New work is admitted, in FIFO order, only
+///   once the budget has room for it, which provides backpressure.
+///
+/// - *Retained* memory, such as pending writeback data, is charged by
+///   `Retain` without waiting, since releasing it may itself require work
+///   that is subject to the budget.
+///
+/// To guarantee progress, work is always admitted when no transient memory is
+/// reserved, even if that exceeds the limit.
+class MemoryBudget : public AtomicReferenceCount<MemoryBudget> {
+ public:
+  using AdmitCallback = absl::AnyInvocable<void(MemoryReservation) &&>;
+
+  /// Constructs a budget with the specified limit.
+  explicit MemoryBudget(size_t total_bytes_limit);
+
+  size_t total_bytes_limit() const { return total_bytes_limit_; }
+
+  /// Returns the total number of bytes currently charged to the budget.
+  size_t bytes_in_use() const {
+    absl::MutexLock lock(&mutex_);
+    return bytes_in_use_;
+  }
+
+  /// Returns the number of pending `Reserve` requests.
+  size_t num_waiting() const {
+    absl::MutexLock lock(&mutex_);
+    return waiting_.size();
+  }
+
+  /// Reserves `bytes` of transient memory, and invokes `on_admitted` with the
+  /// reservation once it has been admitted.
+  ///
+  /// `on_admitted` is invoked either synchronously, or from the thread that
+  /// releases memory, and therefore should only start the work (e.g. by
+  /// submitting it to an executor).  In the latter case, it is invoked in the
+  /// trace context of the call to `Reserve`.
+  void Reserve(size_t bytes, AdmitCallback on_admitted);
+
+  /// Returns an empty reservation of retained memory, which may be resized
+  /// without waiting.
+  MemoryReservation Retain();
+
+ private:
+  friend class MemoryReservation;
+
+  struct Waiter {
+    size_t bytes;
+    AdmitCallback on_admitted;
+    internal_tracing::TraceContext trace_context{
+        internal_tracing::TraceContext::kThread};
+  };
+
+  // Changes the bytes charged by a reservation from `old_bytes` to
+  // `new_bytes`, and admits any waiting requests for which there is now room.
+  void Update(size_t old_bytes, size_t new_bytes, bool end_transient);
+  bool CanAdmit(size_t bytes) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t total_bytes_limit_;
+  mutable absl::Mutex mutex_;
+  size_t bytes_in_use_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of outstanding transient reservations.
+  size_t num_transient_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::deque<Waiter> waiting_ ABSL_GUARDED_BY(mutex_);
+};
+
+/// Memory charged to a `MemoryBudget`, which is released when the reservation
+/// is destroyed or reset.
+///
+/// A default-constructed reservation is not associated with a budget, and
+/// `Resize` has no effect.
+class MemoryReservation {
+ public:
+  MemoryReservation() = default;
+  MemoryReservation(MemoryReservation&& other)
+      : budget_(std::move(other.budget_)),
+        bytes_(std::exchange(other.bytes_, 0)),
+        transient_(other.transient_) {}
+  MemoryReservation& operator=(MemoryReservation&& other) {
+    Reset();
+    budget_ = std::move(other.budget_);
+    bytes_ = std::exchange(other.bytes_, 0);
+    transient_ = other.transient_;
+    return *this;
+  }
+  ~MemoryReservation() { Reset(); }
+
+  /// Returns the number of bytes reserved.
+  size_t size() const { return bytes_; }
+
+  /// Changes the number of bytes reserved, without waiting for admission.
+  ///
+  /// This is used for memory whose size is not known in advance, such as an
+  /// HTTP response body that is received incrementally.
+  void Resize(size_t bytes);
+
+  /// Releases the reservation.
+  void Reset();
+
+ private:
+  friend class MemoryBudget;
+  MemoryReservation(IntrusivePtr<MemoryBudget> budget, size_t bytes,
+                    bool transient)
+      : budget_(std::move(budget)), bytes_(bytes), transient_(transient) {}
+
+  IntrusivePtr<MemoryBudget> budget_;
+  size_t bytes_ = 0;
+  bool transient_ = false;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_MEMORY_BUDGET_H_
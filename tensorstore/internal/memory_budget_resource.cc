@@ -0,0 +1,61 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/memory_budget_resource.h"
+
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/memory_budget.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+struct MemoryBudgetResourceTraits
+    : public ContextResourceTraits<MemoryBudgetResource> {
+  using Spec = MemoryBudgetResource::Spec;
+  using Resource = MemoryBudgetResource::Resource;
+  static constexpr Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    return jb::Object(jb::Member(
+        "total_bytes_limit",
+        jb::Projection(&Spec::total_bytes_limit,
+                       jb::DefaultValue([](auto* v) { *v = 0; }))));
+  }
+  static Result<Resource> Create(const Spec& spec,
+                                 ContextResourceCreationContext context) {
+    Resource resource;
+    resource.spec = spec;
+    if (spec.total_bytes_limit != 0) {
+      resource.budget = MakeIntrusivePtr<MemoryBudget>(spec.total_bytes_limit);
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+const ContextResourceRegistration<MemoryBudgetResourceTraits> registration;
+
+}  // namespace
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,50 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_MEMORY_BUDGET_RESOURCE_H_
+#define TENSORSTORE_INTERNAL_MEMORY_BUDGET_RESOURCE_H_
+
+#include <stddef.h>
+
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/memory_budget.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Context resource corresponding to a `MemoryBudget` shared by in-flight
+/// reads, decodes, and writebacks.
+struct MemoryBudgetResource {
+  static constexpr char id[] = "memory_budget";
+
+  struct Spec {
+    // A limit of `0` indicates that in-flight memory is not limited.
+    size_t total_bytes_limit = 0;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.total_bytes_limit);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+    // `nullptr` if `spec.total_bytes_limit == 0`.
+    IntrusivePtr<MemoryBudget> budget;
+  };
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_MEMORY_BUDGET_RESOURCE_H_
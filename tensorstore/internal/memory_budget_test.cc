@@ -0,0 +1,130 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/memory_budget.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/context.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/memory_budget_resource.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::internal::MakeIntrusivePtr;
+using ::tensorstore::internal::MemoryBudget;
+using ::tensorstore::internal::MemoryBudgetResource;
+using ::tensorstore::internal::MemoryReservation;
+
+// Reserves `bytes` from `budget`, storing the reservation in `*result` once
+// admitted.
+void Reserve(MemoryBudget& budget, size_t bytes,
+             std::optional<MemoryReservation>* result) {
+  budget.Reserve(bytes, [result](MemoryReservation reservation) {
+    result->emplace(std::move(reservation));
+  });
+}
+
+TEST(MemoryBudgetTest, AdmitsWithinLimit) {
+  auto budget = MakeIntrusivePtr<MemoryBudget>(100);
+  std::optional<MemoryReservation> a, b, c;
+  Reserve(*budget, 60, &a);
+  Reserve(*budget, 40, &b);
+  ASSERT_TRUE(a);
+  ASSERT_TRUE(b);
+  EXPECT_EQ(100, budget->bytes_in_use());
+
+  // Exceeds the limit, so waits until memory is released.
+  Reserve(*budget, 50, &c);
+  EXPECT_FALSE(c);
+  EXPECT_EQ(1, budget->num_waiting());
+  b.reset();
+  EXPECT_FALSE(c);
+  a->Resize(10);
+  ASSERT_TRUE(c);
+  EXPECT_EQ(50, c->size());
+  EXPECT_EQ(60, budget->bytes_in_use());
+  a.reset();
+  c.reset();
+  EXPECT_EQ(0, budget->bytes_in_use());
+}
+
+TEST(MemoryBudgetTest, Fifo) {
+  auto budget = MakeIntrusivePtr<MemoryBudget>(100);
+  std::optional<MemoryReservation> a, b, c;
+  Reserve(*budget, 90, &a);
+  Reserve(*budget, 20, &b);
+  // Would fit, but is queued behind `b`.
+  Reserve(*budget, 10, &c);
+  EXPECT_FALSE(b);
+  EXPECT_FALSE(c);
+  a.reset();
+  EXPECT_TRUE(b);
+  EXPECT_TRUE(c);
+}
+
+TEST(MemoryBudgetTest, OversizedRequestAdmittedWhenIdle) {
+  auto budget = MakeIntrusivePtr<MemoryBudget>(100);
+  std::optional<MemoryReservation> a, b;
+  Reserve(*budget, 150, &a);
+  ASSERT_TRUE(a);
+  Reserve(*budget, 1, &b);
+  EXPECT_FALSE(b);
+  a.reset();
+  EXPECT_TRUE(b);
+}
+
+TEST(MemoryBudgetTest, Retained) {
+  auto budget = MakeIntrusivePtr<MemoryBudget>(100);
+  std::optional<MemoryReservation> a, b;
+  auto retained = budget->Retain();
+  retained.Resize(200);
+  EXPECT_EQ(200, budget->bytes_in_use());
+
+  // Retained memory does not prevent progress of transient work.
+  Reserve(*budget, 10, &a);
+  ASSERT_TRUE(a);
+  Reserve(*budget, 10, &b);
+  EXPECT_FALSE(b);
+  retained.Resize(50);
+  EXPECT_TRUE(b);
+  retained.Reset();
+  EXPECT_EQ(20, budget->bytes_in_use());
+}
+
+TEST(MemoryBudgetResourceTest, Default) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource, context.GetResource<MemoryBudgetResource>());
+  EXPECT_FALSE(resource->budget);
+}
+
+TEST(MemoryBudgetResourceTest, Limit) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto spec, Context::Spec::FromJson(
+                     {{"memory_budget", {{"total_bytes_limit", 1000}}}}));
+  Context context(spec);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource, context.GetResource<MemoryBudgetResource>());
+  ASSERT_TRUE(resource->budget);
+  EXPECT_EQ(1000, resource->budget->total_bytes_limit());
+}
+
+}  // namespace
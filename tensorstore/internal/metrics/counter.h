@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <string>
@@ -45,6 +46,16 @@ namespace internal_metrics {
 template <typename T>
 class CounterCell;
 
+/// ShardedCounterCell holds an individual "counter" metric value, sharded by
+/// thread.
+template <typename T>
+class ShardedCounterCell;
+
+/// Implementation of `Counter` and `ShardedCounter`, parameterized by the
+/// cell type.
+template <typename Cell, typename... Fields>
+class CounterMetric;
+
 /// A Counter metric represents a monotonically increasing value.
 /// Do not use a counter to expose a value that can decrease - instead use a
 /// Gauge.
@@ -63,25 +74,39 @@ class CounterCell;
 ///   animals->Increment("dog");
 ///
 template <typename T, typename... Fields>
-class ABSL_CACHELINE_ALIGNED Counter {
-  static_assert(std::is_same_v<T, int64_t> || std::is_same_v<T, double>);
-  using Cell = std::conditional_t<std::is_same_v<T, int64_t>,
-                                  CounterCell<int64_t>, CounterCell<double>>;
-  using Impl = AbstractMetric<Cell, true, Fields...>;
+using Counter = CounterMetric<CounterCell<T>, Fields...>;
+
+/// A ShardedCounter is a `Counter` that is cheaper to increment concurrently
+/// from many threads.
+///
+/// Each cell is split into `kMetricCellShards` cache lines, which are summed
+/// only when the counter is read or collected.  This should be used for
+/// counters on hot paths, such as cache hits, that may be incremented from
+/// many threads at once.
+///
+/// Only `int64_t` values are supported.
+template <typename T, typename... Fields>
+using ShardedCounter = CounterMetric<ShardedCounterCell<T>, Fields...>;
+
+template <typename Cell, typename... Fields>
+class ABSL_CACHELINE_ALIGNED CounterMetric {
+  using Impl = AbstractMetric<Cell, kCellHasCombine<Cell>, Fields...>;
 
  public:
-  using value_type = T;
+  using value_type = typename Cell::value_type;
+  static_assert(std::is_same_v<value_type, int64_t> ||
+                std::is_same_v<value_type, double>);
 
-  static std::unique_ptr<Counter> Allocate(
+  static std::unique_ptr<CounterMetric> Allocate(
       std::string_view metric_name,
       typename internal::FirstType<std::string_view, Fields>... field_names,
       MetricMetadata metadata) {
-    return absl::WrapUnique(new Counter(std::string(metric_name),
-                                        std::move(metadata),
-                                        {std::string(field_names)...}));
+    return absl::WrapUnique(new CounterMetric(std::string(metric_name),
+                                              std::move(metadata),
+                                              {std::string(field_names)...}));
   }
 
-  static Counter& New(
+  static CounterMetric& New(
       std::string_view metric_name,
       typename internal::FirstType<std::string_view, Fields>... field_names,
       MetricMetadata metadata) {
@@ -147,8 +172,8 @@ class ABSL_CACHELINE_ALIGNED Counter {
   void Reset() { impl_.Reset(); }
 
  private:
-  Counter(std::string metric_name, MetricMetadata metadata,
-          typename Impl::field_names_type field_names)
+  CounterMetric(std::string metric_name, MetricMetadata metadata,
+                typename Impl::field_names_type field_names)
       : impl_(std::move(metric_name), std::move(metadata),
               std::move(field_names)) {}
 
@@ -216,6 +241,42 @@ class ABSL_CACHELINE_ALIGNED CounterCell<int64_t> : public CounterTag {
   std::atomic<int64_t> value_{0};
 };
 
+template <>
+class ShardedCounterCell<int64_t> : public CounterTag {
+ public:
+  using value_type = int64_t;
+  ShardedCounterCell() = default;
+
+  /// Increment the counter by value.
+  void IncrementBy(int64_t value) {
+    if (value <= 0) return;
+    shards_[GetMetricCellShard()].value.fetch_add(value,
+                                                  std::memory_order_relaxed);
+  }
+
+  void Increment() { IncrementBy(1); }
+
+  int64_t Get() const {
+    int64_t value = 0;
+    for (const auto& shard : shards_) {
+      value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  void Reset() {
+    for (auto& shard : shards_) {
+      shard.value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct ABSL_CACHELINE_ALIGNED Shard {
+    std::atomic<int64_t> value{0};
+  };
+  std::array<Shard, kMetricCellShards> shards_;
+};
+
 #else
 template <typename T>
 struct CounterCell {
@@ -243,6 +304,8 @@ class Counter {
     return const_cast<Cell&>(cell);
   }
 };
+template <typename T, typename... Fields>
+using ShardedCounter = Counter<T, Fields...>;
 #endif  // TENSORSTORE_METRICS_DISABLED
 
 }  // namespace internal_metrics
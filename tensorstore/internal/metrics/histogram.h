@@ -48,6 +48,16 @@ namespace internal_metrics {
 template <typename Bucketer>
 class HistogramCell;
 
+/// ShardedHistogramCell holds an individual "histogram" metric value, sharded
+/// by thread.
+template <typename Bucketer>
+class ShardedHistogramCell;
+
+/// Implementation of `Histogram` and `ShardedHistogram`, parameterized by the
+/// cell type.
+template <typename Cell, typename... Fields>
+class HistogramMetric;
+
 /// DefaultBucketer buckets by powers of 2:
 ///  n<0: bucket 0
 ///  n=0: bucket 1
@@ -88,24 +98,36 @@ struct DefaultBucketer {
 ///   animals->Observe(33.0, "dog");
 ///
 template <typename Bucketer, typename... Fields>
-class ABSL_CACHELINE_ALIGNED Histogram {
-  using Cell = HistogramCell<Bucketer>;
+using Histogram = HistogramMetric<HistogramCell<Bucketer>, Fields...>;
+
+/// A ShardedHistogram is a `Histogram` that is cheaper to observe concurrently
+/// from many threads.
+///
+/// Each cell is split into `kMetricCellShards` independent histograms, which
+/// are merged only when the histogram is read or collected.  This should be
+/// used for histograms on hot paths, such as per-operation latencies.
+template <typename Bucketer, typename... Fields>
+using ShardedHistogram =
+    HistogramMetric<ShardedHistogramCell<Bucketer>, Fields...>;
+
+template <typename Cell, typename... Fields>
+class ABSL_CACHELINE_ALIGNED HistogramMetric {
   using Impl = AbstractMetric<Cell, false, Fields...>;
 
  public:
   using value_type = double;
   using count_type = int64_t;
 
-  static std::unique_ptr<Histogram> Allocate(
+  static std::unique_ptr<HistogramMetric> Allocate(
       std::string_view metric_name,
       typename internal::FirstType<std::string_view, Fields>... field_names,
       MetricMetadata metadata) {
-    return absl::WrapUnique(new Histogram(std::string(metric_name),
-                                          std::move(metadata),
-                                          {std::string(field_names)...}));
+    return absl::WrapUnique(new HistogramMetric(std::string(metric_name),
+                                                std::move(metadata),
+                                                {std::string(field_names)...}));
   }
 
-  static Histogram& New(
+  static HistogramMetric& New(
       std::string_view metric_name,
       typename internal::FirstType<std::string_view, Fields>... field_names,
       MetricMetadata metadata) {
@@ -176,8 +198,8 @@ class ABSL_CACHELINE_ALIGNED Histogram {
   void Reset() { impl_.Reset(); }
 
  private:
-  Histogram(std::string metric_name, MetricMetadata metadata,
-            typename Impl::field_names_type field_names)
+  HistogramMetric(std::string metric_name, MetricMetadata metadata,
+                  typename Impl::field_names_type field_names)
       : impl_(std::move(metric_name), std::move(metadata),
               std::move(field_names)) {}
 
@@ -274,6 +296,62 @@ class ABSL_CACHELINE_ALIGNED HistogramCell : public Bucketer {
   std::array<std::atomic<int64_t>, Max> buckets_{};
 };
 
+template <typename Bucketer>
+class ShardedHistogramCell : public Bucketer {
+ public:
+  using value_type = double;
+  using count_type = int64_t;
+  using Bucketer::Max;
+
+  ShardedHistogramCell() = default;
+
+  void Observe(double value) { shards_[GetMetricCellShard()].Observe(value); }
+
+  double GetMean() const { return Merge().mean; }
+  int64_t GetCount() const { return Merge().count; }
+  double GetSSD() const { return Merge().sum_of_squared_deviation; }
+
+  int64_t GetBucket(size_t idx) const {
+    int64_t count = 0;
+    for (const auto& shard : shards_) count += shard.GetBucket(idx);
+    return count;
+  }
+
+  void Reset() {
+    for (auto& shard : shards_) shard.Reset();
+  }
+
+  CollectedMetric::Histogram Collect(std::vector<std::string> fields) const {
+    auto result = Merge();
+    result.fields = std::move(fields);
+    return result;
+  }
+
+ private:
+  // Merges the shards, combining the means and sums of squared deviations
+  // using the parallel algorithm of Chan et al.
+  CollectedMetric::Histogram Merge() const {
+    CollectedMetric::Histogram result{{}, 0, 0, 0, {}};
+    result.buckets.resize(Max);
+    for (const auto& shard : shards_) {
+      auto h = shard.Collect({});
+      if (h.count == 0) continue;
+      for (size_t i = 0; i < Max; ++i) result.buckets[i] += h.buckets[i];
+      double n_a = static_cast<double>(result.count);
+      double n_b = static_cast<double>(h.count);
+      double n = n_a + n_b;
+      double delta = h.mean - result.mean;
+      result.mean += delta * n_b / n;
+      result.sum_of_squared_deviation +=
+          h.sum_of_squared_deviation + delta * delta * n_a * n_b / n;
+      result.count += h.count;
+    }
+    return result;
+  }
+
+  std::array<HistogramCell<Bucketer>, kMetricCellShards> shards_;
+};
+
 #else
 struct DefaultBucketer;
 template <typename Bucketer>
@@ -302,6 +380,8 @@ class Histogram {
     return const_cast<Cell&>(cell);
   }
 };
+template <typename Bucketer, typename... Fields>
+using ShardedHistogram = Histogram<Bucketer, Fields...>;
 #endif  // TENSORSTORE_METRICS_DISABLED
 
 }  // namespace internal_metrics
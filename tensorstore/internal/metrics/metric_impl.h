@@ -23,6 +23,7 @@
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -39,6 +40,24 @@ namespace internal_metrics {
 
 size_t MetricThreadCounter();
 
+/// Number of shards of the sharded cell types, such as `ShardedCounterCell`.
+constexpr size_t kMetricCellShards = 8;
+
+/// Returns the shard of a sharded cell that is updated by the current thread.
+inline size_t GetMetricCellShard() {
+  thread_local size_t shard = MetricThreadCounter() % kMetricCellShards;
+  return shard;
+}
+
+/// Indicates whether `Cell` has a `Combine` method, in which case metrics
+/// without fields shard their cell by thread.
+template <typename Cell, typename = void>
+constexpr inline bool kCellHasCombine = false;
+
+template <typename Cell>
+constexpr inline bool
+    kCellHasCombine<Cell, std::void_t<decltype(&Cell::Combine)>> = true;
+
 // Metrics include an optional set of labels of type {int, string, bool}.
 template <typename K>
 struct FieldTraits;
@@ -17,9 +17,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <string>
+
 #include <benchmark/benchmark.h>
 #include "absl/synchronization/blocking_counter.h"
 #include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/metrics/registry.h"
 #include "tensorstore/internal/thread/thread_pool.h"
 #include "tensorstore/util/executor.h"
@@ -28,7 +31,11 @@ namespace {
 
 using ::tensorstore::Executor;
 using ::tensorstore::internal_metrics::Counter;
+using ::tensorstore::internal_metrics::DefaultBucketer;
 using ::tensorstore::internal_metrics::GetMetricRegistry;
+using ::tensorstore::internal_metrics::Histogram;
+using ::tensorstore::internal_metrics::ShardedCounter;
+using ::tensorstore::internal_metrics::ShardedHistogram;
 
 Executor SetupThreadPoolTestEnv(size_t num_threads) {
   GetMetricRegistry().Reset();
@@ -78,6 +85,71 @@ BENCHMARK(BM_Metric_Counter)  //
     ->Args({256})             //
     ->UseRealTime();
 
+static auto& benchmark_labeled_counter = Counter<int64_t, std::string>::New(
+    "/tensorstore/benchmark/labeled_counter", "label", "A metric");
+
+static auto& benchmark_sharded_counter =
+    ShardedCounter<int64_t, std::string>::New(
+        "/tensorstore/benchmark/sharded_counter", "label", "A metric");
+
+static auto& benchmark_histogram = Histogram<DefaultBucketer>::New(
+    "/tensorstore/benchmark/histogram", "A metric");
+
+static auto& benchmark_sharded_histogram =
+    ShardedHistogram<DefaultBucketer>::New(
+        "/tensorstore/benchmark/sharded_histogram", "A metric");
+
+// Calls `fn` from `state.range(0)` threads, to measure contended updates of
+// a single metric cell.
+template <typename Fn>
+void RunContendedBenchmark(benchmark::State& state, Fn fn) {
+  const size_t ops = 4 * 1024 * 1024;
+  const size_t num_threads = state.range(0) ? state.range(0) : 1;
+  const size_t iters = ops / num_threads;
+
+  auto executor = SetupThreadPoolTestEnv(state.range(0));
+
+  for (auto s : state) {
+    absl::BlockingCounter done(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      executor([&done, &fn, iters] {
+        for (size_t j = 0; j < iters; j++) {
+          fn(j);
+        }
+        done.DecrementCount();
+      });
+    }
+    done.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * iters * num_threads);
+}
+
+static void BM_Metric_LabeledCounter(benchmark::State& state) {
+  auto& cell = benchmark_labeled_counter.GetCell("a");
+  RunContendedBenchmark(state, [&](size_t) { cell.Increment(); });
+}
+
+static void BM_Metric_ShardedCounter(benchmark::State& state) {
+  auto& cell = benchmark_sharded_counter.GetCell("a");
+  RunContendedBenchmark(state, [&](size_t) { cell.Increment(); });
+}
+
+static void BM_Metric_Histogram(benchmark::State& state) {
+  RunContendedBenchmark(
+      state, [](size_t j) { benchmark_histogram.Observe(j & 1023); });
+}
+
+static void BM_Metric_ShardedHistogram(benchmark::State& state) {
+  RunContendedBenchmark(
+      state, [](size_t j) { benchmark_sharded_histogram.Observe(j & 1023); });
+}
+
+BENCHMARK(BM_Metric_LabeledCounter)->Arg(0)->Arg(8)->Arg(32)->UseRealTime();
+BENCHMARK(BM_Metric_ShardedCounter)->Arg(0)->Arg(8)->Arg(32)->UseRealTime();
+BENCHMARK(BM_Metric_Histogram)->Arg(0)->Arg(8)->Arg(32)->UseRealTime();
+BENCHMARK(BM_Metric_ShardedHistogram)->Arg(0)->Arg(8)->Arg(32)->UseRealTime();
+
 }  // namespace
 
 #endif  // !defined(TENSORSTORE_METRICS_DISABLED)
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <string>
+#include <thread>  // NOLINT
 #include <variant>
 #include <vector>
 
@@ -39,6 +40,8 @@ using ::tensorstore::internal_metrics::Gauge;
 using ::tensorstore::internal_metrics::GetMetricRegistry;
 using ::tensorstore::internal_metrics::Histogram;
 using ::tensorstore::internal_metrics::MaxGauge;
+using ::tensorstore::internal_metrics::ShardedCounter;
+using ::tensorstore::internal_metrics::ShardedHistogram;
 using ::tensorstore::internal_metrics::Value;
 
 TEST(MetricTest, CounterInt) {
@@ -271,6 +274,62 @@ TEST(MetricTest, HistogramFields) {
   EXPECT_EQ(1, metric.histograms[3].buckets[3]);  // <4
 }
 
+TEST(MetricTest, ShardedCounterFields) {
+  auto& counter = ShardedCounter<int64_t, std::string>::New(
+      "/tensorstore/sharded_counter", "field1", "A metric");
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 16; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j) counter.Increment("a");
+      counter.IncrementBy(2, "b");
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(16000, counter.Get("a"));
+  EXPECT_EQ(32, counter.Get("b"));
+
+  auto metric = counter.Collect();
+  ASSERT_EQ(2, metric.values.size());
+  std::sort(metric.values.begin(), metric.values.end(),
+            [](auto& a, auto& b) { return a.fields < b.fields; });
+  EXPECT_EQ(16000, std::get<int64_t>(metric.values[0].value));
+  EXPECT_EQ(32, std::get<int64_t>(metric.values[1].value));
+
+  counter.Reset();
+  EXPECT_EQ(0, counter.Get("a"));
+}
+
+TEST(MetricTest, ShardedHistogram) {
+  auto& histogram = ShardedHistogram<DefaultBucketer>::New(
+      "/tensorstore/sharded_hist", "A metric");
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 16; ++i) {
+    threads.emplace_back([&, i] {
+      histogram.Observe(1);
+      histogram.Observe(2 + i % 2);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(32, histogram.GetCount());
+  EXPECT_NEAR(1.75, histogram.GetMean(), 0.001);
+
+  auto metric = histogram.Collect();
+  ASSERT_EQ(1, metric.histograms.size());
+  const auto& h = metric.histograms[0];
+  EXPECT_EQ(32, h.count);
+  EXPECT_NEAR(1.75, h.mean, 0.001);
+  // Values 1 (x16), 2 (x8) and 3 (x8) deviate from the mean by -0.75, 0.25
+  // and 1.25 respectively.
+  EXPECT_NEAR(16 * 0.5625 + 8 * 0.0625 + 8 * 1.5625,
+              h.sum_of_squared_deviation, 0.001);
+  EXPECT_EQ(16, h.buckets[2]);  // <2
+  EXPECT_EQ(16, h.buckets[3]);  // <4
+}
+
 TEST(MetricTest, ValueInt) {
   auto& value = Value<int64_t>::New("/tensorstore/value1", "A metric");
   value.Set(3);
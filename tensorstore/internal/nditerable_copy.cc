@@ -14,28 +14,54 @@
 
 #include "tensorstore/internal/nditerable_copy.h"
 
+#include <stddef.h>
+
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/arena.h"
 #include "tensorstore/internal/element_copy_function.h"
 #include "tensorstore/internal/elementwise_function.h"
+#include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/nditerable.h"
 #include "tensorstore/internal/nditerable_buffer_management.h"
 #include "tensorstore/internal/nditerable_util.h"
+#include "tensorstore/internal/tiled_transpose.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/extents.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 
 namespace tensorstore {
 namespace internal {
+namespace {
+
+// Returns `true` if elements of `dtype` may be copied as raw bytes.
+bool IsTriviallyCopyable(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::custom:
+    case DataTypeId::string_t:
+    case DataTypeId::ustring_t:
+    case DataTypeId::json_t:
+      return false;
+    default:
+      return true;
+  }
+}
+
+}  // namespace
 
 // Note: `NDIterableCopyManager` has some similarity to
 // `NDIterablesWithManagedBuffers`, but differs in that different
@@ -108,6 +134,17 @@ NDIteratorCopyManager::NDIteratorCopyManager(
           iterable.input()
               ->dtype()
               ->copy_assign[buffer_parameters.input_buffer_kind];
+      // When the input and output layouts conflict, the strided copy of a
+      // 2-d block accesses one of the two buffers with a large stride.  Such
+      // blocks are instead transposed in cache-sized tiles.
+      if (buffer_parameters.input_buffer_kind ==
+              IterationBufferKind::kStrided &&
+          buffer_parameters.output_buffer_kind ==
+              IterationBufferKind::kStrided &&
+          IsTriviallyCopyable(iterable.input()->dtype()) &&
+          IsTiledTransposeElementSize(iterable.input()->dtype()->size)) {
+        transpose_element_size_ = iterable.input()->dtype()->size;
+      }
       break;
     case NDIterableCopyManager::BufferSource::kExternal:
       buffer_manager_.Initialize(layout.block_shape,
@@ -129,6 +166,25 @@ NDIteratorCopyManager::NDIteratorCopyManager(
   //    i.e. `buffer_source=kBoth`, copy from the input to output buffer.
   //
   // 3. Call `UpdateBlock` on the output iterator.
+  constexpr static CopyImpl kTransposeCopyImpl =
+      [](NDIteratorCopyManager* self, span<const Index> indices,
+         IterationBufferShape block_shape, absl::Status* status) -> bool {
+    IterationBufferPointer input_pointer, output_pointer;
+    if (!self->input_->GetBlock(indices, block_shape, &input_pointer,
+                                status) ||
+        !self->output_->GetBlock(indices, block_shape, &output_pointer,
+                                 status)) {
+      return false;
+    }
+    if (!TiledTransposeCopy(self->transpose_element_size_, block_shape,
+                            input_pointer, output_pointer) &&
+        !self->copy_elements_function_(nullptr, block_shape, input_pointer,
+                                       output_pointer, status)) {
+      return false;
+    }
+    return self->output_->UpdateBlock(indices, block_shape, output_pointer,
+                                      status);
+  };
   constexpr static CopyImpl kCopyImpls[] = {
       // kBoth
       [](NDIteratorCopyManager* self, span<const Index> indices,
@@ -178,7 +234,10 @@ NDIteratorCopyManager::NDIteratorCopyManager(
                    self->buffer_manager_.buffer_pointers()[1][0], status);
       },
   };
-  copy_impl_ = kCopyImpls[static_cast<int>(buffer_parameters.buffer_source)];
+  copy_impl_ = transpose_element_size_
+                   ? kTransposeCopyImpl
+                   : kCopyImpls[static_cast<int>(
+                         buffer_parameters.buffer_source)];
 }
 
 NDIterableCopier::NDIterableCopier(const NDIterable& input,
@@ -202,11 +261,26 @@ NDIterableCopier::NDIterableCopier(
                              arena) {}
 
 absl::Status NDIterableCopier::Copy() {
-  span<const Index> iteration_shape = layout_info_.iteration_shape;
-  std::fill_n(position_, iteration_shape.size(), static_cast<Index>(0));
-  if (layout_info_.empty) {
+  return CopyOuterRange(0, layout_info_.iteration_shape[0]);
+}
+
+absl::Status NDIterableCopier::CopyOuterRange(Index outer_begin,
+                                              Index outer_end) {
+  const DimensionIndex rank = layout_info_.iteration_shape.size();
+  assert(0 <= outer_begin && outer_begin <= outer_end &&
+         outer_end <= layout_info_.iteration_shape[0]);
+  std::fill_n(position_, rank, static_cast<Index>(0));
+  position_[0] = outer_begin;
+  if (layout_info_.empty || outer_begin == outer_end) {
     return absl::OkStatus();
   }
+  // Iterating over a shape whose outermost extent is `outer_end` stops at the
+  // end of the range.
+  Index iteration_shape_buffer[kMaxRank];
+  std::copy_n(layout_info_.iteration_shape.data(), rank,
+              iteration_shape_buffer);
+  iteration_shape_buffer[0] = outer_end;
+  span<const Index> iteration_shape(iteration_shape_buffer, rank);
   absl::Status copy_status;
   if (Index inner_block_size = block_shape_[1];
       inner_block_size != iteration_shape.back()) {
@@ -223,8 +297,12 @@ absl::Status NDIterableCopier::Copy() {
                                              inner_block_size, position_);
     }
   } else {
-    // Block shape is 2d, exclude innermost dimension from iteration.
-    const Index outer_block_size = block_shape_[0];
+    // Block shape is 2d, exclude innermost dimension from iteration.  If the
+    // outer block dimension is also the outermost iteration dimension, the
+    // block must not extend past the range.
+    const Index outer_block_size =
+        std::min(block_shape_[0],
+                 iteration_shape[rank - 2] - position_[rank - 2]);
     for (Index block_size = outer_block_size; block_size;) {
       if (!iterator_copy_manager_.Copy(
               span<const Index>(position_, iteration_shape.size()),
@@ -239,5 +317,84 @@ absl::Status NDIterableCopier::Copy() {
   return absl::OkStatus();
 }
 
+namespace {
+
+// Tunable parameter: Maximum number of ranges into which
+// `ParallelNDIterableCopy` splits a copy.
+constexpr Index kMaxParallelCopyTasks = 64;
+
+struct ParallelCopyState : public AtomicReferenceCount<ParallelCopyState> {
+  ParallelCopyState(size_t num_ranges, Index outer_size)
+      : num_ranges(num_ranges),
+        outer_size(outer_size),
+        remaining_ranges(num_ranges) {}
+
+  // Claims and copies ranges until none remain.
+  void CopyRanges() {
+    for (size_t i;
+         (i = next_range.fetch_add(1, std::memory_order_relaxed)) <
+         num_ranges;) {
+      auto status = copiers[i]->CopyOuterRange(
+          outer_size * i / num_ranges, outer_size * (i + 1) / num_ranges);
+      absl::MutexLock lock(&mutex);
+      if (!status.ok() && this->status.ok()) this->status = std::move(status);
+      --remaining_ranges;
+    }
+  }
+
+  const size_t num_ranges;
+  const Index outer_size;
+  // `copiers[i]` is only accessed by the thread that claimed range `i`.
+  std::vector<std::unique_ptr<NDIterableCopier>> copiers;
+  std::atomic<size_t> next_range{0};
+  absl::Mutex mutex;
+  size_t remaining_ranges ABSL_GUARDED_BY(mutex);
+  absl::Status status ABSL_GUARDED_BY(mutex);
+};
+
+}  // namespace
+
+absl::Status ParallelNDIterableCopy(const NDIterable& input,
+                                    const NDIterable& output,
+                                    span<const Index> shape,
+                                    const Executor& executor, Arena* arena) {
+  auto copier = std::make_unique<NDIterableCopier>(input, output, shape, arena);
+  span<const Index> iteration_shape = copier->layout_info().iteration_shape;
+  const Index elements_per_task = std::max(
+      Index(1), kParallelCopyMinBytesPerTask /
+                    std::max(Index(1), Index(input.dtype()->size)));
+  const Index num_ranges =
+      std::min({iteration_shape[0],
+                ProductOfExtents(iteration_shape) / elements_per_task,
+                kMaxParallelCopyTasks});
+  if (copier->layout_info().empty || num_ranges <= 1) {
+    return copier->Copy();
+  }
+  auto state =
+      MakeIntrusivePtr<ParallelCopyState>(num_ranges, iteration_shape[0]);
+  state->copiers.reserve(num_ranges);
+  state->copiers.push_back(std::move(copier));
+  for (Index i = 1; i < num_ranges; ++i) {
+    state->copiers.push_back(
+        std::make_unique<NDIterableCopier>(input, output, shape, arena));
+  }
+  for (Index i = 1; i < num_ranges; ++i) {
+    executor([state] { state->CopyRanges(); });
+  }
+  state->CopyRanges();
+  absl::Status status;
+  {
+    absl::MutexLock lock(&state->mutex);
+    state->mutex.Await(absl::Condition(
+        +[](ParallelCopyState* state) { return state->remaining_ranges == 0; },
+        state.get()));
+    status = state->status;
+  }
+  // Tasks that start late only access `next_range`.  The copiers reference
+  // `input`, `output` and `arena`, which may be destroyed once this returns.
+  state->copiers.clear();
+  return status;
+}
+
 }  // namespace internal
 }  // namespace tensorstore
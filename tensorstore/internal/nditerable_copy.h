@@ -23,6 +23,8 @@
 /// `NDIterableCopyManager` and `NDIteratorCopyManager` classes can be used for
 /// to perform partial copies or for greater control over the iteration order.
 
+#include <stddef.h>
+
 #include <array>
 
 #include "absl/status/status.h"
@@ -33,6 +35,7 @@
 #include "tensorstore/internal/nditerable_buffer_management.h"
 #include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/rank.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
@@ -135,6 +138,9 @@ struct NDIteratorCopyManager {
                             absl::Status* status);
   CopyImpl copy_impl_;
   SpecializedElementwiseFunctionPointer<2, void*> copy_elements_function_;
+  // Element size for which `TiledTransposeCopy` is attempted before
+  // `copy_elements_function_`, or `0` if not applicable.
+  ptrdiff_t transpose_element_size_ = 0;
   NDIteratorExternalBufferManager<1, 2> buffer_manager_;
 };
 
@@ -173,6 +179,16 @@ struct NDIterableCopier {
   /// Leaves `position()` at one past the last position copied.
   absl::Status Copy();
 
+  /// Same as `Copy`, but only copies the positions whose index in the
+  /// outermost iteration dimension is in `[outer_begin, outer_end)`.
+  ///
+  /// Copiers constructed with the same arguments use the same iteration
+  /// layout, and may copy disjoint ranges concurrently.
+  ///
+  /// \dchecks `0 <= outer_begin && outer_begin <= outer_end &&
+  ///     outer_end <= layout_info().iteration_shape[0]`
+  absl::Status CopyOuterRange(Index outer_begin, Index outer_end);
+
   /// Returns the layout used for copying.
   const NDIterationLayoutInfo<>& layout_info() const { return layout_info_; }
 
@@ -198,6 +214,27 @@ struct NDIterableCopier {
   NDIteratorCopyManager iterator_copy_manager_;
 };
 
+/// Minimum number of bytes copied by each task of `ParallelNDIterableCopy`.
+constexpr Index kParallelCopyMinBytesPerTask = 4 * 1024 * 1024;
+
+/// Copies `input` to `output`, like `NDIterableCopier::Copy`, but splits large
+/// copies along the outermost iteration dimension into ranges that are copied
+/// concurrently by tasks submitted to `executor`.
+///
+/// The calling thread also copies ranges, and any range not yet claimed by a
+/// task once the calling thread finishes its own.  Therefore, this does not
+/// deadlock even if `executor` has no free threads, e.g. when called from a
+/// task running on a concurrency-limited `executor`.  Returns once all ranges
+/// have been copied.
+///
+/// Separate iterators obtained from `input` and `output` must be usable
+/// concurrently for disjoint positions, as is the case for array-backed
+/// iterables.  All allocations from `arena` are made by the calling thread.
+absl::Status ParallelNDIterableCopy(const NDIterable& input,
+                                    const NDIterable& output,
+                                    span<const Index> shape,
+                                    const Executor& executor, Arena* arena);
+
 }  // namespace internal
 }  // namespace tensorstore
 
@@ -23,6 +23,7 @@
 #include "tensorstore/array.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
 #include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/arena.h"
@@ -43,6 +44,8 @@
 
 namespace {
 
+using ::tensorstore::Index;
+
 void DoCopyUnrolled(const uint8_t* TENSORSTORE_INTERNAL_RESTRICT src,
                     uint8_t* TENSORSTORE_INTERNAL_RESTRICT target,
                     int64_t inner_size, int64_t outer_size,
@@ -233,4 +236,54 @@ BENCHMARK(BM_Copy<kSimpleRestrict>)->Apply(DefineArgs);
 BENCHMARK(BM_Copy<kSimpleRestrictNoBuiltin>)->Apply(DefineArgs);
 BENCHMARK(BM_Copy<kDataType>)->Apply(DefineArgs);
 
+// Copies a C-order array to a Fortran-order array, which requires a
+// transpose of the two dimensions.
+template <typename T, bool UseNDIter>
+void BM_TransposeCopy(benchmark::State& state) {
+  const Index size = state.range(0);
+  auto source_array = tensorstore::AllocateArray<T>(
+      {size, size}, tensorstore::c_order, tensorstore::value_init);
+  auto target_array = tensorstore::AllocateArray<T>(
+      {size, size}, tensorstore::fortran_order, tensorstore::value_init);
+  for (auto s : state) {
+    if (UseNDIter) {
+      tensorstore::internal::Arena arena;
+      auto source_iterable = GetArrayNDIterable(source_array, &arena);
+      auto target_iterable = GetArrayNDIterable(target_array, &arena);
+      tensorstore::internal::NDIterableCopier copier(
+          *source_iterable, *target_iterable, source_array.shape(),
+          tensorstore::c_order, &arena);
+      TENSORSTORE_CHECK_OK(copier.Copy());
+    } else {
+      const T* src = source_array.data();
+      T* target = target_array.data();
+      for (Index i = 0; i < size; ++i) {
+        for (Index j = 0; j < size; ++j) {
+          target[j * size + i] = src[i * size + j];
+        }
+      }
+    }
+    benchmark::DoNotOptimize(target_array.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size *
+                          size * sizeof(T));
+}
+
+template <typename Bench>
+void DefineTransposeArgs(Bench* benchmark) {
+  benchmark->Arg(64);
+  benchmark->Arg(256);
+  benchmark->Arg(1024);
+  benchmark->Arg(4096);
+}
+
+BENCHMARK(BM_TransposeCopy<uint8_t, true>)->Apply(DefineTransposeArgs);
+BENCHMARK(BM_TransposeCopy<uint8_t, false>)->Apply(DefineTransposeArgs);
+BENCHMARK(BM_TransposeCopy<uint16_t, true>)->Apply(DefineTransposeArgs);
+BENCHMARK(BM_TransposeCopy<uint16_t, false>)->Apply(DefineTransposeArgs);
+BENCHMARK(BM_TransposeCopy<float, true>)->Apply(DefineTransposeArgs);
+BENCHMARK(BM_TransposeCopy<float, false>)->Apply(DefineTransposeArgs);
+BENCHMARK(BM_TransposeCopy<double, true>)->Apply(DefineTransposeArgs);
+BENCHMARK(BM_TransposeCopy<double, false>)->Apply(DefineTransposeArgs);
+
 }  // namespace
@@ -14,6 +14,8 @@
 
 #include "tensorstore/internal/nditerable_copy.h"
 
+#include <stdint.h>
+
 #include <memory>
 #include <new>
 #include <string>
@@ -37,7 +39,9 @@
 #include "tensorstore/internal/nditerable_elementwise_output_transform.h"
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/internal/nditerable_util.h"
+#include "tensorstore/internal/thread/thread_pool.h"
 #include "tensorstore/rank.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -216,4 +220,58 @@ TEST_P(MaybeUnitBlockSizeTest, InnerIndexArray) {
   EXPECT_EQ(expected, dest);
 }
 
+TEST(NDIterableCopyTest, CopyOuterRange) {
+  auto source_array = tensorstore::AllocateArray<int>({6, 4});
+  for (Index i = 0; i < 24; ++i) source_array.data()[i] = i + 1;
+  auto dest_array = tensorstore::AllocateArray<int>(
+      {6, 4}, tensorstore::fortran_order, tensorstore::value_init);
+  tensorstore::internal::Arena arena;
+  auto source_iterable =
+      GetTransformedArrayNDIterable(source_array, &arena).value();
+  auto dest_iterable =
+      GetTransformedArrayNDIterable(dest_array, &arena).value();
+  tensorstore::internal::NDIterableCopier copier(
+      *source_iterable, *dest_iterable, dest_array.shape(),
+      tensorstore::c_order, &arena);
+  const Index outer_size = copier.layout_info().iteration_shape[0];
+  ASSERT_EQ(0, outer_size % 2);
+  TENSORSTORE_ASSERT_OK(copier.CopyOuterRange(0, outer_size / 2));
+  Index num_copied = 0;
+  for (Index i = 0; i < 24; ++i) num_copied += (dest_array.data()[i] != 0);
+  EXPECT_EQ(12, num_copied);
+  TENSORSTORE_ASSERT_OK(copier.CopyOuterRange(outer_size / 2, outer_size));
+  EXPECT_EQ(source_array, dest_array);
+}
+
+/// Copies a large array with `ParallelNDIterableCopy` using `executor`.
+void TestParallelCopy(const tensorstore::Executor& executor) {
+  // Large enough to be split into several ranges.
+  const Index rows = 1024, cols = 2048;
+  auto source_array = tensorstore::AllocateArray<int64_t>({rows, cols});
+  for (Index i = 0; i < rows * cols; ++i) source_array.data()[i] = i;
+  auto dest_array = tensorstore::AllocateArray<int64_t>(
+      {rows, cols}, tensorstore::fortran_order, tensorstore::value_init);
+  tensorstore::internal::Arena arena;
+  auto source_iterable =
+      GetTransformedArrayNDIterable(source_array, &arena).value();
+  auto dest_iterable =
+      GetTransformedArrayNDIterable(dest_array, &arena).value();
+  TENSORSTORE_ASSERT_OK(tensorstore::internal::ParallelNDIterableCopy(
+      *source_iterable, *dest_iterable, dest_array.shape(), executor, &arena));
+  EXPECT_EQ(source_array, dest_array);
+}
+
+TEST(ParallelNDIterableCopyTest, ThreadPool) {
+  TestParallelCopy(tensorstore::internal::DetachedThreadPool(4));
+}
+
+TEST(ParallelNDIterableCopyTest, InlineExecutor) {
+  TestParallelCopy(tensorstore::InlineExecutor{});
+}
+
+TEST(ParallelNDIterableCopyTest, ExecutorNeverRunsTasks) {
+  // The calling thread copies all ranges itself.
+  TestParallelCopy([](tensorstore::ExecutorTask task) {});
+}
+
 }  // namespace
@@ -42,7 +42,7 @@ class GceAuthProvider : public RefreshableAuthProvider {
     std::vector<std::string> scopes;
   };
 
-  ~GceAuthProvider() override = default;
+  ~GceAuthProvider() override { StopBackgroundRefresh(); }
 
   GceAuthProvider(std::shared_ptr<internal_http::HttpTransport> transport,
                   const ServiceAccountInfo& service_account_info,
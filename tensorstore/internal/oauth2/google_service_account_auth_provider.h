@@ -36,7 +36,7 @@ class GoogleServiceAccountAuthProvider : public RefreshableAuthProvider {
  public:
   using AccountCredentials = internal_oauth2::GoogleServiceAccountCredentials;
 
-  ~GoogleServiceAccountAuthProvider() override = default;
+  ~GoogleServiceAccountAuthProvider() override { StopBackgroundRefresh(); }
 
   GoogleServiceAccountAuthProvider(
       const AccountCredentials& creds,
@@ -35,7 +35,7 @@ class OAuth2AuthProvider : public RefreshableAuthProvider {
  public:
   using RefreshToken = internal_oauth2::RefreshToken;
 
-  ~OAuth2AuthProvider() override = default;
+  ~OAuth2AuthProvider() override { StopBackgroundRefresh(); }
 
   OAuth2AuthProvider(const RefreshToken& creds, std::string uri,
                      std::shared_ptr<internal_http::HttpTransport> transport,
@@ -14,33 +14,103 @@
 
 #include "tensorstore/internal/oauth2/refreshable_auth_provider.h"
 
+#include <algorithm>
+#include <cassert>
 #include <functional>
 #include <utility>
 
+#include "absl/base/no_destructor.h"
+#include "absl/random/distributions.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorstore/internal/oauth2/bearer_token.h"
+#include "tensorstore/internal/thread/thread_pool.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/result.h"
 
 namespace tensorstore {
 namespace internal_oauth2 {
 
+namespace {
+
+constexpr absl::Duration kRefreshRetryDelay = absl::Seconds(10);
+
+const Executor& GetRefreshExecutor() {
+  static absl::NoDestructor<Executor> executor(
+      internal::DetachedThreadPool(2));
+  return *executor;
+}
+
+}  // namespace
+
 RefreshableAuthProvider::RefreshableAuthProvider(
     std::function<absl::Time()> clock)
     : clock_(clock ? std::move(clock) : &absl::Now) {}
 
+RefreshableAuthProvider::~RefreshableAuthProvider() {
+  StopBackgroundRefresh();
+}
+
+void RefreshableAuthProvider::StopBackgroundRefresh() {
+  absl::MutexLock lock(&mutex_);
+  stopped_ = true;
+  mutex_.Await(absl::Condition(
+      +[](bool* refreshing) { return !*refreshing; }, &refreshing_));
+}
+
+Result<BearerTokenWithExpiration> RefreshableAuthProvider::DoRefresh() {
+  assert(!refreshing_);
+  refreshing_ = true;
+  absl::Time start = clock_();
+  mutex_.Unlock();
+  auto token_result = Refresh();
+  mutex_.Lock();
+  refreshing_ = false;
+  ++refresh_generation_;
+  refresh_status_ = token_result.status();
+  if (token_result.ok()) {
+    token_ = *token_result;
+    absl::Duration lead =
+        kRefreshLead + absl::Uniform(gen_, absl::ZeroDuration(),
+                                     kRefreshJitter);
+    refresh_at_ =
+        std::max(token_.expiration - kExpirationMargin - lead,
+                 start + (token_.expiration - start) / 2);
+  } else {
+    // Avoid retrying a failed background refresh on every call while the
+    // current token remains valid.
+    refresh_at_ = clock_() + kRefreshRetryDelay;
+  }
+  return token_result;
+}
+
 Result<BearerTokenWithExpiration> RefreshableAuthProvider::GetToken() {
   absl::MutexLock lock(&mutex_);
   if (IsValidInternal()) {
+    if (!refreshing_ && !stopped_ && clock_() >= refresh_at_) {
+      // The token is still usable; refresh it off the request path.
+      refreshing_ = true;
+      GetRefreshExecutor()([this] {
+        absl::MutexLock lock(&mutex_);
+        refreshing_ = false;
+        if (!stopped_) DoRefresh().IgnoreResult();
+      });
+    }
     return token_;
   }
 
-  auto token_result = Refresh();
-  if (token_result.ok()) {
-    token_ = token_result.value();
+  if (refreshing_) {
+    // Share the result of the refresh already in progress.
+    const uint64_t generation = refresh_generation_;
+    mutex_.Await(absl::Condition(
+        +[](bool* refreshing) { return !*refreshing; }, &refreshing_));
+    if (IsValidInternal()) return token_;
+    if (refresh_generation_ != generation && !refresh_status_.ok()) {
+      return refresh_status_;
+    }
   }
-  return token_result;
+  return DoRefresh();
 }
 
 }  // namespace internal_oauth2
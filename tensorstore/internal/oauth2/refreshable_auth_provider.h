@@ -15,9 +15,13 @@
 #ifndef TENSORSTORE_INTERNAL_OAUTH2_REFRESHABLE_AUTH_PROVIDER_H_
 #define TENSORSTORE_INTERNAL_OAUTH2_REFRESHABLE_AUTH_PROVIDER_H_
 
+#include <stdint.h>
+
 #include <functional>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "tensorstore/internal/oauth2/auth_provider.h"
@@ -28,10 +32,27 @@ namespace tensorstore {
 namespace internal_oauth2 {
 
 /// Base class for auth providers that support refreshing.
+///
+/// Tokens are refreshed proactively: once a token is within
+/// `kRefreshLead` (plus a random jitter) of its expiration, the next call to
+/// `GetToken` returns the still-valid cached token and schedules a single
+/// `Refresh` on a background executor.  Callers only block when no valid
+/// token is available, and concurrent callers share a single in-flight
+/// `Refresh`.
 class RefreshableAuthProvider : public AuthProvider {
  public:
+  /// Minimum time ahead of `expiration - kExpirationMargin` at which the
+  /// token is refreshed in the background.  A random jitter of up to
+  /// `kRefreshJitter` is added so that many processes started together do
+  /// not refresh in lock-step.  The refresh point is never earlier than
+  /// halfway through the token lifetime.
+  static constexpr absl::Duration kRefreshLead = absl::Minutes(4);
+  static constexpr absl::Duration kRefreshJitter = absl::Minutes(1);
+
   explicit RefreshableAuthProvider(std::function<absl::Time()> clock = {});
 
+  ~RefreshableAuthProvider() override;
+
   /// Returns the short-term authentication bearer token.
   ///
   /// Safe for concurrent use by multiple threads.
@@ -52,9 +73,13 @@ class RefreshableAuthProvider : public AuthProvider {
 
  protected:
   // Generate a new BearerTokenWithExpiration.
-  // Guaranteed to be called under lock.
-  virtual Result<BearerTokenWithExpiration> Refresh()
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) = 0;
+  // Called without `mutex_` held; at most one call is in progress at a time.
+  virtual Result<BearerTokenWithExpiration> Refresh() = 0;
+
+  // Waits for any background refresh to complete and prevents new ones from
+  // being scheduled.  Derived classes whose `Refresh` depends on their own
+  // members must call this from their destructor.
+  void StopBackgroundRefresh() ABSL_LOCKS_EXCLUDED(mutex_);
 
   bool IsExpiredInternal() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
     return clock_() > (token_.expiration - kExpirationMargin);
@@ -67,11 +92,31 @@ class RefreshableAuthProvider : public AuthProvider {
   absl::Time GetCurrentTime() { return clock_(); }
 
  private:
+  // Runs `Refresh` with `mutex_` released and installs the result.
+  Result<BearerTokenWithExpiration> DoRefresh()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   std::function<absl::Time()> clock_;  // mock time.
 
   absl::Mutex mutex_;
   BearerTokenWithExpiration token_ ABSL_GUARDED_BY(mutex_) = {
       {}, absl::InfinitePast()};
+
+  // Time after which a valid token is refreshed in the background.
+  absl::Time refresh_at_ ABSL_GUARDED_BY(mutex_) = absl::InfiniteFuture();
+
+  // Whether a call to `Refresh` is in progress.
+  bool refreshing_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Whether background refreshes are disabled.
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Incremented each time a refresh completes, along with its status, so
+  // that callers which waited on another caller's refresh observe its error.
+  uint64_t refresh_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Status refresh_status_ ABSL_GUARDED_BY(mutex_);
+
+  absl::BitGen gen_ ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace internal_oauth2
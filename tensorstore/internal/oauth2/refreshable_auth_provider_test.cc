@@ -0,0 +1,144 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/oauth2/refreshable_auth_provider.h"
+
+#include <thread>  // NOLINT
+
+#include <gtest/gtest.h>
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/oauth2/bearer_token.h"
+#include "tensorstore/util/result.h"
+
+namespace {
+
+using ::tensorstore::Result;
+using ::tensorstore::internal_oauth2::BearerTokenWithExpiration;
+using ::tensorstore::internal_oauth2::RefreshableAuthProvider;
+
+/// Issues tokens named after the refresh count, valid for one hour.
+class TestAuthProvider : public RefreshableAuthProvider {
+ public:
+  TestAuthProvider()
+      : RefreshableAuthProvider([this] { return now(); }),
+        time_(absl::Now()) {}
+
+  ~TestAuthProvider() override { StopBackgroundRefresh(); }
+
+  absl::Time now() {
+    absl::MutexLock lock(&mutex_);
+    return time_;
+  }
+
+  void Advance(absl::Duration d) {
+    absl::MutexLock lock(&mutex_);
+    time_ += d;
+  }
+
+  int refresh_count() {
+    absl::MutexLock lock(&mutex_);
+    return refresh_count_;
+  }
+
+  /// If set, `Refresh` notifies `entered` and then blocks on `release`.
+  absl::Notification* entered = nullptr;
+  absl::Notification* release = nullptr;
+
+ protected:
+  Result<BearerTokenWithExpiration> Refresh() override {
+    if (entered) entered->Notify();
+    if (release) release->WaitForNotification();
+    absl::MutexLock lock(&mutex_);
+    ++refresh_count_;
+    return BearerTokenWithExpiration{absl::StrCat("token", refresh_count_),
+                                     time_ + absl::Hours(1)};
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::Time time_ ABSL_GUARDED_BY(mutex_);
+  int refresh_count_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+TEST(RefreshableAuthProviderTest, RefreshesAheadOfExpiry) {
+  TestAuthProvider auth;
+  auto result = auth.GetToken();
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ("token1", result->token);
+  EXPECT_EQ(1, auth.refresh_count());
+
+  // Well before the refresh point, the cached token is returned.
+  auth.Advance(absl::Minutes(30));
+  result = auth.GetToken();
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ("token1", result->token);
+  EXPECT_EQ(1, auth.refresh_count());
+
+  // Within the refresh lead, the still-valid token is returned immediately
+  // while a refresh runs in the background.
+  absl::Notification entered, release;
+  auth.entered = &entered;
+  auth.release = &release;
+  auth.Advance(absl::Minutes(30) - RefreshableAuthProvider::kExpirationMargin -
+               RefreshableAuthProvider::kRefreshLead);
+  result = auth.GetToken();
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ("token1", result->token);
+  entered.WaitForNotification();
+
+  // Concurrent callers do not start another refresh.
+  result = auth.GetToken();
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ("token1", result->token);
+
+  release.Notify();
+  while (auth.refresh_count() < 2) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  auth.entered = nullptr;
+  auth.release = nullptr;
+  // Wait for the new token to be installed.
+  while (auth.GetToken().value().token != "token2") {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(2, auth.refresh_count());
+}
+
+TEST(RefreshableAuthProviderTest, SingleFlight) {
+  TestAuthProvider auth;
+  absl::Notification entered, release;
+  auth.entered = &entered;
+  auth.release = &release;
+
+  Result<BearerTokenWithExpiration> result1, result2;
+  std::thread t1([&] { result1 = auth.GetToken(); });
+  entered.WaitForNotification();
+  std::thread t2([&] { result2 = auth.GetToken(); });
+  release.Notify();
+  t1.join();
+  t2.join();
+
+  ASSERT_TRUE(result1.ok()) << result1.status();
+  ASSERT_TRUE(result2.ok()) << result2.status();
+  EXPECT_EQ("token1", result1->token);
+  EXPECT_EQ("token1", result2->token);
+  EXPECT_EQ(1, auth.refresh_count());
+}
+
+}  // namespace
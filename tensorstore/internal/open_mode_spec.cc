@@ -72,6 +72,11 @@ TENSORSTORE_DEFINE_JSON_BINDER(
                                       jb::DefaultValue([](bool* v) {
                                         *v = false;
                                       })))),
+        jb::Member("defer_validation",
+                   jb::Projection(&OpenModeSpec::defer_validation,
+                                  jb::DefaultValue([](bool* v) {
+                                    *v = false;
+                                  }))),
         // For backward compatibility, accept `allow_metadata_mismatch` even
         // though it is no longer supported.
         jb::Member("allow_metadata_mismatch", [](auto is_loading,
@@ -98,6 +103,8 @@ absl::Status OpenModeSpec::ApplyOptions(const SpecOptions& options) {
     assume_cached_metadata =
         !assume_metadata && ((open_mode & OpenMode::assume_cached_metadata) ==
                              OpenMode::assume_cached_metadata);
+    defer_validation =
+        (open_mode & OpenMode::defer_validation) == OpenMode::defer_validation;
   }
   return absl::Status();
 }
@@ -139,6 +146,12 @@ absl::Status OpenModeSpec::Validate(ReadWriteMode read_write_mode) const {
         "without `open`");
   }
 
+  if (defer_validation && !open) {
+    return absl::InvalidArgumentError(
+        "Cannot specify an open mode of `defer_validation` "
+        "without `open`");
+  }
+
   if (create && (read_write_mode != ReadWriteMode::dynamic &&
                  !(read_write_mode & ReadWriteMode::write))) {
     return absl::InvalidArgumentError(
@@ -34,6 +34,7 @@ struct OpenModeSpec {
   bool delete_existing = false;
   bool assume_metadata = false;
   bool assume_cached_metadata = false;
+  bool defer_validation = false;
 
   OpenMode open_mode() const {
     return (open ? OpenMode::open : OpenMode{}) |
@@ -41,13 +42,14 @@ struct OpenModeSpec {
            (delete_existing ? OpenMode::delete_existing : OpenMode{}) |
            (assume_metadata ? OpenMode::assume_metadata : OpenMode{}) |
            (assume_cached_metadata ? OpenMode::assume_cached_metadata
-                                   : OpenMode{});
+                                   : OpenMode{}) |
+           (defer_validation ? OpenMode::defer_validation : OpenMode{});
   }
 
   // For compatibility with `ContextBindingTraits`.
   static constexpr auto ApplyMembers = [](auto& x, auto f) {
     return f(x.open, x.create, x.delete_existing, x.assume_metadata,
-             x.assume_cached_metadata);
+             x.assume_cached_metadata, x.defer_validation);
   };
 
   /// Applies the specified options.
@@ -23,6 +23,7 @@
 
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
+#include "tensorstore/util/executor.h"
 
 namespace tensorstore {
 namespace internal_os {
@@ -65,6 +66,25 @@ absl::Status RecursiveFileList(
     absl::FunctionRef<bool(std::string_view)> recurse_into,
     absl::FunctionRef<absl::Status(ListerEntry)> on_item);
 
+/// Recursively lists the files (but not the directories) under
+/// `root_directory`, like `RecursiveFileList`, but reads up to `parallelism`
+/// directories concurrently using tasks submitted to `executor`.
+///
+/// `recurse_into` is called for each directory before it is read, and may be
+/// called concurrently from multiple threads.  Calls to `on_file` are
+/// serialized, but may occur on any thread and in any order.
+///
+/// The calling thread also takes part in the traversal, so that progress does
+/// not depend on `executor`, which may be the executor on which this function
+/// is called.  Returns once the traversal is complete, or after the first
+/// error, which stops the traversal.
+///
+/// On Windows, directories are read sequentially on the calling thread.
+absl::Status ParallelRecursiveFileList(
+    std::string root_directory, const Executor& executor, size_t parallelism,
+    absl::FunctionRef<bool(std::string_view)> recurse_into,
+    absl::FunctionRef<absl::Status(ListerEntry)> on_file);
+
 }  // namespace internal_os
 }  // namespace tensorstore
 
@@ -25,21 +25,31 @@
 #include <stdint.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/os/error_code.h"
 #include "tensorstore/internal/os/potentially_blocking_region.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/status.h"
 
@@ -209,6 +219,238 @@ absl::Status RecursiveListImpl(
   return absl::OkStatus();
 }
 
+/// Size of the buffer used to read directory entries.  Large buffers reduce the
+/// number of round trips required on network filesystems.
+constexpr size_t kDirectoryBufferSize = 512 * 1024;
+
+std::string JoinPathComponent(const std::string& path,
+                              std::string_view component) {
+  return absl::StrCat(
+      path, (path.empty() || absl::EndsWith(path, "/")) ? "" : "/", component);
+}
+
+/// Shared state of `ParallelRecursiveFileList`.
+///
+/// Directories that remain to be read are kept on a stack, from which the
+/// calling thread and up to `parallelism - 1` tasks submitted to the executor
+/// take directories until the stack is empty and no directory is being read.
+///
+/// Tasks that start after the traversal is done return immediately, so `Run`
+/// only waits for the threads that are actually taking part in it.
+class ParallelFileLister
+    : public std::enable_shared_from_this<ParallelFileLister> {
+ public:
+  ParallelFileLister(Executor executor, size_t parallelism,
+                     absl::FunctionRef<bool(std::string_view)> recurse_into,
+                     absl::FunctionRef<absl::Status(ListerEntry)> on_file)
+      : executor_(std::move(executor)),
+        parallelism_(std::max(size_t(1), parallelism)),
+        recurse_into_(recurse_into),
+        on_file_(on_file) {}
+
+  absl::Status Run(std::string root_directory) {
+    {
+      absl::MutexLock lock(&mutex_);
+      pending_.push_back(std::move(root_directory));
+      ++workers_;
+    }
+    Work();
+    // `recurse_into_` and `on_file_` must not be used once this returns.
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(this, &ParallelFileLister::Idle));
+    return status_;
+  }
+
+ private:
+  /// Reads directories until the traversal is done.
+  ///
+  /// \pre The caller has incremented `workers_`.
+  void Work() {
+    std::unique_ptr<char[]> buffer(new char[kDirectoryBufferSize]);
+    absl::MutexLock lock(&mutex_);
+    while (true) {
+      mutex_.Await(absl::Condition(this, &ParallelFileLister::CanProceed));
+      if (pending_.empty()) {
+        // Either an error occurred, or no directory is being read that could
+        // add more.
+        done_ = true;
+        break;
+      }
+      std::string path = std::move(pending_.back());
+      pending_.pop_back();
+      ++reading_;
+      std::vector<std::string> subdirectories;
+      mutex_.Unlock();
+      auto status = ReadDirectory(path, buffer.get(), subdirectories);
+      mutex_.Lock();
+      --reading_;
+      if (!status.ok() && !done_) {
+        status_ = std::move(status);
+        done_ = true;
+      }
+      if (done_) {
+        // Stop after the first error.
+        pending_.clear();
+        break;
+      }
+      for (auto& subdirectory : subdirectories) {
+        pending_.push_back(std::move(subdirectory));
+      }
+      // Start additional workers for the directories that can't be read
+      // right away.
+      size_t new_helpers = 0;
+      while (helpers_ + 1 < parallelism_ && helpers_ < pending_.size()) {
+        ++helpers_;
+        ++new_helpers;
+      }
+      if (new_helpers == 0) continue;
+      mutex_.Unlock();
+      for (size_t i = 0; i < new_helpers; ++i) {
+        executor_([self = shared_from_this()] {
+          {
+            absl::MutexLock lock(&self->mutex_);
+            if (self->done_) return;
+            ++self->workers_;
+          }
+          self->Work();
+        });
+      }
+      mutex_.Lock();
+    }
+    --workers_;
+  }
+
+  bool CanProceed() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return done_ || !pending_.empty() || reading_ == 0;
+  }
+
+  bool Idle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return workers_ == 0;
+  }
+
+  /// Reads the entries of the directory `path`, reporting files to `on_file_`
+  /// and adding the subdirectories to recurse into to `subdirectories`.
+  absl::Status ReadDirectory(const std::string& path, char* buffer,
+                             std::vector<std::string>& subdirectories) {
+    if (!recurse_into_(path)) return absl::OkStatus();
+    int fd;
+    do {
+      PotentiallyBlockingRegion region;
+      fd = ::open(path.empty() ? "." : path.c_str(),
+                  O_CLOEXEC | O_RDONLY | O_DIRECTORY);
+    } while (fd == -1 && errno == EINTR);
+    if (fd == -1) {
+      // The directory was removed concurrently; ignore.
+      if (errno == ENOENT || errno == ENOTDIR) return absl::OkStatus();
+      return StatusFromOsError(errno,
+                               "Failed while listing: ", QuoteString(path));
+    }
+    UniqueFileDescriptor unique_fd(fd);
+
+    // Files in the current batch of entries, as full paths and the size of the
+    // last component.
+    std::vector<std::pair<std::string, size_t>> files;
+    auto add_entry = [&](const char* name, unsigned char type) {
+      std::string_view component(name);
+      if (component == "." || component == "..") return;
+      bool is_directory = (type == DT_DIR);
+      if (type == DT_UNKNOWN) {
+        struct ::stat entry_stat;
+        is_directory =
+            ::fstatat(fd, name, &entry_stat, AT_SYMLINK_NOFOLLOW) == 0 &&
+            S_ISDIR(entry_stat.st_mode);
+      }
+      std::string full_path = JoinPathComponent(path, component);
+      if (is_directory) {
+        subdirectories.push_back(std::move(full_path));
+      } else {
+        files.emplace_back(std::move(full_path), component.size());
+      }
+    };
+    auto report_files = [&]() -> absl::Status {
+      if (files.empty()) return absl::OkStatus();
+      absl::MutexLock lock(&on_file_mutex_);
+      for (auto& [full_path, component_size] : files) {
+        std::string_view component(full_path);
+        component.remove_prefix(full_path.size() - component_size);
+        ListerEntry::Impl impl{fd, full_path, component, false};
+        TENSORSTORE_RETURN_IF_ERROR(on_file_(ListerEntry(&impl)));
+      }
+      files.clear();
+      return absl::OkStatus();
+    };
+
+#ifdef __linux__
+    // Read directly with `getdents64` to control the buffer size, which is
+    // fixed by `readdir`.
+    while (true) {
+      long n;
+      {
+        PotentiallyBlockingRegion region;
+        n = ::syscall(SYS_getdents64, fd, buffer, kDirectoryBufferSize);
+      }
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        return StatusFromOsError(errno,
+                                 "Failed while listing: ", QuoteString(path));
+      }
+      if (n == 0) break;
+      for (long pos = 0; pos < n;) {
+        auto* e = reinterpret_cast<struct ::dirent64*>(buffer + pos);
+        pos += e->d_reclen;
+        add_entry(e->d_name, e->d_type);
+      }
+      TENSORSTORE_RETURN_IF_ERROR(report_files());
+    }
+#else
+    DIR* dir = ::fdopendir(unique_fd.release());
+    if (dir == nullptr) {
+      ::close(fd);
+      return StatusFromOsError(errno,
+                               "Failed while listing: ", QuoteString(path));
+    }
+    std::unique_ptr<DIR, int (*)(DIR*)> unique_dir(dir, &::closedir);
+    while (true) {
+      errno = 0;
+      struct ::dirent* e;
+      {
+        PotentiallyBlockingRegion region;
+        e = ::readdir(dir);
+      }
+      if (e == nullptr) {
+        if (errno != 0) {
+          return StatusFromOsError(
+              errno, "Failed while listing: ", QuoteString(path));
+        }
+        break;
+      }
+      add_entry(e->d_name, e->d_type);
+    }
+    TENSORSTORE_RETURN_IF_ERROR(report_files());
+#endif
+    return absl::OkStatus();
+  }
+
+  Executor executor_;
+  size_t parallelism_;
+  absl::FunctionRef<bool(std::string_view)> recurse_into_;
+  absl::FunctionRef<absl::Status(ListerEntry)> on_file_;
+
+  absl::Mutex mutex_;
+  std::vector<std::string> pending_ ABSL_GUARDED_BY(mutex_);
+  // Number of directories being read.
+  size_t reading_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of threads in `Work`.
+  size_t workers_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of tasks submitted to `executor_`, each of which takes part until
+  // the traversal is done.
+  size_t helpers_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+
+  absl::Mutex on_file_mutex_;
+};
+
 }  // namespace
 
 absl::Status RecursiveFileList(
@@ -233,5 +475,29 @@ absl::Status RecursiveFileList(
   return status;
 }
 
+absl::Status ParallelRecursiveFileList(
+    std::string root_directory, const Executor& executor, size_t parallelism,
+    absl::FunctionRef<bool(std::string_view)> recurse_into,
+    absl::FunctionRef<absl::Status(ListerEntry)> on_file) {
+  // root_directory must be a directory.
+  struct ::stat dir_stat;
+  if (::fstatat(AT_FDCWD, root_directory.empty() ? "." : root_directory.c_str(),
+                &dir_stat, 0) != 0) {
+    if (errno == ENOENT) return absl::OkStatus();
+    return StatusFromOsError(errno,
+                             "Failed to stat: ", QuoteString(root_directory));
+  }
+  if (!S_ISDIR(dir_stat.st_mode)) {
+    return absl::NotFoundError(absl::StrCat("Cannot list non-directory: ",
+                                            QuoteString(root_directory)));
+  }
+
+  auto lister = std::make_shared<ParallelFileLister>(executor, parallelism,
+                                                     recurse_into, on_file);
+  auto status = lister->Run(std::move(root_directory));
+  MaybeAddSourceLocation(status);
+  return status;
+}
+
 }  // namespace internal_os
 }  // namespace tensorstore
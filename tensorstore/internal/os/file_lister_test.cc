@@ -27,6 +27,8 @@
 #include "absl/strings/str_cat.h"
 #include "tensorstore/internal/os/file_util.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/internal/thread/thread_pool.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
@@ -41,6 +43,7 @@ using ::tensorstore::internal_os::MakeDirectory;
 using ::tensorstore::internal_os::OpenDirectoryDescriptor;
 using ::tensorstore::internal_os::OpenExistingFileForReading;
 using ::tensorstore::internal_os::OpenFileForWriting;
+using ::tensorstore::internal_os::ParallelRecursiveFileList;
 using ::tensorstore::internal_os::ReadFromFile;
 using ::tensorstore::internal_os::RecursiveFileList;
 using ::tensorstore::internal_os::WriteToFile;
@@ -174,6 +177,42 @@ TEST_F(RecursiveFileListTest, NonRecursive) {
                                               "<dir>zzq", "<dir>xyz", "<dir>"));
 }
 
+TEST_F(RecursiveFileListTest, Parallel) {
+  for (const tensorstore::Executor& executor :
+       {tensorstore::Executor(tensorstore::InlineExecutor{}),
+        tensorstore::internal::DetachedThreadPool(4)}) {
+    std::vector<std::string> files;
+    EXPECT_THAT(ParallelRecursiveFileList(
+                    "", executor, /*parallelism=*/4,
+                    /*recurse_into=*/
+                    [](std::string_view path) { return path != "zzq"; },
+                    /*on_file=*/
+                    [&](auto entry) {
+                      files.push_back(entry.GetFullPath());
+                      return absl::OkStatus();
+                    }),
+                IsOk());
+    EXPECT_THAT(files, ::testing::UnorderedElementsAre(
+                           "a.txt", "b.txt", "c.txt", "xyz/a.txt",
+                           "xyz/b.txt", "xyz/c.txt"));
+  }
+}
+
+TEST_F(RecursiveFileListTest, ParallelError) {
+  auto executor = tensorstore::internal::DetachedThreadPool(4);
+  EXPECT_THAT(ParallelRecursiveFileList(
+                  "", executor, /*parallelism=*/4,
+                  /*recurse_into=*/[](std::string_view path) { return true; },
+                  /*on_file=*/
+                  [&](auto entry) { return absl::UnknownError("failed"); }),
+              ::testing::Not(IsOk()));
+  EXPECT_THAT(ParallelRecursiveFileList(
+                  g_scoped_dir->path() + "/aax", executor, /*parallelism=*/4,
+                  /*recurse_into=*/[](std::string_view path) { return true; },
+                  /*on_file=*/[](auto entry) { return absl::OkStatus(); }),
+              IsOk());
+}
+
 TEST(RecursiveFileListEntryTest, DeleteWithOpenFile) {
   // List the subdirectory (relative path)
   ScopedTemporaryDirectory tmpdir;
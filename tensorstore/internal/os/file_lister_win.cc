@@ -24,6 +24,7 @@
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
@@ -31,6 +32,7 @@
 #include "absl/strings/str_cat.h"
 #include "tensorstore/internal/os/error_code.h"
 #include "tensorstore/internal/os/wstring.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/status.h"
 
@@ -262,5 +264,16 @@ absl::Status RecursiveFileList(
   return status;
 }
 
+absl::Status ParallelRecursiveFileList(
+    std::string root_directory, const Executor& executor, size_t parallelism,
+    absl::FunctionRef<bool(std::string_view)> recurse_into,
+    absl::FunctionRef<absl::Status(ListerEntry)> on_file) {
+  return RecursiveFileList(std::move(root_directory), recurse_into,
+                           [&](ListerEntry entry) -> absl::Status {
+                             if (entry.IsDirectory()) return absl::OkStatus();
+                             return on_file(entry);
+                           });
+}
+
 }  // namespace internal_os
 }  // namespace tensorstore
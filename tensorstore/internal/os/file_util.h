@@ -123,6 +123,21 @@ Result<UniqueFileDescriptor> OpenFileForWriting(const std::string& path);
 Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
                                int64_t offset);
 
+/// Maps the first `size` bytes of an open file into memory, read-only.
+///
+/// The returned `absl::Cord` references the mapping directly, and the mapping
+/// is released once the last reference to it is destroyed.  The mapping
+/// remains valid after `fd` is closed.  If the file is subsequently truncated,
+/// accessing the truncated portion of the mapping results in a `SIGBUS`;
+/// therefore, this must only be used for files that are never modified in
+/// place.
+///
+/// \param fd Open file descriptor.
+/// \param size Number of bytes to map, must not exceed the size of the file.
+/// \error `absl::StatusCode::kUnimplemented` if memory mapping is not
+///     supported on this platform.
+Result<absl::Cord> MemmapFileReadOnly(FileDescriptor fd, size_t size);
+
 /// Writes to an open file.
 ///
 /// \param fd Open file descriptor.
@@ -143,6 +158,25 @@ Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf, size_t count);
 ///     error).
 Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value);
 
+/// Opens an existing file for writing, bypassing the operating system page
+/// cache (e.g. `O_DIRECT` on Linux, `F_NOCACHE` on macOS).
+///
+/// Data must be written to the returned file descriptor using
+/// `WriteCordToFileDirect`.
+///
+/// \error `absl::StatusCode::kUnimplemented` if not supported on this
+///     platform.
+/// \error `absl::StatusCode::kInvalidArgument` if not supported by the
+///     filesystem.
+Result<UniqueFileDescriptor> OpenFileForDirectWriting(const std::string& path);
+
+/// Writes `value` to the start of a file opened by `OpenFileForDirectWriting`
+/// through aligned buffers, and then sets the file size to `value.size()`.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if the filesystem rejects the
+///     aligned writes, in which case the file contents are unspecified.
+absl::Status WriteCordToFileDirect(FileDescriptor fd, const absl::Cord& value);
+
 /// Truncates an open file.
 ///
 /// \returns `true` on success, or `false` in case of an error (in which case
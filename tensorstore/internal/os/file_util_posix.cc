@@ -23,6 +23,7 @@
 #include <fcntl.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -32,9 +33,12 @@
 #include <sys/file.h>
 #endif
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -168,6 +172,19 @@ Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
   return StatusFromOsError(errno, "Failed to read from file");
 }
 
+Result<absl::Cord> MemmapFileReadOnly(FileDescriptor fd, size_t size) {
+  if (size == 0) return absl::Cord();
+  void* address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (address == MAP_FAILED) {
+    return StatusFromOsError(errno, "Failed to mmap file");
+  }
+  return absl::MakeCordFromExternal(
+      absl::string_view(static_cast<const char*>(address), size),
+      [](absl::string_view s) {
+        ::munmap(const_cast<char*>(s.data()), s.size());
+      });
+}
+
 Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf,
                               size_t count) {
   ssize_t n;
@@ -206,6 +223,103 @@ Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   return StatusFromOsError(errno, "Failed to write to file");
 }
 
+Result<UniqueFileDescriptor> OpenFileForDirectWriting(const std::string& path) {
+#if defined(O_DIRECT) || defined(__APPLE__)
+  FileDescriptor fd = FileDescriptorTraits::Invalid();
+  {
+    PotentiallyBlockingRegion region;
+#if defined(O_DIRECT)
+    fd = ::open(path.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+#else
+    fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+#endif
+  }
+  if (fd == FileDescriptorTraits::Invalid()) {
+    return StatusFromOsError(errno, "Failed to open for direct I/O: ",
+                             QuoteString(path));
+  }
+  UniqueFileDescriptor unique_fd(fd);
+#if !defined(O_DIRECT)
+  if (::fcntl(fd, F_NOCACHE, 1) != 0) {
+    return StatusFromOsError(errno, "Failed to disable caching: ",
+                             QuoteString(path));
+  }
+#endif
+  return unique_fd;
+#else
+  return absl::UnimplementedError(
+      "Direct I/O is not supported on this platform");
+#endif
+}
+
+absl::Status WriteCordToFileDirect(FileDescriptor fd, const absl::Cord& value) {
+  // Alignment that satisfies the `O_DIRECT` requirements of all common
+  // filesystems and devices.
+  constexpr size_t kAlignment = 4096;
+  constexpr size_t kMaxBufferSize = 1024 * 1024;
+  const size_t padded_size =
+      (value.size() + kAlignment - 1) / kAlignment * kAlignment;
+  const size_t buffer_size = std::min(kMaxBufferSize, padded_size);
+
+  struct FreeDeleter {
+    void operator()(char* p) const { ::free(p); }
+  };
+  std::unique_ptr<char, FreeDeleter> buffer;
+  if (buffer_size > 0) {
+    void* p;
+    if (int error = ::posix_memalign(&p, kAlignment, buffer_size); error != 0) {
+      return StatusFromOsError(error, "Failed to allocate aligned buffer");
+    }
+    buffer.reset(static_cast<char*>(p));
+  }
+
+  size_t buffer_used = 0;
+  off_t offset = 0;
+  // Writes the first `n` bytes of `buffer`, where `n` is a multiple of
+  // `kAlignment`.
+  const auto flush = [&](size_t n) -> absl::Status {
+    for (size_t written = 0; written < n;) {
+      ssize_t r;
+      do {
+        PotentiallyBlockingRegion region;
+        r = ::pwrite(fd, buffer.get() + written, n - written, offset + written);
+      } while (r < 0 && errno == EINTR);
+      if (r < 0) {
+        return StatusFromOsError(errno, "Failed to write to file");
+      }
+      if (r == 0) {
+        return StatusFromOsError(ENOSPC, "Failed to write to file");
+      }
+      written += r;
+    }
+    offset += n;
+    buffer_used = 0;
+    return absl::OkStatus();
+  };
+
+  for (std::string_view chunk : value.Chunks()) {
+    while (!chunk.empty()) {
+      size_t n = std::min(chunk.size(), buffer_size - buffer_used);
+      std::memcpy(buffer.get() + buffer_used, chunk.data(), n);
+      buffer_used += n;
+      chunk.remove_prefix(n);
+      if (buffer_used == buffer_size) {
+        TENSORSTORE_RETURN_IF_ERROR(flush(buffer_size));
+      }
+    }
+  }
+  if (buffer_used != 0) {
+    // The final block is padded, and the excess is removed by `ftruncate`.
+    size_t n = (buffer_used + kAlignment - 1) / kAlignment * kAlignment;
+    std::memset(buffer.get() + buffer_used, 0, n - buffer_used);
+    TENSORSTORE_RETURN_IF_ERROR(flush(n));
+  }
+  if (::ftruncate(fd, static_cast<off_t>(value.size())) != 0) {
+    return StatusFromOsError(errno, "Failed to truncate file");
+  }
+  return absl::OkStatus();
+}
+
 absl::Status TruncateFile(FileDescriptor fd) {
   if (::ftruncate(fd, 0) == 0) {
     return absl::OkStatus();
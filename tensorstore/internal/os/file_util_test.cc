@@ -41,12 +41,15 @@ using ::tensorstore::internal_os::GetMTime;
 using ::tensorstore::internal_os::GetSize;
 using ::tensorstore::internal_os::IsDirSeparator;
 using ::tensorstore::internal_os::IsRegularFile;
+using ::tensorstore::internal_os::MemmapFileReadOnly;
 using ::tensorstore::internal_os::OpenExistingFileForReading;
+using ::tensorstore::internal_os::OpenFileForDirectWriting;
 using ::tensorstore::internal_os::OpenFileForWriting;
 using ::tensorstore::internal_os::ReadFromFile;
 using ::tensorstore::internal_os::RenameOpenFile;
 using ::tensorstore::internal_os::TruncateFile;
 using ::tensorstore::internal_os::WriteCordToFile;
+using ::tensorstore::internal_os::WriteCordToFileDirect;
 using ::tensorstore::internal_os::WriteToFile;
 
 TEST(FileUtilTest, Basics) {
@@ -120,4 +123,83 @@ TEST(FileUtilTest, Basics) {
   }
 }
 
+TEST(FileUtilTest, MemmapFileReadOnly) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+  std::string renamed_txt = tempdir.path() + "/renamed.txt";
+  std::string contents(10000, 'x');
+  contents[0] = 'a';
+  contents.back() = 'z';
+  {
+    auto f = OpenFileForWriting(foo_txt);
+    EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord(contents)),
+                IsOkAndHolds(contents.size()));
+  }
+
+  absl::Cord mapped;
+  {
+    auto f = OpenExistingFileForReading(foo_txt);
+    ASSERT_THAT(f, IsOk());
+    auto result = MemmapFileReadOnly(f->get(), contents.size());
+#ifdef _WIN32
+    EXPECT_THAT(result, StatusIs(absl::StatusCode::kUnimplemented));
+    return;
+#endif
+    ASSERT_THAT(result, IsOk());
+    mapped = *std::move(result);
+    EXPECT_THAT(MemmapFileReadOnly(f->get(), 0), IsOkAndHolds(absl::Cord()));
+  }
+
+  // The mapping remains valid after the file is closed and replaced.
+  {
+    auto f = OpenFileForWriting(renamed_txt);
+    EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord("new")), IsOkAndHolds(3));
+    EXPECT_THAT(RenameOpenFile(f->get(), renamed_txt, foo_txt), IsOk());
+  }
+  EXPECT_EQ(contents, mapped);
+  EXPECT_EQ("axx", mapped.Subcord(0, 3));
+}
+
+TEST(FileUtilTest, WriteCordToFileDirect) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+  {
+    auto f = OpenFileForWriting(foo_txt);
+    ASSERT_THAT(f, IsOk());
+  }
+
+  // Not a multiple of the alignment, and spanning multiple buffers.
+  std::string contents(2 * 1024 * 1024 + 100, 'x');
+  contents[0] = 'a';
+  contents.back() = 'z';
+  {
+    auto f = OpenFileForDirectWriting(foo_txt);
+    if (absl::IsUnimplemented(f.status()) ||
+        absl::IsInvalidArgument(f.status())) {
+      GTEST_SKIP() << f.status();
+    }
+    ASSERT_THAT(f, IsOk());
+    auto status = WriteCordToFileDirect(f->get(), absl::Cord(contents));
+    if (absl::IsInvalidArgument(status)) GTEST_SKIP() << status;
+    ASSERT_THAT(status, IsOk());
+  }
+
+  auto f = OpenExistingFileForReading(foo_txt);
+  ASSERT_THAT(f, IsOk());
+  FileInfo info;
+  ASSERT_THAT(GetFileInfo(f->get(), &info), IsOk());
+  EXPECT_EQ(contents.size(), GetSize(info));
+
+  std::string buf(contents.size(), '\0');
+  size_t total = 0;
+  while (total < buf.size()) {
+    auto n = ReadFromFile(f->get(), buf.data() + total, buf.size() - total,
+                          total);
+    ASSERT_THAT(n, IsOk());
+    ASSERT_GT(*n, 0);
+    total += *n;
+  }
+  EXPECT_EQ(contents, buf);
+}
+
 }  // namespace
@@ -240,6 +240,13 @@ Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
   return StatusFromOsError(::GetLastError(), "Failed to read from file");
 }
 
+Result<absl::Cord> MemmapFileReadOnly(FileDescriptor fd, size_t size) {
+  // A mapped view prevents the file from being replaced by `RenameOpenFile`,
+  // which would break concurrent writers.
+  return absl::UnimplementedError(
+      "Memory mapping files is not supported on Windows");
+}
+
 Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf,
                               size_t count) {
   if (count > std::numeric_limits<DWORD>::max()) {
@@ -268,6 +275,14 @@ Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   return value.size();
 }
 
+Result<UniqueFileDescriptor> OpenFileForDirectWriting(const std::string& path) {
+  return absl::UnimplementedError("Direct I/O is not supported on Windows");
+}
+
+absl::Status WriteCordToFileDirect(FileDescriptor fd, const absl::Cord& value) {
+  return absl::UnimplementedError("Direct I/O is not supported on Windows");
+}
+
 absl::Status TruncateFile(FileDescriptor fd) {
   if (::SetEndOfFile(fd)) {
     return absl::OkStatus();
@@ -0,0 +1,357 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/io_uring.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "absl/status/status.h"
+#include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/util/result.h"
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && \
+    defined(__NR_io_uring_enter)
+#define TENSORSTORE_INTERNAL_HAVE_IO_URING 1
+#endif
+
+#ifdef TENSORSTORE_INTERNAL_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/os/error_code.h"
+#include "tensorstore/internal/thread/thread.h"
+#endif
+
+namespace tensorstore {
+namespace internal_os {
+
+IoUringEngine::~IoUringEngine() = default;
+
+#ifdef TENSORSTORE_INTERNAL_HAVE_IO_URING
+namespace {
+
+using ::tensorstore::internal::StatusFromOsError;
+
+int IoUringSetup(unsigned entries, ::io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                    min_complete, flags, nullptr, 0));
+}
+
+/// Memory mapping of one of the io_uring regions.
+struct RingMapping {
+  void* ptr = MAP_FAILED;
+  size_t size = 0;
+
+  RingMapping() = default;
+  RingMapping(const RingMapping&) = delete;
+  RingMapping& operator=(const RingMapping&) = delete;
+
+  absl::Status Map(int ring_fd, size_t size, off_t offset) {
+    this->size = size;
+    ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+    if (ptr == MAP_FAILED) {
+      return StatusFromOsError(errno, "Failed to map io_uring region");
+    }
+    return absl::OkStatus();
+  }
+
+  template <typename T>
+  T* At(uint32_t offset) const {
+    return reinterpret_cast<T*>(static_cast<char*>(ptr) + offset);
+  }
+
+  ~RingMapping() {
+    if (ptr != MAP_FAILED) ::munmap(ptr, size);
+  }
+};
+
+class LinuxIoUringEngine final : public IoUringEngine {
+ public:
+  static Result<std::unique_ptr<LinuxIoUringEngine>> Create(
+      unsigned queue_depth) {
+    ::io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int ring_fd = IoUringSetup(std::max(1u, queue_depth), &params);
+    if (ring_fd < 0) {
+      return StatusFromOsError(errno, "io_uring_setup failed");
+    }
+    std::unique_ptr<LinuxIoUringEngine> engine(
+        new LinuxIoUringEngine(ring_fd, params));
+    TENSORSTORE_RETURN_IF_ERROR(engine->MapRings());
+    engine->completion_thread_ = internal::Thread(
+        {"tensorstore_io_uring"}, [engine = engine.get()] {
+          engine->CompletionLoop();
+        });
+    return engine;
+  }
+
+  ~LinuxIoUringEngine() override {
+    if (completion_thread_.get_id() != internal::Thread::Id()) {
+      {
+        absl::MutexLock lock(&mutex_);
+        // A request without a callback signals the completion thread to exit.
+        QueueLocked(new Operation{});
+        SubmitLocked();
+      }
+      completion_thread_.Join();
+    }
+    ::close(ring_fd_);
+  }
+
+  void Read(FileDescriptor fd, void* buf, size_t count, int64_t offset,
+            ReadCallback callback) override {
+    auto* op = new Operation;
+    op->fd = fd;
+    op->offset = offset;
+    op->iov.iov_base = buf;
+    op->iov.iov_len = count;
+    op->callback = std::move(callback);
+    absl::MutexLock lock(&mutex_);
+    QueueLocked(op);
+    SubmitLocked();
+  }
+
+ private:
+  struct Operation {
+    FileDescriptor fd = -1;
+    int64_t offset = 0;
+    ::iovec iov{};
+    ReadCallback callback;
+  };
+
+  LinuxIoUringEngine(int ring_fd, const ::io_uring_params& params)
+      : ring_fd_(ring_fd),
+        params_(params),
+        // Bounding the number of requests in flight by the submission queue
+        // size ensures that a submission queue entry is always available, and
+        // that the completion queue (which is at least as large) never
+        // overflows.
+        max_in_flight_(std::min(params.sq_entries, params.cq_entries)) {}
+
+  absl::Status MapRings() {
+    size_t sq_size =
+        params_.sq_off.array + params_.sq_entries * sizeof(uint32_t);
+    size_t cq_size =
+        params_.cq_off.cqes + params_.cq_entries * sizeof(::io_uring_cqe);
+    const bool single_mmap = params_.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) sq_size = cq_size = std::max(sq_size, cq_size);
+    TENSORSTORE_RETURN_IF_ERROR(
+        sq_mapping_.Map(ring_fd_, sq_size, IORING_OFF_SQ_RING));
+    const RingMapping* cq_mapping = &sq_mapping_;
+    if (!single_mmap) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          cq_mapping_.Map(ring_fd_, cq_size, IORING_OFF_CQ_RING));
+      cq_mapping = &cq_mapping_;
+    }
+    TENSORSTORE_RETURN_IF_ERROR(
+        sqe_mapping_.Map(ring_fd_, params_.sq_entries * sizeof(::io_uring_sqe),
+                         IORING_OFF_SQES));
+    sq_head_ = sq_mapping_.At<uint32_t>(params_.sq_off.head);
+    sq_tail_ = sq_mapping_.At<uint32_t>(params_.sq_off.tail);
+    sq_mask_ = *sq_mapping_.At<uint32_t>(params_.sq_off.ring_mask);
+    sq_array_ = sq_mapping_.At<uint32_t>(params_.sq_off.array);
+    sqes_ = sqe_mapping_.At<::io_uring_sqe>(0);
+    cq_head_ = cq_mapping->At<uint32_t>(params_.cq_off.head);
+    cq_tail_ = cq_mapping->At<uint32_t>(params_.cq_off.tail);
+    cq_mask_ = *cq_mapping->At<uint32_t>(params_.cq_off.ring_mask);
+    cqes_ = cq_mapping->At<::io_uring_cqe>(params_.cq_off.cqes);
+    return absl::OkStatus();
+  }
+
+  /// Adds `op` to the submission queue, or to `overflow_` if the maximum
+  /// number of requests are already in flight.
+  void QueueLocked(Operation* op) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (in_flight_ == max_in_flight_) {
+      overflow_.push_back(op);
+      return;
+    }
+    ++in_flight_;
+    // Only this engine (with `mutex_` held) writes the submission queue tail.
+    const uint32_t tail = *sq_tail_;
+    const uint32_t index = tail & sq_mask_;
+    ::io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    if (op->callback) {
+      // `IORING_OP_READV` is used rather than `IORING_OP_READ` since it is
+      // supported by all kernels that support io_uring (5.1+).
+      sqe->opcode = IORING_OP_READV;
+      sqe->fd = op->fd;
+      sqe->off = static_cast<uint64_t>(op->offset);
+      sqe->addr = reinterpret_cast<uint64_t>(&op->iov);
+      sqe->len = 1;
+    } else {
+      sqe->opcode = IORING_OP_NOP;
+    }
+    sqe->user_data = reinterpret_cast<uint64_t>(op);
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  /// Submits all queued submission queue entries to the kernel.
+  void SubmitLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    while (true) {
+      const uint32_t pending =
+          *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+      if (pending == 0) return;
+      int ret = IoUringEnter(ring_fd_, pending, 0, 0);
+      if (ret >= 0) continue;
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EBUSY) {
+        // Transient resource shortage in the kernel; the completion thread
+        // does not require `mutex_` to make progress, so simply retry.
+        absl::SleepFor(absl::Microseconds(50));
+        continue;
+      }
+      ABSL_LOG(FATAL) << StatusFromOsError(errno, "io_uring_enter failed");
+    }
+  }
+
+  void CompletionLoop() {
+    std::vector<std::pair<Operation*, int32_t>> completed;
+    bool done = false;
+    while (!done) {
+      uint32_t head = *cq_head_;
+      const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      if (head == tail) {
+        int ret = IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+          ABSL_LOG(FATAL) << StatusFromOsError(errno, "io_uring_enter failed");
+        }
+        continue;
+      }
+      for (; head != tail; ++head) {
+        const ::io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        completed.emplace_back(reinterpret_cast<Operation*>(cqe.user_data),
+                               cqe.res);
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      {
+        absl::MutexLock lock(&mutex_);
+        in_flight_ -= completed.size();
+        while (!overflow_.empty() && in_flight_ < max_in_flight_) {
+          QueueLocked(overflow_.front());
+          overflow_.pop_front();
+        }
+        SubmitLocked();
+      }
+      for (auto& [op, res] : completed) {
+        std::unique_ptr<Operation> op_ptr(op);
+        if (!op->callback) {
+          done = true;
+          continue;
+        }
+        if (res >= 0) {
+          std::move(op->callback)(static_cast<ptrdiff_t>(res));
+        } else {
+          std::move(op->callback)(
+              StatusFromOsError(-res, "Failed to read from file"));
+        }
+      }
+      completed.clear();
+    }
+  }
+
+  int ring_fd_;
+  ::io_uring_params params_;
+  const uint32_t max_in_flight_;
+
+  RingMapping sq_mapping_;
+  RingMapping cq_mapping_;
+  RingMapping sqe_mapping_;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t* sq_array_ = nullptr;
+  ::io_uring_sqe* sqes_ = nullptr;
+
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  ::io_uring_cqe* cqes_ = nullptr;
+
+  absl::Mutex mutex_;
+  uint32_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::deque<Operation*> overflow_ ABSL_GUARDED_BY(mutex_);
+
+  internal::Thread completion_thread_;
+};
+
+}  // namespace
+
+bool IoUringEngine::IsSupported() { return true; }
+
+Result<std::unique_ptr<IoUringEngine>> IoUringEngine::Create(
+    unsigned queue_depth) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto engine,
+                               LinuxIoUringEngine::Create(queue_depth));
+  return std::unique_ptr<IoUringEngine>(std::move(engine));
+}
+
+IoUringEngine* IoUringEngine::GetShared() {
+  static IoUringEngine* engine = [] {
+    auto result = Create(/*queue_depth=*/256);
+    if (!result.ok()) {
+      ABSL_LOG(INFO) << "io_uring unavailable, using blocking file I/O: "
+                     << result.status();
+      return static_cast<IoUringEngine*>(nullptr);
+    }
+    return result->release();
+  }();
+  return engine;
+}
+
+#else  // !TENSORSTORE_INTERNAL_HAVE_IO_URING
+
+bool IoUringEngine::IsSupported() { return false; }
+
+Result<std::unique_ptr<IoUringEngine>> IoUringEngine::Create(
+    unsigned queue_depth) {
+  return absl::UnimplementedError("io_uring is not supported on this platform");
+}
+
+IoUringEngine* IoUringEngine::GetShared() { return nullptr; }
+
+#endif  // TENSORSTORE_INTERNAL_HAVE_IO_URING
+
+}  // namespace internal_os
+}  // namespace tensorstore
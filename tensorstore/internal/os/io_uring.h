@@ -0,0 +1,86 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_OS_IO_URING_H_
+#define TENSORSTORE_INTERNAL_OS_IO_URING_H_
+
+/// \file Asynchronous file reads using the Linux io_uring interface.
+///
+/// The engine is accessed directly through the `io_uring_setup` and
+/// `io_uring_enter` system calls, and therefore does not depend on liburing.
+/// On platforms other than Linux, or if the running kernel does not permit
+/// io_uring (e.g. due to a seccomp filter), `IoUringEngine::GetShared()`
+/// returns `nullptr` and callers are expected to fall back to blocking I/O.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "absl/functional/any_invocable.h"
+#include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_os {
+
+/// Submits file reads to an io_uring instance and completes them from a single
+/// dedicated completion thread.
+///
+/// Reads are submitted directly by the calling thread.  If the submission
+/// queue is full, the request is queued and submitted by the completion thread
+/// once earlier requests complete, so `Read` never blocks waiting for space.
+class IoUringEngine {
+ public:
+  /// Callback invoked with the number of bytes read (`0` indicates end of
+  /// file), or an error.
+  ///
+  /// Callbacks are invoked on the completion thread and should not block; they
+  /// may, however, call `Read` to submit additional requests.
+  using ReadCallback = absl::AnyInvocable<void(Result<ptrdiff_t>) &&>;
+
+  /// Returns `true` if io_uring is potentially available on this platform.
+  static bool IsSupported();
+
+  /// Creates a new engine with a submission queue of (at least)
+  /// `queue_depth` entries.
+  ///
+  /// \error `absl::StatusCode::kUnimplemented` if io_uring is not supported on
+  ///     this platform.
+  /// \error Other error codes if the kernel rejects `io_uring_setup`.
+  static Result<std::unique_ptr<IoUringEngine>> Create(unsigned queue_depth);
+
+  /// Returns a lazily-created process-wide engine, or `nullptr` if io_uring is
+  /// not available.
+  static IoUringEngine* GetShared();
+
+  /// Destroys the engine and joins the completion thread.
+  ///
+  /// No requests may be outstanding.
+  virtual ~IoUringEngine();
+
+  /// Asynchronously reads up to `count` bytes at `offset` from `fd` into
+  /// `buf`.
+  ///
+  /// As with `ReadFromFile`, the read may return fewer than `count` bytes.  The
+  /// caller must ensure that `fd` and `buf` remain valid until `callback` is
+  /// invoked.
+  virtual void Read(FileDescriptor fd, void* buf, size_t count, int64_t offset,
+                    ReadCallback callback) = 0;
+};
+
+}  // namespace internal_os
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_OS_IO_URING_H_
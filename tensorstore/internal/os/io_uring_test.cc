@@ -0,0 +1,143 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/io_uring.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
+#include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::Result;
+using ::tensorstore::StatusIs;
+using ::tensorstore::internal_os::FileDescriptorTraits;
+using ::tensorstore::internal_os::IoUringEngine;
+using ::tensorstore::internal_os::OpenExistingFileForReading;
+using ::tensorstore::internal_os::OpenFileForWriting;
+using ::tensorstore::internal_os::WriteCordToFile;
+
+std::string WriteTestFile(const std::string& path, size_t size) {
+  std::string contents(size, '\0');
+  for (size_t i = 0; i < size; ++i) contents[i] = static_cast<char>(i % 251);
+  auto f = OpenFileForWriting(path);
+  EXPECT_TRUE(f.ok());
+  EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord(contents)),
+              IsOkAndHolds(size));
+  return contents;
+}
+
+TEST(IoUringEngineTest, Unsupported) {
+  if (IoUringEngine::IsSupported()) {
+    GTEST_SKIP() << "io_uring is supported on this platform";
+  }
+  EXPECT_THAT(IoUringEngine::Create(8),
+              StatusIs(absl::StatusCode::kUnimplemented));
+  EXPECT_EQ(nullptr, IoUringEngine::GetShared());
+}
+
+TEST(IoUringEngineTest, Read) {
+  auto engine = IoUringEngine::Create(8);
+  if (!engine.ok()) GTEST_SKIP() << engine.status();
+
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string path = tempdir.path() + "/data";
+  std::string contents = WriteTestFile(path, 4096);
+  auto fd = OpenExistingFileForReading(path);
+  ASSERT_TRUE(fd.ok());
+
+  char buf[100];
+  absl::Notification done;
+  Result<ptrdiff_t> result;
+  (*engine)->Read(fd->get(), buf, sizeof(buf), 1000,
+                  [&](Result<ptrdiff_t> r) {
+                    result = std::move(r);
+                    done.Notify();
+                  });
+  done.WaitForNotification();
+  EXPECT_THAT(result, IsOkAndHolds(sizeof(buf)));
+  EXPECT_EQ(contents.substr(1000, sizeof(buf)),
+            std::string(buf, sizeof(buf)));
+
+  // Reading past the end of the file returns 0.
+  absl::Notification eof_done;
+  (*engine)->Read(fd->get(), buf, sizeof(buf), 5000,
+                  [&](Result<ptrdiff_t> r) {
+                    result = std::move(r);
+                    eof_done.Notify();
+                  });
+  eof_done.WaitForNotification();
+  EXPECT_THAT(result, IsOkAndHolds(0));
+}
+
+// Tests that more requests than the queue depth may be submitted at once.
+TEST(IoUringEngineTest, MoreRequestsThanQueueDepth) {
+  auto engine = IoUringEngine::Create(2);
+  if (!engine.ok()) GTEST_SKIP() << engine.status();
+
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string path = tempdir.path() + "/data";
+  constexpr size_t kNumRequests = 64;
+  constexpr size_t kRequestSize = 16;
+  std::string contents = WriteTestFile(path, kNumRequests * kRequestSize);
+  auto fd = OpenExistingFileForReading(path);
+  ASSERT_TRUE(fd.ok());
+
+  std::vector<char> buf(kNumRequests * kRequestSize);
+  std::vector<Result<ptrdiff_t>> results(kNumRequests);
+  absl::BlockingCounter counter(kNumRequests);
+  for (size_t i = 0; i < kNumRequests; ++i) {
+    (*engine)->Read(fd->get(), buf.data() + i * kRequestSize, kRequestSize,
+                    i * kRequestSize, [&, i](Result<ptrdiff_t> r) {
+                      results[i] = std::move(r);
+                      counter.DecrementCount();
+                    });
+  }
+  counter.Wait();
+  for (size_t i = 0; i < kNumRequests; ++i) {
+    EXPECT_THAT(results[i], IsOkAndHolds(kRequestSize)) << i;
+  }
+  EXPECT_EQ(contents, std::string(buf.data(), buf.size()));
+}
+
+TEST(IoUringEngineTest, InvalidFileDescriptor) {
+  auto engine = IoUringEngine::Create(8);
+  if (!engine.ok()) GTEST_SKIP() << engine.status();
+
+  char buf[16];
+  absl::Notification done;
+  Result<ptrdiff_t> result;
+  (*engine)->Read(FileDescriptorTraits::Invalid(), buf, sizeof(buf), 0,
+                  [&](Result<ptrdiff_t> r) {
+                    result = std::move(r);
+                    done.Notify();
+                  });
+  done.WaitForNotification();
+  EXPECT_FALSE(result.ok());
+}
+
+}  // namespace
@@ -16,9 +16,11 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/container/intrusive_linked_list.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
@@ -27,7 +29,16 @@ namespace tensorstore {
 namespace internal {
 
 AdmissionQueue::AdmissionQueue(size_t limit)
-    : limit_(limit == 0 ? std::numeric_limits<size_t>::max() : limit) {}
+    : adaptive_(false),
+      min_limit_(limit == 0 ? std::numeric_limits<size_t>::max() : limit),
+      max_limit_(min_limit_),
+      limit_(max_limit_) {}
+
+AdmissionQueue::AdmissionQueue(size_t min_limit, size_t max_limit)
+    : adaptive_(true),
+      min_limit_(std::max<size_t>(1, min_limit)),
+      max_limit_(std::max(min_limit_, max_limit)),
+      limit_(max_limit_) {}
 
 void AdmissionQueue::Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
   assert(node->next_ == nullptr);
@@ -37,9 +48,10 @@ void AdmissionQueue::Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
 
   {
     absl::MutexLock lock(&mutex_);
-    if (in_flight_++ >= limit_) {
+    if (in_flight_++ - queued_ >= limit_) {
       internal::intrusive_linked_list::InsertBefore(RateLimiterNodeAccessor{},
                                                     &head_, node);
+      ++queued_;
       return;
     }
   }
@@ -50,18 +62,53 @@ void AdmissionQueue::Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
 void AdmissionQueue::Finish(RateLimiterNode* node) {
   assert(node->next_ == nullptr);
 
-  RateLimiterNode* next_node = nullptr;
+  absl::InlinedVector<RateLimiterNode*, 1> next_nodes;
   {
     absl::MutexLock lock(&mutex_);
     in_flight_--;
-    next_node = head_.next_;
-    if (next_node == &head_) return;
-    internal::intrusive_linked_list::Remove(RateLimiterNodeAccessor{},
-                                            next_node);
+    if (adaptive_ && ++window_finished_ >= limit_) {
+      // Additive increase, but only while the limit is constraining.
+      if (!window_overloaded_ && queued_ > 0 && limit_ < max_limit_) {
+        ++limit_;
+      }
+      window_finished_ = 0;
+      window_overloaded_ = false;
+    }
+    while (queued_ > 0 && in_flight_ - queued_ < limit_) {
+      RateLimiterNode* next_node = head_.next_;
+      internal::intrusive_linked_list::Remove(RateLimiterNodeAccessor{},
+                                              next_node);
+      // Mark as no longer queued, so that it may not be cancelled.
+      next_node->next_ = nullptr;
+      --queued_;
+      next_nodes.push_back(next_node);
+    }
+  }
+
+  // Next nodes get a chance to run after clearing admission queue state.
+  for (auto* next_node : next_nodes) {
+    RunStartFunction(next_node);
   }
+}
+
+bool AdmissionQueue::Cancel(RateLimiterNode* node) {
+  absl::MutexLock lock(&mutex_);
+  if (!CancelLocked(node)) return false;
+  // A queued node does not occupy a slot, so no other node may be started.
+  --queued_;
+  --in_flight_;
+  return true;
+}
 
-  // Next node gets a chance to run after clearing admission queue state.
-  RunStartFunction(next_node);
+void AdmissionQueue::ReportOverload() {
+  if (!adaptive_) return;
+  absl::MutexLock lock(&mutex_);
+  // Decrease at most once per window, since operations which were already in
+  // flight are likely to observe the same overload.
+  if (window_overloaded_) return;
+  window_overloaded_ = true;
+  window_finished_ = 0;
+  limit_ = std::max(min_limit_, limit_ / 2);
 }
 
 }  // namespace internal
@@ -34,17 +34,33 @@ namespace internal {
 /// be called when an operation starts, and `Finish` must be called when an
 /// operation completes. Operations are enqueued if limit is reached, to be
 /// started once the number of parallel operations are below limit.
+///
+/// An adaptive AdmissionQueue adjusts the limit using additive-increase /
+/// multiplicative-decrease (AIMD) control: callers report server overload
+/// (e.g. HTTP 429 or 503 responses) via `ReportOverload`, which halves the
+/// limit at most once per window of `limit` completed operations, and the
+/// limit increases by one for each window of `limit` operations that complete
+/// without overload while the queue is saturated.
 class AdmissionQueue : public RateLimiter {
  public:
   /// Construct an AdmissionQueue with `limit` parallelism.
   AdmissionQueue(size_t limit);
+
+  /// Construct an adaptive AdmissionQueue with an initial limit of
+  /// `max_limit`, which is adjusted within `[min_limit, max_limit]`.
+  AdmissionQueue(size_t min_limit, size_t max_limit);
+
   ~AdmissionQueue() override = default;
 
-  size_t limit() const { return limit_; }
+  size_t limit() const {
+    absl::MutexLock l(&mutex_);
+    return limit_;
+  }
   size_t in_flight() const {
     absl::MutexLock l(&mutex_);
     return in_flight_;
   }
+  bool adaptive() const { return adaptive_; }
 
   /// Admit a task node to the queue. Admit ensures that at most `limit`
   /// operations are running concurrently.  When the node is admitted the start
@@ -56,9 +72,26 @@ class AdmissionQueue : public RateLimiter {
   /// queued node will have it's start function invoked.
   void Finish(RateLimiterNode* node) override;
 
+  /// Removes a queued task node without starting it.
+  bool Cancel(RateLimiterNode* node) override;
+
+  /// Reports that an operation was rejected due to server overload.  Has no
+  /// effect unless the queue is adaptive.
+  void ReportOverload();
+
  private:
-  const size_t limit_;
+  const bool adaptive_;
+  const size_t min_limit_;
+  const size_t max_limit_;
+  size_t limit_ ABSL_GUARDED_BY(mutex_);
+  // Number of operations which have been admitted but not finished, including
+  // those which are queued.
   size_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t queued_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of operations finished in the current AIMD window.
+  size_t window_finished_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Whether overload was reported during the current AIMD window.
+  bool window_overloaded_ ABSL_GUARDED_BY(mutex_) = false;
 };
 
 }  // namespace internal
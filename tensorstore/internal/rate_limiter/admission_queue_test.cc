@@ -18,6 +18,7 @@
 
 #include <atomic>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "tensorstore/internal/intrusive_ptr.h"
@@ -69,4 +70,86 @@ TEST(AdmissionQueueTest, Basic) {
   EXPECT_EQ(100, done);
 }
 
+TEST(AdmissionQueueTest, Adaptive) {
+  AdmissionQueue queue(1, 4);
+  std::atomic<size_t> started{0};
+  auto admit = [&] {
+    auto node = MakeIntrusivePtr<Node>(&queue, [&started] { started++; });
+    intrusive_ptr_increment(node.get());  // adopted by Node::Start.
+    queue.Admit(node.get(), &Node::Start);
+    return node;
+  };
+
+  EXPECT_TRUE(queue.adaptive());
+  EXPECT_EQ(4, queue.limit());
+
+  // Overload halves the limit at most once per window.
+  queue.ReportOverload();
+  EXPECT_EQ(2, queue.limit());
+  queue.ReportOverload();
+  EXPECT_EQ(2, queue.limit());
+
+  // Completing a window without saturation does not increase the limit.
+  admit();
+  admit();
+  EXPECT_EQ(2, started);
+  EXPECT_EQ(2, queue.limit());
+
+  // A window completed while operations are queued increases the limit.
+  std::vector<IntrusivePtr<Node>> nodes;
+  for (int i = 0; i < 3; ++i) nodes.push_back(admit());
+  EXPECT_EQ(4, started);
+  nodes[0].reset();
+  EXPECT_EQ(5, started);
+  for (int i = 0; i < 2; ++i) nodes.push_back(admit());
+  EXPECT_EQ(5, started);
+  nodes[1].reset();
+  EXPECT_EQ(3, queue.limit());
+  EXPECT_EQ(7, started);
+  nodes.clear();
+  EXPECT_EQ(0, queue.in_flight());
+
+  // The limit does not decrease below the minimum.
+  queue.ReportOverload();
+  admit();
+  admit();
+  admit();
+  queue.ReportOverload();
+  EXPECT_EQ(1, queue.limit());
+}
+
+TEST(AdmissionQueueTest, FixedIgnoresOverload) {
+  AdmissionQueue queue(4);
+  EXPECT_FALSE(queue.adaptive());
+  queue.ReportOverload();
+  EXPECT_EQ(4, queue.limit());
+}
+
+TEST(AdmissionQueueTest, Cancel) {
+  AdmissionQueue queue(1);
+  static std::vector<void*> started;
+  started.clear();
+  auto start = +[](void* node) { started.push_back(node); };
+
+  RateLimiterNode a, b, c;
+  queue.Admit(&a, start);
+  queue.Admit(&b, start);
+  queue.Admit(&c, start);
+  EXPECT_EQ(std::vector<void*>{&a}, started);
+  EXPECT_EQ(3, queue.in_flight());
+
+  // A started node may not be cancelled.
+  EXPECT_FALSE(queue.Cancel(&a));
+
+  // A queued node is removed without being started.
+  EXPECT_TRUE(queue.Cancel(&b));
+  EXPECT_FALSE(queue.Cancel(&b));
+  EXPECT_EQ(2, queue.in_flight());
+
+  queue.Finish(&a);
+  EXPECT_EQ((std::vector<void*>{&a, &c}), started);
+  queue.Finish(&c);
+  EXPECT_EQ(0, queue.in_flight());
+}
+
 }  // namespace
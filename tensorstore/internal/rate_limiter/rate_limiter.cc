@@ -43,6 +43,24 @@ void RateLimiter::RunStartFunction(RateLimiterNode* node) {
   fn(node);
 }
 
+bool RateLimiter::Cancel(RateLimiterNode* node) {
+  absl::MutexLock l(&mutex_);
+  return CancelLocked(node);
+}
+
+bool RateLimiter::CancelLocked(RateLimiterNode* node) {
+  if (node->next_ == nullptr) return false;
+  internal::intrusive_linked_list::Remove(RateLimiterNodeAccessor{}, node);
+  node->next_ = nullptr;
+  node->prev_ = nullptr;
+  node->start_fn_ = nullptr;
+  return true;
+}
+
+void RateLimiter::Reconcile(RateLimiterNode* node, size_t bytes) {
+  node->bytes_ = bytes;
+}
+
 void NoRateLimiter::Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
   assert(node->next_ == nullptr);
   assert(node->prev_ == nullptr);
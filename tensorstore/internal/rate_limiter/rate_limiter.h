@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_INTERNAL_RATE_LIMITER_RATE_LIMITER_H_
 #define TENSORSTORE_INTERNAL_RATE_LIMITER_RATE_LIMITER_H_
 
+#include <stddef.h>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/container/intrusive_linked_list.h"
@@ -30,12 +32,20 @@ namespace internal {
 // the RateLimiterNode nor the RateLimiter class manage any reference counts.
 // Callers should manage reference counts externally.
 //
+// A node is linked into `RateLimiter::head_` (and `next_` is non-null) only
+// while it is queued; implementations unlink nodes under the lock before
+// invoking their start function.
 struct RateLimiterNode {
   using StartFn = void (*)(void*);
 
   RateLimiterNode* next_ = nullptr;
   RateLimiterNode* prev_ = nullptr;
   StartFn start_fn_ = nullptr;
+
+  // Expected number of bytes transferred by the operation, which is the cost
+  // of the node for rate limiters which count bytes rather than requests.
+  // Must be set before `RateLimiter::Admit`.
+  size_t bytes_ = 0;
 };
 
 using RateLimiterNodeAccessor = internal::intrusive_linked_list::MemberAccessor<
@@ -54,7 +64,27 @@ class RateLimiter {
   /// Cleanup a task from the rate limiter.
   virtual void Finish(RateLimiterNode* node) = 0;
 
+  /// Removes a task which has been admitted but not yet started, such as when
+  /// the result of the operation is no longer needed.
+  ///
+  /// Returns `true` if the task was removed, in which case its start function
+  /// is never invoked and `Finish` must not be called.  Returns `false` if the
+  /// start function has already been (or is being) invoked.
+  virtual bool Cancel(RateLimiterNode* node);
+
+  /// Records that the operation for a started `node` actually transferred
+  /// `bytes`, in place of the estimate `node->bytes_` with which it was
+  /// admitted, such as when the size of a response is not known in advance.
+  ///
+  /// Rate limiters which count bytes charge the difference against the nodes
+  /// admitted subsequently.
+  virtual void Reconcile(RateLimiterNode* node, size_t bytes);
+
  protected:
+  /// Unlinks `node` from the queue if it is queued.
+  bool CancelLocked(RateLimiterNode* node)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   static void RunStartFunction(RateLimiterNode* node);
 
   mutable absl::Mutex mutex_;
@@ -40,7 +40,9 @@ double GetLogA(absl::Duration doubling_time) {
          absl::ToDoubleSeconds(doubling_time);
 }
 
-double GetMaxAvailable(double initial_rate) {
+double GetMaxAvailable(double initial_rate, RateLimiterUnit unit) {
+  // Allow bursts of up to one second of bandwidth.
+  if (unit == RateLimiterUnit::kBytes) return initial_rate;
   // NOTE: Figure out a reasonable count for maximum buffered tokens.
   return std::min(initial_rate * 1000.0, 2000.0);
 }
@@ -48,8 +50,9 @@ double GetMaxAvailable(double initial_rate) {
 }  // namespace
 
 DoublingRateLimiter::DoublingRateLimiter(double initial_rate,
-                                         absl::Duration doubling_time)
-    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate)),
+                                         absl::Duration doubling_time,
+                                         RateLimiterUnit unit)
+    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate, unit), unit),
       initial_rate_(initial_rate),
       doubling_time_(doubling_time),
       a_(GetLogA(doubling_time)) {
@@ -59,8 +62,10 @@ DoublingRateLimiter::DoublingRateLimiter(double initial_rate,
 
 DoublingRateLimiter::DoublingRateLimiter(double initial_rate,
                                          absl::Duration doubling_time,
-                                         std::function<absl::Time()> clock)
-    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate), std::move(clock)),
+                                         std::function<absl::Time()> clock,
+                                         RateLimiterUnit unit)
+    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate, unit),
+                             std::move(clock), unit),
       initial_rate_(initial_rate),
       doubling_time_(doubling_time),
       a_(GetLogA(doubling_time)) {
@@ -84,16 +89,19 @@ absl::Duration DoublingRateLimiter::GetSchedulerDelay() const {
   return absl::Milliseconds(10);
 }
 
-ConstantRateLimiter::ConstantRateLimiter(double initial_rate)
-    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate)),
+ConstantRateLimiter::ConstantRateLimiter(double initial_rate,
+                                         RateLimiterUnit unit)
+    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate, unit), unit),
       initial_rate_(initial_rate),
       r_(absl::Seconds(1.0 / initial_rate)) {
   ABSL_CHECK_GT(initial_rate, std::numeric_limits<double>::min());
 }
 
 ConstantRateLimiter::ConstantRateLimiter(double initial_rate,
-                                         std::function<absl::Time()> clock)
-    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate), std::move(clock)),
+                                         std::function<absl::Time()> clock,
+                                         RateLimiterUnit unit)
+    : TokenBucketRateLimiter(GetMaxAvailable(initial_rate, unit),
+                             std::move(clock), unit),
       initial_rate_(initial_rate),
       r_(absl::Seconds(1.0 / initial_rate)) {
   ABSL_CHECK_GT(initial_rate, std::numeric_limits<double>::min());
@@ -32,14 +32,19 @@ namespace internal {
 /// The DoublingRateLimiter accepts an initial_rate and a doubling_time. The
 /// doubling time is computed over the life of the DoublingRateLimiter, and so
 /// is best used for short-duration processes.
+///
+/// With `RateLimiterUnit::kBytes`, the rates are in bytes per second, which
+/// shapes bandwidth rather than request rate.
 class DoublingRateLimiter : public TokenBucketRateLimiter {
  public:
   /// Constructs a DoublingRateLimiter
-  DoublingRateLimiter(double initial_rate, absl::Duration doubling_time);
+  DoublingRateLimiter(double initial_rate, absl::Duration doubling_time,
+                      RateLimiterUnit unit = RateLimiterUnit::kRequests);
 
   // Test constructor.
   DoublingRateLimiter(double initial_rate, absl::Duration doubling_time,
-                      std::function<absl::Time()> clock);
+                      std::function<absl::Time()> clock,
+                      RateLimiterUnit unit = RateLimiterUnit::kRequests);
 
   ~DoublingRateLimiter() override = default;
 
@@ -63,10 +68,12 @@ class DoublingRateLimiter : public TokenBucketRateLimiter {
 class ConstantRateLimiter : public TokenBucketRateLimiter {
  public:
   /// Constructs a DoublingRateLimiter
-  explicit ConstantRateLimiter(double initial_rate);
+  explicit ConstantRateLimiter(
+      double initial_rate, RateLimiterUnit unit = RateLimiterUnit::kRequests);
 
   // Test constructor.
-  ConstantRateLimiter(double initial_rate, std::function<absl::Time()> clock);
+  ConstantRateLimiter(double initial_rate, std::function<absl::Time()> clock,
+                      RateLimiterUnit unit = RateLimiterUnit::kRequests);
 
   ~ConstantRateLimiter() override = default;
 
@@ -39,6 +39,7 @@ using ::tensorstore::internal::IntrusivePtr;
 using ::tensorstore::internal::MakeIntrusivePtr;
 using ::tensorstore::internal::RateLimiter;
 using ::tensorstore::internal::RateLimiterNode;
+using ::tensorstore::internal::RateLimiterUnit;
 
 struct Node : public RateLimiterNode, public AtomicReferenceCount<Node> {
   RateLimiter* queue_;
@@ -94,6 +95,70 @@ TEST(ConstantRateLimiter, Basic) {
   EXPECT_EQ(100, done);
 }
 
+TEST(ConstantRateLimiter, Bytes) {
+  absl::Time now = absl::Now();
+  ConstantRateLimiter queue(
+      100, [&now]() { return now; }, RateLimiterUnit::kBytes);
+
+  EXPECT_EQ(RateLimiterUnit::kBytes, queue.unit());
+  EXPECT_EQ(1, queue.Cost(0));
+  EXPECT_EQ(50, queue.Cost(50));
+
+  std::atomic<size_t> done{0};
+  for (size_t bytes : {50, 50, 250, 10}) {
+    auto node = MakeIntrusivePtr<Node>(&queue, [&done] {  //
+      done++;
+    });
+    node->bytes_ = bytes;
+
+    intrusive_ptr_increment(node.get());  // adopted by Node::Start.
+    queue.Admit(node.get(), &Node::Start);
+  }
+  EXPECT_EQ(0, done);
+
+  now += absl::Seconds(1);
+  queue.PeriodicCallForTesting();
+  EXPECT_EQ(2, done);
+
+  // The 250 byte node exceeds the bucket size, so it starts once the bucket
+  // is full and leaves a deficit.
+  now += absl::Seconds(1);
+  queue.PeriodicCallForTesting();
+  EXPECT_EQ(3, done);
+  EXPECT_EQ(-150, queue.available());
+
+  now += absl::Seconds(1.5);
+  queue.PeriodicCallForTesting();
+  EXPECT_EQ(3, done);
+
+  now += absl::Seconds(0.5);
+  queue.PeriodicCallForTesting();
+  EXPECT_EQ(4, done);
+}
+
+TEST(ConstantRateLimiter, Reconcile) {
+  absl::Time now = absl::Now();
+  ConstantRateLimiter queue(
+      100, [&now]() { return now; }, RateLimiterUnit::kBytes);
+
+  now += absl::Seconds(1);
+  queue.PeriodicCallForTesting();
+  EXPECT_EQ(100, queue.available());
+
+  // The size of the node is not known until it completes.
+  auto node = MakeIntrusivePtr<Node>(&queue, [] {});
+  intrusive_ptr_increment(node.get());  // adopted by Node::Start.
+  queue.Admit(node.get(), &Node::Start);
+  EXPECT_EQ(99, queue.available());
+
+  queue.Reconcile(node.get(), 80);
+  EXPECT_EQ(80, node->bytes_);
+  EXPECT_EQ(20, queue.available());
+
+  queue.Reconcile(node.get(), 30);
+  EXPECT_EQ(70, queue.available());
+}
+
 TEST(DoublingRateLimiter, Basic) {
   absl::Time now = absl::Now();
 
@@ -14,12 +14,16 @@
 
 #include "tensorstore/internal/rate_limiter/token_bucket_rate_limiter.h"
 
+#include <stddef.h>
+
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <utility>
 
 #include "absl/base/attributes.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/log/absl_log.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
@@ -39,17 +43,20 @@ ABSL_CONST_INIT internal_log::VerboseFlag rate_limiter_logging("rate_limiter");
 
 }  // namespace
 
-TokenBucketRateLimiter::TokenBucketRateLimiter(double max_tokens)
+TokenBucketRateLimiter::TokenBucketRateLimiter(double max_tokens,
+                                               RateLimiterUnit unit)
     : clock_(absl::Now),
       max_tokens_(max_tokens),
+      unit_(unit),
       start_time_(clock_()),
       last_update_(start_time_),
       allow_schedule_at_(true) {}
 
 TokenBucketRateLimiter::TokenBucketRateLimiter(
-    double max_tokens, std::function<absl::Time()> clock)
+    double max_tokens, std::function<absl::Time()> clock, RateLimiterUnit unit)
     : clock_(std::move(clock)),
       max_tokens_(max_tokens),
+      unit_(unit),
       start_time_(clock_()),
       last_update_(start_time_),
       allow_schedule_at_(false) {}
@@ -83,6 +90,29 @@ void TokenBucketRateLimiter::Finish(RateLimiterNode* node) {
   assert(node->prev_ == nullptr);
 }
 
+void TokenBucketRateLimiter::Reconcile(RateLimiterNode* node, size_t bytes) {
+  assert(node->next_ == nullptr);
+  if (unit_ != RateLimiterUnit::kBytes) {
+    node->bytes_ = bytes;
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  const double delta = Cost(bytes) - Cost(node->bytes_);
+  node->bytes_ = bytes;
+  available_ = std::min(available_ - delta, max_tokens_);
+  ABSL_LOG_IF(INFO, rate_limiter_logging.Level(1))
+      << "Reconcile " << delta << " => " << available_;
+  if (delta < 0) {
+    // Overestimated; the refund may allow queued nodes to start.
+    PerformWorkLocked();
+  }
+}
+
+double TokenBucketRateLimiter::Cost(size_t bytes) const {
+  if (unit_ == RateLimiterUnit::kRequests) return 1.0;
+  return std::max(1.0, static_cast<double>(bytes));
+}
+
 absl::Duration TokenBucketRateLimiter::GetSchedulerDelay() const {
   return absl::Milliseconds(10);
 }
@@ -99,9 +129,7 @@ void TokenBucketRateLimiter::PerformWork() {
 }
 
 void TokenBucketRateLimiter::PerformWorkLocked() {
-  RateLimiterNode local;
-  internal::intrusive_linked_list::Initialize(RateLimiterNodeAccessor{},
-                                              &local);
+  absl::InlinedVector<RateLimiterNode*, 8> to_start;
 
   // Attempt to fill the available_ tokens based on the timestamp.
   auto now = clock_();
@@ -119,14 +147,16 @@ void TokenBucketRateLimiter::PerformWorkLocked() {
   }
 
   // Start all nodes which can be started.
-  int count = 0;
   RateLimiterNodeAccessor accessor;
-  while (available_ >= 1.0 && !OnlyContainsNode(accessor, &head_)) {
-    available_ -= 1.0;
+  while (!OnlyContainsNode(accessor, &head_)) {
     auto* n = accessor.GetNext(&head_);
+    const double cost = Cost(n->bytes_);
+    if (available_ < std::min(cost, max_tokens_)) break;
+    available_ -= cost;
     internal::intrusive_linked_list::Remove(accessor, n);
-    internal::intrusive_linked_list::InsertBefore(accessor, &local, n);
-    count++;
+    // Mark as no longer queued, so that it may not be cancelled.
+    n->next_ = nullptr;
+    to_start.push_back(n);
   }
 
   // Maybe enqueue on scheduler.
@@ -146,16 +176,15 @@ void TokenBucketRateLimiter::PerformWorkLocked() {
     }
   }
 
-  if (count == 0) {
+  if (to_start.empty()) {
     return;
   }
 
   // Run all nodes without locks.
   mutex_.Unlock();
-  ABSL_LOG_IF(INFO, rate_limiter_logging.Level(1)) << "Starting " << count;
-  for (int i = 0; i < count; ++i) {
-    auto* n = accessor.GetNext(&local);
-    internal::intrusive_linked_list::Remove(accessor, n);
+  ABSL_LOG_IF(INFO, rate_limiter_logging.Level(1))
+      << "Starting " << to_start.size();
+  for (auto* n : to_start) {
     RunStartFunction(n);
   }
   mutex_.Lock();
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_INTERNAL_RATE_LIMITER_TOKEN_BUCKET_RATE_LIMITER_H_
 #define TENSORSTORE_INTERNAL_RATE_LIMITER_TOKEN_BUCKET_RATE_LIMITER_H_
 
+#include <stddef.h>
+
 #include <functional>
 
 #include "absl/base/thread_annotations.h"
@@ -25,19 +27,32 @@
 namespace tensorstore {
 namespace internal {
 
+/// Specifies what the tokens of a `TokenBucketRateLimiter` count.
+enum class RateLimiterUnit {
+  /// Each node costs 1.0, so that rates are in requests per second.
+  kRequests,
+
+  /// Each node costs `RateLimiterNode::bytes_` (but at least 1.0), so that
+  /// rates are in bytes per second.
+  kBytes,
+};
+
 /// TokenBucketRateLimiter is a base class for implementing Leaky-bucket rate
 /// limiter algorithms.
 class TokenBucketRateLimiter : public RateLimiter {
  public:
-  explicit TokenBucketRateLimiter(double max_tokens);
+  explicit TokenBucketRateLimiter(
+      double max_tokens, RateLimiterUnit unit = RateLimiterUnit::kRequests);
 
   // Test constructor.
-  explicit TokenBucketRateLimiter(double max_tokens,
-                                  std::function<absl::Time()> clock);
+  explicit TokenBucketRateLimiter(
+      double max_tokens, std::function<absl::Time()> clock,
+      RateLimiterUnit unit = RateLimiterUnit::kRequests);
 
   ~TokenBucketRateLimiter() override;
 
   absl::Time start_time() const { return start_time_; }
+  RateLimiterUnit unit() const { return unit_; }
 
   absl::Time last_update() const {
     absl::MutexLock l(&mutex_);
@@ -49,9 +64,18 @@ class TokenBucketRateLimiter : public RateLimiter {
     return available_;
   }
 
-  // Admit one operation; each admitted node costs 1.0.
+  // Admit one operation, which costs `Cost(node->bytes_)`.
+  //
+  // Nodes are started in order.  A node which costs more than `max_tokens`
+  // is started once the bucket is full, leaving a deficit which must be
+  // refilled before the next node starts.
   void Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) final;
   void Finish(RateLimiterNode* node) final;
+  void Reconcile(RateLimiterNode* node, size_t bytes) final;
+
+  // Returns the number of tokens consumed by an operation which transfers
+  // `bytes`.
+  double Cost(size_t bytes) const;
 
   // Returns the number of tokens to add to the rate-limiter for
   // the time between start and end.
@@ -70,10 +94,12 @@ class TokenBucketRateLimiter : public RateLimiter {
   // Intermediate state values.
   std::function<absl::Time()> clock_;
   const double max_tokens_;
+  const RateLimiterUnit unit_;
   const absl::Time start_time_;
   absl::Time last_update_ ABSL_GUARDED_BY(mutex_);
 
-  // Available buckets. Each request subtracts 1.0.
+  // Available tokens. Each request subtracts its cost, which may leave a
+  // negative balance.
   double available_ ABSL_GUARDED_BY(mutex_) = 0;
   bool scheduled_ ABSL_GUARDED_BY(mutex_) = false;
   bool allow_schedule_at_ ABSL_GUARDED_BY(mutex_) = true;
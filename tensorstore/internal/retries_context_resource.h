@@ -17,16 +17,19 @@
 
 #include <stdint.h>
 
-#include <algorithm>
+#include <memory>
 #include <optional>
 
+#include "absl/status/status.h"
 #include "absl/time/time.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/cache_key/absl_time.h"  // IWYU pragma: keep
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/json_binding/absl_time.h"  // IWYU pragma: keep
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/retry.h"
 #include "tensorstore/util/result.h"
 
@@ -34,6 +37,9 @@ namespace tensorstore {
 namespace internal {
 
 /// Specifies parameters for retrying with exponential backoff.
+///
+/// If `retry_budget` is specified, the retries of all requests which share the
+/// resource are additionally limited by a `RetryBudget`.
 template <typename Derived>
 struct RetriesResource : public ContextResourceTraits<Derived> {
   constexpr static bool config_only = true;
@@ -42,22 +48,44 @@ struct RetriesResource : public ContextResourceTraits<Derived> {
     int64_t max_retries = 32;
     absl::Duration initial_delay = absl::Seconds(1);
     absl::Duration max_delay = absl::Seconds(32);
+    // Maximum ratio of retries to requests.
+    std::optional<double> retry_budget;
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.max_retries, x.initial_delay, x.max_delay);
+      return f(x.max_retries, x.initial_delay, x.max_delay, x.retry_budget);
     };
 
     // Retry delay for the attempt, or nullopt when the attempt exceeds the
-    // maximum allowable.
+    // maximum allowable or would not start before `deadline`.
+    //
+    // Delays grow exponentially with decorrelated jitter, so that requests
+    // which fail together are not retried together.
     // https://cloud.google.com/storage/docs/retry-strategy#exponential-backoff
-    std::optional<absl::Duration> BackoffForAttempt(int attempt) {
+    std::optional<absl::Duration> BackoffForAttempt(
+        int attempt, absl::Time deadline = absl::InfiniteFuture()) {
       if (attempt >= max_retries) return std::nullopt;
-      return internal::BackoffForAttempt(
-          attempt, initial_delay, max_delay,
-          /*jitter=*/std::min(absl::Seconds(1), initial_delay));
+      auto delay = internal::DecorrelatedJitterBackoffForAttempt(
+          attempt, initial_delay, max_delay);
+      if (!internal::IsRetryBeforeDeadline(delay, deadline)) {
+        return std::nullopt;
+      }
+      return delay;
     }
   };
 
-  using Resource = Spec;
+  struct Resource : public Spec {
+    // Shared by all users of the resource; null if `retry_budget` is not
+    // specified.
+    std::shared_ptr<RetryBudget> budget;
+
+    // Records an initial attempt of a request against `budget`.
+    void RecordRequest() const {
+      if (budget) budget->RecordRequest();
+    }
+
+    // Returns `false` if `budget` does not permit another retry.
+    bool TryRetry() const { return !budget || budget->TryRetry(); }
+  };
+
   static Spec Default() { return {}; }
   static constexpr auto JsonBinder() {
     namespace jb = ::tensorstore::internal_json_binding;
@@ -77,12 +105,23 @@ struct RetriesResource : public ContextResourceTraits<Derived> {
             "max_delay",  //
             jb::Projection(&Spec::max_delay, jb::DefaultValue([](auto* v) {
               *v = Derived::Default().max_delay;
-            }))) /**/
+            }))),
+        jb::Member("retry_budget",  //
+                   jb::Projection<&Spec::retry_budget>()) /**/
     );
   }
   static Result<Resource> Create(
       const Spec& spec, internal::ContextResourceCreationContext context) {
-    return spec;
+    if (spec.retry_budget && !(*spec.retry_budget >= 0)) {
+      return absl::InvalidArgumentError(
+          "\"retry_budget\" must be non-negative");
+    }
+    Resource resource;
+    static_cast<Spec&>(resource) = spec;
+    if (spec.retry_budget) {
+      resource.budget = std::make_shared<RetryBudget>(*spec.retry_budget);
+    }
+    return resource;
   }
   static Spec GetSpec(const Resource& resource,
                       const internal::ContextSpecBuilder& builder) {
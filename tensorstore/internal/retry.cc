@@ -16,9 +16,13 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <utility>
 
 #include "absl/random/random.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 
 namespace tensorstore {
@@ -42,5 +46,94 @@ absl::Duration BackoffForAttempt(int attempt, absl::Duration initial_delay,
   return delay;
 }
 
+namespace {
+
+/// Upper bound on the number of steps replayed by
+/// `DecorrelatedJitterBackoffForAttempt`; by then the delays are limited by
+/// `max_delay` for any reasonable ratio of `max_delay` to `initial_delay`.
+constexpr int kMaxReplayedAttempts = 64;
+
+absl::Duration DecorrelatedJitterBackoff(absl::InsecureBitGen& gen,
+                                         absl::Duration previous_delay,
+                                         absl::Duration initial_delay,
+                                         absl::Duration max_delay) {
+  assert(initial_delay > absl::ZeroDuration());
+  assert(max_delay >= initial_delay);
+  const int64_t lo_us = absl::ToInt64Microseconds(initial_delay);
+  const int64_t hi_us = std::max(
+      lo_us,
+      absl::ToInt64Microseconds(std::min(previous_delay, max_delay) * 3));
+  return std::min(max_delay, absl::Microseconds(absl::Uniform(
+                                 absl::IntervalClosed, gen, lo_us, hi_us)));
+}
+
+}  // namespace
+
+absl::Duration DecorrelatedJitterBackoff(absl::Duration previous_delay,
+                                         absl::Duration initial_delay,
+                                         absl::Duration max_delay) {
+  absl::InsecureBitGen gen;
+  return DecorrelatedJitterBackoff(gen, previous_delay, initial_delay,
+                                   max_delay);
+}
+
+absl::Duration DecorrelatedJitterBackoffForAttempt(
+    int attempt, absl::Duration initial_delay, absl::Duration max_delay) {
+  assert(attempt >= 0);
+  absl::InsecureBitGen gen;
+  absl::Duration delay = initial_delay;
+  for (int i = 0; i <= std::min(attempt, kMaxReplayedAttempts); ++i) {
+    delay = DecorrelatedJitterBackoff(gen, delay, initial_delay, max_delay);
+  }
+  return delay;
+}
+
+RetryBudget::RetryBudget(double ratio, double min_retries_per_second,
+                         double max_balance,
+                         std::function<absl::Time()> clock)
+    : ratio_(ratio),
+      min_retries_per_second_(min_retries_per_second),
+      max_balance_(max_balance),
+      clock_(std::move(clock)),
+      balance_(max_balance),
+      last_refill_(clock_()) {
+  assert(ratio >= 0);
+  assert(min_retries_per_second >= 0);
+  assert(max_balance >= 1);
+}
+
+void RetryBudget::RefillLocked() {
+  const absl::Time now = clock_();
+  if (now <= last_refill_) return;
+  balance_ = std::min(
+      max_balance_,
+      balance_ + min_retries_per_second_ *
+                     absl::ToDoubleSeconds(now - last_refill_));
+  last_refill_ = now;
+}
+
+void RetryBudget::RecordRequest() {
+  absl::MutexLock lock(&mutex_);
+  balance_ = std::min(max_balance_, balance_ + ratio_);
+}
+
+bool RetryBudget::TryRetry() {
+  absl::MutexLock lock(&mutex_);
+  RefillLocked();
+  if (balance_ < 1) return false;
+  balance_ -= 1;
+  return true;
+}
+
+double RetryBudget::balance() const {
+  absl::MutexLock lock(&mutex_);
+  return balance_;
+}
+
+bool IsRetryBeforeDeadline(absl::Duration delay, absl::Time deadline,
+                           absl::Time now) {
+  return deadline == absl::InfiniteFuture() || now + delay < deadline;
+}
+
 }  // namespace internal
 }  // namespace tensorstore
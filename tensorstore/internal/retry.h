@@ -15,6 +15,11 @@
 #ifndef TENSORSTORE_INTERNAL_RETRY_H_
 #define TENSORSTORE_INTERNAL_RETRY_H_
 
+#include <functional>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 
 namespace tensorstore {
@@ -34,6 +39,72 @@ absl::Duration BackoffForAttempt(
     absl::Duration jitter          // GCS recommends absl::Seconds(1)
 );
 
+/// Computes the next delay of a "decorrelated jitter" backoff sequence, which
+/// is chosen uniformly between `initial_delay` and three times
+/// `previous_delay`, limited to `max_delay`.  Compared with exponential
+/// backoff, the delays of concurrent requests which fail at the same time
+/// quickly diverge, so that their retries are not issued in lockstep.
+///
+/// https://aws.amazon.com/blogs/architecture/exponential-backoff-and-jitter/
+absl::Duration DecorrelatedJitterBackoff(absl::Duration previous_delay,
+                                         absl::Duration initial_delay,
+                                         absl::Duration max_delay);
+
+/// Returns a delay distributed as the `attempt`-th element of a
+/// `DecorrelatedJitterBackoff` sequence starting at `initial_delay`.
+///
+/// Callers which only track the attempt number, rather than the previous
+/// delay, obtain the same distribution of delays for each attempt.
+absl::Duration DecorrelatedJitterBackoffForAttempt(int attempt,
+                                                   absl::Duration initial_delay,
+                                                   absl::Duration max_delay);
+
+/// Limits the number of retries issued on behalf of a group of requests, such
+/// as all requests to a storage service, so that retries during an outage do
+/// not amplify the load on the service.
+///
+/// Each request deposits `ratio` tokens and each retry withdraws one token, so
+/// that retries are limited to `ratio` times the request rate.  Additionally,
+/// `min_retries_per_second` tokens accrue over time, so that a low rate of
+/// requests may still be retried.  The balance is limited to `max_balance`.
+///
+/// Once the budget is exhausted, all retries are rejected until requests
+/// replenish it, which acts as a circuit breaker when most requests fail.
+class RetryBudget {
+ public:
+  explicit RetryBudget(double ratio, double min_retries_per_second = 1,
+                       double max_balance = 100,
+                       std::function<absl::Time()> clock = absl::Now);
+
+  /// Records an initial attempt of a request.
+  void RecordRequest() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /// Withdraws a token for a retry.  Returns `false` if the budget is
+  /// exhausted, in which case the request must not be retried.
+  bool TryRetry() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /// Returns the number of available tokens.
+  double balance() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  void RefillLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const double ratio_;
+  const double min_retries_per_second_;
+  const double max_balance_;
+  const std::function<absl::Time()> clock_;
+
+  mutable absl::Mutex mutex_;
+  double balance_ ABSL_GUARDED_BY(mutex_);
+  absl::Time last_refill_ ABSL_GUARDED_BY(mutex_);
+};
+
+/// Returns `true` if a retry issued after waiting `delay` would start before
+/// `deadline`.  Retries which cannot start before the deadline are pointless,
+/// since the operation will already have failed.
+bool IsRetryBeforeDeadline(absl::Duration delay, absl::Time deadline,
+                           absl::Time now = absl::Now());
+
 }  // namespace internal
 }  // namespace tensorstore
 
@@ -21,6 +21,13 @@
 namespace {
 
 using ::tensorstore::internal::BackoffForAttempt;
+using ::tensorstore::internal::DecorrelatedJitterBackoff;
+using ::tensorstore::internal::DecorrelatedJitterBackoffForAttempt;
+using ::tensorstore::internal::IsRetryBeforeDeadline;
+using ::tensorstore::internal::RetryBudget;
+using ::testing::AllOf;
+using ::testing::Ge;
+using ::testing::Le;
 
 TEST(RetryTest, BackoffForAttempt) {
   // first attempt ==
@@ -49,4 +56,72 @@ TEST(RetryTest, BackoffForAttempt) {
               ::testing::AllOf(::testing::Ge(2), testing::Le(104)));
 }
 
+TEST(RetryTest, DecorrelatedJitterBackoff) {
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(DecorrelatedJitterBackoff(absl::Seconds(4), absl::Seconds(1),
+                                          absl::Seconds(100)),
+                AllOf(Ge(absl::Seconds(1)), Le(absl::Seconds(12))));
+    EXPECT_THAT(DecorrelatedJitterBackoff(absl::Seconds(50), absl::Seconds(1),
+                                          absl::Seconds(100)),
+                AllOf(Ge(absl::Seconds(1)), Le(absl::Seconds(100))));
+  }
+  EXPECT_EQ(absl::Seconds(1),
+            DecorrelatedJitterBackoff(absl::ZeroDuration(), absl::Seconds(1),
+                                      absl::Seconds(100)));
+}
+
+TEST(RetryTest, DecorrelatedJitterBackoffForAttempt) {
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(DecorrelatedJitterBackoffForAttempt(0, absl::Seconds(1),
+                                                    absl::Seconds(100)),
+                AllOf(Ge(absl::Seconds(1)), Le(absl::Seconds(3))));
+    EXPECT_THAT(DecorrelatedJitterBackoffForAttempt(2, absl::Seconds(1),
+                                                    absl::Seconds(100)),
+                AllOf(Ge(absl::Seconds(1)), Le(absl::Seconds(27))));
+    EXPECT_THAT(DecorrelatedJitterBackoffForAttempt(1000, absl::Seconds(1),
+                                                    absl::Seconds(100)),
+                AllOf(Ge(absl::Seconds(1)), Le(absl::Seconds(100))));
+  }
+}
+
+TEST(RetryBudgetTest, Basic) {
+  absl::Time now = absl::UnixEpoch();
+  RetryBudget budget(/*ratio=*/0.5, /*min_retries_per_second=*/1,
+                     /*max_balance=*/2, [&now] { return now; });
+  EXPECT_EQ(2, budget.balance());
+
+  // The initial balance permits a burst of retries.
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_FALSE(budget.TryRetry());
+
+  // Each request contributes half of a retry.
+  budget.RecordRequest();
+  EXPECT_FALSE(budget.TryRetry());
+  budget.RecordRequest();
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_FALSE(budget.TryRetry());
+
+  // Retries also accrue over time, up to the maximum balance.
+  now += absl::Seconds(1);
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_FALSE(budget.TryRetry());
+  now += absl::Seconds(10);
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_TRUE(budget.TryRetry());
+  EXPECT_FALSE(budget.TryRetry());
+}
+
+TEST(RetryTest, IsRetryBeforeDeadline) {
+  const absl::Time now = absl::UnixEpoch() + absl::Seconds(100);
+  EXPECT_TRUE(IsRetryBeforeDeadline(absl::Seconds(1000),
+                                    absl::InfiniteFuture(), now));
+  EXPECT_TRUE(IsRetryBeforeDeadline(absl::Seconds(1),
+                                    now + absl::Seconds(2), now));
+  EXPECT_FALSE(IsRetryBeforeDeadline(absl::Seconds(2),
+                                     now + absl::Seconds(2), now));
+  EXPECT_FALSE(IsRetryBeforeDeadline(absl::ZeroDuration(),
+                                     now - absl::Seconds(1), now));
+}
+
 }  // namespace
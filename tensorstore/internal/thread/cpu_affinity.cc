@@ -0,0 +1,138 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/thread/cpu_affinity.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+#if defined(__linux__)
+// Reads the first line of a sysfs file, or returns an empty string.
+std::string ReadSysfsLine(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  if (file) std::getline(file, line);
+  return line;
+}
+
+std::vector<int> GetCurrentThreadCpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+bool SetCurrentThreadCpus(tensorstore::span<const int> cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+#endif
+
+}  // namespace
+
+std::vector<int> ParseCpuList(std::string_view list) {
+  std::vector<int> cpus;
+  list = absl::StripAsciiWhitespace(list);
+  if (list.empty()) return cpus;
+  for (std::string_view range : absl::StrSplit(list, ',')) {
+    std::pair<std::string_view, std::string_view> bounds =
+        absl::StrSplit(range, absl::MaxSplits('-', 1));
+    int first, last;
+    if (!absl::SimpleAtoi(bounds.first, &first)) return {};
+    if (bounds.second.empty()) {
+      last = first;
+    } else if (!absl::SimpleAtoi(bounds.second, &last)) {
+      return {};
+    }
+    if (first < 0 || last < first) return {};
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+const std::vector<std::vector<int>>& GetNumaNodeCpus() {
+  static const absl::NoDestructor<std::vector<std::vector<int>>> nodes([] {
+    std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+    for (int node :
+         ParseCpuList(ReadSysfsLine("/sys/devices/system/node/online"))) {
+      auto cpus = ParseCpuList(ReadSysfsLine(
+          absl::StrCat("/sys/devices/system/node/node", node, "/cpulist")));
+      // Memory-only nodes have no CPUs.
+      if (!cpus.empty()) nodes.push_back(std::move(cpus));
+    }
+#endif
+    return nodes;
+  }());
+  return *nodes;
+}
+
+int GetCurrentCpu() {
+#if defined(__linux__)
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity(tensorstore::span<const int> cpus) {
+#if defined(__linux__)
+  if (cpus.empty()) return;
+  std::vector<int> previous_cpus = GetCurrentThreadCpus();
+  std::vector<int> allowed_cpus;
+  for (int cpu : cpus) {
+    if (std::binary_search(previous_cpus.begin(), previous_cpus.end(), cpu)) {
+      allowed_cpus.push_back(cpu);
+    }
+  }
+  if (allowed_cpus.empty() || !SetCurrentThreadCpus(allowed_cpus)) return;
+  previous_cpus_ = std::move(previous_cpus);
+#endif
+}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+#if defined(__linux__)
+  if (!previous_cpus_.empty()) SetCurrentThreadCpus(previous_cpus_);
+#endif
+}
+
+}  // namespace internal
+}  // namespace tensorstore
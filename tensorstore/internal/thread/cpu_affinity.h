@@ -0,0 +1,62 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_THREAD_CPU_AFFINITY_H_
+#define TENSORSTORE_INTERNAL_THREAD_CPU_AFFINITY_H_
+
+#include <string_view>
+#include <vector>
+
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Parses a Linux cpu list such as `"0-3,8,10-11"`.
+///
+/// Returns an empty vector if `list` is malformed.
+std::vector<int> ParseCpuList(std::string_view list);
+
+/// Returns the CPUs of each online NUMA node of the host.
+///
+/// Returns an empty vector if the topology cannot be determined, which is
+/// always the case on platforms other than Linux.
+const std::vector<std::vector<int>>& GetNumaNodeCpus();
+
+/// Returns the CPU on which the calling thread is running, or -1 if unknown.
+int GetCurrentCpu();
+
+/// Restricts the calling thread to a set of CPUs for the lifetime of this
+/// object, and then restores its previous affinity.
+///
+/// CPUs outside the previous affinity of the thread are ignored.  Has no
+/// effect if `cpus` is empty, or if thread affinity is not supported.
+class ScopedThreadAffinity {
+ public:
+  explicit ScopedThreadAffinity(tensorstore::span<const int> cpus);
+  ~ScopedThreadAffinity();
+
+  ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+  ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+ private:
+  // CPUs to which the thread was previously restricted, or empty if the
+  // affinity was not changed.
+  std::vector<int> previous_cpus_;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_THREAD_CPU_AFFINITY_H_
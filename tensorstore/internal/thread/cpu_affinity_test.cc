@@ -0,0 +1,70 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/thread/cpu_affinity.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+using ::tensorstore::internal::GetCurrentCpu;
+using ::tensorstore::internal::GetNumaNodeCpus;
+using ::tensorstore::internal::ParseCpuList;
+using ::tensorstore::internal::ScopedThreadAffinity;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(ParseCpuListTest, Basic) {
+  EXPECT_THAT(ParseCpuList(""), IsEmpty());
+  EXPECT_THAT(ParseCpuList("0\n"), ElementsAre(0));
+  EXPECT_THAT(ParseCpuList("0-3"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(ParseCpuList("0-1,8,10-11"), ElementsAre(0, 1, 8, 10, 11));
+}
+
+TEST(ParseCpuListTest, Invalid) {
+  EXPECT_THAT(ParseCpuList("a"), IsEmpty());
+  EXPECT_THAT(ParseCpuList("3-1"), IsEmpty());
+  EXPECT_THAT(ParseCpuList("0,,1"), IsEmpty());
+  EXPECT_THAT(ParseCpuList("-1"), IsEmpty());
+}
+
+TEST(NumaTest, NodesAreDisjoint) {
+  std::vector<bool> seen;
+  for (const auto& cpus : GetNumaNodeCpus()) {
+    EXPECT_THAT(cpus, ::testing::Not(IsEmpty()));
+    for (int cpu : cpus) {
+      if (static_cast<size_t>(cpu) >= seen.size()) seen.resize(cpu + 1);
+      EXPECT_FALSE(seen[cpu]) << cpu;
+      seen[cpu] = true;
+    }
+  }
+}
+
+TEST(ScopedThreadAffinityTest, RestrictsCurrentThread) {
+  int cpu = GetCurrentCpu();
+  if (cpu < 0) GTEST_SKIP() << "Thread affinity not supported";
+  {
+    std::vector<int> cpus{cpu};
+    ScopedThreadAffinity affinity(cpus);
+    EXPECT_EQ(cpu, GetCurrentCpu());
+  }
+  // Empty sets have no effect.
+  std::vector<int> no_cpus;
+  ScopedThreadAffinity affinity(no_cpus);
+}
+
+}  // namespace
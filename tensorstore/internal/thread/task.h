@@ -23,6 +23,7 @@
 #include "absl/time/clock.h"
 #include "tensorstore/internal/attributes.h"
 #include "tensorstore/internal/tracing/tracing.h"
+#include "tensorstore/util/task_priority.h"
 
 namespace tensorstore {
 namespace internal_thread_impl {
@@ -33,9 +34,12 @@ struct InFlightTask {
       : callback_(std::move(callback)),
         tc_(internal_tracing::TraceContext(
             internal_tracing::TraceContext::kThread)),
-        start_nanos(absl::GetCurrentTimeNanos()) {}
+        start_nanos(absl::GetCurrentTimeNanos()),
+        priority(internal::GetCurrentTaskPriority()) {}
 
   void Run() {
+    // Tasks submitted by this task inherit its priority.
+    internal::ScopedTaskPriority scoped_priority(priority);
     internal_tracing::SwapCurrentTraceContext(&tc_);
     std::move(callback_)();
     callback_ = {};
@@ -45,6 +49,10 @@ struct InFlightTask {
   absl::AnyInvocable<void() &&> callback_;
   TENSORSTORE_ATTRIBUTE_NO_UNIQUE_ADDRESS internal_tracing::TraceContext tc_;
   int64_t start_nanos;
+  TaskPriority priority;
+
+  // Link used by the lock-free submission inbox of `TaskGroup`.
+  InFlightTask* next = nullptr;
 };
 
 }  // namespace internal_thread_impl
@@ -21,7 +21,9 @@
 #include <atomic>
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
 #include "absl/base/optimization.h"
 #include "absl/synchronization/mutex.h"
@@ -30,10 +32,12 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/gauge.h"
+#include "tensorstore/internal/thread/cpu_affinity.h"
 #include "tensorstore/internal/thread/pool_impl.h"
 #include "tensorstore/internal/thread/task.h"
 #include "tensorstore/internal/thread/task_provider.h"
 #include "tensorstore/util/span.h"
+#include "tensorstore/util/task_priority.h"
 
 namespace tensorstore {
 namespace internal_thread_impl {
@@ -123,16 +127,20 @@ struct TaskGroup::PerThreadData {
 };
 
 TaskGroup::TaskGroup(private_t, internal::IntrusivePtr<SharedThreadPool> pool,
-                     size_t thread_limit)
+                     size_t thread_limit, std::vector<int> cpus)
     : pool_(std::move(pool)),
       thread_limit_(thread_limit),
+      cpus_(std::move(cpus)),
       threads_blocked_(0),
       threads_in_use_(0),
+      inbox_size_(0),
       steal_index_(0) {}
 
 TaskGroup::~TaskGroup() {
   assert(threads_in_use_.load(std::memory_order_relaxed) == 0);
+  assert(inbox_.empty());
   assert(queue_.empty());
+  assert(background_queue_.empty());
 }
 
 int64_t TaskGroup::EstimateThreadsRequired() {
@@ -142,14 +150,16 @@ int64_t TaskGroup::EstimateThreadsRequired() {
   }
 
   // Otherwise check the available tasks.
+  size_t available = inbox_size_.load(std::memory_order_relaxed);
   absl::MutexLock lock(&mutex_);
-  if (!queue_.empty()) {
-    return std::min(n, queue_.size());
+  available += queue_.size();
+  if (available != 0) {
+    return std::min(n, available);
   }
   for (auto* p : thread_queues_) {
     if (!p->queue.empty()) return std::min(n, p->queue.size());
   }
-  return 0;
+  return std::min(n, background_queue_.size());
 }
 
 void TaskGroup::DoWorkOnThread() {
@@ -169,6 +179,9 @@ void TaskGroup::DoWorkOnThread() {
     per_thread_data = data.get();
   }
 
+  std::optional<internal::ScopedThreadAffinity> affinity;
+  if (!cpus_.empty()) affinity.emplace(cpus_);
+
   int64_t last_run_ns = absl::GetCurrentTimeNanos();
   ThreadMetrics metrics;
 
@@ -208,13 +221,19 @@ void TaskGroup::DoWorkOnThread() {
   per_thread_data = nullptr;
 }
 
+bool TaskGroup::IsCurrentThreadAssigned() const {
+  return per_thread_data != nullptr &&
+         per_thread_data->owner.load(std::memory_order_relaxed) == this;
+}
+
 /// Acquire a task.
 std::unique_ptr<InFlightTask> TaskGroup::AcquireTask(PerThreadData* thread_data,
                                                      absl::Duration timeout) {
   struct ScopedIncDec {
     std::atomic<int64_t>& x_;
     ScopedIncDec(std::atomic<int64_t>& x) : x_(x) {
-      x_.fetch_add(1, std::memory_order_relaxed);
+      // Pairs with the load in `NotifyBlockedThreads`.
+      x_.fetch_add(1, std::memory_order_seq_cst);
     }
     ~ScopedIncDec() { x_.fetch_sub(1, std::memory_order_relaxed); }
   };
@@ -226,7 +245,9 @@ std::unique_ptr<InFlightTask> TaskGroup::AcquireTask(PerThreadData* thread_data,
 
   absl::MutexLock lock(&mutex_);
   while (true) {
-    // Second, attempt to acquire a task from the global queue.
+    // Second, attempt to acquire a task from the global queue, including
+    // tasks submitted to the inbox.
+    DrainInboxLocked();
     if (!queue_.empty()) {
       std::unique_ptr<InFlightTask> task = std::move(queue_.front());
       queue_.pop_front();
@@ -266,11 +287,24 @@ std::unique_ptr<InFlightTask> TaskGroup::AcquireTask(PerThreadData* thread_data,
       return task;
     }
 
-    // No tasks acquired; wait until more work appears on the global queue.
+    // Fourth, run background tasks only when no other task is available.
+    if (!background_queue_.empty()) {
+      std::unique_ptr<InFlightTask> task =
+          std::move(background_queue_.front());
+      background_queue_.pop_front();
+      return task;
+    }
+
+    // No tasks acquired; wait until more work appears on the global queues.
     ScopedIncDec blocked(threads_blocked_);
     if (!mutex_.AwaitWithTimeout(
             absl::Condition(
-                +[](decltype(queue_)* q) { return !q->empty(); }, &queue_),
+                +[](TaskGroup* self) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+                    self->mutex_) {
+                  return !self->queue_.empty() || !self->inbox_.empty() ||
+                         !self->background_queue_.empty();
+                },
+                this),
             timeout)) {
       return nullptr;
     }
@@ -278,12 +312,36 @@ std::unique_ptr<InFlightTask> TaskGroup::AcquireTask(PerThreadData* thread_data,
   ABSL_UNREACHABLE();
 }
 
+void TaskGroup::DrainInboxLocked() {
+  int64_t n = 0;
+  for (InFlightTask* task = inbox_.TakeAll(); task != nullptr; ++n) {
+    InFlightTask* next = std::exchange(task->next, nullptr);
+    queue_.push_back(std::unique_ptr<InFlightTask>(task));
+    task = next;
+  }
+  if (n != 0) inbox_size_.fetch_sub(n, std::memory_order_relaxed);
+}
+
+void TaskGroup::NotifyBlockedThreads() {
+  // Pairs with the increment of `threads_blocked_` in `AcquireTask`: either
+  // the blocked thread observes the pushed tasks when evaluating its wait
+  // condition, or this thread observes the blocked thread, and releasing the
+  // mutex causes the wait condition to be re-evaluated.
+  if (threads_blocked_.load(std::memory_order_seq_cst) > 0) {
+    absl::MutexLock lock(&mutex_);
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 void TaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
   int state = 2;
-  if (per_thread_data != nullptr &&
-      per_thread_data->owner.load(std::memory_order_relaxed) == this) {
+  if (task->priority == TaskPriority::kBackground) {
+    // Background tasks bypass the per-thread queues, which are always drained
+    // first.
+    state = 3;
+  } else if (per_thread_data != nullptr &&
+             per_thread_data->owner.load(std::memory_order_relaxed) == this) {
     // Add on the current-thread's queue.
     if (per_thread_data->queue.push(task.get())) {
       task.release();
@@ -293,7 +351,12 @@ void TaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
     }
   }
 
-  if (state != 0) {
+  if (state == 2) {
+    // Submit to the inbox without locking.
+    inbox_size_.fetch_add(1, std::memory_order_relaxed);
+    inbox_.Push(task.release());
+    NotifyBlockedThreads();
+  } else if (state != 0) {
     absl::MutexLock lock(&mutex_);
 
     if (state == 1) {
@@ -309,7 +372,11 @@ void TaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
       }
     }
 
-    queue_.push_back(std::move(task));
+    if (state == 3) {
+      background_queue_.push_back(std::move(task));
+    } else {
+      queue_.push_back(std::move(task));
+    }
   }
 
   if (threads_in_use_.load(std::memory_order_relaxed) < thread_limit_) {
@@ -319,11 +386,34 @@ void TaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
 
 void TaskGroup::BulkAddTask(
     tensorstore::span<std::unique_ptr<InFlightTask>> tasks) {
-  {
+  // Link the normal-priority tasks from newest to oldest, and push them to the
+  // inbox with a single operation.
+  InFlightTask* newest = nullptr;
+  InFlightTask* oldest = nullptr;
+  int64_t n = 0;
+  bool has_background = false;
+  for (auto& t : tasks) {
+    if (t->priority == TaskPriority::kBackground) {
+      has_background = true;
+      continue;
+    }
+    InFlightTask* task = t.release();
+    task->next = newest;
+    if (oldest == nullptr) oldest = task;
+    newest = task;
+    ++n;
+  }
+  if (n != 0) {
+    inbox_size_.fetch_add(n, std::memory_order_relaxed);
+    inbox_.PushChain(newest, oldest);
+  }
+  if (has_background) {
     absl::MutexLock lock(&mutex_);
     for (auto& t : tasks) {
-      queue_.push_back(std::move(t));
+      if (t) background_queue_.push_back(std::move(t));
     }
+  } else if (n != 0) {
+    NotifyBlockedThreads();
   }
   if (threads_in_use_.load(std::memory_order_relaxed) < thread_limit_) {
     pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
@@ -29,6 +29,7 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "tensorstore/internal/container/block_queue.h"
+#include "tensorstore/internal/container/mpsc_inbox.h"
 #include "tensorstore/internal/container/single_producer_queue.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/thread/pool_impl.h"
@@ -45,20 +46,32 @@ using InFlightTaskQueue =
 /// TaskGroup is TaskProvider which allows adding additional tasks to a
 /// task provider, and allowing up to a specific number of threads to
 /// work on the tasks concurrently.
+///
+/// Tasks added from threads not assigned to the group are pushed to a
+/// lock-free inbox, so that submission does not contend on the group mutex;
+/// workers move them to the global queue when acquiring tasks.
+///
+/// Tasks with `TaskPriority::kBackground` are kept in a separate queue and
+/// are only run when no other task is available.
 class TaskGroup : public TaskProvider {
   struct private_t {};
 
  public:
   struct PerThreadData;
 
+  /// Returns a new task group.
+  ///
+  /// If `cpus` is non-empty, threads are restricted to those CPUs while they
+  /// are assigned to the group.
   static internal::IntrusivePtr<TaskGroup> Make(
-      internal::IntrusivePtr<SharedThreadPool> pool, size_t thread_limit) {
+      internal::IntrusivePtr<SharedThreadPool> pool, size_t thread_limit,
+      std::vector<int> cpus = {}) {
     return internal::MakeIntrusivePtr<TaskGroup>(private_t{}, std::move(pool),
-                                                 thread_limit);
+                                                 thread_limit, std::move(cpus));
   }
 
   TaskGroup(private_t, internal::IntrusivePtr<SharedThreadPool> pool,
-            size_t thread_limit);
+            size_t thread_limit, std::vector<int> cpus);
 
   ~TaskGroup() override;
 
@@ -67,7 +80,7 @@ class TaskGroup : public TaskProvider {
   /// Thread safety: safe to call concurrently from multiple threads.
   void AddTask(std::unique_ptr<InFlightTask> task);
 
-  /// Enqueues a task.
+  /// Enqueues multiple tasks in a single operation.
   ///
   /// Thread safety: safe to call concurrently from multiple threads.
   void BulkAddTask(tensorstore::span<std::unique_ptr<InFlightTask>> tasks);
@@ -78,21 +91,40 @@ class TaskGroup : public TaskProvider {
   /// Worker method: Assign a thread to this task provider.
   void DoWorkOnThread() override;
 
+  /// Returns `true` if the current thread is assigned to this task group.
+  bool IsCurrentThreadAssigned() const;
+
  private:
   /// Worker method: Acquire work from the global queue or another thread.
   std::unique_ptr<InFlightTask> AcquireTask(PerThreadData* thread_data,
                                             absl::Duration timeout);
 
+  /// Worker method: Moves tasks from `inbox_` to `queue_`.
+  void DrainInboxLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Wakes blocked workers, if any, after tasks were pushed to `inbox_`.
+  void NotifyBlockedThreads();
+
   const internal::IntrusivePtr<SharedThreadPool> pool_;
   const size_t thread_limit_;
+  const std::vector<int> cpus_;
 
   // worker thread state counters; updated under lock, read without locks.
   ABSL_CACHELINE_ALIGNED std::atomic<int64_t> threads_blocked_;
   std::atomic<int64_t> threads_in_use_;
 
+  // Tasks submitted from other threads; pushed without locking.
+  ABSL_CACHELINE_ALIGNED internal_container::MpscInbox<
+      InFlightTask, &InFlightTask::next>
+      inbox_;
+  // Number of tasks in `inbox_`; incremented before the tasks are pushed.
+  std::atomic<int64_t> inbox_size_;
+
   absl::Mutex mutex_;
   internal_container::BlockQueue<std::unique_ptr<InFlightTask>> queue_
       ABSL_GUARDED_BY(mutex_);
+  internal_container::BlockQueue<std::unique_ptr<InFlightTask>>
+      background_queue_ ABSL_GUARDED_BY(mutex_);
   std::vector<PerThreadData*> thread_queues_ ABSL_GUARDED_BY(mutex_);
   size_t steal_index_ ABSL_GUARDED_BY(mutex_);
 };
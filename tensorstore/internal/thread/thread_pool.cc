@@ -16,26 +16,168 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "absl/base/no_destructor.h"
+#include "absl/flags/flag.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "tensorstore/internal/env.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/thread/cpu_affinity.h"
 #include "tensorstore/internal/thread/pool_impl.h"
 #include "tensorstore/internal/thread/task.h"
 #include "tensorstore/internal/thread/task_group_impl.h"
+#include "tensorstore/internal/thread/work_stealing_task_group_impl.h"
 #include "tensorstore/util/executor.h"
+#include "tensorstore/util/span.h"
+
+ABSL_FLAG(std::optional<bool>, tensorstore_thread_pool_work_stealing,
+          std::nullopt,
+          "Use the work-stealing task scheduler for thread pools. "
+          "Overrides TENSORSTORE_THREAD_POOL_WORK_STEALING.");
 
 namespace tensorstore {
 namespace internal {
 namespace {
 
-Executor DefaultThreadPool(size_t num_threads) {
+// Executor that adds tasks to a single task group.
+template <typename TaskGroupType>
+struct TaskGroupExecutor {
+  internal::IntrusivePtr<TaskGroupType> task_group;
+
+  void operator()(ExecutorTask task) const {
+    task_group->AddTask(
+        std::make_unique<internal_thread_impl::InFlightTask>(std::move(task)));
+  }
+};
+
+// Returns an executor that adds tasks to a single task group.
+template <typename TaskGroupType>
+Executor MakeTaskGroupExecutor(
+    internal::IntrusivePtr<internal_thread_impl::SharedThreadPool> pool,
+    size_t num_threads) {
+  return TaskGroupExecutor<TaskGroupType>{
+      TaskGroupType::Make(std::move(pool), num_threads)};
+}
+
+template <typename TaskGroupType>
+struct NumaTaskGroups {
+  std::vector<internal::IntrusivePtr<TaskGroupType>> task_groups;
+  // Maps each CPU to the index of its node, or -1.
+  std::vector<int> cpu_to_node;
+  // Used to distribute tasks submitted from unknown CPUs.
+  std::atomic<size_t> next_node{0};
+};
+
+// Executor that adds tasks to the task group of the current NUMA node.
+template <typename TaskGroupType>
+struct NumaTaskGroupExecutor {
+  std::shared_ptr<NumaTaskGroups<TaskGroupType>> state;
+
+  void operator()(ExecutorTask task) const {
+    size_t node;
+    int cpu = GetCurrentCpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < state->cpu_to_node.size() &&
+        state->cpu_to_node[cpu] >= 0) {
+      node = state->cpu_to_node[cpu];
+    } else {
+      node = state->next_node.fetch_add(1, std::memory_order_relaxed) %
+             state->task_groups.size();
+    }
+    state->task_groups[node]->AddTask(
+        std::make_unique<internal_thread_impl::InFlightTask>(std::move(task)));
+  }
+};
+
+// Returns an executor with one task group per NUMA node, each restricted to
+// the CPUs of its node.  Tasks are added to the task group of the node on
+// which the submitting thread is running, since buffers that the task will
+// access were most likely first touched, and therefore allocated, there.
+template <typename TaskGroupType>
+Executor MakeNumaTaskGroupExecutor(
+    internal::IntrusivePtr<internal_thread_impl::SharedThreadPool> pool,
+    size_t num_threads, const std::vector<std::vector<int>>& nodes) {
+  auto state = std::make_shared<NumaTaskGroups<TaskGroupType>>();
+  size_t total_cpus = 0;
+  for (const auto& cpus : nodes) total_cpus += cpus.size();
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    // Divide the thread limit in proportion to the number of CPUs.
+    size_t node_threads =
+        std::max(size_t{1}, num_threads * nodes[node].size() / total_cpus);
+    state->task_groups.push_back(
+        TaskGroupType::Make(pool, node_threads, nodes[node]));
+    for (int cpu : nodes[node]) {
+      if (static_cast<size_t>(cpu) >= state->cpu_to_node.size()) {
+        state->cpu_to_node.resize(cpu + 1, -1);
+      }
+      state->cpu_to_node[cpu] = static_cast<int>(node);
+    }
+  }
+  return NumaTaskGroupExecutor<TaskGroupType>{std::move(state)};
+}
+
+template <typename TaskGroupType>
+Executor MakeExecutor(
+    internal::IntrusivePtr<internal_thread_impl::SharedThreadPool> pool,
+    size_t num_threads, bool numa_aware) {
+  if (numa_aware) {
+    const auto& nodes = GetNumaNodeCpus();
+    if (nodes.size() > 1) {
+      return MakeNumaTaskGroupExecutor<TaskGroupType>(std::move(pool),
+                                                      num_threads, nodes);
+    }
+  }
+  return MakeTaskGroupExecutor<TaskGroupType>(std::move(pool), num_threads);
+}
+
+// Returns `true` if the current thread is assigned to a task group of
+// `executor`.
+template <typename TaskGroupType>
+bool IsCurrentThreadOf(const Executor& executor) {
+  if (auto* e = executor.target<TaskGroupExecutor<TaskGroupType>>()) {
+    return e->task_group->IsCurrentThreadAssigned();
+  }
+  if (auto* e = executor.target<NumaTaskGroupExecutor<TaskGroupType>>()) {
+    for (const auto& task_group : e->state->task_groups) {
+      if (task_group->IsCurrentThreadAssigned()) return true;
+    }
+  }
+  return false;
+}
+
+// Tunable parameter: Maximum nesting depth of tasks run inline by
+// `MaybeInlineExecutor`, which bounds stack usage.
+constexpr int kMaxInlineDepth = 8;
+
+thread_local int inline_depth = 0;
+
+struct MaybeInlineExecutorImpl {
+  Executor executor;
+
+  void operator()(ExecutorTask task) const {
+    if (inline_depth < kMaxInlineDepth &&
+        (IsCurrentThreadOf<internal_thread_impl::TaskGroup>(executor) ||
+         IsCurrentThreadOf<internal_thread_impl::WorkStealingTaskGroup>(
+             executor))) {
+      ++inline_depth;
+      std::move(task)();
+      --inline_depth;
+      return;
+    }
+    executor(std::move(task));
+  }
+};
+
+Executor DefaultThreadPool(size_t num_threads, bool numa_aware) {
   static absl::NoDestructor<internal_thread_impl::SharedThreadPool> pool_;
   intrusive_ptr_increment(pool_.get());
   if (num_threads == 0 || num_threads == std::numeric_limits<size_t>::max()) {
@@ -47,20 +189,48 @@ Executor DefaultThreadPool(size_t num_threads) {
         << num_threads;
   }
 
-  auto task_group = internal_thread_impl::TaskGroup::Make(
-      internal::IntrusivePtr<internal_thread_impl::SharedThreadPool>(
-          pool_.get()),
-      num_threads);
-  return [task_group = std::move(task_group)](ExecutorTask task) {
-    task_group->AddTask(
-        std::make_unique<internal_thread_impl::InFlightTask>(std::move(task)));
-  };
+  internal::IntrusivePtr<internal_thread_impl::SharedThreadPool> pool(
+      pool_.get());
+  if (internal::GetFlagOrEnvValue(FLAGS_tensorstore_thread_pool_work_stealing,
+                                  "TENSORSTORE_THREAD_POOL_WORK_STEALING")
+          .value_or(false)) {
+    return MakeExecutor<internal_thread_impl::WorkStealingTaskGroup>(
+        std::move(pool), num_threads, numa_aware);
+  }
+  return MakeExecutor<internal_thread_impl::TaskGroup>(std::move(pool),
+                                                       num_threads, numa_aware);
 }
 
 }  // namespace
 
 Executor DetachedThreadPool(size_t num_threads) {
-  return DefaultThreadPool(num_threads);
+  return DefaultThreadPool(num_threads, /*numa_aware=*/false);
+}
+
+Executor NumaAwareDetachedThreadPool(size_t num_threads) {
+  return DefaultThreadPool(num_threads, /*numa_aware=*/true);
+}
+
+Executor MaybeInlineExecutor(Executor executor) {
+  return MaybeInlineExecutorImpl{std::move(executor)};
+}
+
+void ExecuteBatch(const Executor& executor, span<ExecutorTask> tasks) {
+  using ::tensorstore::internal_thread_impl::InFlightTask;
+  using ::tensorstore::internal_thread_impl::TaskGroup;
+  if (auto* task_group_executor =
+          executor.target<TaskGroupExecutor<TaskGroup>>()) {
+    std::vector<std::unique_ptr<InFlightTask>> in_flight;
+    in_flight.reserve(tasks.size());
+    for (auto& task : tasks) {
+      in_flight.push_back(std::make_unique<InFlightTask>(std::move(task)));
+    }
+    task_group_executor->task_group->BulkAddTask(in_flight);
+    return;
+  }
+  for (auto& task : tasks) {
+    executor(std::move(task));
+  }
 }
 
 }  // namespace internal
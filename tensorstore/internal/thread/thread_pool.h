@@ -18,6 +18,7 @@
 #include <stddef.h>
 
 #include "tensorstore/util/executor.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -30,6 +31,41 @@ namespace internal {
 /// \param num_threads Maximum number of threads to use.
 Executor DetachedThreadPool(size_t num_threads);
 
+/// Returns a detached thread pool executor whose threads are partitioned by
+/// NUMA node.
+///
+/// Each node is assigned a share of `num_threads` proportional to its number
+/// of CPUs, and its threads are restricted to those CPUs while running tasks.
+/// A task runs on the node of the CPU from which it was submitted, so that
+/// continuations run near the memory touched by the submitting thread.
+///
+/// Equivalent to `DetachedThreadPool` if the host has a single NUMA node, or
+/// if the topology cannot be determined.
+Executor NumaAwareDetachedThreadPool(size_t num_threads);
+
+/// Returns an executor for cheap continuations, such as resolving a promise,
+/// which would otherwise pay for a thread hop through `executor`.
+///
+/// Tasks submitted from a thread of `executor`, which must have been returned
+/// by `DetachedThreadPool` or `NumaAwareDetachedThreadPool`, run immediately
+/// on the submitting thread, up to a bounded nesting depth.  Tasks submitted
+/// from any other thread, or from too deep a nesting level, are submitted to
+/// `executor`.
+///
+/// As with `InlineExecutor`, tasks may run while the submitting thread holds
+/// locks, so this must only be used for tasks that do not block.
+Executor MaybeInlineExecutor(Executor executor);
+
+/// Submits each of `tasks` to `executor`.
+///
+/// If `executor` was returned by `DetachedThreadPool`, the tasks are enqueued
+/// with a single operation, which is substantially cheaper than submitting
+/// them individually when there are many tasks.  Otherwise, this is equivalent
+/// to calling `executor` with each task in order.
+///
+/// The elements of `tasks` are left in a moved-from state.
+void ExecuteBatch(const Executor& executor, span<ExecutorTask> tasks);
+
 }  // namespace internal
 }  // namespace tensorstore
 
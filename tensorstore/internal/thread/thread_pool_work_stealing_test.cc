@@ -0,0 +1,29 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "absl/flags/commandlineflag.h"
+#include "absl/flags/reflection.h"
+#include "absl/log/absl_check.h"
+#include "tensorstore/internal/thread/thread_pool.h"  // IWYU pragma: keep
+
+void SetupThreadPoolTestEnv() {
+  std::string error;
+  ABSL_CHECK(absl::FindCommandLineFlag("tensorstore_thread_pool_work_stealing")
+                 ->ParseFrom("true", &error))
+      << error;
+}
+
+#include "tensorstore/internal/thread/thread_pool_test.inc"  // IWYU pragma: keep
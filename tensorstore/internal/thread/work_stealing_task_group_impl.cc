@@ -0,0 +1,333 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/thread/work_stealing_task_group_impl.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/container/single_producer_queue.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/thread/cpu_affinity.h"
+#include "tensorstore/internal/thread/pool_impl.h"
+#include "tensorstore/internal/thread/task.h"
+#include "tensorstore/internal/thread/task_provider.h"
+#include "tensorstore/util/task_priority.h"
+
+namespace tensorstore {
+namespace internal_thread_impl {
+namespace {
+
+auto& work_stealing_steal_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/thread_pool/work_stealing/steal_count",
+    "Tasks stolen from other threads by WorkStealingTaskGroup");
+
+constexpr absl::Duration kThreadAssignmentLifetime = absl::Milliseconds(20);
+
+// Tunable parameter: In addition to the task to run, steal up to 1/2 the
+// remaining items (max 16) onto the local deque.
+inline size_t ItemsToStealToLocalQueue(size_t available) {
+  return (std::min)(size_t{16}, available >> 1);
+}
+
+}  // namespace
+
+struct WorkStealingTaskGroup::Worker {
+  explicit Worker(WorkStealingTaskGroup* group) : group(group) {}
+
+  WorkStealingTaskGroup* const group;
+
+  // Indicates that a thread is assigned to this worker; guarded by
+  // `group->mutex_`.
+  bool active = false;
+
+  // Index of the next worker to attempt to steal from.  Only accessed by the
+  // assigned thread.
+  size_t steal_index = 0;
+
+  // Local deque; only the assigned thread may push and pop.
+  internal_container::SingleProducerQueue<InFlightTask*> queue{256};
+};
+
+namespace {
+thread_local WorkStealingTaskGroup::Worker* current_worker = nullptr;
+}  // namespace
+
+WorkStealingTaskGroup::WorkStealingTaskGroup(
+    private_t, internal::IntrusivePtr<SharedThreadPool> pool,
+    size_t thread_limit, std::vector<int> cpus)
+    : pool_(std::move(pool)),
+      thread_limit_(thread_limit),
+      cpus_(std::move(cpus)),
+      workers_(new std::atomic<Worker*>[thread_limit]),
+      num_workers_(0),
+      threads_in_use_(0),
+      threads_idle_(0),
+      injection_queue_size_(0),
+      background_queue_size_(0),
+      wakeups_(0) {}
+
+WorkStealingTaskGroup::~WorkStealingTaskGroup() {
+  assert(threads_in_use_.load(std::memory_order_relaxed) == 0);
+  assert(queue_.empty());
+  assert(background_queue_.empty());
+  size_t num_workers = num_workers_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < num_workers; ++i) {
+    Worker* worker = workers_[i].load(std::memory_order_relaxed);
+    assert(worker->queue.empty());
+    delete worker;
+  }
+}
+
+int64_t WorkStealingTaskGroup::EstimateThreadsRequired() {
+  int64_t n = static_cast<int64_t>(thread_limit_) -
+              threads_in_use_.load(std::memory_order_relaxed);
+  if (n <= 0 || threads_idle_.load(std::memory_order_relaxed) != 0) {
+    // Idle threads are woken directly when work is added.
+    return 0;
+  }
+  int64_t available = injection_queue_size_.load(std::memory_order_relaxed);
+  size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < num_workers && available < n; ++i) {
+    available += workers_[i].load(std::memory_order_acquire)->queue.size();
+  }
+  available += background_queue_size_.load(std::memory_order_relaxed);
+  return std::min(n, available);
+}
+
+void WorkStealingTaskGroup::DoWorkOnThread() {
+  assert(current_worker == nullptr);
+
+  Worker* worker = nullptr;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (threads_in_use_.load(std::memory_order_relaxed) ==
+        static_cast<int64_t>(thread_limit_)) {
+      return;
+    }
+    threads_in_use_.fetch_add(1, std::memory_order_relaxed);
+    // Reuse an inactive worker slot; since at most `thread_limit_` threads
+    // are in use, a new slot is always available otherwise.
+    size_t num_workers = num_workers_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < num_workers; ++i) {
+      Worker* w = workers_[i].load(std::memory_order_relaxed);
+      if (!w->active) {
+        worker = w;
+        break;
+      }
+    }
+    if (!worker) {
+      assert(num_workers < thread_limit_);
+      worker = new Worker(this);
+      workers_[num_workers].store(worker, std::memory_order_release);
+      num_workers_.store(num_workers + 1, std::memory_order_release);
+    }
+    worker->active = true;
+  }
+  current_worker = worker;
+
+  std::optional<internal::ScopedThreadAffinity> affinity;
+  if (!cpus_.empty()) affinity.emplace(cpus_);
+
+  int64_t last_run_ns = absl::GetCurrentTimeNanos();
+
+  // As long as there is work available, do it on this thread.
+  while (true) {
+    if (InFlightTask* t = AcquireTask(worker, kThreadAssignmentLifetime)) {
+      std::unique_ptr<InFlightTask>(t)->Run();
+      last_run_ns = absl::GetCurrentTimeNanos();
+      continue;
+    }
+    auto idle = absl::Nanoseconds(absl::GetCurrentTimeNanos() - last_run_ns);
+    if (idle > kThreadAssignmentLifetime) {
+      // If a thread has been idle for 20ms, migrate it to the global pool.
+      break;
+    }
+  }
+
+  // The local deque is empty, since `AcquireTask` checks it first and only
+  // this thread pushes to it.
+  current_worker = nullptr;
+  {
+    absl::MutexLock lock(&mutex_);
+    worker->active = false;
+    threads_in_use_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+bool WorkStealingTaskGroup::IsCurrentThreadAssigned() const {
+  return current_worker != nullptr && current_worker->group == this;
+}
+
+InFlightTask* WorkStealingTaskGroup::TrySteal(Worker* worker) {
+  size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < num_workers; ++i, ++worker->steal_index) {
+    if (worker->steal_index >= num_workers) worker->steal_index = 0;
+    Worker* victim =
+        workers_[worker->steal_index].load(std::memory_order_acquire);
+    if (victim == worker) continue;
+    InFlightTask* task = victim->queue.try_steal();
+    if (!task) continue;
+    // Tunable parameter: Items to steal and move to the local deque.
+    size_t x = ItemsToStealToLocalQueue(victim->queue.size());
+    while (x--) {
+      InFlightTask* t = victim->queue.try_steal();
+      if (!t) break;
+      worker->queue.push(t);
+    }
+    work_stealing_steal_count.Increment();
+    return task;
+  }
+  return nullptr;
+}
+
+InFlightTask* WorkStealingTaskGroup::PopQueuedTask(bool include_background) {
+  if (!queue_.empty()) {
+    InFlightTask* task = queue_.front().release();
+    queue_.pop_front();
+    injection_queue_size_.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+  if (include_background && !background_queue_.empty()) {
+    InFlightTask* task = background_queue_.front().release();
+    background_queue_.pop_front();
+    background_queue_size_.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+  return nullptr;
+}
+
+InFlightTask* WorkStealingTaskGroup::AcquireTask(Worker* worker,
+                                                 absl::Duration timeout) {
+  // First, attempt to acquire a task from the local deque.
+  if (InFlightTask* t = worker->queue.try_pop()) return t;
+
+  while (true) {
+    // Second, attempt to acquire a task from the injection queue.
+    if (injection_queue_size_.load(std::memory_order_relaxed) > 0) {
+      absl::MutexLock lock(&mutex_);
+      if (InFlightTask* t = PopQueuedTask(/*include_background=*/false)) {
+        return t;
+      }
+    }
+
+    // Third, steal from other workers without locking.
+    if (InFlightTask* t = TrySteal(worker)) return t;
+
+    // Fourth, run background tasks only when no other task is available.
+    if (background_queue_size_.load(std::memory_order_relaxed) > 0) {
+      absl::MutexLock lock(&mutex_);
+      if (InFlightTask* t = PopQueuedTask(/*include_background=*/true)) {
+        return t;
+      }
+    }
+
+    // Advertise that this thread is idle, and check again, so that a task
+    // pushed to a local deque concurrently is not missed; see
+    // `WakeIdleWorker`.
+    threads_idle_.fetch_add(1, std::memory_order_seq_cst);
+    if (InFlightTask* t = TrySteal(worker)) {
+      threads_idle_.fetch_sub(1, std::memory_order_relaxed);
+      return t;
+    }
+
+    // No tasks acquired; wait until more work appears.
+    absl::MutexLock lock(&mutex_);
+    bool woken = mutex_.AwaitWithTimeout(
+        absl::Condition(
+            +[](WorkStealingTaskGroup* self)
+                 ABSL_EXCLUSIVE_LOCKS_REQUIRED(self->mutex_) {
+                   return !self->queue_.empty() ||
+                          !self->background_queue_.empty() ||
+                          self->wakeups_ > 0;
+                 },
+            this),
+        timeout);
+    threads_idle_.fetch_sub(1, std::memory_order_relaxed);
+    if (!woken) return nullptr;
+    if (wakeups_ > 0) {
+      // Woken for a task pushed to a local deque; prefer stealing it over
+      // running a background task.
+      --wakeups_;
+      continue;
+    }
+    if (InFlightTask* t = PopQueuedTask(/*include_background=*/true)) {
+      return t;
+    }
+  }
+  ABSL_UNREACHABLE();
+}
+
+void WorkStealingTaskGroup::WakeIdleWorker() {
+  absl::MutexLock lock(&mutex_);
+  if (wakeups_ < threads_idle_.load(std::memory_order_relaxed)) {
+    ++wakeups_;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingTaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
+  Worker* worker = current_worker;
+  if (task->priority == TaskPriority::kBackground) {
+    // Background tasks bypass the local deques, which are always drained
+    // first.
+    absl::MutexLock lock(&mutex_);
+    background_queue_.push_back(std::move(task));
+    background_queue_size_.fetch_add(1, std::memory_order_relaxed);
+    if (threads_idle_.load(std::memory_order_relaxed) > 0) return;
+  } else if (worker != nullptr && worker->group == this) {
+    // Push onto the current thread's deque; the deque grows as needed.
+    worker->queue.push(task.release());
+    // Pairs with the `fetch_add` of `threads_idle_` in `AcquireTask`: either
+    // the idle thread observes the pushed task, or this thread observes the
+    // idle thread.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (threads_idle_.load(std::memory_order_relaxed) > 0) {
+      WakeIdleWorker();
+      return;
+    }
+    // Request additional threads only as the local deque doubles in size, to
+    // avoid contending on the pool mutex during fan-out.
+    size_t size = worker->queue.size();
+    if ((size & (size - 1)) != 0) return;
+  } else {
+    absl::MutexLock lock(&mutex_);
+    queue_.push_back(std::move(task));
+    injection_queue_size_.fetch_add(1, std::memory_order_relaxed);
+    // Parked threads are woken by the mutex condition.
+    if (threads_idle_.load(std::memory_order_relaxed) > 0) return;
+  }
+
+  if (threads_in_use_.load(std::memory_order_relaxed) <
+      static_cast<int64_t>(thread_limit_)) {
+    pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
+  }
+}
+
+}  // namespace internal_thread_impl
+}  // namespace tensorstore
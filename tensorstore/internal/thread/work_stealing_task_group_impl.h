@@ -0,0 +1,136 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_THREAD_WORK_STEALING_TASK_GROUP_IMPL_H_
+#define TENSORSTORE_INTERNAL_THREAD_WORK_STEALING_TASK_GROUP_IMPL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/container/block_queue.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/thread/pool_impl.h"
+#include "tensorstore/internal/thread/task.h"
+#include "tensorstore/internal/thread/task_provider.h"
+
+namespace tensorstore {
+namespace internal_thread_impl {
+
+/// Work-stealing alternative to `TaskGroup`.
+///
+/// Each thread assigned to the group owns a growable lock-free deque.  Tasks
+/// added from one of those threads are pushed onto its own deque without
+/// locking, and popped in LIFO order by the owner for locality.  Tasks added
+/// from any other thread go to a mutex-protected injection queue.
+///
+/// An idle thread first checks the injection queue, then steals from the
+/// deques of the other threads without acquiring the mutex, and only then
+/// parks.  Parked threads are woken when work is pushed to a local deque, so
+/// that bursty fan-out from a single thread is spread quickly.
+///
+/// Unlike `TaskGroup`, stealing never acquires the group mutex.
+///
+/// Tasks with `TaskPriority::kBackground` are kept in a separate queue and
+/// are only run when no other task is available.
+class WorkStealingTaskGroup : public TaskProvider {
+  struct private_t {};
+
+ public:
+  struct Worker;
+
+  /// Returns a new task group.
+  ///
+  /// If `cpus` is non-empty, threads are restricted to those CPUs while they
+  /// are assigned to the group.
+  static internal::IntrusivePtr<WorkStealingTaskGroup> Make(
+      internal::IntrusivePtr<SharedThreadPool> pool, size_t thread_limit,
+      std::vector<int> cpus = {}) {
+    return internal::MakeIntrusivePtr<WorkStealingTaskGroup>(
+        private_t{}, std::move(pool), thread_limit, std::move(cpus));
+  }
+
+  WorkStealingTaskGroup(private_t,
+                        internal::IntrusivePtr<SharedThreadPool> pool,
+                        size_t thread_limit, std::vector<int> cpus);
+
+  ~WorkStealingTaskGroup() override;
+
+  /// Enqueues a task.
+  ///
+  /// Thread safety: safe to call concurrently from multiple threads.
+  void AddTask(std::unique_ptr<InFlightTask> task);
+
+  /// Retrieve work units available.
+  int64_t EstimateThreadsRequired() override;
+
+  /// Worker method: Assign a thread to this task provider.
+  void DoWorkOnThread() override;
+
+  /// Returns `true` if the current thread is assigned to this task group.
+  bool IsCurrentThreadAssigned() const;
+
+ private:
+  /// Worker method: Acquire work from the local deque, the injection queue,
+  /// or another worker, waiting up to `timeout` for work to appear.
+  InFlightTask* AcquireTask(Worker* worker, absl::Duration timeout);
+
+  /// Worker method: Attempts to steal tasks from the other workers.
+  InFlightTask* TrySteal(Worker* worker);
+
+  /// Worker method: Pops a task from the injection queue, or else from the
+  /// background queue if `include_background` is `true`.
+  InFlightTask* PopQueuedTask(bool include_background)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Wakes a parked worker, if any, after a task was pushed to a local deque.
+  void WakeIdleWorker();
+
+  const internal::IntrusivePtr<SharedThreadPool> pool_;
+  const size_t thread_limit_;
+  const std::vector<int> cpus_;
+
+  // Worker slots.  The first `num_workers_` entries are non-null, and are
+  // retained (possibly inactive) until the group is destroyed, so that they
+  // may be read by stealing threads without locking.
+  std::unique_ptr<std::atomic<Worker*>[]> workers_;
+  std::atomic<size_t> num_workers_;
+
+  // worker thread state counters; updated without locks.
+  ABSL_CACHELINE_ALIGNED std::atomic<int64_t> threads_in_use_;
+  std::atomic<int64_t> threads_idle_;
+  std::atomic<int64_t> injection_queue_size_;
+  std::atomic<int64_t> background_queue_size_;
+
+  absl::Mutex mutex_;
+  internal_container::BlockQueue<std::unique_ptr<InFlightTask>> queue_
+      ABSL_GUARDED_BY(mutex_);
+  internal_container::BlockQueue<std::unique_ptr<InFlightTask>>
+      background_queue_ ABSL_GUARDED_BY(mutex_);
+  // Number of parked workers signaled by `WakeIdleWorker`.
+  int64_t wakeups_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_thread_impl
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_THREAD_WORK_STEALING_TASK_GROUP_IMPL_H_
@@ -0,0 +1,286 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tiled_transpose.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "tensorstore/index.h"
+#include "tensorstore/internal/elementwise_function.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TENSORSTORE_INTERNAL_TILED_TRANSPOSE_SSE2 1
+#endif
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+// Blocks with fewer rows or columns than this are left to the ordinary
+// strided copy, since tiling does not pay for itself.
+constexpr Index kMinTransposeExtent = 16;
+
+// Tunable parameter: Edge length, in elements, of the square tiles.  Each tile
+// touches `kTileEdge` rows of both buffers, which should remain resident in
+// the L1 cache while the tile is processed.
+template <typename T>
+constexpr Index kTileEdge = sizeof(T) == 1 ? 128 : sizeof(T) == 8 ? 32 : 64;
+
+// Transposes a `kSize x kSize` block of elements of type `T` in registers.
+//
+// Row `r` of the source block starts at `src + r * src_stride`, and row `c`
+// of the destination block, which receives column `c` of the source block,
+// starts at `dst + c * dst_stride`.
+template <typename T, int Size>
+struct GenericTransposeKernel {
+  constexpr static Index kSize = Size;
+
+  static void Apply(const char* src, Index src_stride, char* dst,
+                    Index dst_stride) {
+    T block[Size][Size];
+    for (int r = 0; r < Size; ++r) {
+      std::memcpy(block[r], src + r * src_stride, sizeof(block[r]));
+    }
+    for (int c = 0; c < Size; ++c) {
+      T column[Size];
+      for (int r = 0; r < Size; ++r) column[r] = block[r][c];
+      std::memcpy(dst + c * dst_stride, column, sizeof(column));
+    }
+  }
+};
+
+template <typename T>
+struct TransposeKernel
+    : public GenericTransposeKernel<T, (sizeof(T) <= 2 ? 8 : 4)> {};
+
+#ifdef TENSORSTORE_INTERNAL_TILED_TRANSPOSE_SSE2
+
+inline __m128i LoadUnaligned(const char* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline void StoreUnaligned(char* p, __m128i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+inline __m128i LoadLow64(const char* p) {
+  return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+}
+
+inline void StoreLow64(char* p, __m128i v) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(p), v);
+}
+
+// 8x8 transpose of bytes, using 64-bit row loads.
+template <>
+struct TransposeKernel<uint8_t> {
+  constexpr static Index kSize = 8;
+
+  static void Apply(const char* src, Index src_stride, char* dst,
+                    Index dst_stride) {
+    __m128i r[8];
+    for (int i = 0; i < 8; ++i) r[i] = LoadLow64(src + i * src_stride);
+    // Interleave pairs of rows: a[k] holds rows 2k and 2k+1.
+    const __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+    const __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+    const __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+    const __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+    // b0/b1: columns 0-3/4-7 of rows 0-3; b2/b3: the same for rows 4-7.
+    const __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+    const __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+    const __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+    const __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+    // Each result holds two complete columns.
+    const __m128i c[4] = {
+        _mm_unpacklo_epi32(b0, b2), _mm_unpackhi_epi32(b0, b2),
+        _mm_unpacklo_epi32(b1, b3), _mm_unpackhi_epi32(b1, b3)};
+    for (int i = 0; i < 4; ++i) {
+      StoreLow64(dst + (2 * i) * dst_stride, c[i]);
+      StoreLow64(dst + (2 * i + 1) * dst_stride, _mm_srli_si128(c[i], 8));
+    }
+  }
+};
+
+// 8x8 transpose of 16-bit elements.
+template <>
+struct TransposeKernel<uint16_t> {
+  constexpr static Index kSize = 8;
+
+  static void Apply(const char* src, Index src_stride, char* dst,
+                    Index dst_stride) {
+    __m128i r[8];
+    for (int i = 0; i < 8; ++i) r[i] = LoadUnaligned(src + i * src_stride);
+    const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+    const __m128i a1 = _mm_unpacklo_epi16(r[2], r[3]);
+    const __m128i a2 = _mm_unpacklo_epi16(r[4], r[5]);
+    const __m128i a3 = _mm_unpacklo_epi16(r[6], r[7]);
+    const __m128i a4 = _mm_unpackhi_epi16(r[0], r[1]);
+    const __m128i a5 = _mm_unpackhi_epi16(r[2], r[3]);
+    const __m128i a6 = _mm_unpackhi_epi16(r[4], r[5]);
+    const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+    const __m128i b0 = _mm_unpacklo_epi32(a0, a1);
+    const __m128i b1 = _mm_unpacklo_epi32(a2, a3);
+    const __m128i b2 = _mm_unpackhi_epi32(a0, a1);
+    const __m128i b3 = _mm_unpackhi_epi32(a2, a3);
+    const __m128i b4 = _mm_unpacklo_epi32(a4, a5);
+    const __m128i b5 = _mm_unpacklo_epi32(a6, a7);
+    const __m128i b6 = _mm_unpackhi_epi32(a4, a5);
+    const __m128i b7 = _mm_unpackhi_epi32(a6, a7);
+    StoreUnaligned(dst + 0 * dst_stride, _mm_unpacklo_epi64(b0, b1));
+    StoreUnaligned(dst + 1 * dst_stride, _mm_unpackhi_epi64(b0, b1));
+    StoreUnaligned(dst + 2 * dst_stride, _mm_unpacklo_epi64(b2, b3));
+    StoreUnaligned(dst + 3 * dst_stride, _mm_unpackhi_epi64(b2, b3));
+    StoreUnaligned(dst + 4 * dst_stride, _mm_unpacklo_epi64(b4, b5));
+    StoreUnaligned(dst + 5 * dst_stride, _mm_unpackhi_epi64(b4, b5));
+    StoreUnaligned(dst + 6 * dst_stride, _mm_unpacklo_epi64(b6, b7));
+    StoreUnaligned(dst + 7 * dst_stride, _mm_unpackhi_epi64(b6, b7));
+  }
+};
+
+// 4x4 transpose of 32-bit elements.
+template <>
+struct TransposeKernel<uint32_t> {
+  constexpr static Index kSize = 4;
+
+  static void Apply(const char* src, Index src_stride, char* dst,
+                    Index dst_stride) {
+    const __m128i r0 = LoadUnaligned(src);
+    const __m128i r1 = LoadUnaligned(src + src_stride);
+    const __m128i r2 = LoadUnaligned(src + 2 * src_stride);
+    const __m128i r3 = LoadUnaligned(src + 3 * src_stride);
+    const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    StoreUnaligned(dst, _mm_unpacklo_epi64(t0, t1));
+    StoreUnaligned(dst + dst_stride, _mm_unpackhi_epi64(t0, t1));
+    StoreUnaligned(dst + 2 * dst_stride, _mm_unpacklo_epi64(t2, t3));
+    StoreUnaligned(dst + 3 * dst_stride, _mm_unpackhi_epi64(t2, t3));
+  }
+};
+
+// 4x4 transpose of 64-bit elements, as four 2x2 transposes.
+template <>
+struct TransposeKernel<uint64_t> {
+  constexpr static Index kSize = 4;
+
+  static void Apply(const char* src, Index src_stride, char* dst,
+                    Index dst_stride) {
+    for (int i = 0; i < 4; i += 2) {
+      for (int j = 0; j < 4; j += 2) {
+        const char* s = src + i * src_stride + j * 8;
+        const __m128i x = LoadUnaligned(s);
+        const __m128i y = LoadUnaligned(s + src_stride);
+        char* d = dst + j * dst_stride + i * 8;
+        StoreUnaligned(d, _mm_unpacklo_epi64(x, y));
+        StoreUnaligned(d + dst_stride, _mm_unpackhi_epi64(x, y));
+      }
+    }
+  }
+};
+
+#endif  // TENSORSTORE_INTERNAL_TILED_TRANSPOSE_SSE2
+
+// Transposes the elements in rows `[i0, i1)` and columns `[j0, j1)` one at a
+// time.  Used for the edges of tiles that do not fill a whole kernel block.
+template <typename T>
+void TransposeElements(const char* src, Index src_stride, char* dst,
+                       Index dst_stride, Index i0, Index i1, Index j0,
+                       Index j1) {
+  for (Index j = j0; j < j1; ++j) {
+    for (Index i = i0; i < i1; ++i) {
+      std::memcpy(dst + j * dst_stride + i * sizeof(T),
+                  src + i * src_stride + j * sizeof(T), sizeof(T));
+    }
+  }
+}
+
+// Copies `src`, with `rows` rows of `cols` contiguous elements, to `dst`,
+// with `cols` rows of `rows` contiguous elements.
+template <typename T>
+void TransposeTiled(const char* src, Index src_stride, char* dst,
+                    Index dst_stride, Index rows, Index cols) {
+  using Kernel = TransposeKernel<T>;
+  constexpr Index kSize = Kernel::kSize;
+  constexpr Index kTile = kTileEdge<T>;
+  for (Index i0 = 0; i0 < rows; i0 += kTile) {
+    const Index i1 = std::min(rows, i0 + kTile);
+    for (Index j0 = 0; j0 < cols; j0 += kTile) {
+      const Index j1 = std::min(cols, j0 + kTile);
+      Index i = i0;
+      for (; i + kSize <= i1; i += kSize) {
+        Index j = j0;
+        for (; j + kSize <= j1; j += kSize) {
+          Kernel::Apply(src + i * src_stride + j * sizeof(T), src_stride,
+                        dst + j * dst_stride + i * sizeof(T), dst_stride);
+        }
+        TransposeElements<T>(src, src_stride, dst, dst_stride, i, i + kSize,
+                             j, j1);
+      }
+      TransposeElements<T>(src, src_stride, dst, dst_stride, i, i1, j0, j1);
+    }
+  }
+}
+
+}  // namespace
+
+bool TiledTransposeCopy(ptrdiff_t element_size, IterationBufferShape shape,
+                        IterationBufferPointer source,
+                        IterationBufferPointer dest) {
+  // Normalize so that rows of `src` and rows of `dst` are both contiguous.
+  Index rows, cols, src_stride, dst_stride;
+  if (source.inner_byte_stride == element_size &&
+      dest.outer_byte_stride == element_size) {
+    rows = shape[0];
+    cols = shape[1];
+    src_stride = source.outer_byte_stride;
+    dst_stride = dest.inner_byte_stride;
+  } else if (source.outer_byte_stride == element_size &&
+             dest.inner_byte_stride == element_size) {
+    rows = shape[1];
+    cols = shape[0];
+    src_stride = source.inner_byte_stride;
+    dst_stride = dest.outer_byte_stride;
+  } else {
+    return false;
+  }
+  if (rows < kMinTransposeExtent || cols < kMinTransposeExtent) return false;
+  const char* src = static_cast<const char*>(source.pointer.get());
+  char* dst = static_cast<char*>(dest.pointer.get());
+  switch (element_size) {
+    case 1:
+      TransposeTiled<uint8_t>(src, src_stride, dst, dst_stride, rows, cols);
+      return true;
+    case 2:
+      TransposeTiled<uint16_t>(src, src_stride, dst, dst_stride, rows, cols);
+      return true;
+    case 4:
+      TransposeTiled<uint32_t>(src, src_stride, dst, dst_stride, rows, cols);
+      return true;
+    case 8:
+      TransposeTiled<uint64_t>(src, src_stride, dst, dst_stride, rows, cols);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace internal
+}  // namespace tensorstore
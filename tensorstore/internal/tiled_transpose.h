@@ -0,0 +1,62 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_TILED_TRANSPOSE_H_
+#define TENSORSTORE_INTERNAL_TILED_TRANSPOSE_H_
+
+/// \file
+///
+/// Cache-blocked copy between 2-d strided buffers whose contiguous dimensions
+/// differ.
+///
+/// A plain strided copy of such a block reads one buffer sequentially but
+/// accesses the other with a large stride, touching a new cache line for
+/// every element.  Instead, the block is processed in tiles small enough that
+/// the cache lines of both buffers remain resident, and each tile is
+/// transposed in registers a few rows at a time.
+
+#include <stddef.h>
+
+#include "tensorstore/index.h"
+#include "tensorstore/internal/elementwise_function.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Returns `true` if `TiledTransposeCopy` supports elements of
+/// `element_size` bytes.
+///
+/// The elements must also be trivially copyable.
+constexpr bool IsTiledTransposeElementSize(ptrdiff_t element_size) {
+  return element_size == 1 || element_size == 2 || element_size == 4 ||
+         element_size == 8;
+}
+
+/// Copies a 2-d block of `shape` trivially-copyable elements of
+/// `element_size` bytes from `source` to `dest`, both of which must be
+/// `IterationBufferKind::kStrided` pointers, if one is contiguous along the
+/// inner dimension and the other is contiguous along the outer dimension.
+///
+/// Returns `false`, without copying anything, if the buffers are not
+/// transposed relative to each other in this way, if the block is too small
+/// for tiling to be worthwhile, or if `element_size` is not supported.  The
+/// caller should then use an ordinary strided copy.
+bool TiledTransposeCopy(ptrdiff_t element_size, IterationBufferShape shape,
+                        IterationBufferPointer source,
+                        IterationBufferPointer dest);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TILED_TRANSPOSE_H_
@@ -0,0 +1,108 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tiled_transpose.h"
+
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorstore/index.h"
+#include "tensorstore/internal/elementwise_function.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::internal::IterationBufferPointer;
+using ::tensorstore::internal::TiledTransposeCopy;
+
+template <typename T>
+class TiledTransposeTest : public ::testing::Test {};
+
+using ElementTypes = ::testing::Types<uint8_t, uint16_t, uint32_t, uint64_t>;
+TYPED_TEST_SUITE(TiledTransposeTest, ElementTypes);
+
+// Copies a `rows x cols` row-major source to a column-major destination,
+// with padding in both buffers, and checks the result.
+template <typename T>
+void TestTranspose(Index rows, Index cols, bool source_outer) {
+  const Index src_row_len = cols + 3;
+  const Index dst_row_len = rows + 5;
+  std::vector<T> src(rows * src_row_len);
+  for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<T>(i * 7 + 1);
+  std::vector<T> dst(cols * dst_row_len, 0);
+  const Index es = sizeof(T);
+  IterationBufferPointer source(src.data(), src_row_len * es, es);
+  IterationBufferPointer dest(dst.data(), es, dst_row_len * es);
+  tensorstore::internal::IterationBufferShape shape{rows, cols};
+  if (!source_outer) {
+    // Same copy, with the block dimensions listed in the other order.
+    std::swap(source.outer_byte_stride, source.inner_byte_stride);
+    std::swap(dest.outer_byte_stride, dest.inner_byte_stride);
+    shape = {cols, rows};
+  }
+  ASSERT_TRUE(TiledTransposeCopy(es, shape, source, dest));
+  for (Index i = 0; i < rows; ++i) {
+    for (Index j = 0; j < cols; ++j) {
+      ASSERT_EQ(src[i * src_row_len + j], dst[j * dst_row_len + i])
+          << "i=" << i << ", j=" << j;
+    }
+  }
+  // Padding is not modified.
+  for (Index j = 0; j < cols; ++j) {
+    for (Index i = rows; i < dst_row_len; ++i) {
+      ASSERT_EQ(0, dst[j * dst_row_len + i]);
+    }
+  }
+}
+
+TYPED_TEST(TiledTransposeTest, Square) {
+  TestTranspose<TypeParam>(64, 64, true);
+  TestTranspose<TypeParam>(64, 64, false);
+}
+
+TYPED_TEST(TiledTransposeTest, NotMultipleOfKernel) {
+  TestTranspose<TypeParam>(19, 37, true);
+  TestTranspose<TypeParam>(37, 19, false);
+}
+
+TYPED_TEST(TiledTransposeTest, MultipleTiles) {
+  TestTranspose<TypeParam>(300, 141, true);
+  TestTranspose<TypeParam>(141, 300, false);
+}
+
+TEST(TiledTransposeCopyTest, TooSmall) {
+  std::vector<uint32_t> src(8 * 100), dst(8 * 100);
+  IterationBufferPointer source(src.data(), 100 * 4, 4);
+  IterationBufferPointer dest(dst.data(), 4, 8 * 4);
+  EXPECT_FALSE(TiledTransposeCopy(4, {8, 100}, source, dest));
+}
+
+TEST(TiledTransposeCopyTest, NotTransposed) {
+  std::vector<uint32_t> src(64 * 64), dst(64 * 64);
+  IterationBufferPointer source(src.data(), 64 * 4, 4);
+  IterationBufferPointer dest(dst.data(), 64 * 4, 4);
+  EXPECT_FALSE(TiledTransposeCopy(4, {64, 64}, source, dest));
+}
+
+TEST(TiledTransposeCopyTest, UnsupportedElementSize) {
+  std::vector<char> src(64 * 64 * 3), dst(64 * 64 * 3);
+  IterationBufferPointer source(src.data(), 64 * 3, 3);
+  IterationBufferPointer dest(dst.data(), 3, 64 * 3);
+  EXPECT_FALSE(TiledTransposeCopy(3, {64, 64}, source, dest));
+}
+
+}  // namespace
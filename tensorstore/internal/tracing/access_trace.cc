@@ -0,0 +1,182 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/access_trace.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/json.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+namespace {
+
+struct RecordingState {
+  absl::Mutex mutex;
+  std::vector<AccessTraceEvent> events ABSL_GUARDED_BY(mutex);
+  size_t max_events ABSL_GUARDED_BY(mutex) = 0;
+  size_t num_dropped ABSL_GUARDED_BY(mutex) = 0;
+};
+
+RecordingState& GetRecordingState() {
+  static absl::NoDestructor<RecordingState> state;
+  return *state;
+}
+
+Result<double> GetNumberMember(const ::nlohmann::json& j,
+                               const char* member) {
+  auto it = j.find(member);
+  if (it == j.end() || !it->is_number()) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Expected number for ", QuoteString(member),
+                            ", but received: ", j.dump()));
+  }
+  return it->get<double>();
+}
+
+}  // namespace
+
+void StartAccessTraceRecording(size_t max_events) {
+  auto& state = GetRecordingState();
+  absl::MutexLock lock(&state.mutex);
+  state.events.clear();
+  state.max_events = max_events;
+  state.num_dropped = 0;
+  access_trace_recording.store(true, std::memory_order_relaxed);
+}
+
+std::vector<AccessTraceEvent> StopAccessTraceRecording(size_t* num_dropped) {
+  auto& state = GetRecordingState();
+  std::vector<AccessTraceEvent> events;
+  {
+    absl::MutexLock lock(&state.mutex);
+    access_trace_recording.store(false, std::memory_order_relaxed);
+    events = std::exchange(state.events, {});
+    if (num_dropped) *num_dropped = state.num_dropped;
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.start_time < b.start_time;
+                   });
+  return events;
+}
+
+void AccessTraceRecorder::Start(const char* op,
+                                IndexTransformView<> transform) {
+  op_ = op;
+  transform_ = IndexTransform<>(transform);
+  start_time_ = absl::Now();
+}
+
+void AccessTraceRecorder::Finish(AnyFuture future) {
+  future.UntypedExecuteWhenReady(
+      [op = op_, transform = std::move(transform_),
+       start_time = start_time_](AnyFuture ready) mutable {
+        AccessTraceEvent event{op, std::move(transform), start_time,
+                               absl::Now(), ready.status().ok()};
+        auto& state = GetRecordingState();
+        absl::MutexLock lock(&state.mutex);
+        // Accesses that complete after recording stops are discarded.
+        if (!IsAccessTraceRecording()) return;
+        if (state.events.size() >= state.max_events) {
+          ++state.num_dropped;
+          return;
+        }
+        state.events.push_back(std::move(event));
+      });
+}
+
+::nlohmann::json AccessTraceToJson(
+    const std::vector<AccessTraceEvent>& events) {
+  ::nlohmann::json::array_t j_events;
+  j_events.reserve(events.size());
+  absl::Time origin = absl::InfiniteFuture();
+  for (const auto& event : events) {
+    origin = std::min(origin, event.start_time);
+  }
+  for (const auto& event : events) {
+    j_events.push_back({
+        {"op", event.op},
+        {"transform", ::nlohmann::json(event.transform)},
+        {"start_ms", absl::ToDoubleMilliseconds(event.start_time - origin)},
+        {"end_ms", absl::ToDoubleMilliseconds(event.end_time - origin)},
+        {"ok", event.ok},
+    });
+  }
+  return ::nlohmann::json{{"events", std::move(j_events)}};
+}
+
+Result<std::vector<AccessTraceEvent>> ParseAccessTrace(
+    const ::nlohmann::json& j) {
+  auto it = j.is_object() ? j.find("events") : j.end();
+  if (it == j.end() || !it->is_array()) {
+    return absl::InvalidArgumentError(
+        "Expected access trace object with \"events\" array");
+  }
+  std::vector<AccessTraceEvent> events;
+  events.reserve(it->size());
+  for (const auto& j_event : *it) {
+    if (!j_event.is_object()) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Expected access trace event object, but received: ",
+          j_event.dump()));
+    }
+    AccessTraceEvent event;
+    auto op = j_event.find("op");
+    if (op == j_event.end() || (*op != "read" && *op != "write")) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Expected \"op\" of \"read\" or \"write\", but received: ",
+          j_event.dump()));
+    }
+    event.op = op->get<std::string>();
+    auto transform = j_event.find("transform");
+    if (transform == j_event.end()) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Missing \"transform\" in access trace event: ", j_event.dump()));
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(event.transform,
+                                 ParseIndexTransform(*transform));
+    TENSORSTORE_ASSIGN_OR_RETURN(double start_ms,
+                                 GetNumberMember(j_event, "start_ms"));
+    TENSORSTORE_ASSIGN_OR_RETURN(double end_ms,
+                                 GetNumberMember(j_event, "end_ms"));
+    event.start_time = absl::UnixEpoch() + absl::Milliseconds(start_ms);
+    event.end_time = absl::UnixEpoch() + absl::Milliseconds(end_ms);
+    auto ok = j_event.find("ok");
+    event.ok = ok == j_event.end() || *ok == true;
+    events.push_back(std::move(event));
+  }
+  return events;
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
@@ -0,0 +1,137 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_TRACING_ACCESS_TRACE_H_
+#define TENSORSTORE_INTERNAL_TRACING_ACCESS_TRACE_H_
+
+/// \file
+///
+/// Recording of the TensorStore read and write access pattern.
+///
+/// While recording is enabled, each `tensorstore::Read` and
+/// `tensorstore::Write` records the operation, the index transform that was
+/// accessed, and the times at which it was issued and completed.  The
+/// resultant trace may be replayed against a different kvstore or context
+/// configuration by `//tensorstore/internal/benchmark:access_trace_replay`,
+/// which reproduces both the access pattern and the concurrency.
+///
+/// When recording is disabled, the only cost is a relaxed atomic load per
+/// operation.
+
+#include <stddef.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+
+/// A single recorded access.
+struct AccessTraceEvent {
+  /// Either `"read"` or `"write"`.
+  std::string op;
+
+  /// Transform that was accessed, in the index space of the TensorStore.
+  IndexTransform<> transform;
+
+  /// Time at which the operation was issued.
+  absl::Time start_time;
+
+  /// Time at which the operation (including commit, for writes) completed.
+  absl::Time end_time;
+
+  /// Whether the operation completed successfully.
+  bool ok = true;
+};
+
+/// Indicates whether recording is enabled.  Only accessed by
+/// `IsAccessTraceRecording` and by `access_trace.cc`.
+ABSL_CONST_INIT inline std::atomic<bool> access_trace_recording{false};
+
+/// Returns `true` if accesses are currently being recorded.
+inline bool IsAccessTraceRecording() {
+  return access_trace_recording.load(std::memory_order_relaxed);
+}
+
+/// Starts recording accesses, discarding any previously recorded events.
+///
+/// \param max_events Maximum number of events to record; subsequent events
+///     are dropped and counted by `StopAccessTraceRecording`.
+void StartAccessTraceRecording(size_t max_events = 1 << 20);
+
+/// Stops recording accesses, and returns the events recorded since the last
+/// call to `StartAccessTraceRecording`, ordered by start time.
+///
+/// \param num_dropped[out] Optional.  Set to the number of events dropped
+///     due to the `max_events` limit.
+std::vector<AccessTraceEvent> StopAccessTraceRecording(
+    size_t* num_dropped = nullptr);
+
+/// Records a single access, if recording is enabled when it is constructed.
+///
+/// Example usage:
+///
+///     AccessTraceRecorder recorder("read", source.transform);
+///     auto future = ...;
+///     recorder.RecordWhenReady(future);
+class AccessTraceRecorder {
+ public:
+  /// Captures `transform` and the start time, if recording is enabled.
+  ///
+  /// \param op Operation name, which must have static lifetime.
+  AccessTraceRecorder(const char* op, IndexTransformView<> transform) {
+    if (IsAccessTraceRecording()) Start(op, transform);
+  }
+
+  /// Records the access once `future` becomes ready.
+  template <typename T>
+  void RecordWhenReady(const Future<T>& future) {
+    if (op_) Finish(future);
+  }
+
+ private:
+  void Start(const char* op, IndexTransformView<> transform);
+  void Finish(AnyFuture future);
+
+  const char* op_ = nullptr;
+  IndexTransform<> transform_;
+  absl::Time start_time_;
+};
+
+/// Returns the JSON representation of `events`.
+///
+/// The trace is encoded as an object with an `"events"` member, where each
+/// event specifies `"op"`, `"transform"`, `"ok"`, and the `"start_ms"` and
+/// `"end_ms"` times in milliseconds relative to the start of the first
+/// event.
+::nlohmann::json AccessTraceToJson(const std::vector<AccessTraceEvent>& events);
+
+/// Parses the JSON representation returned by `AccessTraceToJson`.
+///
+/// Times are returned relative to `absl::UnixEpoch()`.
+Result<std::vector<AccessTraceEvent>> ParseAccessTrace(
+    const ::nlohmann::json& j);
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TRACING_ACCESS_TRACE_H_
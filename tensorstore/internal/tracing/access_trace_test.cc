@@ -0,0 +1,129 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/access_trace.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/index_transform_builder.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::IdentityTransform;
+using ::tensorstore::IndexTransformBuilder;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::internal_tracing::AccessTraceEvent;
+using ::tensorstore::internal_tracing::AccessTraceRecorder;
+using ::tensorstore::internal_tracing::AccessTraceToJson;
+using ::tensorstore::internal_tracing::IsAccessTraceRecording;
+using ::tensorstore::internal_tracing::ParseAccessTrace;
+using ::tensorstore::internal_tracing::StartAccessTraceRecording;
+using ::tensorstore::internal_tracing::StopAccessTraceRecording;
+
+TEST(AccessTraceTest, NotRecording) {
+  EXPECT_FALSE(IsAccessTraceRecording());
+  auto pair = PromiseFuturePair<void>::Make();
+  AccessTraceRecorder recorder("read", IdentityTransform(2));
+  recorder.RecordWhenReady(pair.future);
+  pair.promise.SetResult(absl::OkStatus());
+  StartAccessTraceRecording();
+  EXPECT_TRUE(StopAccessTraceRecording().empty());
+}
+
+TEST(AccessTraceTest, Record) {
+  StartAccessTraceRecording(/*max_events=*/2);
+  EXPECT_TRUE(IsAccessTraceRecording());
+  auto read = PromiseFuturePair<void>::Make();
+  auto write = PromiseFuturePair<void>::Make();
+  auto dropped = PromiseFuturePair<void>::Make();
+  AccessTraceRecorder("read", IdentityTransform(2))
+      .RecordWhenReady(read.future);
+  AccessTraceRecorder("write", IdentityTransform(1))
+      .RecordWhenReady(write.future);
+  AccessTraceRecorder("read", IdentityTransform(3))
+      .RecordWhenReady(dropped.future);
+  write.promise.SetResult(absl::UnknownError("failed"));
+  read.promise.SetResult(absl::OkStatus());
+  dropped.promise.SetResult(absl::OkStatus());
+
+  size_t num_dropped;
+  auto events = StopAccessTraceRecording(&num_dropped);
+  EXPECT_FALSE(IsAccessTraceRecording());
+  EXPECT_EQ(1, num_dropped);
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ("read", events[0].op);
+  EXPECT_EQ(IdentityTransform(2), events[0].transform);
+  EXPECT_TRUE(events[0].ok);
+  EXPECT_EQ("write", events[1].op);
+  EXPECT_FALSE(events[1].ok);
+  EXPECT_LE(events[0].start_time, events[1].start_time);
+  EXPECT_LE(events[0].start_time, events[0].end_time);
+}
+
+TEST(AccessTraceTest, JsonRoundTrip) {
+  auto transform = IndexTransformBuilder(1, 1)
+                       .input_origin({2})
+                       .input_shape({5})
+                       .output_single_input_dimension(0, 3, 2, 0)
+                       .Finalize()
+                       .value();
+  std::vector<AccessTraceEvent> events{
+      {"write", IdentityTransform(1), absl::FromUnixSeconds(11),
+       absl::FromUnixSeconds(12), true},
+      {"read", transform, absl::FromUnixSeconds(10),
+       absl::FromUnixSeconds(13), false},
+  };
+  auto j = AccessTraceToJson(events);
+  EXPECT_EQ(1000, j["events"][0]["start_ms"]);
+  EXPECT_EQ(2000, j["events"][0]["end_ms"]);
+  EXPECT_EQ(0, j["events"][1]["start_ms"]);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto parsed, ParseAccessTrace(j));
+  ASSERT_EQ(2, parsed.size());
+  EXPECT_EQ("write", parsed[0].op);
+  EXPECT_EQ(IdentityTransform(1), parsed[0].transform);
+  EXPECT_EQ(absl::Seconds(1), parsed[0].start_time - absl::UnixEpoch());
+  EXPECT_EQ(absl::Seconds(2), parsed[0].end_time - absl::UnixEpoch());
+  EXPECT_TRUE(parsed[0].ok);
+  EXPECT_EQ("read", parsed[1].op);
+  EXPECT_EQ(transform, parsed[1].transform);
+  EXPECT_FALSE(parsed[1].ok);
+}
+
+TEST(AccessTraceTest, ParseInvalid) {
+  EXPECT_THAT(ParseAccessTrace(::nlohmann::json::array()),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      ParseAccessTrace({{"events", {{{"op", "delete"}}}}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument, ".*\"op\".*"));
+  EXPECT_THAT(ParseAccessTrace({{"events",
+                                 {{{"op", "read"},
+                                   {"transform", {{"input_rank", 1}}},
+                                   {"end_ms", 1}}}}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"start_ms\".*"));
+}
+
+}  // namespace
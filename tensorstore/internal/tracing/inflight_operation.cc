@@ -0,0 +1,146 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/inflight_operation.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/container/intrusive_linked_list.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+
+struct InFlightOperationNode {
+  InFlightOperationNode* prev;
+  InFlightOperationNode* next;
+  size_t shard;
+  const char* type;
+  std::string description;
+  absl::Time start_time;
+  // Guarded by the mutex of the shard.
+  const char* state;
+  absl::Time state_time;
+};
+
+namespace {
+
+using Accessor =
+    internal::intrusive_linked_list::MemberAccessor<InFlightOperationNode>;
+
+// Operations are registered in one of several shards, selected by the
+// registering thread, to reduce contention.
+constexpr size_t kNumShards = 16;
+
+struct ABSL_CACHELINE_ALIGNED Shard {
+  Shard() { internal::intrusive_linked_list::Initialize(Accessor{}, &head); }
+
+  absl::Mutex mutex;
+  InFlightOperationNode head ABSL_GUARDED_BY(mutex);
+};
+
+std::array<Shard, kNumShards>& GetShards() {
+  static absl::NoDestructor<std::array<Shard, kNumShards>> shards;
+  return *shards;
+}
+
+size_t GetThreadShard() {
+  static std::atomic<size_t> next_shard{0};
+  thread_local size_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  return shard;
+}
+
+}  // namespace
+
+InFlightOperation::InFlightOperation(const char* type,
+                                     std::string description,
+                                     const char* state) {
+  auto now = absl::Now();
+  node_ = new InFlightOperationNode;
+  node_->shard = GetThreadShard();
+  node_->type = type;
+  node_->description = std::move(description);
+  node_->start_time = now;
+  node_->state = state;
+  node_->state_time = now;
+  auto& shard = GetShards()[node_->shard];
+  absl::MutexLock lock(&shard.mutex);
+  internal::intrusive_linked_list::InsertBefore(Accessor{}, &shard.head,
+                                                node_);
+}
+
+void InFlightOperation::SetState(const char* state) {
+  if (!node_) return;
+  auto now = absl::Now();
+  auto& shard = GetShards()[node_->shard];
+  absl::MutexLock lock(&shard.mutex);
+  node_->state = state;
+  node_->state_time = now;
+}
+
+void InFlightOperation::reset() {
+  if (!node_) return;
+  {
+    auto& shard = GetShards()[node_->shard];
+    absl::MutexLock lock(&shard.mutex);
+    internal::intrusive_linked_list::Remove(Accessor{}, node_);
+  }
+  delete std::exchange(node_, nullptr);
+}
+
+std::vector<InFlightOperationInfo> CollectInFlightOperations() {
+  std::vector<InFlightOperationInfo> result;
+  for (auto& shard : GetShards()) {
+    absl::MutexLock lock(&shard.mutex);
+    for (auto* node = shard.head.next; node != &shard.head;
+         node = node->next) {
+      result.push_back(InFlightOperationInfo{node->type, node->description,
+                                             node->state, node->start_time,
+                                             node->state_time});
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+    return a.start_time < b.start_time;
+  });
+  return result;
+}
+
+::nlohmann::json InFlightOperationInfoToJson(const InFlightOperationInfo& info,
+                                             absl::Time now) {
+  return ::nlohmann::json{
+      {"type", info.type},
+      {"description", info.description},
+      {"state", info.state},
+      {"start_time", absl::FormatTime(info.start_time)},
+      {"elapsed_ms", absl::ToDoubleMilliseconds(now - info.start_time)},
+      {"state_elapsed_ms", absl::ToDoubleMilliseconds(now - info.state_time)},
+  };
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
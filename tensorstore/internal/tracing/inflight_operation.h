@@ -0,0 +1,128 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_TRACING_INFLIGHT_OPERATION_H_
+#define TENSORSTORE_INTERNAL_TRACING_INFLIGHT_OPERATION_H_
+
+/// \file
+///
+/// Registry of operations in progress, such as kvstore requests, HTTP
+/// transfers, cache reads and writebacks, and transaction commits.
+///
+/// Each operation records its type, a description (typically identifying the
+/// key or URL), its start time and its current state.  When a job stalls, the
+/// registry can be dumped with `CollectInFlightOperations` to determine which
+/// keys are blocked, and at which stage, e.g.:
+///
+///     {"type": "kvstore.gcs.read", "description": "gs://bucket/key",
+///      "state": "queued", "elapsed_ms": 60012, ...}
+///
+/// Example usage:
+///
+///     InFlightOperation op("kvstore.read", key, "queued");
+///     ...
+///     op.SetState("transfer");
+///     ...
+///     // Unregistered when `op` is destroyed.
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+
+namespace tensorstore {
+namespace internal_tracing {
+
+struct InFlightOperationNode;
+
+/// Handle to an operation registered in the in-flight operation registry.
+///
+/// The operation is unregistered when the handle is destroyed or reset.
+class InFlightOperation {
+ public:
+  /// Constructs a handle that does not refer to an operation.
+  InFlightOperation() = default;
+
+  /// Registers an operation.
+  ///
+  /// \param type Type of the operation, which must be a string literal.
+  /// \param description Description of the operation, such as the key.
+  /// \param state Initial state, which must be a string literal.
+  InFlightOperation(const char* type, std::string description,
+                    const char* state = "started");
+
+  InFlightOperation(InFlightOperation&& other) noexcept
+      : node_(std::exchange(other.node_, nullptr)) {}
+
+  InFlightOperation& operator=(InFlightOperation&& other) noexcept {
+    if (this != &other) {
+      reset();
+      node_ = std::exchange(other.node_, nullptr);
+    }
+    return *this;
+  }
+
+  ~InFlightOperation() { reset(); }
+
+  /// Updates the state of the operation, which must be a string literal.
+  void SetState(const char* state);
+
+  /// Unregisters the operation.
+  void reset();
+
+  explicit operator bool() const { return node_ != nullptr; }
+
+ private:
+  InFlightOperationNode* node_ = nullptr;
+};
+
+/// Snapshot of an in-flight operation.
+struct InFlightOperationInfo {
+  std::string type;
+  std::string description;
+  std::string state;
+  absl::Time start_time;
+  /// Time at which the operation entered `state`.
+  absl::Time state_time;
+};
+
+/// Returns the operations currently registered, ordered by start time.
+std::vector<InFlightOperationInfo> CollectInFlightOperations();
+
+/// Returns the JSON representation of `info`, including the time elapsed
+/// since the operation started and entered its current state, relative to
+/// `now`.
+::nlohmann::json InFlightOperationInfoToJson(const InFlightOperationInfo& info,
+                                             absl::Time now);
+
+/// Unregisters `operation` once `future` becomes ready, and returns `future`.
+template <typename FutureType>
+FutureType UnregisterWhenReady(InFlightOperation operation,
+                               FutureType future) {
+  if (!operation) return future;
+  future.ExecuteWhenReady(
+      [operation = std::move(operation)](auto ready) mutable {
+        operation.reset();
+      });
+  return future;
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TRACING_INFLIGHT_OPERATION_H_
@@ -0,0 +1,103 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/inflight_operation.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::internal_tracing::CollectInFlightOperations;
+using ::tensorstore::internal_tracing::InFlightOperation;
+using ::tensorstore::internal_tracing::InFlightOperationInfo;
+using ::tensorstore::internal_tracing::InFlightOperationInfoToJson;
+using ::tensorstore::internal_tracing::UnregisterWhenReady;
+
+// Returns the operations of type `type`, excluding any registered by other
+// tests.
+std::vector<InFlightOperationInfo> CollectOfType(const std::string& type) {
+  std::vector<InFlightOperationInfo> result;
+  for (auto& info : CollectInFlightOperations()) {
+    if (info.type == type) result.push_back(std::move(info));
+  }
+  return result;
+}
+
+TEST(InFlightOperationTest, Basic) {
+  {
+    InFlightOperation a("test.basic", "a", "queued");
+    InFlightOperation b("test.basic", "b");
+    auto ops = CollectOfType("test.basic");
+    ASSERT_EQ(2, ops.size());
+    EXPECT_EQ("a", ops[0].description);
+    EXPECT_EQ("queued", ops[0].state);
+    EXPECT_EQ("b", ops[1].description);
+    EXPECT_EQ("started", ops[1].state);
+    EXPECT_LE(ops[0].start_time, ops[1].start_time);
+
+    a.SetState("transfer");
+    b.reset();
+    EXPECT_FALSE(b);
+    ops = CollectOfType("test.basic");
+    ASSERT_EQ(1, ops.size());
+    EXPECT_EQ("transfer", ops[0].state);
+    EXPECT_LE(ops[0].start_time, ops[0].state_time);
+  }
+  EXPECT_TRUE(CollectOfType("test.basic").empty());
+}
+
+TEST(InFlightOperationTest, Move) {
+  InFlightOperation a("test.move", "a");
+  InFlightOperation b = std::move(a);
+  EXPECT_FALSE(a);  // NOLINT
+  EXPECT_TRUE(b);
+  a = std::move(b);
+  EXPECT_EQ(1, CollectOfType("test.move").size());
+  a = InFlightOperation();
+  EXPECT_TRUE(CollectOfType("test.move").empty());
+}
+
+TEST(InFlightOperationTest, UnregisterWhenReady) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future = UnregisterWhenReady(
+      InFlightOperation("test.future", "a"), pair.future);
+  EXPECT_EQ(1, CollectOfType("test.future").size());
+  pair.promise.SetResult(5);
+  EXPECT_TRUE(CollectOfType("test.future").empty());
+}
+
+TEST(InFlightOperationTest, ToJson) {
+  InFlightOperationInfo info{"test.json", "key", "transfer",
+                             absl::UnixEpoch(),
+                             absl::UnixEpoch() + absl::Seconds(1)};
+  auto j = InFlightOperationInfoToJson(info,
+                                       absl::UnixEpoch() + absl::Seconds(3));
+  EXPECT_EQ("test.json", j["type"]);
+  EXPECT_EQ("key", j["description"]);
+  EXPECT_EQ("transfer", j["state"]);
+  EXPECT_EQ(3000, j["elapsed_ms"]);
+  EXPECT_EQ(2000, j["state_elapsed_ms"]);
+}
+
+}  // namespace
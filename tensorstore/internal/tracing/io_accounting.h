@@ -0,0 +1,81 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_TRACING_IO_ACCOUNTING_H_
+#define TENSORSTORE_INTERNAL_TRACING_IO_ACCOUNTING_H_
+
+/// \file
+///
+/// Per-operation accounting of the I/O performed on behalf of an operation.
+///
+/// An `IoAccounting` object is attached to a `TraceSpan` when it is started,
+/// and is inherited by all descendant spans.  Since the current span is
+/// propagated across `Future` callbacks and executor tasks, code anywhere in
+/// the read and write paths may attribute work to the operation that
+/// requested it by calling `AddIoAccounting`.
+///
+/// When no span is current, `AddIoAccounting` only loads a thread-local
+/// pointer.
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/tracing.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+
+/// Counters accumulated on behalf of a single operation.
+struct IoAccounting : public internal::AtomicReferenceCount<IoAccounting> {
+  /// Bytes of array data requested to be read or written.
+  std::atomic<int64_t> bytes_requested{0};
+  /// Bytes read from a kvstore.
+  std::atomic<int64_t> bytes_fetched{0};
+  /// Bytes of array data produced by decoding chunks.
+  std::atomic<int64_t> bytes_decoded{0};
+  /// Bytes written to a kvstore.
+  std::atomic<int64_t> bytes_written{0};
+  /// Number of chunks read or written.
+  std::atomic<int64_t> chunks_touched{0};
+  /// Number of chunk reads satisfied by the cache.
+  std::atomic<int64_t> cache_hits{0};
+};
+
+/// Returns the accounting attached to `span`, or `nullptr`.
+IoAccounting* GetSpanIoAccounting(const SpanState& span);
+
+/// Returns the accounting of the current span, or `nullptr`.
+inline IoAccounting* GetCurrentIoAccounting() {
+  SpanState* span = current_span;
+  return span ? GetSpanIoAccounting(*span) : nullptr;
+}
+
+/// Adds `n` to `counter` of the accounting of the current span, if any.
+///
+/// Example usage:
+///
+///     AddIoAccounting(&IoAccounting::bytes_fetched, value.size());
+inline void AddIoAccounting(std::atomic<int64_t> IoAccounting::*counter,
+                            int64_t n) {
+  if (auto* accounting = GetCurrentIoAccounting()) {
+    (accounting->*counter).fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TRACING_IO_ACCOUNTING_H_
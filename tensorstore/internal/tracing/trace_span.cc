@@ -0,0 +1,304 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/trace_span.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/random/distributions.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/tracing.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+
+struct SpanState {
+  std::atomic<uint32_t> reference_count{0};
+  bool sampled = false;
+  TraceId trace_id;
+  uint64_t span_id = 0;
+  uint64_t parent_span_id = 0;
+  std::string name;
+  absl::Time start_time;
+  // Only accessed by the owning `TraceSpan`.
+  std::vector<SpanAttribute> attributes;
+  absl::Status status;
+  std::shared_ptr<SpanExporter> exporter;
+  // Inherited by descendant spans.
+  internal::IntrusivePtr<IoAccounting> io_accounting;
+};
+
+void intrusive_ptr_increment(SpanState* p) {
+  p->reference_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void intrusive_ptr_decrement(SpanState* p) {
+  if (p->reference_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete p;
+  }
+}
+
+namespace {
+
+struct TracingConfig {
+  absl::Mutex mutex;
+  std::shared_ptr<SpanExporter> exporter ABSL_GUARDED_BY(mutex);
+  double sample_rate ABSL_GUARDED_BY(mutex) = 0;
+};
+
+TracingConfig& GetTracingConfig() {
+  static absl::NoDestructor<TracingConfig> config;
+  return *config;
+}
+
+// Shared state of all spans in traces that are not sampled.  The initial
+// reference is never released, so it is never destroyed.
+SpanState* GetUnsampledSpanState() {
+  static SpanState* state = [] {
+    auto* state = new SpanState;
+    state->reference_count.store(1, std::memory_order_relaxed);
+    return state;
+  }();
+  return state;
+}
+
+absl::InsecureBitGen& GetThreadBitGen() {
+  thread_local absl::InsecureBitGen gen;
+  return gen;
+}
+
+uint64_t GenerateId() {
+  uint64_t id;
+  do {
+    id = absl::Uniform<uint64_t>(GetThreadBitGen());
+  } while (id == 0);
+  return id;
+}
+
+}  // namespace
+
+SpanExporter::~SpanExporter() = default;
+
+void EnableTracing(std::shared_ptr<SpanExporter> exporter,
+                   double sample_rate) {
+  ABSL_CHECK(exporter);
+  auto& config = GetTracingConfig();
+  absl::MutexLock lock(&config.mutex);
+  config.exporter = std::move(exporter);
+  config.sample_rate = sample_rate;
+  tracing_enabled.store(true, std::memory_order_relaxed);
+}
+
+void DisableTracing() {
+  auto& config = GetTracingConfig();
+  absl::MutexLock lock(&config.mutex);
+  tracing_enabled.store(false, std::memory_order_relaxed);
+  config.exporter = nullptr;
+}
+
+void TraceSpan::Start(std::string_view name,
+                      internal::IntrusivePtr<IoAccounting> io_accounting) {
+  SpanState* parent = current_span;
+  if (parent && !io_accounting) io_accounting = parent->io_accounting;
+  if (parent && !parent->sampled &&
+      parent->io_accounting == io_accounting) {
+    state_.reset(parent);
+  } else {
+    std::shared_ptr<SpanExporter> exporter;
+    TraceId trace_id;
+    uint64_t parent_span_id = 0;
+    bool sampled = false;
+    if (parent) {
+      sampled = parent->sampled;
+      if (sampled) {
+        exporter = parent->exporter;
+        trace_id = parent->trace_id;
+        parent_span_id = parent->span_id;
+      }
+    } else {
+      // Root span: make the sampling decision for the entire trace.
+      auto& config = GetTracingConfig();
+      double sample_rate;
+      {
+        absl::MutexLock lock(&config.mutex);
+        exporter = config.exporter;
+        sample_rate = config.sample_rate;
+      }
+      sampled = exporter && absl::Bernoulli(GetThreadBitGen(), sample_rate);
+      if (sampled) {
+        trace_id.high = absl::Uniform<uint64_t>(GetThreadBitGen());
+        trace_id.low = GenerateId();
+      } else if (!io_accounting) {
+        // Mark the trace as unsampled such that descendant spans skip
+        // sampling.
+        if (!exporter) return;
+        state_.reset(GetUnsampledSpanState());
+      }
+    }
+    if (!state_) {
+      auto* state = new SpanState;
+      // Unsampled spans are only created to carry `io_accounting`.
+      state->sampled = sampled;
+      state->io_accounting = std::move(io_accounting);
+      if (sampled) {
+        state->trace_id = trace_id;
+        state->span_id = GenerateId();
+        state->parent_span_id = parent_span_id;
+        state->name = std::string(name);
+        state->start_time = absl::Now();
+        state->exporter = std::move(exporter);
+      }
+      state_.reset(state);
+    }
+  }
+  // Make this span current, taking ownership of the reference to the prior
+  // current span.
+  previous_ = current_span;
+  current_span = state_.get();
+  intrusive_ptr_increment(current_span);
+  attached_ = true;
+}
+
+TraceSpan::TraceSpan(TraceSpan&& other) noexcept {
+  other.Detach();
+  state_ = std::move(other.state_);
+}
+
+bool TraceSpan::IsSampled(const SpanState& state) { return state.sampled; }
+
+IoAccounting* GetSpanIoAccounting(const SpanState& span) {
+  return span.io_accounting.get();
+}
+
+void TraceSpan::AddAttribute(std::string_view name, SpanAttributeValue value) {
+  state_->attributes.push_back(
+      SpanAttribute{std::string(name), std::move(value)});
+}
+
+void TraceSpan::SetStatus(const absl::Status& status) {
+  if (!active()) return;
+  state_->status = status;
+}
+
+void TraceSpan::Detach() {
+  if (!attached_) return;
+  ABSL_CHECK_EQ(current_span, state_.get())
+      << "Spans must be ended in the reverse order in which they are started";
+  intrusive_ptr_decrement(current_span);
+  current_span = std::exchange(previous_, nullptr);
+  attached_ = false;
+}
+
+void TraceSpan::End() {
+  Detach();
+  auto state = std::move(state_);
+  if (!state || !state->sampled) return;
+  SpanRecord record;
+  record.trace_id = state->trace_id;
+  record.span_id = state->span_id;
+  record.parent_span_id = state->parent_span_id;
+  record.name = state->name;
+  record.start_time = state->start_time;
+  record.end_time = absl::Now();
+  record.attributes = std::move(state->attributes);
+  record.status = std::move(state->status);
+  state->exporter->Export(std::move(record));
+}
+
+std::optional<std::string> GetCurrentTraceparent() {
+  SpanState* span = current_span;
+  if (!span || !span->sampled) return std::nullopt;
+  return absl::StrFormat("00-%016x%016x-%016x-01", span->trace_id.high,
+                         span->trace_id.low, span->span_id);
+}
+
+std::string SpanRecordToJson(const SpanRecord& span) {
+  auto to_nanos = [](absl::Time t) {
+    return absl::StrCat(absl::ToUnixNanos(t));
+  };
+  ::nlohmann::json j{
+      {"traceId", absl::StrFormat("%016x%016x", span.trace_id.high,
+                                  span.trace_id.low)},
+      {"spanId", absl::StrFormat("%016x", span.span_id)},
+      {"name", span.name},
+      {"startTimeUnixNano", to_nanos(span.start_time)},
+      {"endTimeUnixNano", to_nanos(span.end_time)},
+  };
+  if (span.parent_span_id != 0) {
+    j["parentSpanId"] = absl::StrFormat("%016x", span.parent_span_id);
+  }
+  auto& attributes = j["attributes"] = ::nlohmann::json::array_t();
+  for (const auto& attribute : span.attributes) {
+    ::nlohmann::json value = std::visit(
+        [](const auto& v) -> ::nlohmann::json {
+          using T = std::decay_t<decltype(v)>;
+          if constexpr (std::is_same_v<T, bool>) {
+            return {{"boolValue", v}};
+          } else if constexpr (std::is_same_v<T, int64_t>) {
+            // OTLP JSON encodes 64-bit integers as strings.
+            return {{"intValue", absl::StrCat(v)}};
+          } else if constexpr (std::is_same_v<T, double>) {
+            return {{"doubleValue", v}};
+          } else {
+            return {{"stringValue", v}};
+          }
+        },
+        attribute.value);
+    attributes.push_back({{"key", attribute.name}, {"value", value}});
+  }
+  if (span.status.ok()) {
+    j["status"] = {{"code", 1}};
+  } else {
+    j["status"] = {{"code", 2}, {"message", span.status.ToString()}};
+  }
+  return j.dump();
+}
+
+namespace {
+class LoggingSpanExporter : public SpanExporter {
+ public:
+  void Export(SpanRecord span) override {
+    ABSL_LOG(INFO) << SpanRecordToJson(span);
+  }
+};
+}  // namespace
+
+std::shared_ptr<SpanExporter> MakeLoggingSpanExporter() {
+  return std::make_shared<LoggingSpanExporter>();
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
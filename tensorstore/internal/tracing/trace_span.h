@@ -0,0 +1,235 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_TRACING_TRACE_SPAN_H_
+#define TENSORSTORE_INTERNAL_TRACING_TRACE_SPAN_H_
+
+/// \file
+///
+/// Tracing spans, following the OpenTelemetry data model.
+///
+/// Tracing is disabled by default.  While disabled, constructing a
+/// `TraceSpan` only checks an atomic flag.  Once enabled by
+/// `EnableTracing`, each root span (a span started while no span is current)
+/// is sampled with the configured probability, and the descendants of a
+/// sampled span are recorded and passed to the `SpanExporter` as they end.
+///
+/// Example usage:
+///
+///     Future<Value> DoSomething(std::string_view key) {
+///       internal_tracing::TraceSpan span("tensorstore.something");
+///       span.SetAttribute("key", key);
+///       // Spans started by `Issue`, including by callbacks it registers,
+///       // are children of `span`.
+///       auto future = Issue(key);
+///       return internal_tracing::EndWhenReady(std::move(span),
+///                                             std::move(future));
+///     }
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
+#include "tensorstore/internal/tracing/tracing.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+
+/// Value of a span attribute.
+using SpanAttributeValue = std::variant<bool, int64_t, double, std::string>;
+
+/// Span attribute, equivalent to an OpenTelemetry attribute.
+struct SpanAttribute {
+  std::string name;
+  SpanAttributeValue value;
+};
+
+/// 128-bit trace identifier.
+struct TraceId {
+  uint64_t high = 0;
+  uint64_t low = 0;
+
+  friend bool operator==(const TraceId& a, const TraceId& b) {
+    return a.high == b.high && a.low == b.low;
+  }
+  friend bool operator!=(const TraceId& a, const TraceId& b) {
+    return !(a == b);
+  }
+};
+
+/// Completed span, as passed to `SpanExporter::Export`.
+struct SpanRecord {
+  TraceId trace_id;
+  uint64_t span_id = 0;
+  /// Identifier of the parent span, or `0` for a root span.
+  uint64_t parent_span_id = 0;
+  std::string name;
+  absl::Time start_time;
+  absl::Time end_time;
+  std::vector<SpanAttribute> attributes;
+  absl::Status status;
+};
+
+/// Returns the OpenTelemetry (OTLP) JSON encoding of `span`.
+std::string SpanRecordToJson(const SpanRecord& span);
+
+/// Receives completed spans.
+class SpanExporter {
+ public:
+  virtual ~SpanExporter();
+
+  /// Called when a sampled span ends.  May be called concurrently from
+  /// multiple threads.
+  virtual void Export(SpanRecord span) = 0;
+};
+
+/// Returns an exporter that logs the `SpanRecordToJson` encoding of each
+/// span.
+std::shared_ptr<SpanExporter> MakeLoggingSpanExporter();
+
+/// Enables tracing, passing completed spans to `exporter`.
+///
+/// \param exporter Non-null exporter.
+/// \param sample_rate Probability, in `[0, 1]`, with which each trace is
+///     sampled.
+void EnableTracing(std::shared_ptr<SpanExporter> exporter,
+                   double sample_rate = 1.0);
+
+/// Disables tracing.  Spans that are already in progress are still exported
+/// to the prior exporter when they end.
+void DisableTracing();
+
+/// Indicates whether tracing is enabled.  Only accessed by `TraceSpan`.
+ABSL_CONST_INIT inline std::atomic<bool> tracing_enabled{false};
+
+/// Returns the W3C `traceparent` header value identifying the current span,
+/// or `std::nullopt` if the current span is not sampled.
+std::optional<std::string> GetCurrentTraceparent();
+
+/// Span measuring an operation.
+///
+/// Upon construction, the span is started as a child of the current span, and
+/// becomes the current span of this thread until it is detached or ended.
+/// Spans must be detached or ended on the thread on which they were
+/// started, in the reverse order in which they were started.
+class TraceSpan {
+ public:
+  /// Starts a span named `name`, which should be a string literal.
+  explicit TraceSpan(std::string_view name) {
+    if (ABSL_PREDICT_FALSE(current_span != nullptr ||
+                           tracing_enabled.load(std::memory_order_relaxed))) {
+      Start(name, {});
+    }
+  }
+
+  /// Starts a span named `name` to which `io_accounting`, if non-null, is
+  /// attached.  The span is started even if tracing is disabled, such that
+  /// the accounting is inherited by descendant spans.
+  TraceSpan(std::string_view name,
+            internal::IntrusivePtr<IoAccounting> io_accounting) {
+    if (ABSL_PREDICT_FALSE(io_accounting || current_span != nullptr ||
+                           tracing_enabled.load(std::memory_order_relaxed))) {
+      Start(name, std::move(io_accounting));
+    }
+  }
+
+  /// Moves the span, detaching it from this thread.
+  TraceSpan(TraceSpan&& other) noexcept;
+  TraceSpan& operator=(TraceSpan&& other) = delete;
+
+  /// Ends the span, if not already ended.
+  ~TraceSpan() {
+    if (state_) End();
+  }
+
+  /// Indicates whether the span is being recorded.  If `false`, attributes
+  /// and the status are ignored.
+  bool active() const { return state_ && IsSampled(*state_); }
+
+  /// Sets an attribute of the span.
+  ///
+  /// String, integer, floating point and `bool` values are supported.
+  template <typename T>
+  void SetAttribute(std::string_view name, T&& value) {
+    if (!active()) return;
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+      AddAttribute(name, SpanAttributeValue(std::in_place_type<bool>, value));
+    } else if constexpr (std::is_integral_v<U>) {
+      AddAttribute(name, SpanAttributeValue(std::in_place_type<int64_t>,
+                                            static_cast<int64_t>(value)));
+    } else if constexpr (std::is_floating_point_v<U>) {
+      AddAttribute(name, SpanAttributeValue(std::in_place_type<double>,
+                                            static_cast<double>(value)));
+    } else {
+      AddAttribute(name,
+                   SpanAttributeValue(std::in_place_type<std::string>,
+                                      std::string(std::string_view(value))));
+    }
+  }
+
+  /// Sets the status of the span.
+  void SetStatus(const absl::Status& status);
+
+  /// Restores the span that was current when this span was started, without
+  /// ending this span.  The span may then be moved to, and ended by, a
+  /// callback that runs on another thread.
+  void Detach();
+
+  /// Ends the span, detaching it if necessary.
+  void End();
+
+ private:
+  void Start(std::string_view name,
+             internal::IntrusivePtr<IoAccounting> io_accounting);
+  static bool IsSampled(const SpanState& state);
+  void AddAttribute(std::string_view name, SpanAttributeValue value);
+
+  internal::IntrusivePtr<SpanState> state_;
+  // Span that was current when this span was started, owning a reference.
+  SpanState* previous_ = nullptr;
+  bool attached_ = false;
+};
+
+/// Ends `span` when `future` becomes ready, recording the status of its
+/// result, and returns `future`.
+template <typename FutureType>
+FutureType EndWhenReady(TraceSpan span, FutureType future) {
+  if (!span.active()) return future;
+  span.Detach();
+  future.ExecuteWhenReady([span = std::move(span)](auto ready) mutable {
+    span.SetStatus(ready.status());
+    span.End();
+  });
+  return future;
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TRACING_TRACE_SPAN_H_
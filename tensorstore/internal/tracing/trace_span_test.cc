@@ -0,0 +1,218 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/trace_span.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/io_accounting.h"
+#include "tensorstore/internal/tracing/tracing.h"
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::internal::MakeIntrusivePtr;
+using ::tensorstore::internal_tracing::AddIoAccounting;
+using ::tensorstore::internal_tracing::current_span;
+using ::tensorstore::internal_tracing::DisableTracing;
+using ::tensorstore::internal_tracing::EnableTracing;
+using ::tensorstore::internal_tracing::EndWhenReady;
+using ::tensorstore::internal_tracing::GetCurrentIoAccounting;
+using ::tensorstore::internal_tracing::GetCurrentTraceparent;
+using ::tensorstore::internal_tracing::IoAccounting;
+using ::tensorstore::internal_tracing::SpanExporter;
+using ::tensorstore::internal_tracing::SpanRecord;
+using ::tensorstore::internal_tracing::SpanRecordToJson;
+using ::tensorstore::internal_tracing::SwapCurrentTraceContext;
+using ::tensorstore::internal_tracing::TraceContext;
+using ::tensorstore::internal_tracing::TraceSpan;
+
+class TestExporter : public SpanExporter {
+ public:
+  void Export(SpanRecord span) override {
+    absl::MutexLock lock(&mutex_);
+    spans_.push_back(std::move(span));
+  }
+
+  std::vector<SpanRecord> spans() {
+    absl::MutexLock lock(&mutex_);
+    return spans_;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::vector<SpanRecord> spans_;
+};
+
+class TraceSpanTest : public ::testing::Test {
+ protected:
+  ~TraceSpanTest() override { DisableTracing(); }
+
+  std::shared_ptr<TestExporter> exporter_ = std::make_shared<TestExporter>();
+};
+
+TEST_F(TraceSpanTest, Disabled) {
+  {
+    TraceSpan span("a");
+    EXPECT_FALSE(span.active());
+    EXPECT_EQ(nullptr, current_span);
+    EXPECT_EQ(std::nullopt, GetCurrentTraceparent());
+  }
+  EXPECT_EQ(nullptr, current_span);
+}
+
+TEST_F(TraceSpanTest, ParentChild) {
+  EnableTracing(exporter_);
+  {
+    TraceSpan parent("parent");
+    ASSERT_TRUE(parent.active());
+    parent.SetAttribute("key", std::string("value"));
+    {
+      TraceSpan child("child");
+      child.SetAttribute("size", 5);
+      child.SetStatus(absl::UnknownError("failed"));
+    }
+  }
+  EXPECT_EQ(nullptr, current_span);
+  auto spans = exporter_->spans();
+  ASSERT_EQ(2, spans.size());
+  const auto& child = spans[0];
+  const auto& parent = spans[1];
+  EXPECT_EQ("child", child.name);
+  EXPECT_EQ("parent", parent.name);
+  EXPECT_EQ(parent.trace_id, child.trace_id);
+  EXPECT_EQ(parent.span_id, child.parent_span_id);
+  EXPECT_EQ(0, parent.parent_span_id);
+  EXPECT_NE(parent.span_id, child.span_id);
+  EXPECT_EQ(absl::UnknownError("failed"), child.status);
+  EXPECT_TRUE(parent.status.ok());
+  ASSERT_EQ(1, parent.attributes.size());
+  EXPECT_EQ("key", parent.attributes[0].name);
+
+  auto j = ::nlohmann::json::parse(SpanRecordToJson(child));
+  EXPECT_EQ("child", j["name"]);
+  EXPECT_EQ(16, j["spanId"].get<std::string>().size());
+  EXPECT_EQ(32, j["traceId"].get<std::string>().size());
+  EXPECT_EQ(j["attributes"][0]["value"]["intValue"], "5");
+  EXPECT_EQ(2, j["status"]["code"]);
+}
+
+TEST_F(TraceSpanTest, Traceparent) {
+  EnableTracing(exporter_);
+  TraceSpan span("a");
+  auto traceparent = GetCurrentTraceparent();
+  ASSERT_TRUE(traceparent);
+  EXPECT_THAT(*traceparent,
+              ::testing::MatchesRegex("00-[0-9a-f]{32}-[0-9a-f]{16}-01"));
+}
+
+TEST_F(TraceSpanTest, ContextPropagation) {
+  EnableTracing(exporter_);
+  std::optional<TraceContext> context;
+  {
+    TraceSpan parent("parent");
+    context.emplace(TraceContext::kThread);
+  }
+  EXPECT_EQ(nullptr, current_span);
+  // Simulate running deferred work with the captured context.
+  SwapCurrentTraceContext(&*context);
+  { TraceSpan child("child"); }
+  SwapCurrentTraceContext(&*context);
+  EXPECT_EQ(nullptr, current_span);
+
+  auto spans = exporter_->spans();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ("parent", spans[0].name);
+  EXPECT_EQ("child", spans[1].name);
+  EXPECT_EQ(spans[0].span_id, spans[1].parent_span_id);
+}
+
+TEST_F(TraceSpanTest, EndWhenReady) {
+  EnableTracing(exporter_);
+  auto pair = PromiseFuturePair<int>::Make();
+  {
+    TraceSpan span("op");
+    auto future = EndWhenReady(std::move(span), pair.future);
+    EXPECT_EQ(nullptr, current_span);
+  }
+  EXPECT_TRUE(exporter_->spans().empty());
+  pair.promise.SetResult(absl::NotFoundError("missing"));
+  auto spans = exporter_->spans();
+  ASSERT_EQ(1, spans.size());
+  EXPECT_EQ("op", spans[0].name);
+  EXPECT_EQ(absl::NotFoundError("missing"), spans[0].status);
+}
+
+TEST_F(TraceSpanTest, NotSampled) {
+  EnableTracing(exporter_, /*sample_rate=*/0);
+  {
+    TraceSpan parent("parent");
+    EXPECT_FALSE(parent.active());
+    TraceSpan child("child");
+    EXPECT_FALSE(child.active());
+    EXPECT_EQ(std::nullopt, GetCurrentTraceparent());
+  }
+  EXPECT_EQ(nullptr, current_span);
+  EXPECT_TRUE(exporter_->spans().empty());
+}
+
+TEST_F(TraceSpanTest, IoAccounting) {
+  auto accounting = MakeIntrusivePtr<IoAccounting>();
+  std::optional<TraceContext> context;
+  {
+    // Accounting does not require tracing to be enabled.
+    TraceSpan span("op", accounting);
+    EXPECT_FALSE(span.active());
+    EXPECT_EQ(accounting.get(), GetCurrentIoAccounting());
+    {
+      TraceSpan child("child");
+      AddIoAccounting(&IoAccounting::bytes_fetched, 5);
+    }
+    context.emplace(TraceContext::kThread);
+  }
+  EXPECT_EQ(nullptr, GetCurrentIoAccounting());
+  AddIoAccounting(&IoAccounting::bytes_fetched, 100);
+
+  // Deferred work is attributed to the operation.
+  SwapCurrentTraceContext(&*context);
+  AddIoAccounting(&IoAccounting::bytes_fetched, 2);
+  SwapCurrentTraceContext(&*context);
+  EXPECT_EQ(7, accounting->bytes_fetched);
+}
+
+TEST_F(TraceSpanTest, IoAccountingSampled) {
+  EnableTracing(exporter_);
+  auto accounting = MakeIntrusivePtr<IoAccounting>();
+  {
+    TraceSpan parent("parent");
+    TraceSpan span("op", accounting);
+    EXPECT_TRUE(span.active());
+    TraceSpan child("child");
+    EXPECT_EQ(accounting.get(), GetCurrentIoAccounting());
+  }
+  EXPECT_EQ(3, exporter_->spans().size());
+}
+
+}  // namespace
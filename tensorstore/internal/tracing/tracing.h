@@ -15,19 +15,64 @@
 #ifndef TENSORSTORE_INTERNAL_TRACING_TRACING_H_
 #define TENSORSTORE_INTERNAL_TRACING_TRACING_H_
 
+/// \file
+///
+/// Propagation of the tracing context across asynchronous boundaries.
+///
+/// Spans are created by `TraceSpan`, defined in `trace_span.h`.
+
 #include <utility>
 
+#include "absl/base/attributes.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+
 namespace tensorstore {
 namespace internal_tracing {
 
-struct TraceContext {
+/// State of a span, defined in `trace_span.cc`.
+struct SpanState;
+void intrusive_ptr_increment(SpanState* p);
+void intrusive_ptr_decrement(SpanState* p);
+
+/// Span that is current on this thread, or `nullptr`.  Owns a reference.
+///
+/// Only accessed by `TraceContext`, `SwapCurrentTraceContext`, and
+/// `TraceSpan`.
+ABSL_CONST_INIT inline thread_local SpanState* current_span = nullptr;
+
+/// Tracing context, identifying the span to which work is attributed.
+///
+/// The current context is captured when work is deferred, such as when a
+/// `Future` callback is registered or a task is submitted to an executor, and
+/// is installed by `SwapCurrentTraceContext` while the work runs.  Spans
+/// started by the deferred work are then children of the span that was
+/// current when it was deferred.
+///
+/// When tracing is disabled, the context is always empty, and capturing and
+/// swapping it copies only a null pointer.
+class TraceContext {
+ public:
   struct ThreadInitType {};
   inline static constexpr ThreadInitType kThread{};
-  explicit TraceContext(ThreadInitType) {}
+
+  /// Captures the current context of this thread.
+  explicit TraceContext(ThreadInitType) : span_(current_span) {}
   TraceContext() = delete;
+
+ private:
+  friend void SwapCurrentTraceContext(TraceContext* context);
+  internal::IntrusivePtr<SpanState> span_;
 };
 
-inline void SwapCurrentTraceContext(TraceContext* context) {}
+/// Exchanges `*context` with the current context of this thread.
+///
+/// Calling this before and after running deferred work runs the work in the
+/// captured context, and then restores the prior context.
+inline void SwapCurrentTraceContext(TraceContext* context) {
+  SpanState* span = context->span_.release();
+  context->span_.reset(current_span, internal::adopt_object_ref);
+  current_span = span;
+}
 
 }  // namespace internal_tracing
 }  // namespace tensorstore
@@ -0,0 +1,361 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/vectorized_conversion.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+
+#include "absl/base/attributes.h"
+#include "absl/base/internal/endian.h"
+#include <half.hpp>
+#include "tensorstore/index.h"
+#include "tensorstore/util/bfloat16.h"
+
+#if !defined(TENSORSTORE_DISABLE_F16C) && defined(__x86_64__) && \
+    (defined(__clang__) || defined(__GNUC__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define TENSORSTORE_INTERNAL_F16C_DISPATCH 1
+#endif
+
+// `TENSORSTORE_INTERNAL_TARGET_CLONES` compiles a function for each of the
+// specified instruction sets, and an ifunc resolver selects the version for the
+// host CPU when the program is loaded.  This relies on ifunc support, which is
+// only available for ELF targets.
+#if !defined(TENSORSTORE_DISABLE_TARGET_CLONES) && defined(__x86_64__) && \
+    defined(__linux__) && ABSL_HAVE_ATTRIBUTE(target_clones)
+#define TENSORSTORE_INTERNAL_TARGET_CLONES \
+  __attribute__((target_clones("avx2", "default")))
+#else
+#define TENSORSTORE_INTERNAL_TARGET_CLONES
+#endif
+
+#if defined(__clang__) || defined(__GNUC__)
+#define TENSORSTORE_INTERNAL_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define TENSORSTORE_INTERNAL_RESTRICT __restrict
+#else
+#define TENSORSTORE_INTERNAL_RESTRICT
+#endif
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+// GCC only vectorizes loops at `-O2` if the trip count is known at compile
+// time, so each kernel processes fixed-size blocks of elements followed by the
+// remaining elements.
+constexpr Index kBlockSize = 32;
+
+template <typename T>
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline T ByteSwap(T x) {
+  if constexpr (sizeof(T) == 2) {
+    return absl::gbswap_16(x);
+  } else if constexpr (sizeof(T) == 4) {
+    return absl::gbswap_32(x);
+  } else {
+    return absl::gbswap_64(x);
+  }
+}
+
+template <typename T>
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void SwapEndianBlock(
+    const unsigned char* TENSORSTORE_INTERNAL_RESTRICT source,
+    unsigned char* TENSORSTORE_INTERNAL_RESTRICT dest, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    T x;
+    std::memcpy(&x, source + i * sizeof(T), sizeof(T));
+    x = ByteSwap(x);
+    std::memcpy(dest + i * sizeof(T), &x, sizeof(T));
+  }
+}
+
+template <typename T>
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void SwapEndianInplaceBlock(
+    unsigned char* data, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    T x;
+    std::memcpy(&x, data + i * sizeof(T), sizeof(T));
+    x = ByteSwap(x);
+    std::memcpy(data + i * sizeof(T), &x, sizeof(T));
+  }
+}
+
+template <typename T>
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void SwapEndianLoop(const void* source,
+                                                        void* dest,
+                                                        Index count) {
+  auto* d = static_cast<unsigned char*>(dest);
+  Index i = 0;
+  // The in-place case is handled separately since `source` and `dest` may not
+  // be marked `restrict`.
+  if (source == dest) {
+    for (; i + kBlockSize <= count; i += kBlockSize) {
+      SwapEndianInplaceBlock<T>(d + i * sizeof(T), kBlockSize);
+    }
+    SwapEndianInplaceBlock<T>(d + i * sizeof(T), count - i);
+    return;
+  }
+  auto* s = static_cast<const unsigned char*>(source);
+  for (; i + kBlockSize <= count; i += kBlockSize) {
+    SwapEndianBlock<T>(s + i * sizeof(T), d + i * sizeof(T), kBlockSize);
+  }
+  SwapEndianBlock<T>(s + i * sizeof(T), d + i * sizeof(T), count - i);
+}
+
+template <typename From, typename To>
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void ConvertBlock(
+    const From* TENSORSTORE_INTERNAL_RESTRICT from,
+    To* TENSORSTORE_INTERNAL_RESTRICT to, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    to[i] = static_cast<To>(from[i]);
+  }
+}
+
+template <typename From, typename To>
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void ConvertLoop(const From* from, To* to,
+                                                     Index count) {
+  Index i = 0;
+  for (; i + kBlockSize <= count; i += kBlockSize) {
+    ConvertBlock(from + i, to + i, kBlockSize);
+  }
+  ConvertBlock(from + i, to + i, count - i);
+}
+
+TENSORSTORE_INTERNAL_TARGET_CLONES
+void SwapEndian16(const void* source, void* dest, Index count) {
+  SwapEndianLoop<uint16_t>(source, dest, count);
+}
+
+TENSORSTORE_INTERNAL_TARGET_CLONES
+void SwapEndian32(const void* source, void* dest, Index count) {
+  SwapEndianLoop<uint32_t>(source, dest, count);
+}
+
+TENSORSTORE_INTERNAL_TARGET_CLONES
+void SwapEndian64(const void* source, void* dest, Index count) {
+  SwapEndianLoop<uint64_t>(source, dest, count);
+}
+
+}  // namespace
+
+template <>
+void SwapEndianContiguous<2>(const void* source, void* dest, Index count) {
+  SwapEndian16(source, dest, count);
+}
+
+template <>
+void SwapEndianContiguous<4>(const void* source, void* dest, Index count) {
+  SwapEndian32(source, dest, count);
+}
+
+template <>
+void SwapEndianContiguous<8>(const void* source, void* dest, Index count) {
+  SwapEndian64(source, dest, count);
+}
+
+// Each specialization forwards to a non-template function to which
+// `TENSORSTORE_INTERNAL_TARGET_CLONES` is applied.
+#define TENSORSTORE_INTERNAL_DEFINE_VECTORIZED_CONVERSION(From, To)         \
+  namespace {                                                               \
+  TENSORSTORE_INTERNAL_TARGET_CLONES                                        \
+  void Convert_##From##_##To(const From* from, To* to, Index count) {       \
+    ConvertLoop(from, to, count);                                           \
+  }                                                                         \
+  }                                                                         \
+  template <>                                                               \
+  void ConvertContiguous<From, To>(const From* from, To* to, Index count) { \
+    Convert_##From##_##To(from, to, count);                                 \
+  }                                                                         \
+  /**/
+
+TENSORSTORE_INTERNAL_FOR_EACH_VECTORIZED_CONVERSION(
+    TENSORSTORE_INTERNAL_DEFINE_VECTORIZED_CONVERSION)
+
+#undef TENSORSTORE_INTERNAL_DEFINE_VECTORIZED_CONVERSION
+
+namespace {
+
+// The bfloat16 conversions operate on the bit representations, which allows
+// them to be auto-vectorized.  The AVX512-BF16 `vcvtneps2bf16` instruction is
+// not used since it flushes subnormals to zero and does not preserve
+// signaling NaN, unlike `BFloat16`.
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void Bfloat16ToFloatBlock(
+    const BFloat16* TENSORSTORE_INTERNAL_RESTRICT from,
+    float* TENSORSTORE_INTERNAL_RESTRICT to, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    uint16_t x;
+    std::memcpy(&x, from + i, sizeof(x));
+    const uint32_t y = static_cast<uint32_t>(x) << 16;
+    std::memcpy(to + i, &y, sizeof(y));
+  }
+}
+
+// Branch-free equivalent of `internal::Float32ToBfloat16RoundNearestEven`.
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void FloatToBfloat16Block(
+    const float* TENSORSTORE_INTERNAL_RESTRICT from,
+    BFloat16* TENSORSTORE_INTERNAL_RESTRICT to, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    uint32_t x;
+    std::memcpy(&x, from + i, sizeof(x));
+    const uint32_t rounded = x + 0x7fff + ((x >> 16) & 1);
+    const uint32_t nan = x | 0x00200000u;
+    const uint16_t y = static_cast<uint16_t>(
+        ((x & 0x7fffffffu) > 0x7f800000u ? nan : rounded) >> 16);
+    std::memcpy(to + i, &y, sizeof(y));
+  }
+}
+
+TENSORSTORE_INTERNAL_TARGET_CLONES
+void ConvertBfloat16ToFloat(const BFloat16* from, float* to, Index count) {
+  Index i = 0;
+  for (; i + kBlockSize <= count; i += kBlockSize) {
+    Bfloat16ToFloatBlock(from + i, to + i, kBlockSize);
+  }
+  Bfloat16ToFloatBlock(from + i, to + i, count - i);
+}
+
+TENSORSTORE_INTERNAL_TARGET_CLONES
+void ConvertFloatToBfloat16(const float* from, BFloat16* to, Index count) {
+  Index i = 0;
+  for (; i + kBlockSize <= count; i += kBlockSize) {
+    FloatToBfloat16Block(from + i, to + i, kBlockSize);
+  }
+  FloatToBfloat16Block(from + i, to + i, count - i);
+}
+
+using ::half_float::half;
+
+#if defined(__aarch64__) && (defined(__clang__) || defined(__GNUC__))
+
+// The AArch64 conversion instructions round to nearest even and quiet NaN
+// values, like `half_float::half`, and loops over `__fp16` are vectorized
+// using `fcvtl`/`fcvtn`.
+void ConvertHalfToFloat(const half* from, float* to, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    __fp16 x;
+    std::memcpy(&x, from + i, sizeof(x));
+    to[i] = static_cast<float>(x);
+  }
+}
+
+void ConvertFloatToHalf(const float* from, half* to, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    const __fp16 y = static_cast<__fp16>(from[i]);
+    std::memcpy(to + i, &y, sizeof(y));
+  }
+}
+
+#else
+
+void ConvertHalfToFloatGeneric(const half* from, float* to, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    to[i] = static_cast<float>(from[i]);
+  }
+}
+
+void ConvertFloatToHalfGeneric(const float* from, half* to, Index count) {
+  for (Index i = 0; i < count; ++i) {
+    to[i] = static_cast<half>(from[i]);
+  }
+}
+
+#if defined(TENSORSTORE_INTERNAL_F16C_DISPATCH)
+
+// `vcvtph2ps` and `vcvtps2ph` (with round-to-nearest-even) produce the same
+// results as `half_float::half`, which itself uses them when compiled with
+// `-mf16c`.  Since F16C is not part of the x86-64 baseline, support is
+// checked at run time.
+bool HasF16c() {
+  unsigned int eax, ebx, ecx, edx;
+  return __builtin_cpu_supports("avx") &&
+         __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_F16C);
+}
+
+__attribute__((target("avx,f16c"))) void ConvertHalfToFloatF16c(
+    const half* from, float* to, Index count) {
+  Index i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(to + i, _mm256_cvtph_ps(_mm_loadu_si128(
+                                 reinterpret_cast<const __m128i*>(from + i))));
+  }
+  ConvertHalfToFloatGeneric(from + i, to + i, count - i);
+}
+
+__attribute__((target("avx,f16c"))) void ConvertFloatToHalfF16c(
+    const float* from, half* to, Index count) {
+  Index i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i),
+                     _mm256_cvtps_ph(_mm256_loadu_ps(from + i),
+                                     _MM_FROUND_TO_NEAREST_INT));
+  }
+  ConvertFloatToHalfGeneric(from + i, to + i, count - i);
+}
+
+void ConvertHalfToFloat(const half* from, float* to, Index count) {
+  static const auto impl =
+      HasF16c() ? &ConvertHalfToFloatF16c : &ConvertHalfToFloatGeneric;
+  impl(from, to, count);
+}
+
+void ConvertFloatToHalf(const float* from, half* to, Index count) {
+  static const auto impl =
+      HasF16c() ? &ConvertFloatToHalfF16c : &ConvertFloatToHalfGeneric;
+  impl(from, to, count);
+}
+
+#else
+
+void ConvertHalfToFloat(const half* from, float* to, Index count) {
+  ConvertHalfToFloatGeneric(from, to, count);
+}
+
+void ConvertFloatToHalf(const float* from, half* to, Index count) {
+  ConvertFloatToHalfGeneric(from, to, count);
+}
+
+#endif  // defined(TENSORSTORE_INTERNAL_F16C_DISPATCH)
+#endif  // defined(__aarch64__)
+
+}  // namespace
+
+template <>
+void ConvertContiguous<BFloat16, float>(const BFloat16* from, float* to,
+                                        Index count) {
+  ConvertBfloat16ToFloat(from, to, count);
+}
+
+template <>
+void ConvertContiguous<float, BFloat16>(const float* from, BFloat16* to,
+                                        Index count) {
+  ConvertFloatToBfloat16(from, to, count);
+}
+
+template <>
+void ConvertContiguous<half, float>(const half* from, float* to, Index count) {
+  ConvertHalfToFloat(from, to, count);
+}
+
+template <>
+void ConvertContiguous<float, half>(const float* from, half* to, Index count) {
+  ConvertFloatToHalf(from, to, count);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
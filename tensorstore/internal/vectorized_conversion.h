@@ -0,0 +1,122 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_VECTORIZED_CONVERSION_H_
+#define TENSORSTORE_INTERNAL_VECTORIZED_CONVERSION_H_
+
+/// \file
+///
+/// Out-of-line kernels for byte swapping and numeric conversion of contiguous
+/// arrays.
+///
+/// These are used by the `ApplyContiguous` members of the element-wise
+/// functions for endian conversion and data type conversion.  Where supported
+/// (currently GCC and Clang targeting x86-64 Linux), each kernel is compiled
+/// for multiple instruction sets and the best version for the host CPU is
+/// selected at load time.  Otherwise, a single version that relies on
+/// auto-vectorization for the baseline instruction set is used.
+///
+/// Conversions between `float16_t` and `float` use the F16C instructions if
+/// they are supported by the host CPU (x86-64), or the native `__fp16` type
+/// (AArch64).
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tensorstore/index.h"
+
+namespace half_float {
+class half;
+}  // namespace half_float
+
+namespace tensorstore {
+class BFloat16;
+namespace internal {
+
+/// Swaps the byte order of `count` contiguous `ElementSize`-byte values.
+///
+/// There is no alignment requirement on `source` or `dest`.  `source` and
+/// `dest` must either be equal or not overlap.
+///
+/// \tparam ElementSize Size in bytes of each value, must be 2, 4, or 8.
+template <size_t ElementSize>
+void SwapEndianContiguous(const void* source, void* dest, Index count);
+
+template <>
+void SwapEndianContiguous<2>(const void* source, void* dest, Index count);
+template <>
+void SwapEndianContiguous<4>(const void* source, void* dest, Index count);
+template <>
+void SwapEndianContiguous<8>(const void* source, void* dest, Index count);
+
+// Invokes `X(From, To)` for each pair of types for which a vectorized
+// `ConvertContiguous` kernel is defined.
+#define TENSORSTORE_INTERNAL_FOR_EACH_VECTORIZED_CONVERSION(X) \
+  X(int8_t, float)                                             \
+  X(uint8_t, float)                                            \
+  X(int16_t, float)                                            \
+  X(uint16_t, float)                                           \
+  X(int32_t, float)                                            \
+  X(uint32_t, float)                                           \
+  X(int8_t, double)                                            \
+  X(uint8_t, double)                                           \
+  X(int16_t, double)                                           \
+  X(uint16_t, double)                                          \
+  X(int32_t, double)                                           \
+  X(uint32_t, double)                                          \
+  X(float, int8_t)                                             \
+  X(float, uint8_t)                                            \
+  X(float, int16_t)                                            \
+  X(float, uint16_t)                                           \
+  X(float, int32_t)                                            \
+  X(double, int32_t)                                           \
+  X(float, double)                                             \
+  X(double, float)                                             \
+  /**/
+
+/// Specifies whether `ConvertContiguous<From, To>` is defined.
+template <typename From, typename To>
+constexpr inline bool HasVectorizedConversion = false;
+
+/// Converts `count` contiguous values using `static_cast<To>`.
+///
+/// `from` and `to` must not overlap.
+template <typename From, typename To>
+void ConvertContiguous(const From* from, To* to, Index count);
+
+#define TENSORSTORE_INTERNAL_DECLARE_VECTORIZED_CONVERSION(From, To)         \
+  template <>                                                              \
+  constexpr inline bool HasVectorizedConversion<From, To> = true;          \
+  template <>                                                              \
+  void ConvertContiguous<From, To>(const From* from, To* to, Index count); \
+  /**/
+
+TENSORSTORE_INTERNAL_FOR_EACH_VECTORIZED_CONVERSION(
+    TENSORSTORE_INTERNAL_DECLARE_VECTORIZED_CONVERSION)
+
+// Conversions between `float` and the 16-bit floating point types.  The
+// results are identical to `static_cast<To>`, including for subnormals; NaN
+// values are converted to NaN values of the same sign.
+TENSORSTORE_INTERNAL_DECLARE_VECTORIZED_CONVERSION(BFloat16, float)
+TENSORSTORE_INTERNAL_DECLARE_VECTORIZED_CONVERSION(float, BFloat16)
+TENSORSTORE_INTERNAL_DECLARE_VECTORIZED_CONVERSION(::half_float::half, float)
+TENSORSTORE_INTERNAL_DECLARE_VECTORIZED_CONVERSION(float, ::half_float::half)
+
+#undef TENSORSTORE_INTERNAL_DECLARE_VECTORIZED_CONVERSION
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_VECTORIZED_CONVERSION_H_
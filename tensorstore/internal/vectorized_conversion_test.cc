@@ -0,0 +1,214 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/vectorized_conversion.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/base/internal/endian.h"
+#include <half.hpp>
+#include "tensorstore/index.h"
+#include "tensorstore/util/bfloat16.h"
+
+namespace {
+
+using ::tensorstore::BFloat16;
+using ::tensorstore::Index;
+using ::tensorstore::internal::ConvertContiguous;
+using ::tensorstore::internal::SwapEndianContiguous;
+
+// Counts that exercise both the blocked loop and the remainder loop.
+constexpr Index kCounts[] = {0, 1, 7, 32, 33, 100};
+
+template <typename T>
+T ByteSwap(T x) {
+  if constexpr (sizeof(T) == 2) {
+    return absl::gbswap_16(x);
+  } else if constexpr (sizeof(T) == 4) {
+    return absl::gbswap_32(x);
+  } else {
+    return absl::gbswap_64(x);
+  }
+}
+
+template <typename T>
+void TestSwapEndian() {
+  for (Index count : kCounts) {
+    SCOPED_TRACE(count);
+    std::vector<T> values(count);
+    for (Index i = 0; i < count; ++i) {
+      values[i] = static_cast<T>(0x0102030405060708 * (i + 1));
+    }
+    // Use an odd offset to test unaligned access.
+    std::vector<unsigned char> source(count * sizeof(T) + 1);
+    std::vector<unsigned char> dest(count * sizeof(T) + 1);
+    if (count) std::memcpy(source.data() + 1, values.data(), count * sizeof(T));
+    SwapEndianContiguous<sizeof(T)>(source.data() + 1, dest.data() + 1, count);
+    for (Index i = 0; i < count; ++i) {
+      T x;
+      std::memcpy(&x, dest.data() + 1 + i * sizeof(T), sizeof(T));
+      EXPECT_EQ(ByteSwap(values[i]), x) << i;
+    }
+
+    // In-place.
+    SwapEndianContiguous<sizeof(T)>(source.data() + 1, source.data() + 1,
+                                    count);
+    EXPECT_EQ(source, dest);
+  }
+}
+
+TEST(SwapEndianContiguousTest, Size2) { TestSwapEndian<uint16_t>(); }
+TEST(SwapEndianContiguousTest, Size4) { TestSwapEndian<uint32_t>(); }
+TEST(SwapEndianContiguousTest, Size8) { TestSwapEndian<uint64_t>(); }
+
+template <typename From, typename To>
+void TestConvert(From start, From step) {
+  for (Index count : kCounts) {
+    SCOPED_TRACE(count);
+    std::vector<From> from(count);
+    for (Index i = 0; i < count; ++i) {
+      from[i] = static_cast<From>(start + step * static_cast<From>(i));
+    }
+    std::vector<To> to(count);
+    ConvertContiguous(from.data(), to.data(), count);
+    for (Index i = 0; i < count; ++i) {
+      EXPECT_EQ(static_cast<To>(from[i]), to[i]) << i;
+    }
+  }
+}
+
+TEST(ConvertContiguousTest, IntegerToFloat) {
+  TestConvert<int8_t, float>(-50, 1);
+  TestConvert<uint8_t, float>(0, 2);
+  TestConvert<int16_t, float>(-30000, 600);
+  TestConvert<uint16_t, float>(0, 650);
+  TestConvert<int32_t, float>(-2000000000, 40000003);
+  TestConvert<uint32_t, float>(0, 40000003);
+  TestConvert<int8_t, double>(-50, 1);
+  TestConvert<uint8_t, double>(0, 2);
+  TestConvert<int16_t, double>(-30000, 600);
+  TestConvert<uint16_t, double>(0, 650);
+  TestConvert<int32_t, double>(-2000000000, 40000003);
+  TestConvert<uint32_t, double>(0, 40000003);
+}
+
+TEST(ConvertContiguousTest, FloatToInteger) {
+  TestConvert<float, int8_t>(-50.5f, 1.25f);
+  TestConvert<float, uint8_t>(0.5f, 2.5f);
+  TestConvert<float, int16_t>(-30000.5f, 600.25f);
+  TestConvert<float, uint16_t>(0.5f, 650.25f);
+  TestConvert<float, int32_t>(-2000000000.0f, 40000000.0f);
+  TestConvert<double, int32_t>(-2000000000.5, 40000000.25);
+}
+
+TEST(ConvertContiguousTest, FloatToFloat) {
+  TestConvert<float, double>(-1.0e30f, 1.5e28f);
+  TestConvert<double, float>(-1.0e30, 1.5e28);
+  TestConvert<double, float>(0.1, 0.3);
+}
+
+template <typename T>
+uint32_t GetBits(T x) {
+  if constexpr (sizeof(T) == 2) {
+    uint16_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+  } else {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+  }
+}
+
+// Checks that `ConvertContiguous` matches `static_cast` bit for bit, except
+// that NaN values are only required to remain NaN values of the same sign.
+template <typename From, typename To>
+void TestConvertFloat16(const std::vector<From>& values) {
+  for (Index count : kCounts) {
+    SCOPED_TRACE(count);
+    std::vector<From> from(count);
+    for (Index i = 0; i < count; ++i) {
+      from[i] = values[i % values.size()];
+    }
+    std::vector<To> to(count);
+    ConvertContiguous(from.data(), to.data(), count);
+    for (Index i = 0; i < count; ++i) {
+      const To expected = static_cast<To>(from[i]);
+      if (std::isnan(static_cast<float>(expected))) {
+        EXPECT_TRUE(std::isnan(static_cast<float>(to[i]))) << i;
+        EXPECT_EQ(std::signbit(static_cast<float>(expected)),
+                  std::signbit(static_cast<float>(to[i])))
+            << i;
+      } else {
+        EXPECT_EQ(GetBits(expected), GetBits(to[i])) << i;
+      }
+    }
+  }
+}
+
+std::vector<float> GetFloatTestValues() {
+  return {0.0f,
+          -0.0f,
+          1.0f,
+          -2.5f,
+          3.14159265f,
+          1.0009765625f,  // Tie in float16.
+          1.00390625f,    // Tie in bfloat16.
+          65504.0f,
+          65520.0f,  // Rounds to infinity in float16.
+          1e-5f,
+          6e-8f,   // Subnormal in float16.
+          1e-40f,  // Subnormal in float32 and bfloat16.
+          3.4e38f,
+          std::numeric_limits<float>::infinity(),
+          -std::numeric_limits<float>::infinity(),
+          std::numeric_limits<float>::quiet_NaN(),
+          -std::numeric_limits<float>::quiet_NaN(),
+          std::numeric_limits<float>::signaling_NaN()};
+}
+
+TEST(ConvertContiguousTest, Bfloat16) {
+  auto values = GetFloatTestValues();
+  TestConvertFloat16<float, BFloat16>(values);
+  std::vector<BFloat16> bfloat16_values;
+  for (float x : values) bfloat16_values.push_back(static_cast<BFloat16>(x));
+  TestConvertFloat16<BFloat16, float>(bfloat16_values);
+}
+
+TEST(ConvertContiguousTest, Bfloat16PreservesNaN) {
+  // Unlike some hardware conversions, signaling NaN is preserved.
+  const float from[] = {std::numeric_limits<float>::signaling_NaN()};
+  BFloat16 to[1];
+  ConvertContiguous(from, to, 1);
+  EXPECT_EQ(GetBits(static_cast<BFloat16>(from[0])), GetBits(to[0]));
+}
+
+TEST(ConvertContiguousTest, Float16) {
+  using ::half_float::half;
+  auto values = GetFloatTestValues();
+  TestConvertFloat16<float, half>(values);
+  std::vector<half> half_values;
+  for (float x : values) half_values.push_back(static_cast<half>(x));
+  TestConvertFloat16<half, float>(half_values);
+}
+
+}  // namespace
@@ -0,0 +1,142 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/iterate_chunks.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/chunk_order_iterator.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace {
+
+/// State of an in-progress `IterateChunks` operation.
+class ChunkIterationState
+    : public internal::AtomicReferenceCount<ChunkIterationState> {
+ public:
+  using Ptr = internal::IntrusivePtr<ChunkIterationState>;
+
+  ChunkIterationState(TensorStore<> store, const ChunkLayout& chunk_layout,
+                      IterateChunksCallback callback,
+                      IterateChunksOptions options, Promise<void> promise)
+      : store_(std::move(store)),
+        callback_(std::move(callback)),
+        max_in_flight_(std::max(size_t(1), options.max_in_flight)),
+        promise_(std::move(promise)),
+        iterator_(store_.domain().box(), chunk_layout) {}
+
+  /// Issues reads until `max_in_flight` reads are outstanding or all chunks
+  /// have been requested.
+  ///
+  /// If called recursively, e.g. because a read completed synchronously, the
+  /// outer call continues issuing reads.
+  static void IssueReads(Ptr self) {
+    {
+      absl::MutexLock lock(&self->mutex_);
+      if (self->issuing_) return;
+      self->issuing_ = true;
+    }
+    while (true) {
+      Box<> bounds;
+      bool issue = false, finished = false;
+      {
+        absl::MutexLock lock(&self->mutex_);
+        if (self->promise_.result_needed() && !self->iterator_.AtEnd() &&
+            self->in_flight_ < self->max_in_flight_) {
+          bounds = self->iterator_.Next();
+          ++self->in_flight_;
+          issue = true;
+        } else {
+          self->issuing_ = false;
+          if (self->in_flight_ == 0 && self->iterator_.AtEnd() &&
+              !self->finished_) {
+            self->finished_ = finished = true;
+          }
+        }
+      }
+      if (!issue) {
+        if (finished) self->promise_.SetResult(absl::OkStatus());
+        return;
+      }
+      tensorstore::Read(self->store_ | AllDims().BoxSlice(bounds))
+          .ExecuteWhenReady(
+              [self, bounds = std::move(bounds)](
+                  ReadyFuture<SharedOffsetArray<void>> future) {
+                self->OnRead(bounds, future.result());
+                IssueReads(self);
+              });
+    }
+  }
+
+ private:
+  void OnRead(BoxView<> bounds,
+              const Result<SharedOffsetArray<void>>& result) {
+    absl::Status status = result.status();
+    if (status.ok() && promise_.result_needed()) {
+      status = callback_(bounds, *result);
+    }
+    if (!status.ok()) {
+      promise_.SetResult(MaybeAnnotateStatus(
+          status, tensorstore::StrCat("Processing chunk ", bounds)));
+    }
+    absl::MutexLock lock(&mutex_);
+    --in_flight_;
+  }
+
+  TensorStore<> store_;
+  IterateChunksCallback callback_;
+  const size_t max_in_flight_;
+  Promise<void> promise_;
+
+  absl::Mutex mutex_;
+  internal::ChunkOrderIterator iterator_ ABSL_GUARDED_BY(mutex_);
+  size_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Set while a call to `IssueReads` is issuing reads.
+  bool issuing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace
+
+Future<void> IterateChunks(TensorStore<> store, IterateChunksCallback callback,
+                           IterateChunksOptions options) {
+  if (!IsFinite(store.domain().box())) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Cannot iterate over chunks of unbounded domain ", store.domain()));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto chunk_layout, store.chunk_layout());
+  auto [promise, future] = PromiseFuturePair<void>::Make();
+  ChunkIterationState::IssueReads(
+      internal::MakeIntrusivePtr<ChunkIterationState>(
+          std::move(store), chunk_layout, std::move(callback), options,
+          std::move(promise)));
+  return std::move(future);
+}
+
+}  // namespace tensorstore
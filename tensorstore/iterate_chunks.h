@@ -0,0 +1,79 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_ITERATE_CHUNKS_H_
+#define TENSORSTORE_ITERATE_CHUNKS_H_
+
+/// \file
+/// Chunk-aligned iteration over the entire domain of a TensorStore.
+
+#include <stddef.h>
+
+#include <functional>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+
+/// Options for `IterateChunks`.
+///
+/// \relates IterateChunks
+struct IterateChunksOptions {
+  /// Maximum number of chunks that are read concurrently.  Memory usage is
+  /// proportional to this value times the size of a read chunk.
+  size_t max_in_flight = 16;
+};
+
+/// Callback invoked by `IterateChunks` for each chunk.
+///
+/// \relates IterateChunks
+using IterateChunksCallback =
+    std::function<absl::Status(BoxView<> bounds, SharedOffsetArray<void> data)>;
+
+/// Reads the entire domain of `store` one read chunk at a time.
+///
+/// The domain is partitioned according to the read chunk grid of
+/// `store.chunk_layout()`.  Chunks are requested in storage order: the write
+/// chunks (e.g. shards) are visited in lexicographical order, and within each
+/// write chunk, the read chunks are visited in lexicographical order.  Since
+/// each requested region is aligned to a single read chunk, each chunk is
+/// decoded exactly once.
+///
+/// Up to `options.max_in_flight` chunks are read concurrently, and `callback`
+/// is invoked with the bounds and data of each chunk as soon as it has been
+/// read, which need not be in the order in which the chunks were requested.
+/// The `callback` may be invoked concurrently from multiple threads.
+///
+/// Dimensions for which the chunk layout does not specify a chunk size are not
+/// partitioned.
+///
+/// \param store The TensorStore to read, must have a bounded domain.
+/// \param callback Invoked for each chunk.  If it returns an error, iteration
+///     stops and the returned future fails with that error.
+/// \param options Iteration options.
+/// \returns A future that becomes ready when all chunks have been processed,
+///     or an error occurs.
+/// \error `absl::StatusCode::kInvalidArgument` if the domain of `store` is not
+///     bounded.
+/// \relates TensorStore
+Future<void> IterateChunks(TensorStore<> store, IterateChunksCallback callback,
+                           IterateChunksOptions options = {});
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_ITERATE_CHUNKS_H_
@@ -0,0 +1,134 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/iterate_chunks.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
+#include "tensorstore/open.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::BoxView;
+using ::tensorstore::Index;
+using ::tensorstore::IterateChunks;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::SharedOffsetArray;
+using ::tensorstore::TensorStore;
+
+TensorStore<> CreateShardedStore() {
+  auto store = tensorstore::Open(
+                   {
+                       {"driver", "zarr3"},
+                       {"kvstore", "memory://"},
+                       {"metadata",
+                        {
+                            {"data_type", "uint16"},
+                            {"shape", {6, 7}},
+                            {"chunk_grid",
+                             {{"name", "regular"},
+                              {"configuration", {{"chunk_shape", {4, 4}}}}}},
+                            {"codecs",
+                             {
+                                 {{"name", "sharding_indexed"},
+                                  {"configuration", {{"chunk_shape", {2, 2}}}}},
+                             }},
+                        }},
+                   },
+                   tensorstore::OpenMode::create)
+                   .value();
+  auto array = tensorstore::AllocateArray<uint16_t>({6, 7});
+  for (Index i = 0; i < 6; ++i) {
+    for (Index j = 0; j < 7; ++j) {
+      array(i, j) = static_cast<uint16_t>(i * 100 + j);
+    }
+  }
+  TENSORSTORE_CHECK_OK(tensorstore::Write(array, store).result());
+  return store;
+}
+
+TEST(IterateChunksTest, StorageOrder) {
+  auto store = CreateShardedStore();
+  std::vector<Box<>> boxes;
+  TENSORSTORE_ASSERT_OK(
+      IterateChunks(
+          store,
+          [&](BoxView<> bounds, SharedOffsetArray<void> data) {
+            EXPECT_EQ(bounds, data.domain());
+            auto array =
+                tensorstore::StaticDataTypeCast<uint16_t>(data).value();
+            for (Index i = bounds[0].inclusive_min();
+                 i <= bounds[0].inclusive_max(); ++i) {
+              for (Index j = bounds[1].inclusive_min();
+                   j <= bounds[1].inclusive_max(); ++j) {
+                EXPECT_EQ(i * 100 + j, array(i, j));
+              }
+            }
+            boxes.emplace_back(bounds);
+            return absl::OkStatus();
+          },
+          {/*.max_in_flight=*/1})
+          .result());
+  // Inner chunks of the first shard, followed by the inner chunks of the other
+  // shards.
+  EXPECT_THAT(boxes, ::testing::ElementsAre(
+                         Box({0, 0}, {2, 2}), Box({0, 2}, {2, 2}),
+                         Box({2, 0}, {2, 2}), Box({2, 2}, {2, 2}),
+                         Box({0, 4}, {2, 2}), Box({0, 6}, {2, 1}),
+                         Box({2, 4}, {2, 2}), Box({2, 6}, {2, 1}),
+                         Box({4, 0}, {2, 2}), Box({4, 2}, {2, 2}),
+                         Box({4, 4}, {2, 2}), Box({4, 6}, {2, 1})));
+}
+
+TEST(IterateChunksTest, Concurrent) {
+  auto store = CreateShardedStore();
+  absl::Mutex mutex;
+  Index num_elements = 0;
+  TENSORSTORE_ASSERT_OK(
+      IterateChunks(store,
+                    [&](BoxView<> bounds, SharedOffsetArray<void> data) {
+                      absl::MutexLock lock(&mutex);
+                      num_elements += bounds.num_elements();
+                      return absl::OkStatus();
+                    })
+          .result());
+  EXPECT_EQ(6 * 7, num_elements);
+}
+
+TEST(IterateChunksTest, CallbackError) {
+  auto store = CreateShardedStore();
+  EXPECT_THAT(
+      IterateChunks(store,
+                    [&](BoxView<> bounds, SharedOffsetArray<void> data) {
+                      return absl::UnknownError("failed");
+                    })
+          .result(),
+      MatchesStatus(absl::StatusCode::kUnknown, "Processing chunk .*: failed"));
+}
+
+}  // namespace
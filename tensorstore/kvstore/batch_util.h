@@ -392,6 +392,32 @@ constexpr CoalescingOptions kDefaultRemoteStorageCoalescingOptions = {
     /*.target_coalesced_size=*/128 * 1024 * 10248,
 };
 
+// For local storage, reads are served in units of pages by the operating
+// system, so gaps of up to a page are effectively free.  The target size is
+// kept smaller than for remote storage, since the per-request overhead is low
+// and separate reads may proceed in parallel.
+constexpr CoalescingOptions kDefaultLocalStorageCoalescingOptions = {
+    /*.max_extra_read_bytes=*/4095,
+    /*.target_coalesced_size=*/8 * 1024 * 1024,
+};
+
+// For remote storage accessed over connections which multiplex requests, such
+// as HTTP/2, an additional request costs little more than its headers rather
+// than a connection, so only small gaps are filled, and large coalesced reads
+// are avoided in favor of concurrent streams.
+constexpr CoalescingOptions kMultiplexedRemoteStorageCoalescingOptions = {
+    /*.max_extra_read_bytes=*/511,
+    /*.target_coalesced_size=*/16 * 1024 * 1024,
+};
+
+// Returns the coalescing options for remote storage accessed over connections
+// which multiplex up to `max_concurrent_streams` requests.
+constexpr CoalescingOptions GetRemoteStorageCoalescingOptions(
+    int64_t max_concurrent_streams) {
+  return max_concurrent_streams > 1 ? kMultiplexedRemoteStorageCoalescingOptions
+                                    : kDefaultRemoteStorageCoalescingOptions;
+}
+
 }  // namespace internal_kvstore_batch
 }  // namespace tensorstore
 
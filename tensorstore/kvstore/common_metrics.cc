@@ -0,0 +1,80 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/common_metrics.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/metrics/histogram.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+namespace {
+
+using OperationHistogram =
+    internal_metrics::ShardedHistogram<internal_metrics::DefaultBucketer,
+                                       std::string, std::string>;
+
+auto& kvstore_latency_ms = OperationHistogram::New(
+    "/tensorstore/kvstore/latency_ms", "driver", "op",
+    "kvstore operation latency (ms), by driver and operation");
+
+auto& kvstore_queue_latency_ms = OperationHistogram::New(
+    "/tensorstore/kvstore/queue_latency_ms", "driver", "op",
+    "kvstore operation time (ms) spent queued before being issued, by driver "
+    "and operation");
+
+auto& kvstore_service_latency_ms = OperationHistogram::New(
+    "/tensorstore/kvstore/service_latency_ms", "driver", "op",
+    "kvstore operation time (ms) spent being serviced, by driver and "
+    "operation");
+
+auto& kvstore_bytes = OperationHistogram::New(
+    "/tensorstore/kvstore/bytes", "driver", "op",
+    "Bytes transferred per kvstore operation, by driver and operation");
+
+}  // namespace
+
+void RecordOperationLatency(std::string_view driver_id,
+                            std::string_view operation,
+                            absl::Duration latency) {
+  kvstore_latency_ms.Observe(absl::ToDoubleMilliseconds(latency), driver_id,
+                             operation);
+}
+
+void RecordOperationBytes(std::string_view driver_id,
+                          std::string_view operation, int64_t bytes) {
+  kvstore_bytes.Observe(bytes, driver_id, operation);
+}
+
+void KvStoreOperationTimer::StartService() {
+  auto now = absl::Now();
+  kvstore_queue_latency_ms.Observe(
+      absl::ToDoubleMilliseconds(now - start_time_), driver_id_, operation_);
+  start_time_ = now;
+}
+
+void KvStoreOperationTimer::FinishService() {
+  kvstore_service_latency_ms.Observe(
+      absl::ToDoubleMilliseconds(absl::Now() - start_time_), driver_id_,
+      operation_);
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
@@ -0,0 +1,90 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_COMMON_METRICS_H_
+#define TENSORSTORE_KVSTORE_COMMON_METRICS_H_
+
+/// \file
+///
+/// Metrics recorded consistently for all key-value store drivers.
+///
+/// All metrics are labeled by the driver identifier (`Driver::driver_id`) and
+/// the operation (`"read"`, `"write"` or `"delete_range"`):
+///
+/// - `/tensorstore/kvstore/latency_ms`: end-to-end latency, recorded by
+///   `kvstore::Read`, `kvstore::Write` and `kvstore::DeleteRange`.
+///
+/// - `/tensorstore/kvstore/bytes`: bytes read or written per operation.
+///
+/// - `/tensorstore/kvstore/queue_latency_ms` and
+///   `/tensorstore/kvstore/service_latency_ms`: time spent waiting to be
+///   issued, e.g. in an admission queue or executor, and time spent being
+///   serviced.  Recorded by drivers via `KvStoreOperationTimer`.
+
+#include <stdint.h>
+
+#include <string_view>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Records the end-to-end latency of an operation.
+void RecordOperationLatency(std::string_view driver_id,
+                            std::string_view operation,
+                            absl::Duration latency);
+
+/// Records the number of bytes transferred by an operation.
+void RecordOperationBytes(std::string_view driver_id,
+                          std::string_view operation, int64_t bytes);
+
+/// Records the queue and service latency of a single driver operation.
+///
+/// Example usage:
+///
+///     KvStoreOperationTimer timer("file", "read");
+///     executor([timer]() mutable {
+///       timer.StartService();
+///       ...
+///       timer.FinishService();
+///     });
+class KvStoreOperationTimer {
+ public:
+  /// Starts timing the queue latency.
+  ///
+  /// \param driver_id Driver identifier, which must remain valid.
+  /// \param operation Operation name, which must remain valid.
+  KvStoreOperationTimer(std::string_view driver_id, std::string_view operation)
+      : driver_id_(driver_id),
+        operation_(operation),
+        start_time_(absl::Now()) {}
+
+  /// Records the queue latency, and starts timing the service latency.
+  void StartService();
+
+  /// Records the service latency.
+  void FinishService();
+
+ private:
+  std::string_view driver_id_;
+  std::string_view operation_;
+  absl::Time start_time_;
+};
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_COMMON_METRICS_H_
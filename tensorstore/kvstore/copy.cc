@@ -12,40 +12,239 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+/// Copies (or incrementally synchronizes) all keys from one kvstore to
+/// another.
+///
+/// The source is listed as `--list_partitions` disjoint key ranges in
+/// parallel, and up to `--concurrency` keys are transferred at a time.  With
+/// `--incremental`, keys that already exist in the target with the same size
+/// (and, with `--checksum`, the same contents) are skipped.  With
+/// `--checkpoint`, each copied key is recorded in a local file, and keys
+/// recorded by a previous, interrupted run are skipped.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
 #include "absl/status/status.h"
+#include "absl/strings/escaping.h"
 #include "absl/synchronization/mutex.h"
-#include "absl/flags/parse.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/json_binding/std_optional.h"
-#include "tensorstore/internal/path.h"
 #include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/json_absl_flag.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 
 ABSL_FLAG(tensorstore::JsonAbslFlag<std::optional<tensorstore::kvstore::Spec>>,
           source, std::nullopt, "Source kvstore");
 ABSL_FLAG(tensorstore::JsonAbslFlag<std::optional<tensorstore::kvstore::Spec>>,
           target, std::nullopt, "Target kvstore");
+ABSL_FLAG(int, concurrency, 64, "Maximum number of keys copied concurrently");
+ABSL_FLAG(int, list_partitions, 16,
+          "Number of key ranges, split by the first byte of the key, that are "
+          "listed in parallel (at most 256)");
+ABSL_FLAG(bool, incremental, false,
+          "Skip keys that already exist in the target with the same size");
+ABSL_FLAG(bool, checksum, false,
+          "With --incremental, also compare the contents of keys whose sizes "
+          "match, and skip only those that are identical");
+ABSL_FLAG(std::string, checkpoint, "",
+          "Local file in which copied keys are recorded; keys recorded by a "
+          "previous run are skipped");
+ABSL_FLAG(bool, verbose, false, "Log each key that is copied");
 
 namespace tensorstore {
 
 namespace {
 
-Result<int> RunCopy() {
-  static absl::Mutex log_mutex;
+/// Returns `num_partitions` disjoint key ranges that together cover all keys.
+///
+/// The ranges are split by the first byte of the key, which requires no
+/// knowledge of the key distribution.
+std::vector<KeyRange> PartitionKeys(int num_partitions) {
+  num_partitions = std::clamp(num_partitions, 1, 256);
+  std::vector<KeyRange> ranges;
+  std::string inclusive_min;
+  for (int i = 1; i <= num_partitions; ++i) {
+    std::string exclusive_max =
+        (i == num_partitions)
+            ? std::string()
+            : std::string(1, static_cast<char>(i * 256 / num_partitions));
+    ranges.emplace_back(std::exchange(inclusive_min, exclusive_max),
+                        exclusive_max);
+  }
+  return ranges;
+}
+
+/// Append-only log of the keys that have been copied, one C-escaped key per
+/// line.
+class Checkpoint {
+ public:
+  absl::Status Open(const std::string& path) {
+    {
+      std::ifstream in(path);
+      for (std::string line; std::getline(in, line);) {
+        // A final line without a newline may have been truncated by an
+        // interrupted run, and is ignored.
+        if (in.eof()) break;
+        std::string key;
+        if (absl::CUnescape(line, &key)) done_.insert(std::move(key));
+      }
+    }
+    out_.open(path, std::ios::app);
+    if (!out_) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Failed to open checkpoint file: ", QuoteString(path)));
+    }
+    return absl::OkStatus();
+  }
+
+  bool Contains(std::string_view key) const { return done_.contains(key); }
+  size_t size() const { return done_.size(); }
+
+  void Record(std::string_view key) {
+    if (!out_.is_open()) return;
+    out_ << absl::CEscape(key) << '\n';
+    // Bound the work that is repeated if the copy is interrupted.
+    if (++unflushed_ >= 1000) Flush();
+  }
+
+  void Flush() {
+    if (!out_.is_open()) return;
+    out_.flush();
+    unflushed_ = 0;
+  }
+
+ private:
+  absl::flat_hash_set<std::string> done_;
+  std::ofstream out_;
+  int unflushed_ = 0;
+};
+
+/// State shared by the listing receivers, the copy loop, and the copy
+/// callbacks.
+struct CopyState {
+  absl::Mutex mutex;
+  std::deque<kvstore::ListEntry> pending ABSL_GUARDED_BY(mutex);
+  int active_listings ABSL_GUARDED_BY(mutex) = 0;
+  int in_flight ABSL_GUARDED_BY(mutex) = 0;
+  absl::Status list_status ABSL_GUARDED_BY(mutex);
+  Checkpoint checkpoint ABSL_GUARDED_BY(mutex);
+
+  int64_t num_copied ABSL_GUARDED_BY(mutex) = 0;
+  int64_t num_skipped ABSL_GUARDED_BY(mutex) = 0;
+  int64_t num_failed ABSL_GUARDED_BY(mutex) = 0;
+  int64_t bytes_copied ABSL_GUARDED_BY(mutex) = 0;
+};
+
+/// Queues the entries listed for one partition of the source.
+struct PartitionListReceiver {
+  CopyState* state;
+
+  void set_starting(AnyCancelReceiver cancel) {}
+
+  void set_value(kvstore::ListEntry entry) {
+    absl::MutexLock lock(&state->mutex);
+    state->pending.push_back(std::move(entry));
+  }
+
+  void set_error(absl::Status error) {
+    absl::MutexLock lock(&state->mutex);
+    state->list_status.Update(error);
+  }
+
+  void set_done() {}
+
+  void set_stopping() {
+    absl::MutexLock lock(&state->mutex);
+    --state->active_listings;
+  }
+};
 
+/// Copies `key` from `source` to `target`.
+///
+/// Returns the number of bytes written, or `std::nullopt` if nothing was
+/// written because the key no longer exists in `source` or, if
+/// `compare_contents` is `true`, `target` already holds the same value.
+Future<std::optional<int64_t>> CopyKey(const KvStore& source,
+                                       const KvStore& target, std::string key,
+                                       bool compare_contents) {
+  auto write = [target, key](const kvstore::ReadResult& source_read,
+                             const kvstore::ReadResult* target_read)
+      -> Future<std::optional<int64_t>> {
+    if (!source_read.has_value()) return std::optional<int64_t>();
+    if (target_read && target_read->has_value() &&
+        target_read->value == source_read.value) {
+      return std::optional<int64_t>();
+    }
+    const int64_t size = source_read.value.size();
+    return MapFutureValue(
+        InlineExecutor{},
+        [size](const TimestampedStorageGeneration&) {
+          return std::optional<int64_t>(size);
+        },
+        kvstore::Write(target, key, source_read.value));
+  };
+  if (!compare_contents) {
+    return MapFutureValue(
+        InlineExecutor{},
+        [write](const kvstore::ReadResult& source_read) {
+          return write(source_read, nullptr);
+        },
+        kvstore::Read(source, key));
+  }
+  return MapFutureValue(
+      InlineExecutor{},
+      [write](const kvstore::ReadResult& source_read,
+              const kvstore::ReadResult& target_read) {
+        return write(source_read, &target_read);
+      },
+      kvstore::Read(source, key), kvstore::Read(target, key));
+}
+
+/// Lists `store` in parallel over `partitions`, returning the size of each
+/// key, or -1 if the size is not reported by the driver.
+Result<absl::flat_hash_map<std::string, int64_t>> ListSizes(
+    const KvStore& store, const std::vector<KeyRange>& partitions) {
+  std::vector<Future<std::vector<kvstore::ListEntry>>> futures;
+  for (const auto& range : partitions) {
+    futures.push_back(kvstore::ListFuture(store, {range}));
+  }
+  absl::flat_hash_map<std::string, int64_t> sizes;
+  for (auto& future : futures) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto entries, future.result());
+    for (auto& entry : entries) {
+      sizes.emplace(std::move(entry.key), entry.size);
+    }
+  }
+  return sizes;
+}
+
+Result<int> RunCopy() {
   auto source_spec = absl::GetFlag(FLAGS_source).value;
   if (!source_spec) {
     return absl::InvalidArgumentError("Must specify --source");
@@ -54,65 +253,121 @@ Result<int> RunCopy() {
   if (!target_spec) {
     return absl::InvalidArgumentError("Must specify --target");
   }
+  const int concurrency = absl::GetFlag(FLAGS_concurrency);
+  if (concurrency < 1) {
+    return absl::InvalidArgumentError("--concurrency must be positive");
+  }
+  const bool incremental = absl::GetFlag(FLAGS_incremental);
+  const bool checksum = absl::GetFlag(FLAGS_checksum);
+  const bool verbose = absl::GetFlag(FLAGS_verbose);
 
   TENSORSTORE_ASSIGN_OR_RETURN(auto source,
                                kvstore::Open(*source_spec).result());
   TENSORSTORE_ASSIGN_OR_RETURN(auto target,
                                kvstore::Open(*target_spec).result());
 
-  TENSORSTORE_ASSIGN_OR_RETURN(auto list_entries,
-                               kvstore::ListFuture(source).result());
+  const auto partitions = PartitionKeys(absl::GetFlag(FLAGS_list_partitions));
 
-  std::vector<Future<const void>> write_futures;
+  CopyState state;
+  if (auto path = absl::GetFlag(FLAGS_checkpoint); !path.empty()) {
+    absl::MutexLock lock(&state.mutex);
+    TENSORSTORE_RETURN_IF_ERROR(state.checkpoint.Open(path));
+    std::cout << "Resuming after " << state.checkpoint.size()
+              << " previously copied keys" << std::endl;
+  }
 
-  for (const auto& entry : list_entries) {
-    std::string key = entry.key;
-    write_futures.push_back(MapFutureValue(
-        InlineExecutor{},
-        [&](const Result<kvstore::ReadResult>& read_result) -> Future<void> {
-          if (!read_result.ok()) {
-            absl::MutexLock lock(&log_mutex);
-            std::cout << "Error reading: " << tensorstore::QuoteString(key)
-                      << ": " << read_result.status() << std::endl;
+  absl::flat_hash_map<std::string, int64_t> target_sizes;
+  if (incremental) {
+    TENSORSTORE_ASSIGN_OR_RETURN(target_sizes, ListSizes(target, partitions),
+                                 tensorstore::MaybeAnnotateStatus(
+                                     _, "Listing target for --incremental"));
+  }
+
+  const absl::Time start_time = absl::Now();
+  {
+    absl::MutexLock lock(&state.mutex);
+    state.active_listings = partitions.size();
+  }
+  for (const auto& range : partitions) {
+    kvstore::ListOptions options;
+    options.range = range;
+    kvstore::List(source, std::move(options), PartitionListReceiver{&state});
+  }
+
+  while (true) {
+    kvstore::ListEntry entry;
+    bool compare_contents = false;
+    {
+      absl::MutexLock lock(&state.mutex);
+      auto can_proceed = [&] {
+        return state.pending.empty()
+                   ? state.active_listings == 0
+                   : state.in_flight < concurrency;
+      };
+      state.mutex.Await(absl::Condition(&can_proceed));
+      if (state.pending.empty()) break;
+      entry = std::move(state.pending.front());
+      state.pending.pop_front();
+      if (state.checkpoint.Contains(entry.key)) {
+        ++state.num_skipped;
+        continue;
+      }
+      if (incremental) {
+        auto it = target_sizes.find(entry.key);
+        if (it != target_sizes.end() && entry.has_size() &&
+            it->second == entry.size) {
+          if (!checksum) {
+            ++state.num_skipped;
+            state.checkpoint.Record(entry.key);
+            continue;
           }
-          if (!read_result->has_value()) {
-            return absl::OkStatus();
+          compare_contents = true;
+        }
+      }
+      ++state.in_flight;
+    }
+    CopyKey(source, target, entry.key, compare_contents)
+        .ExecuteWhenReady([&state, verbose, key = entry.key](
+                              ReadyFuture<std::optional<int64_t>> future) {
+          absl::MutexLock lock(&state.mutex);
+          --state.in_flight;
+          auto& result = future.result();
+          if (!result.ok()) {
+            ++state.num_failed;
+            std::cout << "Error copying " << tensorstore::QuoteString(key)
+                      << ": " << result.status() << std::endl;
+            return;
           }
-          {
-            absl::MutexLock lock(&log_mutex);
-            std::cout << "Read: " << tensorstore::QuoteString(key) << std::endl;
+          if (*result) {
+            ++state.num_copied;
+            state.bytes_copied += **result;
+            if (verbose) {
+              std::cout << "Copied: " << tensorstore::QuoteString(key)
+                        << std::endl;
+            }
+          } else {
+            ++state.num_skipped;
           }
-          return MapFuture(
-              InlineExecutor{},
-              [&](const Result<TimestampedStorageGeneration>& stamp)
-                  -> Result<void> {
-                if (!stamp.ok()) {
-                  absl::MutexLock lock(&log_mutex);
-                  std::cout
-                      << "Error writing: " << tensorstore::QuoteString(key)
-                      << ": " << stamp.status() << std::endl;
-                  return stamp.status();
-                }
-                {
-                  absl::MutexLock lock(&log_mutex);
-                  std::cout << "Wrote: " << tensorstore::QuoteString(key)
-                            << std::endl;
-                }
-                return absl::OkStatus();
-              },
-              kvstore::Write(target, key, read_result->value));
-        },
-        kvstore::Read(source, key)));
+          state.checkpoint.Record(key);
+        });
   }
 
-  bool all_ok = true;
-  for (const auto& future : write_futures) {
-    const auto& result = future.result();
-    if (!result.ok()) all_ok = false;
+  absl::MutexLock lock(&state.mutex);
+  auto done = [&] { return state.in_flight == 0; };
+  state.mutex.Await(absl::Condition(&done));
+  state.checkpoint.Flush();
+  const double seconds = absl::ToDoubleSeconds(absl::Now() - start_time);
+  std::cout << "Copied " << state.num_copied << " keys ("
+            << state.bytes_copied << " bytes) in " << seconds << "s, skipped "
+            << state.num_skipped << ", failed " << state.num_failed
+            << std::endl;
+  if (!state.list_status.ok()) {
+    std::cout << "Error listing source: " << state.list_status << std::endl;
+    return 1;
   }
-
-  return all_ok ? 0 : 1;
+  return state.num_failed == 0 ? 0 : 1;
 }
+
 }  // namespace
 }  // namespace tensorstore
 
@@ -126,7 +381,8 @@ int main(int argc, char** argv) {
       std::cerr
           << "Usage: " << argv[0]
           << " --source <source-kvstore-spec> --target <target-kvstore-spec>"
-          << std::endl;
+          << " [--concurrency=N] [--list_partitions=N] [--incremental]"
+          << " [--checksum] [--checkpoint=<file>]" << std::endl;
     }
     return 1;
   }
@@ -0,0 +1,332 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Key-value store adapter which stores each distinct value once, addressed by
+/// its content.
+///
+/// Within the base kvstore, the value for each key `k` is stored as:
+///
+///     index/k          SHA-256 digest of the value, as 64 hex digits
+///     data/<digest>    value
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/digest/sha256.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+using ::tensorstore::kvstore::ListReceiver;
+using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::SupportedFeatures;
+
+auto& dedup_duplicate_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/dedup/duplicate_count",
+    "Number of writes of values already present in the base kvstore.");
+
+constexpr std::string_view kIndexPrefix = "index/";
+constexpr std::string_view kDataPrefix = "data/";
+constexpr size_t kDigestSize = 64;
+
+/// Bounds the memory used to remember which values are already stored.
+constexpr size_t kMaxKnownDigests = 1 << 16;
+
+std::string ComputeDigest(const absl::Cord& value) {
+  internal::SHA256Digester digester;
+  digester.Write(value);
+  auto digest = digester.Digest();
+  return absl::BytesToHexString(std::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+bool IsValidDigest(std::string_view digest) {
+  if (digest.size() != kDigestSize) return false;
+  for (char c : digest) {
+    if (!absl::ascii_isxdigit(c) || absl::ascii_isupper(c)) return false;
+  }
+  return true;
+}
+
+struct DedupKvStoreSpecData {
+  kvstore::Spec base;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.base);
+  };
+
+  constexpr static auto default_json_binder = jb::Object(
+      jb::Member("base", jb::Projection<&DedupKvStoreSpecData::base>()));
+};
+
+class DedupKvStoreSpec
+    : public internal_kvstore::RegisteredDriverSpec<DedupKvStoreSpec,
+                                                    DedupKvStoreSpecData> {
+ public:
+  static constexpr char id[] = "dedup";
+
+  Future<kvstore::DriverPtr> DoOpen() const override;
+
+  absl::Status ApplyOptions(kvstore::DriverSpecOptions&& options) override {
+    return data_.base.driver.Set(std::move(options));
+  }
+};
+
+/// Defines the "dedup" KeyValueStore driver.
+///
+/// Each write stores the digest of the value under the index key, after
+/// storing the value under its digest unless it is already present, such that
+/// writing a value identical to an existing one only updates the index.
+/// Generation conditions and staleness bounds apply to the index keys; the
+/// values, which are immutable, may be read from any cached version.
+///
+/// Values that are no longer referenced by any index key are not deleted.
+class DedupKvStore
+    : public internal_kvstore::RegisteredDriver<DedupKvStore,
+                                                DedupKvStoreSpec> {
+ public:
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override;
+
+  Future<const void> DeleteRange(KeyRange range) override {
+    return kvstore::DeleteRange(index_, std::move(range));
+  }
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override {
+    kvstore::List(index_, std::move(options), std::move(receiver));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    return index_.driver->DescribeKey(tensorstore::StrCat(index_.path, key));
+  }
+
+  absl::Status GetBoundSpecData(DedupKvStoreSpecData& spec) const {
+    spec = spec_data_;
+    return absl::OkStatus();
+  }
+
+  SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    // Values are never modified in place.
+    return index_.driver->GetSupportedFeatures(
+               KeyRange::AddPrefix(index_.path, key_range)) &
+           (SupportedFeatures::kAtomicWriteWithoutOverwrite |
+            SupportedFeatures::kSingleKeyAtomicReadModifyWrite);
+  }
+
+  /// Stores `value` under `digest` unless it is already present.
+  Future<const void> WriteData(std::string digest, absl::Cord value);
+
+  bool IsKnownDigest(const std::string& digest) {
+    absl::MutexLock lock(&mutex_);
+    return known_digests_.contains(digest);
+  }
+
+  void AddKnownDigest(std::string digest) {
+    absl::MutexLock lock(&mutex_);
+    if (known_digests_.size() >= kMaxKnownDigests) known_digests_.clear();
+    known_digests_.insert(std::move(digest));
+  }
+
+  DedupKvStoreSpecData spec_data_;
+  kvstore::KvStore index_;
+  kvstore::KvStore data_;
+
+ private:
+  absl::Mutex mutex_;
+  // Digests of values known to be present in `data_`.
+  absl::flat_hash_set<std::string> known_digests_ ABSL_GUARDED_BY(mutex_);
+};
+
+Future<kvstore::DriverPtr> DedupKvStoreSpec::DoOpen() const {
+  return MapFutureValue(
+      InlineExecutor{},
+      [spec = internal::IntrusivePtr<const DedupKvStoreSpec>(this)](
+          kvstore::KvStore& base) -> Result<kvstore::DriverPtr> {
+        auto driver = internal::MakeIntrusivePtr<DedupKvStore>();
+        driver->spec_data_ = spec->data_;
+        driver->index_ = kvstore::KvStore(
+            base.driver, tensorstore::StrCat(base.path, kIndexPrefix));
+        driver->data_ = kvstore::KvStore(
+            base.driver, tensorstore::StrCat(base.path, kDataPrefix));
+        driver->SetBatchNestingDepth(base.driver->BatchNestingDepth() + 1);
+        return driver;
+      },
+      kvstore::Open(data_.base));
+}
+
+Future<ReadResult> DedupKvStore::Read(Key key, ReadOptions options) {
+  const auto byte_range = options.byte_range;
+  options.byte_range = {};
+  auto index_future =
+      kvstore::Read(index_, std::move(key), std::move(options));
+  return PromiseFuturePair<ReadResult>::LinkValue(
+             [self = internal::IntrusivePtr<DedupKvStore>(this), byte_range](
+                 Promise<ReadResult> promise,
+                 ReadyFuture<ReadResult> ready) {
+               auto& index = ready.value();
+               if (!index.has_value()) {
+                 promise.SetResult(std::move(index));
+                 return;
+               }
+               std::string digest(index.value);
+               if (!IsValidDigest(digest)) {
+                 promise.SetResult(absl::DataLossError(tensorstore::StrCat(
+                     "Invalid digest in index: ", digest)));
+                 return;
+               }
+               kvstore::ReadOptions data_options;
+               data_options.byte_range = byte_range;
+               data_options.staleness_bound = absl::InfinitePast();
+               auto data_future = kvstore::Read(self->data_, digest,
+                                                std::move(data_options));
+               LinkValue(
+                   [self, digest, stamp = std::move(index.stamp)](
+                       Promise<ReadResult> promise,
+                       ReadyFuture<ReadResult> ready) mutable {
+                     auto& data = ready.value();
+                     if (!data.has_value()) {
+                       promise.SetResult(absl::DataLossError(
+                           tensorstore::StrCat("Missing value for digest ",
+                                               digest)));
+                       return;
+                     }
+                     self->AddKnownDigest(std::move(digest));
+                     promise.SetResult(ReadResult::Value(std::move(data.value),
+                                                         std::move(stamp)));
+                   },
+                   std::move(promise), std::move(data_future));
+             },
+             std::move(index_future))
+      .future;
+}
+
+Future<const void> DedupKvStore::WriteData(std::string digest,
+                                           absl::Cord value) {
+  if (IsKnownDigest(digest)) {
+    dedup_duplicate_count.Increment();
+    return MakeReadyFuture();
+  }
+  // Checking for an existing value avoids transferring it again.
+  kvstore::ReadOptions read_options;
+  read_options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+  read_options.staleness_bound = absl::InfinitePast();
+  auto exists_future = kvstore::Read(data_, digest, std::move(read_options));
+  return PromiseFuturePair<void>::LinkValue(
+             [self = internal::IntrusivePtr<DedupKvStore>(this),
+              digest = std::move(digest), value = std::move(value)](
+                 Promise<void> promise,
+                 ReadyFuture<ReadResult> ready) mutable {
+               if (ready.value().has_value()) {
+                 dedup_duplicate_count.Increment();
+                 self->AddKnownDigest(std::move(digest));
+                 promise.SetResult(absl::OkStatus());
+                 return;
+               }
+               // A concurrent write of the same value is harmless, since the
+               // condition fails only if the value is already present.
+               kvstore::WriteOptions write_options;
+               write_options.generation_conditions.if_equal =
+                   StorageGeneration::NoValue();
+               auto write_future = kvstore::Write(self->data_, digest,
+                                                  std::move(value),
+                                                  std::move(write_options));
+               LinkValue(
+                   [self, digest = std::move(digest)](
+                       Promise<void> promise,
+                       ReadyFuture<TimestampedStorageGeneration> ready) {
+                     self->AddKnownDigest(std::move(digest));
+                     promise.SetResult(absl::OkStatus());
+                   },
+                   std::move(promise), std::move(write_future));
+             },
+             std::move(exists_future))
+      .future;
+}
+
+Future<TimestampedStorageGeneration> DedupKvStore::Write(
+    Key key, std::optional<Value> value, WriteOptions options) {
+  if (options.byte_offset) {
+    return absl::UnimplementedError("Byte range writes are not supported");
+  }
+  if (!value) {
+    return kvstore::Write(index_, std::move(key), std::nullopt,
+                          std::move(options));
+  }
+  std::string digest = ComputeDigest(*value);
+  auto data_future = WriteData(digest, std::move(*value));
+  return PromiseFuturePair<TimestampedStorageGeneration>::LinkValue(
+             [self = internal::IntrusivePtr<DedupKvStore>(this),
+              key = std::move(key), digest = std::move(digest),
+              options = std::move(options)](
+                 Promise<TimestampedStorageGeneration> promise,
+                 ReadyFuture<const void> ready) mutable {
+               LinkResult(std::move(promise),
+                          kvstore::Write(self->index_, std::move(key),
+                                         absl::Cord(std::move(digest)),
+                                         std::move(options)));
+             },
+             std::move(data_future))
+      .future;
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(tensorstore::DedupKvStore)
+
+// Registers the driver.
+namespace {
+const tensorstore::internal_kvstore::DriverRegistration<
+    tensorstore::DedupKvStoreSpec>
+    registration;
+}  // namespace
@@ -0,0 +1,147 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal::MatchesListEntry;
+using ::tensorstore::IsOkAndHolds;
+using ::testing::Ne;
+using ::testing::UnorderedElementsAre;
+
+// SHA-256 digest of "value".
+constexpr char kValueDigest[] =
+    "cd42404d52ad55ccfa9aca4adc828aa5800ad9d385a0671fbcbf724118320619";
+
+TEST(DedupTest, Basic) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "dedup"}, {"base", "memory://base/"}}, context)
+          .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(DedupTest, DeleteRange) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "dedup"}, {"base", "memory://base/"}}, context)
+          .result());
+  tensorstore::internal::TestKeyValueStoreDeleteRange(store);
+}
+
+TEST(DedupTest, List) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "dedup"}, {"base", "memory://base/"}}, context)
+          .result());
+  // Listed sizes are those of the index entries.
+  tensorstore::internal::TestKeyValueStoreList(store, /*match_size=*/false);
+}
+
+TEST(DedupTest, SpecRoundtrip) {
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "dedup"},
+      {"base", {{"driver", "memory"}, {"path", "a/"}}},
+  };
+  options.full_base_spec = {{"driver", "memory"}, {"path", "a/"}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(DedupTest, IdenticalValuesStoredOnce) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "dedup"}, {"base", "memory://base/"}}, context)
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base, kvstore::Open("memory://base/", context).result());
+
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("value")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "b", absl::Cord("value")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "c", absl::Cord("other")));
+
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(store, "c").result(),
+              MatchesKvsReadResult(absl::Cord("other")));
+  kvstore::ReadOptions options;
+  options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 3);
+  EXPECT_THAT(kvstore::Read(store, "b", options).result(),
+              MatchesKvsReadResult(absl::Cord("al")));
+
+  EXPECT_THAT(kvstore::Read(base, "index/a").result(),
+              MatchesKvsReadResult(absl::Cord(kValueDigest)));
+  EXPECT_THAT(kvstore::Read(base, std::string("data/") + kValueDigest)
+                  .result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  auto data = base;
+  data.path += "data/";
+  EXPECT_THAT(kvstore::ListFuture(data).result(),
+              IsOkAndHolds(UnorderedElementsAre(
+                  MatchesListEntry(kValueDigest),
+                  MatchesListEntry(Ne(kValueDigest)))));
+
+  // Deleting a key leaves the value in place.
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "a"));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResultNotFound());
+  EXPECT_THAT(kvstore::Read(store, "b").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+}
+
+TEST(DedupTest, CorruptIndex) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "dedup"}, {"base", "memory://base/"}}, context)
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base, kvstore::Open("memory://base/", context).result());
+
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base, "index/a", absl::Cord("xyz")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Invalid digest in index: xyz"));
+
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(base, "index/b", absl::Cord(kValueDigest)));
+  EXPECT_THAT(kvstore::Read(store, "b").result(),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Missing value for digest .*"));
+}
+
+}  // namespace
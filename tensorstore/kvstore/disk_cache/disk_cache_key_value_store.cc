@@ -0,0 +1,673 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+///
+/// Key-value store adapter that keeps a size-bounded persistent cache of the
+/// values read from a base key-value store in a second, typically local,
+/// key-value store.
+///
+/// Each cached value is stored under a key derived from the SHA-256 digest of
+/// the base kvstore spec and the key, along with the key, the
+/// `StorageGeneration` and the time at which the value was known to be
+/// current.  Cached values are used directly when they satisfy the
+/// `staleness_bound` of a read; otherwise they are revalidated by a read from
+/// the base kvstore conditioned on `if_not_equal` of the cached generation,
+/// which avoids transferring the value again if it is unchanged.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/internal/data_copy_concurrency_resource.h"
+#include "tensorstore/internal/digest/sha256.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+/// specializations
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/serialization.h"  // IWYU pragma: keep
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
+
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListReceiver;
+
+namespace tensorstore {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+ABSL_CONST_INIT internal_log::VerboseFlag disk_cache_logging("disk_cache");
+
+auto& disk_cache_hit_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/disk_cache/hit_count",
+    "Number of reads served from the cache without accessing the base "
+    "kvstore.");
+auto& disk_cache_revalidated_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/disk_cache/revalidated_count",
+    "Number of reads served from the cache after revalidating the cached "
+    "generation with the base kvstore.");
+auto& disk_cache_miss_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/disk_cache/miss_count",
+    "Number of reads for which no cached value was available.");
+auto& disk_cache_evict_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/disk_cache/evict_count",
+    "Number of values evicted from the cache.");
+
+// -----------------------------------------------------------------------------
+// Cached value encoding.
+//
+// Each cached value is stored as:
+//
+//     magic (4 bytes): "tsdc"
+//     key_size (uint64le), key
+//     generation_size (uint64le), generation
+//     time (int64le, nanoseconds since the unix epoch)
+//     value
+
+constexpr std::string_view kMagic = "tsdc";
+
+/// Values with longer generations are not cached, which bounds the portion of
+/// a cached value that must be flattened to decode the header.
+constexpr size_t kMaxGenerationSize = 1024;
+
+void AppendUint64(std::string& out, uint64_t x) {
+  for (int i = 0; i < 8; ++i) {
+    out.push_back(static_cast<char>((x >> (8 * i)) & 0xff));
+  }
+}
+
+bool ConsumeUint64(std::string_view& in, uint64_t& x) {
+  if (in.size() < 8) return false;
+  x = 0;
+  for (int i = 0; i < 8; ++i) {
+    x |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  in.remove_prefix(8);
+  return true;
+}
+
+bool ConsumeString(std::string_view& in, std::string_view& s) {
+  uint64_t size;
+  if (!ConsumeUint64(in, size) || in.size() < size) return false;
+  s = in.substr(0, size);
+  in.remove_prefix(size);
+  return true;
+}
+
+struct CachedValue {
+  TimestampedStorageGeneration stamp;
+  absl::Cord value;
+};
+
+absl::Cord EncodeCachedValue(std::string_view key,
+                             const TimestampedStorageGeneration& stamp,
+                             const absl::Cord& value) {
+  std::string header;
+  header.reserve(kMagic.size() + 24 + key.size() +
+                 stamp.generation.value.size());
+  header.append(kMagic);
+  AppendUint64(header, key.size());
+  header.append(key);
+  AppendUint64(header, stamp.generation.value.size());
+  header.append(stamp.generation.value);
+  AppendUint64(header, static_cast<uint64_t>(absl::ToUnixNanos(stamp.time)));
+  absl::Cord encoded(std::move(header));
+  encoded.Append(value);
+  return encoded;
+}
+
+/// Decodes a cached value, returning `std::nullopt` if it is malformed or was
+/// stored for a different key.
+std::optional<CachedValue> DecodeCachedValue(std::string_view key,
+                                             const absl::Cord& encoded) {
+  // Only the header needs to be flattened.
+  const size_t header_limit =
+      std::min(encoded.size(),
+               kMagic.size() + 24 + key.size() + kMaxGenerationSize);
+  std::string header_buffer(encoded.Subcord(0, header_limit));
+  std::string_view header = header_buffer;
+  if (header.substr(0, kMagic.size()) != kMagic) return std::nullopt;
+  header.remove_prefix(kMagic.size());
+  std::string_view stored_key, generation;
+  uint64_t time;
+  if (!ConsumeString(header, stored_key) || stored_key != key ||
+      !ConsumeString(header, generation) || !ConsumeUint64(header, time)) {
+    return std::nullopt;
+  }
+  CachedValue cached;
+  cached.stamp.generation.value = std::string(generation);
+  cached.stamp.time = absl::FromUnixNanos(static_cast<int64_t>(time));
+  if (StorageGeneration::IsUnknown(cached.stamp.generation)) {
+    return std::nullopt;
+  }
+  const size_t header_size = header_buffer.size() - header.size();
+  cached.value = encoded.Subcord(header_size, encoded.size() - header_size);
+  return cached;
+}
+
+/// Cache keys are of the form `"xx/<64 hex digits>"`, where `xx` is the first
+/// byte of the digest, in order to bound the number of entries per directory.
+constexpr size_t kCacheKeySize = 3 + 64;
+
+bool IsCacheKey(std::string_view key) {
+  return key.size() == kCacheKeySize && key[2] == '/' &&
+         key.substr(0, 2) == key.substr(3, 2);
+}
+
+// -----------------------------------------------------------------------------
+
+struct DiskCacheKvStoreSpecData {
+  kvstore::Spec base;
+  kvstore::Spec cache;
+  uint64_t total_bytes_limit;
+  Context::Resource<internal::DataCopyConcurrencyResource>
+      data_copy_concurrency;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.base, x.cache, x.total_bytes_limit, x.data_copy_concurrency);
+  };
+
+  constexpr static auto default_json_binder = jb::Object(
+      jb::Member("base", jb::Projection<&DiskCacheKvStoreSpecData::base>()),
+      jb::Member("cache", jb::Projection<&DiskCacheKvStoreSpecData::cache>()),
+      jb::Member(
+          "total_bytes_limit",
+          jb::Projection<&DiskCacheKvStoreSpecData::total_bytes_limit>()),
+      jb::Member(
+          internal::DataCopyConcurrencyResource::id,
+          jb::Projection<&DiskCacheKvStoreSpecData::data_copy_concurrency>()) /**/
+  );
+};
+
+class DiskCacheKvStoreSpec
+    : public internal_kvstore::RegisteredDriverSpec<DiskCacheKvStoreSpec,
+                                                    DiskCacheKvStoreSpecData> {
+ public:
+  static constexpr char id[] = "disk_cache";
+
+  Future<kvstore::DriverPtr> DoOpen() const override;
+
+  absl::Status ApplyOptions(kvstore::DriverSpecOptions&& options) override {
+    return data_.base.driver.Set(std::move(options));
+  }
+
+  Result<kvstore::Spec> GetBase(std::string_view path) const override {
+    kvstore::Spec base = data_.base;
+    base.AppendSuffix(path);
+    return base;
+  }
+};
+
+/// Defines the "disk_cache" key value store.
+class DiskCacheKvStore
+    : public internal_kvstore::RegisteredDriver<DiskCacheKvStore,
+                                                DiskCacheKvStoreSpec> {
+ public:
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override;
+
+  Future<const void> DeleteRange(KeyRange range) override;
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override;
+
+  std::string DescribeKey(std::string_view key) override {
+    return base_.driver->DescribeKey(tensorstore::StrCat(base_.path, key));
+  }
+
+  absl::Status GetBoundSpecData(DiskCacheKvStoreSpecData& spec) const {
+    spec = spec_data_;
+    return absl::OkStatus();
+  }
+
+  kvstore::SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    // Written values are cached whole, so partial writes are not supported.
+    return base_.driver->GetSupportedFeatures(
+               KeyRange::AddPrefix(base_.path, key_range)) &
+           ~kvstore::SupportedFeatures::kByteRangeWrite;
+  }
+
+  Result<KvStore> GetBase(std::string_view path,
+                          const Transaction& transaction) const override {
+    return KvStore(base_.driver, tensorstore::StrCat(base_.path, path),
+                   transaction);
+  }
+
+  const Executor& executor() const {
+    return spec_data_.data_copy_concurrency->executor;
+  }
+
+  /// Returns the key under which the value for `key` is cached.
+  std::string GetCacheKey(std::string_view key) const;
+
+  /// Populates the index from the entries already present in the cache.
+  void InitializeIndex(std::vector<ListEntry> entries);
+
+  /// Returns the time at which the cached value for `cache_key` was last
+  /// validated by this driver, or `std::nullopt` if it is not cached.
+  ///
+  /// Marks the entry as most recently used.
+  std::optional<absl::Time> LookupIndexEntry(const std::string& cache_key);
+
+  /// Records that the cached value for `cache_key` was validated at `time`.
+  void UpdateValidatedTime(const std::string& cache_key, absl::Time time);
+
+  /// Writes `value` to the cache.
+  void StoreCachedValue(std::string_view key, std::string cache_key,
+                        const TimestampedStorageGeneration& stamp,
+                        const absl::Cord& value);
+
+  /// Removes the cached value for `cache_key`, if any.
+  void EraseCachedValue(std::string cache_key);
+
+  DiskCacheKvStoreSpecData spec_data_;
+  kvstore::KvStore base_;
+  kvstore::KvStore cache_;
+
+  /// Identifies the base kvstore in the cache keys, such that a single cache
+  /// may be shared by multiple base kvstores.
+  std::string base_identifier_;
+
+ private:
+  struct IndexEntry {
+    size_t size;
+    absl::Time validated_time;
+    std::list<std::string>::iterator lru_it;
+  };
+
+  /// Adds or replaces an index entry, and returns the cache keys to evict.
+  std::vector<std::string> AddIndexEntry(std::string cache_key, size_t size,
+                                         absl::Time validated_time)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  void EvictCachedValues(std::vector<std::string> cache_keys);
+
+  absl::Mutex mutex_;
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<std::string, IndexEntry> index_ ABSL_GUARDED_BY(mutex_);
+  // Front is the least recently used entry, which is evicted first.
+  std::list<std::string> lru_ ABSL_GUARDED_BY(mutex_);
+};
+
+std::string DiskCacheKvStore::GetCacheKey(std::string_view key) const {
+  internal::SHA256Digester digester;
+  digester.Write(base_identifier_);
+  digester.Write(std::string_view("\0", 1));
+  digester.Write(key);
+  auto digest = digester.Digest();
+  std::string hex = absl::BytesToHexString(std::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+  return tensorstore::StrCat(hex.substr(0, 2), "/", hex);
+}
+
+void DiskCacheKvStore::InitializeIndex(std::vector<ListEntry> entries) {
+  std::vector<std::string> evicted;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (auto& entry : entries) {
+      if (!IsCacheKey(entry.key) || !entry.has_size()) continue;
+      auto keys = AddIndexEntry(std::move(entry.key), entry.size,
+                                absl::InfinitePast());
+      evicted.insert(evicted.end(), std::make_move_iterator(keys.begin()),
+                     std::make_move_iterator(keys.end()));
+    }
+  }
+  EvictCachedValues(std::move(evicted));
+}
+
+std::optional<absl::Time> DiskCacheKvStore::LookupIndexEntry(
+    const std::string& cache_key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(cache_key);
+  if (it == index_.end()) return std::nullopt;
+  lru_.splice(lru_.end(), lru_, it->second.lru_it);
+  return it->second.validated_time;
+}
+
+void DiskCacheKvStore::UpdateValidatedTime(const std::string& cache_key,
+                                           absl::Time time) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(cache_key);
+  if (it == index_.end()) return;
+  it->second.validated_time = std::max(it->second.validated_time, time);
+}
+
+std::vector<std::string> DiskCacheKvStore::AddIndexEntry(
+    std::string cache_key, size_t size, absl::Time validated_time) {
+  auto [it, inserted] = index_.try_emplace(cache_key);
+  if (!inserted) {
+    total_bytes_ -= it->second.size;
+    lru_.erase(it->second.lru_it);
+  }
+  it->second.size = size;
+  it->second.validated_time = validated_time;
+  it->second.lru_it = lru_.insert(lru_.end(), std::move(cache_key));
+  total_bytes_ += size;
+
+  std::vector<std::string> evicted;
+  while (total_bytes_ > spec_data_.total_bytes_limit && !lru_.empty()) {
+    auto victim = index_.find(lru_.front());
+    total_bytes_ -= victim->second.size;
+    index_.erase(victim);
+    evicted.push_back(std::move(lru_.front()));
+    lru_.pop_front();
+  }
+  return evicted;
+}
+
+void DiskCacheKvStore::EvictCachedValues(std::vector<std::string> cache_keys) {
+  for (auto& cache_key : cache_keys) {
+    disk_cache_evict_count.Increment();
+    // Errors are ignored; at worst the cache exceeds its limit until the
+    // entry is evicted again after a restart.
+    kvstore::Delete(cache_, cache_key);
+  }
+}
+
+void DiskCacheKvStore::StoreCachedValue(
+    std::string_view key, std::string cache_key,
+    const TimestampedStorageGeneration& stamp, const absl::Cord& value) {
+  if (stamp.generation.value.size() > kMaxGenerationSize) return;
+  absl::Cord encoded = EncodeCachedValue(key, stamp, value);
+  const size_t size = encoded.size();
+  if (size > spec_data_.total_bytes_limit) return;
+  kvstore::Write(cache_, cache_key, std::move(encoded))
+      .ExecuteWhenReady(
+          [self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+           cache_key = std::move(cache_key), size, time = stamp.time](
+              ReadyFuture<TimestampedStorageGeneration> future) mutable {
+            if (!future.result().ok()) {
+              ABSL_LOG_IF(INFO, disk_cache_logging)
+                  << "Failed to write " << cache_key << ": "
+                  << future.result().status();
+              return;
+            }
+            std::vector<std::string> evicted;
+            {
+              absl::MutexLock lock(&self->mutex_);
+              evicted = self->AddIndexEntry(std::move(cache_key), size, time);
+            }
+            self->EvictCachedValues(std::move(evicted));
+          });
+}
+
+void DiskCacheKvStore::EraseCachedValue(std::string cache_key) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = index_.find(cache_key); it != index_.end()) {
+      total_bytes_ -= it->second.size;
+      lru_.erase(it->second.lru_it);
+      index_.erase(it);
+    }
+  }
+  kvstore::Delete(cache_, cache_key);
+}
+
+Future<kvstore::DriverPtr> DiskCacheKvStoreSpec::DoOpen() const {
+  auto open_future = MapFutureValue(
+      InlineExecutor{},
+      [spec = internal::IntrusivePtr<const DiskCacheKvStoreSpec>(this)](
+          kvstore::KvStore& base, kvstore::KvStore& cache)
+          -> Result<internal::IntrusivePtr<DiskCacheKvStore>> {
+        auto driver = internal::MakeIntrusivePtr<DiskCacheKvStore>();
+        driver->spec_data_ = spec->data_;
+        driver->base_ = std::move(base);
+        driver->cache_ = std::move(cache);
+        // The identifier must be stable across processes, so it is computed
+        // from the base spec without any context resources.
+        auto base_json = [&]() -> Result<::nlohmann::json> {
+          TENSORSTORE_ASSIGN_OR_RETURN(
+              auto base_spec, driver->base_.spec(tensorstore::strip_context));
+          return base_spec.ToJson();
+        }();
+        driver->base_identifier_ =
+            base_json.ok() ? base_json->dump()
+                           : driver->base_.driver->DescribeKey(
+                                 driver->base_.path);
+        driver->SetBatchNestingDepth(driver->base_.driver->BatchNestingDepth() +
+                                     1);
+        return driver;
+      },
+      kvstore::Open(data_.base), kvstore::Open(data_.cache));
+
+  return PromiseFuturePair<kvstore::DriverPtr>::LinkValue(
+             [](Promise<kvstore::DriverPtr> promise,
+                ReadyFuture<internal::IntrusivePtr<DiskCacheKvStore>> ready) {
+               auto driver = ready.value();
+               LinkValue(
+                   [driver](Promise<kvstore::DriverPtr> promise,
+                            ReadyFuture<std::vector<ListEntry>> entries) {
+                     driver->InitializeIndex(std::move(entries.value()));
+                     promise.SetResult(kvstore::DriverPtr(driver));
+                   },
+                   std::move(promise), kvstore::ListFuture(driver->cache_));
+             },
+             std::move(open_future))
+      .future;
+}
+
+// Implements DiskCacheKvStore::Read
+struct ReadState : public internal::AtomicReferenceCount<ReadState> {
+  internal::IntrusivePtr<DiskCacheKvStore> owner_;
+  kvstore::Key key_;
+  std::string cache_key_;
+  kvstore::ReadOptions options_;
+  absl::Time validated_time_ = absl::InfinitePast();
+  std::optional<CachedValue> cached_;
+
+  void OnCacheRead(Promise<kvstore::ReadResult> promise,
+                   ReadyFuture<kvstore::ReadResult> ready) {
+    if (!promise.result_needed()) return;
+    auto& r = ready.result();
+    if (r.ok() && r->has_value()) {
+      cached_ = DecodeCachedValue(key_, r->value);
+    }
+    if (!cached_) {
+      ABSL_LOG_IF(INFO, disk_cache_logging && !r.ok())
+          << "Failed to read " << cache_key_ << ": " << r.status();
+      owner_->EraseCachedValue(cache_key_);
+      ReadFromBase(std::move(promise));
+      return;
+    }
+    cached_->stamp.time = std::max(cached_->stamp.time, validated_time_);
+    if (cached_->stamp.time >= options_.staleness_bound) {
+      disk_cache_hit_count.Increment();
+      SetResultFromCached(promise, cached_->stamp);
+      return;
+    }
+    ReadFromBase(std::move(promise));
+  }
+
+  void ReadFromBase(Promise<kvstore::ReadResult> promise) {
+    kvstore::ReadOptions options = options_;
+    if (cached_) {
+      // Revalidate the cached value, which must then be read in full if it
+      // has changed.
+      options.byte_range = OptionalByteRangeRequest{};
+      if (StorageGeneration::IsUnknown(
+              options.generation_conditions.if_not_equal)) {
+        options.generation_conditions.if_not_equal = cached_->stamp.generation;
+      }
+    }
+    auto future = kvstore::Read(owner_->base_, key_, std::move(options));
+    Link(WithExecutor(owner_->executor(),
+                      [self = internal::IntrusivePtr<ReadState>(this)](
+                          Promise<kvstore::ReadResult> promise,
+                          ReadyFuture<kvstore::ReadResult> ready) {
+                        self->OnBaseRead(std::move(promise), std::move(ready));
+                      }),
+         std::move(promise), std::move(future));
+  }
+
+  void OnBaseRead(Promise<kvstore::ReadResult> promise,
+                  ReadyFuture<kvstore::ReadResult> ready) {
+    if (!promise.result_needed()) return;
+    if (!ready.result().ok()) {
+      promise.SetResult(ready.result().status());
+      return;
+    }
+    kvstore::ReadResult read_result = std::move(ready.value());
+    if (read_result.aborted() && cached_ &&
+        read_result.stamp.generation == cached_->stamp.generation) {
+      disk_cache_revalidated_count.Increment();
+      owner_->UpdateValidatedTime(cache_key_, read_result.stamp.time);
+      SetResultFromCached(promise, std::move(read_result.stamp));
+      return;
+    }
+    if (!cached_) disk_cache_miss_count.Increment();
+    if (read_result.has_value() &&
+        (cached_ || options_.byte_range.IsFull())) {
+      owner_->StoreCachedValue(key_, cache_key_, read_result.stamp,
+                               read_result.value);
+      if (cached_) {
+        auto byte_range =
+            options_.byte_range.Validate(read_result.value.size());
+        if (!byte_range.ok()) {
+          promise.SetResult(std::move(byte_range).status());
+          return;
+        }
+        read_result.value =
+            internal::GetSubCord(read_result.value, *byte_range);
+      }
+    } else if (read_result.not_found() && cached_) {
+      owner_->EraseCachedValue(cache_key_);
+    }
+    promise.SetResult(std::move(read_result));
+  }
+
+  void SetResultFromCached(Promise<kvstore::ReadResult>& promise,
+                           TimestampedStorageGeneration stamp) {
+    if (!options_.generation_conditions.Matches(stamp.generation)) {
+      promise.SetResult(kvstore::ReadResult::Unspecified(std::move(stamp)));
+      return;
+    }
+    auto byte_range = options_.byte_range.Validate(cached_->value.size());
+    if (!byte_range.ok()) {
+      promise.SetResult(std::move(byte_range).status());
+      return;
+    }
+    promise.SetResult(kvstore::ReadResult::Value(
+        internal::GetSubCord(cached_->value, *byte_range), std::move(stamp)));
+  }
+};
+
+Future<kvstore::ReadResult> DiskCacheKvStore::Read(Key key,
+                                                   ReadOptions options) {
+  auto state = internal::MakeIntrusivePtr<ReadState>();
+  state->owner_ = internal::IntrusivePtr<DiskCacheKvStore>(this);
+  state->cache_key_ = GetCacheKey(key);
+  state->key_ = std::move(key);
+  state->options_ = std::move(options);
+
+  auto pair = PromiseFuturePair<kvstore::ReadResult>::Make();
+  auto validated_time = LookupIndexEntry(state->cache_key_);
+  if (!validated_time) {
+    state->ReadFromBase(std::move(pair.promise));
+    return std::move(pair.future);
+  }
+  state->validated_time_ = *validated_time;
+  auto future = kvstore::Read(cache_, state->cache_key_);
+  Link(WithExecutor(executor(),
+                    [state = std::move(state)](
+                        Promise<kvstore::ReadResult> promise,
+                        ReadyFuture<kvstore::ReadResult> ready) {
+                      state->OnCacheRead(std::move(promise), std::move(ready));
+                    }),
+       std::move(pair.promise), std::move(future));
+  return std::move(pair.future);
+}
+
+Future<TimestampedStorageGeneration> DiskCacheKvStore::Write(
+    Key key, std::optional<Value> value, WriteOptions options) {
+  auto future = kvstore::Write(base_, key, value, std::move(options));
+  // Write through to the cache, so that the value need not be read back.
+  future.ExecuteWhenReady(
+      [self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+       key = std::move(key), value = std::move(value)](
+          ReadyFuture<TimestampedStorageGeneration> ready) {
+        auto& r = ready.result();
+        if (!r.ok() || StorageGeneration::IsUnknown(r->generation)) return;
+        if (value) {
+          self->StoreCachedValue(key, self->GetCacheKey(key), *r, *value);
+        } else {
+          self->EraseCachedValue(self->GetCacheKey(key));
+        }
+      });
+  return future;
+}
+
+Future<const void> DiskCacheKvStore::DeleteRange(KeyRange range) {
+  // Cached values are not removed, since cache keys are not ordered.  Reads
+  // with a `staleness_bound` later than the deletion revalidate them as usual.
+  return kvstore::DeleteRange(base_, std::move(range));
+}
+
+void DiskCacheKvStore::ListImpl(ListOptions options, ListReceiver receiver) {
+  kvstore::List(base_, std::move(options), std::move(receiver));
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(
+    tensorstore::DiskCacheKvStore)
+
+// Registers the driver.
+namespace {
+const tensorstore::internal_kvstore::DriverRegistration<
+    tensorstore::DiskCacheKvStoreSpec>
+    registration;
+
+}  // namespace
@@ -0,0 +1,254 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/mock_kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::Context;
+using ::tensorstore::Result;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal::MockKeyValueStore;
+using ::tensorstore::internal::MockKeyValueStoreResource;
+using ::tensorstore::kvstore::KvStore;
+
+class DiskCacheTest : public ::testing::Test {
+ public:
+  DiskCacheTest() : context_(Context::Default()) {}
+
+  Result<KvStore> KvStoreOpen(::nlohmann::json base,
+                              size_t total_bytes_limit = 1000000) const {
+    return kvstore::Open({{"driver", "disk_cache"},
+                          {"base", base},
+                          {"cache", {{"driver", "memory"}, {"path", "cache/"}}},
+                          {"total_bytes_limit", total_bytes_limit}},
+                         context_)
+        .result();
+  }
+
+  Result<KvStore> KvStoreOpen() const {
+    return KvStoreOpen({{"driver", "memory"}, {"path", "base/"}});
+  }
+
+  Context context_;
+};
+
+TEST_F(DiskCacheTest, ReadNotFound) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  EXPECT_THAT(kvstore::Read(store, "abc").result(),
+              MatchesKvsReadResultNotFound());
+}
+
+TEST_F(DiskCacheTest, Basic) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST_F(DiskCacheTest, DeletePrefix) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueStoreDeletePrefix(store);
+}
+
+TEST_F(DiskCacheTest, DeleteRange) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueStoreDeleteRange(store);
+}
+
+TEST_F(DiskCacheTest, List) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueStoreList(store);
+}
+
+TEST_F(DiskCacheTest, SpecRoundtrip) {
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.check_data_after_serialization = false;
+  options.full_spec = {{"driver", "disk_cache"},
+                       {"base", {{"driver", "memory"}, {"path", "base/"}}},
+                       {"cache", {{"driver", "memory"}, {"path", "cache/"}}},
+                       {"total_bytes_limit", 1000}};
+  options.full_base_spec = {{"driver", "memory"}, {"path", "base/"}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+class DiskCacheMockTest : public DiskCacheTest {
+ public:
+  DiskCacheMockTest() {
+    mock_store_ =
+        context_.GetResource<MockKeyValueStoreResource>().value()->get();
+    memory_store_ = kvstore::Open({{"driver", "memory"}}, Context::Default())
+                        .value()
+                        .driver;
+  }
+
+  Result<KvStore> KvStoreOpen(size_t total_bytes_limit = 1000000) const {
+    return DiskCacheTest::KvStoreOpen({{"driver", "mock_key_value_store"}},
+                                      total_bytes_limit);
+  }
+
+  // Reads `key` from `store`, handling the expected base kvstore read using
+  // `memory_store_`.
+  Result<kvstore::ReadResult> ReadAndForward(
+      const KvStore& store, std::string key,
+      StorageGeneration expected_if_not_equal,
+      kvstore::ReadOptions options = {}) {
+    auto read_future = kvstore::Read(store, key, options);
+    read_future.Force();
+    {
+      auto req = mock_store_->read_requests.pop();
+      EXPECT_EQ(key, req.key);
+      EXPECT_EQ(expected_if_not_equal,
+                req.options.generation_conditions.if_not_equal);
+      req(memory_store_);
+    }
+    return read_future.result();
+  }
+
+  MockKeyValueStore* mock_store_;
+  kvstore::DriverPtr memory_store_;
+};
+
+TEST_F(DiskCacheMockTest, ServesAndRevalidatesCachedValues) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp,
+      kvstore::Write(memory_store_, "a", absl::Cord("abc")).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+
+  kvstore::ReadOptions cached_options;
+  cached_options.staleness_bound = absl::InfinitePast();
+
+  // Initial read populates the cache.
+  EXPECT_THAT(
+      ReadAndForward(store, "a", StorageGeneration::Unknown(), cached_options),
+      MatchesKvsReadResult(absl::Cord("abc"), stamp.generation));
+
+  // Satisfied from the cache without accessing the base kvstore.
+  EXPECT_THAT(kvstore::Read(store, "a", cached_options).result(),
+              MatchesKvsReadResult(absl::Cord("abc"), stamp.generation));
+  EXPECT_TRUE(mock_store_->read_requests.empty());
+
+  // Byte range requests are also satisfied from the cache.
+  {
+    kvstore::ReadOptions options = cached_options;
+    options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 3);
+    EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+                MatchesKvsReadResult(absl::Cord("bc"), stamp.generation));
+    EXPECT_TRUE(mock_store_->read_requests.empty());
+  }
+
+  // Revalidation is conditioned on the cached generation.
+  EXPECT_THAT(ReadAndForward(store, "a", stamp.generation),
+              MatchesKvsReadResult(absl::Cord("abc"), stamp.generation));
+
+  // Changed values are read in full and replace the cached value.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto new_stamp,
+      kvstore::Write(memory_store_, "a", absl::Cord("def")).result());
+  EXPECT_THAT(ReadAndForward(store, "a", stamp.generation),
+              MatchesKvsReadResult(absl::Cord("def"), new_stamp.generation));
+  EXPECT_THAT(kvstore::Read(store, "a", cached_options).result(),
+              MatchesKvsReadResult(absl::Cord("def"), new_stamp.generation));
+  EXPECT_TRUE(mock_store_->read_requests.empty());
+
+  // Deleted values are removed from the cache.
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(memory_store_, "a").result());
+  EXPECT_THAT(ReadAndForward(store, "a", new_stamp.generation),
+              MatchesKvsReadResultNotFound());
+  EXPECT_THAT(
+      ReadAndForward(store, "a", StorageGeneration::Unknown(), cached_options),
+      MatchesKvsReadResultNotFound());
+}
+
+TEST_F(DiskCacheMockTest, PersistsAcrossOpen) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp,
+      kvstore::Write(memory_store_, "a", absl::Cord("abc")).result());
+  kvstore::ReadOptions cached_options;
+  cached_options.staleness_bound = absl::InfinitePast();
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+    EXPECT_THAT(ReadAndForward(store, "a", StorageGeneration::Unknown(),
+                               cached_options),
+                MatchesKvsReadResult(absl::Cord("abc"), stamp.generation));
+  }
+
+  // A distinct limit ensures that a new driver is opened, which loads the
+  // existing cache entries.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen(2000000));
+  EXPECT_THAT(kvstore::Read(store, "a", cached_options).result(),
+              MatchesKvsReadResult(absl::Cord("abc"), stamp.generation));
+  EXPECT_TRUE(mock_store_->read_requests.empty());
+}
+
+TEST_F(DiskCacheMockTest, EvictsLeastRecentlyUsed) {
+  const absl::Cord value(std::string(100, 'x'));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(memory_store_, "a", value).result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(memory_store_, "b", value).result());
+  // Sufficient for only one value.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen(200));
+
+  kvstore::ReadOptions cached_options;
+  cached_options.staleness_bound = absl::InfinitePast();
+  EXPECT_THAT(
+      ReadAndForward(store, "a", StorageGeneration::Unknown(), cached_options),
+      MatchesKvsReadResult(value));
+  EXPECT_THAT(
+      ReadAndForward(store, "b", StorageGeneration::Unknown(), cached_options),
+      MatchesKvsReadResult(value));
+  EXPECT_THAT(kvstore::Read(store, "b", cached_options).result(),
+              MatchesKvsReadResult(value));
+  EXPECT_TRUE(mock_store_->read_requests.empty());
+  EXPECT_THAT(
+      ReadAndForward(store, "a", StorageGeneration::Unknown(), cached_options),
+      MatchesKvsReadResult(value));
+}
+
+TEST_F(DiskCacheMockTest, WriteThrough) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  auto write_future = kvstore::Write(store, "a", absl::Cord("abc"));
+  write_future.Force();
+  {
+    auto req = mock_store_->write_requests.pop();
+    EXPECT_EQ("a", req.key);
+    req(memory_store_);
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stamp, write_future.result());
+
+  kvstore::ReadOptions cached_options;
+  cached_options.staleness_bound = absl::InfinitePast();
+  EXPECT_THAT(kvstore::Read(store, "a", cached_options).result(),
+              MatchesKvsReadResult(absl::Cord("abc"), stamp.generation));
+  EXPECT_TRUE(mock_store_->read_requests.empty());
+}
+
+}  // namespace
@@ -153,6 +153,13 @@ class Driver {
   using ListOptions = kvstore::ListOptions;
   using ListReceiver = kvstore::ListReceiver;
   using ListSender = kvstore::ListSender;
+  using ReadStreamReceiver = kvstore::ReadStreamReceiver;
+  using ReadStreamSender = kvstore::ReadStreamSender;
+  using StatOptions = kvstore::StatOptions;
+  using StatResult = kvstore::StatResult;
+  using ScanOptions = kvstore::ScanOptions;
+  using ScanReceiver = kvstore::ScanReceiver;
+  using ScanSender = kvstore::ScanSender;
 
   using ReadModifyWriteSource = kvstore::ReadModifyWriteSource;
   using ReadModifyWriteTarget = kvstore::ReadModifyWriteTarget;
@@ -165,6 +172,26 @@ class Driver {
   ///     with an error.
   virtual Future<ReadResult> Read(Key key, ReadOptions options = {});
 
+  /// Implementation of `ReadStream` that driver implementations may define.
+  ///
+  /// Drivers which can deliver a value incrementally, without assembling it
+  /// in memory, should override this.  The default implementation calls
+  /// `Read` and delivers the result as a single fragment.
+  virtual void ReadStreamImpl(Key key, ReadOptions options,
+                              ReadStreamReceiver receiver);
+
+  /// Reads the specified key incrementally.
+  ///
+  /// This simply forwards to `ReadStreamImpl`.
+  ReadStreamSender ReadStream(Key key, ReadOptions options = {});
+
+  /// Retrieves the metadata of the specified key without its value.
+  ///
+  /// The default implementation calls `Read` with an empty byte range, which
+  /// drivers handle without transferring the value, and reports an unknown
+  /// size.  Drivers which can obtain the size cheaply should override this.
+  virtual Future<StatResult> Stat(Key key, StatOptions options = {});
+
   /// Performs an optionally-conditional write.
   ///
   /// Atomically updates or deletes the value stored for `key` subject to the
@@ -252,6 +279,21 @@ class Driver {
   /// This simply forwards to `ListImpl`.
   ListSender List(ListOptions options);
 
+  /// Implementation of `Scan`.
+  ///
+  /// The default implementation lists `options.range` using `ListImpl` and
+  /// reads each key, with up to `options.read_ahead` reads in progress; see
+  /// `internal_kvstore::ReadAheadScan`.  Drivers which can retrieve values
+  /// along with their keys should override it.
+  virtual void ScanImpl(ScanOptions options, ScanReceiver receiver);
+
+  /// Lists keys in the key-value store along with their values.
+  ///
+  /// The entries are emitted in key order.
+  ///
+  /// This simply forwards to `ScanImpl`.
+  ScanSender Scan(ScanOptions options);
+
   /// Returns a Spec that can be used to re-open this key-value store.
   ///
   /// Options that modify the returned `Spec` may be specified in any order.
@@ -293,6 +335,14 @@ class Driver {
   /// By default, returns `QuoteString(key)`.
   virtual std::string DescribeKey(std::string_view key);
 
+  /// Returns the driver identifier, used to label metrics.
+  ///
+  /// The default implementation returns `"unknown"`.
+  ///
+  /// For drivers that do support a JSON representation, this is defined
+  /// automatically by `internal_kvstore::RegisteredDriver` in `registry.h`.
+  virtual std::string_view driver_id() const;
+
   /// Equivalent to
   /// `AnnotateErrorWithKeyDescription(DescribeKey(key), action, error)`.
   absl::Status AnnotateError(std::string_view key, std::string_view action,
@@ -80,12 +80,21 @@
 /// 8. `fsync` the parent directory of the file (to ensure the `unlink` or
 ///    `rename` operations are durable).  This step is skipped on MS Windows,
 ///    where `fsync` is not supported for directories.
+///
+/// If the store is opened with `single_writer`, the caller guarantees that no
+/// other process writes to the directory.  Writes to the same key are instead
+/// serialized within the process, the lock file is used only as a temporary
+/// file (steps 2 and 3 are skipped), deletes do not create a lock file, and the
+/// `fsync` of the parent directory in step 8 is shared by all writes to the
+/// same directory that complete before it starts.
 
 #include <stddef.h>
 #include <stdint.h>
 
 #include <atomic>
 #include <cassert>
+#include <list>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -93,11 +102,16 @@
 #include <utility>
 
 #include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/functional/function_ref.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/match.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include <nlohmann/json.hpp>
@@ -110,14 +124,17 @@
 #include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/path.h"
 #include "tensorstore/internal/os/error_code.h"
 #include "tensorstore/internal/os/unique_handle.h"
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/file/util.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -128,6 +145,7 @@
 #include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/url_registry.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
@@ -140,6 +158,7 @@
 // Include these last to reduce impact of macros.
 #include "tensorstore/internal/os/file_lister.h"
 #include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/internal/os/io_uring.h"
 
 /// On FreeBSD and Mac OS X, `flock` can safely be used instead of open file
 /// descriptor locks.  `flock`/`fcntl`/`lockf` all use the same underlying lock
@@ -178,17 +197,20 @@ using ::tensorstore::kvstore::ListReceiver;
 using ::tensorstore::kvstore::ReadResult;
 using ::tensorstore::kvstore::SupportedFeatures;
 
-auto& file_bytes_read = internal_metrics::Counter<int64_t>::New(
+auto& file_bytes_read = internal_metrics::ShardedCounter<int64_t>::New(
     "/tensorstore/kvstore/file/bytes_read",
     "Bytes read by the file kvstore driver");
 
-auto& file_bytes_written = internal_metrics::Counter<int64_t>::New(
+auto& file_bytes_written = internal_metrics::ShardedCounter<int64_t>::New(
     "/tensorstore/kvstore/file/bytes_written",
     "Bytes written by the file kvstore driver");
 
 auto& file_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/read", "file driver kvstore::Read calls");
 
+auto& file_stat = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/file/stat", "file driver kvstore::Stat calls");
+
 auto& file_open_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/open_read",
     "Number of times a file is opened for reading");
@@ -196,6 +218,10 @@ auto& file_open_read = internal_metrics::Counter<int64_t>::New(
 auto& file_batch_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/batch_read", "file driver reads after batching");
 
+auto& file_memmap_hit = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/file/memmap_hit",
+    "file driver reads served from an existing memory mapping");
+
 auto& file_write = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/write", "file driver kvstore::Write calls");
 
@@ -229,12 +255,38 @@ struct FileIoSyncResource
   }
 };
 
+/// Mechanism used to perform file reads.
+enum class FileIoEngine {
+  /// Blocking reads on the `file_io_concurrency` executor.
+  kThreadPool,
+  /// Asynchronous reads submitted to a shared io_uring instance, falling back
+  /// to `kThreadPool` if io_uring is unavailable.
+  kIoUring,
+  /// Files are memory mapped and reads reference the mapping directly, falling
+  /// back to `kThreadPool` if memory mapping is unavailable.
+  kMemoryMap,
+};
+
+constexpr auto FileIoEngineJsonBinder = [](auto is_loading,
+                                           const auto& options, auto* obj,
+                                           auto* j) {
+  return jb::Enum<FileIoEngine, const char*>({
+      {FileIoEngine::kThreadPool, "thread_pool"},
+      {FileIoEngine::kIoUring, "io_uring"},
+      {FileIoEngine::kMemoryMap, "memmap"},
+  })(is_loading, options, obj, j);
+};
+
 struct FileKeyValueStoreSpecData {
   Context::Resource<internal::FileIoConcurrencyResource> file_io_concurrency;
   Context::Resource<FileIoSyncResource> file_io_sync;
+  FileIoEngine file_io_engine = FileIoEngine::kThreadPool;
+  bool direct_io = false;
+  bool single_writer = false;
 
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    return f(x.file_io_concurrency, x.file_io_sync);
+    return f(x.file_io_concurrency, x.file_io_sync, x.file_io_engine,
+             x.direct_io, x.single_writer);
   };
 
   // TODO(jbms): Storing a UNIX path as a JSON string presents a challenge
@@ -257,11 +309,139 @@ struct FileKeyValueStoreSpecData {
           internal::FileIoConcurrencyResource::id,
           jb::Projection<&FileKeyValueStoreSpecData::file_io_concurrency>()),
       jb::Member(FileIoSyncResource::id,
-                 jb::Projection<&FileKeyValueStoreSpecData::file_io_sync>())
+                 jb::Projection<&FileKeyValueStoreSpecData::file_io_sync>()),
+      jb::Member("file_io_engine",
+                 jb::Projection<&FileKeyValueStoreSpecData::file_io_engine>(
+                     jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                         [](auto* v) { *v = FileIoEngine::kThreadPool; },
+                         FileIoEngineJsonBinder))),
+      jb::Member("direct_io",
+                 jb::Projection<&FileKeyValueStoreSpecData::direct_io>(
+                     jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                         [](auto* v) { *v = false; }))),
+      jb::Member("single_writer",
+                 jb::Projection<&FileKeyValueStoreSpecData::single_writer>(
+                     jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                         [](auto* v) { *v = false; })))
       //
   );
 };
 
+/// Bounded LRU cache of memory-mapped files, keyed by path.
+///
+/// Each entry records the generation of the file that was mapped; since value
+/// files are never modified in place (only replaced via `rename`), a mapping
+/// remains valid for its generation even after the path refers to a new file.
+/// Lookups for a path with a different generation invalidate the entry.
+class MemmapCache {
+ public:
+  static constexpr size_t kMaxEntries = 256;
+
+  std::optional<absl::Cord> Find(const std::string& path,
+                                 const StorageGeneration& generation) {
+    absl::MutexLock lock(&mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end()) return std::nullopt;
+    if (it->second->generation != generation) {
+      lru_.erase(it->second);
+      entries_.erase(it);
+      return std::nullopt;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->contents;
+  }
+
+  void Insert(const std::string& path, StorageGeneration generation,
+              absl::Cord contents) {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = entries_.find(path); it != entries_.end()) {
+      lru_.erase(it->second);
+      entries_.erase(it);
+    } else if (entries_.size() == kMaxEntries) {
+      entries_.erase(lru_.back().path);
+      lru_.pop_back();
+    }
+    lru_.push_front(Entry{path, std::move(generation), std::move(contents)});
+    entries_.emplace(path, lru_.begin());
+  }
+
+ private:
+  struct Entry {
+    std::string path;
+    StorageGeneration generation;
+    absl::Cord contents;
+  };
+  absl::Mutex mutex_;
+  std::list<Entry> lru_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+/// State used in place of lock files when the store is opened with
+/// `single_writer`.
+class SingleWriterState
+    : public std::enable_shared_from_this<SingleWriterState> {
+ public:
+  /// Blocks until no other write to `path` through this store is in progress,
+  /// and prevents new ones from starting until destroyed.
+  class PathLock {
+   public:
+    PathLock(SingleWriterState& state, const std::string& path)
+        : state_(state), path_(path) {
+      absl::MutexLock lock(&state_.mutex_);
+      while (!state_.locked_paths_.insert(path_).second) {
+        state_.path_unlocked_.Wait(&state_.mutex_);
+      }
+    }
+
+    ~PathLock() {
+      absl::MutexLock lock(&state_.mutex_);
+      state_.locked_paths_.erase(path_);
+      state_.path_unlocked_.SignalAll();
+    }
+
+   private:
+    SingleWriterState& state_;
+    const std::string& path_;
+  };
+
+  /// Returns a future that becomes ready once `dir_path` has been synced after
+  /// this call.  Concurrent calls for the same directory share a single
+  /// `fsync`.
+  Future<const void> SyncDirectory(std::string dir_path,
+                                   const Executor& executor) {
+    absl::MutexLock lock(&mutex_);
+    auto& future = pending_syncs_[dir_path];
+    if (!future.null()) return future;
+    auto [promise, new_future] = PromiseFuturePair<void>::Make();
+    future = new_future;
+    executor([self = shared_from_this(), dir_path = std::move(dir_path),
+              promise = std::move(promise)] {
+      {
+        // Syncs requested from now on require another `fsync`.
+        absl::MutexLock lock(&self->mutex_);
+        self->pending_syncs_.erase(dir_path);
+      }
+      auto status = [&]() -> absl::Status {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto dir_fd, internal_os::OpenDirectoryDescriptor(dir_path));
+        return internal_os::FsyncDirectory(dir_fd.get());
+      }();
+      promise.SetResult(MaybeAnnotateStatus(
+          std::move(status),
+          tensorstore::StrCat("Error calling fsync on directory: ", dir_path)));
+    });
+    return new_future;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::CondVar path_unlocked_;
+  absl::flat_hash_set<std::string> locked_paths_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, Future<const void>> pending_syncs_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 class FileKeyValueStoreSpec
     : public internal_kvstore::RegisteredDriverSpec<FileKeyValueStoreSpec,
                                                     FileKeyValueStoreSpecData> {
@@ -281,6 +461,8 @@ class FileKeyValueStore
  public:
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
                                              WriteOptions options) override;
@@ -307,8 +489,19 @@ class FileKeyValueStore
   }
 
   bool sync() const { return *spec_.file_io_sync; }
+  bool direct_io() const { return spec_.direct_io; }
 
   SpecData spec_;
+
+  /// Engine used for reads, or `nullptr` to use blocking reads on `executor()`.
+  internal_os::IoUringEngine* io_uring_ = nullptr;
+
+  /// Cache of memory-mapped files, or `nullptr` if memory mapping is not used.
+  std::unique_ptr<MemmapCache> memmap_cache_;
+
+  /// State used instead of lock files, or `nullptr` unless `single_writer` was
+  /// specified.
+  std::shared_ptr<SingleWriterState> single_writer_;
 };
 
 absl::Status ValidateKey(std::string_view key) {
@@ -456,6 +649,13 @@ struct WriteLockHelper {
     return fd;
   }
 
+  /// Creates the lock file without acquiring the lock, for use when writes are
+  /// serialized by other means.
+  absl::Status Create() {
+    TENSORSTORE_ASSIGN_OR_RETURN(lock_fd, OpenLockFile(&info));
+    return absl::OkStatus();
+  }
+
   /// Creates the lock file and acquires the lock.
   absl::Status CreateAndAcquire() {
     TENSORSTORE_ASSIGN_OR_RETURN(lock_fd, OpenLockFile(&info));
@@ -520,6 +720,59 @@ Result<absl::Cord> ReadFromFileDescriptor(FileDescriptor fd,
   return std::move(buffer).Build();
 }
 
+/// State of an asynchronous read of a byte range using io_uring.
+struct AsyncReadState {
+  using Callback = absl::AnyInvocable<void(Result<absl::Cord>) &&>;
+
+  internal_os::IoUringEngine* engine;
+  FileDescriptor fd;
+  int64_t inclusive_min;
+  internal::FlatCordBuilder buffer;
+  size_t offset = 0;
+  Callback callback;
+};
+
+/// Submits the remainder of the read specified by `state`, resubmitting as
+/// needed after short reads.
+void ContinueAsyncRead(std::unique_ptr<AsyncReadState> state) {
+  AsyncReadState* s = state.get();
+  if (s->offset == s->buffer.size()) {
+    std::move(s->callback)(std::move(s->buffer).Build());
+    return;
+  }
+  s->engine->Read(
+      s->fd, s->buffer.data() + s->offset, s->buffer.size() - s->offset,
+      s->inclusive_min + s->offset,
+      [state = std::move(state)](Result<ptrdiff_t> n) mutable {
+        if (!n.ok()) {
+          std::move(state->callback)(std::move(n).status());
+          return;
+        }
+        if (*n == 0) {
+          std::move(state->callback)(absl::UnavailableError(
+              tensorstore::StrCat("Length changed while reading")));
+          return;
+        }
+        file_bytes_read.IncrementBy(*n);
+        state->offset += *n;
+        state->buffer.set_inuse(state->offset);
+        ContinueAsyncRead(std::move(state));
+      });
+}
+
+/// Asynchronous equivalent of `ReadFromFileDescriptor`.
+///
+/// The caller must ensure that `fd` remains open until `callback` is invoked.
+void ReadFromFileDescriptorAsync(internal_os::IoUringEngine* engine,
+                                 FileDescriptor fd, ByteRange byte_range,
+                                 AsyncReadState::Callback callback) {
+  file_batch_read.Increment();
+  ContinueAsyncRead(std::unique_ptr<AsyncReadState>(new AsyncReadState{
+      engine, fd, byte_range.inclusive_min,
+      internal::FlatCordBuilder(byte_range.size(), false), 0,
+      std::move(callback)}));
+}
+
 class BatchReadTask;
 using BatchReadTaskBase = internal_kvstore_batch::BatchReadEntry<
     FileKeyValueStore,
@@ -535,6 +788,7 @@ class BatchReadTask final
   TimestampedStorageGeneration stamp_;
   UniqueFileDescriptor fd_;
   int64_t size_;
+  internal_kvstore::KvStoreOperationTimer timer_{"file", "read"};
 
  public:
   BatchReadTask(BatchEntryKey&& batch_entry_key_)
@@ -548,7 +802,11 @@ class BatchReadTask final
     driver().executor()(
         [self = internal::IntrusivePtr<BatchReadTask>(
              // Acquire initial reference count.
-             this, internal::adopt_object_ref)] { self->ProcessBatch(); });
+             this, internal::adopt_object_ref)] {
+          self->timer_.StartService();
+          self->ProcessBatch();
+          self->timer_.FinishService();
+        });
   }
 
   Result<kvstore::ReadResult> DoByteRangeRead(ByteRange byte_range) {
@@ -559,7 +817,84 @@ class BatchReadTask final
     return kvstore::ReadResult::Value(std::move(value), stamp_);
   }
 
+  /// Reads `byte_range` using the io_uring engine and invokes `callback` with
+  /// the result from the completion thread.
+  template <typename Callback>
+  void DoAsyncByteRangeRead(ByteRange byte_range, Callback callback) {
+    ReadFromFileDescriptorAsync(
+        driver().io_uring_, fd_.get(), byte_range,
+        [self = internal::IntrusivePtr<BatchReadTask>(this),
+         callback = std::move(callback)](Result<absl::Cord> value) mutable {
+          if (!value.ok()) {
+            std::move(callback)(tensorstore::MaybeAnnotateStatus(
+                std::move(value).status(), "Error reading from open file"));
+            return;
+          }
+          std::move(callback)(
+              kvstore::ReadResult::Value(*std::move(value), self->stamp_));
+        });
+  }
+
+  /// Obtains the entire contents of the file as a memory-mapped `absl::Cord`,
+  /// reusing an existing mapping if the file has not changed.
+  ///
+  /// Returns `std::nullopt` if the file does not exist.
+  Result<std::optional<absl::Cord>> GetMemmappedContents() {
+    auto& path = std::get<std::string>(batch_entry_key);
+    auto& cache = *driver().memmap_cache_;
+    FileInfo info;
+    if (internal_os::GetFileInfo(path, &info).ok() &&
+        internal_os::IsRegularFile(info)) {
+      stamp_.generation = GetFileGeneration(info);
+      if (auto contents = cache.Find(path, stamp_.generation)) {
+        file_memmap_hit.Increment();
+        return contents;
+      }
+    }
+    // The file is opened and its generation is obtained from the open file to
+    // ensure that the mapping corresponds to the generation.
+    file_open_read.Increment();
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        fd_, OpenValueFile(path.c_str(), &stamp_.generation, &size_));
+    if (!fd_.valid()) return std::nullopt;
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto contents, internal_os::MemmapFileReadOnly(fd_.get(), size_),
+        tensorstore::MaybeAnnotateStatus(_, "Error reading from open file"));
+    fd_.reset();
+    file_batch_read.Increment();
+    file_bytes_read.IncrementBy(contents.size());
+    cache.Insert(path, stamp_.generation, contents);
+    return contents;
+  }
+
+  void ProcessMemmapBatch() {
+    stamp_.time = absl::Now();
+    auto& requests = request_batch.requests;
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto contents, GetMemmappedContents(),
+        internal_kvstore_batch::SetCommonResult(requests, std::move(_)));
+    if (!contents) {
+      internal_kvstore_batch::SetCommonResult(
+          requests, kvstore::ReadResult::Missing(stamp_.time));
+      return;
+    }
+    internal_kvstore_batch::ValidateGenerationsAndByteRanges(
+        requests, stamp_, static_cast<int64_t>(contents->size()));
+    for (auto& request : requests) {
+      auto& byte_range_request =
+          std::get<internal_kvstore_batch::ByteRangeReadRequest>(request);
+      auto byte_range = byte_range_request.byte_range.AsByteRange();
+      byte_range_request.promise.SetResult(kvstore::ReadResult::Value(
+          contents->Subcord(byte_range.inclusive_min, byte_range.size()),
+          stamp_));
+    }
+  }
+
   void ProcessBatch() {
+    if (driver().memmap_cache_) {
+      ProcessMemmapBatch();
+      return;
+    }
     stamp_.time = absl::Now();
     file_open_read.Increment();
     auto& requests = request_batch.requests;
@@ -581,6 +916,15 @@ class BatchReadTask final
     if (requests.size() == 1) {
       auto& byte_range_request =
           std::get<internal_kvstore_batch::ByteRangeReadRequest>(requests[0]);
+      if (driver().io_uring_) {
+        DoAsyncByteRangeRead(
+            byte_range_request.byte_range.AsByteRange(),
+            [promise = byte_range_request.promise](
+                Result<kvstore::ReadResult> result) {
+              promise.SetResult(std::move(result));
+            });
+        return;
+      }
       // Perform single read immediately.
       byte_range_request.promise.SetResult(
           DoByteRangeRead(byte_range_request.byte_range.AsByteRange()));
@@ -589,28 +933,54 @@ class BatchReadTask final
 
     const auto& executor = driver().executor();
 
-    internal_kvstore_batch::CoalescingOptions coalescing_options;
-    coalescing_options.max_extra_read_bytes = 255;
+    // The file is opened only once for the entire batch.  Requests are
+    // coalesced into as few reads as possible; all but the last coalesced read
+    // are dispatched to the executor to proceed in parallel, while the last one
+    // is performed inline on the current thread.
+    std::optional<std::pair<ByteRange, span<Request>>> deferred_read;
     internal_kvstore_batch::ForEachCoalescedRequest<Request>(
-        requests, coalescing_options,
+        requests, internal_kvstore_batch::kDefaultLocalStorageCoalescingOptions,
         [&](ByteRange coalesced_byte_range, span<Request> coalesced_requests) {
-          auto self = internal::IntrusivePtr<BatchReadTask>(this);
-          executor([self = std::move(self), coalesced_byte_range,
-                    coalesced_requests] {
-            self->ProcessCoalescedRead(coalesced_byte_range,
-                                       coalesced_requests);
-          });
+          if (driver().io_uring_) {
+            // All coalesced reads are submitted from this thread and resolved
+            // from the io_uring completion thread.
+            DoAsyncByteRangeRead(
+                coalesced_byte_range,
+                [coalesced_byte_range, coalesced_requests](
+                    Result<kvstore::ReadResult> read_result) {
+                  ResolveCoalescedRead(coalesced_byte_range,
+                                       coalesced_requests,
+                                       std::move(read_result));
+                });
+            return;
+          }
+          if (deferred_read) {
+            executor([self = internal::IntrusivePtr<BatchReadTask>(this),
+                      coalesced = *deferred_read] {
+              self->ProcessCoalescedRead(coalesced.first, coalesced.second);
+            });
+          }
+          deferred_read.emplace(coalesced_byte_range, coalesced_requests);
         });
+    if (deferred_read) {
+      ProcessCoalescedRead(deferred_read->first, deferred_read->second);
+    }
   }
 
-  void ProcessCoalescedRead(ByteRange coalesced_byte_range,
-                            span<Request> coalesced_requests) {
-    TENSORSTORE_ASSIGN_OR_RETURN(auto read_result,
-                                 DoByteRangeRead(coalesced_byte_range),
+  static void ResolveCoalescedRead(ByteRange coalesced_byte_range,
+                                   span<Request> coalesced_requests,
+                                   Result<kvstore::ReadResult> read_result) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto value, std::move(read_result),
                                  internal_kvstore_batch::SetCommonResult(
                                      coalesced_requests, std::move(_)));
     internal_kvstore_batch::ResolveCoalescedRequests(
-        coalesced_byte_range, coalesced_requests, std::move(read_result));
+        coalesced_byte_range, coalesced_requests, std::move(value));
+  }
+
+  void ProcessCoalescedRead(ByteRange coalesced_byte_range,
+                            span<Request> coalesced_requests) {
+    ResolveCoalescedRead(coalesced_byte_range, coalesced_requests,
+                         DoByteRangeRead(coalesced_byte_range));
   }
 };
 
@@ -625,20 +995,107 @@ Future<ReadResult> FileKeyValueStore::Read(Key key, ReadOptions options) {
   return std::move(future);
 }
 
+/// Obtains the metadata of `path` without opening it.
+Result<kvstore::StatResult> StatValueFile(std::string path,
+                                          const kvstore::StatOptions& options) {
+  kvstore::StatResult result;
+  result.stamp.time = absl::Now();
+  FileInfo info;
+  if (auto status = internal_os::GetFileInfo(path, &info); !status.ok()) {
+    // Map not found to a missing value.
+    if (absl::IsNotFound(status)) {
+      result.state = kvstore::StatResult::State::kMissing;
+      result.stamp.generation = StorageGeneration::NoValue();
+      return result;
+    }
+    return status;
+  }
+  if (!internal_os::IsRegularFile(info)) {
+    return absl::FailedPreconditionError(
+        tensorstore::StrCat("Not a regular file: ", path));
+  }
+  result.stamp.generation = GetFileGeneration(info);
+  if (!options.generation_conditions.Matches(result.stamp.generation)) {
+    return result;
+  }
+  result.state = kvstore::StatResult::State::kValue;
+  result.size = static_cast<int64_t>(internal_os::GetSize(info));
+  return result;
+}
+
+Future<kvstore::StatResult> FileKeyValueStore::Stat(Key key,
+                                                    StatOptions options) {
+  file_stat.Increment();
+  TENSORSTORE_RETURN_IF_ERROR(ValidateKey(key));
+  return MapFuture(executor(),
+                   [key = std::move(key), options = std::move(options)] {
+                     return StatValueFile(key, options);
+                   });
+}
+
+/// Writes `value` to the lock file through a separate file descriptor that
+/// bypasses the page cache.
+///
+/// Returns `false` if direct I/O is not supported by the platform or the
+/// filesystem, in which case the caller falls back to buffered writes.
+Result<bool> TryWriteDirect(const std::string& lock_path,
+                            const absl::Cord& value) {
+  auto direct_fd = internal_os::OpenFileForDirectWriting(lock_path);
+  absl::Status status = direct_fd.status();
+  if (status.ok()) {
+    status = internal_os::WriteCordToFileDirect(direct_fd->get(), value);
+  }
+  if (status.ok()) {
+    file_bytes_written.IncrementBy(value.size());
+    return true;
+  }
+  if (absl::IsInvalidArgument(status) || absl::IsUnimplemented(status)) {
+    return false;
+  }
+  return MaybeAnnotateStatus(
+      status, tensorstore::StrCat("Failed writing: ", QuoteString(lock_path)));
+}
+
 /// Implements `FileKeyValueStore::Write`.
 struct WriteTask {
   std::string full_path;
   absl::Cord value;
   kvstore::WriteOptions options;
   bool sync;
+  bool direct_io;
+  /// If non-null, writes are serialized in-process rather than by locking, and
+  /// the caller is responsible for syncing the parent directory.
+  std::shared_ptr<SingleWriterState> single_writer;
+  internal_kvstore::KvStoreOperationTimer timer{"file", "write"};
 
   Result<TimestampedStorageGeneration> operator()() const {
+    auto timer = this->timer;
+    timer.StartService();
+    auto result = Run();
+    timer.FinishService();
+    return result;
+  }
+
+  Result<TimestampedStorageGeneration> Run() const {
     TimestampedStorageGeneration r;
     r.time = absl::Now();
 
     WriteLockHelper lock_helper(full_path);
-    TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
-    TENSORSTORE_RETURN_IF_ERROR(lock_helper.CreateAndAcquire());
+    UniqueFileDescriptor dir_fd;
+    std::optional<SingleWriterState::PathLock> path_lock;
+    if (single_writer) {
+      path_lock.emplace(*single_writer, full_path);
+      // Only create the parent directories if they don't already exist.
+      auto status = lock_helper.Create();
+      if (absl::IsNotFound(status)) {
+        TENSORSTORE_ASSIGN_OR_RETURN(dir_fd, OpenParentDirectory(full_path));
+        status = lock_helper.Create();
+      }
+      TENSORSTORE_RETURN_IF_ERROR(status);
+    } else {
+      TENSORSTORE_ASSIGN_OR_RETURN(dir_fd, OpenParentDirectory(full_path));
+      TENSORSTORE_RETURN_IF_ERROR(lock_helper.CreateAndAcquire());
+    }
     bool delete_lock_file = true;
 
     auto generation_result = [&]() -> Result<StorageGeneration> {
@@ -655,12 +1112,19 @@ struct WriteTask {
           return StorageGeneration::Unknown();
         }
       }
-      if (internal_os::GetSize(lock_helper.info) > value.size()) {
+      bool written = false;
+      if (direct_io) {
+        TENSORSTORE_ASSIGN_OR_RETURN(written, TryWriteDirect(lock_path, value));
+        if (!written) {
+          // A failed direct write may have left partial contents.
+          TENSORSTORE_RETURN_IF_ERROR(internal_os::TruncateFile(fd));
+        }
+      } else if (internal_os::GetSize(lock_helper.info) > value.size()) {
         // Only truncate when the file is larger. In the common path, the lock
         // file is newly created, so truncate is useless.
         TENSORSTORE_RETURN_IF_ERROR(internal_os::TruncateFile(fd));
       }
-      absl::Cord value_for_write = value;
+      absl::Cord value_for_write = written ? absl::Cord() : value;
       for (; !value_for_write.empty();) {
         TENSORSTORE_ASSIGN_OR_RETURN(
             auto n, internal_os::WriteCordToFile(fd, value_for_write),
@@ -678,7 +1142,7 @@ struct WriteTask {
       TENSORSTORE_RETURN_IF_ERROR(
           internal_os::RenameOpenFile(fd, lock_path, full_path));
       delete_lock_file = false;
-      if (this->sync) {
+      if (this->sync && !single_writer) {
         // fsync the parent directory to ensure the `rename` is durable.
         TENSORSTORE_RETURN_IF_ERROR(
             internal_os::FsyncDirectory(dir_fd.get()),
@@ -712,35 +1176,56 @@ struct DeleteTask {
   std::string full_path;
   kvstore::WriteOptions options;
   bool sync;
+  /// If non-null, deletes are serialized in-process rather than by locking,
+  /// and the caller is responsible for syncing the parent directory.
+  std::shared_ptr<SingleWriterState> single_writer;
+  internal_kvstore::KvStoreOperationTimer timer{"file", "write"};
 
   Result<TimestampedStorageGeneration> operator()() const {
+    auto timer = this->timer;
+    timer.StartService();
+    auto result = Run();
+    timer.FinishService();
+    return result;
+  }
+
+  /// Deletes the file if the condition is satisfied.
+  Result<StorageGeneration> DeleteIfEqual() const {
+    // Check condition.
+    if (!StorageGeneration::IsUnknown(options.generation_conditions.if_equal)) {
+      StorageGeneration generation;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          UniqueFileDescriptor value_fd,
+          OpenValueFile(full_path.c_str(), &generation));
+      if (generation != options.generation_conditions.if_equal) {
+        return StorageGeneration::Unknown();
+      }
+    }
+    auto status = internal_os::DeleteFile(full_path);
+    if (!status.ok() && !absl::IsNotFound(status)) {
+      return status;
+    }
+    return StorageGeneration::NoValue();
+  }
+
+  Result<TimestampedStorageGeneration> Run() const {
     TimestampedStorageGeneration r;
     r.time = absl::Now();
 
+    if (single_writer) {
+      SingleWriterState::PathLock path_lock(*single_writer, full_path);
+      TENSORSTORE_ASSIGN_OR_RETURN(r.generation, DeleteIfEqual());
+      return r;
+    }
+
     WriteLockHelper lock_helper(full_path);
     TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
     TENSORSTORE_RETURN_IF_ERROR(lock_helper.CreateAndAcquire());
 
-    bool fsync_directory = false;
-    auto generation_result = [&]() -> Result<StorageGeneration> {
-      // Check condition.
-      if (!StorageGeneration::IsUnknown(
-              options.generation_conditions.if_equal)) {
-        StorageGeneration generation;
-        TENSORSTORE_ASSIGN_OR_RETURN(
-            UniqueFileDescriptor value_fd,
-            OpenValueFile(full_path.c_str(), &generation));
-        if (generation != options.generation_conditions.if_equal) {
-          return StorageGeneration::Unknown();
-        }
-      }
-      auto status = internal_os::DeleteFile(full_path);
-      if (!status.ok() && !absl::IsNotFound(status)) {
-        return status;
-      }
-      fsync_directory = this->sync;
-      return StorageGeneration::NoValue();
-    }();
+    auto generation_result = DeleteIfEqual();
+    const bool fsync_directory =
+        this->sync && generation_result.ok() &&
+        StorageGeneration::IsNoValue(*generation_result);
 
     // Delete the lock file.
     TENSORSTORE_RETURN_IF_ERROR(lock_helper.Delete());
@@ -766,13 +1251,44 @@ Future<TimestampedStorageGeneration> FileKeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   file_write.Increment();
   TENSORSTORE_RETURN_IF_ERROR(ValidateKey(key));
-  if (value) {
-    return MapFuture(executor(), WriteTask{std::move(key), std::move(*value),
-                                           std::move(options), this->sync()});
-  } else {
-    return MapFuture(executor(), DeleteTask{std::move(key), std::move(options),
-                                            this->sync()});
+  // In single-writer mode, the parent directory is synced separately, so that
+  // concurrent writes to the same directory can share a single `fsync`.
+  const bool sync_directory = single_writer_ && this->sync();
+  std::string dir_path;
+  if (sync_directory) {
+    dir_path = internal::PathDirnameBasename(key).first;
+    if (dir_path.empty()) dir_path = ".";
   }
+  auto future =
+      value ? MapFuture(executor(),
+                        WriteTask{std::move(key), std::move(*value),
+                                  std::move(options), this->sync(),
+                                  this->direct_io(), single_writer_})
+            : MapFuture(executor(),
+                        DeleteTask{std::move(key), std::move(options),
+                                   this->sync(), single_writer_});
+  if (!sync_directory) return future;
+  return PromiseFuturePair<TimestampedStorageGeneration>::LinkValue(
+             [single_writer = single_writer_, io_executor = executor(),
+              dir_path = std::move(dir_path)](
+                 Promise<TimestampedStorageGeneration> promise,
+                 ReadyFuture<TimestampedStorageGeneration> future) {
+               // An unsatisfied condition leaves the directory unchanged.
+               if (StorageGeneration::IsUnknown(future.value().generation)) {
+                 promise.SetResult(future.result());
+                 return;
+               }
+               LinkValue(
+                   [stamp = future.value()](
+                       Promise<TimestampedStorageGeneration> promise,
+                       ReadyFuture<const void> sync_future) {
+                     promise.SetResult(stamp);
+                   },
+                   std::move(promise),
+                   single_writer->SyncDirectory(dir_path, io_executor));
+             },
+             std::move(future))
+      .future;
 }
 
 /// Implements `FileKeyValueStore::DeleteRange`.
@@ -826,20 +1342,31 @@ Future<const void> FileKeyValueStore::DeleteRange(KeyRange range) {
       .future;
 }
 
+/// Number of directories read concurrently by `List` when using the shared
+/// `file_io_concurrency` executor.
+constexpr size_t kDefaultListParallelism = 16;
+
 /// Implements `FileKeyValueStore:::List`.
 struct ListTask {
   kvstore::ListOptions options;
   ListReceiver receiver;
+  Executor executor;
+  size_t parallelism;
 
   void operator()() {
     std::atomic<bool> cancelled = false;
-    execution::set_starting(receiver, [&cancelled] {
+    auto demand = FlowDemand::Make();
+    execution::set_starting(receiver, [&cancelled, demand] {
       cancelled.store(true, std::memory_order_relaxed);
+      demand->RequestUnbounded();
     });
+    execution::set_demand(receiver, demand);
     std::string prefix(
         internal_file_util::LongestDirectoryPrefix(options.range));
-    auto status = internal_os::RecursiveFileList(
-        prefix,
+    // Subdirectories are read in parallel, which matters for large trees on
+    // network filesystems; calls to `on_file` are serialized.
+    auto status = internal_os::ParallelRecursiveFileList(
+        prefix, executor, parallelism,
         [&](std::string_view path) {
           return tensorstore::IntersectsPrefix(options.range, path);
         },
@@ -847,14 +1374,20 @@ struct ListTask {
           if (cancelled.load(std::memory_order_relaxed)) {
             return absl::CancelledError("");
           }
-          if (entry.IsDirectory()) return absl::OkStatus();
           std::string_view path = entry.GetFullPath();
           if (tensorstore::Contains(options.range, path) &&
               !absl::EndsWith(path, kLockSuffix)) {
             // TODO: If the file was stat'd, include length.
             path.remove_prefix(options.strip_prefix_length);
+            // The directory traversal is synchronous, so pause it until the
+            // receiver requests more entries.
+            demand->WhenAvailable().Wait();
+            if (cancelled.load(std::memory_order_relaxed)) {
+              return absl::CancelledError("");
+            }
             execution::set_value(receiver,
                                  ListEntry{std::string(path), entry.GetSize()});
+            demand->Consume();
           }
           return absl::OkStatus();
         });
@@ -882,12 +1415,25 @@ void FileKeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
     execution::set_stopping(receiver);
     return;
   }
-  executor()(ListTask{std::move(options), std::move(receiver)});
+  const size_t parallelism =
+      spec_.file_io_concurrency->spec.limit.value_or(kDefaultListParallelism);
+  executor()(ListTask{std::move(options), std::move(receiver), executor(),
+                      parallelism});
 }
 
 Future<kvstore::DriverPtr> FileKeyValueStoreSpec::DoOpen() const {
   auto driver_ptr = internal::MakeIntrusivePtr<FileKeyValueStore>();
   driver_ptr->spec_ = data_;
+  if (data_.single_writer) {
+    driver_ptr->single_writer_ = std::make_shared<SingleWriterState>();
+  }
+  if (data_.file_io_engine == FileIoEngine::kIoUring) {
+    driver_ptr->io_uring_ = internal_os::IoUringEngine::GetShared();
+  } else if (data_.file_io_engine == FileIoEngine::kMemoryMap) {
+#ifndef _WIN32
+    driver_ptr->memmap_cache_ = std::make_unique<MemmapCache>();
+#endif
+  }
   return driver_ptr;
 }
 
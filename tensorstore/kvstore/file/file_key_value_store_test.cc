@@ -25,12 +25,15 @@
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/internal/os/filesystem.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
 #include "tensorstore/internal/thread/thread.h"
+#include "tensorstore/kvstore/batch_util.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -38,11 +41,14 @@
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
 #include "tensorstore/util/execution/sender_testutil.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
 
 // Include system headers last to reduce impact of macros.
 #ifndef _WIN32
@@ -59,6 +65,7 @@ using ::tensorstore::KeyRange;
 using ::tensorstore::KvStore;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
 using ::tensorstore::internal::MatchesListEntry;
 using ::tensorstore::internal::MatchesTimestampedStorageGeneration;
@@ -374,6 +381,56 @@ TEST(FileKeyValueStoreTest, List) {
   tensorstore::internal::TestKeyValueStoreList(store, /*match_size=*/false);
 }
 
+// Receiver which requests a single entry, and records the demand handle so
+// that the test may request more.
+struct FlowControlledListReceiver {
+  absl::Mutex* mutex;
+  std::vector<std::string>* keys;
+  tensorstore::FlowDemand::Ptr* demand;
+  absl::Notification* done;
+
+  void set_starting(tensorstore::AnyCancelReceiver) {}
+  void set_demand(tensorstore::FlowDemand::Ptr d) {
+    d->Request(1);
+    absl::MutexLock lock(mutex);
+    *demand = std::move(d);
+  }
+  void set_value(kvstore::ListEntry entry) {
+    absl::MutexLock lock(mutex);
+    keys->push_back(std::move(entry.key));
+  }
+  void set_done() {}
+  void set_error(absl::Status) {}
+  void set_stopping() { done->Notify(); }
+};
+
+TEST(FileKeyValueStoreTest, ListFlowControl) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = GetStore(root);
+  for (std::string key : {"a", "b", "c"}) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, key, absl::Cord("x")).result());
+  }
+
+  absl::Mutex mutex;
+  std::vector<std::string> keys;
+  tensorstore::FlowDemand::Ptr demand;
+  absl::Notification done;
+  kvstore::List(store, {},
+                FlowControlledListReceiver{&mutex, &keys, &demand, &done});
+  {
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(
+        +[](std::vector<std::string>* keys) { return !keys->empty(); },
+        &keys));
+    // The listing is paused until more entries are requested.
+    EXPECT_EQ(1, keys.size());
+  }
+  demand->Request(2);
+  done.WaitForNotification();
+  EXPECT_THAT(keys, ::testing::UnorderedElementsAre("a", "b", "c"));
+}
+
 TEST(FileKeyValueStoreTest, SpecRoundtrip) {
   ScopedTemporaryDirectory tempdir;
   std::string root = tempdir.path() + "/root";
@@ -399,6 +456,33 @@ TEST(FileKeyValueStoreTest, SpecRoundtripSync) {
   tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
 }
 
+TEST(FileKeyValueStoreTest, SpecRoundtripIoUring) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "file"}, {"path", root}, {"file_io_engine", "io_uring"}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(FileKeyValueStoreTest, SpecRoundtripDirectIo) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "file"}, {"path", root}, {"direct_io", true}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(FileKeyValueStoreTest, SpecRoundtripSingleWriter) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "file"}, {"path", root}, {"single_writer", true}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
 TEST(FileKeyValueStoreTest, InvalidSpec) {
   ScopedTemporaryDirectory tempdir;
   std::string root = tempdir.path() + "/root";
@@ -415,6 +499,14 @@ TEST(FileKeyValueStoreTest, InvalidSpec) {
   EXPECT_THAT(
       kvstore::Open({{"driver", "file"}, {"path", 5}}, context).result(),
       MatchesStatus(absl::StatusCode::kInvalidArgument));
+
+  // Test with invalid `"file_io_engine"` key.
+  EXPECT_THAT(kvstore::Open({{"driver", "file"},
+                             {"path", root},
+                             {"file_io_engine", "invalid"}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
 }
 
 TEST(FileKeyValueStoreTest, UrlRoundtrip) {
@@ -456,10 +548,149 @@ TEST(FileKeyValueStoreTest, BatchRead) {
   auto store = GetStore(tempdir.path());
 
   tensorstore::internal::BatchReadGenericCoalescingTestOptions options;
-  options.coalescing_options.max_extra_read_bytes = 255;
+  options.coalescing_options =
+      tensorstore::internal_kvstore_batch::kDefaultLocalStorageCoalescingOptions;
+  options.metric_prefix = "/tensorstore/kvstore/file/";
+  options.has_file_open_metric = true;
+  tensorstore::internal::TestBatchReadGenericCoalescing(store, options);
+}
+
+KvStore GetIoUringStore(std::string root) {
+  return kvstore::Open({{"driver", "file"},
+                        {"path", root + "/"},
+                        {"file_io_engine", "io_uring"}})
+      .value();
+}
+
+TEST(FileKeyValueStoreTest, IoUringBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = GetIoUringStore(root);
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(FileKeyValueStoreTest, IoUringBatchRead) {
+  ScopedTemporaryDirectory tempdir;
+  auto store = GetIoUringStore(tempdir.path());
+
+  tensorstore::internal::BatchReadGenericCoalescingTestOptions options;
+  options.coalescing_options =
+      tensorstore::internal_kvstore_batch::kDefaultLocalStorageCoalescingOptions;
   options.metric_prefix = "/tensorstore/kvstore/file/";
   options.has_file_open_metric = true;
   tensorstore::internal::TestBatchReadGenericCoalescing(store, options);
 }
 
+TEST(FileKeyValueStoreTest, MemmapBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_engine", "memmap"}})
+                      .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(FileKeyValueStoreTest, MemmapOverwrite) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_engine", "memmap"}})
+                      .result());
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, "a", absl::Cord("abcdef")).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result0,
+                                   kvstore::Read(store, "a").result());
+  EXPECT_EQ("abcdef", read_result0.value);
+
+  // Reading again is served from the cached mapping.
+  kvstore::ReadOptions options;
+  options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 3);
+  EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("bc"),
+                                   read_result0.stamp.generation));
+
+  // Overwriting the key invalidates the mapping, but existing values remain
+  // valid.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "a", absl::Cord("xyz")).result());
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("xyz"), stamp.generation));
+  EXPECT_EQ("abcdef", read_result0.value);
+
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "a").result());
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResultNotFound());
+}
+
+TEST(FileKeyValueStoreTest, DirectIoBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"direct_io", true}})
+                      .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+// Tests values that are not a multiple of the direct I/O alignment, and
+// overwriting a value with a shorter one.
+TEST(FileKeyValueStoreTest, DirectIoUnalignedSizes) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"direct_io", true}})
+                      .result());
+  for (size_t size : {0, 1, 4095, 4096, 4097, 3 * 1024 * 1024 + 5, 10}) {
+    absl::Cord value(std::string(size, static_cast<char>('a' + size % 26)));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto stamp, kvstore::Write(store, "a", value).result());
+    EXPECT_THAT(kvstore::Read(store, "a").result(),
+                MatchesKvsReadResult(value, stamp.generation))
+        << size;
+  }
+}
+
+TEST(FileKeyValueStoreTest, SingleWriterBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"single_writer", true}})
+                      .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+// Tests that concurrent writes to many keys, which share directory syncs, all
+// complete, and that no lock files are left behind.
+TEST(FileKeyValueStoreTest, SingleWriterConcurrentWrites) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"single_writer", true}})
+                      .result());
+  std::vector<tensorstore::Future<tensorstore::TimestampedStorageGeneration>>
+      futures;
+  for (int i = 0; i < 100; ++i) {
+    futures.push_back(kvstore::Write(store, tensorstore::StrCat("dir/", i % 10),
+                                     absl::Cord(tensorstore::StrCat(i))));
+  }
+  for (auto& future : futures) {
+    TENSORSTORE_EXPECT_OK(future.result());
+  }
+  EXPECT_THAT(GetDirectoryContents(root),
+              ::testing::UnorderedElementsAre(
+                  "dir", "dir/0", "dir/1", "dir/2", "dir/3", "dir/4", "dir/5",
+                  "dir/6", "dir/7", "dir/8", "dir/9"));
+}
+
 }  // namespace
@@ -65,6 +65,7 @@
 #include "tensorstore/kvstore/gcs_grpc/storage_stub_pool.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/generic_coalescing_batch_util.h"
+#include "tensorstore/kvstore/hedged_read.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
@@ -75,6 +76,8 @@
 #include "tensorstore/proto/proto_util.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/sender.h"
+#include "tensorstore/util/execution/sender_util.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
@@ -175,11 +178,14 @@ struct GcsGrpcKeyValueStoreSpecData {
   Context::Resource<GcsUserProjectResource> user_project;
   Context::Resource<internal_storage_gcs::GcsRequestRetries> retries;
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency;
+  std::optional<double> hedge_read_percentile;
+  std::optional<double> hedge_read_budget;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     return f(x.bucket, x.endpoint, x.num_channels, x.timeout,
              x.wait_for_connection, x.user_project, x.retries,
-             x.data_copy_concurrency);
+             x.data_copy_concurrency, x.hedge_read_percentile,
+             x.hedge_read_budget);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -215,7 +221,15 @@ struct GcsGrpcKeyValueStoreSpecData {
       jb::Member(
           DataCopyConcurrencyResource::id,
           jb::Projection<
-              &GcsGrpcKeyValueStoreSpecData::data_copy_concurrency>()), /**/
+              &GcsGrpcKeyValueStoreSpecData::data_copy_concurrency>()),
+      jb::Member(
+          "hedge_read_percentile",
+          jb::Projection<&GcsGrpcKeyValueStoreSpecData::hedge_read_percentile>(
+              jb::Optional(internal_kvstore::HedgeReadPercentileBinder()))),
+      jb::Member(
+          "hedge_read_budget",
+          jb::Projection<&GcsGrpcKeyValueStoreSpecData::hedge_read_budget>(
+              jb::Optional(internal_kvstore::HedgeReadBudgetBinder()))), /**/
       jb::DiscardExtraMembers);
 };
 
@@ -243,12 +257,17 @@ class GcsGrpcKeyValueStore
  public:
   internal_kvstore_batch::CoalescingOptions GetBatchReadCoalescingOptions()
       const {
-    return internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions;
+    // gRPC multiplexes requests over HTTP/2 channels.
+    return internal_kvstore_batch::kMultiplexedRemoteStorageCoalescingOptions;
   }
 
   /// Key value store operations.
   Future<ReadResult> Read(Key key, ReadOptions options) override;
   Future<ReadResult> ReadImpl(Key&& key, ReadOptions&& options);
+  Future<ReadResult> IssueRead(const Key& key, ReadOptions options);
+
+  void ReadStreamImpl(Key key, ReadOptions options,
+                      ReadStreamReceiver receiver) override;
 
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
@@ -329,6 +348,10 @@ class GcsGrpcKeyValueStore
                                                  spec_.retries->max_retries),
                                  absl::StatusCode::kAborted, loc);
     }
+    if (!spec_.retries->TryRetry()) {
+      return MaybeAnnotateStatus(std::move(status), "Retry budget exhausted",
+                                 absl::StatusCode::kAborted, loc);
+    }
     gcs_grpc_retries.Increment();
     ScheduleAt(absl::Now() + *delay,
                WithExecutor(executor(), [task = internal::IntrusivePtr<Task>(
@@ -341,6 +364,8 @@ class GcsGrpcKeyValueStore
   std::string bucket_;
   std::shared_ptr<StorageStubPool> storage_stub_pool_;
   std::function<std::shared_ptr<grpc::CallCredentials>()> call_credentials_fn_;
+  // Set if `hedge_read_percentile` is specified.
+  std::unique_ptr<internal_kvstore::ReadHedger> read_hedger_;
 };
 
 ////////////////////////////////////////////////////
@@ -354,6 +379,74 @@ absl::crc32c_t ComputeCrc32c(const absl::Cord& cord) {
   return crc;
 }
 
+/// Sets the generation conditions and byte range of a ReadObjectRequest.
+void ApplyReadOptions(const kvstore::ReadOptions& options,
+                      ReadObjectRequest& request) {
+  if (!StorageGeneration::IsUnknown(options.generation_conditions.if_equal)) {
+    uint64_t gen =
+        StorageGeneration::IsNoValue(options.generation_conditions.if_equal)
+            ? 0
+            : StorageGeneration::ToUint64(
+                  options.generation_conditions.if_equal);
+    request.set_if_generation_match(gen);
+  }
+  if (!StorageGeneration::IsUnknown(
+          options.generation_conditions.if_not_equal)) {
+    uint64_t gen =
+        StorageGeneration::IsNoValue(options.generation_conditions.if_not_equal)
+            ? 0
+            : StorageGeneration::ToUint64(
+                  options.generation_conditions.if_not_equal);
+    request.set_if_generation_not_match(gen);
+  }
+  if (options.byte_range.inclusive_min != 0) {
+    request.set_read_offset(options.byte_range.inclusive_min);
+  }
+  if (options.byte_range.exclusive_max != -1) {
+    auto target_size = options.byte_range.size();
+    assert(target_size >= 0);
+    // read_limit == 0 reads the entire object; instead just read a single
+    // byte.
+    request.set_read_limit(target_size == 0 ? 1 : target_size);
+  }
+}
+
+/// Validates the content range and fragment checksum of a ReadObjectResponse.
+absl::Status ValidateReadObjectResponse(
+    const ReadObjectResponse& response,
+    const OptionalByteRangeRequest& byte_range) {
+  if (response.has_content_range()) {
+    // The content-range request indicates the expected data. If it does not
+    // satisfy the byte range request, cancel the read with an error. Allow
+    // the returned size to exceed the requested size.
+    auto returned_size =
+        response.content_range().end() - response.content_range().start();
+    if (auto size = byte_range.size();
+        (size > 0 && size != returned_size) ||
+        (byte_range.inclusive_min >= 0 &&
+         response.content_range().start() != byte_range.inclusive_min)) {
+      return absl::OutOfRangeError(
+          tensorstore::StrCat("Requested byte range ", byte_range,
+                              " was not satisfied by GCS object with size ",
+                              response.content_range().complete_length()));
+    }
+  }
+  if (response.has_checksummed_data() &&
+      response.checksummed_data().has_crc32c() &&
+      response.checksummed_data().crc32c() != 0) {
+    // Validate the content checksum.
+    auto content_crc32c = ComputeCrc32c(response.checksummed_data().content());
+    if (content_crc32c !=
+        absl::crc32c_t(response.checksummed_data().crc32c())) {
+      return absl::DataLossError(absl::StrFormat(
+          "Object fragment crc32c %08x does not match expected crc32c %08x",
+          static_cast<uint32_t>(content_crc32c),
+          response.checksummed_data().crc32c()));
+    }
+  }
+  return absl::OkStatus();
+}
+
 // Implements GcsGrpcKeyValueStore::Read
 // rpc ReadObject(ReadObjectRequest) returns (stream ReadObjectResponse) {}
 struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
@@ -363,7 +456,7 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
   Promise<kvstore::ReadResult> promise_;
 
   // working state.
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
   ReadObjectRequest request_;
   ReadObjectResponse response_;
   std::optional<absl::crc32c_t> crc32c_;
@@ -382,41 +475,12 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
   void Start(const std::string& object_name) {
     ABSL_LOG_IF(INFO, gcs_grpc_logging) << "ReadTask::Start " << this;
 
-    stub_ = driver_->get_stub().get();
     promise_.ExecuteWhenNotNeeded(
         [self = internal::IntrusivePtr<ReadTask>(this)] { self->TryCancel(); });
 
     request_.set_bucket(driver_->bucket_name());
     request_.set_object(object_name);
-
-    if (!StorageGeneration::IsUnknown(
-            options_.generation_conditions.if_equal)) {
-      uint64_t gen =
-          StorageGeneration::IsNoValue(options_.generation_conditions.if_equal)
-              ? 0
-              : StorageGeneration::ToUint64(
-                    options_.generation_conditions.if_equal);
-      request_.set_if_generation_match(gen);
-    }
-    if (!StorageGeneration::IsUnknown(
-            options_.generation_conditions.if_not_equal)) {
-      uint64_t gen = StorageGeneration::IsNoValue(
-                         options_.generation_conditions.if_not_equal)
-                         ? 0
-                         : StorageGeneration::ToUint64(
-                               options_.generation_conditions.if_not_equal);
-      request_.set_if_generation_not_match(gen);
-    }
-    if (options_.byte_range.inclusive_min != 0) {
-      request_.set_read_offset(options_.byte_range.inclusive_min);
-    }
-    if (options_.byte_range.exclusive_max != -1) {
-      auto target_size = options_.byte_range.size();
-      assert(target_size >= 0);
-      // read_limit == 0 reads the entire object; instead just read a single
-      // byte.
-      request_.set_read_limit(target_size == 0 ? 1 : target_size);
-    }
+    ApplyReadOptions(options_, request_);
 
     Retry();
   }
@@ -441,6 +505,7 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
 
       // Start a call.
       intrusive_ptr_increment(this);  // adopted in OnDone.
+      stub_ = driver_->get_stub();
       stub_->async()->ReadObject(context_.get(), &request_, this);
     }
 
@@ -468,40 +533,12 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
       // Do not validate byte-range requests.
       crc32c_ = absl::crc32c_t(response_.object_checksums().crc32c());
     }
-    if (response_.has_content_range()) {
-      // The content-range request indicates the expected data. If it does not
-      // satisfy the byte range request, cancel the read with an error. Allow
-      // the returned size to exceed the requested size.
-      auto returned_size =
-          response_.content_range().end() - response_.content_range().start();
-      if (auto size = options_.byte_range.size();
-          (size > 0 && size != returned_size) ||
-          (options_.byte_range.inclusive_min >= 0 &&
-           response_.content_range().start() !=
-               options_.byte_range.inclusive_min)) {
-        promise_.SetResult(absl::OutOfRangeError(
-            tensorstore::StrCat("Requested byte range ", options_.byte_range,
-                                " was not satisfied by GCS object with size ",
-                                response_.content_range().complete_length())));
-        TryCancel();
-        return;
-      }
-    }
-    if (response_.has_checksummed_data() &&
-        response_.checksummed_data().has_crc32c() &&
-        response_.checksummed_data().crc32c() != 0) {
-      // Validate the content checksum.
-      auto content_crc32c =
-          ComputeCrc32c(response_.checksummed_data().content());
-      if (content_crc32c !=
-          absl::crc32c_t(response_.checksummed_data().crc32c())) {
-        promise_.SetResult(absl::DataLossError(absl::StrFormat(
-            "Object fragment crc32c %08x does not match expected crc32c %08x",
-            static_cast<uint32_t>(content_crc32c),
-            response_.checksummed_data().crc32c())));
-        TryCancel();
-        return;
-      }
+    if (auto status =
+            ValidateReadObjectResponse(response_, options_.byte_range);
+        !status.ok()) {
+      promise_.SetResult(std::move(status));
+      TryCancel();
+      return;
     }
     if (response_.has_checksummed_data()) {
       gcs_grpc_bytes_read.IncrementBy(
@@ -595,6 +632,288 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
   }
 };
 
+// Implements GcsGrpcKeyValueStore::ReadStream
+// rpc ReadObject(ReadObjectRequest) returns (stream ReadObjectResponse) {}
+//
+// Unlike `ReadTask`, each message is delivered to the receiver as it arrives
+// and the next message is only requested once the receiver has returned, so
+// gRPC flow control bounds the amount of buffered data.  A retry after some
+// data has been delivered resumes from the first undelivered byte of the
+// same object generation.
+struct ReadStreamTask : public internal::AtomicReferenceCount<ReadStreamTask>,
+                        public grpc::ClientReadReactor<ReadObjectResponse> {
+  internal::IntrusivePtr<GcsGrpcKeyValueStore> driver_;
+  kvstore::ReadOptions options_;
+  kvstore::ReadStreamReceiver receiver_;
+
+  // working state.
+  std::shared_ptr<Storage::StubInterface> stub_;
+  ReadObjectRequest request_;
+  ReadObjectResponse response_;
+  // Absolute byte range of the read, once known, and the range requested by
+  // the current call.
+  OptionalByteRangeRequest byte_range_;
+  OptionalByteRangeRequest request_range_;
+  std::optional<absl::crc32c_t> crc32c_;
+  absl::crc32c_t value_crc32c_{0};
+  TimestampedStorageGeneration storage_generation_;
+  int64_t bytes_delivered_ = 0;
+  absl::Status error_;
+
+  int attempt_ = 0;
+  absl::Mutex mutex_;
+  std::unique_ptr<grpc::ClientContext> context_ ABSL_GUARDED_BY(mutex_);
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+
+  ReadStreamTask(internal::IntrusivePtr<GcsGrpcKeyValueStore>&& driver,
+                 kvstore::ReadOptions&& options,
+                 kvstore::ReadStreamReceiver&& receiver)
+      : driver_(std::move(driver)),
+        options_(std::move(options)),
+        receiver_(std::move(receiver)) {
+    execution::set_starting(receiver_, [this] { TryCancel(); });
+  }
+
+  ~ReadStreamTask() {
+    {
+      absl::MutexLock l(&mutex_);
+      context_ = nullptr;
+    }
+    driver_ = {};
+    execution::set_stopping(receiver_);
+  }
+
+  bool is_cancelled() ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock l(&mutex_);
+    return cancelled_;
+  }
+
+  void TryCancel() ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock l(&mutex_);
+    if (!cancelled_) {
+      cancelled_ = true;
+      if (context_) context_->TryCancel();
+    }
+  }
+
+  // Cancels the call with an error which is reported from `ReadFinished`.
+  void Fail(absl::Status status) ABSL_LOCKS_EXCLUDED(mutex_) {
+    error_ = std::move(status);
+    absl::MutexLock l(&mutex_);
+    if (context_) context_->TryCancel();
+  }
+
+  void Start(const std::string& object_name) {
+    ABSL_LOG_IF(INFO, gcs_grpc_logging) << "ReadStreamTask::Start " << this;
+
+    byte_range_ = request_range_ = options_.byte_range;
+    storage_generation_ =
+        TimestampedStorageGeneration{StorageGeneration::Unknown(), absl::Now()};
+
+    request_.set_bucket(driver_->bucket_name());
+    request_.set_object(object_name);
+    ApplyReadOptions(options_, request_);
+
+    Retry();
+  }
+
+  void Retry() ABSL_LOCKS_EXCLUDED(mutex_) {
+    if (is_cancelled()) {
+      execution::set_done(receiver_);
+      return;
+    }
+
+    ABSL_LOG_IF(INFO, gcs_grpc_logging) << "ReadStreamTask::Retry " << this
+                                        << " " << ConciseDebugString(request_);
+
+    {
+      absl::MutexLock lock(&mutex_);
+      assert(context_ == nullptr);
+      context_ = driver_->AllocateContext();
+
+      // Start a call.
+      intrusive_ptr_increment(this);  // adopted in OnDone.
+      stub_ = driver_->get_stub();
+      stub_->async()->ReadObject(context_.get(), &request_, this);
+    }
+
+    StartRead(&response_);
+    StartCall();
+  }
+
+  void OnReadDone(bool ok) override {
+    ABSL_LOG_IF(INFO, gcs_grpc_logging)
+        << "ReadStreamTask::OnReadDone: " << this << " " << ok;
+    if (!ok) return;
+    // Hold the call open until the receiver has consumed the message; the
+    // next message is not requested until then.
+    AddHold();
+    driver_->executor()([self = internal::IntrusivePtr<ReadStreamTask>(this)] {
+      if (self->HandleResponse()) {
+        self->StartRead(&self->response_);
+      }
+      self->RemoveHold();
+    });
+  }
+
+  // Validates and delivers `response_`.  Returns whether the next message
+  // should be read.
+  bool HandleResponse() {
+    if (is_cancelled()) return false;
+    if (response_.has_metadata()) {
+      storage_generation_.generation =
+          StorageGeneration::FromUint64(response_.metadata().generation());
+    }
+    if (response_.has_object_checksums() &&
+        response_.object_checksums().crc32c() != 0 &&
+        options_.byte_range.IsFull()) {
+      // Do not validate byte-range requests.
+      crc32c_ = absl::crc32c_t(response_.object_checksums().crc32c());
+    }
+    if (auto status = ValidateReadObjectResponse(response_, request_range_);
+        !status.ok()) {
+      Fail(std::move(status));
+      return false;
+    }
+    if (response_.has_content_range() && byte_range_.inclusive_min < 0) {
+      // Record the absolute offset of a suffix request so that a retry can
+      // resume from it.
+      byte_range_.inclusive_min = response_.content_range().start();
+    }
+    if (response_.has_checksummed_data() && options_.byte_range.size() != 0) {
+      absl::Cord fragment = response_.checksummed_data().content();
+      response_.Clear();
+      if (!fragment.empty()) {
+        if (StorageGeneration::IsUnknown(storage_generation_.generation)) {
+          Fail(absl::InternalError("Object missing a valid generation"));
+          return false;
+        }
+        gcs_grpc_bytes_read.IncrementBy(fragment.size());
+        if (crc32c_.has_value()) {
+          value_crc32c_ = absl::ConcatCrc32c(
+              value_crc32c_, ComputeCrc32c(fragment), fragment.size());
+        }
+        bytes_delivered_ += fragment.size();
+        execution::set_value(
+            receiver_,
+            kvstore::ReadResult::Value(std::move(fragment),
+                                       storage_generation_));
+      }
+    }
+    return true;
+  }
+
+  void OnDone(const grpc::Status& s) override {
+    internal::IntrusivePtr<ReadStreamTask> self(this,
+                                                internal::adopt_object_ref);
+    driver_->executor()(
+        [self = std::move(self), status = GrpcStatusToAbslStatus(s)]() {
+          self->ReadFinished(std::move(status));
+        });
+  }
+
+  // Updates `request_` to resume after the data delivered so far.  Returns
+  // false if the read cannot be resumed.
+  bool PrepareResume() {
+    if (bytes_delivered_ == 0) return true;
+    if (byte_range_.inclusive_min < 0 ||
+        StorageGeneration::IsUnknown(storage_generation_.generation)) {
+      return false;
+    }
+    request_range_ = OptionalByteRangeRequest(
+        byte_range_.inclusive_min + bytes_delivered_, byte_range_.exclusive_max);
+    request_.set_read_offset(request_range_.inclusive_min);
+    if (request_range_.exclusive_max != -1) {
+      request_.set_read_limit(request_range_.size());
+    }
+    request_.clear_if_generation_not_match();
+    request_.set_if_generation_match(
+        StorageGeneration::ToUint64(storage_generation_.generation));
+    return true;
+  }
+
+  void ReadFinished(absl::Status status) {
+    ABSL_LOG_IF(INFO, gcs_grpc_logging)
+        << "ReadStreamTask::ReadFinished: " << this << " " << status;
+    {
+      absl::MutexLock lock(&mutex_);
+      context_ = nullptr;
+    }
+    if (!error_.ok()) {
+      execution::set_error(receiver_, std::move(error_));
+      return;
+    }
+    if (is_cancelled()) {
+      execution::set_done(receiver_);
+      return;
+    }
+
+    if (!status.ok() && attempt_ == 0 &&
+        status.code() == absl::StatusCode::kUnauthenticated &&
+        bytes_delivered_ == 0) {
+      // Allow a single unauthenticated error.
+      attempt_++;
+      Retry();
+      return;
+    }
+    if (!status.ok() && IsRetriable(status) && PrepareResume()) {
+      response_.Clear();
+      status =
+          driver_->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+
+    auto latency = absl::Now() - storage_generation_.time;
+    gcs_grpc_read_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+
+    if (!status.ok()) {
+      if (bytes_delivered_ == 0 &&
+          (absl::IsFailedPrecondition(status) || absl::IsAborted(status))) {
+        // Failed precondition is set when either the if_generation_match or
+        // the if_generation_not_match fails.
+        if (!StorageGeneration::IsUnknown(
+                options_.generation_conditions.if_equal)) {
+          storage_generation_.generation = StorageGeneration::Unknown();
+        } else {
+          storage_generation_.generation =
+              options_.generation_conditions.if_not_equal;
+        }
+        execution::set_value(receiver_, kvstore::ReadResult::Unspecified(
+                                            std::move(storage_generation_)));
+        execution::set_done(receiver_);
+        return;
+      }
+      if (bytes_delivered_ == 0 && absl::IsNotFound(status)) {
+        execution::set_value(
+            receiver_, kvstore::ReadResult::Missing(storage_generation_.time));
+        execution::set_done(receiver_);
+        return;
+      }
+      execution::set_error(receiver_, std::move(status));
+      return;
+    }
+    if (StorageGeneration::IsUnknown(storage_generation_.generation)) {
+      execution::set_error(
+          receiver_, absl::InternalError("Object missing a valid generation"));
+      return;
+    }
+    if (crc32c_.has_value() && value_crc32c_ != *crc32c_) {
+      execution::set_error(
+          receiver_,
+          absl::DataLossError("Object crc32c does not match expected crc32c"));
+      return;
+    }
+    if (bytes_delivered_ == 0) {
+      execution::set_value(receiver_,
+                           kvstore::ReadResult::Value(
+                               absl::Cord(), std::move(storage_generation_)));
+    }
+    execution::set_done(receiver_);
+  }
+};
+
 // Implements GcsGrpcKeyValueStore::Write
 // rpc ReadObject(ReadObjectRequest) returns (stream ReadObjectResponse) {}
 // rpc StartResumableWrite(StartResumableWriteRequest) returns
@@ -606,7 +925,7 @@ struct WriteTask : public internal::AtomicReferenceCount<WriteTask>,
   Promise<TimestampedStorageGeneration> promise_;
   std::string object_name_;
   absl::Cord value_;
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
 
   // working state.
   WriteObjectRequest request_;
@@ -671,7 +990,6 @@ struct WriteTask : public internal::AtomicReferenceCount<WriteTask>,
 
     object_name_ = std::move(object_name);
     value_ = std::move(value);
-    stub_ = driver_->get_stub().get();
     promise_.ExecuteWhenNotNeeded([self = internal::IntrusivePtr<WriteTask>(
                                        this)] { self->TryCancel(); });
     Retry();
@@ -695,6 +1013,7 @@ struct WriteTask : public internal::AtomicReferenceCount<WriteTask>,
 
       // Initiate the write.
       intrusive_ptr_increment(this);
+      stub_ = driver_->get_stub();
       stub_->async()->WriteObject(context_.get(), &response_, this);
     }
 
@@ -796,7 +1115,7 @@ struct DeleteTask : public internal::AtomicReferenceCount<DeleteTask> {
   Promise<TimestampedStorageGeneration> promise_;
 
   // Working state
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
   absl::Time start_time_;
   DeleteObjectRequest request_;
   ::google::protobuf::Empty response_;
@@ -810,7 +1129,6 @@ struct DeleteTask : public internal::AtomicReferenceCount<DeleteTask> {
   }
 
   void Start(const std::string& object_name) {
-    stub_ = driver_->get_stub().get();
     promise_.ExecuteWhenNotNeeded([self = internal::IntrusivePtr<DeleteTask>(
                                        this)] { self->TryCancel(); });
 
@@ -840,6 +1158,7 @@ struct DeleteTask : public internal::AtomicReferenceCount<DeleteTask> {
       context_ = driver_->AllocateContext();
 
       intrusive_ptr_increment(this);  // Adopted by OnDone
+      stub_ = driver_->get_stub();
       stub_->async()->DeleteObject(
           context_.get(), &request_, &response_,
           WithExecutor(driver_->executor(), [this](::grpc::Status s) {
@@ -904,7 +1223,7 @@ struct ListTask : public internal::AtomicReferenceCount<ListTask> {
   ListReceiver receiver_;
 
   // working state.
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
   ListObjectsRequest request;
   ListObjectsResponse response;
 
@@ -945,7 +1264,6 @@ struct ListTask : public internal::AtomicReferenceCount<ListTask> {
   }
 
   void Start() {
-    stub_ = driver_->get_stub().get();
     request.set_lexicographic_start(options_.range.inclusive_min);
     request.set_lexicographic_end(options_.range.exclusive_max);
     request.set_parent(driver_->bucket_name());
@@ -969,6 +1287,7 @@ struct ListTask : public internal::AtomicReferenceCount<ListTask> {
       context_ = driver_->AllocateContext();
 
       intrusive_ptr_increment(this);
+      stub_ = driver_->get_stub();
       stub_->async()->ListObjects(
           context_.get(), &request, &response,
           WithExecutor(driver_->executor(), [this](::grpc::Status s) {
@@ -1087,6 +1406,19 @@ Future<kvstore::ReadResult> GcsGrpcKeyValueStore::Read(Key key,
 Future<kvstore::ReadResult> GcsGrpcKeyValueStore::ReadImpl(
     Key&& key, ReadOptions&& options) {
   gcs_grpc_batch_read.Increment();
+  spec_.retries->RecordRequest();
+  if (read_hedger_) {
+    return read_hedger_->Read(
+        [self = internal::IntrusivePtr<GcsGrpcKeyValueStore>(this),
+         key = std::move(key), options = std::move(options)] {
+          return self->IssueRead(key, options);
+        });
+  }
+  return IssueRead(key, std::move(options));
+}
+
+Future<kvstore::ReadResult> GcsGrpcKeyValueStore::IssueRead(
+    const Key& key, ReadOptions options) {
   auto op = PromiseFuturePair<ReadResult>::Make();
 
   auto task = internal::MakeIntrusivePtr<ReadTask>();
@@ -1097,9 +1429,33 @@ Future<kvstore::ReadResult> GcsGrpcKeyValueStore::ReadImpl(
   return std::move(op.future);
 }
 
+void GcsGrpcKeyValueStore::ReadStreamImpl(Key key, ReadOptions options,
+                                          ReadStreamReceiver receiver) {
+  gcs_grpc_read.Increment();
+  absl::Status status;
+  if (!IsValidObjectName(key)) {
+    status = absl::InvalidArgumentError("Invalid blob object name");
+  } else if (!IsValidStorageGeneration(
+                 options.generation_conditions.if_equal) ||
+             !IsValidStorageGeneration(
+                 options.generation_conditions.if_not_equal)) {
+    status = absl::InvalidArgumentError("Malformed StorageGeneration");
+  }
+  if (!status.ok()) {
+    execution::submit(ErrorSender{std::move(status)},
+                      FlowSingleReceiver{std::move(receiver)});
+    return;
+  }
+  auto task = internal::MakeIntrusivePtr<ReadStreamTask>(
+      internal::IntrusivePtr<GcsGrpcKeyValueStore>(this), std::move(options),
+      std::move(receiver));
+  task->Start(key);
+}
+
 Future<TimestampedStorageGeneration> GcsGrpcKeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   gcs_grpc_write.Increment();
+  spec_.retries->RecordRequest();
   if (!IsValidObjectName(key)) {
     return absl::InvalidArgumentError("Invalid blob object name");
   }
@@ -1127,6 +1483,7 @@ Future<TimestampedStorageGeneration> GcsGrpcKeyValueStore::Write(
 void GcsGrpcKeyValueStore::ListImpl(ListOptions options,
                                     ListReceiver receiver) {
   gcs_grpc_list.Increment();
+  spec_.retries->RecordRequest();
   if (options.range.empty()) {
     execution::set_starting(receiver, [] {});
     execution::set_done(receiver);
@@ -1142,6 +1499,7 @@ void GcsGrpcKeyValueStore::ListImpl(ListOptions options,
 
 Future<const void> GcsGrpcKeyValueStore::DeleteRange(KeyRange range) {
   gcs_grpc_delete_range.Increment();
+  spec_.retries->RecordRequest();
   if (range.empty()) return absl::OkStatus();
 
   // TODO(jbms): It could make sense to rate limit the list operation, so that
@@ -1160,6 +1518,12 @@ Future<kvstore::DriverPtr> GcsGrpcKeyValueStoreSpec::DoOpen() const {
   auto driver = internal::MakeIntrusivePtr<GcsGrpcKeyValueStore>();
   driver->spec_ = data_;
   driver->bucket_ = absl::StrFormat("projects/_/buckets/%s", data_.bucket);
+  if (data_.hedge_read_percentile) {
+    driver->read_hedger_ = std::make_unique<internal_kvstore::ReadHedger>(
+        *data_.hedge_read_percentile,
+        data_.hedge_read_budget.value_or(
+            internal_kvstore::ReadHedger::kDefaultBudget));
+  }
 
   std::string endpoint = data_.endpoint;
   if (endpoint.empty()) {
@@ -47,7 +47,9 @@
 #include "tensorstore/proto/parse_text_proto_or_die.h"
 #include "tensorstore/proto/protobuf_matchers.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/future_collecting_receiver.h"
 #include "tensorstore/util/execution/sender_testutil.h"
+#include "tensorstore/util/execution/sync_flow_sender.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status_testutil.h"
@@ -215,6 +217,63 @@ TEST_F(GcsGrpcTest, ReadWithOptions) {
       kvstore::Read(store, expected_request.object(), options).result());
 }
 
+TEST_F(GcsGrpcTest, ReadStreamResume) {
+  ReadObjectRequest expected_request = ParseTextProtoOrDie(R"pb(
+    bucket: 'projects/_/buckets/bucket'
+    object: 'abc'
+  )pb");
+
+  // After a retriable error, the read resumes from the first byte which was
+  // not delivered, pinned to the same generation.
+  ReadObjectRequest resume_request = ParseTextProtoOrDie(R"pb(
+    bucket: 'projects/_/buckets/bucket'
+    object: 'abc'
+    read_offset: 4
+    if_generation_match: 2
+  )pb");
+
+  ReadObjectResponse response1 = ParseTextProtoOrDie(R"pb(
+    metadata { generation: 2 }
+    checksummed_data { content: '1234' }
+  )pb");
+  ReadObjectResponse response2 = ParseTextProtoOrDie(R"pb(
+    metadata { generation: 2 }
+    checksummed_data { content: '5678' }
+  )pb");
+
+  ::testing::Sequence s1;
+  EXPECT_CALL(mock(), ReadObject(_, EqualsProto(expected_request), _))
+      .Times(1)
+      .InSequence(s1)
+      .WillOnce(testing::Invoke(
+          [&](auto*, auto*,
+              grpc::ServerWriter<ReadObjectResponse>* resp) -> ::grpc::Status {
+            resp->Write(response1);
+            return AbslStatusToGrpcStatus(absl::UnavailableError(""));
+          }));
+  EXPECT_CALL(mock(), ReadObject(_, EqualsProto(resume_request), _))
+      .Times(1)
+      .InSequence(s1)
+      .WillOnce(testing::Invoke(
+          [&](auto*, auto*,
+              grpc::ServerWriter<ReadObjectResponse>* resp) -> ::grpc::Status {
+            resp->Write(response2);
+            return grpc::Status::OK;
+          }));
+
+  auto store = OpenStore();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto fragments,
+      tensorstore::CollectFlowSenderIntoFuture<
+          std::vector<kvstore::ReadResult>>(tensorstore::MakeSyncFlowSender(
+          store.driver->ReadStream(expected_request.object())))
+          .result());
+  ASSERT_EQ(2, fragments.size());
+  EXPECT_EQ("1234", fragments[0].value);
+  EXPECT_EQ("5678", fragments[1].value);
+  EXPECT_EQ(StorageGeneration::FromUint64(2), fragments[1].stamp.generation);
+}
+
 TEST_F(GcsGrpcTest, Write) {
   std::vector<WriteObjectRequest> requests;
 
@@ -240,7 +240,7 @@ TEST_F(GcsGrpcTestbenchTest, BatchRead) {
   auto store = OpenStore("batch_read/");
   tensorstore::internal::BatchReadGenericCoalescingTestOptions options;
   options.coalescing_options = tensorstore::internal_kvstore_batch::
-      kDefaultRemoteStorageCoalescingOptions;
+      kMultiplexedRemoteStorageCoalescingOptions;
 
   // Don't test `target_coalesced_size` because writing a large file is too slow
   // with the fake gcs stubby implementation.
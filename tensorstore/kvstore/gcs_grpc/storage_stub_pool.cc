@@ -18,12 +18,15 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/const_init.h"
@@ -42,6 +45,8 @@
 #include "grpcpp/support/channel_arguments.h"  // third_party
 #include "tensorstore/internal/env.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/gauge.h"
 
 // protos
 #include "google/storage/v2/storage.grpc.pb.h"
@@ -55,6 +60,12 @@ ABSL_FLAG(std::optional<uint32_t>, tensorstore_gcs_grpc_channels, std::nullopt,
           "Default (and maximum) channels to use in gcs_grpc driver. "
           "Overrides TENSORSTORE_GCS_GRPC_CHANNELS.");
 
+ABSL_FLAG(std::optional<uint32_t>, tensorstore_gcs_grpc_max_channels,
+          std::nullopt,
+          "Maximum channels to which the gcs_grpc driver grows a channel pool "
+          "when every channel is saturated. "
+          "Overrides TENSORSTORE_GCS_GRPC_MAX_CHANNELS.");
+
 using ::tensorstore::internal::GetFlagOrEnvValue;
 
 namespace tensorstore {
@@ -65,6 +76,39 @@ ABSL_CONST_INIT absl::Mutex global_mu(absl::kConstInit);
 
 ABSL_CONST_INIT internal_log::VerboseFlag gcs_grpc_logging("gcs_grpc");
 
+auto& gcs_grpc_pool_channels = internal_metrics::Gauge<int64_t>::New(
+    "/tensorstore/kvstore/gcs_grpc/pool/channels",
+    "Number of channels in all gcs_grpc channel pools");
+
+auto& gcs_grpc_pool_direct_path_channels =
+    internal_metrics::Gauge<int64_t>::New(
+        "/tensorstore/kvstore/gcs_grpc/pool/direct_path_channels",
+        "Number of gcs_grpc channels connected using Direct Path");
+
+auto& gcs_grpc_pool_outstanding_rpcs = internal_metrics::Gauge<int64_t>::New(
+    "/tensorstore/kvstore/gcs_grpc/pool/outstanding_rpcs",
+    "Number of gcs_grpc stubs currently in use by an RPC");
+
+auto& gcs_grpc_pool_grow = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/gcs_grpc/pool/grow",
+    "Number of channels added to gcs_grpc channel pools because every "
+    "channel was saturated");
+
+auto& gcs_grpc_pool_unhealthy_skipped = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/gcs_grpc/pool/unhealthy_skipped",
+    "Number of times a gcs_grpc channel in TRANSIENT_FAILURE was skipped");
+
+/// Number of concurrent RPCs beyond which a channel is considered saturated.
+///
+/// This is the HTTP/2 SETTINGS_MAX_CONCURRENT_STREAMS advertised by GCS; RPCs
+/// beyond it are queued by gRPC rather than sent.
+constexpr int64_t kMaxConcurrentStreamsPerChannel = 100;
+
+bool IsDirectPathAddress(std::string_view address) {
+  return absl::StartsWith(address, "google-c2p:///") ||
+         absl::StartsWith(address, "google-c2p-experimental:///");
+}
+
 /// Returns the number of channels to use.
 /// See also the channel construction in googleapis/google-cloud-cpp repository:
 /// https://github.com/googleapis/google-cloud-cpp/blob/main/google/cloud/storage/internal/grpc_client.cc#L188
@@ -81,8 +125,7 @@ uint32_t ChannelsForAddress(std::string_view address, uint32_t num_channels) {
     return *opt;
   }
 
-  if (absl::StartsWith(address, "google-c2p:///") ||
-      absl::StartsWith(address, "google-c2p-experimental:///") ||
+  if (IsDirectPathAddress(address) ||
       absl::EndsWith(address, ".googleprod.com")) {
     // google-c2p are direct-path addresses; multiple channels are handled
     // internally in gRPC.
@@ -93,50 +136,157 @@ uint32_t ChannelsForAddress(std::string_view address, uint32_t num_channels) {
   return std::max(4u, std::thread::hardware_concurrency() / 2);
 }
 
+/// Returns the maximum number of channels to which a pool of `num_channels`
+/// channels may grow.
+uint32_t MaxChannelsForAddress(std::string_view address,
+                               uint32_t num_channels) {
+  auto opt = GetFlagOrEnvValue(FLAGS_tensorstore_gcs_grpc_max_channels,
+                               "TENSORSTORE_GCS_GRPC_MAX_CHANNELS");
+  if (opt && *opt > 0) {
+    return std::max(*opt, num_channels);
+  }
+  if (num_channels == 1) {
+    // Single channel pools (e.g. direct-path) rely on gRPC to open additional
+    // connections internally.
+    return 1;
+  }
+  return 4 * num_channels;
+}
+
 }  // namespace
 
 StorageStubPool::StorageStubPool(
     std::string address, uint32_t size,
     std::shared_ptr<::grpc::ChannelCredentials> creds)
-    : address_(std::move(address)) {
+    : address_(std::move(address)), creds_(std::move(creds)) {
   size = ChannelsForAddress(address_, size);
-  channels_.resize(size);
-  stubs_.resize(size);
+  max_size_ = MaxChannelsForAddress(address_, size);
 
   ABSL_LOG_IF(INFO, gcs_grpc_logging)
-      << "Connecting to " << address_ << " with " << size << " channels";
+      << "Connecting to " << address_ << " with " << size
+      << " channels (maximum " << max_size_ << ")";
 
-  bool use_subchannel_pool =
+  use_subchannel_pool_ =
       GetFlagOrEnvValue(FLAGS_tensorstore_gcs_grpc_use_local_subchannel_pool,
                         "TENSORSTORE_GCS_GRPC_USE_LOCAL_SUBCHANNEL_POOL")
           .value_or(false);
-  for (int id = 0; id < channels_.size(); id++) {
-    // See google cloud storage client in:
-    // https://github.com/googleapis/google-cloud-cpp/blob/main/google/cloud/storage/internal/storage_stub_factory.cc
-    auto args = grpc::ChannelArguments();
-    if (size > 1 && use_subchannel_pool) {
-      args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
-      args.SetInt(GRPC_ARG_CHANNEL_ID, id);
-      args.SetInt(GRPC_ARG_DNS_ENABLE_SRV_QUERIES, 0);
+  absl::MutexLock lock(&mutex_);
+  channels_.reserve(size);
+  for (uint32_t id = 0; id < size; id++) {
+    AddChannel();
+  }
+}
+
+StorageStubPool::Channel* StorageStubPool::AddChannel() {
+  const int id = static_cast<int>(channels_.size());
+  // See google cloud storage client in:
+  // https://github.com/googleapis/google-cloud-cpp/blob/main/google/cloud/storage/internal/storage_stub_factory.cc
+  auto args = grpc::ChannelArguments();
+  if (max_size_ > 1 && use_subchannel_pool_) {
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    args.SetInt(GRPC_ARG_CHANNEL_ID, id);
+    args.SetInt(GRPC_ARG_DNS_ENABLE_SRV_QUERIES, 0);
+  }
+  auto channel = std::make_unique<Channel>();
+  channel->channel = grpc::CreateCustomChannel(address_, creds_, args);
+  channel->stub = Storage::NewStub(channel->channel);
+  channels_.push_back(std::move(channel));
+  gcs_grpc_pool_channels.Increment();
+  if (IsDirectPathAddress(address_)) {
+    gcs_grpc_pool_direct_path_channels.Increment();
+  }
+  return channels_.back().get();
+}
+
+size_t StorageStubPool::size() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return channels_.size();
+}
+
+StorageStubPool::Channel* StorageStubPool::FindLeastLoaded(
+    const Channel* exclude) const {
+  // Start at a rotating offset so that ties are broken round-robin.
+  const size_t n = channels_.size();
+  const size_t start = next_channel_index_.fetch_add(1);
+  Channel* best = nullptr;
+  int64_t best_outstanding = std::numeric_limits<int64_t>::max();
+  for (size_t i = 0; i < n; ++i) {
+    Channel* channel = channels_[(start + i) % n].get();
+    if (channel == exclude) continue;
+    int64_t outstanding = channel->outstanding.load(std::memory_order_relaxed);
+    if (outstanding < best_outstanding) {
+      best = channel;
+      best_outstanding = outstanding;
+      if (outstanding == 0) break;
     }
-    channels_[id] = grpc::CreateCustomChannel(address_, creds, args);
-    stubs_[id] = Storage::NewStub(channels_[id]);
   }
+  return best;
+}
+
+std::shared_ptr<StorageStubPool::Storage::StubInterface>
+StorageStubPool::get_next_stub() {
+  Channel* channel;
+  bool saturated;
+  size_t observed_size;
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    observed_size = channels_.size();
+    channel = FindLeastLoaded(nullptr);
+    if (observed_size > 1 && channel->channel->GetState(false) ==
+                                 GRPC_CHANNEL_TRANSIENT_FAILURE) {
+      gcs_grpc_pool_unhealthy_skipped.Increment();
+      channel = FindLeastLoaded(channel);
+    }
+    saturated = channel->outstanding.load(std::memory_order_relaxed) >=
+                kMaxConcurrentStreamsPerChannel;
+  }
+  if (saturated && observed_size < max_size_) {
+    absl::MutexLock lock(&mutex_);
+    // Another thread may already have grown the pool.
+    if (channels_.size() == observed_size) {
+      channel = AddChannel();
+      gcs_grpc_pool_grow.Increment();
+      ABSL_LOG_IF(INFO, gcs_grpc_logging)
+          << "Growing channel pool for " << address_ << " to "
+          << channels_.size() << " channels";
+    }
+  }
+  channel->outstanding.fetch_add(1, std::memory_order_relaxed);
+  gcs_grpc_pool_outstanding_rpcs.Increment();
+  // The returned pointer shares ownership of the stub, and releases the RPC
+  // slot on the channel when it is destroyed.
+  return std::shared_ptr<Storage::StubInterface>(
+      channel->stub.get(),
+      [channel, stub = channel->stub](Storage::StubInterface*) {
+        channel->outstanding.fetch_sub(1, std::memory_order_relaxed);
+        gcs_grpc_pool_outstanding_rpcs.Decrement();
+      });
+}
+
+std::vector<int64_t> StorageStubPool::GetOutstandingRpcs() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  std::vector<int64_t> result;
+  result.reserve(channels_.size());
+  for (const auto& channel : channels_) {
+    result.push_back(channel->outstanding.load(std::memory_order_relaxed));
+  }
+  return result;
 }
 
 void StorageStubPool::WaitForConnected(absl::Duration duration) {
+  absl::ReaderMutexLock lock(&mutex_);
   for (auto& channel : channels_) {
-    channel->GetState(true);
+    channel->channel->GetState(true);
   }
   if (duration > absl::ZeroDuration()) {
     auto timeout = absl::ToChronoTime(absl::Now() + duration);
     for (auto& channel : channels_) {
-      channel->WaitForConnected(timeout);
+      channel->channel->WaitForConnected(timeout);
     }
   }
   ABSL_LOG_IF(INFO, gcs_grpc_logging)
       << "Connection established to " << address_ << " in state "
-      << channels_[0]->GetState(false);
+      << channels_[0]->channel->GetState(false);
 }
 
 std::shared_ptr<StorageStubPool> GetSharedStorageStubPool(
@@ -17,11 +17,14 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "google/storage/v2/storage.grpc.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "grpcpp/channel.h"  // third_party
 #include "grpcpp/security/credentials.h"  // third_party
@@ -30,6 +33,11 @@ namespace tensorstore {
 namespace internal_gcs_grpc {
 
 // A gRPC ConnectionPool for Storage stubs.
+//
+// Each call to `get_next_stub` returns the stub of the channel with the fewest
+// outstanding RPCs, skipping channels in TRANSIENT_FAILURE.  When every
+// channel has reached the HTTP/2 concurrent stream limit, the pool grows by
+// one channel, up to `max_size()` channels.
 class StorageStubPool {
   using Storage = ::google::storage::v2::Storage;
 
@@ -39,23 +47,45 @@ class StorageStubPool {
 
   // Accessors
   const std::string& address() const { return address_; }
-  size_t size() const { return stubs_.size(); }
+  size_t size() const ABSL_LOCKS_EXCLUDED(mutex_);
+  size_t max_size() const { return max_size_; }
+
+  // Least-loaded stub acquisition.
+  //
+  // The returned stub counts as one outstanding RPC on its channel until it is
+  // released, so it should be held for the duration of a single call.
+  std::shared_ptr<Storage::StubInterface> get_next_stub()
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
-  // Round-robin stub acquisition.
-  std::shared_ptr<Storage::StubInterface> get_next_stub() const {
-    size_t id = (stubs_.size() > 1)
-                    ? (next_channel_index_.fetch_add(1) % stubs_.size())
-                    : 0;
-    return stubs_[id];
-  }
+  // Returns the number of outstanding RPCs on each channel.
+  std::vector<int64_t> GetOutstandingRpcs() const ABSL_LOCKS_EXCLUDED(mutex_);
 
   // Wait for the channels to resolve to the Connected state.
-  void WaitForConnected(absl::Duration duration);
+  void WaitForConnected(absl::Duration duration) ABSL_LOCKS_EXCLUDED(mutex_);
 
  private:
+  struct Channel {
+    std::shared_ptr<grpc::Channel> channel;
+    std::shared_ptr<Storage::StubInterface> stub;
+    std::atomic<int64_t> outstanding{0};
+  };
+
+  // Returns the least loaded channel other than `exclude`, or nullptr.
+  Channel* FindLeastLoaded(const Channel* exclude) const
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+
+  // Adds a new channel to the pool.
+  Channel* AddChannel() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   std::string address_;
-  std::vector<std::shared_ptr<Storage::StubInterface>> stubs_;
-  std::vector<std::shared_ptr<grpc::Channel>> channels_;
+  std::shared_ptr<::grpc::ChannelCredentials> creds_;
+  bool use_subchannel_pool_;
+  size_t max_size_;
+
+  mutable absl::Mutex mutex_;
+  // Channels are never removed, so pointers to them remain valid for the
+  // lifetime of the pool.
+  std::vector<std::unique_ptr<Channel>> channels_ ABSL_GUARDED_BY(mutex_);
   mutable std::atomic<size_t> next_channel_index_ = 0;
 };
 
@@ -0,0 +1,226 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "tensorstore/internal/http/http_header.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_kvstore_gcs_http {
+namespace {
+
+using ::tensorstore::internal_http::AppendHeaderData;
+using ::tensorstore::internal_http::HttpResponse;
+
+using HeaderMap = absl::btree_multimap<std::string, std::string>;
+
+// Splits an HTTP message into the header block, including the CRLF which
+// terminates the final header, and the body.
+std::pair<std::string_view, std::string_view> SplitHeaderBlock(
+    std::string_view message) {
+  if (absl::StartsWith(message, "\r\n")) {
+    return {std::string_view(), message.substr(2)};
+  }
+  size_t pos = message.find("\r\n\r\n");
+  if (pos == std::string_view::npos) return {message, std::string_view()};
+  return {message.substr(0, pos + 2), message.substr(pos + 4)};
+}
+
+// Removes and returns the first line of `message`.
+std::string_view ConsumeLine(std::string_view& message) {
+  size_t pos = message.find("\r\n");
+  std::string_view line = message.substr(0, pos);
+  message.remove_prefix(pos == std::string_view::npos ? message.size()
+                                                      : pos + 2);
+  return line;
+}
+
+// Returns the index encoded in a "Content-ID" header of the form
+// "<item+N>" (request) or "<response-item+N>" (response).
+std::optional<size_t> GetContentIdIndex(const HeaderMap& headers) {
+  auto it = headers.find("content-id");
+  if (it == headers.end()) return std::nullopt;
+  std::string_view id = it->second;
+  absl::ConsumeSuffix(&id, ">");
+  size_t pos = id.rfind('+');
+  size_t index;
+  if (pos == std::string_view::npos ||
+      !absl::SimpleAtoi(id.substr(pos + 1), &index)) {
+    return std::nullopt;
+  }
+  return index;
+}
+
+}  // namespace
+
+std::string BatchRequestContentType() {
+  return tensorstore::StrCat("multipart/mixed; boundary=",
+                             kBatchRequestBoundary);
+}
+
+absl::Cord BuildBatchRequestPayload(span<const BatchRequestPart> parts) {
+  std::string payload;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    absl::StrAppend(&payload, "--", kBatchRequestBoundary, "\r\n",
+                    "Content-Type: application/http\r\n",
+                    "Content-ID: <item+", i, ">\r\n\r\n",  //
+                    parts[i].method, " ", parts[i].path, " HTTP/1.1\r\n\r\n");
+  }
+  absl::StrAppend(&payload, "--", kBatchRequestBoundary, "--\r\n");
+  return absl::Cord(std::move(payload));
+}
+
+Result<std::vector<std::string_view>> SplitMultipartPayload(
+    std::string_view content_type, std::string_view payload) {
+  size_t pos = content_type.find("boundary=");
+  if (pos == std::string_view::npos) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Missing multipart boundary in content-type: ", content_type));
+  }
+  std::string_view boundary = content_type.substr(pos + 9);
+  boundary = absl::StripAsciiWhitespace(boundary.substr(0, boundary.find(';')));
+  if (boundary.size() >= 2 && boundary.front() == '"' &&
+      boundary.back() == '"') {
+    boundary = boundary.substr(1, boundary.size() - 2);
+  }
+  if (boundary.empty()) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Empty multipart boundary in content-type: ", content_type));
+  }
+
+  const std::string delimiter = tensorstore::StrCat("\r\n--", boundary);
+  std::string_view first_delimiter = std::string_view(delimiter).substr(2);
+  pos = payload.find(first_delimiter);
+  if (pos == std::string_view::npos) {
+    return absl::InvalidArgumentError("Multipart payload has no parts");
+  }
+  pos += first_delimiter.size();
+
+  std::vector<std::string_view> parts;
+  while (!absl::StartsWith(payload.substr(pos), "--")) {
+    // Skip any transport padding following the delimiter.
+    size_t start = payload.find("\r\n", pos);
+    if (start == std::string_view::npos) break;
+    start += 2;
+    size_t end = payload.find(delimiter, start);
+    if (end == std::string_view::npos) {
+      return absl::InvalidArgumentError("Unterminated multipart payload");
+    }
+    parts.push_back(payload.substr(start, end - start));
+    pos = end + delimiter.size();
+  }
+  return parts;
+}
+
+Result<std::vector<BatchRequestPart>> ParseBatchRequestPayload(
+    std::string_view content_type, std::string_view payload) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto parts,
+                               SplitMultipartPayload(content_type, payload));
+  std::vector<BatchRequestPart> requests(parts.size());
+  std::vector<bool> seen(parts.size());
+  for (size_t i = 0; i < parts.size(); ++i) {
+    auto [header_block, message] = SplitHeaderBlock(parts[i]);
+    HeaderMap headers;
+    AppendHeaderData(headers, header_block);
+    size_t index = GetContentIdIndex(headers).value_or(i);
+    if (index >= parts.size() || seen[index]) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Invalid batch request part ", i));
+    }
+    seen[index] = true;
+
+    // "METHOD path HTTP/1.1"
+    std::vector<std::string_view> tokens =
+        absl::StrSplit(ConsumeLine(message), ' ');
+    if (tokens.size() != 3) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Invalid batch request part ", i));
+    }
+    requests[index].method = std::string(tokens[0]);
+    requests[index].path = std::string(tokens[1]);
+  }
+  return requests;
+}
+
+Result<std::vector<HttpResponse>> ParseBatchResponse(
+    const HttpResponse& response, size_t num_parts) {
+  auto content_type = response.headers.find("content-type");
+  if (content_type == response.headers.end()) {
+    return absl::InvalidArgumentError(
+        "Batch response is missing a content-type header");
+  }
+  std::string payload(response.payload);
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto parts, SplitMultipartPayload(content_type->second, payload));
+
+  // A status_code of 0 marks a part which has not been seen.
+  std::vector<HttpResponse> responses(num_parts,
+                                      HttpResponse{0, absl::Cord()});
+  for (size_t i = 0; i < parts.size(); ++i) {
+    auto [header_block, message] = SplitHeaderBlock(parts[i]);
+    HeaderMap headers;
+    AppendHeaderData(headers, header_block);
+    size_t index = GetContentIdIndex(headers).value_or(i);
+    if (index >= num_parts || responses[index].status_code != 0) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Unexpected batch response part ", i));
+    }
+
+    // "HTTP/1.1 204 No Content"
+    std::vector<std::string_view> tokens =
+        absl::StrSplit(ConsumeLine(message), absl::MaxSplits(' ', 2));
+    int32_t status_code;
+    if (tokens.size() < 2 || !absl::SimpleAtoi(tokens[1], &status_code) ||
+        status_code <= 0) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Invalid status line in batch response part ", i));
+    }
+    auto [part_header_block, body] = SplitHeaderBlock(message);
+    auto& part_response = responses[index];
+    part_response.status_code = status_code;
+    AppendHeaderData(part_response.headers, part_header_block);
+    part_response.payload = absl::Cord(body);
+  }
+  for (size_t i = 0; i < num_parts; ++i) {
+    if (responses[i].status_code == 0) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Batch response is missing part ", i));
+    }
+  }
+  return responses;
+}
+
+}  // namespace internal_kvstore_gcs_http
+}  // namespace tensorstore
@@ -0,0 +1,78 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_GCS_HTTP_BATCH_REQUEST_H_
+#define TENSORSTORE_KVSTORE_GCS_HTTP_BATCH_REQUEST_H_
+
+/// \file
+/// Encoding and decoding of GCS JSON API batch requests.
+///
+/// https://cloud.google.com/storage/docs/batch
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_kvstore_gcs_http {
+
+/// Maximum number of requests which GCS accepts in a single batch.
+inline constexpr size_t kMaxBatchRequestParts = 100;
+
+/// Multipart boundary used for batch request payloads.  Request paths are
+/// percent-encoded, so the boundary cannot occur within a part.
+inline constexpr std::string_view kBatchRequestBoundary =
+    "tensorstore_batch_boundary";
+
+/// A single request within a batch request.
+struct BatchRequestPart {
+  std::string method;
+
+  /// Absolute request path, including any query string, e.g.
+  /// "/storage/v1/b/bucket/o/object?userProject=project".
+  std::string path;
+};
+
+/// Returns the "content-type" header value of a batch request payload.
+std::string BatchRequestContentType();
+
+/// Encodes `parts` as a multipart/mixed batch request payload.  The
+/// "Content-ID" of each part encodes its index in `parts`.
+absl::Cord BuildBatchRequestPayload(span<const BatchRequestPart> parts);
+
+/// Decodes a payload produced by `BuildBatchRequestPayload`.
+Result<std::vector<BatchRequestPart>> ParseBatchRequestPayload(
+    std::string_view content_type, std::string_view payload);
+
+/// Splits a multipart payload into its parts, using the boundary specified by
+/// `content_type`.
+Result<std::vector<std::string_view>> SplitMultipartPayload(
+    std::string_view content_type, std::string_view payload);
+
+/// Decodes the response to a batch request of `num_parts` requests.  The
+/// returned vector is indexed in request order.
+Result<std::vector<internal_http::HttpResponse>> ParseBatchResponse(
+    const internal_http::HttpResponse& response, size_t num_parts);
+
+}  // namespace internal_kvstore_gcs_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_GCS_HTTP_BATCH_REQUEST_H_
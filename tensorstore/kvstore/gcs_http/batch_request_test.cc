@@ -0,0 +1,99 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::StatusIs;
+using ::tensorstore::internal_http::HttpResponse;
+using ::tensorstore::internal_kvstore_gcs_http::BatchRequestContentType;
+using ::tensorstore::internal_kvstore_gcs_http::BatchRequestPart;
+using ::tensorstore::internal_kvstore_gcs_http::BuildBatchRequestPayload;
+using ::tensorstore::internal_kvstore_gcs_http::ParseBatchRequestPayload;
+using ::tensorstore::internal_kvstore_gcs_http::ParseBatchResponse;
+
+TEST(BatchRequestTest, RoundTrip) {
+  std::vector<BatchRequestPart> parts{
+      {"DELETE", "/storage/v1/b/bucket/o/a"},
+      {"DELETE", "/storage/v1/b/bucket/o/b%2Fc?userProject=p"},
+  };
+  std::string payload(BuildBatchRequestPayload(parts));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto parsed, ParseBatchRequestPayload(BatchRequestContentType(), payload));
+  ASSERT_EQ(2, parsed.size());
+  EXPECT_EQ("DELETE", parsed[0].method);
+  EXPECT_EQ("/storage/v1/b/bucket/o/a", parsed[0].path);
+  EXPECT_EQ("DELETE", parsed[1].method);
+  EXPECT_EQ("/storage/v1/b/bucket/o/b%2Fc?userProject=p", parsed[1].path);
+}
+
+TEST(BatchRequestTest, ParseResponse) {
+  // Parts may be returned out of order; the Content-ID identifies them.
+  HttpResponse response{
+      200, absl::Cord("--batch_abc\r\n"
+                      "Content-Type: application/http\r\n"
+                      "Content-ID: <response-item+1>\r\n"
+                      "\r\n"
+                      "HTTP/1.1 404 Not Found\r\n"
+                      "Content-Type: application/json\r\n"
+                      "\r\n"
+                      "{\"error\": {\"code\": 404}}\r\n"
+                      "--batch_abc\r\n"
+                      "Content-Type: application/http\r\n"
+                      "Content-ID: <response-item+0>\r\n"
+                      "\r\n"
+                      "HTTP/1.1 204 No Content\r\n"
+                      "Content-Length: 0\r\n"
+                      "\r\n"
+                      "\r\n"
+                      "--batch_abc--\r\n")};
+  response.headers.emplace("content-type",
+                           "multipart/mixed; boundary=batch_abc");
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto parts, ParseBatchResponse(response, 2));
+  ASSERT_EQ(2, parts.size());
+  EXPECT_EQ(204, parts[0].status_code);
+  EXPECT_EQ(404, parts[1].status_code);
+  EXPECT_EQ("{\"error\": {\"code\": 404}}", parts[1].payload);
+  EXPECT_THAT(parts[1].headers,
+              ::testing::Contains(
+                  ::testing::Pair("content-type", "application/json")));
+}
+
+TEST(BatchRequestTest, ParseResponseMissingPart) {
+  HttpResponse response{200, absl::Cord("--b\r\n"
+                                        "Content-ID: <response-item+0>\r\n"
+                                        "\r\n"
+                                        "HTTP/1.1 204 No Content\r\n"
+                                        "\r\n"
+                                        "\r\n"
+                                        "--b--\r\n")};
+  response.headers.emplace("content-type", "multipart/mixed; boundary=\"b\"");
+  EXPECT_THAT(ParseBatchResponse(response, 2),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  TENSORSTORE_EXPECT_OK(ParseBatchResponse(response, 1));
+}
+
+}  // namespace
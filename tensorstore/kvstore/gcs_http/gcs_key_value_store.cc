@@ -15,12 +15,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -31,6 +33,7 @@
 #include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
@@ -40,6 +43,7 @@
 #include "tensorstore/context.h"
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
+#include "tensorstore/internal/deadline.h"
 #include "tensorstore/internal/env.h"
 #include "tensorstore/internal/http/curl_transport.h"
 #include "tensorstore/internal/http/http_request.h"
@@ -50,40 +54,54 @@
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/memory_budget.h"
+#include "tensorstore/internal/memory_budget_resource.h"
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/oauth2/auth_provider.h"
 #include "tensorstore/internal/oauth2/google_auth_provider.h"
 #include "tensorstore/internal/path.h"
+#include "tensorstore/internal/rate_limiter/admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/retries_context_resource.h"
 #include "tensorstore/internal/source_location.h"
 #include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/internal/tracing/inflight_operation.h"
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/gcs/gcs_resource.h"
 #include "tensorstore/kvstore/gcs/validate.h"
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
 #include "tensorstore/kvstore/gcs_http/gcs_resource.h"
 #include "tensorstore/kvstore/gcs_http/object_metadata.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/generic_coalescing_batch_util.h"
+#include "tensorstore/kvstore/hedged_read.h"
 #include "tensorstore/kvstore/http/byte_range_util.h"
+#include "tensorstore/kvstore/http/parallel_read.h"
 #include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_ahead_scan.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/segmented_list.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/url_registry.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -113,6 +131,8 @@ ABSL_FLAG(std::optional<std::string>, tensorstore_gcs_http_version,
 using ::tensorstore::internal::DataCopyConcurrencyResource;
 using ::tensorstore::internal::GetFlagOrEnvValue;
 using ::tensorstore::internal::IntrusivePtr;
+using ::tensorstore::internal::MemoryBudget;
+using ::tensorstore::internal::MemoryBudgetResource;
 using ::tensorstore::internal::NoRateLimiter;
 using ::tensorstore::internal::RateLimiter;
 using ::tensorstore::internal::RateLimiterNode;
@@ -122,9 +142,14 @@ using ::tensorstore::internal_http::HttpRequestBuilder;
 using ::tensorstore::internal_http::HttpResponse;
 using ::tensorstore::internal_http::HttpTransport;
 using ::tensorstore::internal_http::IssueRequestOptions;
+using ::tensorstore::internal_kvstore_gcs_http::BatchRequestContentType;
+using ::tensorstore::internal_kvstore_gcs_http::BatchRequestPart;
+using ::tensorstore::internal_kvstore_gcs_http::BuildBatchRequestPayload;
 using ::tensorstore::internal_kvstore_gcs_http::GcsConcurrencyResource;
 using ::tensorstore::internal_kvstore_gcs_http::GcsRateLimiterResource;
+using ::tensorstore::internal_kvstore_gcs_http::kMaxBatchRequestParts;
 using ::tensorstore::internal_kvstore_gcs_http::ObjectMetadata;
+using ::tensorstore::internal_kvstore_gcs_http::ParseBatchResponse;
 using ::tensorstore::internal_kvstore_gcs_http::ParseObjectMetadata;
 using ::tensorstore::internal_storage_gcs::GcsRequestRetries;
 using ::tensorstore::internal_storage_gcs::GcsUserProjectResource;
@@ -161,6 +186,9 @@ auto& gcs_retries = internal_metrics::Counter<int64_t>::New(
 auto& gcs_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/gcs/read", "GCS driver kvstore::Read calls");
 
+auto& gcs_stat = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/gcs/stat", "GCS driver kvstore::Stat calls");
+
 auto& gcs_batch_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/gcs/batch_read", "gcs driver reads after batching");
 
@@ -181,6 +209,14 @@ auto& gcs_delete_range = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/gcs/delete_range",
     "GCS driver kvstore::DeleteRange calls");
 
+auto& gcs_batch_delete = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/gcs/batch_delete",
+    "GCS driver batch requests issued by kvstore::DeleteRange");
+
+auto& gcs_copy_range = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/gcs/copy_range",
+    "GCS driver kvstore::ExperimentalCopyRange calls");
+
 auto& gcs_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/gcs/list", "GCS driver kvstore::List calls");
 
@@ -240,6 +276,20 @@ bool AddGenerationParam(std::string* url, const bool has_query,
   }
 }
 
+/// Returns the number of requests which may be multiplexed over a connection
+/// to the GCS endpoint.  Curl negotiates HTTP/2 for https urls unless HTTP/1.1
+/// is requested.
+int32_t GetMaxConcurrentStreams(const HttpTransport& transport) {
+  using HttpVersion = IssueRequestOptions::HttpVersion;
+  const auto version = GetHttpVersion();
+  if (version == HttpVersion::kHttp2PriorKnowledge ||
+      (version != HttpVersion::kHttp1 &&
+       absl::StartsWith(GetGcsBaseUrl(), "https://"))) {
+    return transport.max_concurrent_streams();
+  }
+  return 1;
+}
+
 /// Adds the userProject query parameter to the provided url.
 bool AddUserProjectParam(std::string* url, const bool has_query,
                          std::string_view encoded_user_project) {
@@ -275,10 +325,32 @@ struct GcsKeyValueStoreSpecData {
   Context::Resource<GcsUserProjectResource> user_project;
   Context::Resource<GcsRequestRetries> retries;
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency;
+  Context::Resource<MemoryBudgetResource> memory_budget;
+
+  /// Reads larger than this size are split into concurrent requests of at most
+  /// this size.
+  std::optional<int64_t> parallel_read_part_size;
+
+  /// Writes larger than this size are uploaded as concurrent parts of at least
+  /// this size, which are then composed into the final object.
+  std::optional<int64_t> parallel_upload_part_size;
+
+  /// Reads which have not completed after this percentile of recent read
+  /// latencies are duplicated.
+  std::optional<double> hedge_read_percentile;
+
+  /// Maximum fraction of reads which are duplicated.
+  std::optional<double> hedge_read_budget;
+
+  /// Ranges with multiple top-level prefixes are listed as this many
+  /// concurrent prefix listings.
+  std::optional<int64_t> list_concurrency;
 
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
     return f(x.bucket, x.request_concurrency, x.rate_limiter, x.user_project,
-             x.retries, x.data_copy_concurrency);
+             x.retries, x.data_copy_concurrency, x.memory_budget,
+             x.parallel_read_part_size, x.parallel_upload_part_size,
+             x.hedge_read_percentile, x.hedge_read_budget, x.list_concurrency);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -309,7 +381,28 @@ struct GcsKeyValueStoreSpecData {
                  jb::Projection<&GcsKeyValueStoreSpecData::retries>()),
       jb::Member(DataCopyConcurrencyResource::id,
                  jb::Projection<
-                     &GcsKeyValueStoreSpecData::data_copy_concurrency>()) /**/
+                     &GcsKeyValueStoreSpecData::data_copy_concurrency>()),
+      jb::Member(MemoryBudgetResource::id,
+                 jb::Projection<&GcsKeyValueStoreSpecData::memory_budget>()),
+      jb::Member("parallel_read_part_size",
+                 jb::Projection<
+                     &GcsKeyValueStoreSpecData::parallel_read_part_size>(
+                     jb::Optional(jb::Integer<int64_t>(1)))),
+      jb::Member("parallel_upload_part_size",
+                 jb::Projection<
+                     &GcsKeyValueStoreSpecData::parallel_upload_part_size>(
+                     jb::Optional(jb::Integer<int64_t>(1)))),
+      jb::Member(
+          "hedge_read_percentile",
+          jb::Projection<&GcsKeyValueStoreSpecData::hedge_read_percentile>(
+              jb::Optional(internal_kvstore::HedgeReadPercentileBinder()))),
+      jb::Member(
+          "hedge_read_budget",
+          jb::Projection<&GcsKeyValueStoreSpecData::hedge_read_budget>(
+              jb::Optional(internal_kvstore::HedgeReadBudgetBinder()))),
+      jb::Member("list_concurrency",
+                 jb::Projection<&GcsKeyValueStoreSpecData::list_concurrency>(
+                     jb::Optional(jb::Integer<int64_t>(1)))) /**/
   );
 };
 
@@ -350,21 +443,50 @@ class GcsKeyValueStore
 
   internal_kvstore_batch::CoalescingOptions GetBatchReadCoalescingOptions()
       const {
-    return internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions;
+    return coalescing_options_;
   }
 
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
   Future<ReadResult> ReadImpl(Key&& key, ReadOptions&& options);
 
+  /// Issues a single read request for `resource`.
+  Future<ReadResult> IssueRead(std::string resource, ReadOptions options);
+
+  /// Reads part of a value for `internal_http::ReadInParts`.
+  Future<internal_http::ReadPartResult> ReadPart(std::string resource,
+                                                 ReadOptions options);
+
+  /// Issues a metadata request, which returns the size of the object.
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
                                              WriteOptions options) override;
 
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
+  /// Objects are listed in key order, such that values may be read while the
+  /// listing is in progress.
+  void ScanImpl(ScanOptions options, ScanReceiver receiver) override {
+    internal_kvstore::ReadAheadScan(kvstore::DriverPtr(this),
+                                    std::move(options), std::move(receiver),
+                                    /*ordered_list=*/true);
+  }
+
+  /// Lists `options.range`.  If `discover_prefixes` is `true`, first lists
+  /// the top-level prefixes of the range, which are then listed concurrently.
+  void StartList(ListOptions options, ListReceiver receiver,
+                 bool discover_prefixes);
+
   Future<const void> DeleteRange(KeyRange range) override;
 
+  /// Copies objects from another GCS bucket (or this one) using server-side
+  /// rewrites, so that the data is never transferred through the client.
+  Future<const void> ExperimentalCopyRangeFrom(
+      const internal::OpenTransactionPtr& transaction, const KvStore& source,
+      Key target_prefix, kvstore::CopyRangeOptions options) override;
+
   /// Returns the Auth header for a GCS request.
   Result<std::optional<std::string>> GetAuthHeader() {
     absl::MutexLock lock(&auth_provider_mutex_);
@@ -390,6 +512,10 @@ class GcsKeyValueStore
     return spec_.data_copy_concurrency->executor;
   }
 
+  const IntrusivePtr<MemoryBudget>& memory_budget() const {
+    return spec_.memory_budget->budget;
+  }
+
   RateLimiter& read_rate_limiter() {
     if (spec_.rate_limiter.has_value()) {
       return *(spec_.rate_limiter.value()->read_limiter);
@@ -403,7 +529,9 @@ class GcsKeyValueStore
     return no_rate_limiter_;
   }
 
-  RateLimiter& admission_queue() { return *spec_.request_concurrency->queue; }
+  internal::AdmissionQueue& admission_queue() {
+    return *spec_.request_concurrency->queue;
+  }
 
   absl::Status GetBoundSpecData(SpecData& spec) const {
     spec = spec_;
@@ -424,18 +552,35 @@ class GcsKeyValueStore
   // Returns whether the task will be retried. On false, max retries have
   // been met or exceeded.  On true, `task->Retry()` will be scheduled to run
   // after a suitable backoff period.
+  //
+  // Retries that could not start before `deadline` are not scheduled.
   template <typename Task>
   absl::Status BackoffForAttemptAsync(
       absl::Status status, int attempt, Task* task,
+      absl::Time deadline = absl::InfiniteFuture(),
       SourceLocation loc = ::tensorstore::SourceLocation::current()) {
     assert(task != nullptr);
-    auto delay = spec_.retries->BackoffForAttempt(attempt);
+    if (absl::IsUnavailable(status) || absl::IsResourceExhausted(status)) {
+      // Includes HTTP 429 and 503 responses, which indicate that requests
+      // should be issued less aggressively.
+      admission_queue().ReportOverload();
+    }
+    auto delay = spec_.retries->BackoffForAttempt(attempt, deadline);
+    if (!delay && attempt < spec_.retries->max_retries) {
+      return MaybeAnnotateStatus(std::move(status),
+                                 "Retry would not start before the deadline",
+                                 absl::StatusCode::kDeadlineExceeded, loc);
+    }
     if (!delay) {
       return MaybeAnnotateStatus(std::move(status),
                                  absl::StrFormat("All %d retry attempts failed",
                                                  spec_.retries->max_retries),
                                  absl::StatusCode::kAborted, loc);
     }
+    if (!spec_.retries->TryRetry()) {
+      return MaybeAnnotateStatus(std::move(status), "Retry budget exhausted",
+                                 absl::StatusCode::kAborted, loc);
+    }
 
     gcs_retries.Increment();
     ScheduleAt(absl::Now() + *delay,
@@ -453,6 +598,10 @@ class GcsKeyValueStore
   NoRateLimiter no_rate_limiter_;
 
   std::shared_ptr<HttpTransport> transport_;
+  internal_kvstore_batch::CoalescingOptions coalescing_options_;
+
+  // Set if `hedge_read_percentile` is specified.
+  std::unique_ptr<internal_kvstore::ReadHedger> read_hedger_;
 
   absl::Mutex auth_provider_mutex_;
   // Optional state indicates whether the provider has been obtained.  A
@@ -466,6 +615,15 @@ Future<kvstore::DriverPtr> GcsKeyValueStoreSpec::DoOpen() const {
   driver->resource_root_ = BucketResourceRoot(data_.bucket);
   driver->upload_root_ = BucketUploadRoot(data_.bucket);
   driver->transport_ = internal_http::GetDefaultHttpTransport();
+  driver->coalescing_options_ =
+      internal_kvstore_batch::GetRemoteStorageCoalescingOptions(
+          GetMaxConcurrentStreams(*driver->transport_));
+  if (data_.hedge_read_percentile) {
+    driver->read_hedger_ = std::make_unique<internal_kvstore::ReadHedger>(
+        *data_.hedge_read_percentile,
+        data_.hedge_read_budget.value_or(
+            internal_kvstore::ReadHedger::kDefaultBudget));
+  }
 
   // NOTE: Remove temporary logging use of experimental feature.
   if (data_.rate_limiter.has_value()) {
@@ -478,6 +636,22 @@ Future<kvstore::DriverPtr> GcsKeyValueStoreSpec::DoOpen() const {
   return driver;
 }
 
+/// Returns a random 128-bit identifier as a hex string.
+std::string GetRandomId() {
+  struct RandomState {
+    absl::Mutex mutex;
+    absl::BitGen gen ABSL_GUARDED_BY(mutex);
+  };
+  static RandomState random_state;
+  uint64_t uuid[2];
+  absl::MutexLock lock(&random_state.mutex);
+  for (auto& x : uuid) {
+    x = absl::Uniform<uint64_t>(random_state.gen);
+  }
+  return tensorstore::StrCat(absl::Hex(uuid[0], absl::kZeroPad16),
+                             absl::Hex(uuid[1], absl::kZeroPad16));
+}
+
 // GCS does not follow HTTP spec as far as respecting `cache-control` request
 // headers.
 //
@@ -490,19 +664,7 @@ Future<kvstore::DriverPtr> GcsKeyValueStoreSpec::DoOpen() const {
 // As a workaround, specify a unique query parameter in every request.  That
 // ensures the cache is bypassed.
 void AddUniqueQueryParameterToDisableCaching(std::string& url) {
-  struct RandomState {
-    absl::Mutex mutex;
-    absl::BitGen gen ABSL_GUARDED_BY(mutex);
-  };
-  static RandomState random_state;
-  uint64_t uuid[2];
-  absl::MutexLock lock(&random_state.mutex);
-  for (auto& x : uuid) {
-    x = absl::Uniform<uint64_t>(random_state.gen);
-  }
-  tensorstore::StrAppend(&url,
-                         "&tensorstore=", absl::Hex(uuid[0], absl::kZeroPad16),
-                         absl::Hex(uuid[1], absl::kZeroPad16));
+  tensorstore::StrAppend(&url, "&tensorstore=", GetRandomId());
 }
 
 ////////////////////////////////////////////////////
@@ -518,19 +680,67 @@ struct ReadTask : public RateLimiterNode,
 
   int attempt_ = 0;
   absl::Time start_time_;
+  internal_kvstore::KvStoreOperationTimer timer_{"gcs", "read"};
+  internal_tracing::InFlightOperation inflight_;
+
+  // Set for reads issued by `GcsKeyValueStore::ReadPart`, which permit the
+  // response to be truncated at the end of the object.
+  bool read_part_ = false;
+  ByteRange byte_range_;
+  int64_t total_size_ = -1;
+
+  // Set once the task has been admitted to `owner->admission_queue()`.
+  bool in_admission_queue_ = false;
+
+  // Registration of the callback on the outstanding HTTP request, if any.
+  // Unregistering it releases the request future, which aborts the transfer.
+  absl::Mutex mutex_;
+  FutureCallbackRegistration response_callback_ ABSL_GUARDED_BY(mutex_);
 
   ReadTask(IntrusivePtr<GcsKeyValueStore> owner, std::string resource,
            kvstore::ReadOptions options, Promise<kvstore::ReadResult> promise)
       : owner(std::move(owner)),
         resource(std::move(resource)),
         options(std::move(options)),
-        promise(std::move(promise)) {}
+        promise(std::move(promise)),
+        inflight_("kvstore.gcs.read", this->resource, "rate_limiter") {
+    // Reads of unknown size are charged once the response is received.
+    bytes_ = std::max(int64_t{0}, this->options.byte_range.size());
+  }
+
+  ~ReadTask() {
+    if (in_admission_queue_) owner->admission_queue().Finish(this);
+  }
 
-  ~ReadTask() { owner->admission_queue().Finish(this); }
+  /// Arranges for the task to be abandoned once the result is not needed.
+  void RegisterCancellation() {
+    promise.ExecuteWhenNotNeeded(
+        [self = IntrusivePtr<ReadTask>(this)] { self->OnNotNeeded(); });
+  }
+
+  void OnNotNeeded() {
+    FutureCallbackRegistration response_callback;
+    {
+      absl::MutexLock lock(&mutex_);
+      response_callback = std::move(response_callback_);
+    }
+    response_callback.UnregisterNonBlocking();
+
+    // Remove the task from the rate limiters if it has not yet started; in
+    // that case drop the reference which would have been adopted.
+    if (owner->read_rate_limiter().Cancel(this)) {
+      intrusive_ptr_decrement(this);  // adopted by ReadTask::Start.
+    } else if (owner->admission_queue().Cancel(this)) {
+      in_admission_queue_ = false;
+      intrusive_ptr_decrement(this);  // adopted by ReadTask::Admit.
+    }
+  }
 
   static void Start(void* task) {
     auto* self = reinterpret_cast<ReadTask*>(task);
     self->owner->read_rate_limiter().Finish(self);
+    self->in_admission_queue_ = true;
+    self->inflight_.SetState("admission_queue");
     self->owner->admission_queue().Admit(self, &ReadTask::Admit);
   }
 
@@ -579,14 +789,26 @@ struct ReadTask : public RateLimiterNode,
 
     auto request = request_builder.EnableAcceptEncoding().BuildRequest();
     start_time_ = absl::Now();
+    if (attempt_ == 0) timer_.StartService();
+    inflight_.SetState("http_request");
 
     ABSL_LOG_IF(INFO, gcs_http_logging) << "ReadTask: " << request;
     auto future = owner->transport_->IssueRequest(
-        request, IssueRequestOptions().SetHttpVersion(GetHttpVersion()));
-    future.ExecuteWhenReady([self = IntrusivePtr<ReadTask>(this)](
-                                ReadyFuture<HttpResponse> response) {
-      self->OnResponse(response.result());
-    });
+        request, IssueRequestOptions()
+                     .SetHttpVersion(GetHttpVersion())
+                     .SetDeadline(options.deadline)
+                     .SetMemoryBudget(owner->memory_budget()));
+    auto response_callback =
+        future.ExecuteWhenReady([self = IntrusivePtr<ReadTask>(this)](
+                                    ReadyFuture<HttpResponse> response) {
+          self->OnResponse(response.result());
+        });
+    {
+      absl::MutexLock lock(&mutex_);
+      response_callback_ = std::move(response_callback);
+    }
+    // Handle cancellation which raced with issuing the request.
+    if (!promise.result_needed()) OnNotNeeded();
   }
 
   void OnResponse(const Result<HttpResponse>& response) {
@@ -609,8 +831,9 @@ struct ReadTask : public RateLimiterNode,
     }();
 
     if (!status.ok() && IsRetriable(status)) {
-      status =
-          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      inflight_.SetState("backoff");
+      status = owner->BackoffForAttemptAsync(std::move(status), attempt_++,
+                                             this, options.deadline);
       if (status.ok()) {
         return;
       }
@@ -624,8 +847,10 @@ struct ReadTask : public RateLimiterNode,
 
   Result<kvstore::ReadResult> FinishResponse(const HttpResponse& httpresponse) {
     gcs_bytes_read.IncrementBy(httpresponse.payload.size());
+    owner->read_rate_limiter().Reconcile(this, httpresponse.payload.size());
     auto latency = absl::Now() - start_time_;
     gcs_read_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+    timer_.FinishService();
 
     // Parse `Date` header from response to correctly handle cached responses.
     // The GCS servers always send a `date` header.
@@ -649,13 +874,13 @@ struct ReadTask : public RateLimiterNode,
 
     absl::Cord value;
     ObjectMetadata metadata;
-    if (options.byte_range.size() != 0) {
-      // Currently unused
-      ByteRange byte_range;
-      int64_t total_size;
-
+    if (read_part_) {
+      TENSORSTORE_RETURN_IF_ERROR(internal_http::GetResponseByteRange(
+          httpresponse, value, byte_range_, total_size_));
+      SetObjectMetadataFromHeaders(httpresponse.headers, &metadata);
+    } else if (options.byte_range.size() != 0) {
       TENSORSTORE_RETURN_IF_ERROR(internal_http::ValidateResponseByteRange(
-          httpresponse, options.byte_range, value, byte_range, total_size));
+          httpresponse, options.byte_range, value, byte_range_, total_size_));
       // TODO: Avoid parsing the entire metadata & only extract the
       // generation field.
       SetObjectMetadataFromHeaders(httpresponse.headers, &metadata);
@@ -665,6 +890,7 @@ struct ReadTask : public RateLimiterNode,
       absl::Cord cord = httpresponse.payload;
       TENSORSTORE_ASSIGN_OR_RETURN(metadata,
                                    ParseObjectMetadata(cord.Flatten()));
+      total_size_ = ListEntry::checked_size(metadata.size);
     }
 
     auto generation = StorageGeneration::FromUint64(metadata.generation);
@@ -691,10 +917,34 @@ Future<kvstore::ReadResult> GcsKeyValueStore::Read(Key key,
 Future<kvstore::ReadResult> GcsKeyValueStore::ReadImpl(Key&& key,
                                                        ReadOptions&& options) {
   gcs_batch_read.Increment();
+  spec_.retries->RecordRequest();
   auto encoded_object_name = internal::PercentEncodeUriComponent(key);
   std::string resource = tensorstore::internal::JoinPath(resource_root_, "/o/",
                                                          encoded_object_name);
 
+  if (spec_.parallel_read_part_size &&
+      internal_http::ShouldReadInParts(options.byte_range,
+                                       *spec_.parallel_read_part_size)) {
+    return internal_http::ReadInParts(
+        std::move(options), *spec_.parallel_read_part_size,
+        [self = internal::IntrusivePtr<GcsKeyValueStore>(this),
+         resource = std::move(resource)](ReadOptions options) {
+          return self->ReadPart(resource, std::move(options));
+        });
+  }
+
+  if (read_hedger_) {
+    return read_hedger_->Read(
+        [self = internal::IntrusivePtr<GcsKeyValueStore>(this),
+         resource = std::move(resource), options = std::move(options)] {
+          return self->IssueRead(resource, options);
+        });
+  }
+  return IssueRead(std::move(resource), std::move(options));
+}
+
+Future<kvstore::ReadResult> GcsKeyValueStore::IssueRead(std::string resource,
+                                                        ReadOptions options) {
   auto op = PromiseFuturePair<ReadResult>::Make();
   auto state = internal::MakeIntrusivePtr<ReadTask>(
       internal::IntrusivePtr<GcsKeyValueStore>(this), std::move(resource),
@@ -702,9 +952,67 @@ Future<kvstore::ReadResult> GcsKeyValueStore::ReadImpl(Key&& key,
 
   intrusive_ptr_increment(state.get());  // adopted by ReadTask::Start.
   read_rate_limiter().Admit(state.get(), &ReadTask::Start);
+  state->RegisterCancellation();
+  internal::SetPromiseDeadline(state->promise, state->options.deadline);
   return std::move(op.future);
 }
 
+Future<internal_http::ReadPartResult> GcsKeyValueStore::ReadPart(
+    std::string resource, ReadOptions options) {
+  auto op = PromiseFuturePair<ReadResult>::Make();
+  auto state = internal::MakeIntrusivePtr<ReadTask>(
+      internal::IntrusivePtr<GcsKeyValueStore>(this), std::move(resource),
+      std::move(options), std::move(op.promise));
+  state->read_part_ = true;
+
+  intrusive_ptr_increment(state.get());  // adopted by ReadTask::Start.
+  read_rate_limiter().Admit(state.get(), &ReadTask::Start);
+  state->RegisterCancellation();
+  internal::SetPromiseDeadline(state->promise, state->options.deadline);
+  return MapFutureValue(
+      InlineExecutor{},
+      [state = std::move(state)](ReadResult& result) {
+        return internal_http::ReadPartResult{std::move(result),
+                                             state->byte_range_,
+                                             state->total_size_};
+      },
+      std::move(op.future));
+}
+
+Future<kvstore::StatResult> GcsKeyValueStore::Stat(Key key,
+                                                   StatOptions options) {
+  gcs_stat.Increment();
+  if (!IsValidObjectName(key)) {
+    return absl::InvalidArgumentError("Invalid GCS object name");
+  }
+  if (!IsValidStorageGeneration(options.generation_conditions.if_equal) ||
+      !IsValidStorageGeneration(options.generation_conditions.if_not_equal)) {
+    return absl::InvalidArgumentError("Malformed StorageGeneration");
+  }
+  spec_.retries->RecordRequest();
+  ReadOptions read_options;
+  read_options.generation_conditions = std::move(options.generation_conditions);
+  read_options.staleness_bound = options.staleness_bound;
+  read_options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+
+  auto op = PromiseFuturePair<ReadResult>::Make();
+  auto state = internal::MakeIntrusivePtr<ReadTask>(
+      internal::IntrusivePtr<GcsKeyValueStore>(this),
+      tensorstore::internal::JoinPath(resource_root_, "/o/",
+                                      internal::PercentEncodeUriComponent(key)),
+      std::move(read_options), std::move(op.promise));
+
+  intrusive_ptr_increment(state.get());  // adopted by ReadTask::Start.
+  read_rate_limiter().Admit(state.get(), &ReadTask::Start);
+  state->RegisterCancellation();
+  return MapFutureValue(
+      InlineExecutor{},
+      [state = std::move(state)](const ReadResult& result) {
+        return kvstore::StatResult::FromReadResult(result, state->total_size_);
+      },
+      std::move(op.future));
+}
+
 /// A WriteTask is a function object used to satisfy a
 /// GcsKeyValueStore::Write request.
 struct WriteTask : public RateLimiterNode,
@@ -717,6 +1025,8 @@ struct WriteTask : public RateLimiterNode,
 
   int attempt_ = 0;
   absl::Time start_time_;
+  internal_kvstore::KvStoreOperationTimer timer_{"gcs", "write"};
+  internal_tracing::InFlightOperation inflight_;
 
   WriteTask(IntrusivePtr<GcsKeyValueStore> owner,
             std::string encoded_object_name, absl::Cord value,
@@ -726,13 +1036,18 @@ struct WriteTask : public RateLimiterNode,
         encoded_object_name(std::move(encoded_object_name)),
         value(std::move(value)),
         options(std::move(options)),
-        promise(std::move(promise)) {}
+        promise(std::move(promise)),
+        inflight_("kvstore.gcs.write", this->encoded_object_name,
+                  "rate_limiter") {
+    bytes_ = this->value.size();
+  }
 
   ~WriteTask() { owner->admission_queue().Finish(this); }
 
   static void Start(void* task) {
     auto* self = reinterpret_cast<WriteTask*>(task);
     self->owner->write_rate_limiter().Finish(self);
+    self->inflight_.SetState("admission_queue");
     self->owner->admission_queue().Admit(self, &WriteTask::Admit);
   }
   static void Admit(void* task) {
@@ -776,12 +1091,16 @@ struct WriteTask : public RateLimiterNode,
             .AddHeader(tensorstore::StrCat("Content-Length: ", value.size()))
             .BuildRequest();
     start_time_ = absl::Now();
+    if (attempt_ == 0) timer_.StartService();
+    inflight_.SetState("http_request");
 
     ABSL_LOG_IF(INFO, gcs_http_logging)
         << "WriteTask: " << request << " size=" << value.size();
 
     auto future = owner->transport_->IssueRequest(
-        request, IssueRequestOptions(value).SetHttpVersion(GetHttpVersion()));
+        request, IssueRequestOptions(value)
+                     .SetHttpVersion(GetHttpVersion())
+                     .SetDeadline(options.deadline));
     future.ExecuteWhenReady([self = IntrusivePtr<WriteTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
       self->OnResponse(response.result());
@@ -816,8 +1135,9 @@ struct WriteTask : public RateLimiterNode,
     }();
 
     if (!status.ok() && IsRetriable(status)) {
-      status =
-          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      inflight_.SetState("backoff");
+      status = owner->BackoffForAttemptAsync(std::move(status), attempt_++,
+                                             this, options.deadline);
       if (status.ok()) {
         return;
       }
@@ -852,6 +1172,7 @@ struct WriteTask : public RateLimiterNode,
     auto latency = absl::Now() - start_time_;
     gcs_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
     gcs_bytes_written.IncrementBy(value.size());
+    timer_.FinishService();
 
     // TODO: Avoid parsing the entire metadata & only extract the
     // generation field.
@@ -865,6 +1186,267 @@ struct WriteTask : public RateLimiterNode,
   }
 };
 
+Future<TimestampedStorageGeneration> StartWriteTask(
+    IntrusivePtr<GcsKeyValueStore> owner, std::string encoded_object_name,
+    absl::Cord value, kvstore::WriteOptions options) {
+  auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+  auto state = internal::MakeIntrusivePtr<WriteTask>(
+      owner, std::move(encoded_object_name), std::move(value),
+      std::move(options), std::move(op.promise));
+  intrusive_ptr_increment(state.get());  // adopted by WriteTask::Start.
+  owner->write_rate_limiter().Admit(state.get(), &WriteTask::Start);
+  internal::SetPromiseDeadline(state->promise, state->options.deadline);
+  return std::move(op.future);
+}
+
+/// A ComposeTask is a function object which concatenates existing objects into
+/// a single object.
+///
+/// https://cloud.google.com/storage/docs/json_api/v1/objects/compose
+struct ComposeTask : public RateLimiterNode,
+                     public internal::AtomicReferenceCount<ComposeTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::string encoded_object_name;
+  std::vector<std::string> source_names;
+  kvstore::WriteOptions options;
+  Promise<TimestampedStorageGeneration> promise;
+
+  int attempt_ = 0;
+  absl::Time start_time_;
+
+  ComposeTask(IntrusivePtr<GcsKeyValueStore> owner,
+              std::string encoded_object_name,
+              std::vector<std::string> source_names,
+              kvstore::WriteOptions options,
+              Promise<TimestampedStorageGeneration> promise)
+      : owner(std::move(owner)),
+        encoded_object_name(std::move(encoded_object_name)),
+        source_names(std::move(source_names)),
+        options(std::move(options)),
+        promise(std::move(promise)) {}
+
+  ~ComposeTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<ComposeTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->admission_queue().Admit(self, &ComposeTask::Admit);
+  }
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<ComposeTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<ComposeTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    std::string compose_url = tensorstore::StrCat(
+        owner->resource_root(), "/o/", encoded_object_name, "/compose");
+
+    // The condition applies to the composed object, so the write remains
+    // atomic with respect to other writers.
+    bool has_query =
+        AddGenerationParam(&compose_url, false, "ifGenerationMatch",
+                           options.generation_conditions.if_equal);
+    AddUserProjectParam(&compose_url, has_query, owner->encoded_user_project());
+
+    ::nlohmann::json::array_t source_objects;
+    for (const auto& name : source_names) {
+      source_objects.push_back({{"name", name}});
+    }
+    absl::Cord body(::nlohmann::json{
+        {"sourceObjects", std::move(source_objects)},
+        {"destination", {{"contentType", "application/octet-stream"}}}}
+                        .dump());
+
+    auto maybe_auth_header = owner->GetAuthHeader();
+    if (!maybe_auth_header.ok()) {
+      promise.SetResult(maybe_auth_header.status());
+      return;
+    }
+    HttpRequestBuilder request_builder("POST", compose_url);
+    if (maybe_auth_header.value().has_value()) {
+      request_builder.AddHeader(*maybe_auth_header.value());
+    }
+    auto request =
+        request_builder.AddHeader("Content-Type: application/json")
+            .AddHeader(tensorstore::StrCat("Content-Length: ", body.size()))
+            .BuildRequest();
+    start_time_ = absl::Now();
+
+    ABSL_LOG_IF(INFO, gcs_http_logging) << "ComposeTask: " << request;
+
+    auto future = owner->transport_->IssueRequest(
+        request, IssueRequestOptions(std::move(body))
+                     .SetHttpVersion(GetHttpVersion()));
+    future.ExecuteWhenReady([self = IntrusivePtr<ComposeTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "ComposeTask " << *response;
+
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) return response.status();
+      if (response.value().status_code == 412) {
+        // Failed precondition implies the generation did not match.
+        return absl::OkStatus();
+      }
+      return HttpResponseCodeToStatus(response.value());
+    }();
+
+    if (!status.ok() && IsRetriable(status)) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(status);
+      return;
+    }
+
+    TimestampedStorageGeneration r;
+    r.time = start_time_;
+    if (response.value().status_code == 412) {
+      r.generation = StorageGeneration::Unknown();
+      promise.SetResult(std::move(r));
+      return;
+    }
+    auto payload = response.value().payload;
+    auto parsed_object_metadata = ParseObjectMetadata(payload.Flatten());
+    if (!parsed_object_metadata.ok()) {
+      promise.SetResult(parsed_object_metadata.status());
+      return;
+    }
+    r.generation =
+        StorageGeneration::FromUint64(parsed_object_metadata->generation);
+    promise.SetResult(std::move(r));
+  }
+};
+
+/// A ParallelUploadTask writes a large value as a parallel composite upload.
+///
+/// The value is split into at most 32 parts, which are uploaded concurrently
+/// as temporary objects alongside the destination and then composed into the
+/// destination object.  The temporary objects are deleted afterwards.
+///
+/// https://cloud.google.com/storage/docs/parallel-composite-uploads
+struct ParallelUploadTask
+    : public internal::AtomicReferenceCount<ParallelUploadTask> {
+  /// Maximum number of source objects of a single compose request.
+  constexpr static int64_t kMaxComposeSources = 32;
+
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::string key;
+  absl::Cord value;
+  kvstore::WriteOptions options;
+  int64_t part_size;
+  Promise<TimestampedStorageGeneration> promise;
+
+  std::vector<std::string> part_names_;
+  absl::Time start_time_;
+
+  void Start() {
+    start_time_ = absl::Now();
+    const std::string prefix =
+        tensorstore::StrCat(key, ".tensorstore_upload_", GetRandomId(), "_");
+    const int64_t size = value.size();
+    std::vector<Future<TimestampedStorageGeneration>> futures;
+    for (int64_t offset = 0; offset < size; offset += part_size) {
+      part_names_.push_back(tensorstore::StrCat(prefix, part_names_.size()));
+      kvstore::WriteOptions part_options;
+      part_options.generation_conditions.if_equal = StorageGeneration::NoValue();
+      futures.push_back(StartWriteTask(
+          owner, internal::PercentEncodeUriComponent(part_names_.back()),
+          value.Subcord(offset, std::min(part_size, size - offset)),
+          std::move(part_options)));
+    }
+    auto all_ready = WaitAllFuture(tensorstore::span(futures));
+    all_ready.ExecuteWhenReady(
+        [self = IntrusivePtr<ParallelUploadTask>(this),
+         futures = std::move(futures)](ReadyFuture<void> all_ready) {
+          self->OnPartsUploaded(all_ready.status(), futures);
+        });
+  }
+
+  void OnPartsUploaded(
+      absl::Status status,
+      const std::vector<Future<TimestampedStorageGeneration>>& futures) {
+    if (status.ok()) {
+      for (const auto& future : futures) {
+        if (StorageGeneration::IsUnknown(future.value().generation)) {
+          status = absl::AbortedError(
+              "Temporary object for parallel upload already exists");
+          break;
+        }
+      }
+    }
+    if (status.ok() && !promise.result_needed()) {
+      status = absl::CancelledError();
+    }
+    if (!status.ok()) {
+      Finish(std::move(status));
+      return;
+    }
+    auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+    auto task = internal::MakeIntrusivePtr<ComposeTask>(
+        owner, internal::PercentEncodeUriComponent(key), part_names_, options,
+        std::move(op.promise));
+    intrusive_ptr_increment(task.get());  // adopted by ComposeTask::Start.
+    owner->write_rate_limiter().Admit(task.get(), &ComposeTask::Start);
+    op.future.ExecuteWhenReady(
+        [self = IntrusivePtr<ParallelUploadTask>(this)](
+            ReadyFuture<TimestampedStorageGeneration> future) {
+          self->OnComposed(future.result());
+        });
+  }
+
+  void OnComposed(Result<TimestampedStorageGeneration> result) {
+    if (result.ok() && !StorageGeneration::IsUnknown(result->generation)) {
+      auto latency = absl::Now() - start_time_;
+      gcs_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+      gcs_bytes_written.IncrementBy(value.size());
+      result->time = start_time_;
+    }
+    Finish(std::move(result));
+  }
+
+  /// Deletes the temporary part objects and then completes the write with
+  /// `result`.  Failures to delete the parts are only logged.
+  void Finish(Result<TimestampedStorageGeneration> result) {
+    std::vector<Future<void>> futures;
+    for (const auto& name : part_names_) {
+      futures.push_back(MapFuture(
+          InlineExecutor{},
+          [](const Result<TimestampedStorageGeneration>& r) -> Result<void> {
+            ABSL_LOG_IF(INFO, gcs_http_logging && !r.ok())
+                << "Failed to delete parallel upload part: " << r.status();
+            return MakeResult();
+          },
+          owner->Write(name, std::nullopt, {})));
+    }
+    auto all_ready = WaitAllFuture(tensorstore::span(futures));
+    all_ready.ExecuteWhenReady(
+        [self = IntrusivePtr<ParallelUploadTask>(this),
+         result = std::move(result),
+         futures = std::move(futures)](ReadyFuture<void>) mutable {
+          self->promise.SetResult(std::move(result));
+        });
+  }
+};
+
 /// A DeleteTask is a function object used to satisfy a
 /// GcsKeyValueStore::Delete request.
 struct DeleteTask : public RateLimiterNode,
@@ -997,6 +1579,7 @@ struct DeleteTask : public RateLimiterNode,
 Future<TimestampedStorageGeneration> GcsKeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   gcs_write.Increment();
+  spec_.retries->RecordRequest();
   if (!IsValidObjectName(key)) {
     return absl::InvalidArgumentError("Invalid GCS object name");
   }
@@ -1007,7 +1590,20 @@ Future<TimestampedStorageGeneration> GcsKeyValueStore::Write(
   std::string encoded_object_name = internal::PercentEncodeUriComponent(key);
   auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
 
-  if (value) {
+  if (value && spec_.parallel_upload_part_size &&
+      static_cast<int64_t>(value->size()) > *spec_.parallel_upload_part_size) {
+    auto state = internal::MakeIntrusivePtr<ParallelUploadTask>();
+    state->owner = IntrusivePtr<GcsKeyValueStore>(this);
+    state->key = std::move(key);
+    state->part_size =
+        std::max(*spec_.parallel_upload_part_size,
+                 CeilOfRatio(static_cast<int64_t>(value->size()),
+                             ParallelUploadTask::kMaxComposeSources));
+    state->value = std::move(*value);
+    state->options = std::move(options);
+    state->promise = std::move(op.promise);
+    state->Start();
+  } else if (value) {
     auto state = internal::MakeIntrusivePtr<WriteTask>(
         IntrusivePtr<GcsKeyValueStore>(this), std::move(encoded_object_name),
         std::move(*value), std::move(options), std::move(op.promise));
@@ -1032,6 +1628,7 @@ Future<TimestampedStorageGeneration> GcsKeyValueStore::Write(
 struct GcsListResponsePayload {
   std::string next_page_token;        // used to page through list results.
   std::vector<ObjectMetadata> items;  // individual result metadata.
+  std::vector<std::string> prefixes;  // common prefixes, given a delimiter.
 };
 
 constexpr static auto GcsListResponsePayloadBinder = jb::Object(
@@ -1040,29 +1637,43 @@ constexpr static auto GcsListResponsePayloadBinder = jb::Object(
                               jb::DefaultInitializedValue())),
     jb::Member("items", jb::Projection(&GcsListResponsePayload::items,
                                        jb::DefaultInitializedValue())),
+    jb::Member("prefixes", jb::Projection(&GcsListResponsePayload::prefixes,
+                                          jb::DefaultInitializedValue())),
     jb::DiscardExtraMembers);
 
 /// ListTask implements the ListImpl execution flow.
+///
+/// The request for the next page is issued as soon as a page is received, so
+/// that it overlaps with delivering the entries of the current page.
+///
+/// If `discover_prefixes` is `true`, the task instead issues a single
+/// delimited request for the top-level prefixes of the range, and lists them
+/// concurrently using `ListSegments`.  Any failure of that request falls back
+/// to a sequential listing, so `receiver` is only signaled by the listings
+/// which are started afterwards.
 struct ListTask : public RateLimiterNode,
                   public internal::AtomicReferenceCount<ListTask> {
   internal::IntrusivePtr<GcsKeyValueStore> owner_;
   ListOptions options_;
   ListReceiver receiver_;
   std::string resource_;
+  bool discover_prefixes_;
 
   std::string base_list_url_;
   std::string next_page_token_;
   int attempt_ = 0;
   bool has_query_parameters_;
   std::atomic<bool> cancelled_{false};
+  FlowDemand::Ptr demand_ = FlowDemand::Make();
 
   ListTask(internal::IntrusivePtr<GcsKeyValueStore>&& owner,
            ListOptions&& options, ListReceiver&& receiver,
-           std::string&& resource)
+           std::string&& resource, bool discover_prefixes)
       : owner_(std::move(owner)),
         options_(std::move(options)),
         receiver_(std::move(receiver)),
-        resource_(std::move(resource)) {
+        resource_(std::move(resource)),
+        discover_prefixes_(discover_prefixes) {
     // Construct the base LIST url. This will be modified to include the
     // nextPageToken
     base_list_url_ = resource_;
@@ -1082,6 +1693,19 @@ struct ListTask : public RateLimiterNode,
           "endOffset=", internal::PercentEncodeUriComponent(exclusive_max));
       has_query_parameters_ = true;
     }
+    if (discover_prefixes_) {
+      // List the prefixes which follow the last delimiter that is common to
+      // all keys in the range.
+      std::string_view prefix = LongestPrefix(options_.range);
+      prefix = prefix.substr(0, prefix.rfind('/') + 1);
+      absl::StrAppend(&base_list_url_, (has_query_parameters_ ? "&" : "?"),
+                      "delimiter=%2F");
+      if (!prefix.empty()) {
+        absl::StrAppend(&base_list_url_, "&prefix=",
+                        internal::PercentEncodeUriComponent(prefix));
+      }
+      has_query_parameters_ = true;
+    }
   }
 
   ~ListTask() { owner_->admission_queue().Finish(this); }
@@ -1097,9 +1721,13 @@ struct ListTask : public RateLimiterNode,
   }
   static void Admit(void* task) {
     auto* self = reinterpret_cast<ListTask*>(task);
-    execution::set_starting(self->receiver_, [self] {
-      self->cancelled_.store(true, std::memory_order_relaxed);
-    });
+    if (!self->discover_prefixes_) {
+      execution::set_starting(self->receiver_, [self] {
+        self->cancelled_.store(true, std::memory_order_relaxed);
+        self->demand_->RequestUnbounded();
+      });
+      execution::set_demand(self->receiver_, self->demand_);
+    }
     self->owner_->executor()(
         [state = IntrusivePtr<ListTask>(self, internal::adopt_object_ref)] {
           state->IssueRequest();
@@ -1108,36 +1736,61 @@ struct ListTask : public RateLimiterNode,
 
   void Retry() { IssueRequest(); }
 
+  void Done() {
+    execution::set_done(receiver_);
+    execution::set_stopping(receiver_);
+  }
+
+  void Fail(absl::Status status) {
+    if (discover_prefixes_) {
+      ABSL_LOG_IF(INFO, gcs_http_logging)
+          << "List prefix discovery failed: " << status;
+      owner_->StartList(std::move(options_), std::move(receiver_),
+                        /*discover_prefixes=*/false);
+      return;
+    }
+    execution::set_error(receiver_, std::move(status));
+    execution::set_stopping(receiver_);
+  }
+
   void IssueRequest() {
     if (is_cancelled()) {
-      execution::set_done(receiver_);
-      execution::set_stopping(receiver_);
+      Done();
+      return;
+    }
+    auto future = StartRequest();
+    if (!future.ok()) {
+      Fail(std::move(future).status());
       return;
     }
+    HandleResponse(*std::move(future));
+  }
 
+  // Issues the request for the page identified by `next_page_token_`.
+  Result<Future<HttpResponse>> StartRequest() {
     std::string list_url = base_list_url_;
     if (!next_page_token_.empty()) {
       absl::StrAppend(&list_url, (has_query_parameters_ ? "&" : "?"),
                       "pageToken=", next_page_token_);
     }
 
-    auto auth_header = owner_->GetAuthHeader();
-    if (!auth_header.ok()) {
-      execution::set_error(receiver_, std::move(auth_header).status());
-      execution::set_stopping(receiver_);
-      return;
-    }
+    TENSORSTORE_ASSIGN_OR_RETURN(auto auth_header, owner_->GetAuthHeader());
 
     HttpRequestBuilder request_builder("GET", list_url);
-    if (auth_header->has_value()) {
-      request_builder.AddHeader(auth_header->value());
+    if (auth_header.has_value()) {
+      request_builder.AddHeader(*auth_header);
     }
 
     auto request = request_builder.BuildRequest();
     ABSL_LOG_IF(INFO, gcs_http_logging) << "List: " << request;
 
-    auto future = owner_->transport_->IssueRequest(
-        request, IssueRequestOptions().SetHttpVersion(GetHttpVersion()));
+    return owner_->transport_->IssueRequest(
+        request, IssueRequestOptions()
+                     .SetHttpVersion(GetHttpVersion())
+                     .SetMemoryBudget(owner_->memory_budget()));
+  }
+
+  void HandleResponse(Future<HttpResponse> future) {
     future.ExecuteWhenReady(WithExecutor(
         owner_->executor(), [self = IntrusivePtr<ListTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
@@ -1145,17 +1798,29 @@ struct ListTask : public RateLimiterNode,
         }));
   }
 
+  // Handles the prefetched response for the next page once the receiver has
+  // requested more entries.
+  void HandleResponseWhenDemanded(Future<HttpResponse> future) {
+    demand_->WhenAvailable().ExecuteWhenReady(
+        [self = IntrusivePtr<ListTask>(this),
+         future = std::move(future)](ReadyFuture<const void>) {
+          if (self->is_cancelled()) {
+            self->Done();
+            return;
+          }
+          self->HandleResponse(std::move(future));
+        });
+  }
+
   void OnResponse(const Result<HttpResponse>& response) {
     auto status = OnResponseImpl(response);
     // OkStatus are handled by OnResponseImpl
     if (absl::IsCancelled(status)) {
-      execution::set_done(receiver_);
-      execution::set_stopping(receiver_);
+      Done();
       return;
     }
     if (!status.ok()) {
-      execution::set_error(receiver_, std::move(status));
-      execution::set_stopping(receiver_);
+      Fail(std::move(status));
       return;
     }
   }
@@ -1173,6 +1838,7 @@ struct ListTask : public RateLimiterNode,
       return owner_->BackoffForAttemptAsync(std::move(status), attempt_++,
                                             this);
     }
+    TENSORSTORE_RETURN_IF_ERROR(status);
     auto payload = response->payload;
     auto j = internal::ParseJson(payload.Flatten());
     if (j.is_discarded()) {
@@ -1182,6 +1848,22 @@ struct ListTask : public RateLimiterNode,
     TENSORSTORE_ASSIGN_OR_RETURN(
         auto parsed_payload,
         jb::FromJson<GcsListResponsePayload>(j, GcsListResponsePayloadBinder));
+
+    // Successful request, so clear the retry_attempt for the next request.
+    attempt_ = 0;
+    next_page_token_ = std::move(parsed_payload.next_page_token);
+
+    if (discover_prefixes_) {
+      ListDiscoveredPrefixes(std::move(parsed_payload));
+      return absl::OkStatus();
+    }
+
+    // Prefetch the next page while the entries of this page are delivered.
+    std::optional<Result<Future<HttpResponse>>> next_page;
+    if (!next_page_token_.empty()) {
+      next_page = StartRequest();
+    }
+
     for (auto& metadata : parsed_payload.items) {
       if (is_cancelled()) {
         return absl::CancelledError();
@@ -1195,44 +1877,207 @@ struct ListTask : public RateLimiterNode,
                                std::string(name),
                                ListEntry::checked_size(metadata.size),
                            });
+      demand_->Consume();
     }
 
-    // Successful request, so clear the retry_attempt for the next request.
-    attempt_ = 0;
-    next_page_token_ = std::move(parsed_payload.next_page_token);
-    if (!next_page_token_.empty()) {
-      IssueRequest();
-    } else {
-      execution::set_done(receiver_);
-      execution::set_stopping(receiver_);
+    if (!next_page) {
+      Done();
+      return absl::OkStatus();
     }
+    TENSORSTORE_RETURN_IF_ERROR(next_page->status());
+    HandleResponseWhenDemanded(**std::move(next_page));
     return absl::OkStatus();
   }
+
+  void ListDiscoveredPrefixes(GcsListResponsePayload payload) {
+    std::vector<ListEntry> entries;
+    entries.reserve(payload.items.size());
+    for (auto& metadata : payload.items) {
+      entries.push_back(ListEntry{std::move(metadata.name),
+                                  ListEntry::checked_size(metadata.size)});
+    }
+    auto segments = internal_kvstore::GetDelimitedListSegments(
+        options_.range, std::move(payload.prefixes), std::move(entries),
+        /*truncated=*/!next_page_token_.empty());
+    size_t num_ranges = 0;
+    for (const auto& segment : segments) {
+      if (!segment.entry) ++num_ranges;
+    }
+    if (num_ranges == 1) {
+      // A single prefix is no faster to list separately.
+      owner_->StartList(std::move(options_), std::move(receiver_),
+                        /*discover_prefixes=*/false);
+      return;
+    }
+    internal_kvstore::ListSegments(
+        std::move(segments), std::move(options_),
+        static_cast<size_t>(owner_->spec_.list_concurrency.value_or(1)),
+        [owner = owner_](ListOptions options, ListReceiver receiver) {
+          owner->StartList(std::move(options), std::move(receiver),
+                           /*discover_prefixes=*/false);
+        },
+        std::move(receiver_));
+  }
 };
 
 void GcsKeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
   gcs_list.Increment();
+  spec_.retries->RecordRequest();
   if (options.range.empty()) {
     execution::set_starting(receiver, [] {});
     execution::set_done(receiver);
     execution::set_stopping(receiver);
     return;
   }
+  StartList(std::move(options), std::move(receiver),
+            /*discover_prefixes=*/spec_.list_concurrency.value_or(1) > 1);
+}
 
+void GcsKeyValueStore::StartList(ListOptions options, ListReceiver receiver,
+                                 bool discover_prefixes) {
   auto state = internal::MakeIntrusivePtr<ListTask>(
       IntrusivePtr<GcsKeyValueStore>(this), std::move(options),
       std::move(receiver),
-      /*resource=*/tensorstore::internal::JoinPath(resource_root_, "/o"));
+      /*resource=*/tensorstore::internal::JoinPath(resource_root_, "/o"),
+      discover_prefixes);
 
   intrusive_ptr_increment(state.get());  // adopted by ListTask::Start.
   read_rate_limiter().Admit(state.get(), &ListTask::Start);
 }
 
+/// A BatchDeleteTask unconditionally removes up to `kMaxBatchRequestParts`
+/// objects using a single request to the GCS JSON API batch endpoint.
+///
+/// https://cloud.google.com/storage/docs/batch
+struct BatchDeleteTask : public RateLimiterNode,
+                         public internal::AtomicReferenceCount<BatchDeleteTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::vector<std::string> encoded_object_names;
+  Promise<void> promise;
+
+  int attempt_ = 0;
+
+  BatchDeleteTask(IntrusivePtr<GcsKeyValueStore> owner,
+                  std::vector<std::string> encoded_object_names,
+                  Promise<void> promise)
+      : owner(std::move(owner)),
+        encoded_object_names(std::move(encoded_object_names)),
+        promise(std::move(promise)) {}
+
+  ~BatchDeleteTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<BatchDeleteTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->admission_queue().Admit(self, &BatchDeleteTask::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<BatchDeleteTask*>(task);
+    self->owner->executor()([state = IntrusivePtr<BatchDeleteTask>(
+                                 self, internal::adopt_object_ref)] {
+      state->Retry();
+    });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    // Each part is addressed by its path relative to the GCS host.
+    std::string resource_path = std::string(
+        internal::ParseGenericUri(owner->resource_root()).path);
+    std::vector<BatchRequestPart> parts;
+    parts.reserve(encoded_object_names.size());
+    for (const auto& name : encoded_object_names) {
+      std::string path = tensorstore::StrCat(resource_path, "/o/", name);
+      AddUserProjectParam(&path, false, owner->encoded_user_project());
+      parts.push_back(BatchRequestPart{"DELETE", std::move(path)});
+    }
+    absl::Cord body = BuildBatchRequestPayload(parts);
+
+    auto maybe_auth_header = owner->GetAuthHeader();
+    if (!maybe_auth_header.ok()) {
+      promise.SetResult(maybe_auth_header.status());
+      return;
+    }
+    // The authorization header of the outer request applies to every part.
+    HttpRequestBuilder request_builder(
+        "POST", tensorstore::StrCat(GetGcsBaseUrl(), "/batch/storage/v1"));
+    if (maybe_auth_header.value().has_value()) {
+      request_builder.AddHeader(*maybe_auth_header.value());
+    }
+    auto request =
+        request_builder
+            .AddHeader(tensorstore::StrCat("Content-Type: ",
+                                           BatchRequestContentType()))
+            .AddHeader(tensorstore::StrCat("Content-Length: ", body.size()))
+            .BuildRequest();
+
+    ABSL_LOG_IF(INFO, gcs_http_logging) << "BatchDeleteTask: " << request;
+
+    gcs_batch_delete.Increment();
+    auto future = owner->transport_->IssueRequest(
+        request, IssueRequestOptions(std::move(body))
+                     .SetHttpVersion(GetHttpVersion()));
+    future.ExecuteWhenReady([self = IntrusivePtr<BatchDeleteTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "BatchDeleteTask " << *response;
+
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) return response.status();
+      if (response->status_code != 200) {
+        return HttpResponseCodeToStatus(*response);
+      }
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto parts,
+          ParseBatchResponse(*response, encoded_object_names.size()));
+
+      // Parts which failed with a retriable error are retried in a subsequent
+      // batch; any other failure fails the whole operation.
+      std::vector<std::string> remaining;
+      absl::Status retry_status;
+      for (size_t i = 0; i < parts.size(); ++i) {
+        if (parts[i].status_code == 404) continue;
+        auto part_status = HttpResponseCodeToStatus(parts[i]);
+        if (part_status.ok()) continue;
+        if (!IsRetriable(part_status)) return part_status;
+        remaining.push_back(std::move(encoded_object_names[i]));
+        retry_status = std::move(part_status);
+      }
+      encoded_object_names = std::move(remaining);
+      return retry_status;
+    }();
+
+    if (!status.ok() && IsRetriable(status)) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    promise.SetResult(std::move(status));
+  }
+};
+
 // Receiver used by `DeleteRange` for processing the results from `List`.
+//
+// Keys are accumulated and removed with batch requests of up to
+// `kMaxBatchRequestParts` objects, rather than one request per object.
 struct DeleteRangeListReceiver {
   IntrusivePtr<GcsKeyValueStore> owner_;
   Promise<void> promise_;
   FutureCallbackRegistration cancel_registration_;
+  std::vector<std::string> pending_;
 
   void set_starting(AnyCancelReceiver cancel) {
     cancel_registration_ = promise_.ExecuteWhenNotNeeded(std::move(cancel));
@@ -1241,22 +2086,37 @@ struct DeleteRangeListReceiver {
   void set_value(ListEntry entry) {
     assert(!entry.key.empty());
     if (!entry.key.empty()) {
-      LinkError(promise_, owner_->Delete(std::move(entry.key)));
+      pending_.push_back(internal::PercentEncodeUriComponent(entry.key));
+      if (pending_.size() >= kMaxBatchRequestParts) Flush();
     }
   }
 
+  void Flush() {
+    if (pending_.empty() || promise_.null()) return;
+    auto op = PromiseFuturePair<void>::Make(tensorstore::MakeResult());
+    auto state = internal::MakeIntrusivePtr<BatchDeleteTask>(
+        owner_, std::exchange(pending_, {}), std::move(op.promise));
+    intrusive_ptr_increment(state.get());  // adopted by BatchDeleteTask::Start.
+    owner_->write_rate_limiter().Admit(state.get(), &BatchDeleteTask::Start);
+    LinkError(promise_, std::move(op.future));
+  }
+
   void set_error(absl::Status error) {
     SetDeferredResult(promise_, std::move(error));
     promise_ = Promise<void>();
   }
 
-  void set_done() { promise_ = Promise<void>(); }
+  void set_done() {
+    Flush();
+    promise_ = Promise<void>();
+  }
 
   void set_stopping() { cancel_registration_.Unregister(); }
 };
 
 Future<const void> GcsKeyValueStore::DeleteRange(KeyRange range) {
   gcs_delete_range.Increment();
+  spec_.retries->RecordRequest();
   if (range.empty()) return absl::OkStatus();
 
   // TODO(jbms): It could make sense to rate limit the list operation, so that
@@ -1271,6 +2131,212 @@ Future<const void> GcsKeyValueStore::DeleteRange(KeyRange range) {
   return std::move(op.future);
 }
 
+/// A RewriteTask copies a single object using the GCS rewrite API.
+///
+/// Large objects, or copies between buckets with different locations or
+/// storage classes, may require several requests; each response that is not
+/// `done` supplies a `rewriteToken` with which the next request continues.
+///
+/// https://cloud.google.com/storage/docs/json_api/v1/objects/rewrite
+struct RewriteTask : public RateLimiterNode,
+                     public internal::AtomicReferenceCount<RewriteTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::string source_resource;
+  std::string encoded_target_name;
+  Promise<void> promise;
+
+  int attempt_ = 0;
+  std::string rewrite_token_;
+
+  RewriteTask(IntrusivePtr<GcsKeyValueStore> owner,
+              std::string source_resource, std::string encoded_target_name,
+              Promise<void> promise)
+      : owner(std::move(owner)),
+        source_resource(std::move(source_resource)),
+        encoded_target_name(std::move(encoded_target_name)),
+        promise(std::move(promise)) {}
+
+  ~RewriteTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<RewriteTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->admission_queue().Admit(self, &RewriteTask::Admit);
+  }
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<RewriteTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<RewriteTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    std::string rewrite_url = tensorstore::StrCat(
+        source_resource, "/rewriteTo/b/", owner->spec_.bucket, "/o/",
+        encoded_target_name);
+    bool has_query = false;
+    if (!rewrite_token_.empty()) {
+      absl::StrAppend(&rewrite_url, "?rewriteToken=",
+                      internal::PercentEncodeUriComponent(rewrite_token_));
+      has_query = true;
+    }
+    AddUserProjectParam(&rewrite_url, has_query, owner->encoded_user_project());
+
+    auto maybe_auth_header = owner->GetAuthHeader();
+    if (!maybe_auth_header.ok()) {
+      promise.SetResult(maybe_auth_header.status());
+      return;
+    }
+    HttpRequestBuilder request_builder("POST", rewrite_url);
+    if (maybe_auth_header.value().has_value()) {
+      request_builder.AddHeader(*maybe_auth_header.value());
+    }
+    auto request = request_builder.AddHeader("Content-Length: 0")
+                       .AddHeader("Content-Type: application/json")
+                       .BuildRequest();
+
+    ABSL_LOG_IF(INFO, gcs_http_logging) << "RewriteTask: " << request;
+
+    auto future = owner->transport_->IssueRequest(
+        request, IssueRequestOptions().SetHttpVersion(GetHttpVersion()));
+    future.ExecuteWhenReady([self = IntrusivePtr<RewriteTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "RewriteTask " << *response;
+
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) return response.status();
+      if (response.value().status_code == 404) {
+        // The source object was deleted after it was listed.
+        return absl::OkStatus();
+      }
+      return HttpResponseCodeToStatus(response.value());
+    }();
+
+    if (!status.ok() && IsRetriable(status)) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok() || response.value().status_code == 404) {
+      promise.SetResult(status);
+      return;
+    }
+
+    auto payload = response.value().payload;
+    auto j = internal::ParseJson(payload.Flatten());
+    if (!j.is_object()) {
+      promise.SetResult(
+          absl::InvalidArgumentError("Malformed GCS rewrite response"));
+      return;
+    }
+    if (auto done = j.find("done");
+        done == j.end() || !done->is_boolean() || done->get<bool>()) {
+      promise.SetResult(absl::OkStatus());
+      return;
+    }
+    auto token = j.find("rewriteToken");
+    if (token == j.end() || !token->is_string()) {
+      promise.SetResult(absl::InvalidArgumentError(
+          "GCS rewrite response is missing \"rewriteToken\""));
+      return;
+    }
+    // Continue the rewrite.  The GCS documentation recommends issuing the
+    // continuation immediately rather than backing off.
+    rewrite_token_ = token->get<std::string>();
+    attempt_ = 0;
+    Retry();
+  }
+};
+
+// Receiver used by `ExperimentalCopyRangeFrom` for processing the results
+// from `List` on the source bucket.
+//
+// Each listed object is copied by a separate `RewriteTask`, subject to the
+// write rate limiter and admission queue of the target, so that the copies
+// proceed concurrently with the listing.
+struct CopyRangeListReceiver {
+  IntrusivePtr<GcsKeyValueStore> owner_;
+  std::string source_resource_root_;
+  size_t source_prefix_length_;
+  std::string target_prefix_;
+  Promise<void> promise_;
+  FutureCallbackRegistration cancel_registration_;
+
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration_ = promise_.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+
+  void set_value(ListEntry entry) {
+    if (promise_.null()) return;
+    std::string target_key = tensorstore::StrCat(
+        target_prefix_,
+        std::string_view(entry.key).substr(source_prefix_length_));
+    if (!IsValidObjectName(target_key)) {
+      SetDeferredResult(promise_,
+                        absl::InvalidArgumentError("Invalid GCS object name"));
+      return;
+    }
+    auto op = PromiseFuturePair<void>::Make(tensorstore::MakeResult());
+    auto state = internal::MakeIntrusivePtr<RewriteTask>(
+        owner_,
+        tensorstore::StrCat(source_resource_root_, "/o/",
+                            internal::PercentEncodeUriComponent(entry.key)),
+        internal::PercentEncodeUriComponent(target_key),
+        std::move(op.promise));
+    intrusive_ptr_increment(state.get());  // adopted by RewriteTask::Start.
+    owner_->write_rate_limiter().Admit(state.get(), &RewriteTask::Start);
+    LinkError(promise_, std::move(op.future));
+  }
+
+  void set_error(absl::Status error) {
+    SetDeferredResult(promise_, std::move(error));
+    promise_ = Promise<void>();
+  }
+
+  void set_done() { promise_ = Promise<void>(); }
+
+  void set_stopping() { cancel_registration_.Unregister(); }
+};
+
+Future<const void> GcsKeyValueStore::ExperimentalCopyRangeFrom(
+    const internal::OpenTransactionPtr& transaction, const KvStore& source,
+    Key target_prefix, kvstore::CopyRangeOptions options) {
+  // Server-side copies are only possible between GCS buckets, and are not
+  // atomic, so they cannot participate in a transaction.
+  if (transaction || source.transaction != no_transaction ||
+      typeid(*source.driver) != typeid(GcsKeyValueStore)) {
+    return kvstore::Driver::ExperimentalCopyRangeFrom(
+        transaction, source, std::move(target_prefix), std::move(options));
+  }
+  gcs_copy_range.Increment();
+  auto& source_driver = static_cast<GcsKeyValueStore&>(*source.driver);
+  auto op = PromiseFuturePair<void>::Make(tensorstore::MakeResult());
+  ListOptions list_options;
+  list_options.range = KeyRange::AddPrefix(source.path, options.source_range);
+  list_options.staleness_bound = options.source_staleness_bound;
+  source_driver.ListImpl(
+      std::move(list_options),
+      CopyRangeListReceiver{internal::IntrusivePtr<GcsKeyValueStore>(this),
+                            source_driver.resource_root(), source.path.size(),
+                            std::move(target_prefix), std::move(op.promise)});
+  return std::move(op.future);
+}
+
 Result<kvstore::Spec> ParseGcsUrl(std::string_view url) {
   auto parsed = internal::ParseGenericUri(url);
   assert(parsed.scheme == kUriScheme);
@@ -1298,6 +2364,8 @@ Result<kvstore::Spec> ParseGcsUrl(std::string_view url) {
       Context::Resource<GcsRequestRetries>::DefaultSpec();
   driver_spec->data_.data_copy_concurrency =
       Context::Resource<DataCopyConcurrencyResource>::DefaultSpec();
+  driver_spec->data_.memory_budget =
+      Context::Resource<MemoryBudgetResource>::DefaultSpec();
 
   return {std::in_place, std::move(driver_spec), std::move(decoded_path)};
 }
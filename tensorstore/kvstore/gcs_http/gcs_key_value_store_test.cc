@@ -49,6 +49,7 @@
 #include "tensorstore/json_serialization_options_base.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/gcs_http/gcs_mock.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -77,6 +78,7 @@ using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::Result;
 using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesListEntry;
 using ::tensorstore::internal::ScheduleAt;
 using ::tensorstore::internal_http::ApplyResponseToHandler;
@@ -250,6 +252,144 @@ TEST(GcsKeyValueStoreTest, Basic) {
   tensorstore::internal::TestKeyValueReadWriteOps(store);
 }
 
+TEST(GcsKeyValueStoreTest, ParallelRead) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", kDriver},
+                                 {"bucket", "my-bucket"},
+                                 {"parallel_read_part_size", 4}},
+                                context)
+                      .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, store.spec());
+  EXPECT_THAT(spec.ToJson(tensorstore::IncludeDefaults{false}),
+              ::testing::Optional(MatchesJson({{"driver", kDriver},
+                                               {"bucket", "my-bucket"},
+                                               {"parallel_read_part_size", 4}})));
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp,
+      kvstore::Write(store, "a", absl::Cord("0123456789")).result());
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("0123456789"), stamp.generation));
+  {
+    kvstore::ReadOptions options;
+    options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 9);
+    EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+                MatchesKvsReadResult(absl::Cord("12345678"), stamp.generation));
+  }
+  {
+    kvstore::ReadOptions options;
+    options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 20);
+    EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+                MatchesStatus(absl::StatusCode::kOutOfRange));
+  }
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "empty", absl::Cord()).result());
+  EXPECT_THAT(kvstore::Read(store, "empty").result(),
+              MatchesKvsReadResult(absl::Cord()));
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(GcsKeyValueStoreTest, ParallelUpload) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", kDriver},
+                                 {"bucket", "my-bucket"},
+                                 {"parallel_upload_part_size", 4}},
+                                context)
+                      .result());
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp,
+      kvstore::Write(store, "a", absl::Cord("0123456789")).result());
+  EXPECT_FALSE(StorageGeneration::IsUnknown(stamp.generation));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("0123456789"), stamp.generation));
+
+  // Conditions are applied to the composed object.
+  {
+    kvstore::WriteOptions options;
+    options.generation_conditions.if_equal = StorageGeneration::NoValue();
+    EXPECT_THAT(
+        kvstore::Write(store, "a", absl::Cord("abcdefghij"), options).result(),
+        ::testing::Optional(::testing::Field(
+            &tensorstore::TimestampedStorageGeneration::generation,
+            StorageGeneration::Unknown())));
+  }
+  {
+    kvstore::WriteOptions options;
+    options.generation_conditions.if_equal = stamp.generation;
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto new_stamp,
+        kvstore::Write(store, "a", absl::Cord("abcdefghij"), options).result());
+    EXPECT_THAT(
+        kvstore::Read(store, "a").result(),
+        MatchesKvsReadResult(absl::Cord("abcdefghij"), new_stamp.generation));
+  }
+
+  // The temporary part objects are deleted.
+  EXPECT_THAT(ListFuture(store, {}).result(),
+              ::testing::Optional(
+                  ::testing::ElementsAre(MatchesListEntry("a"))));
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(GcsKeyValueStoreTest, HedgedRead) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", kDriver},
+                                 {"bucket", "my-bucket"},
+                                 {"hedge_read_percentile", 95},
+                                 {"hedge_read_budget", 0.5}},
+                                context)
+                      .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, store.spec());
+  EXPECT_THAT(spec.ToJson(tensorstore::IncludeDefaults{false}),
+              ::testing::Optional(MatchesJson({{"driver", kDriver},
+                                               {"bucket", "my-bucket"},
+                                               {"hedge_read_percentile", 95},
+                                               {"hedge_read_budget", 0.5}})));
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "a", absl::Cord("abc")).result());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(kvstore::Read(store, "a").result(),
+                MatchesKvsReadResult(absl::Cord("abc"), stamp.generation));
+  }
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+
+  EXPECT_THAT(kvstore::Open({{"driver", kDriver},
+                             {"bucket", "my-bucket"},
+                             {"hedge_read_percentile", 100}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(kvstore::Open({{"driver", kDriver},
+                             {"bucket", "my-bucket"},
+                             {"hedge_read_percentile", 95},
+                             {"hedge_read_budget", 2}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(GcsKeyValueStoreTest, Retry) {
   for (int max_retries : {2, 3, 4}) {
     for (bool fail : {false, true}) {
@@ -509,6 +649,22 @@ TEST(GcsKeyValueStoreTest, DeletePrefix) {
   tensorstore::internal::TestKeyValueStoreDeletePrefix(store);
 }
 
+TEST(GcsKeyValueStoreTest, CopyRange) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  bucket.SetErrorRate(0.02);
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", kDriver}, {"bucket", "my-bucket"}}, context)
+          .result());
+  tensorstore::internal::TestKeyValueStoreCopyRange(store);
+}
+
 TEST(GcsKeyValueStoreTest, DeleteRange) {
   auto mock_transport = std::make_shared<MyMockTransport>();
   DefaultHttpTransportSetter mock_transport_setter{mock_transport};
@@ -555,12 +711,55 @@ TEST(GcsKeyValueStoreTest, DeleteRangeFromBeginning) {
   tensorstore::internal::TestKeyValueStoreDeleteRangeFromBeginning(store);
 }
 
+class MyBatchCountingMockTransport : public MyMockTransport {
+ public:
+  void IssueRequestWithHandler(const HttpRequest& request,
+                               IssueRequestOptions options,
+                               HttpResponseHandler* response_handler) final {
+    if (request.method == "DELETE") ++delete_requests_;
+    if (absl::StrContains(request.url, "/batch/")) ++batch_requests_;
+    MyMockTransport::IssueRequestWithHandler(request, std::move(options),
+                                             response_handler);
+  }
+
+  std::atomic<size_t> delete_requests_{0};
+  std::atomic<size_t> batch_requests_{0};
+};
+
+TEST(GcsKeyValueStoreTest, DeleteRangeBatched) {
+  auto mock_transport = std::make_shared<MyBatchCountingMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", kDriver}, {"bucket", "my-bucket"}}, context)
+          .result());
+  for (int i = 0; i < 150; ++i) {
+    TENSORSTORE_ASSERT_OK(
+        kvstore::Write(store, tensorstore::StrCat("a/", i), absl::Cord("x")));
+  }
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "b", absl::Cord("x")));
+
+  TENSORSTORE_ASSERT_OK(
+      kvstore::DeleteRange(store, tensorstore::KeyRange::Prefix("a/")));
+  EXPECT_EQ(0, mock_transport->delete_requests_.load());
+  EXPECT_EQ(2, mock_transport->batch_requests_.load());
+  EXPECT_THAT(ListFuture(store).result(),
+              ::testing::Optional(
+                  ::testing::ElementsAre(MatchesListEntry("b"))));
+}
+
 class MyDeleteRangeCancellationMockTransport : public MyMockTransport {
  public:
   void IssueRequestWithHandler(const HttpRequest& request,
                                IssueRequestOptions options,
                                HttpResponseHandler* response_handler) final {
-    if (request.method == "DELETE") {
+    if (request.method == "DELETE" ||
+        absl::StrContains(request.url, "/batch/")) {
       cancellation_notification_.WaitForNotification();
       ++total_delete_requests_;
     }
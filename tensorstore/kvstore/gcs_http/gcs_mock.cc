@@ -30,9 +30,11 @@
 #include "absl/log/absl_log.h"
 #include "absl/random/distributions.h"
 #include "absl/status/status.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/substitute.h"
 #include "absl/synchronization/mutex.h"
@@ -41,6 +43,7 @@
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -125,6 +128,10 @@ GCSMockStorageBucket::Match(const HttpRequest& request, absl::Cord payload) {
     return {};
   }
   std::string_view path = parsed.authority_and_path;
+  if (path == "storage.googleapis.com/batch/storage/v1" &&
+      request.method == "POST") {
+    return HandleBatchRequest(request, payload);
+  }
   if (absl::StartsWith(path, bucket_prefix_)) {
     // Bucket path.
     path.remove_prefix(bucket_prefix_.size());
@@ -187,6 +194,15 @@ GCSMockStorageBucket::Match(const HttpRequest& request, absl::Cord payload) {
               R"({ "error": { "code": 400, "message": "Uploads must be sent to the upload URL." } })")};
     }
     return HandleInsertRequest(path, params, payload);
+  } else if (absl::StartsWith(path, "/o/") &&
+             absl::EndsWith(path, "/compose") && request.method == "POST") {
+    // POST request to compose an object.
+    return HandleComposeRequest(path, params, payload);
+  } else if (absl::StartsWith(path, "/o/") &&
+             absl::StrContains(path, "/rewriteTo/b/") &&
+             request.method == "POST") {
+    // POST request to rewrite (copy) an object.
+    return HandleRewriteRequest(path, params);
   } else if (absl::StartsWith(path, "/o/") && request.method == "GET") {
     // GET request on an object.
     return HandleGetRequest(request, path, params);
@@ -197,15 +213,71 @@ GCSMockStorageBucket::Match(const HttpRequest& request, absl::Cord payload) {
 
   // NOT HANDLED
   // update (PUT request)
-  // .../compose
   // .../watch
-  // .../rewrite/...
   // patch (PATCH request)
   // .../copyTo/...
 
   return HttpResponse{404, absl::Cord()};
 }
 
+std::variant<std::monostate, HttpResponse, absl::Status>
+GCSMockStorageBucket::HandleBatchRequest(const HttpRequest& request,
+                                         const absl::Cord& payload) {
+  // https://cloud.google.com/storage/docs/batch
+  std::string_view content_type;
+  for (const auto& header : request.headers) {
+    if (absl::StartsWithIgnoreCase(header, "content-type:")) {
+      content_type =
+          absl::StripAsciiWhitespace(std::string_view(header).substr(13));
+    }
+  }
+  std::string flat_payload(payload);
+  auto parts = internal_kvstore_gcs_http::ParseBatchRequestPayload(
+      content_type, flat_payload);
+  if (!parts.ok() || parts->empty() ||
+      parts->size() > internal_kvstore_gcs_http::kMaxBatchRequestParts) {
+    return HttpResponse{400, absl::Cord()};
+  }
+  // Only handle batches which are addressed to this bucket.
+  const std::string part_prefix =
+      tensorstore::StrCat("/storage/v1/b/", bucket_, "/");
+  for (const auto& part : *parts) {
+    if (!absl::StartsWith(part.path, part_prefix)) return {};
+  }
+
+  constexpr std::string_view kBoundary = "mock_batch_boundary";
+  std::string body;
+  for (size_t i = 0; i < parts->size(); ++i) {
+    HttpRequest part_request;
+    part_request.method = (*parts)[i].method;
+    part_request.url =
+        tensorstore::StrCat("https://storage.googleapis.com", (*parts)[i].path);
+    auto match_result = Match(part_request, absl::Cord());
+    HttpResponse part_response{404, absl::Cord()};
+    if (auto* r = std::get_if<HttpResponse>(&match_result)) {
+      part_response = std::move(*r);
+    } else if (std::holds_alternative<absl::Status>(match_result)) {
+      part_response = HttpResponse{500, absl::Cord()};
+    }
+    absl::StrAppend(&body, "--", kBoundary, "\r\n",
+                    "Content-Type: application/http\r\n",
+                    "Content-ID: <response-item+", i, ">\r\n\r\n",
+                    "HTTP/1.1 ", part_response.status_code, "\r\n");
+    for (const auto& [key, value] : part_response.headers) {
+      absl::StrAppend(&body, key, ": ", value, "\r\n");
+    }
+    absl::StrAppend(&body, "\r\n", std::string(part_response.payload),
+                    "\r\n");
+  }
+  absl::StrAppend(&body, "--", kBoundary, "--\r\n");
+
+  HttpResponse response{200, absl::Cord(std::move(body))};
+  response.headers.insert(
+      {"content-type",
+       tensorstore::StrCat("multipart/mixed; boundary=", kBoundary)});
+  return response;
+}
+
 std::variant<std::monostate, HttpResponse, absl::Status>
 GCSMockStorageBucket::HandleListRequest(std::string_view path,
                                         const ParamMap& params) {
@@ -318,6 +390,112 @@ GCSMockStorageBucket::HandleInsertRequest(std::string_view path,
   return HttpResponse{404, absl::Cord()};
 }
 
+std::variant<std::monostate, HttpResponse, absl::Status>
+GCSMockStorageBucket::HandleComposeRequest(std::string_view path,
+                                           const ParamMap& params,
+                                           absl::Cord payload) {
+  // https://cloud.google.com/storage/docs/json_api/v1/objects/compose
+  path.remove_prefix(3);  // remove /o/
+  path.remove_suffix(8);  // remove /compose
+  std::string name = internal::PercentDecode(path);
+
+  QueryParameters parsed_parameters;
+  {
+    auto parse_result = ParseQueryParameters(params, &parsed_parameters);
+    if (parse_result.has_value()) {
+      return std::move(parse_result.value());
+    }
+  }
+
+  auto body = ::nlohmann::json::parse(std::string(payload), nullptr,
+                                      /*allow_exceptions=*/false);
+  if (!body.is_object() || !body.contains("sourceObjects") ||
+      !body["sourceObjects"].is_array() || body["sourceObjects"].empty() ||
+      body["sourceObjects"].size() > 32) {
+    return HttpResponse{400, absl::Cord()};
+  }
+
+  absl::Cord data;
+  for (const auto& source : body["sourceObjects"]) {
+    if (!source.is_object() || !source.contains("name") ||
+        !source["name"].is_string()) {
+      return HttpResponse{400, absl::Cord()};
+    }
+    auto it = data_.find(source["name"].get<std::string>());
+    if (it == data_.end()) {
+      return HttpResponse{404, absl::Cord()};
+    }
+    data.Append(it->second.data);
+  }
+
+  auto it = data_.find(name);
+  if (parsed_parameters.ifGenerationMatch.has_value()) {
+    const int64_t v = parsed_parameters.ifGenerationMatch.value();
+    if (v == 0 ? it != data_.end()
+               : (it == data_.end() || v != it->second.generation)) {
+      // generation does not match.
+      return HttpResponse{412, absl::Cord()};
+    }
+  }
+
+  auto& obj = data_[name];
+  if (obj.name.empty()) {
+    obj.name = std::move(name);
+  }
+  obj.generation = ++next_generation_;
+  obj.data = std::move(data);
+
+  ABSL_LOG(INFO) << "Composed: " << obj.name << " " << obj.generation;
+
+  return ObjectMetadataResponse(obj);
+}
+
+std::variant<std::monostate, HttpResponse, absl::Status>
+GCSMockStorageBucket::HandleRewriteRequest(std::string_view path,
+                                           const ParamMap& params) {
+  // https://cloud.google.com/storage/docs/json_api/v1/objects/rewrite
+  path.remove_prefix(3);  // remove /o/
+  std::pair<std::string_view, std::string_view> split =
+      absl::StrSplit(path, absl::MaxSplits("/rewriteTo/b/", 1));
+  std::string source_name = internal::PercentDecode(split.first);
+  std::pair<std::string_view, std::string_view> destination =
+      absl::StrSplit(split.second, absl::MaxSplits("/o/", 1));
+  if (destination.first != bucket_) {
+    // Only rewrites within the mock bucket are supported.
+    return HttpResponse{404, absl::Cord()};
+  }
+  std::string name = internal::PercentDecode(destination.second);
+
+  auto source_it = data_.find(source_name);
+  if (source_it == data_.end()) {
+    return HttpResponse{404, absl::Cord()};
+  }
+
+  // Like GCS for large objects, require a second request which presents the
+  // rewrite token returned by the first.
+  if (params.find("rewriteToken") == params.end()) {
+    ::nlohmann::json response{{"kind", "storage#rewriteResponse"},
+                              {"done", false},
+                              {"rewriteToken", "mock token"}};
+    return HttpResponse{200, absl::Cord(response.dump())};
+  }
+
+  absl::Cord data = source_it->second.data;
+  auto& obj = data_[name];
+  if (obj.name.empty()) {
+    obj.name = std::move(name);
+  }
+  obj.generation = ++next_generation_;
+  obj.data = std::move(data);
+
+  ABSL_LOG(INFO) << "Rewritten: " << obj.name << " " << obj.generation;
+
+  ::nlohmann::json response{{"kind", "storage#rewriteResponse"},
+                            {"done", true},
+                            {"resource", ObjectMetadata(obj)}};
+  return HttpResponse{200, absl::Cord(response.dump())};
+}
+
 std::optional<OptionalByteRangeRequest> ParseRangeHeader(
     std::string_view header) {
   static LazyRE2 kRange = {R"((?i)range: bytes=(\d+)?-(\d+)?)"};
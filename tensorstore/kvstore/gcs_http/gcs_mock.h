@@ -72,6 +72,11 @@ class GCSMockStorageBucket {
   std::variant<std::monostate, internal_http::HttpResponse, absl::Status> Match(
       const internal_http::HttpRequest& request, absl::Cord payload);
 
+  // Dispatch each part of a JSON API batch request.
+  std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
+  HandleBatchRequest(const internal_http::HttpRequest& request,
+                     const absl::Cord& payload);
+
   // List objects in the bucket.
   std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
   HandleListRequest(std::string_view path, const ParamMap& params);
@@ -81,6 +86,15 @@ class GCSMockStorageBucket {
   HandleInsertRequest(std::string_view path, const ParamMap& params,
                       absl::Cord payload);
 
+  // Compose existing objects into a new object.
+  std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
+  HandleComposeRequest(std::string_view path, const ParamMap& params,
+                       absl::Cord payload);
+
+  // Copy an existing object to a new object.
+  std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
+  HandleRewriteRequest(std::string_view path, const ParamMap& params);
+
   // Get an object, which might be the data or the metadata.
   std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
   HandleGetRequest(const internal_http::HttpRequest& request,
@@ -19,10 +19,12 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "absl/base/call_once.h"
 #include "absl/flags/marshalling.h"
 #include "absl/log/absl_log.h"
+#include "absl/status/status.h"
 #include "absl/time/time.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
@@ -30,7 +32,10 @@
 #include "tensorstore/internal/rate_limiter/admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/rate_limiter/scaling_rate_limiter.h"
+#include "tensorstore/internal/rate_limiter/token_bucket_rate_limiter.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 
 /// specializations
 #include "tensorstore/internal/cache_key/absl_time.h"
@@ -47,6 +52,8 @@ using ::tensorstore::internal::ConstantRateLimiter;
 using ::tensorstore::internal::ContextResourceCreationContext;
 using ::tensorstore::internal::DoublingRateLimiter;
 using ::tensorstore::internal::NoRateLimiter;
+using ::tensorstore::internal::RateLimiter;
+using ::tensorstore::internal::RateLimiterUnit;
 
 namespace tensorstore {
 namespace internal_kvstore_gcs_http {
@@ -87,6 +94,33 @@ std::optional<absl::Duration> GetEnvGcsRateLimiterDoublingTime() {
   return std::nullopt;
 }
 
+/// Returns a limiter for `rate` requests per second or `bytes_rate` bytes per
+/// second, or a `NoRateLimiter` if neither is specified.
+Result<std::shared_ptr<RateLimiter>> MakeRateLimiter(
+    std::string_view name, std::optional<double> rate,
+    std::optional<double> bytes_rate, absl::Duration doubling_time) {
+  if (rate && bytes_rate) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("\"", name, "_rate\" and \"", name,
+                            "_bytes_rate\" are mutually exclusive"));
+  }
+  std::shared_ptr<RateLimiter> limiter;
+  if (!rate && !bytes_rate) {
+    limiter = std::make_shared<NoRateLimiter>();
+    return limiter;
+  }
+  const auto unit =
+      rate ? RateLimiterUnit::kRequests : RateLimiterUnit::kBytes;
+  const double initial_rate = rate ? *rate : *bytes_rate;
+  if (doubling_time > absl::ZeroDuration()) {
+    limiter = std::make_shared<DoublingRateLimiter>(initial_rate,
+                                                    doubling_time, unit);
+  } else {
+    limiter = std::make_shared<ConstantRateLimiter>(initial_rate, unit);
+  }
+  return limiter;
+}
+
 }  // namespace
 
 GcsConcurrencyResource::GcsConcurrencyResource(size_t shared_limit)
@@ -98,6 +132,13 @@ GcsConcurrencyResource::GcsConcurrencyResource()
 
 Result<GcsConcurrencyResource::Resource> GcsConcurrencyResource::Create(
     const Spec& spec, ContextResourceCreationContext context) const {
+  if (spec.adaptive) {
+    Resource value;
+    value.spec = spec;
+    value.queue = std::make_shared<AdmissionQueue>(
+        /*min_limit=*/1, /*max_limit=*/spec.limit.value_or(shared_limit_));
+    return value;
+  }
   if (spec.limit) {
     Resource value;
     value.spec = spec;
@@ -120,28 +161,13 @@ Result<GcsRateLimiterResource::Resource> GcsRateLimiterResource::Create(
   auto doubling_time = spec.doubling_time.value_or(
       GetEnvGcsRateLimiterDoublingTime().value_or(absl::ZeroDuration()));
 
-  if (spec.read_rate) {
-    if (doubling_time > absl::ZeroDuration()) {
-      value.read_limiter =
-          std::make_shared<DoublingRateLimiter>(*spec.read_rate, doubling_time);
-    } else {
-      value.read_limiter =
-          std::make_shared<ConstantRateLimiter>(*spec.read_rate);
-    }
-  } else {
-    value.read_limiter = std::make_shared<NoRateLimiter>();
-  }
-  if (spec.write_rate) {
-    if (doubling_time > absl::ZeroDuration()) {
-      value.write_limiter = std::make_shared<DoublingRateLimiter>(
-          *spec.write_rate, doubling_time);
-    } else {
-      value.write_limiter =
-          std::make_shared<ConstantRateLimiter>(*spec.write_rate);
-    }
-  } else {
-    value.write_limiter = std::make_shared<NoRateLimiter>();
-  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      value.read_limiter, MakeRateLimiter("read", spec.read_rate,
+                                          spec.read_bytes_rate, doubling_time));
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      value.write_limiter,
+      MakeRateLimiter("write", spec.write_rate, spec.write_bytes_rate,
+                      doubling_time));
   return value;
 }
 
@@ -0,0 +1,125 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/hedged_read.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+namespace {
+
+auto& hedged_reads = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/hedged_reads", "Duplicate reads issued by hedging");
+
+// Number of recent latencies from which the delay is computed.
+constexpr size_t kMaxSamples = 1024;
+
+// Number of latencies recorded between updates of the delay.
+constexpr size_t kUpdateInterval = 64;
+
+// Maximum number of duplicate reads which may be issued in a burst.
+constexpr double kMaxTokens = 10;
+
+}  // namespace
+
+ReadHedger::ReadHedger(double percentile, double budget)
+    : percentile_(percentile), budget_(budget) {
+  samples_.reserve(kMaxSamples);
+}
+
+Future<kvstore::ReadResult> ReadHedger::Read(ReadFunction read) {
+  const absl::Time start_time = absl::Now();
+  absl::Duration delay;
+  {
+    absl::MutexLock lock(&mutex_);
+    tokens_ = std::min(kMaxTokens, tokens_ + budget_);
+    delay = delay_;
+  }
+  auto pair = PromiseFuturePair<kvstore::ReadResult>::Make();
+  // Whichever linked read completes first sets the result, which unregisters
+  // the other link and thereby cancels the other read.
+  LinkResult(pair.promise, TimedRead(read));
+  if (delay != absl::InfiniteDuration()) {
+    internal::ScheduleAt(
+        start_time + delay,
+        [this, promise = std::move(pair.promise), read = std::move(read)] {
+          if (!promise.result_needed() || !AcquireHedge()) return;
+          hedged_reads.Increment();
+          LinkResult(promise, TimedRead(read));
+        });
+  }
+  return std::move(pair.future);
+}
+
+Future<kvstore::ReadResult> ReadHedger::TimedRead(const ReadFunction& read) {
+  return MapFutureValue(
+      InlineExecutor{},
+      [this, start_time = absl::Now()](kvstore::ReadResult& result) {
+        RecordLatency(absl::Now() - start_time);
+        return std::move(result);
+      },
+      read());
+}
+
+void ReadHedger::RecordLatency(absl::Duration latency) {
+  absl::MutexLock lock(&mutex_);
+  if (samples_.size() < kMaxSamples) {
+    samples_.push_back(latency);
+  } else {
+    samples_[next_sample_] = latency;
+    next_sample_ = (next_sample_ + 1) % kMaxSamples;
+  }
+  if (samples_.size() < kMinSamples ||
+      (++samples_since_update_ < kUpdateInterval &&
+       delay_ != absl::InfiniteDuration())) {
+    return;
+  }
+  samples_since_update_ = 0;
+  std::vector<absl::Duration> sorted = samples_;
+  auto nth = sorted.begin() +
+             std::min(sorted.size() - 1,
+                      static_cast<size_t>(sorted.size() * percentile_ / 100));
+  std::nth_element(sorted.begin(), nth, sorted.end());
+  delay_ = *nth;
+}
+
+absl::Duration ReadHedger::delay() const {
+  absl::MutexLock lock(&mutex_);
+  return delay_;
+}
+
+bool ReadHedger::AcquireHedge() {
+  absl::MutexLock lock(&mutex_);
+  if (tokens_ < 1) return false;
+  tokens_ -= 1;
+  return true;
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
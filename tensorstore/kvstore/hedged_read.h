@@ -0,0 +1,124 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_HEDGED_READ_H_
+#define TENSORSTORE_KVSTORE_HEDGED_READ_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Issues duplicate ("hedged") reads to reduce tail latency.
+///
+/// The latencies of recent successful reads are tracked, and if a read has not
+/// completed after the configured percentile of those latencies, a duplicate
+/// read is issued.  The result of whichever read completes first is returned,
+/// and the other read is cancelled.  The number of duplicate reads is limited
+/// to a fraction of all reads, such that hedging does not amplify load on an
+/// overloaded backend.
+///
+/// This class is thread-safe.
+class ReadHedger {
+ public:
+  using ReadFunction = std::function<Future<kvstore::ReadResult>()>;
+
+  /// Minimum number of recorded latencies before reads are hedged.
+  constexpr static size_t kMinSamples = 64;
+
+  /// Default value of `budget`.
+  constexpr static double kDefaultBudget = 0.05;
+
+  /// \param percentile Percentile, in `(0, 100)`, of recent read latencies
+  ///     after which a duplicate read is issued.
+  /// \param budget Maximum fraction, in `[0, 1]`, of reads that are
+  ///     duplicated.
+  ReadHedger(double percentile, double budget);
+
+  /// Invokes `read`, and invokes it again if it does not complete within the
+  /// hedging delay.
+  ///
+  /// `read` must keep this `ReadHedger` alive, e.g. by holding a reference to
+  /// the driver that owns it.
+  Future<kvstore::ReadResult> Read(ReadFunction read);
+
+  /// Records the latency of a successful read.
+  void RecordLatency(absl::Duration latency);
+
+  /// Returns the current hedging delay, or `absl::InfiniteDuration()` if too
+  /// few latencies have been recorded.
+  absl::Duration delay() const;
+
+ private:
+  // Returns a future for `read()` which records its latency.
+  Future<kvstore::ReadResult> TimedRead(const ReadFunction& read);
+
+  // Consumes budget for a duplicate read, returning `false` if none remains.
+  bool AcquireHedge();
+
+  const double percentile_;
+  const double budget_;
+  mutable absl::Mutex mutex_;
+  // Ring buffer of recent latencies.
+  std::vector<absl::Duration> samples_ ABSL_GUARDED_BY(mutex_);
+  size_t next_sample_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t samples_since_update_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Duration delay_ ABSL_GUARDED_BY(mutex_) = absl::InfiniteDuration();
+  // Number of duplicate reads that may currently be issued.
+  double tokens_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+/// JSON binder for `hedge_read_percentile` driver options.
+constexpr auto HedgeReadPercentileBinder() {
+  namespace jb = ::tensorstore::internal_json_binding;
+  return jb::Validate(
+      [](const auto& options, double* obj) {
+        if (!(*obj > 0 && *obj < 100)) {
+          return absl::InvalidArgumentError(
+              "Expected percentile in the range (0, 100)");
+        }
+        return absl::OkStatus();
+      },
+      jb::FloatBinder);
+}
+
+/// JSON binder for `hedge_read_budget` driver options.
+constexpr auto HedgeReadBudgetBinder() {
+  namespace jb = ::tensorstore::internal_json_binding;
+  return jb::Validate(
+      [](const auto& options, double* obj) {
+        if (!(*obj >= 0 && *obj <= 1)) {
+          return absl::InvalidArgumentError(
+              "Expected fraction in the range [0, 1]");
+        }
+        return absl::OkStatus();
+      },
+      jb::FloatBinder);
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_HEDGED_READ_H_
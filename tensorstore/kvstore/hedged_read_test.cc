@@ -0,0 +1,137 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/hedged_read.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::Future;
+using ::tensorstore::Promise;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal_kvstore::ReadHedger;
+using ::tensorstore::kvstore::ReadResult;
+
+// Records the promises of the reads issued via `read()`.
+struct PendingReads {
+  absl::Mutex mutex;
+  std::vector<Promise<ReadResult>> promises;
+
+  ReadHedger::ReadFunction read() {
+    return [this] {
+      auto pair = PromiseFuturePair<ReadResult>::Make();
+      absl::MutexLock lock(&mutex);
+      promises.push_back(std::move(pair.promise));
+      return std::move(pair.future);
+    };
+  }
+
+  size_t size() {
+    absl::MutexLock lock(&mutex);
+    return promises.size();
+  }
+
+  // Waits until at least `n` reads were issued, or `timeout` elapses.
+  bool WaitFor(size_t n, absl::Duration timeout) {
+    const absl::Time deadline = absl::Now() + timeout;
+    while (size() < n) {
+      if (absl::Now() > deadline) return false;
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+    return true;
+  }
+
+  Promise<ReadResult> get(size_t i) {
+    absl::MutexLock lock(&mutex);
+    return promises[i];
+  }
+};
+
+ReadResult Value(const char* value) {
+  return ReadResult::Value(absl::Cord(value),
+                           {StorageGeneration::FromString("g"),
+                            absl::UnixEpoch()});
+}
+
+TEST(ReadHedgerTest, NoDelayWithoutSamples) {
+  ReadHedger hedger(50, 1);
+  EXPECT_EQ(absl::InfiniteDuration(), hedger.delay());
+  for (size_t i = 0; i + 1 < ReadHedger::kMinSamples; ++i) {
+    hedger.RecordLatency(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(absl::InfiniteDuration(), hedger.delay());
+  hedger.RecordLatency(absl::Milliseconds(1));
+  EXPECT_EQ(absl::Milliseconds(1), hedger.delay());
+}
+
+TEST(ReadHedgerTest, Percentile) {
+  ReadHedger hedger(75, 1);
+  for (size_t i = 0; i < ReadHedger::kMinSamples; ++i) {
+    hedger.RecordLatency(absl::Milliseconds(i));
+  }
+  EXPECT_EQ(absl::Milliseconds(48), hedger.delay());
+}
+
+TEST(ReadHedgerTest, UnhedgedRead) {
+  ReadHedger hedger(50, 1);
+  PendingReads reads;
+  auto future = hedger.Read(reads.read());
+  ASSERT_EQ(1, reads.size());
+  reads.get(0).SetResult(Value("a"));
+  EXPECT_THAT(future.result(), MatchesKvsReadResult(absl::Cord("a")));
+}
+
+TEST(ReadHedgerTest, HedgedRead) {
+  ReadHedger hedger(50, 1);
+  for (size_t i = 0; i < ReadHedger::kMinSamples; ++i) {
+    hedger.RecordLatency(absl::Milliseconds(1));
+  }
+  PendingReads reads;
+  auto future = hedger.Read(reads.read());
+  ASSERT_TRUE(reads.WaitFor(2, absl::Seconds(10)));
+  // The duplicate read completes first, and the original read is cancelled.
+  reads.get(1).SetResult(Value("b"));
+  EXPECT_THAT(future.result(), MatchesKvsReadResult(absl::Cord("b")));
+  EXPECT_FALSE(reads.get(0).result_needed());
+}
+
+TEST(ReadHedgerTest, Budget) {
+  ReadHedger hedger(50, 0);
+  for (size_t i = 0; i < ReadHedger::kMinSamples; ++i) {
+    hedger.RecordLatency(absl::Milliseconds(1));
+  }
+  PendingReads reads;
+  auto future = hedger.Read(reads.read());
+  EXPECT_FALSE(reads.WaitFor(2, absl::Milliseconds(100)));
+  reads.get(0).SetResult(Value("a"));
+  EXPECT_THAT(future.result(), MatchesKvsReadResult(absl::Cord("a")));
+}
+
+}  // namespace
@@ -14,17 +14,123 @@
 
 #include "tensorstore/kvstore/http/byte_range_util.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace internal_http {
+namespace {
+
+/// Maximum number of bytes searched for a boundary delimiter or for the end
+/// of the headers of a part.
+constexpr size_t kMaxMultipartSearchSize = 16384;
+
+/// Returns the boundary of a `multipart/byteranges` response, or `std::nullopt`
+/// if `response` has a different content type.
+std::optional<std::string> GetMultipartByteRangesBoundary(
+    const HttpResponse& response) {
+  auto it = response.headers.find("content-type");
+  if (it == response.headers.end()) return std::nullopt;
+  // For example: "multipart/byteranges; boundary=3d6b6a416f9b5"
+  std::vector<std::string_view> params = absl::StrSplit(it->second, ';');
+  if (!absl::EqualsIgnoreCase(absl::StripAsciiWhitespace(params[0]),
+                              "multipart/byteranges")) {
+    return std::nullopt;
+  }
+  for (size_t i = 1; i < params.size(); ++i) {
+    std::string_view param = absl::StripAsciiWhitespace(params[i]);
+    if (!absl::ConsumePrefix(&param, "boundary=")) continue;
+    if (param.size() >= 2 && param.front() == '"' && param.back() == '"') {
+      param = param.substr(1, param.size() - 2);
+    }
+    return std::string(param);
+  }
+  return std::string();
+}
+
+/// Returns the position of the first occurrence of `needle` in `payload` at
+/// or after `pos`, searching at most `kMaxMultipartSearchSize` bytes.
+std::optional<size_t> FindInPayload(const absl::Cord& payload, size_t pos,
+                                    std::string_view needle) {
+  if (pos > payload.size()) return std::nullopt;
+  std::string window(payload.Subcord(pos, kMaxMultipartSearchSize));
+  size_t i = window.find(needle);
+  if (i == std::string::npos) return std::nullopt;
+  return pos + i;
+}
+
+absl::Status ParseMultipartByteRanges(const absl::Cord& payload,
+                                      std::string_view boundary,
+                                      std::vector<ByteRangePart>& parts) {
+  const auto error = [](std::string_view message) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Invalid multipart/byteranges response: ", message));
+  };
+  if (boundary.empty()) return error("missing boundary");
+  const std::string delimiter = tensorstore::StrCat("--", boundary);
+  // The contents of each part are located using its Content-Range header,
+  // since they may contain the delimiter; only the preamble, the headers, and
+  // the delimiters themselves are searched.
+  auto delimiter_pos = FindInPayload(payload, 0, delimiter);
+  while (true) {
+    if (!delimiter_pos) return error("missing boundary delimiter");
+    size_t pos = *delimiter_pos + delimiter.size();
+    std::string after_delimiter(payload.Subcord(pos, 2));
+    if (after_delimiter == "--") break;
+    auto headers_begin = FindInPayload(payload, pos, "\r\n");
+    if (!headers_begin) return error("missing line break");
+    // The headers end with an empty line, which immediately follows the line
+    // break after the delimiter if there are no headers.
+    auto headers_end = FindInPayload(payload, *headers_begin, "\r\n\r\n");
+    if (!headers_end) return error("missing end of part headers");
+    std::string headers(
+        payload.Subcord(*headers_begin + 2, *headers_end - *headers_begin));
+    std::optional<ParsedContentRange> content_range;
+    for (std::string_view line : absl::StrSplit(headers, "\r\n")) {
+      std::string_view name = line.substr(0, line.find(':'));
+      if (name.size() == line.size() ||
+          !absl::EqualsIgnoreCase(name, "content-range")) {
+        continue;
+      }
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          content_range,
+          ParseContentRange(absl::StripAsciiWhitespace(
+              line.substr(name.size() + 1))));
+    }
+    if (!content_range) return error("part without Content-Range header");
+    const size_t value_begin = *headers_end + 4;
+    const int64_t size =
+        content_range->exclusive_max - content_range->inclusive_min;
+    if (value_begin + size > payload.size()) return error("truncated part");
+    parts.push_back(ByteRangePart{
+        ByteRange{content_range->inclusive_min, content_range->exclusive_max},
+        content_range->total_size, payload.Subcord(value_begin, size)});
+    delimiter_pos = FindInPayload(payload, value_begin + size, delimiter);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
 
 absl::Status ValidateResponseByteRange(
     const HttpResponse& response,
@@ -74,5 +180,50 @@ absl::Status ValidateResponseByteRange(
   return absl::OkStatus();
 }
 
+absl::Status GetResponseByteRange(const HttpResponse& response,
+                                  absl::Cord& value, ByteRange& byte_range,
+                                  int64_t& total_size) {
+  value = response.payload;
+  if (response.status_code != 206) {
+    total_size = response.payload.size();
+    byte_range = {0, total_size};
+    return absl::OkStatus();
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto content_range_info,
+                               ParseContentRangeHeader(response));
+  byte_range = {content_range_info.inclusive_min,
+                content_range_info.exclusive_max};
+  total_size = content_range_info.total_size;
+  if (byte_range.size() != value.size()) {
+    return absl::OutOfRangeError(tensorstore::StrCat(
+        "Response with byte range ", byte_range, " contains ", value.size(),
+        " bytes"));
+  }
+  return absl::OkStatus();
+}
+
+std::string FormatMultipleRangeHeader(span<const ByteRange> byte_ranges) {
+  assert(!byte_ranges.empty());
+  std::string header = "Range: bytes=";
+  for (size_t i = 0; i < byte_ranges.size(); ++i) {
+    absl::StrAppend(&header, i == 0 ? "" : ",", byte_ranges[i].inclusive_min,
+                    "-", byte_ranges[i].exclusive_max - 1);
+  }
+  return header;
+}
+
+absl::Status GetResponseByteRangeParts(const HttpResponse& response,
+                                       std::vector<ByteRangePart>& parts) {
+  parts.clear();
+  if (response.status_code == 206) {
+    if (auto boundary = GetMultipartByteRangesBoundary(response)) {
+      return ParseMultipartByteRanges(response.payload, *boundary, parts);
+    }
+  }
+  auto& part = parts.emplace_back();
+  return GetResponseByteRange(response, part.value, part.byte_range,
+                              part.total_size);
+}
+
 }  // namespace internal_http
 }  // namespace tensorstore
@@ -17,10 +17,14 @@
 
 #include <stdint.h>
 
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal_http {
@@ -34,6 +38,42 @@ absl::Status ValidateResponseByteRange(
     const OptionalByteRangeRequest& byte_range_request, absl::Cord& value,
     ByteRange& byte_range, int64_t& total_size);
 
+/// Determines the portion of a value contained in `response`, without
+/// requiring that it match a particular request.
+///
+/// This is used when reading part of a value that may extend past the end of
+/// the value, in which case the server truncates the response.  If the server
+/// ignored the requested range, `byte_range` covers the entire value.
+///
+/// Assigns the content to `value`, the corresponding byte range to
+/// `byte_range`, and the total size (or `-1` if unknown) to `total_size`.
+absl::Status GetResponseByteRange(const HttpResponse& response,
+                                  absl::Cord& value, ByteRange& byte_range,
+                                  int64_t& total_size);
+
+/// Returns a `Range` header requesting all of `byte_ranges`, such as
+/// "Range: bytes=0-9,100-109".
+///
+/// \dchecks `!byte_ranges.empty()`
+std::string FormatMultipleRangeHeader(span<const ByteRange> byte_ranges);
+
+/// Part of the response to a request for multiple byte ranges.
+struct ByteRangePart {
+  ByteRange byte_range;
+  /// Total size of the value, or `-1` if unknown.
+  int64_t total_size;
+  absl::Cord value;
+};
+
+/// Splits the response to a request for multiple byte ranges into parts.
+///
+/// In addition to `multipart/byteranges` responses (RFC 9110 section 14.6),
+/// handles servers that respond with a single, possibly merged, byte range, or
+/// that ignore the `Range` header and respond with the entire value.  The
+/// values of the parts reference `response.payload` rather than copying it.
+absl::Status GetResponseByteRangeParts(const HttpResponse& response,
+                                       std::vector<ByteRangePart>& parts);
+
 }  // namespace internal_http
 }  // namespace tensorstore
 
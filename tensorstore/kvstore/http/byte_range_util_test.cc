@@ -0,0 +1,124 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/http/byte_range_util.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::ByteRange;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_http::ByteRangePart;
+using ::tensorstore::internal_http::FormatMultipleRangeHeader;
+using ::tensorstore::internal_http::GetResponseByteRangeParts;
+using ::tensorstore::internal_http::HttpResponse;
+
+TEST(FormatMultipleRangeHeaderTest, Basic) {
+  const ByteRange byte_ranges[] = {{0, 10}, {100, 110}};
+  EXPECT_EQ("Range: bytes=0-9,100-109", FormatMultipleRangeHeader(byte_ranges));
+}
+
+TEST(GetResponseByteRangePartsTest, Multipart) {
+  HttpResponse response{
+      206,
+      absl::Cord("preamble\r\n"
+                 "--THIS_STRING_SEPARATES\r\n"
+                 "Content-Type: application/octet-stream\r\n"
+                 "Content-Range: bytes 0-3/20\r\n"
+                 "\r\n"
+                 "abcd\r\n"
+                 "--THIS_STRING_SEPARATES\r\n"
+                 "content-range: bytes 10-14/20\r\n"
+                 "\r\n"
+                 "--THI\r\n"
+                 "--THIS_STRING_SEPARATES--\r\n")};
+  response.headers.emplace(
+      "content-type", "multipart/byteranges; boundary=THIS_STRING_SEPARATES");
+  std::vector<ByteRangePart> parts;
+  TENSORSTORE_ASSERT_OK(GetResponseByteRangeParts(response, parts));
+  ASSERT_EQ(2, parts.size());
+  EXPECT_EQ((ByteRange{0, 4}), parts[0].byte_range);
+  EXPECT_EQ(20, parts[0].total_size);
+  EXPECT_EQ("abcd", parts[0].value);
+  EXPECT_EQ((ByteRange{10, 15}), parts[1].byte_range);
+  EXPECT_EQ("--THI", parts[1].value);
+}
+
+TEST(GetResponseByteRangePartsTest, MultipartQuotedBoundary) {
+  HttpResponse response{206, absl::Cord("--abc\r\n"
+                                        "Content-Range: bytes 5-5/*\r\n"
+                                        "\r\n"
+                                        "x\r\n"
+                                        "--abc--")};
+  response.headers.emplace("content-type",
+                           "multipart/byteranges; boundary=\"abc\"");
+  std::vector<ByteRangePart> parts;
+  TENSORSTORE_ASSERT_OK(GetResponseByteRangeParts(response, parts));
+  ASSERT_EQ(1, parts.size());
+  EXPECT_EQ((ByteRange{5, 6}), parts[0].byte_range);
+  EXPECT_EQ(-1, parts[0].total_size);
+  EXPECT_EQ("x", parts[0].value);
+}
+
+TEST(GetResponseByteRangePartsTest, MultipartInvalid) {
+  HttpResponse response{206, absl::Cord("--abc\r\n"
+                                        "Content-Range: bytes 0-9/20\r\n"
+                                        "\r\n"
+                                        "short")};
+  response.headers.emplace("content-type",
+                           "multipart/byteranges; boundary=abc");
+  std::vector<ByteRangePart> parts;
+  EXPECT_THAT(GetResponseByteRangeParts(response, parts),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Invalid multipart/byteranges response: "
+                            "truncated part"));
+
+  response.payload = absl::Cord("--abc\r\n\r\nvalue\r\n--abc--");
+  EXPECT_THAT(GetResponseByteRangeParts(response, parts),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            ".*part without Content-Range header"));
+}
+
+TEST(GetResponseByteRangePartsTest, SingleRange) {
+  // Servers may merge the requested ranges into a single range.
+  HttpResponse response{206, absl::Cord("0123456789")};
+  response.headers.emplace("content-range", "bytes 10-19/100");
+  std::vector<ByteRangePart> parts;
+  TENSORSTORE_ASSERT_OK(GetResponseByteRangeParts(response, parts));
+  ASSERT_EQ(1, parts.size());
+  EXPECT_EQ((ByteRange{10, 20}), parts[0].byte_range);
+  EXPECT_EQ(100, parts[0].total_size);
+  EXPECT_EQ("0123456789", parts[0].value);
+}
+
+TEST(GetResponseByteRangePartsTest, EntireValue) {
+  HttpResponse response{200, absl::Cord("0123456789")};
+  std::vector<ByteRangePart> parts;
+  TENSORSTORE_ASSERT_OK(GetResponseByteRangeParts(response, parts));
+  ASSERT_EQ(1, parts.size());
+  EXPECT_EQ((ByteRange{0, 10}), parts[0].byte_range);
+  EXPECT_EQ(10, parts[0].total_size);
+  EXPECT_EQ("0123456789", parts[0].value);
+}
+
+}  // namespace
@@ -16,7 +16,9 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -45,13 +47,13 @@
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/path.h"
 #include "tensorstore/internal/retries_context_resource.h"
-#include "tensorstore/internal/retry.h"
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/generic_coalescing_batch_util.h"
 #include "tensorstore/kvstore/http/byte_range_util.h"
+#include "tensorstore/kvstore/http/parallel_read.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
@@ -62,13 +64,18 @@
 #include "tensorstore/util/garbage_collection/fwd.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
 /// specializations
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/cache_key/std_vector.h"  // IWYU pragma: keep
 #include "tensorstore/internal/json_binding/std_array.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/serialization/std_vector.h"  // IWYU pragma: keep
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
 
 using ::tensorstore::internal::IntrusivePtr;
 using ::tensorstore::internal_http::HttpRequestBuilder;
@@ -83,6 +90,9 @@ namespace jb = tensorstore::internal_json_binding;
 auto& http_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/http/read", "http driver kvstore::Read calls");
 
+auto& http_stat = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/http/stat", "http driver kvstore::Stat calls");
+
 auto& http_batch_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/http/batch_read", "http driver reads after batching");
 
@@ -152,8 +162,17 @@ struct HttpKeyValueStoreSpecData {
   Context::Resource<HttpRequestRetries> retries;
   std::vector<std::string> headers;
 
+  /// Reads larger than this size are split into concurrent requests of at most
+  /// this size.
+  std::optional<int64_t> parallel_read_part_size;
+
+  /// Batched reads of multiple byte ranges of the same value are issued as a
+  /// single request for multiple ranges.
+  bool multi_range_requests = false;
+
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    return f(x.base_url, x.request_concurrency, x.retries, x.headers);
+    return f(x.base_url, x.request_concurrency, x.retries, x.headers,
+             x.parallel_read_part_size, x.multi_range_requests);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -173,7 +192,16 @@ struct HttpKeyValueStoreSpecData {
           HttpRequestConcurrencyResource::id,
           jb::Projection<&HttpKeyValueStoreSpecData::request_concurrency>()),
       jb::Member(HttpRequestRetries::id,
-                 jb::Projection<&HttpKeyValueStoreSpecData::retries>()));
+                 jb::Projection<&HttpKeyValueStoreSpecData::retries>()),
+      jb::Member("parallel_read_part_size",
+                 jb::Projection<
+                     &HttpKeyValueStoreSpecData::parallel_read_part_size>(
+                     jb::Optional(jb::Integer<int64_t>(1)))),
+      jb::Member(
+          "multi_range_requests",
+          jb::Projection<&HttpKeyValueStoreSpecData::multi_range_requests>(
+              jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                  [](auto* v) { *v = false; }))));
 
   std::string GetUrl(std::string_view path) const {
     auto parsed = internal::ParseGenericUri(base_url);
@@ -228,6 +256,9 @@ class HttpKeyValueStore
   Future<ReadResult> Read(Key key, ReadOptions options) override;
   Future<ReadResult> ReadImpl(Key&& key, ReadOptions&& options);
 
+  /// Issues a HEAD request, which returns the size of the value.
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
   const Executor& executor() const {
     return spec_.request_concurrency->executor;
   }
@@ -244,6 +275,10 @@ class HttpKeyValueStore
   HttpKeyValueStoreSpecData spec_;
 
   std::shared_ptr<HttpTransport> transport_;
+
+  /// Set once the server has responded to a request for multiple byte ranges
+  /// with the entire value, after which such requests are no longer issued.
+  std::atomic<bool> multi_range_unsupported_{false};
 };
 
 Future<kvstore::DriverPtr> HttpKeyValueStoreSpec::DoOpen() const {
@@ -260,6 +295,17 @@ struct ReadTask {
   std::string url;
   kvstore::ReadOptions options;
 
+  // Set for reads issued by `ReadPartTask`, which permit the response to be
+  // truncated at the end of the value.
+  bool read_part = false;
+  ByteRange byte_range;
+  int64_t total_size = -1;
+
+  // Set for reads issued by `MultiRangeBatchReadEntry`, in place of
+  // `options.byte_range`; the response is split into `parts`.
+  std::vector<ByteRange> byte_ranges;
+  std::vector<internal_http::ByteRangePart> parts;
+
   HttpResponse httpresponse;
 
   absl::Status DoRead() {
@@ -268,7 +314,10 @@ struct ReadTask {
     for (const auto& header : owner->spec_.headers) {
       request_builder.AddHeader(header);
     }
-    if (options.byte_range.size() != 0) {
+    if (!byte_ranges.empty()) {
+      request_builder.AddHeader(
+          internal_http::FormatMultipleRangeHeader(byte_ranges));
+    } else if (options.byte_range.size() != 0) {
       request_builder.MaybeAddRangeHeader(options.byte_range);
     }
 
@@ -356,13 +405,19 @@ struct ReadTask {
     }
 
     absl::Cord value;
-    if (options.byte_range.size() != 0) {
-      // Currently unused
-      ByteRange byte_range;
-      int64_t total_size;
-
+    if (!byte_ranges.empty()) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          internal_http::GetResponseByteRangeParts(httpresponse, parts));
+    } else if (read_part) {
+      TENSORSTORE_RETURN_IF_ERROR(internal_http::GetResponseByteRange(
+          httpresponse, value, byte_range, total_size));
+    } else if (options.byte_range.size() != 0) {
       TENSORSTORE_RETURN_IF_ERROR(internal_http::ValidateResponseByteRange(
           httpresponse, options.byte_range, value, byte_range, total_size));
+    } else if (auto content_length =
+                   internal_http::TryGetContentLength(httpresponse.headers)) {
+      // HEAD responses report the size of the value.
+      total_size = kvstore::ListEntry::checked_size(*content_length);
     }
 
     // Parse `ETag` header from response.
@@ -388,16 +443,18 @@ struct ReadTask {
     absl::Time start_time;
     absl::Status status;
     const int max_retries = owner->spec_.retries->max_retries;
+    owner->spec_.retries->RecordRequest();
     int attempt = 0;
     for (; attempt < max_retries; attempt++) {
       start_time = absl::Now();
       status = DoRead();
       if (status.ok() || !IsRetriable(status)) break;
 
-      auto delay = internal::BackoffForAttempt(
-          attempt, owner->spec_.retries->initial_delay,
-          owner->spec_.retries->max_delay,
-          std::min(absl::Seconds(1), owner->spec_.retries->initial_delay));
+      if (!owner->spec_.retries->TryRetry()) {
+        return MaybeAnnotateStatus(std::move(status), "Retry budget exhausted",
+                                   absl::StatusCode::kAborted);
+      }
+      auto delay = *owner->spec_.retries->BackoffForAttempt(attempt);
 
       ABSL_LOG_IF(INFO, http_logging)
           << "The operation failed and will be automatically retried in "
@@ -424,9 +481,178 @@ struct ReadTask {
   }
 };
 
+/// A StatTask is a function object used to satisfy a
+/// HttpKeyValueStore::Stat request.
+struct StatTask {
+  ReadTask task;
+
+  Result<kvstore::StatResult> operator()() {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto result, task());
+    return kvstore::StatResult::FromReadResult(result, task.total_size);
+  }
+};
+
+/// A ReadPartTask is a function object used to read part of a value for
+/// `internal_http::ReadInParts`.
+struct ReadPartTask {
+  ReadTask task;
+
+  Result<internal_http::ReadPartResult> operator()() {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto result, task());
+    return internal_http::ReadPartResult{std::move(result), task.byte_range,
+                                         task.total_size};
+  }
+};
+
+struct MultiRangeReadResult {
+  /// Result without a value, if `state == kValue`.
+  kvstore::ReadResult read_result;
+  std::vector<internal_http::ByteRangePart> parts;
+};
+
+/// A MultiRangeReadTask is a function object used to read multiple byte ranges
+/// of a value with a single request, for `MultiRangeBatchReadEntry`.
+struct MultiRangeReadTask {
+  ReadTask task;
+
+  Result<MultiRangeReadResult> operator()() {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto result, task());
+    if (task.httpresponse.status_code == 200) {
+      // The server ignored the requested ranges.
+      task.owner->multi_range_unsupported_.store(true,
+                                                 std::memory_order_relaxed);
+    }
+    return MultiRangeReadResult{std::move(result), std::move(task.parts)};
+  }
+};
+
+/// Maximum number of byte ranges requested at once, which bounds the size of
+/// the `Range` header.
+constexpr size_t kMaxRangesPerRequest = 32;
+
+using MultiRangeBatchReadEntryBase =
+    internal_kvstore_batch::GenericCoalescingBatchReadEntryBase<
+        HttpKeyValueStore>;
+
+/// Batch read implementation used with `multi_range_requests`.
+///
+/// Requests are coalesced as by `GenericCoalescingBatchReadEntry`, and then
+/// the coalesced byte ranges are read with requests for up to
+/// `kMaxRangesPerRequest` ranges each.
+class MultiRangeBatchReadEntry
+    : public MultiRangeBatchReadEntryBase,
+      public internal::AtomicReferenceCount<MultiRangeBatchReadEntry> {
+ public:
+  MultiRangeBatchReadEntry(BatchEntryKey&& batch_entry_key_)
+      : MultiRangeBatchReadEntryBase(std::move(batch_entry_key_)),
+        // Create an initial reference count that is implicitly transferred to
+        // `Submit`.
+        internal::AtomicReferenceCount<MultiRangeBatchReadEntry>(
+            /*initial_ref_count=*/1) {}
+
+  // Submit is responsible for destroying the entry when done.
+  void Submit(Batch::View batch) final {
+    if (request_batch.requests.empty()) return;
+    driver().executor()([this] { ProcessBatch(); });
+  }
+
+ private:
+  void ProcessBatch() {
+    // Take ownership of the initial reference.  Each request holds a separate
+    // reference.
+    internal::IntrusivePtr<MultiRangeBatchReadEntry> self(
+        this, internal::adopt_object_ref);
+    std::vector<ByteRange> byte_ranges;
+    std::vector<span<Request>> coalesced_requests;
+    internal_kvstore_batch::ForEachCoalescedRequest<Request>(
+        request_batch.requests, driver().GetBatchReadCoalescingOptions(),
+        [&](ByteRange coalesced_byte_range, span<Request> requests) {
+          byte_ranges.push_back(coalesced_byte_range);
+          coalesced_requests.push_back(requests);
+        });
+    for (size_t i = 0; i < byte_ranges.size(); i += kMaxRangesPerRequest) {
+      const size_t end = std::min(byte_ranges.size(), i + kMaxRangesPerRequest);
+      IssueRead(
+          std::vector<ByteRange>(byte_ranges.begin() + i,
+                                 byte_ranges.begin() + end),
+          std::vector<span<Request>>(coalesced_requests.begin() + i,
+                                     coalesced_requests.begin() + end));
+    }
+  }
+
+  void IssueRead(std::vector<ByteRange> byte_ranges,
+                 std::vector<span<Request>> coalesced_requests) {
+    http_batch_read.Increment();
+    auto& driver = this->driver();
+    kvstore::ReadOptions options;
+    options.generation_conditions =
+        std::get<kvstore::ReadGenerationConditions>(batch_entry_key);
+    options.staleness_bound = request_batch.staleness_bound;
+    ReadTask task{IntrusivePtr<HttpKeyValueStore>(&driver),
+                  driver.spec_.GetUrl(std::get<kvstore::Key>(batch_entry_key)),
+                  std::move(options)};
+    task.byte_ranges = byte_ranges;
+    auto future =
+        MapFuture(driver.executor(), MultiRangeReadTask{std::move(task)});
+    future.Force();
+    std::move(future).ExecuteWhenReady(WithExecutor(
+        driver.executor(),
+        [self = internal::IntrusivePtr<MultiRangeBatchReadEntry>(this),
+         byte_ranges = std::move(byte_ranges),
+         coalesced_requests = std::move(coalesced_requests)](
+            ReadyFuture<MultiRangeReadResult> future) {
+          auto& result = future.result();
+          for (size_t i = 0; i < byte_ranges.size(); ++i) {
+            if (!result.ok()) {
+              internal_kvstore_batch::SetCommonResult(coalesced_requests[i],
+                                                      result.status());
+              continue;
+            }
+            Resolve(byte_ranges[i], coalesced_requests[i], *result);
+          }
+        }));
+  }
+
+  static void Resolve(ByteRange byte_range, span<Request> requests,
+                      const MultiRangeReadResult& result) {
+    kvstore::ReadResult read_result = result.read_result;
+    if (read_result.state == kvstore::ReadResult::kValue) {
+      auto it = std::find_if(
+          result.parts.begin(), result.parts.end(), [&](const auto& part) {
+            return part.byte_range.inclusive_min <= byte_range.inclusive_min &&
+                   byte_range.exclusive_max <= part.byte_range.exclusive_max;
+          });
+      if (it == result.parts.end()) {
+        internal_kvstore_batch::SetCommonResult(
+            requests,
+            absl::OutOfRangeError(tensorstore::StrCat(
+                "Requested byte range ", byte_range,
+                " was not satisfied by response")));
+        return;
+      }
+      read_result.value = it->value.Subcord(
+          byte_range.inclusive_min - it->byte_range.inclusive_min,
+          byte_range.size());
+    }
+    internal_kvstore_batch::ResolveCoalescedRequests(byte_range, requests,
+                                                     std::move(read_result));
+  }
+};
+
 Future<kvstore::ReadResult> HttpKeyValueStore::Read(Key key,
                                                     ReadOptions options) {
   http_read.Increment();
+  if (spec_.multi_range_requests && options.batch &&
+      !options.byte_range.IsFull() && options.byte_range.IsRange() &&
+      !multi_range_unsupported_.load(std::memory_order_relaxed)) {
+    auto [promise, future] = PromiseFuturePair<kvstore::ReadResult>::Make();
+    MultiRangeBatchReadEntry::MakeRequest<MultiRangeBatchReadEntry>(
+        *this, std::move(key), std::move(options.generation_conditions),
+        options.batch, options.staleness_bound,
+        MultiRangeBatchReadEntry::Request{
+            {std::move(promise), options.byte_range}});
+    return std::move(future);
+  }
   return internal_kvstore_batch::HandleBatchRequestByGenericByteRangeCoalescing(
       *this, std::move(key), std::move(options));
 }
@@ -435,10 +661,35 @@ Future<kvstore::ReadResult> HttpKeyValueStore::ReadImpl(Key&& key,
                                                         ReadOptions&& options) {
   http_batch_read.Increment();
   std::string url = spec_.GetUrl(key);
+  if (spec_.parallel_read_part_size &&
+      internal_http::ShouldReadInParts(options.byte_range,
+                                       *spec_.parallel_read_part_size)) {
+    return internal_http::ReadInParts(
+        std::move(options), *spec_.parallel_read_part_size,
+        [self = IntrusivePtr<HttpKeyValueStore>(this),
+         url = std::move(url)](kvstore::ReadOptions options) {
+          return MapFuture(self->executor(),
+                           ReadPartTask{ReadTask{self, url, std::move(options),
+                                                 /*read_part=*/true}});
+        });
+  }
   return MapFuture(executor(), ReadTask{IntrusivePtr<HttpKeyValueStore>(this),
                                         std::move(url), std::move(options)});
 }
 
+Future<kvstore::StatResult> HttpKeyValueStore::Stat(Key key,
+                                                    StatOptions options) {
+  http_stat.Increment();
+  ReadOptions read_options;
+  read_options.generation_conditions = std::move(options.generation_conditions);
+  read_options.staleness_bound = options.staleness_bound;
+  read_options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+  return MapFuture(executor(),
+                   StatTask{ReadTask{IntrusivePtr<HttpKeyValueStore>(this),
+                                     spec_.GetUrl(key),
+                                     std::move(read_options)}});
+}
+
 Result<kvstore::Spec> ParseHttpUrl(std::string_view url) {
   auto parsed = internal::ParseGenericUri(url);
   TENSORSTORE_RETURN_IF_ERROR(ValidateParsedHttpUrl(parsed));
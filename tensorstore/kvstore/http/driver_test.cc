@@ -202,6 +202,55 @@ TEST_F(HttpKeyValueStoreTest, ReadBatch) {
       MatchesKvsReadResult(absl::Cord("01234"), StorageGeneration::Invalid()));
 }
 
+TEST_F(HttpKeyValueStoreTest, ReadBatchMultiRange) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "http"},
+                                 {"base_url", "https://example.com/my/path/"},
+                                 {"multi_range_requests", true}})
+                      .result());
+  std::vector<Future<kvstore::ReadResult>> futures;
+  {
+    auto batch = Batch::New();
+    {
+      kvstore::ReadOptions options;
+      options.byte_range.inclusive_min = 10;
+      options.byte_range.exclusive_max = 20;
+      options.batch = batch;
+      futures.push_back(kvstore::Read(store, "abc", options));
+    }
+    {
+      kvstore::ReadOptions options;
+      options.byte_range.inclusive_min = 10000;
+      options.byte_range.exclusive_max = 10005;
+      options.batch = batch;
+      futures.push_back(kvstore::Read(store, "abc", options));
+    }
+  }
+  auto request = mock_transport->requests_.pop();
+  EXPECT_EQ("https://example.com/my/path/abc", request.request.url);
+  EXPECT_THAT(request.request.method, "GET");
+  EXPECT_THAT(request.request.headers,
+              ::testing::UnorderedElementsAre(
+                  "cache-control: no-cache", "Range: bytes=10-19,10000-10004"));
+  request.set_result(HttpResponse{
+      206,
+      absl::Cord("--sep\r\n"
+                 "Content-Range: bytes 10-19/20000\r\n\r\n"
+                 "valueabcde\r\n"
+                 "--sep\r\n"
+                 "Content-Range: bytes 10000-10004/20000\r\n\r\n"
+                 "01234\r\n"
+                 "--sep--\r\n"),
+      {{"content-type", "multipart/byteranges; boundary=sep"},
+       {"etag", "\"xyz\""}}});
+  EXPECT_THAT(futures[0].result(),
+              MatchesKvsReadResult(absl::Cord("valueabcde"),
+                                   StorageGeneration::FromString("xyz")));
+  EXPECT_THAT(futures[1].result(),
+              MatchesKvsReadResult(absl::Cord("01234"),
+                                   StorageGeneration::FromString("xyz")));
+}
+
 TEST_F(HttpKeyValueStoreTest, ReadZeroByteRange) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, kvstore::Open("https://example.com/my/path/").result());
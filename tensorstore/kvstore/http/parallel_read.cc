@@ -0,0 +1,236 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/http/parallel_read.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_http {
+namespace {
+
+struct ReadInPartsState
+    : public internal::AtomicReferenceCount<ReadInPartsState> {
+  kvstore::ReadOptions options;
+  int64_t part_size;
+  ReadPartFunction read_part;
+};
+
+using ReadInPartsStatePtr = internal::IntrusivePtr<ReadInPartsState>;
+
+// Resolves `request` against the value described by `part`.
+Result<ByteRange> ResolveByteRange(const OptionalByteRangeRequest& request,
+                                   const ReadPartResult& part) {
+  if (part.total_size != -1) return request.Validate(part.total_size);
+  if (request.IsRange()) return request.AsByteRange();
+  return ByteRange{request.inclusive_min, part.byte_range.exclusive_max};
+}
+
+// Returns `part.result` restricted to `byte_range`.
+Result<kvstore::ReadResult> ExtractByteRange(ReadPartResult& part,
+                                             ByteRange byte_range) {
+  if (byte_range.inclusive_min < part.byte_range.inclusive_min ||
+      byte_range.exclusive_max > part.byte_range.exclusive_max) {
+    return absl::OutOfRangeError(tensorstore::StrCat(
+        "Requested byte range ", byte_range,
+        " was not satisfied by response with byte range ", part.byte_range,
+        " and total size ", part.total_size));
+  }
+  const int64_t offset = part.byte_range.inclusive_min;
+  part.result.value = internal::GetSubCord(
+      part.result.value, {byte_range.inclusive_min - offset,
+                          byte_range.exclusive_max - offset});
+  return std::move(part.result);
+}
+
+Result<kvstore::ReadResult> GetRequestedByteRange(
+    ReadPartResult& part, const OptionalByteRangeRequest& request) {
+  if (!part.result.has_value()) return std::move(part.result);
+  TENSORSTORE_ASSIGN_OR_RETURN(auto byte_range,
+                               ResolveByteRange(request, part));
+  return ExtractByteRange(part, byte_range);
+}
+
+// Reads the entire requested byte range with a single request.
+void ReadSingle(ReadInPartsStatePtr state,
+                Promise<kvstore::ReadResult> promise) {
+  auto future = state->read_part(state->options);
+  Link(
+      [state = std::move(state)](Promise<kvstore::ReadResult> promise,
+                                 ReadyFuture<ReadPartResult> future) {
+        auto& result = future.result();
+        if (!result.ok()) {
+          promise.SetResult(result.status());
+          return;
+        }
+        promise.SetResult(
+            GetRequestedByteRange(*result, state->options.byte_range));
+      },
+      std::move(promise), std::move(future));
+}
+
+void ReadRemainingParts(ReadInPartsStatePtr state,
+                        Promise<kvstore::ReadResult> promise,
+                        ReadPartResult first, ByteRange byte_range) {
+  const int64_t part_size = state->part_size;
+  std::vector<Future<ReadPartResult>> futures;
+  std::vector<ByteRange> part_ranges;
+  for (int64_t offset = first.byte_range.exclusive_max;
+       offset < byte_range.exclusive_max; offset += part_size) {
+    ByteRange part_range{
+        offset, std::min(byte_range.exclusive_max, offset + part_size)};
+    kvstore::ReadOptions options;
+    options.generation_conditions.if_equal = first.result.stamp.generation;
+    options.staleness_bound = state->options.staleness_bound;
+    options.byte_range = OptionalByteRangeRequest::Range(
+        part_range.inclusive_min, part_range.exclusive_max);
+    futures.push_back(state->read_part(std::move(options)));
+    part_ranges.push_back(part_range);
+  }
+  auto all_ready = WaitAllFuture(tensorstore::span(futures));
+  Link(
+      [state = std::move(state), first = std::move(first),
+       futures = std::move(futures), part_ranges = std::move(part_ranges)](
+          Promise<kvstore::ReadResult> promise,
+          ReadyFuture<void> all_ready) mutable {
+        if (!all_ready.status().ok()) {
+          promise.SetResult(all_ready.status());
+          return;
+        }
+        absl::Cord value = std::move(first.result.value);
+        for (size_t i = 0; i < futures.size(); ++i) {
+          auto& part = futures[i].value();
+          if (!part.result.has_value() ||
+              part.result.stamp.generation != first.result.stamp.generation) {
+            // The value was modified or deleted after the first part was
+            // read.
+            ReadSingle(std::move(state), std::move(promise));
+            return;
+          }
+          auto part_result = ExtractByteRange(part, part_ranges[i]);
+          if (!part_result.ok()) {
+            promise.SetResult(part_result.status());
+            return;
+          }
+          value.Append(std::move(part_result->value));
+        }
+        promise.SetResult(kvstore::ReadResult::Value(
+            std::move(value), std::move(first.result.stamp)));
+      },
+      std::move(promise), std::move(all_ready));
+}
+
+void OnFirstPart(ReadInPartsStatePtr state,
+                 Promise<kvstore::ReadResult> promise,
+                 Result<ReadPartResult>& result) {
+  const auto& request = state->options.byte_range;
+  if (!result.ok()) {
+    if (absl::IsOutOfRange(result.status()) && !request.IsRange()) {
+      // Servers reject a range request that starts at the end of the value,
+      // such as any range request for an empty value, even though the
+      // original request may be satisfiable.
+      ReadSingle(std::move(state), std::move(promise));
+      return;
+    }
+    promise.SetResult(result.status());
+    return;
+  }
+  auto& first = *result;
+  if (!first.result.has_value()) {
+    promise.SetResult(std::move(first.result));
+    return;
+  }
+  if (first.total_size == -1 && !request.IsRange()) {
+    // The extent of the value is unknown.
+    ReadSingle(std::move(state), std::move(promise));
+    return;
+  }
+  auto byte_range = ResolveByteRange(request, first);
+  if (!byte_range.ok()) {
+    promise.SetResult(byte_range.status());
+    return;
+  }
+  if (first.byte_range.inclusive_min <= byte_range->inclusive_min &&
+      first.byte_range.exclusive_max >= byte_range->exclusive_max) {
+    promise.SetResult(ExtractByteRange(first, *byte_range));
+    return;
+  }
+  if (first.byte_range.inclusive_min != byte_range->inclusive_min ||
+      !StorageGeneration::IsCleanValidValue(first.result.stamp.generation)) {
+    // The remaining parts cannot be conditioned on the generation of the
+    // first part.
+    ReadSingle(std::move(state), std::move(promise));
+    return;
+  }
+  ReadRemainingParts(std::move(state), std::move(promise), std::move(first),
+                     *byte_range);
+}
+
+}  // namespace
+
+bool ShouldReadInParts(const OptionalByteRangeRequest& byte_range,
+                       int64_t part_size) {
+  return part_size > 0 && byte_range.inclusive_min >= 0 &&
+         (!byte_range.IsRange() || byte_range.size() > part_size);
+}
+
+Future<kvstore::ReadResult> ReadInParts(kvstore::ReadOptions options,
+                                        int64_t part_size,
+                                        ReadPartFunction read_part) {
+  assert(ShouldReadInParts(options.byte_range, part_size));
+  auto state = internal::MakeIntrusivePtr<ReadInPartsState>();
+  state->options = std::move(options);
+  state->part_size = part_size;
+  state->read_part = std::move(read_part);
+
+  const auto& request = state->options.byte_range;
+  int64_t first_exclusive_max = request.inclusive_min + part_size;
+  if (request.IsRange()) {
+    first_exclusive_max = std::min(first_exclusive_max, request.exclusive_max);
+  }
+  kvstore::ReadOptions first_options = state->options;
+  first_options.byte_range = OptionalByteRangeRequest::Range(
+      request.inclusive_min, first_exclusive_max);
+  auto future = state->read_part(std::move(first_options));
+
+  auto pair = PromiseFuturePair<kvstore::ReadResult>::Make();
+  Link(
+      [state = std::move(state)](Promise<kvstore::ReadResult> promise,
+                                 ReadyFuture<ReadPartResult> future) mutable {
+        OnFirstPart(std::move(state), std::move(promise), future.result());
+      },
+      std::move(pair.promise), std::move(future));
+  return std::move(pair.future);
+}
+
+}  // namespace internal_http
+}  // namespace tensorstore
@@ -0,0 +1,78 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_HTTP_PARALLEL_READ_H_
+#define TENSORSTORE_KVSTORE_HTTP_PARALLEL_READ_H_
+
+#include <stdint.h>
+
+#include <functional>
+
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+/// Result of reading one part of a value.
+struct ReadPartResult {
+  /// Result of the read.  If `result.has_value()`, `result.value` holds the
+  /// bytes `byte_range` of the value.
+  kvstore::ReadResult result;
+
+  /// Byte range contained in `result.value`.  This may be truncated at the end
+  /// of the value, or may cover the entire value if the server ignored the
+  /// requested byte range.
+  ByteRange byte_range;
+
+  /// Total size of the value, or `-1` if unknown.
+  int64_t total_size = -1;
+};
+
+/// Reads a part of a value, as specified by `options.byte_range`.
+///
+/// Unlike a normal read, the requested byte range may extend past the end of
+/// the value.
+using ReadPartFunction =
+    std::function<Future<ReadPartResult>(kvstore::ReadOptions options)>;
+
+/// Returns `true` if `ReadInParts` may split a read of `byte_range` into
+/// multiple requests of at most `part_size` bytes.
+///
+/// Reads of an unknown size, such as full-object reads, are candidates, since
+/// their size is not known until the first part has been read.
+bool ShouldReadInParts(const OptionalByteRangeRequest& byte_range,
+                       int64_t part_size);
+
+/// Reads `options.byte_range` as a sequence of concurrent requests of at most
+/// `part_size` bytes each.
+///
+/// The first part determines the total size and the storage generation of the
+/// value; the remaining parts are then issued concurrently, conditioned on
+/// that generation, and the results are concatenated.  If the value changes
+/// while the parts are being read, or if its generation cannot be used as a
+/// condition, the read falls back to a single request for the entire range.
+///
+/// \pre `ShouldReadInParts(options.byte_range, part_size)`
+Future<kvstore::ReadResult> ReadInParts(kvstore::ReadOptions options,
+                                        int64_t part_size,
+                                        ReadPartFunction read_part);
+
+}  // namespace internal_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_HTTP_PARALLEL_READ_H_
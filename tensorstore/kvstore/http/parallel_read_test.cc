@@ -0,0 +1,237 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/http/parallel_read.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::ByteRange;
+using ::tensorstore::Future;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::OptionalByteRangeRequest;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::TimestampedStorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal_http::ReadInParts;
+using ::tensorstore::internal_http::ReadPartResult;
+using ::tensorstore::internal_http::ShouldReadInParts;
+using ::testing::ElementsAre;
+
+// Simulates ranged reads of a single value from an HTTP server.
+struct FakeServer {
+  std::optional<std::string> value = std::string("0123456789");
+  StorageGeneration generation = StorageGeneration::FromString("g1");
+  bool ignore_ranges = false;
+
+  // Requested byte ranges and `if_equal` conditions.
+  std::vector<OptionalByteRangeRequest> requests;
+  std::vector<StorageGeneration> conditions;
+
+  // Invoked after each request.
+  std::function<void()> on_request;
+
+  Future<ReadPartResult> operator()(kvstore::ReadOptions options) {
+    requests.push_back(options.byte_range);
+    conditions.push_back(options.generation_conditions.if_equal);
+    auto result = Read(options);
+    if (on_request) on_request();
+    return result;
+  }
+
+  tensorstore::Result<ReadPartResult> Read(
+      const kvstore::ReadOptions& options) {
+    ReadPartResult part;
+    const auto now = absl::Now();
+    if (!value) {
+      part.result = kvstore::ReadResult::Missing(now);
+      return part;
+    }
+    if (!StorageGeneration::IsUnknown(options.generation_conditions.if_equal) &&
+        options.generation_conditions.if_equal != generation) {
+      part.result = kvstore::ReadResult::Unspecified(
+          TimestampedStorageGeneration{StorageGeneration::Unknown(), now});
+      return part;
+    }
+    const int64_t size = value->size();
+    part.total_size = size;
+    ByteRange byte_range{0, size};
+    if (!ignore_ranges) {
+      const auto& request = options.byte_range;
+      if (request.inclusive_min >= size && !request.IsFull()) {
+        return absl::OutOfRangeError("416");
+      }
+      byte_range.inclusive_min = request.inclusive_min;
+      if (request.IsRange()) {
+        byte_range.exclusive_max = std::min(size, request.exclusive_max);
+      }
+    }
+    part.byte_range = byte_range;
+    part.result = kvstore::ReadResult::Value(
+        absl::Cord(value->substr(byte_range.inclusive_min, byte_range.size())),
+        TimestampedStorageGeneration{generation, now});
+    return part;
+  }
+};
+
+Future<kvstore::ReadResult> Read(FakeServer& server,
+                                 OptionalByteRangeRequest byte_range,
+                                 int64_t part_size) {
+  kvstore::ReadOptions options;
+  options.byte_range = byte_range;
+  return ReadInParts(std::move(options), part_size,
+                     [&server](kvstore::ReadOptions options) {
+                       return server(std::move(options));
+                     });
+}
+
+TEST(ShouldReadInPartsTest, Basic) {
+  EXPECT_FALSE(ShouldReadInParts(OptionalByteRangeRequest(), 0));
+  EXPECT_TRUE(ShouldReadInParts(OptionalByteRangeRequest(), 4));
+  EXPECT_TRUE(ShouldReadInParts(OptionalByteRangeRequest::Suffix(2), 4));
+  EXPECT_FALSE(ShouldReadInParts(OptionalByteRangeRequest::SuffixLength(8), 4));
+  EXPECT_FALSE(ShouldReadInParts(OptionalByteRangeRequest::Range(2, 6), 4));
+  EXPECT_TRUE(ShouldReadInParts(OptionalByteRangeRequest::Range(2, 7), 4));
+  EXPECT_FALSE(ShouldReadInParts(OptionalByteRangeRequest::Range(0, 0), 4));
+}
+
+TEST(ReadInPartsTest, FullRead) {
+  FakeServer server;
+  EXPECT_THAT(Read(server, {}, 4).result(),
+              MatchesKvsReadResult(absl::Cord("0123456789"), server.generation));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(0, 4),
+                          OptionalByteRangeRequest::Range(4, 8),
+                          OptionalByteRangeRequest::Range(8, 10)));
+  EXPECT_THAT(server.conditions,
+              ElementsAre(StorageGeneration::Unknown(), server.generation,
+                          server.generation));
+}
+
+TEST(ReadInPartsTest, FullReadSinglePart) {
+  FakeServer server;
+  EXPECT_THAT(Read(server, {}, 16).result(),
+              MatchesKvsReadResult(absl::Cord("0123456789"), server.generation));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(0, 16)));
+}
+
+TEST(ReadInPartsTest, Suffix) {
+  FakeServer server;
+  EXPECT_THAT(Read(server, OptionalByteRangeRequest::Suffix(3), 4).result(),
+              MatchesKvsReadResult(absl::Cord("3456789"), server.generation));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(3, 7),
+                          OptionalByteRangeRequest::Range(7, 10)));
+}
+
+TEST(ReadInPartsTest, Range) {
+  FakeServer server;
+  EXPECT_THAT(Read(server, OptionalByteRangeRequest::Range(2, 9), 3).result(),
+              MatchesKvsReadResult(absl::Cord("2345678"), server.generation));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(2, 5),
+                          OptionalByteRangeRequest::Range(5, 8),
+                          OptionalByteRangeRequest::Range(8, 9)));
+}
+
+TEST(ReadInPartsTest, RangeOutOfBounds) {
+  FakeServer server;
+  EXPECT_THAT(Read(server, OptionalByteRangeRequest::Range(2, 20), 4).result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(2, 6)));
+}
+
+TEST(ReadInPartsTest, EmptyValue) {
+  FakeServer server;
+  server.value = "";
+  EXPECT_THAT(Read(server, {}, 4).result(),
+              MatchesKvsReadResult(absl::Cord(), server.generation));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(0, 4),
+                          OptionalByteRangeRequest()));
+}
+
+TEST(ReadInPartsTest, Missing) {
+  FakeServer server;
+  server.value = std::nullopt;
+  EXPECT_THAT(Read(server, {}, 4).result(), MatchesKvsReadResultNotFound());
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(0, 4)));
+}
+
+TEST(ReadInPartsTest, RangeIgnoredByServer) {
+  FakeServer server;
+  server.ignore_ranges = true;
+  EXPECT_THAT(Read(server, OptionalByteRangeRequest::Range(2, 9), 4).result(),
+              MatchesKvsReadResult(absl::Cord("2345678"), server.generation));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(2, 6)));
+}
+
+TEST(ReadInPartsTest, ValueChanged) {
+  FakeServer server;
+  server.on_request = [&] {
+    if (server.requests.size() == 1) {
+      server.value = "abcdefghij";
+      server.generation = StorageGeneration::FromString("g2");
+    }
+  };
+  EXPECT_THAT(Read(server, {}, 4).result(),
+              MatchesKvsReadResult(absl::Cord("abcdefghij"),
+                                   StorageGeneration::FromString("g2")));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(0, 4),
+                          OptionalByteRangeRequest::Range(4, 8),
+                          OptionalByteRangeRequest::Range(8, 10),
+                          OptionalByteRangeRequest()));
+}
+
+TEST(ReadInPartsTest, NoGeneration) {
+  FakeServer server;
+  server.generation = StorageGeneration::Invalid();
+  EXPECT_THAT(Read(server, {}, 4).result(),
+              MatchesKvsReadResult(absl::Cord("0123456789")));
+  EXPECT_THAT(server.requests,
+              ElementsAre(OptionalByteRangeRequest::Range(0, 4),
+                          OptionalByteRangeRequest()));
+}
+
+}  // namespace
@@ -15,11 +15,16 @@
 #ifndef TENSORSTORE_KVSTORE_KVSTACK_RANGE_MAP_H_
 #define TENSORSTORE_KVSTORE_KVSTACK_RANGE_MAP_H_
 
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iterator>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/container/btree_set.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -138,6 +143,51 @@ class KeyRangeMap {
   absl::btree_set<Value, Compare> table_;
 };
 
+// Read-only index of a `KeyRangeMap` for repeated lookups of single keys.
+//
+// The ranges are flattened into a sorted array, and the position of the most
+// recent match is cached, since successive keys typically fall in the same
+// range.  The map must outlive the index, and must not be modified after the
+// index is built.
+template <typename V>
+class KeyRangeMapIndex {
+ public:
+  using Value = typename KeyRangeMap<V>::Value;
+
+  KeyRangeMapIndex() = default;
+  KeyRangeMapIndex(const KeyRangeMapIndex&) = delete;
+  KeyRangeMapIndex& operator=(const KeyRangeMapIndex&) = delete;
+
+  // Rebuilds the index from `map`.  Not thread safe.
+  void Reset(const KeyRangeMap<V>& map) {
+    entries_.clear();
+    for (const auto& v : map) entries_.push_back(&v);
+    last_.store(0, std::memory_order_relaxed);
+  }
+
+  // Returns the entry whose range contains `key`, or `nullptr` if none.
+  const Value* range_containing(std::string_view key) const {
+    size_t i = last_.load(std::memory_order_relaxed);
+    if (i < entries_.size() && Contains(entries_[i]->range, key)) {
+      return entries_[i];
+    }
+    auto it = std::upper_bound(
+        entries_.begin(), entries_.end(), key,
+        [](std::string_view k, const Value* v) {
+          return k < v->range.inclusive_min;
+        });
+    if (it == entries_.begin()) return nullptr;
+    --it;
+    if (!Contains((*it)->range, key)) return nullptr;
+    last_.store(it - entries_.begin(), std::memory_order_relaxed);
+    return *it;
+  }
+
+ private:
+  std::vector<const Value*> entries_;
+  mutable std::atomic<size_t> last_{0};
+};
+
 }  // namespace internal_kvstack
 }  // namespace tensorstore
 
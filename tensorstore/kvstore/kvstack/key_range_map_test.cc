@@ -23,6 +23,7 @@
 
 using ::tensorstore::KeyRange;
 using ::tensorstore::internal_kvstack::KeyRangeMap;
+using ::tensorstore::internal_kvstack::KeyRangeMapIndex;
 
 namespace tensorstore {
 namespace internal_kvstack {
@@ -173,4 +174,27 @@ TEST(RangeMapTest, Sparse) {
   }
 }
 
+TEST(RangeMapTest, Index) {
+  KeyRangeMap<int> m;
+  m.Set(KeyRange("a", "c"), 1);
+  m.Set(KeyRange("c", "e"), 2);
+  m.Set(KeyRange("g", ""), 3);
+
+  KeyRangeMapIndex<int> index;
+  EXPECT_EQ(nullptr, index.range_containing("a"));
+  index.Reset(m);
+
+  EXPECT_EQ(nullptr, index.range_containing(""));
+  EXPECT_EQ(nullptr, index.range_containing("f"));
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_NE(nullptr, index.range_containing("b"));
+    EXPECT_EQ(1, index.range_containing("b")->value);
+    ASSERT_NE(nullptr, index.range_containing("c"));
+    EXPECT_EQ(2, index.range_containing("c")->value);
+    ASSERT_NE(nullptr, index.range_containing("zzz"));
+    EXPECT_EQ(3, index.range_containing("zzz")->value);
+    EXPECT_EQ(nullptr, index.range_containing("e"));
+  }
+}
+
 }  // namespace
@@ -262,17 +262,20 @@ class KvStack
           mapped.kvstore.driver->GetSupportedFeatures(intersect));
       found = true;
     });
-    return found ? static_cast<SupportedFeatures>(merged)
+    // Partial writes are not supported through the stack.
+    return found ? static_cast<SupportedFeatures>(merged) &
+                       ~SupportedFeatures::kByteRangeWrite
                  : SupportedFeatures::kNone;
   }
 
   std::string DescribeKey(std::string_view key) override {
-    auto it = layers_.range_containing(key);
-    if (it == layers_.end()) {
+    auto* layer = layer_index_.range_containing(key);
+    if (!layer) {
       return tensorstore::StrCat("kvstack[unmapped] ", QuoteString(key));
     }
 
-    return it->value.kvstore.driver->DescribeKey(it->value.GetMappedKey(key));
+    return layer->value.kvstore.driver->DescribeKey(
+        layer->value.GetMappedKey(key));
   }
 
   absl::Status ReadModifyWrite(internal::OpenTransactionPtr& transaction,
@@ -295,6 +298,7 @@ class KvStack
       layers_.Set(spec_.layers[i].key_range,
                   MappedValue{f.value(), spec_.layers[i].strip_prefix_length});
     }
+    layer_index_.Reset(layers_);
     SetBatchNestingDepth(batch_nesting_depth + 1);
   }
 
@@ -314,6 +318,9 @@ class KvStack
   };
 
   internal_kvstack::KeyRangeMap<MappedValue> layers_;
+
+  // Index of `layers_` for single-key operations.
+  internal_kvstack::KeyRangeMapIndex<MappedValue> layer_index_;
 };
 
 Future<kvstore::DriverPtr> KvStackSpec::DoOpen() const {
@@ -341,24 +348,27 @@ Future<kvstore::DriverPtr> KvStackSpec::DoOpen() const {
 }
 
 Future<ReadResult> KvStack::Read(Key key, ReadOptions options) {
-  auto it = layers_.range_containing(key);
-  if (it == layers_.end()) {
+  auto* layer = layer_index_.range_containing(key);
+  if (!layer) {
     return ReadResult::Missing(absl::InfiniteFuture());
   }
-  key = key.substr(it->value.strip_prefix_length);
-  return kvstore::Read(it->value.kvstore, std::move(key), std::move(options));
+  // `options.batch` is forwarded, so that reads from the same layer are
+  // coalesced by the layer driver when the batch is submitted.
+  key = key.substr(layer->value.strip_prefix_length);
+  return kvstore::Read(layer->value.kvstore, std::move(key),
+                       std::move(options));
 }
 
 Future<TimestampedStorageGeneration> KvStack::Write(Key key,
                                                     std::optional<Value> value,
                                                     WriteOptions options) {
-  auto it = layers_.range_containing(key);
-  if (it == layers_.end()) {
+  auto* layer = layer_index_.range_containing(key);
+  if (!layer) {
     return absl::InvalidArgumentError(
         tensorstore::StrCat("Key not found in any layers: ", QuoteString(key)));
   }
-  key = key.substr(it->value.strip_prefix_length);
-  return kvstore::Write(it->value.kvstore, std::move(key), std::move(value),
+  key = key.substr(layer->value.strip_prefix_length);
+  return kvstore::Write(layer->value.kvstore, std::move(key), std::move(value),
                         std::move(options));
 }
 
@@ -375,13 +385,13 @@ Future<const void> KvStack::DeleteRange(KeyRange range) {
 absl::Status KvStack::ReadModifyWrite(internal::OpenTransactionPtr& transaction,
                                       size_t& phase, Key key,
                                       ReadModifyWriteSource& source) {
-  auto it = layers_.range_containing(key);
-  if (it == layers_.end()) {
+  auto* layer = layer_index_.range_containing(key);
+  if (!layer) {
     return absl::InvalidArgumentError(
         tensorstore::StrCat("Key not found in any layers: ", QuoteString(key)));
   }
-  return it->value.kvstore.driver->ReadModifyWrite(
-      transaction, phase, it->value.GetMappedKey(key), source);
+  return layer->value.kvstore.driver->ReadModifyWrite(
+      transaction, phase, layer->value.GetMappedKey(key), source);
 }
 
 absl::Status KvStack::TransactionalDeleteRange(
@@ -41,10 +41,12 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/source_location.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_ahead_scan.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
 #include "tensorstore/kvstore/spec.h"
@@ -354,6 +356,39 @@ Future<const void> Driver::DeleteRange(KeyRange range) {
       "KeyValueStore does not support deleting by range");
 }
 
+void Driver::ReadStreamImpl(Key key, ReadOptions options,
+                            ReadStreamReceiver receiver) {
+  execution::submit(FlowSingleSender{Read(std::move(key), std::move(options))},
+                    std::move(receiver));
+}
+
+ReadStreamSender Driver::ReadStream(Key key, ReadOptions options) {
+  struct ReadStreamSender {
+    IntrusivePtr<Driver> self;
+    Key key;
+    ReadOptions options;
+    void submit(ReadStreamReceiver receiver) {
+      self->ReadStreamImpl(key, options, std::move(receiver));
+    }
+  };
+  return ReadStreamSender{IntrusivePtr<Driver>(this), std::move(key),
+                          std::move(options)};
+}
+
+Future<StatResult> Driver::Stat(Key key, StatOptions options) {
+  ReadOptions read_options;
+  read_options.generation_conditions = std::move(options.generation_conditions);
+  read_options.staleness_bound = options.staleness_bound;
+  read_options.batch = std::move(options.batch);
+  read_options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+  return MapFutureValue(
+      InlineExecutor{},
+      [](const ReadResult& read_result) {
+        return StatResult::FromReadResult(read_result);
+      },
+      Read(std::move(key), std::move(read_options)));
+}
+
 void Driver::ListImpl(ListOptions options, ListReceiver receiver) {
   execution::submit(FlowSingleSender{ErrorSender{absl::UnimplementedError(
                         "KeyValueStore does not support listing")}},
@@ -371,10 +406,29 @@ ListSender Driver::List(ListOptions options) {
   return ListSender{IntrusivePtr<Driver>(this), std::move(options)};
 }
 
+void Driver::ScanImpl(ScanOptions options, ScanReceiver receiver) {
+  internal_kvstore::ReadAheadScan(DriverPtr(this), std::move(options),
+                                  std::move(receiver),
+                                  /*ordered_list=*/false);
+}
+
+ScanSender Driver::Scan(ScanOptions options) {
+  struct ScanSender {
+    IntrusivePtr<Driver> self;
+    ScanOptions options;
+    void submit(ScanReceiver receiver) {
+      self->ScanImpl(options, std::move(receiver));
+    }
+  };
+  return ScanSender{IntrusivePtr<Driver>(this), std::move(options)};
+}
+
 std::string Driver::DescribeKey(std::string_view key) {
   return tensorstore::QuoteString(key);
 }
 
+std::string_view Driver::driver_id() const { return "unknown"; }
+
 absl::Status Driver::AnnotateError(std::string_view key,
                                    std::string_view action,
                                    const absl::Status& error,
@@ -18,8 +18,10 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -28,6 +30,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/btree_map.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
@@ -39,7 +42,6 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
-#include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
@@ -68,6 +70,7 @@ using ::tensorstore::internal_kvstore::DeleteRangeEntry;
 using ::tensorstore::internal_kvstore::kReadModifyWrite;
 using ::tensorstore::kvstore::ListEntry;
 using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::ScanEntry;
 using ::tensorstore::kvstore::SupportedFeatures;
 
 TimestampedStorageGeneration GenerationNow(StorageGeneration generation) {
@@ -94,26 +97,88 @@ struct StoredKeyValuePairs
   };
 
   using Map = absl::btree_map<std::string, ValueWithGenerationNumber>;
-  std::pair<Map::iterator, Map::iterator> Find(const std::string& inclusive_min,
-                                               const std::string& exclusive_max)
-      ABSL_SHARED_LOCKS_REQUIRED(mutex) {
-    return {values.lower_bound(inclusive_min),
-            exclusive_max.empty() ? values.end()
-                                  : values.lower_bound(exclusive_max)};
-  }
-
-  std::pair<Map::iterator, Map::iterator> Find(const KeyRange& range)
-      ABSL_SHARED_LOCKS_REQUIRED(mutex) {
-    return Find(range.inclusive_min, range.exclusive_max);
-  }
-
-  absl::Mutex mutex;
-  /// Next generation number to use when updating the value associated with a
-  /// key.  Using a single per-store counter rather than a per-key counter
-  /// ensures that creating a key, deleting it, then creating it again does
-  /// not result in the same generation number being reused for a given key.
-  uint64_t next_generation_number ABSL_GUARDED_BY(mutex) = 0;
-  Map values ABSL_GUARDED_BY(mutex);
+
+  template <typename MapType>
+  static auto Find(MapType& values, const std::string& inclusive_min,
+                   const std::string& exclusive_max) {
+    return std::pair(values.lower_bound(inclusive_min),
+                     exclusive_max.empty() ? values.end()
+                                           : values.lower_bound(exclusive_max));
+  }
+
+  /// Keys are partitioned among shards by hash, such that single-key
+  /// operations on keys in different shards do not contend.  Multi-key
+  /// operations lock all shards, in order.
+  static constexpr size_t kNumShards = 16;
+
+  struct Shard {
+    absl::Mutex mutex;
+
+    /// Copy-on-write map of the keys in this shard, which may be shared with
+    /// any number of `Snapshot` objects.
+    std::shared_ptr<Map> values ABSL_GUARDED_BY(mutex) =
+        std::make_shared<Map>();
+
+    /// Returns the map for modification, first copying it if it is shared
+    /// with a snapshot.
+    ///
+    /// A snapshot can only be taken while holding a lock on `mutex`, so the use
+    /// count can only overestimate the number of snapshots here.
+    Map& MutableValues() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+      if (values.use_count() > 1) values = std::make_shared<Map>(*values);
+      return *values;
+    }
+
+    void EraseRange(const std::string& inclusive_min,
+                    const std::string& exclusive_max)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+      auto it_range = Find(std::as_const(*values), inclusive_min,
+                           exclusive_max);
+      if (it_range.first == it_range.second) return;
+      auto& mutable_values = MutableValues();
+      it_range = Find(mutable_values, inclusive_min, exclusive_max);
+      mutable_values.erase(it_range.first, it_range.second);
+    }
+  };
+
+  /// Consistent view of the maps of all shards, which is not affected by
+  /// subsequent modifications.
+  using Snapshot = std::array<std::shared_ptr<const Map>, kNumShards>;
+
+  Shard& GetShard(std::string_view key) {
+    return shards[absl::HashOf(key) % kNumShards];
+  }
+
+  /// Returns a snapshot, which requires only briefly holding a reader lock on
+  /// each shard.
+  Snapshot GetSnapshot() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    Snapshot snapshot;
+    for (auto& shard : shards) shard.mutex.ReaderLock();
+    for (size_t i = 0; i < kNumShards; ++i) snapshot[i] = shards[i].values;
+    for (auto& shard : shards) shard.mutex.ReaderUnlock();
+    return snapshot;
+  }
+
+  /// Acquires a writer lock on all shards, in order.
+  void LockAll() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    for (auto& shard : shards) shard.mutex.Lock();
+  }
+
+  void UnlockAll() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    for (auto& shard : shards) shard.mutex.Unlock();
+  }
+
+  /// Returns the next generation number to use when updating the value
+  /// associated with a key.  Using a single per-store counter rather than a
+  /// per-key counter ensures that creating a key, deleting it, then creating
+  /// it again does not result in the same generation number being reused for
+  /// a given key.
+  uint64_t NextGenerationNumber() {
+    return next_generation_number.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> next_generation_number{0};
+  std::array<Shard, kNumShards> shards;
 };
 
 /// Defines the context resource (see `tensorstore/context.h`) that actually
@@ -184,6 +249,8 @@ class MemoryDriver
  public:
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
                                              WriteOptions options) override;
@@ -192,6 +259,8 @@ class MemoryDriver
 
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
+  void ScanImpl(ScanOptions options, ScanReceiver receiver) override;
+
   absl::Status ReadModifyWrite(internal::OpenTransactionPtr& transaction,
                                size_t& phase, Key key,
                                ReadModifyWriteSource& source) override;
@@ -221,7 +290,8 @@ class MemoryDriver
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
     return SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
-           SupportedFeatures::kAtomicWriteWithoutOverwrite;
+           SupportedFeatures::kAtomicWriteWithoutOverwrite |
+           SupportedFeatures::kByteRangeWrite;
   }
 
   /// In simple cases, such as the "memory" driver, the `Driver` can simply
@@ -247,8 +317,8 @@ class MemoryDriver::TransactionNode
 
   /// Commits a (possibly multi-key) transaction atomically.
   ///
-  /// The commit involves two steps, both while holding a lock on the entire
-  /// KeyValueStore:
+  /// The commit involves two steps, both while holding a lock on all shards of
+  /// the KeyValueStore:
   ///
   /// 1. Without making any modifications, validates that the underlying
   ///    KeyValueStore data matches the generation constraints specified in the
@@ -262,16 +332,15 @@ class MemoryDriver::TransactionNode
       ABSL_NO_THREAD_SAFETY_ANALYSIS {
     if (!single_phase_mutation.remaining_entries_.HasError()) {
       auto& data = static_cast<MemoryDriver&>(*this->driver()).data();
-      TimestampedStorageGeneration generation;
-      UniqueWriterLock lock(data.mutex);
+      data.LockAll();
       absl::Time commit_time = absl::Now();
       if (!ValidateEntryConditions(data, single_phase_mutation, commit_time)) {
-        lock.unlock();
+        data.UnlockAll();
         this->RetryAtomicWriteback(commit_time);
         return;
       }
       ApplyMutation(data, single_phase_mutation, commit_time);
-      lock.unlock();
+      data.UnlockAll();
       this->AtomicCommitWritebackSuccess();
     } else {
       internal_kvstore::WritebackError(single_phase_mutation);
@@ -281,10 +350,12 @@ class MemoryDriver::TransactionNode
 
   /// Validates that the underlying `data` matches the generation constraints
   /// specified in the transaction.  No changes are made to the `data`.
+  ///
+  /// All shards of `data` must be locked.
   static bool ValidateEntryConditions(
       StoredKeyValuePairs& data,
       internal_kvstore::SinglePhaseMutation& single_phase_mutation,
-      const absl::Time& commit_time) ABSL_SHARED_LOCKS_REQUIRED(data.mutex) {
+      const absl::Time& commit_time) {
     bool validated = true;
     for (auto& entry : single_phase_mutation.entries_) {
       if (!ValidateEntryConditions(data, entry, commit_time)) {
@@ -296,8 +367,7 @@ class MemoryDriver::TransactionNode
 
   static bool ValidateEntryConditions(StoredKeyValuePairs& data,
                                       internal_kvstore::MutationEntry& entry,
-                                      const absl::Time& commit_time)
-      ABSL_SHARED_LOCKS_REQUIRED(data.mutex) {
+                                      const absl::Time& commit_time) {
     if (entry.entry_type() == kReadModifyWrite) {
       return ValidateEntryConditions(
           data, static_cast<BufferedReadModifyWriteEntry&>(entry), commit_time);
@@ -319,15 +389,16 @@ class MemoryDriver::TransactionNode
   static bool ValidateEntryConditions(StoredKeyValuePairs& data,
                                       BufferedReadModifyWriteEntry& entry,
                                       const absl::Time& commit_time)
-      ABSL_SHARED_LOCKS_REQUIRED(data.mutex) {
+      ABSL_NO_THREAD_SAFETY_ANALYSIS {
     auto& stamp = entry.stamp();
     auto if_equal = StorageGeneration::Clean(stamp.generation);
     if (StorageGeneration::IsUnknown(if_equal)) {
       assert(stamp.time == absl::InfiniteFuture());
       return true;
     }
-    auto it = data.values.find(entry.key_);
-    if (it == data.values.end()) {
+    const auto& values = *data.GetShard(entry.key_).values;
+    auto it = values.find(entry.key_);
+    if (it == values.end()) {
       if (StorageGeneration::IsNoValue(if_equal)) {
         stamp.time = commit_time;
         return true;
@@ -342,11 +413,11 @@ class MemoryDriver::TransactionNode
   /// Applies the changes in the transaction to the stored `data`.
   ///
   /// It is assumed that the constraints have already been validated by
-  /// `ValidateConditions`.
+  /// `ValidateConditions`.  All shards of `data` must be locked.
   static void ApplyMutation(
       StoredKeyValuePairs& data,
       internal_kvstore::SinglePhaseMutation& single_phase_mutation,
-      const absl::Time& commit_time) ABSL_EXCLUSIVE_LOCKS_REQUIRED(data.mutex) {
+      const absl::Time& commit_time) ABSL_NO_THREAD_SAFETY_ANALYSIS {
     for (auto& entry : single_phase_mutation.entries_) {
       if (entry.entry_type() == kReadModifyWrite) {
         auto& rmw_entry = static_cast<BufferedReadModifyWriteEntry&>(entry);
@@ -356,28 +427,33 @@ class MemoryDriver::TransactionNode
         if (!StorageGeneration::IsDirty(stamp.generation)) {
           // Do nothing
         } else if (value_state == ReadResult::kMissing) {
-          data.values.erase(rmw_entry.key_);
+          auto& shard = data.GetShard(rmw_entry.key_);
+          if (shard.values->count(rmw_entry.key_)) {
+            shard.MutableValues().erase(rmw_entry.key_);
+          }
           stamp.generation = StorageGeneration::NoValue();
         } else {
           assert(value_state == ReadResult::kValue);
-          auto& v = data.values[rmw_entry.key_];
-          v.generation_number = data.next_generation_number++;
+          auto& v = data.GetShard(rmw_entry.key_)
+                        .MutableValues()[rmw_entry.key_];
+          v.generation_number = data.NextGenerationNumber();
           v.value = std::move(rmw_entry.value_);
           stamp.generation = v.generation();
         }
       } else {
         auto& dr_entry = static_cast<DeleteRangeEntry&>(entry);
-        auto it_range = data.Find(dr_entry.key_, dr_entry.exclusive_max_);
-        data.values.erase(it_range.first, it_range.second);
+        for (auto& shard : data.shards) {
+          shard.EraseRange(dr_entry.key_, dr_entry.exclusive_max_);
+        }
       }
     }
   }
 };
 
 Future<ReadResult> MemoryDriver::Read(Key key, ReadOptions options) {
-  auto& data = this->data();
-  absl::ReaderMutexLock lock(&data.mutex);
-  auto& values = data.values;
+  auto& shard = data().GetShard(key);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  const auto& values = *shard.values;
   auto it = values.find(key);
   if (it == values.end()) {
     // Key not found.
@@ -394,15 +470,33 @@ Future<ReadResult> MemoryDriver::Read(Key key, ReadOptions options) {
                            std::move(stamp));
 }
 
+Future<StatResult> MemoryDriver::Stat(Key key, StatOptions options) {
+  auto& shard = data().GetShard(key);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  const auto& values = *shard.values;
+  auto it = values.find(key);
+  if (it == values.end()) {
+    return StatResult{StatResult::State::kMissing, -1,
+                      GenerationNow(StorageGeneration::NoValue())};
+  }
+  auto stamp = GenerationNow(it->second.generation());
+  if (!options.generation_conditions.Matches(it->second.generation())) {
+    return StatResult{StatResult::State::kUnspecified, -1, std::move(stamp)};
+  }
+  return StatResult{StatResult::State::kValue,
+                    static_cast<int64_t>(it->second.value.size()),
+                    std::move(stamp)};
+}
+
 Future<TimestampedStorageGeneration> MemoryDriver::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   using ValueWithGenerationNumber =
       StoredKeyValuePairs::ValueWithGenerationNumber;
   auto& data = this->data();
-  absl::WriterMutexLock lock(&data.mutex);
-  auto& values = data.values;
-  auto it = values.find(key);
-  if (it == values.end()) {
+  auto& shard = data.GetShard(key);
+  absl::WriterMutexLock lock(&shard.mutex);
+  auto it = shard.values->find(key);
+  if (it == shard.values->end()) {
     // Key does not already exist.
     if (!options.generation_conditions.MatchesNoValue()) {
       // Write is conditioned on there being an existing key with a
@@ -413,39 +507,57 @@ Future<TimestampedStorageGeneration> MemoryDriver::Write(
       // Delete was requested, but key already doesn't exist.
       return GenerationNow(StorageGeneration::NoValue());
     }
-    // Insert the value it into the hash table with the next unused
-    // generation number.
-    it = values
-             .emplace(std::move(key),
-                      ValueWithGenerationNumber{std::move(*value),
-                                                data.next_generation_number++})
-             .first;
-    return GenerationNow(it->second.generation());
-  }
-  // Key already exists.
-  if (!options.generation_conditions.Matches(it->second.generation())) {
+  } else if (!options.generation_conditions.Matches(it->second.generation())) {
     // Write is conditioned on an existing generation of `if_equal`,
     // which does not match the current generation.  Abort.
     return GenerationNow(StorageGeneration::Unknown());
   }
+  if (options.byte_offset) {
+    // Splice the new value into the existing value.
+    if (it == shard.values->end()) {
+      return absl::NotFoundError("Cannot write byte range of missing key");
+    }
+    const absl::Cord& existing = it->second.value;
+    const int64_t offset = *options.byte_offset;
+    if (!value || offset < 0 ||
+        offset + static_cast<int64_t>(value->size()) >
+            static_cast<int64_t>(existing.size())) {
+      return absl::OutOfRangeError(tensorstore::StrCat(
+          "Cannot write ", value ? value->size() : 0, " bytes at offset ",
+          offset, " of value of size ", existing.size()));
+    }
+    absl::Cord spliced = existing.Subcord(0, offset);
+    spliced.Append(*value);
+    spliced.Append(existing.Subcord(offset + value->size(),
+                                    existing.size() - offset - value->size()));
+    *value = std::move(spliced);
+  }
+  // The map may be copied if it is shared with a snapshot, which invalidates
+  // `it`.
+  auto& values = shard.MutableValues();
   if (!value) {
     // Delete request.
-    values.erase(it);
+    values.erase(key);
     return GenerationNow(StorageGeneration::NoValue());
   }
-  // Set the generation number to the next unused generation number.
-  it->second.generation_number = data.next_generation_number++;
-  // Update the value.
-  it->second.value = std::move(*value);
+  // Insert or update the value with the next unused generation number.
+  it = values
+           .insert_or_assign(
+               std::move(key),
+               ValueWithGenerationNumber{std::move(*value),
+                                         data.NextGenerationNumber()})
+           .first;
   return GenerationNow(it->second.generation());
 }
 
 Future<const void> MemoryDriver::DeleteRange(KeyRange range) {
   auto& data = this->data();
-  absl::WriterMutexLock lock(&data.mutex);
   if (!range.empty()) {
-    auto it_range = data.Find(range);
-    data.values.erase(it_range.first, it_range.second);
+    data.LockAll();
+    for (auto& shard : data.shards) {
+      shard.EraseRange(range.inclusive_min, range.exclusive_max);
+    }
+    data.UnlockAll();
   }
   return absl::OkStatus();  // Converted to a ReadyFuture.
 }
@@ -457,21 +569,28 @@ void MemoryDriver::ListImpl(ListOptions options, ListReceiver receiver) {
     cancelled.store(true, std::memory_order_relaxed);
   });
 
-  // Collect the keys.
-  std::vector<ListEntry> entries;
-  {
-    absl::ReaderMutexLock lock(&data.mutex);
-    auto it_range = data.Find(options.range);
+  // Collect the keys from a snapshot, which does not block writers.
+  std::vector<std::pair<std::string_view, int64_t>> keys;
+  auto snapshot = data.GetSnapshot();
+  for (const auto& values : snapshot) {
+    auto it_range = StoredKeyValuePairs::Find(
+        *values, options.range.inclusive_min, options.range.exclusive_max);
     for (auto it = it_range.first; it != it_range.second; ++it) {
-      if (cancelled.load(std::memory_order_relaxed)) break;
-      std::string_view key = it->first;
-      entries.push_back(ListEntry{
-          std::string(
-              key.substr(std::min(options.strip_prefix_length, key.size()))),
-          ListEntry::checked_size(it->second.value.size()),
-      });
+      keys.emplace_back(it->first,
+                        ListEntry::checked_size(it->second.value.size()));
     }
   }
+  std::sort(keys.begin(), keys.end());
+  std::vector<ListEntry> entries;
+  entries.reserve(keys.size());
+  for (const auto& [key, size] : keys) {
+    if (cancelled.load(std::memory_order_relaxed)) break;
+    entries.push_back(ListEntry{
+        std::string(
+            key.substr(std::min(options.strip_prefix_length, key.size()))),
+        size,
+    });
+  }
 
   // Send the keys.
   for (auto& entry : entries) {
@@ -482,6 +601,43 @@ void MemoryDriver::ListImpl(ListOptions options, ListReceiver receiver) {
   execution::set_stopping(receiver);
 }
 
+void MemoryDriver::ScanImpl(ScanOptions options, ScanReceiver receiver) {
+  using ValueWithGenerationNumber =
+      StoredKeyValuePairs::ValueWithGenerationNumber;
+  auto& data = this->data();
+  std::atomic<bool> cancelled{false};
+  execution::set_starting(receiver, [&cancelled] {
+    cancelled.store(true, std::memory_order_relaxed);
+  });
+
+  // The values are delivered directly from a snapshot, which remains valid
+  // while the entries are sent.
+  std::vector<std::pair<std::string_view, const ValueWithGenerationNumber*>>
+      entries;
+  auto snapshot = data.GetSnapshot();
+  const absl::Time time = absl::Now();
+  for (const auto& values : snapshot) {
+    auto it_range = StoredKeyValuePairs::Find(
+        *values, options.range.inclusive_min, options.range.exclusive_max);
+    for (auto it = it_range.first; it != it_range.second; ++it) {
+      entries.emplace_back(it->first, &it->second);
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (const auto& [key, value] : entries) {
+    if (cancelled.load(std::memory_order_relaxed)) break;
+    execution::set_value(
+        receiver,
+        ScanEntry{std::string(key.substr(
+                      std::min(options.strip_prefix_length, key.size()))),
+                  value->value,
+                  TimestampedStorageGeneration{value->generation(), time}});
+  }
+  execution::set_done(receiver);
+  execution::set_stopping(receiver);
+}
+
 absl::Status MemoryDriver::ReadModifyWrite(
     internal::OpenTransactionPtr& transaction, size_t& phase, Key key,
     ReadModifyWriteSource& source) {
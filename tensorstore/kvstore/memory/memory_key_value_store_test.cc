@@ -14,23 +14,35 @@
 
 #include "tensorstore/kvstore/memory/memory_key_value_store.h"
 
+#include <stdint.h>
+
+#include <algorithm>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/internal/metrics/registry.h"
 #include "tensorstore/json_serialization_options_base.h"
+#include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
 #include "tensorstore/serialization/test_util.h"
+#include "tensorstore/util/execution/future_collecting_receiver.h"
+#include "tensorstore/util/execution/sync_flow_sender.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/status_testutil.h"
 
@@ -43,6 +55,7 @@ using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal::MatchesScanEntry;
 using ::tensorstore::serialization::SerializationRoundTrip;
 
 TEST(MemoryKeyValueStoreTest, Basic) {
@@ -82,6 +95,103 @@ TEST(MemoryKeyValueStoreTest, List) {
   tensorstore::internal::TestKeyValueStoreList(store);
 }
 
+TEST(MemoryKeyValueStoreTest, ByteRangeWrite) {
+  KvStore store(tensorstore::GetMemoryKeyValueStore());
+  kvstore::WriteOptions options;
+  options.byte_offset = 2;
+  EXPECT_THAT(kvstore::Write(store, "a", absl::Cord("xy"), options).result(),
+              MatchesStatus(absl::StatusCode::kNotFound));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("abcdef")));
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, "a", absl::Cord("xy"), options).result());
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("abxyef")));
+  options.byte_offset = 5;
+  EXPECT_THAT(kvstore::Write(store, "a", absl::Cord("xy"), options).result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(kvstore::Write(store, "a", std::nullopt, options).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(MemoryKeyValueStoreTest, ConcurrentWriteAndList) {
+  auto store = tensorstore::GetMemoryKeyValueStore();
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeys = 100;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < kNumKeys; ++j) {
+        TENSORSTORE_CHECK_OK(
+            store->Write(absl::StrFormat("%d/%03d", i, j), absl::Cord("x"))
+                .result());
+      }
+    });
+  }
+  // Listing concurrently with writes observes a subset of the keys, in order.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto partial,
+                                   kvstore::ListFuture(store.get()).result());
+  EXPECT_TRUE(std::is_sorted(partial.begin(), partial.end(),
+                             [](const auto& a, const auto& b) {
+                               return a.key < b.key;
+                             }));
+  for (auto& thread : threads) thread.join();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto entries,
+                                   kvstore::ListFuture(store.get()).result());
+  ASSERT_EQ(kNumThreads * kNumKeys, entries.size());
+  EXPECT_EQ("0/000", entries.front().key);
+  EXPECT_EQ("3/099", entries.back().key);
+}
+
+TEST(MemoryKeyValueStoreTest, ReadStream) {
+  auto store = tensorstore::GetMemoryKeyValueStore();
+  TENSORSTORE_ASSERT_OK(store->Write("a", absl::Cord("abc")));
+
+  // The default implementation delivers the value as a single fragment.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto fragments,
+      tensorstore::CollectFlowSenderIntoFuture<
+          std::vector<kvstore::ReadResult>>(
+          tensorstore::MakeSyncFlowSender(store->ReadStream("a")))
+          .result());
+  ASSERT_EQ(1, fragments.size());
+  EXPECT_TRUE(fragments[0].has_value());
+  EXPECT_EQ("abc", fragments[0].value);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      fragments, tensorstore::CollectFlowSenderIntoFuture<
+                     std::vector<kvstore::ReadResult>>(
+                     tensorstore::MakeSyncFlowSender(store->ReadStream("b")))
+                     .result());
+  ASSERT_EQ(1, fragments.size());
+  EXPECT_EQ(kvstore::ReadResult::kMissing, fragments[0].state);
+}
+
+TEST(MemoryKeyValueStoreTest, Scan) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "memory"}, {"path", "p/"}}).result());
+  for (const char* key : {"c", "a", "b/1", "d"}) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, key, absl::Cord(key)));
+  }
+  // Keys outside of the path are not included.
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(KvStore(store.driver), "q", absl::Cord("q")));
+
+  EXPECT_THAT(kvstore::ScanFuture(store).result(),
+              ::testing::Optional(::testing::ElementsAre(
+                  MatchesScanEntry("a", absl::Cord("a")),
+                  MatchesScanEntry("b/1", absl::Cord("b/1")),
+                  MatchesScanEntry("c", absl::Cord("c")),
+                  MatchesScanEntry("d", absl::Cord("d")))));
+
+  kvstore::ScanOptions options;
+  options.range = tensorstore::KeyRange("b", "d");
+  EXPECT_THAT(kvstore::ScanFuture(store, options).result(),
+              ::testing::Optional(::testing::ElementsAre(
+                  MatchesScanEntry("b/1"), MatchesScanEntry("c"))));
+}
+
 TEST(MemoryKeyValueStoreTest, Open) {
   auto context = Context::Default();
 
@@ -315,4 +425,37 @@ TEST(MemoryKeyValueStoreTest, InvalidUri) {
                             ".*: Fragment identifier not supported"));
 }
 
+// Returns the number of observations of the histogram `metric_name` for the
+// memory driver and `operation`.
+int64_t GetOperationCount(std::string_view metric_name,
+                          std::string_view operation) {
+  auto metric =
+      tensorstore::internal_metrics::GetMetricRegistry().Collect(metric_name);
+  if (!metric) return 0;
+  for (const auto& h : metric->histograms) {
+    if (h.fields.size() == 2 && h.fields[0] == "memory" &&
+        h.fields[1] == operation) {
+      return h.count;
+    }
+  }
+  return 0;
+}
+
+TEST(MemoryKeyValueStoreTest, OperationMetrics) {
+#ifdef TENSORSTORE_METRICS_DISABLED
+  GTEST_SKIP() << "metrics disabled";
+#endif
+  KvStore store(tensorstore::GetMemoryKeyValueStore());
+  const int64_t reads = GetOperationCount("/tensorstore/kvstore/latency_ms",
+                                          "read");
+  const int64_t writes = GetOperationCount("/tensorstore/kvstore/bytes",
+                                           "write");
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("xyz")).result());
+  TENSORSTORE_ASSERT_OK(kvstore::Read(store, "a").result());
+  EXPECT_EQ(reads + 1,
+            GetOperationCount("/tensorstore/kvstore/latency_ms", "read"));
+  EXPECT_EQ(writes + 1,
+            GetOperationCount("/tensorstore/kvstore/bytes", "write"));
+}
+
 }  // namespace
@@ -185,6 +185,9 @@ Future<TimestampedStorageGeneration> MockKeyValueStore::Write(
       log_entry.emplace("if_equal",
                         options.generation_conditions.if_equal.value);
     }
+    if (options.byte_offset) {
+      log_entry.emplace("byte_offset", *options.byte_offset);
+    }
     request_log.push(std::move(log_entry));
   }
   if (forward_to) {
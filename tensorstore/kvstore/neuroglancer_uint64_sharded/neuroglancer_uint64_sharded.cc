@@ -18,6 +18,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <limits>
@@ -150,7 +151,8 @@ using MinishardIndex = uint64_t;
 
 // Reading a minishard index proceeds as follows:
 //
-// 1. Request the shard index.
+// 1. Request the shard index entry.  The entries of adjacent minishards
+//    requested in the same batch are retrieved with a single read.
 //
 //    a. If not found, the minishard is empty.  Done.
 //
@@ -208,8 +210,27 @@ class MinishardIndexReadOperationState
 
     auto minishard_fetch_batch = Batch::New();
 
-    for (auto& request : request_batch.requests) {
-      ProcessMinishard(batch, request, minishard_fetch_batch);
+    // Group the requests into runs of adjacent minishards, such that the shard
+    // index entries of each run are retrieved with a single read.
+    auto& requests = request_batch.requests;
+    std::sort(requests.begin(), requests.end(),
+              [](const Request& a, const Request& b) {
+                return std::get<MinishardIndex>(a) <
+                       std::get<MinishardIndex>(b);
+              });
+    for (size_t run_start_i = 0; run_start_i < requests.size();) {
+      size_t run_end_i = run_start_i + 1;
+      while (run_end_i < requests.size() &&
+             std::get<MinishardIndex>(requests[run_end_i]) -
+                     std::get<MinishardIndex>(requests[run_end_i - 1]) <=
+                 1) {
+        ++run_end_i;
+      }
+      ProcessMinishardRun(
+          batch,
+          span<Request>(requests).subspan(run_start_i, run_end_i - run_start_i),
+          minishard_fetch_batch);
+      run_start_i = run_end_i;
     }
   }
 
@@ -219,30 +240,45 @@ class MinishardIndexReadOperationState
                        std::get<ShardIndex>(batch_entry_key));
   }
 
-  void ProcessMinishard(Batch::View batch, Request& request,
-                        Batch minishard_fetch_batch) {
+  // Reads the shard index entries for `requests`, which must be sorted by
+  // minishard and refer to a contiguous range of minishards.
+  void ProcessMinishardRun(Batch::View batch, span<Request> requests,
+                           Batch minishard_fetch_batch) {
+    const MinishardIndex first_minishard =
+        std::get<MinishardIndex>(requests.front());
+    const MinishardIndex last_minishard =
+        std::get<MinishardIndex>(requests.back());
     kvstore::ReadOptions kvstore_read_options;
     kvstore_read_options.generation_conditions =
         std::get<kvstore::ReadGenerationConditions>(this->batch_entry_key);
     kvstore_read_options.staleness_bound = this->request_batch.staleness_bound;
-    auto key = std::get<MinishardIndex>(request);
     kvstore_read_options.byte_range = OptionalByteRangeRequest{
-        static_cast<int64_t>(key * 16), static_cast<int64_t>((key + 1) * 16)};
+        static_cast<int64_t>(first_minishard * 16),
+        static_cast<int64_t>((last_minishard + 1) * 16)};
     kvstore_read_options.batch = batch;
     auto shard_index_read_future = this->driver().base()->Read(
         this->ShardKey(), std::move(kvstore_read_options));
     shard_index_read_future.Force();
     shard_index_read_future.ExecuteWhenReady(
         [self = internal::IntrusivePtr<MinishardIndexReadOperationState>(this),
-         minishard_fetch_batch = std::move(minishard_fetch_batch),
-         &request](ReadyFuture<kvstore::ReadResult> future) mutable {
+         minishard_fetch_batch = std::move(minishard_fetch_batch), requests,
+         first_minishard](ReadyFuture<kvstore::ReadResult> future) mutable {
           const auto& executor = self->driver().executor();
-          executor([self = std::move(self), &request,
+          executor([self = std::move(self), requests, first_minishard,
                     minishard_fetch_batch = std::move(minishard_fetch_batch),
                     future = std::move(future)] {
-            OnShardIndexReady(std::move(self), request,
-                              std::move(minishard_fetch_batch),
-                              std::move(future.result()));
+            const auto& result = future.result();
+            for (auto& request : requests) {
+              Result<kvstore::ReadResult> entry_result = result;
+              if (entry_result.ok() && entry_result->has_value()) {
+                // Extract the shard index entry of this minishard.
+                entry_result->value = result->value.Subcord(
+                    (std::get<MinishardIndex>(request) - first_minishard) * 16,
+                    16);
+              }
+              OnShardIndexReady(self, request, minishard_fetch_batch,
+                                std::move(entry_result));
+            }
           });
         });
   }
@@ -651,11 +687,8 @@ class ShardedKeyValueStoreWriteCache
     void Writeback(internal_kvstore::ReadModifyWriteEntry& entry,
                    internal_kvstore::ReadModifyWriteEntry& source_entry,
                    kvstore::ReadResult&& read_result) override {
-      auto& value = read_result.value;
-      if (read_result.state == kvstore::ReadResult::kValue) {
-        value = EncodeData(value,
-                           GetOwningCache(*this).sharding_spec().data_encoding);
-      }
+      // The value is buffered unencoded; it is encoded, along with the other
+      // chunks of the shard, by `EncodeChunksForWriteback`.
       internal_kvstore::AtomicMultiPhaseMutation::Writeback(
           entry, entry, std::move(read_result));
     }
@@ -724,6 +757,79 @@ void StartApply(ShardedKeyValueStoreWriteCache::TransactionNode& node) {
   node.RetryAtomicWriteback(node.apply_options_.staleness_bound);
 }
 
+/// Encodes the new chunks of a shard according to the `data_encoding`, and
+/// then sends the new shard state to `node.apply_receiver_`.
+///
+/// This is used by `MergeForWriteback`.  Each minishard is encoded by a
+/// separate task, such that the chunks of a shard are compressed in parallel.
+///
+/// \param stamp The stamp of the new shard state.
+/// \param chunks The chunks of the new shard state, ordered by minishard and
+///     then by chunk id.
+/// \param new_chunk_indices Indices within `chunks` of the unencoded chunks,
+///     in increasing order.
+void EncodeChunksForWriteback(
+    ShardedKeyValueStoreWriteCache::TransactionNode& node,
+    TimestampedStorageGeneration stamp, std::vector<EncodedChunk> chunks,
+    std::vector<size_t> new_chunk_indices) {
+  struct State {
+    ShardedKeyValueStoreWriteCache::TransactionNode* node;
+    ShardingSpec::DataEncoding data_encoding;
+    TimestampedStorageGeneration stamp;
+    std::shared_ptr<EncodedChunks> chunks;
+    std::vector<size_t> new_chunk_indices;
+    std::atomic<size_t> remaining_tasks;
+
+    void EncodeChunks(size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        auto& chunk = (*chunks)[new_chunk_indices[i]];
+        chunk.encoded_data = EncodeData(chunk.encoded_data, data_encoding);
+      }
+      if (remaining_tasks.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+      }
+      internal::AsyncCache::ReadState update;
+      update.stamp = std::move(stamp);
+      update.data = std::move(chunks);
+      execution::set_value(std::exchange(node->apply_receiver_, {}),
+                           std::move(update));
+    }
+  };
+  auto& cache = GetOwningCache(node);
+  auto state = std::make_shared<State>();
+  state->node = &node;
+  state->data_encoding = cache.sharding_spec().data_encoding;
+  state->stamp = std::move(stamp);
+  state->chunks = std::make_shared<EncodedChunks>(std::move(chunks));
+  state->new_chunk_indices = std::move(new_chunk_indices);
+
+  // Boundaries, within `new_chunk_indices`, of the chunks of each minishard.
+  std::vector<size_t> task_ends;
+  const auto& new_indices = state->new_chunk_indices;
+  if (state->data_encoding != ShardingSpec::DataEncoding::raw) {
+    for (size_t i = 1; i < new_indices.size(); ++i) {
+      if ((*state->chunks)[new_indices[i]].minishard_and_chunk_id.minishard !=
+          (*state->chunks)[new_indices[i - 1]]
+              .minishard_and_chunk_id.minishard) {
+        task_ends.push_back(i);
+      }
+    }
+    task_ends.push_back(new_indices.size());
+  } else {
+    task_ends.push_back(0);
+  }
+  state->remaining_tasks = task_ends.size();
+  size_t begin = 0;
+  for (size_t task_i = 0; task_i + 1 < task_ends.size(); ++task_i) {
+    cache.executor()([state, begin, end = task_ends[task_i]] {
+      state->EncodeChunks(begin, end);
+    });
+    begin = task_ends[task_i];
+  }
+  // Encode the last minishard on the current thread.
+  state->EncodeChunks(begin, task_ends.back());
+}
+
 /// Attempts to compute the new encoded shard state that merges any mutations
 /// into the existing state.
 ///
@@ -753,6 +859,8 @@ void MergeForWriteback(ShardedKeyValueStoreWriteCache::TransactionNode& node,
   }
 
   std::vector<EncodedChunk> chunks;
+  // Indices within `chunks` of the new, not yet encoded, chunks.
+  std::vector<size_t> new_chunk_indices;
   // Index of next chunk in `existing_chunks` not yet merged into `chunks`.
   size_t existing_index = 0;
   // Indicates that inconsistent conditional mutations were observed.
@@ -804,6 +912,7 @@ void MergeForWriteback(ShardedKeyValueStoreWriteCache::TransactionNode& node,
     }
     if (buffered_entry.value_state_ == kvstore::ReadResult::kValue) {
       // The mutation specifies a new value (rather than a deletion).
+      new_chunk_indices.push_back(chunks.size());
       chunks.push_back(
           EncodedChunk{minishard_and_chunk_id, buffered_entry.value_});
       changed = true;
@@ -827,14 +936,11 @@ void MergeForWriteback(ShardedKeyValueStoreWriteCache::TransactionNode& node,
   // Merge in any remaining existing chunks that occur after all mutated chunks.
   chunks.insert(chunks.end(), existing_chunks.begin() + existing_index,
                 existing_chunks.end());
-  internal::AsyncCache::ReadState update;
-  update.stamp = std::move(stamp);
   if (changed) {
-    update.stamp.generation.MarkDirty();
+    stamp.generation.MarkDirty();
   }
-  update.data = std::make_shared<EncodedChunks>(std::move(chunks));
-  execution::set_value(std::exchange(node.apply_receiver_, {}),
-                       std::move(update));
+  EncodeChunksForWriteback(node, std::move(stamp), std::move(chunks),
+                           std::move(new_chunk_indices));
 }
 
 }  // namespace
@@ -1119,8 +1225,10 @@ class ShardedKeyValueStore
 
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
+    // Entries are rewritten as part of the entire shard.
     return base_kvstore_driver()->GetSupportedFeatures(
-        KeyRange::Prefix(key_prefix()));
+               KeyRange::Prefix(key_prefix())) &
+           ~SupportedFeatures::kByteRangeWrite;
   }
 
   Result<KvStore> GetBase(std::string_view path,
@@ -1438,6 +1546,26 @@ class ReadOperationState
               }) -
           chunk_requests.begin());
 
+      // Requests for a zero-length prefix, as used to check for the presence
+      // of a chunk, are resolved from the minishard index alone.
+      chunk_requests = chunk_requests.first(
+          std::remove_if(
+              chunk_requests.begin(), chunk_requests.end(),
+              [&](Request& request) {
+                auto& byte_range_request =
+                    std::get<internal_kvstore_batch::ByteRangeReadRequest>(
+                        request);
+                if (byte_range_request.byte_range.inclusive_min != 0 ||
+                    byte_range_request.byte_range.exclusive_max != 0) {
+                  return false;
+                }
+                byte_range_request.promise.SetResult(
+                    kvstore::ReadResult::Value(absl::Cord(), stamp));
+                return true;
+              }) -
+          chunk_requests.begin());
+      if (chunk_requests.empty()) return;
+
       if (sharding_spec.data_encoding == ShardingSpec::DataEncoding::raw) {
         // Can apply requested byte range directly.
         const auto process_request = [&](Request& request) {
@@ -1654,6 +1782,123 @@ kvstore::DriverPtr GetShardedKeyValueStore(
       std::move(get_max_chunks_per_shard)));
 }
 
+namespace {
+
+/// State shared by the shard reads of an `ExportShards` operation.
+struct ExportShardsState
+    : public internal::AtomicReferenceCount<ExportShardsState> {
+  kvstore::DriverPtr base_kvstore;
+  Executor executor;
+  std::string key_prefix;
+  ShardingSpec sharding_spec;
+  ExportChunkFunction callback;
+  absl::Time staleness_bound;
+  uint64_t exclusive_max_shard;
+
+  absl::Mutex mutex;
+  uint64_t next_shard ABSL_GUARDED_BY(mutex);
+
+  /// Serializes calls to `callback`.
+  absl::Mutex callback_mutex;
+};
+
+absl::Status ExportShard(ExportShardsState& state, uint64_t shard,
+                         const kvstore::ReadResult& read_result) {
+  if (!read_result.has_value()) return absl::OkStatus();
+  TENSORSTORE_ASSIGN_OR_RETURN(auto chunks,
+                               SplitShard(state.sharding_spec,
+                                          read_result.value));
+  std::vector<absl::Cord> values;
+  values.reserve(chunks.size());
+  for (const auto& chunk : chunks) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto value,
+        DecodeData(chunk.encoded_data, state.sharding_spec.data_encoding),
+        ConvertInvalidArgumentToFailedPrecondition(MaybeAnnotateStatus(
+            _,
+            tensorstore::StrCat("Error decoding chunk ",
+                                chunk.minishard_and_chunk_id.chunk_id.value))));
+    values.push_back(std::move(value));
+  }
+  absl::MutexLock lock(&state.callback_mutex);
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        state.callback(chunks[i].minishard_and_chunk_id.chunk_id,
+                       std::move(values[i])));
+  }
+  return absl::OkStatus();
+}
+
+/// Starts reading the next shard that has not yet been read, if any.
+///
+/// The operation completes once all copies of `promise` are released.
+void StartNextShardRead(IntrusivePtr<ExportShardsState> state,
+                        Promise<void> promise) {
+  if (!promise.result_needed()) return;
+  uint64_t shard;
+  {
+    absl::MutexLock lock(&state->mutex);
+    if (state->next_shard == state->exclusive_max_shard) return;
+    shard = state->next_shard++;
+  }
+  std::string shard_key =
+      GetShardKey(state->sharding_spec, state->key_prefix, shard);
+  kvstore::ReadOptions options;
+  options.staleness_bound = state->staleness_bound;
+  auto future = state->base_kvstore->Read(shard_key, std::move(options));
+  Executor executor = state->executor;
+  LinkValue(
+      WithExecutor(
+          std::move(executor),
+          [state = std::move(state), shard, shard_key = std::move(shard_key)](
+              Promise<void> promise,
+              ReadyFuture<kvstore::ReadResult> future) mutable {
+            auto status = ExportShard(*state, shard, future.value());
+            if (!status.ok()) {
+              promise.SetResult(MaybeAnnotateStatus(
+                  std::move(status),
+                  tensorstore::StrCat("Error exporting shard ",
+                                      tensorstore::QuoteString(shard_key))));
+              return;
+            }
+            StartNextShardRead(std::move(state), std::move(promise));
+          }),
+      std::move(promise), std::move(future));
+}
+
+}  // namespace
+
+Future<const void> ExportShards(kvstore::DriverPtr base_kvstore,
+                                Executor executor, std::string key_prefix,
+                                const ShardingSpec& sharding_spec,
+                                ExportChunkFunction callback,
+                                ExportShardsOptions options) {
+  const uint64_t exclusive_max_shard =
+      options.exclusive_max_shard.value_or(sharding_spec.num_shards());
+  if (exclusive_max_shard > sharding_spec.num_shards() ||
+      options.inclusive_min_shard > exclusive_max_shard) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Invalid shard range [", options.inclusive_min_shard, ", ",
+        exclusive_max_shard, ") for ", sharding_spec.num_shards(),
+        " shards"));
+  }
+  auto state = internal::MakeIntrusivePtr<ExportShardsState>();
+  state->base_kvstore = std::move(base_kvstore);
+  state->executor = std::move(executor);
+  state->key_prefix = std::move(key_prefix);
+  state->sharding_spec = sharding_spec;
+  state->callback = std::move(callback);
+  state->staleness_bound = options.staleness_bound;
+  state->exclusive_max_shard = exclusive_max_shard;
+  state->next_shard = options.inclusive_min_shard;
+  auto [promise, future] = PromiseFuturePair<void>::Make(MakeResult());
+  for (size_t i = 0; i < std::max(options.max_concurrent_shards, size_t{1});
+       ++i) {
+    StartNextShardRead(state, promise);
+  }
+  return std::move(future);
+}
+
 std::string ChunkIdToKey(ChunkId chunk_id) {
   std::string key;
   key.resize(sizeof(uint64_t));
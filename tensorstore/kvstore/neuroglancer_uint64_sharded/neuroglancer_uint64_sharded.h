@@ -15,16 +15,21 @@
 #ifndef TENSORSTORE_KVSTORE_NEUROGLANCER_UINT64_SHARDED_NEUROGLANCER_UINT64_SHARDED_H_
 #define TENSORSTORE_KVSTORE_NEUROGLANCER_UINT64_SHARDED_NEUROGLANCER_UINT64_SHARDED_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <functional>
 #include <optional>
 #include <string>
 
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/neuroglancer_uint64_sharded/uint64_sharded.h"
 #include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
 
 namespace tensorstore {
 namespace neuroglancer_uint64_sharded {
@@ -99,6 +104,62 @@ kvstore::DriverPtr GetShardedKeyValueStore(
     const ShardingSpec& sharding_spec, internal::CachePool::WeakPtr cache_pool,
     GetMaxChunksPerShardFunction get_max_chunks_per_shard = {});
 
+/// Receives a single chunk exported by `ExportShards`.
+///
+/// Returning an error status stops the export, and the error is returned from
+/// `ExportShards`.
+using ExportChunkFunction =
+    std::function<absl::Status(ChunkId chunk_id, absl::Cord value)>;
+
+/// Options for `ExportShards`.
+struct ExportShardsOptions {
+  /// First shard number to export.
+  uint64_t inclusive_min_shard = 0;
+
+  /// One past the last shard number to export.  Defaults to the number of
+  /// shards.
+  std::optional<uint64_t> exclusive_max_shard;
+
+  /// Maximum number of shards read at once.  Each shard that is being read is
+  /// held in memory in its entirety.
+  size_t max_concurrent_shards = 1;
+
+  /// Cached shard data older than this bound is not used.
+  absl::Time staleness_bound = absl::InfiniteFuture();
+};
+
+/// Exports every chunk stored in a range of shards.
+///
+/// Unlike reading the chunks individually through the `KeyValueStore` returned
+/// by `GetShardedKeyValueStore`, which requires separate reads of the shard
+/// index, minishard index, and chunk data, each shard is read from
+/// `base_kvstore` in its entirety by a single request and then split into its
+/// chunks.  This makes exporting an entire sharded database bound by
+/// sequential bandwidth rather than by the number of requests.
+///
+/// The decoded value of each chunk is passed to `callback`.  Calls to
+/// `callback` are never concurrent, and the chunks of a given shard are
+/// passed consecutively, ordered by minishard and then by chunk id.  Shards
+/// are passed in order of shard number only if
+/// `options.max_concurrent_shards == 1`.  Shards that do not exist are
+/// skipped.
+///
+/// \param base_kvstore The underlying `KeyValueStore` that holds the shard
+///     files.
+/// \param executor Executor used to split and decode the shards and to invoke
+///     `callback`.
+/// \param key_prefix Prefix of the sharded database within `base_kvstore`.
+/// \param sharding_spec Sharding specification.
+/// \param callback Called for each chunk.
+/// \param options Export options.
+/// \error `absl::StatusCode::kInvalidArgument` if the shard range is invalid.
+/// \error `absl::StatusCode::kFailedPrecondition` if a shard is corrupt.
+Future<const void> ExportShards(kvstore::DriverPtr base_kvstore,
+                                Executor executor, std::string key_prefix,
+                                const ShardingSpec& sharding_spec,
+                                ExportChunkFunction callback,
+                                ExportShardsOptions options = {});
+
 /// Returns a key suitable for use with a `KeyValueStore` returned from
 /// `GetShardedKeyValueStore`.
 ///
@@ -58,6 +58,8 @@
 #include "tensorstore/kvstore/test_util.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/executor.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -85,7 +87,10 @@ using ::tensorstore::internal::MatchesTimestampedStorageGeneration;
 using ::tensorstore::internal::MockKeyValueStore;
 using ::tensorstore::internal::UniqueNow;
 using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::neuroglancer_uint64_sharded::ChunkId;
 using ::tensorstore::neuroglancer_uint64_sharded::ChunkIdToKey;
+using ::tensorstore::neuroglancer_uint64_sharded::ExportShards;
+using ::tensorstore::neuroglancer_uint64_sharded::ExportShardsOptions;
 using ::tensorstore::neuroglancer_uint64_sharded::GetShardedKeyValueStore;
 using ::tensorstore::neuroglancer_uint64_sharded::ShardingSpec;
 
@@ -196,6 +201,46 @@ TEST(Uint64ShardedKeyValueStoreTest, BasicFunctionality) {
   }
 }
 
+// Tests that a shard with gzip-encoded chunks spanning multiple minishards,
+// which are encoded in parallel, is written correctly.
+TEST(Uint64ShardedKeyValueStoreTest, TransactionalWriteMultipleMinishards) {
+  ::nlohmann::json sharding_spec_json{
+      {"@type", "neuroglancer_uint64_sharded_v1"},
+      {"hash", "identity"},
+      {"preshift_bits", 0},
+      {"minishard_bits", 2},
+      {"shard_bits", 0},
+      {"data_encoding", "gzip"},
+      {"minishard_index_encoding", "gzip"}};
+  auto sharding_spec = ShardingSpec::FromJson(sharding_spec_json).value();
+  auto base_kv_store = tensorstore::GetMemoryKeyValueStore();
+  auto cache_pool = CachePool::Make(kSmallCacheLimits);
+  auto store = GetShardedKeyValueStore(
+      base_kv_store, GetExecutor("thread_pool"), "prefix", sharding_spec,
+      CachePool::WeakPtr(cache_pool));
+
+  constexpr uint64_t kNumChunks = 16;
+  tensorstore::Transaction txn(tensorstore::isolated);
+  for (uint64_t chunk_id = 0; chunk_id < kNumChunks; ++chunk_id) {
+    absl::Cord value(tensorstore::StrCat("value", chunk_id));
+    TENSORSTORE_ASSERT_OK(
+        kvstore::Write(KvStore{store, txn}, GetChunkKey(chunk_id), value));
+  }
+  TENSORSTORE_ASSERT_OK(txn.CommitAsync());
+
+  // Read back using a separate cache.
+  auto cache_pool2 = CachePool::Make(kSmallCacheLimits);
+  auto store2 = GetShardedKeyValueStore(
+      base_kv_store, GetExecutor("inline"), "prefix", sharding_spec,
+      CachePool::WeakPtr(cache_pool2));
+  for (uint64_t chunk_id = 0; chunk_id < kNumChunks; ++chunk_id) {
+    absl::Cord expected(tensorstore::StrCat("value", chunk_id));
+    EXPECT_THAT(store2->Read(GetChunkKey(chunk_id)).result(),
+                MatchesKvsReadResult(expected))
+        << chunk_id;
+  }
+}
+
 TEST(Uint64ShardedKeyValueStoreTest, DescribeKey) {
   ::nlohmann::json sharding_spec_json{
       {"@type", "neuroglancer_uint64_sharded_v1"},
@@ -1598,6 +1643,29 @@ TEST_F(UnderlyingKeyValueStoreTest, BatchRead) {
     EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(3));
   }
 
+  {
+    SCOPED_TRACE(
+        "Read 2/6 chunks from the same shard (adjacent minishards) in a single "
+        "batch");
+    std::vector<Future<kvstore::ReadResult>> futures;
+    {
+      kvstore::ReadOptions options;
+      options.batch = Batch::New();
+      futures = {
+          store->Read(key0, options),
+          store->Read(key3, options),
+      };
+    }
+    EXPECT_THAT(futures[0].result(), MatchesKvsReadResult(absl::Cord("abc")));
+    EXPECT_THAT(futures[1].result(), MatchesKvsReadResult(absl::Cord("key3-")));
+    // Expected to result in a single request for the shard index entries of
+    // both minishards, followed by a batch request for the two minishard
+    // indices, followed by a batch request for the two entries.
+    auto log = mock_store->request_log.pop_all();
+    ASSERT_THAT(log, ::testing::SizeIs(3));
+    EXPECT_THAT(log[0]["requests"], ::testing::SizeIs(1));
+  }
+
   {
     SCOPED_TRACE("Read 6/6 entries from the same shard in a single batch");
     std::vector<Future<kvstore::ReadResult>> futures;
@@ -1685,6 +1753,43 @@ TEST_F(UnderlyingKeyValueStoreTest, BatchRead) {
   }
 }
 
+// Tests that zero-length reads, as used to check for the presence of a chunk,
+// do not read the chunk data.
+TEST_F(UnderlyingKeyValueStoreTest, ZeroLengthReadResolvedFromIndex) {
+  cache_pool = CachePool::Make({});
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  mock_store->forward_to = memory_store;
+  mock_store->log_requests = true;
+  mock_store->handle_batch_requests = true;
+
+  auto store = GetStore(
+      /*get_max_chunks_per_shard=*/[](uint64_t shard) -> uint64_t {
+        return 6;
+      });
+
+  auto key0 = GetChunkKey(0x50);  // shard=0, minishard=0
+  auto key1 = GetChunkKey(0x54);  // shard=0, minishard=0
+
+  TENSORSTORE_ASSERT_OK(store->Write(key0, absl::Cord("abc")).result());
+  mock_store->request_log.pop_all();
+
+  std::vector<Future<kvstore::ReadResult>> futures;
+  {
+    kvstore::ReadOptions options;
+    options.batch = Batch::New();
+    options.byte_range = OptionalByteRangeRequest(0, 0);
+    futures = {
+        store->Read(key0, options),
+        store->Read(key1, options),
+    };
+  }
+  EXPECT_THAT(futures[0].result(), MatchesKvsReadResult(absl::Cord()));
+  EXPECT_THAT(futures[1].result(), MatchesKvsReadResultNotFound());
+  // Expected to result in a single request for the shard index, followed by a
+  // single request for the minishard index.
+  EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(2));
+}
+
 // Tests of ReadModifyWrite operations, using `KvsBackedTestCache` ->
 // `Uint64ShardedKeyValueStore` -> `MockKeyValueStore`.
 class ReadModifyWriteTest : public ::testing::Test {
@@ -1829,6 +1934,96 @@ TENSORSTORE_GLOBAL_INITIALIZER {
   }
 }
 
+class ExportShardsTest : public ::testing::Test {
+ protected:
+  ::nlohmann::json sharding_spec_json{
+      {"@type", "neuroglancer_uint64_sharded_v1"},
+      {"hash", "identity"},
+      {"preshift_bits", 0},
+      {"minishard_bits", 1},
+      {"shard_bits", 2},
+      {"data_encoding", "gzip"},
+      {"minishard_index_encoding", "raw"}};
+  ShardingSpec sharding_spec =
+      ShardingSpec::FromJson(sharding_spec_json).value();
+  CachePool::StrongPtr cache_pool = CachePool::Make(kSmallCacheLimits);
+  kvstore::DriverPtr base_kv_store = tensorstore::GetMemoryKeyValueStore();
+  kvstore::DriverPtr store = GetShardedKeyValueStore(
+      base_kv_store, tensorstore::InlineExecutor{}, "prefix", sharding_spec,
+      CachePool::WeakPtr(cache_pool));
+
+  void WriteChunks(const std::map<uint64_t, absl::Cord>& values) {
+    for (const auto& [chunk_id, value] : values) {
+      TENSORSTORE_ASSERT_OK(store->Write(GetChunkKey(chunk_id), value));
+    }
+  }
+
+  Result<std::map<uint64_t, absl::Cord>> Export(
+      ExportShardsOptions options = {}) {
+    std::map<uint64_t, absl::Cord> values;
+    TENSORSTORE_RETURN_IF_ERROR(
+        ExportShards(
+            base_kv_store, tensorstore::internal::DetachedThreadPool(2),
+            "prefix", sharding_spec,
+            [&](ChunkId chunk_id, absl::Cord value) {
+              EXPECT_TRUE(values.emplace(chunk_id.value, value).second);
+              return absl::OkStatus();
+            },
+            options)
+            .result());
+    return values;
+  }
+};
+
+TEST_F(ExportShardsTest, AllShards) {
+  std::map<uint64_t, absl::Cord> values{
+      {1, absl::Cord("a")},   {2, absl::Cord("bc")}, {3, absl::Cord("def")},
+      {6, absl::Cord("gh")},  {7, absl::Cord("i")},  {10, absl::Cord("xyz")},
+      {13, absl::Cord("jk")}, {100, absl::Cord("l")}};
+  WriteChunks(values);
+  for (size_t max_concurrent_shards : {1, 3}) {
+    SCOPED_TRACE(max_concurrent_shards);
+    ExportShardsOptions options;
+    options.max_concurrent_shards = max_concurrent_shards;
+    EXPECT_THAT(Export(options), ::testing::Optional(values));
+  }
+}
+
+TEST_F(ExportShardsTest, ShardRange) {
+  WriteChunks({{1, absl::Cord("a")}, {2, absl::Cord("bc")}});
+  ExportShardsOptions options;
+  options.inclusive_min_shard = 1;
+  options.exclusive_max_shard = 2;
+  EXPECT_THAT(Export(options),
+              ::testing::Optional(::testing::ElementsAre(
+                  ::testing::Pair(2, absl::Cord("bc")))));
+  options.exclusive_max_shard = 5;
+  EXPECT_THAT(Export(options),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Invalid shard range \\[1, 5\\) for 4 shards"));
+}
+
+TEST_F(ExportShardsTest, CorruptShard) {
+  WriteChunks({{1, absl::Cord("a")}});
+  TENSORSTORE_ASSERT_OK(
+      base_kv_store->Write("prefix/1.shard", Bytes({1, 2, 3})));
+  EXPECT_THAT(Export(),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            "Error exporting shard \"prefix/1\\.shard\": "
+                            "Existing shard has size 3, .*"));
+}
+
+TEST_F(ExportShardsTest, CallbackError) {
+  WriteChunks({{1, absl::Cord("a")}});
+  auto future = ExportShards(
+      base_kv_store, tensorstore::InlineExecutor{}, "prefix", sharding_spec,
+      [](ChunkId chunk_id, absl::Cord value) {
+        return absl::UnknownError("stop");
+      });
+  EXPECT_THAT(future.result(),
+              MatchesStatus(absl::StatusCode::kUnknown, ".*stop"));
+}
+
 TEST(ShardedKeyValueStoreTest, SpecRoundtrip) {
   ::nlohmann::json sharding_spec_json{
       {"@type", "neuroglancer_uint64_sharded_v1"},
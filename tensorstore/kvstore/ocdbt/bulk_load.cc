@@ -0,0 +1,319 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/bulk_load.h"
+
+#include <stddef.h>
+
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/btree_node_encoder.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/create_new_manifest.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/write_nodes.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+}  // namespace
+
+template <typename Entry>
+BulkLoader::PendingLevel<Entry>::PendingLevel(const Config& config,
+                                              BtreeNodeHeight height)
+    : config(config), height(height) {
+  Reset();
+}
+
+template <typename Entry>
+void BulkLoader::PendingLevel<Entry>::Reset() {
+  encoder.emplace(config, height, /*existing_prefix=*/std::string_view());
+  keys.clear();
+  num_entries = 0;
+  num_bytes = 0;
+}
+
+template <typename Entry>
+bool BulkLoader::PendingLevel<Entry>::ShouldFlush() const {
+  if (num_entries >= kNodesPerFlush * kMaxNodeArity) return true;
+  return config.max_decoded_node_bytes != 0 &&
+         num_bytes >= kNodesPerFlush * config.max_decoded_node_bytes;
+}
+
+BulkLoader::BulkLoader(IoHandle::Ptr io_handle, const Config& config,
+                       std::shared_ptr<const Manifest> existing_manifest)
+    : io_handle_(std::move(io_handle)),
+      config_(config),
+      existing_manifest_(std::move(existing_manifest)),
+      leaf_level_(config_, /*height=*/0) {}
+
+Future<BulkLoader::Ptr> BulkLoader::Open(IoHandle::Ptr io_handle) {
+  auto ensure_future = internal_ocdbt::EnsureExistingManifest(io_handle);
+  return PromiseFuturePair<Ptr>::LinkValue(
+             [io_handle = std::move(io_handle)](
+                 Promise<Ptr> promise, ReadyFuture<const absl::Time> time) {
+               LinkValue(
+                   [io_handle](Promise<Ptr> promise,
+                               ReadyFuture<const ManifestWithTime> future) {
+                     auto& manifest = future.value().manifest;
+                     const Config* config =
+                         io_handle->config_state->GetExistingConfig();
+                     if (!manifest || !config) {
+                       promise.SetResult(absl::FailedPreconditionError(
+                           "Manifest was unexpectedly deleted"));
+                       return;
+                     }
+                     if (!manifest->versions.empty() &&
+                         !manifest->latest_version()
+                              .root.location.IsMissing()) {
+                       promise.SetResult(absl::FailedPreconditionError(
+                           "Bulk load requires an empty database"));
+                       return;
+                     }
+                     promise.SetResult(internal::MakeIntrusivePtr<BulkLoader>(
+                         io_handle, *config, manifest));
+                   },
+                   std::move(promise), io_handle->GetManifest(time.value()));
+             },
+             std::move(ensure_future))
+      .future;
+}
+
+absl::Status BulkLoader::Add(std::string_view key, absl::Cord value) {
+  if (committed_) {
+    return absl::FailedPreconditionError("Bulk load already committed");
+  }
+  if (num_keys_ != 0 && key <= last_key_) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Bulk load keys must be strictly increasing, but ",
+        tensorstore::QuoteString(key), " follows ",
+        tensorstore::QuoteString(last_key_)));
+  }
+  if (key.size() > kMaxKeyLength) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Key of length ", key.size(),
+                            " exceeds maximum length of ", kMaxKeyLength));
+  }
+  last_key_ = key;
+  ++num_keys_;
+
+  auto& level = leaf_level_;
+  LeafNodeEntry entry;
+  entry.key = level.keys.emplace_back(key);
+  if (value.size() > config_.max_inline_value_bytes) {
+    // Values are appended to the current data file in key order.
+    flush_promise_.Link(io_handle_->WriteData(
+        IndirectDataKind::kValue, std::move(value),
+        entry.value_reference.emplace<IndirectDataReference>()));
+  } else {
+    entry.value_reference = std::move(value);
+  }
+  level.num_bytes += key.size() + EstimateDecodedEntrySizeExcludingKey(entry);
+  ++level.num_entries;
+  level.encoder->AddEntry(/*existing=*/false, std::move(entry));
+  if (!level.ShouldFlush()) return absl::OkStatus();
+  TENSORSTORE_ASSIGN_OR_RETURN(auto new_entries,
+                               WriteLevel(level, /*may_be_root=*/false));
+  return AddInteriorEntries(1, std::move(new_entries));
+}
+
+template <typename Entry>
+Result<std::vector<InteriorNodeEntryData<std::string>>> BulkLoader::WriteLevel(
+    PendingLevel<Entry>& level, bool may_be_root) {
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "BulkLoader: writing height=" << static_cast<int>(level.height)
+      << ", num_entries=" << level.num_entries
+      << ", num_bytes=" << level.num_bytes;
+  auto encoded_nodes = level.encoder->Finalize(may_be_root);
+  // `Finalize` copies the keys it retains, so `level.keys` may be released.
+  level.Reset();
+  TENSORSTORE_RETURN_IF_ERROR(encoded_nodes);
+  return internal_ocdbt::WriteNodes(*io_handle_, flush_promise_,
+                                    *std::move(encoded_nodes));
+}
+
+absl::Status BulkLoader::AddInteriorEntries(
+    BtreeNodeHeight height,
+    std::vector<InteriorNodeEntryData<std::string>> entries) {
+  if (interior_levels_.size() < height) {
+    interior_levels_.push_back(
+        std::make_unique<PendingLevel<InteriorNodeEntry>>(config_, height));
+  }
+  auto& level = *interior_levels_[height - 1];
+  for (auto& entry : entries) {
+    InteriorNodeEntry new_entry;
+    new_entry.key = level.keys.emplace_back(std::move(entry.key));
+    new_entry.subtree_common_prefix_length = entry.subtree_common_prefix_length;
+    new_entry.node = entry.node;
+    level.num_bytes += new_entry.key.size() +
+                       EstimateDecodedEntrySizeExcludingKey(new_entry);
+    ++level.num_entries;
+    level.encoder->AddEntry(/*existing=*/false, std::move(new_entry));
+  }
+  if (!level.ShouldFlush()) return absl::OkStatus();
+  if (height == std::numeric_limits<BtreeNodeHeight>::max()) {
+    return absl::DataLossError("Maximum B+tree height exceeded");
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto new_entries,
+                               WriteLevel(level, /*may_be_root=*/false));
+  return AddInteriorEntries(height + 1, std::move(new_entries));
+}
+
+Result<BtreeGenerationReference> BulkLoader::WriteRemainingLevels() {
+  if (num_keys_ == 0) {
+    return internal_ocdbt::WriteRootNode(*io_handle_, flush_promise_,
+                                         /*height=*/0, /*new_entries=*/{});
+  }
+  // Write the remaining entries of each level, bottom-up.  The highest level
+  // which has received entries may contain the root.
+  for (BtreeNodeHeight height = 0;; ++height) {
+    const bool is_top = (interior_levels_.size() == height);
+    std::vector<InteriorNodeEntryData<std::string>> new_entries;
+    if (height == 0) {
+      TENSORSTORE_ASSIGN_OR_RETURN(new_entries,
+                                   WriteLevel(leaf_level_, is_top));
+    } else {
+      auto& level = *interior_levels_[height - 1];
+      if (level.num_entries == 0) continue;
+      TENSORSTORE_ASSIGN_OR_RETURN(new_entries, WriteLevel(level, is_top));
+    }
+    if (is_top) {
+      return internal_ocdbt::WriteRootNode(*io_handle_, flush_promise_, height,
+                                           std::move(new_entries));
+    }
+    TENSORSTORE_RETURN_IF_ERROR(
+        AddInteriorEntries(height + 1, std::move(new_entries)));
+  }
+}
+
+Future<absl::Time> BulkLoader::Commit() {
+  if (committed_) {
+    return absl::FailedPreconditionError("Bulk load already committed");
+  }
+  committed_ = true;
+  TENSORSTORE_ASSIGN_OR_RETURN(auto new_generation, WriteRemainingLevels());
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "BulkLoader: committing " << num_keys_ << " keys, root_height="
+      << static_cast<int>(new_generation.root_height);
+
+  auto manifest_future = internal_ocdbt::CreateNewManifest(
+      io_handle_, existing_manifest_, new_generation);
+  return PromiseFuturePair<absl::Time>::LinkValue(
+             [self = Ptr(this)](
+                 Promise<absl::Time> promise,
+                 ReadyFuture<
+                     std::pair<std::shared_ptr<Manifest>, Future<const void>>>
+                     future) {
+               auto& [new_manifest, version_flush_future] = future.value();
+               // All data files must be durable before they are referenced
+               // by the manifest.
+               self->flush_promise_.Link(version_flush_future);
+               auto flush_future = std::move(self->flush_promise_).future();
+               if (flush_future.null()) flush_future = MakeReadyFuture();
+               flush_future.Force();
+               LinkValue(
+                   [self, new_manifest = new_manifest](
+                       Promise<absl::Time> promise,
+                       ReadyFuture<const void> future) {
+                     auto update_future = self->io_handle_->TryUpdateManifest(
+                         self->existing_manifest_, new_manifest, absl::Now());
+                     LinkValue(
+                         [](Promise<absl::Time> promise,
+                            ReadyFuture<TryUpdateManifestResult> future) {
+                           auto& result = future.value();
+                           if (!result.success) {
+                             promise.SetResult(absl::FailedPreconditionError(
+                                 "Database was modified concurrently with "
+                                 "bulk load"));
+                             return;
+                           }
+                           promise.SetResult(result.time);
+                         },
+                         std::move(promise), std::move(update_future));
+                   },
+                   std::move(promise), std::move(flush_future));
+             },
+             std::move(manifest_future))
+      .future;
+}
+
+Future<absl::Time> BulkLoad(
+    IoHandle::Ptr io_handle,
+    std::vector<std::vector<BulkLoadEntry>> sorted_runs) {
+  return PromiseFuturePair<absl::Time>::LinkValue(
+             [sorted_runs = std::move(sorted_runs)](
+                 Promise<absl::Time> promise,
+                 ReadyFuture<BulkLoader::Ptr> future) mutable {
+               auto& loader = *future.value();
+               // K-way merge of the runs, ordered by the next key of each run.
+               struct RunPosition {
+                 std::vector<BulkLoadEntry>* run;
+                 size_t index;
+               };
+               const auto greater = [](const RunPosition& a,
+                                       const RunPosition& b) {
+                 return (*a.run)[a.index].key > (*b.run)[b.index].key;
+               };
+               std::priority_queue<RunPosition, std::vector<RunPosition>,
+                                   decltype(greater)>
+                   queue(greater);
+               for (auto& run : sorted_runs) {
+                 if (!run.empty()) queue.push({&run, 0});
+               }
+               while (!queue.empty()) {
+                 auto position = queue.top();
+                 queue.pop();
+                 auto& entry = (*position.run)[position.index];
+                 TENSORSTORE_RETURN_IF_ERROR(
+                     loader.Add(entry.key, std::move(entry.value)),
+                     static_cast<void>(promise.SetResult(_)));
+                 if (++position.index < position.run->size()) {
+                   queue.push(position);
+                 }
+               }
+               LinkResult(std::move(promise), loader.Commit());
+             },
+             BulkLoader::Open(std::move(io_handle)))
+      .future;
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
@@ -0,0 +1,163 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_BULK_LOAD_H_
+#define TENSORSTORE_KVSTORE_OCDBT_BULK_LOAD_H_
+
+/// \file
+///
+/// Bulk loading of sorted key/value pairs into an empty OCDBT database.
+///
+/// Ordinary writes are staged as mutations and merged into the existing
+/// B+tree by traversing it from the root.  When the database is empty and
+/// the keys are available in sorted order, the B+tree can instead be built
+/// bottom-up in a single pass: values are appended sequentially to data
+/// files, and each level of nodes is encoded as soon as enough entries have
+/// accumulated to fill several nodes, so that all nodes except the last of
+/// each level are nearly full.
+///
+/// The new version is committed by a single manifest update, which fails if
+/// the database is modified concurrently.
+
+#include <stddef.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/btree_node_encoder.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Builds the B+tree of an empty database from key/value pairs added in
+/// strictly increasing key order.
+///
+/// Must not be used with a database that is written concurrently by a
+/// distributed (coordinator-based) writer.
+class BulkLoader : public internal::AtomicReferenceCount<BulkLoader> {
+ public:
+  using Ptr = internal::IntrusivePtr<BulkLoader>;
+
+  /// Number of nodes' worth of entries accumulated at each level before they
+  /// are encoded.  Larger values result in more uniformly filled nodes at the
+  /// cost of memory.
+  constexpr static size_t kNodesPerFlush = 16;
+
+  /// Creates a bulk loader for the database accessed by `io_handle`.
+  ///
+  /// Creates the manifest if it does not exist.  Fails with
+  /// `absl::StatusCode::kFailedPrecondition` if the latest version of the
+  /// database is not empty.
+  static Future<Ptr> Open(IoHandle::Ptr io_handle);
+
+  /// Adds a key/value pair.
+  ///
+  /// Keys must be strictly increasing.  Values which exceed
+  /// `Config::max_inline_value_bytes` are written to data files immediately;
+  /// completed nodes are also written as they become available.
+  absl::Status Add(std::string_view key, absl::Cord value);
+
+  /// Writes the remaining nodes and commits the new version.
+  ///
+  /// Returns the time at which the manifest was written.  No further calls to
+  /// `Add` are permitted.
+  Future<absl::Time> Commit();
+
+  /// Returns the number of key/value pairs added.
+  size_t num_keys() const { return num_keys_; }
+
+  // Treat as private:
+
+  BulkLoader(IoHandle::Ptr io_handle, const Config& config,
+             std::shared_ptr<const Manifest> existing_manifest);
+
+ private:
+  // Entries accumulated for one level of the tree.
+  template <typename Entry>
+  struct PendingLevel {
+    PendingLevel(const Config& config, BtreeNodeHeight height);
+
+    void Reset();
+
+    bool ShouldFlush() const;
+
+    const Config& config;
+    BtreeNodeHeight height;
+    std::optional<BtreeNodeEncoder<Entry>> encoder;
+
+    // Storage for the keys referenced by the entries added to `encoder`.
+    std::deque<std::string> keys;
+    size_t num_entries;
+    size_t num_bytes;
+  };
+
+  template <typename Entry>
+  Result<std::vector<InteriorNodeEntryData<std::string>>> WriteLevel(
+      PendingLevel<Entry>& level, bool may_be_root);
+
+  absl::Status AddInteriorEntries(
+      BtreeNodeHeight height,
+      std::vector<InteriorNodeEntryData<std::string>> entries);
+
+  Result<BtreeGenerationReference> WriteRemainingLevels();
+
+  IoHandle::Ptr io_handle_;
+  Config config_;
+  std::shared_ptr<const Manifest> existing_manifest_;
+  FlushPromise flush_promise_;
+
+  PendingLevel<LeafNodeEntry> leaf_level_;
+  // `interior_levels_[i]` holds the entries for nodes of height `i + 1`.
+  std::vector<std::unique_ptr<PendingLevel<InteriorNodeEntry>>>
+      interior_levels_;
+
+  std::string last_key_;
+  size_t num_keys_ = 0;
+  bool committed_ = false;
+};
+
+/// Single key/value pair for `BulkLoad`.
+struct BulkLoadEntry {
+  std::string key;
+  absl::Cord value;
+};
+
+/// Loads the union of `sorted_runs` into the empty database accessed by
+/// `io_handle`.
+///
+/// Each run must be sorted by key, and the runs must not contain duplicate
+/// keys.  The runs are merged while loading.
+Future<absl::Time> BulkLoad(
+    IoHandle::Ptr io_handle,
+    std::vector<std::vector<BulkLoadEntry>> sorted_runs);
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_BULK_LOAD_H_
@@ -0,0 +1,152 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/bulk_load.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/driver.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+using ::tensorstore::KvStore;
+using ::tensorstore::MatchesKvsReadResult;
+using ::tensorstore::MatchesKvsReadResultNotFound;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_ocdbt::BulkLoad;
+using ::tensorstore::internal_ocdbt::BulkLoadEntry;
+using ::tensorstore::internal_ocdbt::BulkLoader;
+using ::tensorstore::internal_ocdbt::OcdbtDriver;
+
+KvStore OpenStore(int max_inline_value_bytes = 100) {
+  return kvstore::Open({{"driver", "ocdbt"},
+                        {"base", "memory://"},
+                        {"config",
+                         {{"max_inline_value_bytes", max_inline_value_bytes},
+                          {"max_decoded_node_bytes", 1024}}}})
+      .value();
+}
+
+std::string Key(int i) { return absl::StrFormat("key%06d", i); }
+
+TEST(BulkLoadTest, Basic) {
+  for (int max_inline_value_bytes : {0, 100}) {
+    auto store = OpenStore(max_inline_value_bytes);
+    auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto loader, BulkLoader::Open(driver.io_handle_).result());
+    constexpr int kNumKeys = 5000;
+    for (int i = 0; i < kNumKeys; ++i) {
+      TENSORSTORE_ASSERT_OK(loader->Add(Key(i), absl::Cord(Key(i) + "_value")));
+    }
+    EXPECT_EQ(kNumKeys, loader->num_keys());
+    TENSORSTORE_ASSERT_OK(loader->Commit().result());
+
+    for (int i : {0, 1, 1234, kNumKeys - 1}) {
+      EXPECT_THAT(kvstore::Read(store, Key(i)).result(),
+                  MatchesKvsReadResult(absl::Cord(Key(i) + "_value")));
+    }
+    EXPECT_THAT(kvstore::Read(store, "missing").result(),
+                MatchesKvsReadResultNotFound());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto list,
+                                     kvstore::ListFuture(store).result());
+    EXPECT_EQ(kNumKeys, list.size());
+
+    // The loaded database supports ordinary writes.
+    TENSORSTORE_ASSERT_OK(
+        kvstore::Write(store, Key(1), absl::Cord("new")).result());
+    EXPECT_THAT(kvstore::Read(store, Key(1)).result(),
+                MatchesKvsReadResult(absl::Cord("new")));
+  }
+}
+
+TEST(BulkLoadTest, Empty) {
+  auto store = OpenStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto loader, BulkLoader::Open(driver.io_handle_).result());
+  TENSORSTORE_ASSERT_OK(loader->Commit().result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto list,
+                                   kvstore::ListFuture(store).result());
+  EXPECT_THAT(list, ::testing::IsEmpty());
+}
+
+TEST(BulkLoadTest, UnsortedKeys) {
+  auto store = OpenStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto loader, BulkLoader::Open(driver.io_handle_).result());
+  TENSORSTORE_ASSERT_OK(loader->Add("b", absl::Cord("1")));
+  EXPECT_THAT(loader->Add("a", absl::Cord("2")),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(loader->Add("b", absl::Cord("2")),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BulkLoadTest, NonEmptyDatabase) {
+  auto store = OpenStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("1")).result());
+  EXPECT_THAT(BulkLoader::Open(driver.io_handle_).result(),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(BulkLoadTest, ConcurrentModification) {
+  auto store = OpenStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto loader, BulkLoader::Open(driver.io_handle_).result());
+  TENSORSTORE_ASSERT_OK(loader->Add("a", absl::Cord("1")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "b", absl::Cord("2")).result());
+  EXPECT_THAT(loader->Commit().result(),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(BulkLoadTest, MergeRuns) {
+  auto store = OpenStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  std::vector<std::vector<BulkLoadEntry>> runs(3);
+  for (int i = 0; i < 300; ++i) {
+    runs[i % 3].push_back({Key(i), absl::Cord(Key(i))});
+  }
+  TENSORSTORE_ASSERT_OK(BulkLoad(driver.io_handle_, std::move(runs)).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto list,
+                                   kvstore::ListFuture(store).result());
+  EXPECT_EQ(300, list.size());
+  EXPECT_THAT(kvstore::Read(store, Key(200)).result(),
+              MatchesKvsReadResult(absl::Cord(Key(200))));
+}
+
+TEST(BulkLoadTest, MergeRunsDuplicateKey) {
+  auto store = OpenStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  std::vector<std::vector<BulkLoadEntry>> runs(2);
+  runs[0].push_back({"a", absl::Cord("1")});
+  runs[1].push_back({"a", absl::Cord("2")});
+  EXPECT_THAT(BulkLoad(driver.io_handle_, std::move(runs)).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
@@ -0,0 +1,646 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/compaction.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/list.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/storage_generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+constexpr size_t kDataFileIdLength = 32;
+
+// Asynchronous operation state used to implement `GetDataFileUsage`.
+//
+// The version tree and the B+trees of the live versions are traversed in
+// parallel.  Each distinct node and indirect value is visited once; B+tree
+// nodes are typically shared by many versions.
+//
+// The promise is resolved with the accumulated usage when the last reference
+// to the operation is released, unless an error has already been set.
+struct DataFileUsageOperation
+    : public internal::AtomicReferenceCount<DataFileUsageOperation> {
+  using Ptr = internal::IntrusivePtr<DataFileUsageOperation>;
+
+  ReadonlyIoHandle::Ptr io_handle;
+  std::optional<GenerationNumber> keep_versions;
+  GenerationNumber min_generation_number = 0;
+  Promise<DataFileUsage> promise;
+
+  absl::Mutex mutex;
+  DataFileUsage usage ABSL_GUARDED_BY(mutex);
+  absl::flat_hash_set<std::string> visited ABSL_GUARDED_BY(mutex);
+
+  ~DataFileUsageOperation() {
+    absl::MutexLock lock(&mutex);
+    promise.SetResult(std::move(usage));
+  }
+
+  // Records a reference to `ref`.  Returns `false` if `ref` was already
+  // recorded.
+  bool AddReference(const IndirectDataReference& ref) {
+    absl::MutexLock lock(&mutex);
+    if (!visited.insert(ref.EncodeCacheKey()).second) return false;
+    usage[ref.file_id.FullPath()] += ref.length;
+    return true;
+  }
+
+  static void ManifestReady(Ptr op,
+                            ReadyFuture<const ManifestWithTime> read_future) {
+    const auto* manifest = read_future.value().manifest.get();
+    if (!manifest) return;
+    if (op->keep_versions) {
+      GenerationNumber latest = manifest->latest_generation();
+      op->min_generation_number =
+          latest >= *op->keep_versions ? latest - *op->keep_versions + 1 : 0;
+    }
+    for (const auto& entry : manifest->version_tree_nodes) {
+      VisitVersionNode(op, entry);
+    }
+    VisitVersions(op, manifest->versions);
+  }
+
+  static void VisitVersionNode(const Ptr& op,
+                               const VersionNodeReference& node_ref) {
+    if (!op->AddReference(node_ref.location)) return;
+    auto* op_ptr = op.get();
+    LinkValue(
+        WithExecutor(
+            op_ptr->io_handle->executor,
+            [op, generation_number = node_ref.generation_number,
+             height = node_ref.height](
+                Promise<DataFileUsage> promise,
+                ReadyFuture<const std::shared_ptr<const VersionTreeNode>>
+                    read_future) {
+              const auto& node = *read_future.value();
+              auto* config = op->io_handle->config_state->GetExistingConfig();
+              assert(config);
+              TENSORSTORE_RETURN_IF_ERROR(
+                  ValidateVersionTreeNodeReference(node, *config,
+                                                   generation_number, height),
+                  static_cast<void>(promise.SetResult(_)));
+              if (auto* entries =
+                      std::get_if<VersionTreeNode::InteriorNodeEntries>(
+                          &node.entries)) {
+                for (const auto& entry : *entries) {
+                  VisitVersionNode(op, entry);
+                }
+              } else {
+                VisitVersions(
+                    op, std::get<VersionTreeNode::LeafNodeEntries>(node.entries));
+              }
+            }),
+        op_ptr->promise,
+        op_ptr->io_handle->GetVersionTreeNode(node_ref.location));
+  }
+
+  static void VisitVersions(const Ptr& op,
+                            span<const BtreeGenerationReference> versions) {
+    for (const auto& version : versions) {
+      if (version.generation_number < op->min_generation_number ||
+          version.root.location.IsMissing()) {
+        continue;
+      }
+      VisitBtreeNode(op, version.root.location);
+    }
+  }
+
+  static void VisitBtreeNode(const Ptr& op,
+                             const IndirectDataReference& location) {
+    if (!op->AddReference(location)) return;
+    auto* op_ptr = op.get();
+    LinkValue(
+        WithExecutor(op_ptr->io_handle->executor,
+                     [op](Promise<DataFileUsage> promise,
+                          ReadyFuture<const std::shared_ptr<const BtreeNode>>
+                              read_future) {
+                       const auto& node = *read_future.value();
+                       if (auto* entries =
+                               std::get_if<BtreeNode::InteriorNodeEntries>(
+                                   &node.entries)) {
+                         for (const auto& entry : *entries) {
+                           VisitBtreeNode(op, entry.node.location);
+                         }
+                         return;
+                       }
+                       for (const auto& entry :
+                            std::get<BtreeNode::LeafNodeEntries>(
+                                node.entries)) {
+                         if (auto* ref = std::get_if<IndirectDataReference>(
+                                 &entry.value_reference)) {
+                           op->AddReference(*ref);
+                         }
+                       }
+                     }),
+        op_ptr->promise, op_ptr->io_handle->GetBtreeNode(location));
+  }
+};
+
+// Size of each data file, keyed by path relative to the database root.
+using DataFileSizes = absl::flat_hash_map<std::string, int64_t>;
+
+// Returns `true` if `key` is the name of a data file generated by
+// `GenerateDataFileId` with one of the configured prefixes.
+bool IsDataFileKey(std::string_view key, const DataFilePrefixes& prefixes) {
+  for (std::string_view prefix :
+       {std::string_view(prefixes.value), std::string_view(prefixes.btree_node),
+        std::string_view(prefixes.version_tree_node)}) {
+    if (key.size() != prefix.size() + kDataFileIdLength ||
+        !absl::StartsWith(key, prefix)) {
+      continue;
+    }
+    auto id = key.substr(prefix.size());
+    if (std::all_of(id.begin(), id.end(), [](char c) {
+          return absl::ascii_isdigit(c) || (c >= 'a' && c <= 'f');
+        })) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Lists the data files of the database.
+Future<DataFileSizes> ListDataFiles(const KvStore& base,
+                                    const DataFilePrefixes& prefixes) {
+  // List the longest common prefix of all data file prefixes.
+  std::string_view common_prefix = prefixes.value;
+  for (std::string_view prefix :
+       {std::string_view(prefixes.btree_node),
+        std::string_view(prefixes.version_tree_node)}) {
+    size_t n = 0;
+    while (n < std::min(prefix.size(), common_prefix.size()) &&
+           prefix[n] == common_prefix[n]) {
+      ++n;
+    }
+    common_prefix = common_prefix.substr(0, n);
+  }
+  kvstore::ListOptions list_options;
+  list_options.range = KeyRange::Prefix(std::string(common_prefix));
+  return MapFutureValue(
+      InlineExecutor{},
+      [prefixes](std::vector<kvstore::ListEntry>& entries) -> DataFileSizes {
+        DataFileSizes sizes;
+        for (auto& entry : entries) {
+          if (!IsDataFileKey(entry.key, prefixes)) continue;
+          sizes.emplace(std::move(entry.key), entry.size);
+        }
+        return sizes;
+      },
+      kvstore::ListFuture(base, std::move(list_options)));
+}
+
+// Invokes `task(i)` for each `i` in `[0, n)`, with at most `concurrency`
+// tasks in progress at once.  The returned future becomes ready when all
+// tasks have completed, or any task fails.
+template <typename Task>
+Future<const void> RunWithConcurrencyLimit(size_t n, size_t concurrency,
+                                           Task task) {
+  struct State : public internal::AtomicReferenceCount<State> {
+    explicit State(Task task) : task(std::move(task)) {}
+
+    Task task;
+    size_t n;
+    std::atomic<size_t> next{0};
+    Promise<void> promise;
+
+    static void StartNext(internal::IntrusivePtr<State> state) {
+      // Tasks which complete synchronously are handled by the loop rather
+      // than by recursion.
+      while (true) {
+        size_t i = state->next++;
+        if (i >= state->n || !state->promise.result_needed()) return;
+        auto future = state->task(i);
+        if (!future.ready()) {
+          future.ExecuteWhenReady(
+              [state = std::move(state)](ReadyFuture<const void> future) {
+                if (!future.status().ok()) {
+                  state->promise.SetResult(future.status());
+                  return;
+                }
+                StartNext(std::move(state));
+              });
+          return;
+        }
+        if (!future.status().ok()) {
+          state->promise.SetResult(future.status());
+          return;
+        }
+      }
+    }
+  };
+  auto [promise, future] = PromiseFuturePair<void>::Make(absl::OkStatus());
+  auto state = internal::MakeIntrusivePtr<State>(std::move(task));
+  state->n = n;
+  state->promise = std::move(promise);
+  for (size_t i = 0; i < std::min(n, std::max(size_t(1), concurrency)); ++i) {
+    State::StartNext(state);
+  }
+  return std::move(future);
+}
+
+// A live value to be rewritten into a new data file.
+struct ValueRewrite {
+  std::string key;
+  IndirectDataReference location;
+  StorageGeneration generation;
+};
+
+// Asynchronous operation state used to implement `CompactDataFiles`.
+//
+// 1. List the data files and compute their usage.
+//
+// 2. Scan the latest version for indirect values stored in data files that
+//    are small or mostly unreferenced.
+//
+// 3. Rewrite those values via the `BtreeWriter`, conditioned on the key not
+//    having been modified concurrently.
+//
+// 4. List the data files and compute their usage again, and delete the data
+//    files which are no longer referenced.
+struct CompactionOperation
+    : public internal::AtomicReferenceCount<CompactionOperation> {
+  using Ptr = internal::IntrusivePtr<CompactionOperation>;
+
+  IoHandle::Ptr io_handle;
+  BtreeWriterPtr btree_writer;
+  KvStore base;
+  DataFilePrefixes data_file_prefixes;
+  CompactionOptions options;
+
+  absl::Mutex mutex;
+  // Data files whose values are to be rewritten.
+  absl::flat_hash_set<std::string> candidate_files ABSL_GUARDED_BY(mutex);
+  std::vector<ValueRewrite> rewrites ABSL_GUARDED_BY(mutex);
+  uint64_t rewrite_bytes ABSL_GUARDED_BY(mutex) = 0;
+  CompactionResult result ABSL_GUARDED_BY(mutex);
+
+  const Executor& executor() const { return io_handle->executor; }
+
+  DataFileUsageOptions usage_options() const {
+    DataFileUsageOptions usage_options;
+    usage_options.keep_versions = options.keep_versions;
+    usage_options.staleness_bound = absl::Now();
+    return usage_options;
+  }
+
+  static void Start(Ptr op, Promise<CompactionResult> promise) {
+    auto* op_ptr = op.get();
+    LinkValue(
+        WithExecutor(op_ptr->executor(),
+                     [op](Promise<CompactionResult> promise,
+                          ReadyFuture<DataFileSizes> files_future) {
+                       // The manifest is read after listing so that every file
+                       // committed before the listing is accounted for.
+                       auto* op_ptr = op.get();
+                       LinkValue(
+                           WithExecutor(
+                               op_ptr->executor(),
+                               [op, files_future](
+                                   Promise<CompactionResult> promise,
+                                   ReadyFuture<DataFileUsage> usage_future) {
+                                 SelectCandidates(std::move(op),
+                                                  std::move(promise),
+                                                  files_future.value(),
+                                                  usage_future.value());
+                               }),
+                           std::move(promise),
+                           GetDataFileUsage(op_ptr->io_handle,
+                                            op_ptr->usage_options()));
+                     }),
+        std::move(promise),
+        ListDataFiles(op_ptr->base, op_ptr->data_file_prefixes));
+  }
+
+  static void SelectCandidates(Ptr op, Promise<CompactionResult> promise,
+                               const DataFileSizes& files,
+                               const DataFileUsage& usage) {
+    bool has_candidates;
+    {
+      absl::MutexLock lock(&op->mutex);
+      for (const auto& [path, size] : files) {
+        if (size <= 0) continue;
+        auto it = usage.find(path);
+        if (it == usage.end()) continue;
+        if (static_cast<uint64_t>(size) < op->options.min_data_file_size ||
+            static_cast<double>(it->second) <
+                op->options.min_live_fraction * static_cast<double>(size)) {
+          op->candidate_files.insert(path);
+        }
+      }
+      ABSL_LOG_IF(INFO, ocdbt_logging)
+          << "Compaction: " << op->candidate_files.size() << "/"
+          << files.size() << " data files selected";
+      has_candidates = !op->candidate_files.empty();
+    }
+    if (!has_candidates) {
+      CollectGarbage(std::move(op), std::move(promise));
+      return;
+    }
+    auto* op_ptr = op.get();
+    LinkValue(WithExecutor(op_ptr->executor(),
+                           [op](Promise<CompactionResult> promise,
+                                ReadyFuture<const ManifestWithTime> future) {
+                             ScanLatestVersion(std::move(op),
+                                               std::move(promise),
+                                               future.value().manifest.get());
+                           }),
+              std::move(promise), op_ptr->io_handle->GetManifest(absl::Now()));
+  }
+
+  // Receives the leaf entries of the latest version.
+  struct ScanReceiver {
+    Ptr op;
+    Promise<void> promise;
+    FutureCallbackRegistration cancel_registration;
+
+    template <typename Cancel>
+    void set_starting(Cancel cancel) {
+      cancel_registration = promise.ExecuteWhenNotNeeded(std::move(cancel));
+    }
+
+    void set_stopping() { cancel_registration.Unregister(); }
+
+    void set_error(absl::Status status) {
+      promise.SetResult(std::move(status));
+    }
+
+    void set_done() {}
+
+    void set_value(std::string_view key_prefix,
+                   span<const LeafNodeEntry> entries) {
+      op->AddRewrites(key_prefix, entries);
+    }
+  };
+
+  void AddRewrites(std::string_view key_prefix,
+                   span<const LeafNodeEntry> entries) {
+    absl::MutexLock lock(&mutex);
+    for (const auto& entry : entries) {
+      auto* location =
+          std::get_if<IndirectDataReference>(&entry.value_reference);
+      if (!location ||
+          !candidate_files.contains(location->file_id.FullPath())) {
+        continue;
+      }
+      if (rewrite_bytes + location->length > options.max_rewrite_bytes) {
+        result.incomplete = true;
+        continue;
+      }
+      rewrite_bytes += location->length;
+      rewrites.push_back(ValueRewrite{
+          tensorstore::StrCat(key_prefix, entry.key), *location,
+          ComputeStorageGeneration(entry.value_reference)});
+    }
+  }
+
+  static void ScanLatestVersion(Ptr op, Promise<CompactionResult> promise,
+                                const Manifest* manifest) {
+    if (!manifest || manifest->latest_version().root.location.IsMissing()) {
+      CollectGarbage(std::move(op), std::move(promise));
+      return;
+    }
+    const auto& latest_version = manifest->latest_version();
+    auto [scan_promise, scan_future] =
+        PromiseFuturePair<void>::Make(absl::OkStatus());
+    NonDistributedListSubtree(op->io_handle, latest_version.root,
+                              latest_version.root_height,
+                              /*subtree_key_prefix=*/{}, KeyRange{},
+                              ScanReceiver{op, std::move(scan_promise)});
+    auto* op_ptr = op.get();
+    LinkValue(WithExecutor(op_ptr->executor(),
+                           [op](Promise<CompactionResult> promise,
+                                ReadyFuture<void> future) {
+                             RewriteValues(std::move(op), std::move(promise));
+                           }),
+              std::move(promise), std::move(scan_future));
+  }
+
+  // Rewrites the value `rewrites[i]`.
+  Future<const void> RewriteValue(size_t i) {
+    ValueRewrite* rewrite;
+    {
+      absl::MutexLock lock(&mutex);
+      rewrite = &rewrites[i];
+    }
+    auto [promise, future] = PromiseFuturePair<void>::Make(absl::OkStatus());
+    LinkValue(
+        [self = Ptr(this), rewrite](
+            Promise<void> promise,
+            ReadyFuture<kvstore::ReadResult> read_future) {
+          auto& read_result = read_future.value();
+          if (!read_result.has_value()) {
+            promise.SetResult(absl::DataLossError(tensorstore::StrCat(
+                "Missing value for ", rewrite->location)));
+            return;
+          }
+          kvstore::WriteOptions write_options;
+          write_options.generation_conditions.if_equal = rewrite->generation;
+          auto write_future = self->btree_writer->Write(
+              rewrite->key, std::move(read_result.value),
+              std::move(write_options));
+          write_future.Force();
+          LinkValue(
+              [self, rewrite](
+                  Promise<void> promise,
+                  ReadyFuture<TimestampedStorageGeneration> write_future) {
+                if (StorageGeneration::IsUnknown(
+                        write_future.value().generation)) {
+                  // The key was modified concurrently; the value it
+                  // referenced is no longer live.
+                  return;
+                }
+                absl::MutexLock lock(&self->mutex);
+                ++self->result.values_rewritten;
+                self->result.bytes_rewritten += rewrite->location.length;
+              },
+              std::move(promise), std::move(write_future));
+        },
+        std::move(promise),
+        io_handle->ReadIndirectData(rewrite->location, {}));
+    return std::move(future);
+  }
+
+  static void RewriteValues(Ptr op, Promise<CompactionResult> promise) {
+    size_t num_rewrites;
+    {
+      absl::MutexLock lock(&op->mutex);
+      num_rewrites = op->rewrites.size();
+    }
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "Compaction: rewriting " << num_rewrites << " values";
+    auto* op_ptr = op.get();
+    LinkValue(
+        WithExecutor(op_ptr->executor(),
+                     [op](Promise<CompactionResult> promise,
+                          ReadyFuture<const void> future) {
+                       CollectGarbage(std::move(op), std::move(promise));
+                     }),
+        std::move(promise),
+        RunWithConcurrencyLimit(
+            num_rewrites, op->options.concurrency,
+            [op](size_t i) { return op->RewriteValue(i); }));
+  }
+
+  static void CollectGarbage(Ptr op, Promise<CompactionResult> promise) {
+    if (!op->options.delete_unreferenced_files) {
+      Finish(std::move(op), std::move(promise));
+      return;
+    }
+    auto* op_ptr = op.get();
+    LinkValue(
+        WithExecutor(op_ptr->executor(),
+                     [op](Promise<CompactionResult> promise,
+                          ReadyFuture<DataFileSizes> files_future) {
+                       auto* op_ptr = op.get();
+                       LinkValue(
+                           WithExecutor(
+                               op_ptr->executor(),
+                               [op, files_future](
+                                   Promise<CompactionResult> promise,
+                                   ReadyFuture<DataFileUsage> usage_future) {
+                                 DeleteUnreferenced(std::move(op),
+                                                    std::move(promise),
+                                                    files_future.value(),
+                                                    usage_future.value());
+                               }),
+                           std::move(promise),
+                           GetDataFileUsage(op_ptr->io_handle,
+                                            op_ptr->usage_options()));
+                     }),
+        std::move(promise),
+        ListDataFiles(op_ptr->base, op_ptr->data_file_prefixes));
+  }
+
+  static void DeleteUnreferenced(Ptr op, Promise<CompactionResult> promise,
+                                 const DataFileSizes& files,
+                                 const DataFileUsage& usage) {
+    auto unreferenced = std::make_shared<std::vector<std::string>>();
+    uint64_t bytes = 0;
+    for (const auto& [path, size] : files) {
+      if (usage.contains(path)) continue;
+      unreferenced->push_back(path);
+      bytes += std::max(int64_t{0}, size);
+    }
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "Compaction: deleting " << unreferenced->size() << "/"
+        << files.size() << " data files";
+    auto* op_ptr = op.get();
+    LinkValue(
+        WithExecutor(op_ptr->executor(),
+                     [op, num_files = unreferenced->size(), bytes](
+                         Promise<CompactionResult> promise,
+                         ReadyFuture<const void> future) {
+                       {
+                         absl::MutexLock lock(&op->mutex);
+                         op->result.files_deleted += num_files;
+                         op->result.bytes_deleted += bytes;
+                       }
+                       Finish(std::move(op), std::move(promise));
+                     }),
+        std::move(promise),
+        RunWithConcurrencyLimit(
+            unreferenced->size(), op->options.concurrency,
+            [base = op->base, unreferenced](size_t i) -> Future<const void> {
+              return PromiseFuturePair<void>::LinkError(
+                         absl::OkStatus(),
+                         kvstore::Delete(base, (*unreferenced)[i]))
+                  .future;
+            }));
+  }
+
+  static void Finish(Ptr op, Promise<CompactionResult> promise) {
+    absl::MutexLock lock(&op->mutex);
+    promise.SetResult(op->result);
+  }
+};
+
+}  // namespace
+
+Future<DataFileUsage> GetDataFileUsage(ReadonlyIoHandle::Ptr io_handle,
+                                       const DataFileUsageOptions& options) {
+  auto [promise, future] = PromiseFuturePair<DataFileUsage>::Make();
+  auto op = internal::MakeIntrusivePtr<DataFileUsageOperation>();
+  op->io_handle = std::move(io_handle);
+  op->keep_versions = options.keep_versions;
+  op->promise = promise;
+  auto* op_ptr = op.get();
+  LinkValue(WithExecutor(op_ptr->io_handle->executor,
+                         [op = std::move(op)](
+                             Promise<DataFileUsage> promise,
+                             ReadyFuture<const ManifestWithTime> future) {
+                           DataFileUsageOperation::ManifestReady(
+                               std::move(op), std::move(future));
+                         }),
+            std::move(promise),
+            op_ptr->io_handle->GetManifest(options.staleness_bound));
+  return std::move(future);
+}
+
+Future<CompactionResult> CompactDataFiles(
+    IoHandle::Ptr io_handle, BtreeWriterPtr btree_writer, KvStore base,
+    const DataFilePrefixes& data_file_prefixes, CompactionOptions options) {
+  auto [promise, future] = PromiseFuturePair<CompactionResult>::Make();
+  auto op = internal::MakeIntrusivePtr<CompactionOperation>();
+  op->io_handle = std::move(io_handle);
+  op->btree_writer = std::move(btree_writer);
+  op->base = std::move(base);
+  op->data_file_prefixes = data_file_prefixes;
+  op->options = std::move(options);
+  CompactionOperation::Start(std::move(op), std::move(promise));
+  return std::move(future);
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
@@ -0,0 +1,129 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_COMPACTION_H_
+#define TENSORSTORE_KVSTORE_OCDBT_COMPACTION_H_
+
+/// \file
+///
+/// Compaction and garbage collection of OCDBT data files.
+///
+/// Values, B+tree nodes, and version tree nodes are appended to immutable data
+/// files which are never modified.  Values which are overwritten or deleted
+/// continue to occupy space in their data file, and a database with many
+/// small commits spreads its values across many small files.
+///
+/// Compaction rewrites the live values of fragmented data files through the
+/// normal `BtreeWriter` commit path, which packs them into new data files, and
+/// then deletes data files which are no longer referenced by any retained
+/// version.
+///
+/// Garbage collection must not run concurrently with writers in other
+/// processes: a data file written by a commit which has not yet updated the
+/// manifest is indistinguishable from an unreferenced data file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/btree_writer.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io/io_handle_impl.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Number of bytes of each data file that are referenced by the database,
+/// keyed by the path of the data file relative to the database root.
+using DataFileUsage = absl::flat_hash_map<std::string, uint64_t>;
+
+struct DataFileUsageOptions {
+  /// Number of most recent versions whose B+tree nodes and values are
+  /// considered live.  If not specified, every version reachable from the
+  /// manifest is live.  Version tree nodes are always live.
+  std::optional<GenerationNumber> keep_versions;
+
+  /// Staleness bound for reading the manifest.
+  absl::Time staleness_bound = absl::Now();
+};
+
+/// Computes the number of referenced bytes of every data file reachable from
+/// the manifest.
+///
+/// Each distinct B+tree node, version tree node, and indirect value is
+/// counted once, even if it is shared by multiple versions.
+Future<DataFileUsage> GetDataFileUsage(ReadonlyIoHandle::Ptr io_handle,
+                                       const DataFileUsageOptions& options);
+
+struct CompactionOptions {
+  /// Specifies which versions are retained.  Data files referenced only by
+  /// older versions are deleted, making those versions unreadable.
+  std::optional<GenerationNumber> keep_versions;
+
+  /// Data files in which fewer than this fraction of bytes are referenced
+  /// are compacted.
+  double min_live_fraction = 0.5;
+
+  /// Data files smaller than this are compacted.
+  uint64_t min_data_file_size = 0;
+
+  /// Maximum total size of the values rewritten by a single call.  Further
+  /// candidates are left for subsequent calls, which allows compaction to
+  /// proceed incrementally.
+  uint64_t max_rewrite_bytes = uint64_t{1} << 30;
+
+  /// Maximum number of concurrent value rewrites or file deletions.
+  size_t concurrency = 32;
+
+  /// Delete data files which are unreferenced after compaction.
+  bool delete_unreferenced_files = true;
+};
+
+struct CompactionResult {
+  /// Number and total size of values rewritten into new data files.
+  size_t values_rewritten = 0;
+  uint64_t bytes_rewritten = 0;
+
+  /// Number and total size of unreferenced data files deleted.
+  size_t files_deleted = 0;
+  uint64_t bytes_deleted = 0;
+
+  /// Indicates that `max_rewrite_bytes` prevented some candidate values from
+  /// being rewritten.
+  bool incomplete = false;
+};
+
+/// Compacts the data files of the database accessed by `io_handle`.
+///
+/// \param io_handle I/O handle for the database.
+/// \param btree_writer Writer used to commit the rewritten values.
+/// \param base Root of the database, relative to which data file paths are
+///     resolved.
+/// \param data_file_prefixes Prefixes of the data files to consider.
+/// \param options Compaction options.
+Future<CompactionResult> CompactDataFiles(
+    IoHandle::Ptr io_handle, BtreeWriterPtr btree_writer, KvStore base,
+    const DataFilePrefixes& data_file_prefixes, CompactionOptions options);
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_COMPACTION_H_
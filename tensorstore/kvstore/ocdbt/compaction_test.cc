@@ -0,0 +1,131 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/compaction.h"
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/driver.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+using ::tensorstore::KeyRange;
+using ::tensorstore::KvStore;
+using ::tensorstore::MatchesKvsReadResult;
+using ::tensorstore::internal_ocdbt::CompactDataFiles;
+using ::tensorstore::internal_ocdbt::CompactionOptions;
+using ::tensorstore::internal_ocdbt::DataFileUsageOptions;
+using ::tensorstore::internal_ocdbt::GetDataFileUsage;
+using ::tensorstore::internal_ocdbt::OcdbtDriver;
+
+// Writes each key in a separate commit, and then overwrites some of them, so
+// that the data files contain both live and superseded values.
+KvStore OpenFragmentedStore() {
+  auto store = kvstore::Open({{"driver", "ocdbt"},
+                              {"base", "memory://"},
+                              {"config", {{"max_inline_value_bytes", 0}}}})
+                   .value();
+  for (std::string key : {"a", "b", "c"}) {
+    TENSORSTORE_CHECK_OK(
+        kvstore::Write(store, key, absl::Cord("old_" + key)).result());
+  }
+  for (std::string key : {"a", "b"}) {
+    TENSORSTORE_CHECK_OK(
+        kvstore::Write(store, key, absl::Cord("new_" + key)).result());
+  }
+  return store;
+}
+
+TEST(CompactionTest, KeepLatestVersion) {
+  auto store = OpenFragmentedStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+
+  CompactionOptions options;
+  options.keep_versions = 1;
+  options.min_live_fraction = 1;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      CompactDataFiles(driver.io_handle_, driver.btree_writer_, driver.base_,
+                       driver.data_file_prefixes_, options)
+          .result());
+  EXPECT_FALSE(result.incomplete);
+  EXPECT_GT(result.files_deleted, 0);
+
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("new_a")));
+  EXPECT_THAT(kvstore::Read(store, "b").result(),
+              MatchesKvsReadResult(absl::Cord("new_b")));
+  EXPECT_THAT(kvstore::Read(store, "c").result(),
+              MatchesKvsReadResult(absl::Cord("old_c")));
+
+  // Every remaining data file is referenced by the latest version.
+  DataFileUsageOptions usage_options;
+  usage_options.keep_versions = 1;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto usage, GetDataFileUsage(driver.io_handle_, usage_options).result());
+  kvstore::ListOptions list_options;
+  list_options.range = KeyRange::Prefix("d/");
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto files, kvstore::ListFuture(driver.base_, list_options).result());
+  EXPECT_FALSE(files.empty());
+  for (const auto& file : files) {
+    EXPECT_TRUE(usage.contains(file.key)) << file.key;
+  }
+}
+
+TEST(CompactionTest, KeepAllVersions) {
+  auto store = OpenFragmentedStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+
+  // Every data file is referenced by some version, so none are deleted.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      CompactDataFiles(driver.io_handle_, driver.btree_writer_, driver.base_,
+                       driver.data_file_prefixes_, CompactionOptions{})
+          .result());
+  EXPECT_EQ(0, result.files_deleted);
+  EXPECT_THAT(kvstore::Read(store, "c").result(),
+              MatchesKvsReadResult(absl::Cord("old_c")));
+}
+
+TEST(CompactionTest, MaxRewriteBytes) {
+  auto store = OpenFragmentedStore();
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+
+  CompactionOptions options;
+  options.keep_versions = 1;
+  options.min_live_fraction = 1;
+  options.max_rewrite_bytes = 0;
+  options.delete_unreferenced_files = false;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      CompactDataFiles(driver.io_handle_, driver.btree_writer_, driver.base_,
+                       driver.data_file_prefixes_, options)
+          .result());
+  EXPECT_TRUE(result.incomplete);
+  EXPECT_EQ(0, result.values_rewritten);
+  EXPECT_EQ(0, result.files_deleted);
+}
+
+}  // namespace
@@ -24,6 +24,7 @@
 #include "absl/synchronization/mutex.h"
 #include <nlohmann/json.hpp>
 #include "riegeli/zstd/zstd_writer.h"
+#include "tensorstore/internal/compression/lz4.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/enum.h"
@@ -52,8 +53,16 @@ constexpr auto ZstdCompressionJsonBinder = jb::Object(
             jb::DefaultInitializedValue(jb::Integer<int32_t>(
                 riegeli::ZstdWriterBase::Options::kMinCompressionLevel,
                 riegeli::ZstdWriterBase::Options::kMaxCompressionLevel)))));
+constexpr auto Lz4CompressionJsonBinder = jb::Object(
+    jb::Member("id", jb::Constant([] { return "lz4"; })),
+    jb::Member("level",
+               jb::Projection<&Config::Lz4Compression::level>(
+                   jb::DefaultInitializedValue(jb::Integer<int32_t>(
+                       lz4::Options::kMinCompressionLevel,
+                       lz4::Options::kMaxCompressionLevel)))));
 constexpr auto ConfigCompressionJsonBinder =
-    jb::Variant(NoCompressionJsonBinder, ZstdCompressionJsonBinder);
+    jb::Variant(NoCompressionJsonBinder, ZstdCompressionJsonBinder,
+                Lz4CompressionJsonBinder);
 
 constexpr auto ManifestKindJsonBinder = [](auto is_loading, const auto& options,
                                            auto* obj, auto* j) {
@@ -0,0 +1,160 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/non_distributed/diff_versions.h"
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/driver.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/create_new_manifest.h"
+#include "tensorstore/kvstore/ocdbt/test_util.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+using ::tensorstore::KeyRange;
+using ::tensorstore::internal_ocdbt::BtreeDiffEntry;
+using ::tensorstore::internal_ocdbt::BtreeGenerationReference;
+using ::tensorstore::internal_ocdbt::DiffVersionsFuture;
+using ::tensorstore::internal_ocdbt::EnsureExistingManifest;
+using ::tensorstore::internal_ocdbt::GetOcdbtIoHandle;
+using ::tensorstore::internal_ocdbt::OcdbtDriver;
+using ::tensorstore::internal_ocdbt::ReadManifest;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::Optional;
+using ::testing::VariantWith;
+
+std::string Key(int i) { return absl::StrFormat("key%04d", i); }
+
+BtreeGenerationReference GetLatestVersion(const kvstore::KvStore& store) {
+  auto manifest =
+      ReadManifest(static_cast<OcdbtDriver&>(*store.driver)).value();
+  return manifest->latest_version();
+}
+
+std::vector<std::string> GetKeys(const std::vector<BtreeDiffEntry>& diffs) {
+  std::vector<std::string> keys;
+  for (const auto& diff : diffs) keys.push_back(diff.key);
+  return keys;
+}
+
+class DiffVersionsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Use small nodes to obtain a tree with several levels.
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        store, kvstore::Open({{"driver", "ocdbt"},
+                              {"base", "memory://"},
+                              {"config", {{"max_decoded_node_bytes", 256}}}})
+                   .result());
+    TENSORSTORE_ASSERT_OK(
+        EnsureExistingManifest(GetOcdbtIoHandle(*store.driver)));
+    empty_version = GetLatestVersion(store);
+    std::vector<tensorstore::Future<const void>> futures;
+    for (int i = 0; i < 200; ++i) {
+      futures.push_back(kvstore::Write(store, Key(i),
+                                       absl::Cord(tensorstore::StrCat(i))));
+    }
+    for (auto& future : futures) {
+      TENSORSTORE_ASSERT_OK(future.status());
+    }
+    from_version = GetLatestVersion(store);
+  }
+
+  kvstore::KvStore store;
+  BtreeGenerationReference empty_version;
+  BtreeGenerationReference from_version;
+};
+
+TEST_F(DiffVersionsTest, Basic) {
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, Key(10), absl::Cord("x")));
+  // Rewriting the same inline value is not a difference.
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, Key(20), absl::Cord("20")));
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, Key(50)));
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, Key(100) + "a", absl::Cord("y")));
+  auto to_version = GetLatestVersion(store);
+  auto io_handle = GetOcdbtIoHandle(*store.driver);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto diffs, DiffVersionsFuture(io_handle, from_version, to_version)
+                      .result());
+  EXPECT_THAT(GetKeys(diffs), ElementsAre(Key(10), Key(50), Key(100) + "a"));
+  EXPECT_THAT(diffs[0].from_value,
+              Optional(VariantWith<absl::Cord>(absl::Cord("10"))));
+  EXPECT_THAT(diffs[0].to_value,
+              Optional(VariantWith<absl::Cord>(absl::Cord("x"))));
+  EXPECT_THAT(diffs[1].from_value,
+              Optional(VariantWith<absl::Cord>(absl::Cord("50"))));
+  EXPECT_EQ(std::nullopt, diffs[1].to_value);
+  EXPECT_EQ(std::nullopt, diffs[2].from_value);
+  EXPECT_THAT(diffs[2].to_value,
+              Optional(VariantWith<absl::Cord>(absl::Cord("y"))));
+
+  // Reverse direction.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto reverse_diffs,
+      DiffVersionsFuture(io_handle, to_version, from_version).result());
+  ASSERT_EQ(diffs.size(), reverse_diffs.size());
+  for (size_t i = 0; i < diffs.size(); ++i) {
+    EXPECT_EQ(diffs[i].key, reverse_diffs[i].key);
+    EXPECT_EQ(diffs[i].from_value, reverse_diffs[i].to_value);
+    EXPECT_EQ(diffs[i].to_value, reverse_diffs[i].from_value);
+  }
+
+  // Restricted key range.
+  EXPECT_THAT(
+      DiffVersionsFuture(io_handle, from_version, to_version,
+                         KeyRange(Key(40), Key(60)))
+          .result(),
+      Optional(ElementsAre(Field(&BtreeDiffEntry::key, Key(50)))));
+
+  // Identical versions.
+  EXPECT_THAT(
+      DiffVersionsFuture(io_handle, to_version, to_version).result(),
+      Optional(ElementsAre()));
+}
+
+TEST_F(DiffVersionsTest, FromEmpty) {
+  auto io_handle = GetOcdbtIoHandle(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto diffs,
+      DiffVersionsFuture(io_handle, empty_version, from_version).result());
+  ASSERT_EQ(200, diffs.size());
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(Key(i), diffs[i].key);
+    EXPECT_EQ(std::nullopt, diffs[i].from_value);
+    EXPECT_THAT(
+        diffs[i].to_value,
+        Optional(VariantWith<absl::Cord>(absl::Cord(tensorstore::StrCat(i)))));
+  }
+}
+
+}  // namespace
@@ -14,6 +14,8 @@
 
 #include "tensorstore/kvstore/ocdbt/distributed/btree_node_write_mutation.h"
 
+#include <stddef.h>
+
 #include <algorithm>
 #include <cassert>
 #include <limits>
@@ -242,6 +244,27 @@ absl::Status BtreeInteriorNodeWriteMutation::EncodeTo(
       writer, BtreeInteriorNodeWriteMutationCodec{}(writer, *this));
 }
 
+size_t BtreeLeafNodeWriteMutation::EstimateSize() const {
+  size_t size = key.size() + existing_generation.value.size();
+  if (mode == kAddNew) {
+    LeafNodeEntry entry;
+    entry.value_reference = new_entry.value_reference;
+    size += GetLeafNodeDataSize(entry);
+  }
+  return size;
+}
+
+size_t BtreeInteriorNodeWriteMutation::EstimateSize() const {
+  size_t size = existing_range.inclusive_min.size() +
+                existing_range.exclusive_max.size() +
+                existing_generation.value.size();
+  for (const auto& entry : new_entries) {
+    size += entry.key.size() + kInteriorNodeFixedSize +
+            entry.node.location.file_id.size();
+  }
+  return size;
+}
+
 bool AddNewEntries(BtreeNodeEncoder<LeafNodeEntry>& encoder,
                    const BtreeLeafNodeWriteMutation& mutation) {
   assert(mutation.mode != BtreeNodeWriteMutation::kRetainExisting);
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_BTREE_NODE_WRITE_MUTATION_H_
 #define TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_BTREE_NODE_WRITE_MUTATION_H_
 
+#include <stddef.h>
+
 #include <optional>
 #include <string>
 #include <string_view>
@@ -38,6 +40,10 @@ struct BtreeNodeWriteMutation
   using Ptr = internal::IntrusivePtr<const BtreeNodeWriteMutation>;
   virtual absl::Status EncodeTo(riegeli::Writer&& writer) const = 0;
 
+  // Returns the approximate in-memory size in bytes, used to bound the size of
+  // mutation batches.
+  virtual size_t EstimateSize() const = 0;
+
   enum Mode : uint8_t {
     // Retain existing value.  This mutation merely checks that the
     // `existing_generation` matches.
@@ -68,6 +74,7 @@ struct BtreeLeafNodeWriteMutation : public BtreeNodeWriteMutation {
 
   absl::Status DecodeFrom(riegeli::Reader& reader);
   absl::Status EncodeTo(riegeli::Writer&& writer) const override;
+  size_t EstimateSize() const override;
 };
 
 struct BtreeInteriorNodeWriteMutation : public BtreeNodeWriteMutation {
@@ -85,6 +92,7 @@ struct BtreeInteriorNodeWriteMutation : public BtreeNodeWriteMutation {
 
   absl::Status DecodeFrom(riegeli::Reader& reader);
   absl::Status EncodeTo(riegeli::Writer&& writer) const override;
+  size_t EstimateSize() const override;
 };
 
 // Adds all new entries specified by `mutation` to `encoder`.
@@ -43,7 +43,8 @@
 //
 // 1. [Buffering requests] Write requests are buffered as "pending" requests.
 //    As soon as there is at least one pending write operation, a commit is
-//    initiated.  See `DistributedBtreeWriter::Write` and
+//    initiated, after waiting for the optional mutation batching window to
+//    elapse.  See `DistributedBtreeWriter::Write` and
 //    `WriterCommitOperation::MaybeStart`.
 //
 // 2. [Submitting requests to appropriate cooperator] The buffered requests are
@@ -102,7 +103,9 @@
 //     both locally-originating and remote-originating requests are buffered as
 //     "pending" requests.  Once there is at least one buffered request for a
 //     given node, a commit of the updates to that node is initiated, if one is
-//     not already in progress.
+//     not already in progress, again after the optional mutation batching
+//     window.  Batching merges mutations from many writers to the same node
+//     into a single node rewrite.
 //
 // 4b. [Starting the commit] To start committing updates to a node, the
 //     cooperator first reads the existing node, by following the path from the
@@ -132,6 +135,12 @@
 //
 // 4f. [Sending responses] Once the parent has indicated success, the staged
 //     requests are completed.
+//
+// If manifest notifications are enabled, the cooperator additionally notifies
+// the coordinator of each new manifest it writes in step 4e, and every process
+// long-polls the coordinator for such notifications in order to refresh its
+// cached manifest immediately, rather than readers having to re-read the
+// manifest from storage.  See `manifest_watcher.h`.
 
 #include "tensorstore/kvstore/ocdbt/distributed/btree_writer.h"
 
@@ -154,17 +163,22 @@
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include <blake3.h>
+#include "grpcpp/create_channel.h"  // third_party
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/mutex.h"
+#include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/ocdbt/btree_writer.h"
 #include "tensorstore/kvstore/ocdbt/distributed/btree_node_identifier.h"
 #include "tensorstore/kvstore/ocdbt/distributed/btree_node_write_mutation.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/manifest_watcher.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
 #include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
@@ -197,6 +211,10 @@ struct PendingDistributedRequests {
   };
   std::vector<WriteRequest> write_requests;
   bool needs_inline_value_pass = false;
+  // Estimated total size of `write_requests`, and the time at which the oldest
+  // request was made.  Used for mutation batching.
+  size_t num_bytes = 0;
+  absl::Time oldest_request_time = absl::InfiniteFuture();
 };
 
 struct StagedDistributedRequests {
@@ -226,6 +244,18 @@ class DistributedBtreeWriter : public BtreeWriter {
   // have not yet been staged.
   bool commit_in_progress_ = false;
 
+  // Set to `true` to indicate that a commit is scheduled at the end of the
+  // mutation batching window.
+  bool batch_window_open_ = false;
+
+  // Maximum manifest staleness bound requested while the batching window is
+  // open.
+  absl::Time batch_staleness_bound_ = absl::InfinitePast();
+
+  // Mutation batching parameters, see `DistributedBtreeWriterOptions`.
+  absl::Duration mutation_batch_window_;
+  size_t mutation_batch_bytes_;
+
   // Address of the coordinator server.
   std::string coordinator_address_;
 
@@ -243,6 +273,14 @@ class DistributedBtreeWriter : public BtreeWriter {
   // coordinator server.  Currently defined as SHA256 hash of the base kvstore
   // JSON spec.
   std::string storage_identifier_;
+
+  // Whether to send and watch for manifest notifications, see
+  // `DistributedBtreeWriterOptions`.
+  bool manifest_notifications_;
+
+  // Watches for manifests written by other processes.  Null unless
+  // `manifest_notifications_` is `true`.
+  internal_ocdbt_cooperator::ManifestWatcher manifest_watcher_;
 };
 
 struct WriterCommitOperation
@@ -364,10 +402,40 @@ void WriterCommitOperation::MaybeStart(DistributedBtreeWriter& writer,
                                        absl::Time manifest_staleness_bound,
                                        UniqueWriterLock<absl::Mutex> lock) {
   if (writer.commit_in_progress_) return;
-  // FIXME: maybe have a delay
+  auto& pending = writer.pending_;
+  if (writer.mutation_batch_window_ > absl::ZeroDuration() &&
+      (writer.mutation_batch_bytes_ == 0 ||
+       pending.num_bytes < writer.mutation_batch_bytes_)) {
+    // Wait for the batching window, measured from the oldest pending request,
+    // to elapse, so that more writes to the same B+tree nodes are submitted
+    // together.
+    const absl::Time deadline =
+        pending.oldest_request_time + writer.mutation_batch_window_;
+    if (absl::Now() < deadline) {
+      writer.batch_staleness_bound_ =
+          std::max(writer.batch_staleness_bound_, manifest_staleness_bound);
+      if (writer.batch_window_open_) return;
+      writer.batch_window_open_ = true;
+      lock.unlock();
+      ScheduleAt(deadline, [writer = internal::IntrusivePtr<
+                                DistributedBtreeWriter>(&writer)] {
+        UniqueWriterLock lock{writer->mutex_};
+        if (!writer->batch_window_open_ || writer->commit_in_progress_) return;
+        // Batching window has elapsed.
+        writer->pending_.oldest_request_time = absl::InfinitePast();
+        MaybeStart(*writer, absl::InfinitePast(), std::move(lock));
+      });
+      return;
+    }
+  }
+  manifest_staleness_bound =
+      std::max(manifest_staleness_bound, writer.batch_staleness_bound_);
+  writer.batch_window_open_ = false;
+  writer.batch_staleness_bound_ = absl::InfinitePast();
 
   // Start commit
-  ABSL_LOG_IF(INFO, ocdbt_logging) << "Starting commit";
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "Starting commit: pending_bytes=" << pending.num_bytes;
   writer.commit_in_progress_ = true;
   lock.unlock();
 
@@ -392,6 +460,9 @@ void WriterCommitOperation::StartCommit(DistributedBtreeWriter& writer,
     cooperator_options.security = writer.security_;
     cooperator_options.lease_duration = writer.lease_duration_;
     cooperator_options.storage_identifier = writer.storage_identifier_;
+    cooperator_options.mutation_batch_window = writer.mutation_batch_window_;
+    cooperator_options.mutation_batch_bytes = writer.mutation_batch_bytes_;
+    cooperator_options.manifest_notifications = writer.manifest_notifications_;
     TENSORSTORE_ASSIGN_OR_RETURN(
         writer.cooperator_,
         internal_ocdbt_cooperator::Start(std::move(cooperator_options)),
@@ -702,6 +773,8 @@ void WriterCommitOperation::SubmitRequests(
         auto& pending = writer->pending_.write_requests;
         pending.insert(pending.end(), write_requests.begin(),
                        write_requests.end());
+        // Retried requests are not subject to the batching window.
+        writer->pending_.oldest_request_time = absl::InfinitePast();
         auto new_staleness_bound =
             existing_manifest_time + absl::Nanoseconds(1);
         MaybeStart(*writer, new_staleness_bound, std::move(lock));
@@ -743,8 +816,13 @@ Future<TimestampedStorageGeneration> DistributedBtreeWriter::Write(
           value_ref.emplace<IndirectDataReference>());
     }
   }
+  const size_t request_bytes = request.mutation->EstimateSize();
   UniqueWriterLock lock{writer.mutex_};
   writer.pending_.write_requests.emplace_back(std::move(request));
+  writer.pending_.num_bytes += request_bytes;
+  if (writer.pending_.write_requests.size() == 1) {
+    writer.pending_.oldest_request_time = absl::Now();
+  }
   if (needs_inline_value_pass) {
     writer.pending_.needs_inline_value_pass = true;
   }
@@ -789,6 +867,21 @@ BtreeWriterPtr MakeDistributedBtreeWriter(
   assert(writer->security_);
   writer->lease_duration_ = options.lease_duration;
   writer->storage_identifier_ = std::move(options.storage_identifier);
+  writer->mutation_batch_window_ = options.mutation_batch_window;
+  writer->mutation_batch_bytes_ = options.mutation_batch_bytes;
+  writer->manifest_notifications_ = options.manifest_notifications;
+  if (writer->manifest_notifications_) {
+    internal_ocdbt_cooperator::ManifestWatcher::Options watcher_options;
+    watcher_options.coordinator_stub =
+        grpc_gen::Coordinator::NewStub(grpc::CreateChannel(
+            writer->coordinator_address_,
+            writer->security_->GetClientCredentials()));
+    watcher_options.io_handle = writer->io_handle_;
+    watcher_options.key =
+        BtreeNodeIdentifier::Root().GetKey(writer->storage_identifier_);
+    writer->manifest_watcher_ = internal_ocdbt_cooperator::ManifestWatcher(
+        std::move(watcher_options));
+  }
   return writer;
 }
 
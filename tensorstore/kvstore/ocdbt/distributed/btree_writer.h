@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_BTREE_WRITER_H_
 #define TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_BTREE_WRITER_H_
 
+#include <stddef.h>
+
 #include <string>
 
 #include "absl/time/time.h"
@@ -34,6 +36,21 @@ struct DistributedBtreeWriterOptions {
 
   // Unique identifier of base kvstore, e.g. base kvstore JSON spec.
   std::string storage_identifier;
+
+  // Maximum time that writes are accumulated before submitting them to the
+  // lease owners, and before a lease owner commits the mutations it receives.
+  // Zero disables batching.
+  absl::Duration mutation_batch_window = absl::ZeroDuration();
+
+  // Submit/commit as soon as at least this many bytes of mutations are
+  // pending, regardless of `mutation_batch_window`.  Zero means no limit.
+  size_t mutation_batch_bytes = 0;
+
+  // Notify the coordinator of each new manifest written, and refresh the
+  // cached manifest as soon as the coordinator reports a manifest written by
+  // another process.  This allows reads to use a large staleness bound
+  // without missing writes made through the same coordinator.
+  bool manifest_notifications = false;
 };
 
 BtreeWriterPtr MakeDistributedBtreeWriter(
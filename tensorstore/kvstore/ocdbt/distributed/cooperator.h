@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_COOPERATOR_H_
 #define TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_COOPERATOR_H_
 
+#include <stddef.h>
+
 #include <functional>
 #include <string>
 #include <vector>
@@ -83,6 +85,16 @@ struct Options {
   // Unique identifier of base kvstore.  Currently defined as SHA256 hash of
   // the base kvstore JSON spec.
   std::string storage_identifier;
+  // Maximum time that mutations to a B+tree node owned by this cooperator are
+  // accumulated before being committed, so that mutations from many clients
+  // are merged into a single node rewrite.  Zero disables batching.
+  absl::Duration mutation_batch_window = absl::ZeroDuration();
+  // Commit as soon as at least this many bytes of mutations are pending,
+  // regardless of `mutation_batch_window`.  Zero means no limit.
+  size_t mutation_batch_bytes = 0;
+  // Notify the coordinator of each new manifest committed by this cooperator,
+  // for processes using `ManifestWatcher`.
+  bool manifest_notifications = false;
 };
 
 struct Cooperator;
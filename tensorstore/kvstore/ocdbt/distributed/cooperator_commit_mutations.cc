@@ -17,9 +17,15 @@
 
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/grpc/utils.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/kvstore/ocdbt/distributed/btree_node_identifier.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator_impl.h"
+#include "tensorstore/kvstore/ocdbt/distributed/manifest_watcher.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/create_new_manifest.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/storage_generation.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/write_nodes.h"
@@ -29,6 +35,11 @@ namespace tensorstore {
 namespace internal_ocdbt_cooperator {
 namespace {
 ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+auto& mutation_batch_window_commits = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/ocdbt/cooperator_batch_window_commits",
+    "OCDBT cooperator node commits started at the end of a mutation batching "
+    "window");
 }
 
 using NodeMutationRequests = Cooperator::NodeMutationRequests;
@@ -801,6 +812,13 @@ void NodeCommitOperation::WriteNewManifest(NodeCommitOperation::Ptr commit_op) {
           RetryCommit(std::move(commit_op));
           return;
         }
+        auto& server = *commit_op->server;
+        if (server.manifest_notifications_) {
+          NotifyManifest(
+              server.coordinator_stub_,
+              BtreeNodeIdentifier::Root().GetKey(server.storage_identifier_),
+              commit_op->new_manifest->latest_generation());
+        }
         commit_op->SetSuccess(commit_op->new_manifest->latest_generation(),
                               r->time);
       });
@@ -812,7 +830,28 @@ void NodeCommitOperation::RetryCommit(NodeCommitOperation::Ptr commit_op) {
   StartCommit(std::move(commit_op), new_staleness_bound);
 }
 
-// Starts a commit operation if one is not already in progress.
+namespace {
+// Starts a commit of the pending requests in `mutation_requests`.
+//
+// Precondition: no commit is in progress.
+void StartNodeCommit(
+    Cooperator& server,
+    internal::IntrusivePtr<NodeMutationRequests> mutation_requests,
+    UniqueWriterLock<absl::Mutex>&& lock) {
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "[Port=" << server.listening_port_
+      << "] StartNodeCommit: pending_bytes="
+      << mutation_requests->pending.num_bytes;
+  mutation_requests->commit_in_progress = true;
+  lock.unlock();
+  auto commit_op = internal::MakeIntrusivePtr<NodeCommitOperation>();
+  commit_op->server.reset(&server);
+  commit_op->mutation_requests = std::move(mutation_requests);
+  NodeCommitOperation::StartCommit(
+      std::move(commit_op), /*manifest_staleness_bound=*/absl::InfinitePast());
+}
+}  // namespace
+
 void MaybeCommit(Cooperator& server,
                  internal::IntrusivePtr<NodeMutationRequests> mutation_requests,
                  UniqueWriterLock<absl::Mutex>&& lock) {
@@ -832,13 +871,34 @@ void MaybeCommit(Cooperator& server,
     lock = UniqueWriterLock{mutation_requests->mutex};
   }
   if (mutation_requests->commit_in_progress) return;
-  mutation_requests->commit_in_progress = true;
-  lock.unlock();
-  auto commit_op = internal::MakeIntrusivePtr<NodeCommitOperation>();
-  commit_op->server.reset(&server);
-  commit_op->mutation_requests = std::move(mutation_requests);
-  NodeCommitOperation::StartCommit(
-      std::move(commit_op), /*manifest_staleness_bound=*/absl::InfinitePast());
+  auto& pending = mutation_requests->pending;
+  if (server.mutation_batch_window_ > absl::ZeroDuration() &&
+      (server.mutation_batch_bytes_ == 0 ||
+       pending.num_bytes < server.mutation_batch_bytes_)) {
+    // Wait for the batching window, measured from the oldest pending request,
+    // to elapse, in order to merge additional mutations into the same node
+    // rewrite.  Requests that accumulated during a previous commit are
+    // typically already past the window.
+    const absl::Time deadline =
+        pending.oldest_request_time + server.mutation_batch_window_;
+    if (absl::Now() < deadline) {
+      if (mutation_requests->batch_window_open) return;
+      mutation_requests->batch_window_open = true;
+      lock.unlock();
+      ScheduleAt(deadline, [server = CooperatorPtr(&server),
+                            mutation_requests =
+                                std::move(mutation_requests)]() mutable {
+        UniqueWriterLock lock{mutation_requests->mutex};
+        if (!mutation_requests->batch_window_open) return;
+        mutation_requests->batch_window_open = false;
+        mutation_batch_window_commits.Increment();
+        StartNodeCommit(*server, std::move(mutation_requests), std::move(lock));
+      });
+      return;
+    }
+  }
+  mutation_requests->batch_window_open = false;
+  StartNodeCommit(server, std::move(mutation_requests), std::move(lock));
 }
 
 }  // namespace internal_ocdbt_cooperator
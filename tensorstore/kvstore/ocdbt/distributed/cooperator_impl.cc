@@ -71,9 +71,14 @@ void PendingRequests::Append(PendingRequests&& other) {
     latest_manifest_time =
         std::max(latest_manifest_time, other.latest_manifest_time);
   }
+  num_bytes += other.num_bytes;
+  oldest_request_time =
+      std::min(oldest_request_time, other.oldest_request_time);
   other.latest_root_generation = 0;
   other.node_generation_at_latest_root_generation.value.clear();
   other.latest_manifest_time = absl::InfinitePast();
+  other.num_bytes = 0;
+  other.oldest_request_time = absl::InfiniteFuture();
 }
 
 Cooperator::~Cooperator() {
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_COOPERATOR_IMPL_H_
 #define TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_COOPERATOR_IMPL_H_
 
+#include <stddef.h>
+
 #include <atomic>
 #include <memory>
 #include <string>
@@ -38,6 +40,7 @@
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator.grpc.pb.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
 #include "tensorstore/kvstore/ocdbt/distributed/lease_cache_for_cooperator.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/format/version_tree.h"
@@ -62,6 +65,10 @@ struct PendingRequests {
   internal_ocdbt::GenerationNumber latest_root_generation = 0;
   StorageGeneration node_generation_at_latest_root_generation;
   absl::Time latest_manifest_time = absl::InfinitePast();
+  // Estimated total size of `requests`, and the time at which the oldest
+  // request was received.  Used for mutation batching.
+  size_t num_bytes = 0;
+  absl::Time oldest_request_time = absl::InfiniteFuture();
 
   void Append(PendingRequests&& other);
 };
@@ -78,6 +85,9 @@ struct Cooperator : public grpc_gen::Cooperator::CallbackService,
     absl::Mutex mutex;
     PendingRequests pending;
     bool commit_in_progress = false;
+    // Indicates that a commit is scheduled at the end of the mutation batching
+    // window.
+    bool batch_window_open = false;
 
     NodeKey node_key() const {
       return {lease_node->key, node_identifier.height};
@@ -135,6 +145,15 @@ struct Cooperator : public grpc_gen::Cooperator::CallbackService,
   // Storage identifier used for computing lease keys.
   std::string storage_identifier_;
 
+  // Mutation batching parameters, see `Options`.
+  absl::Duration mutation_batch_window_ = absl::ZeroDuration();
+  size_t mutation_batch_bytes_ = 0;
+
+  // Coordinator client, used for sending manifest notifications if
+  // `manifest_notifications_` is `true`.
+  std::shared_ptr<grpc_gen::Coordinator::StubInterface> coordinator_stub_;
+  bool manifest_notifications_ = false;
+
   absl::Mutex mutex_;
   Future<const absl::Time> manifest_available_;
 
@@ -43,6 +43,9 @@ Result<CooperatorPtr> Start(Options&& options) {
     impl->clock_ = [] { return absl::Now(); };
   }
   impl->io_handle_ = std::move(options.io_handle);
+  impl->mutation_batch_window_ = options.mutation_batch_window;
+  impl->mutation_batch_bytes_ = options.mutation_batch_bytes;
+  impl->manifest_notifications_ = options.manifest_notifications;
 
   grpc::ServerBuilder builder;
   builder.RegisterService(impl.get());
@@ -65,10 +68,11 @@ Result<CooperatorPtr> Start(Options&& options) {
   {
     LeaseCacheForCooperator::Options cache_options;
     cache_options.clock = impl->clock_;
-    cache_options.coordinator_stub =
+    impl->coordinator_stub_ =
         tensorstore::internal_ocdbt::grpc_gen::Coordinator::NewStub(
             grpc::CreateChannel(options.coordinator_address,
                                 options.security->GetClientCredentials()));
+    cache_options.coordinator_stub = impl->coordinator_stub_;
     cache_options.security = options.security;
     cache_options.cooperator_port = impl->listening_port_;
     cache_options.lease_duration = options.lease_duration;
@@ -14,6 +14,8 @@
 
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "riegeli/bytes/string_reader.h"
 #include "riegeli/bytes/string_writer.h"
 #include "tensorstore/internal/grpc/utils.h"
@@ -117,7 +119,9 @@ struct SubmitMutationBatchOperation
         << "SubmitMutationBatch: HandleRequestLocally: "
         << state->node_identifier;
     auto& mutation_requests = state->batch_request.mutations;
-    std::vector<PendingRequest> pending_requests(mutation_requests.size());
+    PendingRequests new_pending;
+    auto& pending_requests = new_pending.requests;
+    pending_requests.resize(mutation_requests.size());
     for (size_t i = 0; i < pending_requests.size(); ++i) {
       auto& mutation_request = mutation_requests[i];
       auto& pending_request = pending_requests[i];
@@ -125,13 +129,13 @@ struct SubmitMutationBatchOperation
       pending_request.index_within_batch = i;
       pending_request.mutation = std::move(mutation_request.mutation);
       pending_request.flush_future = std::move(mutation_request.flush_future);
+      new_pending.num_bytes += pending_request.mutation->EstimateSize();
     }
+    new_pending.oldest_request_time = absl::Now();
 
     auto node_mutation_requests = state->server->GetNodeMutationRequests(
         *state->lease_node, state->node_identifier.height);
     UniqueWriterLock lock(node_mutation_requests->mutex);
-    PendingRequests new_pending;
-    new_pending.requests = std::move(pending_requests);
     node_mutation_requests->pending.Append(std::move(new_pending));
     MaybeCommit(*state->server, std::move(node_mutation_requests),
                 std::move(lock));
@@ -292,7 +296,9 @@ void EnqueueWriteRequest(Cooperator& server,
         static_cast<void>(reactor->Finish(grpc::Status(
             grpc::StatusCode::INTERNAL,
             tensorstore::StrCat("Failed to decode write request: ", _)))));
+    batch.num_bytes += local_request.mutation->EstimateSize();
   }
+  batch.oldest_request_time = absl::Now();
   auto mutation_requests =
       server.GetNodeMutationRequests(lease_node, node_height);
   future.ExecuteWhenReady([reactor, response](
@@ -17,6 +17,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -94,6 +95,8 @@ CoordinatorServer& CoordinatorServer::operator=(CoordinatorServer&&) = default;
 class CoordinatorServer::Impl
     : public internal_ocdbt::grpc_gen::Coordinator::CallbackService {
  public:
+  ~Impl();
+
   std::vector<int> listening_ports_;
   std::unique_ptr<grpc::Server> server_;
   internal_ocdbt::RpcSecurityMethod::Ptr security_;
@@ -104,16 +107,75 @@ class CoordinatorServer::Impl
       const internal_ocdbt::grpc_gen::LeaseRequest* request,
       internal_ocdbt::grpc_gen::LeaseResponse* response) override;
 
+  grpc::ServerUnaryReactor* NotifyManifest(
+      grpc::CallbackServerContext* context,
+      const internal_ocdbt::grpc_gen::NotifyManifestRequest* request,
+      internal_ocdbt::grpc_gen::NotifyManifestResponse* response) override;
+
+  grpc::ServerUnaryReactor* WatchManifest(
+      grpc::CallbackServerContext* context,
+      const internal_ocdbt::grpc_gen::WatchManifestRequest* request,
+      internal_ocdbt::grpc_gen::WatchManifestResponse* response) override;
+
   void PurgeExpiredLeases() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Reactor for a pending `WatchManifest` request.
+  class ManifestWatchReactor : public grpc::ServerUnaryReactor {
+   public:
+    ManifestWatchReactor(
+        Impl* impl, std::string key,
+        internal_ocdbt::grpc_gen::WatchManifestResponse* response)
+        : impl_(impl), key_(std::move(key)), response_(response) {}
+
+    void OnCancel() override;
+    void OnDone() override { delete this; }
+
+    Impl* impl_;
+    std::string key_;
+    internal_ocdbt::grpc_gen::WatchManifestResponse* response_;
+  };
+
+  // Most recent root generation notified for a given database, and the
+  // pending `WatchManifest` requests waiting for a newer generation.
+  struct ManifestState {
+    uint64_t root_generation = 0;
+    std::vector<ManifestWatchReactor*> watches;
+  };
+
   absl::Mutex mutex_;
   LeaseTree leases_by_expiration_time_ ABSL_GUARDED_BY(mutex_);
   using LeaseSet =
       internal::HeterogeneousHashSet<std::unique_ptr<LeaseNode>,
                                      std::string_view, &LeaseNode::key>;
   LeaseSet leases_by_key_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, ManifestState> manifests_
+      ABSL_GUARDED_BY(mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_) = false;
 };
 
+CoordinatorServer::Impl::~Impl() {
+  // Pending `WatchManifest` requests would otherwise block `Shutdown`
+  // indefinitely.
+  std::vector<ManifestWatchReactor*> watches;
+  {
+    absl::MutexLock lock(&mutex_);
+    shutting_down_ = true;
+    for (auto& [key, state] : manifests_) {
+      watches.insert(watches.end(), state.watches.begin(),
+                     state.watches.end());
+      state.watches.clear();
+    }
+  }
+  for (auto* reactor : watches) {
+    reactor->Finish(grpc::Status(grpc::StatusCode::CANCELLED,
+                                 "Coordinator shutting down"));
+  }
+  if (server_) {
+    server_->Shutdown();
+    server_->Wait();
+  }
+}
+
 span<const int> CoordinatorServer::ports() const {
   return impl_->listening_ports_;
 }
@@ -215,6 +277,79 @@ grpc::ServerUnaryReactor* CoordinatorServer::Impl::RequestLease(
   return reactor;
 }
 
+grpc::ServerUnaryReactor* CoordinatorServer::Impl::NotifyManifest(
+    grpc::CallbackServerContext* context,
+    const internal_ocdbt::grpc_gen::NotifyManifestRequest* request,
+    internal_ocdbt::grpc_gen::NotifyManifestResponse* response) {
+  auto* reactor = context->DefaultReactor();
+  if (auto status = security_->ValidateServerRequest(context); !status.ok()) {
+    reactor->Finish(internal::AbslStatusToGrpcStatus(status));
+    return reactor;
+  }
+  std::vector<ManifestWatchReactor*> watches;
+  uint64_t root_generation;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto& state = manifests_[request->key()];
+    if (request->root_generation() > state.root_generation) {
+      state.root_generation = request->root_generation();
+      watches.swap(state.watches);
+    }
+    root_generation = state.root_generation;
+  }
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "Coordinator: notify request=" << *request
+      << ", waking " << watches.size() << " watches";
+  for (auto* watch : watches) {
+    watch->response_->set_root_generation(root_generation);
+    watch->Finish(grpc::Status());
+  }
+  reactor->Finish(grpc::Status());
+  return reactor;
+}
+
+grpc::ServerUnaryReactor* CoordinatorServer::Impl::WatchManifest(
+    grpc::CallbackServerContext* context,
+    const internal_ocdbt::grpc_gen::WatchManifestRequest* request,
+    internal_ocdbt::grpc_gen::WatchManifestResponse* response) {
+  auto* reactor = new ManifestWatchReactor(this, request->key(), response);
+  if (auto status = security_->ValidateServerRequest(context); !status.ok()) {
+    reactor->Finish(internal::AbslStatusToGrpcStatus(status));
+    return reactor;
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!shutting_down_) {
+      auto& state = manifests_[request->key()];
+      if (state.root_generation <= request->root_generation()) {
+        // Wait for a newer generation to be notified.
+        state.watches.push_back(reactor);
+        return reactor;
+      }
+      response->set_root_generation(state.root_generation);
+    }
+  }
+  reactor->Finish(response->has_root_generation()
+                      ? grpc::Status()
+                      : grpc::Status(grpc::StatusCode::CANCELLED,
+                                     "Coordinator shutting down"));
+  return reactor;
+}
+
+void CoordinatorServer::Impl::ManifestWatchReactor::OnCancel() {
+  {
+    absl::MutexLock lock(&impl_->mutex_);
+    auto it = impl_->manifests_.find(key_);
+    if (it == impl_->manifests_.end()) return;
+    auto& watches = it->second.watches;
+    auto watch_it = std::find(watches.begin(), watches.end(), this);
+    // Already finished by `NotifyManifest` or shutdown.
+    if (watch_it == watches.end()) return;
+    watches.erase(watch_it);
+  }
+  Finish(grpc::Status::CANCELLED);
+}
+
 Result<CoordinatorServer> CoordinatorServer::Start(Options options) {
   auto impl = std::make_unique<Impl>();
   if (options.clock) {
@@ -22,12 +22,16 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/log/absl_log.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "grpcpp/client_context.h"  // third_party
 #include "grpcpp/create_channel.h"  // third_party
+#include "grpcpp/support/status.h"  // third_party
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/ocdbt/distributed/btree_node_identifier.h"
 #include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.pb.h"
 #include "tensorstore/kvstore/ocdbt/distributed/lease_cache_for_cooperator.h"
 #include "tensorstore/kvstore/ocdbt/distributed/rpc_security.h"
 #include "tensorstore/util/future.h"
@@ -39,6 +43,7 @@ namespace {
 
 using ::tensorstore::KeyRange;
 using ::tensorstore::internal_ocdbt::BtreeNodeIdentifier;
+namespace grpc_gen = ::tensorstore::internal_ocdbt::grpc_gen;
 using ::tensorstore::internal_ocdbt_cooperator::LeaseCacheForCooperator;
 using ::tensorstore::ocdbt::CoordinatorServer;
 
@@ -47,6 +52,7 @@ class CoordinatorServerTest : public ::testing::Test {
   absl::Time cur_time;
   CoordinatorServer server_;
   LeaseCacheForCooperator lease_cache;
+  std::shared_ptr<grpc_gen::Coordinator::StubInterface> coordinator_stub;
 
   void SetUp() override {
     auto security =
@@ -70,9 +76,8 @@ class CoordinatorServerTest : public ::testing::Test {
     LeaseCacheForCooperator::Options lease_cache_options;
     lease_cache_options.clock = {};
     lease_cache_options.cooperator_port = 42;
-    lease_cache_options.coordinator_stub =
-        tensorstore::internal_ocdbt::grpc_gen::Coordinator::NewStub(
-            std::move(channel));
+    coordinator_stub = grpc_gen::Coordinator::NewStub(std::move(channel));
+    lease_cache_options.coordinator_stub = coordinator_stub;
     lease_cache_options.security = security;
 
     lease_cache = LeaseCacheForCooperator(std::move(lease_cache_options));
@@ -89,4 +94,59 @@ TEST_F(CoordinatorServerTest, Basic) {
   EXPECT_THAT(lease_info->peer_address, ::testing::MatchesRegex(".*:42"));
 }
 
+TEST_F(CoordinatorServerTest, WatchManifest) {
+  grpc_gen::WatchManifestRequest watch_request;
+  watch_request.set_key("key");
+  watch_request.set_root_generation(0);
+
+  // Pending watch completes once a newer generation is notified.
+  {
+    grpc::ClientContext context;
+    grpc_gen::WatchManifestResponse response;
+    grpc::Status status;
+    absl::Notification done;
+    coordinator_stub->async()->WatchManifest(&context, &watch_request,
+                                             &response, [&](grpc::Status s) {
+                                               status = std::move(s);
+                                               done.Notify();
+                                             });
+    grpc::ClientContext notify_context;
+    grpc_gen::NotifyManifestRequest notify_request;
+    grpc_gen::NotifyManifestResponse notify_response;
+    notify_request.set_key("key");
+    notify_request.set_root_generation(2);
+    ASSERT_TRUE(coordinator_stub
+                    ->NotifyManifest(&notify_context, notify_request,
+                                     &notify_response)
+                    .ok());
+    done.WaitForNotification();
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(2, response.root_generation());
+  }
+
+  // Watch for an older generation completes immediately.
+  {
+    grpc::ClientContext context;
+    grpc_gen::WatchManifestResponse response;
+    watch_request.set_root_generation(1);
+    EXPECT_TRUE(
+        coordinator_stub->WatchManifest(&context, watch_request, &response)
+            .ok());
+    EXPECT_EQ(2, response.root_generation());
+  }
+
+  // Watch for the current generation waits until the deadline.
+  {
+    grpc::ClientContext context;
+    context.set_deadline(
+        absl::ToChronoTime(absl::Now() + absl::Milliseconds(100)));
+    grpc_gen::WatchManifestResponse response;
+    watch_request.set_root_generation(2);
+    EXPECT_EQ(grpc::StatusCode::DEADLINE_EXCEEDED,
+              coordinator_stub->WatchManifest(&context, watch_request,
+                                              &response)
+                  .error_code());
+  }
+}
+
 }  // namespace
@@ -246,4 +246,38 @@ TEST_F(DistributedTest, ManifestDeleted) {
               MatchesStatus(absl::StatusCode::kFailedPrecondition));
 }
 
+
+TEST_F(DistributedTest, MutationBatchWindow) {
+  ::nlohmann::json security_json = ::nlohmann::json::value_t::discarded;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto batch_context_spec,
+      Context::Spec::FromJson({{"ocdbt_coordinator",
+                                {{"address", coordinator_address_},
+                                 {"security", security_json},
+                                 {"mutation_batch_window", "10ms"},
+                                 {"mutation_batch_bytes", 1000}}}}));
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  ::nlohmann::json kvs_spec{
+      {"driver", "ocdbt"},
+      {"base", {{"driver", "file"}, {"path", tempdir.path() + "/"}}},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store1,
+      kvstore::Open(kvs_spec, Context(batch_context_spec)).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store2,
+      kvstore::Open(kvs_spec, Context(batch_context_spec)).result());
+  std::vector<tensorstore::AnyFuture> write_futures;
+  for (size_t i = 0; i < 20; ++i) {
+    write_futures.push_back(kvstore::Write(i % 2 ? store1 : store2,
+                                           absl::StrFormat("%04d", i),
+                                           absl::Cord("a")));
+  }
+  for (auto& future : write_futures) {
+    TENSORSTORE_ASSERT_OK(future.status());
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto map, GetMap(store1));
+  EXPECT_EQ(20, map.size());
+}
+
 }  // namespace
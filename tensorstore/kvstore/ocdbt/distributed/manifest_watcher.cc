@@ -0,0 +1,226 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/distributed/manifest_watcher.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"  // third_party
+#include "grpcpp/support/status.h"  // third_party
+#include "tensorstore/internal/grpc/utils.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.pb.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_ocdbt_cooperator {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+namespace grpc_gen = ::tensorstore::internal_ocdbt::grpc_gen;
+using ::tensorstore::internal_ocdbt::GenerationNumber;
+using ::tensorstore::internal_ocdbt::ManifestWithTime;
+
+// Delay before re-issuing a `WatchManifest` request that failed with an error
+// other than an expired deadline, e.g. because the coordinator is unreachable.
+constexpr absl::Duration kWatchRetryDelay = absl::Seconds(1);
+
+struct NotifyRequestState
+    : public internal::AtomicReferenceCount<NotifyRequestState> {
+  std::shared_ptr<grpc_gen::Coordinator::StubInterface> coordinator_stub;
+  grpc::ClientContext client_context;
+  grpc_gen::NotifyManifestRequest request;
+  grpc_gen::NotifyManifestResponse response;
+};
+
+}  // namespace
+
+void NotifyManifest(
+    std::shared_ptr<grpc_gen::Coordinator::StubInterface> coordinator_stub,
+    std::string key, GenerationNumber root_generation) {
+  auto state = internal::MakeIntrusivePtr<NotifyRequestState>();
+  state->coordinator_stub = std::move(coordinator_stub);
+  state->request.set_key(std::move(key));
+  state->request.set_root_generation(root_generation);
+  auto* state_ptr = state.get();
+  state_ptr->coordinator_stub->async()->NotifyManifest(
+      &state_ptr->client_context, &state_ptr->request, &state_ptr->response,
+      [state = std::move(state)](::grpc::Status s) {
+        auto status = internal::GrpcStatusToAbslStatus(std::move(s));
+        ABSL_LOG_IF(INFO, ocdbt_logging || !status.ok())
+            << "NotifyManifest: root_generation="
+            << state->request.root_generation() << ": " << status;
+      });
+}
+
+class ManifestWatcher::Impl
+    : public internal::AtomicReferenceCount<ManifestWatcher::Impl> {
+ public:
+  // Issues a new `WatchManifest` request, unless stopped.
+  void StartRequest();
+
+  void HandleResponse(absl::Status status, GenerationNumber root_generation);
+
+  // Ensures the cached manifest is at least `root_generation`.
+  void Refresh(GenerationNumber root_generation);
+
+  // Cancels the pending request, if any.
+  void Stop();
+
+  std::shared_ptr<grpc_gen::Coordinator::StubInterface> coordinator_stub_;
+  internal_ocdbt::IoHandle::Ptr io_handle_;
+  std::string key_;
+  absl::Duration poll_timeout_;
+
+  absl::Mutex mutex_;
+  GenerationNumber root_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  // Context of the pending request, if any.
+  grpc::ClientContext* client_context_ ABSL_GUARDED_BY(mutex_) = nullptr;
+};
+
+namespace {
+
+struct WatchRequestState
+    : public internal::AtomicReferenceCount<WatchRequestState> {
+  internal::IntrusivePtr<ManifestWatcher::Impl> owner;
+  grpc::ClientContext client_context;
+  grpc_gen::WatchManifestRequest request;
+  grpc_gen::WatchManifestResponse response;
+};
+
+}  // namespace
+
+void ManifestWatcher::Impl::StartRequest() {
+  auto state = internal::MakeIntrusivePtr<WatchRequestState>();
+  state->owner.reset(this);
+  state->request.set_key(key_);
+  state->client_context.set_deadline(
+      absl::ToChronoTime(absl::Now() + poll_timeout_));
+  {
+    absl::MutexLock lock(&mutex_);
+    if (stopped_) return;
+    state->request.set_root_generation(root_generation_);
+    client_context_ = &state->client_context;
+  }
+  auto* state_ptr = state.get();
+  coordinator_stub_->async()->WatchManifest(
+      &state_ptr->client_context, &state_ptr->request, &state_ptr->response,
+      [state = std::move(state)](::grpc::Status s) {
+        state->owner->HandleResponse(
+            internal::GrpcStatusToAbslStatus(std::move(s)),
+            state->response.root_generation());
+      });
+}
+
+void ManifestWatcher::Impl::HandleResponse(absl::Status status,
+                                           GenerationNumber root_generation) {
+  bool refresh = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    client_context_ = nullptr;
+    if (stopped_) return;
+    if (status.ok() && root_generation > root_generation_) {
+      root_generation_ = root_generation;
+      refresh = true;
+    }
+  }
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "WatchManifest: root_generation=" << root_generation << ": "
+      << status;
+  if (refresh) Refresh(root_generation);
+  if (status.ok() || absl::IsDeadlineExceeded(status)) {
+    StartRequest();
+    return;
+  }
+  internal::ScheduleAt(absl::Now() + kWatchRetryDelay,
+                       [self = internal::IntrusivePtr<Impl>(this)] {
+                         self->StartRequest();
+                       });
+}
+
+void ManifestWatcher::Impl::Refresh(GenerationNumber root_generation) {
+  // The notification may correspond to a manifest written by this process, in
+  // which case the cached manifest is already up to date.
+  auto cached_future = io_handle_->GetManifest(absl::InfinitePast());
+  cached_future.Force();
+  std::move(cached_future)
+      .ExecuteWhenReady([self = internal::IntrusivePtr<Impl>(this),
+                         root_generation](
+                            ReadyFuture<const ManifestWithTime> future) {
+        auto& r = future.result();
+        if (r.ok() && internal_ocdbt::GetLatestGeneration(
+                          r->manifest.get()) >= root_generation) {
+          return;
+        }
+        auto read_future = self->io_handle_->GetManifest(absl::Now());
+        read_future.Force();
+        std::move(read_future)
+            .ExecuteWhenReady(
+                [root_generation](ReadyFuture<const ManifestWithTime> future) {
+                  ABSL_LOG_IF(INFO, ocdbt_logging)
+                      << "WatchManifest: refreshed manifest for "
+                         "root_generation="
+                      << root_generation << ": " << future.status();
+                });
+      });
+}
+
+void ManifestWatcher::Impl::Stop() {
+  absl::MutexLock lock(&mutex_);
+  stopped_ = true;
+  if (client_context_) client_context_->TryCancel();
+}
+
+ManifestWatcher::ManifestWatcher() = default;
+
+ManifestWatcher::ManifestWatcher(Options&& options) {
+  impl_.reset(new Impl);
+  impl_->coordinator_stub_ = std::move(options.coordinator_stub);
+  impl_->io_handle_ = std::move(options.io_handle);
+  impl_->key_ = std::move(options.key);
+  impl_->poll_timeout_ = options.poll_timeout;
+  impl_->StartRequest();
+}
+
+ManifestWatcher::ManifestWatcher(ManifestWatcher&& other) = default;
+
+ManifestWatcher& ManifestWatcher::operator=(ManifestWatcher&& other) {
+  if (impl_) impl_->Stop();
+  impl_ = std::move(other.impl_);
+  return *this;
+}
+
+ManifestWatcher::~ManifestWatcher() {
+  if (impl_) impl_->Stop();
+}
+
+}  // namespace internal_ocdbt_cooperator
+}  // namespace tensorstore
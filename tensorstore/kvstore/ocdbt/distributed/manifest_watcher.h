@@ -0,0 +1,91 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_MANIFEST_WATCHER_H_
+#define TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_MANIFEST_WATCHER_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+
+namespace tensorstore {
+namespace internal_ocdbt_cooperator {
+
+// Notifies the coordinator that a manifest with the specified root generation
+// has been written.
+//
+// The notification is sent asynchronously.  Since notifications only serve to
+// refresh the manifest caches of other processes early, failures are logged
+// but otherwise ignored.
+//
+// Args:
+//   coordinator_stub: Coordinator client, must be non-null.
+//   key: Lease key of the root node, obtained from
+//     `BtreeNodeIdentifier::Root().GetKey(storage_identifier)`.
+//   root_generation: Generation of the new manifest.
+void NotifyManifest(
+    std::shared_ptr<internal_ocdbt::grpc_gen::Coordinator::StubInterface>
+        coordinator_stub,
+    std::string key, internal_ocdbt::GenerationNumber root_generation);
+
+// Watches the coordinator for notifications of new manifests, and refreshes
+// the cached manifest of an `IoHandle` as soon as one is received.
+//
+// This allows readers to specify a large staleness bound, avoiding a manifest
+// request for each read, while still observing writes made by other processes
+// shortly after they are committed.  Only writes made through cooperators
+// connected to the same coordinator are notified.
+//
+// Watching stops when this object is destroyed.
+class ManifestWatcher {
+ public:
+  struct Options {
+    std::shared_ptr<internal_ocdbt::grpc_gen::Coordinator::StubInterface>
+        coordinator_stub;
+    internal_ocdbt::IoHandle::Ptr io_handle;
+
+    // Lease key of the root node, see `NotifyManifest`.
+    std::string key;
+
+    // Deadline of each long-poll `WatchManifest` request, after which a new
+    // request is issued.
+    absl::Duration poll_timeout = absl::Minutes(1);
+  };
+
+  // Constructs a null watcher.
+  ManifestWatcher();
+
+  // Starts watching.
+  explicit ManifestWatcher(Options&& options);
+
+  ManifestWatcher(ManifestWatcher&& other);
+  ManifestWatcher& operator=(ManifestWatcher&& other);
+
+  ~ManifestWatcher();
+
+  // Treat as private:
+  class Impl;
+
+  internal::IntrusivePtr<Impl> impl_;
+};
+
+}  // namespace internal_ocdbt_cooperator
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_MANIFEST_WATCHER_H_
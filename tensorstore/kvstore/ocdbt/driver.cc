@@ -19,20 +19,27 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <cassert>
 #include <cstring>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
 
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
 #include "absl/time/time.h"
+#include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json/json.h"
+#include "tensorstore/internal/json/value_as.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/metrics/counter.h"
@@ -48,11 +55,14 @@
 #include "tensorstore/kvstore/ocdbt/distributed/rpc_security.h"
 #include "tensorstore/kvstore/ocdbt/distributed/rpc_security_registry.h"
 #include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
 #include "tensorstore/kvstore/ocdbt/io/io_handle_impl.h"
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/btree_writer.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/list.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/read.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/read_version.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/scan.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/transactional_btree_writer.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
@@ -70,6 +80,7 @@
 // specializations
 #include "tensorstore/internal/cache_key/absl_time.h"  // IWYU pragma: keep
 #include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/internal/cache_key/std_variant.h"  // IWYU pragma: keep
 #include "tensorstore/internal/json_binding/absl_time.h"  // IWYU pragma: keep
 #include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
 
@@ -94,7 +105,13 @@ struct OcdbtCoordinatorResourceTraits
         jb::Member("address", jb::Projection<&Spec::address>()),
         jb::Member("lease_duration", jb::Projection<&Spec::lease_duration>()),
         jb::Member("security", jb::Projection<&Spec::security>(
-                                   RpcSecurityMethodJsonBinder)));
+                                   RpcSecurityMethodJsonBinder)),
+        jb::Member("mutation_batch_window",
+                   jb::Projection<&Spec::mutation_batch_window>()),
+        jb::Member("mutation_batch_bytes",
+                   jb::Projection<&Spec::mutation_batch_bytes>()),
+        jb::Member("manifest_notifications",
+                   jb::Projection<&Spec::manifest_notifications>()));
   }
   static Result<Resource> Create(
       const Spec& spec, internal::ContextResourceCreationContext context) {
@@ -113,6 +130,9 @@ const internal::ContextResourceRegistration<OcdbtCoordinatorResourceTraits>
 auto& ocdbt_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/ocdbt/read", "OCDBT driver kvstore::Read calls");
 
+auto& ocdbt_stat = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/ocdbt/stat", "OCDBT driver kvstore::Stat calls");
+
 auto& ocdbt_write = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/ocdbt/write", "OCDBT driver kvstore::Write calls");
 
@@ -123,6 +143,59 @@ auto& ocdbt_delete_range = internal_metrics::Counter<int64_t>::New(
 auto& ocdbt_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/ocdbt/list", "OCDBT driver kvstore::List calls");
 
+auto& ocdbt_scan = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/ocdbt/scan", "OCDBT driver kvstore::Scan calls");
+
+// Binds a `VersionSpec` to either a generation number (JSON integer), an
+// exact commit time (RFC3339 string), or an inclusive upper bound on the
+// commit time (RFC3339 string prefixed by "<=").
+constexpr auto VersionSpecJsonBinder =
+    [](auto is_loading, const auto& options, VersionSpec* obj,
+       ::nlohmann::json* j) -> absl::Status {
+  if constexpr (is_loading) {
+    if (auto* s = j->get_ptr<const std::string*>()) {
+      std::string_view time_string = *s;
+      const bool upper_bound = absl::ConsumePrefix(&time_string, "<=");
+      absl::Time time;
+      std::string error;
+      if (!absl::ParseTime(absl::RFC3339_full, time_string, &time, &error)) {
+        return internal_json::ExpectedError(
+            *j, "Commit time formatted as RFC3339 string");
+      }
+      TENSORSTORE_ASSIGN_OR_RETURN(auto commit_time,
+                                   CommitTime::FromAbslTime(time));
+      if (upper_bound) {
+        *obj = CommitTimeUpperBound{commit_time};
+      } else {
+        *obj = commit_time;
+      }
+      return absl::OkStatus();
+    }
+    GenerationNumber generation_number;
+    TENSORSTORE_RETURN_IF_ERROR(internal_json::JsonRequireInteger(
+        *j, &generation_number, /*strict=*/true, /*min_value=*/1));
+    *obj = generation_number;
+    return absl::OkStatus();
+  } else {
+    struct Visitor {
+      ::nlohmann::json operator()(GenerationNumber generation_number) const {
+        return generation_number;
+      }
+      ::nlohmann::json operator()(CommitTime commit_time) const {
+        return absl::FormatTime(static_cast<absl::Time>(commit_time),
+                                absl::UTCTimeZone());
+      }
+      ::nlohmann::json operator()(CommitTimeUpperBound upper_bound) const {
+        return absl::StrCat("<=", absl::FormatTime(static_cast<absl::Time>(
+                                                       upper_bound.commit_time),
+                                                   absl::UTCTimeZone()));
+      }
+    };
+    *j = std::visit(Visitor{}, *obj);
+    return absl::OkStatus();
+  }
+};
+
 }  // namespace
 namespace jb = ::tensorstore::internal_json_binding;
 
@@ -166,9 +239,30 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
             "experimental_read_coalescing_interval",
             jb::Projection<
                 &OcdbtDriverSpecData::experimental_read_coalescing_interval>()),
+        jb::Member(
+            "experimental_read_coalescing_adaptive",
+            jb::Projection<
+                &OcdbtDriverSpecData::experimental_read_coalescing_adaptive>()),
         jb::Member(
             "target_data_file_size",
             jb::Projection<&OcdbtDriverSpecData::target_data_file_size>()),
+        jb::Member(
+            "data_file_flush_delay",
+            jb::Projection<&OcdbtDriverSpecData::data_file_flush_delay>()),
+        jb::Member(
+            "value_data_alignment",
+            jb::Projection<&OcdbtDriverSpecData::value_data_alignment>()),
+        jb::Member(
+            "experimental_pinned_btree_levels",
+            jb::Projection<
+                &OcdbtDriverSpecData::experimental_pinned_btree_levels>()),
+        jb::Member(
+            "experimental_pinned_btree_bytes",
+            jb::Projection<
+                &OcdbtDriverSpecData::experimental_pinned_btree_bytes>()),
+        jb::Member("version",
+                   jb::Projection<&OcdbtDriverSpecData::version>(
+                       jb::Optional(VersionSpecJsonBinder))),
         jb::Member("coordinator",
                    jb::Projection<&OcdbtDriverSpecData::coordinator>()),
         jb::Member(internal::CachePoolResource::id,
@@ -181,12 +275,41 @@ Result<kvstore::Spec> OcdbtDriverSpec::GetBase(std::string_view path) const {
   return data_.base;
 }
 
+namespace {
+// Resolves `driver->version_` and replaces `driver->io_handle_` with a
+// read-only handle for the resolved version.
+//
+// The version is resolved once, when the driver is opened.  Afterwards, reads
+// never re-read the manifest, and no B+tree writer is created.
+void OpenSnapshot(internal::IntrusivePtr<OcdbtDriver> driver,
+                  PinnedBtreeNodeOptions pinned_btree_node_options,
+                  Promise<kvstore::DriverPtr> promise) {
+  auto version_future =
+      ReadVersion(driver->io_handle_, *driver->version_, absl::Now());
+  LinkValue(
+      [driver = std::move(driver), pinned_btree_node_options](
+          Promise<kvstore::DriverPtr> promise,
+          ReadyFuture<BtreeGenerationReference> future) mutable {
+        // Reading the version validated the manifest, which ensures that the
+        // config is known.
+        const Config* config =
+            driver->io_handle_->config_state->GetExistingConfig();
+        assert(config);
+        driver->io_handle_ =
+            MakeSnapshotIoHandle(std::move(driver->io_handle_), *config,
+                                 future.value(), pinned_btree_node_options);
+        promise.SetResult(std::move(driver));
+      },
+      std::move(promise), std::move(version_future));
+}
+}  // namespace
+
 Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
   auto base_kvstore_future = kvstore::Open(data_.base);
   Future<kvstore::KvStore> manifest_kvstore_future =
       data_.manifest ? kvstore::Open(*data_.manifest)
                      : Future<kvstore::KvStore>(kvstore::KvStore{});
-  return MapFutureValue(
+  auto driver_future = MapFutureValue(
       InlineExecutor{},
       [spec = internal::IntrusivePtr<const OcdbtDriverSpec>(this)](
           kvstore::KvStore& base_kvstore,
@@ -208,12 +331,22 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
             spec->data_.experimental_read_coalescing_merged_bytes;
         driver->experimental_read_coalescing_interval_ =
             spec->data_.experimental_read_coalescing_interval;
+        driver->experimental_read_coalescing_adaptive_ =
+            spec->data_.experimental_read_coalescing_adaptive;
         driver->target_data_file_size_ = spec->data_.target_data_file_size;
+        driver->data_file_flush_delay_ = spec->data_.data_file_flush_delay;
+        driver->value_data_alignment_ = spec->data_.value_data_alignment;
+        driver->experimental_pinned_btree_levels_ =
+            spec->data_.experimental_pinned_btree_levels;
+        driver->experimental_pinned_btree_bytes_ =
+            spec->data_.experimental_pinned_btree_bytes;
+        driver->version_ = spec->data_.version;
 
         std::optional<ReadCoalesceOptions> read_coalesce_options;
         if (driver->experimental_read_coalescing_threshold_bytes_ ||
             driver->experimental_read_coalescing_merged_bytes_ ||
-            driver->experimental_read_coalescing_interval_) {
+            driver->experimental_read_coalescing_interval_ ||
+            driver->experimental_read_coalescing_adaptive_.value_or(false)) {
           read_coalesce_options.emplace();
           read_coalesce_options->max_overhead_bytes_per_request =
               static_cast<int64_t>(
@@ -226,8 +359,24 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
           read_coalesce_options->max_interval =
               driver->experimental_read_coalescing_interval_.value_or(
                   absl::ZeroDuration());
+          read_coalesce_options->adaptive =
+              driver->experimental_read_coalescing_adaptive_.value_or(false);
         }
 
+        PinnedBtreeNodeOptions pinned_btree_node_options;
+        pinned_btree_node_options.max_levels =
+            driver->experimental_pinned_btree_levels_.value_or(0);
+        pinned_btree_node_options.max_bytes =
+            driver->experimental_pinned_btree_bytes_.value_or(0);
+
+        DataFileWriteOptions data_file_write_options;
+        data_file_write_options.target_size =
+            driver->target_data_file_size_.value_or(kDefaultTargetBufferSize);
+        data_file_write_options.flush_delay =
+            driver->data_file_flush_delay_.value_or(absl::ZeroDuration());
+        data_file_write_options.value_alignment =
+            driver->value_data_alignment_.value_or(0);
+
         TENSORSTORE_ASSIGN_OR_RETURN(
             auto config_state,
             ConfigState::Make(spec->data_.config, supported_manifest_features,
@@ -239,11 +388,14 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
             driver->manifest_kvstore_.driver ? driver->manifest_kvstore_
                                              : driver->base_,
             std::move(config_state), driver->data_file_prefixes_,
-            driver->target_data_file_size_.value_or(kDefaultTargetBufferSize),
-            std::move(read_coalesce_options));
-        driver->btree_writer_ =
-            MakeNonDistributedBtreeWriter(driver->io_handle_);
+            data_file_write_options, std::move(read_coalesce_options),
+            driver->version_ ? PinnedBtreeNodeOptions{}
+                             : pinned_btree_node_options);
         driver->coordinator_ = spec->data_.coordinator;
+        if (driver->version_) {
+          // Read-only snapshot; see `OpenSnapshot`.
+          return driver;
+        }
         if (!driver->coordinator_->address) {
           driver->btree_writer_ =
               MakeNonDistributedBtreeWriter(driver->io_handle_);
@@ -260,6 +412,13 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
         }
         options.lease_duration = driver->coordinator_->lease_duration.value_or(
             kDefaultLeaseDuration);
+        options.mutation_batch_window =
+            driver->coordinator_->mutation_batch_window.value_or(
+                absl::ZeroDuration());
+        options.mutation_batch_bytes =
+            driver->coordinator_->mutation_batch_bytes.value_or(0);
+        options.manifest_notifications =
+            driver->coordinator_->manifest_notifications.value_or(false);
 
         // Compute unique identifier for the base kvstore to use with
         // coordinator.
@@ -271,6 +430,23 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
         return driver;
       },
       std::move(base_kvstore_future), std::move(manifest_kvstore_future));
+  if (!data_.version) return driver_future;
+  PinnedBtreeNodeOptions pinned_btree_node_options;
+  pinned_btree_node_options.max_levels =
+      data_.experimental_pinned_btree_levels.value_or(0);
+  pinned_btree_node_options.max_bytes =
+      data_.experimental_pinned_btree_bytes.value_or(0);
+  return PromiseFuturePair<kvstore::DriverPtr>::LinkValue(
+             [pinned_btree_node_options](
+                 Promise<kvstore::DriverPtr> promise,
+                 ReadyFuture<kvstore::DriverPtr> future) {
+               OpenSnapshot(internal::IntrusivePtr<OcdbtDriver>(
+                                static_cast<OcdbtDriver*>(
+                                    future.value().get())),
+                            pinned_btree_node_options, std::move(promise));
+             },
+             std::move(driver_future))
+      .future;
 }
 
 absl::Status OcdbtDriverSpec::ApplyOptions(
@@ -302,13 +478,21 @@ absl::Status OcdbtDriver::GetBoundSpecData(OcdbtDriverSpecData& spec) const {
       experimental_read_coalescing_merged_bytes_;
   spec.experimental_read_coalescing_interval =
       experimental_read_coalescing_interval_;
+  spec.experimental_read_coalescing_adaptive =
+      experimental_read_coalescing_adaptive_;
   spec.target_data_file_size = target_data_file_size_;
+  spec.data_file_flush_delay = data_file_flush_delay_;
+  spec.value_data_alignment = value_data_alignment_;
+  spec.experimental_pinned_btree_levels = experimental_pinned_btree_levels_;
+  spec.experimental_pinned_btree_bytes = experimental_pinned_btree_bytes_;
+  spec.version = version_;
   spec.coordinator = coordinator_;
   return absl::Status();
 }
 
 kvstore::SupportedFeatures OcdbtDriver::GetSupportedFeatures(
     const KeyRange& key_range) const {
+  if (!btree_writer_) return kvstore::SupportedFeatures::kNone;
   return kvstore::SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
          kvstore::SupportedFeatures::kAtomicWriteWithoutOverwrite;
 }
@@ -320,6 +504,13 @@ Future<kvstore::ReadResult> OcdbtDriver::Read(kvstore::Key key,
                                             std::move(options));
 }
 
+Future<kvstore::StatResult> OcdbtDriver::Stat(kvstore::Key key,
+                                              kvstore::StatOptions options) {
+  ocdbt_stat.Increment();
+  return internal_ocdbt::NonDistributedStat(io_handle_, std::move(key),
+                                            std::move(options));
+}
+
 void OcdbtDriver::ListImpl(kvstore::ListOptions options,
                            ListReceiver receiver) {
   ocdbt_list.Increment();
@@ -327,22 +518,34 @@ void OcdbtDriver::ListImpl(kvstore::ListOptions options,
                                             std::move(receiver));
 }
 
+void OcdbtDriver::ScanImpl(kvstore::ScanOptions options,
+                           ScanReceiver receiver) {
+  ocdbt_scan.Increment();
+  return internal_ocdbt::NonDistributedScan(io_handle_, std::move(options),
+                                            std::move(receiver));
+}
+
 Future<TimestampedStorageGeneration> OcdbtDriver::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   ocdbt_write.Increment();
+  if (!btree_writer_) {
+    return kvstore::Driver::Write(std::move(key), std::move(value),
+                                  std::move(options));
+  }
   return btree_writer_->Write(std::move(key), std::move(value),
                               std::move(options));
 }
 
 Future<const void> OcdbtDriver::DeleteRange(KeyRange range) {
   ocdbt_delete_range.Increment();
+  if (!btree_writer_) return kvstore::Driver::DeleteRange(std::move(range));
   return btree_writer_->DeleteRange(std::move(range));
 }
 
 Future<const void> OcdbtDriver::ExperimentalCopyRangeFrom(
     const internal::OpenTransactionPtr& transaction, const KvStore& source,
     std::string target_prefix, kvstore::CopyRangeOptions options) {
-  if (typeid(*source.driver) == typeid(OcdbtDriver)) {
+  if (btree_writer_ && typeid(*source.driver) == typeid(OcdbtDriver)) {
     auto& source_driver = static_cast<OcdbtDriver&>(*source.driver);
     if (source.transaction != no_transaction) {
       return absl::UnimplementedError("Source transactions not supported");
@@ -422,7 +625,8 @@ Result<KvStore> OcdbtDriver::GetBase(std::string_view path,
 absl::Status OcdbtDriver::ReadModifyWrite(
     internal::OpenTransactionPtr& transaction, size_t& phase, Key key,
     ReadModifyWriteSource& source) {
-  if (!transaction || !transaction->atomic() || coordinator_->address) {
+  if (!transaction || !transaction->atomic() || coordinator_->address ||
+      !btree_writer_) {
     return kvstore::Driver::ReadModifyWrite(transaction, phase, std::move(key),
                                             source);
   }
@@ -432,7 +636,7 @@ absl::Status OcdbtDriver::ReadModifyWrite(
 
 absl::Status OcdbtDriver::TransactionalDeleteRange(
     const internal::OpenTransactionPtr& transaction, KeyRange range) {
-  if (!transaction->atomic() || coordinator_->address) {
+  if (!transaction->atomic() || coordinator_->address || !btree_writer_) {
     return kvstore::Driver::TransactionalDeleteRange(transaction,
                                                      std::move(range));
   }
@@ -38,6 +38,7 @@
 #include "tensorstore/kvstore/ocdbt/btree_writer.h"
 #include "tensorstore/kvstore/ocdbt/config.h"
 #include "tensorstore/kvstore/ocdbt/distributed/rpc_security.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
 #include "tensorstore/kvstore/ocdbt/io/io_handle_impl.h"
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
 #include "tensorstore/kvstore/operations.h"
@@ -69,8 +70,13 @@ struct OcdbtCoordinatorResource
     std::optional<std::string> address;
     std::optional<absl::Duration> lease_duration;
     RpcSecurityMethod::Ptr security;
+    std::optional<absl::Duration> mutation_batch_window;
+    std::optional<size_t> mutation_batch_bytes;
+    std::optional<bool> manifest_notifications;
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.address, x.lease_duration, x.security);
+      return f(x.address, x.lease_duration, x.security,
+               x.mutation_batch_window, x.mutation_batch_bytes,
+               x.manifest_notifications);
     };
   };
   using Resource = Spec;
@@ -87,8 +93,14 @@ struct OcdbtDriverSpecData {
   std::optional<size_t> experimental_read_coalescing_threshold_bytes;
   std::optional<size_t> experimental_read_coalescing_merged_bytes;
   std::optional<absl::Duration> experimental_read_coalescing_interval;
+  std::optional<bool> experimental_read_coalescing_adaptive;
   std::optional<size_t> target_data_file_size;
+  std::optional<absl::Duration> data_file_flush_delay;
+  std::optional<size_t> value_data_alignment;
+  std::optional<size_t> experimental_pinned_btree_levels;
+  std::optional<size_t> experimental_pinned_btree_bytes;
   bool assume_config = false;
+  std::optional<VersionSpec> version;
   Context::Resource<OcdbtCoordinatorResource> coordinator;
 
   TENSORSTORE_DECLARE_JSON_DEFAULT_BINDER(OcdbtDriverSpecData,
@@ -101,8 +113,11 @@ struct OcdbtDriverSpecData {
              x.data_copy_concurrency,
              x.experimental_read_coalescing_threshold_bytes,
              x.experimental_read_coalescing_merged_bytes,
-             x.experimental_read_coalescing_interval, x.target_data_file_size,
-             x.coordinator);
+             x.experimental_read_coalescing_interval,
+             x.experimental_read_coalescing_adaptive, x.target_data_file_size,
+             x.data_file_flush_delay, x.value_data_alignment,
+             x.experimental_pinned_btree_levels,
+             x.experimental_pinned_btree_bytes, x.version, x.coordinator);
   };
 };
 
@@ -124,6 +139,8 @@ class OcdbtDriver
  public:
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
                                              WriteOptions options) override;
@@ -138,6 +155,9 @@ class OcdbtDriver
 
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
+  /// Delivers values stored inline in the leaf nodes without additional reads.
+  void ScanImpl(ScanOptions options, ScanReceiver receiver) override;
+
   absl::Status GetBoundSpecData(OcdbtDriverSpecData& spec) const;
 
   kvstore::SupportedFeatures GetSupportedFeatures(
@@ -166,7 +186,15 @@ class OcdbtDriver
   std::optional<size_t> experimental_read_coalescing_threshold_bytes_;
   std::optional<size_t> experimental_read_coalescing_merged_bytes_;
   std::optional<absl::Duration> experimental_read_coalescing_interval_;
+  std::optional<bool> experimental_read_coalescing_adaptive_;
   std::optional<size_t> target_data_file_size_;
+  std::optional<absl::Duration> data_file_flush_delay_;
+  std::optional<size_t> value_data_alignment_;
+  std::optional<size_t> experimental_pinned_btree_levels_;
+  std::optional<size_t> experimental_pinned_btree_bytes_;
+  // Fixed version at which the database was opened read-only, or
+  // `std::nullopt` to access the latest version.
+  std::optional<VersionSpec> version_;
   Context::Resource<OcdbtCoordinatorResource> coordinator_;
 };
 
@@ -16,14 +16,18 @@
 
 #include <initializer_list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include <nlohmann/json_fwd.hpp>
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
@@ -64,6 +68,7 @@ using ::tensorstore::internal::GetMap;
 using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
 using ::tensorstore::internal::MatchesListEntry;
+using ::tensorstore::internal::MatchesScanEntry;
 using ::tensorstore::internal::MockKeyValueStore;
 using ::tensorstore::internal_ocdbt::Config;
 using ::tensorstore::internal_ocdbt::ConfigConstraints;
@@ -355,7 +360,10 @@ TEST(OcdbtTest, WithExperimentalSpec) {
       {"experimental_read_coalescing_threshold_bytes", 1024},
       {"experimental_read_coalescing_merged_bytes", 2048},
       {"experimental_read_coalescing_interval", "10ms"},
+      {"experimental_read_coalescing_adaptive", true},
       {"target_data_file_size", 1024},
+      {"data_file_flush_delay", "1ms"},
+      {"value_data_alignment", 512},
   };
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, tensorstore::kvstore::Open(json_spec).result());
@@ -440,6 +448,90 @@ TEST(OcdbtTest, CacheKey) {
 }
 
 // TODO(jbms): Consider refactoring into TEST_P.
+// Returns the next write request, forwarding any read requests to `target`.
+std::optional<MockKeyValueStore::WriteRequest> PopWriteRequest(
+    MockKeyValueStore& mock_key_value_store,
+    const tensorstore::kvstore::DriverPtr& target) {
+  for (auto deadline = absl::Now() + absl::Seconds(10);
+       absl::Now() < deadline;) {
+    if (auto req = mock_key_value_store.write_requests.pop_nonblock()) {
+      return req;
+    }
+    if (auto req = mock_key_value_store.read_requests.pop_nonblock()) {
+      (*req)(target);
+      continue;
+    }
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  return std::nullopt;
+}
+
+TEST(OcdbtTest, PipelinedCommits) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto base_store,
+                                   kvstore::Open("memory://").result());
+  auto context = Context::Default();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  MockKeyValueStore* mock_key_value_store =
+      mock_key_value_store_resource->get();
+  mock_key_value_store->supported_features =
+      SupportedFeatures::kSingleKeyAtomicReadModifyWrite;
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open(
+          {{"driver", "ocdbt"}, {"base", {{"driver", "mock_key_value_store"}}}},
+          context)
+          .result());
+
+  mock_key_value_store->forward_to = base_store.driver;
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "init", absl::Cord("value")));
+  mock_key_value_store->forward_to = {};
+
+  auto write_future_a = kvstore::Write(store, "a", absl::Cord("value_a"));
+  {
+    auto req = PopWriteRequest(*mock_key_value_store, base_store.driver);
+    ASSERT_TRUE(req);
+    EXPECT_THAT(req->key, ::testing::StartsWith("d/"));
+    (*req)(base_store.driver);
+  }
+  auto manifest_req_a =
+      PopWriteRequest(*mock_key_value_store, base_store.driver);
+  ASSERT_TRUE(manifest_req_a);
+  EXPECT_EQ("manifest.ocdbt", manifest_req_a->key);
+
+  // While the first manifest write is still outstanding, the next commit
+  // writes its B+tree nodes.
+  auto write_future_b = kvstore::Write(store, "b", absl::Cord("value_b"));
+  {
+    auto req = PopWriteRequest(*mock_key_value_store, base_store.driver);
+    ASSERT_TRUE(req);
+    EXPECT_THAT(req->key, ::testing::StartsWith("d/"));
+    (*req)(base_store.driver);
+  }
+  EXPECT_FALSE(write_future_a.ready());
+  EXPECT_FALSE(write_future_b.ready());
+
+  (*manifest_req_a)(base_store.driver);
+  TENSORSTORE_ASSERT_OK(write_future_a.result());
+  {
+    auto req = PopWriteRequest(*mock_key_value_store, base_store.driver);
+    ASSERT_TRUE(req);
+    EXPECT_EQ("manifest.ocdbt", req->key);
+    (*req)(base_store.driver);
+  }
+  TENSORSTORE_ASSERT_OK(write_future_b.result());
+
+  mock_key_value_store->forward_to = base_store.driver;
+  EXPECT_THAT(GetMap(store),
+              ::testing::Optional(::testing::ElementsAre(
+                  ::testing::Pair("a", absl::Cord("value_a")),
+                  ::testing::Pair("b", absl::Cord("value_b")),
+                  ::testing::Pair("init", absl::Cord("value")))));
+}
+
 TENSORSTORE_GLOBAL_INITIALIZER {
   const auto register_test_suite = [](ConfigConstraints config) {
     const auto register_test_case = [&](std::string case_name, auto op) {
@@ -506,7 +598,8 @@ TENSORSTORE_GLOBAL_INITIALIZER {
   }
 
   for (const auto compression : std::initializer_list<Config::Compression>{
-           Config::NoCompression{}, Config::ZstdCompression{0}}) {
+           Config::NoCompression{}, Config::ZstdCompression{0},
+           Config::Lz4Compression{0}}) {
     ConfigConstraints config;
     config.max_decoded_node_bytes = 0;
     config.max_inline_value_bytes = 0;
@@ -653,6 +746,58 @@ TEST(OcdbtTest, NumberedManifest) {
                   MatchesListEntry(::testing::StartsWith("d/")))));
 }
 
+TEST(OcdbtTest, FixedVersion) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "ocdbt"}, {"base", "memory://"}}, context)
+          .result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("1")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("2")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "b", absl::Cord("3")));
+
+  ::nlohmann::json snapshot_spec{
+      {"driver", "ocdbt"}, {"base", "memory://"}, {"version", 2}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto snapshot, kvstore::Open(snapshot_spec, context).result());
+  EXPECT_THAT(kvstore::Read(snapshot, "a").result(),
+              MatchesKvsReadResult(absl::Cord("1")));
+  EXPECT_THAT(kvstore::Read(snapshot, "b").result(),
+              MatchesKvsReadResultNotFound());
+  EXPECT_THAT(GetMap(snapshot),
+              ::testing::Optional(::testing::ElementsAre(
+                  ::testing::Pair("a", absl::Cord("1")))));
+  EXPECT_THAT(
+      snapshot.spec().value().ToJson(tensorstore::IncludeDefaults{false}),
+      ::testing::Optional(JsonSubValueMatches("/version", 2)));
+
+  // Writes are not supported.
+  EXPECT_EQ(SupportedFeatures::kNone,
+            snapshot.driver->GetSupportedFeatures(KeyRange{}));
+  EXPECT_THAT(kvstore::Write(snapshot, "a", absl::Cord("4")).result(),
+              MatchesStatus(absl::StatusCode::kUnimplemented));
+
+  // Later writes to the database are not visible.
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "c", absl::Cord("5")));
+  EXPECT_THAT(kvstore::Read(snapshot, "c").result(),
+              MatchesKvsReadResultNotFound());
+
+  // Latest version committed at or before the current time.
+  snapshot_spec["version"] =
+      "<=" + absl::FormatTime(absl::Now(), absl::UTCTimeZone());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      snapshot, kvstore::Open(snapshot_spec, context).result());
+  EXPECT_THAT(kvstore::Read(snapshot, "c").result(),
+              MatchesKvsReadResult(absl::Cord("5")));
+
+  snapshot_spec["version"] = 100;
+  EXPECT_THAT(kvstore::Open(snapshot_spec, context).result(),
+              MatchesStatus(absl::StatusCode::kNotFound));
+  snapshot_spec["version"] = "abc";
+  EXPECT_THAT(kvstore::Open(snapshot_spec, context).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(OcdbtTest, CopyRange) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store,
@@ -669,6 +814,67 @@ TEST(OcdbtTest, CopyRange) {
                              })));
 }
 
+// Tests that scans deliver both inline and indirect values in key order, from
+// multiple leaf nodes.
+TEST(OcdbtTest, Scan) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "ocdbt"},
+                                 {"base", "memory://"},
+                                 {"config",
+                                  {{"max_inline_value_bytes", 4},
+                                   {"max_decoded_node_bytes", 1}}}})
+                      .result());
+  std::vector<::testing::Matcher<kvstore::ScanEntry>> expected;
+  for (int i = 0; i < 20; ++i) {
+    std::string key = absl::StrFormat("k%02d", i);
+    absl::Cord value(i % 3 == 0 ? "long value" : "v");
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, key, value));
+    if (i >= 5 && i < 15) {
+      expected.push_back(MatchesScanEntry(key.substr(1), value));
+    }
+  }
+  for (size_t read_ahead : {1, 16}) {
+    SCOPED_TRACE(read_ahead);
+    kvstore::ScanOptions options;
+    options.range = KeyRange("k05", "k15");
+    options.strip_prefix_length = 1;
+    options.read_ahead = read_ahead;
+    EXPECT_THAT(kvstore::ScanFuture(store, options).result(),
+                ::testing::Optional(::testing::ElementsAreArray(expected)));
+  }
+}
+
+// Tests a single commit that produces enough new leaf nodes to be encoded in
+// parallel.
+TEST(OcdbtTest, LargeTransactionalWrite) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({
+                                    {"driver", "ocdbt"},
+                                    {"base", "memory://"},
+                                    {"config",
+                                     {{"max_inline_value_bytes", 1024},
+                                      {"max_decoded_node_bytes", 65536}}},
+                                })
+                      .result());
+  constexpr size_t kNumKeys = 12000;
+  const absl::Cord value(std::string(256, 'x'));
+  auto transaction = tensorstore::Transaction(tensorstore::atomic_isolated);
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto transactional_store,
+                                     store | transaction);
+    for (size_t i = 0; i < kNumKeys; ++i) {
+      TENSORSTORE_ASSERT_OK(kvstore::Write(transactional_store,
+                                           absl::StrFormat("%06d", i), value));
+    }
+    TENSORSTORE_ASSERT_OK(transaction.CommitAsync());
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto map, GetMap(store));
+  EXPECT_EQ(kNumKeys, map.size());
+  EXPECT_THAT(kvstore::Read(store, absl::StrFormat("%06d", kNumKeys / 2))
+                  .result(),
+              MatchesKvsReadResult(value));
+}
+
 TEST(OcdbtTest, TransactionalCopyRange) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, kvstore::Open({
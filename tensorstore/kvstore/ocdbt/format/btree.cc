@@ -237,6 +237,7 @@ Result<BtreeNode> DecodeBtreeNode(const absl::Cord& encoded,
     return tensorstore::MaybeAnnotateStatus(status,
                                             "Error decoding b-tree node");
   }
+  ComputeBtreeNodeKeyHeads(node);
 #ifndef NDEBUG
   CheckBtreeNodeInvariants(node);
 #endif
@@ -320,46 +321,103 @@ std::ostream& operator<<(std::ostream& os, const InteriorNodeEntry& e) {
             << e.subtree_common_prefix_length << ", node=" << e.node << "}";
 }
 
+void ComputeBtreeNodeKeyHeads(BtreeNode& node) {
+  std::visit(
+      [&](const auto& entries) {
+        node.key_heads.resize(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+          node.key_heads[i] = GetBtreeKeyHead(entries[i].key);
+        }
+      },
+      node.entries);
+}
+
+namespace {
+
+// Returns the first element of `[first, last)` not less than `value`.
+//
+// Unlike `std::lower_bound`, the loop body selects the next position with a
+// conditional move rather than a branch, which avoids branch mispredictions
+// on the essentially random comparisons of a binary search.
+const uint64_t* BranchFreeLowerBound(const uint64_t* first,
+                                     const uint64_t* last, uint64_t value) {
+  size_t n = last - first;
+  if (n == 0) return first;
+  while (n > 1) {
+    size_t half = n / 2;
+    first = (first[half] < value) ? first + half : first;
+    n -= half;
+  }
+  return first + (*first < value);
+}
+
+// Returns the first entry in `[first, entries.end())` whose key is not less
+// than `target` (if `kOrEqual` is `false`) or greater than `target` (if
+// `kOrEqual` is `true`).
+template <bool kOrEqual, typename Entry>
+const Entry* PartitionByKey(span<const Entry> entries,
+                            span<const uint64_t> key_heads,
+                            const Entry* first, std::string_view target) {
+  const Entry* last = entries.data() + entries.size();
+  if (key_heads.size() == entries.size()) {
+    // Entries with a smaller head have a smaller key, and entries with a
+    // larger head have a larger key, so only the entries whose head equals
+    // that of `target` require comparing the full keys.
+    const uint64_t head = GetBtreeKeyHead(target);
+    const uint64_t* heads = key_heads.data();
+    const uint64_t* heads_end = heads + key_heads.size();
+    const uint64_t* equal_first = BranchFreeLowerBound(
+        heads + (first - entries.data()), heads_end, head);
+    const uint64_t* equal_last =
+        head == std::numeric_limits<uint64_t>::max()
+            ? heads_end
+            : BranchFreeLowerBound(equal_first, heads_end, head + 1);
+    first = entries.data() + (equal_first - heads);
+    last = entries.data() + (equal_last - heads);
+  }
+  return std::partition_point(first, last, [&](const Entry& entry) {
+    return kOrEqual ? entry.key <= target : entry.key < target;
+  });
+}
+
+}  // namespace
+
 const LeafNodeEntry* FindBtreeEntry(span<const LeafNodeEntry> entries,
-                                    std::string_view key) {
-  const LeafNodeEntry* entry = FindBtreeEntryLowerBound(entries, key);
+                                    std::string_view key,
+                                    span<const uint64_t> key_heads) {
+  const LeafNodeEntry* entry =
+      FindBtreeEntryLowerBound(entries, key, key_heads);
   if (entry == entries.data() + entries.size() || entry->key != key) {
     return nullptr;
   }
   return entry;
 }
 
-const LeafNodeEntry* FindBtreeEntryLowerBound(span<const LeafNodeEntry> entries,
-                                              std::string_view inclusive_min) {
-  return std::lower_bound(
-      entries.data(), entries.data() + entries.size(), inclusive_min,
-      [](const LeafNodeEntry& entry, std::string_view inclusive_min) {
-        return entry.key < inclusive_min;
-      });
+const LeafNodeEntry* FindBtreeEntryLowerBound(
+    span<const LeafNodeEntry> entries, std::string_view inclusive_min,
+    span<const uint64_t> key_heads) {
+  return PartitionByKey</*kOrEqual=*/false>(entries, key_heads,
+                                             entries.data(), inclusive_min);
 }
 
-span<const LeafNodeEntry> FindBtreeEntryRange(span<const LeafNodeEntry> entries,
-                                              std::string_view inclusive_min,
-                                              std::string_view exclusive_max) {
-  const LeafNodeEntry* lower = FindBtreeEntryLowerBound(entries, inclusive_min);
+span<const LeafNodeEntry> FindBtreeEntryRange(
+    span<const LeafNodeEntry> entries, std::string_view inclusive_min,
+    std::string_view exclusive_max, span<const uint64_t> key_heads) {
+  const LeafNodeEntry* lower =
+      FindBtreeEntryLowerBound(entries, inclusive_min, key_heads);
   const LeafNodeEntry* upper = entries.data() + entries.size();
   if (!exclusive_max.empty()) {
-    upper = std::lower_bound(
-        lower, upper, exclusive_max,
-        [](const LeafNodeEntry& entry, std::string_view exclusive_max) {
-          return entry.key < exclusive_max;
-        });
+    upper = PartitionByKey</*kOrEqual=*/false>(entries, key_heads, lower,
+                                                exclusive_max);
   }
   return {lower, upper};
 }
 
 const InteriorNodeEntry* FindBtreeEntry(span<const InteriorNodeEntry> entries,
-                                        std::string_view key) {
-  auto it = std::lower_bound(
-      entries.data(), entries.data() + entries.size(), key,
-      [](const InteriorNodeEntry& entry, std::string_view inclusive_min) {
-        return entry.key <= inclusive_min;
-      });
+                                        std::string_view key,
+                                        span<const uint64_t> key_heads) {
+  auto it = PartitionByKey</*kOrEqual=*/true>(entries, key_heads,
+                                              entries.data(), key);
   if (it == entries.data()) {
     // Key not present.
     return nullptr;
@@ -368,28 +426,23 @@ const InteriorNodeEntry* FindBtreeEntry(span<const InteriorNodeEntry> entries,
 }
 
 const InteriorNodeEntry* FindBtreeEntryLowerBound(
-    span<const InteriorNodeEntry> entries, std::string_view inclusive_min) {
-  auto it = std::lower_bound(
-      entries.data(), entries.data() + entries.size(), inclusive_min,
-      [](const InteriorNodeEntry& entry, std::string_view inclusive_min) {
-        return entry.key <= inclusive_min;
-      });
+    span<const InteriorNodeEntry> entries, std::string_view inclusive_min,
+    span<const uint64_t> key_heads) {
+  auto it = PartitionByKey</*kOrEqual=*/true>(entries, key_heads,
+                                              entries.data(), inclusive_min);
   if (it != entries.data()) --it;
   return it;
 }
 
 span<const InteriorNodeEntry> FindBtreeEntryRange(
     span<const InteriorNodeEntry> entries, std::string_view inclusive_min,
-    std::string_view exclusive_max) {
+    std::string_view exclusive_max, span<const uint64_t> key_heads) {
   const InteriorNodeEntry* lower =
-      FindBtreeEntryLowerBound(entries, inclusive_min);
+      FindBtreeEntryLowerBound(entries, inclusive_min, key_heads);
   const InteriorNodeEntry* upper = entries.data() + entries.size();
   if (!exclusive_max.empty()) {
-    upper = std::lower_bound(
-        lower, upper, exclusive_max,
-        [](const InteriorNodeEntry& entry, std::string_view exclusive_max) {
-          return entry.key < exclusive_max;
-        });
+    upper = PartitionByKey</*kOrEqual=*/false>(entries, key_heads, lower,
+                                                exclusive_max);
   }
   return {lower, upper};
 }
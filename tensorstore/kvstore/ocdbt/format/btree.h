@@ -105,6 +105,8 @@ using BtreeNodeHeight = uint8_t;
 
 using LeafNodeValueReference = std::variant<absl::Cord, IndirectDataReference>;
 
+std::ostream& operator<<(std::ostream& os, const LeafNodeValueReference& x);
+
 using LeafNodeValueKind = uint8_t;
 constexpr LeafNodeValueKind kInlineValue = 0;
 constexpr LeafNodeValueKind kOutOfLineValue = 1;
@@ -225,11 +227,37 @@ struct BtreeNode {
   /// Concatenated key data, referenced by `key_prefix` and `entries`.
   KeyBuffer key_buffer;
 
+  /// Compact search index over the keys of `entries`.
+  ///
+  /// `key_heads[i]` is `GetBtreeKeyHead(entries[i].key)`.  Searching the
+  /// contiguous array of heads first avoids dereferencing the key of every
+  /// entry visited by the binary search, and the full keys are compared only
+  /// among entries whose heads are equal.
+  ///
+  /// Computed by `DecodeBtreeNode`.  May be empty, e.g. for nodes constructed
+  /// directly, in which case searches compare the full keys.
+  std::vector<uint64_t> key_heads;
+
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.height, x.key_prefix, x.entries, x.key_buffer);
+    return f(x.height, x.key_prefix, x.entries, x.key_buffer, x.key_heads);
   };
 };
 
+/// Returns the first 8 bytes of `key`, zero padded, as a big-endian integer.
+///
+/// The ordering of heads is consistent with the lexicographical ordering of
+/// keys: `a < b` implies `GetBtreeKeyHead(a) <= GetBtreeKeyHead(b)`.
+inline uint64_t GetBtreeKeyHead(std::string_view key) {
+  unsigned char buffer[8] = {};
+  std::copy_n(key.data(), std::min(key.size(), size_t{8}), buffer);
+  uint64_t head = 0;
+  for (unsigned char c : buffer) head = (head << 8) | c;
+  return head;
+}
+
+/// Computes `node.key_heads` from `node.entries`.
+void ComputeBtreeNodeKeyHeads(BtreeNode& node);
+
 /// Functions for estimating the size of the in-memory representation of a
 /// B+tree node entry.
 ///
@@ -306,38 +334,46 @@ struct ComparePrefixedKeyToUnprefixedKey {
 
 /// Returns the entry with key equal to `key`, or `nullptr` if there is no such
 /// entry.
+///
+/// If `key_heads` is non-empty, it must equal `BtreeNode::key_heads` of the
+/// node containing `entries`, and is used to accelerate the search.  The same
+/// applies to the other `FindBtreeEntry*` functions.
 const LeafNodeEntry* FindBtreeEntry(span<const LeafNodeEntry> entries,
-                                    std::string_view key);
+                                    std::string_view key,
+                                    span<const uint64_t> key_heads = {});
 
 /// Returns a pointer to the first entry with a key not less than
 /// `inclusive_min`, or a pointer one past the end of `entries` if there is no
 /// such entry.
-const LeafNodeEntry* FindBtreeEntryLowerBound(span<const LeafNodeEntry> entries,
-                                              std::string_view inclusive_min);
+const LeafNodeEntry* FindBtreeEntryLowerBound(
+    span<const LeafNodeEntry> entries, std::string_view inclusive_min,
+    span<const uint64_t> key_heads = {});
 
 /// Returns the sub-span of entries with keys greater or equal to
 /// `inclusive_min` and less than `exclusive_max` (where, as for `KeyRange`, an
 /// empty string for `exclusive_max` indicates no upper bound).
-span<const LeafNodeEntry> FindBtreeEntryRange(span<const LeafNodeEntry> entries,
-                                              std::string_view inclusive_min,
-                                              std::string_view exclusive_max);
+span<const LeafNodeEntry> FindBtreeEntryRange(
+    span<const LeafNodeEntry> entries, std::string_view inclusive_min,
+    std::string_view exclusive_max, span<const uint64_t> key_heads = {});
 
 /// Returns a pointer to the entry whose subtree may contain `key`, or `nullptr`
 /// if no entry has a subtree that may contain `key`.
 const InteriorNodeEntry* FindBtreeEntry(span<const InteriorNodeEntry> entries,
-                                        std::string_view key);
+                                        std::string_view key,
+                                        span<const uint64_t> key_heads = {});
 
 /// Returns a pointer to the first entry whose key range intersects the set of
 /// keys that are not less than `inclusive_min`.
 const InteriorNodeEntry* FindBtreeEntryLowerBound(
-    span<const InteriorNodeEntry> entries, std::string_view inclusive_min);
+    span<const InteriorNodeEntry> entries, std::string_view inclusive_min,
+    span<const uint64_t> key_heads = {});
 
 /// Returns the sub-span of entries whose subtrees intersect the key range
 /// `[inclusive_min, exclusive_max)` (where, as for `KeyRange`, an empty string
 /// for `exclusive_max` indicates no upper bound).
 span<const InteriorNodeEntry> FindBtreeEntryRange(
     span<const InteriorNodeEntry> entries, std::string_view inclusive_min,
-    std::string_view exclusive_max);
+    std::string_view exclusive_max, span<const uint64_t> key_heads = {});
 
 #ifndef NDEBUG
 /// Checks invariants.
@@ -0,0 +1,110 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures point-lookup throughput within a decoded (warm) B+tree node, with
+// and without the `BtreeNode::key_heads` search index.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+
+namespace {
+
+using ::tensorstore::internal_ocdbt::BtreeNode;
+using ::tensorstore::internal_ocdbt::ComputeBtreeNodeKeyHeads;
+using ::tensorstore::internal_ocdbt::FindBtreeEntry;
+using ::tensorstore::internal_ocdbt::InteriorNodeEntry;
+
+// Keys of the form "<8 hex digits>/<index>", i.e. keys which mostly differ
+// within their first 8 bytes, as is typical once the node's common prefix has
+// been removed.
+std::vector<std::string> MakeKeys(size_t num_keys) {
+  std::minstd_rand gen(42);
+  std::vector<std::string> keys;
+  keys.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys.push_back(absl::StrFormat("%08x/%d", gen(), i));
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+std::vector<std::string> MakeProbes(const std::vector<std::string>& keys) {
+  std::minstd_rand gen(7);
+  std::vector<std::string> probes;
+  for (size_t i = 0; i < 1024; ++i) {
+    probes.push_back(keys[gen() % keys.size()]);
+  }
+  return probes;
+}
+
+void BM_FindLeafEntry(benchmark::State& state, bool use_key_heads) {
+  const auto keys = MakeKeys(state.range(0));
+  const auto probes = MakeProbes(keys);
+  BtreeNode node;
+  node.height = 0;
+  auto& entries = node.entries.emplace<BtreeNode::LeafNodeEntries>();
+  for (const auto& key : keys) {
+    entries.push_back({/*.key=*/key, /*.value_reference=*/absl::Cord()});
+  }
+  if (use_key_heads) ComputeBtreeNodeKeyHeads(node);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto* entry = FindBtreeEntry(entries, probes[i++ % probes.size()],
+                                 node.key_heads);
+    ABSL_CHECK(entry);
+    benchmark::DoNotOptimize(entry);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_FindInteriorEntry(benchmark::State& state, bool use_key_heads) {
+  const auto keys = MakeKeys(state.range(0));
+  const auto probes = MakeProbes(keys);
+  BtreeNode node;
+  node.height = 1;
+  auto& entries = node.entries.emplace<BtreeNode::InteriorNodeEntries>();
+  for (const auto& key : keys) {
+    InteriorNodeEntry entry;
+    entry.key = key;
+    entry.subtree_common_prefix_length = 0;
+    entries.push_back(entry);
+  }
+  if (use_key_heads) ComputeBtreeNodeKeyHeads(node);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto* entry = FindBtreeEntry(entries, probes[i++ % probes.size()],
+                                 node.key_heads);
+    ABSL_CHECK(entry);
+    benchmark::DoNotOptimize(entry);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_FindLeafEntry, Keys, false)->Range(16, 16384);
+BENCHMARK_CAPTURE(BM_FindLeafEntry, KeyHeads, true)->Range(16, 16384);
+BENCHMARK_CAPTURE(BM_FindInteriorEntry, Keys, false)->Range(16, 16384);
+BENCHMARK_CAPTURE(BM_FindInteriorEntry, KeyHeads, true)->Range(16, 16384);
+
+}  // namespace
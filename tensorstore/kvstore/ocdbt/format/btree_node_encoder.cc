@@ -343,7 +343,22 @@ Result<std::vector<EncodedNode>> BtreeNodeEncoder<Entry>::Finalize(
     }
   }
 #endif  //  TENSORSTORE_INTERNAL_OCDBT_DEBUG
+  const auto ranges = Partition();
   std::vector<EncodedNode> encoded_nodes;
+  encoded_nodes.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto encoded_node,
+        EncodeNode(range, /*is_root=*/may_be_root && ranges.size() == 1));
+    encoded_nodes.push_back(std::move(encoded_node));
+  }
+  return encoded_nodes;
+}
+
+template <typename Entry>
+std::vector<typename BtreeNodeEncoder<Entry>::NodeEntryRange>
+BtreeNodeEncoder<Entry>::Partition() const {
+  std::vector<NodeEntryRange> ranges;
 
   constexpr size_t kMinArity = std::is_same_v<Entry, LeafNodeEntry> ? 1 : 2;
 
@@ -379,17 +394,20 @@ Result<std::vector<EncodedNode>> BtreeNodeEncoder<Entry>::Finalize(
     }
     assert(end_i > start_i);
     assert(end_i - start_i <= kMaxNodeArity);
-    TENSORSTORE_ASSIGN_OR_RETURN(
-        auto encoded_node,
-        EncodeEntries<Entry>(
-            config_, height_, existing_prefix_,
-            span(buffered_entries_.data() + start_i, end_i - start_i),
-            may_be_root && start_i == 0 && end_i == buffered_entries_.size()));
-    encoded_nodes.push_back(std::move(encoded_node));
+    ranges.push_back({start_i, end_i, get_range_size(end_i)});
     start_i = end_i;
     prev_size_estimate = buffered_entries_[end_i - 1].cumulative_size;
   }
-  return encoded_nodes;
+  return ranges;
+}
+
+template <typename Entry>
+Result<EncodedNode> BtreeNodeEncoder<Entry>::EncodeNode(
+    const NodeEntryRange& range, bool is_root) {
+  return EncodeEntries<Entry>(
+      config_, height_, existing_prefix_,
+      span(buffered_entries_.data() + range.begin, range.end - range.begin),
+      is_root);
 }
 
 void AddNewInteriorEntry(BtreeNodeEncoder<InteriorNodeEntry>& encoder,
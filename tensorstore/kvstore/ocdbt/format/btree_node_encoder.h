@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_FORMAT_BTREE_NODE_ENCODER_H_
 #define TENSORSTORE_KVSTORE_OCDBT_FORMAT_BTREE_NODE_ENCODER_H_
 
+#include <stddef.h>
+
 #include <string>
 #include <string_view>
 #include <vector>
@@ -82,6 +84,29 @@ class BtreeNodeEncoder {
   ///     `0`.  This is needed because no prefix is supported for the root node.
   Result<std::vector<EncodedNode>> Finalize(bool may_be_root);
 
+  /// Range of added entries that forms a single node.
+  struct NodeEntryRange {
+    size_t begin;
+    size_t end;
+
+    /// Estimated decoded size of the node.
+    size_t size_estimate;
+  };
+
+  /// Partitions the added entries into nodes, without encoding them.
+  ///
+  /// `Finalize` is equivalent to calling `EncodeNode` on each returned range.
+  std::vector<NodeEntryRange> Partition() const;
+
+  /// Generates the encoded representation of a single node returned by
+  /// `Partition`.
+  ///
+  /// May be called concurrently from multiple threads for distinct ranges.
+  ///
+  /// \param is_root Indicates whether this is the root node, which requires
+  ///     that `Partition` returned just a single node.
+  Result<EncodedNode> EncodeNode(const NodeEntryRange& range, bool is_root);
+
   // Treat as private:
 
   struct BufferedEntry {
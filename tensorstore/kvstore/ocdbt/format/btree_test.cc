@@ -43,9 +43,13 @@ using ::tensorstore::MatchesStatus;
 using ::tensorstore::Result;
 using ::tensorstore::internal_ocdbt::BtreeNode;
 using ::tensorstore::internal_ocdbt::BtreeNodeEncoder;
+using ::tensorstore::internal_ocdbt::ComputeBtreeNodeKeyHeads;
 using ::tensorstore::internal_ocdbt::Config;
 using ::tensorstore::internal_ocdbt::DecodeBtreeNode;
 using ::tensorstore::internal_ocdbt::EncodedNode;
+using ::tensorstore::internal_ocdbt::FindBtreeEntry;
+using ::tensorstore::internal_ocdbt::FindBtreeEntryLowerBound;
+using ::tensorstore::internal_ocdbt::FindBtreeEntryRange;
 using ::tensorstore::internal_ocdbt::InteriorNodeEntry;
 using ::tensorstore::internal_ocdbt::kMaxNodeArity;
 using ::tensorstore::internal_ocdbt::LeafNodeEntry;
@@ -91,6 +95,7 @@ void TestBtreeNodeRoundTrip(const Config& config, const BtreeNode& node) {
                       decoded_node.key_prefix));
         EXPECT_THAT(decoded_node.entries,
                     ::testing::VariantWith<std::vector<Entry>>(entries));
+        EXPECT_EQ(entries.size(), decoded_node.key_heads.size());
       },
       node.entries);
 }
@@ -109,6 +114,20 @@ TEST(BtreeNodeTest, LeafNodeRoundTrip) {
   TestBtreeNodeRoundTrip(config, node);
 }
 
+TEST(BtreeNodeTest, LeafNodeRoundTripLz4) {
+  Config config;
+  config.compression = Config::Lz4Compression{0};
+  BtreeNode node;
+  node.height = 0;
+  node.key_prefix = "ab";
+  auto& entries = node.entries.emplace<BtreeNode::LeafNodeEntries>();
+  entries.push_back({/*.key =*/"c",
+                     /*.value_reference =*/absl::Cord("value1")});
+  entries.push_back({/*.key =*/"d",
+                     /*.value_reference =*/absl::Cord("value2")});
+  TestBtreeNodeRoundTrip(config, node);
+}
+
 TEST(BtreeNodeTest, InteriorNodeRoundTrip) {
   Config config;
   BtreeNode node;
@@ -318,4 +337,73 @@ TEST(BtreeNodeTest, MaxArity) {
             std::get<BtreeNode::LeafNodeEntries>(decoded_node2.entries).size());
 }
 
+// Checks that searches using `key_heads` agree with searches comparing the
+// full keys, including for keys which are equal in their first 8 bytes.
+TEST(BtreeNodeTest, KeyHeadsSearch) {
+  std::vector<std::string> keys = {
+      "",
+      std::string("\0", 1),
+      "a",
+      std::string("a\0", 2),
+      "a\xff",
+      "abcdefgh",
+      "abcdefgh0",
+      "abcdefgh1",
+      "abcdefgi",
+      "b",
+      "\xff\xff\xff\xff\xff\xff\xff\xff",
+      "\xff\xff\xff\xff\xff\xff\xff\xff\xff",
+  };
+  std::sort(keys.begin(), keys.end());
+
+  BtreeNode leaf;
+  leaf.height = 0;
+  auto& leaf_entries = leaf.entries.emplace<BtreeNode::LeafNodeEntries>();
+  BtreeNode interior;
+  interior.height = 1;
+  auto& interior_entries =
+      interior.entries.emplace<BtreeNode::InteriorNodeEntries>();
+  for (const auto& key : keys) {
+    leaf_entries.push_back({/*.key=*/key, /*.value_reference=*/absl::Cord()});
+    InteriorNodeEntry entry;
+    entry.key = key;
+    entry.subtree_common_prefix_length = 0;
+    interior_entries.push_back(entry);
+  }
+  ComputeBtreeNodeKeyHeads(leaf);
+  ComputeBtreeNodeKeyHeads(interior);
+  ASSERT_EQ(keys.size(), leaf.key_heads.size());
+
+  std::vector<std::string> probes = keys;
+  for (const auto& key : keys) {
+    probes.push_back(key + "0");
+    probes.push_back(key + std::string("\0", 1));
+  }
+  for (const auto& probe : probes) {
+    SCOPED_TRACE(tensorstore::QuoteString(probe));
+    EXPECT_EQ(FindBtreeEntry(leaf_entries, probe),
+              FindBtreeEntry(leaf_entries, probe, leaf.key_heads));
+    EXPECT_EQ(FindBtreeEntryLowerBound(leaf_entries, probe),
+              FindBtreeEntryLowerBound(leaf_entries, probe, leaf.key_heads));
+    EXPECT_EQ(FindBtreeEntry(interior_entries, probe),
+              FindBtreeEntry(interior_entries, probe, interior.key_heads));
+    EXPECT_EQ(
+        FindBtreeEntryLowerBound(interior_entries, probe),
+        FindBtreeEntryLowerBound(interior_entries, probe, interior.key_heads));
+    for (const auto& exclusive_max : probes) {
+      auto expected = FindBtreeEntryRange(leaf_entries, probe, exclusive_max);
+      auto actual = FindBtreeEntryRange(leaf_entries, probe, exclusive_max,
+                                        leaf.key_heads);
+      EXPECT_EQ(expected.data(), actual.data());
+      EXPECT_EQ(expected.size(), actual.size());
+      auto expected_interior =
+          FindBtreeEntryRange(interior_entries, probe, exclusive_max);
+      auto actual_interior = FindBtreeEntryRange(
+          interior_entries, probe, exclusive_max, interior.key_heads);
+      EXPECT_EQ(expected_interior.data(), actual_interior.data());
+      EXPECT_EQ(expected_interior.size(), actual_interior.size());
+    }
+  }
+}
+
 }  // namespace
@@ -19,7 +19,9 @@
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 
 #include "absl/base/internal/endian.h"
@@ -32,7 +34,10 @@
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/limiting_reader.h"
+#include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/string_reader.h"
+#include "riegeli/bytes/string_writer.h"
 #include "riegeli/bytes/writer.h"
 #include "riegeli/digests/crc32c_digester.h"
 #include "riegeli/digests/digesting_reader.h"
@@ -43,6 +48,7 @@
 #include "riegeli/varint/varint_writing.h"
 #include "riegeli/zstd/zstd_reader.h"
 #include "riegeli/zstd/zstd_writer.h"
+#include "tensorstore/internal/compression/lz4.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
@@ -160,6 +166,28 @@ absl::Status DecodeWithOptionalCompression(
         }
         break;
       }
+      case 2: {
+        // LZ4 frames are decoded in one shot rather than streamed.
+        std::string compressed;
+        if (auto status = riegeli::ReadAll(digesting_reader, compressed);
+            !status.ok()) {
+          digesting_reader.Fail(std::move(status));
+          return false;
+        }
+        auto decompressed = lz4::Decode(compressed);
+        if (!decompressed.ok()) {
+          digesting_reader.Fail(absl::DataLossError(
+              decompressed.status().message()));
+          return false;
+        }
+        riegeli::StringReader lz4_reader(*decompressed);
+        success = decode_decompressed(lz4_reader, version) &&
+                  lz4_reader.VerifyEndAndClose();
+        if (!success && !lz4_reader.ok()) {
+          digesting_reader.Fail(lz4_reader.status());
+        }
+        break;
+      }
       default:
         digesting_reader.Fail(absl::DataLossError(absl::StrFormat(
             "Unsupported compression format: %d", compression_format)));
@@ -199,21 +227,38 @@ Result<absl::Cord> EncodeWithOptionalCompression(
     riegeli::DigestingWriter digesting_writer(&writer,
                                               riegeli::Crc32cDigester());
     if (!riegeli::WriteVarint32(version_number, digesting_writer)) return false;
+    if (!riegeli::WriteVarint32(
+            static_cast<uint32_t>(config.compression.index()),
+            digesting_writer)) {
+      return false;
+    }
     if (std::holds_alternative<Config::NoCompression>(config.compression)) {
-      if (!riegeli::WriteVarint32(0, digesting_writer)) return false;
       if (!encode(digesting_writer)) return false;
-    } else {
-      if (!riegeli::WriteVarint32(1, digesting_writer)) return false;
-      const auto& zstd_config =
-          std::get<Config::ZstdCompression>(config.compression);
+    } else if (const auto* zstd_config =
+                   std::get_if<Config::ZstdCompression>(&config.compression)) {
       riegeli::ZstdWriter zstd_writer(
           &digesting_writer,
           riegeli::ZstdWriterBase::Options().set_compression_level(
-              zstd_config.level));
+              zstd_config->level));
       if (!encode(zstd_writer) || !zstd_writer.Close()) {
         digesting_writer.Fail(zstd_writer.status());
         return false;
       }
+    } else {
+      const auto& lz4_config =
+          std::get<Config::Lz4Compression>(config.compression);
+      std::string decompressed;
+      riegeli::StringWriter lz4_writer(&decompressed);
+      if (!encode(lz4_writer) || !lz4_writer.Close()) {
+        digesting_writer.Fail(lz4_writer.status());
+        return false;
+      }
+      auto compressed = lz4::Encode(decompressed, {lz4_config.level});
+      if (!compressed.ok()) {
+        digesting_writer.Fail(std::move(compressed).status());
+        return false;
+      }
+      if (!digesting_writer.Write(*compressed)) return false;
     }
     if (!digesting_writer.Close()) {
       writer.Fail(digesting_writer.status());
@@ -63,6 +63,14 @@ std::ostream& operator<<(std::ostream& os, Config::ZstdCompression x) {
   return os << "zstd{level=" << x.level << "}";
 }
 
+bool operator==(Config::Lz4Compression a, Config::Lz4Compression b) {
+  return a.level == b.level;
+}
+
+std::ostream& operator<<(std::ostream& os, Config::Lz4Compression x) {
+  return os << "lz4{level=" << x.level << "}";
+}
+
 std::ostream& operator<<(std::ostream& os, const Config::Compression& x) {
   std::visit([&](const auto& v) { os << v; }, x);
   return os;
@@ -91,10 +91,25 @@ struct Config {
     };
   };
 
+  struct Lz4Compression {
+    int32_t level;
+    friend bool operator==(Lz4Compression a, Lz4Compression b);
+    friend bool operator!=(Lz4Compression a, Lz4Compression b) {
+      return !(a == b);
+    }
+    friend std::ostream& operator<<(std::ostream& os, Lz4Compression x);
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.level);
+    };
+  };
+
   /// Encoded as:
   ///   0 -> no compression
   ///   1 -> zstd
-  using Compression = std::variant<NoCompression, ZstdCompression>;
+  ///   2 -> lz4
+  using Compression =
+      std::variant<NoCompression, ZstdCompression, Lz4Compression>;
   Compression compression = ZstdCompression{0};
 
   friend std::ostream& operator<<(std::ostream& os, const Compression& x);
@@ -14,6 +14,8 @@
 
 #include "tensorstore/kvstore/ocdbt/format/config_codec.h"
 
+#include <stdint.h>
+
 #include <string>
 #include <variant>
 
@@ -22,6 +24,7 @@
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "riegeli/zstd/zstd_writer.h"
+#include "tensorstore/internal/compression/lz4.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/kvstore/ocdbt/format/codec_util.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
@@ -50,6 +53,26 @@ struct ZstdCompressionOptionsCodec {
   }
 };
 
+struct Lz4CompressionOptionsCodec {
+  template <typename IO, typename T>
+  [[nodiscard]] bool operator()(IO& io, T&& value) const {
+    static_assert(std::is_same_v<IO, riegeli::Reader> ||
+                  std::is_same_v<IO, riegeli::Writer>);
+    if (!LittleEndianCodec<int32_t>{}(io, value.level)) return false;
+    if constexpr (std::is_same_v<IO, riegeli::Reader>) {
+      using Options = lz4::Options;
+      if (value.level < Options::kMinCompressionLevel ||
+          value.level > Options::kMaxCompressionLevel) {
+        io.Fail(absl::InvalidArgumentError(absl::StrFormat(
+            "Lz4 compression level %d is outside valid range [%d, %d]",
+            value.level, Options::kMinCompressionLevel,
+            Options::kMaxCompressionLevel)));
+      }
+    }
+    return true;
+  }
+};
+
 using CompressionMethodCodec = VarintCodec<uint32_t>;
 }  // namespace
 
@@ -67,6 +90,12 @@ bool CompressionConfigCodec::operator()(riegeli::Reader& reader,
         return false;
       }
       break;
+    case 2:
+      if (!Lz4CompressionOptionsCodec{}(
+              reader, value.emplace<Config::Lz4Compression>())) {
+        return false;
+      }
+      break;
     default:
       reader.Fail(absl::InvalidArgumentError(absl::StrFormat(
           "Invalid compression method: %d", compression_method)));
@@ -77,16 +106,14 @@ bool CompressionConfigCodec::operator()(riegeli::Reader& reader,
 
 bool CompressionConfigCodec::operator()(
     riegeli::Writer& writer, const Config::Compression& value) const {
-  if (std::holds_alternative<Config::NoCompression>(value)) {
-    if (!CompressionMethodCodec{}(writer, 0)) {
-      return false;
-    }
-  } else {
-    if (!CompressionMethodCodec{}(writer, 1) ||
-        !ZstdCompressionOptionsCodec{}(
-            writer, std::get<Config::ZstdCompression>(value))) {
-      return false;
-    }
+  if (!CompressionMethodCodec{}(writer, static_cast<uint32_t>(value.index()))) {
+    return false;
+  }
+  if (auto* zstd = std::get_if<Config::ZstdCompression>(&value)) {
+    return ZstdCompressionOptionsCodec{}(writer, *zstd);
+  }
+  if (auto* lz4 = std::get_if<Config::Lz4Compression>(&value)) {
+    return Lz4CompressionOptionsCodec{}(writer, *lz4);
   }
   return true;
 }
@@ -29,6 +29,7 @@ namespace {
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::Result;
 using ::tensorstore::internal_ocdbt::CommitTime;
+using ::tensorstore::internal_ocdbt::Config;
 using ::tensorstore::internal_ocdbt::DecodeManifest;
 using ::tensorstore::internal_ocdbt::Manifest;
 
@@ -78,6 +79,12 @@ Manifest GetSimpleManifest() {
 
 TEST(ManifestTest, RoundTrip) { TestManifestRoundTrip(GetSimpleManifest()); }
 
+TEST(ManifestTest, RoundTripLz4Compression) {
+  auto manifest = GetSimpleManifest();
+  manifest.config.compression = Config::Lz4Compression{9};
+  TestManifestRoundTrip(manifest);
+}
+
 TEST(ManifestTest, RoundTripNonZeroHeight) {
   Manifest manifest;
   {
@@ -246,6 +246,9 @@ absl::Status ValidateVersionTreeNodeReference(
 // Specifies an inclusive upper bound on a version's commit time.
 struct CommitTimeUpperBound {
   CommitTime commit_time;
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.commit_time);
+  };
 };
 
 // Specifies a version.
@@ -16,10 +16,13 @@
 
 #include <stddef.h>
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -40,6 +43,7 @@
 #include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
@@ -62,6 +66,14 @@ namespace {
 
 ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
 
+auto& coalesce_saved_requests = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/ocdbt/coalesce/saved_requests",
+    "OCDBT reads avoided by merging them into other reads");
+
+auto& coalesce_wasted_bytes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/ocdbt/coalesce/wasted_bytes",
+    "Bytes read by merged OCDBT reads that no merged read requested");
+
 absl::Cord DeepCopyCord(const absl::Cord& cord) {
   // If the Cord is flat, skipping the CordBuilder improves performance.
   if (std::optional<absl::string_view> flat = cord.TryFlat();
@@ -134,16 +146,24 @@ struct PendingReadHash {
   }
 };
 
+struct MergeValue;
+
 class CoalesceKvStoreDriver final : public kvstore::Driver {
  public:
   explicit CoalesceKvStoreDriver(kvstore::DriverPtr base, size_t threshold,
                                  size_t merged_threshold,
-                                 absl::Duration interval, Executor executor)
+                                 absl::Duration interval, Executor executor,
+                                 bool adaptive)
       : base_(std::move(base)),
         threshold_(threshold),
         merged_threshold_(merged_threshold),
         interval_(interval),
-        thread_pool_executor_(std::move(executor)) {}
+        thread_pool_executor_(std::move(executor)) {
+    if (adaptive) {
+      cost_model_ = std::make_unique<ReadCostModel>(
+          CoalesceThresholds{threshold, merged_threshold});
+    }
+  }
 
   ~CoalesceKvStoreDriver() override = default;
 
@@ -185,7 +205,9 @@ class CoalesceKvStoreDriver final : public kvstore::Driver {
 
   kvstore::SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
-    return base_->GetSupportedFeatures(key_range);
+    // Only whole-value writes are supported through the coalescing adapter.
+    return base_->GetSupportedFeatures(key_range) &
+           ~kvstore::SupportedFeatures::kByteRangeWrite;
   }
 
   void GarbageCollectionVisit(
@@ -196,12 +218,27 @@ class CoalesceKvStoreDriver final : public kvstore::Driver {
   void StartNextRead(internal::IntrusivePtr<PendingRead> state_ptr);
 
  private:
+  /// Issues a read to `base_`, recording its cost if adaptive.
+  Future<ReadResult> ReadFromBase(const Key& key, ReadOptions options);
+
+  /// Issues the read that satisfies all of the subreads of `merged`.
+  Future<ReadResult> ReadMerged(const Key& key, const MergeValue& merged);
+
+  CoalesceThresholds GetThresholds() {
+    return cost_model_ ? cost_model_->thresholds()
+                       : CoalesceThresholds{threshold_, merged_threshold_};
+  }
+
   kvstore::DriverPtr base_;
   size_t threshold_;
   size_t merged_threshold_;
   absl::Duration interval_;
   Executor thread_pool_executor_;
 
+  /// Determines the thresholds in place of `threshold_` and
+  /// `merged_threshold_`, if adaptive.
+  std::unique_ptr<ReadCostModel> cost_model_;
+
   absl::Mutex mu_;
   absl::flat_hash_set<internal::IntrusivePtr<PendingRead>, PendingReadHash,
                       PendingReadEq>
@@ -252,7 +289,7 @@ Future<kvstore::ReadResult> CoalesceKvStoreDriver::Read(Key key,
   }
 
   // non-interval based trigger
-  auto future = base_->Read(key, std::move(options));
+  auto future = ReadFromBase(key, std::move(options));
   future.ExecuteWhenReady(
       [self = internal::IntrusivePtr<CoalesceKvStoreDriver>(this),
        state = std::move(state_ptr)](ReadyFuture<ReadResult>) {
@@ -265,6 +302,22 @@ Future<kvstore::ReadResult> CoalesceKvStoreDriver::Read(Key key,
   return future;
 }
 
+Future<kvstore::ReadResult> CoalesceKvStoreDriver::ReadFromBase(
+    const Key& key, ReadOptions options) {
+  auto future = base_->Read(key, std::move(options));
+  if (cost_model_) {
+    future.ExecuteWhenReady(
+        [self = internal::IntrusivePtr<CoalesceKvStoreDriver>(this),
+         start_time = absl::Now()](ReadyFuture<ReadResult> ready) {
+          auto& result = ready.result();
+          if (!result.ok() || !result->has_value()) return;
+          self->cost_model_->Record(result->value.size(),
+                                    absl::Now() - start_time);
+        });
+  }
+  return future;
+}
+
 struct MergeValue {
   kvstore::ReadOptions options;
 
@@ -275,6 +328,12 @@ struct MergeValue {
   std::vector<Entry> subreads;
 };
 
+Future<kvstore::ReadResult> CoalesceKvStoreDriver::ReadMerged(
+    const Key& key, const MergeValue& merged) {
+  coalesce_saved_requests.IncrementBy(merged.subreads.size() - 1);
+  return ReadFromBase(key, merged.options);
+}
+
 void OnReadComplete(MergeValue merge_values,
                     ReadyFuture<kvstore::ReadResult> ready) {
   // If there is no value, or there is a single subread, then forward the
@@ -289,6 +348,10 @@ void OnReadComplete(MergeValue merge_values,
     kvstore::ReadResult result = ready.value();
     absl::Cord value = std::move(result.value);
 
+    // The subreads are ordered by their start, so the bytes requested by
+    // them are counted in a single pass.
+    size_t requested_bytes = 0;
+    size_t requested_end = 0;
     for (const auto& e : merge_values.subreads) {
       size_t request_start, request_size;
       if (e.byte_range.inclusive_min < 0) {
@@ -302,10 +365,17 @@ void OnReadComplete(MergeValue merge_values,
       } else {
         request_size = e.byte_range.exclusive_max - e.byte_range.inclusive_min;
       }
+      const size_t start = std::min(request_start, value.size());
+      const size_t end = start + std::min(request_size, value.size() - start);
+      if (end > requested_end) {
+        requested_bytes += end - std::max(start, requested_end);
+        requested_end = end;
+      }
       result.value =
           MaybeDeepCopyCord(value.Subcord(request_start, request_size));
       e.promise.SetResult(result);
     }
+    coalesce_wasted_bytes.IncrementBy(value.size() - requested_bytes);
   }
 }
 
@@ -350,6 +420,7 @@ void CoalesceKvStoreDriver::StartNextRead(
   });
 
   kvstore::Key key = state_ptr->key;
+  const CoalesceThresholds thresholds = GetThresholds();
 
   MergeValue merged;
   const auto& first_pending = pending.front();
@@ -372,7 +443,7 @@ void CoalesceKvStoreDriver::StartNextRead(
       // The options differ from the prior options, so issue the pending
       // request and start another.
       assert(!merged.subreads.empty());
-      auto f = base_->Read(key, merged.options);
+      auto f = ReadMerged(key, merged);
       f.ExecuteWhenReady(
           [merged = std::move(merged)](ReadyFuture<kvstore::ReadResult> ready) {
             OnReadComplete(std::move(merged), std::move(ready));
@@ -382,15 +453,15 @@ void CoalesceKvStoreDriver::StartNextRead(
     } else if (merged.options.byte_range.exclusive_max != -1 &&
                ((e.options.byte_range.inclusive_min -
                      merged.options.byte_range.exclusive_max >
-                 threshold_) ||
-                (merged_threshold_ > 0 &&
-                 merged.options.byte_range.size() > merged_threshold_))) {
+                 thresholds.gap) ||
+                (thresholds.merged > 0 &&
+                 merged.options.byte_range.size() > thresholds.merged))) {
       // The distance from the end of the prior read to the beginning of the
-      // next read exceeds threshold_ or the total merged_size exceeds
-      // merged_threshold_, so issue the pending request and start
+      // next read exceeds the gap threshold or the total merged_size exceeds
+      // the merged threshold, so issue the pending request and start
       // another.
       assert(!merged.subreads.empty());
-      auto f = base_->Read(key, merged.options);
+      auto f = ReadMerged(key, merged);
       f.ExecuteWhenReady(
           [merged = std::move(merged)](ReadyFuture<kvstore::ReadResult> ready) {
             OnReadComplete(std::move(merged), std::move(ready));
@@ -424,7 +495,7 @@ void CoalesceKvStoreDriver::StartNextRead(
   // Issue final request. This request will trigger additional reads via
   // StartNextRead.
   assert(!merged.subreads.empty());
-  auto f = base_->Read(key, merged.options);
+  auto f = ReadMerged(key, merged);
   f.ExecuteWhenReady(
       [self = internal::IntrusivePtr<CoalesceKvStoreDriver>(this),
        merged = std::move(merged),
@@ -442,18 +513,52 @@ void CoalesceKvStoreDriver::StartNextRead(
 
 }  // namespace
 
+void ReadCostModel::Record(size_t bytes, absl::Duration duration) {
+  const double x = static_cast<double>(bytes);
+  const double y = absl::ToDoubleSeconds(duration);
+  absl::MutexLock lock(&mutex_);
+  // Average the initial samples uniformly, rather than weighting the
+  // arbitrary initial means.
+  const double w =
+      std::max(kSampleWeight, 1.0 / static_cast<double>(++num_samples_));
+  mean_x_ += w * (x - mean_x_);
+  mean_y_ += w * (y - mean_y_);
+  mean_xx_ += w * (x * x - mean_xx_);
+  mean_xy_ += w * (x * y - mean_xy_);
+}
+
+CoalesceThresholds ReadCostModel::thresholds() {
+  absl::MutexLock lock(&mutex_);
+  if (num_samples_ < kMinSamples) return initial_;
+  const double var_x = mean_xx_ - mean_x_ * mean_x_;
+  const double cov_xy = mean_xy_ - mean_x_ * mean_y_;
+  // The fit is not meaningful unless the reads differ in size and larger
+  // reads take longer.
+  if (!(var_x > 0) || !(cov_xy > 0)) return initial_;
+  const double seconds_per_byte = cov_xy / var_x;
+  const double latency = mean_y_ - seconds_per_byte * mean_x_;
+  if (!(latency > 0)) return initial_;
+  CoalesceThresholds thresholds;
+  thresholds.gap = static_cast<size_t>(
+      std::clamp(latency / seconds_per_byte, static_cast<double>(kMinGap),
+                 static_cast<double>(kMaxGap)));
+  thresholds.merged = thresholds.gap * kMergedGapRatio;
+  return thresholds;
+}
+
 kvstore::DriverPtr MakeCoalesceKvStoreDriver(kvstore::DriverPtr base,
                                              size_t threshold,
                                              size_t merged_threshold,
                                              absl::Duration interval,
-                                             Executor executor) {
+                                             Executor executor,
+                                             bool adaptive) {
   ABSL_LOG_IF(INFO, ocdbt_logging)
       << "Coalescing reads with threshold: " << threshold
       << ", merged_threshold: " << merged_threshold
-      << ", interval: " << interval;
+      << ", interval: " << interval << ", adaptive: " << adaptive;
   return internal::MakeIntrusivePtr<CoalesceKvStoreDriver>(
       std::move(base), threshold, merged_threshold, interval,
-      std::move(executor));
+      std::move(executor), adaptive);
 }
 
 }  // namespace internal_ocdbt
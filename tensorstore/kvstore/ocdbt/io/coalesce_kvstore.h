@@ -15,22 +15,87 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_IO_COALESCE_KVSTORE_H_
 #define TENSORSTORE_KVSTORE_OCDBT_IO_COALESCE_KVSTORE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/util/executor.h"
 
 namespace tensorstore {
 namespace internal_ocdbt {
 
+/// Thresholds that determine which reads are coalesced.
+struct CoalesceThresholds {
+  /// Maximum gap in bytes between merged ranges.
+  size_t gap = 0;
+
+  /// Maximum size in bytes of a merged read beyond which no further ranges
+  /// are merged, or 0 for no limit.
+  size_t merged = 0;
+};
+
+/// Estimates the fixed latency and the bandwidth of the reads issued to a
+/// kvstore, and derives the coalescing thresholds from them.
+///
+/// The duration of a read of `n` bytes is modeled as `latency + n /
+/// bandwidth`, fit by least squares to recent reads.  Merging two reads
+/// separated by a gap of `g` bytes costs `g / bandwidth` and saves one
+/// `latency`, so the gap threshold is `latency * bandwidth`.  The merged size
+/// is limited to `kMergedGapRatio` times the gap threshold, beyond which the
+/// transfer time dominates and separate reads may proceed in parallel.
+class ReadCostModel {
+ public:
+  /// Weight of each new sample relative to the previous estimate.
+  constexpr static double kSampleWeight = 1.0 / 64;
+
+  /// Number of samples required before the estimate is used.
+  constexpr static int64_t kMinSamples = 16;
+
+  constexpr static size_t kMergedGapRatio = 16;
+
+  /// Bounds on the gap threshold.
+  constexpr static size_t kMinGap = 4 * 1024;
+  constexpr static size_t kMaxGap = 64 * 1024 * 1024;
+
+  /// Uses `initial` until enough reads have been recorded.
+  explicit ReadCostModel(CoalesceThresholds initial) : initial_(initial) {}
+
+  /// Records a read of `bytes` that took `duration`.
+  void Record(size_t bytes, absl::Duration duration);
+
+  /// Returns the current thresholds.
+  CoalesceThresholds thresholds();
+
+ private:
+  const CoalesceThresholds initial_;
+  absl::Mutex mutex_;
+  int64_t num_samples_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Exponentially-weighted means of the size `x` in bytes, the duration `y`
+  // in seconds, `x * x`, and `x * y`.
+  double mean_x_ ABSL_GUARDED_BY(mutex_) = 0;
+  double mean_y_ ABSL_GUARDED_BY(mutex_) = 0;
+  double mean_xx_ ABSL_GUARDED_BY(mutex_) = 0;
+  double mean_xy_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
 /// Adapts a base kvstore to coalesce read ranges.
 ///
 /// Concurrent reads for the same key may be merged if the ranges are
 /// separated by less than threshold bytes. 1MB may be a reasonable value
 /// for reducing GCS reads in the OCDBT driver.
+///
+/// If `adaptive` is `true`, `threshold` and `merged_threshold` are only the
+/// initial values, which are then adjusted to the latency and bandwidth
+/// measured for `base` by a `ReadCostModel`.
 kvstore::DriverPtr MakeCoalesceKvStoreDriver(kvstore::DriverPtr base,
                                              size_t threshold,
                                              size_t merged_threshold,
                                              absl::Duration interval,
-                                             Executor executor);
+                                             Executor executor,
+                                             bool adaptive = false);
 
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
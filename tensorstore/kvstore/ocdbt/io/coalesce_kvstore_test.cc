@@ -14,6 +14,8 @@
 
 #include "tensorstore/kvstore/ocdbt/io/coalesce_kvstore.h"
 
+#include <stddef.h>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/strings/cord.h"
@@ -31,7 +33,9 @@ namespace kvstore = ::tensorstore::kvstore;
 using ::tensorstore::Context;
 using ::tensorstore::OptionalByteRangeRequest;
 using ::tensorstore::internal::MockKeyValueStore;
+using ::tensorstore::internal_ocdbt::CoalesceThresholds;
 using ::tensorstore::internal_ocdbt::MakeCoalesceKvStoreDriver;
+using ::tensorstore::internal_ocdbt::ReadCostModel;
 using ::tensorstore::kvstore::ReadOptions;
 
 TEST(CoalesceKvstoreTest, SimpleRead) {
@@ -264,4 +268,46 @@ TEST(CoalesceKvstoreTest, ReadWithInterval) {
   EXPECT_EQ(read_future4.result().value().value, absl::Cord("7"));
 }
 
+// Records reads of several sizes with the specified cost.
+void RecordReads(ReadCostModel& model, absl::Duration latency,
+                 double bytes_per_second, int num_reads) {
+  for (int i = 1; i <= num_reads; ++i) {
+    const size_t bytes = i * 64 * 1024;
+    model.Record(bytes, latency + absl::Seconds(bytes / bytes_per_second));
+  }
+}
+
+TEST(ReadCostModelTest, InitialThresholds) {
+  ReadCostModel model(CoalesceThresholds{100, 200});
+  RecordReads(model, absl::Milliseconds(10), 1e8,
+              ReadCostModel::kMinSamples - 1);
+  EXPECT_EQ(100u, model.thresholds().gap);
+  EXPECT_EQ(200u, model.thresholds().merged);
+}
+
+TEST(ReadCostModelTest, Adapts) {
+  ReadCostModel model(CoalesceThresholds{100, 200});
+  // Transferring 1MB takes as long as the latency of a request.
+  RecordReads(model, absl::Milliseconds(10), 1e8, 64);
+  auto thresholds = model.thresholds();
+  EXPECT_NEAR(1e6, static_cast<double>(thresholds.gap), 1e4);
+  EXPECT_EQ(thresholds.gap * ReadCostModel::kMergedGapRatio,
+            thresholds.merged);
+}
+
+TEST(ReadCostModelTest, MinGap) {
+  ReadCostModel model(CoalesceThresholds{100, 200});
+  RecordReads(model, absl::Microseconds(1), 1e9, 64);
+  EXPECT_EQ(ReadCostModel::kMinGap, model.thresholds().gap);
+}
+
+TEST(ReadCostModelTest, UniformReads) {
+  ReadCostModel model(CoalesceThresholds{100, 200});
+  for (int i = 0; i < 64; ++i) {
+    model.Record(1024, absl::Milliseconds(10));
+  }
+  // The latency and bandwidth cannot be distinguished.
+  EXPECT_EQ(100u, model.thresholds().gap);
+}
+
 }  // namespace
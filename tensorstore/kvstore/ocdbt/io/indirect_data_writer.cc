@@ -25,10 +25,13 @@
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/mutex.h"
+#include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/ocdbt/format/data_file_id.h"
@@ -53,15 +56,17 @@ class IndirectDataWriter
     : public internal::AtomicReferenceCount<IndirectDataWriter> {
  public:
   explicit IndirectDataWriter(kvstore::KvStore kvstore, std::string prefix,
-                              size_t target_size)
+                              size_t target_size, absl::Duration flush_delay)
       : kvstore_(std::move(kvstore)),
         prefix_(std::move(prefix)),
-        target_size_(target_size) {}
+        target_size_(target_size),
+        flush_delay_(flush_delay) {}
 
   // Treat as private:
   kvstore::KvStore kvstore_;
   std::string prefix_;
   size_t target_size_;
+  absl::Duration flush_delay_;
   absl::Mutex mutex_;
 
   // Count of in-flight flush operations.
@@ -94,6 +99,17 @@ void intrusive_ptr_decrement(IndirectDataWriter* p) {
 }
 
 namespace {
+void MaybeFlush(IndirectDataWriter& self, UniqueWriterLock<absl::Mutex> lock);
+
+// Requests a flush of the data file corresponding to `promise`, if it has not
+// already been flushed.
+void RequestFlush(IndirectDataWriter& self, const Promise<void>& promise) {
+  UniqueWriterLock lock{self.mutex_};
+  if (!HaveSameSharedState(promise, self.promise_)) return;
+  self.flush_requested_ = true;
+  MaybeFlush(self, std::move(lock));
+}
+
 void MaybeFlush(IndirectDataWriter& self, UniqueWriterLock<absl::Mutex> lock) {
   bool buffer_at_target =
       self.target_size_ > 0 && self.buffer_.size() >= self.target_size_;
@@ -153,7 +169,7 @@ void MaybeFlush(IndirectDataWriter& self, UniqueWriterLock<absl::Mutex> lock) {
 }  // namespace
 
 Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
-                         IndirectDataReference& ref) {
+                         IndirectDataReference& ref, size_t alignment) {
   ABSL_LOG_IF(INFO, ocdbt_logging)
       << "Write indirect data: size=" << data.size();
   if (data.empty()) {
@@ -174,12 +190,24 @@ Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
         [self = internal::IntrusivePtr<IndirectDataWriter>(&self)](
             Promise<void> promise) {
           ABSL_LOG_IF(INFO, ocdbt_logging) << "Force called";
-          UniqueWriterLock lock{self->mutex_};
-          if (!HaveSameSharedState(promise, self->promise_)) return;
-          self->flush_requested_ = true;
-          MaybeFlush(*self, std::move(lock));
+          if (self->flush_delay_ <= absl::ZeroDuration()) {
+            RequestFlush(*self, promise);
+            return;
+          }
+          // Defer the flush so that writes issued in the meantime, e.g. by
+          // subsequent commits, are packed into the same data file.
+          internal::ScheduleAt(
+              absl::Now() + self->flush_delay_,
+              [self, promise = std::move(promise)] {
+                RequestFlush(*self, promise);
+              });
         });
   }
+  if (alignment > 1) {
+    if (size_t remainder = self.buffer_.size() % alignment) {
+      self.buffer_.Append(std::string(alignment - remainder, '\0'));
+    }
+  }
   ref.file_id = self.data_file_id_;
   ref.offset = self.buffer_.size();
   ref.length = data.size();
@@ -193,9 +221,10 @@ Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
 
 IndirectDataWriterPtr MakeIndirectDataWriter(kvstore::KvStore kvstore,
                                              std::string prefix,
-                                             size_t target_size) {
+                                             size_t target_size,
+                                             absl::Duration flush_delay) {
   return internal::MakeIntrusivePtr<IndirectDataWriter>(
-      std::move(kvstore), std::move(prefix), target_size);
+      std::move(kvstore), std::move(prefix), target_size, flush_delay);
 }
 
 }  // namespace internal_ocdbt
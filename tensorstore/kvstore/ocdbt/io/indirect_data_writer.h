@@ -18,6 +18,7 @@
 #include <stddef.h>
 
 #include "absl/strings/cord.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
@@ -35,8 +36,11 @@
 /// guaranteed to be durable until the returned future becomes ready.
 ///
 /// Currently, values that are written are buffered in memory until they are
-/// explicitly flushed by forcing a returned future.  In the future, there may
-/// be support for streaming writes and appending to existing keys in the
+/// explicitly flushed by forcing a returned future, or until the buffer
+/// reaches the target size.  If a flush delay is specified, forcing a future
+/// only schedules the flush after the delay, so that writes from subsequent
+/// commits are packed into the same data file.  In the future, there may be
+/// support for streaming writes and appending to existing keys in the
 /// underlying kvstore.
 ///
 /// This is used to store data values and btree nodes.
@@ -50,12 +54,22 @@ using IndirectDataWriterPtr = internal::IntrusivePtr<IndirectDataWriter>;
 void intrusive_ptr_increment(IndirectDataWriter* p);
 void intrusive_ptr_decrement(IndirectDataWriter* p);
 
-IndirectDataWriterPtr MakeIndirectDataWriter(kvstore::KvStore kvstore,
-                                             std::string prefix,
-                                             size_t target_size);
+/// Returns a new writer of data files under `prefix`.
+///
+/// \param target_size Size at which the buffered data file is flushed without
+///     waiting for a future to be forced, or 0 for no limit.
+/// \param flush_delay Time for which a forced flush is deferred to allow
+///     additional writes to be buffered.
+IndirectDataWriterPtr MakeIndirectDataWriter(
+    kvstore::KvStore kvstore, std::string prefix, size_t target_size,
+    absl::Duration flush_delay = absl::ZeroDuration());
 
+/// Buffers `data` for writing, and sets `ref` to its eventual location.
+///
+/// If `alignment > 1`, the data is stored at an offset that is a multiple of
+/// `alignment` within the data file, by inserting zero padding as needed.
 Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
-                         IndirectDataReference& ref);
+                         IndirectDataReference& ref, size_t alignment = 0);
 
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
@@ -23,6 +23,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/strings/cord.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/memory/memory_key_value_store.h"
@@ -152,4 +153,61 @@ TEST(IndirectDataWriter, LimitedSize) {
   EXPECT_THAT(files, ::testing::ElementsAreArray(refs));
 }
 
+TEST(IndirectDataWriter, Alignment) {
+  constexpr size_t kAlignment = 4096;
+
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  auto writer = MakeIndirectDataWriter(
+      tensorstore::kvstore::KvStore(memory_store), "d/", 0);
+
+  std::vector<Future<const void>> futures;
+  std::vector<IndirectDataReference> refs;
+  for (size_t size : {1, 4096, 5000, 10}) {
+    auto& ref = refs.emplace_back();
+    futures.push_back(Write(*writer, GetCord(size), ref, kAlignment));
+    EXPECT_EQ(0, ref.offset % kAlignment);
+    EXPECT_EQ(size, ref.length);
+    EXPECT_EQ(refs[0].file_id, ref.file_id);
+  }
+  EXPECT_EQ(0, refs[0].offset);
+  EXPECT_EQ(4096, refs[1].offset);
+  EXPECT_EQ(8192, refs[2].offset);
+  EXPECT_EQ(16384, refs[3].offset);
+  for (auto& f : futures) {
+    TENSORSTORE_ASSERT_OK(f.result());
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto read_result,
+      tensorstore::kvstore::Read(tensorstore::kvstore::KvStore(memory_store),
+                                 refs[0].file_id.FullPath())
+          .result());
+  EXPECT_EQ(16384 + 10, read_result.value.size());
+}
+
+TEST(IndirectDataWriter, FlushDelay) {
+  auto data = GetCord(100);
+
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  auto mock_key_value_store = MockKeyValueStore::Make();
+  auto writer = MakeIndirectDataWriter(
+      tensorstore::kvstore::KvStore(mock_key_value_store), "d/", 0,
+      absl::Milliseconds(10));
+
+  // Writes issued after the first future is forced, but before the delay
+  // elapses, are packed into the same data file.
+  IndirectDataReference ref1, ref2;
+  auto f1 = Write(*writer, data, ref1);
+  f1.Force();
+  auto f2 = Write(*writer, data, ref2);
+  f2.Force();
+  EXPECT_EQ(ref1.file_id, ref2.file_id);
+  EXPECT_EQ(100, ref2.offset);
+
+  auto r = mock_key_value_store->write_requests.pop();
+  r(memory_store);
+  TENSORSTORE_ASSERT_OK(f1.result());
+  TENSORSTORE_ASSERT_OK(f2.result());
+  EXPECT_TRUE(mock_key_value_store->write_requests.empty());
+}
+
 }  // namespace
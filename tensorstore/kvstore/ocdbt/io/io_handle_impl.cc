@@ -38,6 +38,7 @@
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -52,6 +53,7 @@
 #include "tensorstore/kvstore/ocdbt/io/indirect_data_writer.h"
 #include "tensorstore/kvstore/ocdbt/io/manifest_cache.h"
 #include "tensorstore/kvstore/ocdbt/io/node_cache.h"
+#include "tensorstore/kvstore/ocdbt/io/pinned_btree_nodes.h"
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/read_version.h"
 #include "tensorstore/kvstore/operations.h"
@@ -67,6 +69,10 @@ namespace internal_ocdbt {
 namespace {
 ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
 
+auto& pinned_btree_node_hits = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/ocdbt/pinned_btree_node_hits",
+    "OCDBT B+tree node reads served by pinned nodes");
+
 }  // namespace
 
 class IoHandleImpl : public IoHandle {
@@ -79,11 +85,21 @@ class IoHandleImpl : public IoHandle {
   internal::CachePtr<BtreeNodeCache> btree_node_cache_;
   internal::CachePtr<VersionTreeNodeCache> version_tree_node_cache_;
   IndirectDataWriterPtr indirect_data_writer_[kNumIndirectDataKinds];
+  size_t value_alignment_ = 0;
   kvstore::DriverPtr indirect_data_kvstore_driver_;
+  // Upper levels of the latest B+tree, or `nullptr` if not enabled.
+  PinnedBtreeNodes::Ptr pinned_btree_nodes_;
 
   Future<const std::shared_ptr<const BtreeNode>> GetBtreeNode(
-      const IndirectDataReference& ref) const final {
-    return btree_node_cache_->ReadEntry(ref);
+      const IndirectDataReference& ref, Batch::View batch) const final {
+    if (pinned_btree_nodes_) {
+      if (auto node = pinned_btree_nodes_->Find(ref)) {
+        pinned_btree_node_hits.Increment();
+        return MakeReadyFuture<const std::shared_ptr<const BtreeNode>>(
+            std::move(node));
+      }
+    }
+    return btree_node_cache_->ReadEntry(ref, absl::InfinitePast(), batch);
   }
 
   Future<const std::shared_ptr<const VersionTreeNode>> GetVersionTreeNode(
@@ -191,6 +207,16 @@ class IoHandleImpl : public IoHandle {
       absl::Time staleness_bound) const final {
     auto [promise, future] = PromiseFuturePair<ManifestWithTime>::Make();
     GetManifestOp::Start(this, std::move(promise), staleness_bound);
+    if (pinned_btree_nodes_) {
+      // Refresh the pinned nodes whenever a new manifest is observed.
+      future.ExecuteWhenReady([pinned_btree_nodes = pinned_btree_nodes_](
+                                  ReadyFuture<ManifestWithTime> future) {
+        if (!future.result().ok()) return;
+        const auto& manifest = future.value().manifest;
+        if (!manifest || manifest->versions.empty()) return;
+        pinned_btree_nodes->Update(manifest->latest_version()).IgnoreFuture();
+      });
+    }
     return std::move(future);
   }
 
@@ -356,7 +382,7 @@ class IoHandleImpl : public IoHandle {
                                IndirectDataReference& ref) const final {
     return internal_ocdbt::Write(
         *indirect_data_writer_[static_cast<size_t>(kind)], std::move(data),
-        ref);
+        ref, kind == IndirectDataKind::kValue ? value_alignment_ : 0);
   }
 
   std::string DescribeLocation() const final {
@@ -369,8 +395,10 @@ IoHandle::Ptr MakeIoHandle(
         data_copy_concurrency,
     internal::CachePool* cache_pool, const KvStore& base_kvstore,
     const KvStore& manifest_kvstore, ConfigStatePtr config_state,
-    const DataFilePrefixes& data_file_prefixes, size_t write_target_size,
-    std::optional<ReadCoalesceOptions> read_coalesce_options) {
+    const DataFilePrefixes& data_file_prefixes,
+    const DataFileWriteOptions& data_file_write_options,
+    std::optional<ReadCoalesceOptions> read_coalesce_options,
+    PinnedBtreeNodeOptions pinned_btree_node_options) {
   // Maybe wrap the base driver in CoalesceKvStoreDriver.
   kvstore::DriverPtr driver_with_optional_coalescing =
       read_coalesce_options.has_value()
@@ -379,12 +407,15 @@ IoHandle::Ptr MakeIoHandle(
                 read_coalesce_options->max_overhead_bytes_per_request,
                 read_coalesce_options->max_merged_bytes_per_request,
                 read_coalesce_options->max_interval,
-                data_copy_concurrency->executor)
+                data_copy_concurrency->executor,
+                read_coalesce_options->adaptive)
           : base_kvstore.driver;
   auto impl = internal::MakeIntrusivePtr<IoHandleImpl>();
   impl->base_kvstore_ = base_kvstore;
   impl->config_state = std::move(config_state);
   impl->executor = data_copy_concurrency->executor;
+  impl->maybe_inline_executor = data_copy_concurrency->maybe_inline_executor;
+  impl->value_alignment_ = data_file_write_options.value_alignment;
   auto data_kvstore =
       kvstore::KvStore(driver_with_optional_coalescing, base_kvstore.path);
   {
@@ -401,7 +432,9 @@ IoHandle::Ptr MakeIoHandle(
                        &data_prefix_array[0];
       if (match_i == i) {
         impl->indirect_data_writer_[i] = internal_ocdbt::MakeIndirectDataWriter(
-            data_kvstore, std::string(data_prefix_array[i]), write_target_size);
+            data_kvstore, std::string(data_prefix_array[i]),
+            data_file_write_options.target_size,
+            data_file_write_options.flush_delay);
       } else {
         impl->indirect_data_writer_[i] = impl->indirect_data_writer_[match_i];
       }
@@ -413,6 +446,16 @@ IoHandle::Ptr MakeIoHandle(
       internal_ocdbt::GetDecodedIndirectDataCache<BtreeNodeCache>(
           cache_pool, impl->indirect_data_kvstore_driver_,
           data_copy_concurrency);
+  if (pinned_btree_node_options.max_levels > 0) {
+    // Reads through the node cache directly, rather than through `impl`, to
+    // avoid a reference cycle.
+    impl->pinned_btree_nodes_ = internal::MakeIntrusivePtr<PinnedBtreeNodes>(
+        pinned_btree_node_options, data_copy_concurrency->executor,
+        [cache = impl->btree_node_cache_](const IndirectDataReference& ref,
+                                          Batch::View batch) {
+          return cache->ReadEntry(ref, absl::InfinitePast(), batch);
+        });
+  }
   impl->version_tree_node_cache_ =
       tensorstore::internal_ocdbt::GetDecodedIndirectDataCache<
           tensorstore::internal_ocdbt::VersionTreeNodeCache>(
@@ -444,5 +487,87 @@ IoHandle::Ptr MakeIoHandle(
   return impl;
 }
 
+namespace {
+class SnapshotIoHandle : public IoHandle {
+ public:
+  IoHandle::Ptr base_;
+  std::shared_ptr<const Manifest> manifest_;
+  // Upper levels of the snapshot B+tree, or `nullptr` if not enabled.
+  PinnedBtreeNodes::Ptr pinned_btree_nodes_;
+
+  Future<const std::shared_ptr<const BtreeNode>> GetBtreeNode(
+      const IndirectDataReference& ref, Batch::View batch) const final {
+    if (pinned_btree_nodes_) {
+      if (auto node = pinned_btree_nodes_->Find(ref)) {
+        pinned_btree_node_hits.Increment();
+        return MakeReadyFuture<const std::shared_ptr<const BtreeNode>>(
+            std::move(node));
+      }
+    }
+    return base_->GetBtreeNode(ref, batch);
+  }
+
+  Future<const std::shared_ptr<const VersionTreeNode>> GetVersionTreeNode(
+      const IndirectDataReference& ref) const final {
+    return base_->GetVersionTreeNode(ref);
+  }
+
+  Future<const ManifestWithTime> GetManifest(
+      absl::Time staleness_bound) const final {
+    return MakeReadyFuture<const ManifestWithTime>(
+        ManifestWithTime{manifest_, absl::InfiniteFuture()});
+  }
+
+  Future<kvstore::ReadResult> ReadIndirectData(
+      const IndirectDataReference& ref,
+      kvstore::ReadOptions read_options) const final {
+    return base_->ReadIndirectData(ref, std::move(read_options));
+  }
+
+  Future<TryUpdateManifestResult> TryUpdateManifest(
+      std::shared_ptr<const Manifest> old_manifest,
+      std::shared_ptr<const Manifest> new_manifest,
+      absl::Time time) const final {
+    return absl::FailedPreconditionError(
+        "Cannot modify an OCDBT database opened at a fixed version");
+  }
+
+  Future<const void> WriteData(IndirectDataKind kind, absl::Cord data,
+                               IndirectDataReference& ref) const final {
+    return absl::FailedPreconditionError(
+        "Cannot modify an OCDBT database opened at a fixed version");
+  }
+
+  std::string DescribeLocation() const final {
+    return base_->DescribeLocation();
+  }
+};
+}  // namespace
+
+IoHandle::Ptr MakeSnapshotIoHandle(
+    IoHandle::Ptr base, const Config& config,
+    const BtreeGenerationReference& version,
+    PinnedBtreeNodeOptions pinned_btree_node_options) {
+  auto impl = internal::MakeIntrusivePtr<SnapshotIoHandle>();
+  impl->config_state = base->config_state;
+  impl->executor = base->executor;
+  impl->maybe_inline_executor = base->maybe_inline_executor;
+  auto manifest = std::make_shared<Manifest>();
+  manifest->config = config;
+  manifest->versions.push_back(version);
+  impl->manifest_ = std::move(manifest);
+  if (pinned_btree_node_options.max_levels > 0) {
+    impl->pinned_btree_nodes_ = internal::MakeIntrusivePtr<PinnedBtreeNodes>(
+        pinned_btree_node_options, base->executor,
+        [base](const IndirectDataReference& ref, Batch::View batch) {
+          return base->GetBtreeNode(ref, batch);
+        });
+    // The version never changes, so the pinned nodes are loaded only once.
+    impl->pinned_btree_nodes_->Update(version).IgnoreFuture();
+  }
+  impl->base_ = std::move(base);
+  return impl;
+}
+
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
@@ -27,6 +27,9 @@
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/ocdbt/config.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io/pinned_btree_nodes.h"
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
 
 namespace tensorstore {
@@ -42,10 +45,28 @@ struct DataFilePrefixes {
   };
 };
 
+struct DataFileWriteOptions {
+  /// Size at which a data file is written without waiting for a flush, or 0
+  /// for no limit.
+  size_t target_size = 0;
+
+  /// Time for which a flush is deferred, so that writes from concurrent or
+  /// subsequent commits are packed into the same data file.
+  absl::Duration flush_delay = absl::ZeroDuration();
+
+  /// Alignment of the offset of each indirect value within its data file, or
+  /// 0 for no alignment.  Does not apply to B+tree and version tree nodes.
+  size_t value_alignment = 0;
+};
+
 struct ReadCoalesceOptions {
   int64_t max_overhead_bytes_per_request;
   int64_t max_merged_bytes_per_request;
   absl::Duration max_interval;
+
+  /// Adapt the byte thresholds to the measured latency and bandwidth of the
+  /// base kvstore, see `ReadCostModel`.
+  bool adaptive = false;
 };
 
 /// Returns an `IoHandle` handle based on the specified arguments.
@@ -54,8 +75,26 @@ IoHandle::Ptr MakeIoHandle(
         data_copy_concurrency,
     internal::CachePool* cache_pool, const KvStore& base_kvstore,
     const KvStore& manifest_kvstore, ConfigStatePtr config_state,
-    const DataFilePrefixes& data_file_prefixes, size_t write_target_size = 0,
-    std::optional<ReadCoalesceOptions> read_coalesce_options = std::nullopt);
+    const DataFilePrefixes& data_file_prefixes,
+    const DataFileWriteOptions& data_file_write_options = {},
+    std::optional<ReadCoalesceOptions> read_coalesce_options = std::nullopt,
+    PinnedBtreeNodeOptions pinned_btree_node_options = {});
+
+/// Returns a read-only `IoHandle` for a single, fixed version of the database
+/// accessed by `base`.
+///
+/// Since B+tree nodes and data files are immutable once written, no
+/// revalidation is ever needed: `GetManifest` always returns a manifest
+/// containing only `version`, with a timestamp of `absl::InfiniteFuture()`,
+/// and never reads the stored manifest.  `TryUpdateManifest` and `WriteData`
+/// fail.
+///
+/// If `pinned_btree_node_options.max_levels > 0`, the upper levels of
+/// `version` (rather than of the latest version) are pinned.
+IoHandle::Ptr MakeSnapshotIoHandle(
+    IoHandle::Ptr base, const Config& config,
+    const BtreeGenerationReference& version,
+    PinnedBtreeNodeOptions pinned_btree_node_options = {});
 
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
@@ -26,6 +26,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/time/time.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
@@ -110,7 +111,8 @@ class DecodedIndirectDataCache
 
   Future<const std::shared_ptr<const T>> ReadEntry(
       const IndirectDataReference& ref,
-      absl::Time staleness_bound = absl::InfinitePast()) {
+      absl::Time staleness_bound = absl::InfinitePast(),
+      Batch::View batch = no_batch) {
     auto entry = GetEntry(ref);
     auto* entry_ptr = entry.get();
     return PromiseFuturePair<std::shared_ptr<const T>>::LinkValue(
@@ -120,7 +122,7 @@ class DecodedIndirectDataCache
                  promise.SetResult(
                      internal::AsyncCache::ReadLock<T>(*entry).shared_data());
                },
-               entry_ptr->Read({staleness_bound}))
+               entry_ptr->Read({staleness_bound, batch}))
         .future;
   }
 
@@ -0,0 +1,222 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/io/pinned_btree_nodes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+auto& pinned_btree_refreshes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/ocdbt/pinned_btree_refreshes",
+    "OCDBT pinned B+tree node set refreshes");
+
+ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+}  // namespace
+
+// Reads the pinned levels breadth-first, one batch per level.
+struct PinnedBtreeNodes::RefreshOperation
+    : public internal::AtomicReferenceCount<RefreshOperation> {
+  using Ptr = internal::IntrusivePtr<RefreshOperation>;
+
+  PinnedBtreeNodes::Ptr self;
+  uint64_t refresh_generation;
+  Promise<void> promise;
+
+  // Previously pinned nodes, which are reused rather than re-read.
+  std::shared_ptr<const NodeMap> old_nodes;
+
+  std::shared_ptr<NodeMap> new_nodes = std::make_shared<NodeMap>();
+  uint64_t num_bytes = 0;
+  size_t level = 0;
+
+  // Nodes of the current level, and the futures for reading them.
+  std::vector<IndirectDataReference> refs;
+  std::vector<Future<const std::shared_ptr<const BtreeNode>>> futures;
+
+  static void Start(Ptr op) {
+    auto& self = *op->self;
+    op->futures.clear();
+    op->futures.reserve(op->refs.size());
+    {
+      Batch batch = Batch::New();
+      for (const auto& ref : op->refs) {
+        if (op->old_nodes) {
+          auto it = op->old_nodes->find(ref.EncodeCacheKey());
+          if (it != op->old_nodes->end()) {
+            op->futures.push_back(MakeReadyFuture<
+                                  const std::shared_ptr<const BtreeNode>>(
+                it->second));
+            continue;
+          }
+        }
+        op->futures.push_back(self.reader_(ref, batch));
+      }
+    }
+    auto all_future = WaitAllFuture(tensorstore::span(op->futures));
+    auto* op_ptr = op.get();
+    Link(WithExecutor(self.executor_,
+                      [op = std::move(op)](Promise<void> promise,
+                                           ReadyFuture<void> future) mutable {
+                        // On error, `future` may become ready before all of
+                        // the reads complete.
+                        if (!future.result().ok()) {
+                          ABSL_LOG_IF(INFO, ocdbt_logging)
+                              << "PinnedBtreeNodes: refresh failed: "
+                              << future.status();
+                          Finish(std::move(op), /*success=*/false);
+                          return;
+                        }
+                        LevelReady(std::move(op));
+                      }),
+         op_ptr->promise, std::move(all_future));
+  }
+
+  static void LevelReady(Ptr op) {
+    const auto& options = op->self->options_;
+    std::vector<IndirectDataReference> children;
+    for (size_t i = 0; i < op->refs.size(); ++i) {
+      const auto& ref = op->refs[i];
+      if (options.max_bytes != 0 &&
+          op->num_bytes + ref.length > options.max_bytes) {
+        // The byte budget is exhausted; pin a prefix of this level only.
+        Finish(std::move(op), /*success=*/true);
+        return;
+      }
+      op->num_bytes += ref.length;
+      const auto& node = op->futures[i].value();
+      op->new_nodes->emplace(ref.EncodeCacheKey(), node);
+      if (auto* entries =
+              std::get_if<BtreeNode::InteriorNodeEntries>(&node->entries)) {
+        for (const auto& entry : *entries) {
+          children.push_back(entry.node.location);
+        }
+      }
+    }
+    op->futures.clear();
+    if (++op->level == options.max_levels || children.empty()) {
+      Finish(std::move(op), /*success=*/true);
+      return;
+    }
+    op->refs = std::move(children);
+    Start(std::move(op));
+  }
+
+  static void Finish(Ptr op, bool success) {
+    auto& self = *op->self;
+    absl::MutexLock lock(&self.mutex_);
+    if (op->refresh_generation != self.refresh_generation_) return;
+    if (!success) {
+      // Retry on the next update.
+      self.root_ = IndirectDataReference::Missing();
+      return;
+    }
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "PinnedBtreeNodes: pinned " << op->new_nodes->size()
+        << " nodes, " << op->num_bytes << " bytes";
+    self.nodes_ = std::move(op->new_nodes);
+    self.num_bytes_ = op->num_bytes;
+  }
+};
+
+PinnedBtreeNodes::PinnedBtreeNodes(PinnedBtreeNodeOptions options,
+                                   Executor executor, Reader reader)
+    : options_(options),
+      executor_(std::move(executor)),
+      reader_(std::move(reader)),
+      root_(IndirectDataReference::Missing()),
+      refresh_future_(MakeReadyFuture()) {}
+
+std::shared_ptr<const BtreeNode> PinnedBtreeNodes::Find(
+    const IndirectDataReference& ref) const {
+  std::shared_ptr<const NodeMap> nodes;
+  {
+    absl::MutexLock lock(&mutex_);
+    nodes = nodes_;
+  }
+  if (!nodes) return nullptr;
+  auto it = nodes->find(ref.EncodeCacheKey());
+  if (it == nodes->end()) return nullptr;
+  return it->second;
+}
+
+Future<const void> PinnedBtreeNodes::Update(
+    const BtreeGenerationReference& version) {
+  if (options_.max_levels == 0) return MakeReadyFuture();
+  const auto& root = version.root.location;
+  auto op = internal::MakeIntrusivePtr<RefreshOperation>();
+  {
+    absl::MutexLock lock(&mutex_);
+    if (root == root_) return refresh_future_;
+    root_ = root;
+    op->refresh_generation = ++refresh_generation_;
+    if (root.IsMissing()) {
+      // Empty tree.
+      nodes_ = nullptr;
+      num_bytes_ = 0;
+      refresh_future_ = MakeReadyFuture();
+      return refresh_future_;
+    }
+    op->old_nodes = nodes_;
+    auto [promise, future] = PromiseFuturePair<void>::Make(absl::OkStatus());
+    op->promise = std::move(promise);
+    refresh_future_ = std::move(future);
+  }
+  pinned_btree_refreshes.Increment();
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "PinnedBtreeNodes: refreshing for generation "
+      << version.generation_number << ", root=" << root;
+  op->self.reset(this);
+  op->refs.push_back(root);
+  auto future = op->promise.future();
+  RefreshOperation::Start(std::move(op));
+  return future;
+}
+
+size_t PinnedBtreeNodes::num_nodes() const {
+  absl::MutexLock lock(&mutex_);
+  return nodes_ ? nodes_->size() : 0;
+}
+
+uint64_t PinnedBtreeNodes::num_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return num_bytes_;
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
@@ -0,0 +1,127 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_IO_PINNED_BTREE_NODES_H_
+#define TENSORSTORE_KVSTORE_OCDBT_IO_PINNED_BTREE_NODES_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+
+/// \file
+///
+/// `PinnedBtreeNodes` holds the upper levels of the B+tree of the latest
+/// version in memory, independent of the `BtreeNodeCache`.
+///
+/// The upper levels are accessed by every read, but compete for space in the
+/// shared cache pool with bulk data and may be evicted under scan load, which
+/// adds a round trip per level to subsequent cold reads.
+///
+/// B+tree nodes are immutable, so a pinned node remains valid for as long as
+/// it is held; the pinned set is merely refreshed, asynchronously, when the
+/// root of the latest version changes.
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+struct PinnedBtreeNodeOptions {
+  /// Number of levels of the B+tree, starting from the root, to pin.  Pinning
+  /// is disabled if equal to 0.
+  size_t max_levels = 0;
+
+  /// Maximum total encoded size of the pinned nodes.  Levels are pinned in
+  /// order starting from the root until this budget is exhausted.  If equal
+  /// to 0, the size is unlimited.
+  uint64_t max_bytes = 0;
+};
+
+class PinnedBtreeNodes
+    : public internal::AtomicReferenceCount<PinnedBtreeNodes> {
+ public:
+  using Ptr = internal::IntrusivePtr<PinnedBtreeNodes>;
+
+  /// Function used to read nodes which are not already pinned.
+  using Reader =
+      std::function<Future<const std::shared_ptr<const BtreeNode>>(
+          const IndirectDataReference& ref, Batch::View batch)>;
+
+  PinnedBtreeNodes(PinnedBtreeNodeOptions options, Executor executor,
+                   Reader reader);
+
+  /// Returns the pinned node at `ref`, or `nullptr` if it is not pinned.
+  std::shared_ptr<const BtreeNode> Find(const IndirectDataReference& ref) const;
+
+  /// Ensures the pinned nodes correspond to the B+tree rooted at `version`.
+  ///
+  /// If the root differs from the current root, starts an asynchronous
+  /// refresh.  Nodes shared with the previous tree are retained without
+  /// being re-read.  Until the refresh completes, the previously pinned nodes
+  /// remain available.
+  ///
+  /// The returned future becomes ready when the pinned nodes correspond to
+  /// `version`, or when the refresh is superseded or fails.
+  Future<const void> Update(const BtreeGenerationReference& version);
+
+  /// Returns the number and total encoded size of the pinned nodes.
+  size_t num_nodes() const;
+  uint64_t num_bytes() const;
+
+  const PinnedBtreeNodeOptions& options() const { return options_; }
+
+ private:
+  struct RefreshOperation;
+
+  // Pinned nodes, keyed by `IndirectDataReference::EncodeCacheKey`.
+  using NodeMap =
+      absl::flat_hash_map<std::string, std::shared_ptr<const BtreeNode>>;
+
+  PinnedBtreeNodeOptions options_;
+  Executor executor_;
+  Reader reader_;
+
+  mutable absl::Mutex mutex_;
+
+  // Root which the pinned nodes correspond to, or which the in-progress
+  // refresh targets.
+  IndirectDataReference root_ ABSL_GUARDED_BY(mutex_);
+
+  // Incremented whenever a refresh starts; a refresh only installs its nodes
+  // if it has not been superseded.
+  uint64_t refresh_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Completion of the most recent refresh.
+  Future<const void> refresh_future_ ABSL_GUARDED_BY(mutex_);
+
+  std::shared_ptr<const NodeMap> nodes_ ABSL_GUARDED_BY(mutex_);
+  uint64_t num_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_IO_PINNED_BTREE_NODES_H_
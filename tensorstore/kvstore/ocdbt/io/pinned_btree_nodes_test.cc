@@ -0,0 +1,179 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/io/pinned_btree_nodes.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Batch;
+using ::tensorstore::Future;
+using ::tensorstore::InlineExecutor;
+using ::tensorstore::MakeReadyFuture;
+using ::tensorstore::internal_ocdbt::BtreeGenerationReference;
+using ::tensorstore::internal_ocdbt::BtreeNode;
+using ::tensorstore::internal_ocdbt::IndirectDataReference;
+using ::tensorstore::internal_ocdbt::InteriorNodeEntry;
+using ::tensorstore::internal_ocdbt::PinnedBtreeNodeOptions;
+using ::tensorstore::internal_ocdbt::PinnedBtreeNodes;
+
+IndirectDataReference Ref(uint64_t offset, uint64_t length) {
+  IndirectDataReference ref{};
+  ref.offset = offset;
+  ref.length = length;
+  return ref;
+}
+
+// In-memory B+tree nodes, keyed by offset.
+class FakeTree {
+ public:
+  void AddNode(const IndirectDataReference& ref, int height,
+               std::vector<IndirectDataReference> children = {}) {
+    auto node = std::make_shared<BtreeNode>();
+    node->height = height;
+    if (height == 0) {
+      node->entries = BtreeNode::LeafNodeEntries{};
+    } else {
+      BtreeNode::InteriorNodeEntries entries;
+      for (const auto& child : children) {
+        InteriorNodeEntry entry;
+        entry.subtree_common_prefix_length = 0;
+        entry.node.location = child;
+        entries.push_back(entry);
+      }
+      node->entries = std::move(entries);
+    }
+    nodes_[ref.offset] = std::move(node);
+  }
+
+  PinnedBtreeNodes::Ptr MakePinned(PinnedBtreeNodeOptions options) {
+    return tensorstore::internal::MakeIntrusivePtr<PinnedBtreeNodes>(
+        options, InlineExecutor{},
+        [this](const IndirectDataReference& ref, Batch::View batch)
+            -> Future<const std::shared_ptr<const BtreeNode>> {
+          reads_.push_back(ref.offset);
+          auto it = nodes_.find(ref.offset);
+          if (it == nodes_.end()) return absl::NotFoundError("missing node");
+          return MakeReadyFuture<const std::shared_ptr<const BtreeNode>>(
+              it->second);
+        });
+  }
+
+  const std::vector<uint64_t>& reads() const { return reads_; }
+
+ private:
+  absl::flat_hash_map<uint64_t, std::shared_ptr<const BtreeNode>> nodes_;
+  std::vector<uint64_t> reads_;
+};
+
+BtreeGenerationReference Version(const IndirectDataReference& root,
+                                 int root_height) {
+  BtreeGenerationReference version{};
+  version.root.location = root;
+  version.root_height = root_height;
+  version.generation_number = 1;
+  return version;
+}
+
+// root(0) -> a(100), b(150);  a -> c(200);  b -> d(210)
+void AddDefaultTree(FakeTree& tree) {
+  tree.AddNode(Ref(0, 100), 2, {Ref(100, 50), Ref(150, 50)});
+  tree.AddNode(Ref(100, 50), 1, {Ref(200, 10)});
+  tree.AddNode(Ref(150, 50), 1, {Ref(210, 10)});
+  tree.AddNode(Ref(200, 10), 0);
+  tree.AddNode(Ref(210, 10), 0);
+}
+
+TEST(PinnedBtreeNodesTest, PinsTopLevels) {
+  FakeTree tree;
+  AddDefaultTree(tree);
+  auto pinned = tree.MakePinned({/*.max_levels=*/2});
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(0, 100), 2)).result());
+  EXPECT_EQ(3, pinned->num_nodes());
+  EXPECT_EQ(200, pinned->num_bytes());
+  EXPECT_TRUE(pinned->Find(Ref(0, 100)));
+  EXPECT_TRUE(pinned->Find(Ref(150, 50)));
+  EXPECT_FALSE(pinned->Find(Ref(200, 10)));
+  EXPECT_THAT(tree.reads(), ::testing::ElementsAre(0, 100, 150));
+
+  // Updating to the same root does not re-read.
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(0, 100), 2)).result());
+  EXPECT_EQ(3, tree.reads().size());
+}
+
+TEST(PinnedBtreeNodesTest, ByteBudget) {
+  FakeTree tree;
+  AddDefaultTree(tree);
+  auto pinned = tree.MakePinned({/*.max_levels=*/3, /*.max_bytes=*/160});
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(0, 100), 2)).result());
+  EXPECT_EQ(2, pinned->num_nodes());
+  EXPECT_EQ(150, pinned->num_bytes());
+  EXPECT_TRUE(pinned->Find(Ref(100, 50)));
+  EXPECT_FALSE(pinned->Find(Ref(150, 50)));
+}
+
+TEST(PinnedBtreeNodesTest, RefreshReusesSharedNodes) {
+  FakeTree tree;
+  AddDefaultTree(tree);
+  // New root which shares `a` with the previous version.
+  tree.AddNode(Ref(300, 100), 2, {Ref(100, 50), Ref(400, 50)});
+  tree.AddNode(Ref(400, 50), 1, {Ref(210, 10)});
+
+  auto pinned = tree.MakePinned({/*.max_levels=*/2});
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(0, 100), 2)).result());
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(300, 100), 2)).result());
+  EXPECT_THAT(tree.reads(), ::testing::ElementsAre(0, 100, 150, 300, 400));
+  EXPECT_EQ(3, pinned->num_nodes());
+  EXPECT_TRUE(pinned->Find(Ref(300, 100)));
+  EXPECT_TRUE(pinned->Find(Ref(100, 50)));
+  EXPECT_FALSE(pinned->Find(Ref(0, 100)));
+}
+
+TEST(PinnedBtreeNodesTest, ReadErrorRetainsPreviousNodes) {
+  FakeTree tree;
+  AddDefaultTree(tree);
+  tree.AddNode(Ref(300, 100), 2, {Ref(500, 50)});
+
+  auto pinned = tree.MakePinned({/*.max_levels=*/2});
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(0, 100), 2)).result());
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(300, 100), 2)).result());
+  EXPECT_TRUE(pinned->Find(Ref(0, 100)));
+  EXPECT_FALSE(pinned->Find(Ref(300, 100)));
+
+  // The failed refresh is retried on the next update.
+  tree.AddNode(Ref(500, 50), 1, {Ref(200, 10)});
+  TENSORSTORE_ASSERT_OK(pinned->Update(Version(Ref(300, 100), 2)).result());
+  EXPECT_TRUE(pinned->Find(Ref(300, 100)));
+  EXPECT_TRUE(pinned->Find(Ref(500, 50)));
+}
+
+}  // namespace
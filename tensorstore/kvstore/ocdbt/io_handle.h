@@ -23,6 +23,7 @@
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/kvstore/ocdbt/config.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
@@ -45,8 +46,11 @@ class ReadonlyIoHandle
   using Ptr = internal::IntrusivePtr<const ReadonlyIoHandle>;
 
   /// Reads the B+tree node at the specified location.
+  ///
+  /// If `batch` is specified, the read may be deferred until the batch is
+  /// submitted and coalesced with other reads in the same batch.
   virtual Future<const std::shared_ptr<const BtreeNode>> GetBtreeNode(
-      const IndirectDataReference& ref) const = 0;
+      const IndirectDataReference& ref, Batch::View batch = no_batch) const = 0;
 
   /// Reads the version tree node at the specified location.
   virtual Future<const std::shared_ptr<const VersionTreeNode>>
@@ -64,6 +68,11 @@ class ReadonlyIoHandle
   ConfigStatePtr config_state;
   Executor executor;
 
+  /// Equivalent to `executor`, except that continuations are run inline when
+  /// already on a thread of `executor`.  Must only be used for cheap callbacks
+  /// that merely issue further asynchronous operations.
+  Executor maybe_inline_executor;
+
   virtual ~ReadonlyIoHandle();
 };
 
@@ -25,6 +25,11 @@
 //
 // The actual commit logic is implemented in `btree_writer_commit_operation.h`.
 //
+// Once a commit operation has flushed its new B+tree nodes and begins writing
+// the new manifest, it hands off to the next commit operation, which is
+// speculatively based on the manifest being written.  This allows B+tree
+// updates to be pipelined, while the manifest writes remain serialized.
+//
 
 #include "tensorstore/kvstore/ocdbt/non_distributed/btree_writer.h"
 
@@ -82,7 +87,8 @@ class NonDistributedBtreeWriter : public BtreeWriter {
 
   IoHandle::Ptr io_handle_;
 
-  // Guards access to `pending_` and `commit_in_progress_`.
+  // Guards access to `pending_`, `commit_in_progress_`, and
+  // `pending_manifest_update_`.
   absl::Mutex mutex_;
 
   // Requested write operations that are not yet being committed.  A commit is
@@ -91,9 +97,15 @@ class NonDistributedBtreeWriter : public BtreeWriter {
   // requests are enqueued here.
   PendingRequests pending_;
 
-  // Indicates whether a commit operation is in progress.  Currently guaranteed
-  // to be `true` if `pending_` is not empty.
+  // Indicates whether a commit operation is in progress that has not yet
+  // started writing its new manifest.  Currently guaranteed to be `true` if
+  // `pending_` is not empty.
   bool commit_in_progress_;
+
+  // Manifest update of the most recent commit operation that has started
+  // writing its new manifest, if it has not yet completed.  The next commit
+  // operation is based on it.
+  PendingManifestUpdate::Ptr pending_manifest_update_;
 };
 
 struct CommitOperation final
@@ -105,6 +117,10 @@ struct CommitOperation final
   NonDistributedBtreeWriter::Ptr writer_;
   StagedMutations staged_;
 
+  // Set once this commit has started writing its new manifest, at which point
+  // it no longer stages additional pending requests.
+  PendingManifestUpdate::Ptr manifest_update_;
+
   // Starts a commit operation (by calling `Start`) if one is not already in
   // progress.
   //
@@ -125,7 +141,9 @@ struct CommitOperation final
   //
   // Args:
   //   writer: Writer with pending mutations to commit.
-  static void Start(NonDistributedBtreeWriter& writer);
+  //   base: Manifest update of the previous commit, if still in progress.
+  static void Start(NonDistributedBtreeWriter& writer,
+                    PendingManifestUpdate::Ptr base);
 
   // Fails the commit operation.
   void Fail(const absl::Status& error) override;
@@ -140,6 +158,12 @@ struct CommitOperation final
 
   void Retry() override { ReadManifest(); }
 
+  // Allows the next commit operation to start.
+  void ManifestUpdateStarted() override;
+
+  // Marks `manifest_update_` as complete.
+  void FinishManifestUpdate(bool success);
+
   MutationEntryTree& GetEntries() override { return staged_.entries; }
 
   void CommitSuccessful(absl::Time time) override;
@@ -151,25 +175,67 @@ void CommitOperation::MaybeStart(NonDistributedBtreeWriter& writer,
   // TODO(jbms): Consider adding a delay here, using `ScheduleAt`.
 
   // Start commit
-  ABSL_LOG_IF(INFO, ocdbt_logging) << "Starting commit";
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "Starting commit, speculative=" << !!writer.pending_manifest_update_;
   writer.commit_in_progress_ = true;
+  auto base = writer.pending_manifest_update_;
   lock.unlock();
 
-  CommitOperation::Start(writer);
+  CommitOperation::Start(writer, std::move(base));
 }
 
-void CommitOperation::Start(NonDistributedBtreeWriter& writer) {
+void CommitOperation::Start(NonDistributedBtreeWriter& writer,
+                            PendingManifestUpdate::Ptr base) {
   auto commit_op = new CommitOperation(writer.io_handle_);
   // Will be deallocated when operation completes, either by `Fail` or
   // `CommitSuccessful`.
   commit_op->writer_.reset(&writer);
+  commit_op->base_manifest_update_ = std::move(base);
   commit_op->ReadManifest();
 }
 
+void CommitOperation::ManifestUpdateStarted() {
+  if (manifest_update_) return;
+  manifest_update_ = internal::MakeIntrusivePtr<PendingManifestUpdate>();
+  manifest_update_->manifest = new_manifest_;
+  auto [promise, future] = PromiseFuturePair<void>::Make();
+  manifest_update_->promise = std::move(promise);
+  manifest_update_->future = std::move(future);
+  auto& writer = *writer_;
+  UniqueWriterLock lock(writer.mutex_);
+  writer.pending_manifest_update_ = manifest_update_;
+  writer.commit_in_progress_ = false;
+  if (!writer.pending_.requests.empty()) {
+    CommitOperation::MaybeStart(writer, std::move(lock));
+  }
+}
+
+void CommitOperation::FinishManifestUpdate(bool success) {
+  auto& writer = *writer_;
+  {
+    absl::MutexLock lock(&writer.mutex_);
+    if (writer.pending_manifest_update_ == manifest_update_) {
+      writer.pending_manifest_update_.reset();
+    }
+  }
+  if (success) {
+    manifest_update_->promise.SetResult(absl::OkStatus());
+  } else {
+    manifest_update_->promise.SetResult(
+        absl::AbortedError("Speculative manifest not written"));
+  }
+}
+
 void CommitOperation::Fail(const absl::Status& error) {
   ABSL_LOG_IF(INFO, ocdbt_logging) << "Commit failed: " << error;
   CommitFailed(staged_, error);
   auto& writer = *writer_;
+  if (manifest_update_) {
+    // Pending requests are owned by the next commit operation.
+    FinishManifestUpdate(/*success=*/false);
+    delete this;
+    return;
+  }
   PendingRequests pending;
   {
     UniqueWriterLock lock(writer.mutex_);
@@ -195,6 +261,9 @@ void CommitOperation::Fail(const absl::Status& error) {
 }
 
 void CommitOperation::StagePending(WriteStager& stager) {
+  // Once the next commit operation has started, retries must not stage
+  // requests made after it, to preserve the order of commits.
+  if (manifest_update_) return;
   auto& writer = *writer_;
   PendingRequests pending;
   {
@@ -259,13 +328,10 @@ CommitOperation::ApplyWriteEntryChain(StorageGeneration existing_generation,
 
 void CommitOperation::CommitSuccessful(absl::Time time) {
   internal_ocdbt::CommitSuccessful(staged_, time);
-  auto writer = std::move(writer_);
+  // `ManifestUpdateStarted` has already allowed the next commit operation to
+  // start.  It remains valid only if this commit was not retried.
+  FinishManifestUpdate(manifest_update_->manifest == new_manifest_);
   delete this;
-  UniqueWriterLock lock(writer->mutex_);
-  writer->commit_in_progress_ = false;
-  if (!writer->pending_.requests.empty()) {
-    CommitOperation::MaybeStart(*writer, std::move(lock));
-  }
 }
 
 }  // namespace
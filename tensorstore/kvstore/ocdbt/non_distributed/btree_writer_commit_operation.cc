@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <string>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -46,6 +47,17 @@ namespace tensorstore {
 namespace internal_ocdbt {
 
 void BtreeWriterCommitOperationBase::ReadManifest() {
+  if (base_manifest_update_) {
+    // Base this commit on a manifest that is still being written.  Any node
+    // referenced by it has already been flushed.
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "ReadManifest: speculative base generation="
+        << GetLatestGeneration(base_manifest_update_->manifest.get());
+    existing_manifest_ = base_manifest_update_->manifest;
+    StageAndTraverse();
+    return;
+  }
+
   Future<const ManifestWithTime> read_future;
 
   if (io_handle_->config_state->GetAssumedOrExistingConfig()) {
@@ -72,31 +84,34 @@ void BtreeWriterCommitOperationBase::ReadManifest() {
         }
         existing_manifest_ = r->manifest;
         staleness_bound_ = r->time;
-        auto& executor = io_handle_->executor;
-        executor([this]() mutable {
-          WriteStager stager(*this);
-          StagePending(stager);
-          auto [promise, future] =
-              PromiseFuturePair<void>::Make(absl::OkStatus());
-          TraverseBtreeStartingFromRoot(std::move(promise));
-          future.Force();
-          future.ExecuteWhenReady([this](ReadyFuture<void> future) mutable {
-            auto& r = future.result();
-            if (!r.ok()) {
-              if (absl::IsCancelled(r.status())) {
-                // Out of date, retry.
-                this->Retry();
-                return;
-              }
-              Fail(r.status());
-              return;
-            }
-            WriteNewManifest();
-          });
-        });
+        StageAndTraverse();
       });
 }
 
+void BtreeWriterCommitOperationBase::StageAndTraverse() {
+  auto& executor = io_handle_->executor;
+  executor([this]() mutable {
+    WriteStager stager(*this);
+    StagePending(stager);
+    auto [promise, future] = PromiseFuturePair<void>::Make(absl::OkStatus());
+    TraverseBtreeStartingFromRoot(std::move(promise));
+    future.Force();
+    future.ExecuteWhenReady([this](ReadyFuture<void> future) mutable {
+      auto& r = future.result();
+      if (!r.ok()) {
+        if (absl::IsCancelled(r.status())) {
+          // Out of date, retry.
+          this->Retry();
+          return;
+        }
+        Fail(r.status());
+        return;
+      }
+      WriteNewManifest();
+    });
+  });
+}
+
 void BtreeWriterCommitOperationBase::WriteStager::Stage(
     LeafNodeValueReference& value_ref) {
   if (auto* value_ptr = std::get_if<absl::Cord>(&value_ref)) {
@@ -197,6 +212,88 @@ void BtreeWriterCommitOperationBase::InteriorNodeTraversalState::
           /*may_be_root=*/parent_state_->is_root_parent()));
 }
 
+void BtreeWriterCommitOperationBase::EncodeLeafNodes(
+    LeafNodeEncodeState::Ptr leaf_state, NodeTraversalState::Ptr parent_state,
+    std::string existing_relative_child_key) {
+  auto ranges = leaf_state->encoder.Partition();
+
+  // Group the nodes into tasks of at least `kMinLeafNodeBytesPerEncodeTask`.
+  std::vector<size_t> task_ends;
+  size_t task_bytes = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    task_bytes += ranges[i].size_estimate;
+    if (task_bytes >= kMinLeafNodeBytesPerEncodeTask) {
+      task_ends.push_back(i + 1);
+      task_bytes = 0;
+    }
+  }
+  if (task_ends.empty() || task_ends.back() != ranges.size()) {
+    task_ends.push_back(ranges.size());
+  }
+
+  if (task_ends.size() == 1) {
+    // Encode sequentially.
+    const bool is_root = parent_state->is_root_parent() && ranges.size() == 1;
+    std::vector<EncodedNode> encoded_nodes;
+    encoded_nodes.reserve(ranges.size());
+    for (const auto& range : ranges) {
+      auto encoded_node = leaf_state->encoder.EncodeNode(range, is_root);
+      if (!encoded_node.ok()) {
+        SetDeferredResult(parent_state->promise_,
+                          std::move(encoded_node).status());
+        return;
+      }
+      encoded_nodes.push_back(*std::move(encoded_node));
+    }
+    UpdateParent(*parent_state, existing_relative_child_key,
+                 std::move(encoded_nodes));
+    return;
+  }
+
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "EncodeLeafNodes: encoding " << ranges.size() << " nodes in "
+      << task_ends.size() << " tasks";
+  auto executor = parent_state->writer_->io_handle_->executor;
+  leaf_state->encoded_nodes.resize(ranges.size());
+  leaf_state->ranges = std::move(ranges);
+  leaf_state->parent_state = std::move(parent_state);
+  leaf_state->existing_relative_child_key =
+      std::move(existing_relative_child_key);
+  leaf_state->remaining_tasks.store(task_ends.size(),
+                                    std::memory_order_relaxed);
+  size_t task_begin = 0;
+  for (size_t task_end : task_ends) {
+    executor([leaf_state, task_begin, task_end] {
+      auto& state = *leaf_state;
+      if (state.parent_state->promise_.result_needed()) {
+        for (size_t i = task_begin; i < task_end; ++i) {
+          auto encoded_node =
+              state.encoder.EncodeNode(state.ranges[i], /*is_root=*/false);
+          if (!encoded_node.ok()) {
+            absl::MutexLock lock(&state.mutex);
+            state.status.Update(encoded_node.status());
+            break;
+          }
+          state.encoded_nodes[i] = *std::move(encoded_node);
+        }
+      }
+      if (state.remaining_tasks.fetch_sub(1, std::memory_order_acq_rel) !=
+          1) {
+        return;
+      }
+      // Last task to complete.
+      if (!state.parent_state->promise_.result_needed()) return;
+      if (!state.status.ok()) {
+        SetDeferredResult(state.parent_state->promise_, state.status);
+        return;
+      }
+      UpdateParent(*state.parent_state, state.existing_relative_child_key,
+                   std::move(state.encoded_nodes));
+    });
+    task_begin = task_end;
+  }
+}
+
 void BtreeWriterCommitOperationBase::UpdateParent(
     NodeTraversalState& parent_state,
     std::string_view existing_relative_child_key,
@@ -312,6 +409,24 @@ void BtreeWriterCommitOperationBase::NewManifestReady(Promise<void> promise) {
 }
 
 void BtreeWriterCommitOperationBase::WriteNewManifest() {
+  ManifestUpdateStarted();
+  if (base_manifest_update_) {
+    // Manifest writes are serialized: wait for the base manifest update to
+    // complete before writing the new manifest.
+    auto base_future = std::exchange(base_manifest_update_, {})->future;
+    base_future.ExecuteWhenReady(WithExecutor(
+        io_handle_->executor, [this](ReadyFuture<const void> future) {
+          if (!future.result().ok()) {
+            ABSL_LOG_IF(INFO, ocdbt_logging)
+                << "WriteNewManifest: speculative base manifest not written";
+            staleness_bound_ = absl::Now();
+            Retry();
+            return;
+          }
+          WriteNewManifest();
+        }));
+    return;
+  }
   ABSL_LOG_IF(INFO, ocdbt_logging)
       << "WriteNewManifest: existing_generation="
       << GetLatestGeneration(existing_manifest_.get())
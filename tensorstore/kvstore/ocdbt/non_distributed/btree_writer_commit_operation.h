@@ -38,7 +38,10 @@
 // 4. Nodes are re-written (and split as required) in a bottom-up fashion.
 //    Non-leaf nodes are not rewritten until any child nodes that need to be
 //    modified have been re-written.  Note: This step happens concurrently with
-//    the traversal described in the previous step.
+//    the traversal described in the previous step.  Each subtree is processed
+//    independently on the executor; when the mutations to a single leaf node
+//    result in many new leaf nodes (e.g. a large write to an empty database),
+//    the new nodes are also encoded in parallel (see `EncodeLeafNodes`).
 //
 // 5. Once the root B+tree node has been written, a new manifest is created.
 //    If all of the inline version slots in the manifest are full, new version
@@ -51,6 +54,12 @@
 // 8. If the manifest is written successfully, then the commit is done.
 //    Otherwise, return to step 2.
 //
+// Commits may be pipelined: once a commit reaches step 6, a subsequent commit
+// may perform steps 2-5 speculatively based on the new manifest that is still
+// being written (see `PendingManifestUpdate`).  Only the manifest writes
+// themselves are serialized; if the speculative base manifest is not the one
+// ultimately written, the subsequent commit returns to step 1.
+//
 // TODO(jbms): Currently, B+tree nodes are never merged in response to delete
 // operations, which means that lookups are `O(log M)`, where `M` is the total
 // number of keys inserted, rather than `O(log N)`, where `N` is the current
@@ -64,9 +73,13 @@
 // in its memory usage.  That needs to be addressed, e.g. by limiting the number
 // of in-flight nodes.
 
+#include <stddef.h>
+
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -331,6 +344,21 @@ void PartitionInteriorNodeMutations(
   end_of_partition(entry_it.to_pointer());
 }
 
+// Manifest write that has been initiated by a commit operation, and on which
+// subsequent commits may be speculatively based.
+struct PendingManifestUpdate
+    : public internal::AtomicReferenceCount<PendingManifestUpdate> {
+  using Ptr = internal::IntrusivePtr<PendingManifestUpdate>;
+
+  // New manifest initially being written.
+  std::shared_ptr<const Manifest> manifest;
+
+  // Becomes ready once the commit operation completes.  Ready with success if,
+  // and only if, `manifest` was written successfully.
+  Promise<void> promise;
+  Future<const void> future;
+};
+
 class BtreeWriterCommitOperationBase {
  protected:
   BtreeWriterCommitOperationBase(IoHandle::Ptr io_handle)
@@ -353,6 +381,11 @@ class BtreeWriterCommitOperationBase {
   FlushPromise flush_promise_;
   absl::Time staleness_bound_ = absl::InfinitePast();
 
+  // If non-null, the commit is speculatively based on
+  // `base_manifest_update_->manifest` rather than on the manifest read from
+  // storage.  Reset once the base manifest update completes.
+  PendingManifestUpdate::Ptr base_manifest_update_;
+
   // Starts a commit attempt, beginning by reading the existing manifest as of
   // `staleness_bound_`.
   //
@@ -366,6 +399,12 @@ class BtreeWriterCommitOperationBase {
   /// Retries the commit operation.
   virtual void Retry() = 0;
 
+  /// Called when the new manifest has been generated and all nodes have been
+  /// flushed, just before waiting for `base_manifest_update_` (if any) and
+  /// writing the new manifest.  May be called more than once if the commit is
+  /// retried.
+  virtual void ManifestUpdateStarted() {}
+
   class WriteStager {
    public:
     void Stage(LeafNodeValueReference& value_ref);
@@ -478,6 +517,51 @@ class BtreeWriterCommitOperationBase {
     void ApplyMutations() final;
   };
 
+  // Encoder for the new leaf nodes that replace a single existing leaf node,
+  // along with the storage referenced by the encoder.
+  struct LeafNodeEncodeState
+      : public internal::AtomicReferenceCount<LeafNodeEncodeState> {
+    using Ptr = internal::IntrusivePtr<LeafNodeEncodeState>;
+
+    LeafNodeEncodeState(const Config& config, std::string full_prefix,
+                        std::shared_ptr<const BtreeNode> existing_node)
+        : full_prefix(std::move(full_prefix)),
+          existing_node(std::move(existing_node)),
+          encoder(config, /*height=*/0, this->full_prefix) {}
+
+    // Full key prefix that applies to the entries of `existing_node`.
+    std::string full_prefix;
+
+    // Existing leaf node, or `nullptr` if the tree is empty.
+    std::shared_ptr<const BtreeNode> existing_node;
+
+    BtreeLeafNodeEncoder encoder;
+
+    // State used by `EncodeLeafNodes` when encoding in parallel.
+    NodeTraversalState::Ptr parent_state;
+    std::string existing_relative_child_key;
+    std::vector<BtreeLeafNodeEncoder::NodeEntryRange> ranges;
+    std::vector<EncodedNode> encoded_nodes;
+    std::atomic<size_t> remaining_tasks{0};
+    absl::Mutex mutex;
+    absl::Status status;
+  };
+
+  // Minimum estimated size of the leaf nodes encoded by a single executor task
+  // in `EncodeLeafNodes`.
+  constexpr static size_t kMinLeafNodeBytesPerEncodeTask = 1024 * 1024;
+
+  // Encodes the new leaf nodes added to `leaf_state->encoder`, and then calls
+  // `UpdateParent`.
+  //
+  // If the new nodes are large enough to be split across multiple executor
+  // tasks, they are encoded in parallel on the executor.  The traversal state
+  // `parent_state` is not released (and therefore the parent is not updated)
+  // until all of the nodes have been encoded.
+  static void EncodeLeafNodes(LeafNodeEncodeState::Ptr leaf_state,
+                              NodeTraversalState::Ptr parent_state,
+                              std::string existing_relative_child_key);
+
   // Adds mutations to `parent_state` to replace the child with key
   // `existing_relative_child_key` with the children in `encoded_nodes_result`.
   //
@@ -520,7 +604,12 @@ class BtreeWriterCommitOperationBase {
   // Ensures all indirect writes are flushed, and then marks `promise` as ready.
   void NewManifestReady(Promise<void> promise);
 
-  // Attempts to write the new manifest.
+  // Stages pending mutations and traverses the B+tree, based on
+  // `existing_manifest_`.
+  void StageAndTraverse();
+
+  // Attempts to write the new manifest, after waiting for
+  // `base_manifest_update_` to complete.
   void WriteNewManifest();
 };
 
@@ -909,15 +998,18 @@ void BtreeWriterCommitOperation<MutationEntry>::VisitInteriorNode(
 template <typename MutationEntry>
 void BtreeWriterCommitOperation<MutationEntry>::VisitLeafNode(
     VisitNodeParameters params) {
+  auto leaf_state = internal::MakeIntrusivePtr<LeafNodeEncodeState>(
+      params.parent_state->writer_->existing_config(),
+      std::move(params.full_prefix), std::move(params.node));
+  const std::string& full_prefix = leaf_state->full_prefix;
+  auto& encoder = leaf_state->encoder;
   span<const LeafNodeEntry> existing_entries;
-  if (params.node) {
-    existing_entries =
-        std::get<BtreeNode::LeafNodeEntries>(params.node->entries);
+  if (leaf_state->existing_node) {
+    existing_entries = std::get<BtreeNode::LeafNodeEntries>(
+        leaf_state->existing_node->entries);
   }
-  BtreeLeafNodeEncoder encoder(params.parent_state->writer_->existing_config(),
-                               /*height=*/0, params.full_prefix);
   ComparePrefixedKeyToUnprefixedKey compare_existing_and_new_keys{
-      params.full_prefix};
+      full_prefix};
   bool modified = false;
   auto existing_it = existing_entries.begin();
   const auto& key_range = params.key_range;
@@ -959,7 +1051,7 @@ void BtreeWriterCommitOperation<MutationEntry>::VisitLeafNode(
               params.parent_state->writer_)
               ->ValidateSupersededWriteEntries(
                   superseded_writes, span(existing_it, existing_entries.end()),
-                  params.full_prefix, validated);
+                  full_prefix, validated);
       if (!validated) {
         params.parent_state->NotifyOutOfDate();
         return;
@@ -1024,8 +1116,8 @@ void BtreeWriterCommitOperation<MutationEntry>::VisitLeafNode(
     encoder.AddEntry(/*existing=*/true, LeafNodeEntry(*existing_it));
   }
 
-  UpdateParent(*params.parent_state, params.inclusive_min_key_suffix,
-               encoder.Finalize(params.parent_state->is_root_parent()));
+  EncodeLeafNodes(std::move(leaf_state), std::move(params.parent_state),
+                  std::move(params.inclusive_min_key_suffix));
 }
 
 }  // namespace internal_ocdbt
@@ -0,0 +1,412 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/non_distributed/diff_versions.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_sender_operation_state.h"
+#include "tensorstore/util/execution/sync_flow_sender.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+// Subtree of one of the two versions being compared.
+struct DiffSide {
+  // Indicates that the subtree contains no keys.
+  bool empty = true;
+
+  // Location of the root node of the subtree.
+  IndirectDataReference location;
+
+  BtreeNodeHeight height = 0;
+
+  // Full inclusive min key of the subtree, of which the first
+  // `subtree_common_prefix_length` bytes are excluded from the encoded node.
+  std::string inclusive_min_key;
+  KeyLength subtree_common_prefix_length = 0;
+
+  // Decoded root node, once read.
+  std::shared_ptr<const BtreeNode> node;
+
+  // Returns the prefix of the keys stored in `node`.
+  std::string key_prefix() const {
+    return tensorstore::StrCat(
+        std::string_view(inclusive_min_key)
+            .substr(0, subtree_common_prefix_length),
+        node->key_prefix);
+  }
+};
+
+// Subtree that covers `range` within its parent.
+struct DiffItem {
+  KeyRange range;
+  DiffSide side;
+};
+
+DiffSide GetRootSide(const BtreeGenerationReference& version) {
+  DiffSide side;
+  side.empty = version.root.location.IsMissing();
+  side.location = version.root.location;
+  side.height = version.root_height;
+  return side;
+}
+
+// Returns the smaller of two `KeyRange::exclusive_max` bounds.
+std::string_view MinExclusiveMax(std::string_view a, std::string_view b) {
+  return KeyRange::CompareExclusiveMax(a, b) < 0 ? a : b;
+}
+
+// Asynchronous operation state used to implement `DiffVersions`.
+//
+// The two B+trees are traversed together, starting from the roots:
+//
+// 1. If both subtrees are the same node, they contain the same keys and the
+//    pair is skipped.
+//
+// 2. Otherwise, the node with the greater height, or both if the heights are
+//    equal, is expanded into its children.  The key range is split at the
+//    boundaries of the children of either side, and each resulting segment is
+//    compared recursively against the subtree that covers it on the other
+//    side.  An unmodified child then typically pairs with the identical child
+//    on the other side and is skipped in step 1.
+//
+// 3. Once both sides are leaf nodes (or empty), their entries are merged and
+//    the differences are emitted.
+struct DiffOperation : public internal::FlowSenderOperationState<
+                           std::vector<BtreeDiffEntry>> {
+  using Ptr = internal::IntrusivePtr<DiffOperation>;
+  using Base =
+      internal::FlowSenderOperationState<std::vector<BtreeDiffEntry>>;
+
+  using Base::Base;
+
+  ReadonlyIoHandle::Ptr io_handle;
+
+  static Future<const std::shared_ptr<const BtreeNode>> ReadSide(
+      const DiffOperation& op, const DiffSide& side, Batch::View batch) {
+    if (side.empty || side.node) {
+      return MakeReadyFuture<std::shared_ptr<const BtreeNode>>(side.node);
+    }
+    return op.io_handle->GetBtreeNode(side.location, batch);
+  }
+
+  // Emits the differences between `a` and `b` within `range`.
+  static void VisitPair(DiffOperation::Ptr op, DiffSide a, DiffSide b,
+                        KeyRange range, Batch::View batch = no_batch) {
+    if (a.empty && b.empty) return;
+    if (!a.empty && !b.empty && a.location == b.location) {
+      // Identical subtree.
+      return;
+    }
+    if (op->cancelled()) return;
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "DiffVersions: from=" << a.location << ", from_empty=" << a.empty
+        << ", to=" << b.location << ", to_empty=" << b.empty
+        << ", key_range=" << range;
+    auto a_future = ReadSide(*op, a, batch);
+    auto b_future = ReadSide(*op, b, batch);
+    auto* op_ptr = op.get();
+    Link(WithExecutor(
+             op_ptr->io_handle->executor,
+             [op = std::move(op), a = std::move(a), b = std::move(b),
+              range = std::move(range)](
+                 Promise<void> promise,
+                 ReadyFuture<const std::shared_ptr<const BtreeNode>> a_future,
+                 ReadyFuture<const std::shared_ptr<const BtreeNode>>
+                     b_future) mutable {
+               if (!SetNode(*op, a, a_future) || !SetNode(*op, b, b_future)) {
+                 return;
+               }
+               if (op->cancelled()) return;
+               VisitNodes(std::move(op), a, b, range);
+             }),
+         op_ptr->promise, std::move(a_future), std::move(b_future));
+  }
+
+  // Stores the result of reading the root node of `side`.  Returns `false` on
+  // error.
+  static bool SetNode(
+      DiffOperation& op, DiffSide& side,
+      ReadyFuture<const std::shared_ptr<const BtreeNode>>& future) {
+    if (side.empty || side.node) return true;
+    auto& r = future.result();
+    if (!r.ok()) {
+      op.SetError(r.status());
+      return false;
+    }
+    if (auto status = ValidateBtreeNodeReference(
+            **r, side.height,
+            std::string_view(side.inclusive_min_key)
+                .substr(side.subtree_common_prefix_length));
+        !status.ok()) {
+      op.SetError(std::move(status));
+      return false;
+    }
+    side.node = *r;
+    return true;
+  }
+
+  static void VisitNodes(DiffOperation::Ptr op, const DiffSide& a,
+                         const DiffSide& b, const KeyRange& range) {
+    const BtreeNodeHeight a_height = a.empty ? 0 : a.node->height;
+    const BtreeNodeHeight b_height = b.empty ? 0 : b.node->height;
+    const bool expand_a =
+        !a.empty && a_height > 0 && (b.empty || a_height >= b_height);
+    const bool expand_b =
+        !b.empty && b_height > 0 && (a.empty || b_height >= a_height);
+    if (!expand_a && !expand_b) {
+      VisitLeafNodes(*op, a, b, range);
+      return;
+    }
+    auto a_items = expand_a ? ExpandInteriorNode(a, range)
+                            : std::vector<DiffItem>{{range, a}};
+    auto b_items = expand_b ? ExpandInteriorNode(b, range)
+                            : std::vector<DiffItem>{{range, b}};
+
+    // Issue the reads of all children as a single batch, as for `List`.
+    Batch batch = Batch::New();
+    const DiffSide empty_side;
+    std::string pos = range.inclusive_min;
+    size_t a_i = 0, b_i = 0;
+    while (true) {
+      // Finds the item of `items` that covers `pos`, if any, and reduces `end`
+      // to the next boundary of `items` after `pos`.
+      const auto find_side = [&](const std::vector<DiffItem>& items,
+                                 size_t& i,
+                                 std::string_view& end) -> const DiffSide* {
+        while (i < items.size() &&
+               KeyRange::CompareKeyAndExclusiveMax(
+                   pos, items[i].range.exclusive_max) >= 0) {
+          ++i;
+        }
+        if (i == items.size()) return nullptr;
+        const auto& item = items[i];
+        if (item.range.inclusive_min <= pos) {
+          end = MinExclusiveMax(end, item.range.exclusive_max);
+          return item.side.empty ? nullptr : &item.side;
+        }
+        end = MinExclusiveMax(end, item.range.inclusive_min);
+        return nullptr;
+      };
+      std::string_view end = range.exclusive_max;
+      const DiffSide* a_side = find_side(a_items, a_i, end);
+      const DiffSide* b_side = find_side(b_items, b_i, end);
+      if (a_side || b_side) {
+        VisitPair(op, a_side ? *a_side : empty_side,
+                  b_side ? *b_side : empty_side,
+                  KeyRange(pos, std::string(end)), batch);
+      }
+      if (KeyRange::CompareExclusiveMax(end, range.exclusive_max) == 0) break;
+      pos = std::string(end);
+    }
+  }
+
+  // Returns the children of `side` that intersect `range`, with their key
+  // ranges restricted to `range`.
+  static std::vector<DiffItem> ExpandInteriorNode(const DiffSide& side,
+                                                  const KeyRange& range) {
+    const auto& node = *side.node;
+    auto& all_entries = std::get<BtreeNode::InteriorNodeEntries>(node.entries);
+    const std::string key_prefix = side.key_prefix();
+    auto relative_range = KeyRange::RemovePrefix(key_prefix, range);
+    auto entries =
+        FindBtreeEntryRange(all_entries, relative_range.inclusive_min,
+                            relative_range.exclusive_max, node.key_heads);
+    std::vector<DiffItem> items;
+    items.reserve(entries.size());
+    for (const auto& entry : entries) {
+      const size_t i = &entry - all_entries.data();
+      DiffItem item;
+      item.side.empty = false;
+      item.side.location = entry.node.location;
+      item.side.height = node.height - 1;
+      item.side.inclusive_min_key = tensorstore::StrCat(key_prefix, entry.key);
+      item.side.subtree_common_prefix_length =
+          key_prefix.size() + entry.subtree_common_prefix_length;
+      item.range = Intersect(
+          range, KeyRange(item.side.inclusive_min_key,
+                          i + 1 < all_entries.size()
+                              ? tensorstore::StrCat(key_prefix,
+                                                    all_entries[i + 1].key)
+                              : std::string()));
+      if (item.range.empty()) continue;
+      items.push_back(std::move(item));
+    }
+    return items;
+  }
+
+  // Merges the entries of two leaf nodes (either of which may be empty).
+  static void VisitLeafNodes(DiffOperation& op, const DiffSide& a,
+                             const DiffSide& b, const KeyRange& range) {
+    struct Entries {
+      std::string key_prefix;
+      span<const LeafNodeEntry> entries;
+    };
+    const auto get_entries = [&](const DiffSide& side) {
+      Entries result;
+      if (side.empty) return result;
+      const auto& node = *side.node;
+      result.key_prefix = side.key_prefix();
+      auto relative_range = KeyRange::RemovePrefix(result.key_prefix, range);
+      result.entries = FindBtreeEntryRange(
+          std::get<BtreeNode::LeafNodeEntries>(node.entries),
+          relative_range.inclusive_min, relative_range.exclusive_max,
+          node.key_heads);
+      return result;
+    };
+    const auto a_entries = get_entries(a);
+    const auto b_entries = get_entries(b);
+    std::vector<BtreeDiffEntry> diffs;
+    size_t a_i = 0, b_i = 0;
+    while (a_i < a_entries.entries.size() || b_i < b_entries.entries.size()) {
+      std::string a_key, b_key;
+      if (a_i < a_entries.entries.size()) {
+        a_key = tensorstore::StrCat(a_entries.key_prefix,
+                                    a_entries.entries[a_i].key);
+      }
+      if (b_i < b_entries.entries.size()) {
+        b_key = tensorstore::StrCat(b_entries.key_prefix,
+                                    b_entries.entries[b_i].key);
+      }
+      if (b_i == b_entries.entries.size() ||
+          (a_i < a_entries.entries.size() && a_key < b_key)) {
+        auto& diff = diffs.emplace_back();
+        diff.key = std::move(a_key);
+        diff.from_value = a_entries.entries[a_i++].value_reference;
+      } else if (a_i == a_entries.entries.size() || b_key < a_key) {
+        auto& diff = diffs.emplace_back();
+        diff.key = std::move(b_key);
+        diff.to_value = b_entries.entries[b_i++].value_reference;
+      } else {
+        const auto& a_value = a_entries.entries[a_i++].value_reference;
+        const auto& b_value = b_entries.entries[b_i++].value_reference;
+        if (a_value == b_value) continue;
+        auto& diff = diffs.emplace_back();
+        diff.key = std::move(a_key);
+        diff.from_value = a_value;
+        diff.to_value = b_value;
+      }
+    }
+    if (diffs.empty()) return;
+    execution::set_value(op.shared_receiver->receiver, std::move(diffs));
+  }
+};
+
+struct DiffVersionsFutureReceiver {
+  Promise<std::vector<BtreeDiffEntry>> promise;
+  std::vector<BtreeDiffEntry> diffs;
+  FutureCallbackRegistration cancel_registration;
+
+  void set_value(std::vector<BtreeDiffEntry> value) {
+    if (diffs.empty()) {
+      diffs = std::move(value);
+    } else {
+      diffs.insert(diffs.end(), std::make_move_iterator(value.begin()),
+                   std::make_move_iterator(value.end()));
+    }
+  }
+
+  void set_error(absl::Status status) { promise.SetResult(std::move(status)); }
+
+  void set_done() {
+    std::sort(diffs.begin(), diffs.end(),
+              [](const BtreeDiffEntry& a, const BtreeDiffEntry& b) {
+                return a.key < b.key;
+              });
+    promise.SetResult(std::move(diffs));
+  }
+
+  template <typename Cancel>
+  void set_starting(Cancel cancel) {
+    cancel_registration = promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+
+  void set_stopping() { cancel_registration.Unregister(); }
+};
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const BtreeDiffEntry& e) {
+  os << "{key=" << tensorstore::QuoteString(e.key) << ", from_value=";
+  if (e.from_value) {
+    os << *e.from_value;
+  } else {
+    os << "<missing>";
+  }
+  os << ", to_value=";
+  if (e.to_value) {
+    os << *e.to_value;
+  } else {
+    os << "<missing>";
+  }
+  return os << "}";
+}
+
+void DiffVersions(
+    ReadonlyIoHandle::Ptr io_handle, const BtreeGenerationReference& from,
+    const BtreeGenerationReference& to, KeyRange range,
+    AnyFlowReceiver<absl::Status, std::vector<BtreeDiffEntry>> receiver) {
+  auto op = internal::MakeIntrusivePtr<DiffOperation>(std::move(receiver));
+  op->io_handle = std::move(io_handle);
+  DiffOperation::VisitPair(std::move(op), GetRootSide(from), GetRootSide(to),
+                           std::move(range));
+}
+
+Future<std::vector<BtreeDiffEntry>> DiffVersionsFuture(
+    ReadonlyIoHandle::Ptr io_handle, const BtreeGenerationReference& from,
+    const BtreeGenerationReference& to, KeyRange range) {
+  auto [promise, future] =
+      PromiseFuturePair<std::vector<BtreeDiffEntry>>::Make();
+  DiffVersions(
+      std::move(io_handle), from, to, std::move(range),
+      SyncFlowReceiver<DiffVersionsFutureReceiver>{{std::move(promise)}});
+  return std::move(future);
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
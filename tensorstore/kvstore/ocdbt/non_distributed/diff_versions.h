@@ -0,0 +1,82 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_DIFF_VERSIONS_H_
+#define TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_DIFF_VERSIONS_H_
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+// Key that differs between two versions of a database.
+struct BtreeDiffEntry {
+  std::string key;
+
+  // Value in the `from` version, or `std::nullopt` if the key was added.
+  std::optional<LeafNodeValueReference> from_value;
+
+  // Value in the `to` version, or `std::nullopt` if the key was deleted.
+  std::optional<LeafNodeValueReference> to_value;
+
+  friend bool operator==(const BtreeDiffEntry& a, const BtreeDiffEntry& b) {
+    return a.key == b.key && a.from_value == b.from_value &&
+           a.to_value == b.to_value;
+  }
+  friend bool operator!=(const BtreeDiffEntry& a, const BtreeDiffEntry& b) {
+    return !(a == b);
+  }
+  friend std::ostream& operator<<(std::ostream& os, const BtreeDiffEntry& e);
+};
+
+// Computes the keys within `range` that were added, deleted, or modified
+// between the `from` and `to` versions, e.g. as returned by `ListVersions`.
+//
+// The B+trees of both versions are traversed together, and subtrees that are
+// referenced by both versions at the same location are skipped without being
+// read.  Since a commit only rewrites the nodes on the paths to the modified
+// keys, the number of nodes read is proportional to the number of changed
+// keys times the tree height, rather than to the size of the database.
+//
+// A value that was rewritten without change (e.g. by compaction, or by
+// writing the same value again as an out-of-line value) is reported as
+// modified.
+//
+// Entries are delivered in batches, one per pair of leaf nodes, and batches
+// are not delivered in key order.
+void DiffVersions(
+    ReadonlyIoHandle::Ptr io_handle, const BtreeGenerationReference& from,
+    const BtreeGenerationReference& to, KeyRange range,
+    AnyFlowReceiver<absl::Status, std::vector<BtreeDiffEntry>> receiver);
+
+// Same as above, but returns all differences sorted by key.
+Future<std::vector<BtreeDiffEntry>> DiffVersionsFuture(
+    ReadonlyIoHandle::Ptr io_handle, const BtreeGenerationReference& from,
+    const BtreeGenerationReference& to, KeyRange range = {});
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_DIFF_VERSIONS_H_
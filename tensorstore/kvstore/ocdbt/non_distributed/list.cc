@@ -26,6 +26,7 @@
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -38,6 +39,7 @@
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
 #include "tensorstore/util/execution/flow_sender_operation_state.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
@@ -67,8 +69,9 @@ using ::tensorstore::kvstore::ListReceiver;
 //
 // 3. Emit matching leaf-node keys to the receiver.
 //
-// TODO(jbms): Currently memory usage is not bounded.  That needs to be
-// addressed, e.g. by limiting the number of in-flight nodes.
+// Node reads are deferred while the receiver has no outstanding demand (see
+// `FlowDemand`), which bounds memory usage when the receiver lags.  Reads of
+// the children of a single interior node are still issued together.
 struct ListOperation
     : public internal::FlowSenderOperationState<std::string_view,
                                                 span<const LeafNodeEntry>> {
@@ -124,11 +127,13 @@ struct ListOperation
   //   prefix_length: Length of the prefix of `inclusive_min_key` that specifies
   //     the implicit prefix that is excluded from the encoded representation of
   //     the node.
+  //   batch: Batch with which to coalesce the node read.
   static void VisitSubtree(ListOperation::Ptr op,
                            const BtreeNodeReference& node_ref,
                            BtreeNodeHeight node_height,
                            std::string inclusive_min_key,
-                           KeyLength subtree_common_prefix_length) {
+                           KeyLength subtree_common_prefix_length,
+                           Batch::View batch = no_batch) {
     ABSL_LOG_IF(INFO, ocdbt_logging)
         << "List: node=" << node_ref
         << ", node_height=" << static_cast<int>(node_height)
@@ -136,11 +141,26 @@ struct ListOperation
         << ", inclusive_min_key=" << tensorstore::QuoteString(inclusive_min_key)
         << ", key_range=" << op->range;
     auto* op_ptr = op.get();
+    if (!op_ptr->demand->available()) {
+      // Defer the read until the receiver requests more entries.
+      Link(WithExecutor(op_ptr->io_handle->maybe_inline_executor,
+                        [op = std::move(op), node_ref, node_height,
+                         inclusive_min_key = std::move(inclusive_min_key),
+                         subtree_common_prefix_length](
+                            Promise<void>, ReadyFuture<const void>) mutable {
+                          VisitSubtree(std::move(op), node_ref, node_height,
+                                       std::move(inclusive_min_key),
+                                       subtree_common_prefix_length);
+                        }),
+           op_ptr->promise, op_ptr->demand->WhenAvailable());
+      return;
+    }
     Link(WithExecutor(op_ptr->io_handle->executor,
                       NodeReadyCallback{std::move(op), node_height,
                                         std::move(inclusive_min_key),
                                         subtree_common_prefix_length}),
-         op_ptr->promise, op_ptr->io_handle->GetBtreeNode(node_ref.location));
+         op_ptr->promise,
+         op_ptr->io_handle->GetBtreeNode(node_ref.location, batch));
   }
 
   // Called when a B+tree node lookup completes.
@@ -188,7 +208,7 @@ struct ListOperation
                                 const KeyRange& key_range) {
     auto& all_entries = std::get<BtreeNode::InteriorNodeEntries>(node.entries);
     auto entries = FindBtreeEntryRange(all_entries, key_range.inclusive_min,
-                                       key_range.exclusive_max);
+                                       key_range.exclusive_max, node.key_heads);
     ABSL_LOG_IF(INFO, ocdbt_logging)
         << "VisitInteriorNode: subtree_key_prefix="
         << tensorstore::QuoteString(subtree_key_prefix)
@@ -199,12 +219,18 @@ struct ListOperation
         << ", num matches=" << entries.size();
     // Note: It is safe to access `all_entries.front()` and `all_entries.back()`
     // because B+tree nodes are guaranteed to have at least one entry.
+
+    // Issue the reads of all matching children as a single batch, which is
+    // submitted when `batch` is destroyed.  Children stored in the same data
+    // file are then fetched by coalesced reads rather than one read each.
+    Batch batch = Batch::New();
     for (const auto& entry : entries) {
       VisitSubtree(op, entry.node, node.height - 1,
                    /*inclusive_min_key=*/
                    tensorstore::StrCat(subtree_key_prefix, entry.key),
                    /*subtree_common_prefix_length=*/subtree_key_prefix.size() +
-                       entry.subtree_common_prefix_length);
+                       entry.subtree_common_prefix_length,
+                   batch);
     }
   }
 
@@ -214,7 +240,7 @@ struct ListOperation
                             const KeyRange& key_range) {
     auto& all_entries = std::get<BtreeNode::LeafNodeEntries>(node.entries);
     auto entries = FindBtreeEntryRange(all_entries, key_range.inclusive_min,
-                                       key_range.exclusive_max);
+                                       key_range.exclusive_max, node.key_heads);
     ABSL_LOG_IF(INFO, ocdbt_logging)
         << "VisitLeafNode: subtree_key_prefix="
         << tensorstore::QuoteString(subtree_key_prefix)
@@ -228,6 +254,7 @@ struct ListOperation
     if (entries.empty()) return;
     execution::set_value(op->shared_receiver->receiver, subtree_key_prefix,
                          entries);
+    op->demand->Consume(entries.size());
   }
 };
 
@@ -266,6 +293,12 @@ struct KeyReceiverAdapter {
     execution::set_starting(receiver, std::forward<Cancel>(cancel));
   }
 
+  // Demand is counted in leaf entries, which correspond one-to-one with
+  // list entries.
+  void set_demand(FlowDemand::Ptr demand) {
+    execution::set_demand(receiver, std::move(demand));
+  }
+
   void set_stopping() { execution::set_stopping(receiver); }
 };
 
@@ -277,7 +310,7 @@ void NonDistributedList(ReadonlyIoHandle::Ptr io_handle,
       std::move(io_handle), std::move(options.range),
       KeyReceiverAdapter{std::move(receiver), options.strip_prefix_length});
   auto* op_ptr = op.get();
-  Link(WithExecutor(op_ptr->io_handle->executor,
+  Link(WithExecutor(op_ptr->io_handle->maybe_inline_executor,
                     ListOperation::ManifestReadyCallback{std::move(op)}),
        op_ptr->promise,
        op_ptr->io_handle->GetManifest(options.staleness_bound));
@@ -15,6 +15,7 @@
 #include "tensorstore/kvstore/ocdbt/non_distributed/read.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
 #include <string>
@@ -67,7 +68,8 @@ ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
 //
 // 4. Once the leaf node containing the key is reached, either return the value
 //    directly (if stored inline), or read it via
-//    `ReadonlyIoHandle::ReadIndirectData` (if stored separately).
+//    `ReadonlyIoHandle::ReadIndirectData` (if stored separately).  For a stat,
+//    the size is recorded instead and the value is never read.
 struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
   using Ptr = internal::IntrusivePtr<ReadOperation>;
   ReadonlyIoHandle::Ptr io_handle;
@@ -83,35 +85,35 @@ struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
   // Generation of indirect value.
   StorageGeneration generation;
 
+  // Indicates that only the size of the value is requested.
+  bool stat = false;
+
+  // Size of the value, set if the key is present and satisfies the
+  // generation conditions.
+  int64_t size = -1;
+
   // Initiates the asynchronous read operation.
   //
   // Args:
-  //   promise: Promise on which to set read result when ready.
-  //   io_handle: I/O handle to use.
-  //   key: Key to read.
-  //   options: Additional read options.
+  //   op: Operation state, with all members other than `time`,
+  //     `matched_length`, `generation` and `size` initialized.
+  //   staleness_bound: Staleness bound for the manifest.
   //
   // Returns:
   //   Futures that resolves when the read completes.
-  static Future<kvstore::ReadResult> Start(ReadonlyIoHandle::Ptr io_handle,
-                                           kvstore::Key&& key,
-                                           kvstore::ReadOptions&& options) {
-    auto op = internal::MakeIntrusivePtr<ReadOperation>();
-    op->io_handle = std::move(io_handle);
-    op->generation_conditions = std::move(options.generation_conditions);
-    op->byte_range = options.byte_range;
-    op->key = std::move(key);
+  static Future<kvstore::ReadResult> Start(ReadOperation::Ptr op,
+                                           absl::Time staleness_bound) {
     auto* op_ptr = op.get();
     return PromiseFuturePair<kvstore::ReadResult>::LinkValue(
                WithExecutor(
-                   op_ptr->io_handle->executor,
+                   op_ptr->io_handle->maybe_inline_executor,
                    [op = std::move(op)](
                        Promise<kvstore::ReadResult> promise,
                        ReadyFuture<const ManifestWithTime> future) mutable {
                      ManifestReady(std::move(op), std::move(promise),
                                    future.value());
                    }),
-               op_ptr->io_handle->GetManifest(options.staleness_bound))
+               op_ptr->io_handle->GetManifest(staleness_bound))
         .future;
   }
 
@@ -202,7 +204,7 @@ struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
                                 std::string_view unmatched_key_suffix) {
     auto* entry =
         FindBtreeEntry(std::get<BtreeNode::InteriorNodeEntries>(node.entries),
-                       unmatched_key_suffix);
+                       unmatched_key_suffix, node.key_heads);
     if (!entry) {
       op->KeyNotPresent(promise);
       return;
@@ -235,7 +237,7 @@ struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
                             std::string_view unmatched_key_suffix) {
     auto* entry =
         FindBtreeEntry(std::get<BtreeNode::LeafNodeEntries>(node.entries),
-                       unmatched_key_suffix);
+                       unmatched_key_suffix, node.key_heads);
     if (!entry) {
       op->KeyNotPresent(promise);
       return;
@@ -250,6 +252,19 @@ struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
       return;
     }
 
+    if (op->stat) {
+      if (auto* direct_value =
+              std::get_if<absl::Cord>(&entry->value_reference)) {
+        op->size = direct_value->size();
+      } else {
+        op->size = std::get<IndirectDataReference>(entry->value_reference)
+                       .length;
+      }
+      promise.SetResult(kvstore::ReadResult::Value(
+          {}, TimestampedStorageGeneration{std::move(generation), op->time}));
+      return;
+    }
+
     if (auto* direct_value = std::get_if<absl::Cord>(&entry->value_reference)) {
       // Value stored directly in btree node.
       TENSORSTORE_ASSIGN_OR_RETURN(
@@ -289,8 +304,29 @@ struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
 Future<kvstore::ReadResult> NonDistributedRead(ReadonlyIoHandle::Ptr io_handle,
                                                kvstore::Key key,
                                                kvstore::ReadOptions options) {
-  return ReadOperation::Start(std::move(io_handle), std::move(key),
-                              std::move(options));
+  auto op = internal::MakeIntrusivePtr<ReadOperation>();
+  op->io_handle = std::move(io_handle);
+  op->generation_conditions = std::move(options.generation_conditions);
+  op->byte_range = options.byte_range;
+  op->key = std::move(key);
+  return ReadOperation::Start(std::move(op), options.staleness_bound);
+}
+
+Future<kvstore::StatResult> NonDistributedStat(ReadonlyIoHandle::Ptr io_handle,
+                                               kvstore::Key key,
+                                               kvstore::StatOptions options) {
+  auto op = internal::MakeIntrusivePtr<ReadOperation>();
+  op->io_handle = std::move(io_handle);
+  op->generation_conditions = std::move(options.generation_conditions);
+  op->key = std::move(key);
+  op->stat = true;
+  auto future = ReadOperation::Start(op, options.staleness_bound);
+  return MapFutureValue(
+      InlineExecutor{},
+      [op = std::move(op)](const kvstore::ReadResult& read_result) {
+        return kvstore::StatResult::FromReadResult(read_result, op->size);
+      },
+      std::move(future));
 }
 
 }  // namespace internal_ocdbt
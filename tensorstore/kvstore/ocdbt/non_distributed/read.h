@@ -27,6 +27,12 @@ Future<kvstore::ReadResult> NonDistributedRead(ReadonlyIoHandle::Ptr io_handle,
                                                kvstore::Key key,
                                                kvstore::ReadOptions options);
 
+/// Obtains the size of the value from the B+tree leaf entry, without reading
+/// the value.
+Future<kvstore::StatResult> NonDistributedStat(ReadonlyIoHandle::Ptr io_handle,
+                                               kvstore::Key key,
+                                               kvstore::StatOptions options);
+
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
 
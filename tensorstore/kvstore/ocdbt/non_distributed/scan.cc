@@ -0,0 +1,261 @@
+// Copyright 2022 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/non_distributed/scan.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/list.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/storage_generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_sender_operation_state.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::ScanEntry;
+
+// Asynchronous operation state used to implement `NonDistributedScan`.
+//
+// The scan operation is implemented as follows:
+//
+// 1. Resolve the root b+tree node by reading the manifest.
+//
+// 2. List the matching leaf node entries using `NonDistributedListSubtree`,
+//    which visits the leaf nodes in arbitrary order.
+//
+// 3. Sort the entries by key, and emit them in order.  Values stored inline
+//    are emitted directly; values stored indirectly are read ahead of the
+//    entry being emitted.
+struct ScanOperation
+    : public internal::FlowSenderOperationState<ScanEntry> {
+  using Ptr = internal::IntrusivePtr<ScanOperation>;
+  using Base = internal::FlowSenderOperationState<ScanEntry>;
+
+  using Base::Base;
+
+  struct Entry {
+    std::string key;
+    LeafNodeValueReference value_reference;
+    // Read of an indirect value.  Null until the read is started.
+    Future<ReadResult> read;
+  };
+
+  ReadonlyIoHandle::Ptr io_handle;
+  kvstore::ScanOptions options;
+
+  // Time of the manifest from which the entries are listed.
+  absl::Time time;
+
+  absl::Mutex mutex;
+  // Matching entries, sorted by key once `list_stopped` is `true`.
+  std::vector<Entry> entries ABSL_GUARDED_BY(mutex);
+  bool list_stopped ABSL_GUARDED_BY(mutex) = false;
+  // Index of the first entry which has not been emitted.
+  size_t next_emit ABSL_GUARDED_BY(mutex) = 0;
+  // Index of the first entry for which a read has not been started.
+  size_t next_read ABSL_GUARDED_BY(mutex) = 0;
+  bool emitting ABSL_GUARDED_BY(mutex) = false;
+  bool emit_requested ABSL_GUARDED_BY(mutex) = false;
+
+  // Called when the manifest lookup has completed.
+  struct ManifestReadyCallback {
+    ScanOperation::Ptr op;
+    void operator()(Promise<void> promise,
+                    ReadyFuture<const ManifestWithTime> read_future) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto manifest_with_time,
+                                   read_future.result(), op->SetError(_));
+      op->time = manifest_with_time.time;
+      const auto* manifest = manifest_with_time.manifest.get();
+      if (!manifest || manifest->latest_version().root.location.IsMissing()) {
+        // Manifest not present or btree is empty.
+        return;
+      }
+      auto& latest_version = manifest->versions.back();
+      auto* op_ptr = op.get();
+      NonDistributedListSubtree(op_ptr->io_handle, latest_version.root,
+                                latest_version.root_height,
+                                /*subtree_key_prefix=*/{},
+                                KeyRange(op_ptr->options.range),
+                                LeafReceiver{std::move(op)});
+    }
+  };
+
+  // Receives the matching leaf node entries.
+  struct LeafReceiver {
+    ScanOperation::Ptr op;
+    FutureCallbackRegistration cancel_registration;
+
+    void set_starting(AnyCancelReceiver cancel) {
+      cancel_registration = op->promise.ExecuteWhenNotNeeded(std::move(cancel));
+    }
+
+    void set_value(std::string_view key_prefix,
+                   span<const LeafNodeEntry> leaf_entries) {
+      absl::MutexLock lock(&op->mutex);
+      for (const auto& entry : leaf_entries) {
+        op->entries.push_back(Entry{tensorstore::StrCat(key_prefix, entry.key),
+                                    entry.value_reference,
+                                    {}});
+      }
+    }
+
+    void set_done() {}
+
+    void set_error(absl::Status status) { op->SetError(std::move(status)); }
+
+    void set_stopping() {
+      cancel_registration();
+      {
+        absl::MutexLock lock(&op->mutex);
+        std::sort(op->entries.begin(), op->entries.end(),
+                  [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        op->list_stopped = true;
+      }
+      Emit(std::move(op));
+    }
+  };
+
+  // Emits the entries which are available, in key order.  Only one thread
+  // emits at a time; calls made while another thread is emitting cause it to
+  // repeat.
+  static void Emit(ScanOperation::Ptr op) {
+    {
+      absl::MutexLock lock(&op->mutex);
+      op->emit_requested = true;
+      if (op->emitting) return;
+      op->emitting = true;
+    }
+    while (true) {
+      std::vector<ScanEntry> batch;
+      std::vector<Future<ReadResult>> started;
+      absl::Status status;
+      {
+        absl::MutexLock lock(&op->mutex);
+        if (!op->emit_requested || op->cancelled()) {
+          op->emitting = false;
+          return;
+        }
+        op->emit_requested = false;
+        status = op->CollectEntries(batch, started);
+      }
+      for (auto& future : started) {
+        future.ExecuteWhenReady(
+            [op](ReadyFuture<ReadResult>) { Emit(op); });
+      }
+      for (auto& entry : batch) {
+        execution::set_value(op->shared_receiver->receiver, std::move(entry));
+      }
+      if (!status.ok()) op->SetError(std::move(status));
+    }
+  }
+
+  // Moves the entries which may be emitted in order into `batch`, and starts
+  // the reads of indirect values within `options.read_ahead` entries of the
+  // next entry to emit.
+  absl::Status CollectEntries(std::vector<ScanEntry>& batch,
+                              std::vector<Future<ReadResult>>& started)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    if (!list_stopped) return absl::OkStatus();
+    for (; next_emit < entries.size(); ++next_emit) {
+      StartReads(started);
+      auto& entry = entries[next_emit];
+      absl::Cord value;
+      if (auto* direct_value =
+              std::get_if<absl::Cord>(&entry.value_reference)) {
+        value = *direct_value;
+      } else {
+        if (!entry.read.ready()) break;
+        auto& result = entry.read.result();
+        if (!result.ok()) {
+          // No further entries are emitted.
+          next_emit = entries.size();
+          return result.status();
+        }
+        value = std::move(result->value);
+        entry.read = {};
+      }
+      batch.push_back(ScanEntry{
+          entry.key.substr(
+              std::min(entry.key.size(), options.strip_prefix_length)),
+          std::move(value),
+          TimestampedStorageGeneration{
+              ComputeStorageGeneration(entry.value_reference), time}});
+    }
+    return absl::OkStatus();
+  }
+
+  void StartReads(std::vector<Future<ReadResult>>& started)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    const size_t end = std::min(
+        entries.size(), next_emit + std::max(size_t(1), options.read_ahead));
+    for (next_read = std::max(next_read, next_emit); next_read < end;
+         ++next_read) {
+      auto& entry = entries[next_read];
+      auto* indirect_ref =
+          std::get_if<IndirectDataReference>(&entry.value_reference);
+      if (!indirect_ref) continue;
+      entry.read = io_handle->ReadIndirectData(*indirect_ref, {});
+      started.push_back(entry.read);
+    }
+  }
+};
+
+}  // namespace
+
+void NonDistributedScan(ReadonlyIoHandle::Ptr io_handle,
+                        kvstore::ScanOptions options,
+                        kvstore::ScanReceiver&& receiver) {
+  auto op = internal::MakeIntrusivePtr<ScanOperation>(std::move(receiver));
+  op->io_handle = std::move(io_handle);
+  op->options = std::move(options);
+  auto* op_ptr = op.get();
+  Link(WithExecutor(op_ptr->io_handle->maybe_inline_executor,
+                    ScanOperation::ManifestReadyCallback{std::move(op)}),
+       op_ptr->promise,
+       op_ptr->io_handle->GetManifest(op_ptr->options.staleness_bound));
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
@@ -0,0 +1,36 @@
+// Copyright 2022 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_SCAN_H_
+#define TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_SCAN_H_
+
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/kvstore/operations.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Scans the keys in `options.range` along with their values, in key order.
+///
+/// Values stored inline in the leaf nodes are delivered without additional
+/// reads.  Values stored indirectly are read with up to `options.read_ahead`
+/// reads in progress.
+void NonDistributedScan(ReadonlyIoHandle::Ptr io_handle,
+                        kvstore::ScanOptions options,
+                        kvstore::ScanReceiver&& receiver);
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_SCAN_H_
@@ -15,21 +15,33 @@
 #include "tensorstore/kvstore/operations.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <optional>
 #include <ostream>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/deadline.h"
+#include "tensorstore/internal/tracing/inflight_operation.h"
+#include "tensorstore/internal/tracing/trace_span.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/transaction.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/execution.h"
@@ -37,10 +49,13 @@
 #include "tensorstore/util/execution/sender.h"
 #include "tensorstore/util/execution/sender_util.h"
 #include "tensorstore/util/execution/sync_flow_sender.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
+#include "tensorstore/util/task_priority.h"
 
 namespace tensorstore {
 namespace kvstore {
@@ -79,12 +94,61 @@ Future<std::vector<ListEntry>> ListFuture(const KvStore& store,
           kvstore::List(store, std::move(options))));
 }
 
-Future<ReadResult> Read(const KvStore& store, std::string_view key,
-                        ReadOptions options) {
+Future<std::vector<ScanEntry>> ScanFuture(const KvStore& store,
+                                          ScanOptions options) {
+  return tensorstore::CollectFlowSenderIntoFuture<std::vector<ScanEntry>>(
+      tensorstore::MakeSyncFlowSender(
+          kvstore::Scan(store, std::move(options))));
+}
+
+namespace {
+
+// Records the end-to-end latency of a non-transactional operation on `driver`
+// once `future` becomes ready, along with the number of bytes computed by
+// `get_bytes` from a successful result.  The operation remains registered as
+// `inflight` until then.
+template <typename T, typename GetBytes = std::nullptr_t>
+Future<T> WithOperationMetrics(const Driver& driver,
+                               std::string_view operation,
+                               internal_tracing::InFlightOperation inflight,
+                               absl::Time start_time, Future<T> future,
+                               GetBytes get_bytes = nullptr) {
+  future.ExecuteWhenReady([driver_id = driver.driver_id(), operation,
+                           inflight = std::move(inflight), start_time,
+                           get_bytes = std::move(get_bytes)](
+                              ReadyFuture<T> ready) mutable {
+    inflight.reset();
+    internal_kvstore::RecordOperationLatency(driver_id, operation,
+                                             absl::Now() - start_time);
+    if constexpr (!std::is_same_v<GetBytes, std::nullptr_t>) {
+      if (!ready.status().ok()) return;
+      internal_kvstore::RecordOperationBytes(driver_id, operation,
+                                             get_bytes(ready.value()));
+    }
+  });
+  return future;
+}
+
+Future<ReadResult> ReadImpl(const KvStore& store, std::string_view key,
+                            ReadOptions options) {
+  internal::ScopedTaskPriority scoped_priority(options.priority);
+  options.deadline = std::min(options.deadline, internal::GetCurrentDeadline());
+  internal::ScopedDeadline scoped_deadline(options.deadline);
   auto full_key = tensorstore::StrCat(store.path, key);
   if (store.transaction == no_transaction) {
     // Regular non-transactional read.
-    return store.driver->Read(std::move(full_key), std::move(options));
+    const absl::Time deadline = options.deadline;
+    const absl::Time start_time = absl::Now();
+    internal_tracing::InFlightOperation inflight(
+        "kvstore.read", store.driver->DescribeKey(full_key));
+    return internal::WithDeadline(
+        WithOperationMetrics(
+            *store.driver, "read", std::move(inflight), start_time,
+            store.driver->Read(std::move(full_key), std::move(options)),
+            [](const ReadResult& r) {
+              return static_cast<int64_t>(r.value.size());
+            }),
+        deadline);
   }
   if (!StorageGeneration::IsUnknown(options.generation_conditions.if_equal)) {
     return absl::UnimplementedError(
@@ -107,15 +171,114 @@ Future<ReadResult> Read(const KvStore& store, std::string_view key,
       std::move(transactional_read_options));
 }
 
-Future<TimestampedStorageGeneration> Write(const KvStore& store,
-                                           std::string_view key,
-                                           std::optional<Value> value,
-                                           WriteOptions options) {
+}  // namespace
+
+Future<ReadResult> Read(const KvStore& store, std::string_view key,
+                        ReadOptions options) {
+  internal_tracing::TraceSpan span("tensorstore.kvstore.read");
+  span.SetAttribute("key", key);
+  auto future = ReadImpl(store, key, std::move(options));
+  return internal_tracing::EndWhenReady(std::move(span), std::move(future));
+}
+
+Future<StatResult> Stat(const KvStore& store, std::string_view key,
+                        StatOptions options) {
+  auto full_key = tensorstore::StrCat(store.path, key);
+  if (store.transaction == no_transaction) {
+    const absl::Time start_time = absl::Now();
+    internal_tracing::InFlightOperation inflight(
+        "kvstore.stat", store.driver->DescribeKey(full_key));
+    return WithOperationMetrics(
+        *store.driver, "stat", std::move(inflight), start_time,
+        store.driver->Stat(std::move(full_key), std::move(options)));
+  }
+  // Transactional reads do not support byte ranges, and the size of the value
+  // may depend on pending writes, so the value is read.
+  ReadOptions read_options;
+  read_options.generation_conditions = std::move(options.generation_conditions);
+  read_options.staleness_bound = options.staleness_bound;
+  read_options.batch = std::move(options.batch);
+  return MapFutureValue(
+      InlineExecutor{},
+      [](const ReadResult& read_result) {
+        return StatResult::FromReadResult(
+            read_result, static_cast<int64_t>(read_result.value.size()));
+      },
+      ReadImpl(store, key, std::move(read_options)));
+}
+
+void ReadStream(const KvStore& store, std::string_view key,
+                ReadOptions options, ReadStreamReceiver receiver) {
+  if (store.transaction != no_transaction) {
+    execution::submit(ErrorSender{absl::UnimplementedError(
+                          "transactional streaming read not supported")},
+                      FlowSingleReceiver{std::move(receiver)});
+    return;
+  }
+  store.driver->ReadStreamImpl(tensorstore::StrCat(store.path, key),
+                               std::move(options), std::move(receiver));
+}
+
+namespace {
+
+/// Returns an error if `options.byte_offset` is specified but not supported
+/// for the write.
+absl::Status ValidateByteOffset(const KvStore& store,
+                                const std::string& full_key,
+                                const std::optional<Value>& value,
+                                const WriteOptions& options) {
+  if (!options.byte_offset) return absl::OkStatus();
+  if (store.transaction != no_transaction) {
+    return absl::UnimplementedError(
+        "byte_offset not supported for transactional writes");
+  }
+  if (!value) {
+    return absl::InvalidArgumentError("byte_offset not supported for deletes");
+  }
+  if (*options.byte_offset < 0) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Invalid byte_offset: ", *options.byte_offset));
+  }
+  if ((store.driver->GetSupportedFeatures(KeyRange::Singleton(full_key)) &
+       SupportedFeatures::kByteRangeWrite) == SupportedFeatures::kNone) {
+    return absl::UnimplementedError(
+        tensorstore::StrCat("byte_offset not supported for ",
+                            store.driver->DescribeKey(full_key)));
+  }
+  return absl::OkStatus();
+}
+
+Future<TimestampedStorageGeneration> NonTransactionalWrite(
+    const KvStore& store, std::string full_key, std::optional<Value> value,
+    WriteOptions options) {
+  const int64_t size = value ? static_cast<int64_t>(value->size()) : 0;
+  const absl::Time start_time = absl::Now();
+  internal_tracing::InFlightOperation inflight(
+      "kvstore.write", store.driver->DescribeKey(full_key));
+  return WithOperationMetrics(
+      *store.driver, "write", std::move(inflight), start_time,
+      store.driver->Write(std::move(full_key), std::move(value),
+                          std::move(options)),
+      [size](const TimestampedStorageGeneration&) { return size; });
+}
+
+Future<TimestampedStorageGeneration> WriteImpl(const KvStore& store,
+                                               std::string_view key,
+                                               std::optional<Value> value,
+                                               WriteOptions options) {
+  internal::ScopedTaskPriority scoped_priority(options.priority);
+  options.deadline = std::min(options.deadline, internal::GetCurrentDeadline());
+  internal::ScopedDeadline scoped_deadline(options.deadline);
   auto full_key = tensorstore::StrCat(store.path, key);
+  TENSORSTORE_RETURN_IF_ERROR(
+      ValidateByteOffset(store, full_key, value, options));
   if (store.transaction == no_transaction) {
     // Regular non-transactional write.
-    return store.driver->Write(std::move(full_key), std::move(value),
-                               std::move(options));
+    const absl::Time deadline = options.deadline;
+    return internal::WithDeadline(
+        NonTransactionalWrite(store, std::move(full_key), std::move(value),
+                              std::move(options)),
+        deadline);
   }
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto open_transaction,
@@ -138,15 +301,22 @@ Future<TimestampedStorageGeneration> Write(const KvStore& store,
   return TimestampedStorageGeneration();
 }
 
-Future<TimestampedStorageGeneration> WriteCommitted(const KvStore& store,
-                                                    std::string_view key,
-                                                    std::optional<Value> value,
-                                                    WriteOptions options) {
+Future<TimestampedStorageGeneration> WriteCommittedImpl(
+    const KvStore& store, std::string_view key, std::optional<Value> value,
+    WriteOptions options) {
+  internal::ScopedTaskPriority scoped_priority(options.priority);
+  options.deadline = std::min(options.deadline, internal::GetCurrentDeadline());
+  internal::ScopedDeadline scoped_deadline(options.deadline);
   auto full_key = tensorstore::StrCat(store.path, key);
+  TENSORSTORE_RETURN_IF_ERROR(
+      ValidateByteOffset(store, full_key, value, options));
   if (store.transaction == no_transaction) {
     // Regular non-transactional write.
-    return store.driver->Write(std::move(full_key), std::move(value),
-                               std::move(options));
+    const absl::Time deadline = options.deadline;
+    return internal::WithDeadline(
+        NonTransactionalWrite(store, std::move(full_key), std::move(value),
+                              std::move(options)),
+        deadline);
   }
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto open_transaction,
@@ -157,6 +327,29 @@ Future<TimestampedStorageGeneration> WriteCommitted(const KvStore& store,
       std::move(value), std::move(options));
 }
 
+}  // namespace
+
+Future<TimestampedStorageGeneration> Write(const KvStore& store,
+                                           std::string_view key,
+                                           std::optional<Value> value,
+                                           WriteOptions options) {
+  internal_tracing::TraceSpan span("tensorstore.kvstore.write");
+  span.SetAttribute("key", key);
+  auto future = WriteImpl(store, key, std::move(value), std::move(options));
+  return internal_tracing::EndWhenReady(std::move(span), std::move(future));
+}
+
+Future<TimestampedStorageGeneration> WriteCommitted(const KvStore& store,
+                                                    std::string_view key,
+                                                    std::optional<Value> value,
+                                                    WriteOptions options) {
+  internal_tracing::TraceSpan span("tensorstore.kvstore.write");
+  span.SetAttribute("key", key);
+  auto future =
+      WriteCommittedImpl(store, key, std::move(value), std::move(options));
+  return internal_tracing::EndWhenReady(std::move(span), std::move(future));
+}
+
 Future<TimestampedStorageGeneration> Delete(const KvStore& store,
                                             std::string_view key,
                                             WriteOptions options) {
@@ -181,7 +374,15 @@ Future<const void> DeleteRange(Driver* driver,
 Future<const void> DeleteRange(const KvStore& store, KeyRange range) {
   range = KeyRange::AddPrefix(store.path, std::move(range));
   if (store.transaction == no_transaction) {
-    return store.driver->DeleteRange(std::move(range));
+    const absl::Time start_time = absl::Now();
+    internal_tracing::InFlightOperation inflight(
+        "kvstore.delete_range",
+        tensorstore::StrCat(store.driver->DescribeKey(range.inclusive_min),
+                            " to ",
+                            store.driver->DescribeKey(range.exclusive_max)));
+    return WithOperationMetrics(*store.driver, "delete_range",
+                                std::move(inflight), start_time,
+                                store.driver->DeleteRange(std::move(range)));
   }
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto open_transaction,
@@ -208,6 +409,11 @@ void AddListOptionsPrefix(ListOptions& options, std::string_view path) {
   options.range = KeyRange::AddPrefix(path, std::move(options.range));
   options.strip_prefix_length += path.size();
 }
+
+void AddScanOptionsPrefix(ScanOptions& options, std::string_view path) {
+  options.range = KeyRange::AddPrefix(path, std::move(options.range));
+  options.strip_prefix_length += path.size();
+}
 }  // namespace
 
 void List(const KvStore& store, ListOptions options, ListReceiver receiver) {
@@ -230,5 +436,25 @@ ListSender List(const KvStore& store, ListOptions options) {
   return store.driver->List(std::move(options));
 }
 
+void Scan(const KvStore& store, ScanOptions options, ScanReceiver receiver) {
+  if (store.transaction != no_transaction) {
+    execution::submit(ErrorSender{absl::UnimplementedError(
+                          "transactional scan not supported")},
+                      FlowSingleReceiver{std::move(receiver)});
+    return;
+  }
+  AddScanOptionsPrefix(options, store.path);
+  store.driver->ScanImpl(std::move(options), std::move(receiver));
+}
+
+ScanSender Scan(const KvStore& store, ScanOptions options) {
+  if (store.transaction != no_transaction) {
+    return ErrorSender{
+        absl::UnimplementedError("transactional scan not supported")};
+  }
+  AddScanOptionsPrefix(options, store.path);
+  return store.driver->Scan(std::move(options));
+}
+
 }  // namespace kvstore
 }  // namespace tensorstore
@@ -38,6 +38,7 @@
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/any_sender.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/task_priority.h"
 
 namespace tensorstore {
 namespace kvstore {
@@ -118,9 +119,32 @@ struct ReadOptions {
 
   /// Optional batch to use.
   Batch batch{no_batch};
+
+  /// Scheduling priority of the tasks that carry out the read.
+  TaskPriority priority = TaskPriority::kNormal;
+
+  /// The read fails with `absl::StatusCode::kDeadlineExceeded` if it does not
+  /// complete by `deadline`.  Retries that cannot start before the deadline
+  /// are not attempted.  The default of `absl::InfiniteFuture()` indicates no
+  /// deadline.
+  absl::Time deadline = absl::InfiniteFuture();
+};
+
+/// Options for `Stat`.
+///
+/// \relates KvStore
+struct StatOptions {
+  /// Specifies conditions for the stat.
+  ReadGenerationConditions generation_conditions;
+
+  /// Cached metadata may be used without validation if not older than
+  /// `staleness_bound`, as for `ReadOptions::staleness_bound`.
+  absl::Time staleness_bound{absl::InfiniteFuture()};
+
+  /// Optional batch to use.
+  Batch batch{no_batch};
 };
 
-struct TransactionalReadGenerationConditions {
   /// The read is aborted if the generation associated with the stored ``key``
   /// matches `if_not_equal`.  The special values of
   /// `StorageGeneration::Unknown()` (the default) or
@@ -183,6 +207,25 @@ struct WriteGenerationConditions {
 struct WriteOptions {
   /// Specifies conditions for the write.
   WriteGenerationConditions generation_conditions;
+
+  /// Scheduling priority of the tasks that carry out the write.
+  TaskPriority priority = TaskPriority::kNormal;
+
+  /// The write fails with `absl::StatusCode::kDeadlineExceeded` if it does not
+  /// complete by `deadline`.  For transactional writes, the deadline applies
+  /// only to staging the write in the transaction.  The default of
+  /// `absl::InfiniteFuture()` indicates no deadline.
+  absl::Time deadline = absl::InfiniteFuture();
+
+  /// If specified, the new value overwrites the bytes of the existing value
+  /// starting at this offset, rather than replacing the entire value.  The
+  /// write fails with `absl::StatusCode::kNotFound` if there is no existing
+  /// value, and with `absl::StatusCode::kOutOfRange` if the new value would
+  /// extend past the end of the existing value.
+  ///
+  /// Only supported for non-transactional writes to drivers that report
+  /// `SupportedFeatures::kByteRangeWrite`.
+  std::optional<int64_t> byte_offset;
 };
 
 /// Options for `ListFuture`.
@@ -227,6 +270,53 @@ void PrintTo(const std::vector<ListEntry>& v, ::std::ostream* os);
 using ListReceiver = AnyFlowReceiver<absl::Status, ListEntry>;
 using ListSender = AnyFlowSender<absl::Status, ListEntry>;
 
+/// Receiver for `ReadStream` operations.
+///
+/// If the value is present, it is delivered as a sequence of `ReadResult`
+/// fragments in the `kValue` state which all have the same `stamp`; the value
+/// is the concatenation of the fragments.  Otherwise, a single `ReadResult` in
+/// the `kMissing` or `kUnspecified` state is delivered.  An error may follow
+/// fragments which have already been delivered, in which case the partial
+/// value must be discarded.
+using ReadStreamReceiver = AnyFlowReceiver<absl::Status, ReadResult>;
+using ReadStreamSender = AnyFlowSender<absl::Status, ReadResult>;
+
+/// Options for `Scan`.
+///
+/// \relates KvStore
+struct ScanOptions {
+  /// Only keys in this range are emitted.
+  KeyRange range;
+
+  /// Length of prefix to strip from keys.
+  size_t strip_prefix_length = 0;
+
+  /// Staleness bound on the keys and values.
+  absl::Time staleness_bound = absl::InfiniteFuture();
+
+  /// Maximum number of values read ahead of the entry being delivered, for
+  /// drivers which read each value separately.
+  size_t read_ahead = 16;
+};
+
+/// Entry delivered by `Scan` operations.
+struct ScanEntry {
+  Key key;
+
+  Value value;
+
+  /// Generation and timestamp of `value`.
+  TimestampedStorageGeneration stamp;
+
+  template <typename Sink>
+  friend void AbslStringify(Sink& sink, const ScanEntry& entry) {
+    absl::Format(&sink, "%s", entry.key);
+  }
+};
+
+using ScanReceiver = AnyFlowReceiver<absl::Status, ScanEntry>;
+using ScanSender = AnyFlowSender<absl::Status, ScanEntry>;
+
 /// Options for `CopyRange`.
 ///
 /// \relates KvStore
@@ -254,6 +344,38 @@ struct CopyRangeOptions {
 Future<ReadResult> Read(const KvStore& store, std::string_view key,
                         ReadOptions options = {});
 
+/// Reads the value for the key `store.path + key` incrementally.
+///
+/// Unlike `Read`, the value need not be assembled in memory before it is
+/// delivered.  Drivers which do not support streaming deliver the entire value
+/// as a single fragment.
+///
+/// \param store `KvStore` from which to read.
+/// \param key The key to read, interpreted as a suffix to be appended to
+///     `store.path`.
+/// \param options Specifies options for reading.
+/// \param receiver Receives the value fragments; see `ReadStreamReceiver`.
+/// \relates KvStore
+void ReadStream(const KvStore& store, std::string_view key,
+                ReadOptions options, ReadStreamReceiver receiver);
+
+/// Retrieves the generation, size and timestamp of the value for the key
+/// `store.path + key`, without retrieving the value itself.
+///
+/// Stats issued with the same `options.batch` may be combined by the driver.
+///
+/// .. note::
+///
+///    A missing value is not considered an error.
+///
+/// \param store `KvStore` from which to read.
+/// \param key The key to stat, interpreted as a suffix to be appended to
+///     `store.path`.
+/// \param options Specifies options for the stat.
+/// \relates KvStore
+Future<StatResult> Stat(const KvStore& store, std::string_view key,
+                        StatOptions options = {});
+
 /// Performs an optionally-conditional write.
 ///
 /// Atomically updates or deletes the value stored for `store.path + key`
@@ -353,6 +475,29 @@ inline Future<std::vector<ListEntry>> ListFuture(const DriverPtr& driver,
   return ListFuture(driver.get(), options);
 }
 
+/// Lists the keys in a range along with their values, in key order.
+///
+/// Equivalent to listing the range and then reading each key, except that
+/// drivers which store values together with their keys deliver them without
+/// additional reads, and other drivers read the values concurrently, ahead of
+/// the entry being delivered.  Keys deleted concurrently with the scan may be
+/// omitted.
+///
+/// \param store `KvStore` from which to scan keys.
+/// \param options Scan options.  The `options.range` is interpreted relative
+///     to `store.path`.
+/// \param receiver Receives the entries in key order.
+/// \relates KvStore
+void Scan(const KvStore& store, ScanOptions options, ScanReceiver receiver);
+
+ScanSender Scan(const KvStore& store, ScanOptions options);
+
+/// Calls `Scan` and collects the entries in an `std::vector`.
+///
+/// \relates KvStore
+Future<std::vector<ScanEntry>> ScanFuture(const KvStore& store,
+                                          ScanOptions options = {});
+
 }  // namespace kvstore
 }  // namespace tensorstore
 
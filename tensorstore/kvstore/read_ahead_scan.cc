@@ -0,0 +1,289 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/read_ahead_scan.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+namespace {
+
+using ::tensorstore::kvstore::DriverPtr;
+using ::tensorstore::kvstore::Key;
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListOptions;
+using ::tensorstore::kvstore::ReadOptions;
+using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::ScanEntry;
+using ::tensorstore::kvstore::ScanOptions;
+using ::tensorstore::kvstore::ScanReceiver;
+
+// Maximum number of listed keys buffered before an ordered listing is paused,
+// for listings which support flow control.
+constexpr size_t kMaxBufferedKeys = 4096;
+
+class ReadAheadScanState
+    : public internal::AtomicReferenceCount<ReadAheadScanState> {
+ public:
+  ReadAheadScanState(DriverPtr driver, ScanOptions options,
+                     ScanReceiver receiver, bool ordered_list)
+      : driver_(std::move(driver)),
+        options_(std::move(options)),
+        read_ahead_(std::max(size_t(1), options_.read_ahead)),
+        ordered_list_(ordered_list),
+        receiver_(std::move(receiver)) {}
+
+  void Start() {
+    // `receiver_` may request cancellation until `set_stopping` is called,
+    // which happens before this object is destroyed.
+    execution::set_starting(receiver_, [this] { Cancel(); });
+    ListOptions list_options;
+    list_options.range = options_.range;
+    list_options.staleness_bound = options_.staleness_bound;
+    driver_->ListImpl(
+        std::move(list_options),
+        KeyReceiver{internal::IntrusivePtr<ReadAheadScanState>(this)});
+  }
+
+  struct KeyReceiver {
+    internal::IntrusivePtr<ReadAheadScanState> state;
+
+    void set_starting(AnyCancelReceiver cancel) {
+      {
+        absl::MutexLock lock(&state->mutex_);
+        if (!state->cancelled_ && state->error_.ok()) {
+          state->cancel_list_ = std::move(cancel);
+          return;
+        }
+      }
+      cancel();
+    }
+
+    void set_demand(FlowDemand::Ptr demand) {
+      if (!state->ordered_list_) {
+        // All keys must be listed before any are read.
+        demand->RequestUnbounded();
+        return;
+      }
+      demand->Request(kMaxBufferedKeys);
+      absl::MutexLock lock(&state->mutex_);
+      state->list_demand_ = std::move(demand);
+    }
+
+    void set_value(ListEntry entry) {
+      {
+        absl::MutexLock lock(&state->mutex_);
+        if (state->cancelled_ || !state->error_.ok()) return;
+        state->pending_.push_back(PendingRead{std::move(entry.key), {}});
+      }
+      if (state->ordered_list_) state->Drain();
+    }
+
+    void set_done() {}
+
+    void set_error(absl::Status status) { state->Fail(std::move(status)); }
+
+    void set_stopping() {
+      {
+        absl::MutexLock lock(&state->mutex_);
+        state->list_stopped_ = true;
+        state->cancel_list_ = {};
+        state->list_demand_.reset();
+        if (!state->ordered_list_) {
+          std::sort(state->pending_.begin(), state->pending_.end(),
+                    [](const PendingRead& a, const PendingRead& b) {
+                      return a.key < b.key;
+                    });
+        }
+      }
+      state->Drain();
+    }
+  };
+
+ private:
+  struct PendingRead {
+    Key key;
+    // Null until the read is started.
+    Future<ReadResult> read;
+  };
+
+  void Cancel() {
+    internal::IntrusivePtr<ReadAheadScanState> self(this);
+    AnyCancelReceiver cancel_list;
+    std::deque<PendingRead> pending;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (cancelled_) return;
+      cancelled_ = true;
+      cancel_list = std::move(cancel_list_);
+      pending.swap(pending_);
+      reading_ = 0;
+    }
+    if (cancel_list) cancel_list();
+    Drain();
+  }
+
+  void Fail(absl::Status status) {
+    AnyCancelReceiver cancel_list;
+    std::deque<PendingRead> pending;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (cancelled_ || !error_.ok()) return;
+      error_ = std::move(status);
+      cancel_list = std::move(cancel_list_);
+      pending.swap(pending_);
+      reading_ = 0;
+    }
+    if (cancel_list) cancel_list();
+    Drain();
+  }
+
+  // Sends the values which have been read to `receiver_`, in key order, and
+  // starts reads.  Only one thread delivers at a time; calls made while
+  // another thread is delivering cause it to repeat.
+  void Drain() {
+    {
+      absl::MutexLock lock(&mutex_);
+      drain_requested_ = true;
+      if (delivering_) return;
+      delivering_ = true;
+    }
+    while (true) {
+      std::vector<PendingRead> completed;
+      std::vector<Future<ReadResult>> started;
+      FlowDemand::Ptr list_demand;
+      bool finish = false;
+      absl::Status status;
+      {
+        absl::MutexLock lock(&mutex_);
+        if (!drain_requested_ || finished_) {
+          delivering_ = false;
+          return;
+        }
+        drain_requested_ = false;
+        if (cancelled_ || !error_.ok()) {
+          finished_ = true;
+          finish = true;
+          status = error_;
+        } else {
+          while (!pending_.empty() && !pending_.front().read.null() &&
+                 pending_.front().read.ready()) {
+            completed.push_back(std::move(pending_.front()));
+            pending_.pop_front();
+            --reading_;
+          }
+          if (!completed.empty()) list_demand = list_demand_;
+          if (ordered_list_ || list_stopped_) StartReads(started);
+          if (list_stopped_ && pending_.empty()) {
+            finished_ = true;
+            finish = true;
+          }
+        }
+      }
+      for (auto& future : started) {
+        future.ExecuteWhenReady(
+            [self = internal::IntrusivePtr<ReadAheadScanState>(this)](
+                ReadyFuture<ReadResult>) { self->Drain(); });
+      }
+      if (list_demand) list_demand->Request(completed.size());
+      for (auto& pending : completed) {
+        auto& result = pending.read.result();
+        if (!result.ok()) {
+          Fail(result.status());
+          break;
+        }
+        if (!result->has_value()) continue;
+        Key key = std::move(pending.key);
+        key.erase(0, std::min(key.size(), options_.strip_prefix_length));
+        execution::set_value(receiver_,
+                             ScanEntry{std::move(key), std::move(result->value),
+                                       std::move(result->stamp)});
+      }
+      if (finish) {
+        if (status.ok()) {
+          execution::set_done(receiver_);
+        } else {
+          execution::set_error(receiver_, std::move(status));
+        }
+        execution::set_stopping(receiver_);
+      }
+    }
+  }
+
+  // Starts reads of the next pending keys, such that at most `read_ahead_`
+  // reads are in progress or waiting to be delivered.
+  void StartReads(std::vector<Future<ReadResult>>& started)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    while (reading_ < read_ahead_ && reading_ < pending_.size()) {
+      auto& pending = pending_[reading_++];
+      ReadOptions read_options;
+      read_options.staleness_bound = options_.staleness_bound;
+      pending.read = driver_->Read(pending.key, std::move(read_options));
+      started.push_back(pending.read);
+    }
+  }
+
+  const DriverPtr driver_;
+  const ScanOptions options_;
+  const size_t read_ahead_;
+  const bool ordered_list_;
+  ScanReceiver receiver_;
+
+  absl::Mutex mutex_;
+  AnyCancelReceiver cancel_list_ ABSL_GUARDED_BY(mutex_);
+  FlowDemand::Ptr list_demand_ ABSL_GUARDED_BY(mutex_);
+  // Listed keys which have not been delivered, in key order.  Reads have been
+  // started for the first `reading_` keys.
+  std::deque<PendingRead> pending_ ABSL_GUARDED_BY(mutex_);
+  size_t reading_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool list_stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status error_ ABSL_GUARDED_BY(mutex_);
+  bool delivering_ ABSL_GUARDED_BY(mutex_) = false;
+  bool drain_requested_ ABSL_GUARDED_BY(mutex_) = false;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace
+
+void ReadAheadScan(DriverPtr driver, ScanOptions options,
+                   ScanReceiver receiver, bool ordered_list) {
+  internal::MakeIntrusivePtr<ReadAheadScanState>(
+      std::move(driver), std::move(options), std::move(receiver),
+      ordered_list)
+      ->Start();
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
@@ -0,0 +1,42 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_READ_AHEAD_SCAN_H_
+#define TENSORSTORE_KVSTORE_READ_AHEAD_SCAN_H_
+
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Implements `Scan` by listing `options.range` using `driver->ListImpl` and
+/// reading each listed key using `driver->Read`.
+///
+/// The values are read in key order, with at most `options.read_ahead` reads
+/// in progress or waiting to be delivered at once.  Keys which are missing
+/// when read are skipped.
+///
+/// If `ordered_list` is `true`, `driver` must list keys in key order, and
+/// reading begins while the listing is still in progress; the number of
+/// buffered keys is bounded using the flow control of the listing, if
+/// supported.  Otherwise, all listed keys are buffered and sorted before they
+/// are read.
+void ReadAheadScan(kvstore::DriverPtr driver, kvstore::ScanOptions options,
+                   kvstore::ScanReceiver receiver, bool ordered_list);
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_READ_AHEAD_SCAN_H_
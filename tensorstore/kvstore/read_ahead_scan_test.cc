@@ -0,0 +1,102 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/read_ahead_scan.h"
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/execution/future_collecting_receiver.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::FutureCollectingReceiver;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::KeyRange;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::internal::MatchesScanEntry;
+using ::tensorstore::internal_kvstore::ReadAheadScan;
+using ::testing::ElementsAre;
+
+class ReadAheadScanTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(store_,
+                                     kvstore::Open("memory://").result());
+    for (const char* key : {"d", "a/1", "e", "b", "c/1"}) {
+      TENSORSTORE_ASSERT_OK(kvstore::Write(store_, key, absl::Cord(key)));
+    }
+  }
+
+  tensorstore::Result<std::vector<kvstore::ScanEntry>> Scan(
+      kvstore::ScanOptions options) {
+    auto [promise, future] =
+        PromiseFuturePair<std::vector<kvstore::ScanEntry>>::Make();
+    // The memory driver lists keys in key order.
+    ReadAheadScan(store_.driver, std::move(options),
+                  FutureCollectingReceiver<std::vector<kvstore::ScanEntry>>{
+                      std::move(promise)},
+                  /*ordered_list=*/GetParam());
+    return future.result();
+  }
+
+  kvstore::KvStore store_;
+};
+
+INSTANTIATE_TEST_SUITE_P(OrderedList, ReadAheadScanTest, ::testing::Bool());
+
+TEST_P(ReadAheadScanTest, EntriesInKeyOrder) {
+  for (size_t read_ahead : {1, 2, 16}) {
+    SCOPED_TRACE(read_ahead);
+    kvstore::ScanOptions options;
+    options.read_ahead = read_ahead;
+    EXPECT_THAT(Scan(options),
+                IsOkAndHolds(ElementsAre(
+                    MatchesScanEntry("a/1", absl::Cord("a/1")),
+                    MatchesScanEntry("b", absl::Cord("b")),
+                    MatchesScanEntry("c/1", absl::Cord("c/1")),
+                    MatchesScanEntry("d", absl::Cord("d")),
+                    MatchesScanEntry("e", absl::Cord("e")))));
+  }
+}
+
+TEST_P(ReadAheadScanTest, RangeAndStripPrefix) {
+  kvstore::ScanOptions options;
+  options.range = KeyRange::Prefix("c/");
+  options.strip_prefix_length = 2;
+  EXPECT_THAT(Scan(options), IsOkAndHolds(ElementsAre(MatchesScanEntry(
+                                 "1", absl::Cord("c/1")))));
+}
+
+TEST_P(ReadAheadScanTest, Empty) {
+  kvstore::ScanOptions options;
+  options.range = KeyRange::Prefix("x/");
+  EXPECT_THAT(Scan(options), IsOkAndHolds(::testing::IsEmpty()));
+}
+
+}  // namespace
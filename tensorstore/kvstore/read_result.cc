@@ -46,5 +46,11 @@ std::ostream& operator<<(std::ostream& os, const ReadResult& x) {
   }
   return os << ", stamp=" << x.stamp << "}";
 }
+
+std::ostream& operator<<(std::ostream& os, const StatResult& x) {
+  os << "{state=" << x.state;
+  if (x.state == ReadResult::kValue) os << ", size=" << x.size;
+  return os << ", stamp=" << x.stamp << "}";
+}
 }  // namespace kvstore
 }  // namespace tensorstore
@@ -16,6 +16,7 @@
 #define TENSORSTORE_KVSTORE_READ_RESULT_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <iosfwd>
 #include <optional>
@@ -144,6 +145,56 @@ struct ReadResult {
   friend std::ostream& operator<<(std::ostream& os, State state);
 };
 
+/// Metadata of a stored value, as returned by `kvstore::Stat`.
+struct StatResult {
+  using State = ReadResult::State;
+
+  /// Constructs the result of a stat from the result of a read which did not
+  /// retrieve the value.
+  static StatResult FromReadResult(const ReadResult& read_result,
+                                   int64_t size = -1) {
+    return StatResult{read_result.state,
+                      read_result.has_value() ? size : int64_t{-1},
+                      read_result.stamp};
+  }
+
+  /// Indicates whether the value is present, as for `ReadResult::state`.
+  State state = State::kUnspecified;
+
+  /// Size of the value in bytes if `state == kValue`, or `-1` if the size is
+  /// not known.
+  int64_t size = -1;
+
+  /// Generation and timestamp associated with `state`.
+  TimestampedStorageGeneration stamp;
+
+  /// Returns `true` if the stat was aborted because the conditions were not
+  /// satisfied.
+  bool aborted() const { return state == State::kUnspecified; }
+
+  /// Returns `true` if the key was not found.
+  bool not_found() const { return state == State::kMissing; }
+
+  /// Returns `true` if a value is present.
+  bool has_value() const { return state == State::kValue; }
+
+  // Reflection support.
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.state, x.size, x.stamp);
+  };
+
+  /// Compares two stat results for equality.
+  friend bool operator==(const StatResult& a, const StatResult& b) {
+    return a.state == b.state && a.size == b.size && a.stamp == b.stamp;
+  }
+  friend bool operator!=(const StatResult& a, const StatResult& b) {
+    return !(a == b);
+  }
+
+  /// Prints a debugging string representation to an `std::ostream`.
+  friend std::ostream& operator<<(std::ostream& os, const StatResult& x);
+};
+
 }  // namespace kvstore
 }  // namespace tensorstore
 
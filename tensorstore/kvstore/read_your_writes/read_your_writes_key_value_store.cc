@@ -0,0 +1,362 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Key-value store adapter which serves reads of recently written keys from
+/// memory, for base key-value stores that are only eventually consistent.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+// specializations
+#include "tensorstore/internal/cache_key/absl_time.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/absl_time.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/absl_time.h"  // IWYU pragma: keep
+
+namespace tensorstore {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+using ::tensorstore::kvstore::ListReceiver;
+using ::tensorstore::kvstore::ReadResult;
+
+auto& read_your_writes_hit_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/read_your_writes/hit_count",
+    "Number of reads served from recent writes without accessing the base "
+    "kvstore.");
+
+struct ReadYourWritesKvStoreSpecData {
+  kvstore::Spec base;
+  absl::Duration max_age;
+  size_t total_bytes_limit;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.base, x.max_age, x.total_bytes_limit);
+  };
+
+  constexpr static auto default_json_binder = jb::Validate(
+      [](const auto& options, auto* obj) -> absl::Status {
+        if (obj->max_age < absl::ZeroDuration() ||
+            obj->max_age == absl::InfiniteDuration()) {
+          return absl::InvalidArgumentError(
+              "\"max_age\" must be non-negative and finite");
+        }
+        return absl::OkStatus();
+      },
+      jb::Object(
+          jb::Member("base",
+                     jb::Projection<&ReadYourWritesKvStoreSpecData::base>()),
+          jb::Member("max_age",
+                     jb::Projection<&ReadYourWritesKvStoreSpecData::max_age>(
+                         jb::DefaultValue([](auto* v) {
+                           *v = absl::Seconds(60);
+                         }))),
+          jb::Member(
+              "total_bytes_limit",
+              jb::Projection<
+                  &ReadYourWritesKvStoreSpecData::total_bytes_limit>(
+                  jb::DefaultValue([](auto* v) { *v = 64 * 1024 * 1024; })))));
+};
+
+class ReadYourWritesKvStoreSpec
+    : public internal_kvstore::RegisteredDriverSpec<
+          ReadYourWritesKvStoreSpec, ReadYourWritesKvStoreSpecData> {
+ public:
+  static constexpr char id[] = "read_your_writes";
+
+  Future<kvstore::DriverPtr> DoOpen() const override;
+
+  absl::Status ApplyOptions(kvstore::DriverSpecOptions&& options) override {
+    return data_.base.driver.Set(std::move(options));
+  }
+
+  Result<kvstore::Spec> GetBase(std::string_view path) const override {
+    kvstore::Spec base = data_.base;
+    base.AppendSuffix(path);
+    return base;
+  }
+};
+
+/// Defines the "read_your_writes" KeyValueStore driver.
+///
+/// Successful writes are recorded in memory, together with the generation
+/// returned by the base kvstore, for `max_age`.  Reads of a recorded key are
+/// served from the record rather than from the base kvstore, which may still
+/// return the previous value.  Values that do not fit within
+/// `total_bytes_limit` are recorded by generation only, such that conditional
+/// reads with a matching `if_not_equal` generation are still answered from
+/// memory.
+///
+/// Since the same driver is shared by all opens of an equivalent spec within a
+/// `Context`, all readers and writers in the process observe the records.
+class ReadYourWritesKvStore
+    : public internal_kvstore::RegisteredDriver<ReadYourWritesKvStore,
+                                                ReadYourWritesKvStoreSpec> {
+ public:
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override;
+
+  Future<const void> DeleteRange(KeyRange range) override;
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override {
+    kvstore::List(base_, std::move(options), std::move(receiver));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    return base_.driver->DescribeKey(tensorstore::StrCat(base_.path, key));
+  }
+
+  absl::Status GetBoundSpecData(ReadYourWritesKvStoreSpecData& spec) const {
+    spec = spec_data_;
+    return absl::OkStatus();
+  }
+
+  kvstore::SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    // Written values are remembered whole, so partial writes are not
+    // supported.
+    return base_.driver->GetSupportedFeatures(
+               KeyRange::AddPrefix(base_.path, key_range)) &
+           ~kvstore::SupportedFeatures::kByteRangeWrite;
+  }
+
+  Result<KvStore> GetBase(std::string_view path,
+                          const Transaction& transaction) const override {
+    return KvStore(base_.driver, tensorstore::StrCat(base_.path, path),
+                   transaction);
+  }
+
+  /// Returns the result of reading `key` if it can be determined from a
+  /// recent write.
+  std::optional<Result<ReadResult>> ReadFromRecord(const Key& key,
+                                                   const ReadOptions& options);
+
+  /// Records the result of a successful write of `value` to `key`.
+  void Record(const Key& key, const TimestampedStorageGeneration& stamp,
+              const std::optional<Value>& value);
+
+  /// Removes the records for all keys in `range`.
+  void EraseRange(const KeyRange& range);
+
+  ReadYourWritesKvStoreSpecData spec_data_;
+  kvstore::KvStore base_;
+
+ private:
+  struct WriteRecord {
+    StorageGeneration generation;
+    absl::Time write_time;
+    // Set if the value is retained.  A value of `std::nullopt` indicates that
+    // the key was deleted.
+    std::optional<std::optional<Value>> value;
+    std::list<std::string>::iterator order_it;
+  };
+  using Records = absl::btree_map<std::string, WriteRecord>;
+
+  size_t RecordSize(const WriteRecord& record) const {
+    return (record.value && *record.value) ? (*record.value)->size() : 0;
+  }
+
+  void EraseRecord(Records::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Removes records older than `max_age`, and the oldest values until the
+  /// retained values fit within `total_bytes_limit`.
+  void EvictRecords(absl::Time now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  Records records_ ABSL_GUARDED_BY(mutex_);
+  // Keys of `records_` in order of increasing `write_time`.
+  std::list<std::string> order_ ABSL_GUARDED_BY(mutex_);
+  // Total size of the values retained in `records_`.
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+Future<kvstore::DriverPtr> ReadYourWritesKvStoreSpec::DoOpen() const {
+  return MapFutureValue(
+      InlineExecutor{},
+      [spec = internal::IntrusivePtr<const ReadYourWritesKvStoreSpec>(this)](
+          kvstore::KvStore& base) -> Result<kvstore::DriverPtr> {
+        auto driver = internal::MakeIntrusivePtr<ReadYourWritesKvStore>();
+        driver->spec_data_ = spec->data_;
+        driver->base_ = std::move(base);
+        driver->SetBatchNestingDepth(driver->base_.driver->BatchNestingDepth() +
+                                     1);
+        return driver;
+      },
+      kvstore::Open(data_.base));
+}
+
+void ReadYourWritesKvStore::EraseRecord(Records::iterator it) {
+  total_bytes_ -= RecordSize(it->second);
+  order_.erase(it->second.order_it);
+  records_.erase(it);
+}
+
+void ReadYourWritesKvStore::EvictRecords(absl::Time now) {
+  const absl::Time min_write_time = now - spec_data_.max_age;
+  while (!order_.empty()) {
+    auto it = records_.find(order_.front());
+    if (it->second.write_time >= min_write_time &&
+        total_bytes_ <= spec_data_.total_bytes_limit) {
+      break;
+    }
+    EraseRecord(it);
+  }
+}
+
+std::optional<Result<ReadResult>> ReadYourWritesKvStore::ReadFromRecord(
+    const Key& key, const ReadOptions& options) {
+  absl::MutexLock lock(&mutex_);
+  const absl::Time now = absl::Now();
+  EvictRecords(now);
+  auto it = records_.find(key);
+  if (it == records_.end()) return std::nullopt;
+  const auto& record = it->second;
+  // Absent writes by other processes, the recorded generation is current.
+  TimestampedStorageGeneration stamp{record.generation, now};
+  if (!options.generation_conditions.Matches(stamp.generation)) {
+    return ReadResult::Unspecified(std::move(stamp));
+  }
+  if (!record.value) return std::nullopt;
+  if (!*record.value) return ReadResult::Missing(std::move(stamp));
+  const auto& value = **record.value;
+  TENSORSTORE_ASSIGN_OR_RETURN(auto byte_range,
+                               options.byte_range.Validate(value.size()));
+  return ReadResult::Value(internal::GetSubCord(value, byte_range),
+                           std::move(stamp));
+}
+
+void ReadYourWritesKvStore::Record(const Key& key,
+                                   const TimestampedStorageGeneration& stamp,
+                                   const std::optional<Value>& value) {
+  absl::MutexLock lock(&mutex_);
+  const absl::Time now = absl::Now();
+  auto [it, inserted] = records_.try_emplace(key);
+  auto& record = it->second;
+  if (!inserted) {
+    // Concurrent writes may complete out of order.
+    if (record.write_time > stamp.time) return;
+    total_bytes_ -= RecordSize(record);
+    order_.erase(record.order_it);
+  }
+  record.generation = stamp.generation;
+  record.write_time = stamp.time;
+  if (!value || value->size() <= spec_data_.total_bytes_limit) {
+    record.value = value;
+  } else {
+    record.value = std::nullopt;
+  }
+  total_bytes_ += RecordSize(record);
+  // Writes almost always complete in order of `stamp.time`, so appending
+  // keeps `order_` sorted in practice; an occasional out-of-order record is
+  // merely evicted late.
+  record.order_it = order_.insert(order_.end(), key);
+  EvictRecords(now);
+}
+
+void ReadYourWritesKvStore::EraseRange(const KeyRange& range) {
+  absl::MutexLock lock(&mutex_);
+  for (auto it = records_.lower_bound(range.inclusive_min);
+       it != records_.end() &&
+       KeyRange::CompareKeyAndExclusiveMax(it->first, range.exclusive_max) <
+           0;) {
+    EraseRecord(it++);
+  }
+}
+
+Future<ReadResult> ReadYourWritesKvStore::Read(Key key, ReadOptions options) {
+  if (auto result = ReadFromRecord(key, options)) {
+    read_your_writes_hit_count.Increment();
+    return std::move(*result);
+  }
+  return kvstore::Read(base_, std::move(key), std::move(options));
+}
+
+Future<TimestampedStorageGeneration> ReadYourWritesKvStore::Write(
+    Key key, std::optional<Value> value, WriteOptions options) {
+  auto future = kvstore::Write(base_, key, value, std::move(options));
+  future.ExecuteWhenReady(
+      [self = internal::IntrusivePtr<ReadYourWritesKvStore>(this),
+       key = std::move(key), value = std::move(value)](
+          ReadyFuture<TimestampedStorageGeneration> ready) {
+        auto& r = ready.result();
+        // An unknown generation indicates that the write condition was not
+        // satisfied.
+        if (!r.ok() || StorageGeneration::IsUnknown(r->generation)) return;
+        self->Record(key, *r, value);
+      });
+  return future;
+}
+
+Future<const void> ReadYourWritesKvStore::DeleteRange(KeyRange range) {
+  // Records are removed both before and after the deletion, such that reads
+  // issued in the meantime are forwarded to the base kvstore.
+  EraseRange(range);
+  auto future = kvstore::DeleteRange(base_, range);
+  future.ExecuteWhenReady(
+      [self = internal::IntrusivePtr<ReadYourWritesKvStore>(this),
+       range = std::move(range)](ReadyFuture<const void> ready) {
+        self->EraseRange(range);
+      });
+  return future;
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(
+    tensorstore::ReadYourWritesKvStore)
+
+// Registers the driver.
+namespace {
+const tensorstore::internal_kvstore::DriverRegistration<
+    tensorstore::ReadYourWritesKvStoreSpec>
+    registration;
+}  // namespace
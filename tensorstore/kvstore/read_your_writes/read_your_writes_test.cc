@@ -0,0 +1,180 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/mock_kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::TimestampedStorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultAborted;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal::MockKeyValueStore;
+using ::tensorstore::internal::MockKeyValueStoreResource;
+
+TEST(ReadYourWritesTest, Basic) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "read_your_writes"},
+                                 {"base", "memory://data/"}},
+                                context)
+                      .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(ReadYourWritesTest, DeleteRange) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "read_your_writes"},
+                                 {"base", "memory://data/"}},
+                                context)
+                      .result());
+  tensorstore::internal::TestKeyValueStoreDeleteRange(store);
+}
+
+TEST(ReadYourWritesTest, SpecRoundtrip) {
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "read_your_writes"},
+      {"base", {{"driver", "memory"}, {"path", "a/"}}},
+      {"max_age", "30s"},
+      {"total_bytes_limit", 1000},
+  };
+  options.full_base_spec = {{"driver", "memory"}, {"path", "a/"}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(ReadYourWritesTest, InvalidSpec) {
+  auto context = Context::Default();
+  EXPECT_THAT(kvstore::Open({{"driver", "read_your_writes"},
+                             {"base", "memory://"},
+                             {"max_age", "-1s"}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"max_age\" must be non-negative and finite.*"));
+}
+
+// Tests that reads of recently written keys do not access the base kvstore,
+// which may still return the previous value.
+TEST(ReadYourWritesTest, ReadAfterWrite) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context.GetResource<MockKeyValueStoreResource>());
+  MockKeyValueStore* mock_store = mock_key_value_store_resource->get();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "read_your_writes"},
+                     {"base", {{"driver", "mock_key_value_store"}}},
+                     {"total_bytes_limit", 5}},
+                    context)
+          .result());
+
+  const auto g1 = StorageGeneration::FromString("g1");
+  auto write_future = kvstore::Write(store, "key", absl::Cord("value"));
+  mock_store->write_requests.pop().promise.SetResult(
+      TimestampedStorageGeneration(g1, absl::Now()));
+  TENSORSTORE_ASSERT_OK(write_future.result());
+
+  EXPECT_THAT(kvstore::Read(store, "key").result(),
+              MatchesKvsReadResult(absl::Cord("value"), g1));
+  kvstore::ReadOptions options;
+  options.generation_conditions.if_not_equal = g1;
+  EXPECT_THAT(kvstore::Read(store, "key", options).result(),
+              MatchesKvsReadResultAborted());
+  options = {};
+  options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 3);
+  EXPECT_THAT(kvstore::Read(store, "key", options).result(),
+              MatchesKvsReadResult(absl::Cord("al"), g1));
+  EXPECT_TRUE(mock_store->read_requests.empty());
+
+  // Values larger than `total_bytes_limit` are remembered by generation only.
+  const auto g2 = StorageGeneration::FromString("g2");
+  write_future = kvstore::Write(store, "key", absl::Cord("long value"));
+  mock_store->write_requests.pop().promise.SetResult(
+      TimestampedStorageGeneration(g2, absl::Now()));
+  TENSORSTORE_ASSERT_OK(write_future.result());
+  options = {};
+  options.generation_conditions.if_not_equal = g2;
+  EXPECT_THAT(kvstore::Read(store, "key", options).result(),
+              MatchesKvsReadResultAborted());
+  EXPECT_TRUE(mock_store->read_requests.empty());
+  auto read_future = kvstore::Read(store, "key");
+  mock_store->read_requests.pop().promise.SetResult(kvstore::ReadResult::Value(
+      absl::Cord("long value"), TimestampedStorageGeneration(g2, absl::Now())));
+  EXPECT_THAT(read_future.result(),
+              MatchesKvsReadResult(absl::Cord("long value"), g2));
+
+  // Deleted keys are read as missing until the deletion is forgotten.
+  write_future = kvstore::Delete(store, "key");
+  mock_store->write_requests.pop().promise.SetResult(
+      TimestampedStorageGeneration(StorageGeneration::NoValue(), absl::Now()));
+  TENSORSTORE_ASSERT_OK(write_future.result());
+  EXPECT_THAT(kvstore::Read(store, "key").result(),
+              MatchesKvsReadResultNotFound());
+  EXPECT_TRUE(mock_store->read_requests.empty());
+}
+
+TEST(ReadYourWritesTest, DeleteRangeForgetsWrites) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context.GetResource<MockKeyValueStoreResource>());
+  MockKeyValueStore* mock_store = mock_key_value_store_resource->get();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "read_your_writes"},
+                     {"base", {{"driver", "mock_key_value_store"}}}},
+                    context)
+          .result());
+
+  auto write_future = kvstore::Write(store, "key", absl::Cord("value"));
+  mock_store->write_requests.pop().promise.SetResult(
+      TimestampedStorageGeneration(StorageGeneration::FromString("g1"),
+                                   absl::Now()));
+  TENSORSTORE_ASSERT_OK(write_future.result());
+
+  auto delete_future = kvstore::DeleteRange(store, tensorstore::KeyRange{});
+  mock_store->delete_range_requests.pop().promise.SetResult(
+      absl::OkStatus());
+  TENSORSTORE_ASSERT_OK(delete_future.result());
+
+  auto read_future = kvstore::Read(store, "key");
+  mock_store->read_requests.pop().promise.SetResult(
+      kvstore::ReadResult::Missing(absl::Now()));
+  EXPECT_THAT(read_future.result(), MatchesKvsReadResultNotFound());
+}
+
+}  // namespace
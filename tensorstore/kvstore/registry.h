@@ -204,6 +204,8 @@ class RegisteredDriver : public Parent {
     DerivedSpec::EncodeCacheKeyImpl(out, bound_spec_data);
   }
 
+  std::string_view driver_id() const override { return DerivedSpec::id; }
+
   Result<DriverSpecPtr> GetBoundSpec() const override {
     auto spec = internal::MakeIntrusivePtr<DerivedSpec>();
     spec->context_binding_state_ = ContextBindingState::bound;
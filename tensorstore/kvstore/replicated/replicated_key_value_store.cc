@@ -0,0 +1,374 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Key-value store adapter which reads from several replicas of the same data.
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/context.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_array.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/hedged_read.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+// specializations
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/cache_key/std_optional.h"
+#include "tensorstore/internal/cache_key/std_vector.h"
+#include "tensorstore/internal/context_binding_vector.h"
+#include "tensorstore/serialization/std_optional.h"
+#include "tensorstore/serialization/std_vector.h"
+#include "tensorstore/util/apply_members/apply_members.h"
+#include "tensorstore/util/garbage_collection/std_optional.h"
+#include "tensorstore/util/garbage_collection/std_vector.h"
+
+namespace tensorstore {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+using ::tensorstore::kvstore::Key;
+using ::tensorstore::kvstore::ListOptions;
+using ::tensorstore::kvstore::ListReceiver;
+using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::SupportedFeatures;
+
+// Weight of each new sample in the moving average of replica read latencies.
+constexpr double kLatencyWeight = 0.2;
+
+// Latency recorded for a failed read, such that replicas which fail are
+// deprioritized until they succeed again, e.g. when reached by a hedged read.
+constexpr absl::Duration kFailureLatency = absl::Seconds(10);
+
+struct ReplicatedKeyValueStoreSpecData {
+  std::vector<kvstore::Spec> replicas;
+  size_t primary;
+  std::optional<double> hedge_read_percentile;
+  std::optional<double> hedge_read_budget;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.replicas, x.primary, x.hedge_read_percentile,
+             x.hedge_read_budget);
+  };
+
+  constexpr static auto default_json_binder = jb::Validate(
+      [](const auto& options, auto* obj) -> absl::Status {
+        if (obj->replicas.empty()) {
+          return absl::InvalidArgumentError(
+              "At least one replica must be specified");
+        }
+        if (obj->primary >= obj->replicas.size()) {
+          return absl::InvalidArgumentError(tensorstore::StrCat(
+              "Invalid primary of ", obj->primary, " for ",
+              obj->replicas.size(), " replicas"));
+        }
+        return absl::OkStatus();
+      },
+      jb::Object(
+          jb::Member("replicas",
+                     jb::Projection<&ReplicatedKeyValueStoreSpecData::replicas>(
+                         jb::Array())),
+          jb::Member("primary",
+                     jb::Projection<&ReplicatedKeyValueStoreSpecData::primary>(
+                         jb::DefaultValue([](auto* v) { *v = 0; }))),
+          jb::Member(
+              "hedge_read_percentile",
+              jb::Projection<
+                  &ReplicatedKeyValueStoreSpecData::hedge_read_percentile>(
+                  jb::Optional(internal_kvstore::HedgeReadPercentileBinder()))),
+          jb::Member(
+              "hedge_read_budget",
+              jb::Projection<
+                  &ReplicatedKeyValueStoreSpecData::hedge_read_budget>(
+                  jb::Optional(internal_kvstore::HedgeReadBudgetBinder())))));
+};
+
+class ReplicatedKeyValueStoreSpec
+    : public internal_kvstore::RegisteredDriverSpec<
+          ReplicatedKeyValueStoreSpec, ReplicatedKeyValueStoreSpecData> {
+ public:
+  static constexpr char id[] = "replicated";
+
+  Future<kvstore::DriverPtr> DoOpen() const override;
+};
+
+/// Defines the "replicated" KeyValueStore driver.
+///
+/// Reads are routed to the replica with the lowest moving average of recent
+/// read latencies, and are retried on the other replicas, in order of
+/// increasing latency, if they fail.  All other operations are forwarded to
+/// the primary replica.
+class ReplicatedKeyValueStore
+    : public internal_kvstore::RegisteredDriver<ReplicatedKeyValueStore,
+                                                ReplicatedKeyValueStoreSpec> {
+ public:
+  // Order in which the replicas are read.
+  using ReplicaOrder = std::shared_ptr<const std::vector<size_t>>;
+
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override {
+    return kvstore::Write(primary(), std::move(key), std::move(value),
+                          std::move(options));
+  }
+
+  Future<const void> DeleteRange(KeyRange range) override {
+    return kvstore::DeleteRange(primary(), std::move(range));
+  }
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override {
+    // Listing is not retried on other replicas, since entries may already
+    // have been emitted when a failure occurs.
+    kvstore::List(primary(), std::move(options), std::move(receiver));
+  }
+
+  absl::Status ReadModifyWrite(internal::OpenTransactionPtr& transaction,
+                               size_t& phase, Key key,
+                               ReadModifyWriteSource& source) override {
+    return primary().driver->ReadModifyWrite(
+        transaction, phase, tensorstore::StrCat(primary().path, key), source);
+  }
+
+  absl::Status TransactionalDeleteRange(
+      const internal::OpenTransactionPtr& transaction,
+      KeyRange range) override {
+    return primary().driver->TransactionalDeleteRange(
+        transaction, KeyRange::AddPrefix(primary().path, std::move(range)));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    return primary().driver->DescribeKey(
+        tensorstore::StrCat(primary().path, key));
+  }
+
+  SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    // Partial writes could not be applied consistently to the replicas.
+    return primary().driver->GetSupportedFeatures(
+               KeyRange::AddPrefix(primary().path, key_range)) &
+           ~SupportedFeatures::kByteRangeWrite;
+  }
+
+  /// Obtains a `BoundSpec` representation from an open `Driver`.
+  absl::Status GetBoundSpecData(ReplicatedKeyValueStoreSpecData& spec) const {
+    spec = spec_;
+    spec.replicas.clear();
+    for (const auto& replica : replicas_) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto replica_spec, replica.spec(ContextBindingMode::retain));
+      spec.replicas.push_back(std::move(replica_spec));
+    }
+    return absl::OkStatus();
+  }
+
+  const KvStore& primary() const { return replicas_[spec_.primary]; }
+
+  /// Returns the replicas in order of increasing estimated latency.
+  ///
+  /// Replicas without an estimate are ordered first, such that each replica
+  /// is sampled.
+  ReplicaOrder RankReplicas() const;
+
+  /// Reads from the `i`-th replica in `order`, falling back to the next
+  /// replicas in `order`, cyclically, for up to `remaining` replicas in total.
+  Future<ReadResult> ReadReplica(ReplicaOrder order, size_t i,
+                                 size_t remaining, Key key,
+                                 ReadOptions options);
+
+  /// Updates the latency estimate of `replica`.
+  void RecordLatency(size_t replica, absl::Duration latency);
+
+  ReplicatedKeyValueStoreSpecData spec_;
+  std::vector<KvStore> replicas_;
+
+  // Set if `hedge_read_percentile` is specified.
+  std::unique_ptr<internal_kvstore::ReadHedger> read_hedger_;
+
+  mutable absl::Mutex mutex_;
+  // Moving average of the read latency of each replica, or
+  // `absl::ZeroDuration()` if none has been recorded.
+  std::vector<absl::Duration> latencies_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Returns `true` if a read failing with `status` should be retried on another
+// replica, i.e. if the failure may be specific to the replica.
+bool ShouldTryOtherReplica(const absl::Status& status) {
+  switch (status.code()) {
+    case absl::StatusCode::kInvalidArgument:
+    case absl::StatusCode::kOutOfRange:
+    case absl::StatusCode::kCancelled:
+      return false;
+    default:
+      return true;
+  }
+}
+
+Future<kvstore::DriverPtr> ReplicatedKeyValueStoreSpec::DoOpen() const {
+  auto driver = internal::MakeIntrusivePtr<ReplicatedKeyValueStore>();
+  driver->spec_ = data_;
+
+  std::vector<Future<kvstore::KvStore>> replica_futures;
+  replica_futures.reserve(data_.replicas.size());
+  for (const auto& replica : data_.replicas) {
+    replica_futures.push_back(kvstore::Open(replica));
+  }
+
+  auto wait_all = WaitAllFuture(tensorstore::span(replica_futures));
+  return MapFuture(
+      InlineExecutor{},
+      [driver = std::move(driver),
+       replica_futures = std::move(replica_futures)](
+          const Result<void>& all) mutable -> Result<kvstore::DriverPtr> {
+        TENSORSTORE_RETURN_IF_ERROR(all);
+        size_t batch_nesting_depth = 0;
+        for (auto& f : replica_futures) {
+          batch_nesting_depth = std::max(batch_nesting_depth,
+                                         f.value().driver->BatchNestingDepth());
+          driver->replicas_.push_back(std::move(f.value()));
+        }
+        driver->SetBatchNestingDepth(batch_nesting_depth + 1);
+        driver->latencies_.resize(driver->replicas_.size(),
+                                  absl::ZeroDuration());
+        if (driver->spec_.hedge_read_percentile &&
+            driver->replicas_.size() > 1) {
+          driver->read_hedger_ = std::make_unique<internal_kvstore::ReadHedger>(
+              *driver->spec_.hedge_read_percentile,
+              driver->spec_.hedge_read_budget.value_or(
+                  internal_kvstore::ReadHedger::kDefaultBudget));
+        }
+        return driver;
+      },
+      std::move(wait_all));
+}
+
+ReplicatedKeyValueStore::ReplicaOrder ReplicatedKeyValueStore::RankReplicas()
+    const {
+  auto order = std::make_shared<std::vector<size_t>>(replicas_.size());
+  std::iota(order->begin(), order->end(), size_t{0});
+  absl::MutexLock lock(&mutex_);
+  std::stable_sort(order->begin(), order->end(), [&](size_t a, size_t b) {
+    return latencies_[a] < latencies_[b];
+  });
+  return order;
+}
+
+void ReplicatedKeyValueStore::RecordLatency(size_t replica,
+                                            absl::Duration latency) {
+  absl::MutexLock lock(&mutex_);
+  auto& average = latencies_[replica];
+  average = (average == absl::ZeroDuration())
+                ? latency
+                : average + (latency - average) * kLatencyWeight;
+}
+
+Future<ReadResult> ReplicatedKeyValueStore::Read(Key key, ReadOptions options) {
+  auto order = RankReplicas();
+  const size_t num_replicas = order->size();
+  if (!read_hedger_) {
+    return ReadReplica(std::move(order), 0, num_replicas, std::move(key),
+                       std::move(options));
+  }
+  // The hedged read starts from the next fastest replica rather than
+  // duplicating the read of the replica which is slow to respond.
+  return read_hedger_->Read(
+      [self = internal::IntrusivePtr<ReplicatedKeyValueStore>(this),
+       order = std::move(order), key = std::move(key),
+       options = std::move(options),
+       attempt = std::make_shared<std::atomic<size_t>>(0)] {
+        return self->ReadReplica(order, attempt->fetch_add(1),
+                                 order->size(), key, options);
+      });
+}
+
+Future<ReadResult> ReplicatedKeyValueStore::ReadReplica(ReplicaOrder order,
+                                                        size_t i,
+                                                        size_t remaining,
+                                                        Key key,
+                                                        ReadOptions options) {
+  const size_t replica = (*order)[i % order->size()];
+  auto future = kvstore::Read(replicas_[replica], key, options);
+  return PromiseFuturePair<ReadResult>::Link(
+             [self = internal::IntrusivePtr<ReplicatedKeyValueStore>(this),
+              order = std::move(order), i, remaining, replica,
+              key = std::move(key), options = std::move(options),
+              start_time = absl::Now()](Promise<ReadResult> promise,
+                                        ReadyFuture<ReadResult> f) mutable {
+               auto& result = f.result();
+               if (result.ok()) {
+                 self->RecordLatency(replica, absl::Now() - start_time);
+               } else if (ShouldTryOtherReplica(result.status())) {
+                 self->RecordLatency(replica, kFailureLatency);
+                 if (remaining > 1) {
+                   if (!promise.result_needed()) return;
+                   LinkResult(std::move(promise),
+                              self->ReadReplica(std::move(order), i + 1,
+                                                remaining - 1, std::move(key),
+                                                std::move(options)));
+                   return;
+                 }
+               }
+               promise.SetResult(result);
+             },
+             std::move(future))
+      .future;
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(
+    tensorstore::ReplicatedKeyValueStore)
+
+// Registers the driver.
+namespace {
+const tensorstore::internal_kvstore::DriverRegistration<
+    tensorstore::ReplicatedKeyValueStoreSpec>
+    registration;
+}  // namespace
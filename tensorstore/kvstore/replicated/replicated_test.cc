@@ -0,0 +1,166 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/mock_kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal::MockKeyValueStore;
+using ::tensorstore::internal::MockKeyValueStoreResource;
+
+TEST(ReplicatedTest, Basic) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "replicated"},
+                     {"replicas", {"memory://data/", "memory://data/"}}},
+                    context)
+          .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(ReplicatedTest, List) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "replicated"},
+                     {"replicas", {"memory://data/", "memory://data/"}}},
+                    context)
+          .result());
+  tensorstore::internal::TestKeyValueStoreList(store);
+}
+
+TEST(ReplicatedTest, SpecRoundtrip) {
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "replicated"},
+      {"replicas",
+       {{{"driver", "memory"}, {"path", "a/"}},
+        {{"driver", "memory"}, {"path", "a/"}}}},
+      {"primary", 1},
+      {"hedge_read_percentile", 95.0},
+  };
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(ReplicatedTest, InvalidSpec) {
+  auto context = Context::Default();
+  EXPECT_THAT(kvstore::Open({{"driver", "replicated"},
+                             {"replicas", ::nlohmann::json::array_t{}}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*At least one replica must be specified.*"));
+  EXPECT_THAT(kvstore::Open({{"driver", "replicated"},
+                             {"replicas", {"memory://a/"}},
+                             {"primary", 1}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*Invalid primary of 1 for 1 replicas.*"));
+}
+
+TEST(ReplicatedTest, WritesGoToPrimary) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "replicated"},
+                     {"replicas", {"memory://a/", "memory://b/"}},
+                     {"primary", 1}},
+                    context)
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base, kvstore::Open("memory://", context).result());
+
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "key", absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(base, "b/key").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(base, "a/key").result(),
+              MatchesKvsReadResultNotFound());
+}
+
+TEST(ReplicatedTest, FailedReadFallsBackToOtherReplica) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context.GetResource<MockKeyValueStoreResource>());
+  MockKeyValueStore* mock_store = mock_key_value_store_resource->get();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "replicated"},
+                     {"replicas",
+                      {{{"driver", "mock_key_value_store"}}, "memory://b/"}},
+                     {"primary", 1}},
+                    context)
+          .result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "key", absl::Cord("value")));
+
+  // Neither replica has a latency estimate, so the first replica is read.
+  auto read_future = kvstore::Read(store, "key");
+  {
+    auto req = mock_store->read_requests.pop();
+    EXPECT_EQ("key", req.key);
+    req.promise.SetResult(absl::UnavailableError("replica unavailable"));
+  }
+  EXPECT_THAT(read_future.result(), MatchesKvsReadResult(absl::Cord("value")));
+
+  // The failed replica is now deprioritized.
+  EXPECT_THAT(kvstore::Read(store, "key").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  EXPECT_TRUE(mock_store->read_requests.empty());
+}
+
+TEST(ReplicatedTest, ReadErrorNotRetried) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context.GetResource<MockKeyValueStoreResource>());
+  MockKeyValueStore* mock_store = mock_key_value_store_resource->get();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "replicated"},
+                     {"replicas",
+                      {{{"driver", "mock_key_value_store"}}, "memory://b/"}}},
+                    context)
+          .result());
+
+  auto read_future = kvstore::Read(store, "key");
+  mock_store->read_requests.pop().promise.SetResult(
+      absl::OutOfRangeError("invalid byte range"));
+  EXPECT_THAT(read_future.result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+}
+
+}  // namespace
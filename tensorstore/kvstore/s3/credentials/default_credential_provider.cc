@@ -14,6 +14,8 @@
 
 #include "tensorstore/kvstore/s3/credentials/default_credential_provider.h"
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <memory>
 #include <string>
@@ -25,14 +27,17 @@
 #include "absl/base/no_destructor.h"
 #include "absl/functional/function_ref.h"
 #include "absl/log/absl_log.h"
+#include "absl/random/distributions.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "tensorstore/internal/http/http_transport.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/thread/thread_pool.h"
 #include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
 #include "tensorstore/kvstore/s3/credentials/ec2_credential_provider.h"
 #include "tensorstore/kvstore/s3/credentials/environment_credential_provider.h"
 #include "tensorstore/kvstore/s3/credentials/file_credential_provider.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/result.h"
 
 namespace tensorstore {
@@ -41,6 +46,14 @@ namespace {
 
 ABSL_CONST_INIT internal_log::VerboseFlag s3_logging("s3");
 
+constexpr absl::Duration kRefreshRetryDelay = absl::Seconds(10);
+
+const Executor& GetRefreshExecutor() {
+  static absl::NoDestructor<Executor> executor(
+      internal::DetachedThreadPool(2));
+  return *executor;
+}
+
 struct AwsCredentialProviderRegistry {
   std::vector<std::pair<int, AwsCredentialProviderFn>> providers;
   absl::Mutex mutex;
@@ -97,22 +110,100 @@ DefaultAwsCredentialsProvider::DefaultAwsCredentialsProvider(
       clock_(clock),
       credentials_{{}, {}, {}, absl::InfinitePast()} {}
 
+DefaultAwsCredentialsProvider::~DefaultAwsCredentialsProvider() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+    mutex_.Await(absl::Condition(
+        +[](bool* refreshing) { return !*refreshing; },
+        &background_refresh_));
+  }
+  // Ensure the background task has released `refresh_mutex_`.
+  absl::MutexLock refresh_lock(&refresh_mutex_);
+}
+
 Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
   {
     absl::ReaderMutexLock lock(&mutex_);
+    absl::Time now = clock_();
+    if (credentials_.expires_at > now &&
+        (now < refresh_at_ || background_refresh_ || stopped_)) {
+      return credentials_;
+    }
+  }
+
+  uint64_t generation;
+  {
+    absl::MutexLock lock(&mutex_);
     if (credentials_.expires_at > clock_()) {
+      // The credentials are still usable; refresh them off the request path.
+      if (!background_refresh_ && !stopped_) {
+        background_refresh_ = true;
+        GetRefreshExecutor()([this] { BackgroundRefresh(); });
+      }
+      return credentials_;
+    }
+    generation = generation_;
+  }
+
+  absl::MutexLock refresh_lock(&refresh_mutex_);
+  {
+    // Another caller may have refreshed the credentials while this one was
+    // waiting; share its result rather than querying the source again.
+    absl::ReaderMutexLock lock(&mutex_);
+    if (generation_ != generation || credentials_.expires_at > clock_()) {
       return credentials_;
     }
   }
+  auto credentials = Refresh();
+  absl::MutexLock lock(&mutex_);
+  SetCredentials(std::move(credentials));
+  return credentials_;
+}
 
-  absl::WriterMutexLock lock(&mutex_);
+void DefaultAwsCredentialsProvider::BackgroundRefresh() {
+  absl::MutexLock refresh_lock(&refresh_mutex_);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (stopped_ || !provider_) {
+      background_refresh_ = false;
+      return;
+    }
+  }
+  // Only the current source is queried; falling back to other sources (and
+  // ultimately anonymous credentials) is left to the request path once the
+  // current credentials have actually expired.
+  auto credentials_result = provider_->GetCredentials();
+  absl::MutexLock lock(&mutex_);
+  if (credentials_result.ok()) {
+    SetCredentials(std::move(credentials_result).value());
+  } else {
+    if (s3_logging) {
+      ABSL_LOG(INFO) << "Background credential refresh failed: "
+                     << credentials_result.status();
+    }
+    refresh_at_ = clock_() + kRefreshRetryDelay;
+  }
+  background_refresh_ = false;
+}
+
+void DefaultAwsCredentialsProvider::SetCredentials(
+    AwsCredentials credentials) {
+  absl::Time now = clock_();
+  ++generation_;
+  credentials_ = std::move(credentials);
+  absl::Duration lead =
+      kRefreshLead + absl::Uniform(gen_, absl::ZeroDuration(), kRefreshJitter);
+  refresh_at_ = std::max(credentials_.expires_at - lead,
+                         now + (credentials_.expires_at - now) / 2);
+}
 
+AwsCredentials DefaultAwsCredentialsProvider::Refresh() {
   // Refresh existing credentials
   if (provider_) {
     auto credentials_result = provider_->GetCredentials();
     if (credentials_result.ok()) {
-      credentials_ = credentials_result.value();
-      return credentials_;
+      return std::move(credentials_result).value();
     }
   }
 
@@ -128,8 +219,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
     provider_ = std::make_unique<EnvironmentCredentialProvider>();
     if (auto credentials_result = provider_->GetCredentials();
         credentials_result.ok()) {
-      credentials_ = std::move(credentials_result).value();
-      return credentials_;
+      return std::move(credentials_result).value();
     } else if (s3_logging) {
       ABSL_LOG_FIRST_N(INFO, 1)
           << "Could not acquire credentials from environment: "
@@ -144,8 +234,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
                                                          options_.profile);
     if (auto credentials_result = provider_->GetCredentials();
         credentials_result.ok()) {
-      credentials_ = std::move(credentials_result).value();
-      return credentials_;
+      return std::move(credentials_result).value();
     } else if (s3_logging) {
       ABSL_LOG_FIRST_N(INFO, 1)
           << "Could not acquire credentials from file/profile: "
@@ -159,8 +248,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
         options_.endpoint, options_.transport);
     if (auto credentials_result = provider_->GetCredentials();
         credentials_result.ok()) {
-      credentials_ = std::move(credentials_result).value();
-      return credentials_;
+      return std::move(credentials_result).value();
     } else if (s3_logging) {
       ABSL_LOG(INFO)
           << "Could not acquire credentials from EC2 Metadata Server "
@@ -170,8 +258,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
 
   // 4. Anonymous credentials
   provider_ = nullptr;
-  credentials_ = AwsCredentials::Anonymous();
-  return credentials_;
+  return AwsCredentials::Anonymous();
 }
 
 }  // namespace internal_kvstore_s3
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_S3_CREDENTIALS_DEFAULT_CREDENTIAL_PROVIDER_H_
 #define TENSORSTORE_KVSTORE_S3_CREDENTIALS_DEFAULT_CREDENTIAL_PROVIDER_H_
 
+#include <stdint.h>
+
 #include <functional>
 #include <memory>
 #include <string>
@@ -22,6 +24,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/functional/function_ref.h"
+#include "absl/random/random.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -42,7 +45,12 @@ namespace internal_kvstore_s3 {
 ///
 /// The cached credentials are returned until they expire,
 /// at which point the original source is queried again to
-/// obtain fresher credentials
+/// obtain fresher credentials.
+///
+/// Expiring credentials are refreshed from their source in the background
+/// once they are within `kRefreshLead` (plus a random jitter) of expiry, so
+/// that callers normally never block.  When the credentials have expired,
+/// concurrent callers share a single query of the sources.
 class DefaultAwsCredentialsProvider : public AwsCredentialProvider {
  public:
   /// Options to configure the provider. These include the:
@@ -58,17 +66,42 @@ class DefaultAwsCredentialsProvider : public AwsCredentialProvider {
     std::shared_ptr<internal_http::HttpTransport> transport;
   };
 
+  /// Minimum time ahead of expiry at which credentials are refreshed in the
+  /// background, and the maximum random jitter added to it.  The refresh
+  /// point is never earlier than halfway through the credential lifetime.
+  static constexpr absl::Duration kRefreshLead = absl::Minutes(4);
+  static constexpr absl::Duration kRefreshJitter = absl::Minutes(1);
+
   DefaultAwsCredentialsProvider(
       Options options = {{}, {}, {}, internal_http::GetDefaultHttpTransport()},
       absl::FunctionRef<absl::Time()> clock = absl::Now);
+  ~DefaultAwsCredentialsProvider() override;
+
   Result<AwsCredentials> GetCredentials() override;
 
  private:
+  // Queries the sources in order, returning anonymous credentials if none
+  // are available.
+  AwsCredentials Refresh() ABSL_EXCLUSIVE_LOCKS_REQUIRED(refresh_mutex_);
+  void BackgroundRefresh() ABSL_LOCKS_EXCLUDED(refresh_mutex_, mutex_);
+  void SetCredentials(AwsCredentials credentials)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   Options options_;
   absl::FunctionRef<absl::Time()> clock_;
+
+  // Held while querying the sources, so that at most one query is in flight.
+  absl::Mutex refresh_mutex_ ABSL_ACQUIRED_BEFORE(mutex_);
+  std::unique_ptr<AwsCredentialProvider> provider_
+      ABSL_GUARDED_BY(refresh_mutex_);
+
   absl::Mutex mutex_;
-  std::unique_ptr<AwsCredentialProvider> provider_ ABSL_GUARDED_BY(mutex_);
   AwsCredentials credentials_ ABSL_GUARDED_BY(mutex_);
+  absl::Time refresh_at_ ABSL_GUARDED_BY(mutex_) = absl::InfiniteFuture();
+  uint64_t generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool background_refresh_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::BitGen gen_ ABSL_GUARDED_BY(mutex_);
 };
 
 using AwsCredentialProviderFn =
@@ -195,4 +195,37 @@ TEST_F(DefaultCredentialProviderTest, ConfigureEC2ProviderFromOptions) {
   EXPECT_EQ(credentials.expires_at, absl::InfiniteFuture());
 }
 
+TEST_F(DefaultCredentialProviderTest, RefreshesEC2CredentialsAheadOfExpiry) {
+  auto now = absl::Now();
+  auto clock = [&]() -> absl::Time { return now; };
+  auto expiry = now + absl::Hours(1);
+
+  auto mock_transport = std::make_shared<DefaultMockHttpTransport>(
+      DefaultEC2MetadataFlow(kEndpoint, "1234", "ASIA1234567890",
+                             "1234567890abcdef", "token", expiry));
+
+  auto provider = std::make_unique<DefaultAwsCredentialsProvider>(
+      Options{{}, {}, kEndpoint, mock_transport}, clock);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto credentials,
+                                   provider->GetCredentials());
+  EXPECT_EQ(credentials.session_token, "token");
+  EXPECT_EQ(credentials.expires_at, expiry - absl::Seconds(60));
+
+  // Within the refresh lead the cached credentials are returned while new
+  // ones are fetched in the background.
+  now = credentials.expires_at - DefaultAwsCredentialsProvider::kRefreshLead;
+  auto new_expiry = expiry + absl::Hours(1);
+  mock_transport->Reset(
+      DefaultEC2MetadataFlow(kEndpoint, "1234", "ASIA1234567890",
+                             "1234567890abcdef", "TOKEN", new_expiry));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(credentials, provider->GetCredentials());
+  EXPECT_EQ(credentials.session_token, "token");
+
+  while (credentials.session_token != "TOKEN") {
+    absl::SleepFor(absl::Milliseconds(1));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(credentials, provider->GetCredentials());
+  }
+  EXPECT_EQ(credentials.expires_at, new_expiry - absl::Seconds(60));
+}
+
 }  // namespace
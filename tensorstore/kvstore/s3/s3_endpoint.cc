@@ -72,6 +72,20 @@ struct S3VirtualHostFormatter {
   }
 };
 
+// Directory buckets (S3 Express One Zone) are accessed using virtual-host
+// style addressing of a zonal endpoint:
+//
+// <bucket>.s3express-<zone_id>.<aws_region>.amazonaws.com
+//
+// https://docs.aws.amazon.com/AmazonS3/latest/userguide/s3-express-networking.html
+struct S3ExpressFormatter {
+  std::string GetEndpoint(std::string_view bucket,
+                          std::string_view aws_region) const {
+    return absl::StrFormat("https://%s.s3express-%s.%s.amazonaws.com", bucket,
+                           GetDirectoryBucketZoneId(bucket), aws_region);
+  }
+};
+
 // Construct a path-style hostname and host header.
 struct S3PathFormatter {
   std::string GetEndpoint(std::string_view bucket,
@@ -136,6 +150,20 @@ std::variant<absl::Status, S3EndpointRegion> ValidateEndpoint(
   }
 
   if (endpoint.empty()) {
+    if (IsDirectoryBucket(bucket)) {
+      // The zone id does not determine the region name, and directory buckets
+      // do not respond to the HEAD request used to resolve the region.
+      if (aws_region.empty()) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Directory bucket ", QuoteString(bucket),
+            " requires \"aws_region\" to be specified"));
+      }
+      S3ExpressFormatter formatter;
+      return S3EndpointRegion{
+          formatter.GetEndpoint(bucket, aws_region),
+          aws_region,
+      };
+    }
     if (!aws_region.empty()) {
       if (!absl::StrContains(bucket, ".")) {
         // Use virtual host addressing.
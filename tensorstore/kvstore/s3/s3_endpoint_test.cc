@@ -68,6 +68,17 @@ TEST(ValidateEndpointTest, Basic) {
       ::testing::VariantWith<S3EndpointRegion>(
           S3EndpointRegion{"http://my.host/testbucket", "region"}));
 
+  // Directory buckets use the zonal endpoint, and require a region.
+  EXPECT_THAT(
+      ValidateEndpoint("bucket--usw2-az1--x-s3", "us-west-2", {}, {}),
+      ::testing::VariantWith<S3EndpointRegion>(S3EndpointRegion{
+          "https://bucket--usw2-az1--x-s3.s3express-usw2-az1.us-west-2."
+          "amazonaws.com",
+          "us-west-2"}));
+  EXPECT_THAT(ValidateEndpoint("bucket--usw2-az1--x-s3", {}, {}, {}),
+              ::testing::VariantWith<absl::Status>(
+                  tensorstore::StatusIs(absl::StatusCode::kInvalidArgument)));
+
   // error: host header with empty endpoint
   EXPECT_THAT(ValidateEndpoint("testbucket", {}, {}, "my.header"),
               ::testing::VariantWith<absl::Status>(
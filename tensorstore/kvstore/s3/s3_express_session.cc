@@ -0,0 +1,146 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/s3/s3_express_session.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/attributes.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/http/http_request.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
+#include "tensorstore/kvstore/s3/s3_endpoint.h"
+#include "tensorstore/kvstore/s3/s3_metadata.h"
+#include "tensorstore/kvstore/s3/s3_request_builder.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tinyxml2.h"
+
+using ::tensorstore::internal_http::HttpResponse;
+
+namespace tensorstore {
+namespace internal_kvstore_s3 {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag s3_logging("s3");
+
+/// SHA256 hash of the empty `CreateSession` request body.
+static constexpr char kEmptySha256[] =
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+}  // namespace
+
+Result<AwsCredentials> ParseCreateSessionResponse(std::string_view payload) {
+  tinyxml2::XMLDocument xml_document;
+  if (int xmlcode = xml_document.Parse(payload.data(), payload.size());
+      xmlcode != tinyxml2::XML_SUCCESS) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Malformed CreateSession response: ", xmlcode));
+  }
+  auto* root = xml_document.FirstChildElement("CreateSessionResult");
+  auto* node =
+      root == nullptr ? nullptr : root->FirstChildElement("Credentials");
+  if (node == nullptr) {
+    return absl::InvalidArgumentError(
+        "Malformed CreateSession response: missing <Credentials>");
+  }
+  AwsCredentials credentials;
+  credentials.access_key = GetNodeText(node->FirstChildElement("AccessKeyId"));
+  credentials.secret_key =
+      GetNodeText(node->FirstChildElement("SecretAccessKey"));
+  credentials.session_token =
+      GetNodeText(node->FirstChildElement("SessionToken"));
+  std::string expiration = GetNodeText(node->FirstChildElement("Expiration"));
+  std::string error;
+  if (credentials.access_key.empty() || credentials.session_token.empty() ||
+      !absl::ParseTime(absl::RFC3339_full, expiration,
+                       &credentials.expires_at, &error)) {
+    return absl::InvalidArgumentError(
+        "Malformed CreateSession response: invalid <Credentials>");
+  }
+  return credentials;
+}
+
+Result<AwsCredentials> S3ExpressSessionCache::GetCredentials(
+    const AwsCredentials& credentials, const S3EndpointRegion& ehr) {
+  Future<AwsCredentials> future;
+  bool created = false;
+  std::optional<AwsCredentials> current;
+  {
+    absl::MutexLock lock(&mutex_);
+    const absl::Time now = absl::Now();
+    if (session_.expires_at - now > kRefreshWindow) return session_;
+    if (pending_.null()) {
+      pending_ = CreateSession(credentials, ehr);
+      created = true;
+    }
+    future = pending_;
+    if (session_.expires_at - now > kMinRemaining) current = session_;
+  }
+  if (created) {
+    // Registered outside the lock, since the callback may run immediately.
+    future.ExecuteWhenReady(
+        [self = shared_from_this()](ReadyFuture<AwsCredentials> ready) {
+          self->OnSession(ready.result());
+        });
+  }
+  // Continue to use the current session while the refresh is in progress.
+  if (current) return *std::move(current);
+  return future.result();
+}
+
+Future<AwsCredentials> S3ExpressSessionCache::CreateSession(
+    const AwsCredentials& credentials, const S3EndpointRegion& ehr) {
+  auto request = S3RequestBuilder("GET", absl::StrCat(ehr.endpoint, "/"))
+                     .AddQueryParameter("session", "")
+                     .MaybeUseS3ExpressAuth(true, /*create_session=*/true)
+                     .BuildRequest(host_header_, credentials, ehr.aws_region,
+                                   kEmptySha256, absl::Now());
+  ABSL_LOG_IF(INFO, s3_logging) << "CreateSession: " << request;
+  return MapFutureValue(
+      InlineExecutor{},
+      [](const HttpResponse& response) -> Result<AwsCredentials> {
+        TENSORSTORE_RETURN_IF_ERROR(
+            internal_http::HttpResponseCodeToStatus(response),
+            MaybeAnnotateStatus(_, "CreateSession request failed"));
+        return ParseCreateSessionResponse(response.payload.Flatten());
+      },
+      transport_->IssueRequest(request, {}));
+}
+
+void S3ExpressSessionCache::OnSession(const Result<AwsCredentials>& session) {
+  absl::MutexLock lock(&mutex_);
+  if (session.ok()) {
+    session_ = *session;
+  } else {
+    ABSL_LOG_IF(INFO, s3_logging)
+        << "CreateSession failed: " << session.status();
+  }
+  // A failed request is retried by the next call to `GetCredentials`.
+  pending_ = Future<AwsCredentials>();
+}
+
+}  // namespace internal_kvstore_s3
+}  // namespace tensorstore
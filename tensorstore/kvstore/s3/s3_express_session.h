@@ -0,0 +1,89 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_S3_S3_EXPRESS_SESSION_H_
+#define TENSORSTORE_KVSTORE_S3_S3_EXPRESS_SESSION_H_
+
+/// \file
+/// Session credentials for S3 Express One Zone directory buckets.
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/http/http_transport.h"
+#include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
+#include "tensorstore/kvstore/s3/s3_endpoint.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_kvstore_s3 {
+
+/// Parses the body of a `CreateSession` response.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_CreateSession.html
+Result<AwsCredentials> ParseCreateSessionResponse(std::string_view payload);
+
+/// Caches the session credentials used to authorize requests to a directory
+/// bucket.
+///
+/// Requests to directory buckets are signed with short-lived credentials
+/// returned by `CreateSession`, which avoids authorizing each request against
+/// IAM.  Sessions are valid for 5 minutes; a new session is created in the
+/// background once the current one is within `kRefreshWindow` of expiring, so
+/// that requests only wait for `CreateSession` when no usable session exists.
+class S3ExpressSessionCache
+    : public std::enable_shared_from_this<S3ExpressSessionCache> {
+ public:
+  /// Remaining lifetime below which the session is refreshed in the
+  /// background.
+  static constexpr absl::Duration kRefreshWindow = absl::Minutes(1);
+
+  /// Remaining lifetime below which the session is no longer used, to allow
+  /// for clock skew and request latency.
+  static constexpr absl::Duration kMinRemaining = absl::Seconds(10);
+
+  S3ExpressSessionCache(std::string host_header,
+                        std::shared_ptr<internal_http::HttpTransport> transport)
+      : host_header_(std::move(host_header)),
+        transport_(std::move(transport)) {}
+
+  /// Returns session credentials for the bucket at `ehr`, creating a session
+  /// using `credentials` if necessary.
+  Result<AwsCredentials> GetCredentials(const AwsCredentials& credentials,
+                                        const S3EndpointRegion& ehr);
+
+ private:
+  Future<AwsCredentials> CreateSession(const AwsCredentials& credentials,
+                                       const S3EndpointRegion& ehr);
+
+  void OnSession(const Result<AwsCredentials>& session);
+
+  std::string host_header_;
+  std::shared_ptr<internal_http::HttpTransport> transport_;
+
+  absl::Mutex mutex_;
+  AwsCredentials session_ ABSL_GUARDED_BY(mutex_);
+  // Pending `CreateSession` request, if any.
+  Future<AwsCredentials> pending_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_kvstore_s3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_S3_S3_EXPRESS_SESSION_H_
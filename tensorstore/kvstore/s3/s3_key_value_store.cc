@@ -15,31 +15,37 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <typeinfo>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include <openssl/md5.h>
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/digest/sha256.h"
 #include "tensorstore/internal/http/curl_transport.h"
+#include "tensorstore/internal/http/http_header.h"
 #include "tensorstore/internal/http/http_request.h"
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/internal/http/http_transport.h"
@@ -48,6 +54,7 @@
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/histogram.h"
+#include "tensorstore/internal/rate_limiter/admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/source_location.h"
 #include "tensorstore/internal/thread/schedule_at.h"
@@ -57,28 +64,37 @@
 #include "tensorstore/kvstore/gcs/validate.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/generic_coalescing_batch_util.h"
+#include "tensorstore/kvstore/hedged_read.h"
 #include "tensorstore/kvstore/http/byte_range_util.h"
+#include "tensorstore/kvstore/http/parallel_read.h"
 #include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_ahead_scan.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
 #include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
 #include "tensorstore/kvstore/s3/credentials/default_credential_provider.h"
 #include "tensorstore/kvstore/s3/s3_endpoint.h"
+#include "tensorstore/kvstore/s3/s3_express_session.h"
 #include "tensorstore/kvstore/s3/s3_metadata.h"
 #include "tensorstore/kvstore/s3/s3_request_builder.h"
 #include "tensorstore/kvstore/s3/s3_resource.h"
 #include "tensorstore/kvstore/s3/s3_uri_utils.h"
 #include "tensorstore/kvstore/s3/validate.h"
+#include "tensorstore/kvstore/segmented_list.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/url_registry.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 #include "tinyxml2.h"
@@ -102,11 +118,14 @@ using ::tensorstore::internal_http::HttpResponse;
 using ::tensorstore::internal_http::HttpTransport;
 using ::tensorstore::internal_kvstore_s3::AwsCredentialProvider;
 using ::tensorstore::internal_kvstore_s3::AwsCredentials;
+using ::tensorstore::internal_kvstore_s3::BuildDeleteObjectsRequest;
 using ::tensorstore::internal_kvstore_s3::GetAwsCredentialProvider;
 using ::tensorstore::internal_kvstore_s3::GetNodeText;
 using ::tensorstore::internal_kvstore_s3::IsValidBucketName;
 using ::tensorstore::internal_kvstore_s3::IsValidObjectName;
 using ::tensorstore::internal_kvstore_s3::IsValidStorageGeneration;
+using ::tensorstore::internal_kvstore_s3::kMaxDeleteObjectsKeys;
+using ::tensorstore::internal_kvstore_s3::ParseDeleteObjectsResponse;
 using ::tensorstore::internal_kvstore_s3::S3ConcurrencyResource;
 using ::tensorstore::internal_kvstore_s3::S3EndpointRegion;
 using ::tensorstore::internal_kvstore_s3::S3RateLimiterResource;
@@ -142,6 +161,9 @@ auto& s3_retries = internal_metrics::Counter<int64_t>::New(
 auto& s3_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/s3/read", "S3 driver kvstore::Read calls");
 
+auto& s3_stat = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/s3/stat", "S3 driver kvstore::Stat calls");
+
 auto& s3_batch_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/s3/batch_read", "S3 driver reads after batching");
 
@@ -162,6 +184,10 @@ auto& s3_delete_range = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/s3/delete_range",
     "S3 driver kvstore::DeleteRange calls");
 
+auto& s3_copy_range = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/s3/copy_range",
+    "S3 driver kvstore::ExperimentalCopyRange calls");
+
 auto& s3_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/s3/list", "S3 driver kvstore::List calls");
 
@@ -174,9 +200,23 @@ static constexpr char kUriScheme[] = "s3";
 static constexpr char kEmptySha256[] =
     "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
 
+/// Payload hash used to sign requests without hashing the payload.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-header-based-auth.html
+static constexpr char kUnsignedPayload[] = "UNSIGNED-PAYLOAD";
+
 /// An empty etag which should not collide with an actual payload hash
 static constexpr char kEmptyEtag[] = "\"\"";
 
+/// Limits on multipart uploads.
+/// https://docs.aws.amazon.com/AmazonS3/latest/userguide/qfacts.html
+static constexpr int64_t kMinUploadPartSize = 5 * 1024 * 1024;
+static constexpr int64_t kMaxUploadParts = 10000;
+
+/// Objects larger than this must be copied with UploadPartCopy.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_CopyObject.html
+static constexpr int64_t kMaxCopyObjectSize = int64_t{5} * 1024 * 1024 * 1024;
+static constexpr int64_t kCopyPartSize = int64_t{1} * 1024 * 1024 * 1024;
+
 /// Adds the generation header to the provided builder.
 bool AddGenerationHeader(S3RequestBuilder* builder, std::string_view header,
                          const StorageGeneration& gen) {
@@ -284,10 +324,36 @@ struct S3KeyValueStoreSpecData {
   Context::Resource<S3RequestRetries> retries;
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency;
 
+  /// Reads larger than this size are split into concurrent requests of at most
+  /// this size.
+  std::optional<int64_t> parallel_read_part_size;
+
+  /// Values larger than this size are written using a multipart upload with
+  /// parts of this size.
+  std::optional<int64_t> parallel_upload_part_size;
+
+  /// Reads which have not completed after this percentile of recent read
+  /// latencies are duplicated.
+  std::optional<double> hedge_read_percentile;
+
+  /// Maximum fraction of reads which are duplicated.
+  std::optional<double> hedge_read_budget;
+
+  /// Whether request payloads are included in the request signature.  By
+  /// default, payloads are only signed over plain HTTP.
+  std::optional<bool> sign_payload;
+
+  /// Ranges with multiple top-level prefixes are listed as this many
+  /// concurrent prefix listings.
+  std::optional<int64_t> list_concurrency;
+
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
     return f(x.bucket, x.requester_pays, x.endpoint, x.host_header,
              x.aws_region, x.aws_credentials, x.request_concurrency,
-             x.rate_limiter, x.retries, x.data_copy_concurrency);
+             x.rate_limiter, x.retries, x.data_copy_concurrency,
+             x.parallel_read_part_size, x.parallel_upload_part_size,
+             x.hedge_read_percentile, x.hedge_read_budget, x.sign_payload,
+             x.list_concurrency);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -323,7 +389,28 @@ struct S3KeyValueStoreSpecData {
                  jb::Projection<&S3KeyValueStoreSpecData::retries>()),
       jb::Member(DataCopyConcurrencyResource::id,
                  jb::Projection<
-                     &S3KeyValueStoreSpecData::data_copy_concurrency>()) /**/
+                     &S3KeyValueStoreSpecData::data_copy_concurrency>()),
+      jb::Member("parallel_read_part_size",
+                 jb::Projection<
+                     &S3KeyValueStoreSpecData::parallel_read_part_size>(
+                     jb::Optional(jb::Integer<int64_t>(1)))),
+      jb::Member("parallel_upload_part_size",
+                 jb::Projection<
+                     &S3KeyValueStoreSpecData::parallel_upload_part_size>(
+                     jb::Optional(jb::Integer<int64_t>(kMinUploadPartSize)))),
+      jb::Member(
+          "hedge_read_percentile",
+          jb::Projection<&S3KeyValueStoreSpecData::hedge_read_percentile>(
+              jb::Optional(internal_kvstore::HedgeReadPercentileBinder()))),
+      jb::Member(
+          "hedge_read_budget",
+          jb::Projection<&S3KeyValueStoreSpecData::hedge_read_budget>(
+              jb::Optional(internal_kvstore::HedgeReadBudgetBinder()))),
+      jb::Member("sign_payload",
+                 jb::Projection<&S3KeyValueStoreSpecData::sign_payload>()),
+      jb::Member("list_concurrency",
+                 jb::Projection<&S3KeyValueStoreSpecData::list_concurrency>(
+                     jb::Optional(jb::Integer<int64_t>(1)))) /**/
   );
 };
 
@@ -352,7 +439,13 @@ class S3KeyValueStore
                   S3KeyValueStoreSpecData spec)
       : transport_(std::move(transport)),
         spec_(std::move(spec)),
-        host_header_(spec_.host_header.value_or(std::string())) {}
+        host_header_(spec_.host_header.value_or(std::string())),
+        directory_bucket_(IsDirectoryBucket(spec_.bucket)) {
+    if (directory_bucket_) {
+      s3express_session_ =
+          std::make_shared<S3ExpressSessionCache>(host_header_, transport_);
+    }
+  }
 
   internal_kvstore_batch::CoalescingOptions GetBatchReadCoalescingOptions()
       const {
@@ -366,14 +459,44 @@ class S3KeyValueStore
 
   Future<ReadResult> ReadImpl(Key&& key, ReadOptions&& options);
 
+  /// Issues a single read request for `key`.
+  Future<ReadResult> IssueRead(const Key& key, ReadOptions options);
+
+  /// Reads part of a value for `internal_http::ReadInParts`.
+  Future<internal_http::ReadPartResult> ReadPart(const Key& key,
+                                                 ReadOptions options);
+
+  /// Issues a HEAD request, which returns the size of the object.
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
                                              WriteOptions options) override;
 
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
+  /// Objects are listed in key order, such that values may be read while the
+  /// listing is in progress.
+  void ScanImpl(ScanOptions options, ScanReceiver receiver) override {
+    internal_kvstore::ReadAheadScan(kvstore::DriverPtr(this),
+                                    std::move(options), std::move(receiver),
+                                    /*ordered_list=*/true);
+  }
+
+  /// Lists `options.range`.  If `discover_prefixes` is `true`, first lists
+  /// the top-level prefixes of the range, which are then listed concurrently.
+  void StartList(ListOptions options, ListReceiver receiver,
+                 bool discover_prefixes);
+
   Future<const void> DeleteRange(KeyRange range) override;
 
+  /// Copies objects from another bucket (or this one) on the same endpoint
+  /// using server-side copies, so that the data is never transferred through
+  /// the client.
+  Future<const void> ExperimentalCopyRangeFrom(
+      const internal::OpenTransactionPtr& transaction, const KvStore& source,
+      Key target_prefix, kvstore::CopyRangeOptions options) override;
+
   absl::Status GetBoundSpecData(SpecData& spec) const {
     spec = spec_;
     return absl::OkStatus();
@@ -396,10 +519,39 @@ class S3KeyValueStore
     return no_rate_limiter_;
   }
 
-  RateLimiter& admission_queue() { return *spec_.request_concurrency->queue; }
+  internal::AdmissionQueue& admission_queue() {
+    return *spec_.request_concurrency->queue;
+  }
+
+  /// Returns the credentials with which to sign requests to `ehr`.
+  ///
+  /// For directory buckets, these are the credentials of a cached session.
+  Result<std::optional<AwsCredentials>> GetCredentials(
+      const S3EndpointRegion& ehr) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto credentials,
+                                 spec_.aws_credentials->GetCredentials());
+    if (!s3express_session_ || !credentials || credentials->IsAnonymous()) {
+      return credentials;
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto session, s3express_session_->GetCredentials(*credentials, ehr));
+    return {std::in_place, std::move(session)};
+  }
 
-  Result<std::optional<AwsCredentials>> GetCredentials() {
-    return spec_.aws_credentials->GetCredentials();
+  /// Returns the `x-amz-content-sha256` value for a request to `ehr` with
+  /// `payload`.
+  ///
+  /// Over HTTPS, which already protects the integrity of the payload, the
+  /// payload is not hashed unless `sign_payload` is specified, since hashing
+  /// dominates the CPU cost of writing large values.
+  std::string PayloadHash(const S3EndpointRegion& ehr,
+                          const absl::Cord& payload) const {
+    if (!payload.empty() &&
+        !spec_.sign_payload.value_or(
+            !absl::StartsWithIgnoreCase(ehr.endpoint, "https://"))) {
+      return kUnsignedPayload;
+    }
+    return payload_sha256(payload);
   }
 
   // Resolves the region endpoint for the bucket.
@@ -414,6 +566,11 @@ class S3KeyValueStore
       absl::Status status, int attempt, Task* task,
       SourceLocation loc = ::tensorstore::SourceLocation::current()) {
     assert(task != nullptr);
+    if (absl::IsUnavailable(status) || absl::IsResourceExhausted(status)) {
+      // Includes HTTP 429 and 503 responses, which indicate that requests
+      // should be issued less aggressively.
+      admission_queue().ReportOverload();
+    }
     auto delay = spec_.retries->BackoffForAttempt(attempt);
     if (!delay) {
       return MaybeAnnotateStatus(std::move(status),
@@ -421,6 +578,10 @@ class S3KeyValueStore
                                                  spec_.retries->max_retries),
                                  absl::StatusCode::kAborted, loc);
     }
+    if (!spec_.retries->TryRetry()) {
+      return MaybeAnnotateStatus(std::move(status), "Retry budget exhausted",
+                                 absl::StatusCode::kAborted, loc);
+    }
     s3_retries.Increment();
     ScheduleAt(absl::Now() + *delay,
                WithExecutor(executor(), [task = IntrusivePtr<Task>(task)] {
@@ -435,6 +596,13 @@ class S3KeyValueStore
   S3KeyValueStoreSpecData spec_;
   std::string host_header_;
 
+  // Set if `spec_.bucket` is an S3 Express One Zone directory bucket.
+  bool directory_bucket_;
+  std::shared_ptr<S3ExpressSessionCache> s3express_session_;
+
+  // Set if `hedge_read_percentile` is specified.
+  std::unique_ptr<internal_kvstore::ReadHedger> read_hedger_;
+
   absl::Mutex mutex_;  // Guards resolve_ehr_ creation.
   Future<const S3EndpointRegion> resolve_ehr_;
 };
@@ -454,12 +622,21 @@ struct ReadTask : public RateLimiterNode,
   int attempt_ = 0;
   absl::Time start_time_;
 
+  // Set for reads issued by `S3KeyValueStore::ReadPart`, which permit the
+  // response to be truncated at the end of the object.
+  bool read_part_ = false;
+  ByteRange byte_range_;
+  int64_t total_size_ = -1;
+
   ReadTask(IntrusivePtr<S3KeyValueStore> owner, std::string object_name,
            kvstore::ReadOptions options, Promise<kvstore::ReadResult> promise)
       : owner(std::move(owner)),
         object_name(std::move(object_name)),
         options(std::move(options)),
-        promise(std::move(promise)) {}
+        promise(std::move(promise)) {
+    // Reads of unknown size are charged once the response is received.
+    bytes_ = std::max(int64_t{0}, this->options.byte_range.size());
+  }
 
   ~ReadTask() { owner->admission_queue().Finish(this); }
 
@@ -483,7 +660,8 @@ struct ReadTask : public RateLimiterNode,
     }
 
     AwsCredentials credentials;
-    if (auto maybe_credentials = owner->GetCredentials();
+    if (auto maybe_credentials =
+            owner->GetCredentials(endpoint_region_.value());
         !maybe_credentials.ok()) {
       promise.SetResult(maybe_credentials.status());
       return;
@@ -507,6 +685,7 @@ struct ReadTask : public RateLimiterNode,
     start_time_ = absl::Now();
     auto request = request_builder.EnableAcceptEncoding()
                        .MaybeAddRequesterPayer(owner->spec_.requester_pays)
+                       .MaybeUseS3ExpressAuth(owner->directory_bucket_)
                        .BuildRequest(owner->host_header_, credentials,
                                      ehr.aws_region, kEmptySha256, start_time_);
 
@@ -553,6 +732,7 @@ struct ReadTask : public RateLimiterNode,
 
   Result<kvstore::ReadResult> FinishResponse(const HttpResponse& httpresponse) {
     s3_bytes_read.IncrementBy(httpresponse.payload.size());
+    owner->read_rate_limiter().Reconcile(this, httpresponse.payload.size());
     auto latency = absl::Now() - start_time_;
     s3_read_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
 
@@ -575,13 +755,16 @@ struct ReadTask : public RateLimiterNode,
     }
 
     absl::Cord value;
-    if (options.byte_range.size() != 0) {
-      // Currently unused
-      ByteRange byte_range;
-      int64_t total_size;
-
+    if (read_part_) {
+      TENSORSTORE_RETURN_IF_ERROR(internal_http::GetResponseByteRange(
+          httpresponse, value, byte_range_, total_size_));
+    } else if (options.byte_range.size() != 0) {
       TENSORSTORE_RETURN_IF_ERROR(internal_http::ValidateResponseByteRange(
-          httpresponse, options.byte_range, value, byte_range, total_size));
+          httpresponse, options.byte_range, value, byte_range_, total_size_));
+    } else if (auto content_length =
+                   internal_http::TryGetContentLength(httpresponse.headers)) {
+      // HEAD responses report the size of the object.
+      total_size_ = ListEntry::checked_size(*content_length);
     }
 
     TENSORSTORE_ASSIGN_OR_RETURN(
@@ -607,14 +790,9 @@ Future<kvstore::ReadResult> S3KeyValueStore::Read(Key key,
       *this, std::move(key), std::move(options));
 }
 
-Future<kvstore::ReadResult> S3KeyValueStore::ReadImpl(Key&& key,
-                                                      ReadOptions&& options) {
-  s3_batch_read.Increment();
-  auto op = PromiseFuturePair<ReadResult>::Make();
-  auto state = internal::MakeIntrusivePtr<ReadTask>(
-      internal::IntrusivePtr<S3KeyValueStore>(this), key, std::move(options),
-      std::move(op.promise));
-  MaybeResolveRegion().ExecuteWhenReady(
+/// Issues `state` once the endpoint region has been resolved.
+void StartReadTask(IntrusivePtr<ReadTask> state) {
+  state->owner->MaybeResolveRegion().ExecuteWhenReady(
       [state = std::move(state)](ReadyFuture<const S3EndpointRegion> ready) {
         if (!ready.status().ok()) {
           state->promise.SetResult(ready.status());
@@ -626,9 +804,396 @@ Future<kvstore::ReadResult> S3KeyValueStore::ReadImpl(Key&& key,
         intrusive_ptr_increment(state.get());  // adopted by ReadTask::Start.
         state->owner->read_rate_limiter().Admit(state.get(), &ReadTask::Start);
       });
+}
+
+Future<kvstore::ReadResult> S3KeyValueStore::ReadImpl(Key&& key,
+                                                      ReadOptions&& options) {
+  s3_batch_read.Increment();
+  spec_.retries->RecordRequest();
+  if (spec_.parallel_read_part_size &&
+      internal_http::ShouldReadInParts(options.byte_range,
+                                       *spec_.parallel_read_part_size)) {
+    return internal_http::ReadInParts(
+        std::move(options), *spec_.parallel_read_part_size,
+        [self = internal::IntrusivePtr<S3KeyValueStore>(this),
+         key = std::move(key)](ReadOptions options) {
+          return self->ReadPart(key, std::move(options));
+        });
+  }
+  if (read_hedger_) {
+    return read_hedger_->Read(
+        [self = internal::IntrusivePtr<S3KeyValueStore>(this),
+         key = std::move(key), options = std::move(options)] {
+          return self->IssueRead(key, options);
+        });
+  }
+  return IssueRead(key, std::move(options));
+}
+
+Future<kvstore::ReadResult> S3KeyValueStore::IssueRead(const Key& key,
+                                                       ReadOptions options) {
+  auto op = PromiseFuturePair<ReadResult>::Make();
+  StartReadTask(internal::MakeIntrusivePtr<ReadTask>(
+      internal::IntrusivePtr<S3KeyValueStore>(this), key, std::move(options),
+      std::move(op.promise)));
   return std::move(op.future);
 }
 
+Future<internal_http::ReadPartResult> S3KeyValueStore::ReadPart(
+    const Key& key, ReadOptions options) {
+  auto op = PromiseFuturePair<ReadResult>::Make();
+  auto state = internal::MakeIntrusivePtr<ReadTask>(
+      internal::IntrusivePtr<S3KeyValueStore>(this), key, std::move(options),
+      std::move(op.promise));
+  state->read_part_ = true;
+  StartReadTask(state);
+  return MapFutureValue(
+      InlineExecutor{},
+      [state = std::move(state)](ReadResult& result) {
+        return internal_http::ReadPartResult{std::move(result),
+                                             state->byte_range_,
+                                             state->total_size_};
+      },
+      std::move(op.future));
+}
+
+Future<kvstore::StatResult> S3KeyValueStore::Stat(Key key,
+                                                  StatOptions options) {
+  s3_stat.Increment();
+  if (!IsValidObjectName(key)) {
+    return absl::InvalidArgumentError("Invalid S3 object name");
+  }
+  if (!IsValidStorageGeneration(options.generation_conditions.if_equal) ||
+      !IsValidStorageGeneration(options.generation_conditions.if_not_equal)) {
+    return absl::InvalidArgumentError("Malformed StorageGeneration");
+  }
+  spec_.retries->RecordRequest();
+  ReadOptions read_options;
+  read_options.generation_conditions = std::move(options.generation_conditions);
+  read_options.staleness_bound = options.staleness_bound;
+  read_options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+
+  auto op = PromiseFuturePair<ReadResult>::Make();
+  auto state = internal::MakeIntrusivePtr<ReadTask>(
+      internal::IntrusivePtr<S3KeyValueStore>(this), key,
+      std::move(read_options), std::move(op.promise));
+  StartReadTask(state);
+  return MapFutureValue(
+      InlineExecutor{},
+      [state = std::move(state)](const ReadResult& result) {
+        return kvstore::StatResult::FromReadResult(result, state->total_size_);
+      },
+      std::move(op.future));
+}
+
+/// A MultipartRequestTask issues a single request of a multipart upload or a
+/// DeleteObjects request, retrying transient failures.
+///
+/// https://docs.aws.amazon.com/AmazonS3/latest/userguide/mpuoverview.html
+struct MultipartRequestTask
+    : public RateLimiterNode,
+      public internal::AtomicReferenceCount<MultipartRequestTask> {
+  IntrusivePtr<S3KeyValueStore> owner;
+  std::string method;
+  std::string url;
+  std::vector<std::pair<std::string, std::string>> query_params;
+  absl::Cord payload;
+  std::vector<std::string> headers;
+  ReadyFuture<const S3EndpointRegion> endpoint_region;
+  Promise<HttpResponse> promise;
+
+  int attempt_ = 0;
+
+  MultipartRequestTask(
+      IntrusivePtr<S3KeyValueStore> owner, std::string method, std::string url,
+      std::vector<std::pair<std::string, std::string>> query_params,
+      absl::Cord payload, std::vector<std::string> headers,
+      ReadyFuture<const S3EndpointRegion> endpoint_region,
+      Promise<HttpResponse> promise)
+      : owner(std::move(owner)),
+        method(std::move(method)),
+        url(std::move(url)),
+        query_params(std::move(query_params)),
+        payload(std::move(payload)),
+        headers(std::move(headers)),
+        endpoint_region(std::move(endpoint_region)),
+        promise(std::move(promise)) {}
+
+  ~MultipartRequestTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<MultipartRequestTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->admission_queue().Admit(self, &MultipartRequestTask::Admit);
+  }
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<MultipartRequestTask*>(task);
+    self->owner->executor()([state = IntrusivePtr<MultipartRequestTask>(
+                                 self, internal::adopt_object_ref)] {
+      state->Retry();
+    });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    AwsCredentials credentials;
+    if (auto maybe_credentials =
+            owner->GetCredentials(endpoint_region.value());
+        !maybe_credentials.ok()) {
+      promise.SetResult(maybe_credentials.status());
+      return;
+    } else if (maybe_credentials.value().has_value()) {
+      credentials = std::move(*maybe_credentials.value());
+    }
+
+    auto builder = S3RequestBuilder(method, url);
+    for (const auto& [key, value] : query_params) {
+      builder.AddQueryParameter(key, value);
+    }
+    if (method != "DELETE") {
+      builder.AddHeader(absl::StrCat("Content-Length: ", payload.size()));
+    }
+    for (const auto& header : headers) {
+      builder.AddHeader(header);
+    }
+    const auto& ehr = endpoint_region.value();
+    auto request =
+        builder.MaybeAddRequesterPayer(owner->spec_.requester_pays)
+            .MaybeUseS3ExpressAuth(owner->directory_bucket_)
+            .BuildRequest(owner->host_header_, credentials, ehr.aws_region,
+                          owner->PayloadHash(ehr, payload), absl::Now());
+
+    ABSL_LOG_IF(INFO, s3_logging)
+        << "MultipartRequestTask: " << request << " size=" << payload.size();
+
+    auto future = owner->transport_->IssueRequest(
+        request, internal_http::IssueRequestOptions(payload));
+    future.ExecuteWhenReady([self = IntrusivePtr<MultipartRequestTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, s3_logging.Level(1) && response.ok())
+        << "MultipartRequestTask " << *response;
+
+    absl::Status status = !response.ok()
+                              ? response.status()
+                              : HttpResponseCodeToStatus(response.value());
+    if (!status.ok() && IsRetriable(status)) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(status);
+      return;
+    }
+    promise.SetResult(response.value());
+  }
+};
+
+Future<HttpResponse> IssueMultipartRequest(
+    IntrusivePtr<S3KeyValueStore> owner,
+    ReadyFuture<const S3EndpointRegion> endpoint_region, std::string method,
+    std::string url,
+    std::vector<std::pair<std::string, std::string>> query_params,
+    absl::Cord payload = absl::Cord(), std::vector<std::string> headers = {}) {
+  auto op = PromiseFuturePair<HttpResponse>::Make();
+  auto* task = new MultipartRequestTask(
+      owner, std::move(method), std::move(url), std::move(query_params),
+      std::move(payload), std::move(headers), std::move(endpoint_region),
+      std::move(op.promise));
+  task->bytes_ = task->payload.size();
+  intrusive_ptr_increment(task);  // adopted by MultipartRequestTask::Start.
+  owner->write_rate_limiter().Admit(task, &MultipartRequestTask::Start);
+  return std::move(op.future);
+}
+
+/// Returns an error if `xml_document` is an S3 <Error> response, which may be
+/// returned with a 200 status code when completing a multipart upload.
+absl::Status GetMultipartErrorStatus(tinyxml2::XMLDocument& xml_document) {
+  auto* error = xml_document.FirstChildElement("Error");
+  if (error == nullptr) return absl::OkStatus();
+  return absl::UnavailableError(absl::StrCat(
+      "Multipart upload failed: ", GetNodeText(error->FirstChildElement("Code")),
+      ": ", GetNodeText(error->FirstChildElement("Message"))));
+}
+
+/// Returns the upload id from a CreateMultipartUpload response.
+Result<std::string> GetUploadId(const HttpResponse& response) {
+  auto cord = response.payload;
+  auto payload = cord.Flatten();
+  tinyxml2::XMLDocument xml_document;
+  if (int xmlcode = xml_document.Parse(payload.data(), payload.size());
+      xmlcode != tinyxml2::XML_SUCCESS) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Malformed CreateMultipartUpload response: ", xmlcode));
+  }
+  auto* root = xml_document.FirstChildElement("InitiateMultipartUploadResult");
+  if (root == nullptr) {
+    return absl::InvalidArgumentError(
+        "Malformed CreateMultipartUpload response: missing "
+        "<InitiateMultipartUploadResult>");
+  }
+  std::string upload_id = GetNodeText(root->FirstChildElement("UploadId"));
+  if (upload_id.empty()) {
+    return absl::InvalidArgumentError(
+        "Malformed CreateMultipartUpload response: missing <UploadId>");
+  }
+  return upload_id;
+}
+
+/// Aborts the multipart upload `upload_id`, if any, so that its parts do not
+/// continue to incur storage costs.
+void AbortMultipartUpload(IntrusivePtr<S3KeyValueStore> owner,
+                          ReadyFuture<const S3EndpointRegion> endpoint_region,
+                          std::string upload_url,
+                          const std::string& upload_id) {
+  if (upload_id.empty()) return;
+  // The callback keeps the request alive after the caller is destroyed.
+  IssueMultipartRequest(std::move(owner), std::move(endpoint_region), "DELETE",
+                        std::move(upload_url), {{"uploadId", upload_id}})
+      .ExecuteWhenReady([](ReadyFuture<HttpResponse> response) {
+        ABSL_LOG_IF(INFO, s3_logging && !response.status().ok())
+            << "AbortMultipartUpload failed: " << response.status();
+      });
+}
+
+/// A MultipartUploadTask uploads a value using an S3 multipart upload.
+///
+/// The parts are uploaded concurrently, each as a separate request subject to
+/// the rate limiter and admission queue.  If any part fails, the upload is
+/// aborted so that the parts do not continue to incur storage costs.
+struct MultipartUploadTask
+    : public internal::AtomicReferenceCount<MultipartUploadTask> {
+  IntrusivePtr<S3KeyValueStore> owner;
+  std::string upload_url;
+  ReadyFuture<const S3EndpointRegion> endpoint_region;
+  absl::Cord value;
+  int64_t part_size;
+  Promise<TimestampedStorageGeneration> promise;
+
+  std::string upload_id_;
+  absl::Time start_time_;
+
+  void Start() {
+    start_time_ = absl::Now();
+    auto future = IssueMultipartRequest(owner, endpoint_region, "POST",
+                                        upload_url, {{"uploads", ""}});
+    future.ExecuteWhenReady([self = IntrusivePtr<MultipartUploadTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnInitiateResponse(response.result());
+    });
+  }
+
+  void OnInitiateResponse(const Result<HttpResponse>& response) {
+    if (!response.ok()) {
+      promise.SetResult(response.status());
+      return;
+    }
+    auto upload_id = GetUploadId(*response);
+    if (!upload_id.ok()) {
+      promise.SetResult(upload_id.status());
+      return;
+    }
+    upload_id_ = *std::move(upload_id);
+    if (!promise.result_needed()) {
+      Abort();
+      return;
+    }
+
+    const int64_t size = value.size();
+    std::vector<Future<HttpResponse>> futures;
+    for (int64_t offset = 0, part_number = 1; offset < size;
+         offset += part_size, ++part_number) {
+      futures.push_back(IssueMultipartRequest(
+          owner, endpoint_region, "PUT", upload_url,
+          {{"partNumber", absl::StrCat(part_number)}, {"uploadId", upload_id_}},
+          value.Subcord(offset, std::min(part_size, size - offset))));
+    }
+    auto all_ready = WaitAllFuture(tensorstore::span(futures));
+    all_ready.ExecuteWhenReady(
+        [self = IntrusivePtr<MultipartUploadTask>(this),
+         futures = std::move(futures)](ReadyFuture<void> all_ready) {
+          self->OnPartsUploaded(all_ready.status(), futures);
+        });
+  }
+
+  void OnPartsUploaded(const absl::Status& status,
+                       const std::vector<Future<HttpResponse>>& futures) {
+    if (!status.ok() || !promise.result_needed()) {
+      Abort();
+      promise.SetResult(status);
+      return;
+    }
+    std::string body = "<CompleteMultipartUpload>";
+    for (size_t i = 0; i < futures.size(); ++i) {
+      const auto& headers = futures[i].value().headers;
+      auto it = headers.find("etag");
+      if (it == headers.end()) {
+        Abort();
+        promise.SetResult(
+            absl::InvalidArgumentError("etag not found in UploadPart response"));
+        return;
+      }
+      absl::StrAppend(&body, "<Part><PartNumber>", i + 1,
+                      "</PartNumber><ETag>", it->second, "</ETag></Part>");
+    }
+    absl::StrAppend(&body, "</CompleteMultipartUpload>");
+    auto future = IssueMultipartRequest(owner, endpoint_region, "POST",
+                                        upload_url, {{"uploadId", upload_id_}},
+                                        absl::Cord(std::move(body)));
+    future.ExecuteWhenReady([self = IntrusivePtr<MultipartUploadTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnCompleteResponse(response.result());
+    });
+  }
+
+  void OnCompleteResponse(const Result<HttpResponse>& response) {
+    auto result = [&]() -> Result<TimestampedStorageGeneration> {
+      TENSORSTORE_RETURN_IF_ERROR(response);
+      auto cord = response->payload;
+      auto payload = cord.Flatten();
+      tinyxml2::XMLDocument xml_document;
+      if (int xmlcode = xml_document.Parse(payload.data(), payload.size());
+          xmlcode != tinyxml2::XML_SUCCESS) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Malformed CompleteMultipartUpload response: ", xmlcode));
+      }
+      TENSORSTORE_RETURN_IF_ERROR(GetMultipartErrorStatus(xml_document));
+      auto* root =
+          xml_document.FirstChildElement("CompleteMultipartUploadResult");
+      std::string etag =
+          root ? GetNodeText(root->FirstChildElement("ETag")) : "";
+      if (etag.empty()) {
+        return absl::InvalidArgumentError(
+            "Malformed CompleteMultipartUpload response: missing <ETag>");
+      }
+      auto latency = absl::Now() - start_time_;
+      s3_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+      s3_bytes_written.IncrementBy(value.size());
+      return TimestampedStorageGeneration{StorageGeneration::FromString(etag),
+                                          start_time_};
+    }();
+    if (!result.ok()) Abort();
+    promise.SetResult(std::move(result));
+  }
+
+  /// Aborts the upload, discarding any uploaded parts.
+  void Abort() {
+    AbortMultipartUpload(owner, endpoint_region, upload_url, upload_id_);
+  }
+};
+
 /// A WriteTask is a function object used to satisfy a
 /// S3KeyValueStore::Write request.
 struct WriteTask : public RateLimiterNode,
@@ -653,10 +1218,18 @@ struct WriteTask : public RateLimiterNode,
         object_name(std::move(object_name)),
         value(std::move(value)),
         options(std::move(options)),
-        promise(std::move(promise)) {}
+        promise(std::move(promise)) {
+    // A multipart upload charges each of its parts instead.
+    if (!UseMultipartUpload()) bytes_ = this->value.size();
+  }
 
   ~WriteTask() { owner->admission_queue().Finish(this); }
 
+  bool UseMultipartUpload() const {
+    return owner->spec_.parallel_upload_part_size &&
+           value.size() > *owner->spec_.parallel_upload_part_size;
+  }
+
   static void Start(void* task) {
     auto* self = reinterpret_cast<WriteTask*>(task);
     self->owner->write_rate_limiter().Finish(self);
@@ -676,7 +1249,8 @@ struct WriteTask : public RateLimiterNode,
       return;
     }
 
-    if (auto maybe_credentials = owner->GetCredentials();
+    if (auto maybe_credentials =
+            owner->GetCredentials(endpoint_region_.value());
         !maybe_credentials.ok()) {
       promise.SetResult(maybe_credentials.status());
       return;
@@ -698,6 +1272,7 @@ struct WriteTask : public RateLimiterNode,
     auto now = absl::Now();
     const auto& ehr = endpoint_region_.value();
     auto request = builder.MaybeAddRequesterPayer(owner->spec_.requester_pays)
+                       .MaybeUseS3ExpressAuth(owner->directory_bucket_)
                        .BuildRequest(owner->host_header_, credentials_,
                                      ehr.aws_region, kEmptySha256, now);
 
@@ -745,19 +1320,36 @@ struct WriteTask : public RateLimiterNode,
   }
 
   void DoPut() {
+    if (UseMultipartUpload()) {
+      // The multipart upload issues its own requests, and this task releases
+      // its admission queue slot once it is destroyed.
+      auto task = internal::MakeIntrusivePtr<MultipartUploadTask>();
+      task->owner = owner;
+      task->upload_url = upload_url_;
+      task->endpoint_region = endpoint_region_;
+      task->part_size = std::max(
+          *owner->spec_.parallel_upload_part_size,
+          CeilOfRatio(static_cast<int64_t>(value.size()), kMaxUploadParts));
+      task->value = std::move(value);
+      task->promise = std::move(promise);
+      task->Start();
+      return;
+    }
+
     // NOTE: This was changed from POST to PUT as a basic POST does not work
     // Some more headers need to be added to allow POST to work:
     // https://docs.aws.amazon.com/AmazonS3/latest/API/sigv4-authentication-HTTPPOST.html
 
     start_time_ = absl::Now();
-    auto content_sha256 = payload_sha256(value);
-
     const auto& ehr = endpoint_region_.value();
+    auto content_sha256 = owner->PayloadHash(ehr, value);
+
     auto request =
         S3RequestBuilder("PUT", upload_url_)
             .AddHeader("Content-Type: application/octet-stream")
             .AddHeader(absl::StrCat("Content-Length: ", value.size()))
             .MaybeAddRequesterPayer(owner->spec_.requester_pays)
+            .MaybeUseS3ExpressAuth(owner->directory_bucket_)
             .BuildRequest(owner->host_header_, credentials_, ehr.aws_region,
                           content_sha256, start_time_);
 
@@ -871,7 +1463,8 @@ struct DeleteTask : public RateLimiterNode,
       return;
     }
 
-    if (auto maybe_credentials = owner->GetCredentials();
+    if (auto maybe_credentials =
+            owner->GetCredentials(endpoint_region_.value());
         !maybe_credentials.ok()) {
       promise.SetResult(maybe_credentials.status());
       return;
@@ -893,6 +1486,7 @@ struct DeleteTask : public RateLimiterNode,
     auto now = absl::Now();
     const auto& ehr = endpoint_region_.value();
     auto request = builder.MaybeAddRequesterPayer(owner->spec_.requester_pays)
+                       .MaybeUseS3ExpressAuth(owner->directory_bucket_)
                        .BuildRequest(owner->host_header_, credentials_,
                                      ehr.aws_region, kEmptySha256, now);
 
@@ -942,6 +1536,7 @@ struct DeleteTask : public RateLimiterNode,
     const auto& ehr = endpoint_region_.value();
     auto request = S3RequestBuilder("DELETE", delete_url_)
                        .MaybeAddRequesterPayer(owner->spec_.requester_pays)
+                       .MaybeUseS3ExpressAuth(owner->directory_bucket_)
                        .BuildRequest(owner->host_header_, credentials_,
                                      ehr.aws_region, kEmptySha256, start_time_);
 
@@ -1008,6 +1603,7 @@ struct DeleteTask : public RateLimiterNode,
 Future<TimestampedStorageGeneration> S3KeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   s3_write.Increment();
+  spec_.retries->RecordRequest();
   if (!IsValidObjectName(key)) {
     return absl::InvalidArgumentError("Invalid S3 object name");
   }
@@ -1059,11 +1655,21 @@ Future<TimestampedStorageGeneration> S3KeyValueStore::Write(
 }
 
 /// ListTask implements the ListImpl execution flow.
+///
+/// The request for the next page is issued as soon as a page is received, so
+/// that it overlaps with delivering the entries of the current page.
+///
+/// If `discover_prefixes` is `true`, the task instead issues a single
+/// delimited request for the top-level prefixes of the range, and lists them
+/// concurrently using `ListSegments`.  Any failure of that request falls back
+/// to a sequential listing, so `receiver` is only signaled by the listings
+/// which are started afterwards.
 struct ListTask : public RateLimiterNode,
                   public internal::AtomicReferenceCount<ListTask> {
   internal::IntrusivePtr<S3KeyValueStore> owner_;
   ListOptions options_;
   ListReceiver receiver_;
+  bool discover_prefixes_;
 
   std::string resource_;
   ReadyFuture<const S3EndpointRegion> endpoint_region_;
@@ -1073,19 +1679,27 @@ struct ListTask : public RateLimiterNode,
   int attempt_ = 0;
   bool has_query_parameters_;
   std::atomic<bool> cancelled_{false};
+  FlowDemand::Ptr demand_ = FlowDemand::Make();
 
   ListTask(internal::IntrusivePtr<S3KeyValueStore>&& owner,
-           ListOptions&& options, ListReceiver&& receiver)
+           ListOptions&& options, ListReceiver&& receiver,
+           bool discover_prefixes)
       : owner_(std::move(owner)),
         options_(std::move(options)),
-        receiver_(std::move(receiver)) {
+        receiver_(std::move(receiver)),
+        discover_prefixes_(discover_prefixes) {
+    if (discover_prefixes_) return;
     execution::set_starting(receiver_, [this] {
       cancelled_.store(true, std::memory_order_relaxed);
+      demand_->RequestUnbounded();
     });
+    execution::set_demand(receiver_, demand_);
   }
 
   ~ListTask() {
-    execution::set_stopping(receiver_);
+    if (!discover_prefixes_) {
+      execution::set_stopping(receiver_);
+    }
     owner_->admission_queue().Finish(this);
   }
 
@@ -1108,17 +1722,46 @@ struct ListTask : public RateLimiterNode,
 
   void Retry() { IssueRequest(); }
 
+  void Fail(absl::Status status) {
+    if (discover_prefixes_) {
+      ABSL_LOG_IF(INFO, s3_logging)
+          << "List prefix discovery failed: " << status;
+      owner_->StartList(std::move(options_), std::move(receiver_),
+                        /*discover_prefixes=*/false);
+      return;
+    }
+    execution::set_error(receiver_, std::move(status));
+  }
+
   void IssueRequest() {
     if (is_cancelled()) {
       execution::set_done(receiver_);
       return;
     }
+    auto future = StartRequest();
+    if (!future.ok()) {
+      Fail(std::move(future).status());
+      return;
+    }
+    HandleResponse(*std::move(future));
+  }
 
+  // Issues the request for the page identified by `continuation_token_`.
+  Result<Future<HttpResponse>> StartRequest() {
     // https://docs.aws.amazon.com/AmazonS3/latest/API/API_ListObjectsV2.html
     auto request_builder =
         S3RequestBuilder("GET", resource_).AddQueryParameter("list-type", "2");
     if (auto prefix = LongestPrefix(options_.range); !prefix.empty()) {
-      request_builder.AddQueryParameter("prefix", std::string(prefix));
+      if (owner_->directory_bucket_ || discover_prefixes_) {
+        // Directory buckets only support prefixes that end in a delimiter.
+        prefix = prefix.substr(0, prefix.rfind('/') + 1);
+      }
+      if (!prefix.empty()) {
+        request_builder.AddQueryParameter("prefix", std::string(prefix));
+      }
+    }
+    if (discover_prefixes_) {
+      request_builder.AddQueryParameter("delimiter", "/");
     }
     // NOTE: Consider adding a start-after query parameter, however that
     // would require a predecessor to inclusive_min key.
@@ -1128,24 +1771,27 @@ struct ListTask : public RateLimiterNode,
     }
 
     AwsCredentials credentials;
-    if (auto maybe_credentials = owner_->GetCredentials();
-        !maybe_credentials.ok()) {
-      execution::set_error(receiver_, std::move(maybe_credentials).status());
-      return;
-    } else if (maybe_credentials.value().has_value()) {
-      credentials = std::move(*maybe_credentials.value());
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto maybe_credentials,
+        owner_->GetCredentials(endpoint_region_.value()));
+    if (maybe_credentials.has_value()) {
+      credentials = std::move(*maybe_credentials);
     }
 
     const auto& ehr = endpoint_region_.value();
     start_time_ = absl::Now();
 
     auto request =
-        request_builder.BuildRequest(owner_->host_header_, credentials,
-                                     ehr.aws_region, kEmptySha256, start_time_);
+        request_builder.MaybeUseS3ExpressAuth(owner_->directory_bucket_)
+            .BuildRequest(owner_->host_header_, credentials, ehr.aws_region,
+                          kEmptySha256, start_time_);
 
     ABSL_LOG_IF(INFO, s3_logging) << "List: " << request;
 
-    auto future = owner_->transport_->IssueRequest(request, {});
+    return owner_->transport_->IssueRequest(request, {});
+  }
+
+  void HandleResponse(Future<HttpResponse> future) {
     future.ExecuteWhenReady(WithExecutor(
         owner_->executor(), [self = IntrusivePtr<ListTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
@@ -1153,6 +1799,20 @@ struct ListTask : public RateLimiterNode,
         }));
   }
 
+  // Handles the prefetched response for the next page once the receiver has
+  // requested more entries.
+  void HandleResponseWhenDemanded(Future<HttpResponse> future) {
+    demand_->WhenAvailable().ExecuteWhenReady(
+        [self = IntrusivePtr<ListTask>(this),
+         future = std::move(future)](ReadyFuture<const void>) {
+          if (self->is_cancelled()) {
+            execution::set_done(self->receiver_);
+            return;
+          }
+          self->HandleResponse(std::move(future));
+        });
+  }
+
   void OnResponse(const Result<HttpResponse>& response) {
     auto status = OnResponseImpl(response);
     // OkStatus are handled by OnResponseImpl
@@ -1161,7 +1821,7 @@ struct ListTask : public RateLimiterNode,
       return;
     }
     if (!status.ok()) {
-      execution::set_error(receiver_, std::move(status));
+      Fail(std::move(status));
       return;
     }
   }
@@ -1179,6 +1839,7 @@ struct ListTask : public RateLimiterNode,
       return owner_->BackoffForAttemptAsync(std::move(status), attempt_++,
                                             this);
     }
+    TENSORSTORE_RETURN_IF_ERROR(status);
 
     auto cord = response->payload;
     auto payload = cord.Flatten();
@@ -1195,6 +1856,39 @@ struct ListTask : public RateLimiterNode,
           "Malformed List response: missing <ListBucketResult>");
     }
 
+    // Successful request, so clear the retry_attempt for the next request.
+    // Visit /ListBucketResult/IsTruncated
+    // Visit /ListBucketResult/NextContinuationToken
+    attempt_ = 0;
+    const bool truncated =
+        GetNodeText(root->FirstChildElement("IsTruncated")) == "true";
+    if (truncated) {
+      auto* next_continuation_token =
+          root->FirstChildElement("NextContinuationToken");
+      if (next_continuation_token == nullptr) {
+        return absl::InvalidArgumentError(
+            "Malformed List response: missing <NextContinuationToken>");
+      }
+      continuation_token_ = GetNodeText(next_continuation_token);
+    }
+
+    if (discover_prefixes_) {
+      return ListDiscoveredPrefixes(root, truncated);
+    }
+
+    // Prefetch the next page while the entries of this page are delivered,
+    // unless the last key of this page already exceeds the range.
+    std::optional<Result<Future<HttpResponse>>> next_page;
+    if (truncated) {
+      auto* last = root->LastChildElement("Contents");
+      if (owner_->directory_bucket_ || last == nullptr ||
+          KeyRange::CompareKeyAndExclusiveMax(
+              GetNodeText(last->FirstChildElement("Key")),
+              options_.range.exclusive_max) < 0) {
+        next_page = StartRequest();
+      }
+    }
+
     // TODO: Visit /ListBucketResult/KeyCount?
     // Visit /ListBucketResult/Contents
     for (auto* contents = root->FirstChildElement("Contents");
@@ -1214,6 +1908,8 @@ struct ListTask : public RateLimiterNode,
       if (key < options_.range.inclusive_min) continue;
       if (KeyRange::CompareKeyAndExclusiveMax(
               key, options_.range.exclusive_max) >= 0) {
+        // Directory buckets do not return objects in sorted order.
+        if (owner_->directory_bucket_) continue;
         // Objects are returned sorted in ascending order of the respective
         // key names, so after the current key exceeds exclusive max no
         // additional requests need to be made.
@@ -1231,46 +1927,100 @@ struct ListTask : public RateLimiterNode,
         execution::set_value(
             receiver_,
             ListEntry{key.substr(options_.strip_prefix_length), size});
+        demand_->Consume();
       }
     }
 
-    // Successful request, so clear the retry_attempt for the next request.
-    // Visit /ListBucketResult/IsTruncated
-    // Visit /ListBucketResult/NextContinuationToken
-    attempt_ = 0;
-    if (GetNodeText(root->FirstChildElement("IsTruncated")) == "true") {
-      auto* next_continuation_token =
-          root->FirstChildElement("NextContinuationToken");
-      if (next_continuation_token == nullptr) {
+    if (!next_page) {
+      execution::set_done(receiver_);
+      return absl::OkStatus();
+    }
+    TENSORSTORE_RETURN_IF_ERROR(next_page->status());
+    HandleResponseWhenDemanded(**std::move(next_page));
+    return absl::OkStatus();
+  }
+
+  absl::Status ListDiscoveredPrefixes(tinyxml2::XMLElement* root,
+                                      bool truncated) {
+    // Visit /ListBucketResult/CommonPrefixes/Prefix
+    std::vector<std::string> prefixes;
+    for (auto* common_prefixes = root->FirstChildElement("CommonPrefixes");
+         common_prefixes != nullptr;
+         common_prefixes =
+             common_prefixes->NextSiblingElement("CommonPrefixes")) {
+      auto* prefix_node = common_prefixes->FirstChildElement("Prefix");
+      if (prefix_node == nullptr) {
         return absl::InvalidArgumentError(
-            "Malformed List response: missing <NextContinuationToken>");
+            "Malformed List response: missing <Prefix> in <CommonPrefixes>");
       }
-      continuation_token_ = GetNodeText(next_continuation_token);
-      IssueRequest();
-    } else {
-      execution::set_done(receiver_);
+      prefixes.push_back(GetNodeText(prefix_node));
     }
+    std::vector<ListEntry> entries;
+    for (auto* contents = root->FirstChildElement("Contents");
+         contents != nullptr;
+         contents = contents->NextSiblingElement("Contents")) {
+      auto* key_node = contents->FirstChildElement("Key");
+      if (key_node == nullptr) {
+        return absl::InvalidArgumentError(
+            "Malformed List response: missing <Key> in <Contents>");
+      }
+      int64_t size = -1;
+      if (!absl::SimpleAtoi(GetNodeText(contents->FirstChildElement("Size")),
+                            &size)) {
+        size = -1;
+      }
+      entries.push_back(ListEntry{GetNodeText(key_node), size});
+    }
+    auto segments = internal_kvstore::GetDelimitedListSegments(
+        options_.range, std::move(prefixes), std::move(entries), truncated);
+    size_t num_ranges = 0;
+    for (const auto& segment : segments) {
+      if (!segment.entry) ++num_ranges;
+    }
+    if (num_ranges == 1) {
+      // A single prefix is no faster to list separately.
+      owner_->StartList(std::move(options_), std::move(receiver_),
+                        /*discover_prefixes=*/false);
+      return absl::OkStatus();
+    }
+    internal_kvstore::ListSegments(
+        std::move(segments), std::move(options_),
+        static_cast<size_t>(owner_->spec_.list_concurrency.value_or(1)),
+        [owner = owner_](ListOptions options, ListReceiver receiver) {
+          owner->StartList(std::move(options), std::move(receiver),
+                           /*discover_prefixes=*/false);
+        },
+        std::move(receiver_));
     return absl::OkStatus();
   }
 };
 
 void S3KeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
   s3_list.Increment();
+  spec_.retries->RecordRequest();
   if (options.range.empty()) {
     execution::set_starting(receiver, [] {});
     execution::set_done(receiver);
     execution::set_stopping(receiver);
     return;
   }
+  // Directory buckets do not return keys in sorted order, which is required
+  // to resume a truncated listing of prefixes.
+  StartList(std::move(options), std::move(receiver),
+            /*discover_prefixes=*/!directory_bucket_ &&
+                spec_.list_concurrency.value_or(1) > 1);
+}
 
+void S3KeyValueStore::StartList(ListOptions options, ListReceiver receiver,
+                                bool discover_prefixes) {
   auto state = internal::MakeIntrusivePtr<ListTask>(
       IntrusivePtr<S3KeyValueStore>(this), std::move(options),
-      std::move(receiver));
+      std::move(receiver), discover_prefixes);
 
   MaybeResolveRegion().ExecuteWhenReady(
       [state = std::move(state)](ReadyFuture<const S3EndpointRegion> ready) {
         if (!ready.status().ok()) {
-          execution::set_error(state->receiver_, ready.status());
+          state->Fail(ready.status());
           return;
         }
         state->resource_ = tensorstore::StrCat(ready.value().endpoint, "/");
@@ -1280,11 +2030,103 @@ void S3KeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
       });
 }
 
+/// Returns the base64-encoded MD5 digest of `data`, as required by the
+/// "Content-MD5" header of a DeleteObjects request.
+std::string ContentMd5(std::string_view data) {
+  unsigned char digest[MD5_DIGEST_LENGTH];
+  MD5(reinterpret_cast<const uint8_t*>(data.data()), data.size(), digest);
+  return absl::Base64Escape(
+      std::string_view(reinterpret_cast<const char*>(digest), sizeof(digest)));
+}
+
+/// A DeleteObjectsTask unconditionally removes up to `kMaxDeleteObjectsKeys`
+/// objects with a single DeleteObjects request.  Keys which fail with a
+/// transient error are retried in a subsequent request.
+///
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_DeleteObjects.html
+struct DeleteObjectsTask
+    : public internal::AtomicReferenceCount<DeleteObjectsTask> {
+  IntrusivePtr<S3KeyValueStore> owner;
+  std::vector<std::string> keys;
+  Promise<void> promise;
+
+  std::string resource_;
+  ReadyFuture<const S3EndpointRegion> endpoint_region_;
+  int attempt_ = 0;
+
+  DeleteObjectsTask(IntrusivePtr<S3KeyValueStore> owner,
+                    std::vector<std::string> keys, Promise<void> promise)
+      : owner(std::move(owner)),
+        keys(std::move(keys)),
+        promise(std::move(promise)) {}
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    std::string body = BuildDeleteObjectsRequest(keys);
+    std::string content_md5 =
+        tensorstore::StrCat("Content-MD5: ", ContentMd5(body));
+    auto future = IssueMultipartRequest(
+        owner, endpoint_region_, "POST", resource_, {{"delete", ""}},
+        absl::Cord(std::move(body)), {std::move(content_md5)});
+    future.ExecuteWhenReady([self = IntrusivePtr<DeleteObjectsTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    absl::Status status = [&]() -> absl::Status {
+      TENSORSTORE_RETURN_IF_ERROR(response);
+      auto cord = response->payload;
+      TENSORSTORE_ASSIGN_OR_RETURN(auto errors,
+                                   ParseDeleteObjectsResponse(cord.Flatten()));
+      std::vector<std::string> remaining;
+      absl::Status retry_status;
+      for (auto& error : errors) {
+        if (error.code == "NoSuchKey") continue;
+        std::string message =
+            tensorstore::StrCat("DeleteObjects failed for ",
+                                QuoteString(error.key), ": ", error.code, ": ",
+                                error.message);
+        if (error.code == "InternalError" || error.code == "SlowDown" ||
+            error.code == "ServiceUnavailable") {
+          remaining.push_back(std::move(error.key));
+          retry_status = absl::UnavailableError(std::move(message));
+        } else if (error.code == "AccessDenied") {
+          return absl::PermissionDeniedError(std::move(message));
+        } else {
+          return absl::UnknownError(std::move(message));
+        }
+      }
+      keys = std::move(remaining);
+      return retry_status;
+    }();
+
+    if (!status.ok() && IsRetriable(status)) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    promise.SetResult(std::move(status));
+  }
+};
+
 // Receiver used by `DeleteRange` for processing the results from `List`.
+//
+// Keys are accumulated and removed with DeleteObjects requests of up to
+// `kMaxDeleteObjectsKeys` keys, rather than one request per object.
 struct DeleteRangeListReceiver {
   IntrusivePtr<S3KeyValueStore> owner_;
   Promise<void> promise_;
   FutureCallbackRegistration cancel_registration_;
+  std::vector<std::string> pending_;
 
   void set_starting(AnyCancelReceiver cancel) {
     cancel_registration_ = promise_.ExecuteWhenNotNeeded(std::move(cancel));
@@ -1293,22 +2135,45 @@ struct DeleteRangeListReceiver {
   void set_value(ListEntry entry) {
     assert(!entry.key.empty());
     if (!entry.key.empty()) {
-      LinkError(promise_, owner_->Delete(std::move(entry.key)));
+      pending_.push_back(std::move(entry.key));
+      if (pending_.size() >= kMaxDeleteObjectsKeys) Flush();
     }
   }
 
+  void Flush() {
+    if (pending_.empty() || promise_.null()) return;
+    auto op = PromiseFuturePair<void>::Make(tensorstore::MakeResult());
+    auto state = internal::MakeIntrusivePtr<DeleteObjectsTask>(
+        owner_, std::exchange(pending_, {}), std::move(op.promise));
+    owner_->MaybeResolveRegion().ExecuteWhenReady(
+        [state = std::move(state)](ReadyFuture<const S3EndpointRegion> ready) {
+          if (!ready.status().ok()) {
+            state->promise.SetResult(ready.status());
+            return;
+          }
+          state->resource_ = tensorstore::StrCat(ready.value().endpoint, "/");
+          state->endpoint_region_ = std::move(ready);
+          state->Retry();
+        });
+    LinkError(promise_, std::move(op.future));
+  }
+
   void set_error(absl::Status error) {
     SetDeferredResult(promise_, std::move(error));
     promise_ = Promise<void>();
   }
 
-  void set_done() { promise_ = Promise<void>(); }
+  void set_done() {
+    Flush();
+    promise_ = Promise<void>();
+  }
 
   void set_stopping() { cancel_registration_.Unregister(); }
 };
 
 Future<const void> S3KeyValueStore::DeleteRange(KeyRange range) {
   s3_delete_range.Increment();
+  spec_.retries->RecordRequest();
   if (range.empty()) return absl::OkStatus();
 
   // TODO(jbms): It could make sense to rate limit the list operation, so that
@@ -1323,6 +2188,242 @@ Future<const void> S3KeyValueStore::DeleteRange(KeyRange range) {
   return std::move(op.future);
 }
 
+/// Returns the <ETag> of a CopyObject, UploadPartCopy or
+/// CompleteMultipartUpload response.  Like CompleteMultipartUpload, copies may
+/// fail with an <Error> response despite a 200 status code.
+Result<std::string> GetCopyResultETag(const Result<HttpResponse>& response,
+                                      const char* result_element) {
+  TENSORSTORE_RETURN_IF_ERROR(response);
+  auto cord = response->payload;
+  auto payload = cord.Flatten();
+  tinyxml2::XMLDocument xml_document;
+  if (int xmlcode = xml_document.Parse(payload.data(), payload.size());
+      xmlcode != tinyxml2::XML_SUCCESS) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Malformed ", result_element, " response: ", xmlcode));
+  }
+  TENSORSTORE_RETURN_IF_ERROR(GetMultipartErrorStatus(xml_document));
+  auto* root = xml_document.FirstChildElement(result_element);
+  std::string etag = root ? GetNodeText(root->FirstChildElement("ETag")) : "";
+  if (etag.empty()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Malformed ", result_element, " response: missing <ETag>"));
+  }
+  return etag;
+}
+
+/// A CopyObjectTask copies a single object without transferring its data
+/// through the client.
+///
+/// Objects of up to 5 GiB are copied with a single CopyObject request.  Larger
+/// objects are copied as a multipart upload whose parts are copied
+/// concurrently with UploadPartCopy requests.
+///
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_CopyObject.html
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_UploadPartCopy.html
+struct CopyObjectTask : public internal::AtomicReferenceCount<CopyObjectTask> {
+  IntrusivePtr<S3KeyValueStore> owner;
+  std::string target_url;
+  ReadyFuture<const S3EndpointRegion> endpoint_region;
+  std::string copy_source;  // "<bucket>/<encoded key>"
+  int64_t size;             // Size of the source object, or -1 if unknown.
+  Promise<void> promise;
+
+  std::string upload_id_;
+
+  std::string CopySourceHeader() const {
+    return absl::StrCat("x-amz-copy-source: ", copy_source);
+  }
+
+  void Start() {
+    if (size > kMaxCopyObjectSize) {
+      auto future = IssueMultipartRequest(owner, endpoint_region, "POST",
+                                          target_url, {{"uploads", ""}});
+      future.ExecuteWhenReady([self = IntrusivePtr<CopyObjectTask>(this)](
+                                  ReadyFuture<HttpResponse> response) {
+        self->OnInitiateResponse(response.result());
+      });
+      return;
+    }
+    auto future =
+        IssueMultipartRequest(owner, endpoint_region, "PUT", target_url, {},
+                              absl::Cord(), {CopySourceHeader()});
+    future.ExecuteWhenReady([self = IntrusivePtr<CopyObjectTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      auto etag = GetCopyResultETag(response.result(), "CopyObjectResult");
+      if (absl::IsNotFound(etag.status())) {
+        // The source object was deleted after it was listed.
+        self->promise.SetResult(absl::OkStatus());
+        return;
+      }
+      self->promise.SetResult(etag.status());
+    });
+  }
+
+  void OnInitiateResponse(const Result<HttpResponse>& response) {
+    if (!response.ok()) {
+      promise.SetResult(response.status());
+      return;
+    }
+    auto upload_id = GetUploadId(*response);
+    if (!upload_id.ok()) {
+      promise.SetResult(upload_id.status());
+      return;
+    }
+    upload_id_ = *std::move(upload_id);
+    if (!promise.result_needed()) {
+      Abort();
+      return;
+    }
+
+    const int64_t part_size =
+        std::max(kCopyPartSize, CeilOfRatio(size, kMaxUploadParts));
+    std::vector<Future<HttpResponse>> futures;
+    for (int64_t offset = 0, part_number = 1; offset < size;
+         offset += part_size, ++part_number) {
+      futures.push_back(IssueMultipartRequest(
+          owner, endpoint_region, "PUT", target_url,
+          {{"partNumber", absl::StrCat(part_number)}, {"uploadId", upload_id_}},
+          absl::Cord(),
+          {CopySourceHeader(),
+           absl::StrCat("x-amz-copy-source-range: bytes=", offset, "-",
+                        std::min(offset + part_size, size) - 1)}));
+    }
+    auto all_ready = WaitAllFuture(tensorstore::span(futures));
+    all_ready.ExecuteWhenReady(
+        [self = IntrusivePtr<CopyObjectTask>(this),
+         futures = std::move(futures)](ReadyFuture<void> all_ready) {
+          self->OnPartsCopied(all_ready.status(), futures);
+        });
+  }
+
+  void OnPartsCopied(const absl::Status& status,
+                     const std::vector<Future<HttpResponse>>& futures) {
+    if (!status.ok() || !promise.result_needed()) {
+      Abort();
+      promise.SetResult(status);
+      return;
+    }
+    // Unlike UploadPart, the ETag of each part is returned in the body.
+    std::string body = "<CompleteMultipartUpload>";
+    for (size_t i = 0; i < futures.size(); ++i) {
+      auto etag = GetCopyResultETag(futures[i].result(), "CopyPartResult");
+      if (!etag.ok()) {
+        Abort();
+        promise.SetResult(etag.status());
+        return;
+      }
+      absl::StrAppend(&body, "<Part><PartNumber>", i + 1,
+                      "</PartNumber><ETag>", *etag, "</ETag></Part>");
+    }
+    absl::StrAppend(&body, "</CompleteMultipartUpload>");
+    auto future = IssueMultipartRequest(owner, endpoint_region, "POST",
+                                        target_url, {{"uploadId", upload_id_}},
+                                        absl::Cord(std::move(body)));
+    future.ExecuteWhenReady([self = IntrusivePtr<CopyObjectTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      auto etag = GetCopyResultETag(response.result(),
+                                    "CompleteMultipartUploadResult");
+      if (!etag.ok()) self->Abort();
+      self->promise.SetResult(etag.status());
+    });
+  }
+
+  /// Aborts the upload, discarding any copied parts.
+  void Abort() {
+    AbortMultipartUpload(owner, endpoint_region, target_url, upload_id_);
+  }
+};
+
+// Receiver used by `ExperimentalCopyRangeFrom` for processing the results
+// from `List` on the source bucket.
+//
+// Each listed object is copied by a separate `CopyObjectTask`, whose requests
+// are subject to the write rate limiter and admission queue of the target, so
+// that the copies proceed concurrently with the listing.
+struct CopyRangeListReceiver {
+  IntrusivePtr<S3KeyValueStore> owner_;
+  std::string source_bucket_;
+  size_t source_prefix_length_;
+  std::string target_prefix_;
+  Promise<void> promise_;
+  FutureCallbackRegistration cancel_registration_;
+
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration_ = promise_.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+
+  void set_value(ListEntry entry) {
+    if (promise_.null()) return;
+    std::string target_key = tensorstore::StrCat(
+        target_prefix_,
+        std::string_view(entry.key).substr(source_prefix_length_));
+    if (!IsValidObjectName(target_key)) {
+      SetDeferredResult(promise_,
+                        absl::InvalidArgumentError("Invalid S3 object name"));
+      return;
+    }
+    auto op = PromiseFuturePair<void>::Make(tensorstore::MakeResult());
+    auto task = internal::MakeIntrusivePtr<CopyObjectTask>();
+    task->owner = owner_;
+    task->copy_source = tensorstore::StrCat(source_bucket_, "/",
+                                            S3UriObjectKeyEncode(entry.key));
+    task->size = entry.size;
+    task->promise = std::move(op.promise);
+    owner_->MaybeResolveRegion().ExecuteWhenReady(
+        [task = std::move(task), target_key = std::move(target_key)](
+            ReadyFuture<const S3EndpointRegion> ready) {
+          if (!ready.status().ok()) {
+            task->promise.SetResult(ready.status());
+            return;
+          }
+          task->target_url =
+              tensorstore::StrCat(ready.value().endpoint, "/", target_key);
+          task->endpoint_region = std::move(ready);
+          task->Start();
+        });
+    LinkError(promise_, std::move(op.future));
+  }
+
+  void set_error(absl::Status error) {
+    SetDeferredResult(promise_, std::move(error));
+    promise_ = Promise<void>();
+  }
+
+  void set_done() { promise_ = Promise<void>(); }
+
+  void set_stopping() { cancel_registration_.Unregister(); }
+};
+
+Future<const void> S3KeyValueStore::ExperimentalCopyRangeFrom(
+    const internal::OpenTransactionPtr& transaction, const KvStore& source,
+    Key target_prefix, kvstore::CopyRangeOptions options) {
+  // Server-side copies are only possible between buckets on the same
+  // endpoint, and are not atomic, so they cannot participate in a transaction.
+  if (transaction || source.transaction != no_transaction ||
+      typeid(*source.driver) != typeid(S3KeyValueStore)) {
+    return kvstore::Driver::ExperimentalCopyRangeFrom(
+        transaction, source, std::move(target_prefix), std::move(options));
+  }
+  auto& source_driver = static_cast<S3KeyValueStore&>(*source.driver);
+  if (source_driver.spec_.endpoint != spec_.endpoint ||
+      source_driver.host_header_ != host_header_) {
+    return kvstore::Driver::ExperimentalCopyRangeFrom(
+        transaction, source, std::move(target_prefix), std::move(options));
+  }
+  s3_copy_range.Increment();
+  auto op = PromiseFuturePair<void>::Make(tensorstore::MakeResult());
+  ListOptions list_options;
+  list_options.range = KeyRange::AddPrefix(source.path, options.source_range);
+  list_options.staleness_bound = options.source_staleness_bound;
+  source_driver.ListImpl(
+      std::move(list_options),
+      CopyRangeListReceiver{internal::IntrusivePtr<S3KeyValueStore>(this),
+                            source_driver.spec_.bucket, source.path.size(),
+                            std::move(target_prefix), std::move(op.promise)});
+  return std::move(op.future);
+}
+
 // Resolves the region endpoint for the bucket.
 Future<const S3EndpointRegion> S3KeyValueStore::MaybeResolveRegion() {
   absl::MutexLock l(&mutex_);
@@ -1351,6 +2452,12 @@ Future<kvstore::DriverPtr> S3KeyValueStoreSpec::DoOpen() const {
   // TODO: The transport should support the AWS_CA_BUNDLE environment variable.
   auto driver = internal::MakeIntrusivePtr<S3KeyValueStore>(
       internal_http::GetDefaultHttpTransport(), data_);
+  if (data_.hedge_read_percentile) {
+    driver->read_hedger_ = std::make_unique<internal_kvstore::ReadHedger>(
+        *data_.hedge_read_percentile,
+        data_.hedge_read_budget.value_or(
+            internal_kvstore::ReadHedger::kDefaultBudget));
+  }
 
   // NOTE: Remove temporary logging use of experimental feature.
   if (data_.rate_limiter.has_value()) {
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -179,6 +180,11 @@ TEST(S3KeyValueStoreTest, SimpleMock_VirtualHost) {
           request.headers,
           testing::Contains("host: my-bucket.s3.us-east-1.amazonaws.com"));
     }
+    // Payloads sent over HTTPS are not hashed.
+    if (request.method == "PUT") {
+      EXPECT_THAT(request.headers,
+                  testing::Contains("x-amz-content-sha256: UNSIGNED-PAYLOAD"));
+    }
   }
   EXPECT_THAT(host_header_validated, testing::Ge(2));
 }
@@ -434,6 +440,146 @@ TEST(S3KeyValueStoreTest, SimpleMock_ListPrefix) {
                                                   MatchesListEntry("b/b")));
 }
 
+TEST(S3KeyValueStoreTest, SimpleMock_DeleteRange) {
+  const auto kListResult =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"                            //
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"  //
+      "<Name>bucket</Name>"                                                   //
+      "<Prefix>b</Prefix>"                                                    //
+      "<KeyCount>2</KeyCount>"                                                //
+      "<MaxKeys>1000</MaxKeys>"                                               //
+      "<IsTruncated>false</IsTruncated>"                                      //
+      "<Contents><Key>b/a</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>0</Size><StorageClass>STANDARD</StorageClass></Contents>"        //
+      "<Contents><Key>b/b</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>0</Size><StorageClass>STANDARD</StorageClass></Contents>"        //
+      "</ListBucketResult>";
+
+  // Mocks for s3
+  absl::flat_hash_map<std::string, HttpResponse> url_to_response{
+      // initial HEAD request responds with an x-amz-bucket-region header.
+      {"HEAD https://my-bucket.s3.amazonaws.com",
+       HttpResponse{200, absl::Cord(), {{"x-amz-bucket-region", "us-east-1"}}}},
+
+      {"GET "
+       "https://my-bucket.s3.us-east-1.amazonaws.com/"
+       "?list-type=2&prefix=b",
+       HttpResponse{200, absl::Cord(kListResult), {}}},
+
+      {"POST https://my-bucket.s3.us-east-1.amazonaws.com/?delete",
+       HttpResponse{200,
+                    absl::Cord("<DeleteResult xmlns=\"http://"
+                               "s3.amazonaws.com/doc/2006-03-01/\"/>"),
+                    {}}},
+  };
+
+  auto mock_transport =
+      std::make_shared<DefaultMockHttpTransport>(url_to_response);
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  // Opens the s3 driver with small exponential backoff values.
+  auto context = DefaultTestContext();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "s3"}, {"bucket", "my-bucket"}}, context)
+          .result());
+
+  TENSORSTORE_ASSERT_OK(
+      kvstore::DeleteRange(store, ::tensorstore::KeyRange::Prefix("b")));
+
+  // Both keys are removed by a single DeleteObjects request.
+  int delete_requests = 0;
+  for (const auto& request : mock_transport->requests()) {
+    EXPECT_NE("DELETE", request.method);
+    if (request.method == "POST") {
+      ++delete_requests;
+      EXPECT_THAT(request.headers,
+                  ::testing::Contains(::testing::StartsWith("Content-MD5: ")));
+    }
+  }
+  EXPECT_EQ(1, delete_requests);
+}
+
+TEST(S3KeyValueStoreTest, SimpleMock_CopyRange) {
+  const auto kListResult =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"                            //
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"  //
+      "<Name>bucket</Name>"                                                   //
+      "<Prefix>b</Prefix>"                                                    //
+      "<KeyCount>2</KeyCount>"                                                //
+      "<MaxKeys>1000</MaxKeys>"                                               //
+      "<IsTruncated>false</IsTruncated>"                                      //
+      "<Contents><Key>b/a</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>0</Size><StorageClass>STANDARD</StorageClass></Contents>"        //
+      "<Contents><Key>b/b</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>0</Size><StorageClass>STANDARD</StorageClass></Contents>"        //
+      "</ListBucketResult>";
+
+  const auto kCopyResult =
+      "<CopyObjectResult>"
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"
+      "</CopyObjectResult>";
+
+  // Mocks for s3
+  absl::flat_hash_map<std::string, HttpResponse> url_to_response{
+      // initial HEAD request responds with an x-amz-bucket-region header.
+      {"HEAD https://my-bucket.s3.amazonaws.com",
+       HttpResponse{200, absl::Cord(), {{"x-amz-bucket-region", "us-east-1"}}}},
+
+      {"GET "
+       "https://my-bucket.s3.us-east-1.amazonaws.com/"
+       "?list-type=2&prefix=b",
+       HttpResponse{200, absl::Cord(kListResult), {}}},
+
+      {"PUT https://my-bucket.s3.us-east-1.amazonaws.com/c/a",
+       HttpResponse{200, absl::Cord(kCopyResult), {}}},
+      {"PUT https://my-bucket.s3.us-east-1.amazonaws.com/c/b",
+       HttpResponse{200, absl::Cord(kCopyResult), {}}},
+  };
+
+  auto mock_transport =
+      std::make_shared<DefaultMockHttpTransport>(url_to_response);
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  // Opens the s3 driver with small exponential backoff values.
+  auto context = DefaultTestContext();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "s3"}, {"bucket", "my-bucket"}}, context)
+          .result());
+
+  TENSORSTORE_ASSERT_OK(kvstore::ExperimentalCopyRange(
+      store.WithPathSuffix("b"), store.WithPathSuffix("c")));
+
+  // Each object is copied by the server; no data is read by the client.
+  std::vector<std::string> copy_sources;
+  for (const auto& request : mock_transport->requests()) {
+    EXPECT_FALSE(request.method == "GET" &&
+                 !absl::StrContains(request.url, "list-type"))
+        << request.url;
+    if (request.method == "PUT") {
+      for (const auto& header : request.headers) {
+        if (absl::StartsWith(header, "x-amz-copy-source: ")) {
+          copy_sources.push_back(header);
+        }
+      }
+    }
+  }
+  EXPECT_THAT(copy_sources, ::testing::UnorderedElementsAre(
+                                "x-amz-copy-source: my-bucket/b/a",
+                                "x-amz-copy-source: my-bucket/b/b"));
+}
+
 // TODO: Add mocking to satisfy kvstore testing methods, such as:
 // tensorstore::internal::TestKeyValueStoreReadOps
 // tensorstore::internal::TestKeyValueReadWriteOps
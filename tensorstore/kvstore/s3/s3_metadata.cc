@@ -20,12 +20,15 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/container/btree_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "re2/re2.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tinyxml2.h"
 
 namespace tensorstore {
@@ -97,6 +100,35 @@ std::string UnescapeXml(std::string_view data) {
   return result;
 }
 
+/// Escape the 5 special XML characters.
+std::string EscapeXml(std::string_view data) {
+  std::string result;
+  result.reserve(data.size());
+  for (char c : data) {
+    switch (c) {
+      case '<':
+        result += kLt;
+        break;
+      case '>':
+        result += kGt;
+        break;
+      case '"':
+        result += kQuot;
+        break;
+      case '\'':
+        result += kApos;
+        break;
+      case '&':
+        result += kAmp;
+        break;
+      default:
+        result += c;
+        break;
+    }
+  }
+  return result;
+}
+
 }  // namespace
 
 std::string GetNodeText(tinyxml2::XMLNode* node) {
@@ -120,5 +152,41 @@ Result<StorageGeneration> StorageGenerationFromHeaders(
   return absl::NotFoundError("etag not found in response headers");
 }
 
+std::string BuildDeleteObjectsRequest(span<const std::string> keys) {
+  std::string body =
+      R"(<Delete xmlns="http://s3.amazonaws.com/doc/2006-03-01/">)"
+      "<Quiet>true</Quiet>";
+  for (const auto& key : keys) {
+    absl::StrAppend(&body, "<Object><Key>", EscapeXml(key), "</Key></Object>");
+  }
+  absl::StrAppend(&body, "</Delete>");
+  return body;
+}
+
+Result<std::vector<DeleteObjectsError>> ParseDeleteObjectsResponse(
+    std::string_view payload) {
+  tinyxml2::XMLDocument xml_document;
+  if (int xmlcode = xml_document.Parse(payload.data(), payload.size());
+      xmlcode != tinyxml2::XML_SUCCESS) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Malformed DeleteObjects response: ", xmlcode));
+  }
+  auto* root = xml_document.FirstChildElement("DeleteResult");
+  if (root == nullptr) {
+    return absl::InvalidArgumentError(
+        "Malformed DeleteObjects response: missing <DeleteResult>");
+  }
+  std::vector<DeleteObjectsError> errors;
+  for (auto* error = root->FirstChildElement("Error"); error != nullptr;
+       error = error->NextSiblingElement("Error")) {
+    errors.push_back(DeleteObjectsError{
+        GetNodeText(error->FirstChildElement("Key")),
+        GetNodeText(error->FirstChildElement("Code")),
+        GetNodeText(error->FirstChildElement("Message")),
+    });
+  }
+  return errors;
+}
+
 }  // namespace internal_kvstore_s3
 }  // namespace tensorstore
@@ -22,10 +22,13 @@
 #include <stddef.h>
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "absl/container/btree_map.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tinyxml2.h"
 namespace tensorstore {
 namespace internal_kvstore_s3 {
@@ -47,6 +50,25 @@ std::string GetNodeText(tinyxml2::XMLNode* node);
 Result<StorageGeneration> StorageGenerationFromHeaders(
     const absl::btree_multimap<std::string, std::string>& headers);
 
+/// Maximum number of keys which may be removed by a single DeleteObjects
+/// request.
+inline constexpr size_t kMaxDeleteObjectsKeys = 1000;
+
+/// Returns the XML body of a quiet-mode DeleteObjects request for `keys`.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_DeleteObjects.html
+std::string BuildDeleteObjectsRequest(span<const std::string> keys);
+
+/// A per-key failure reported by a DeleteObjects response.
+struct DeleteObjectsError {
+  std::string key;
+  std::string code;
+  std::string message;
+};
+
+/// Parses the <Error> entries of a DeleteObjects response.
+Result<std::vector<DeleteObjectsError>> ParseDeleteObjectsResponse(
+    std::string_view payload);
+
 }  // namespace internal_kvstore_s3
 }  // namespace tensorstore
 
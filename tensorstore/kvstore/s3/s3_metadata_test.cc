@@ -14,12 +14,17 @@
 
 #include "tensorstore/kvstore/s3/s3_metadata.h"
 
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "tinyxml2.h"
 
 namespace {
 
+using ::tensorstore::internal_kvstore_s3::BuildDeleteObjectsRequest;
 using ::tensorstore::internal_kvstore_s3::GetNodeText;
+using ::tensorstore::internal_kvstore_s3::ParseDeleteObjectsResponse;
 
 /// Exemplar ListObjects v2 Response
 /// https://docs.aws.amazon.com/AmazonS3/latest/API/API_ListObjectsV2.html#API_ListObjectsV2_ResponseSyntax
@@ -71,4 +76,40 @@ TEST(XmlSearchTest, GetNodeText) {
             GetNodeText(contents->FirstChildElement("ETag")));
 }
 
+TEST(DeleteObjectsTest, BuildRequest) {
+  std::vector<std::string> keys{"a/b", "c&<d>"};
+  auto body = BuildDeleteObjectsRequest(keys);
+  EXPECT_EQ(R"(<Delete xmlns="http://s3.amazonaws.com/doc/2006-03-01/">)"
+            R"(<Quiet>true</Quiet>)"
+            R"(<Object><Key>a/b</Key></Object>)"
+            R"(<Object><Key>c&amp;&lt;d&gt;</Key></Object>)"
+            R"(</Delete>)",
+            body);
+
+  tinyxml2::XMLDocument xmlDocument;
+  ASSERT_EQ(xmlDocument.Parse(body.c_str()), tinyxml2::XML_SUCCESS);
+  auto* object =
+      xmlDocument.FirstChildElement("Delete")->FirstChildElement("Object");
+  EXPECT_EQ("a/b", GetNodeText(object->FirstChildElement("Key")));
+  EXPECT_EQ("c&<d>",
+            GetNodeText(object->NextSiblingElement("Object")
+                            ->FirstChildElement("Key")));
+}
+
+TEST(DeleteObjectsTest, ParseResponse) {
+  auto errors = ParseDeleteObjectsResponse(
+      R"(<DeleteResult xmlns="http://s3.amazonaws.com/doc/2006-03-01/">)"
+      R"(<Deleted><Key>a</Key></Deleted>)"
+      R"(<Error><Key>b</Key><Code>SlowDown</Code>)"
+      R"(<Message>Please reduce your request rate.</Message></Error>)"
+      R"(</DeleteResult>)");
+  ASSERT_TRUE(errors.ok());
+  ASSERT_EQ(1, errors->size());
+  EXPECT_EQ("b", (*errors)[0].key);
+  EXPECT_EQ("SlowDown", (*errors)[0].code);
+  EXPECT_EQ("Please reduce your request rate.", (*errors)[0].message);
+
+  EXPECT_FALSE(ParseDeleteObjectsResponse("<Error/>").ok());
+}
+
 }  // namespace
@@ -33,9 +33,11 @@
 #include "absl/log/absl_log.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "absl/time/time.h"
 #include <openssl/evp.h>  // IWYU pragma: keep
 #include <openssl/hmac.h>
@@ -80,13 +82,26 @@ void ComputeHmac(unsigned char (&key)[kHmacSize], std::string_view message,
              md_len == kHmacSize);
 }
 
+/// Returns the canonical form of `query`, in which parameters without a value,
+/// such as `?uploads`, are given an empty value.
+std::string CanonicalQueryString(std::string_view query) {
+  if (query.empty()) return std::string();
+  return absl::StrJoin(absl::StrSplit(query, '&'), "&",
+                       [](std::string* out, std::string_view param) {
+                         absl::StrAppend(out, param,
+                                         absl::StrContains(param, '=') ? ""
+                                                                       : "=");
+                       });
+}
+
 /// https://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-header-based-auth.html
 std::string CanonicalRequest(
     std::string_view method, std::string_view path, std::string_view query,
     std::string_view payload_hash,
     const std::vector<std::pair<std::string, std::string_view>>& headers) {
   std::string canonical =
-      absl::StrCat(method, "\n", S3UriObjectKeyEncode(path), "\n", query, "\n");
+      absl::StrCat(method, "\n", S3UriObjectKeyEncode(path), "\n",
+                   CanonicalQueryString(query), "\n");
 
   // Canonical Headers
   std::vector<std::string_view> signed_headers;
@@ -115,7 +130,8 @@ std::string SigningString(std::string_view canonical_request,
 }
 
 void GetSigningKey(std::string_view aws_secret_access_key,
-                   std::string_view aws_region, const absl::Time& time,
+                   std::string_view aws_region, std::string_view service,
+                   const absl::Time& time,
                    unsigned char (&signing_key)[kHmacSize]) {
   absl::TimeZone utc = absl::UTCTimeZone();
   unsigned char date_key[kHmacSize];
@@ -125,7 +141,7 @@ void GetSigningKey(std::string_view aws_secret_access_key,
   ComputeHmac(absl::StrCat("AWS4", aws_secret_access_key),
               absl::FormatTime("%Y%m%d", time, utc), date_key);
   ComputeHmac(date_key, aws_region, date_region_key);
-  ComputeHmac(date_region_key, "s3", date_region_service_key);
+  ComputeHmac(date_region_key, service, date_region_service_key);
   ComputeHmac(date_region_service_key, "aws4_request", signing_key);
 }
 
@@ -148,6 +164,8 @@ std::string AuthorizationHeader(
 
 static constexpr char kAmzContentSha256Header[] = "x-amz-content-sha256: ";
 static constexpr char kAmzSecurityTokenHeader[] = "x-amz-security-token: ";
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_CreateSession.html
+static constexpr char kAmzS3SessionTokenHeader[] = "x-amz-s3session-token: ";
 /// https://docs.aws.amazon.com/AmazonS3/latest/userguide/ObjectsinRequesterPaysBuckets.html
 /// For DELETE, GET, HEAD, POST, and PUT requests, include x-amz-request-payer :
 /// requester in the header
@@ -190,8 +208,10 @@ HttpRequest S3RequestBuilder::BuildRequest(std::string_view host_header,
   // Add AWS Session Token, if available
   // https://docs.aws.amazon.com/AmazonS3/latest/userguide/RESTAuthentication.html#UsingTemporarySecurityCredentials
   if (!credentials.session_token.empty()) {
-    builder_.AddHeader(
-        absl::StrCat(kAmzSecurityTokenHeader, credentials.session_token));
+    builder_.AddHeader(absl::StrCat(s3express_session_
+                                        ? kAmzS3SessionTokenHeader
+                                        : kAmzSecurityTokenHeader,
+                                    credentials.session_token));
   }
 
   auto request = builder_.BuildRequest();
@@ -214,8 +234,9 @@ HttpRequest S3RequestBuilder::BuildRequest(std::string_view host_header,
   assert(!parsed_uri.path.empty());
 
   std::string scope = absl::StrFormat(
-      "%s/%s/s3/aws4_request",
-      absl::FormatTime("%Y%m%d", time, absl::UTCTimeZone()), aws_region);
+      "%s/%s/%s/aws4_request",
+      absl::FormatTime("%Y%m%d", time, absl::UTCTimeZone()), aws_region,
+      service_);
 
   canonical_request_ =
       CanonicalRequest(request.method, parsed_uri.path, parsed_uri.query,
@@ -223,7 +244,8 @@ HttpRequest S3RequestBuilder::BuildRequest(std::string_view host_header,
   signing_string_ = SigningString(canonical_request_, time, scope);
 
   unsigned char signing_key[kHmacSize];
-  GetSigningKey(credentials.secret_key, aws_region, time, signing_key);
+  GetSigningKey(credentials.secret_key, aws_region, service_, time,
+                signing_key);
 
   unsigned char signature[kHmacSize];
   ComputeHmac(signing_key, signing_string_, signature);
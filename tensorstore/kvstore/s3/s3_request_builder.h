@@ -85,6 +85,22 @@ class S3RequestBuilder {
   /// true
   S3RequestBuilder& MaybeAddRequesterPayer(bool requester_payer = false);
 
+  /// Signs the request for an S3 Express One Zone directory bucket, using the
+  /// `s3express` service name, if `directory_bucket` is true.
+  ///
+  /// Unless `create_session` is true, the credentials are session credentials
+  /// returned by `CreateSession`, and the session token is sent as an
+  /// `x-amz-s3session-token` header.
+  /// https://docs.aws.amazon.com/AmazonS3/latest/API/API_CreateSession.html
+  S3RequestBuilder& MaybeUseS3ExpressAuth(bool directory_bucket,
+                                          bool create_session = false) {
+    if (directory_bucket) {
+      service_ = "s3express";
+      s3express_session_ = !create_session;
+    }
+    return *this;
+  }
+
   /// Adds a `range` header to the http request if the byte_range
   /// is specified.
   S3RequestBuilder& MaybeAddRangeHeader(OptionalByteRangeRequest byte_range) {
@@ -131,6 +147,8 @@ class S3RequestBuilder {
   std::string canonical_request_;
   std::string signing_string_;
   std::string signature_;
+  std::string_view service_ = "s3";
+  bool s3express_session_ = false;
   std::vector<std::pair<std::string, std::string>> query_params_;
   internal_http::HttpRequestBuilder builder_;
 };
@@ -281,6 +281,21 @@ TEST(S3RequestBuilderTest, AWS4SignatureListObjectsExample) {
           "x-amz-date: 20130524T000000Z"));
 }
 
+TEST(S3RequestBuilderTest, EmptyQueryParameterValue) {
+  // Parameters without a value, such as `?uploads`, are given an empty value
+  // in the canonical query string.
+  auto url = absl::StrFormat("https://%s.s3.amazonaws.com/test.txt", bucket);
+  auto builder = S3RequestBuilder("POST", url).AddQueryParameter("uploads", "");
+  auto request = builder.BuildRequest(
+      absl::StrFormat("%s.s3.amazonaws.com", bucket), credentials, aws_region,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+      absl::FromCivil(absl::CivilSecond(2013, 5, 24, 0, 0, 0), utc));
+
+  EXPECT_EQ(request.url, absl::StrCat(url, "?uploads"));
+  EXPECT_THAT(builder.GetCanonicalRequest(),
+              ::testing::StartsWith("POST\n/test.txt\nuploads=\n"));
+}
+
 TEST(S3RequestBuilderTest, AnonymousCredentials) {
   // No Authorization header added for anonymous credentials
   auto url = absl::StrFormat("https://%s/test.txt", bucket);
@@ -324,6 +339,41 @@ TEST(S3RequestBuilderTest, AwsSessionTokenHeaderAdded) {
                                    "x-amz-security-token: ", token)));
 }
 
+TEST(S3RequestBuilderTest, S3ExpressSessionAuth) {
+  auto session_credentials =
+      AwsCredentials{credentials.access_key, credentials.secret_key, "token"};
+  const auto now = absl::FromCivil(absl::CivilSecond(2024, 5, 24), utc);
+  auto builder =
+      S3RequestBuilder("GET",
+                       "https://bucket--usw2-az1--x-s3.s3express-usw2-az1."
+                       "us-west-2.amazonaws.com/test.txt")
+          .MaybeUseS3ExpressAuth(true);
+  auto request = builder.BuildRequest(
+      "", session_credentials, "us-west-2",
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", now);
+  EXPECT_THAT(request.headers,
+              ::testing::Contains("x-amz-s3session-token: token"));
+  EXPECT_THAT(request.headers, ::testing::Not(::testing::Contains(
+                                   ::testing::HasSubstr("x-amz-security"))));
+  EXPECT_THAT(
+      builder.GetSigningString(),
+      ::testing::HasSubstr("20240524/us-west-2/s3express/aws4_request"));
+
+  // `CreateSession` requests are signed for the `s3express` service with the
+  // regular credentials.
+  builder = S3RequestBuilder("GET",
+                             "https://bucket--usw2-az1--x-s3.s3express-usw2-"
+                             "az1.us-west-2.amazonaws.com/?session")
+                .MaybeUseS3ExpressAuth(true, /*create_session=*/true);
+  request = builder.BuildRequest(
+      "", session_credentials, "us-west-2",
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", now);
+  EXPECT_THAT(request.headers,
+              ::testing::Contains("x-amz-security-token: token"));
+  EXPECT_THAT(builder.GetSigningString(),
+              ::testing::HasSubstr("/s3express/aws4_request"));
+}
+
 TEST(S3RequestBuilderTest, AwsRequesterPaysHeaderAdded) {
   /// Test that x-amz-requester-payer: requester is added if true
   auto request =
@@ -19,11 +19,13 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "absl/base/call_once.h"
 #include "absl/flags/flag.h"
 #include "absl/flags/marshalling.h"
 #include "absl/log/absl_log.h"
+#include "absl/status/status.h"
 #include "absl/time/time.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
@@ -31,7 +33,10 @@
 #include "tensorstore/internal/rate_limiter/admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/rate_limiter/scaling_rate_limiter.h"
+#include "tensorstore/internal/rate_limiter/token_bucket_rate_limiter.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 
 /// specializations
 #include "tensorstore/internal/cache_key/absl_time.h"  // IWYU pragma: keep
@@ -59,6 +64,8 @@ using ::tensorstore::internal::ContextResourceCreationContext;
 using ::tensorstore::internal::DoublingRateLimiter;
 using ::tensorstore::internal::GetFlagOrEnvValue;
 using ::tensorstore::internal::NoRateLimiter;
+using ::tensorstore::internal::RateLimiter;
+using ::tensorstore::internal::RateLimiterUnit;
 
 namespace tensorstore {
 namespace internal_kvstore_s3 {
@@ -87,6 +94,33 @@ absl::Duration GetEnvS3RateLimiterDoublingTime() {
       .value_or(absl::ZeroDuration());
 }
 
+/// Returns a limiter for `rate` requests per second or `bytes_rate` bytes per
+/// second, or a `NoRateLimiter` if neither is specified.
+Result<std::shared_ptr<RateLimiter>> MakeRateLimiter(
+    std::string_view name, std::optional<double> rate,
+    std::optional<double> bytes_rate, absl::Duration doubling_time) {
+  if (rate && bytes_rate) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("\"", name, "_rate\" and \"", name,
+                            "_bytes_rate\" are mutually exclusive"));
+  }
+  std::shared_ptr<RateLimiter> limiter;
+  if (!rate && !bytes_rate) {
+    limiter = std::make_shared<NoRateLimiter>();
+    return limiter;
+  }
+  const auto unit =
+      rate ? RateLimiterUnit::kRequests : RateLimiterUnit::kBytes;
+  const double initial_rate = rate ? *rate : *bytes_rate;
+  if (doubling_time > absl::ZeroDuration()) {
+    limiter = std::make_shared<DoublingRateLimiter>(initial_rate,
+                                                    doubling_time, unit);
+  } else {
+    limiter = std::make_shared<ConstantRateLimiter>(initial_rate, unit);
+  }
+  return limiter;
+}
+
 }  // namespace
 
 S3ConcurrencyResource::S3ConcurrencyResource(size_t shared_limit)
@@ -97,6 +131,13 @@ S3ConcurrencyResource::S3ConcurrencyResource()
 
 Result<S3ConcurrencyResource::Resource> S3ConcurrencyResource::Create(
     const Spec& spec, ContextResourceCreationContext context) const {
+  if (spec.adaptive) {
+    Resource value;
+    value.spec = spec;
+    value.queue = std::make_shared<AdmissionQueue>(
+        /*min_limit=*/1, /*max_limit=*/spec.limit.value_or(shared_limit_));
+    return value;
+  }
   if (spec.limit) {
     Resource value;
     value.spec = spec;
@@ -119,29 +160,13 @@ Result<S3RateLimiterResource::Resource> S3RateLimiterResource::Create(
   auto doubling_time =
       spec.doubling_time.value_or(GetEnvS3RateLimiterDoublingTime());
 
-  if (spec.read_rate) {
-    if (doubling_time > absl::ZeroDuration()) {
-      value.read_limiter =
-          std::make_shared<DoublingRateLimiter>(*spec.read_rate, doubling_time);
-    } else {
-      value.read_limiter =
-          std::make_shared<ConstantRateLimiter>(*spec.read_rate);
-    }
-  } else {
-    value.read_limiter = std::make_shared<NoRateLimiter>();
-  }
-
-  if (spec.write_rate) {
-    if (doubling_time > absl::ZeroDuration()) {
-      value.write_limiter = std::make_shared<DoublingRateLimiter>(
-          *spec.write_rate, doubling_time);
-    } else {
-      value.write_limiter =
-          std::make_shared<ConstantRateLimiter>(*spec.write_rate);
-    }
-  } else {
-    value.write_limiter = std::make_shared<NoRateLimiter>();
-  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      value.read_limiter, MakeRateLimiter("read", spec.read_rate,
+                                          spec.read_bytes_rate, doubling_time));
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      value.write_limiter,
+      MakeRateLimiter("write", spec.write_rate, spec.write_bytes_rate,
+                      doubling_time));
   return value;
 }
 
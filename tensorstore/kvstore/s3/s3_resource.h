@@ -60,8 +60,12 @@ struct S3ConcurrencyResource
     // If equal to `nullopt`, indicates that the shared executor is used.
     std::optional<size_t> limit;
 
+    // If `true`, the limit is adjusted based on reported server overload, up
+    // to a maximum of `limit`.
+    bool adaptive = false;
+
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.limit);
+      return f(x.limit, x.adaptive);
     };
   };
   struct Resource {
@@ -73,10 +77,15 @@ struct S3ConcurrencyResource
 
   static constexpr auto JsonBinder() {
     namespace jb = tensorstore::internal_json_binding;
-    return jb::Object(jb::Member(
-        "limit",
-        jb::Projection<&Spec::limit>(jb::DefaultInitializedValue(
-            jb::Optional(jb::Integer<size_t>(1), [] { return "shared"; })))));
+    return jb::Object(
+        jb::Member("limit", jb::Projection<&Spec::limit>(
+                                jb::DefaultInitializedValue(jb::Optional(
+                                    jb::Integer<size_t>(1),
+                                    [] { return "shared"; })))),
+        jb::Member("adaptive",
+                   jb::Projection<&Spec::adaptive>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* v) { *v = false; }))));
   }
 
   Result<Resource> Create(
@@ -113,8 +122,14 @@ struct S3RateLimiterResource
     std::optional<double> write_rate;
     std::optional<absl::Duration> doubling_time;
 
+    // Byte-weighted alternatives to `read_rate` and `write_rate`, in bytes
+    // per second, which limit bandwidth rather than request rate.
+    std::optional<double> read_bytes_rate;
+    std::optional<double> write_bytes_rate;
+
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.read_rate, x.write_rate, x.doubling_time);
+      return f(x.read_rate, x.write_rate, x.doubling_time, x.read_bytes_rate,
+               x.write_bytes_rate);
     };
   };
   struct Resource {
@@ -124,7 +139,8 @@ struct S3RateLimiterResource
   };
 
   static Spec Default() {
-    return Spec{std::nullopt, std::nullopt, std::nullopt};
+    return Spec{std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+                std::nullopt};
   }
 
   static constexpr auto JsonBinder() {
@@ -132,7 +148,11 @@ struct S3RateLimiterResource
     return jb::Object(
         jb::Member("read_rate", jb::Projection<&Spec::read_rate>()),
         jb::Member("write_rate", jb::Projection<&Spec::write_rate>()),
-        jb::Member("doubling_time", jb::Projection<&Spec::doubling_time>()));
+        jb::Member("doubling_time", jb::Projection<&Spec::doubling_time>()),
+        jb::Member("read_bytes_rate",
+                   jb::Projection<&Spec::read_bytes_rate>()),
+        jb::Member("write_bytes_rate",
+                   jb::Projection<&Spec::write_bytes_rate>()));
   }
 
   Result<Resource> Create(
@@ -67,6 +67,18 @@ BucketNameType ClassifyBucketName(std::string_view bucket) {
                                                   : BucketNameType::kInvalid;
 }
 
+bool IsDirectoryBucket(std::string_view bucket) {
+  return !GetDirectoryBucketZoneId(bucket).empty();
+}
+
+std::string_view GetDirectoryBucketZoneId(std::string_view bucket) {
+  static LazyRE2 kDirectoryBucket = {
+      "^[a-z0-9][a-z0-9-]*--([a-z0-9]([a-z0-9-]*[a-z0-9])?)--x-s3$"};
+  std::string_view zone_id;
+  if (!RE2::FullMatch(bucket, *kDirectoryBucket, &zone_id)) return {};
+  return zone_id;
+}
+
 // Returns whether the object name is a valid S3 object name.
 // https://docs.aws.amazon.com/AmazonS3/latest/userguide/object-keys.html
 // NOTE: Amazon recommends that object names do not include the following:
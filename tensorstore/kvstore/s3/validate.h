@@ -39,6 +39,15 @@ inline bool IsValidBucketName(std::string_view bucket) {
   return ClassifyBucketName(bucket) != BucketNameType::kInvalid;
 }
 
+/// Returns whether `bucket` is an S3 Express One Zone directory bucket, which
+/// is named `<base-name>--<zone-id>--x-s3`.
+/// https://docs.aws.amazon.com/AmazonS3/latest/userguide/directory-bucket-naming-rules.html
+bool IsDirectoryBucket(std::string_view bucket);
+
+/// Returns the zone id of a directory bucket, such as `usw2-az1`, or an empty
+/// string if `bucket` is not a directory bucket.
+std::string_view GetDirectoryBucketZoneId(std::string_view bucket);
+
 /// Returns whether the object name is a valid S3 object name.
 /// See: https://docs.aws.amazon.com/AmazonS3/latest/userguide/object-keys.html
 bool IsValidObjectName(std::string_view name);
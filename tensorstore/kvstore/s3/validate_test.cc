@@ -20,6 +20,8 @@ namespace {
 
 using ::tensorstore::internal_kvstore_s3::BucketNameType;
 using ::tensorstore::internal_kvstore_s3::ClassifyBucketName;
+using ::tensorstore::internal_kvstore_s3::GetDirectoryBucketZoneId;
+using ::tensorstore::internal_kvstore_s3::IsDirectoryBucket;
 using ::tensorstore::internal_kvstore_s3::IsValidBucketName;
 using ::tensorstore::internal_kvstore_s3::IsValidObjectName;
 
@@ -98,6 +100,17 @@ TEST(ValidateTest, IsValidBucketName) {
   EXPECT_TRUE(IsValidBucketName("abcd_efgh"));
 }
 
+TEST(ValidateTest, DirectoryBucket) {
+  EXPECT_TRUE(IsDirectoryBucket("bucket--usw2-az1--x-s3"));
+  EXPECT_TRUE(IsValidBucketName("bucket--usw2-az1--x-s3"));
+  EXPECT_EQ("usw2-az1", GetDirectoryBucketZoneId("bucket--usw2-az1--x-s3"));
+  EXPECT_EQ("use1-az4", GetDirectoryBucketZoneId("my--bucket--use1-az4--x-s3"));
+  EXPECT_FALSE(IsDirectoryBucket("bucket"));
+  EXPECT_FALSE(IsDirectoryBucket("bucket--x-s3"));
+  EXPECT_FALSE(IsDirectoryBucket("bucket--usw2-az1--x-s3.example"));
+  EXPECT_EQ("", GetDirectoryBucketZoneId("bucket-usw2-az1-x-s3"));
+}
+
 TEST(ValidateTest, IsValidObjectName) {
   EXPECT_TRUE(IsValidObjectName("foo"));
   EXPECT_TRUE(IsValidObjectName("foo.bar"));
@@ -0,0 +1,370 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/segmented_list.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+namespace {
+
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListOptions;
+using ::tensorstore::kvstore::ListReceiver;
+
+using ListFunction = std::function<void(ListOptions, ListReceiver)>;
+
+// Maximum number of entries buffered for a listing before it is paused, for
+// listings which support flow control.
+constexpr size_t kMaxBufferedEntries = 4096;
+
+class SegmentedListState
+    : public internal::AtomicReferenceCount<SegmentedListState> {
+ public:
+  SegmentedListState(std::vector<ListSegment> segments, ListOptions options,
+                     size_t max_concurrency, ListFunction list,
+                     ListReceiver receiver)
+      : options_(std::move(options)),
+        max_concurrency_(std::max(size_t(1), max_concurrency)),
+        list_(std::move(list)),
+        receiver_(std::move(receiver)) {
+    auto [promise, future] = PromiseFuturePair<void>::Make();
+    cancel_promise_ = std::move(promise);
+    cancel_future_ = std::move(future);
+    segments_.resize(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+      auto& segment = segments_[i];
+      if (auto& entry = segments[i].entry) {
+        if (entry->key.size() <= options_.strip_prefix_length) continue;
+        entry->key = entry->key.substr(options_.strip_prefix_length);
+        segment.entries.push_back(std::move(*entry));
+      } else {
+        segment.range = std::move(segments[i].range);
+        segment.listed = true;
+        segment.stopped = false;
+      }
+    }
+  }
+
+  void Start() {
+    // `receiver_` may request cancellation until `set_stopping` is called,
+    // which happens before this object is destroyed.
+    execution::set_starting(receiver_, [this] { Cancel(); });
+    execution::set_demand(receiver_, demand_);
+    Drain();
+  }
+
+  struct SegmentReceiver {
+    internal::IntrusivePtr<SegmentedListState> state;
+    size_t index;
+    FutureCallbackRegistration cancel_registration;
+
+    void set_starting(AnyCancelReceiver cancel) {
+      cancel_registration =
+          state->cancel_promise_.ExecuteWhenNotNeeded(std::move(cancel));
+    }
+
+    void set_demand(FlowDemand::Ptr demand) {
+      demand->Request(kMaxBufferedEntries);
+      absl::MutexLock lock(&state->mutex_);
+      state->segments_[index].demand = std::move(demand);
+    }
+
+    void set_value(ListEntry entry) {
+      bool is_next;
+      {
+        absl::MutexLock lock(&state->mutex_);
+        if (state->cancelled_ || !state->error_.ok()) return;
+        state->segments_[index].entries.push_back(std::move(entry));
+        is_next = index == state->next_deliver_;
+      }
+      if (is_next) state->Drain();
+    }
+
+    void set_done() {}
+
+    void set_error(absl::Status status) { state->Fail(std::move(status)); }
+
+    void set_stopping() {
+      cancel_registration();
+      {
+        absl::MutexLock lock(&state->mutex_);
+        auto& segment = state->segments_[index];
+        segment.stopped = true;
+        segment.demand.reset();
+        --state->active_;
+      }
+      state->Drain();
+    }
+  };
+
+ private:
+  struct Segment {
+    KeyRange range;
+    std::deque<ListEntry> entries;
+    // Whether `range` is listed, rather than the segment being a known entry.
+    bool listed = false;
+    // Whether no more entries will be added to `entries`.
+    bool stopped = true;
+    FlowDemand::Ptr demand;
+  };
+
+  void Cancel() {
+    internal::IntrusivePtr<SegmentedListState> self(this);
+    Future<const void> cancel_future;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (cancelled_) return;
+      cancelled_ = true;
+      cancel_future = std::move(cancel_future_);
+    }
+    // Releasing the last future cancels the listings in progress.
+    cancel_future = {};
+    demand_->RequestUnbounded();
+    Drain();
+  }
+
+  void Fail(absl::Status status) {
+    Future<const void> cancel_future;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (cancelled_ || !error_.ok()) return;
+      error_ = std::move(status);
+      cancel_future = std::move(cancel_future_);
+    }
+    cancel_future = {};
+    Drain();
+  }
+
+  // Sends buffered entries to `receiver_` and starts listings.  Only one
+  // thread delivers at a time; calls made while another thread is delivering
+  // cause it to repeat.
+  void Drain() {
+    {
+      absl::MutexLock lock(&mutex_);
+      drain_requested_ = true;
+      if (delivering_) return;
+      delivering_ = true;
+    }
+    while (true) {
+      std::vector<ListEntry> batch;
+      std::vector<std::pair<FlowDemand::Ptr, size_t>> credits;
+      std::vector<size_t> to_start;
+      bool wait_for_demand = false;
+      bool finish = false;
+      absl::Status status;
+      {
+        absl::MutexLock lock(&mutex_);
+        if (!drain_requested_ || finished_) {
+          delivering_ = false;
+          return;
+        }
+        drain_requested_ = false;
+        if (cancelled_ || !error_.ok()) {
+          if (active_ == 0) {
+            finished_ = true;
+            finish = true;
+            status = error_;
+          }
+        } else {
+          if (demand_->available()) {
+            CollectEntries(batch, credits);
+          } else if (!waiting_for_demand_) {
+            waiting_for_demand_ = true;
+            wait_for_demand = true;
+          }
+          if (next_deliver_ == segments_.size()) {
+            finished_ = true;
+            finish = true;
+          } else {
+            CollectSegmentsToStart(to_start);
+          }
+        }
+      }
+      for (auto& entry : batch) {
+        execution::set_value(receiver_, std::move(entry));
+        demand_->Consume();
+      }
+      for (auto& [demand, n] : credits) demand->Request(n);
+      for (size_t index : to_start) {
+        ListOptions options = options_;
+        options.range = segments_[index].range;
+        list_(std::move(options),
+              SegmentReceiver{internal::IntrusivePtr<SegmentedListState>(this),
+                              index});
+      }
+      if (wait_for_demand) {
+        demand_->WhenAvailable().ExecuteWhenReady(
+            [self = internal::IntrusivePtr<SegmentedListState>(this)](
+                ReadyFuture<const void>) {
+              {
+                absl::MutexLock lock(&self->mutex_);
+                self->waiting_for_demand_ = false;
+              }
+              self->Drain();
+            });
+      }
+      if (finish) {
+        if (status.ok()) {
+          execution::set_done(receiver_);
+        } else {
+          execution::set_error(receiver_, std::move(status));
+        }
+        execution::set_stopping(receiver_);
+      }
+    }
+  }
+
+  // Moves the entries which may be delivered in order into `batch`.
+  void CollectEntries(std::vector<ListEntry>& batch,
+                      std::vector<std::pair<FlowDemand::Ptr, size_t>>& credits)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    while (next_deliver_ < segments_.size()) {
+      auto& segment = segments_[next_deliver_];
+      if (!segment.entries.empty()) {
+        if (segment.demand) {
+          credits.emplace_back(segment.demand, segment.entries.size());
+        }
+        for (auto& entry : segment.entries) batch.push_back(std::move(entry));
+        segment.entries.clear();
+      }
+      if (!segment.stopped) break;
+      if (segment.listed) --listing_;
+      ++next_deliver_;
+    }
+  }
+
+  // Reserves the listings which may be started, such that at most
+  // `max_concurrency_` listed segments are started but not yet delivered.
+  void CollectSegmentsToStart(std::vector<size_t>& to_start)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    next_start_ = std::max(next_start_, next_deliver_);
+    while (next_start_ < segments_.size() && listing_ < max_concurrency_) {
+      size_t index = next_start_++;
+      if (!segments_[index].listed) continue;
+      ++listing_;
+      ++active_;
+      to_start.push_back(index);
+    }
+  }
+
+  const ListOptions options_;
+  const size_t max_concurrency_;
+  const ListFunction list_;
+  ListReceiver receiver_;
+  FlowDemand::Ptr demand_ = FlowDemand::Make();
+
+  // Cancellation of the listings is requested by releasing `cancel_future_`.
+  Promise<void> cancel_promise_;
+
+  absl::Mutex mutex_;
+  Future<const void> cancel_future_ ABSL_GUARDED_BY(mutex_);
+  // Segments are neither added nor removed, such that the `range` of each
+  // segment may be accessed without holding `mutex_`.
+  std::vector<Segment> segments_;
+  // Index of the first segment that has not been completely delivered.
+  size_t next_deliver_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Index of the first segment that has not been started.
+  size_t next_start_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of listed segments started but not completely delivered.
+  size_t listing_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of listings which have not stopped.
+  size_t active_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status error_ ABSL_GUARDED_BY(mutex_);
+  bool delivering_ ABSL_GUARDED_BY(mutex_) = false;
+  bool drain_requested_ ABSL_GUARDED_BY(mutex_) = false;
+  bool waiting_for_demand_ ABSL_GUARDED_BY(mutex_) = false;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+std::string_view GetSegmentKey(const ListSegment& segment) {
+  return segment.entry ? std::string_view(segment.entry->key)
+                       : std::string_view(segment.range.inclusive_min);
+}
+
+}  // namespace
+
+void ListSegments(std::vector<ListSegment> segments, ListOptions options,
+                  size_t max_concurrency, ListFunction list,
+                  ListReceiver receiver) {
+  internal::MakeIntrusivePtr<SegmentedListState>(
+      std::move(segments), std::move(options), max_concurrency,
+      std::move(list), std::move(receiver))
+      ->Start();
+}
+
+std::vector<ListSegment> GetDelimitedListSegments(
+    const KeyRange& range, std::vector<std::string> common_prefixes,
+    std::vector<ListEntry> entries, bool truncated) {
+  std::vector<ListSegment> segments;
+  // Minimum key which was not returned by the listing.
+  std::string resume_min;
+  bool resume_unbounded = false;
+  for (auto& prefix : common_prefixes) {
+    std::string exclusive_max = KeyRange::PrefixExclusiveMax(prefix);
+    if (exclusive_max.empty()) {
+      resume_unbounded = true;
+    } else {
+      resume_min = std::max(resume_min, exclusive_max);
+    }
+    ListSegment segment;
+    segment.range = Intersect(range, KeyRange::Prefix(std::move(prefix)));
+    if (segment.range.empty()) continue;
+    segments.push_back(std::move(segment));
+  }
+  for (auto& entry : entries) {
+    resume_min = std::max(resume_min, KeyRange::Successor(entry.key));
+    if (!Contains(range, entry.key)) continue;
+    ListSegment segment;
+    segment.entry = std::move(entry);
+    segments.push_back(std::move(segment));
+  }
+  // Every key with a given prefix orders after all smaller keys and before
+  // all larger keys which do not have the prefix.
+  std::sort(segments.begin(), segments.end(),
+            [](const ListSegment& a, const ListSegment& b) {
+              return GetSegmentKey(a) < GetSegmentKey(b);
+            });
+  if (truncated && !resume_unbounded) {
+    ListSegment segment;
+    segment.range = Intersect(
+        range, KeyRange(std::max(resume_min, range.inclusive_min), ""));
+    if (!segment.range.empty()) segments.push_back(std::move(segment));
+  }
+  return segments;
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
@@ -0,0 +1,73 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_SEGMENTED_LIST_H_
+#define TENSORSTORE_KVSTORE_SEGMENTED_LIST_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Part of the key range of a `ListSegments` operation.
+struct ListSegment {
+  /// Range of keys which is listed, if `entry` is not specified.
+  KeyRange range;
+
+  /// Entry which is already known, with a key that has not been stripped.
+  std::optional<kvstore::ListEntry> entry;
+};
+
+/// Lists a range given as a sequence of segments.
+///
+/// Each segment that specifies a range is listed by calling `list` with
+/// `options` and the range of the segment, with up to `max_concurrency` of
+/// those listings in progress at once.  The entries are sent to `receiver` in
+/// the order of `segments`, buffering the entries of later segments until the
+/// earlier segments are complete.  If the segments are disjoint and in key
+/// order, and `list` sends the entries of each range in key order, `receiver`
+/// receives all entries in key order.
+///
+/// Flow control requested by `receiver` applies to the entries that are sent
+/// to it.  The number of entries buffered for each listing is bounded using
+/// the flow control of `list`, if supported.
+void ListSegments(
+    std::vector<ListSegment> segments, kvstore::ListOptions options,
+    size_t max_concurrency,
+    std::function<void(kvstore::ListOptions, kvstore::ListReceiver)> list,
+    kvstore::ListReceiver receiver);
+
+/// Returns the segments of `range`, in key order, given the result of listing
+/// it with a delimiter: the `common_prefixes` which end in the delimiter, and
+/// the `entries` which do not contain it after the listed prefix.
+///
+/// Each prefix is listed as a separate segment, and each entry is a known
+/// segment.  If the listing was `truncated`, a final segment lists the keys
+/// after the last prefix and entry.
+std::vector<ListSegment> GetDelimitedListSegments(
+    const KeyRange& range, std::vector<std::string> common_prefixes,
+    std::vector<kvstore::ListEntry> entries, bool truncated);
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_SEGMENTED_LIST_H_
@@ -0,0 +1,151 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/segmented_list.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/future_collecting_receiver.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::FutureCollectingReceiver;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::KeyRange;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::internal::MatchesListEntry;
+using ::tensorstore::internal_kvstore::GetDelimitedListSegments;
+using ::tensorstore::internal_kvstore::ListSegment;
+using ::tensorstore::internal_kvstore::ListSegments;
+using ::testing::ElementsAre;
+
+class ListSegmentsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(store_,
+                                     kvstore::Open("memory://").result());
+    for (const char* key : {"a/1", "b", "c/1", "d/1", "e"}) {
+      TENSORSTORE_ASSERT_OK(kvstore::Write(store_, key, absl::Cord("xy")));
+    }
+  }
+
+  std::vector<ListSegment> GetSegments() {
+    std::vector<ListSegment> segments(5);
+    segments[0].range = KeyRange::Prefix("a/");
+    segments[1].entry = kvstore::ListEntry{"b", 2};
+    segments[2].range = KeyRange::Prefix("c/");
+    segments[3].range = KeyRange::Prefix("d/");
+    segments[4].entry = kvstore::ListEntry{"e", 2};
+    return segments;
+  }
+
+  tensorstore::Result<std::vector<kvstore::ListEntry>> List(
+      std::vector<ListSegment> segments, kvstore::ListOptions options,
+      size_t max_concurrency) {
+    auto [promise, future] =
+        PromiseFuturePair<std::vector<kvstore::ListEntry>>::Make();
+    ListSegments(
+        std::move(segments), std::move(options), max_concurrency,
+        [this](kvstore::ListOptions options, kvstore::ListReceiver receiver) {
+          if (options.range.inclusive_min == fail_min_) {
+            tensorstore::execution::set_starting(receiver, [] {});
+            tensorstore::execution::set_error(receiver,
+                                              absl::UnknownError("failed"));
+            tensorstore::execution::set_stopping(receiver);
+            return;
+          }
+          kvstore::List(store_, std::move(options), std::move(receiver));
+        },
+        FutureCollectingReceiver<std::vector<kvstore::ListEntry>>{
+            std::move(promise)});
+    return future.result();
+  }
+
+  kvstore::KvStore store_;
+  std::string fail_min_ = "none";
+};
+
+TEST_F(ListSegmentsTest, EntriesInSegmentOrder) {
+  for (size_t max_concurrency : {1, 2, 8}) {
+    SCOPED_TRACE(max_concurrency);
+    EXPECT_THAT(List(GetSegments(), {}, max_concurrency),
+                IsOkAndHolds(ElementsAre(
+                    MatchesListEntry("a/1", 2), MatchesListEntry("b", 2),
+                    MatchesListEntry("c/1", 2), MatchesListEntry("d/1", 2),
+                    MatchesListEntry("e", 2))));
+  }
+}
+
+TEST_F(ListSegmentsTest, StripPrefix) {
+  kvstore::ListOptions options;
+  options.strip_prefix_length = 1;
+  EXPECT_THAT(List(GetSegments(), options, 2),
+              IsOkAndHolds(ElementsAre(
+                  MatchesListEntry("/1"), MatchesListEntry("/1"),
+                  MatchesListEntry("/1"))));
+}
+
+TEST_F(ListSegmentsTest, Empty) {
+  EXPECT_THAT(List({}, {}, 2), IsOkAndHolds(::testing::IsEmpty()));
+}
+
+TEST_F(ListSegmentsTest, Error) {
+  fail_min_ = "c/";
+  EXPECT_THAT(List(GetSegments(), {}, 2),
+              MatchesStatus(absl::StatusCode::kUnknown, "failed"));
+}
+
+TEST(GetDelimitedListSegmentsTest, Basic) {
+  auto segments = GetDelimitedListSegments(
+      KeyRange("a/b", "a/y"), {"a/x/", "a/a/", "a/c/"},
+      {kvstore::ListEntry{"a/x", 1}, kvstore::ListEntry{"a/c0", 2}},
+      /*truncated=*/false);
+  ASSERT_EQ(4, segments.size());
+  EXPECT_EQ(KeyRange::Prefix("a/c/"), segments[0].range);
+  EXPECT_FALSE(segments[0].entry);
+  EXPECT_THAT(segments[1].entry, ::testing::Optional(MatchesListEntry("a/c0")));
+  EXPECT_THAT(segments[2].entry, ::testing::Optional(MatchesListEntry("a/x")));
+  EXPECT_EQ(KeyRange::Prefix("a/x/"), segments[3].range);
+}
+
+TEST(GetDelimitedListSegmentsTest, Truncated) {
+  auto segments = GetDelimitedListSegments(
+      KeyRange::Prefix("a/"), {"a/b/"}, {kvstore::ListEntry{"a/a", 1}},
+      /*truncated=*/true);
+  ASSERT_EQ(3, segments.size());
+  EXPECT_THAT(segments[0].entry, ::testing::Optional(MatchesListEntry("a/a")));
+  EXPECT_EQ(KeyRange::Prefix("a/b/"), segments[1].range);
+  EXPECT_EQ(KeyRange("a/b0", "a0"), segments[2].range);
+}
+
+}  // namespace
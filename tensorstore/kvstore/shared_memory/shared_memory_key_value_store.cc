@@ -0,0 +1,773 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+///
+/// Key-value store whose values are stored in a named POSIX shared-memory
+/// segment, and are therefore shared by all processes on the host that open
+/// the same segment, such as the workers of a data loader.
+///
+/// The segment consists of a `SegmentHeader`, an open-addressing index of
+/// `num_slots` `Slot`s, and a circular data region in which entries are
+/// allocated in FIFO order.  Allocating an entry overwrites the oldest
+/// entries, which are thereby evicted for all processes at once.
+///
+/// Writers are serialized by a process-shared mutex in the header.  Readers do
+/// not lock: each slot is protected by a sequence lock, and the `write_offset`
+/// of the data region serves as a sequence number for the entries, such that
+/// a reader detects an entry that was overwritten while it was being copied.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/os/error_code.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+/// specializations
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tensorstore {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListReceiver;
+using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::SupportedFeatures;
+
+auto& shared_memory_hit_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/shared_memory/hit_count",
+    "Number of reads that found a value in the shared-memory segment.");
+auto& shared_memory_miss_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/shared_memory/miss_count",
+    "Number of reads that found no value in the shared-memory segment.");
+auto& shared_memory_evict_count = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/shared_memory/evict_count",
+    "Number of values evicted from the index of the shared-memory segment "
+    "to make room for another key.");
+
+TimestampedStorageGeneration GenerationNow(StorageGeneration generation) {
+  return TimestampedStorageGeneration{std::move(generation), absl::Now()};
+}
+
+// -----------------------------------------------------------------------------
+// Segment layout.
+
+/// Identifies an initialized segment, and the version of its layout.
+constexpr uint64_t kSegmentMagic = 0x7473'6873'6d00'0001;
+
+/// Maximum number of consecutive slots in which a key may be stored.
+constexpr size_t kMaxProbes = 8;
+
+/// Default number of bytes of the segment per index slot.
+constexpr uint64_t kDefaultBytesPerSlot = 16384;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory index requires lock-free 64-bit atomics");
+
+#ifndef _WIN32
+struct SegmentHeader {
+  /// Set to `kSegmentMagic` once the segment has been initialized.
+  std::atomic<uint64_t> magic;
+  uint64_t num_slots;
+  uint64_t data_size;
+  /// Total number of bytes ever allocated in the data region.  The entry
+  /// allocated at logical offset `o` is intact as long as
+  /// `write_offset <= o + data_size`.
+  std::atomic<uint64_t> write_offset;
+  std::atomic<uint64_t> next_generation;
+  /// Serializes writers across processes.
+  pthread_mutex_t mutex;
+};
+
+/// Index slot referring to an entry of the data region.  Each entry is stored
+/// contiguously as the key size (uint64, native byte order), the key, and the
+/// value.
+struct Slot {
+  /// Odd while the slot is being modified.
+  std::atomic<uint64_t> sequence;
+  /// Hash of the key, or 0 if the slot is empty.
+  std::atomic<uint64_t> key_hash;
+  /// Logical offset of the entry in the data region.
+  std::atomic<uint64_t> offset;
+  /// Size of the entry in bytes.
+  std::atomic<uint64_t> size;
+  std::atomic<uint64_t> generation;
+};
+
+constexpr uint64_t kHeaderSize = RoundUpTo<uint64_t>(sizeof(SegmentHeader), 64);
+#endif
+
+/// Hashes a key such that the hash is the same in every process, which is not
+/// the case for `absl::Hash`.  Never returns 0.
+uint64_t HashKey(std::string_view key) {
+  // FNV-1a
+  uint64_t h = 0xcbf29ce484222325;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 0x100000001b3;
+  }
+  return h | 1;
+}
+
+/// Copy of a key and value read from a `Slot`.
+struct SlotContents {
+  uint64_t generation;
+  uint64_t value_size;
+  std::string key;
+  /// Only populated if requested.
+  std::string value;
+};
+
+/// Mapping of a shared-memory segment into this process.
+class Segment {
+ public:
+  /// Opens the segment `name`, creating it with the specified size if it does
+  /// not exist.  Mappings are shared by all drivers in this process.
+  static Result<std::shared_ptr<Segment>> Open(const std::string& name,
+                                               uint64_t total_bytes,
+                                               uint64_t num_slots);
+
+  ~Segment();
+
+  /// Reads the value of `key` without locking.
+  std::optional<SlotContents> Find(std::string_view key) const;
+
+  /// Writes or deletes the value of `key`, subject to `conditions`.
+  Result<TimestampedStorageGeneration> Write(
+      std::string_view key, const std::optional<absl::Cord>& value,
+      const kvstore::WriteGenerationConditions& conditions);
+
+  absl::Status DeleteRange(const KeyRange& range);
+
+  /// Returns the keys in `range` along with the sizes of their values, in
+  /// unspecified order.
+  std::vector<std::pair<std::string, int64_t>> ListKeys(
+      const KeyRange& range) const;
+
+ private:
+#ifndef _WIN32
+  Segment(void* base, size_t mapped_size);
+
+  static Result<std::shared_ptr<Segment>> OpenUncached(const std::string& name,
+                                                       uint64_t total_bytes,
+                                                       uint64_t num_slots);
+
+  size_t num_probes() const {
+    return std::min<uint64_t>(kMaxProbes, header_->num_slots);
+  }
+  Slot& slot(uint64_t key_hash, size_t probe) const {
+    return slots_[(key_hash + probe) % header_->num_slots];
+  }
+
+  bool IsIntact(uint64_t offset) const {
+    return header_->write_offset.load(std::memory_order_relaxed) <=
+           offset + header_->data_size;
+  }
+
+  /// Copies the contents of `slot` without locking.  Returns `false` if the
+  /// slot is empty, does not match `key_hash` (unless 0), refers to an entry
+  /// that has been overwritten, or is concurrently modified.
+  bool ReadSlot(const Slot& slot, uint64_t key_hash, bool include_value,
+                SlotContents& contents) const;
+
+  // The following members require the writer lock.
+  absl::Status Lock();
+  void Unlock();
+  bool IsLive(const Slot& slot) const;
+  std::string_view EntryKey(const Slot& slot) const;
+  uint64_t Allocate(uint64_t size);
+  void SetSlot(Slot& slot, uint64_t key_hash, uint64_t offset, uint64_t size,
+               uint64_t generation);
+  void ClearSlot(Slot& slot);
+
+  void* base_;
+  size_t mapped_size_;
+  SegmentHeader* header_;
+  Slot* slots_;
+  char* data_;
+#endif
+};
+
+#ifdef _WIN32
+
+Result<std::shared_ptr<Segment>> Segment::Open(const std::string& name,
+                                               uint64_t total_bytes,
+                                               uint64_t num_slots) {
+  return absl::UnimplementedError(
+      "Shared-memory segments are not supported on Windows");
+}
+
+Segment::~Segment() = default;
+
+std::optional<SlotContents> Segment::Find(std::string_view key) const {
+  return std::nullopt;
+}
+
+Result<TimestampedStorageGeneration> Segment::Write(
+    std::string_view key, const std::optional<absl::Cord>& value,
+    const kvstore::WriteGenerationConditions& conditions) {
+  return absl::UnimplementedError("");
+}
+
+absl::Status Segment::DeleteRange(const KeyRange& range) {
+  return absl::UnimplementedError("");
+}
+
+std::vector<std::pair<std::string, int64_t>> Segment::ListKeys(
+    const KeyRange& range) const {
+  return {};
+}
+
+#else
+
+Segment::Segment(void* base, size_t mapped_size)
+    : base_(base),
+      mapped_size_(mapped_size),
+      header_(static_cast<SegmentHeader*>(base)),
+      slots_(reinterpret_cast<Slot*>(static_cast<char*>(base) + kHeaderSize)),
+      data_(static_cast<char*>(base) + kHeaderSize +
+            header_->num_slots * sizeof(Slot)) {}
+
+Segment::~Segment() { ::munmap(base_, mapped_size_); }
+
+Result<std::shared_ptr<Segment>> Segment::Open(const std::string& name,
+                                               uint64_t total_bytes,
+                                               uint64_t num_slots) {
+  struct Registry {
+    absl::Mutex mutex;
+    absl::flat_hash_map<std::string, std::weak_ptr<Segment>> segments
+        ABSL_GUARDED_BY(mutex);
+  };
+  static absl::NoDestructor<Registry> registry;
+  absl::MutexLock lock(&registry->mutex);
+  auto& weak_segment = registry->segments[name];
+  if (auto segment = weak_segment.lock()) return segment;
+  TENSORSTORE_ASSIGN_OR_RETURN(auto segment,
+                               OpenUncached(name, total_bytes, num_slots));
+  weak_segment = segment;
+  return segment;
+}
+
+Result<std::shared_ptr<Segment>> Segment::OpenUncached(const std::string& name,
+                                                       uint64_t total_bytes,
+                                                       uint64_t num_slots) {
+  const std::string shm_name = tensorstore::StrCat("/", name);
+  const auto error = [&](std::string_view action) {
+    return internal::StatusFromOsError(internal::GetLastErrorCode(),
+                                       "Failed to ", action,
+                                       " shared-memory segment ",
+                                       QuoteString(name));
+  };
+  const auto map = [&](int fd, size_t size) -> Result<void*> {
+    void* base =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) return error("map");
+    return base;
+  };
+
+  // Attempt to create and initialize the segment.
+  if (int fd = ::shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+      fd != -1) {
+    if (num_slots == 0) {
+      num_slots = std::max<uint64_t>(16, total_bytes / kDefaultBytesPerSlot);
+    }
+    const uint64_t index_size = kHeaderSize + num_slots * sizeof(Slot);
+    if (total_bytes < index_size + 4096) {
+      ::close(fd);
+      ::shm_unlink(shm_name.c_str());
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "total_bytes=", total_bytes, " is too small for num_slots=",
+          num_slots));
+    }
+    const uint64_t data_size = (total_bytes - index_size) / 8 * 8;
+    const size_t mapped_size = index_size + data_size;
+    void* base = nullptr;
+    auto status = [&]() -> absl::Status {
+      if (::ftruncate(fd, mapped_size) != 0) return error("resize");
+      TENSORSTORE_ASSIGN_OR_RETURN(base, map(fd, mapped_size));
+      return absl::OkStatus();
+    }();
+    ::close(fd);
+    if (!status.ok()) {
+      ::shm_unlink(shm_name.c_str());
+      return status;
+    }
+    // The mapping is zero-initialized, which is a valid state for the
+    // atomics and the slots.
+    auto* header = static_cast<SegmentHeader*>(base);
+    header->num_slots = num_slots;
+    header->data_size = data_size;
+    header->next_generation.store(1, std::memory_order_relaxed);
+    pthread_mutexattr_t attr;
+    ::pthread_mutexattr_init(&attr);
+    ::pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#ifdef __linux__
+    // Allows recovery if a process dies while holding the lock.
+    ::pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+#endif
+    ::pthread_mutex_init(&header->mutex, &attr);
+    ::pthread_mutexattr_destroy(&attr);
+    header->magic.store(kSegmentMagic, std::memory_order_release);
+    return std::shared_ptr<Segment>(new Segment(base, mapped_size));
+  }
+  if (errno != EEXIST) return error("create");
+
+  // Open the existing segment, and wait for the process that created it to
+  // finish initializing it.  The layout of an existing segment takes
+  // precedence over `total_bytes` and `num_slots`.
+  int fd = ::shm_open(shm_name.c_str(), O_RDWR, 0);
+  if (fd == -1) return error("open");
+  const absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (true) {
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0) {
+      auto status = error("stat");
+      ::close(fd);
+      return status;
+    }
+    if (static_cast<size_t>(st.st_size) >= kHeaderSize) {
+      const size_t mapped_size = st.st_size;
+      auto base = map(fd, mapped_size);
+      if (!base.ok()) {
+        ::close(fd);
+        return base.status();
+      }
+      auto* header = static_cast<SegmentHeader*>(*base);
+      const uint64_t magic = header->magic.load(std::memory_order_acquire);
+      if (magic == kSegmentMagic &&
+          mapped_size ==
+              kHeaderSize + header->num_slots * sizeof(Slot) +
+                  header->data_size) {
+        ::close(fd);
+        return std::shared_ptr<Segment>(new Segment(*base, mapped_size));
+      }
+      ::munmap(*base, mapped_size);
+      if (magic != 0) {
+        ::close(fd);
+        return absl::FailedPreconditionError(tensorstore::StrCat(
+            "Shared-memory segment ", QuoteString(name),
+            " has an incompatible layout"));
+      }
+    }
+    if (absl::Now() > deadline) {
+      ::close(fd);
+      return absl::DeadlineExceededError(tensorstore::StrCat(
+          "Timed out waiting for shared-memory segment ", QuoteString(name),
+          " to be initialized"));
+    }
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+}
+
+bool Segment::ReadSlot(const Slot& slot, uint64_t key_hash,
+                       bool include_value, SlotContents& contents) const {
+  for (int attempt = 0; attempt < 4; ++attempt) {
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    const uint64_t hash = slot.key_hash.load(std::memory_order_relaxed);
+    const uint64_t offset = slot.offset.load(std::memory_order_relaxed);
+    const uint64_t size = slot.size.load(std::memory_order_relaxed);
+    contents.generation = slot.generation.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+    if (hash == 0 || (key_hash != 0 && hash != key_hash)) return false;
+    if (!IsIntact(offset)) return false;
+
+    // The entry may be overwritten concurrently, in which case the copied
+    // bytes are discarded below.
+    const char* entry = data_ + offset % header_->data_size;
+    uint64_t key_size;
+    memcpy(&key_size, entry, sizeof(key_size));
+    const bool valid_size =
+        size >= sizeof(key_size) && key_size <= size - sizeof(key_size);
+    if (valid_size) {
+      contents.value_size = size - sizeof(key_size) - key_size;
+      contents.key.assign(entry + sizeof(key_size), key_size);
+      contents.value.assign(
+          include_value ? entry + sizeof(key_size) + key_size : entry,
+          include_value ? contents.value_size : 0);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return valid_size && IsIntact(offset);
+  }
+  return false;
+}
+
+std::optional<SlotContents> Segment::Find(std::string_view key) const {
+  const uint64_t key_hash = HashKey(key);
+  SlotContents contents;
+  for (size_t probe = 0; probe < num_probes(); ++probe) {
+    if (ReadSlot(slot(key_hash, probe), key_hash, /*include_value=*/true,
+                 contents) &&
+        contents.key == key) {
+      return contents;
+    }
+  }
+  return std::nullopt;
+}
+
+absl::Status Segment::Lock() {
+  int result = ::pthread_mutex_lock(&header_->mutex);
+#ifdef __linux__
+  if (result == EOWNERDEAD) {
+    // The previous owner died while holding the lock.  It may have left a
+    // slot in the middle of being modified; entries that it had allocated but
+    // not yet referenced from a slot are harmless.
+    for (uint64_t i = 0; i < header_->num_slots; ++i) {
+      Slot& s = slots_[i];
+      const uint64_t sequence = s.sequence.load(std::memory_order_relaxed);
+      if (sequence & 1) {
+        s.key_hash.store(0, std::memory_order_relaxed);
+        s.sequence.store(sequence + 1, std::memory_order_release);
+      }
+    }
+    result = ::pthread_mutex_consistent(&header_->mutex);
+  }
+#endif
+  if (result != 0) {
+    return internal::StatusFromOsError(result,
+                                       "Failed to lock shared-memory segment");
+  }
+  return absl::OkStatus();
+}
+
+void Segment::Unlock() { ::pthread_mutex_unlock(&header_->mutex); }
+
+bool Segment::IsLive(const Slot& slot) const {
+  return slot.key_hash.load(std::memory_order_relaxed) != 0 &&
+         IsIntact(slot.offset.load(std::memory_order_relaxed));
+}
+
+std::string_view Segment::EntryKey(const Slot& slot) const {
+  const char* entry =
+      data_ + slot.offset.load(std::memory_order_relaxed) % header_->data_size;
+  uint64_t key_size;
+  memcpy(&key_size, entry, sizeof(key_size));
+  return std::string_view(entry + sizeof(key_size), key_size);
+}
+
+uint64_t Segment::Allocate(uint64_t size) {
+  const uint64_t data_size = header_->data_size;
+  uint64_t offset = header_->write_offset.load(std::memory_order_relaxed);
+  size = RoundUpTo<uint64_t>(size, 8);
+  // Entries are contiguous, so skip the remainder of the region if the entry
+  // does not fit.
+  if (offset % data_size + size > data_size) {
+    offset += data_size - offset % data_size;
+  }
+  // Readers of the entries being overwritten must observe the new
+  // `write_offset` before any of the new data.
+  header_->write_offset.store(offset + size, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  return offset;
+}
+
+void Segment::SetSlot(Slot& slot, uint64_t key_hash, uint64_t offset,
+                      uint64_t size, uint64_t generation) {
+  const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.key_hash.store(key_hash, std::memory_order_relaxed);
+  slot.offset.store(offset, std::memory_order_relaxed);
+  slot.size.store(size, std::memory_order_relaxed);
+  slot.generation.store(generation, std::memory_order_relaxed);
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void Segment::ClearSlot(Slot& slot) {
+  const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.key_hash.store(0, std::memory_order_relaxed);
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+Result<TimestampedStorageGeneration> Segment::Write(
+    std::string_view key, const std::optional<absl::Cord>& value,
+    const kvstore::WriteGenerationConditions& conditions) {
+  const uint64_t entry_size =
+      value ? sizeof(uint64_t) + key.size() + value->size() : 0;
+  if (RoundUpTo<uint64_t>(entry_size, 8) > header_->data_size) {
+    return absl::ResourceExhaustedError(tensorstore::StrCat(
+        "Value of ", value->size(), " bytes exceeds the ", header_->data_size,
+        " byte data region of the shared-memory segment"));
+  }
+  const uint64_t key_hash = HashKey(key);
+  TENSORSTORE_RETURN_IF_ERROR(Lock());
+  Slot* existing = nullptr;
+  Slot* empty = nullptr;
+  Slot* oldest = nullptr;
+  for (size_t probe = 0; probe < num_probes(); ++probe) {
+    Slot& s = slot(key_hash, probe);
+    if (!IsLive(s)) {
+      if (!empty) empty = &s;
+    } else if (s.key_hash.load(std::memory_order_relaxed) == key_hash &&
+               EntryKey(s) == key) {
+      existing = &s;
+      break;
+    } else if (!oldest || s.offset.load(std::memory_order_relaxed) <
+                              oldest->offset.load(std::memory_order_relaxed)) {
+      oldest = &s;
+    }
+  }
+  const StorageGeneration current =
+      existing ? StorageGeneration::FromUint64(
+                     existing->generation.load(std::memory_order_relaxed))
+               : StorageGeneration::NoValue();
+  if (!conditions.Matches(current)) {
+    Unlock();
+    return GenerationNow(StorageGeneration::Unknown());
+  }
+  if (!value) {
+    if (existing) ClearSlot(*existing);
+    Unlock();
+    return GenerationNow(StorageGeneration::NoValue());
+  }
+  const uint64_t offset = Allocate(entry_size);
+  char* entry = data_ + offset % header_->data_size;
+  const uint64_t key_size = key.size();
+  memcpy(entry, &key_size, sizeof(key_size));
+  memcpy(entry + sizeof(key_size), key.data(), key.size());
+  value->CopyToArray(entry + sizeof(key_size) + key.size());
+  Slot* target = existing ? existing : empty ? empty : oldest;
+  if (target == oldest) shared_memory_evict_count.Increment();
+  const uint64_t generation =
+      header_->next_generation.fetch_add(1, std::memory_order_relaxed);
+  SetSlot(*target, key_hash, offset, entry_size, generation);
+  Unlock();
+  return GenerationNow(StorageGeneration::FromUint64(generation));
+}
+
+absl::Status Segment::DeleteRange(const KeyRange& range) {
+  TENSORSTORE_RETURN_IF_ERROR(Lock());
+  for (uint64_t i = 0; i < header_->num_slots; ++i) {
+    Slot& s = slots_[i];
+    if (IsLive(s) && Contains(range, EntryKey(s))) ClearSlot(s);
+  }
+  Unlock();
+  return absl::OkStatus();
+}
+
+std::vector<std::pair<std::string, int64_t>> Segment::ListKeys(
+    const KeyRange& range) const {
+  std::vector<std::pair<std::string, int64_t>> keys;
+  SlotContents contents;
+  for (uint64_t i = 0; i < header_->num_slots; ++i) {
+    if (ReadSlot(slots_[i], /*key_hash=*/0, /*include_value=*/false,
+                 contents) &&
+        Contains(range, contents.key)) {
+      keys.emplace_back(std::move(contents.key),
+                        static_cast<int64_t>(contents.value_size));
+    }
+  }
+  return keys;
+}
+
+#endif  // _WIN32
+
+// -----------------------------------------------------------------------------
+
+struct SharedMemoryKvStoreSpecData {
+  std::string segment;
+  uint64_t total_bytes;
+  std::optional<uint64_t> num_slots;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.segment, x.total_bytes, x.num_slots);
+  };
+
+  constexpr static auto default_json_binder = jb::Object(
+      jb::Member(
+          "segment",
+          jb::Projection<&SharedMemoryKvStoreSpecData::segment>(jb::Validate(
+              [](const auto& options, const std::string* x) {
+                if (x->empty() || x->size() > 200 ||
+                    x->find('/') != std::string::npos) {
+                  return absl::InvalidArgumentError(tensorstore::StrCat(
+                      "Invalid shared-memory segment name: ", QuoteString(*x)));
+                }
+                return absl::OkStatus();
+              }))),
+      jb::Member("total_bytes",
+                 jb::Projection<&SharedMemoryKvStoreSpecData::total_bytes>()),
+      jb::Member("num_slots",
+                 jb::Projection<&SharedMemoryKvStoreSpecData::num_slots>()));
+};
+
+class SharedMemoryKvStoreSpec
+    : public internal_kvstore::RegisteredDriverSpec<
+          SharedMemoryKvStoreSpec, SharedMemoryKvStoreSpecData> {
+ public:
+  static constexpr char id[] = "shared_memory";
+
+  Future<kvstore::DriverPtr> DoOpen() const override;
+};
+
+/// Defines the "shared_memory" key value store.
+class SharedMemoryKvStore
+    : public internal_kvstore::RegisteredDriver<SharedMemoryKvStore,
+                                                SharedMemoryKvStoreSpec> {
+ public:
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override;
+
+  Future<const void> DeleteRange(KeyRange range) override;
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override;
+
+  absl::Status GetBoundSpecData(SharedMemoryKvStoreSpecData& spec) const {
+    spec = spec_data_;
+    return absl::OkStatus();
+  }
+
+  SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    return SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
+           SupportedFeatures::kAtomicWriteWithoutOverwrite;
+  }
+
+  SpecData spec_data_;
+  std::shared_ptr<Segment> segment_;
+};
+
+Future<kvstore::DriverPtr> SharedMemoryKvStoreSpec::DoOpen() const {
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto segment, Segment::Open(data_.segment, data_.total_bytes,
+                                  data_.num_slots.value_or(0)));
+  auto driver = internal::MakeIntrusivePtr<SharedMemoryKvStore>();
+  driver->spec_data_ = data_;
+  driver->segment_ = std::move(segment);
+  return driver;
+}
+
+Future<ReadResult> SharedMemoryKvStore::Read(Key key, ReadOptions options) {
+  auto contents = segment_->Find(key);
+  if (!contents) {
+    shared_memory_miss_count.Increment();
+    return ReadResult::Missing(GenerationNow(StorageGeneration::NoValue()));
+  }
+  shared_memory_hit_count.Increment();
+  auto generation = StorageGeneration::FromUint64(contents->generation);
+  if (!options.generation_conditions.Matches(generation)) {
+    return ReadResult::Unspecified(GenerationNow(std::move(generation)));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto byte_range, options.byte_range.Validate(contents->value.size()));
+  absl::Cord value(std::move(contents->value));
+  return ReadResult::Value(internal::GetSubCord(value, byte_range),
+                           GenerationNow(std::move(generation)));
+}
+
+Future<TimestampedStorageGeneration> SharedMemoryKvStore::Write(
+    Key key, std::optional<Value> value, WriteOptions options) {
+  if (options.byte_offset) {
+    return absl::UnimplementedError(
+        "Byte range writes are not supported by the shared_memory driver");
+  }
+  return segment_->Write(key, value, options.generation_conditions);
+}
+
+Future<const void> SharedMemoryKvStore::DeleteRange(KeyRange range) {
+  if (range.empty()) return absl::OkStatus();
+  return segment_->DeleteRange(range);
+}
+
+void SharedMemoryKvStore::ListImpl(ListOptions options, ListReceiver receiver) {
+  std::atomic<bool> cancelled{false};
+  execution::set_starting(receiver, [&cancelled] {
+    cancelled.store(true, std::memory_order_relaxed);
+  });
+  auto keys = segment_->ListKeys(options.range);
+  std::sort(keys.begin(), keys.end());
+  for (auto& [key, size] : keys) {
+    if (cancelled.load(std::memory_order_relaxed)) break;
+    execution::set_value(
+        receiver,
+        ListEntry{key.substr(std::min(options.strip_prefix_length, key.size())),
+                  ListEntry::checked_size(size)});
+  }
+  execution::set_done(receiver);
+  execution::set_stopping(receiver);
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(
+    tensorstore::SharedMemoryKvStore)
+
+// Registers the driver.
+namespace {
+const tensorstore::internal_kvstore::DriverRegistration<
+    tensorstore::SharedMemoryKvStoreSpec>
+    registration;
+
+}  // namespace
@@ -0,0 +1,163 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::kvstore::KvStore;
+
+class SharedMemoryTest : public ::testing::Test {
+ public:
+  SharedMemoryTest()
+      : segment_(tensorstore::StrCat(
+            "tensorstore_test_", getpid(), "_",
+            ::testing::UnitTest::GetInstance()->current_test_info()->name())) {
+  }
+
+  ~SharedMemoryTest() override {
+    ::shm_unlink(tensorstore::StrCat("/", segment_).c_str());
+  }
+
+  ::nlohmann::json Spec(size_t total_bytes = 1 << 20) const {
+    return {{"driver", "shared_memory"},
+            {"segment", segment_},
+            {"total_bytes", total_bytes}};
+  }
+
+  Result<KvStore> KvStoreOpen(size_t total_bytes = 1 << 20) const {
+    // Each open uses a new context, as separate processes would.
+    return kvstore::Open(Spec(total_bytes), Context::Default()).result();
+  }
+
+  std::string segment_;
+};
+
+TEST_F(SharedMemoryTest, ReadNotFound) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  EXPECT_THAT(kvstore::Read(store, "abc").result(),
+              MatchesKvsReadResultNotFound());
+}
+
+TEST_F(SharedMemoryTest, Basic) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST_F(SharedMemoryTest, DeleteRange) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueStoreDeleteRange(store);
+}
+
+TEST_F(SharedMemoryTest, DeletePrefix) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueStoreDeletePrefix(store);
+}
+
+TEST_F(SharedMemoryTest, List) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  tensorstore::internal::TestKeyValueStoreList(store);
+}
+
+TEST_F(SharedMemoryTest, SpecRoundtrip) {
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = Spec();
+  options.check_data_after_serialization = false;
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST_F(SharedMemoryTest, InvalidSegmentName) {
+  EXPECT_THAT(kvstore::Open({{"driver", "shared_memory"},
+                             {"segment", "a/b"},
+                             {"total_bytes", 1 << 20}})
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*Invalid shared-memory segment name.*"));
+}
+
+TEST_F(SharedMemoryTest, ValueTooLarge) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen(64 * 1024));
+  EXPECT_THAT(
+      kvstore::Write(store, "a", absl::Cord(std::string(1 << 20, 'x')))
+          .result(),
+      MatchesStatus(absl::StatusCode::kResourceExhausted));
+}
+
+TEST_F(SharedMemoryTest, EvictsOldestValues) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen(64 * 1024));
+  const absl::Cord value(std::string(1000, 'x'));
+  for (int i = 0; i < 200; ++i) {
+    TENSORSTORE_ASSERT_OK(
+        kvstore::Write(store, tensorstore::StrCat("key", i), value));
+  }
+  EXPECT_THAT(kvstore::Read(store, "key0").result(),
+              MatchesKvsReadResultNotFound());
+  EXPECT_THAT(kvstore::Read(store, "key199").result(),
+              MatchesKvsReadResult(value));
+}
+
+TEST_F(SharedMemoryTest, SharedAcrossOpens) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store1, KvStoreOpen());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store1, "a", absl::Cord("value")));
+  // The layout of the existing segment takes precedence.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store2, KvStoreOpen(2 << 20));
+  EXPECT_THAT(kvstore::Read(store2, "a").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+}
+
+TEST_F(SharedMemoryTest, SharedAcrossProcesses) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, KvStoreOpen());
+  EXPECT_EXIT(
+      {
+        auto child_store = KvStoreOpen();
+        if (!child_store.ok() ||
+            !kvstore::Write(*child_store, "a", absl::Cord("from child"))
+                 .result()
+                 .ok()) {
+          std::exit(1);
+        }
+        std::exit(0);
+      },
+      ::testing::ExitedWithCode(0), "");
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("from child")));
+}
+
+}  // namespace
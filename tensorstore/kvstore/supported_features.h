@@ -32,6 +32,11 @@ enum class SupportedFeatures : uint64_t {
   /// i.e. `WriteOptions::if_equal` is handled race-free.  This implies
   /// `kSingleKeyAtomicReadModifyWrite`.
   kSingleKeyAtomicReadModifyWrite = 8,
+
+  /// Indicates if `WriteOptions::byte_offset` is supported, i.e. part of an
+  /// existing value may be overwritten in place without rewriting the entire
+  /// value.
+  kByteRangeWrite = 16,
 };
 
 constexpr inline SupportedFeatures operator&(SupportedFeatures a,
@@ -46,6 +51,10 @@ constexpr inline SupportedFeatures operator|(SupportedFeatures a,
                                         static_cast<uint64_t>(b));
 }
 
+constexpr inline SupportedFeatures operator~(SupportedFeatures a) {
+  return static_cast<SupportedFeatures>(~static_cast<uint64_t>(a));
+}
+
 }  // namespace kvstore
 }  // namespace tensorstore
 
@@ -140,6 +140,15 @@ inline ::testing::Matcher<kvstore::ListEntry> MatchesListEntry(
       ::testing::Field("size", &kvstore::ListEntry::size, size_matcher));
 }
 
+/// Returns a GMock matcher for a `kvstore::ScanEntry`.
+inline ::testing::Matcher<kvstore::ScanEntry> MatchesScanEntry(
+    ::testing::Matcher<std::string> key_matcher,
+    ::testing::Matcher<absl::Cord> value_matcher = ::testing::_) {
+  return ::testing::AllOf(
+      ::testing::Field("key", &kvstore::ScanEntry::key, key_matcher),
+      ::testing::Field("value", &kvstore::ScanEntry::value, value_matcher));
+}
+
 }  // namespace internal
 }  // namespace tensorstore
 
@@ -570,6 +570,31 @@ void TestKeyValueStoreReadOps(const KvStore& store, std::string key,
                        MatchesKvsReadResultAborted()));  /// GCS result
   }
 
+  ABSL_LOG(INFO) << kSep << "Test stat of key";
+  {
+    auto stat_result = kvstore::Stat(store, key).result();
+    TENSORSTORE_ASSERT_OK(stat_result);
+    EXPECT_TRUE(stat_result->has_value());
+    EXPECT_EQ(read_result->stamp.generation, stat_result->stamp.generation);
+    // Drivers which cannot determine the size cheaply report -1.
+    EXPECT_THAT(stat_result->size,
+                testing::AnyOf(-1, static_cast<int64_t>(
+                                       expected_value.size())));
+
+    kvstore::StatOptions options;
+    options.generation_conditions.if_not_equal = read_result->stamp.generation;
+    stat_result = kvstore::Stat(store, key, options).result();
+    TENSORSTORE_ASSERT_OK(stat_result);
+    EXPECT_TRUE(stat_result->aborted());
+  }
+
+  ABSL_LOG(INFO) << kSep << "Test stat of missing key";
+  {
+    auto stat_result = kvstore::Stat(store, missing_key).result();
+    TENSORSTORE_ASSERT_OK(stat_result);
+    EXPECT_TRUE(stat_result->not_found());
+  }
+
   // Test conditional read of a non-existent object using
   // `if_not_equal=StorageGeneration::NoValue()`, which should return
   // `StorageGeneration::NoValue()` even though the `if_not_equal` condition
@@ -136,6 +136,9 @@ void DeletedEntryDone(DeleteRangeEntry& dr_entry, bool error, size_t count = 1);
 void EntryDone(SinglePhaseMutation& single_phase_mutation, bool error,
                size_t count = 1);
 
+void TopLevelEntryDone(SinglePhaseMutation& single_phase_mutation,
+                       bool error);
+
 /// Checks the data structure invariants of an entry as well as entries it
 /// supersedes.
 ///
@@ -372,7 +375,7 @@ struct Controller {
       return;
     }
     WritebackSuccess(*entry_, std::move(new_stamp));
-    EntryDone(entry_->single_phase_mutation(), /*error=*/false);
+    TopLevelEntryDone(entry_->single_phase_mutation(), /*error=*/false);
   }
   void Error(absl::Status error) {
     auto* dr_entry = static_cast<DeleteRangeEntry*>(entry_->next_);
@@ -381,7 +384,7 @@ struct Controller {
     if (dr_entry) {
       DeletedEntryDone(*dr_entry, /*error=*/true);
     } else {
-      EntryDone(single_phase_mutation, /*error=*/true);
+      TopLevelEntryDone(single_phase_mutation, /*error=*/true);
     }
   }
   void Retry(absl::Time time) {
@@ -666,7 +669,7 @@ void HandleDeleteRangeDone(DeleteRangeEntry& dr_entry) {
   } else {
     WritebackSuccess(dr_entry);
   }
-  EntryDone(dr_entry.single_phase_mutation(), error);
+  TopLevelEntryDone(dr_entry.single_phase_mutation(), error);
 }
 
 void DeletedEntryDone(DeleteRangeEntry& dr_entry, bool error, size_t count) {
@@ -897,45 +900,126 @@ void InvalidateReadStateGoingForward(ReadModifyWriteEntry* entry) {
            (&entry->single_phase_mutation() == &single_phase_mutation));
 }
 
+/// Starts writeback of `entry`, which must be directly contained in the
+/// `entries_` tree of the committing phase, if `predicate` allows.
+///
+/// Returns `true` if the entry was counted, meaning that `EntryDone` will be
+/// called for it.
+bool StartEntryWriteback(
+    MutationEntry& entry, absl::Time staleness_bound,
+    absl::FunctionRef<bool(ReadModifyWriteEntry& entry)> predicate) {
+  if (entry.entry_type() == kReadModifyWrite) {
+    auto& rmw_entry = static_cast<ReadModifyWriteEntry&>(entry);
+    if (auto* next = static_cast<ReadModifyWriteEntry*>(rmw_entry.next_)) {
+      // Disconnect from next phase.
+      assert(next->entry_type() == kReadModifyWrite);
+      assert(&next->single_phase_mutation() !=
+             &rmw_entry.single_phase_mutation());
+      next->prev_ = nullptr;
+      InvalidateReadStateGoingForward(next);
+      rmw_entry.next_ = nullptr;
+    }
+    if (!predicate(rmw_entry)) return false;
+    StartWriteback(rmw_entry, staleness_bound);
+    return true;
+  }
+  auto& dr_entry = static_cast<DeleteRangeEntry&>(entry);
+  assert(dr_entry.remaining_entries_.IsDone());
+  size_t deleted_entry_count = 0;
+  for (auto& deleted_entry : dr_entry.superseded_) {
+    auto& rmw_entry = static_cast<ReadModifyWriteEntry&>(deleted_entry);
+    rmw_entry.next_ = &dr_entry;
+    if (predicate(rmw_entry)) {
+      ++deleted_entry_count;
+      StartWriteback(static_cast<ReadModifyWriteEntry&>(deleted_entry),
+                     staleness_bound);
+    }
+  }
+  DeletedEntryDone(dr_entry, /*error=*/false, -deleted_entry_count);
+  return true;
+}
+
 void WritebackPhase(
     SinglePhaseMutation& single_phase_mutation, absl::Time staleness_bound,
     absl::FunctionRef<bool(ReadModifyWriteEntry& entry)> predicate) {
   assert(single_phase_mutation.remaining_entries_.IsDone());
   size_t entry_count = 0;
   for (auto& entry : single_phase_mutation.entries_) {
-    if (entry.entry_type() == kReadModifyWrite) {
-      auto& rmw_entry = static_cast<ReadModifyWriteEntry&>(entry);
-      if (auto* next = static_cast<ReadModifyWriteEntry*>(rmw_entry.next_)) {
-        // Disconnect from next phase.
-        assert(next->entry_type() == kReadModifyWrite);
-        assert(&next->single_phase_mutation() != &single_phase_mutation);
-        next->prev_ = nullptr;
-        InvalidateReadStateGoingForward(next);
-        rmw_entry.next_ = nullptr;
-      }
-      if (predicate(rmw_entry)) {
-        ++entry_count;
-        StartWriteback(rmw_entry, staleness_bound);
-      }
-    } else {
-      auto& dr_entry = static_cast<DeleteRangeEntry&>(entry);
-      assert(dr_entry.remaining_entries_.IsDone());
+    if (StartEntryWriteback(entry, staleness_bound, predicate)) {
       ++entry_count;
-      size_t deleted_entry_count = 0;
-      for (auto& deleted_entry : dr_entry.superseded_) {
-        auto& rmw_entry = static_cast<ReadModifyWriteEntry&>(deleted_entry);
-        rmw_entry.next_ = &dr_entry;
-        if (predicate(rmw_entry)) {
-          ++deleted_entry_count;
-          StartWriteback(static_cast<ReadModifyWriteEntry&>(deleted_entry),
-                         staleness_bound);
-        }
-      }
-      DeletedEntryDone(dr_entry, /*error=*/false, -deleted_entry_count);
     }
   }
   EntryDone(single_phase_mutation, /*error=*/false, -entry_count);
 }
+
+/// Starts writeback of entries from the window of `single_phase_mutation`
+/// until either all entries have been started or `kMaxConcurrentWritebacks`
+/// are in flight.
+///
+/// \param completed Number of windowed entries that just completed.
+void ContinueWindowedWriteback(SinglePhaseMutation& single_phase_mutation,
+                               size_t completed) {
+  auto& mutex = single_phase_mutation.writeback_mutex_;
+  mutex.Lock();
+  single_phase_mutation.writebacks_in_flight_ -= completed;
+  if (single_phase_mutation.starting_writebacks_) {
+    // Another thread (or a caller further up this thread's stack) will observe
+    // the freed slots.
+    mutex.Unlock();
+    return;
+  }
+  single_phase_mutation.starting_writebacks_ = true;
+  while (MutationEntry* entry = single_phase_mutation.next_writeback_) {
+    if (single_phase_mutation.writebacks_in_flight_ >=
+        kMaxConcurrentWritebacks) {
+      break;
+    }
+    single_phase_mutation.next_writeback_ =
+        MutationEntryTree::Traverse(*entry, MutationEntryTree::kRight);
+    ++single_phase_mutation.writebacks_in_flight_;
+    mutex.Unlock();
+    StartEntryWriteback(*entry, absl::InfinitePast(),
+                        [](ReadModifyWriteEntry& entry) { return true; });
+    mutex.Lock();
+  }
+  single_phase_mutation.starting_writebacks_ = false;
+  mutex.Unlock();
+}
+
+/// Starts writeback of all entries of `single_phase_mutation`, with at most
+/// `kMaxConcurrentWritebacks` in flight at once.
+void WindowedWritebackPhase(SinglePhaseMutation& single_phase_mutation) {
+  assert(single_phase_mutation.remaining_entries_.IsDone());
+  size_t entry_count = 0;
+  for ([[maybe_unused]] auto& entry : single_phase_mutation.entries_) {
+    ++entry_count;
+  }
+  {
+    absl::MutexLock lock(&single_phase_mutation.writeback_mutex_);
+    assert(single_phase_mutation.writebacks_in_flight_ == 0);
+    single_phase_mutation.next_writeback_ =
+        single_phase_mutation.entries_.begin().to_pointer();
+  }
+  // Account for all entries before starting any, since the remaining entries
+  // are started as earlier ones complete.  As in `WritebackPhase`, the count
+  // may temporarily wrap around.
+  ContinueWindowedWriteback(single_phase_mutation, 0);
+  EntryDone(single_phase_mutation, /*error=*/false, -entry_count);
+}
+
+/// Called when an entry directly contained in the `entries_` tree of the
+/// committing phase completes writeback.
+void TopLevelEntryDone(SinglePhaseMutation& single_phase_mutation,
+                       bool error) {
+  bool windowed;
+  {
+    absl::MutexLock lock(&single_phase_mutation.writeback_mutex_);
+    // Entries restarted by `RetryAtomicWriteback` are not windowed.
+    windowed = single_phase_mutation.writebacks_in_flight_ != 0;
+  }
+  if (windowed) ContinueWindowedWriteback(single_phase_mutation, 1);
+  EntryDone(single_phase_mutation, error);
+}
 }  // namespace
 
 void MultiPhaseMutation::CommitNextPhase() {
@@ -966,9 +1050,7 @@ void MultiPhaseMutation::CommitNextPhase() {
     }
   }
 
-  auto& single_phase_mutation = GetCommittingPhase();
-  WritebackPhase(single_phase_mutation, absl::InfinitePast(),
-                 [](ReadModifyWriteEntry& entry) { return true; });
+  WindowedWritebackPhase(GetCommittingPhase());
 }
 
 void MultiPhaseMutation::AbortRemainingPhases() {
@@ -1301,7 +1383,7 @@ void AtomicMultiPhaseMutationBase::AtomicWritebackReady(
   if (auto* dr_entry = static_cast<DeleteRangeEntry*>(entry.next_)) {
     DeletedEntryDone(*dr_entry, /*error=*/false);
   } else {
-    EntryDone(entry.single_phase_mutation(), /*error=*/false);
+    TopLevelEntryDone(entry.single_phase_mutation(), /*error=*/false);
   }
 }
 
@@ -1317,7 +1399,7 @@ void AtomicMultiPhaseMutation::Writeback(ReadModifyWriteEntry& entry,
 }
 
 void AtomicMultiPhaseMutationBase::Writeback(DeleteRangeEntry& entry) {
-  EntryDone(entry.single_phase_mutation(), /*error=*/false);
+  TopLevelEntryDone(entry.single_phase_mutation(), /*error=*/false);
 }
 
 void AtomicMultiPhaseMutationBase::AtomicCommitWritebackSuccess() {
@@ -1554,6 +1636,18 @@ class WriteViaExistingTransactionNode : public internal::TransactionState::Node,
       execution::set_value(receiver, read_result_);
       return;
     }
+    if (options.writeback_mode == ReadModifyWriteSource::kNormalWriteback &&
+        !if_equal_no_value_ &&
+        read_result_.stamp.time >= options.staleness_bound &&
+        target_->KvsReadsCommitted()) {
+      // Optimistic fast path: no prior operation in this transaction affects
+      // the key, so the `if_equal` condition can be checked by the conditional
+      // write itself rather than by a separate validation read.  If the
+      // condition turns out to be violated, the write fails and is retried
+      // with a newer `staleness_bound`, which takes the read path below.
+      execution::set_value(receiver, read_result_);
+      return;
+    }
     // Writeback is conditional.  A read request must be performed in order to
     // determine an up-to-date writeback value (which may be required by a
     // subsequent read-modify-write operation layered on top of this operation).
@@ -93,6 +93,7 @@
 #include <string_view>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
@@ -349,6 +350,15 @@ class ReadModifyWriteEntry : public MutationEntry,
   virtual ~ReadModifyWriteEntry() = default;
 };
 
+/// Maximum number of entries of a single phase whose writeback may be in
+/// progress at once when a commit starts.
+///
+/// Bounding the window keeps the memory used by encoded-but-unwritten values
+/// proportional to the window rather than to the size of the transaction, and
+/// allows `Commit` to return promptly so that the writeback of other
+/// transaction nodes in the same phase is issued concurrently.
+constexpr size_t kMaxConcurrentWritebacks = 1024;
+
 /// Represents the modifications made during a single phase.
 class SinglePhaseMutation {
  public:
@@ -378,6 +388,20 @@ class SinglePhaseMutation {
   /// Counter used during writeback to track the number of entries in `entries_`
   /// not yet completed.
   EntryCounter remaining_entries_;
+
+  /// Protects the writeback window state below.
+  absl::Mutex writeback_mutex_;
+
+  /// Next entry in `entries_` for which writeback has not yet been started.
+  MutationEntry* next_writeback_ ABSL_GUARDED_BY(writeback_mutex_) = nullptr;
+
+  /// Number of entries in `entries_` started through the writeback window that
+  /// have not yet completed.
+  size_t writebacks_in_flight_ ABSL_GUARDED_BY(writeback_mutex_) = 0;
+
+  /// Indicates that a thread is currently starting writebacks from the window,
+  /// so that entries which complete synchronously do not recurse.
+  bool starting_writebacks_ ABSL_GUARDED_BY(writeback_mutex_) = false;
 };
 
 /// Destroys all entries backward-reachable from the interval tree contained in
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
 #include "absl/time/clock.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/kvstore/byte_range.h"
@@ -30,6 +31,7 @@
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/kvstore/transaction.h"
 #include "tensorstore/util/status_testutil.h"
 
 namespace {
@@ -215,6 +217,112 @@ TEST(KvStoreTest, ReadMismatch) {
                             "Error writing \"a\": Generation mismatch"));
 }
 
+TEST(KvStoreTest, ConditionalWriteWithoutValidationRead) {
+  auto mock_driver = MockKeyValueStore::Make();
+
+  Transaction txn(tensorstore::isolated);
+
+  KvStore store(mock_driver, "", txn);
+
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal = StorageGeneration::FromString("abc");
+  auto write_future =
+      kvstore::Write(store, "a", absl::Cord("value"), std::move(options));
+
+  auto future = txn.CommitAsync();
+
+  // The condition is checked by the write itself.
+  {
+    auto req = mock_driver->write_requests.pop();
+    EXPECT_THAT(req.key, "a");
+    EXPECT_THAT(req.options.generation_conditions.if_equal,
+                StorageGeneration::FromString("abc"));
+    req.promise.SetResult(TimestampedStorageGeneration(
+        StorageGeneration::FromString("def"), absl::Now()));
+  }
+  EXPECT_TRUE(mock_driver->read_requests.empty());
+
+  TENSORSTORE_ASSERT_OK(future);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stamp, write_future.result());
+  EXPECT_EQ(StorageGeneration::FromString("def"), stamp.generation);
+}
+
+TEST(KvStoreTest, ConditionalWriteMismatch) {
+  auto mock_driver = MockKeyValueStore::Make();
+
+  Transaction txn(tensorstore::isolated);
+
+  KvStore store(mock_driver, "", txn);
+
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal = StorageGeneration::FromString("abc");
+  auto write_future =
+      kvstore::Write(store, "a", absl::Cord("value"), std::move(options));
+
+  auto future = txn.CommitAsync();
+
+  // Optimistic write fails due to the condition.
+  {
+    auto req = mock_driver->write_requests.pop();
+    EXPECT_THAT(req.key, "a");
+    EXPECT_THAT(req.options.generation_conditions.if_equal,
+                StorageGeneration::FromString("abc"));
+    req.promise.SetResult(TimestampedStorageGeneration(
+        StorageGeneration::Unknown(), absl::Now()));
+  }
+
+  // Retry reads the current state, and finds the condition violated.
+  {
+    auto req = mock_driver->read_requests.pop();
+    EXPECT_THAT(req.key, "a");
+    EXPECT_THAT(req.options.generation_conditions.if_not_equal,
+                StorageGeneration::FromString("abc"));
+    req.promise.SetResult(ReadResult::Value(
+        absl::Cord("other"),
+        TimestampedStorageGeneration(StorageGeneration::FromString("xyz"),
+                                     absl::Now())));
+  }
+  EXPECT_TRUE(mock_driver->write_requests.empty());
+
+  TENSORSTORE_ASSERT_OK(future);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stamp, write_future.result());
+  EXPECT_TRUE(StorageGeneration::IsUnknown(stamp.generation));
+}
+
+TEST(KvStoreTest, WritebackWindow) {
+  using ::tensorstore::internal_kvstore::kMaxConcurrentWritebacks;
+  auto mock_driver = MockKeyValueStore::Make();
+
+  Transaction txn(tensorstore::isolated);
+
+  KvStore store(mock_driver, "", txn);
+
+  const size_t num_keys = kMaxConcurrentWritebacks + 2;
+  for (size_t i = 0; i < num_keys; ++i) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, absl::StrFormat("%06d", i),
+                                         absl::Cord("value")));
+  }
+
+  auto future = txn.CommitAsync();
+
+  // Only a window of writes is issued initially; each completion issues the
+  // next.
+  auto respond = [&] {
+    auto req = mock_driver->write_requests.pop();
+    req.promise.SetResult(TimestampedStorageGeneration(
+        StorageGeneration::FromString("abc"), absl::Now()));
+  };
+  EXPECT_EQ(kMaxConcurrentWritebacks, mock_driver->write_requests.size());
+  respond();
+  EXPECT_EQ(kMaxConcurrentWritebacks, mock_driver->write_requests.size());
+  for (size_t i = 1; i < num_keys; ++i) {
+    respond();
+  }
+  EXPECT_TRUE(mock_driver->write_requests.empty());
+
+  TENSORSTORE_ASSERT_OK(future);
+}
+
 TEST(KvStoreTest, ListInvalid) {
   auto mock_driver = MockKeyValueStore::Make();
 
@@ -44,6 +44,9 @@ DecodeGenerationAndTimestamp(const T& t) {
   return DecodeGenerationAndTimestamp(t.generation_and_timestamp());
 }
 
+/// Encodes a non-ok absl::Status as a StatusMessage protocol buffer.
+void EncodeMessageStatus(const absl::Status& status, StatusMessage* message);
+
 /// Returns an absl::Status when given a tensorstore_gpc::StatuMessage
 absl::Status GetMessageStatus(const StatusMessage& t);
 template <typename T>
@@ -38,12 +38,14 @@
 #include "grpcpp/support/server_callback.h"  // third_party
 #include "grpcpp/support/status.h"  // third_party
 #include <nlohmann/json.hpp>
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/grpc/server_credentials.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_array.h"
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/path.h"
@@ -53,6 +55,7 @@
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/tsgrpc/common.h"
 #include "tensorstore/kvstore/tsgrpc/common.pb.h"
 #include "tensorstore/kvstore/tsgrpc/handler_template.h"
@@ -71,8 +74,11 @@
 using ::grpc::CallbackServerContext;
 using ::tensorstore::kvstore::ListEntry;
 using ::tensorstore_grpc::EncodeGenerationAndTimestamp;
+using ::tensorstore_grpc::EncodeMessageStatus;
 using ::tensorstore_grpc::Handler;
 using ::tensorstore_grpc::StreamHandler;
+using ::tensorstore_grpc::kvstore::BatchReadRequest;
+using ::tensorstore_grpc::kvstore::BatchReadResponse;
 using ::tensorstore_grpc::kvstore::DeleteRequest;
 using ::tensorstore_grpc::kvstore::DeleteResponse;
 using ::tensorstore_grpc::kvstore::ListRequest;
@@ -91,6 +97,10 @@ namespace {
 auto& read_metric = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/grpc_server/read", "KvStoreService::Read calls");
 
+auto& batch_read_metric = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/grpc_server/batch_read",
+    "KvStoreService::BatchRead calls");
+
 auto& write_metric = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/grpc_server/write", "KvStoreService::Write calls");
 
@@ -102,6 +112,34 @@ auto& list_metric = internal_metrics::Counter<int64_t>::New(
 
 ABSL_CONST_INIT internal_log::VerboseFlag verbose_logging("tsgrpc_kvstore");
 
+absl::Status DecodeReadOptions(const ReadRequest& request,
+                               kvstore::ReadOptions& options) {
+  options.generation_conditions.if_equal.value = request.generation_if_equal();
+  options.generation_conditions.if_not_equal.value =
+      request.generation_if_not_equal();
+  if (request.has_byte_range()) {
+    options.byte_range.inclusive_min = request.byte_range().inclusive_min();
+    options.byte_range.exclusive_max = request.byte_range().exclusive_max();
+    if (!options.byte_range.SatisfiesInvariants()) {
+      return absl::InvalidArgumentError("Invalid byte range");
+    }
+  }
+  if (request.has_staleness_bound()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        options.staleness_bound,
+        internal::ProtoToAbslTime(request.staleness_bound()));
+  }
+  return absl::OkStatus();
+}
+
+void EncodeReadResult(const kvstore::ReadResult& r, ReadResponse* response) {
+  response->set_state(static_cast<ReadResponse::State>(r.state));
+  EncodeGenerationAndTimestamp(r.stamp, response);
+  if (r.has_value()) {
+    response->set_value(r.value);
+  }
+}
+
 class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
   using Base = Handler<ReadRequest, ReadResponse>;
 
@@ -114,26 +152,8 @@ class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
     ABSL_LOG_IF(INFO, verbose_logging)
         << "ReadHandler " << ConciseDebugString(*request());
     kvstore::ReadOptions options{};
-    options.generation_conditions.if_equal.value =
-        request()->generation_if_equal();
-    options.generation_conditions.if_not_equal.value =
-        request()->generation_if_not_equal();
-
-    if (request()->has_byte_range()) {
-      options.byte_range.inclusive_min =
-          request()->byte_range().inclusive_min();
-      options.byte_range.exclusive_max =
-          request()->byte_range().exclusive_max();
-      if (!options.byte_range.SatisfiesInvariants()) {
-        Finish(absl::InvalidArgumentError("Invalid byte range"));
-        return;
-      }
-    }
-    if (request()->has_staleness_bound()) {
-      TENSORSTORE_ASSIGN_OR_RETURN(
-          options.staleness_bound,
-          internal::ProtoToAbslTime(request()->staleness_bound()), Finish(_));
-    }
+    TENSORSTORE_RETURN_IF_ERROR(DecodeReadOptions(*request(), options),
+                                Finish(_));
 
     internal::IntrusivePtr<ReadHandler> self{this};
     future_ =
@@ -156,12 +176,7 @@ class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
   absl::Status HandleResult(const Result<kvstore::ReadResult>& result) {
     auto status = result.status();
     if (status.ok()) {
-      auto& r = result.value();
-      response()->set_state(static_cast<ReadResponse::State>(r.state));
-      EncodeGenerationAndTimestamp(r.stamp, response());
-      if (r.has_value()) {
-        response()->set_value(r.value);
-      }
+      EncodeReadResult(result.value(), response());
     }
     Finish(status);
     return status;
@@ -172,6 +187,137 @@ class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
   Future<void> future_;
 };
 
+/// Handles `BatchRead` by issuing all reads to the kvstore as a single batch,
+/// and streaming the results back as they complete.
+class BatchReadHandler final
+    : public StreamHandler<BatchReadRequest, BatchReadResponse> {
+  using Base = StreamHandler<BatchReadRequest, BatchReadResponse>;
+
+ public:
+  BatchReadHandler(CallbackServerContext* grpc_context, const Request* request,
+                   KvStore kvstore)
+      : Base(grpc_context, request), kvstore_(std::move(kvstore)) {}
+
+  void Run() {
+    ABSL_LOG_IF(INFO, verbose_logging)
+        << "BatchReadHandler " << ConciseDebugString(*request());
+    const size_t num_requests = request()->request_size();
+    {
+      absl::MutexLock l(&mu_);
+      remaining_ = num_requests;
+      current_ = std::make_unique<BatchReadResponse>();
+      if (num_requests == 0) {
+        MaybeWrite();
+        return;
+      }
+    }
+
+    internal::IntrusivePtr<BatchReadHandler> self{this};
+    std::vector<Future<void>> futures;
+    futures.reserve(num_requests);
+    {
+      // The reads are submitted together when `batch` is destroyed.
+      auto batch = Batch::New();
+      for (size_t i = 0; i < num_requests; ++i) {
+        const auto& read_request = request()->request(i);
+        kvstore::ReadOptions options{};
+        if (auto status = DecodeReadOptions(read_request, options);
+            !status.ok()) {
+          HandleResult(i, status);
+          continue;
+        }
+        options.batch = batch;
+        futures.push_back(
+            PromiseFuturePair<void>::Link(
+                [self, i](Promise<void> promise, auto read_result) {
+                  if (!promise.result_needed()) return;
+                  self->HandleResult(i, read_result.result());
+                  promise.SetResult(absl::OkStatus());
+                },
+                kvstore::Read(kvstore_, read_request.key(), std::move(options)))
+                .future);
+      }
+    }
+
+    absl::MutexLock l(&mu_);
+    // Once cancelled, the futures are released (outside the lock) instead.
+    if (current_) std::swap(futures_, futures);
+  }
+
+  void OnCancel() final {
+    std::vector<Future<void>> futures;
+    absl::MutexLock l(&mu_);
+    cancelled_ = true;
+    std::swap(futures_, futures);
+    MaybeWrite();
+  }
+
+  void OnWriteDone(bool ok) final {
+    absl::MutexLock l(&mu_);
+    in_flight_msg_ = nullptr;
+    if (!ok) cancelled_ = true;
+    MaybeWrite();
+  }
+
+  void HandleResult(size_t index, const Result<kvstore::ReadResult>& result) {
+    absl::MutexLock l(&mu_);
+    --remaining_;
+    if (!current_) return;
+    auto* entry = current_->add_entry();
+    entry->set_index(index);
+    if (result.ok()) {
+      EncodeReadResult(result.value(), entry->mutable_response());
+    } else {
+      EncodeMessageStatus(result.status(),
+                          entry->mutable_response()->mutable_status());
+    }
+    MaybeWrite();
+  }
+
+  /// Sends the results completed so far, unless a message is in flight;
+  /// only 1 is allowed at a time.  Results accumulate in `current_` while a
+  /// message is in flight, so slow clients receive fewer, larger messages.
+  void MaybeWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (in_flight_msg_ != nullptr) return;
+
+    // Final message already sent.
+    if (!current_) return;
+
+    if (cancelled_) {
+      current_ = nullptr;
+      Finish(::grpc::Status(::grpc::StatusCode::CANCELLED, ""));
+      return;
+    }
+
+    if (remaining_ == 0) {
+      if (current_->entry().empty()) {
+        current_ = nullptr;
+        Finish(grpc::Status::OK);
+      } else {
+        // StartWriteAndFinish does call OnWriteDone, only OnDone.
+        in_flight_msg_ = std::move(current_);
+        StartWriteAndFinish(in_flight_msg_.get(), {}, grpc::Status::OK);
+      }
+      return;
+    }
+
+    if (current_->entry().empty()) return;
+    in_flight_msg_ = std::move(current_);
+    StartWrite(in_flight_msg_.get());
+    current_ = std::make_unique<BatchReadResponse>();
+  }
+
+ private:
+  KvStore kvstore_;
+
+  absl::Mutex mu_;
+  size_t remaining_ ABSL_GUARDED_BY(mu_) = 0;
+  bool cancelled_ ABSL_GUARDED_BY(mu_) = false;
+  std::unique_ptr<BatchReadResponse> current_ ABSL_GUARDED_BY(mu_);
+  std::unique_ptr<BatchReadResponse> in_flight_msg_ ABSL_GUARDED_BY(mu_);
+  std::vector<Future<void>> futures_ ABSL_GUARDED_BY(mu_);
+};
+
 class WriteHandler final : public Handler<WriteRequest, WriteResponse> {
   using Base = Handler<WriteRequest, WriteResponse>;
 
@@ -444,7 +590,21 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
                }),
                jb::Member("bind_addresses",
                           jb::Projection<&KvStoreServer::Spec::bind_addresses>(
-                              jb::DefaultInitializedValue()))));
+                              jb::DefaultInitializedValue())),
+               jb::Member("cache",
+                          jb::Projection<&KvStoreServer::Spec::cache>()),
+               jb::Initialize([](auto* obj) {
+                 if (obj->cache) {
+                   internal::EnsureDirectoryPath(obj->cache->path);
+                 }
+                 return absl::OkStatus();
+               }),
+               jb::Member(
+                   "cache_bytes_limit",
+                   jb::Projection<&KvStoreServer::Spec::cache_bytes_limit>(
+                       jb::DefaultValue([](auto* v) {
+                         *v = int64_t{1} << 30;
+                       })))));
 
 /// Default forwarding implementation of tensorstore_grpc::KvStoreService.
 class KvStoreServer::Impl final : public KvStoreService::CallbackService {
@@ -464,6 +624,18 @@ class KvStoreServer::Impl final : public KvStoreService::CallbackService {
     return handler.get();
   }
 
+  ::grpc::ServerWriteReactor<BatchReadResponse>* BatchRead(
+      ::grpc::CallbackServerContext* context,
+      const BatchReadRequest* request) override {
+    batch_read_metric.Increment();
+    internal::IntrusivePtr<BatchReadHandler> handler(
+        new BatchReadHandler(context, request, kvstore_));
+    assert(handler->use_count() == 2);
+    handler->Run();
+    if (handler->use_count() == 1) return nullptr;
+    return handler.get();
+  }
+
   ::grpc::ServerUnaryReactor* Write(::grpc::CallbackServerContext* context,
                                     const WriteRequest* request,
                                     WriteResponse* response) override {
@@ -528,6 +700,18 @@ void KvStoreServer::Wait() { impl_->server_->Wait(); }
 
 tensorstore::Result<KvStoreServer> KvStoreServer::Start(Spec spec,
                                                         Context context) {
+  if (spec.cache) {
+    // Cache the values read by all clients in a single cache.
+    TENSORSTORE_ASSIGN_OR_RETURN(auto base_json, spec.base.ToJson());
+    TENSORSTORE_ASSIGN_OR_RETURN(auto cache_json, spec.cache->ToJson());
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        spec.base, kvstore::Spec::FromJson({
+                       {"driver", "disk_cache"},
+                       {"base", std::move(base_json)},
+                       {"cache", std::move(cache_json)},
+                       {"total_bytes_limit", spec.cache_bytes_limit},
+                   }));
+  }
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto kv, tensorstore::kvstore::Open(spec.base, context).result());
 
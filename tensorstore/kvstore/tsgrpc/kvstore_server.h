@@ -15,8 +15,11 @@
 #ifndef TENSORSTORE_KVSTORE_TSGRPC_KVSTORE_SERVER_H_
 #define TENSORSTORE_KVSTORE_TSGRPC_KVSTORE_SERVER_H_
 
+#include <stdint.h>
+
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -31,6 +34,12 @@ namespace grpc_kvstore {
 
 /// Interface for starting a grpc kvstore server.
 ///
+/// The server may also run as a local daemon that is shared by many client
+/// processes on the same host, by binding a Unix-domain socket address such as
+/// ``unix:/run/tensorstore.sock`` and specifying a `Spec::cache`.  The clients
+/// then share the connection pool, concurrency limits and cache of the
+/// server's `Context`, rather than each creating their own.
+///
 /// .. warning::
 ///
 ///    Encryption and authentication are not currently supported, which makes
@@ -57,10 +66,21 @@ class KvStoreServer {
     /// `CoordinatorServer::port` or `CoordinatorServer::ports`.
     ///
     /// If none are specified, binds to `[::]:0`.
+    ///
+    /// An address of the form ``unix:/path`` binds a Unix-domain socket.
     std::vector<std::string> bind_addresses;
 
     /// Underlying kvstore used by the server.
     kvstore::Spec base;
+
+    /// Optional kvstore in which values read from `base` are cached, shared by
+    /// all clients of the server.  If specified, `base` is wrapped in a
+    /// ``disk_cache`` adapter with this cache, e.g. ``memory://`` for an
+    /// in-memory cache or a ``shared_memory`` segment.
+    std::optional<kvstore::Spec> cache;
+
+    /// Limit on the total number of bytes stored in `cache`.
+    int64_t cache_bytes_limit = int64_t{1} << 30;
   };
 
   /// Starts the kvstore server server.
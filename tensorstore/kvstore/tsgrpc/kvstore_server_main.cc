@@ -12,8 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string_view>
+#include <utility>
+
+#include "absl/algorithm/container.h"
 #include "absl/flags/flag.h"
 #include "absl/log/absl_log.h"
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "grpcpp/security/credentials.h"  // third_party
 #include "grpcpp/security/server_credentials.h"  // third_party
@@ -33,6 +38,18 @@ bazel run //tensorstore/kvstore/grpc:kvstore_server_main &
 bazel run //tensorstore/kvstore:live_kvstore_test \
  -- --kvstore_spec='{ "driver": "tsgrpc_kvstore", "address": "localhost:9833" }'
 
+To run as a daemon shared by the local processes on a host, bind a
+Unix-domain socket and enable the shared cache:
+
+bazel run //tensorstore/kvstore/grpc:kvstore_server_main -- --spec='{
+  "bind_addresses": ["unix:/tmp/tensorstore.sock"],
+  "base": "gs://bucket/path/",
+  "cache": "memory://",
+  "cache_bytes_limit": 10000000000 }'
+
+Clients then specify { "driver": "tsgrpc_kvstore",
+                       "address": "unix:/tmp/tensorstore.sock" }.
+
 */
 using ::tensorstore::grpc_kvstore::KvStoreServer;
 
@@ -58,15 +75,22 @@ int main(int argc, char** argv) {
   absl::ParseCommandLine(argc, argv);  // InitTensorstore
 
   tensorstore::Context context(absl::GetFlag(FLAGS_context_spec).value);
+  auto spec = absl::GetFlag(FLAGS_spec).value;
 
-  // Install LOCAL_TCP credentials for this process:
+  // Install local credentials for this process, which are specific to the
+  // type of socket.
+  const bool uds =
+      !spec.bind_addresses.empty() &&
+      absl::c_all_of(spec.bind_addresses, [](std::string_view address) {
+        return absl::StartsWith(address, "unix:");
+      });
+  const grpc_local_connect_type connect_type = uds ? UDS : LOCAL_TCP;
   tensorstore::GrpcServerCredentials::Use(
-      context, grpc::experimental::LocalServerCredentials(LOCAL_TCP));
+      context, grpc::experimental::LocalServerCredentials(connect_type));
   tensorstore::GrpcClientCredentials::Use(
-      context, grpc::experimental::LocalCredentials(LOCAL_TCP));
+      context, grpc::experimental::LocalCredentials(connect_type));
 
-  auto server =
-      KvStoreServer::Start({absl::GetFlag(FLAGS_spec).value}, context);
+  auto server = KvStoreServer::Start(std::move(spec), context);
   if (!server.ok()) {
     ABSL_LOG(INFO) << "Failed to start KvStoreServer:" << server.status();
     return 2;
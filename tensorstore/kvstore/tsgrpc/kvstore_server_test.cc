@@ -24,7 +24,9 @@
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/notification.h"
 #include <nlohmann/json.hpp>
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
@@ -36,13 +38,17 @@
 #include "tensorstore/util/execution/sender_testutil.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
 
 namespace {
 
 namespace kvstore = ::tensorstore::kvstore;
+using ::tensorstore::Batch;
 using ::tensorstore::KeyRange;
+using ::tensorstore::MatchesStatus;
 using ::tensorstore::grpc_kvstore::KvStoreServer;
+using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
 
 class KvStoreSingleton {
@@ -122,6 +128,36 @@ TEST_F(KvStoreTest, DeleteRange) {
               MatchesKvsReadResultNotFound());
 }
 
+TEST_F(KvStoreTest, BatchRead) {
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::kvstore::Open({{"driver", "tsgrpc_kvstore"},
+                                              {"address", address()},
+                                              {"path", "batch_read/"}},
+                                             context)
+                      .result());
+
+  TENSORSTORE_EXPECT_OK(kvstore::Write(store, "a", absl::Cord("abc")));
+  TENSORSTORE_EXPECT_OK(kvstore::Write(store, "b", absl::Cord("defgh")));
+
+  auto batch = Batch::New();
+  kvstore::ReadOptions options;
+  options.batch = batch;
+  auto a = kvstore::Read(store, "a", options);
+  auto missing = kvstore::Read(store, "missing", options);
+  options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 3);
+  auto b = kvstore::Read(store, "b", options);
+  options.byte_range = tensorstore::OptionalByteRangeRequest::Range(10, 12);
+  auto out_of_range = kvstore::Read(store, "a", options);
+  batch.Release();
+
+  EXPECT_THAT(a.result(), MatchesKvsReadResult(absl::Cord("abc")));
+  EXPECT_THAT(missing.result(), MatchesKvsReadResultNotFound());
+  EXPECT_THAT(b.result(), MatchesKvsReadResult(absl::Cord("ef")));
+  EXPECT_THAT(out_of_range.result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+}
+
 TEST_F(KvStoreTest, List) {
   auto context = tensorstore::Context::Default();
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
@@ -217,4 +253,36 @@ TEST_F(KvStoreTest, List) {
   }
 }
 
+TEST(KvStoreServerTest, SharedCache) {
+  auto server_context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto server, KvStoreServer::Start(KvStoreServer::Spec::FromJson(  //
+                                            {
+                                                {"bind_addresses",
+                                                 {"localhost:0"}},
+                                                {"base", "memory://base/"},
+                                                {"cache", "memory://cache/"},
+                                                {"cache_bytes_limit", 1000},
+                                            })
+                                            .value(),
+                                        server_context));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "tsgrpc_kvstore"},
+                     {"address", absl::StrFormat("localhost:%d",
+                                                 server.port())}},
+                    tensorstore::Context::Default())
+          .result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("abc")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("abc")));
+
+  // The value is cached by the server.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto cache, kvstore::Open("memory://cache/", server_context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto entries,
+                                   kvstore::ListFuture(cache).result());
+  EXPECT_FALSE(entries.empty());
+}
+
 }  // namespace
@@ -40,6 +40,9 @@ class MockKvStoreService : public kvstore::grpc_gen::KvStoreService::Service {
                         ::tensorstore_grpc::kvstore::WriteResponse);
   TENSORSTORE_GRPC_MOCK(Delete, ::tensorstore_grpc::kvstore::DeleteRequest,
                         ::tensorstore_grpc::kvstore::DeleteResponse);
+  TENSORSTORE_GRPC_SERVER_STREAMING_MOCK(
+      BatchRead, ::tensorstore_grpc::kvstore::BatchReadRequest,
+      ::tensorstore_grpc::kvstore::BatchReadResponse);
   TENSORSTORE_GRPC_SERVER_STREAMING_MOCK(
       List, ::tensorstore_grpc::kvstore::ListRequest,
       ::tensorstore_grpc::kvstore::ListResponse);
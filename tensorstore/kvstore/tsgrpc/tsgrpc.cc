@@ -34,6 +34,7 @@
 #include "grpcpp/create_channel.h"  // third_party
 #include "grpcpp/support/status.h"  // third_party
 #include "grpcpp/support/sync_stream.h"  // third_party
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/context_binding.h"
@@ -45,6 +46,7 @@
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
@@ -82,6 +84,8 @@ using ::tensorstore::kvstore::ListEntry;
 using ::tensorstore::kvstore::ListReceiver;
 using ::tensorstore_grpc::DecodeGenerationAndTimestamp;
 using ::tensorstore_grpc::GetMessageStatus;
+using ::tensorstore_grpc::kvstore::BatchReadRequest;
+using ::tensorstore_grpc::kvstore::BatchReadResponse;
 using ::tensorstore_grpc::kvstore::DeleteRequest;
 using ::tensorstore_grpc::kvstore::DeleteResponse;
 using ::tensorstore_grpc::kvstore::ListRequest;
@@ -98,6 +102,10 @@ namespace {
 auto& grpc_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/tsgrpc/read", "grpc driver kvstore::Read calls");
 
+auto& grpc_batch_read = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/tsgrpc/batch_read",
+    "grpc driver BatchRead calls for batched kvstore::Read calls");
+
 auto& grpc_write = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/tsgrpc/write", "grpc driver kvstore::Write calls");
 
@@ -190,6 +198,34 @@ class TsGrpcKeyValueStore
 
 ////////////////////////////////////////////////////
 
+void EncodeReadRequest(kvstore::Key key, const kvstore::ReadOptions& options,
+                       ReadRequest& request) {
+  request.set_key(std::move(key));
+  request.set_generation_if_equal(options.generation_conditions.if_equal.value);
+  request.set_generation_if_not_equal(
+      options.generation_conditions.if_not_equal.value);
+  if (!options.byte_range.IsFull()) {
+    request.mutable_byte_range()->set_inclusive_min(
+        options.byte_range.inclusive_min);
+    request.mutable_byte_range()->set_exclusive_max(
+        options.byte_range.exclusive_max);
+  }
+  if (options.staleness_bound != absl::InfiniteFuture()) {
+    AbslTimeToProto(options.staleness_bound, request.mutable_staleness_bound());
+  }
+}
+
+Result<kvstore::ReadResult> DecodeReadResponse(const ReadResponse& response) {
+  TENSORSTORE_RETURN_IF_ERROR(GetMessageStatus(response));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto stamp,
+                               DecodeGenerationAndTimestamp(response));
+  return kvstore::ReadResult{
+      static_cast<kvstore::ReadResult::State>(response.state()),
+      absl::Cord(response.value()),
+      std::move(stamp),
+  };
+}
+
 /// Implements `TsGrpcKeyValueStore::Read`.
 struct ReadTask : public internal::AtomicReferenceCount<ReadTask> {
   internal::IntrusivePtr<TsGrpcKeyValueStore> driver;
@@ -199,21 +235,7 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask> {
 
   Future<kvstore::ReadResult> Start(kvstore::Key key,
                                     const kvstore::ReadOptions& options) {
-    request.set_key(std::move(key));
-    request.set_generation_if_equal(
-        options.generation_conditions.if_equal.value);
-    request.set_generation_if_not_equal(
-        options.generation_conditions.if_not_equal.value);
-    if (!options.byte_range.IsFull()) {
-      request.mutable_byte_range()->set_inclusive_min(
-          options.byte_range.inclusive_min);
-      request.mutable_byte_range()->set_exclusive_max(
-          options.byte_range.exclusive_max);
-    }
-    if (options.staleness_bound != absl::InfiniteFuture()) {
-      AbslTimeToProto(options.staleness_bound,
-                      request.mutable_staleness_bound());
-    }
+    EncodeReadRequest(std::move(key), options, request);
 
     driver->MaybeSetDeadline(context);
 
@@ -238,14 +260,73 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask> {
         << "ReadTask::Ready " << ConciseDebugString(response) << " " << status;
 
     TENSORSTORE_RETURN_IF_ERROR(status);
-    TENSORSTORE_RETURN_IF_ERROR(GetMessageStatus(response));
-    TENSORSTORE_ASSIGN_OR_RETURN(auto stamp,
-                                 DecodeGenerationAndTimestamp(response));
-    return kvstore::ReadResult{
-        static_cast<kvstore::ReadResult::State>(response.state()),
-        absl::Cord(response.value()),
-        std::move(stamp),
-    };
+    return DecodeReadResponse(response);
+  }
+};
+
+using BatchReadTaskBase = internal_kvstore_batch::BatchReadEntry<
+    TsGrpcKeyValueStore,
+    internal_kvstore_batch::ReadRequest<kvstore::Key,
+                                        kvstore::ReadGenerationConditions>>;
+
+/// Implements batched `TsGrpcKeyValueStore::Read` calls.
+///
+/// All reads of a batch are sent in a single `BatchRead` call, which allows
+/// the server to coalesce them against its own kvstore.  Like `ListTask`,
+/// this uses the synchronous streaming interface from an executor thread.
+class BatchReadTask : public BatchReadTaskBase {
+ public:
+  using BatchReadTaskBase::BatchReadTaskBase;
+
+  void Submit(Batch::View batch) override {
+    grpc_batch_read.Increment();
+    auto executor = driver().executor();
+    executor([self = std::unique_ptr<BatchReadTask>(this)] { self->Run(); });
+  }
+
+  void Run() {
+    auto& requests = request_batch.requests;
+    BatchReadRequest request;
+    for (auto& r : requests) {
+      kvstore::ReadOptions options;
+      options.generation_conditions =
+          std::get<kvstore::ReadGenerationConditions>(r);
+      options.byte_range =
+          std::get<internal_kvstore_batch::ByteRangeReadRequest>(r).byte_range;
+      options.staleness_bound = request_batch.staleness_bound;
+      EncodeReadRequest(std::get<kvstore::Key>(r), options,
+                        *request.add_request());
+    }
+
+    grpc::ClientContext context;
+    driver().MaybeSetDeadline(context);
+    auto reader = driver().stub()->BatchRead(&context, request);
+
+    absl::Status msg_status;
+    BatchReadResponse response;
+    while (msg_status.ok() && reader->Read(&response)) {
+      ABSL_LOG_IF(INFO, verbose_logging)
+          << "BatchReadTask::Read " << ConciseDebugString(response);
+      for (const auto& entry : response.entry()) {
+        if (entry.index() >= requests.size()) {
+          msg_status = absl::DataLossError("Invalid BatchRead response index");
+          context.TryCancel();
+          break;
+        }
+        std::get<internal_kvstore_batch::ByteRangeReadRequest>(
+            requests[entry.index()])
+            .promise.SetResult(DecodeReadResponse(entry.response()));
+      }
+    }
+
+    auto s = reader->Finish();
+    if (msg_status.ok()) {
+      msg_status = s.ok() ? absl::DataLossError("Missing BatchRead response")
+                          : GrpcStatusToAbslStatus(s);
+    }
+    // Fails any read for which no response was received; setting the result
+    // of the other promises has no effect.
+    internal_kvstore_batch::SetCommonResult(requests, msg_status);
   }
 };
 
@@ -404,6 +485,15 @@ struct ListTask {
 Future<kvstore::ReadResult> TsGrpcKeyValueStore::Read(Key key,
                                                       ReadOptions options) {
   grpc_read.Increment();
+  if (options.batch) {
+    auto [promise, future] = PromiseFuturePair<kvstore::ReadResult>::Make();
+    BatchReadTask::MakeRequest<BatchReadTask>(
+        *this, options.batch, options.staleness_bound,
+        BatchReadTask::Request{{std::move(promise), options.byte_range},
+                               std::move(key),
+                               std::move(options.generation_conditions)});
+    return std::move(future);
+  }
   auto task = internal::MakeIntrusivePtr<ReadTask>();
   task->driver = internal::IntrusivePtr<TsGrpcKeyValueStore>(this);
   return task->Start(std::move(key), options);
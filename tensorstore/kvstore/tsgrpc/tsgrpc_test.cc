@@ -74,6 +74,7 @@ class TsGrpcMockTest : public testing::Test {
     ON_CALL(mock(), Read).WillByDefault(Return(grpc::Status::CANCELLED));
     ON_CALL(mock(), Write).WillByDefault(Return(grpc::Status::CANCELLED));
     ON_CALL(mock(), Delete).WillByDefault(Return(grpc::Status::CANCELLED));
+    ON_CALL(mock(), BatchRead).WillByDefault(Return(grpc::Status::CANCELLED));
     ON_CALL(mock(), List).WillByDefault(Return(grpc::Status::CANCELLED));
   }
 
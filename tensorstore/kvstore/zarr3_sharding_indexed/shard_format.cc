@@ -233,8 +233,9 @@ Result<std::optional<absl::Cord>> EncodeShard(
     const ShardIndexParameters& shard_index_parameters) {
   int64_t shard_index_size =
       shard_index_parameters.index_codec_state->encoded_size();
+  // The entries are appended by reference rather than copied into a flat
+  // buffer, so that the encoded shard shares its memory with `entries`.
   absl::Cord shard_data;
-  riegeli::CordWriter writer{&shard_data};
   auto shard_index_array = AllocateArray<uint64_t>(
       shard_index_parameters.index_shape, c_order, default_init);
   bool has_entry = false;
@@ -251,7 +252,7 @@ Result<std::optional<absl::Cord>> EncodeShard(
       length = entry->size();
       entry_offset = offset;
       offset += length;
-      ABSL_CHECK(writer.Write(*entry));
+      shard_data.Append(*entry);
     } else {
       entry_offset = std::numeric_limits<uint64_t>::max();
       length = std::numeric_limits<uint64_t>::max();
@@ -260,26 +261,19 @@ Result<std::optional<absl::Cord>> EncodeShard(
     shard_index_array.data()[i * 2 + 1] = length;
   }
   if (!has_entry) return std::nullopt;
+  absl::Cord encoded_shard_index;
+  riegeli::CordWriter index_writer{&encoded_shard_index};
+  TENSORSTORE_RETURN_IF_ERROR(EncodeShardIndex(
+      index_writer, ShardIndex{std::move(shard_index_array)},
+      shard_index_parameters));
+  ABSL_CHECK(index_writer.Close());
   switch (shard_index_parameters.index_location) {
-    case ShardIndexLocation::kStart: {
-      ABSL_CHECK(writer.Close());
-      absl::Cord encoded_shard_index;
-      riegeli::CordWriter index_writer{&encoded_shard_index};
-      TENSORSTORE_RETURN_IF_ERROR(EncodeShardIndex(
-          index_writer, ShardIndex{std::move(shard_index_array)},
-          shard_index_parameters));
-      ABSL_CHECK(index_writer.Close());
-      encoded_shard_index.Append(std::move(shard_data));
-      shard_data = std::move(encoded_shard_index);
+    case ShardIndexLocation::kStart:
+      shard_data.Prepend(std::move(encoded_shard_index));
       break;
-    }
-    case ShardIndexLocation::kEnd: {
-      TENSORSTORE_RETURN_IF_ERROR(
-          EncodeShardIndex(writer, ShardIndex{std::move(shard_index_array)},
-                           shard_index_parameters));
-      ABSL_CHECK(writer.Close());
+    case ShardIndexLocation::kEnd:
+      shard_data.Append(std::move(encoded_shard_index));
       break;
-    }
   }
   return shard_data;
 }
@@ -163,10 +163,8 @@ class ShardIndexCache
     using OwningCache = ShardIndexCache;
 
     size_t ComputeReadDataSizeInBytes(const void* read_data) override {
-      const auto& cache = GetOwningCache(*this);
-      return read_data
-                 ? cache.shard_index_params().num_entries * sizeof(uint64_t) * 2
-                 : 0;
+      const auto& entries = static_cast<const ReadData*>(read_data)->entries;
+      return entries.num_elements() * sizeof(uint64_t);
     }
 
     std::string GetKeyValueStoreKey() override {
@@ -800,6 +798,9 @@ class ShardedKeyValueStore
 
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
+  /// Obtains the size of the entry from the shard index.
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
   Future<TimestampedStorageGeneration> Write(Key key,
@@ -1162,6 +1163,50 @@ Future<kvstore::ReadResult> ShardedKeyValueStore::Read(Key key,
   return std::move(future);
 }
 
+Future<kvstore::StatResult> ShardedKeyValueStore::Stat(Key key,
+                                                       StatOptions options) {
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      EntryId entry_id,
+      KeyToEntryIdOrError(key, shard_index_params().grid_shape()));
+  auto entry = GetCacheEntry(shard_index_cache(), std::string_view{});
+  auto future = entry->Read({options.staleness_bound, options.batch});
+  return MapFuture(
+      InlineExecutor{},
+      [entry = std::move(entry), entry_id,
+       generation_conditions = std::move(options.generation_conditions)](
+          const Result<void>& result) -> Result<kvstore::StatResult> {
+        TENSORSTORE_RETURN_IF_ERROR(result);
+        std::shared_ptr<const ShardIndex> shard_index;
+        kvstore::StatResult stat_result;
+        {
+          auto lock =
+              internal::AsyncCache::ReadLock<ShardIndexCache::ReadData>(
+                  *entry);
+          stat_result.stamp = lock.stamp();
+          shard_index = lock.shared_data();
+        }
+        if (!shard_index) {
+          stat_result.state = kvstore::StatResult::State::kMissing;
+          return stat_result;
+        }
+        if (!generation_conditions.Matches(stat_result.stamp.generation)) {
+          return stat_result;
+        }
+        const auto index_entry = (*shard_index)[entry_id];
+        if (index_entry.IsMissing()) {
+          stat_result.state = kvstore::StatResult::State::kMissing;
+          return stat_result;
+        }
+        TENSORSTORE_RETURN_IF_ERROR(
+            index_entry.Validate(entry_id),
+            entry->AnnotateError(_, /*reading=*/true));
+        stat_result.state = kvstore::StatResult::State::kValue;
+        stat_result.size = static_cast<int64_t>(index_entry.length);
+        return stat_result;
+      },
+      std::move(future));
+}
+
 // Asynchronous operation state for `ShardedKeyValueStore::ListImpl`.
 struct ListOperationState
     : public internal::FlowSenderOperationState<kvstore::ListEntry> {
@@ -1284,8 +1329,10 @@ std::string ShardedKeyValueStore::DescribeKey(std::string_view key) {
 
 kvstore::SupportedFeatures ShardedKeyValueStore::GetSupportedFeatures(
     const KeyRange& key_range) const {
+  // Entries are rewritten as part of the entire shard.
   return base_kvstore_driver()->GetSupportedFeatures(
-      KeyRange::Singleton(base_kvstore_path()));
+             KeyRange::Singleton(base_kvstore_path())) &
+         ~kvstore::SupportedFeatures::kByteRangeWrite;
 }
 
 Result<KvStore> ShardedKeyValueStore::GetBase(
@@ -46,6 +46,7 @@
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 
 // specializations
@@ -148,53 +149,76 @@ struct ReadDirectoryOp
       return;
     }
 
-    // Issue a read of the directory.
+    // Issue reads of the directory, split into ranges of at most
+    // `max_directory_read_size_` bytes which are read concurrently.
     kvstore::ReadOptions other_options = options_;
     other_options.generation_conditions.if_equal =
         ready.value().stamp.generation;
-    other_options.byte_range = OptionalByteRangeRequest::Range(
-        eocd_.cd_offset, eocd_.cd_offset + eocd_.cd_size);
 
     auto& cache = internal::GetOwningCache(*entry_);
-    auto future =
-        cache.kvstore_driver_->Read(std::string(entry_->key()), other_options);
-    future.Force();
-    future.ExecuteWhenReady(
-        [self = internal::IntrusivePtr<ReadDirectoryOp>(this)](
-            ReadyFuture<kvstore::ReadResult> ready) {
-          self->OnDirectoryBlockRead(std::move(ready));
-        });
+    const int64_t read_size =
+        std::max<int64_t>(1, cache.max_directory_read_size_);
+    const int64_t cd_end = eocd_.cd_offset + eocd_.cd_size;
+    std::vector<Future<kvstore::ReadResult>> futures;
+    int64_t offset = eocd_.cd_offset;
+    do {
+      other_options.byte_range = OptionalByteRangeRequest::Range(
+          offset, std::min(offset + read_size, cd_end));
+      auto future = cache.kvstore_driver_->Read(std::string(entry_->key()),
+                                                other_options);
+      future.Force();
+      futures.push_back(std::move(future));
+      offset += read_size;
+    } while (offset < cd_end);
+    WaitAllFuture(span<Future<kvstore::ReadResult>>(futures))
+        .ExecuteWhenReady(
+            [self = internal::IntrusivePtr<ReadDirectoryOp>(this),
+             futures](ReadyFuture<void> ready) mutable {
+              self->OnDirectoryBlocksRead(std::move(ready),
+                                          std::move(futures));
+            });
   }
 
-  void OnDirectoryBlockRead(ReadyFuture<kvstore::ReadResult> ready) {
-    auto& r = ready.result();
-    if (!r.ok()) {
-      ABSL_LOG_IF(INFO, zip_logging) << r.status();
+  void OnDirectoryBlocksRead(ReadyFuture<void> ready,
+                             std::vector<Future<kvstore::ReadResult>> futures) {
+    if (!ready.result().ok()) {
+      ABSL_LOG_IF(INFO, zip_logging) << ready.status();
       entry_->ReadError(
-          internal::ConvertInvalidArgumentToFailedPrecondition(r.status()));
+          internal::ConvertInvalidArgumentToFailedPrecondition(ready.status()));
       return;
     }
 
-    auto& read_result = *r;
-    if (read_result.aborted() || read_result.not_found() ||
-        !ready.value().has_value()) {
-      // Any non-value is an error.
-      entry_->ReadError(
-          absl::InvalidArgumentError("Faild to read ZIP directory"));
-      return;
+    absl::Cord cd_block;
+    TimestampedStorageGeneration stamp;
+    for (auto& future : futures) {
+      auto& read_result = future.value();
+      if (read_result.aborted() || read_result.not_found() ||
+          !read_result.has_value()) {
+        // Any non-value is an error.
+        entry_->ReadError(
+            absl::InvalidArgumentError("Faild to read ZIP directory"));
+        return;
+      }
+      cd_block.Append(std::move(read_result.value));
+      stamp = std::move(read_result.stamp);
     }
 
     GetOwningCache(*entry_).executor()(
         [self = internal::IntrusivePtr<ReadDirectoryOp>(this),
-         ready = std::move(ready)]() {
-          self->DoDecodeDirectory(std::move(ready), 0);
+         cd_block = std::move(cd_block), stamp = std::move(stamp)]() mutable {
+          self->DoDecodeDirectory(std::move(cd_block), std::move(stamp), 0);
         });
   }
 
   void DoDecodeDirectory(ReadyFuture<kvstore::ReadResult> ready,
                          size_t seek_pos) {
-    absl::Cord* cd_block = &ready.value().value;
-    riegeli::CordReader<absl::Cord*> reader(cd_block);
+    DoDecodeDirectory(std::move(ready.value().value),
+                      std::move(ready.value().stamp), seek_pos);
+  }
+
+  void DoDecodeDirectory(absl::Cord cd_block,
+                         TimestampedStorageGeneration stamp, size_t seek_pos) {
+    riegeli::CordReader<absl::Cord*> reader(&cd_block);
     if (seek_pos > 0) {
       reader.Seek(seek_pos);
     }
@@ -240,14 +264,13 @@ struct ReadDirectoryOp
     std::sort(dir.entries.begin(), dir.entries.end(),
               [](const auto& a, const auto& b) {
                 return std::tie(a.filename, a.local_header_offset) <
-                       std::tie(b.filename, a.local_header_offset);
+                       std::tie(b.filename, b.local_header_offset);
               });
 
     ABSL_LOG_IF(INFO, zip_logging) << dir;
 
     entry_->ReadSuccess(ZipDirectoryCache::ReadState{
-        std::make_shared<const Directory>(std::move(dir)),
-        std::move(ready.value().stamp)});
+        std::make_shared<const Directory>(std::move(dir)), std::move(stamp)});
   }
 };
 
@@ -80,6 +80,9 @@ struct Directory {
   }
 };
 
+/// Default value of `ZipDirectoryCache::max_directory_read_size_`.
+constexpr size_t kDefaultMaxDirectoryReadSize = 16 * 1024 * 1024;
+
 /// Cache used for reading the ZIP directory.
 class ZipDirectoryCache : public internal::AsyncCache {
   using Base = internal::AsyncCache;
@@ -111,6 +114,11 @@ class ZipDirectoryCache : public internal::AsyncCache {
   kvstore::DriverPtr kvstore_driver_;
   Executor executor_;
 
+  // Maximum size of each byte range read of the central directory.  Larger
+  // directories, such as those of ZIP64 files with millions of entries, are
+  // read using several concurrent requests.
+  size_t max_directory_read_size_ = kDefaultMaxDirectoryReadSize;
+
   const Executor& executor() { return executor_; }
 };
 
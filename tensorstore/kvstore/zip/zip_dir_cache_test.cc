@@ -14,6 +14,8 @@
 
 #include "tensorstore/kvstore/zip/zip_dir_cache.h"
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 #include <string_view>
@@ -25,6 +27,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "riegeli/bytes/fd_reader.h"
 #include "riegeli/bytes/read_all.h"
@@ -195,4 +198,98 @@ TEST(ZipDirectoryKvsTest, MinimalZip) {
   EXPECT_THAT(dir->entries[1].filename, "testdir/test2");
 }
 
+// Returns a ZIP file containing `num_entries` empty stored entries.
+absl::Cord MakeZipWithEmptyEntries(int num_entries) {
+  std::string local_headers;
+  std::string central_directory;
+  const auto append16 = [](std::string& out, uint16_t x) {
+    out.push_back(static_cast<char>(x & 0xff));
+    out.push_back(static_cast<char>(x >> 8));
+  };
+  const auto append32 = [&](std::string& out, uint32_t x) {
+    append16(out, x & 0xffff);
+    append16(out, x >> 16);
+  };
+  for (int i = 0; i < num_entries; ++i) {
+    const std::string filename = absl::StrFormat("%06d", i);
+    const uint32_t local_header_offset = local_headers.size();
+
+    append32(local_headers, 0x04034b50);
+    append16(local_headers, 10);  // version needed
+    append16(local_headers, 0);   // flags
+    append16(local_headers, 0);   // compression method
+    append32(local_headers, 0);   // time and date
+    append32(local_headers, 0);   // crc
+    append32(local_headers, 0);   // compressed size
+    append32(local_headers, 0);   // uncompressed size
+    append16(local_headers, filename.size());
+    append16(local_headers, 0);  // extra field length
+    local_headers += filename;
+
+    append32(central_directory, 0x02014b50);
+    append16(central_directory, 0x031e);  // version made by
+    append16(central_directory, 10);      // version needed
+    append16(central_directory, 0);       // flags
+    append16(central_directory, 0);       // compression method
+    append32(central_directory, 0);       // time and date
+    append32(central_directory, 0);       // crc
+    append32(central_directory, 0);       // compressed size
+    append32(central_directory, 0);       // uncompressed size
+    append16(central_directory, filename.size());
+    append16(central_directory, 0);  // extra field length
+    append16(central_directory, 0);  // comment length
+    append16(central_directory, 0);  // disk number
+    append16(central_directory, 0);  // internal attributes
+    append32(central_directory, 0);  // external attributes
+    append32(central_directory, local_header_offset);
+    central_directory += filename;
+  }
+  std::string eocd;
+  append32(eocd, 0x06054b50);
+  append16(eocd, 0);  // disk number
+  append16(eocd, 0);  // central directory disk number
+  append16(eocd, num_entries);
+  append16(eocd, num_entries);
+  append32(eocd, central_directory.size());
+  append32(eocd, local_headers.size());
+  append16(eocd, 0);  // comment length
+  return absl::Cord(local_headers + central_directory + eocd);
+}
+
+// A central directory larger than the block read to locate it is read using
+// several concurrent byte range requests.
+TEST(ZipDirectoryKvsTest, LargeDirectory) {
+  auto context = Context::Default();
+  auto pool = CachePool::Make(CachePool::Limits{});
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      tensorstore::KvStore memory,
+      tensorstore::kvstore::Open({{"driver", "memory"}}, context).result());
+
+  constexpr int kNumEntries = 5000;
+  ASSERT_THAT(tensorstore::kvstore::Write(memory, "data.zip",
+                                          MakeZipWithEmptyEntries(kNumEntries))
+                  .result(),
+              ::tensorstore::IsOk());
+
+  auto cache = GetCache<ZipDirectoryCache>(pool.get(), "", [&] {
+    auto cache =
+        std::make_unique<ZipDirectoryCache>(memory.driver, InlineExecutor{});
+    cache->max_directory_read_size_ = 10000;
+    return cache;
+  });
+
+  auto entry = GetCacheEntry(cache, "data.zip");
+  auto status = entry->Read({absl::InfinitePast()}).status();
+  ASSERT_THAT(status, ::tensorstore::IsOk());
+
+  ZipDirectoryCache::ReadLock<ZipDirectoryCache::ReadData> lock(*entry);
+  auto* dir = lock.data();
+  ASSERT_THAT(dir, ::testing::NotNull());
+  ASSERT_THAT(dir->entries, ::testing::SizeIs(kNumEntries));
+  for (int i = 0; i < kNumEntries; ++i) {
+    EXPECT_EQ(absl::StrFormat("%06d", i), dir->entries[i].filename);
+  }
+}
+
 }  // namespace
@@ -16,16 +16,25 @@
 
 #include <algorithm>
 #include <cassert>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
@@ -43,6 +52,7 @@
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_ahead_scan.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
 #include "tensorstore/kvstore/spec.h"
@@ -80,14 +90,27 @@ ABSL_CONST_INIT internal_log::VerboseFlag zip_logging("zip");
 
 // -----------------------------------------------------------------------------
 
+using ::tensorstore::internal_zip::ZipCompression;
+
+constexpr auto ZipCompressionJsonBinder = [](auto is_loading,
+                                             const auto& options, auto* obj,
+                                             auto* j) {
+  return jb::Enum<ZipCompression, const char*>({
+      {ZipCompression::kStore, "store"},
+      {ZipCompression::kDeflate, "deflate"},
+  })(is_loading, options, obj, j);
+};
+
 struct ZipKvStoreSpecData {
   kvstore::Spec base;
   Context::Resource<internal::CachePoolResource> cache_pool;
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency;
+  // Compression method of written entries.
+  ZipCompression compression = ZipCompression::kStore;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.base, x.cache_pool, x.data_copy_concurrency);
+    return f(x.base, x.cache_pool, x.data_copy_concurrency, x.compression);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -96,7 +119,12 @@ struct ZipKvStoreSpecData {
                  jb::Projection<&ZipKvStoreSpecData::cache_pool>()),
       jb::Member(
           internal::DataCopyConcurrencyResource::id,
-          jb::Projection<&ZipKvStoreSpecData::data_copy_concurrency>()) /**/
+          jb::Projection<&ZipKvStoreSpecData::data_copy_concurrency>()),
+      jb::Member("compression",
+                 jb::Projection<&ZipKvStoreSpecData::compression>(
+                     jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                         [](auto* v) { *v = ZipCompression::kStore; },
+                         ZipCompressionJsonBinder))) /**/
   );
 };
 
@@ -117,12 +145,31 @@ class ZipKvStoreSpec
   }
 };
 
+/// Write to a `ZipKvStore` that has not yet been committed.
+struct PendingWrite {
+  kvstore::Key key;
+  std::optional<absl::Cord> value;
+  StorageGeneration if_equal;
+  Promise<TimestampedStorageGeneration> promise;
+};
+
 /// Defines the "zip" key value store.
+///
+/// Writes rewrite the central directory of the archive stored in the base
+/// kvstore, appending the new entries after the existing ones.  Writes issued
+/// while a rewrite is in progress are grouped into the next rewrite.
 class ZipKvStore
     : public internal_kvstore::RegisteredDriver<ZipKvStore, ZipKvStoreSpec> {
  public:
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
+  /// Obtains the size of the entry from the central directory.
+  Future<StatResult> Stat(Key key, StatOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override;
+
   std::string DescribeKey(std::string_view key) override {
     return tensorstore::StrCat(QuoteString(key), " in ",
                                base_.driver->DescribeKey(base_.path));
@@ -130,6 +177,14 @@ class ZipKvStore
 
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
+  /// The central directory is sorted by filename, such that the entries may be
+  /// read while the directory is being listed.
+  void ScanImpl(ScanOptions options, ScanReceiver receiver) override {
+    internal_kvstore::ReadAheadScan(kvstore::DriverPtr(this),
+                                    std::move(options), std::move(receiver),
+                                    /*ordered_list=*/true);
+  }
+
   absl::Status GetBoundSpecData(ZipKvStoreSpecData& spec) const {
     spec = spec_data_;
     return absl::OkStatus();
@@ -137,7 +192,10 @@ class ZipKvStore
 
   kvstore::SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
-    return base_.driver->GetSupportedFeatures(KeyRange::Singleton(base_.path));
+    // Entries are read-only views of the archive.
+    return base_.driver->GetSupportedFeatures(
+               KeyRange::Singleton(base_.path)) &
+           ~kvstore::SupportedFeatures::kByteRangeWrite;
   }
 
   Result<KvStore> GetBase(std::string_view path,
@@ -149,9 +207,19 @@ class ZipKvStore
     return spec_data_.data_copy_concurrency->executor;
   }
 
+  // Starts a rewrite of the archive applying `pending_writes_`.
+  void StartCommit();
+
+  // Called when a rewrite completes, starts the next rewrite if necessary.
+  void FinishCommit();
+
   ZipKvStoreSpecData spec_data_;
   kvstore::KvStore base_;
   internal::PinnedCacheEntry<ZipDirectoryCache> cache_entry_;
+
+  absl::Mutex write_mutex_;
+  std::vector<PendingWrite> pending_writes_ ABSL_GUARDED_BY(write_mutex_);
+  bool commit_in_progress_ ABSL_GUARDED_BY(write_mutex_) = false;
 };
 
 Future<kvstore::DriverPtr> ZipKvStoreSpec::DoOpen() const {
@@ -238,6 +306,9 @@ struct ReadState : public internal::AtomicReferenceCount<ReadState> {
     }
 
     options.generation_conditions.if_equal = stamp.generation;
+    // Issuing the entry read as part of the original batch allows the base
+    // kvstore to coalesce reads of neighboring entries.
+    options.batch = std::move(options_.batch);
     Link(WithExecutor(owner_->executor(),
                       [self = internal::IntrusivePtr<ReadState>(this),
                        seek_pos](Promise<kvstore::ReadResult> promise,
@@ -321,6 +392,259 @@ Future<kvstore::ReadResult> ZipKvStore::Read(Key key, ReadOptions options) {
       .future;
 }
 
+Future<kvstore::StatResult> ZipKvStore::Stat(Key key, StatOptions options) {
+  return MapFuture(
+      InlineExecutor{},
+      [self = internal::IntrusivePtr<ZipKvStore>(this), key = std::move(key),
+       generation_conditions = std::move(options.generation_conditions)](
+          const Result<void>& result) -> Result<kvstore::StatResult> {
+        TENSORSTORE_RETURN_IF_ERROR(result);
+        kvstore::StatResult stat_result;
+        ZipDirectoryCache::ReadLock<ZipDirectoryCache::ReadData> lock(
+            *(self->cache_entry_));
+        stat_result.stamp = lock.stamp();
+        assert(lock.data());
+        const ZipDirectoryCache::ReadData& dir = *lock.data();
+        auto it = std::lower_bound(
+            dir.entries.begin(), dir.entries.end(), key,
+            [](const auto& e, const std::string& k) { return e.filename < k; });
+        if (it == dir.entries.end() || it->filename != key) {
+          stat_result.state = kvstore::StatResult::State::kMissing;
+          return stat_result;
+        }
+        if (!generation_conditions.Matches(stat_result.stamp.generation)) {
+          return stat_result;
+        }
+        stat_result.state = kvstore::StatResult::State::kValue;
+        stat_result.size =
+            kvstore::ListEntry::checked_size(it->uncompressed_size);
+        return stat_result;
+      },
+      cache_entry_->Read({options.staleness_bound}));
+}
+
+// Reads the central directory of the archive `data`, returning the entries
+// and setting `prefix` to the data preceding the central directory.
+absl::Status DecodeCentralDirectory(
+    const absl::Cord& data, absl::Cord& prefix,
+    std::map<std::string, internal_zip::ZipEntry>& entries) {
+  riegeli::CordReader reader(&data);
+  internal_zip::ZipEOCD eocd{};
+  auto result = internal_zip::TryReadFullEOCD(reader, eocd, 0);
+  if (auto* status = std::get_if<absl::Status>(&result)) {
+    TENSORSTORE_RETURN_IF_ERROR(*status);
+  } else {
+    // The EOCD64 is always available when reading the entire file.
+    return absl::DataLossError("Failed to read ZIP64 End of Central Directory");
+  }
+  if (!reader.Seek(eocd.cd_offset)) {
+    return absl::DataLossError("Failed to read ZIP Central Directory");
+  }
+  for (uint64_t i = 0; i < eocd.num_entries; ++i) {
+    internal_zip::ZipEntry entry{};
+    TENSORSTORE_RETURN_IF_ERROR(
+        internal_zip::ReadCentralDirectoryEntry(reader, entry));
+    std::string filename = entry.filename;
+    entries.insert_or_assign(std::move(filename), std::move(entry));
+  }
+  prefix = data.Subcord(0, eocd.cd_offset);
+  return absl::OkStatus();
+}
+
+// Implements ZipKvStore::Write
+//
+// Each commit reads the entire archive, appends the written entries after the
+// existing entries, and writes a new central directory which omits the
+// overwritten and deleted entries.  The archive is written conditioned on the
+// generation that was read, and the commit is retried if it was modified
+// concurrently.
+struct CommitState : public internal::AtomicReferenceCount<CommitState> {
+  internal::IntrusivePtr<ZipKvStore> owner_;
+  std::vector<PendingWrite> writes_;
+
+  void ReadArchive() {
+    kvstore::ReadOptions options;
+    options.staleness_bound = absl::Now();
+    kvstore::Read(owner_->base_, {}, std::move(options))
+        .ExecuteWhenReady(WithExecutor(
+            owner_->executor(),
+            [self = internal::IntrusivePtr<CommitState>(this)](
+                ReadyFuture<kvstore::ReadResult> ready) {
+              self->OnArchiveRead(ready.result());
+            }));
+  }
+
+  void OnArchiveRead(const Result<kvstore::ReadResult>& read_result) {
+    if (!read_result.ok()) {
+      Fail(read_result.status());
+      return;
+    }
+    const auto& stamp = read_result->stamp;
+    auto archive = EncodeArchive(*read_result);
+    if (!archive.ok()) {
+      Fail(MaybeAnnotateStatus(archive.status(),
+                               tensorstore::StrCat(
+                                   "Failed to write ",
+                                   owner_->base_.driver->DescribeKey(
+                                       owner_->base_.path))));
+      return;
+    }
+    if (!*archive) {
+      // No writes modify the archive.
+      Finish(stamp);
+      return;
+    }
+    kvstore::WriteOptions options;
+    options.generation_conditions.if_equal = stamp.generation;
+    kvstore::Write(owner_->base_, {}, std::move(**archive), std::move(options))
+        .ExecuteWhenReady(WithExecutor(
+            owner_->executor(),
+            [self = internal::IntrusivePtr<CommitState>(this)](
+                ReadyFuture<TimestampedStorageGeneration> ready) {
+              self->OnArchiveWritten(ready.result());
+            }));
+  }
+
+  // Applies `writes_` to the archive in `read_result`.
+  //
+  // Writes whose conditions do not match are completed and removed.  Returns
+  // `std::nullopt` if no write modifies the archive.
+  Result<std::optional<absl::Cord>> EncodeArchive(
+      const kvstore::ReadResult& read_result) {
+    const auto& stamp = read_result.stamp;
+    absl::Cord prefix;
+    std::map<std::string, internal_zip::ZipEntry> entries;
+    if (read_result.has_value()) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          DecodeCentralDirectory(read_result.value, prefix, entries));
+    }
+
+    absl::Cord archive;
+    riegeli::CordWriter<> writer(&archive);
+    writer.Write(std::move(prefix));
+    const absl::Time mtime = absl::Now();
+    bool modified = false;
+    for (auto& write : writes_) {
+      auto it = entries.find(write.key);
+      const bool matches =
+          StorageGeneration::IsUnknown(write.if_equal) ||
+          (StorageGeneration::IsNoValue(write.if_equal)
+               ? it == entries.end()
+               : write.if_equal == stamp.generation);
+      if (!matches) {
+        write.promise.SetResult(TimestampedStorageGeneration{
+            StorageGeneration::Unknown(), stamp.time});
+        write.promise = {};
+        continue;
+      }
+      if (!write.value) {
+        if (it != entries.end()) {
+          entries.erase(it);
+          modified = true;
+        }
+        continue;
+      }
+      internal_zip::ZipEntry entry{};
+      entry.compression_method = owner_->spec_data_.compression;
+      entry.mtime = mtime;
+      entry.filename = write.key;
+      entry.external_fa = 0100644 << 16;  // Regular file, rw-r--r--.
+      entry.local_header_offset = writer.pos();
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto encoded, internal_zip::EncodeEntryData(*write.value, entry));
+      TENSORSTORE_RETURN_IF_ERROR(internal_zip::WriteLocalEntry(writer, entry));
+      writer.Write(std::move(encoded));
+      entries.insert_or_assign(write.key, std::move(entry));
+      modified = true;
+    }
+    writes_.erase(std::remove_if(writes_.begin(), writes_.end(),
+                                 [](const PendingWrite& write) {
+                                   return write.promise.null();
+                                 }),
+                  writes_.end());
+    if (!modified) return std::nullopt;
+
+    internal_zip::ZipEOCD eocd{};
+    eocd.num_entries = entries.size();
+    eocd.cd_offset = writer.pos();
+    for (const auto& [filename, entry] : entries) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          internal_zip::WriteCentralDirectoryEntry(writer, entry));
+    }
+    eocd.cd_size = writer.pos() - eocd.cd_offset;
+    TENSORSTORE_RETURN_IF_ERROR(internal_zip::WriteEOCD(writer, eocd));
+    if (!writer.Close()) return writer.status();
+    return archive;
+  }
+
+  void OnArchiveWritten(const Result<TimestampedStorageGeneration>& result) {
+    if (!result.ok()) {
+      Fail(result.status());
+      return;
+    }
+    if (StorageGeneration::IsUnknown(result->generation)) {
+      // The archive was modified concurrently; retry.
+      ReadArchive();
+      return;
+    }
+    Finish(*result);
+  }
+
+  void Finish(const TimestampedStorageGeneration& stamp) {
+    for (auto& write : writes_) {
+      write.promise.SetResult(stamp);
+    }
+    writes_.clear();
+    owner_->FinishCommit();
+  }
+
+  void Fail(const absl::Status& status) {
+    for (auto& write : writes_) {
+      write.promise.SetResult(status);
+    }
+    writes_.clear();
+    owner_->FinishCommit();
+  }
+};
+
+Future<TimestampedStorageGeneration> ZipKvStore::Write(
+    Key key, std::optional<Value> value, WriteOptions options) {
+  auto [promise, future] =
+      PromiseFuturePair<TimestampedStorageGeneration>::Make();
+  bool start_commit;
+  {
+    absl::MutexLock lock(&write_mutex_);
+    pending_writes_.push_back(
+        PendingWrite{std::move(key), std::move(value),
+                     std::move(options.generation_conditions.if_equal),
+                     std::move(promise)});
+    start_commit = !std::exchange(commit_in_progress_, true);
+  }
+  if (start_commit) StartCommit();
+  return std::move(future);
+}
+
+void ZipKvStore::StartCommit() {
+  auto state = internal::MakeIntrusivePtr<CommitState>();
+  state->owner_ = internal::IntrusivePtr<ZipKvStore>(this);
+  {
+    absl::MutexLock lock(&write_mutex_);
+    state->writes_ = std::exchange(pending_writes_, {});
+  }
+  state->ReadArchive();
+}
+
+void ZipKvStore::FinishCommit() {
+  {
+    absl::MutexLock lock(&write_mutex_);
+    if (pending_writes_.empty()) {
+      commit_in_progress_ = false;
+      return;
+    }
+  }
+  StartCommit();
+}
+
 // Implements ZipKvStore::List
 struct ListState : public internal::AtomicReferenceCount<ListState> {
   internal::IntrusivePtr<ZipKvStore> owner_;
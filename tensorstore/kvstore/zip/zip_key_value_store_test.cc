@@ -26,15 +26,18 @@
 #include <nlohmann/json.hpp>
 #include "riegeli/bytes/fd_reader.h"
 #include "riegeli/bytes/read_all.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/mock_kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/execution/sender_testutil.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
 
@@ -167,6 +170,119 @@ TEST_F(ZipKeyValueStoreTest, Simple) {
   }
 }
 
+TEST_F(ZipKeyValueStoreTest, BatchRead) {
+  auto mock_key_value_store_resource =
+      context_.GetResource<tensorstore::internal::MockKeyValueStoreResource>()
+          .value();
+  auto mock_key_value_store = *mock_key_value_store_resource;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      mock_key_value_store->forward_to,
+      kvstore::Open({{"driver", "memory"}}, context_).result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(mock_key_value_store->forward_to,
+                                       "data.zip", GetTestZipFileData())
+                            .result());
+  mock_key_value_store->log_requests = true;
+  mock_key_value_store->handle_batch_requests = true;
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "zip"},
+                     {"base",
+                      {{"driver", "mock_key_value_store"},
+                       {"path", "data.zip"}}}},
+                    context_)
+          .result());
+
+  // Entry reads that are part of the same batch are issued to the base
+  // kvstore as a single batch, such that they may be coalesced.
+  std::vector<tensorstore::Future<kvstore::ReadResult>> futures;
+  {
+    auto batch = tensorstore::Batch::New();
+    kvstore::ReadOptions options;
+    options.batch = batch;
+    for (const char* key : {"data/a.png", "data/bb.png"}) {
+      futures.push_back(kvstore::Read(store, key, options));
+    }
+  }
+  for (auto& future : futures) {
+    TENSORSTORE_ASSERT_OK(future.result());
+  }
+  EXPECT_EQ(106351, futures[1].value().value.size());
+
+  std::vector<::nlohmann::json> batch_reads;
+  for (auto& entry : mock_key_value_store->request_log.pop_all()) {
+    if (entry["type"] == "batch_read") batch_reads.push_back(entry);
+  }
+  ASSERT_EQ(1, batch_reads.size());
+  EXPECT_EQ(2, batch_reads[0]["requests"].size());
+}
+
+TEST_F(ZipKeyValueStoreTest, WriteRead) {
+  PrepareMemoryKvstore(GetTestZipFileData());
+  for (const char* compression : {"store", "deflate"}) {
+    SCOPED_TRACE(compression);
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto store,
+        kvstore::Open({{"driver", "zip"},
+                       {"base", {{"driver", "memory"}, {"path", "data.zip"}}},
+                       {"compression", compression}},
+                      context_)
+            .result());
+
+    // Concurrent writes are grouped.
+    std::vector<tensorstore::Future<tensorstore::TimestampedStorageGeneration>>
+        futures;
+    futures.push_back(kvstore::Write(store, "x", absl::Cord("xyz")));
+    futures.push_back(kvstore::Write(store, "y", absl::Cord("abc")));
+    futures.push_back(kvstore::Write(store, "x", absl::Cord("xxx")));
+    for (auto& future : futures) {
+      TENSORSTORE_ASSERT_OK(future.result());
+    }
+
+    EXPECT_THAT(kvstore::Read(store, "x").result(),
+                MatchesKvsReadResult(absl::Cord("xxx")));
+    EXPECT_THAT(kvstore::Read(store, "y").result(),
+                MatchesKvsReadResult(absl::Cord("abc")));
+
+    // Existing entries are retained.
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result,
+                                     kvstore::Read(store, "data/bb.png")
+                                         .result());
+    EXPECT_EQ(106351, read_result.value.size());
+
+    TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "y").result());
+    EXPECT_THAT(kvstore::Read(store, "y").result(),
+                MatchesKvsReadResultNotFound());
+  }
+}
+
+TEST_F(ZipKeyValueStoreTest, WriteNewArchive) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "zip"},
+                     {"base", {{"driver", "memory"}, {"path", "new.zip"}}}},
+                    context_)
+          .result());
+
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal =
+      tensorstore::StorageGeneration::NoValue();
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, "key", absl::Cord("value"), options).result());
+
+  // The condition no longer matches.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp,
+      kvstore::Write(store, "key", absl::Cord("other"), options).result());
+  EXPECT_TRUE(tensorstore::StorageGeneration::IsUnknown(stamp.generation));
+
+  EXPECT_THAT(kvstore::Read(store, "key").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  EXPECT_THAT(tensorstore::kvstore::ListFuture(store).result(),
+              ::tensorstore::IsOkAndHolds(::testing::ElementsAre(
+                  ::testing::Field(&kvstore::ListEntry::key, "key"))));
+}
+
 TEST_F(ZipKeyValueStoreTest, ReadOps) {
   PrepareMemoryKvstore(GetReadOpZip());
 
@@ -58,6 +58,10 @@ std::ostream& operator<<(std::ostream& os, OpenMode mode) {
     os << sep << "assume_metadata";
     sep = kSep;
   }
+  if (!!(mode & OpenMode::defer_validation)) {
+    os << sep << "defer_validation";
+    sep = kSep;
+  }
   return os;
 }
 
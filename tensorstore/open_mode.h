@@ -67,6 +67,17 @@ enum class OpenMode {
   /// This option must be specified in conjunction with `open` and must not be
   /// specified in conjunction with `delete_existing`.
   assume_cached_metadata = 16,
+
+  /// Open the existing metadata without checking it against the constraints
+  /// in the spec.  The checks are instead performed by the first read or
+  /// write, which fails if they are not satisfied.  This is intended for
+  /// specs obtained from a previously-opened TensorStore, which are known to
+  /// be consistent with the stored metadata, and avoids the cost of the checks
+  /// for TensorStores that are opened but never accessed.
+  ///
+  /// Drivers that do not support deferring the checks perform them when
+  /// opening.  This option must be specified in conjunction with `open`.
+  defer_validation = 32,
 };
 
 /// Returns the intersection of two open modes.
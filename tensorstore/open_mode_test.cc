@@ -81,6 +81,8 @@ TEST(OpenTest, PrintToOstream) {
   EXPECT_EQ("open|create", StrCat(OpenMode::open | OpenMode::create));
   EXPECT_EQ("open|assume_metadata",
             StrCat(OpenMode::open | OpenMode::assume_metadata));
+  EXPECT_EQ("open|defer_validation",
+            StrCat(OpenMode::open | OpenMode::defer_validation));
   EXPECT_EQ("create|delete_existing",
             StrCat(OpenMode::create | OpenMode::delete_existing));
 }
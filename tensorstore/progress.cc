@@ -60,4 +60,23 @@ std::ostream& operator<<(std::ostream& os, const CopyProgress& a) {
             << ", committed_elements=" << a.committed_elements << " }";
 }
 
+bool operator==(const IoStatistics& a, const IoStatistics& b) {
+  return a.bytes_requested == b.bytes_requested &&
+         a.bytes_fetched == b.bytes_fetched &&
+         a.bytes_decoded == b.bytes_decoded &&
+         a.bytes_written == b.bytes_written &&
+         a.chunks_touched == b.chunks_touched && a.cache_hits == b.cache_hits;
+}
+bool operator!=(const IoStatistics& a, const IoStatistics& b) {
+  return !(a == b);
+}
+std::ostream& operator<<(std::ostream& os, const IoStatistics& a) {
+  return os << "{ bytes_requested=" << a.bytes_requested
+            << ", bytes_fetched=" << a.bytes_fetched
+            << ", bytes_decoded=" << a.bytes_decoded
+            << ", bytes_written=" << a.bytes_written
+            << ", chunks_touched=" << a.chunks_touched
+            << ", cache_hits=" << a.cache_hits << " }";
+}
+
 }  // namespace tensorstore
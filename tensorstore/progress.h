@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_PROGRESS_H_
 #define TENSORSTORE_PROGRESS_H_
 
+#include <stdint.h>
+
 #include <iosfwd>
 #include <utility>
 
@@ -88,6 +90,42 @@ struct CopyProgress {
   friend std::ostream& operator<<(std::ostream& os, const CopyProgress& a);
 };
 
+/// Specifies the I/O performed on behalf of a single `Read` or `Write`
+/// operation, which may be compared to `bytes_requested` to determine the
+/// amplification due to the chunk and shard layout.
+///
+/// Work shared by concurrent operations, such as a chunk read that is
+/// already in progress, is attributed only to the operation that issued it.
+///
+/// \relates Read[TensorStore, Array]
+struct IoStatistics {
+  /// Number of bytes of array data requested to be read or written.
+  int64_t bytes_requested = 0;
+
+  /// Number of bytes read from the underlying key-value store.
+  int64_t bytes_fetched = 0;
+
+  /// Number of bytes of array data produced by decoding chunks.
+  int64_t bytes_decoded = 0;
+
+  /// Number of bytes written to the underlying key-value store, including
+  /// any rewritten shard data.
+  int64_t bytes_written = 0;
+
+  /// Number of chunks read or written.
+  int64_t chunks_touched = 0;
+
+  /// Number of chunk reads satisfied by the cache without a kvstore read.
+  int64_t cache_hits = 0;
+
+  /// Compares two statistics for equality.
+  friend bool operator==(const IoStatistics& a, const IoStatistics& b);
+  friend bool operator!=(const IoStatistics& a, const IoStatistics& b);
+
+  /// Prints a debugging string representation to an `std::ostream`.
+  friend std::ostream& operator<<(std::ostream& os, const IoStatistics& a);
+};
+
 /// Handle for consuming the result of an asynchronous write operation.
 ///
 /// This holds two futures:
@@ -204,6 +242,20 @@ struct CopyProgressFunction {
   Function value;
 };
 
+/// Specifies a function, for use with `tensorstore::Read` and
+/// `tensorstore::Write`, that is called once with the `IoStatistics` of the
+/// operation when it completes.  For writes, this is when the write is
+/// committed.
+///
+/// \relates IoStatistics
+struct IoStatisticsFunction {
+  /// Type-erased movable function with signature `void (IoStatistics)`.
+  using Function =
+      poly::Poly<sizeof(void*) * 2, /*Copyable=*/false, void(IoStatistics)>;
+
+  Function value;
+};
+
 }  // namespace tensorstore
 
 #endif  // TENSORSTORE_PROGRESS_H_
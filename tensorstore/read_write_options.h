@@ -23,6 +23,8 @@
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/progress.h"
+#include "tensorstore/util/deadline.h"
+#include "tensorstore/util/task_priority.h"
 
 namespace tensorstore {
 
@@ -48,14 +50,32 @@ struct ReadOptions {
 
   void Set(Batch value) { this->batch = std::move(value); }
 
+  void Set(TaskPriority value) { this->priority = value; }
+
+  void Set(Deadline value) { this->deadline = value; }
+
+  void Set(IoStatisticsFunction value) {
+    this->io_statistics_function = std::move(value);
+  }
+
   /// Constrains how the source TensorStore may be aligned to the target array.
   DomainAlignmentOptions alignment_options = DomainAlignmentOptions::all;
 
   /// Optional progress callback.
   ReadProgressFunction progress_function;
 
+  /// Optional callback that receives the I/O statistics on completion.
+  IoStatisticsFunction io_statistics_function;
+
   /// Optional batch.
   Batch batch{no_batch};
+
+  /// Scheduling priority of the tasks that carry out the operation.
+  TaskPriority priority = TaskPriority::kNormal;
+
+  /// The operation fails with `absl::StatusCode::kDeadlineExceeded` if it does
+  /// not complete by this deadline.  Defaults to no deadline.
+  Deadline deadline;
 };
 
 template <>
@@ -70,6 +90,28 @@ constexpr inline bool ReadOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool ReadOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool ReadOptions::IsOption<TaskPriority> = true;
+
+template <>
+constexpr inline bool ReadOptions::IsOption<Deadline> = true;
+
+template <>
+constexpr inline bool ReadOptions::IsOption<IoStatisticsFunction> = true;
+
+/// Specifies whether the array returned by `tensorstore::Read` into a new
+/// array may reference data held by the driver.
+enum ReadResultReferenceRestriction {
+  /// The result is always a newly-allocated array.
+  cannot_reference_cached_data = 0,
+
+  /// If the read is satisfied by a single cached chunk without data type
+  /// conversion, the result may reference the cached chunk data rather than a
+  /// copy of it.  In that case, the layout of the result is that of the cached
+  /// data, and the result must not be modified.
+  can_reference_cached_data_read_only = 1,
+};
+
 /// Options for `tensorstore::Read` into new array.
 ///
 /// \relates Read[TensorStore]
@@ -92,6 +134,18 @@ struct ReadIntoNewArrayOptions {
 
   void Set(Batch value) { this->batch = std::move(value); }
 
+  void Set(TaskPriority value) { this->priority = value; }
+
+  void Set(Deadline value) { this->deadline = value; }
+
+  void Set(ReadResultReferenceRestriction value) {
+    this->result_reference_restriction = value;
+  }
+
+  void Set(IoStatisticsFunction value) {
+    this->io_statistics_function = std::move(value);
+  }
+
   /// Specifies the layout order of the newly-allocated array.  Defaults to
   /// `c_order`.
   ContiguousLayoutOrder layout_order = c_order;
@@ -99,8 +153,23 @@ struct ReadIntoNewArrayOptions {
   /// Optional progress callback.
   ReadProgressFunction progress_function;
 
+  /// Optional callback that receives the I/O statistics on completion.
+  IoStatisticsFunction io_statistics_function;
+
   /// Optional batch.
   Batch batch{no_batch};
+
+  /// Scheduling priority of the tasks that carry out the operation.
+  TaskPriority priority = TaskPriority::kNormal;
+
+  /// The operation fails with `absl::StatusCode::kDeadlineExceeded` if it does
+  /// not complete by this deadline.  Defaults to no deadline.
+  Deadline deadline;
+
+  /// Specifies whether the result may reference cached data.  Defaults to
+  /// `cannot_reference_cached_data`.
+  ReadResultReferenceRestriction result_reference_restriction =
+      cannot_reference_cached_data;
 };
 
 template <>
@@ -117,6 +186,65 @@ constexpr inline bool ReadIntoNewArrayOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool ReadIntoNewArrayOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool ReadIntoNewArrayOptions::IsOption<TaskPriority> = true;
+
+template <>
+constexpr inline bool ReadIntoNewArrayOptions::IsOption<Deadline> = true;
+
+template <>
+constexpr inline bool
+    ReadIntoNewArrayOptions::IsOption<ReadResultReferenceRestriction> = true;
+
+template <>
+constexpr inline bool ReadIntoNewArrayOptions::IsOption<IoStatisticsFunction> =
+    true;
+
+/// Options for `tensorstore::Prefetch`.
+///
+/// \relates Prefetch[TensorStore]
+struct PrefetchOptions {
+  template <typename T>
+  constexpr static inline bool IsOption = false;
+
+  /// Combines any number of supported options.
+  template <typename... T, typename = std::enable_if_t<
+                               (IsOption<absl::remove_cvref_t<T>> && ...)>>
+  PrefetchOptions(T&&... option) {
+    (Set(std::forward<T>(option)), ...);
+  }
+
+  void Set(ReadProgressFunction value) {
+    this->progress_function = std::move(value);
+  }
+
+  void Set(Batch value) { this->batch = std::move(value); }
+
+  void Set(TaskPriority value) { this->priority = value; }
+
+  /// Optional progress callback.  The `ReadProgress::copied_elements` member
+  /// indicates the number of elements that have been loaded.
+  ReadProgressFunction progress_function;
+
+  /// Optional batch.
+  Batch batch{no_batch};
+
+  /// Scheduling priority of the tasks that carry out the operation.
+  TaskPriority priority = TaskPriority::kNormal;
+};
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<ReadProgressFunction> = true;
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<Batch> = true;
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<Batch::View> = true;
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<TaskPriority> = true;
+
 /// Specifies restrictions on how references to the source array/source
 /// TensorStore may be used by write operations.
 enum SourceDataReferenceRestriction {
@@ -163,16 +291,34 @@ struct WriteOptions {
     this->source_data_reference_restriction = value;
   }
 
+  void Set(TaskPriority value) { this->priority = value; }
+
+  void Set(Deadline value) { this->deadline = value; }
+
+  void Set(IoStatisticsFunction value) {
+    this->io_statistics_function = std::move(value);
+  }
+
   /// Constrains how the source array may be aligned to the target TensorStore.
   DomainAlignmentOptions alignment_options = DomainAlignmentOptions::all;
 
   /// Optional progress callback.
   WriteProgressFunction progress_function;
 
+  /// Optional callback that receives the I/O statistics once committed.
+  IoStatisticsFunction io_statistics_function;
+
   /// Specifies restrictions on how the source data may be referenced (as
   /// opposed to copied).
   SourceDataReferenceRestriction source_data_reference_restriction =
       cannot_reference_source_data;
+
+  /// Scheduling priority of the tasks that carry out the operation.
+  TaskPriority priority = TaskPriority::kNormal;
+
+  /// The operation fails with `absl::StatusCode::kDeadlineExceeded` if it does
+  /// not complete by this deadline.  Defaults to no deadline.
+  Deadline deadline;
 };
 
 template <>
@@ -185,6 +331,15 @@ template <>
 constexpr inline bool WriteOptions::IsOption<SourceDataReferenceRestriction> =
     true;
 
+template <>
+constexpr inline bool WriteOptions::IsOption<TaskPriority> = true;
+
+template <>
+constexpr inline bool WriteOptions::IsOption<Deadline> = true;
+
+template <>
+constexpr inline bool WriteOptions::IsOption<IoStatisticsFunction> = true;
+
 /// Options for `tensorstore::Copy`.
 ///
 /// \relates Copy[TensorStore, TensorStore]
@@ -0,0 +1,359 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/rechunk.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_rechunk {
+namespace {
+
+/// Returns the origin and size of a grid along dimension `i`, treating an
+/// unchunked dimension as a single cell covering `domain`.
+std::pair<Index, Index> GetGridCell(BoxView<> domain, span<const Index> origin,
+                                    span<const Index> shape,
+                                    DimensionIndex i) {
+  if (shape[i] <= 0) {
+    return {domain[i].inclusive_min(), std::max(Index(1), domain[i].size())};
+  }
+  return {origin[i] == kImplicit ? domain[i].inclusive_min() : origin[i],
+          shape[i]};
+}
+
+}  // namespace
+
+StagingGrid ChooseStagingGrid(BoxView<> domain,
+                              span<const Index> source_origin,
+                              span<const Index> source_shape,
+                              span<const Index> target_origin,
+                              span<const Index> target_shape,
+                              Index element_size, size_t max_block_bytes) {
+  const DimensionIndex rank = domain.rank();
+  assert(IsFinite(domain));
+  StagingGrid grid;
+  grid.origin.resize(rank);
+  grid.shape.resize(rank);
+  std::vector<Index> extent(rank), target_size(rank), common_size(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    extent[i] = std::max(Index(1), domain[i].size());
+    auto [s_origin, s_size] =
+        GetGridCell(domain, source_origin, source_shape, i);
+    auto [t_origin, t_size] =
+        GetGridCell(domain, target_origin, target_shape, i);
+    target_size[i] = t_size;
+    // Both grids have a common boundary if, and only if, their origins agree
+    // modulo the GCD of the cell sizes, in which case the common boundaries
+    // repeat with a period of the LCM.
+    grid.origin[i] = t_origin;
+    common_size[i] = 0;
+    const Index g = GreatestCommonDivisor(s_size, t_size);
+    Index lcm;
+    if (NonnegativeMod(s_origin - t_origin, g) == 0 &&
+        !internal::MulOverflow(s_size / g, t_size, &lcm) && lcm < extent[i]) {
+      for (Index k = 0; k < s_size / g; ++k) {
+        const Index x = t_origin + k * t_size;
+        if (NonnegativeMod(x - s_origin, s_size) == 0) {
+          grid.origin[i] = x;
+          common_size[i] = lcm;
+          break;
+        }
+      }
+    }
+    grid.shape[i] = common_size[i] ? common_size[i] : extent[i];
+  }
+
+  const auto block_bytes = [&] {
+    double bytes = element_size;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      bytes *= std::min(grid.shape[i], extent[i]);
+    }
+    return bytes;
+  };
+  while (block_bytes() > max_block_bytes) {
+    // Halve the dimension that spans the most target chunks, preferring to
+    // remain aligned to the source grid.
+    DimensionIndex dim = -1;
+    double max_ratio = 1;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      const double ratio =
+          static_cast<double>(std::min(grid.shape[i], extent[i])) /
+          target_size[i];
+      if (ratio > max_ratio) {
+        max_ratio = ratio;
+        dim = i;
+      }
+    }
+    if (dim == -1) break;
+    const Index half = std::min(grid.shape[dim], extent[dim]) / 2;
+    const Index unit = (common_size[dim] && half >= common_size[dim])
+                           ? common_size[dim]
+                           : target_size[dim];
+    grid.shape[dim] = std::max(target_size[dim], half / unit * unit);
+  }
+
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    if (grid.shape[i] >= extent[i]) {
+      // A single block covers the dimension.
+      grid.origin[i] = domain[i].inclusive_min();
+      grid.shape[i] = extent[i];
+    }
+  }
+  return grid;
+}
+
+}  // namespace internal_rechunk
+
+namespace {
+
+using ::tensorstore::internal_rechunk::StagingGrid;
+
+/// Enumerates the blocks of a staging grid that intersect a bounded domain,
+/// in lexicographical order.
+class BlockIterator {
+ public:
+  BlockIterator(BoxView<> domain, StagingGrid grid)
+      : domain_(domain), grid_(std::move(grid)) {
+    const DimensionIndex rank = domain.rank();
+    begin_.resize(rank);
+    end_.resize(rank);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      begin_[i] = FloorOfRatio(domain[i].inclusive_min() - grid_.origin[i],
+                               grid_.shape[i]);
+      end_[i] = FloorOfRatio(domain[i].inclusive_max() - grid_.origin[i],
+                             grid_.shape[i]) +
+                1;
+    }
+    cell_ = begin_;
+    at_end_ = domain.is_empty();
+  }
+
+  bool AtEnd() const { return at_end_; }
+
+  /// Returns the bounds of the next block, intersected with the domain.
+  Box<> Next() {
+    assert(!at_end_);
+    const DimensionIndex rank = domain_.rank();
+    Box<> box(rank);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      box[i] = Intersect(
+          IndexInterval::UncheckedSized(
+              grid_.origin[i] + cell_[i] * grid_.shape[i], grid_.shape[i]),
+          domain_[i]);
+    }
+    at_end_ = true;
+    for (DimensionIndex i = rank - 1; i >= 0; --i) {
+      if (++cell_[i] != end_[i]) {
+        at_end_ = false;
+        break;
+      }
+      cell_[i] = begin_[i];
+    }
+    return box;
+  }
+
+ private:
+  Box<> domain_;
+  StagingGrid grid_;
+  std::vector<Index> begin_, end_, cell_;
+  bool at_end_;
+};
+
+/// State of an in-progress `Rechunk` operation.
+class RechunkState : public internal::AtomicReferenceCount<RechunkState> {
+ public:
+  using Ptr = internal::IntrusivePtr<RechunkState>;
+
+  RechunkState(TensorStore<> source, TensorStore<> target, StagingGrid grid,
+               size_t max_in_flight, Promise<void> promise)
+      : source_(std::move(source)),
+        target_(std::move(target)),
+        max_in_flight_(max_in_flight),
+        promise_(std::move(promise)),
+        iterator_(source_.domain().box(), std::move(grid)) {}
+
+  /// Starts copying blocks until `max_in_flight` blocks are outstanding or
+  /// all blocks have been started.
+  ///
+  /// If called recursively, e.g. because a copy completed synchronously, the
+  /// outer call continues starting blocks.
+  static void IssueBlocks(Ptr self) {
+    {
+      absl::MutexLock lock(&self->mutex_);
+      if (self->issuing_) return;
+      self->issuing_ = true;
+    }
+    while (true) {
+      Box<> bounds;
+      bool issue = false, finished = false;
+      {
+        absl::MutexLock lock(&self->mutex_);
+        if (self->promise_.result_needed() && !self->iterator_.AtEnd() &&
+            self->in_flight_ < self->max_in_flight_) {
+          bounds = self->iterator_.Next();
+          ++self->in_flight_;
+          issue = true;
+        } else {
+          self->issuing_ = false;
+          if (self->in_flight_ == 0 && !self->finished_ &&
+              (self->iterator_.AtEnd() || !self->promise_.result_needed())) {
+            self->finished_ = finished = true;
+          }
+        }
+      }
+      if (!issue) {
+        if (finished) self->promise_.SetResult(absl::OkStatus());
+        return;
+      }
+      tensorstore::Read(self->source_ | AllDims().BoxSlice(bounds))
+          .ExecuteWhenReady(
+              [self, bounds = std::move(bounds)](
+                  ReadyFuture<SharedOffsetArray<void>> future) {
+                WriteBlock(self, bounds, future.result());
+              });
+    }
+  }
+
+ private:
+  static void WriteBlock(Ptr self, BoxView<> bounds,
+                         const Result<SharedOffsetArray<void>>& array) {
+    if (!array.ok()) {
+      self->BlockDone(bounds, array.status());
+      IssueBlocks(std::move(self));
+      return;
+    }
+    auto write_futures =
+        tensorstore::Write(*array, self->target_ | AllDims().BoxSlice(bounds));
+    // Within a transaction, the writes are not committed until the
+    // transaction is.
+    Future<const void> future = self->target_.transaction() == no_transaction
+                                    ? write_futures.commit_future
+                                    : write_futures.copy_future;
+    std::move(future).ExecuteWhenReady(
+        [self = std::move(self), bounds = Box<>(bounds)](
+            ReadyFuture<const void> ready) {
+          self->BlockDone(bounds, ready.status());
+          IssueBlocks(self);
+        });
+  }
+
+  void BlockDone(BoxView<> bounds, const absl::Status& status) {
+    if (!status.ok()) {
+      promise_.SetResult(MaybeAnnotateStatus(
+          status, tensorstore::StrCat("Copying block ", bounds)));
+    }
+    absl::MutexLock lock(&mutex_);
+    --in_flight_;
+  }
+
+  TensorStore<> source_;
+  TensorStore<> target_;
+  const size_t max_in_flight_;
+  Promise<void> promise_;
+
+  absl::Mutex mutex_;
+  BlockIterator iterator_ ABSL_GUARDED_BY(mutex_);
+  size_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Set while a call to `IssueBlocks` is starting blocks.
+  bool issuing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+/// Computes the origin and shape of a chunk grid with the specified
+/// `preferred` chunk shape, falling back to the `fallback` chunk shape in
+/// dimensions where it is unspecified.
+void GetChunkGrid(DimensionIndex rank, span<const Index> grid_origin,
+                  span<const Index> preferred, span<const Index> fallback,
+                  std::vector<Index>& origin, std::vector<Index>& shape) {
+  origin.assign(rank, kImplicit);
+  shape.assign(rank, 0);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    if (grid_origin.size() == rank) origin[i] = grid_origin[i];
+    if (preferred.size() == rank && preferred[i] > 0) {
+      shape[i] = preferred[i];
+    } else if (fallback.size() == rank && fallback[i] > 0) {
+      shape[i] = fallback[i];
+    }
+  }
+}
+
+}  // namespace
+
+Future<void> Rechunk(TensorStore<> source, TensorStore<> target,
+                     RechunkOptions options) {
+  const BoxView<> domain = source.domain().box();
+  if (!IsFinite(domain)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Cannot rechunk unbounded domain ", source.domain()));
+  }
+  if (source.rank() != target.rank()) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Cannot rechunk from rank ", source.rank(), " to rank ",
+        target.rank()));
+  }
+  const DimensionIndex rank = source.rank();
+  TENSORSTORE_ASSIGN_OR_RETURN(auto source_layout, source.chunk_layout());
+  TENSORSTORE_ASSIGN_OR_RETURN(auto target_layout, target.chunk_layout());
+  std::vector<Index> source_origin, source_shape, target_origin, target_shape;
+  GetChunkGrid(rank, source_layout.grid_origin(),
+               source_layout.read_chunk_shape(),
+               source_layout.write_chunk_shape(), source_origin, source_shape);
+  GetChunkGrid(rank, target_layout.grid_origin(),
+               target_layout.write_chunk_shape(),
+               target_layout.read_chunk_shape(), target_origin, target_shape);
+  const Index element_size = source.dtype()->size;
+  auto grid = internal_rechunk::ChooseStagingGrid(
+      domain, source_origin, source_shape, target_origin, target_shape,
+      element_size, options.max_staging_bytes);
+  double block_bytes = std::max(Index(1), element_size);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    block_bytes *= std::min(grid.shape[i], domain[i].size());
+  }
+  const size_t max_in_flight = static_cast<size_t>(std::clamp(
+      std::floor(options.max_staging_bytes / block_bytes), 1.0,
+      static_cast<double>(std::max(size_t(1), options.max_in_flight))));
+  auto [promise, future] = PromiseFuturePair<void>::Make();
+  RechunkState::IssueBlocks(internal::MakeIntrusivePtr<RechunkState>(
+      std::move(source), std::move(target), std::move(grid), max_in_flight,
+      std::move(promise)));
+  return std::move(future);
+}
+
+}  // namespace tensorstore
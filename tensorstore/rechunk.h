@@ -0,0 +1,107 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_RECHUNK_H_
+#define TENSORSTORE_RECHUNK_H_
+
+/// \file
+/// Copying between TensorStores with different chunk layouts.
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+
+/// Options for `Rechunk`.
+///
+/// \relates Rechunk
+struct RechunkOptions {
+  /// Maximum total size in bytes of the blocks staged in memory.
+  size_t max_staging_bytes = size_t(1) << 30;
+
+  /// Maximum number of blocks that are copied concurrently.
+  size_t max_in_flight = 4;
+};
+
+/// Copies the entire domain of `source` to the same region of `target`, which
+/// typically has a different chunk layout.
+///
+/// Unlike `tensorstore::Copy`, which copies according to the chunking of the
+/// source and may read and decode a source chunk once for each target chunk
+/// that it intersects, the copy is performed in staging blocks that are
+/// aligned to both the read chunk grid of `source` and the write chunk grid
+/// (e.g. shards) of `target`.  Each block is read into memory in its entirety
+/// and then written, so that each source chunk is read once and each target
+/// chunk is written once.
+///
+/// If a block aligned to both grids would exceed
+/// `options.max_staging_bytes`, the block is reduced in the dimension with the
+/// most target chunks, keeping it aligned to the target grid.  In that case
+/// source chunks that straddle block boundaries are read more than once, but
+/// each target chunk is still written only once.
+///
+/// Up to `options.max_in_flight` blocks, subject to the memory limit, are
+/// copied concurrently; the individual reads and writes are additionally
+/// bounded by the concurrency resources of the respective stores.
+///
+/// If `target` is bound to a transaction, the returned future becomes ready
+/// once the data has been written to the transaction; otherwise, it becomes
+/// ready once the writes have been committed.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if the domain of `source` is
+///     unbounded.
+/// \relates TensorStore
+Future<void> Rechunk(TensorStore<> source, TensorStore<> target,
+                     RechunkOptions options = {});
+
+namespace internal_rechunk {
+
+/// Regular grid of staging blocks used by `Rechunk`.
+struct StagingGrid {
+  std::vector<Index> origin;
+  std::vector<Index> shape;
+};
+
+/// Chooses the staging grid for copying `domain` from a source with the
+/// specified read chunk grid to a target with the specified write chunk grid.
+///
+/// Along each dimension, the block size is the least common multiple of the
+/// source and target chunk sizes, with an origin at which both grids have a
+/// boundary, or the entire extent of the domain if that is smaller or no such
+/// origin exists.  Blocks are then reduced as described in `Rechunk` until
+/// they are at most `max_block_bytes`, or equal to the target chunk shape.
+///
+/// A chunk size of 0 indicates that the corresponding grid is unchunked along
+/// that dimension.
+///
+/// \dchecks All spans have a length of `domain.rank()`.
+/// \dchecks `IsFinite(domain)`
+StagingGrid ChooseStagingGrid(BoxView<> domain,
+                              span<const Index> source_origin,
+                              span<const Index> source_shape,
+                              span<const Index> target_origin,
+                              span<const Index> target_shape,
+                              Index element_size, size_t max_block_bytes);
+
+}  // namespace internal_rechunk
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_RECHUNK_H_
@@ -0,0 +1,166 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/rechunk.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/open.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Rechunk;
+using ::tensorstore::TensorStore;
+using ::tensorstore::internal_rechunk::ChooseStagingGrid;
+using ::testing::ElementsAre;
+
+TensorStore<> CreateStore(std::string url, std::vector<Index> chunk_shape) {
+  return tensorstore::Open(
+             {
+                 {"driver", "zarr3"},
+                 {"kvstore", url},
+                 {"metadata",
+                  {
+                      {"data_type", "uint16"},
+                      {"shape", {10, 11}},
+                      {"chunk_grid",
+                       {{"name", "regular"},
+                        {"configuration", {{"chunk_shape", chunk_shape}}}}},
+                  }},
+             },
+             tensorstore::OpenMode::create)
+      .value();
+}
+
+tensorstore::SharedArray<uint16_t, 2> MakeData() {
+  auto array = tensorstore::AllocateArray<uint16_t>({10, 11});
+  for (Index i = 0; i < 10; ++i) {
+    for (Index j = 0; j < 11; ++j) {
+      array(i, j) = static_cast<uint16_t>(i * 100 + j);
+    }
+  }
+  return array;
+}
+
+TEST(ChooseStagingGridTest, CommonMultiple) {
+  const Index source_origin[] = {0};
+  const Index source_shape[] = {4};
+  const Index target_origin[] = {0};
+  const Index target_shape[] = {6};
+  auto grid = ChooseStagingGrid(Box<>({0}, {100}), source_origin,
+                                source_shape, target_origin, target_shape,
+                                /*element_size=*/1, /*max_block_bytes=*/1000);
+  EXPECT_THAT(grid.origin, ElementsAre(0));
+  EXPECT_THAT(grid.shape, ElementsAre(12));
+}
+
+TEST(ChooseStagingGridTest, OffsetOrigins) {
+  const Index source_shape[] = {4};
+  const Index target_origin[] = {0};
+  const Index target_shape[] = {6};
+  {
+    // Boundaries coincide at 6, 18, ...
+    const Index source_origin[] = {2};
+    auto grid = ChooseStagingGrid(Box<>({0}, {100}), source_origin,
+                                  source_shape, target_origin, target_shape,
+                                  1, 1000);
+    EXPECT_THAT(grid.origin, ElementsAre(6));
+    EXPECT_THAT(grid.shape, ElementsAre(12));
+  }
+  {
+    // Boundaries never coincide, so a single block spans the dimension.
+    const Index source_origin[] = {1};
+    auto grid = ChooseStagingGrid(Box<>({5}, {100}), source_origin,
+                                  source_shape, target_origin, target_shape,
+                                  1, 1000);
+    EXPECT_THAT(grid.origin, ElementsAre(5));
+    EXPECT_THAT(grid.shape, ElementsAre(100));
+  }
+}
+
+TEST(ChooseStagingGridTest, MemoryLimit) {
+  // Transposing row chunks to column chunks requires the entire array to be
+  // staged in order to read each source chunk once; with a limit, blocks are
+  // reduced along the dimension with the most target chunks.
+  const Index origin[] = {0, 0};
+  const Index source_shape[] = {100, 1};
+  const Index target_shape[] = {1, 100};
+  auto grid = ChooseStagingGrid(Box<>({100, 100}), origin, source_shape,
+                                origin, target_shape, 1, 10000);
+  EXPECT_THAT(grid.shape, ElementsAre(100, 100));
+  grid = ChooseStagingGrid(Box<>({100, 100}), origin, source_shape, origin,
+                           target_shape, 1, 1000);
+  EXPECT_THAT(grid.origin, ElementsAre(0, 0));
+  EXPECT_THAT(grid.shape, ElementsAre(6, 100));
+}
+
+TEST(RechunkTest, Basic) {
+  auto source = CreateStore("memory://source/", {3, 5});
+  auto target = CreateStore("memory://target/", {4, 4});
+  auto data = MakeData();
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(data, source).result());
+  TENSORSTORE_ASSERT_OK(Rechunk(source, target).result());
+  EXPECT_THAT(tensorstore::Read(target).result(), ::testing::Optional(data));
+}
+
+TEST(RechunkTest, MemoryLimit) {
+  auto source = CreateStore("memory://source/", {3, 5});
+  auto target = CreateStore("memory://target/", {4, 4});
+  auto data = MakeData();
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(data, source).result());
+  tensorstore::RechunkOptions options;
+  options.max_staging_bytes = 32;
+  options.max_in_flight = 1;
+  TENSORSTORE_ASSERT_OK(Rechunk(source, target, options).result());
+  EXPECT_THAT(tensorstore::Read(target).result(), ::testing::Optional(data));
+}
+
+TEST(RechunkTest, RankMismatch) {
+  auto source = CreateStore("memory://source/", {3, 5});
+  auto target = tensorstore::Open(
+                    {
+                        {"driver", "zarr3"},
+                        {"kvstore", "memory://target/"},
+                        {"metadata",
+                         {
+                             {"data_type", "uint16"},
+                             {"shape", {10}},
+                             {"chunk_grid",
+                              {{"name", "regular"},
+                               {"configuration", {{"chunk_shape", {5}}}}}},
+                         }},
+                    },
+                    tensorstore::OpenMode::create)
+                    .value();
+  EXPECT_THAT(Rechunk(source, target).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Cannot rechunk from rank 2 to rank 1"));
+}
+
+}  // namespace
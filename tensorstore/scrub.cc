@@ -0,0 +1,387 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/scrub.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/crc/crc32c.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/chunk_order_iterator.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+#include "tensorstore/internal/rate_limiter/scaling_rate_limiter.h"
+#include "tensorstore/internal/rate_limiter/token_bucket_rate_limiter.h"
+#include "tensorstore/internal/thread/thread_pool.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+#include "tensorstore/util/task_priority.h"
+
+namespace tensorstore {
+namespace {
+
+/// Executor for verification, and for starting rate-limited reads outside of
+/// the rate limiter.
+const Executor& GetScrubExecutor() {
+  static absl::NoDestructor<Executor> executor(internal::DetachedThreadPool(
+      std::max(size_t(1), size_t(std::thread::hardware_concurrency()))));
+  return *executor;
+}
+
+/// State of an in-progress scrub, which verifies a sequence of items defined
+/// by the derived class.
+class ScrubOperation : public internal::AtomicReferenceCount<ScrubOperation> {
+ public:
+  using Ptr = internal::IntrusivePtr<ScrubOperation>;
+
+  struct Item {
+    /// Key, for `ScrubKvStore`.
+    std::string key;
+    /// Chunk bounds, for `ScrubChunks`.
+    Box<> bounds;
+    /// Expected number of bytes read.
+    size_t bytes = 0;
+  };
+
+  ScrubOperation(const ScrubOptions& options, Promise<ScrubResult> promise)
+      : executor_(internal::WithTaskPriority(GetScrubExecutor(),
+                                             options.priority)),
+        priority_(options.priority),
+        max_in_flight_(std::max(size_t(1), options.max_in_flight)),
+        progress_function_(options.progress_function),
+        promise_(std::move(promise)),
+        next_index_(options.resume_from.items_verified) {
+    result_.progress = options.resume_from;
+    if (options.bytes_per_second > 0) {
+      rate_limiter_ = std::make_unique<internal::ConstantRateLimiter>(
+          options.bytes_per_second, internal::RateLimiterUnit::kBytes);
+    }
+  }
+
+  virtual ~ScrubOperation() = default;
+
+  /// Starts verifying items until `max_in_flight` items are in progress or all
+  /// items have been started.
+  ///
+  /// If called recursively, e.g. because a verification completed
+  /// synchronously, the outer call continues starting items.
+  static void IssueTasks(Ptr self) {
+    {
+      absl::MutexLock lock(&self->mutex_);
+      if (self->issuing_) return;
+      self->issuing_ = true;
+    }
+    while (true) {
+      std::unique_ptr<Task> task;
+      std::optional<ScrubResult> result;
+      {
+        absl::MutexLock lock(&self->mutex_);
+        if (self->promise_.result_needed() && !self->at_end_ &&
+            self->in_flight_ < self->max_in_flight_) {
+          task = std::make_unique<Task>();
+          if (self->NextItem(task->item)) {
+            task->index = self->next_index_++;
+            ++self->in_flight_;
+          } else {
+            self->at_end_ = true;
+            task.reset();
+          }
+        }
+        if (!task) {
+          self->issuing_ = false;
+          if (self->in_flight_ == 0 &&
+              (self->at_end_ || !self->promise_.result_needed()) &&
+              !self->finished_) {
+            self->finished_ = true;
+            result = std::move(self->result_);
+          }
+        }
+      }
+      if (!task) {
+        if (result) self->promise_.SetResult(std::move(*result));
+        return;
+      }
+      task->op = self;
+      task->bytes_ = task->item.bytes;
+      if (self->rate_limiter_) {
+        self->rate_limiter_->Admit(task.release(), &StartRateLimitedTask);
+      } else {
+        RunTask(task.release());
+      }
+    }
+  }
+
+ protected:
+  /// Returns the next item to verify, or `false` if there are no more items.
+  virtual bool NextItem(Item& item) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) = 0;
+
+  /// Reads and verifies `item`, returning the number of bytes read.
+  virtual Future<size_t> Verify(const Item& item) = 0;
+
+  const Executor executor_;
+  const TaskPriority priority_;
+  absl::Mutex mutex_;
+
+ private:
+  struct Task : public internal::RateLimiterNode {
+    Ptr op;
+    Item item;
+    int64_t index;
+  };
+
+  /// Called by the rate limiter, which must not be destroyed by the start
+  /// function, so the task is run on the executor instead.
+  static void StartRateLimitedTask(void* node) {
+    auto* task = static_cast<Task*>(static_cast<internal::RateLimiterNode*>(
+        node));
+    task->op->executor_([task] { RunTask(task); });
+  }
+
+  static void RunTask(Task* task) {
+    task->op->Verify(task->item)
+        .ExecuteWhenReady([task](ReadyFuture<size_t> future) {
+          std::unique_ptr<Task> owned_task(task);
+          Ptr self = std::move(task->op);
+          if (self->rate_limiter_) {
+            if (future.result().ok()) {
+              self->rate_limiter_->Reconcile(task, *future.result());
+            }
+            self->rate_limiter_->Finish(task);
+          }
+          self->OnTaskDone(*task, future.result());
+          owned_task.reset();
+          IssueTasks(std::move(self));
+        });
+  }
+
+  void OnTaskDone(Task& task, const Result<size_t>& result) {
+    absl::MutexLock lock(&mutex_);
+    --in_flight_;
+    auto& progress = result_.progress;
+    if (result.ok()) {
+      progress.bytes_verified += *result;
+    } else {
+      ++progress.errors;
+      result_.errors.push_back(
+          {task.item.key.empty() ? tensorstore::StrCat(task.item.bounds)
+                                 : task.item.key,
+           result.status()});
+    }
+    // Items may complete out of order, but the progress only advances over a
+    // prefix of the scrub order, so that resuming never skips an item.
+    completed_.emplace(task.index, std::move(task.item.key));
+    for (auto it = completed_.begin();
+         it != completed_.end() && it->first == progress.items_verified;
+         it = completed_.erase(it)) {
+      ++progress.items_verified;
+      progress.last_key = std::move(it->second);
+    }
+    if (progress_function_) progress_function_(progress);
+  }
+
+  std::unique_ptr<internal::RateLimiter> rate_limiter_;
+  const size_t max_in_flight_;
+  std::function<void(const ScrubProgress&)> progress_function_;
+  Promise<ScrubResult> promise_;
+
+  int64_t next_index_ ABSL_GUARDED_BY(mutex_);
+  size_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Keys of the items, indexed by position in the scrub order, that completed
+  // after an item that is still in progress.
+  absl::btree_map<int64_t, std::string> completed_ ABSL_GUARDED_BY(mutex_);
+  ScrubResult result_ ABSL_GUARDED_BY(mutex_);
+  bool at_end_ ABSL_GUARDED_BY(mutex_) = false;
+  // Set while a call to `IssueTasks` is starting items.
+  bool issuing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+class KvStoreScrubOperation : public ScrubOperation {
+ public:
+  KvStoreScrubOperation(kvstore::KvStore store,
+                        std::vector<kvstore::ListEntry> entries,
+                        const ScrubKvStoreOptions& options,
+                        Promise<ScrubResult> promise)
+      : ScrubOperation(options, std::move(promise)),
+        store_(std::move(store)),
+        verify_(options.verify),
+        entries_(std::move(entries)) {}
+
+ protected:
+  bool NextItem(Item& item) override {
+    if (next_entry_ == entries_.size()) return false;
+    auto& entry = entries_[next_entry_++];
+    item.key = std::move(entry.key);
+    item.bytes = entry.has_size() ? entry.size : 0;
+    return true;
+  }
+
+  Future<size_t> Verify(const Item& item) override {
+    kvstore::ReadOptions options;
+    options.priority = priority_;
+    return MapFutureValue(
+        executor_,
+        [verify = verify_, key = item.key](
+            const kvstore::ReadResult& read_result) -> Result<size_t> {
+          // Skip keys deleted since they were listed.
+          if (!read_result.has_value()) return 0;
+          if (verify) {
+            TENSORSTORE_RETURN_IF_ERROR(verify(key, read_result.value));
+          }
+          return read_result.value.size();
+        },
+        kvstore::Read(store_, item.key, std::move(options)));
+  }
+
+ private:
+  kvstore::KvStore store_;
+  ScrubValueFunction verify_;
+  std::vector<kvstore::ListEntry> entries_;
+  size_t next_entry_ = 0;
+};
+
+class ChunkScrubOperation : public ScrubOperation {
+ public:
+  ChunkScrubOperation(TensorStore<> store, const ChunkLayout& chunk_layout,
+                      const ScrubOptions& options,
+                      Promise<ScrubResult> promise)
+      : ScrubOperation(options, std::move(promise)),
+        store_(std::move(store)),
+        iterator_(store_.domain().box(), chunk_layout) {
+    for (int64_t i = 0;
+         i < options.resume_from.items_verified && !iterator_.AtEnd(); ++i) {
+      iterator_.Next();
+    }
+  }
+
+ protected:
+  bool NextItem(Item& item) override {
+    if (iterator_.AtEnd()) return false;
+    item.bounds = iterator_.Next();
+    item.bytes = item.bounds.num_elements() * store_.dtype().size();
+    return true;
+  }
+
+  Future<size_t> Verify(const Item& item) override {
+    return MapFutureValue(
+        InlineExecutor{},
+        [bytes = item.bytes](const SharedOffsetArray<void>&) -> size_t {
+          return bytes;
+        },
+        tensorstore::Read(store_ | AllDims().BoxSlice(item.bounds),
+                          priority_));
+  }
+
+ private:
+  TensorStore<> store_;
+  internal::ChunkOrderIterator iterator_;
+};
+
+}  // namespace
+
+Future<ScrubResult> ScrubKvStore(kvstore::KvStore store,
+                                 ScrubKvStoreOptions options) {
+  kvstore::ListOptions list_options;
+  list_options.range = options.range;
+  if (!options.resume_from.last_key.empty()) {
+    list_options.range = Intersect(
+        list_options.range,
+        KeyRange(KeyRange::Successor(options.resume_from.last_key), ""));
+  }
+  auto list_future = kvstore::ListFuture(store, std::move(list_options));
+  return PromiseFuturePair<ScrubResult>::LinkValue(
+             [store = std::move(store), options = std::move(options)](
+                 Promise<ScrubResult> promise,
+                 ReadyFuture<std::vector<kvstore::ListEntry>> future) mutable {
+               auto& entries = future.value();
+               std::sort(entries.begin(), entries.end(),
+                         [](const kvstore::ListEntry& a,
+                            const kvstore::ListEntry& b) {
+                           return a.key < b.key;
+                         });
+               ScrubOperation::IssueTasks(
+                   internal::MakeIntrusivePtr<KvStoreScrubOperation>(
+                       std::move(store), std::move(entries), options,
+                       std::move(promise)));
+             },
+             std::move(list_future))
+      .future;
+}
+
+Future<ScrubResult> ScrubChunks(TensorStore<> store, ScrubOptions options) {
+  if (!IsFinite(store.domain().box())) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Cannot scrub chunks of unbounded domain ", store.domain()));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto chunk_layout, store.chunk_layout());
+  auto [promise, future] = PromiseFuturePair<ScrubResult>::Make();
+  ScrubOperation::IssueTasks(internal::MakeIntrusivePtr<ChunkScrubOperation>(
+      std::move(store), chunk_layout, options, std::move(promise)));
+  return std::move(future);
+}
+
+absl::Status VerifyCrc32cSuffix(std::string_view key,
+                                const absl::Cord& value) {
+  constexpr size_t kDigestSize = 4;
+  if (value.size() < kDigestSize) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Value for ", tensorstore::QuoteString(key),
+        " is too short to contain a crc32c checksum"));
+  }
+  const size_t payload_size = value.size() - kDigestSize;
+  absl::crc32c_t crc{0};
+  for (std::string_view chunk : value.Subcord(0, payload_size).Chunks()) {
+    crc = absl::ExtendCrc32c(crc, chunk);
+  }
+  uint32_t stored = 0;
+  std::string digest(value.Subcord(payload_size, kDigestSize));
+  for (size_t i = 0; i < kDigestSize; ++i) {
+    stored |= uint32_t(static_cast<unsigned char>(digest[i])) << (8 * i);
+  }
+  if (static_cast<uint32_t>(crc) != stored) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "crc32c checksum mismatch for ", tensorstore::QuoteString(key)));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace tensorstore
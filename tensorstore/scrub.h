@@ -0,0 +1,163 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_SCRUB_H_
+#define TENSORSTORE_SCRUB_H_
+
+/// \file
+/// Background verification of stored data.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/task_priority.h"
+
+namespace tensorstore {
+
+/// Progress of a scrub, which may be passed to `ScrubOptions::resume_from` to
+/// continue an interrupted scrub.
+///
+/// \relates ScrubKvStore
+struct ScrubProgress {
+  /// Number of items (keys or chunks) at the start of the scrub order that
+  /// have been verified, including those that failed verification.
+  int64_t items_verified = 0;
+
+  /// Number of bytes verified.
+  int64_t bytes_verified = 0;
+
+  /// Number of items that failed verification.
+  int64_t errors = 0;
+
+  /// For `ScrubKvStore`, the last of the `items_verified` keys.
+  std::string last_key;
+};
+
+/// Verification failure of a single item.
+///
+/// \relates ScrubKvStore
+struct ScrubError {
+  /// Key, or chunk bounds, of the item.
+  std::string item;
+
+  /// Error returned by the read or the verification function.
+  absl::Status status;
+};
+
+/// Result of a completed scrub.
+///
+/// \relates ScrubKvStore
+struct ScrubResult {
+  ScrubProgress progress;
+
+  /// Failures encountered by this scrub, in no particular order.  Excludes the
+  /// failures counted by `ScrubOptions::resume_from`.
+  std::vector<ScrubError> errors;
+};
+
+/// Options for `ScrubKvStore` and `ScrubChunks`.
+///
+/// \relates ScrubKvStore
+struct ScrubOptions {
+  /// Limit on the rate at which data is read, in bytes per second, or `0` for
+  /// no limit.
+  double bytes_per_second = 0;
+
+  /// Priority of the reads and of the verification.
+  TaskPriority priority = TaskPriority::kBackground;
+
+  /// Maximum number of items that are verified concurrently.
+  size_t max_in_flight = 4;
+
+  /// Progress of a previous scrub of the same items, which is continued after
+  /// the items it verified.
+  ScrubProgress resume_from;
+
+  /// Called after each item is verified with the progress so far, while
+  /// holding a lock that serializes the calls.  Must not block.
+  std::function<void(const ScrubProgress&)> progress_function;
+};
+
+/// Verifies a single value read by `ScrubKvStore`.
+///
+/// \relates ScrubKvStore
+using ScrubValueFunction =
+    std::function<absl::Status(std::string_view key, const absl::Cord& value)>;
+
+/// Options for `ScrubKvStore`.
+///
+/// \relates ScrubKvStore
+struct ScrubKvStoreOptions : public ScrubOptions {
+  /// Keys to verify, relative to the path of the store.
+  KeyRange range;
+
+  /// Function that verifies each value.  If not specified, values are only
+  /// read, which verifies any checksums checked by the kvstore driver.
+  ScrubValueFunction verify;
+};
+
+/// Reads and verifies each key of `store` within `options.range`, in
+/// lexicographical order.
+///
+/// Reads are issued with `options.priority` and limited to
+/// `options.bytes_per_second`, so that a scrub of a large store does not delay
+/// other operations.  Failures are recorded in the result rather than stopping
+/// the scrub.  Keys deleted after they are listed are skipped.
+///
+/// To continue an interrupted scrub, specify the last progress reported for
+/// it as `options.resume_from`, which resumes after `last_key`.
+///
+/// \returns A future that becomes ready when all keys have been verified.
+///     Fails only if the keys cannot be listed.
+/// \relates KvStore
+Future<ScrubResult> ScrubKvStore(kvstore::KvStore store,
+                                 ScrubKvStoreOptions options = {});
+
+/// Reads and decodes each read chunk of `store`, in the storage order defined
+/// by `IterateChunks`.
+///
+/// Decoding applies the entire codec chain, including checksum codecs such as
+/// the zarr v3 ``crc32c`` codec.  The rate limit applies to the decoded size of
+/// each chunk.  To continue an interrupted scrub, specify the last progress
+/// reported for it as `options.resume_from`, which skips the first
+/// `items_verified` chunks.
+///
+/// \param store The TensorStore to verify, must have a bounded domain.
+/// \error `absl::StatusCode::kInvalidArgument` if the domain of `store` is not
+///     bounded.
+/// \relates TensorStore
+Future<ScrubResult> ScrubChunks(TensorStore<> store, ScrubOptions options = {});
+
+/// Verifies a value that ends with the little-endian CRC-32C checksum of the
+/// preceding bytes, as written by the zarr v3 ``crc32c`` codec.
+///
+/// \error `absl::StatusCode::kDataLoss` if the checksum does not match.
+/// \relates ScrubKvStore
+absl::Status VerifyCrc32cSuffix(std::string_view key,
+                                const absl::Cord& value);
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_SCRUB_H_
@@ -0,0 +1,168 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/scrub.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/crc/crc32c.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/open.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::ScrubChunks;
+using ::tensorstore::ScrubError;
+using ::tensorstore::ScrubKvStore;
+using ::tensorstore::ScrubKvStoreOptions;
+using ::tensorstore::ScrubOptions;
+using ::tensorstore::ScrubProgress;
+using ::tensorstore::VerifyCrc32cSuffix;
+using ::testing::ElementsAre;
+using ::testing::Field;
+
+absl::Cord WithCrc32c(std::string payload) {
+  uint32_t crc = static_cast<uint32_t>(absl::ComputeCrc32c(payload));
+  for (int i = 0; i < 4; ++i) {
+    payload.push_back(static_cast<char>(crc >> (8 * i)));
+  }
+  return absl::Cord(std::move(payload));
+}
+
+TEST(VerifyCrc32cSuffixTest, Basic) {
+  TENSORSTORE_EXPECT_OK(VerifyCrc32cSuffix("a", WithCrc32c("hello")));
+  TENSORSTORE_EXPECT_OK(VerifyCrc32cSuffix("a", WithCrc32c("")));
+  EXPECT_THAT(VerifyCrc32cSuffix("a", absl::Cord("abc")),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*too short.*"));
+  EXPECT_THAT(VerifyCrc32cSuffix("a", absl::Cord(std::string(9, 'x'))),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "crc32c checksum mismatch for \"a\""));
+}
+
+TEST(ScrubKvStoreTest, Basic) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store,
+                                   kvstore::Open("memory://").result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", WithCrc32c("aaaa")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "b", absl::Cord("bad value")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "c", WithCrc32c("cc")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "d", WithCrc32c("d")));
+
+  ScrubKvStoreOptions options;
+  options.range = tensorstore::KeyRange("a", "d");
+  options.verify = VerifyCrc32cSuffix;
+  options.bytes_per_second = 1e6;
+  std::vector<int64_t> items_verified;
+  options.progress_function = [&](const ScrubProgress& progress) {
+    items_verified.push_back(progress.items_verified);
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result,
+                                   ScrubKvStore(store, options).result());
+  EXPECT_EQ(3, result.progress.items_verified);
+  EXPECT_EQ(14, result.progress.bytes_verified);
+  EXPECT_EQ(1, result.progress.errors);
+  EXPECT_EQ("c", result.progress.last_key);
+  EXPECT_THAT(result.errors, ElementsAre(Field(&ScrubError::item, "b")));
+  EXPECT_EQ(3, items_verified.size());
+  EXPECT_EQ(3, items_verified.back());
+}
+
+TEST(ScrubKvStoreTest, Resume) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store,
+                                   kvstore::Open("memory://").result());
+  for (const char* key : {"a", "b", "c"}) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, key, WithCrc32c(key)));
+  }
+  ScrubKvStoreOptions options;
+  options.verify = VerifyCrc32cSuffix;
+  options.resume_from.items_verified = 2;
+  options.resume_from.bytes_verified = 10;
+  options.resume_from.last_key = "b";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result,
+                                   ScrubKvStore(store, options).result());
+  EXPECT_EQ(3, result.progress.items_verified);
+  EXPECT_EQ(15, result.progress.bytes_verified);
+  EXPECT_EQ("c", result.progress.last_key);
+  EXPECT_THAT(result.errors, ::testing::IsEmpty());
+}
+
+TEST(ScrubChunksTest, DetectsCorruptChunk) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(
+          {
+              {"driver", "zarr3"},
+              {"kvstore", "memory://"},
+              {"metadata",
+               {
+                   {"data_type", "uint16"},
+                   {"shape", {4, 4}},
+                   {"chunk_grid",
+                    {{"name", "regular"},
+                     {"configuration", {{"chunk_shape", {2, 2}}}}}},
+                   {"codecs",
+                    {{{"name", "bytes"},
+                      {"configuration", {{"endian", "little"}}}},
+                     {{"name", "crc32c"}}}},
+               }},
+          },
+          context, tensorstore::OpenMode::create)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeArray<uint16_t>(
+          {{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15, 16}}),
+      store));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto kvs, kvstore::Open("memory://", context).result());
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(kvs, "c/1/0", absl::Cord(std::string(12, '\0'))));
+
+  ScrubOptions options;
+  options.max_in_flight = 2;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result,
+                                   ScrubChunks(store, options).result());
+  EXPECT_EQ(4, result.progress.items_verified);
+  EXPECT_EQ(1, result.progress.errors);
+  EXPECT_EQ(3 * 2 * 2 * 2, result.progress.bytes_verified);
+  EXPECT_THAT(result.errors,
+              ElementsAre(Field(&ScrubError::item,
+                                "{origin={2, 0}, shape={2, 2}}")));
+
+  // Resuming after the corrupt chunk verifies only the last chunk.
+  options.resume_from.items_verified = 3;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(result,
+                                   ScrubChunks(store, options).result());
+  EXPECT_EQ(4, result.progress.items_verified);
+  EXPECT_EQ(0, result.progress.errors);
+  EXPECT_EQ(2 * 2 * 2, result.progress.bytes_verified);
+}
+
+}  // namespace
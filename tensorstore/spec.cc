@@ -14,9 +14,15 @@
 
 #include "tensorstore/spec.h"
 
+#include <memory>
+#include <string>
+
+#include "absl/base/no_destructor.h"
+#include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/index_space/json.h"
+#include "tensorstore/internal/decoded_value_cache.h"
 #include "tensorstore/internal/json/json.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/serialization/serialization.h"
@@ -101,6 +107,21 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
     Spec,
     jb::Projection(&Spec::impl_, internal::TransformedDriverSpecJsonBinder))
 
+Result<Spec> Spec::FromJsonCached(const ::nlohmann::json& json) {
+  static absl::NoDestructor<internal::DecodedValueCache<Spec>> cache(
+      /*max_entries=*/256);
+  // Object members are sorted by key, so equivalent specs have the same
+  // serialization.
+  const std::string key = json.dump();
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto spec,
+      cache->GetOrDecode(key, [&]() -> Result<std::shared_ptr<const Spec>> {
+        TENSORSTORE_ASSIGN_OR_RETURN(auto spec, Spec::FromJson(json));
+        return std::make_shared<const Spec>(std::move(spec));
+      }));
+  return *spec;
+}
+
 Result<IndexTransform<>> Spec::GetTransformForIndexingOperation() const {
   if (impl_.transform.valid()) return impl_.transform;
   if (impl_.driver_spec) {
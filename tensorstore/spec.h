@@ -204,6 +204,15 @@ class Spec {
     return std::forward<Func>(func)(std::move(spec));
   }
 
+  /// Same as `Spec::FromJson(json)`, but memoizes the result in a bounded,
+  /// process-wide cache keyed by the serialized `json`.
+  ///
+  /// This avoids repeatedly invoking the driver JSON binders when the same
+  /// JSON spec is opened many times, e.g. once per request by a server.  Since
+  /// `Spec` is copy-on-write, modifying the returned spec does not affect the
+  /// cached spec.  Errors are not cached.
+  static Result<Spec> FromJsonCached(const ::nlohmann::json& json);
+
   /// Returns a transform that may be used for apply a DimExpression.
   ///
   /// If `transform().valid()`, returns `transform()`.
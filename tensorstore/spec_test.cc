@@ -65,6 +65,28 @@ TEST(SpecTest, ToJson) {
   EXPECT_TRUE(spec.valid());
 }
 
+TEST(SpecTest, FromJsonCached) {
+  ::nlohmann::json spec_json{
+      {"driver", "array"},
+      {"dtype", "int32"},
+      {"array", {1, 2, 3}},
+      {"transform",
+       {{"input_inclusive_min", {0}}, {"input_exclusive_max", {3}}}},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec1, Spec::FromJsonCached(spec_json));
+  EXPECT_THAT(spec1.ToJson(), ::testing::Optional(MatchesJson(spec_json)));
+
+  // Modifying a returned spec does not affect subsequent results.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      spec1, spec1 | tensorstore::Dims(0).SizedInterval(1, 2));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec2, Spec::FromJsonCached(spec_json));
+  EXPECT_THAT(spec2.ToJson(), ::testing::Optional(MatchesJson(spec_json)));
+  EXPECT_NE(spec1, spec2);
+
+  EXPECT_THAT(Spec::FromJsonCached({{"driver", "invalid_driver_name"}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(SpecTest, Comparison) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(  //
       auto spec_a, Spec::FromJson({
@@ -54,13 +54,25 @@ struct RecheckCacheOption {
     return option;
   }
 
+  /// Special time bound equal to `max_age` before the time the TensorStore is
+  /// opened.
+  ///
+  /// Cached data not older than `max_age` at the time of opening, including
+  /// the cached absence of a key, is used without revalidation.
+  static constexpr RecheckCacheOption MaxAge(absl::Duration max_age) {
+    RecheckCacheOption option = AtOpen();
+    option.max_age = max_age;
+    return option;
+  }
+
   /// Specifies the kind of time bound.
   enum Flags {
     /// No bound has been specified.
     kUnspecified,
     /// Data must not be older than the specified `time`.
     kSpecified,
-    /// Data must not be older than the time at which the Spec is opened.
+    /// Data must not be older than `max_age` before the time at which the
+    /// Spec is opened.
     kAtOpen,
   };
 
@@ -69,6 +81,10 @@ struct RecheckCacheOption {
   /// If `flags == kSpecified`, data must not be older than `time`.
   absl::Time time = absl::InfiniteFuture();
 
+  /// If `flags == kAtOpen`, data must not be older than `max_age` before the
+  /// open time.
+  absl::Duration max_age = absl::ZeroDuration();
+
   /// Specifies the interpretation of `time`.
   Flags flags = kUnspecified;
 
@@ -153,7 +169,8 @@ class StalenessBound {
 
   StalenessBound(RecheckCacheOption option)
       : time(option.time),
-        bounded_by_open_time(option.flags == RecheckCacheOption::kAtOpen) {}
+        bounded_by_open_time(option.flags == RecheckCacheOption::kAtOpen),
+        max_age(option.max_age) {}
 
   StalenessBound(absl::Time newer_than_time) : time(newer_than_time) {}
 
@@ -170,7 +187,7 @@ class StalenessBound {
   StalenessBound BoundAtOpen(absl::Time open_time) const {
     StalenessBound result = *this;
     if (result.bounded_by_open_time) {
-      result.time = open_time;
+      result.time = open_time - max_age;
     }
     return result;
   }
@@ -182,6 +199,14 @@ class StalenessBound {
     return b;
   }
 
+  /// Returns a new staleness bound with `bounded_at_open_time == true` that
+  /// accepts cached data not older than `max_age` at the open time.
+  static StalenessBound MaxAge(absl::Duration max_age) {
+    StalenessBound b = BoundedByOpen();
+    b.max_age = max_age;
+    return b;
+  }
+
   /// Time bound.
   absl::Time time = absl::InfiniteFuture();
 
@@ -190,8 +215,14 @@ class StalenessBound {
   /// rather than as a timestamp.
   bool bounded_by_open_time = false;
 
+  /// If `bounded_by_open_time == true`, the bound is `max_age` before the open
+  /// time.
+  absl::Duration max_age = absl::ZeroDuration();
+
   friend bool operator==(const StalenessBound& a, const StalenessBound& b) {
-    return a.time == b.time && a.bounded_by_open_time == b.bounded_by_open_time;
+    return a.time == b.time &&
+           a.bounded_by_open_time == b.bounded_by_open_time &&
+           a.max_age == b.max_age;
   }
 
   friend bool operator!=(const StalenessBound& a, const StalenessBound& b) {
@@ -199,7 +230,7 @@ class StalenessBound {
   }
 
   static constexpr auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.time, x.bounded_by_open_time);
+    return f(x.time, x.bounded_by_open_time, x.max_age);
   };
 };
 
@@ -728,6 +728,60 @@ Read(Source&& source, Option&&... options) {
       ReadIntoNewArrayOptions(std::forward<Option>(options)...));
 }
 
+/// Reads from a `source` `TensorStore` without returning the data.
+///
+/// This populates any caches used by `source`, such as the
+/// `Context.cache_pool`, without allocating a destination array.  It is
+/// equivalent to `Read` in terms of the I/O performed, but each chunk is
+/// released as soon as it has been read.  The cached data is only retained if
+/// it fits within the cache limits.
+///
+/// Options compatible with `PrefetchOptions` are specified in any order after
+/// `store`.  The meaning of each option is determined by its type.
+///
+/// Supported option types are:
+///
+/// - `ReadProgressFunction`
+///
+/// - `Batch`
+///
+/// Example::
+///
+///     TensorReader<std::int32_t, 3> store = ...;
+///     TENSORSTORE_RETURN_IF_ERROR(
+///         Prefetch(store | AllDims().SizedInterval({100, 200}, {25, 30}))
+///             .result());
+///
+/// \param source Source TensorStore object that supports reading.  May be
+///     `Result`-wrapped.
+/// \param options Any option compatible with `PrefetchOptions`.
+/// \returns A future that becomes ready when the data has been read or an
+///     error occurs.
+/// \error `absl::StatusCode::kInvalidArgument` if the resolved domain of
+///     `source` is not finite.
+/// \relates TensorStore
+/// \membergroup I/O
+template <typename Source>
+std::enable_if_t<internal::IsTensorStore<UnwrapResultType<Source>>,
+                 Future<void>>
+Prefetch(const Source& source, PrefetchOptions options) {
+  return MapResult(
+      [&](const auto& unwrapped_source) -> Future<void> {
+        return internal::DriverPrefetch(
+            internal::TensorStoreAccess::handle(unwrapped_source),
+            std::move(options));
+      },
+      source);
+}
+template <typename Source, typename... Option>
+std::enable_if_t<(internal::IsTensorStore<UnwrapResultType<Source>> &&
+                  IsCompatibleOptionSequence<PrefetchOptions, Option...>),
+                 Future<void>>
+Prefetch(const Source& source, Option&&... options) {
+  return tensorstore::Prefetch(
+      source, PrefetchOptions(std::forward<Option>(options)...));
+}
+
 /// Copies from a `source` array to `target` TensorStore.
 ///
 /// The domain of `target` is resolved via `ResolveBounds` and then the domain
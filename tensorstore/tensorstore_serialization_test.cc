@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 #include "tensorstore/array.h"
 #include "tensorstore/context.h"
+#include "tensorstore/driver/driver.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
 #include "tensorstore/open.h"
 #include "tensorstore/open_mode.h"
@@ -33,6 +34,7 @@ namespace {
 
 using ::tensorstore::Context;
 using ::tensorstore::OpenMode;
+using ::tensorstore::internal::TensorStoreAccess;
 using ::tensorstore::serialization::SerializationRoundTrip;
 
 TEST(TensorStoreSerializationTest, Invalid) {
@@ -148,4 +150,48 @@ TEST(TensorStoreSerializationTest, MetadataNotReadAssumeMetadata) {
   EXPECT_THAT(decoded.spec(), ::testing::Optional(t_spec));
 }
 
+TEST(TensorStoreSerializationTest, DecodedDriverHandleCache) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec,
+                                   tensorstore::Spec::FromJson({
+                                       {"driver", "n5"},
+                                       {"kvstore", {{"driver", "memory"}}},
+                                       {"metadata",
+                                        {{"compression", {{"type", "raw"}}},
+                                         {"dataType", "uint32"},
+                                         {"dimensions", {2}},
+                                         {"blockSize", {2}}}},
+                                       {"create", true},
+                                       {"open", true},
+                                   }));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto t, tensorstore::Open(spec).result());
+  const auto get_driver = [](const auto& store) {
+    return TensorStoreAccess::handle(store).driver.get();
+  };
+
+  // Disabled: each decoded handle opens a new driver.
+  tensorstore::internal::SetDecodedDriverHandleCacheCapacity(0);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto a1, SerializationRoundTrip(t));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto a2, SerializationRoundTrip(t));
+  EXPECT_NE(get_driver(a1), get_driver(a2));
+
+  // Enabled: decoding the same handle again reuses the driver, including its
+  // context resources.
+  tensorstore::internal::SetDecodedDriverHandleCacheCapacity(1);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto b1, SerializationRoundTrip(t));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto b2, SerializationRoundTrip(t));
+  EXPECT_EQ(get_driver(b1), get_driver(b2));
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint32_t>(7), b1));
+  EXPECT_THAT(tensorstore::Read(b2).result(),
+              ::testing::Optional(tensorstore::MakeArray<uint32_t>({7, 7})));
+
+  // A different read-write mode is not reused.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto t_read, tensorstore::ModeCast(t, tensorstore::ReadWriteMode::read));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto b3, SerializationRoundTrip(t_read));
+  EXPECT_NE(get_driver(b1), get_driver(b3));
+
+  tensorstore::internal::SetDecodedDriverHandleCacheCapacity(0);
+}
+
 }  // namespace
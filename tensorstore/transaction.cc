@@ -240,6 +240,7 @@ void TransactionState::DecrementNodesPendingAbort(size_t count) {
   }
   // All nodes aborted.  Release `promise_` so that it becomes ready with the
   // error set previously by `SetDeferredResult`.
+  commit_inflight_.reset();
   promise_ = Promise<void>();
 }
 
@@ -247,15 +248,20 @@ void TransactionState::ExecuteCommit() {
   assert(commit_state_ == kCommitStarted);
   // Release the promise callback to break the reference cycle.
   promise_callback_.Unregister();
+  commit_inflight_ = internal_tracing::InFlightOperation(
+      "transaction.commit",
+      tensorstore::StrCat(mode_, " transaction ", static_cast<void*>(this)));
   ExecuteCommitPhase();
 }
 
 void TransactionState::ExecuteCommitPhase() {
   if (nodes_.empty()) {
     // All phases completed.
+    commit_inflight_.reset();
     promise_ = Promise<void>();
     return;
   }
+  commit_inflight_.SetState("prepare");
   // Reset the `commit_start_time_` at the start of each phase, because for
   // "consistent read" validation, the read must be verified as of the start of
   // the current phase.
@@ -304,6 +310,7 @@ void TransactionState::DecrementNodesPendingReadyForCommit() {
     return;
   }
   // Current phase ready to be committed.
+  commit_inflight_.SetState("commit");
 
   // Ensure the transaction state is not freed until this method completes.  The
   // call to `node->Commit()` below may cause `node` to be freed, which might
@@ -354,12 +361,14 @@ void TransactionState::DecrementNodesPendingCommit(size_t count) {
     } else {
       // An error occurred during commit of the last phase.  Abort remaining
       // phases.
+      commit_inflight_.SetState("abort");
       ExecuteAbort();
     }
   } else {
     // All phases completed.  Release the reference to `promise_` so that it
     // becomes ready either with success or with the error set previously by
     // `SetDeferredResult`.
+    commit_inflight_.reset();
     promise_ = Promise<void>();
   }
 }
@@ -40,6 +40,7 @@
 #include "tensorstore/internal/container/intrusive_red_black_tree.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
+#include "tensorstore/internal/tracing/inflight_operation.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
 #include "tensorstore/util/result.h"
@@ -819,6 +820,10 @@ class TransactionState {
   /// commit.
   absl::Time commit_start_time_;
 
+  /// Registers the commit as an in-flight operation, from the time commit
+  /// starts until all phases complete or abort.
+  internal_tracing::InFlightOperation commit_inflight_;
+
   /// Registration of "force" callback on `promise_` that commits the
   /// transaction.  The callback holds a commit reference.  This is unregistered
   /// when all other commit references have been released, in order to break the
@@ -0,0 +1,79 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_UTIL_DEADLINE_H_
+#define TENSORSTORE_UTIL_DEADLINE_H_
+
+/// \file
+/// Deadlines for asynchronous operations.
+
+#include <algorithm>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace tensorstore {
+
+/// Time by which an operation must complete.
+///
+/// If the operation has not completed by the deadline, it fails with
+/// `absl::StatusCode::kDeadlineExceeded`, and any outstanding I/O, including
+/// retries and requests waiting for a concurrency slot, is abandoned.
+///
+/// \ingroup async
+struct Deadline {
+  /// Returns a deadline `timeout` from now.
+  static Deadline After(absl::Duration timeout) {
+    return Deadline{absl::Now() + timeout};
+  }
+
+  /// Returns `true` if the deadline is finite.
+  bool has_deadline() const { return time != absl::InfiniteFuture(); }
+
+  /// Absolute deadline.  The default of `absl::InfiniteFuture()` indicates no
+  /// deadline.
+  absl::Time time = absl::InfiniteFuture();
+};
+
+namespace internal {
+
+/// Deadline of the operation on behalf of which the current thread is running.
+inline thread_local absl::Time current_deadline = absl::InfiniteFuture();
+
+/// Returns the deadline of the operation on behalf of which the current
+/// thread is running, or `absl::InfiniteFuture()` if there is none.
+inline absl::Time GetCurrentDeadline() { return current_deadline; }
+
+/// Restricts the deadline of operations started from the current thread to
+/// `deadline` for the lifetime of this object.
+///
+/// Nested scopes can only shorten the deadline.
+class ScopedDeadline {
+ public:
+  explicit ScopedDeadline(absl::Time deadline) : previous_(current_deadline) {
+    current_deadline = std::min(previous_, deadline);
+  }
+  ~ScopedDeadline() { current_deadline = previous_; }
+
+  ScopedDeadline(const ScopedDeadline&) = delete;
+  ScopedDeadline& operator=(const ScopedDeadline&) = delete;
+
+ private:
+  absl::Time previous_;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_UTIL_DEADLINE_H_
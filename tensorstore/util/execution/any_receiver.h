@@ -20,6 +20,7 @@
 #include "absl/base/attributes.h"
 #include "tensorstore/internal/poly/poly.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
 #include "tensorstore/util/execution/sender.h"
 
 namespace tensorstore {
@@ -45,7 +46,8 @@ using FlowReceiverPoly =
                void(internal_execution::set_value_t, V...),
                void(internal_execution::set_done_t),
                void(internal_execution::set_error_t, E),
-               void(internal_execution::set_stopping_t)>;
+               void(internal_execution::set_stopping_t),
+               void(internal_execution::set_demand_t, FlowDemand::Ptr)>;
 
 }  // namespace internal_sender
 
@@ -105,6 +107,9 @@ class AnyFlowReceiver : public internal_sender::FlowReceiverPoly<E, V...> {
   ABSL_ATTRIBUTE_ALWAYS_INLINE void set_stopping() {
     (*this)(internal_execution::set_stopping_t{});
   }
+  ABSL_ATTRIBUTE_ALWAYS_INLINE void set_demand(FlowDemand::Ptr demand) {
+    (*this)(internal_execution::set_demand_t{}, std::move(demand));
+  }
 };
 
 }  // namespace tensorstore
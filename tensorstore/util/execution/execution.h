@@ -108,6 +108,18 @@ struct set_stopping_t {
   TENSORSTORE_DEFINE_EXECUTION_CUSTOMIZATION_POINT(set_stopping)
 };
 
+/// Unlike the other customization points, `set_demand` is optional: receivers
+/// which do not support flow control ignore it.  See `flow_demand.h`.
+struct set_demand_t {
+  TENSORSTORE_DEFINE_EXECUTION_CUSTOMIZATION_POINT(set_demand)
+
+  template <typename Self, typename... Arg>
+  ABSL_ATTRIBUTE_ALWAYS_INLINE
+      std::enable_if_t<(!has_set_demand<Self&, Arg&&...>::value &&
+                        !has_adl_set_demand<Self&, Arg&&...>::value)>
+      operator()(Self&&, Arg&&...) const {}
+};
+
 #undef TENSORSTORE_INTERNAL_DEFINE_EXECUTION_CUSTOMIZTION_POINT
 
 }  // namespace internal_execution
@@ -125,6 +137,7 @@ constexpr internal_execution::set_done_t set_done = {};
 constexpr internal_execution::set_error_t set_error = {};
 constexpr internal_execution::set_cancel_t set_cancel = {};
 constexpr internal_execution::set_stopping_t set_stopping = {};
+constexpr internal_execution::set_demand_t set_demand = {};
 
 }  // namespace execution
 }  // namespace tensorstore
@@ -0,0 +1,74 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/util/execution/flow_demand.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+
+void FlowDemand::Request(size_t n) {
+  Promise<void> waiter;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!bounded_) {
+      bounded_ = true;
+      credit_ = 0;
+    }
+    credit_ += static_cast<int64_t>(n);
+    if (credit_ <= 0) return;
+    waiter = std::move(waiter_);
+  }
+  if (!waiter.null()) waiter.SetResult(MakeResult());
+}
+
+void FlowDemand::RequestUnbounded() {
+  Promise<void> waiter;
+  {
+    absl::MutexLock lock(&mutex_);
+    bounded_ = false;
+    waiter = std::move(waiter_);
+  }
+  if (!waiter.null()) waiter.SetResult(MakeResult());
+}
+
+void FlowDemand::Consume(size_t n) {
+  absl::MutexLock lock(&mutex_);
+  if (bounded_) credit_ -= static_cast<int64_t>(n);
+}
+
+bool FlowDemand::available() {
+  absl::MutexLock lock(&mutex_);
+  return !bounded_ || credit_ > 0;
+}
+
+Future<const void> FlowDemand::WhenAvailable() {
+  absl::MutexLock lock(&mutex_);
+  if (!bounded_ || credit_ > 0) return MakeReadyFuture();
+  if (!waiter_.null()) {
+    if (auto future = waiter_.future(); !future.null()) return future;
+  }
+  auto [promise, future] = PromiseFuturePair<void>::Make();
+  waiter_ = std::move(promise);
+  return std::move(future);
+}
+
+}  // namespace tensorstore
@@ -0,0 +1,87 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_UTIL_EXECUTION_FLOW_DEMAND_H_
+#define TENSORSTORE_UTIL_EXECUTION_FLOW_DEMAND_H_
+
+/// \file
+/// Demand-driven (request-N) flow control for FlowSender/FlowReceiver.
+///
+/// A FlowSender that supports flow control creates a `FlowDemand` and passes
+/// it to its receiver by calling `execution::set_demand` immediately after
+/// `execution::set_starting`.  The receiver may then call `Request(n)` to
+/// permit `n` further calls to `set_value`; once the outstanding demand is
+/// exhausted, the sender pauses producing values (e.g. stops issuing further
+/// page requests) until more demand is requested.
+///
+/// Receivers which ignore `set_demand`, which is the default, receive values
+/// as fast as the sender produces them.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+
+/// Demand shared between a flow sender (producer) and its receiver
+/// (consumer).
+///
+/// Initially unbounded: flow control is enabled by the first call to
+/// `Request`, which should be made from within `set_demand`.
+///
+/// A sender that produces values in batches (such as a page of list results)
+/// may send an entire batch once demand is available, temporarily exceeding
+/// the requested demand; the excess is deducted from subsequent requests.
+///
+/// Thread safety: all methods may be called concurrently.
+class FlowDemand : public internal::AtomicReferenceCount<FlowDemand> {
+ public:
+  using Ptr = internal::IntrusivePtr<FlowDemand>;
+
+  static Ptr Make() { return Ptr(new FlowDemand); }
+
+  /// Consumer: permits `n` additional values to be sent.
+  void Request(size_t n);
+
+  /// Consumer: disables flow control, resuming the sender if it is paused.
+  ///
+  /// Senders also call this when the operation is cancelled, so that a
+  /// paused sender observes the cancellation.
+  void RequestUnbounded();
+
+  /// Producer: records that `n` values have been sent.
+  void Consume(size_t n = 1);
+
+  /// Producer: returns `true` if values may be sent without waiting.
+  bool available();
+
+  /// Producer: returns a future that becomes ready once values may be sent.
+  Future<const void> WhenAvailable();
+
+ private:
+  FlowDemand() = default;
+
+  absl::Mutex mutex_;
+  bool bounded_ ABSL_GUARDED_BY(mutex_) = false;
+  int64_t credit_ ABSL_GUARDED_BY(mutex_) = 0;
+  Promise<void> waiter_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_UTIL_EXECUTION_FLOW_DEMAND_H_
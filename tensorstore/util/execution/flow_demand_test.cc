@@ -0,0 +1,128 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/util/execution/flow_demand.h"
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/sync_flow_sender.h"
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::AnyCancelReceiver;
+using ::tensorstore::AnyFlowReceiver;
+using ::tensorstore::FlowDemand;
+
+TEST(FlowDemandTest, UnboundedByDefault) {
+  auto demand = FlowDemand::Make();
+  EXPECT_TRUE(demand->available());
+  demand->Consume(100);
+  EXPECT_TRUE(demand->available());
+  EXPECT_TRUE(demand->WhenAvailable().ready());
+}
+
+TEST(FlowDemandTest, Request) {
+  auto demand = FlowDemand::Make();
+  demand->Request(2);
+  EXPECT_TRUE(demand->available());
+  demand->Consume();
+  EXPECT_TRUE(demand->available());
+  demand->Consume();
+  EXPECT_FALSE(demand->available());
+  auto future = demand->WhenAvailable();
+  EXPECT_FALSE(future.ready());
+  auto future2 = demand->WhenAvailable();
+  demand->Request(1);
+  ASSERT_TRUE(future.ready());
+  EXPECT_TRUE(future.status().ok());
+  EXPECT_TRUE(future2.ready());
+}
+
+TEST(FlowDemandTest, Overdraft) {
+  auto demand = FlowDemand::Make();
+  demand->Request(1);
+  // A batch larger than the demand may be sent.
+  demand->Consume(3);
+  demand->Request(2);
+  EXPECT_FALSE(demand->available());
+  demand->Request(1);
+  EXPECT_TRUE(demand->available());
+}
+
+TEST(FlowDemandTest, RequestUnbounded) {
+  auto demand = FlowDemand::Make();
+  demand->Request(0);
+  auto future = demand->WhenAvailable();
+  EXPECT_FALSE(future.ready());
+  demand->RequestUnbounded();
+  EXPECT_TRUE(future.ready());
+  EXPECT_TRUE(demand->available());
+}
+
+// Receiver which requests values one at a time.
+struct DemandReceiver {
+  std::vector<int>* values;
+  FlowDemand::Ptr* demand;
+
+  void set_starting(AnyCancelReceiver) {}
+  void set_demand(FlowDemand::Ptr d) {
+    d->Request(1);
+    *demand = std::move(d);
+  }
+  void set_value(int v) { values->push_back(v); }
+  void set_done() {}
+  void set_error(absl::Status) {}
+  void set_stopping() {}
+};
+
+TEST(FlowDemandTest, AnyFlowReceiverForwardsDemand) {
+  std::vector<int> values;
+  FlowDemand::Ptr demand;
+  AnyFlowReceiver<absl::Status, int> receiver(
+      tensorstore::SyncFlowReceiver<DemandReceiver>{
+          DemandReceiver{&values, &demand}});
+  auto sender_demand = FlowDemand::Make();
+  tensorstore::execution::set_starting(receiver, [] {});
+  tensorstore::execution::set_demand(receiver, sender_demand);
+  EXPECT_EQ(sender_demand, demand);
+  EXPECT_TRUE(sender_demand->available());
+  tensorstore::execution::set_value(receiver, 1);
+  sender_demand->Consume();
+  EXPECT_FALSE(sender_demand->available());
+  EXPECT_THAT(values, ::testing::ElementsAre(1));
+}
+
+TEST(FlowDemandTest, IgnoredByDefault) {
+  // Receivers without `set_demand` leave the demand unbounded.
+  struct Receiver {
+    void set_starting(AnyCancelReceiver) {}
+    void set_value(int) {}
+    void set_done() {}
+    void set_error(absl::Status) {}
+    void set_stopping() {}
+  };
+  AnyFlowReceiver<absl::Status, int> receiver(Receiver{});
+  auto demand = FlowDemand::Make();
+  tensorstore::execution::set_demand(receiver, demand);
+  EXPECT_TRUE(demand->available());
+}
+
+}  // namespace
@@ -19,6 +19,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_demand.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 
@@ -27,6 +28,9 @@ namespace internal {
 
 // Base class for asynchronous operation state objects that manages cancellation
 // and error returns with an `AnyFlowReceiver<absl::Status, T...>`.
+//
+// Operations which support flow control should wait for `demand` before
+// producing further values, and `Consume` it as values are sent.
 template <typename... T>
 struct FlowSenderOperationState
     : public AtomicReferenceCount<FlowSenderOperationState<T...>> {
@@ -37,7 +41,7 @@ struct FlowSenderOperationState
   };
 
   explicit FlowSenderOperationState(BaseReceiver&& receiver)
-      : shared_receiver(new SharedReceiver) {
+      : shared_receiver(new SharedReceiver), demand(FlowDemand::Make()) {
     // The receiver is stored in a separate reference-counted object, so that it
     // can outlive `FlowSenderOperationState`.  `FlowSenderOperationState` is
     // destroyed when the asynchronous operation completes (successfully or with
@@ -52,6 +56,7 @@ struct FlowSenderOperationState
         this->shared_receiver->receiver, [promise = this->promise] {
           SetDeferredResult(promise, absl::CancelledError(""));
         });
+    execution::set_demand(this->shared_receiver->receiver, demand);
     future.Force();
     std::move(future).ExecuteWhenReady(
         [shared_receiver = this->shared_receiver](ReadyFuture<void> future) {
@@ -74,6 +79,9 @@ struct FlowSenderOperationState
 
   IntrusivePtr<SharedReceiver> shared_receiver;
 
+  /// Demand requested by the receiver.
+  FlowDemand::Ptr demand;
+
   /// Tracks errors, cancellation, and completion.
   Promise<void> promise;
 };
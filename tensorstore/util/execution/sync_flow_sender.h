@@ -72,6 +72,13 @@ struct SyncFlowReceiver {
     execution::set_error(self.receiver, std::move(e));
   }
 
+  template <typename Demand>
+  friend void set_demand(SyncFlowReceiver& self, Demand demand) {
+    // No need for additional serialization because the sender is required to
+    // call this immediately after set_starting.
+    execution::set_demand(self.receiver, std::move(demand));
+  }
+
   friend void set_stopping(SyncFlowReceiver& self) {
     // No need for additional serialization because the sender is required to
     // call this after all other calls.
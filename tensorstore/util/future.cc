@@ -52,8 +52,76 @@ auto& future_not_needed_callbacks = internal_metrics::Counter<int64_t>::New(
 auto& future_force_callbacks = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/futures/force_callbacks", "Force callbacks");
 
+// Shared states of up to `kNumSizeClasses * kBlockSizeGranularity` bytes are
+// allocated from per-thread free lists, each holding up to `kMaxCachedBlocks`
+// blocks of a single size class.
+constexpr size_t kBlockSizeGranularity = 64;
+constexpr size_t kNumSizeClasses = 4;
+constexpr size_t kMaxCachedBlocks = 32;
+
+struct FutureStateBlockCache {
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  ~FutureStateBlockCache();
+
+  FreeBlock* free_list[kNumSizeClasses] = {};
+  size_t num_free[kNumSizeClasses] = {};
+};
+
+// Set when the cache of the current thread has been destroyed, after which
+// blocks are no longer cached.  Trivially destructible, so it remains valid
+// during thread exit.
+thread_local bool future_state_block_cache_destroyed = false;
+thread_local FutureStateBlockCache future_state_block_cache;
+
+FutureStateBlockCache::~FutureStateBlockCache() {
+  future_state_block_cache_destroyed = true;
+  for (auto* block : free_list) {
+    while (block) {
+      auto* next = block->next;
+      ::operator delete(block);
+      block = next;
+    }
+  }
+}
+
 }  // namespace
 
+void* FutureStateBase::operator new(size_t size) {
+  if (size > kNumSizeClasses * kBlockSizeGranularity ||
+      future_state_block_cache_destroyed) {
+    return ::operator new(size);
+  }
+  const size_t size_class = (size - 1) / kBlockSizeGranularity;
+  auto& cache = future_state_block_cache;
+  if (auto* block = cache.free_list[size_class]) {
+    cache.free_list[size_class] = block->next;
+    --cache.num_free[size_class];
+    return block;
+  }
+  return ::operator new((size_class + 1) * kBlockSizeGranularity);
+}
+
+void FutureStateBase::operator delete(void* ptr, size_t size) {
+  if (size > kNumSizeClasses * kBlockSizeGranularity ||
+      future_state_block_cache_destroyed) {
+    ::operator delete(ptr);
+    return;
+  }
+  const size_t size_class = (size - 1) / kBlockSizeGranularity;
+  auto& cache = future_state_block_cache;
+  if (cache.num_free[size_class] == kMaxCachedBlocks) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto* block = ::new (ptr) FutureStateBlockCache::FreeBlock;
+  block->next = cache.free_list[size_class];
+  cache.free_list[size_class] = block;
+  ++cache.num_free[size_class];
+}
+
 /// Special value to which CallbackListNode::next points to indicate that
 /// unregistration was requested.
 static CallbackListNode unregister_requested;
@@ -213,6 +281,16 @@ FutureStateBase::FutureStateBase()
   live_futures.Increment();
 }
 
+FutureStateBase::FutureStateBase(ReadyTag)
+    : state_(kResultLocked | kResultWrittenAndReady),
+      combined_reference_count_(1),
+      promise_reference_count_(0),
+      future_reference_count_(1) {
+  Initialize(CallbackListAccessor{}, &ready_callbacks_);
+  Initialize(CallbackListAccessor{}, &promise_callbacks_);
+  live_futures.Increment();
+}
+
 namespace {
 
 void NoMorePromiseReferences(FutureStateBase* shared_state) {
@@ -385,10 +385,13 @@ class Promise {
 template <typename T, typename... U>
 std::enable_if_t<std::is_constructible_v<Result<T>, U...>, ReadyFuture<T>>
 MakeReadyFuture(U&&... u) {
-  auto pair = PromiseFuturePair<T>::Make(std::forward<U>(u)...);
-  // Release the reference to the promise, which makes the future ready.
-  pair.promise.reset();
-  return ReadyFuture<T>(pair.future);
+  // Construct the shared state directly in the ready state, which avoids the
+  // promise reference and the callback processing of `Promise` release.
+  using State = internal_future::FutureStateType<T>;
+  return internal_future::FutureAccess::Construct<ReadyFuture<T>>(
+      internal_future::FutureStatePointer(
+          new State(typename State::ReadyTag{}, std::forward<U>(u)...),
+          internal::adopt_object_ref));
 }
 ReadyFuture<const void> MakeReadyFuture();
 
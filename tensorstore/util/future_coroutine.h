@@ -0,0 +1,198 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_UTIL_FUTURE_COROUTINE_H_
+#define TENSORSTORE_UTIL_FUTURE_COROUTINE_H_
+
+/// \file
+/// C++20 coroutine support for `Future`.
+///
+/// When compiled with coroutine support, `TENSORSTORE_HAS_FUTURE_COROUTINES` is
+/// defined to `1` and:
+///
+/// - Any function returning `Future<T>` may be written as a coroutine.  The
+///   returned future becomes ready when the coroutine executes
+///   `co_return value;`, where `value` is convertible to `Result<T>`.  For
+///   `Future<void>`, use `co_return absl::OkStatus();`.
+///
+/// - `co_await future` suspends until `future` is ready, and evaluates to a
+///   copy of its `Result<T>`.  The coroutine resumes on the thread that made
+///   `future` ready (or inline if it is already ready).
+///
+/// - `co_await ResumeOn(executor)` resumes the coroutine on `executor`.
+///
+/// Example::
+///
+///     Future<int> ReadSize(Executor executor, KvStore store,
+///                          std::string key) {
+///       co_await ResumeOn(executor);
+///       auto result = co_await kvstore::Read(store, key);
+///       if (!result.ok()) co_return result.status();
+///       co_return static_cast<int>(result->value.size());
+///     }
+///
+/// Compared to chains of `MapFutureValue`/`Link`, each coroutine allocates a
+/// single frame, and each `co_await` of a pending future registers a single
+/// callback.
+///
+/// Exceptions thrown from a coroutine terminate the program.
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && \
+    __has_include(<coroutine>)
+#define TENSORSTORE_HAS_FUTURE_COROUTINES 1
+#else
+#define TENSORSTORE_HAS_FUTURE_COROUTINES 0
+#endif
+
+#if TENSORSTORE_HAS_FUTURE_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_future {
+
+/// Coroutine promise type for coroutines returning `Future<T>`.
+template <typename T>
+class FutureCoroutinePromiseBase {
+ public:
+  using Value = std::remove_const_t<T>;
+
+  FutureCoroutinePromiseBase() {
+    auto pair = PromiseFuturePair<Value>::Make();
+    promise_ = std::move(pair.promise);
+    future_ = std::move(pair.future);
+  }
+
+  Future<T> get_return_object() { return std::move(future_); }
+
+  std::suspend_never initial_suspend() noexcept { return {}; }
+
+  // The frame is destroyed as soon as the coroutine completes; the result is
+  // held by the shared state of the returned future.
+  std::suspend_never final_suspend() noexcept { return {}; }
+
+  void unhandled_exception() noexcept { std::terminate(); }
+
+ protected:
+  Promise<Value> promise_;
+  Future<Value> future_;
+};
+
+template <typename T>
+class FutureCoroutinePromise : public FutureCoroutinePromiseBase<T> {
+ public:
+  template <typename U,
+            typename = std::enable_if_t<std::is_constructible_v<
+                Result<std::remove_const_t<T>>, U&&>>>
+  void return_value(U&& value) {
+    this->promise_.SetResult(std::forward<U>(value));
+  }
+};
+
+template <typename T>
+class FutureCoroutinePromise<const T> : public FutureCoroutinePromise<T> {};
+
+template <>
+class FutureCoroutinePromise<void> : public FutureCoroutinePromiseBase<void> {
+ public:
+  void return_value(absl::Status status) {
+    this->promise_.SetResult(MakeResult(std::move(status)));
+  }
+};
+
+template <>
+class FutureCoroutinePromise<const void>
+    : public FutureCoroutinePromise<void> {};
+
+/// Awaiter returned by `operator co_await(Future<T>)`.
+template <typename T>
+class FutureAwaiter {
+ public:
+  explicit FutureAwaiter(Future<T> future) : future_(std::move(future)) {}
+
+  bool await_ready() const noexcept { return future_.ready(); }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    future_.Force();
+    // Registers the callback on a copy, since the coroutine, and therefore
+    // this awaiter, may be destroyed by the callback.
+    Future<T>(future_).ExecuteWhenReady(
+        [handle](ReadyFuture<T>) { handle.resume(); });
+  }
+
+  Result<std::remove_const_t<T>> await_resume() { return future_.result(); }
+
+ private:
+  Future<T> future_;
+};
+
+/// Awaiter returned by `ResumeOn`.
+class ResumeOnAwaiter {
+ public:
+  explicit ResumeOnAwaiter(Executor executor)
+      : executor_(std::move(executor)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    // The coroutine, and therefore this awaiter, may be destroyed on another
+    // thread before `executor` returns.
+    Executor executor = std::move(executor_);
+    executor([handle] { handle.resume(); });
+  }
+
+  void await_resume() const noexcept {}
+
+ private:
+  Executor executor_;
+};
+
+}  // namespace internal_future
+
+/// Suspends the calling coroutine until `future` is ready.
+///
+/// \returns An awaitable that evaluates to a copy of the `Result<T>`.
+/// \relates Future
+template <typename T>
+internal_future::FutureAwaiter<T> operator co_await(Future<T> future) {
+  return internal_future::FutureAwaiter<T>(std::move(future));
+}
+
+/// Returns an awaitable that resumes the calling coroutine on `executor`.
+///
+/// \relates Executor
+inline internal_future::ResumeOnAwaiter ResumeOn(Executor executor) {
+  return internal_future::ResumeOnAwaiter(std::move(executor));
+}
+
+}  // namespace tensorstore
+
+namespace std {
+template <typename T, typename... Args>
+struct coroutine_traits<tensorstore::Future<T>, Args...> {
+  using promise_type = tensorstore::internal_future::FutureCoroutinePromise<T>;
+};
+}  // namespace std
+
+#endif  // TENSORSTORE_HAS_FUTURE_COROUTINES
+
+#endif  // TENSORSTORE_UTIL_FUTURE_COROUTINE_H_
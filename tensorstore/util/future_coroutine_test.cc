@@ -0,0 +1,98 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/util/future_coroutine.h"
+
+#if TENSORSTORE_HAS_FUTURE_COROUTINES
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Executor;
+using ::tensorstore::ExecutorTask;
+using ::tensorstore::Future;
+using ::tensorstore::MakeReadyFuture;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::ResumeOn;
+
+Future<int> AddOne(Future<int> future) {
+  auto result = co_await std::move(future);
+  if (!result.ok()) co_return result.status();
+  co_return *result + 1;
+}
+
+Future<void> CheckPositive(Future<const int> future) {
+  auto result = co_await std::move(future);
+  if (!result.ok()) co_return result.status();
+  if (*result <= 0) co_return absl::InvalidArgumentError("not positive");
+  co_return absl::OkStatus();
+}
+
+TEST(FutureCoroutineTest, ReadyFuture) {
+  auto future = AddOne(MakeReadyFuture<int>(1));
+  ASSERT_TRUE(future.ready());
+  EXPECT_EQ(2, future.value());
+}
+
+TEST(FutureCoroutineTest, PendingFuture) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future = AddOne(pair.future);
+  EXPECT_FALSE(future.ready());
+  pair.promise.SetResult(5);
+  ASSERT_TRUE(future.ready());
+  EXPECT_EQ(6, future.value());
+}
+
+TEST(FutureCoroutineTest, Error) {
+  auto future = AddOne(MakeReadyFuture<int>(absl::UnknownError("x")));
+  EXPECT_THAT(future.result(), MatchesStatus(absl::StatusCode::kUnknown, "x"));
+}
+
+TEST(FutureCoroutineTest, Void) {
+  TENSORSTORE_EXPECT_OK(CheckPositive(MakeReadyFuture<int>(1)).result());
+  EXPECT_THAT(CheckPositive(MakeReadyFuture<int>(0)).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(FutureCoroutineTest, ResumeOn) {
+  std::vector<ExecutorTask> tasks;
+  Executor executor = [&](ExecutorTask task) {
+    tasks.push_back(std::move(task));
+  };
+  auto coroutine = [](Executor executor) -> Future<int> {
+    co_await ResumeOn(executor);
+    co_return 3;
+  };
+  auto future = coroutine(executor);
+  EXPECT_FALSE(future.ready());
+  ASSERT_EQ(1, tasks.size());
+  std::move(tasks[0])();
+  ASSERT_TRUE(future.ready());
+  EXPECT_EQ(3, future.value());
+}
+
+}  // namespace
+
+#endif  // TENSORSTORE_HAS_FUTURE_COROUTINES
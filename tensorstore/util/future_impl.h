@@ -23,6 +23,7 @@
 #include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <new>
 #include <thread>  // NOLINT
 #include <type_traits>
 #include <utility>
@@ -178,9 +179,30 @@ struct CallbackListNode {
 ///     an instance of the `FutureState` class template should be constructed.
 class FutureStateBase {
  public:
+  /// Tag type for constructing a shared state that is already ready.
+  struct ReadyTag {};
+
   FutureStateBase();
+
+  /// Constructs a shared state whose result is already written and marked
+  /// ready, referenced by a single `Future` and no `Promise`.
+  explicit FutureStateBase(ReadyTag);
+
   virtual ~FutureStateBase();
 
+  /// Shared states are small and short-lived; they are allocated from
+  /// per-thread caches of fixed-size blocks rather than the general-purpose
+  /// allocator.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+  static void* operator new(size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+  }
+  static void operator delete(void* ptr, size_t size,
+                              std::align_val_t alignment) {
+    ::operator delete(ptr, size, alignment);
+  }
+
   virtual bool has_value() = 0;
   virtual const absl::Status& status() const& noexcept = 0;
 
@@ -488,6 +510,10 @@ class FutureState : public FutureStateBase {
   template <typename... Args>
   explicit FutureState(Args&&... args) : result(std::forward<Args>(args)...) {}
 
+  template <typename... Args>
+  explicit FutureState(ReadyTag tag, Args&&... args)
+      : FutureStateBase(tag), result(std::forward<Args>(args)...) {}
+
   ~FutureState() override {}
 
   bool has_value() final { return result.has_value(); };
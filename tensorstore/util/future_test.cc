@@ -1791,6 +1791,33 @@ TEST(MakeReadyFutureTest, Basic) {
   EXPECT_EQ(MakeResult(), future.result());
 }
 
+TEST(MakeReadyFutureTest, ForceAndLink) {
+  Future<int> future = MakeReadyFuture<int>(5);
+  Future<int> copy = future;
+  copy.Force();
+  EXPECT_TRUE(copy.WaitFor(absl::ZeroDuration()));
+  auto pair = PromiseFuturePair<int>::Make();
+  Link(
+      [](Promise<int> promise, ReadyFuture<int> f) {
+        promise.SetResult(f.value() + 1);
+      },
+      pair.promise, std::move(copy));
+  EXPECT_EQ(6, pair.future.value());
+  EXPECT_EQ(5, future.value());
+}
+
+TEST(MakeReadyFutureTest, SharedStateReused) {
+  const void* state;
+  {
+    auto future = MakeReadyFuture<int>(1);
+    state = &future.result();
+  }
+  // The freed shared state is cached by the current thread.
+  auto future = MakeReadyFuture<int>(2);
+  EXPECT_EQ(state, &future.result());
+  EXPECT_EQ(2, future.value());
+}
+
 TEST(FutureTest, SetDeferredResult) {
   auto [promise, future] = PromiseFuturePair<int>::Make();
   SetDeferredResult(promise, 2);
@@ -244,7 +244,44 @@ class IterateHelper {
                 pointers...);
   }
 
+  /// Same as `Start`, but for `layouts` of static rank `Rank`.
+  ///
+  /// The nested loops are generated at compile time, which avoids the
+  /// recursion overhead of `Start` for the common low-rank cases.
+  template <DimensionIndex Rank>
+  static Result StartStatic(Func func,
+                            const DimensionSizeAndStrides<arity>* layouts,
+                            Pointer... pointers) {
+    if constexpr (Rank == 0) {
+      return func(pointers...);
+    } else {
+      return StaticLoop<Rank>(func, layouts,
+                              std::index_sequence_for<Pointer...>(),
+                              pointers...);
+    }
+  }
+
  private:
+  /// Loops over the next `Rank` dimensions and calls `func`.
+  template <DimensionIndex Rank, size_t... Is>
+  ABSL_ATTRIBUTE_ALWAYS_INLINE static Result StaticLoop(
+      Func& func, const DimensionSizeAndStrides<arity>* layouts,
+      std::index_sequence<Is...> index_sequence, Pointer... pointers) {
+    const DimensionSizeAndStrides<arity> size_and_strides = layouts[0];
+    Result result = internal::DefaultIterationResult<Result>::value();
+    for (Index i = 0; i < size_and_strides.size; ++i) {
+      if constexpr (Rank == 1) {
+        result = func(pointers...);
+      } else {
+        result = StaticLoop<Rank - 1>(func, layouts + 1, index_sequence,
+                                      pointers...);
+      }
+      if (!result) break;
+      ((pointers += size_and_strides.strides[Is]), ...);
+    }
+    return result;
+  }
+
   /// Loops over the next dimension, and either recurses or calls `func`.
   ///
   /// \pre layouts.size() >= 1
@@ -266,8 +303,8 @@ class IterateHelper {
       }
     } else {
       for (Index i = 0; i < size_and_strides.size; ++i) {
-        auto result = Loop(func, {&layouts[1], layouts.size() - 1},
-                           index_sequence, pointers...);
+        result = Loop(func, {&layouts[1], layouts.size() - 1}, index_sequence,
+                      pointers...);
         if (!result) break;
         increment_pointers();
       }
@@ -154,11 +154,30 @@ struct StridedLayoutFunctionApplyer<Arity>::WrappedFunction {
   static bool OuterCallHelper(
       const StridedLayoutFunctionApplyer& data, std::index_sequence<Is...>,
       std::array<ByteStridedPointer<void>, Arity> pointers, void* arg) {
-    return internal_iterate::IterateHelper<
+    using Helper = internal_iterate::IterateHelper<
         WrappedFunction,
-        std::enable_if_t<true || Is, ByteStridedPointer<void>>...>::
-        Start(WrappedFunction{data, arg}, data.iteration_layout_,
-              pointers[Is]...);
+        std::enable_if_t<true || Is, ByteStridedPointer<void>>...>;
+    const auto& layout = data.iteration_layout_;
+    // The innermost 2 dimensions are handled by `callback_`, which is already
+    // specialized for the data type and buffer kind.  Outer ranks up to 3,
+    // i.e. total ranks up to 5, use loops specialized for the static rank.
+    switch (layout.size()) {
+      case 0:
+        return Helper::template StartStatic<0>(WrappedFunction{data, arg},
+                                               layout.data(), pointers[Is]...);
+      case 1:
+        return Helper::template StartStatic<1>(WrappedFunction{data, arg},
+                                               layout.data(), pointers[Is]...);
+      case 2:
+        return Helper::template StartStatic<2>(WrappedFunction{data, arg},
+                                               layout.data(), pointers[Is]...);
+      case 3:
+        return Helper::template StartStatic<3>(WrappedFunction{data, arg},
+                                               layout.data(), pointers[Is]...);
+      default:
+        return Helper::Start(WrappedFunction{data, arg}, layout,
+                             pointers[Is]...);
+    }
   }
 
   template <size_t... Is, typename... Pointer>
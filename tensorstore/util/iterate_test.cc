@@ -47,6 +47,7 @@ using ::tensorstore::internal_iterate::
     ComputeStridedLayoutDimensionIterationOrder;
 using ::tensorstore::internal_iterate::ExtractInnerShapeAndStrides;
 using ::tensorstore::internal_iterate::InnerShapeAndStrides;
+using ::tensorstore::internal_iterate::IterateHelper;
 using ::tensorstore::internal_iterate::PermuteAndSimplifyStridedIterationLayout;
 using ::tensorstore::internal_iterate::SimplifyStridedIterationLayout;
 using ::tensorstore::internal_iterate::StridedIterationLayout;
@@ -518,12 +519,61 @@ TEST(IterateOverStridedLayoutsTest, InnerRank0NonContiguousFortranStop) {
     result.emplace_back(a, b);
     return a != 3;
   };
-  IterateOverStridedLayouts(shape, {{strides0, strides1}}, func,
-                            ContiguousLayoutOrder::fortran, 0, 0);
+  EXPECT_EQ(false,
+            IterateOverStridedLayouts(shape, {{strides0, strides1}}, func,
+                                      ContiguousLayoutOrder::fortran, 0, 0));
   std::vector<R> expected_result{R{0, 0}, R{3, 12}};
   EXPECT_EQ(expected_result, result);
 }
 
+TEST(IterateHelperTest, StartStaticMatchesStart) {
+  const Index shape[] = {2, 3, 4};
+  const Index strides0[] = {1, 2, 6};
+  const Index strides1[] = {12, 4, 1};
+  auto layout = SimplifyStridedIterationLayout<2>(
+      {ContiguousLayoutOrder::c, include_repeated_elements}, shape,
+      {{strides0, strides1}});
+  ASSERT_EQ(3, layout.size());
+
+  using R = std::tuple<int, int>;
+  std::vector<R> expected_result, result;
+  auto expected_func = [&](int a, int b) {
+    expected_result.emplace_back(a, b);
+    return true;
+  };
+  auto func = [&](int a, int b) {
+    result.emplace_back(a, b);
+    return true;
+  };
+  EXPECT_TRUE((IterateHelper<decltype(expected_func)&, int, int>::Start(
+      expected_func, layout, 0, 0)));
+  EXPECT_TRUE((IterateHelper<decltype(func)&, int, int>::StartStatic<3>(
+      func, layout.data(), 0, 0)));
+  EXPECT_EQ(24, result.size());
+  EXPECT_EQ(expected_result, result);
+}
+
+TEST(IterateHelperTest, StartStaticStop) {
+  const Index shape[] = {2, 3};
+  const Index strides0[] = {1, 2};
+  const Index strides1[] = {3, 1};
+  auto layout = SimplifyStridedIterationLayout<2>(
+      {ContiguousLayoutOrder::c, include_repeated_elements}, shape,
+      {{strides0, strides1}});
+  ASSERT_EQ(2, layout.size());
+
+  using R = std::tuple<int, int>;
+  std::vector<R> result;
+  auto func = [&](int a, int b) {
+    result.emplace_back(a, b);
+    return a != 3;
+  };
+  EXPECT_FALSE((IterateHelper<decltype(func)&, int, int>::StartStatic<2>(
+      func, layout.data(), 0, 0)));
+  std::vector<R> expected_result{R{0, 0}, R{2, 1}, R{4, 2}, R{1, 3}, R{3, 4}};
+  EXPECT_EQ(expected_result, result);
+}
+
 template <ContiguousLayoutOrder Order>
 std::vector<std::vector<int>> GetIndexVectors(std::vector<int> shape) {
   std::vector<std::vector<int>> result;
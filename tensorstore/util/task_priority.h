@@ -0,0 +1,85 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_UTIL_TASK_PRIORITY_H_
+#define TENSORSTORE_UTIL_TASK_PRIORITY_H_
+
+/// \file
+/// Scheduling priority of executor tasks.
+
+#include <utility>
+
+#include "tensorstore/util/executor.h"
+
+namespace tensorstore {
+
+/// Scheduling priority of the tasks that carry out an operation.
+///
+/// Thread pool executors run all pending `kNormal` tasks before any
+/// `kBackground` task, so that large background operations (such as bulk
+/// writeback or prefetching) do not delay latency-sensitive operations.
+///
+/// \ingroup async
+enum class TaskPriority {
+  /// Foreground (interactive) work.  This is the default.
+  kNormal = 0,
+
+  /// Work that only runs when no `kNormal` work is pending.
+  kBackground = 1,
+};
+
+namespace internal {
+
+/// Priority assigned to tasks submitted from the current thread.
+///
+/// Set while running a task on a thread pool executor to the priority of that
+/// task, so that continuations inherit the priority of the operation.
+inline thread_local TaskPriority current_task_priority = TaskPriority::kNormal;
+
+/// Returns the priority assigned to tasks submitted from the current thread.
+inline TaskPriority GetCurrentTaskPriority() { return current_task_priority; }
+
+/// Sets the priority of tasks submitted from the current thread for the
+/// lifetime of this object.
+class ScopedTaskPriority {
+ public:
+  explicit ScopedTaskPriority(TaskPriority priority)
+      : previous_(current_task_priority) {
+    current_task_priority = priority;
+  }
+  ~ScopedTaskPriority() { current_task_priority = previous_; }
+
+  ScopedTaskPriority(const ScopedTaskPriority&) = delete;
+  ScopedTaskPriority& operator=(const ScopedTaskPriority&) = delete;
+
+ private:
+  TaskPriority previous_;
+};
+
+/// Returns an executor that submits tasks to `executor` with the specified
+/// `priority`, regardless of the priority of the submitting thread.
+///
+/// This is needed for continuations that may be submitted from threads not
+/// associated with the operation, such as I/O completion threads.
+inline Executor WithTaskPriority(Executor executor, TaskPriority priority) {
+  return [executor = std::move(executor), priority](ExecutorTask task) {
+    ScopedTaskPriority scoped_priority(priority);
+    executor(std::move(task));
+  };
+}
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_UTIL_TASK_PRIORITY_H_
@@ -243,13 +243,18 @@
 /// no different than binding the transaction to an existing virtual chunked
 /// view.
 
+#include <stddef.h>
+
 #include <functional>
+#include <optional>
 #include <type_traits>
+#include <utility>
 
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
 #include "tensorstore/context.h"
 #include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/serialization/function.h"
 #include "tensorstore/staleness_bound.h"
 #include "tensorstore/tensorstore.h"
@@ -275,11 +280,16 @@ class ReadParameters {
   /// Read may be fulfilled with cached data no older than the specified bound.
   absl::Time staleness_bound() const { return staleness_bound_; }
 
+  /// Priority hint specified by the `ReadPriority` option.  Higher values
+  /// indicate higher priority.
+  int priority() const { return priority_; }
+
   // Treat as private:
 
   Executor executor_;
   StorageGeneration if_not_equal_;
   absl::Time staleness_bound_;
+  int priority_ = 0;
 };
 
 /// Type-erased function called to read a single chunk.
@@ -328,6 +338,46 @@ constexpr inline bool IsWriteFunction =
         Future<TimestampedStorageGeneration>, Func,
         Array<const Element, Rank, offset_origin>, WriteParameters>;
 
+/// Option that limits the number of concurrent calls to the `read_function`.
+///
+/// A call is considered in progress until the `Future` it returns becomes
+/// ready.  Additional reads are queued, and started in the order in which they
+/// were requested.  A value of `0` indicates no limit.
+struct MaxConcurrentReads {
+  constexpr explicit MaxConcurrentReads(size_t value = 0) : value(value) {}
+  size_t value;
+};
+
+/// Option that specifies a priority hint, which is passed to the
+/// `read_function` as `ReadParameters::priority`.
+///
+/// This may be used, for example, by a `read_function` that schedules its
+/// computation on a worker pool shared by several views.
+struct ReadPriority {
+  constexpr explicit ReadPriority(int value = 0) : value(value) {}
+  int value;
+};
+
+/// Option that specifies a kvstore in which chunks computed by the
+/// `read_function` are persisted, such that each chunk is computed only once.
+///
+/// Before calling the `read_function` for a chunk, the chunk is read from the
+/// kvstore; the `read_function` is called only if the chunk is not present,
+/// and the computed chunk is then written to the kvstore.  Chunks are stored
+/// under keys of the form `"<i0>.<i1>...."`, where `i0`, `i1`, ... are the
+/// chunk grid indices.  Each value is the little endian, C order encoding of
+/// the portion of the chunk within the domain.
+///
+/// Cached chunks are revalidated, subject to `RecheckCachedData`, against the
+/// kvstore rather than by calling the `read_function`; stale chunks must be
+/// deleted from the kvstore explicitly.
+///
+/// Only supported for read-only views with a trivial data type.
+struct PersistentCache {
+  explicit PersistentCache(KvStore kvstore) : kvstore(std::move(kvstore)) {}
+  KvStore kvstore;
+};
+
 /// Options to the `tensorstore::VirtualChunked` function for creating an
 /// `virtual_chunked` TensorStore.
 ///
@@ -361,10 +411,20 @@ constexpr inline bool IsWriteFunction =
 /// - `RecheckCachedData`: May be specified in conjunction with a `Context` with
 ///   non-zero `total_bytes_limit` specified for the `cache_pool` to avoid
 ///   re-invoking the `read_function` to validate cached data.
+///
+/// - `MaxConcurrentReads`: Limits the number of concurrent calls to the
+///   `read_function`.
+///
+/// - `ReadPriority`: Priority hint passed to the `read_function`.
+///
+/// - `PersistentCache`: Kvstore in which computed chunks are persisted.
 struct OpenOptions : public Schema {
   Context context;
   Transaction transaction{no_transaction};
   RecheckCachedData recheck_cached_data;
+  MaxConcurrentReads max_concurrent_reads;
+  ReadPriority read_priority;
+  std::optional<KvStore> persistent_cache;
 
   template <typename T>
   static inline constexpr bool IsOption = Schema::IsOption<T>;
@@ -387,6 +447,21 @@ struct OpenOptions : public Schema {
     }
     return absl::OkStatus();
   }
+
+  absl::Status Set(MaxConcurrentReads value) {
+    max_concurrent_reads = value;
+    return absl::OkStatus();
+  }
+
+  absl::Status Set(ReadPriority value) {
+    read_priority = value;
+    return absl::OkStatus();
+  }
+
+  absl::Status Set(PersistentCache value) {
+    persistent_cache = std::move(value.kvstore);
+    return absl::OkStatus();
+  }
 };
 
 template <>
@@ -398,6 +473,15 @@ constexpr inline bool OpenOptions::IsOption<Transaction> = true;
 template <>
 constexpr inline bool OpenOptions::IsOption<RecheckCachedData> = true;
 
+template <>
+constexpr inline bool OpenOptions::IsOption<MaxConcurrentReads> = true;
+
+template <>
+constexpr inline bool OpenOptions::IsOption<ReadPriority> = true;
+
+template <>
+constexpr inline bool OpenOptions::IsOption<PersistentCache> = true;
+
 namespace internal_virtual_chunked {
 Result<internal::Driver::Handle> MakeDriver(
     virtual_chunked::ReadFunction read_function,